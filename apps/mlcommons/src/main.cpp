@@ -32,56 +32,50 @@
 
 namespace fs = std::filesystem;
 
-amdinfer::InferenceRequest preprocessResnet50(
-  const std::filesystem::path& path) {
-  const auto height = 224;
-  const auto width = 224;
-  const auto channels = 3;
+const auto kResnet50Height = 224;
+const auto kResnet50Width = 224;
+const auto kResnet50Channels = 3;
+
+void preprocessResnet50(const std::filesystem::path& path, std::byte* dest) {
+  const auto height = kResnet50Height;
+  const auto width = kResnet50Width;
+  const auto channels = kResnet50Channels;
   const std::array<int8_t, 3> mean{123, 107, 104};
   const std::array<int8_t, 3> std{1, 1, 1};
 
   auto img = cv::imread(path.string());
+  cv::resize(img, img, cv::Size(width, height));
   img = img.isContinuous() ? img : img.clone();
-  auto size = img.size[0] * img.size[1] * channels;
-
-  std::vector<std::byte> data;
-  data.resize(size * sizeof(int8_t));
 
   for (int i = 0; i < height; i++) {
     for (int j = 0; j < width; j++) {
       for (int k = 0; k < channels; k++) {
         auto output_index = (i * width * channels) + (j * channels) + k;
-        auto* addr = reinterpret_cast<int8_t*>(data.data() + output_index);
+        auto* addr = reinterpret_cast<int8_t*>(dest + output_index);
         *addr = static_cast<int8_t>(
           (img.at<cv::Vec<int8_t, channels>>(i, j)[k] - mean.at(k)) *
           std.at(k));
       }
     }
   }
-
-  amdinfer::InferenceRequest request;
-  amdinfer::InferenceRequestInput tensor;
-  tensor.setShape({height, width, channels});
-  tensor.setData(std::move(data));
-  tensor.setDatatype(amdinfer::DataType::Int8);
-
-  request.addInputTensor(tensor);
-  return request;
 }
 
 int main(int argc, char* argv[]) {
   const size_t default_performance_samples = 1000;
+  const size_t default_completion_threads = 4;
 
   // these defaults are overridden first by the config file and then by command
   // line, if they exist
   size_t performance_samples = default_performance_samples;
   fs::path input_directory = fs::current_path() / "data";
+  fs::path sample_cache;
   fs::path model_path;
   std::string worker;
   std::string client_id{"native"};
   std::string address;
   std::string endpoint;
   bool remote_server = false;
+  size_t completion_threads = default_completion_threads;
 
   // these must be specified from the command line
   std::string scenario;
@@ -108,6 +102,9 @@ int main(int argc, char* argv[]) {
   ("input-directory",
     "Path to the directory containing input data. Defaults to ./data",
     cxxopts::value(input_directory))
+  ("sample-cache",
+    "Path to a file to cache the preprocessed samples in across runs",
+    cxxopts::value(sample_cache))
   // ("client", "Must be one of 'native', 'HTTP' or 'gRPC'",
   //   cxxopts::value(client_id))
   // ("address", "Address to the server if using HTTP or gRPC client",
@@ -165,6 +162,11 @@ int main(int argc, char* argv[]) {
       input_directory =
         test_config.get<std::string>(model, scenario, "input_directory");
     }
+    if (result.count("sample-cache") == 0U &&
+        test_config.has(model, scenario, "sample_cache")) {
+      sample_cache =
+        test_config.get<std::string>(model, scenario, "sample_cache");
+    }
 
   } catch (const cxxopts::OptionException& e) {
     std::cout << "Error parsing options: " << e.what() << "\n";
@@ -187,6 +189,21 @@ int main(int argc, char* argv[]) {
     endpoint = test_config.get<std::string>(model, scenario, "endpoint");
   }
 
+  if (test_config.has(model, scenario, "completion_threads")) {
+    completion_threads =
+      test_config.get<int>(model, scenario, "completion_threads");
+  }
+
+  // the Offline scenario can pack its samples into larger requests
+  amdinfer::OfflineOptions offline;
+  if (scenario == "Offline" &&
+      test_config.has(model, scenario, "offline_batch")) {
+    offline.batch = test_config.get<int>(model, scenario, "offline_batch");
+    if (test_config.has(model, scenario, "offline_window")) {
+      offline.window = test_config.get<int>(model, scenario, "offline_window");
+    }
+  }
+
   if (scenario == "SingleStream") {
     test_settings.scenario = mlperf::TestScenario::SingleStream;
   } else if (scenario == "MultiStream") {
@@ -222,8 +239,11 @@ int main(int argc, char* argv[]) {
     return 1;
   }
 
+  const amdinfer::SampleTensor tensor{
+    {kResnet50Height, kResnet50Width, kResnet50Channels},
+    amdinfer::DataType::Int8};
   amdinfer::QuerySampleLibrary qsl(performance_samples, input_directory,
-                                   preprocessResnet50);
+                                   tensor, preprocessResnet50, sample_cache);
 
   std::optional<amdinfer::Server> server;
   std::unique_ptr<amdinfer::Client> client;
@@ -264,6 +284,10 @@ int main(int argc, char* argv[]) {
     amdinfer::ParameterMap parameters =
       test_config.getParameters(model, scenario);
     parameters.put("share", false);
+    if (offline.batch > 0) {
+      // the worker must count the samples in each request to batch them
+      parameters.put("batch_samples", true);
+    }
     amdinfer::waitUntilServerReady(client.get());
 
     endpoint = client->workerLoad(worker, &parameters);
@@ -275,7 +299,8 @@ int main(int argc, char* argv[]) {
     }
   }
 
-  amdinfer::SystemUnderTest sut(&qsl, client.get(), endpoint);
+  amdinfer::SystemUnderTest sut(&qsl, client.get(), endpoint,
+                                completion_threads, offline);
 
   mlperf::StartTest(&sut, &qsl, test_settings, log_settings);
 
@@ -19,7 +19,14 @@
 
 #include "query_sample_library.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include "sample_cache.hpp"
 
 namespace fs = std::filesystem;
 
@@ -27,8 +34,11 @@ namespace amdinfer {
 
 QuerySampleLibrary::QuerySampleLibrary(size_t perf_samples,
                                        const fs::path& directory,
-                                       PreprocessFunc f)
-  : perf_samples_(perf_samples), pre_process_(std::move(f)) {
+                                       SampleTensor tensor, PreprocessFunc f,
+                                       const fs::path& cache)
+  : perf_samples_(perf_samples),
+    tensor_(std::move(tensor)),
+    pre_process_(std::move(f)) {
   for (const auto& path : fs::recursive_directory_iterator(directory)) {
     if (!path.is_directory()) {
       auto sample_path = path.path();
@@ -37,8 +47,20 @@ QuerySampleLibrary::QuerySampleLibrary(size_t perf_samples,
       samples_.emplace_back(sample_path);
     }
   }
+  // the samples are indexed in the cache so they must be in the same order on
+  // every run
+  std::sort(samples_.begin(), samples_.end(),
+            [](const Sample& a, const Sample& b) {
+              return a.filepath < b.filepath;
+            });
+  if (!cache.empty()) {
+    cache_ =
+      std::make_unique<SampleCache>(cache, samples_.size(), tensor_.size());
+  }
 }
 
+QuerySampleLibrary::~QuerySampleLibrary() = default;
+
 const std::string& QuerySampleLibrary::Name() const { return name_; }
 
 size_t QuerySampleLibrary::TotalSampleCount() { return samples_.size(); }
@@ -47,16 +69,64 @@ size_t QuerySampleLibrary::PerformanceSampleCount() { return perf_samples_; }
 
 void QuerySampleLibrary::LoadSamplesToRam(
   const std::vector<mlperf::QuerySampleIndex>& indices) {
-  for (const auto& index : indices) {
-    auto& sample = samples_[index];
-    sample.request = pre_process_(sample.filepath);
+  // samples are loaded in parallel since decoding and preprocessing them is
+  // independent for each sample
+  const auto threads = std::min<size_t>(
+    std::max(std::thread::hardware_concurrency(), 1U), indices.size());
+  std::atomic_size_t next = 0;
+  std::mutex mutex;
+  std::exception_ptr error;
+  auto load = [&]() {
+    try {
+      for (auto i = next++; i < indices.size(); i = next++) {
+        const auto index = indices[i];
+        auto& sample = samples_[index];
+        std::byte* data = nullptr;
+        if (cache_ == nullptr) {
+          sample.data.resize(tensor_.size());
+          data = sample.data.data();
+          pre_process_(sample.filepath, data);
+        } else {
+          data = cache_->record(index);
+          if (cache_->cached(index)) {
+            cache_->prefault(index);
+          } else {
+            pre_process_(sample.filepath, data);
+            cache_->setCached(index);
+          }
+        }
+        // the request points to the tensor so it isn't copied
+        sample.request = InferenceRequest();
+        sample.request.addInputTensor(data, tensor_.shape, tensor_.datatype);
+      }
+    } catch (...) {
+      const std::lock_guard lock{mutex};
+      if (error == nullptr) {
+        error = std::current_exception();
+      }
+      next = indices.size();
+    }
+  };
+
+  std::vector<std::thread> pool;
+  for (size_t i = 1; i < threads; i++) {
+    pool.emplace_back(load);
+  }
+  load();
+  for (auto& thread : pool) {
+    thread.join();
+  }
+  if (error != nullptr) {
+    std::rethrow_exception(error);
   }
 }
 
 void QuerySampleLibrary::UnloadSamplesFromRam(
   const std::vector<mlperf::QuerySampleIndex>& indices) {
   for (const auto& index : indices) {
-    samples_[index].request = InferenceRequest();
+    auto& sample = samples_[index];
+    sample.request = InferenceRequest();
+    sample.data = std::vector<std::byte>();
   }
 }
 
@@ -22,28 +22,68 @@
 
 #include <query_sample_library.h>
 
+#include <cstddef>
 #include <filesystem>
 #include <functional>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "amdinfer/amdinfer.hpp"
 
 namespace amdinfer {
 
+class SampleCache;
+
 struct Sample {
   explicit Sample(const std::filesystem::path& path) : filepath(path){};
 
   std::filesystem::path filepath;
+  /// the preprocessed tensor if it's not in the cache
+  std::vector<std::byte> data;
   InferenceRequest request;
 };
 
+/// The tensor that preprocessing makes from each sample
+struct SampleTensor {
+  Shape shape;
+  DataType datatype;
+
+  /// Get the size of the tensor in bytes
+  [[nodiscard]] size_t size() const {
+    size_t size = datatype.size();
+    for (const auto& dim : shape) {
+      size *= dim;
+    }
+    return size;
+  }
+};
+
+/// Preprocesses the sample at a path and writes its tensor to the address
 using PreprocessFunc =
-  std::function<InferenceRequest(const std::filesystem::path&)>;
+  std::function<void(const std::filesystem::path&, std::byte*)>;
 
 class QuerySampleLibrary : public mlperf::QuerySampleLibrary {
  public:
+  /**
+   * @brief Construct a new QuerySampleLibrary object
+   *
+   * @param perf_samples number of samples that are guaranteed to fit in memory
+   * @param directory directory of the samples
+   * @param tensor the tensor that preprocessing makes from each sample
+   * @param f preprocesses a sample
+   * @param cache path to a file to cache the preprocessed samples in. If
+   * it's empty, the samples are preprocessed each time they're loaded
+   */
   QuerySampleLibrary(size_t perf_samples,
-                     const std::filesystem::path& directory, PreprocessFunc f);
+                     const std::filesystem::path& directory,
+                     SampleTensor tensor, PreprocessFunc f,
+                     const std::filesystem::path& cache = {});
+  QuerySampleLibrary(const QuerySampleLibrary&) = delete;
+  QuerySampleLibrary& operator=(const QuerySampleLibrary&) = delete;
+  QuerySampleLibrary(QuerySampleLibrary&&) = delete;
+  QuerySampleLibrary& operator=(QuerySampleLibrary&&) = delete;
+  ~QuerySampleLibrary() override;
 
   /// Get the name for the object
   const std::string& Name() const override;
@@ -55,8 +95,9 @@ class QuerySampleLibrary : public mlperf::QuerySampleLibrary {
   size_t PerformanceSampleCount() override;
 
   /**
-   * @brief Load the requested samples to memory. In non-MultiStream scenarios,
-   * a previously loaded sample will not be loaded again
+   * @brief Load the requested samples to memory in parallel. In non-MultiStream
+   * scenarios, a previously loaded sample will not be loaded again. Samples in
+   * the cache are read from it instead of being preprocessed
    *
    * @param indices sample indices to load
    */
@@ -78,7 +119,9 @@ class QuerySampleLibrary : public mlperf::QuerySampleLibrary {
   std::string name_{"AMD Inference Server"};
   size_t perf_samples_;
   std::vector<Sample> samples_;
+  SampleTensor tensor_;
   PreprocessFunc pre_process_;
+  std::unique_ptr<SampleCache> cache_;
 };
 
 }  // namespace amdinfer
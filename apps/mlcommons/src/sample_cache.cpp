@@ -0,0 +1,116 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements an on-disk cache of preprocessed samples
+ */
+
+#include "sample_cache.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace fs = std::filesystem;
+
+namespace amdinfer {
+
+namespace {
+
+constexpr std::array<char, 8> kMagic{'A', 'M', 'D', 'Q', 'S', 'L', '0', '1'};
+constexpr size_t kPageSize = 4096;
+
+struct Header {
+  std::array<char, 8> magic;
+  uint64_t count;
+  uint64_t record_size;
+};
+
+size_t roundUp(size_t size) {
+  return (size + kPageSize - 1) / kPageSize * kPageSize;
+}
+
+}  // namespace
+
+SampleCache::SampleCache(const fs::path& path, size_t count,
+                         size_t record_size)
+  : count_(count), record_size_(record_size) {
+  // the records start on a page so the mapping of each one is aligned
+  const auto records_offset = roundUp(sizeof(Header) + count);
+  size_ = records_offset + count * record_size;
+
+  const int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+  if (fd < 0) {
+    throw std::runtime_error("Could not open the sample cache " +
+                             path.string());
+  }
+
+  Header header{};
+  const auto valid =
+    ::pread(fd, &header, sizeof(header), 0) ==
+      static_cast<ssize_t>(sizeof(header)) &&
+    header.magic == kMagic && header.count == count &&
+    header.record_size == record_size &&
+    fs::file_size(path) == static_cast<uintmax_t>(size_);
+  if (!valid) {
+    // the file is sparse so only the written records take space on disk
+    header = Header{kMagic, count, record_size};
+    if (::ftruncate(fd, 0) != 0 ||
+        ::ftruncate(fd, static_cast<off_t>(size_)) != 0 ||
+        ::pwrite(fd, &header, sizeof(header), 0) !=
+          static_cast<ssize_t>(sizeof(header))) {
+      ::close(fd);
+      throw std::runtime_error("Could not create the sample cache " +
+                               path.string());
+    }
+  }
+
+  void* map = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (map == MAP_FAILED) {
+    throw std::runtime_error("Could not map the sample cache " +
+                             path.string());
+  }
+  map_ = static_cast<std::byte*>(map);
+  flags_ = map_ + sizeof(Header);
+  records_ = map_ + records_offset;
+}
+
+SampleCache::~SampleCache() { ::munmap(map_, size_); }
+
+bool SampleCache::cached(size_t index) const {
+  return index < count_ && flags_[index] != std::byte{0};
+}
+
+void SampleCache::setCached(size_t index) { flags_[index] = std::byte{1}; }
+
+std::byte* SampleCache::record(size_t index) const {
+  return records_ + index * record_size_;
+}
+
+void SampleCache::prefault(size_t index) const {
+  const volatile std::byte* data = record(index);
+  for (size_t i = 0; i < record_size_; i += kPageSize) {
+    (void)data[i];
+  }
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,77 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines an on-disk cache of preprocessed samples
+ */
+
+#ifndef GUARD_MLCOMMONS_SRC_SAMPLE_CACHE
+#define GUARD_MLCOMMONS_SRC_SAMPLE_CACHE
+
+#include <cstddef>
+#include <filesystem>
+
+namespace amdinfer {
+
+/**
+ * @brief The SampleCache keeps the preprocessed tensor of each sample in one
+ * memory-mapped file so later runs don't preprocess them again. The file has a
+ * small header, a flag per sample that's set once it's cached, and a record of
+ * the same size for each sample. Records are only allocated on disk once
+ * they're written. Preprocessing writes straight into a record and requests
+ * point into the mapping so the samples aren't copied.
+ *
+ * The cache doesn't know how its samples were made so delete the file if the
+ * data or the preprocessing changes.
+ */
+class SampleCache {
+ public:
+  /**
+   * @brief Open the cache, creating it if it doesn't exist or if it was made
+   * for a different number or size of samples
+   *
+   * @param path path to the cache file
+   * @param count number of samples
+   * @param record_size size of each sample's tensor in bytes
+   */
+  SampleCache(const std::filesystem::path& path, size_t count,
+              size_t record_size);
+  SampleCache(const SampleCache&) = delete;
+  SampleCache& operator=(const SampleCache&) = delete;
+  SampleCache(SampleCache&&) = delete;
+  SampleCache& operator=(SampleCache&&) = delete;
+  ~SampleCache();
+
+  /// Check if a sample is cached
+  [[nodiscard]] bool cached(size_t index) const;
+  /// Mark a sample as cached once its record has been written
+  void setCached(size_t index);
+  /// Get the record of a sample
+  [[nodiscard]] std::byte* record(size_t index) const;
+  /// Read each page of a sample's record so it's in memory before it's used
+  void prefault(size_t index) const;
+
+ private:
+  size_t count_;
+  size_t record_size_;
+  size_t size_ = 0;
+  std::byte* map_ = nullptr;
+  std::byte* flags_ = nullptr;
+  std::byte* records_ = nullptr;
+};
+
+}  // namespace amdinfer
+
+#endif  // GUARD_MLCOMMONS_SRC_SAMPLE_CACHE
@@ -21,7 +21,11 @@
 
 #include <loadgen.h>
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <cstring>
+#include <deque>
 
 #include "query_sample_library.hpp"
 
@@ -30,40 +34,150 @@ namespace amdinfer {
 const std::string& SystemUnderTest::Name() const { return name_; }
 
 SystemUnderTest::SystemUnderTest(QuerySampleLibrary* qsl, Client* client,
-                                 std::string endpoint)
-  : qsl_(qsl), client_(client), endpoint_(std::move(endpoint)) {
+                                 std::string endpoint, size_t threads,
+                                 OfflineOptions offline)
+  : qsl_(qsl),
+    client_(client),
+    endpoint_(std::move(endpoint)),
+    offline_(offline) {
   waitUntilServerReady(client_);
   waitUntilModelReady(client_, endpoint_);
-  std::thread{&SystemUnderTest::FinishQuery, this}.detach();
+  threads = std::max(threads, size_t{1});
+  threads_.reserve(threads);
+  for (size_t i = 0; i < threads; ++i) {
+    threads_.emplace_back(&SystemUnderTest::FinishQuery, this);
+  }
+}
+
+SystemUnderTest::~SystemUnderTest() noexcept {
+  if (offline_thread_.joinable()) {
+    offline_thread_.join();
+  }
+  run_ = false;
+  for (auto& thread : threads_) {
+    thread.join();
+  }
 }
 
 void SystemUnderTest::IssueQuery(
   const std::vector<mlperf::QuerySample>& samples) {
+  if (offline_.batch > 0) {
+    // loadgen issues the whole Offline query at once so it's sent from
+    // another thread to return right away
+    if (offline_thread_.joinable()) {
+      offline_thread_.join();
+    }
+    offline_thread_ =
+      std::thread{&SystemUnderTest::issueOffline, this, samples};
+    return;
+  }
+  // the sample IDs are kept with the futures so the requests don't need IDs
   for (const auto& sample : samples) {
-    auto& request = qsl_->getSample(sample.index);
-    request.setID(std::to_string(sample.id));
-    auto response = client_->modelInferAsync(endpoint_, request);
-    queue_.enqueue(std::move(response));
+    const auto& request = qsl_->getSample(sample.index);
+    queue_.enqueue(
+      PendingSample{sample.id, client_->modelInferAsync(endpoint_, request)});
   }
 }
 
-// NOLINTNEXTLINE(readability-identifier-naming)
 void SystemUnderTest::FinishQuery() {
-  while (true) {
-    InferenceResponseFuture future;
-    queue_.wait_dequeue(future);
-    auto response = future.get();
-    if (response.isError()) {
-      std::cout << "Error encountered in response. App may hang\n";
-    } else {
+  // take whatever responses are queued, up to this many, and report them to
+  // loadgen together
+  constexpr size_t kMaxBatch = 64;
+  constexpr auto kTimeout = std::chrono::milliseconds(100);
+
+  std::vector<PendingSample> pending(kMaxBatch);
+  std::vector<InferenceResponse> responses;
+  std::vector<mlperf::QuerySampleResponse> results;
+  responses.reserve(kMaxBatch);
+  results.reserve(kMaxBatch);
+  while (run_) {
+    const auto count =
+      queue_.wait_dequeue_bulk_timed(pending.begin(), kMaxBatch, kTimeout);
+    for (size_t i = 0; i < count; ++i) {
+      auto response = pending[i].future.get();
+      if (response.isError()) {
+        std::cout << "Error encountered in response. App may hang\n";
+        continue;
+      }
       const auto& outputs = response.getOutputs();
       assert(outputs.size() == 1);
       const auto& output = outputs[0];
       auto data = reinterpret_cast<uintptr_t>(output.getData());
-      mlperf::ResponseId id = std::stoul(response.getID());
-      mlperf::QuerySampleResponse result{id, data, output.getSize()};
-      mlperf::QuerySamplesComplete(&result, 1);
+      results.push_back({pending[i].id, data, output.getSize()});
+      // the responses own the data until loadgen has copied it
+      responses.push_back(std::move(response));
+    }
+    if (!results.empty()) {
+      mlperf::QuerySamplesComplete(results.data(), results.size());
+      results.clear();
+      responses.clear();
+    }
+  }
+}
+
+void SystemUnderTest::issueOffline(
+  const std::vector<mlperf::QuerySample>& samples) {
+  struct Packed {
+    size_t first;
+    size_t count;
+    // the request points to this data so it's kept until the response
+    std::vector<std::byte> data;
+    InferenceResponseFuture future;
+  };
+
+  std::deque<Packed> in_flight;
+  size_t next = 0;
+  auto pack = [&]() {
+    const auto count = std::min(offline_.batch, samples.size() - next);
+    const auto& input = qsl_->getSample(samples[next].index).getInputs()[0];
+    const auto datatype = input.getDatatype();
+    const auto sample_size = input.getSize() * datatype.size();
+    Shape shape = input.getShape();
+    shape.insert(shape.begin(), count);
+
+    Packed packed{next, count, std::vector<std::byte>(count * sample_size),
+                  {}};
+    for (size_t i = 0; i < count; ++i) {
+      const auto& sample = qsl_->getSample(samples[next + i].index);
+      std::memcpy(packed.data.data() + i * sample_size,
+                  sample.getInputs()[0].getData(), sample_size);
+    }
+    InferenceRequest request;
+    request.addInputTensor(packed.data.data(), shape, datatype);
+    packed.future = client_->modelInferAsync(endpoint_, request);
+    in_flight.push_back(std::move(packed));
+    next += count;
+  };
+
+  std::vector<mlperf::QuerySampleResponse> results;
+  results.reserve(offline_.batch);
+  while (next < samples.size() &&
+         in_flight.size() < std::max(offline_.window, size_t{1})) {
+    pack();
+  }
+  while (!in_flight.empty()) {
+    auto packed = std::move(in_flight.front());
+    in_flight.pop_front();
+    auto response = packed.future.get();
+    if (next < samples.size()) {
+      pack();
+    }
+    if (response.isError()) {
+      std::cout << "Error encountered in response. App may hang\n";
+      continue;
+    }
+    // each sample's results are its slice along the first dimension
+    const auto& output = response.getOutputs()[0];
+    const auto stride =
+      output.getSize() * output.getDatatype().size() / packed.count;
+    auto* data = static_cast<std::byte*>(output.getData());
+    results.clear();
+    for (size_t i = 0; i < packed.count; ++i) {
+      results.push_back({samples[packed.first + i].id,
+                         reinterpret_cast<uintptr_t>(data + i * stride),
+                         stride});
     }
+    mlperf::QuerySamplesComplete(results.data(), results.size());
   }
 }
 
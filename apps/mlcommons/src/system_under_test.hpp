@@ -21,22 +21,58 @@
 #define GUARD_MLCOMMONS_SRC_SYSTEM_UNDER_TEST
 
 #include <concurrentqueue/blockingconcurrentqueue.h>
+#include <query_sample.h>
 #include <system_under_test.h>
 
+#include <atomic>
+#include <thread>
+#include <vector>
+
 #include "amdinfer/amdinfer.hpp"
 
 namespace amdinfer {
 
 class QuerySampleLibrary;
 
+/// A request in flight and the ID of the loadgen sample it's for
+struct PendingSample {
+  mlperf::ResponseId id;
+  InferenceResponseFuture future;
+};
+
+/// How the Offline scenario packs samples into requests
+struct OfflineOptions {
+  /// samples per request, such as the endpoint's batch size. Zero sends one
+  /// request per sample
+  size_t batch = 0;
+  /// requests to keep in flight
+  size_t window = 4;
+};
+
 class SystemUnderTest : public mlperf::SystemUnderTest {
  public:
+  /**
+   * @brief Construct a new SystemUnderTest object
+   *
+   * @param qsl the samples to send
+   * @param client client to make the requests with
+   * @param endpoint endpoint to make the requests to
+   * @param threads number of threads that wait for the responses and report
+   * them to loadgen. With more than one, a slow response only holds back the
+   * responses that its thread has taken
+   * @param offline how to pack samples into requests in the Offline scenario
+   */
   SystemUnderTest(QuerySampleLibrary* qsl, Client* client,
-                  std::string endpoint);
+                  std::string endpoint, size_t threads,
+                  OfflineOptions offline = {});
 
   // void execBatch(std::vector<mlperf::QuerySample> batch);
 
-  ~SystemUnderTest() noexcept override = default;
+  SystemUnderTest(const SystemUnderTest&) = delete;
+  SystemUnderTest& operator=(const SystemUnderTest&) = delete;
+  SystemUnderTest(SystemUnderTest&&) = delete;
+  SystemUnderTest& operator=(SystemUnderTest&&) = delete;
+  ~SystemUnderTest() noexcept override;
 
   const std::string& Name() const override;
 
@@ -44,6 +80,17 @@ class SystemUnderTest : public mlperf::SystemUnderTest {
 
   void FinishQuery();
 
+  /**
+   * @brief Send the samples of an Offline query packed along the first
+   * dimension into requests of up to OfflineOptions::batch samples, keeping
+   * OfflineOptions::window requests in flight, and report each request's
+   * samples to loadgen together from the slices of its outputs. The endpoint
+   * must take requests with many samples, such as with batch_samples.
+   *
+   * @param samples the samples of the query
+   */
+  void issueOffline(const std::vector<mlperf::QuerySample>& samples);
+
   void FlushQueries() override;
 
   void ReportLatencyResults(
@@ -54,7 +101,11 @@ class SystemUnderTest : public mlperf::SystemUnderTest {
   QuerySampleLibrary* qsl_;
   Client* client_;
   std::string endpoint_;
-  moodycamel::BlockingConcurrentQueue<InferenceResponseFuture> queue_;
+  moodycamel::BlockingConcurrentQueue<PendingSample> queue_;
+  std::atomic_bool run_ = true;
+  std::vector<std::thread> threads_;
+  OfflineOptions offline_;
+  std::thread offline_thread_;
 };
 
 }  // namespace amdinfer
@@ -0,0 +1,153 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements a high dynamic range histogram to record latencies in
+ */
+
+#include "histogram.hpp"
+
+#include <algorithm>  // for min, max, clamp
+#include <cmath>      // for ceil
+#include <limits>     // for numeric_limits
+#include <string>     // for to_string
+
+#include "amdinfer/core/exceptions.hpp"  // for invalid_argument
+
+namespace amdinfer {
+
+namespace {
+
+constexpr auto kMaxDigits = 5;
+constexpr auto kBits = std::numeric_limits<uint64_t>::digits;
+constexpr auto kDecimal = 10;
+
+}  // namespace
+
+// The histogram is a set of buckets that each double the range of the last.
+// Each is split into the same number of sub-buckets, enough to tell apart
+// values that differ in the last significant digit at the bottom of a bucket.
+// Only the top half of each bucket's sub-buckets are stored as the bottom half
+// overlaps the bucket before it, except for the first bucket
+LatencyHistogram::LatencyHistogram(uint64_t max, int digits)
+  : max_(max), digits_(digits) {
+  if (digits < 1 || digits > kMaxDigits) {
+    throw invalid_argument("Histograms keep between 1 and " +
+                           std::to_string(kMaxDigits) + " significant digits");
+  }
+  if (max < 2) {
+    throw invalid_argument("Histograms must track values of at least 2");
+  }
+
+  uint64_t largest_single_unit = 2;
+  for (auto i = 0; i < digits; ++i) {
+    largest_single_unit *= kDecimal;
+  }
+  auto sub_bucket_magnitude = 0;
+  while ((uint64_t{1} << sub_bucket_magnitude) < largest_single_unit) {
+    sub_bucket_magnitude++;
+  }
+  sub_bucket_half_magnitude_ = sub_bucket_magnitude - 1;
+  const auto sub_bucket_count = uint64_t{1} << sub_bucket_magnitude;
+  sub_bucket_half_count_ = sub_bucket_count / 2;
+  sub_bucket_mask_ = sub_bucket_count - 1;
+
+  size_t buckets = 1;
+  auto smallest_untracked = sub_bucket_count;
+  while (smallest_untracked <= max) {
+    buckets++;
+    if (smallest_untracked > std::numeric_limits<uint64_t>::max() / 2) {
+      break;
+    }
+    smallest_untracked <<= 1;
+  }
+  counts_.resize((buckets + 1) * sub_bucket_half_count_);
+}
+
+size_t LatencyHistogram::index(uint64_t value) const {
+  const auto magnitude = kBits - __builtin_clzll(value | sub_bucket_mask_);
+  const auto bucket = magnitude - (sub_bucket_half_magnitude_ + 1);
+  const auto sub_bucket = value >> bucket;
+  return (static_cast<size_t>(bucket + 1) << sub_bucket_half_magnitude_) +
+         (sub_bucket - sub_bucket_half_count_);
+}
+
+uint64_t LatencyHistogram::lowest(size_t index) const {
+  auto bucket = static_cast<int>(index >> sub_bucket_half_magnitude_) - 1;
+  auto sub_bucket = (index & (sub_bucket_half_count_ - 1)) +
+                    sub_bucket_half_count_;
+  if (bucket < 0) {
+    sub_bucket -= sub_bucket_half_count_;
+    bucket = 0;
+  }
+  return sub_bucket << bucket;
+}
+
+uint64_t LatencyHistogram::highest(size_t index) const {
+  const auto bucket =
+    std::max(static_cast<int>(index >> sub_bucket_half_magnitude_) - 1, 0);
+  return lowest(index) + (uint64_t{1} << bucket) - 1;
+}
+
+void LatencyHistogram::record(uint64_t value) {
+  value = std::min(value, max_);
+  counts_[index(value)]++;
+  min_ = count_ == 0 ? value : std::min(min_, value);
+  max_recorded_ = std::max(max_recorded_, value);
+  sum_ += static_cast<double>(value);
+  count_++;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+  if (max_ != other.max_ || digits_ != other.digits_) {
+    throw invalid_argument("Only histograms of the same size can be merged");
+  }
+  if (other.count_ == 0) {
+    return;
+  }
+  for (auto i = 0U; i < counts_.size(); ++i) {
+    counts_[i] += other.counts_[i];
+  }
+  min_ = count_ == 0 ? other.min_ : std::min(min_, other.min_);
+  max_recorded_ = std::max(max_recorded_, other.max_recorded_);
+  sum_ += other.sum_;
+  count_ += other.count_;
+}
+
+double LatencyHistogram::mean() const {
+  return count_ == 0 ? 0 : sum_ / static_cast<double>(count_);
+}
+
+uint64_t LatencyHistogram::percentile(double percentile) const {
+  if (count_ == 0) {
+    return 0;
+  }
+  constexpr auto kPercent = 100.0;
+  const auto fraction = std::clamp(percentile, 0.0, kPercent) / kPercent;
+  const auto target = std::max(
+    static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(count_))),
+    uint64_t{1});
+
+  uint64_t seen = 0;
+  for (auto i = 0U; i < counts_.size(); ++i) {
+    seen += counts_[i];
+    if (seen >= target) {
+      return std::clamp(highest(i), min_, max_recorded_);
+    }
+  }
+  return max_recorded_;
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,93 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines a high dynamic range histogram to record latencies in
+ */
+
+#ifndef GUARD_PERF_SRC_HISTOGRAM
+#define GUARD_PERF_SRC_HISTOGRAM
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint64_t
+#include <vector>   // for vector
+
+namespace amdinfer {
+
+/// Default largest value that's kept precisely: an hour in microseconds
+constexpr uint64_t kDefaultHistogramMax = 3'600'000'000;
+/// Default number of significant decimal digits that values are kept to
+constexpr auto kDefaultHistogramDigits = 3;
+
+/**
+ * @brief The LatencyHistogram counts values in buckets whose width grows with
+ * the value so every value from 1 to the maximum is kept to a fixed number of
+ * significant digits at a fixed cost in memory, like HdrHistogram. Values
+ * larger than the maximum are counted as the maximum. It isn't thread-safe so
+ * each thread should record into its own histogram and merge them after.
+ */
+class LatencyHistogram {
+ public:
+  /**
+   * @brief Construct a new LatencyHistogram object
+   *
+   * @param max largest value to keep to the given precision
+   * @param digits number of significant digits to keep, between 1 and 5
+   */
+  explicit LatencyHistogram(uint64_t max = kDefaultHistogramMax,
+                            int digits = kDefaultHistogramDigits);
+
+  /// Count a value
+  void record(uint64_t value);
+  /// Add the counts of another histogram with the same max and digits
+  void merge(const LatencyHistogram& other);
+
+  /// Get the number of values recorded
+  [[nodiscard]] uint64_t count() const { return count_; }
+  /// Get the smallest value recorded or 0 if there are none
+  [[nodiscard]] uint64_t min() const { return min_; }
+  /// Get the largest value recorded or 0 if there are none
+  [[nodiscard]] uint64_t max() const { return max_recorded_; }
+  /// Get the mean of the values recorded or 0 if there are none
+  [[nodiscard]] double mean() const;
+  /**
+   * @brief Get the value that the given percentage of values are at or below,
+   * to the histogram's precision. It's 0 if there are no values
+   *
+   * @param percentile between 0 and 100
+   * @return uint64_t
+   */
+  [[nodiscard]] uint64_t percentile(double percentile) const;
+
+ private:
+  [[nodiscard]] size_t index(uint64_t value) const;
+  [[nodiscard]] uint64_t lowest(size_t index) const;
+  [[nodiscard]] uint64_t highest(size_t index) const;
+
+  uint64_t max_;
+  int digits_;
+  int sub_bucket_half_magnitude_;
+  uint64_t sub_bucket_half_count_;
+  uint64_t sub_bucket_mask_;
+  std::vector<uint64_t> counts_;
+  uint64_t count_ = 0;
+  uint64_t min_ = 0;
+  uint64_t max_recorded_ = 0;
+  double sum_ = 0;
+};
+
+}  // namespace amdinfer
+
+#endif  // GUARD_PERF_SRC_HISTOGRAM
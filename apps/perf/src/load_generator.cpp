@@ -0,0 +1,245 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the closed and open loop load that the perf app makes
+ */
+
+#include "load_generator.hpp"
+
+#include <atomic>     // for atomic
+#include <exception>  // for exception
+#include <mutex>      // for mutex, lock_guard
+#include <random>     // for exponential_distribution, mt19937_64
+#include <thread>     // for thread, sleep_until
+#include <utility>    // for move
+
+#include "amdinfer/clients/client.hpp"           // for Client
+#include "amdinfer/core/exceptions.hpp"          // for invalid_argument
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+
+namespace amdinfer {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Window {
+  Clock::time_point start;
+  Clock::time_point end;
+};
+
+Window makeWindow(Clock::time_point now, Seconds warmup, Seconds length) {
+  const auto start = now + std::chrono::duration_cast<Clock::duration>(warmup);
+  return {start, start + std::chrono::duration_cast<Clock::duration>(length)};
+}
+
+/// Counts of one thread, which are merged once the step ends
+struct Tally {
+  uint64_t requests = 0;
+  uint64_t errors = 0;
+  LatencyHistogram latencies;
+};
+
+bool send(const Client* client, const std::string& model,
+          const InferenceRequest& request) {
+  try {
+    const auto response = client->modelInfer(model, request);
+    return !response.isError();
+  } catch (const std::exception&) {
+    return false;
+  }
+}
+
+void count(Tally* tally, const Window& window, Clock::time_point sent,
+           Clock::time_point ended, bool succeeded) {
+  if (sent < window.start || ended > window.end) {
+    return;
+  }
+  tally->requests++;
+  if (succeeded) {
+    const auto latency =
+      std::chrono::duration_cast<std::chrono::microseconds>(ended - sent);
+    tally->latencies.record(latency.count());
+  } else {
+    tally->errors++;
+  }
+}
+
+StepResult merge(LoadMode mode, double load, Seconds window,
+                 const std::vector<Tally>& tallies) {
+  StepResult result;
+  result.mode = mode;
+  result.load = load;
+  result.window = window;
+  for (const auto& tally : tallies) {
+    result.requests += tally.requests;
+    result.errors += tally.errors;
+    result.latencies.merge(tally.latencies);
+  }
+  return result;
+}
+
+}  // namespace
+
+double StepResult::throughput() const {
+  return window.count() == 0
+           ? 0
+           : static_cast<double>(requests - errors) / window.count();
+}
+
+LoadGenerator::LoadGenerator(const Client* client, std::string model,
+                             std::vector<InferenceRequest> requests,
+                             Seconds warmup, Seconds window)
+  : client_(client),
+    model_(std::move(model)),
+    requests_(std::move(requests)),
+    warmup_(warmup),
+    window_(window) {
+  if (requests_.empty()) {
+    throw invalid_argument("At least one request is needed to make load");
+  }
+  if (warmup_.count() < 0 || window_.count() <= 0) {
+    throw invalid_argument(
+      "The warm-up can't be negative and the window must be positive");
+  }
+}
+
+StepResult LoadGenerator::runConcurrency(int concurrency) const {
+  if (concurrency <= 0) {
+    throw invalid_argument("The concurrency must be positive");
+  }
+
+  const auto window = makeWindow(Clock::now(), warmup_, window_);
+  std::atomic<size_t> next = 0;
+  std::vector<Tally> tallies(concurrency);
+  std::vector<std::thread> threads;
+  threads.reserve(concurrency);
+  for (auto& tally : tallies) {
+    threads.emplace_back([this, &window, &next, &tally]() {
+      while (true) {
+        const auto sent = Clock::now();
+        if (sent >= window.end) {
+          return;
+        }
+        const auto index = next.fetch_add(1, std::memory_order_relaxed);
+        const auto succeeded =
+          send(client_, model_, requests_[index % requests_.size()]);
+        count(&tally, window, sent, Clock::now(), succeeded);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  return merge(LoadMode::Concurrency, concurrency, window_, tallies);
+}
+
+StepResult LoadGenerator::runRequestRate(double rate, int threads,
+                                         uint64_t seed) const {
+  if (rate <= 0 || threads <= 0) {
+    throw invalid_argument(
+      "The request rate and the number of threads must be positive");
+  }
+
+  const auto now = Clock::now();
+  const auto window = makeWindow(now, warmup_, window_);
+
+  // each thread takes the next arrival from the schedule when it's free so
+  // arrivals that come while every thread is busy wait for one
+  std::mutex mutex;
+  std::mt19937_64 engine{seed};
+  std::exponential_distribution<double> gap{rate};
+  auto due = now;
+  size_t next = 0;
+
+  std::vector<Tally> tallies(threads);
+  std::vector<std::thread> senders;
+  senders.reserve(threads);
+  for (auto& tally : tallies) {
+    senders.emplace_back([&, this]() {
+      while (true) {
+        Clock::time_point arrival;
+        size_t index = 0;
+        {
+          const std::lock_guard lock{mutex};
+          if (due >= window.end) {
+            return;
+          }
+          arrival = due;
+          due += std::chrono::duration_cast<Clock::duration>(
+            Seconds{gap(engine)});
+          index = next++;
+        }
+        std::this_thread::sleep_until(arrival);
+        const auto succeeded =
+          send(client_, model_, requests_[index % requests_.size()]);
+        count(&tally, window, arrival, Clock::now(), succeeded);
+      }
+    });
+  }
+  for (auto& sender : senders) {
+    sender.join();
+  }
+  return merge(LoadMode::RequestRate, rate, window_, tallies);
+}
+
+StepResult replayTraffic(const Client* client,
+                         const std::vector<TrafficRecord>& records,
+                         const std::string& model, double speed,
+                         int threads) {
+  if (records.empty()) {
+    throw invalid_argument("The recording has no requests to replay");
+  }
+  if (speed <= 0 || threads <= 0) {
+    throw invalid_argument(
+      "The speed and the number of threads must be positive");
+  }
+
+  const auto start = Clock::now();
+  const auto first = records.front().arrival;
+  const Window window{start, Clock::time_point::max()};
+  std::atomic<size_t> next = 0;
+
+  std::vector<Tally> tallies(threads);
+  std::vector<std::thread> senders;
+  senders.reserve(threads);
+  for (auto& tally : tallies) {
+    senders.emplace_back([&]() {
+      while (true) {
+        const auto index = next.fetch_add(1, std::memory_order_relaxed);
+        if (index >= records.size()) {
+          return;
+        }
+        const auto& record = records[index];
+        const auto arrival =
+          start + std::chrono::duration_cast<Clock::duration>(
+                    std::chrono::duration<double, std::nano>(
+                      static_cast<double>((record.arrival - first).count()) /
+                      speed));
+        std::this_thread::sleep_until(arrival);
+        const auto succeeded = send(
+          client, model.empty() ? record.endpoint : model, *record.request);
+        count(&tally, window, arrival, Clock::now(), succeeded);
+      }
+    });
+  }
+  for (auto& sender : senders) {
+    sender.join();
+  }
+  return merge(LoadMode::Replay, speed, Clock::now() - start, tallies);
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,139 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the closed and open loop load that the perf app makes
+ */
+
+#ifndef GUARD_PERF_SRC_LOAD_GENERATOR
+#define GUARD_PERF_SRC_LOAD_GENERATOR
+
+#include <chrono>   // for duration
+#include <cstdint>  // for uint64_t
+#include <string>   // for string
+#include <vector>   // for vector
+
+#include "amdinfer/core/inference_request.hpp"  // for InferenceRequest
+#include "amdinfer/core/traffic_log.hpp"        // for TrafficRecord
+#include "histogram.hpp"                        // for LatencyHistogram
+
+namespace amdinfer {
+
+class Client;
+
+using Seconds = std::chrono::duration<double>;
+
+/// How the load of a step is defined
+enum class LoadMode {
+  /// a fixed number of requests are in flight, each sent as the last ends
+  Concurrency,
+  /// requests arrive at random at a mean rate, independent of the responses
+  RequestRate,
+  /// requests arrive when they did in a recording of a server's traffic
+  Replay,
+};
+
+/// The results of one step of load
+struct StepResult {
+  LoadMode mode = LoadMode::Concurrency;
+  /// the concurrency, the request rate or the speed of the replay
+  double load = 0;
+  /// requests that ended in the measurement window
+  uint64_t requests = 0;
+  /// requests in the window that failed. Their latency isn't recorded
+  uint64_t errors = 0;
+  /// length of the measurement window
+  Seconds window{};
+  /// latencies of the successful requests in microseconds
+  LatencyHistogram latencies;
+
+  /// Get the successful requests per second
+  [[nodiscard]] double throughput() const;
+};
+
+/**
+ * @brief The LoadGenerator sends requests to a model through any client and
+ * measures their latency. Each step runs for a warm-up period, which isn't
+ * measured, and then for a measurement window. A request counts in the window
+ * if it's sent after the warm-up and it ends before the window closes. The
+ * requests are sent by synchronous calls from a pool of threads so the client
+ * must support calls from many threads at once.
+ */
+class LoadGenerator {
+ public:
+  /**
+   * @brief Construct a new LoadGenerator object
+   *
+   * @param client client to send requests with
+   * @param model model to send requests to
+   * @param requests requests to send, taken in turn
+   * @param warmup time to run each step for before measuring
+   * @param window time to measure each step for
+   */
+  LoadGenerator(const Client* client, std::string model,
+                std::vector<InferenceRequest> requests, Seconds warmup,
+                Seconds window);
+
+  /**
+   * @brief Run a closed loop step with a fixed number of requests in flight
+   *
+   * @param concurrency number of requests in flight
+   * @return StepResult
+   */
+  [[nodiscard]] StepResult runConcurrency(int concurrency) const;
+
+  /**
+   * @brief Run an open loop step where requests arrive as a Poisson process.
+   * Latency is measured from when each request was due to be sent so requests
+   * that wait for a free thread include the wait, as they would if they were
+   * queued by a client application
+   *
+   * @param rate mean number of requests sent per second
+   * @param threads number of threads that send requests
+   * @param seed seed for the random arrival times
+   * @return StepResult
+   */
+  [[nodiscard]] StepResult runRequestRate(double rate, int threads,
+                                          uint64_t seed) const;
+
+ private:
+  const Client* client_;
+  std::string model_;
+  std::vector<InferenceRequest> requests_;
+  Seconds warmup_;
+  Seconds window_;
+};
+
+/**
+ * @brief Replay a recording of a server's traffic with the same gaps between
+ * the requests, or scaled by a speed, as one step. Like the request rate's
+ * steps, latency is measured from when each request was due. There's no
+ * warm-up so every request counts and the window spans the whole replay
+ *
+ * @param client client to send requests with
+ * @param records requests to send, in the order they arrived
+ * @param model model to send all of them to or, if empty, the one each was
+ * recorded for
+ * @param speed how many times faster than they were recorded to send them
+ * @param threads number of threads that send requests
+ * @return StepResult
+ */
+[[nodiscard]] StepResult replayTraffic(
+  const Client* client, const std::vector<TrafficRecord>& records,
+  const std::string& model, double speed, int threads);
+
+}  // namespace amdinfer
+
+#endif  // GUARD_PERF_SRC_LOAD_GENERATOR
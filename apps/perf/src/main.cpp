@@ -0,0 +1,575 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Parses the command-line arguments and implements the entrypoint for
+ * the amdinfer-perf executable
+ */
+
+#include <cstddef>              // for byte, size_t
+#include <cstdint>              // for uint64_t, int32_t
+#include <cxxopts/cxxopts.hpp>  // for value, OptionAdder, Options
+#include <exception>            // for exception
+#include <fstream>              // for ofstream
+#include <iostream>             // for cout, cerr
+#include <map>                  // for map
+#include <memory>               // for unique_ptr, make_unique
+#include <optional>             // for optional
+#include <stdexcept>            // for logic_error
+#include <string>               // for string, stod, stoi, to_string
+#include <utility>              // for move
+#include <variant>              // for visit
+#include <vector>               // for vector
+
+#include "amdinfer/amdinfer.hpp"  // for Client, Server, InferenceRequest
+#include "load_generator.hpp"     // for LoadGenerator, StepResult
+#include "report.hpp"             // for printStep, writeJson, writeCsv
+#include "tuner.hpp"              // for tune, TunedParameter, Trial
+
+#ifdef AMDINFER_ENABLE_HTTP
+#include "amdinfer/clients/websocket.hpp"  // for WebSocketClient
+#endif
+
+namespace {
+
+constexpr auto kDefaultWarmup = 2.0;
+constexpr auto kDefaultWindow = 10.0;
+constexpr auto kDefaultThreads = 64;
+constexpr auto kDefaultSloPercentile = 99.0;
+constexpr auto kDefaultTuneTrials = 32;
+constexpr auto kMicroseconds = 1000.0;
+
+/// Split a string on a separator
+std::vector<std::string> split(const std::string& value, char separator) {
+  std::vector<std::string> parts;
+  size_t begin = 0;
+  while (true) {
+    const auto end = value.find(separator, begin);
+    parts.push_back(value.substr(begin, end - begin));
+    if (end == std::string::npos) {
+      return parts;
+    }
+    begin = end + 1;
+  }
+}
+
+/// Parse a number, throwing if the whole string isn't one
+double parseNumber(const std::string& value) {
+  size_t parsed = 0;
+  double number = 0;
+  try {
+    number = std::stod(value, &parsed);
+  } catch (const std::logic_error&) {
+    parsed = 0;
+  }
+  if (value.empty() || parsed != value.size()) {
+    throw amdinfer::invalid_argument("Expected a number, got " + value);
+  }
+  return number;
+}
+
+/**
+ * @brief Parse a range given on the command line as start[:end[:step]]
+ *
+ * @param value the range
+ * @return std::vector<double> the loads in the range, from start up to end
+ */
+std::vector<double> parseRange(const std::string& value) {
+  const auto parts = split(value, ':');
+  if (parts.size() > 3) {
+    throw amdinfer::invalid_argument("Expected start[:end[:step]], got " +
+                                     value);
+  }
+  const auto start = parseNumber(parts[0]);
+  const auto end = parts.size() > 1 ? parseNumber(parts[1]) : start;
+  const auto step = parts.size() > 2 ? parseNumber(parts[2]) : 1.0;
+  if (start <= 0 || end < start || step <= 0) {
+    throw amdinfer::invalid_argument(
+      "Ranges must start above zero, end after they start and step forwards, "
+      "got " +
+      value);
+  }
+
+  // multiplying the step rather than adding it keeps errors from piling up
+  constexpr auto kTolerance = 1e-9;
+  std::vector<double> loads;
+  for (auto i = 0;; ++i) {
+    const auto load = start + i * step;
+    if (load > end + kTolerance) {
+      return loads;
+    }
+    loads.push_back(load);
+  }
+}
+
+/// Parse a load-time parameter given as key=value into the parameters
+void parseParameter(const std::string& value,
+                    amdinfer::ParameterMap* parameters) {
+  const auto separator = value.find('=');
+  if (separator == std::string::npos || separator == 0) {
+    throw amdinfer::invalid_argument("Expected key=value, got " + value);
+  }
+  const auto key = value.substr(0, separator);
+  const auto data = value.substr(separator + 1);
+  if (data == "true" || data == "false") {
+    parameters->put(key, data == "true");
+    return;
+  }
+  try {
+    size_t parsed = 0;
+    const auto integer = std::stoi(data, &parsed);
+    if (parsed == data.size()) {
+      parameters->put(key, static_cast<int32_t>(integer));
+      return;
+    }
+    const auto number = std::stod(data, &parsed);
+    if (parsed == data.size()) {
+      parameters->put(key, number);
+      return;
+    }
+  } catch (const std::logic_error&) {
+    // it's not a number so it's kept as a string
+  }
+  parameters->put(key, data);
+}
+
+/// Parse a parameter to tune given as key=value,value,...
+amdinfer::TunedParameter parseTunedParameter(const std::string& value) {
+  const auto separator = value.find('=');
+  if (separator == std::string::npos || separator == 0) {
+    throw amdinfer::invalid_argument("Expected key=value,value,..., got " +
+                                     value);
+  }
+  amdinfer::TunedParameter parameter{value.substr(0, separator), {}};
+  for (const auto& data : split(value.substr(separator + 1), ',')) {
+    amdinfer::ParameterMap parsed;
+    parseParameter(parameter.key + "=" + data, &parsed);
+    parameter.values.push_back(parsed.begin()->second);
+  }
+  return parameter;
+}
+
+/// Put all the parameters into another map, over any with the same keys
+void putParameters(const amdinfer::ParameterMap& parameters,
+                   amdinfer::ParameterMap* destination) {
+  for (const auto& [key, value] : parameters) {
+    std::visit([destination, &key = key](
+                 const auto& data) { destination->put(key, data); },
+               value);
+  }
+}
+
+/// Parse the shape of an input given as name:AxBxC
+void parseShape(const std::string& value,
+                std::map<std::string, std::vector<uint64_t>>* shapes) {
+  const auto separator = value.rfind(':');
+  if (separator == std::string::npos || separator == 0) {
+    throw amdinfer::invalid_argument("Expected name:AxBxC, got " + value);
+  }
+  std::vector<uint64_t> shape;
+  for (const auto& dimension : split(value.substr(separator + 1), 'x')) {
+    const auto size = parseNumber(dimension);
+    if (size <= 0 || static_cast<double>(static_cast<uint64_t>(size)) != size) {
+      throw amdinfer::invalid_argument(
+        "Dimensions must be positive integers, got " + value);
+    }
+    shape.push_back(static_cast<uint64_t>(size));
+  }
+  (*shapes)[value.substr(0, separator)] = std::move(shape);
+}
+
+/**
+ * @brief Make a request for the model, with an input of zeros for each of the
+ * model's inputs. The data is kept in the given storage, which must outlive
+ * the request
+ *
+ * @param metadata the model's metadata
+ * @param shapes shapes to use for inputs in place of those in the metadata
+ * @param storage storage for the data of the inputs
+ * @return amdinfer::InferenceRequest
+ */
+amdinfer::InferenceRequest makeRequest(
+  const amdinfer::ModelMetadata& metadata,
+  const std::map<std::string, std::vector<uint64_t>>& shapes,
+  std::vector<std::vector<std::byte>>* storage) {
+  amdinfer::InferenceRequest request;
+  for (const auto& input : metadata.getInputs()) {
+    const auto& name = input.getName();
+    auto found = shapes.find(name);
+    auto shape = found != shapes.end() ? found->second : input.getShape();
+    size_t size = 1;
+    for (const auto& dimension : shape) {
+      size *= dimension;
+    }
+    if (shape.empty() || size == 0) {
+      throw amdinfer::invalid_argument("Input " + name +
+                                       " has no fixed shape. Set it with "
+                                       "--shape " +
+                                       name + ":AxBxC");
+    }
+    const auto datatype = input.getDatatype();
+    auto& data = storage->emplace_back(size * datatype.size());
+    request.addInputTensor(amdinfer::InferenceRequestInput{
+      data.data(), std::move(shape), datatype, name});
+  }
+  return request;
+}
+
+std::unique_ptr<amdinfer::Client> makeClient(
+  const std::string& kind, const std::string& address,
+  const std::string& http_address, std::optional<amdinfer::Server>* server) {
+  if (kind == "native") {
+    server->emplace();
+    return std::make_unique<amdinfer::NativeClient>(&(server->value()));
+  }
+#ifdef AMDINFER_ENABLE_HTTP
+  if (kind == "http") {
+    return std::make_unique<amdinfer::HttpClient>(
+      address.empty() ? http_address : address);
+  }
+  if (kind == "websocket") {
+    return std::make_unique<amdinfer::WebSocketClient>(
+      address.empty() ? "ws://127.0.0.1:" + std::to_string(kDefaultHttpPort)
+                      : address,
+      http_address);
+  }
+#endif
+#ifdef AMDINFER_ENABLE_GRPC
+  if (kind == "grpc") {
+    return std::make_unique<amdinfer::GrpcClient>(
+      address.empty() ? "127.0.0.1:" + std::to_string(kDefaultGrpcPort)
+                      : address);
+  }
+#endif
+  throw amdinfer::invalid_argument("Unsupported client: " + kind);
+}
+
+}  // namespace
+
+/**
+ * @brief Parses command line options, makes load for a model and reports its
+ * throughput and latency
+ *
+ * @param argc Number of command line arguments
+ * @param argv Command line arguments
+ * @return int Return value at termination
+ */
+int main(int argc, char* argv[]) {
+  std::string model;
+  std::string worker;
+  bool load_model = false;
+  std::string model_repository;
+  std::vector<std::string> parameters;
+  std::string client_kind = "native";
+  std::string address;
+  std::string http_address =
+    "http://127.0.0.1:" + std::to_string(kDefaultHttpPort);
+  std::string concurrency_range;
+  std::string request_rate_range;
+  int threads = kDefaultThreads;
+  double warmup = kDefaultWarmup;
+  double window = kDefaultWindow;
+  uint64_t seed = 0;
+  std::vector<std::string> shapes;
+  std::string output;
+  std::string format;
+  std::string replay;
+  double replay_speed = 1;
+  std::vector<std::string> tuned;
+  double slo_ms = 0;
+  double slo_percentile = kDefaultSloPercentile;
+  size_t tune_trials = kDefaultTuneTrials;
+  bool save_config = false;
+
+  cxxopts::Options options(
+    "amdinfer-perf", "Measure the throughput and latency of a model");
+  // clang-format off
+  options.add_options()
+    ("model", "Model to send requests to, or the name of its endpoint",
+      cxxopts::value(model))
+    ("worker", "Load this worker and send requests to its endpoint",
+      cxxopts::value(worker))
+    ("load-model", "Load the model from the model repository first",
+      cxxopts::value(load_model))
+    ("model-repository", "Model repository for the native client's server",
+      cxxopts::value(model_repository))
+    ("parameter", "Load-time parameter as key=value. Can be repeated",
+      cxxopts::value(parameters))
+    ("client", "One of 'native', 'http', 'grpc' or 'websocket'",
+      cxxopts::value(client_kind))
+    ("address", "Address of the server for remote clients",
+      cxxopts::value(address))
+    ("http-address", "Address of the HTTP server for the websocket client",
+      cxxopts::value(http_address))
+    ("concurrency-range",
+      "Requests in flight as start[:end[:step]]. Defaults to 1",
+      cxxopts::value(concurrency_range))
+    ("request-rate-range",
+      "Requests per second as start[:end[:step]], sent as a Poisson process",
+      cxxopts::value(request_rate_range))
+    ("threads", "Threads that send requests at a request rate",
+      cxxopts::value(threads))
+    ("warmup", "Seconds to send requests for before measuring each step",
+      cxxopts::value(warmup))
+    ("window", "Seconds to measure each step for", cxxopts::value(window))
+    ("seed", "Seed for the random arrival times", cxxopts::value(seed))
+    ("shape", "Shape of an input as name:AxBxC. Can be repeated",
+      cxxopts::value(shapes))
+    ("replay", "Replay the requests in a traffic log with their timing",
+      cxxopts::value(replay))
+    ("replay-speed", "How many times faster than recorded to replay",
+      cxxopts::value(replay_speed))
+    ("output", "Write the results of all steps to this file",
+      cxxopts::value(output))
+    ("format", "One of 'json' or 'csv'. Defaults to the output's extension",
+      cxxopts::value(format))
+    ("tune", "Load-time parameter to tune as key=value,value,... Can be "
+      "repeated", cxxopts::value(tuned))
+    ("slo-ms", "Latency target in milliseconds for tuning",
+      cxxopts::value(slo_ms))
+    ("slo-percentile", "Percentile of the latencies that must meet the target",
+      cxxopts::value(slo_percentile))
+    ("tune-trials", "The most sets of parameters to try while tuning",
+      cxxopts::value(tune_trials))
+    ("save-config", "Save the best parameters to the model's config.pbtxt",
+      cxxopts::value(save_config))
+    ("help", "Print help");
+  // clang-format on
+
+  try {
+    auto result = options.parse(argc, argv);
+    if (result.count("help") != 0U) {
+      std::cout << options.help({""}) << "\n";
+      return 0;
+    }
+  } catch (const cxxopts::OptionException& e) {
+    std::cerr << "Error parsing options: " << e.what() << "\n";
+    return 1;
+  }
+
+  try {
+    // replayed requests go to the models they were recorded for unless one
+    // is given
+    if (!model.empty() && !worker.empty()) {
+      throw amdinfer::invalid_argument(
+        "Only one of --model and --worker can be set");
+    }
+    if (model.empty() && worker.empty() && replay.empty()) {
+      throw amdinfer::invalid_argument(
+        "A model, a worker or a recording must be given with --model, "
+        "--worker or --replay");
+    }
+    if (!concurrency_range.empty() && !request_rate_range.empty()) {
+      throw amdinfer::invalid_argument(
+        "Only one of --concurrency-range and --request-rate-range can be set");
+    }
+    const auto loads = parseRange(
+      request_rate_range.empty()
+        ? (concurrency_range.empty() ? "1" : concurrency_range)
+        : request_rate_range);
+    for (const auto load : loads) {
+      if (request_rate_range.empty() && static_cast<int>(load) != load) {
+        throw amdinfer::invalid_argument(
+          "The concurrency must be a whole number of requests");
+      }
+    }
+    if (format.empty()) {
+      const auto csv = std::string{".csv"};
+      format = output.size() >= csv.size() &&
+                   output.compare(output.size() - csv.size(), csv.size(),
+                                  csv) == 0
+                 ? "csv"
+                 : "json";
+    }
+    if (format != "json" && format != "csv") {
+      throw amdinfer::invalid_argument("Unsupported format: " + format);
+    }
+    amdinfer::ParameterMap load_parameters;
+    for (const auto& parameter : parameters) {
+      parseParameter(parameter, &load_parameters);
+    }
+    std::map<std::string, std::vector<uint64_t>> input_shapes;
+    for (const auto& shape : shapes) {
+      parseShape(shape, &input_shapes);
+    }
+    std::vector<amdinfer::TunedParameter> tuned_parameters;
+    for (const auto& parameter : tuned) {
+      tuned_parameters.push_back(parseTunedParameter(parameter));
+    }
+    if (!tuned_parameters.empty()) {
+      if (!replay.empty() || !request_rate_range.empty()) {
+        throw amdinfer::invalid_argument(
+          "Tuning uses the concurrency range and can't replay traffic or set "
+          "a request rate");
+      }
+      if (slo_ms <= 0 || slo_percentile <= 0 || slo_percentile > 100) {
+        throw amdinfer::invalid_argument(
+          "Tuning needs a latency target above zero given with --slo-ms at a "
+          "percentile above 0 and up to 100");
+      }
+    }
+    if (save_config &&
+        (tuned_parameters.empty() || client_kind != "native" ||
+         model.empty() || model_repository.empty())) {
+      throw amdinfer::invalid_argument(
+        "--save-config needs --tune, the native client, --model and "
+        "--model-repository");
+    }
+
+    std::optional<amdinfer::Server> server;
+    auto client = makeClient(client_kind, address, http_address, &server);
+    if (server.has_value() && !model_repository.empty()) {
+      server->setModelRepository(model_repository, false);
+    }
+    amdinfer::waitUntilServerReady(client.get());
+
+    std::vector<amdinfer::StepResult> steps;
+    if (!tuned_parameters.empty()) {
+      const amdinfer::LatencySlo slo{
+        slo_percentile, static_cast<uint64_t>(slo_ms * kMicroseconds)};
+      std::vector<std::vector<amdinfer::StepResult>> trial_steps;
+      auto run = [&](const amdinfer::ParameterMap& values) {
+        auto& results = trial_steps.emplace_back();
+        auto trial_parameters = load_parameters;
+        putParameters(values, &trial_parameters);
+        std::string endpoint;
+        try {
+          if (!worker.empty()) {
+            endpoint = client->workerLoad(worker, trial_parameters);
+          } else {
+            client->modelLoad(model, trial_parameters);
+            endpoint = model;
+          }
+          amdinfer::waitUntilModelReady(client.get(), endpoint);
+
+          std::vector<std::vector<std::byte>> storage;
+          std::vector<amdinfer::InferenceRequest> requests{makeRequest(
+            client->modelMetadata(endpoint), input_shapes, &storage)};
+          const amdinfer::LoadGenerator generator{
+            client.get(), endpoint, std::move(requests),
+            amdinfer::Seconds{warmup}, amdinfer::Seconds{window}};
+          // the latency only grows with the load so the sweep stops at the
+          // first step that misses the target
+          for (const auto load : loads) {
+            const auto concurrency = static_cast<int>(load);
+            results.push_back(generator.runConcurrency(concurrency));
+            amdinfer::printStep(std::cout, results.back());
+            if (results.back().latencies.percentile(slo.percentile) >
+                slo.latency_us) {
+              break;
+            }
+          }
+        } catch (const std::exception& e) {
+          // parameters that fail to load or serve don't end the search
+          std::cerr << e.what() << "\n";
+        }
+        if (endpoint.empty()) {
+          return results;
+        }
+        if (!worker.empty()) {
+          client->workerUnload(endpoint);
+        } else {
+          client->modelUnload(endpoint);
+        }
+        return results;
+      };
+      auto print = [&slo](const amdinfer::Trial& trial) {
+        std::cout << "trial ";
+        amdinfer::printTrial(std::cout, trial, slo);
+      };
+
+      const auto trials =
+        amdinfer::tune(tuned_parameters, slo, tune_trials, run, print);
+      const auto* best = amdinfer::findBest(trials);
+      if (best == nullptr) {
+        throw amdinfer::runtime_error(
+          "No set of parameters met the latency target");
+      }
+      steps = trial_steps[static_cast<size_t>(best - trials.data())];
+      std::cout << "best ";
+      amdinfer::printTrial(std::cout, *best, slo);
+
+      auto best_parameters = load_parameters;
+      putParameters(best->parameters, &best_parameters);
+      if (save_config) {
+        server->saveModelParameters(model, best_parameters);
+        std::cout << "Saved the parameters to the config of " << model
+                  << "\n";
+      } else {
+        amdinfer::printParameters(std::cout, best_parameters, "--parameter ");
+        std::cout << "\n";
+      }
+    } else {
+      if (!worker.empty()) {
+        model = client->workerLoad(worker, load_parameters);
+      } else if (load_model) {
+        client->modelLoad(model, load_parameters);
+      }
+      if (!model.empty()) {
+        amdinfer::waitUntilModelReady(client.get(), model);
+      }
+
+      if (!replay.empty()) {
+        amdinfer::TrafficLog log{replay};
+        std::vector<amdinfer::TrafficRecord> records;
+        while (auto record = log.next()) {
+          records.push_back(std::move(*record));
+        }
+        steps.push_back(amdinfer::replayTraffic(client.get(), records, model,
+                                                replay_speed, threads));
+        amdinfer::printStep(std::cout, steps.back());
+      } else {
+        std::vector<std::vector<std::byte>> storage;
+        std::vector<amdinfer::InferenceRequest> requests{
+          makeRequest(client->modelMetadata(model), input_shapes, &storage)};
+        const amdinfer::LoadGenerator generator{
+          client.get(), model, std::move(requests), amdinfer::Seconds{warmup},
+          amdinfer::Seconds{window}};
+
+        for (const auto load : loads) {
+          if (request_rate_range.empty()) {
+            steps.push_back(generator.runConcurrency(static_cast<int>(load)));
+          } else {
+            steps.push_back(generator.runRequestRate(load, threads, seed));
+          }
+          amdinfer::printStep(std::cout, steps.back());
+        }
+      }
+
+      if (!worker.empty()) {
+        client->workerUnload(model);
+      } else if (load_model) {
+        client->modelUnload(model);
+      }
+    }
+
+    if (!output.empty()) {
+      std::ofstream file{output};
+      if (!file) {
+        throw amdinfer::runtime_error("Could not open " + output);
+      }
+      if (format == "csv") {
+        amdinfer::writeCsv(file, steps);
+      } else {
+        amdinfer::writeJson(file, model, steps);
+      }
+    }
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << "\n";
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,136 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements how the perf app reports the results of its steps
+ */
+
+#include "report.hpp"
+
+#include <array>    // for array
+#include <iomanip>  // for setprecision
+#include <utility>  // for pair
+#include <variant>  // for visit
+
+namespace amdinfer {
+
+namespace {
+
+const std::array<std::pair<const char*, double>, 5> kPercentiles{
+  {{"p50", 50}, {"p90", 90}, {"p95", 95}, {"p99", 99}, {"p99.9", 99.9}}};
+
+const char* modeName(LoadMode mode) {
+  switch (mode) {
+    case LoadMode::Concurrency:
+      return "concurrency";
+    case LoadMode::RequestRate:
+      return "request_rate";
+    default:
+      return "replay";
+  }
+}
+
+std::string escape(const std::string& value) {
+  std::string escaped;
+  escaped.reserve(value.size());
+  for (const auto c : value) {
+    if (c == '"' || c == '\\') {
+      escaped += '\\';
+    }
+    escaped += c;
+  }
+  return escaped;
+}
+
+}  // namespace
+
+void printStep(std::ostream& os, const StepResult& step) {
+  const auto& latencies = step.latencies;
+  os << std::fixed << std::setprecision(2) << modeName(step.mode) << " "
+     << step.load << ": " << step.throughput() << " infer/s, "
+     << step.errors << " errors, latency (us) mean " << latencies.mean();
+  for (const auto& [name, percentile] : kPercentiles) {
+    os << " " << name << " " << latencies.percentile(percentile);
+  }
+  os << " max " << latencies.max() << "\n" << std::defaultfloat;
+}
+
+void printTrial(std::ostream& os, const Trial& trial, const LatencySlo& slo) {
+  printParameters(os, trial.parameters);
+  os << ": ";
+  if (trial.throughput <= 0) {
+    os << "no step met p" << slo.percentile << " " << slo.latency_us
+       << " us\n";
+    return;
+  }
+  os << std::fixed << std::setprecision(2) << trial.throughput
+     << " infer/s at concurrency " << std::defaultfloat << trial.load << ", p"
+     << slo.percentile << " " << trial.latency_us << " us\n";
+}
+
+void printParameters(std::ostream& os, const ParameterMap& parameters,
+                     const std::string& prefix) {
+  auto first = true;
+  for (const auto& [key, value] : parameters) {
+    os << (first ? "" : " ") << prefix << key << "=";
+    std::visit([&os](const auto& data) { os << std::boolalpha << data; },
+               value);
+    first = false;
+  }
+  os << std::noboolalpha;
+}
+
+void writeJson(std::ostream& os, const std::string& model,
+               const std::vector<StepResult>& steps) {
+  os << "{\n  \"model\": \"" << escape(model) << "\",\n  \"steps\": [";
+  for (auto i = 0U; i < steps.size(); ++i) {
+    const auto& step = steps[i];
+    const auto& latencies = step.latencies;
+    os << (i == 0 ? "\n" : ",\n") << "    {\"mode\": \""
+       << modeName(step.mode) << "\", \"load\": " << step.load
+       << ", \"requests\": " << step.requests
+       << ", \"errors\": " << step.errors
+       << ", \"window_s\": " << step.window.count()
+       << ", \"throughput\": " << step.throughput()
+       << ", \"latency_us\": {\"min\": " << latencies.min()
+       << ", \"mean\": " << latencies.mean();
+    for (const auto& [name, percentile] : kPercentiles) {
+      os << ", \"" << name << "\": " << latencies.percentile(percentile);
+    }
+    os << ", \"max\": " << latencies.max() << "}}";
+  }
+  os << "\n  ]\n}\n";
+}
+
+void writeCsv(std::ostream& os, const std::vector<StepResult>& steps) {
+  os << "mode,load,requests,errors,window_s,throughput,min_us,mean_us";
+  for (const auto& [name, percentile] : kPercentiles) {
+    os << "," << name << "_us";
+  }
+  os << ",max_us\n";
+  for (const auto& step : steps) {
+    const auto& latencies = step.latencies;
+    os << modeName(step.mode) << "," << step.load << "," << step.requests
+       << "," << step.errors << "," << step.window.count() << ","
+       << step.throughput() << "," << latencies.min() << ","
+       << latencies.mean();
+    for (const auto& [name, percentile] : kPercentiles) {
+      os << "," << latencies.percentile(percentile);
+    }
+    os << "," << latencies.max() << "\n";
+  }
+}
+
+}  // namespace amdinfer
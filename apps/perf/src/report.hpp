@@ -0,0 +1,64 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines how the perf app reports the results of its steps
+ */
+
+#ifndef GUARD_PERF_SRC_REPORT
+#define GUARD_PERF_SRC_REPORT
+
+#include <ostream>  // for ostream
+#include <string>   // for string
+#include <vector>   // for vector
+
+#include "load_generator.hpp"  // for StepResult
+#include "tuner.hpp"           // for LatencySlo, Trial
+
+namespace amdinfer {
+
+/// Print a line for people to read about a step as it ends
+void printStep(std::ostream& os, const StepResult& step);
+
+/// Print a line for people to read about a trial of the tuner as it ends
+void printTrial(std::ostream& os, const Trial& trial, const LatencySlo& slo);
+
+/// Print the parameters as key=value, separated by spaces
+void printParameters(std::ostream& os, const ParameterMap& parameters,
+                     const std::string& prefix = "");
+
+/**
+ * @brief Write the results of all the steps as a JSON object with the model's
+ * name and an array of steps. Latencies are in microseconds
+ *
+ * @param os stream to write to
+ * @param model name of the model the load was sent to
+ * @param steps results of the steps
+ */
+void writeJson(std::ostream& os, const std::string& model,
+               const std::vector<StepResult>& steps);
+
+/**
+ * @brief Write the results of all the steps as CSV with a header and a row for
+ * each step. Latencies are in microseconds
+ *
+ * @param os stream to write to
+ * @param steps results of the steps
+ */
+void writeCsv(std::ostream& os, const std::vector<StepResult>& steps);
+
+}  // namespace amdinfer
+
+#endif  // GUARD_PERF_SRC_REPORT
@@ -0,0 +1,117 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+/**
+ * @file
+ * @brief Implements how the perf app searches for the load-time parameters
+ * that serve the most within a latency target
+ */
+
+#include "tuner.hpp"
+
+#include <set>      // for set
+#include <variant>  // for visit
+
+namespace amdinfer {
+
+namespace {
+
+ParameterMap makeParameters(const std::vector<TunedParameter>& parameters,
+                            const std::vector<size_t>& indices) {
+  ParameterMap values;
+  for (size_t i = 0; i < parameters.size(); ++i) {
+    const auto& key = parameters[i].key;
+    std::visit([&values, &key](const auto& value) { values.put(key, value); },
+               parameters[i].values[indices[i]]);
+  }
+  return values;
+}
+
+}  // namespace
+
+Trial scoreTrial(const ParameterMap& parameters,
+                 const std::vector<StepResult>& steps, const LatencySlo& slo) {
+  Trial trial{parameters};
+  for (const auto& step : steps) {
+    const auto latency = step.latencies.percentile(slo.percentile);
+    if (step.errors == 0 && step.requests > 0 && latency <= slo.latency_us &&
+        step.throughput() > trial.throughput) {
+      trial.load = step.load;
+      trial.throughput = step.throughput();
+      trial.latency_us = latency;
+    }
+  }
+  return trial;
+}
+
+std::vector<Trial> tune(const std::vector<TunedParameter>& parameters,
+                        const LatencySlo& slo, size_t max_trials,
+                        const TrialFunction& run,
+                        const std::function<void(const Trial&)>& on_trial) {
+  std::vector<Trial> trials;
+  std::set<std::vector<size_t>> tried;
+  std::vector<size_t> best(parameters.size(), 0);
+  double best_throughput = -1;
+
+  auto try_values = [&](const std::vector<size_t>& indices) {
+    tried.insert(indices);
+    const auto values = makeParameters(parameters, indices);
+    trials.push_back(scoreTrial(values, run(values), slo));
+    on_trial(trials.back());
+    if (trials.back().throughput > best_throughput) {
+      best_throughput = trials.back().throughput;
+      best = indices;
+      return true;
+    }
+    return false;
+  };
+
+  if (max_trials == 0) {
+    return trials;
+  }
+  try_values(best);
+
+  bool improved = true;
+  while (improved) {
+    improved = false;
+    for (size_t i = 0; i < parameters.size(); ++i) {
+      for (size_t j = 0; j < parameters[i].values.size(); ++j) {
+        auto indices = best;
+        indices[i] = j;
+        if (tried.count(indices) != 0) {
+          continue;
+        }
+        if (trials.size() >= max_trials) {
+          return trials;
+        }
+        improved |= try_values(indices);
+      }
+    }
+  }
+  return trials;
+}
+
+const Trial* findBest(const std::vector<Trial>& trials) {
+  const Trial* best = nullptr;
+  for (const auto& trial : trials) {
+    if (trial.throughput > 0 &&
+        (best == nullptr || trial.throughput > best->throughput)) {
+      best = &trial;
+    }
+  }
+  return best;
+}
+
+}  // namespace amdinfer
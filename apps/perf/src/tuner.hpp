@@ -0,0 +1,109 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+/**
+ * @file
+ * @brief Defines how the perf app searches for the load-time parameters that
+ * serve the most within a latency target
+ */
+
+#ifndef GUARD_PERF_SRC_TUNER
+#define GUARD_PERF_SRC_TUNER
+
+#include <cstddef>     // for size_t
+#include <cstdint>     // for uint64_t
+#include <functional>  // for function
+#include <string>      // for string
+#include <vector>      // for vector
+
+#include "amdinfer/core/parameters.hpp"  // for Parameter, ParameterMap
+#include "load_generator.hpp"            // for StepResult
+
+namespace amdinfer {
+
+/// A load-time parameter to tune and the values to try for it
+struct TunedParameter {
+  std::string key;
+  std::vector<Parameter> values;
+};
+
+/// The latency that a step must meet to count
+struct LatencySlo {
+  /// percentile of the latencies to compare, between 0 and 100
+  double percentile = 99;
+  /// largest latency at the percentile in microseconds
+  uint64_t latency_us = 0;
+};
+
+/// The result of trying one set of values for the tuned parameters
+struct Trial {
+  /// the value of each tuned parameter
+  ParameterMap parameters;
+  /// the load of the step with the most throughput within the target, if any
+  double load = 0;
+  /// the throughput of that step or 0 if no step met the target
+  double throughput = 0;
+  /// the latency of that step at the target's percentile
+  uint64_t latency_us = 0;
+};
+
+/// Run the steps of load for a trial with the given values of the parameters
+using TrialFunction =
+  std::function<std::vector<StepResult>(const ParameterMap&)>;
+
+/**
+ * @brief Score a trial by the step with the most throughput whose latency at
+ * the target's percentile is within it. Steps with errors don't count
+ *
+ * @param parameters the values the steps ran with
+ * @param steps results of the steps
+ * @param slo the latency target
+ * @return Trial
+ */
+[[nodiscard]] Trial scoreTrial(const ParameterMap& parameters,
+                               const std::vector<StepResult>& steps,
+                               const LatencySlo& slo);
+
+/**
+ * @brief Search for the values of the parameters that serve the most within
+ * the latency target. Trying every combination quickly gets too slow so the
+ * search changes one parameter at a time, keeping the others at the best
+ * values found so far, and repeats over all the parameters until none of them
+ * improves. It starts from the first value of each parameter and no set of
+ * values is tried twice
+ *
+ * @param parameters the parameters to tune
+ * @param slo the latency target
+ * @param max_trials the most trials to run
+ * @param run runs the steps of a trial
+ * @param on_trial called with each trial as it ends
+ * @return std::vector<Trial> the trials in the order they ran
+ */
+[[nodiscard]] std::vector<Trial> tune(
+  const std::vector<TunedParameter>& parameters, const LatencySlo& slo,
+  size_t max_trials, const TrialFunction& run,
+  const std::function<void(const Trial&)>& on_trial);
+
+/**
+ * @brief Get the trial with the most throughput within the latency target
+ *
+ * @param trials the trials that ran
+ * @return const Trial* the best trial or nullptr if none met the target
+ */
+[[nodiscard]] const Trial* findBest(const std::vector<Trial>& trials);
+
+}  // namespace amdinfer
+
+#endif  // GUARD_PERF_SRC_TUNER
@@ -101,15 +101,19 @@ function(amdinfer_add_unit_tests tests tests_libs)
   endforeach()
 endfunction()
 
+# benchmarks added with this function are self-contained and get run by the
+# run_benchmarks target. An empty string can be passed for benchmarks that
+# don't link to any libraries
 function(amdinfer_add_benchmarks tests tests_libs)
   foreach(test lib_str IN ZIP_LISTS tests tests_libs)
 
-    string(REPLACE " " "" libs_no_spaces ${lib_str})
-    string(REPLACE "~" ";" libs ${libs_no_spaces})
+    string(REPLACE " " "" libs_no_spaces "${lib_str}")
+    string(REPLACE "~" ";" libs "${libs_no_spaces}")
 
     amdinfer_add_benchmark(${test})
     amdinfer_get_test_target(target ${test} benchmark)
 
     target_link_libraries(${target} PRIVATE ${libs})
+    set_property(GLOBAL APPEND PROPERTY AMDINFER_BENCHMARKS ${target})
   endforeach()
 endfunction()
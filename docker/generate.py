@@ -160,7 +160,7 @@ def add_dev_tools(manager: PackageManager):
             && {manager.install} \\
                 ca-certificates \\
                 git \\
-                # need cc for libb64, and gcc gets installed by xrt as a dependency
+                # gcc gets installed by xrt as a dependency
                 gcc \\
                 {cpp_package} \\
                 make \\
@@ -18,9 +18,13 @@
 
 // IWYU pragma: begin_exports
 #include "amdinfer/build_options.hpp"
+#include "amdinfer/clients/cached.hpp"
+#include "amdinfer/clients/coroutine.hpp"
 #include "amdinfer/clients/grpc.hpp"
 #include "amdinfer/clients/http.hpp"
 #include "amdinfer/clients/native.hpp"
+#include "amdinfer/clients/replicated.hpp"
+#include "amdinfer/core/bulk_job.hpp"
 #include "amdinfer/core/data_types.hpp"
 #include "amdinfer/core/exceptions.hpp"
 #include "amdinfer/core/inference_request.hpp"
@@ -28,6 +32,7 @@
 #include "amdinfer/core/model_metadata.hpp"
 #include "amdinfer/core/parameters.hpp"
 #include "amdinfer/core/server_metadata.hpp"
+#include "amdinfer/core/traffic_log.hpp"
 #include "amdinfer/declarations.hpp"
 #include "amdinfer/servers/server.hpp"
 // IWYU pragma: end_exports
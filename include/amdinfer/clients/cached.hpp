@@ -0,0 +1,208 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines a client that caches the metadata and readiness that another
+ * client gets from the server
+ */
+
+#ifndef GUARD_AMDINFER_CLIENTS_CACHED
+#define GUARD_AMDINFER_CLIENTS_CACHED
+
+#include <chrono>  // for milliseconds
+#include <memory>  // for unique_ptr
+#include <string>  // for string
+#include <vector>  // for vector
+
+#include "amdinfer/clients/client.hpp"  // IWYU pragma: export
+#include "amdinfer/declarations.hpp"    // for InferenceResponseFuture
+
+namespace amdinfer {
+
+class ParameterMap;
+
+/// How long cached metadata and readiness are used by default
+constexpr std::chrono::milliseconds kDefaultMetadataTtl{1000};
+
+/**
+ * @brief The CachedClient class implements the Client over another client and
+ * caches the server's metadata and the metadata and readiness of its models
+ * for a time to live so callers that ask often, such as gateways and loops
+ * waiting on a model, don't make a call each time. Only ready models are
+ * cached so a model that's loading is seen as soon as it's ready.
+ *
+ * A model's entries are dropped when it's loaded or unloaded through this
+ * client or when an inference request to it fails, since the model may be
+ * gone, and invalidate() drops them when another party reports a change.
+ * Other calls go straight to the wrapped client.
+ *
+ * @details Usage:
+ *
+ * CachedClient client{std::make_unique<GrpcClient>("127.0.0.1:50051")};
+ * waitUntilModelReady(&client, "echo");
+ * auto metadata = client.modelMetadata("echo");
+ */
+class CachedClient : public Client {
+ public:
+  /**
+   * @brief Constructs a new CachedClient object
+   *
+   * @param client the client to cache the results of, which must not be null
+   * @param ttl how long results are used before they're asked for again. It
+   * must not be negative
+   */
+  explicit CachedClient(std::unique_ptr<Client> client,
+                        std::chrono::milliseconds ttl = kDefaultMetadataTtl);
+  /// Copy constructor
+  CachedClient(CachedClient const&) = delete;
+  /// Copy assignment constructor
+  CachedClient& operator=(const CachedClient&) = delete;
+  /// Move constructor
+  CachedClient(CachedClient&& other) = default;
+  /// Move assignment constructor
+  CachedClient& operator=(CachedClient&& other) = default;
+  /**
+   * @brief Destructor. This is needed because CachedClientImpl is an
+   * incomplete type. The destructor is defaulted in the implementation. But
+   * having a non-default destructor here forces the need to explicitly specify
+   * the other special member functions by the Rule of 5.
+   */
+  ~CachedClient() override;
+
+  /**
+   * @brief Returns the server metadata, from the cache if it's fresh
+   *
+   * @return ServerMetadata
+   */
+  [[nodiscard]] ServerMetadata serverMetadata() const override;
+  /**
+   * @brief Checks if the server is live
+   *
+   * @return bool - true if server is live, false otherwise
+   */
+  [[nodiscard]] bool serverLive() const override;
+  /**
+   * @brief Checks if the server is ready
+   *
+   * @return bool - true if server is ready, false otherwise
+   */
+  [[nodiscard]] bool serverReady() const override;
+  /**
+   * @brief Checks if a model/worker is ready, from the cache if it was ready
+   * recently
+   *
+   * @param model name of the model to check
+   * @return bool - true if model is ready, false otherwise
+   */
+  [[nodiscard]] bool modelReady(const std::string& model) const override;
+  /**
+   * @brief Returns the metadata associated with a ready model/worker, from the
+   * cache if it's fresh
+   *
+   * @param model name of the model/worker to get metadata
+   * @return ModelMetadata
+   */
+  [[nodiscard]] ModelMetadata modelMetadata(
+    const std::string& model) const override;
+
+  /**
+   * @brief Loads a model with the given name and load-time parameters and
+   * drops its cached entries
+   *
+   * @param model name of the model to load from the model repository directory
+   * @param parameters load-time parameters for the worker supporting the model
+   */
+  void modelLoad(const std::string& model,
+                 const ParameterMap& parameters) const override;
+  /**
+   * @brief Unloads a previously loaded model and drops its cached entries
+   *
+   * @param model name of the model to unload
+   */
+  void modelUnload(const std::string& model) const override;
+
+  /**
+   * @brief Makes a synchronous inference request to the given model/worker.
+   * The model's cached entries are dropped if it fails
+   *
+   * @param model name of the model/worker to request inference to
+   * @param request the request
+   * @return InferenceResponse
+   */
+  [[nodiscard]] InferenceResponse modelInfer(
+    const std::string& model, const InferenceRequest& request) const override;
+  /**
+   * @brief Makes an asynchronous inference request to the given model/worker
+   *
+   * @param model name of the model/worker to request inference to
+   * @param request the request
+   * @return InferenceResponseFuture
+   */
+  [[nodiscard]] InferenceResponseFuture modelInferAsync(
+    const std::string& model, const InferenceRequest& request) const override;
+  /**
+   * @brief Gets a list of active models on the server, returning their names
+   *
+   * @return std::vector<std::string>
+   */
+  [[nodiscard]] std::vector<std::string> modelList() const override;
+
+  /**
+   * @brief Loads a worker with the given name and load-time parameters and
+   * drops the cached entries of its endpoint
+   *
+   * @param worker name of the worker to load
+   * @param parameters load-time parameters for the worker
+   * @return std::string
+   */
+  std::string workerLoad(const std::string& worker,
+                         const ParameterMap& parameters) const override;
+  /**
+   * @brief Unloads a previously loaded worker and drops its cached entries
+   *
+   * @param worker name of the worker to unload
+   */
+  void workerUnload(const std::string& worker) const override;
+
+  /**
+   * @brief Checks if the server has the requested number of a specific
+   * hardware device
+   *
+   * @param name name of the hardware device to check
+   * @param num number of the device that should exist at minimum
+   * @return bool - true if server has at least the requested number of the
+   * hardware device, false otherwise
+   */
+  [[nodiscard]] bool hasHardware(const std::string& name,
+                                 int num) const override;
+
+  /**
+   * @brief Drop the cached entries of a model, such as when its load or unload
+   * is reported by another party
+   *
+   * @param model name of the model
+   */
+  void invalidate(const std::string& model) const;
+  /// Drop all the cached entries
+  void invalidate() const;
+
+ private:
+  class CachedClientImpl;
+  std::unique_ptr<CachedClientImpl> impl_;
+};
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_CLIENTS_CACHED
@@ -21,9 +21,10 @@
 #ifndef GUARD_AMDINFER_CLIENTS_CLIENT
 #define GUARD_AMDINFER_CLIENTS_CLIENT
 
-#include <cstddef>  // for size_t
-#include <string>   // for string
-#include <vector>   // for vector
+#include <cstddef>     // for size_t
+#include <functional>  // for function
+#include <string>      // for string
+#include <vector>      // for vector
 
 #include "amdinfer/core/model_metadata.hpp"   // for ModelMetadata
 #include "amdinfer/core/server_metadata.hpp"  // for ServerMetadata
@@ -210,6 +211,43 @@ std::vector<InferenceResponse> inferAsyncOrderedBatched(
   Client* client, const std::string& model,
   const std::vector<InferenceRequest>& requests, size_t batch_size);
 
+/// Callback that gets each response with the index of its request
+using OrderedResponseCallback = std::function<void(size_t, InferenceResponse)>;
+
+/**
+ * @brief Makes inference requests in parallel to the specified model, keeping
+ * up to window requests in flight. A new request is sent as each response is
+ * taken so, unlike inferAsyncOrderedBatched, the pipeline doesn't drain
+ * between groups of requests. Responses are taken in the order of the
+ * requests so a slow response holds back the requests after it until it
+ * ends. Each response is passed to the callback as it's taken and isn't kept,
+ * which suits runs with many requests.
+ *
+ * @param client a pointer to a client object
+ * @param model the model/worker to make inference requests to
+ * @param requests a vector of requests
+ * @param window the number of requests to keep in flight
+ * @param callback called with each response and the index of its request, in
+ * order, from the calling thread
+ */
+void inferAsyncOrderedWindowed(Client* client, const std::string& model,
+                               const std::vector<InferenceRequest>& requests,
+                               size_t window,
+                               const OrderedResponseCallback& callback);
+/**
+ * @brief Makes inference requests in parallel to the specified model, keeping
+ * up to window requests in flight, and returns the responses in the same order
+ *
+ * @param client a pointer to a client object
+ * @param model the model/worker to make inference requests to
+ * @param requests a vector of requests
+ * @param window the number of requests to keep in flight
+ * @return std::vector<InferenceResponse>
+ */
+std::vector<InferenceResponse> inferAsyncOrderedWindowed(
+  Client* client, const std::string& model,
+  const std::vector<InferenceRequest>& requests, size_t window);
+
 }  // namespace amdinfer
 
 #endif  // GUARD_AMDINFER_CLIENTS_CLIENT
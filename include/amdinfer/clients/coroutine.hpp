@@ -0,0 +1,277 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines awaitable inference requests for C++20 coroutines. The library
+ * itself is built with C++17 so this header is header-only and is empty unless
+ * the including code is compiled with coroutine support.
+ */
+
+#ifndef GUARD_AMDINFER_CLIENTS_COROUTINE
+#define GUARD_AMDINFER_CLIENTS_COROUTINE
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+#include <condition_variable>  // for condition_variable
+#include <coroutine>           // for coroutine_handle, suspend_always
+#include <cstddef>             // for size_t
+#include <deque>               // for deque
+#include <exception>           // for terminate
+#include <mutex>               // for mutex, lock_guard, unique_lock
+#include <string>              // for string
+#include <utility>             // for move, exchange
+
+#include "amdinfer/core/inference_request.hpp"   // IWYU pragma: keep
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/declarations.hpp"             // for InferenceRequestPtr
+
+namespace amdinfer {
+
+class CoExecutor;
+
+/**
+ * @brief A coroutine that's run by a CoExecutor. It starts suspended and is
+ * started by passing it to CoExecutor::spawn, which then owns it. Exceptions
+ * that escape the coroutine terminate the program.
+ */
+class CoTask {
+ public:
+  struct promise_type {
+    CoTask get_return_object() {
+      return CoTask{std::coroutine_handle<promise_type>::from_promise(*this)};
+    }
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    auto final_suspend() noexcept;
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept { std::terminate(); }
+
+    CoExecutor* executor = nullptr;
+  };
+
+  /// Copy constructor
+  CoTask(const CoTask&) = delete;
+  /// Copy assignment constructor
+  CoTask& operator=(const CoTask&) = delete;
+  /// Move constructor
+  CoTask(CoTask&& other) noexcept
+    : handle_(std::exchange(other.handle_, nullptr)) {}
+  /// Move assignment constructor
+  CoTask& operator=(CoTask&& other) noexcept {
+    std::swap(handle_, other.handle_);
+    return *this;
+  }
+  /// Destroys the coroutine if it was never spawned
+  ~CoTask() {
+    if (handle_) {
+      handle_.destroy();
+    }
+  }
+
+ private:
+  friend class CoExecutor;
+  explicit CoTask(std::coroutine_handle<promise_type> handle)
+    : handle_(handle) {}
+
+  std::coroutine_handle<promise_type> handle_;
+};
+
+/**
+ * @brief A small executor that resumes coroutines on the thread that calls
+ * run(). Coroutines awaiting inference with this executor are resumed here
+ * instead of in the client's threads so a few threads can drive many requests
+ * and the coroutines never run concurrently with each other.
+ *
+ * @details Usage:
+ *
+ * CoExecutor executor;
+ * auto infer = [&](InferenceRequest request) -> CoTask {
+ *   auto response = co_await modelInferCo(client, "echo", request, &executor);
+ *   ...
+ * };
+ * executor.spawn(infer(request));
+ * executor.run();
+ */
+class CoExecutor {
+ public:
+  /**
+   * @brief Takes ownership of the task and queues it to start on the executor.
+   * This is thread-safe.
+   *
+   * @param task the task to run
+   */
+  void spawn(CoTask task) {
+    auto handle = std::exchange(task.handle_, nullptr);
+    handle.promise().executor = this;
+    std::lock_guard lock{mutex_};
+    tasks_++;
+    ready_.push_back(handle);
+    cv_.notify_one();
+  }
+
+  /**
+   * @brief Queues a suspended coroutine to be resumed on the executor. This is
+   * thread-safe.
+   *
+   * @param handle the coroutine to resume
+   */
+  void post(std::coroutine_handle<> handle) {
+    std::lock_guard lock{mutex_};
+    ready_.push_back(handle);
+    cv_.notify_one();
+  }
+
+  /// Resumes the queued coroutines until all the spawned tasks have finished
+  void run() {
+    while (true) {
+      std::unique_lock lock{mutex_};
+      cv_.wait(lock, [this]() { return !ready_.empty() || tasks_ == 0; });
+      if (ready_.empty()) {
+        return;
+      }
+      auto handle = ready_.front();
+      ready_.pop_front();
+      lock.unlock();
+      handle.resume();
+    }
+  }
+
+ private:
+  friend struct CoTask::promise_type;
+
+  void finish() {
+    // tasks resumed without the executor finish in other threads so run() has
+    // to be woken up to see that they're done
+    std::lock_guard lock{mutex_};
+    tasks_--;
+    cv_.notify_all();
+  }
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::coroutine_handle<>> ready_;
+  size_t tasks_ = 0;
+};
+
+inline auto CoTask::promise_type::final_suspend() noexcept {
+  // the frame is destroyed here so nothing has to hold on to finished tasks
+  struct FinalAwaiter {
+    [[nodiscard]] bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<promise_type> handle) noexcept {
+      auto* executor = handle.promise().executor;
+      handle.destroy();
+      executor->finish();
+    }
+    void await_resume() const noexcept {}
+  };
+  return FinalAwaiter{};
+}
+
+/**
+ * @brief Awaits the response to an inference request made with the callback
+ * overload of a client's modelInferAsync. The response is stored in the
+ * awaiter, which lives in the suspended coroutine's frame, so no promise or
+ * future is allocated for it.
+ *
+ * @tparam ClientType the client that makes the request
+ * @tparam RequestType how the client's callback overload takes the request
+ */
+template <typename ClientType, typename RequestType>
+class InferenceAwaiter {
+ public:
+  InferenceAwaiter(const ClientType& client, const std::string& model,
+                   RequestType request, CoExecutor* executor)
+    : client_(&client),
+      model_(&model),
+      request_(std::move(request)),
+      executor_(executor) {}
+
+  [[nodiscard]] bool await_ready() const noexcept { return false; }
+
+  void await_suspend(std::coroutine_handle<> handle) {
+    // the response may arrive before this returns so the awaiter must not be
+    // touched after the request is made
+    client_->modelInferAsync(
+      *model_, unwrap(request_),
+      [this, handle](const InferenceResponse& response) {
+        response_ = response;
+        if (executor_ != nullptr) {
+          executor_->post(handle);
+        } else {
+          handle.resume();
+        }
+      });
+  }
+
+  InferenceResponse await_resume() { return std::move(response_); }
+
+ private:
+  static const InferenceRequest& unwrap(const InferenceRequest* request) {
+    return *request;
+  }
+  static InferenceRequestPtr unwrap(InferenceRequestPtr& request) {
+    return std::move(request);
+  }
+
+  const ClientType* client_;
+  const std::string* model_;
+  RequestType request_;
+  CoExecutor* executor_;
+  InferenceResponse response_;
+};
+
+/**
+ * @brief Makes an inference request that can be awaited in a coroutine with a
+ * client that copies the request, such as the GrpcClient and HttpClient. The
+ * request and model only need to be valid until the request is made. Without
+ * an executor, the coroutine is resumed in the client's thread that gets the
+ * response so it should hand off any heavy work.
+ *
+ * @param client the client to make the request with
+ * @param model name of the model/worker to request inference to
+ * @param request the request
+ * @param executor the executor to resume the coroutine on, if any
+ * @return an awaitable that returns the InferenceResponse
+ */
+template <typename ClientType>
+auto modelInferCo(const ClientType& client, const std::string& model,
+                  const InferenceRequest& request,
+                  CoExecutor* executor = nullptr) {
+  return InferenceAwaiter<ClientType, const InferenceRequest*>{
+    client, model, &request, executor};
+}
+
+/**
+ * @brief Makes an inference request that can be awaited in a coroutine with a
+ * client that takes a shared request, such as the NativeClient, which reads
+ * the inputs in place so they must stay valid until the response arrives.
+ *
+ * @param client the client to make the request with
+ * @param model name of the model/worker to request inference to
+ * @param request the request
+ * @param executor the executor to resume the coroutine on, if any
+ * @return an awaitable that returns the InferenceResponse
+ */
+template <typename ClientType>
+auto modelInferCo(const ClientType& client, const std::string& model,
+                  InferenceRequestPtr request, CoExecutor* executor = nullptr) {
+  return InferenceAwaiter<ClientType, InferenceRequestPtr>{
+    client, model, std::move(request), executor};
+}
+
+}  // namespace amdinfer
+
+#endif
+
+#endif  // GUARD_AMDINFER_CLIENTS_COROUTINE
@@ -25,8 +25,9 @@
 #include <string>  // for string
 #include <vector>  // for vector
 
-#include "amdinfer/clients/client.hpp"  // IWYU pragma: export
-#include "amdinfer/declarations.hpp"    // for InferenceResponseFuture
+#include "amdinfer/clients/client.hpp"     // IWYU pragma: export
+#include "amdinfer/core/compression.hpp"  // for CompressionOptions
+#include "amdinfer/declarations.hpp"      // for Callback, InferenceRes...
 
 namespace grpc {
 class Channel;
@@ -52,15 +53,35 @@ class GrpcClient : public Client {
   /**
    * @brief Constructs a new GrpcClient object
    *
-   * @param address Address of the server to connect to
+   * @param address Address of the server to connect to e.g. localhost:50051
+   * or unix:<path> for the server's Unix domain socket
+   * @param compression How inference requests are compressed
+   */
+  explicit GrpcClient(const std::string& address,
+                      const CompressionOptions& compression = {});
+  /**
+   * @brief Constructs a new GrpcClient object that spreads its requests over
+   * several channels. Each channel has its own connection to the server and
+   * its own completion queue thread so one connection doesn't hold up the
+   * client or queue all the requests on one of the server's completion
+   * queues. Asynchronous requests are sent on the channel with the fewest in
+   * flight and the others take turns.
+   *
+   * @param address Address of the server to connect to e.g. localhost:50051
+   * or unix:<path> for the server's Unix domain socket
+   * @param channels Number of channels to open, which must be positive
+   * @param compression How inference requests are compressed
    */
-  explicit GrpcClient(const std::string& address);
+  GrpcClient(const std::string& address, int channels,
+             const CompressionOptions& compression = {});
   /**
    * @brief Constructs a new GrpcClient object
    *
    * @param channel an existing gRPC channel to reuse to connect to the server
+   * @param compression How inference requests are compressed
    */
-  explicit GrpcClient(const std::shared_ptr<::grpc::Channel>& channel);
+  explicit GrpcClient(const std::shared_ptr<::grpc::Channel>& channel,
+                      const CompressionOptions& compression = {});
 
   /// Copy constructor
   GrpcClient(GrpcClient const&) = delete;
@@ -146,7 +167,9 @@ class GrpcClient : public Client {
    * @brief Makes an asynchronous inference request to the given model/worker.
    * The contents of the request depends on the model/worker that the request
    * is for. The user must save the Future object and use it to get the results
-   * of the inference later.
+   * of the inference later. The request is sent right away and its response is
+   * received by the client's completion queue thread so many requests can be
+   * in flight without a thread each. Errors are returned as error responses.
    *
    * @param model name of the model/worker to request inference to
    * @param request the request
@@ -154,6 +177,34 @@ class GrpcClient : public Client {
    */
   [[nodiscard]] InferenceResponseFuture modelInferAsync(
     const std::string& model, const InferenceRequest& request) const override;
+  /**
+   * @brief Makes an asynchronous inference request to the given model/worker
+   * and calls the callback with its response, which saves making a future for
+   * each request. The callback runs in the client's completion queue thread so
+   * it should return quickly and must not throw. Errors are returned as error
+   * responses. Destroying the client waits for the requests in flight.
+   *
+   * @param model name of the model/worker to request inference to
+   * @param request the request
+   * @param callback the function to call with the response
+   */
+  void modelInferAsync(const std::string& model,
+                       const InferenceRequest& request,
+                       Callback callback) const;
+  /**
+   * @brief Makes several inference requests to the given model/worker in one
+   * call using the server's infer_batch extension, which saves the cost of a
+   * call for each of many small requests. The requests are independent and may
+   * even be batched apart. Errors in a request are returned as its error
+   * response.
+   *
+   * @param model name of the model/worker to request inference to
+   * @param requests the requests
+   * @return std::vector<InferenceResponse> the responses, in order
+   */
+  [[nodiscard]] std::vector<InferenceResponse> modelInferBatch(
+    const std::string& model,
+    const std::vector<InferenceRequest>& requests) const;
   /**
    * @brief Gets a list of active models on the server, returning their names
    *
@@ -25,13 +25,17 @@
 #include <string>  // for string
 #include <vector>  // for vector
 
-#include "amdinfer/clients/client.hpp"  // IWYU pragma: export
-#include "amdinfer/declarations.hpp"    // for StringMap
+#include "amdinfer/clients/client.hpp"     // IWYU pragma: export
+#include "amdinfer/core/compression.hpp"  // for CompressionOptions
+#include "amdinfer/declarations.hpp"      // for Callback, StringMap
 
 namespace amdinfer {
 
 class ParameterMap;
 
+/// Default number of the HttpClient's connections that share an event loop
+constexpr auto kDefaultHttpClientsPerLoop = 16;
+
 /**
  * @brief The HttpClient class implements the Client using HTTP REST
  *
@@ -57,10 +61,17 @@ class HttpClient : public Client {
    * @param address Address of the server to connect to
    * @param headers Key-value pairs that should be added to the HTTP headers for
    * all requests
-   * @param parallelism Max number of requests that can be sent in parallel
+   * @param parallelism Max number of requests that can be sent in parallel.
+   * Each request is sent on the connection with the fewest requests in flight
+   * @param clients_per_loop Number of connections that share each event loop
+   * thread
+   * @param compression How inference requests are compressed. If set, the
+   * client also accepts responses compressed with gzip or deflate
    */
   HttpClient(const std::string& address, const StringMap& headers,
-             int parallelism);
+             int parallelism,
+             int clients_per_loop = kDefaultHttpClientsPerLoop,
+             const CompressionOptions& compression = {});
 
   /// Copy constructor
   HttpClient(HttpClient const&) = delete;
@@ -154,6 +165,34 @@ class HttpClient : public Client {
    */
   [[nodiscard]] InferenceResponseFuture modelInferAsync(
     const std::string& model, const InferenceRequest& request) const override;
+  /**
+   * @brief Makes several inference requests to the given model/worker in one
+   * call using the server's infer_batch extension, which saves the cost of a
+   * call for each of many small requests. The requests are independent and may
+   * even be batched apart. Their data is sent in the JSON and errors in a
+   * request are returned as its error response.
+   *
+   * @param model name of the model/worker to request inference to
+   * @param requests the requests
+   * @return std::vector<InferenceResponse> the responses, in order
+   */
+  [[nodiscard]] std::vector<InferenceResponse> modelInferBatch(
+    const std::string& model,
+    const std::vector<InferenceRequest>& requests) const;
+  /**
+   * @brief Makes an asynchronous inference request to the given model/worker
+   * and calls the callback with its response, which saves making a future for
+   * each request. The callback runs in the connection's event loop thread so
+   * it should return quickly and must not throw. Errors are returned as error
+   * responses.
+   *
+   * @param model name of the model/worker to request inference to
+   * @param request the request
+   * @param callback the function to call with the response
+   */
+  void modelInferAsync(const std::string& model,
+                       const InferenceRequest& request,
+                       Callback callback) const;
   /**
    * @brief Gets a list of active models on the server, returning their names
    *
@@ -149,6 +149,30 @@ class NativeClient : public Client {
    */
   [[nodiscard]] InferenceResponseFuture modelInferAsync(
     const std::string& model, const InferenceRequest& request) const override;
+  /**
+   * @brief Makes an asynchronous inference request to the given model/worker
+   * without copying it. The server takes over the request until its response
+   * and reads its input data in place so the data must stay valid and
+   * unchanged until then. The request must not be reused for other requests.
+   *
+   * @param model name of the model/worker to request inference to
+   * @param request the request
+   * @return InferenceResponseFuture
+   */
+  [[nodiscard]] InferenceResponseFuture modelInferAsync(
+    const std::string& model, InferenceRequestPtr request) const;
+  /**
+   * @brief Makes an asynchronous inference request like the overload above
+   * but calls the callback with the response instead of returning a future,
+   * which saves making a promise for each request. The callback runs in the
+   * server's threads so it should return quickly.
+   *
+   * @param model name of the model/worker to request inference to
+   * @param request the request
+   * @param callback the function to call with the response
+   */
+  void modelInferAsync(const std::string& model, InferenceRequestPtr request,
+                       Callback callback) const;
   /**
    * @brief Gets a list of active models on the server, returning their names
    *
@@ -0,0 +1,203 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines a client that spreads its requests over several replicas of
+ * a server
+ */
+
+#ifndef GUARD_AMDINFER_CLIENTS_REPLICATED
+#define GUARD_AMDINFER_CLIENTS_REPLICATED
+
+#include <memory>  // for unique_ptr
+#include <string>  // for string
+#include <vector>  // for vector
+
+#include "amdinfer/clients/client.hpp"  // IWYU pragma: export
+#include "amdinfer/declarations.hpp"    // for InferenceResponseFuture
+
+namespace amdinfer {
+
+class ParameterMap;
+
+/**
+ * @brief The ReplicatedClient class implements the Client over the clients of
+ * several replicas of a server. Each inference request goes to the replica
+ * with the lowest latency, which is tracked as a moving average of its recent
+ * requests and scaled by the requests it has in flight so a burst isn't all
+ * sent to one replica.
+ *
+ * With hedging, a request that hasn't been answered by the given percentile of
+ * the recent latencies is sent again to the next best replica and the first
+ * successful response is returned. The Client has no way to cancel a request
+ * so the other response is dropped when it arrives. Requests that set the
+ * "timeout_ms" parameter are dropped by the server if they're still queued
+ * once it passes, which bounds the work that the loser may cost.
+ *
+ * A request's input data must stay valid until its response is returned, and
+ * until the losing duplicate is sent, so the replicas should be clients that
+ * copy the request when it's sent, such as the GrpcClient and HttpClient.
+ *
+ * @details Usage:
+ *
+ * std::vector<std::unique_ptr<Client>> replicas;
+ * replicas.push_back(std::make_unique<GrpcClient>("server-0:50051"));
+ * replicas.push_back(std::make_unique<GrpcClient>("server-1:50051"));
+ * ReplicatedClient client{std::move(replicas), 0.95};
+ * auto response = client.modelInfer("echo", request);
+ */
+class ReplicatedClient : public Client {
+ public:
+  /**
+   * @brief Constructs a new ReplicatedClient object
+   *
+   * @param replicas the clients of the replicas, which must not be empty
+   * @param hedge_percentile if positive, requests are sent to a second replica
+   * once they take longer than this percentile of the recent latencies. It
+   * must be less than 1.
+   */
+  explicit ReplicatedClient(std::vector<std::unique_ptr<Client>> replicas,
+                            double hedge_percentile = 0);
+  /// Copy constructor
+  ReplicatedClient(ReplicatedClient const&) = delete;
+  /// Copy assignment constructor
+  ReplicatedClient& operator=(const ReplicatedClient&) = delete;
+  /// Move constructor
+  ReplicatedClient(ReplicatedClient&& other) = default;
+  /// Move assignment constructor
+  ReplicatedClient& operator=(ReplicatedClient&& other) = default;
+  /**
+   * @brief Destructor. This is needed because ReplicatedClientImpl is an
+   * incomplete type. The destructor is defaulted in the implementation. But
+   * having a non-default destructor here forces the need to explicitly specify
+   * the other special member functions by the Rule of 5.
+   */
+  ~ReplicatedClient() override;
+
+  /**
+   * @brief Returns the server metadata of the fastest replica
+   *
+   * @return ServerMetadata
+   */
+  [[nodiscard]] ServerMetadata serverMetadata() const override;
+  /**
+   * @brief Checks if any replica is live
+   *
+   * @return bool - true if a replica is live, false otherwise
+   */
+  [[nodiscard]] bool serverLive() const override;
+  /**
+   * @brief Checks if any replica is ready
+   *
+   * @return bool - true if a replica is ready, false otherwise
+   */
+  [[nodiscard]] bool serverReady() const override;
+  /**
+   * @brief Checks if a model/worker is ready on any replica
+   *
+   * @param model name of the model to check
+   * @return bool - true if model is ready, false otherwise
+   */
+  [[nodiscard]] bool modelReady(const std::string& model) const override;
+  /**
+   * @brief Returns the metadata associated with a ready model/worker from the
+   * fastest replica
+   *
+   * @param model name of the model/worker to get metadata
+   * @return ModelMetadata
+   */
+  [[nodiscard]] ModelMetadata modelMetadata(
+    const std::string& model) const override;
+
+  /**
+   * @brief Loads a model with the given name and load-time parameters on every
+   * replica
+   *
+   * @param model name of the model to load from the model repository directory
+   * @param parameters load-time parameters for the worker supporting the model
+   */
+  void modelLoad(const std::string& model,
+                 const ParameterMap& parameters) const override;
+  /**
+   * @brief Unloads a previously loaded model from every replica
+   *
+   * @param model name of the model to unload
+   */
+  void modelUnload(const std::string& model) const override;
+
+  /**
+   * @brief Makes a synchronous inference request to the given model/worker on
+   * the fastest replica, hedging it if enabled
+   *
+   * @param model name of the model/worker to request inference to
+   * @param request the request
+   * @return InferenceResponse
+   */
+  [[nodiscard]] InferenceResponse modelInfer(
+    const std::string& model, const InferenceRequest& request) const override;
+  /**
+   * @brief Makes an asynchronous inference request to the given model/worker
+   * on the fastest replica, hedging it if enabled
+   *
+   * @param model name of the model/worker to request inference to
+   * @param request the request
+   * @return InferenceResponseFuture
+   */
+  [[nodiscard]] InferenceResponseFuture modelInferAsync(
+    const std::string& model, const InferenceRequest& request) const override;
+  /**
+   * @brief Gets a list of active models on the fastest replica
+   *
+   * @return std::vector<std::string>
+   */
+  [[nodiscard]] std::vector<std::string> modelList() const override;
+
+  /**
+   * @brief Loads a worker with the given name and load-time parameters on
+   * every replica
+   *
+   * @param worker name of the worker to load
+   * @param parameters load-time parameters for the worker
+   * @return std::string - the endpoint of the worker on the first replica
+   */
+  std::string workerLoad(const std::string& worker,
+                         const ParameterMap& parameters) const override;
+  /**
+   * @brief Unloads a previously loaded worker from every replica
+   *
+   * @param worker name of the worker to unload
+   */
+  void workerUnload(const std::string& worker) const override;
+
+  /**
+   * @brief Checks if every replica has the requested number of a specific
+   * hardware device
+   *
+   * @param name name of the hardware device to check
+   * @param num number of the device that should exist at minimum
+   * @return bool - true if the replicas have at least the requested number of
+   * the hardware device, false otherwise
+   */
+  [[nodiscard]] bool hasHardware(const std::string& name,
+                                 int num) const override;
+
+ private:
+  class ReplicatedClientImpl;
+  std::unique_ptr<ReplicatedClientImpl> impl_;
+};
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_CLIENTS_REPLICATED
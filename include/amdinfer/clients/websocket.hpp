@@ -21,9 +21,10 @@
 #ifndef GUARD_AMDINFER_CLIENTS_WEBSOCKET
 #define GUARD_AMDINFER_CLIENTS_WEBSOCKET
 
-#include <memory>  // for unique_ptr
-#include <string>  // for string
-#include <vector>  // for vector
+#include <cstddef>  // for size_t
+#include <memory>   // for unique_ptr
+#include <string>   // for string
+#include <vector>   // for vector
 
 #include "amdinfer/clients/client.hpp"  // IWYU pragma: export
 #include "amdinfer/declarations.hpp"    // for InferenceResponseFuture
@@ -32,6 +33,28 @@ namespace amdinfer {
 
 class ParameterMap;
 
+/// The protocol that a WebSocketClient uses for inference over websocket
+enum class WebSocketProtocol {
+  /// requests are sent as JSON and each message back holds one output's data
+  Json,
+  /// requests and responses are sent whole as binary frames
+  Binary,
+};
+
+/**
+ * @brief What the server does with a connection's responses while its send
+ * window is full, i.e. while the client hasn't yet acknowledged enough of the
+ * bytes sent to it
+ */
+enum class WebSocketWindowPolicy {
+  /// the worker producing the responses waits until there's room
+  Block,
+  /// responses that don't fit are dropped
+  Skip,
+  /// responses are queued and the oldest queued ones are dropped to make room
+  DropOldest,
+};
+
 /**
  * @brief The WebSocketClient class implements the Client using websocket. It
  * reuses the HttpClient for most transactions with the exception of some
@@ -52,9 +75,16 @@ class WebSocketClient : public Client {
    *
    * @param ws_address address of the websocket server to connect to
    * @param http_address address of the HTTP server to connect to
+   * @param protocol protocol to negotiate with the server when connecting
+   * @param window bytes the server may send before the client acknowledges
+   * them, which it does as messages are received with modelRecv. If it's
+   * zero, the server sends responses as fast as they're produced
+   * @param policy what the server does with responses while the window is full
    */
-  WebSocketClient(const std::string& ws_address,
-                  const std::string& http_address);
+  WebSocketClient(
+    const std::string& ws_address, const std::string& http_address,
+    WebSocketProtocol protocol = WebSocketProtocol::Json, size_t window = 0,
+    WebSocketWindowPolicy policy = WebSocketWindowPolicy::Block);
 
   /// Copy constructor
   WebSocketClient(WebSocketClient const&) = delete;
@@ -203,9 +233,19 @@ class WebSocketClient : public Client {
    * modelInferWs request. The user should know beforehand how many messages are
    * expected and should call this method the same number of times.
    *
-   * @return std::string a JSON object encoded as a string
+   * @return std::string a JSON object encoded as a string or the raw bytes of
+   * a binary message
    */
   [[nodiscard]] std::string modelRecv() const;
+  /**
+   * @brief Gets one response from the websocket server with the binary
+   * protocol, decoding its binary frame. Errors from the server are returned as
+   * error responses. If the message isn't a binary frame, an exception is
+   * thrown.
+   *
+   * @return InferenceResponse
+   */
+  [[nodiscard]] InferenceResponse modelRecvResponse() const;
   /**
    * @brief Closes the websocket connection
    *
@@ -0,0 +1,136 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the bulk jobs that run a dataset file through a model and
+ * the reader of their results
+ */
+
+#ifndef GUARD_AMDINFER_CORE_BULK_JOB
+#define GUARD_AMDINFER_CORE_BULK_JOB
+
+#include <cstddef>     // for size_t
+#include <cstdint>     // for uint64_t
+#include <filesystem>  // for path
+#include <memory>      // for unique_ptr
+#include <optional>    // for optional
+#include <string>      // for string
+
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+
+namespace amdinfer {
+
+namespace util {
+class MappedFile;
+}  // namespace util
+
+/// Most requests that a bulk job has in flight at once by default
+constexpr size_t kDefaultBulkInFlight = 1024;
+
+/**
+ * @brief What a bulk job runs. The dataset's format is picked by its
+ * extension:
+ *
+ *   - .npy: one input whose first dimension is the samples
+ *   - .safetensors: one input per tensor, named by its key, whose first
+ *     dimensions are all the samples
+ *   - otherwise: requests in the binary wire format back to back, such as a
+ *     traffic log recorded with payloads, one per sample
+ *
+ * Each sample is sent to the model as a request of its own so the model's
+ * batcher makes full batches of them.
+ */
+struct BulkJobOptions {
+  /// the model, alias or ensemble to send the samples to
+  std::string model;
+  /**
+   * @brief the dataset to read. Relative paths are in the model repository,
+   * whose local mirror is used if it's remote
+   */
+  std::filesystem::path input;
+  /// the results to write. An existing file is replaced once the job is done
+  std::filesystem::path output;
+  /// the name of the input of .npy datasets
+  std::string input_name = "input";
+  /// most requests in flight at once. If zero, kDefaultBulkInFlight
+  size_t in_flight = kDefaultBulkInFlight;
+};
+
+/// Where a bulk job is
+enum class BulkJobState { Running, Done, Failed, Cancelled };
+
+/// Get the name of a job's state, such as "running"
+const char* toString(BulkJobState state);
+
+/// How far a bulk job has got
+struct BulkJobProgress {
+  BulkJobState state = BulkJobState::Running;
+  /// samples in the dataset
+  uint64_t total = 0;
+  /// samples sent to the model
+  uint64_t submitted = 0;
+  /// samples whose responses were written, including the failed ones
+  uint64_t completed = 0;
+  /// samples whose responses were errors
+  uint64_t failed = 0;
+  /// why the job failed, if it did
+  std::string error;
+  /// seconds since the job started, or that it took once it's over
+  double seconds = 0;
+};
+
+/// A response read from the results of a bulk job
+struct BulkResult {
+  /// the index of the sample in the dataset
+  uint64_t sample = 0;
+  InferenceResponse response;
+};
+
+/**
+ * @brief Reads the results of a bulk job. They're responses in the binary
+ * wire format back to back, in the order they completed, each tagged with
+ * the index of its sample. Errors are written as error responses.
+ */
+class BulkResults {
+ public:
+  /**
+   * @brief Map the results of a bulk job. It throws file_read_error if they
+   * can't be read
+   *
+   * @param path the results to read
+   */
+  explicit BulkResults(const std::filesystem::path& path);
+  BulkResults(const BulkResults&) = delete;
+  BulkResults& operator=(const BulkResults&) = delete;
+  BulkResults(BulkResults&&) noexcept;             ///< Move constructor
+  BulkResults& operator=(BulkResults&&) noexcept;  ///< Move assignment
+  ~BulkResults();                                  ///< Destructor
+
+  /**
+   * @brief Read the next result, copying its outputs. It throws if the result
+   * is malformed
+   *
+   * @return std::optional<BulkResult> the result or nullopt at the end
+   */
+  std::optional<BulkResult> next();
+
+ private:
+  std::unique_ptr<util::MappedFile> file_;
+  size_t offset_ = 0;
+};
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_CORE_BULK_JOB
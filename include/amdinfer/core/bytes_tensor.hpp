@@ -0,0 +1,160 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the layout of BYTES tensors, whose elements are strings of
+ * variable length
+ */
+
+#ifndef GUARD_AMDINFER_CORE_BYTES_TENSOR
+#define GUARD_AMDINFER_CORE_BYTES_TENSOR
+
+#include <cstddef>      // for size_t, byte
+#include <cstdint>      // for uint32_t, uint64_t
+#include <cstring>      // for memcpy
+#include <limits>       // for numeric_limits
+#include <string_view>  // for string_view
+#include <vector>       // for vector
+
+#include "amdinfer/core/exceptions.hpp"  // for invalid_argument
+#include "amdinfer/core/shape.hpp"       // for Shape
+
+namespace amdinfer {
+
+/**
+ * @brief Bytes before each element of a BYTES tensor that hold its length.
+ *
+ * @details A BYTES tensor's data is its elements in order, each one a 32-bit
+ * little-endian length followed by that many bytes, as in KServe's binary data
+ * extension. Its size counts the bytes of this layout so it's copied like any
+ * other tensor while the protocols send its number of elements as its shape.
+ */
+constexpr size_t kBytesLengthSize = sizeof(uint32_t);
+
+/**
+ * @brief Get the size of the data of a BYTES tensor holding the elements
+ *
+ * @tparam Elements a container of strings or string views
+ * @param elements the elements
+ * @return size_t
+ */
+template <typename Elements>
+size_t getBytesSize(const Elements& elements) {
+  size_t size = 0;
+  for (const auto& element : elements) {
+    size += kBytesLengthSize + element.size();
+  }
+  return size;
+}
+
+/**
+ * @brief Encode the length of an element of a BYTES tensor
+ *
+ * @param length the length of the element in bytes
+ * @param dest where to write it, which must have kBytesLengthSize bytes
+ */
+inline void encodeBytesLength(size_t length, std::byte* dest) {
+  if (length > std::numeric_limits<uint32_t>::max()) {
+    throw invalid_argument("Elements of BYTES tensors must be under 4 GiB");
+  }
+  // the supported hosts are little-endian
+  const auto value = static_cast<uint32_t>(length);
+  std::memcpy(dest, &value, kBytesLengthSize);
+}
+
+/**
+ * @brief Encode an element of a BYTES tensor
+ *
+ * @param element the element
+ * @param dest where to write it, which must have kBytesLengthSize more bytes
+ * than the element
+ * @return std::byte* - the address after the written element
+ */
+inline std::byte* encodeBytesElement(std::string_view element,
+                                     std::byte* dest) {
+  encodeBytesLength(element.size(), dest);
+  if (!element.empty()) {
+    std::memcpy(dest + kBytesLengthSize, element.data(), element.size());
+  }
+  return dest + kBytesLengthSize + element.size();
+}
+
+/**
+ * @brief Encode elements as the data of a BYTES tensor
+ *
+ * @tparam Elements a container of strings or string views
+ * @param elements the elements
+ * @return std::vector<std::byte>
+ */
+template <typename Elements>
+std::vector<std::byte> encodeBytes(const Elements& elements) {
+  std::vector<std::byte> data(getBytesSize(elements));
+  auto* dest = data.data();
+  for (const auto& element : elements) {
+    dest = encodeBytesElement(element, dest);
+  }
+  return data;
+}
+
+/**
+ * @brief A view of the elements of a BYTES tensor. The lengths are read once
+ * when it's constructed so workers can index the elements in constant time and
+ * read them in place without copying them.
+ */
+class BytesView {
+ public:
+  /// Construct an empty BytesView object
+  BytesView() = default;
+  /**
+   * @brief Construct a new BytesView object. The data must outlive it.
+   *
+   * @param data the data of a BYTES tensor
+   * @param size size of the data in bytes
+   * @throws invalid_argument if the data isn't a whole number of elements
+   */
+  BytesView(const void* data, size_t size);
+
+  /// Get the number of elements
+  [[nodiscard]] size_t size() const { return elements_.size(); }
+  /// Check if there are no elements
+  [[nodiscard]] bool empty() const { return elements_.empty(); }
+  /// Get an element
+  [[nodiscard]] std::string_view operator[](size_t index) const {
+    return elements_[index];
+  }
+  /// Get an iterator to the first element
+  [[nodiscard]] auto begin() const { return elements_.begin(); }
+  /// Get an iterator past the last element
+  [[nodiscard]] auto end() const { return elements_.end(); }
+
+ private:
+  std::vector<std::string_view> elements_;
+};
+
+/**
+ * @brief Check that a BYTES tensor has as many elements as its shape on the
+ * wire, such as a KServe request's shape, says it has
+ *
+ * @param elements number of elements in the tensor
+ * @param shape shape of the tensor
+ * @param name name of the tensor, for the error
+ * @throws invalid_argument if they don't match
+ */
+void checkBytesShape(size_t elements, const Shape& shape,
+                     std::string_view name);
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_CORE_BYTES_TENSOR
@@ -0,0 +1,53 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the options to compress requests and responses with
+ */
+
+#ifndef GUARD_AMDINFER_CORE_COMPRESSION
+#define GUARD_AMDINFER_CORE_COMPRESSION
+
+#include <cstddef>  // for size_t
+
+namespace amdinfer {
+
+/// Algorithms that the bodies of requests and responses can be compressed with
+enum class Compression {
+  /// the body is sent as is
+  None,
+  /// the zlib format, which HTTP calls deflate
+  Deflate,
+  /// the gzip format
+  Gzip,
+};
+
+/// Bodies smaller than this many bytes are sent uncompressed by default
+constexpr size_t kDefaultCompressionThreshold = 1024;
+
+/**
+ * @brief How bodies are compressed. Small bodies gain little from compression
+ * so only bodies of at least threshold bytes are compressed.
+ */
+struct CompressionOptions {
+  /// algorithm to compress with. If None, nothing is compressed
+  Compression algorithm = Compression::None;
+  /// bodies smaller than this many bytes are sent uncompressed
+  size_t threshold = kDefaultCompressionThreshold;
+};
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_CORE_COMPRESSION
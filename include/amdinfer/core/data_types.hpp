@@ -21,8 +21,9 @@
 #ifndef GUARD_AMDINFER_CORE_DATA_TYPES
 #define GUARD_AMDINFER_CORE_DATA_TYPES
 
-#include <cstddef>      // for size_t
+#include <cstddef>      // for size_t, byte
 #include <cstdint>      // for uint8_t, int16_t, int32_t
+#include <cstring>      // for memcpy
 #include <iostream>     // for ostream
 #include <string>       // for string
 #include <string_view>  // for string_view
@@ -54,9 +55,63 @@ constexpr uint64_t hash(std::string_view str) {
 // this is kept lower-case for visual consistency with other POD types
 using fp16 = half_float::half;  // NOLINT(readability-identifier-naming)
 
+/**
+ * @brief The bfloat16 type is the upper half of a float: it has the same sign
+ * and exponent bits but only 7 bits of mantissa so it has the range of a float
+ * with less precision. Floats are rounded to the nearest bf16 with ties to
+ * even and NaNs stay NaNs.
+ */
+// this is kept lower-case for visual consistency with other POD types
+class bf16 {  // NOLINT(readability-identifier-naming)
+ public:
+  /// Construct a new bf16 object with the value zero
+  constexpr bf16() = default;
+  /// Construct a new bf16 object from the nearest value to a float
+  explicit bf16(float value) : bits_(round(value)) {}
+
+  /// Convert the value to a float, which is exact
+  // NOLINTNEXTLINE(google-explicit-constructor, hicpp-explicit-conversions)
+  operator float() const {
+    const uint32_t bits = static_cast<uint32_t>(bits_) << kShift;
+    float value = 0;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  /// Get the underlying bits of the value
+  [[nodiscard]] constexpr uint16_t bits() const { return bits_; }
+  /// Make a bf16 object from its underlying bits
+  static constexpr bf16 fromBits(uint16_t bits) {
+    bf16 value;
+    value.bits_ = bits;
+    return value;
+  }
+
+ private:
+  static constexpr auto kShift = 16U;
+  static constexpr uint32_t kAbsMask = 0x7FFFFFFF;
+  static constexpr uint32_t kInfinity = 0x7F800000;
+  static constexpr uint32_t kQuietBit = 0x40;
+  static constexpr uint32_t kHalfUlp = 0x7FFF;
+
+  static uint16_t round(float value) {
+    uint32_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    // truncating a NaN could make it infinity so it's kept quiet instead
+    if ((bits & kAbsMask) > kInfinity) {
+      return static_cast<uint16_t>((bits >> kShift) | kQuietBit);
+    }
+    const uint32_t rounding = kHalfUlp + ((bits >> kShift) & 1U);
+    return static_cast<uint16_t>((bits + rounding) >> kShift);
+  }
+
+  uint16_t bits_ = 0;
+};
+
 /**
  * @brief Supported data types. The ALL_CAPS aliases are deprecated and will
- * be removed.
+ * be removed. BYTES tensors hold variable-length elements in the layout that
+ * bytes_tensor.hpp describes so their size is counted in bytes.
  */
 class DataType {
  public:
@@ -77,6 +132,8 @@ class DataType {
     Fp64,
     FP64 = Fp64,
     String,
+    Bf16,
+    Bytes,
     Unknown,
   };
 
@@ -143,6 +200,10 @@ class DataType {
         return sizeof(double);
       case DataType::String:
         return sizeof(std::string);
+      case DataType::Bf16:
+        return sizeof(bf16);
+      case DataType::Bytes:
+        return sizeof(std::byte);
       default:
         throw invalid_argument("Unknown datatype passed");
     }
@@ -184,6 +245,10 @@ class DataType {
         return "FP64";
       case DataType::String:
         return "STRING";
+      case DataType::Bf16:
+        return "BF16";
+      case DataType::Bytes:
+        return "BYTES";
       default:
         throw invalid_argument("Unknown datatype passed");
     }
@@ -231,6 +296,12 @@ class DataType {
       case detail::hash("STRING"):
       case detail::hash("String"):
         return DataType::String;
+      case detail::hash("BF16"):
+      case detail::hash("Bf16"):
+        return DataType::Bf16;
+      case detail::hash("BYTES"):
+      case detail::hash("Bytes"):
+        return DataType::Bytes;
       default:
         throw invalid_argument("Unknown datatype passed");
     }
@@ -292,6 +363,14 @@ auto switchOverTypes(F f, DataType type, [[maybe_unused]] const Args&... args) {
     case DataType::String: {
       return f.template operator()<char>(args...);
     }
+    case DataType::Bf16: {
+      return f.template operator()<bf16>(args...);
+    }
+    // BYTES tensors are bytes like strings. The protocols map their elements
+    // before switching over the types
+    case DataType::Bytes: {
+      return f.template operator()<char>(args...);
+    }
     default:
       throw invalid_argument("Unknown datatype passed");
   }
@@ -95,6 +95,15 @@ class environment_not_set_error : public runtime_error {
   using runtime_error::runtime_error;
 };
 
+/**
+ * @brief This exception gets thrown if an endpoint can't accept more requests
+ * because its queue is full
+ *
+ */ // NOLINTNEXTLINE(readability-identifier-naming)
+class resource_exhausted_error : public runtime_error {
+  using runtime_error::runtime_error;
+};
+
 }  // namespace amdinfer
 
 #endif  // GUARD_AMDINFER_CORE_EXCEPTIONS
@@ -26,6 +26,7 @@
 #include "amdinfer/core/data_types.hpp"
 #include "amdinfer/core/inference_tensor.hpp"
 #include "amdinfer/core/parameters.hpp"
+#include "amdinfer/core/response_callback.hpp"
 #include "amdinfer/declarations.hpp"
 
 namespace amdinfer {
@@ -50,8 +51,8 @@ class InferenceRequestInput : public InferenceTensor {
    * @param data_type type of the data
    * @param name name to assign
    */
-  InferenceRequestInput(void *data, std::vector<uint64_t> shape,
-                        DataType data_type, std::string name = "");
+  InferenceRequestInput(void *data, Shape shape, DataType data_type,
+                        std::string name = "");
 
   /// Set the request's data
   void setData(void *buffer);
@@ -136,19 +137,34 @@ class InferenceRequest {
  public:
   // Construct a new InferenceRequest object
   InferenceRequest() = default;
+  /**
+   * @brief Construct a new InferenceRequest object as a copy of another. The
+   * callback belongs to the request that's in flight so it isn't copied
+   *
+   * @param other the request to copy
+   */
+  InferenceRequest(const InferenceRequest &other);
+  /// Copy assignment operator. The callback isn't copied
+  InferenceRequest &operator=(const InferenceRequest &other);
+  /// Move constructor
+  InferenceRequest(InferenceRequest &&other) = default;
+  /// Move assignment operator
+  InferenceRequest &operator=(InferenceRequest &&other) = default;
+  /// Destructor
+  ~InferenceRequest() = default;
 
   /**
    * @brief Sets the request's callback function used by the last worker to
    * respond back to the client
    *
-   * @param callback a function pointer that accepts a InferenceResponse object
+   * @param callback a callable that accepts a InferenceResponse object
    */
-  void setCallback(Callback &&callback);
+  void setCallback(ResponseCallback &&callback);
   /**
    * @brief Get the request's callback function used by the last worker to
-   * respond back to the client
+   * respond back to the client. The request is left without a callback
    */
-  Callback getCallback();
+  ResponseCallback getCallback();
   /**
    * @brief Runs the request's callback function.
    *
@@ -179,8 +195,8 @@ class InferenceRequest {
    * @param data_type the datatype of the data
    * @param name the name of the input tensor
    */
-  void addInputTensor(void *data, const std::vector<uint64_t> &shape,
-                      DataType data_type, const std::string &name = "");
+  void addInputTensor(void *data, const Shape &shape, DataType data_type,
+                      const std::string &name = "");
 
   /**
    * @brief Adds a new input tensor to this request
@@ -189,6 +205,13 @@ class InferenceRequest {
    */
   void addInputTensor(InferenceRequestInput input);
 
+  /**
+   * @brief Replace an input tensor, if it exists
+   *
+   * @param index index for the input tensor
+   * @param input the new input tensor
+   */
+  void setInputTensor(size_t index, InferenceRequestInput input);
   /**
    * @brief Set the data pointer for an input tensor, if it exists
    *
@@ -246,7 +269,7 @@ class InferenceRequest {
   ParameterMap parameters_;
   std::vector<InferenceRequestInput> inputs_;
   std::vector<InferenceRequestOutput> outputs_;
-  Callback callback_;
+  ResponseCallback callback_;
 
   // TODO(varunsh): do we need this still?
   friend class FakeInferenceRequest;
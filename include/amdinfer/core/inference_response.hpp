@@ -20,6 +20,10 @@
 #ifndef GUARD_AMDINFER_CORE_INFERENCE_RESPONSE
 #define GUARD_AMDINFER_CORE_INFERENCE_RESPONSE
 
+#include <cstddef>  // for byte, size_t
+#include <memory>   // for shared_ptr
+#include <vector>   // for vector
+
 #include "amdinfer/build_options.hpp"          // for AMDINFER_ENABLE_TRACING
 #include "amdinfer/core/inference_tensor.hpp"  // for InferenceTensor
 #include "amdinfer/core/parameters.hpp"        // for ParameterMap
@@ -46,10 +50,37 @@ class InferenceResponseOutput : public InferenceTensor {
   // InferenceResponseOutput(void *data, std::vector<uint64_t> shape,
   //                       DataType data_type, std::string name = "");
 
-  /// Set the request's data
+  /**
+   * @brief Set the output's data, which it takes ownership of. Copies of this
+   * output share the data rather than copying it.
+   *
+   * @param buffer the data
+   */
   void setData(std::vector<std::byte> &&buffer);
-  /// Get a pointer to the request's data
+  /**
+   * @brief Set the output's data to memory owned elsewhere, such as a buffer
+   * borrowed from a memory pool. Copies of this output share the owner, which
+   * releases the memory once the last of them is destroyed.
+   *
+   * @param data owning pointer to the data
+   * @param size size of the data in bytes
+   */
+  void setData(std::shared_ptr<std::byte> data, size_t size);
+  /**
+   * @brief Set the output's data to a buffer that may not be in host memory,
+   * such as one on a GPU. It's only copied to the host the first time that
+   * getData() is called, which the servers do when they serialize the
+   * response, so outputs that are handed to other models on the same device
+   * can stay there. Copies of this output share the buffer and its copy.
+   *
+   * @param buffer the buffer holding the data
+   * @param size size of the data in bytes
+   */
+  void setData(std::shared_ptr<Buffer> buffer, size_t size);
+  /// Get a pointer to the request's data, copying it to the host if needed
   [[nodiscard]] void *getData() const;
+  /// Get the buffer that the data was set to, if any, or nullptr
+  [[nodiscard]] Buffer *getBuffer() const;
 
   /**
    * @brief Returns the size of the serialized data
@@ -79,7 +110,13 @@ class InferenceResponseOutput : public InferenceTensor {
                                   InferenceResponseOutput const &my_class);
 
  private:
-  std::vector<std::byte> data_;
+  [[nodiscard]] size_t getDataSize() const;
+
+  std::shared_ptr<std::vector<std::byte>> data_;
+  std::shared_ptr<std::byte> borrowed_data_;
+  size_t borrowed_size_ = 0;
+  struct BufferData;
+  std::shared_ptr<BufferData> buffer_data_;
 };
 
 /**
@@ -95,13 +132,22 @@ class InferenceResponse {
   explicit InferenceResponse(const std::string &error);
 
   /// Gets a vector of the requested output information
-  [[nodiscard]] std::vector<InferenceResponseOutput> getOutputs() const;
+  [[nodiscard]] const std::vector<InferenceResponseOutput> &getOutputs()
+    const &;
+  /// Moves the outputs out of a response that is about to be destroyed
+  [[nodiscard]] std::vector<InferenceResponseOutput> getOutputs() &&;
   /**
    * @brief Adds an output tensor to the response
    *
    * @param output an output tensor
    */
   void addOutput(const InferenceResponseOutput &output);
+  /**
+   * @brief Adds an output tensor to the response without copying its data
+   *
+   * @param output an output tensor
+   */
+  void addOutput(InferenceResponseOutput &&output);
 
   /// Gets the ID of the response
   std::string getID() const { return id_; }
@@ -110,7 +156,7 @@ class InferenceResponse {
   /// sets the model name of the response
   void setModel(const std::string &model);
   /// gets the model name of the response
-  std::string getModel();
+  std::string getModel() const;
 
   /// Checks if this is an error response
   bool isError() const;
@@ -130,6 +176,8 @@ class InferenceResponse {
 
   /// Gets a pointer to the parameters associated with this response
   ParameterMap *getParameters() { return this->parameters_.get(); }
+  /// Sets the parameters associated with this response
+  void setParameters(ParameterMap parameters);
 
   /// Provides an implementation to print the class with std::cout to an ostream
   friend std::ostream &operator<<(std::ostream &os,
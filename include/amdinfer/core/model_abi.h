@@ -0,0 +1,133 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the C ABI for models that are run by the CPlusPlus worker
+ *
+ * A model is a shared library named lib<model>_model.so that exports the
+ * functions declared here with C linkage. It's given whole batches: each
+ * input and output tensor is one contiguous span with the requests back to
+ * back and the outputs are in memory from the server's pool that's sent in
+ * the responses without copying. Only plain C types cross the boundary so
+ * models may be built with other compilers and standard libraries than the
+ * server.
+ */
+
+#ifndef GUARD_AMDINFER_CORE_MODEL_ABI
+#define GUARD_AMDINFER_CORE_MODEL_ABI
+
+#include <stddef.h>  // NOLINT(modernize-deprecated-headers)
+#include <stdint.h>  // NOLINT(modernize-deprecated-headers)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Version of this ABI. Models that report another version are rejected
+#define AMDINFER_MODEL_ABI_VERSION 1
+
+/// The datatypes of tensors, with the same values as amdinfer::DataType
+typedef enum AmdinferDatatype {  // NOLINT(modernize-use-using)
+  AMDINFER_BOOL,
+  AMDINFER_UINT8,
+  AMDINFER_UINT16,
+  AMDINFER_UINT32,
+  AMDINFER_UINT64,
+  AMDINFER_INT8,
+  AMDINFER_INT16,
+  AMDINFER_INT32,
+  AMDINFER_INT64,
+  AMDINFER_FP16,
+  AMDINFER_FP32,
+  AMDINFER_FP64,
+  AMDINFER_STRING,
+  AMDINFER_BF16,
+  AMDINFER_BYTES,
+} AmdinferDatatype;
+
+/// Describes an input or output tensor of one request
+typedef struct AmdinferTensorInfo {  // NOLINT(modernize-use-using)
+  const char* name;
+  AmdinferDatatype datatype;
+  /// the tensor's shape, without a batch dimension
+  const uint64_t* shape;
+  size_t rank;
+} AmdinferTensorInfo;
+
+/// The data of a tensor for a whole batch, with the requests back to back
+typedef struct AmdinferSpan {  // NOLINT(modernize-use-using)
+  void* data;
+  /// the size of one request's tensor in bytes
+  size_t stride;
+} AmdinferSpan;
+
+/// A batch of requests to run
+typedef struct AmdinferBatch {  // NOLINT(modernize-use-using)
+  /// the number of requests in the batch
+  size_t size;
+  /// one span per input tensor, in the order of amdinferModelInputs()
+  const AmdinferSpan* inputs;
+  size_t input_count;
+  /// one span per output tensor, in the order of amdinferModelOutputs(), to
+  /// write the outputs to
+  const AmdinferSpan* outputs;
+  size_t output_count;
+  /// the number of threads the model may use to run the batch
+  int32_t threads;
+  /// the model may point this at a message that lives past the call if it
+  /// fails
+  const char* error;
+} AmdinferBatch;
+
+/**
+ * @brief Get the version of the ABI that the model was built against. It's
+ * called first and should return AMDINFER_MODEL_ABI_VERSION.
+ *
+ * @return uint32_t
+ */
+uint32_t amdinferModelAbiVersion(void);
+
+/**
+ * @brief Get the input tensors of the model. The tensors must live until the
+ * model is unloaded
+ *
+ * @param tensors set to the model's array of input tensors
+ * @return size_t the number of input tensors
+ */
+size_t amdinferModelInputs(const AmdinferTensorInfo** tensors);
+
+/**
+ * @brief Get the output tensors of the model. The tensors must live until the
+ * model is unloaded
+ *
+ * @param tensors set to the model's array of output tensors
+ * @return size_t the number of output tensors
+ */
+size_t amdinferModelOutputs(const AmdinferTensorInfo** tensors);
+
+/**
+ * @brief Run a batch of requests. Each instance of the worker calls it from
+ * its own thread so it may be called for several batches at once
+ *
+ * @param batch the batch to run
+ * @return int32_t zero on success. Otherwise, all the requests get an error
+ */
+int32_t amdinferModelRun(AmdinferBatch* batch);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // GUARD_AMDINFER_CORE_MODEL_ABI
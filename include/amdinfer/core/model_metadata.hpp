@@ -24,6 +24,7 @@
 #include <vector>
 
 #include "amdinfer/core/data_types.hpp"
+#include "amdinfer/core/parameters.hpp"
 #include "amdinfer/core/tensor.hpp"
 
 namespace amdinfer {
@@ -115,6 +116,11 @@ class ModelMetadata {
 
   [[nodiscard]] const std::string &getPlatform() const;
 
+  /// Sets how the model was loaded, such as the precision it runs in
+  void setParameters(const ParameterMap &parameters);
+  /// Gets how the model was loaded, such as the precision it runs in
+  [[nodiscard]] const ParameterMap &getParameters() const;
+
   /// Marks this model as ready/not ready
   void setReady(bool ready);
   /// Checks if this model is ready
@@ -126,6 +132,7 @@ class ModelMetadata {
   std::string platform_;
   std::vector<ModelMetadataTensor> inputs_;
   std::vector<ModelMetadataTensor> outputs_;
+  ParameterMap parameters_;
   bool ready_;
 };
 
@@ -17,14 +17,18 @@
  * @brief Defines the Parameter object and associated containers
  */
 
-#include <cstddef>     // for byte, size_t
-#include <cstdint>     // for int32_t
-#include <functional>  // for less
-#include <map>         // for map
-#include <memory>      // for shared_ptr
-#include <sstream>     // for operator<<, basic_ostream, strin...
-#include <string>      // for string, operator<<, char_traits
-#include <variant>     // for visit, variant
+#include <cstddef>      // for byte, size_t
+#include <cstdint>      // for int32_t
+#include <functional>   // for less
+#include <iterator>     // for forward_iterator_tag
+#include <memory>       // for shared_ptr
+#include <sstream>      // for operator<<, basic_ostream, strin...
+#include <stdexcept>    // for out_of_range
+#include <string>       // for string, operator<<, char_traits
+#include <string_view>  // for string_view
+#include <utility>      // for pair
+#include <variant>      // for visit, variant
+#include <vector>       // for vector
 
 #include "amdinfer/core/mixins.hpp"  // for Serializable
 
@@ -40,10 +44,57 @@ using Parameter = std::variant<bool, int32_t, double, std::string>;
  * @brief Holds any parameters from JSON (defined by KServe spec as one of
  * bool, number or string). We further restrict numbers to be doubles or int32.
  *
+ * Requests usually carry no or a few parameters so they're kept in a vector
+ * sorted by key rather than in a tree. An empty map allocates nothing, a
+ * non-empty one allocates once and lookups scan contiguous memory.
  */
 class ParameterMap : public Serializable {
-  using Container = std::map<std::string, Parameter, std::less<>>;
-  using Iterator = Container::iterator;
+ public:
+  /// The underlying data structure holding the parameters, sorted by key
+  using Container = std::vector<std::pair<std::string, Parameter>>;
+
+ private:
+  /**
+   * @brief A read/write iterator over the parameters. It yields the key as
+   * const so the keys can't be changed out of their sorted order.
+   */
+  class Iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using difference_type = Container::difference_type;
+    using value_type = Container::value_type;
+    using reference = std::pair<const std::string &, Parameter &>;
+
+    /// Gives the pair to operator-> which has to return a pointer-like object
+    class Pointer {
+     public:
+      explicit Pointer(reference pair) : pair_(pair) {}
+      reference *operator->() { return &pair_; }
+
+     private:
+      reference pair_;
+    };
+    using pointer = Pointer;
+
+    explicit Iterator(Container::iterator it) : it_(it) {}
+
+    reference operator*() const { return {it_->first, it_->second}; }
+    pointer operator->() const { return Pointer{**this}; }
+    Iterator &operator++() {
+      ++it_;
+      return *this;
+    }
+    Iterator operator++(int) {
+      auto tmp = *this;
+      ++it_;
+      return tmp;
+    }
+    bool operator==(const Iterator &other) const { return it_ == other.it_; }
+    bool operator!=(const Iterator &other) const { return it_ != other.it_; }
+
+   private:
+    Container::iterator it_;
+  };
   using ConstIterator = Container::const_iterator;
 
  public:
@@ -91,9 +142,12 @@ class ParameterMap : public Serializable {
    * @return T
    */
   template <typename T>
-  T get(const std::string &key) const {
-    auto &value = this->parameters_.at(key);
-    return std::get<T>(value);
+  T get(std::string_view key) const {
+    const auto it = this->find(key);
+    if (it == this->parameters_.end()) {
+      throw std::out_of_range("Parameter " + std::string{key} + " not found");
+    }
+    return std::get<T>(it->second);
   }
 
   /**
@@ -102,7 +156,7 @@ class ParameterMap : public Serializable {
    * @param key name of the parameter to check
    * @return bool
    */
-  bool has(const std::string &key) const;
+  [[nodiscard]] bool has(std::string_view key) const;
 
   /**
    * @brief Rename the key associated with a parameter. If the new key already
@@ -124,8 +178,10 @@ class ParameterMap : public Serializable {
   [[nodiscard]] size_t size() const;
   /// Checks if the parameters are empty
   [[nodiscard]] bool empty() const;
+  /// Reserves space for this many parameters in total
+  void reserve(size_t size);
   /// Gets the underlying data structure holding the parameters
-  [[nodiscard]] std::map<std::string, Parameter, std::less<>> data() const;
+  [[nodiscard]] const Container &data() const;
 
   /// Returns a read/write iterator to the first parameter in the object
   Iterator begin();
@@ -178,6 +234,12 @@ class ParameterMap : public Serializable {
   }
 
  private:
+  /// Find the parameter with the key or where it would be inserted
+  [[nodiscard]] ConstIterator lowerBound(std::string_view key) const;
+  [[nodiscard]] ConstIterator find(std::string_view key) const;
+  template <typename T>
+  void emplace(const std::string &key, T &&value);
+
   Container parameters_;
 };
 
@@ -209,14 +271,17 @@ struct less<amdinfer::ParameterMap> {
                   const amdinfer::ParameterMap &rhs) const {
     auto lhs_size = lhs.size();
     auto rhs_size = rhs.size();
-    auto lhs_map = lhs.data();
-    auto rhs_map = rhs.data();
     if (lhs_size == rhs_size) {
-      for (const auto &[key, lhs_value] : lhs_map) {
-        if (rhs_map.find(key) == rhs_map.end()) {
+      // both are sorted by key so rhs is searched in one pass alongside lhs
+      auto rhs_it = rhs.cbegin();
+      for (const auto &[key, lhs_value] : lhs) {
+        while (rhs_it != rhs.cend() && rhs_it->first < key) {
+          rhs_it++;
+        }
+        if (rhs_it == rhs.cend() || rhs_it->first != key) {
           return true;
         }
-        const auto &rhs_value = rhs_map.at(key);
+        const auto &rhs_value = rhs_it->second;
         if (lhs_value != rhs_value) {
           return lhs_value < rhs_value;
         }
@@ -0,0 +1,200 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the callback that a request's response is passed to
+ */
+
+#ifndef GUARD_AMDINFER_CORE_RESPONSE_CALLBACK
+#define GUARD_AMDINFER_CORE_RESPONSE_CALLBACK
+
+#include <cstddef>      // for byte, max_align_t, nullptr_t, size_t
+#include <functional>   // for function
+#include <new>          // for launder
+#include <type_traits>  // for decay_t, enable_if_t, is_invocable_v
+#include <utility>      // for forward, move
+
+namespace amdinfer {
+
+class InferenceResponse;
+
+namespace detail {
+
+template <typename T>
+struct IsStdFunction : std::false_type {};
+template <typename Signature>
+struct IsStdFunction<std::function<Signature>> : std::true_type {};
+
+}  // namespace detail
+
+/**
+ * @brief A move-only function that's called with a request's response. Unlike
+ * std::function, callables up to kCapacity bytes are stored in the object so
+ * the usual callbacks, which capture a few pointers, don't allocate when a
+ * request is made. Larger callables are stored on the heap. Since it's
+ * move-only, callbacks may capture move-only state such as a std::promise by
+ * value.
+ *
+ * Any callable that accepts an InferenceResponse, including a Callback, can be
+ * assigned to it.
+ */
+class ResponseCallback {
+ public:
+  /// Callables up to this size are stored without allocating
+  static constexpr size_t kCapacity = 128;
+
+  /// Construct a new ResponseCallback object that's empty
+  ResponseCallback() = default;
+  /// Construct a new ResponseCallback object that's empty
+  ResponseCallback(std::nullptr_t) {}  // NOLINT(google-explicit-constructor)
+
+  /**
+   * @brief Construct a new ResponseCallback object from a callable
+   *
+   * @tparam F type of the callable
+   * @param function the callable to store
+   */
+  template <typename F,
+            typename = std::enable_if_t<
+              !std::is_same_v<std::decay_t<F>, ResponseCallback> &&
+              std::is_invocable_v<std::decay_t<F>&, const InferenceResponse&>>>
+  ResponseCallback(F&& function) {  // NOLINT(google-explicit-constructor)
+    using Function = std::decay_t<F>;
+    if constexpr (std::is_pointer_v<Function> ||
+                  detail::IsStdFunction<Function>::value) {
+      // an empty std::function or a null function pointer stays empty
+      if (!static_cast<bool>(function)) {
+        return;
+      }
+    }
+    if constexpr (fitsInline<Function>()) {
+      new (storage_) Function(std::forward<F>(function));
+      operations_ = &kInline<Function>;
+    } else {
+      new (storage_) Function*(new Function(std::forward<F>(function)));
+      operations_ = &kHeap<Function>;
+    }
+  }
+
+  ResponseCallback(const ResponseCallback&) = delete;
+  ResponseCallback& operator=(const ResponseCallback&) = delete;
+  /// Move constructor
+  ResponseCallback(ResponseCallback&& other) noexcept {
+    moveFrom(&other);
+  }
+  /// Move assignment operator
+  ResponseCallback& operator=(ResponseCallback&& other) noexcept {
+    if (this != &other) {
+      reset();
+      moveFrom(&other);
+    }
+    return *this;
+  }
+  /// Clear the callback
+  ResponseCallback& operator=(std::nullptr_t) noexcept {
+    reset();
+    return *this;
+  }
+  /// Destructor
+  ~ResponseCallback() { reset(); }
+
+  /**
+   * @brief Call the callback. It must not be empty
+   *
+   * @param response the response to pass to the callback
+   */
+  void operator()(const InferenceResponse& response) const {
+    operations_->invoke(storage_, response);
+  }
+
+  /// Check if there's a callback to call
+  explicit operator bool() const { return operations_ != nullptr; }
+  /// Check if the callback is empty
+  friend bool operator==(const ResponseCallback& callback, std::nullptr_t) {
+    return callback.operations_ == nullptr;
+  }
+  /// Check if the callback is not empty
+  friend bool operator!=(const ResponseCallback& callback, std::nullptr_t) {
+    return callback.operations_ != nullptr;
+  }
+
+ private:
+  struct Operations {
+    void (*invoke)(std::byte* storage, const InferenceResponse& response);
+    /// move the callable in one storage to another and destroy the first
+    void (*relocate)(std::byte* from, std::byte* to);
+    void (*destroy)(std::byte* storage);
+  };
+
+  template <typename Function>
+  static constexpr bool fitsInline() {
+    // moves must not throw so that moving a callback can't fail
+    return sizeof(Function) <= kCapacity &&
+           alignof(Function) <= alignof(std::max_align_t) &&
+           std::is_nothrow_move_constructible_v<Function>;
+  }
+
+  template <typename Function>
+  static Function* get(std::byte* storage) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    return std::launder(reinterpret_cast<Function*>(storage));
+  }
+
+  template <typename Function>
+  static constexpr Operations kInline{
+    [](std::byte* storage, const InferenceResponse& response) {
+      (*get<Function>(storage))(response);
+    },
+    [](std::byte* from, std::byte* to) {
+      auto* function = get<Function>(from);
+      new (to) Function(std::move(*function));
+      function->~Function();
+    },
+    [](std::byte* storage) { get<Function>(storage)->~Function(); }};
+
+  template <typename Function>
+  static constexpr Operations kHeap{
+    [](std::byte* storage, const InferenceResponse& response) {
+      (**get<Function*>(storage))(response);
+    },
+    [](std::byte* from, std::byte* to) {
+      new (to) Function*(*get<Function*>(from));
+    },
+    [](std::byte* storage) { delete *get<Function*>(storage); }};
+
+  void moveFrom(ResponseCallback* other) noexcept {
+    if (other->operations_ != nullptr) {
+      other->operations_->relocate(other->storage_, storage_);
+      operations_ = other->operations_;
+      other->operations_ = nullptr;
+    }
+  }
+
+  void reset() noexcept {
+    if (operations_ != nullptr) {
+      operations_->destroy(storage_);
+      operations_ = nullptr;
+    }
+  }
+
+  // the callable is called through a const callback as std::function does
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays)
+  alignas(std::max_align_t) mutable std::byte storage_[kCapacity];
+  const Operations* operations_ = nullptr;
+};
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_CORE_RESPONSE_CALLBACK
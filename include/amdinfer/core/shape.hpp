@@ -0,0 +1,240 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the shape of tensors
+ */
+
+#ifndef GUARD_AMDINFER_CORE_SHAPE
+#define GUARD_AMDINFER_CORE_SHAPE
+
+#include <algorithm>         // for copy, equal, fill, rotate...
+#include <array>             // for array
+#include <cstddef>           // for size_t
+#include <cstdint>           // for uint64_t
+#include <functional>        // for hash
+#include <initializer_list>  // for initializer_list
+#include <iterator>          // for distance, iterator_traits
+#include <memory>            // for unique_ptr, make_unique
+#include <ostream>           // for ostream
+#include <utility>           // for move
+#include <vector>            // for vector
+
+namespace amdinfer {
+
+/// Dimensions that a Shape holds without allocating
+constexpr size_t kShapeInlineDims = 8;
+
+/**
+ * @brief The dimensions of a tensor. Up to kShapeInlineDims dimensions are
+ * stored inline so creating, copying and comparing the shapes of tensors
+ * doesn't allocate and only longer shapes are stored on the heap. It has the
+ * same interface as std::vector<uint64_t> for the operations tensors use and
+ * converts to and from it implicitly.
+ */
+class Shape {
+ public:
+  using value_type = uint64_t;
+  using size_type = size_t;
+  using reference = uint64_t&;
+  using const_reference = const uint64_t&;
+  using iterator = uint64_t*;
+  using const_iterator = const uint64_t*;
+
+  /// Construct an empty Shape object
+  Shape() = default;
+  /// Construct a new Shape object from its dimensions
+  Shape(std::initializer_list<uint64_t> dims) {
+    assign(dims.begin(), dims.end());
+  }
+  /// Construct a new Shape object from its dimensions
+  Shape(const std::vector<uint64_t>& dims) {  // NOLINT(google-explicit-*)
+    assign(dims.begin(), dims.end());
+  }
+  /// Construct a new Shape object from a range of dimensions
+  template <typename Iter, typename = typename std::iterator_traits<
+                             Iter>::iterator_category>
+  Shape(Iter first, Iter last) {
+    assign(first, last);
+  }
+
+  Shape(const Shape& other) { assign(other.begin(), other.end()); }
+  Shape(Shape&& other) noexcept { *this = std::move(other); }
+  Shape& operator=(const Shape& other) {
+    if (this != &other) {
+      assign(other.begin(), other.end());
+    }
+    return *this;
+  }
+  Shape& operator=(Shape&& other) noexcept {
+    if (this == &other) {
+      return *this;
+    }
+    if (other.heap_ != nullptr) {
+      heap_ = std::move(other.heap_);
+      data_ = heap_.get();
+      capacity_ = other.capacity_;
+    } else {
+      heap_.reset();
+      data_ = inline_.data();
+      capacity_ = kShapeInlineDims;
+      std::copy(other.begin(), other.end(), data_);
+    }
+    size_ = other.size_;
+    other.data_ = other.inline_.data();
+    other.capacity_ = kShapeInlineDims;
+    other.size_ = 0;
+    return *this;
+  }
+  ~Shape() = default;
+
+  /// Convert the shape to a vector
+  operator std::vector<uint64_t>() const {  // NOLINT(google-explicit-*)
+    return {begin(), end()};
+  }
+
+  /// Get the number of dimensions
+  [[nodiscard]] size_t size() const { return size_; }
+  /// Check if there are no dimensions
+  [[nodiscard]] bool empty() const { return size_ == 0; }
+  /// Get the dimensions
+  [[nodiscard]] uint64_t* data() { return data_; }
+  [[nodiscard]] const uint64_t* data() const { return data_; }
+
+  uint64_t& operator[](size_t index) { return data_[index]; }
+  const uint64_t& operator[](size_t index) const { return data_[index]; }
+  [[nodiscard]] uint64_t& front() { return data_[0]; }
+  [[nodiscard]] const uint64_t& front() const { return data_[0]; }
+  [[nodiscard]] uint64_t& back() { return data_[size_ - 1]; }
+  [[nodiscard]] const uint64_t& back() const { return data_[size_ - 1]; }
+
+  [[nodiscard]] iterator begin() { return data_; }
+  [[nodiscard]] iterator end() { return data_ + size_; }
+  [[nodiscard]] const_iterator begin() const { return data_; }
+  [[nodiscard]] const_iterator end() const { return data_ + size_; }
+  [[nodiscard]] const_iterator cbegin() const { return data_; }
+  [[nodiscard]] const_iterator cend() const { return data_ + size_; }
+
+  /// Make space for at least capacity dimensions
+  void reserve(size_t capacity) {
+    if (capacity <= capacity_) {
+      return;
+    }
+    // NOLINTNEXTLINE(*-avoid-c-arrays)
+    auto heap = std::make_unique<uint64_t[]>(capacity);
+    std::copy(begin(), end(), heap.get());
+    heap_ = std::move(heap);
+    data_ = heap_.get();
+    capacity_ = capacity;
+  }
+  /// Set the number of dimensions, with new ones set to value
+  void resize(size_t size, uint64_t value = 0) {
+    if (size > size_) {
+      reserve(size);
+      std::fill(data_ + size_, data_ + size, value);
+    }
+    size_ = size;
+  }
+  void clear() { size_ = 0; }
+  void push_back(uint64_t dim) {
+    if (size_ == capacity_) {
+      reserve(capacity_ * 2);
+    }
+    data_[size_++] = dim;
+  }
+  void pop_back() { --size_; }
+  /// Insert a dimension before pos
+  iterator insert(const_iterator pos, uint64_t dim) {
+    const auto index = pos - data_;
+    push_back(dim);
+    std::rotate(data_ + index, data_ + size_ - 1, data_ + size_);
+    return data_ + index;
+  }
+  /// Insert a range of dimensions before pos
+  template <typename Iter>
+  iterator insert(const_iterator pos, Iter first, Iter last) {
+    const auto index = pos - data_;
+    const auto count = static_cast<size_t>(std::distance(first, last));
+    reserve(size_ + count);
+    std::copy_backward(data_ + index, data_ + size_, data_ + size_ + count);
+    std::copy(first, last, data_ + index);
+    size_ += count;
+    return data_ + index;
+  }
+  /// Remove the dimension at pos
+  iterator erase(const_iterator pos) {
+    const auto index = pos - data_;
+    std::copy(data_ + index + 1, data_ + size_, data_ + index);
+    --size_;
+    return data_ + index;
+  }
+  /// Replace the dimensions with a range
+  template <typename Iter>
+  void assign(Iter first, Iter last) {
+    const auto size = static_cast<size_t>(std::distance(first, last));
+    if (size > capacity_) {
+      clear();
+      reserve(size);
+    }
+    std::copy(first, last, data_);
+    size_ = size;
+  }
+
+  friend bool operator==(const Shape& lhs, const Shape& rhs) {
+    return lhs.size_ == rhs.size_ &&
+           std::equal(lhs.begin(), lhs.end(), rhs.begin());
+  }
+  friend bool operator!=(const Shape& lhs, const Shape& rhs) {
+    return !(lhs == rhs);
+  }
+
+  friend std::ostream& operator<<(std::ostream& os, const Shape& shape) {
+    os << '[';
+    for (size_t i = 0; i < shape.size(); ++i) {
+      os << (i == 0 ? "" : ", ") << shape[i];
+    }
+    return os << ']';
+  }
+
+ private:
+  std::array<uint64_t, kShapeInlineDims> inline_{};
+  // NOLINTNEXTLINE(*-avoid-c-arrays)
+  std::unique_ptr<uint64_t[]> heap_;
+  uint64_t* data_ = inline_.data();
+  size_t size_ = 0;
+  size_t capacity_ = kShapeInlineDims;
+};
+
+}  // namespace amdinfer
+
+namespace std {
+
+/// Hashes the dimensions of shapes, such as for looking up buffers by shape
+template <>
+struct hash<amdinfer::Shape> {
+  size_t operator()(const amdinfer::Shape& shape) const noexcept {
+    // boost::hash_combine
+    constexpr size_t kMagic = 0x9e3779b9;
+    size_t seed = shape.size();
+    for (const auto& dim : shape) {
+      seed ^= std::hash<uint64_t>{}(dim) + kMagic + (seed << 6) + (seed >> 2);
+    }
+    return seed;
+  }
+};
+
+}  // namespace std
+
+#endif  // GUARD_AMDINFER_CORE_SHAPE
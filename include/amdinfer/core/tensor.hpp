@@ -25,6 +25,7 @@
 
 #include "amdinfer/core/data_types.hpp"
 #include "amdinfer/core/mixins.hpp"
+#include "amdinfer/core/shape.hpp"
 
 namespace amdinfer {
 
@@ -33,7 +34,7 @@ namespace amdinfer {
  */
 class Tensor : public Serializable {
  public:
-  Tensor(std::string name, std::vector<uint64_t> shape, DataType data_type);
+  Tensor(std::string name, Shape shape, DataType data_type);
 
   /// Get the tensor's name
   [[nodiscard]] const std::string &getName() const &;
@@ -42,10 +43,10 @@ class Tensor : public Serializable {
   void setName(std::string name);
 
   /// Get the tensor's shape
-  [[nodiscard]] const std::vector<uint64_t> &getShape() const &;
-  [[nodiscard]] std::vector<uint64_t> getShape() &&;
+  [[nodiscard]] const Shape &getShape() const &;
+  [[nodiscard]] Shape getShape() &&;
   /// Sets the tensor's shape
-  void setShape(std::vector<uint64_t> shape);
+  void setShape(Shape shape);
 
   /// Get the tensor's datatype
   [[nodiscard]] DataType getDatatype() const;
@@ -78,7 +79,7 @@ class Tensor : public Serializable {
 
  private:
   std::string name_;
-  std::vector<uint64_t> shape_;
+  Shape shape_;
   DataType data_type_;
 };
 
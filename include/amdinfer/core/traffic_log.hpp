@@ -0,0 +1,108 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the log of inference traffic that a server records and the
+ * reader that replays it
+ */
+
+#ifndef GUARD_AMDINFER_CORE_TRAFFIC_LOG
+#define GUARD_AMDINFER_CORE_TRAFFIC_LOG
+
+#include <array>       // for array
+#include <chrono>      // for nanoseconds
+#include <cstddef>     // for byte
+#include <cstdint>     // for uint64_t, uint16_t
+#include <filesystem>  // for path
+#include <fstream>     // for ifstream
+#include <memory>      // for shared_ptr
+#include <optional>    // for optional
+#include <string>      // for string
+#include <vector>      // for vector
+
+#include "amdinfer/declarations.hpp"  // for InferenceRequestPtr
+
+namespace amdinfer {
+
+/// The eight bytes that start a traffic log
+constexpr std::array<char, 8> kTrafficLogMagic{'A', 'M', 'D', 'T',
+                                               'R', 'C', '0', '1'};
+
+/**
+ * @brief Flag set in the wire header of records whose tensors' data wasn't
+ * recorded. Their data isn't in the log and they're replayed with zeros
+ */
+constexpr uint16_t kTrafficNoPayload = 2;
+
+/**
+ * @brief Starts a traffic log. The log is this header and then one record
+ * per request, each a request in the binary wire format whose tag is the
+ * nanoseconds from the start of the recording to the request's arrival. As in
+ * the wire format, everything is in the recorder's native byte order.
+ */
+struct TrafficLogHeader {
+  std::array<char, 8> magic = kTrafficLogMagic;
+  /// nanoseconds since the Unix epoch when the recording started
+  uint64_t start_ns = 0;
+};
+
+/// A request read from a traffic log
+struct TrafficRecord {
+  /// when the request arrived, from the start of the recording
+  std::chrono::nanoseconds arrival{};
+  /// the endpoint, alias or model that the request was sent to
+  std::string endpoint;
+  /// the request, whose inputs' data points into the record
+  InferenceRequestPtr request;
+  /// whether the inputs' data was recorded or is zeros
+  bool payload = false;
+  /// the record's bytes that the request's data points into
+  std::shared_ptr<const std::vector<std::byte>> data;
+};
+
+/**
+ * @brief Reads the records of a traffic log in the order they arrived. A
+ * recording that stopped in the middle of a record, such as when its server
+ * was killed, ends at the last whole record.
+ */
+class TrafficLog {
+ public:
+  /**
+   * @brief Open a traffic log. It throws if it can't be opened or isn't one
+   *
+   * @param path the log to read
+   */
+  explicit TrafficLog(const std::filesystem::path& path);
+
+  /// Get when the recording started, in nanoseconds since the Unix epoch
+  [[nodiscard]] uint64_t start() const { return header_.start_ns; }
+
+  /**
+   * @brief Read the next record. It throws if the record is malformed
+   *
+   * @return std::optional<TrafficRecord> the record or nullopt at the end
+   */
+  std::optional<TrafficRecord> next();
+
+ private:
+  std::ifstream file_;
+  /// bytes in the log
+  uint64_t size_ = 0;
+  TrafficLogHeader header_;
+};
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_CORE_TRAFFIC_LOG
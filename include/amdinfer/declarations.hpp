@@ -32,6 +32,7 @@ class InferenceResponse;
 using InferenceResponsePromisePtr =
   std::shared_ptr<std::promise<InferenceResponse>>;
 using Callback = std::function<void(const InferenceResponse &)>;
+class ResponseCallback;
 
 class Buffer;
 using BufferPtr = std::unique_ptr<Buffer>;
@@ -46,6 +47,8 @@ using StringMap = std::unordered_map<std::string, std::string>;
 
 class Trace;
 using TracePtr = std::unique_ptr<Trace>;
+class BatchTrace;
+using BatchTracePtr = std::unique_ptr<BatchTrace>;
 
 using Kernels = std::unordered_map<std::string, int>;
 
@@ -16,12 +16,261 @@
 #ifndef GUARD_AMDINFER_SERVERS_SERVER
 #define GUARD_AMDINFER_SERVERS_SERVER
 
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <filesystem>
+#include <map>
 #include <memory>
+#include <string>
+#include <vector>
+
+#include "amdinfer/build_options.hpp"
+#include "amdinfer/core/bulk_job.hpp"
+#include "amdinfer/core/compression.hpp"
 
 namespace amdinfer {
 
+class ParameterMap;
+
+/// Use as a thread or queue count to derive it from the available CPUs
+constexpr auto kThreadsAuto = 0;
+
+struct HttpServerOptions {
+  /// Number of I/O threads. If kThreadsAuto, one per available CPU
+  int threads = kDefaultDrogonThreads;
+  /// Maximum size of a request body in bytes
+  size_t max_body_size = kMaxClientBodySize;
+  /**
+   * @brief Serve the debugging endpoints that profile the server and dump the
+   * state of its queues and workers. They're off by default as profiling
+   * slows the server down while it runs
+   */
+  bool debug_endpoints = false;
+  /**
+   * @brief How inference responses are compressed. A response is compressed if
+   * it's at least as large as the threshold and its request accepts the
+   * algorithm, or the other supported one, in its Accept-Encoding header.
+   * Compressed requests are accepted regardless.
+   */
+  CompressionOptions compression;
+  /**
+   * @brief Responses with at least this many bytes of binary outputs are sent
+   * with chunked transfer encoding, straight from the outputs' buffers,
+   * unless they're compressed. If zero, responses aren't streamed
+   */
+  size_t stream_threshold = kDefaultHttpStreamThreshold;
+  /**
+   * @brief Seconds that an idle connection is kept open, which is how long
+   * clients may keep connections alive between requests. If zero, idle
+   * connections are kept open until their clients close them
+   */
+  size_t idle_connection_timeout = kDefaultHttpIdleTimeout;
+  /// Most requests served on a connection before it's closed. If zero, no limit
+  size_t keepalive_requests = 0;
+  /**
+   * @brief Most pipelined requests that may be pending on a connection. More
+   * aren't read until earlier ones are answered. If zero, no limit
+   */
+  size_t pipelining_requests = 0;
+  /// Most connections that may be open at once
+  size_t max_connections = kDefaultHttpMaxConnections;
+  /// Most connections that may be open from one IP. If zero, no limit
+  size_t max_connections_per_ip = 0;
+  /// Add the CORS header Access-Control-Allow-Origin: * to every response
+  bool cors = true;
+};
+
+struct GrpcServerOptions {
+  /// Number of completion queues. If kThreadsAuto, one per available CPU
+  int completion_queues = kDefaultGrpcCompletionQueues;
+  /**
+   * @brief Number of threads polling each completion queue. If kThreadsAuto,
+   * the available CPUs are divided between the completion queues
+   */
+  int threads_per_queue = kDefaultGrpcThreadsPerQueue;
+  /**
+   * @brief Number of inference calls posted on each completion queue to accept
+   * RPCs. Each call posts another as its RPC arrives so more of them absorb
+   * bursts of RPCs before the queue's threads catch up. Must be positive
+   */
+  int infer_slots = kDefaultGrpcInferSlots;
+  /**
+   * @brief Serve RPCs on gRPC's callback API instead of polling completion
+   * queues. gRPC then runs the calls on its own threads and the completion
+   * queue options are ignored
+   */
+  bool callback_api = false;
+  /**
+   * @brief Number of threads that map and submit inference requests when the
+   * callback API is used so gRPC's threads are free to move messages. If
+   * kThreadsAuto, one per available CPU
+   */
+  int request_threads = kThreadsAuto;
+  /// Maximum size of a sent or received message in bytes
+  int max_message_size = kMaxGrpcMessageSize;
+  /**
+   * @brief How inference responses are compressed. A response is compressed if
+   * it's at least as large as the threshold. Compressed requests are accepted
+   * regardless.
+   */
+  CompressionOptions compression;
+  /**
+   * @brief Path of a Unix domain socket to listen on as well. Co-located
+   * clients can connect to it with the address unix:<path> to skip the TCP
+   * stack. If empty, no socket is used
+   */
+  std::string unix_socket;
+  /// Listen on the TCP port. If false, unix_socket must be set
+  bool tcp = true;
+};
+
+/// The largest message that the socket server accepts by default, in bytes
+constexpr uint64_t kDefaultSocketMessageSize = 1ULL << 30U;
+
+struct SocketServerOptions {
+  /// Most bytes that a request may have after its header
+  uint64_t max_message_size = kDefaultSocketMessageSize;
+  /// Send responses as soon as they're written instead of coalescing them
+  bool tcp_nodelay = true;
+};
+
+struct AdminServerOptions {
+  /**
+   * @brief Serve the debugging endpoints that profile the server and dump the
+   * state of its queues and workers as well
+   */
+  bool debug_endpoints = false;
+  /**
+   * @brief Serve the endpoints that start, track and cancel bulk jobs, which
+   * read and write files on the server's disk
+   */
+  bool bulk_jobs = false;
+};
+
+/// Models that are loaded from the repository at once by default
+constexpr auto kDefaultRepositoryLoads = 4;
+/// Parts of files that are downloaded from a remote repository at once
+constexpr auto kDefaultRepositoryDownloads = 8;
+
+struct RepositoryOptions {
+  /**
+   * @brief Most models in the repository that are loaded at once at startup.
+   * If kThreadsAuto, one per available CPU
+   */
+  int load_threads = kDefaultRepositoryLoads;
+  /**
+   * @brief Most models that are loaded at once onto each kind of device, which
+   * is cpu, gpu or dpu depending on the model's platform. Devices that aren't
+   * listed, or whose limit is zero, are only limited by the load threads
+   */
+  std::map<std::string, int> device_loads;
+  /**
+   * @brief Load models from the repository when they're first requested
+   * instead of only on demand with modelLoad. Requests that arrive while their
+   * model loads wait for it
+   */
+  bool lazy_load = false;
+  /**
+   * @brief Most bytes that models loaded by their first request may take on
+   * each kind of device. If loading one would exceed it, idle ones are
+   * unloaded least recently used first. A model's memory is estimated by the
+   * size of its files. Devices that aren't listed, or whose budget is zero,
+   * are unlimited
+   */
+  std::map<std::string, size_t> memory_budgets;
+  /**
+   * @brief Directory that files of remote repositories are downloaded to. If
+   * it's empty, it's the remote directory in the model cache
+   */
+  std::string cache_directory;
+  /// Most parts of files that are downloaded from a remote repository at once
+  int download_threads = kDefaultRepositoryDownloads;
+};
+
+/// Milliseconds between fetches of the peers' loads by default
+constexpr auto kDefaultPeerPollInterval = 100;
+/// The queued work on an endpoint before requests go to peers by default
+constexpr auto kDefaultPeerForwardThreshold = 8;
+
+struct PeerOptions {
+  /**
+   * @brief The other servers in the pool as host:socket_port:http_port.
+   * Requests are forwarded to their socket servers and their loads are
+   * fetched from their HTTP servers
+   */
+  std::vector<std::string> peers;
+  /// Milliseconds between fetches of the peers' loads
+  int poll_interval = kDefaultPeerPollInterval;
+  /**
+   * @brief Requests go to the least loaded peer once this many requests and
+   * batches are queued for their model here and the peer has less queued. If
+   * their model isn't loaded here, they go to a peer that has it regardless
+   */
+  int forward_threshold = kDefaultPeerForwardThreshold;
+};
+
+/// Seconds between trims of the memory pool by default
+constexpr auto kDefaultMemoryTrimInterval = 30;
+
+struct MemoryTrimOptions {
+  /// Seconds between trims of the memory pool
+  int interval = kDefaultMemoryTrimInterval;
+  /**
+   * @brief MiB that each of the memory pool's allocators may keep allocated.
+   * Memory above this that no buffer uses is given back to the system
+   */
+  int keep_mb = 0;
+};
+
+/// MiB that a traffic log may grow to by default
+constexpr auto kDefaultTrafficLogMb = 1024;
+
+struct TrafficCaptureOptions {
+  /// The log to record to. An existing file is replaced
+  std::string path;
+  /// Fraction of the requests to record, evenly spaced
+  double sample_rate = 1;
+  /// MiB that the log may grow to. The recording stops once it's full
+  int max_mb = kDefaultTrafficLogMb;
+  /**
+   * @brief Record the data of the inputs and not just their shapes. Inputs
+   * whose data is in GPU memory or is decoded straight into the batch are
+   * recorded without their data regardless
+   */
+  bool payloads = false;
+};
+
+/// Limits on what one tenant may send. Zero means no limit
+struct TenantLimit {
+  /// Inference calls per second
+  double requests_per_second = 0;
+  /// Bytes of inference calls per second
+  double bytes_per_second = 0;
+  /// Most inference calls in flight at once
+  int max_in_flight = 0;
+};
+
+/// Most tenants that are limited apart by default
+constexpr auto kDefaultTenants = 1024;
+
+struct TenantLimitOptions {
+  /// The header, or gRPC metadata key, that names the tenant
+  std::string header = "x-tenant-id";
+  /// The limits of tenants that aren't listed
+  TenantLimit limits;
+  /// The limits of particular tenants, by name
+  std::map<std::string, TenantLimit> tenants;
+  /// Seconds of its rates that an idle tenant may send at once
+  double burst = 1;
+  /**
+   * @brief Most unlisted tenants that are limited apart. Calls from later ones
+   * are limited together as the tenant "other" so the tenants tracked, and
+   * their metrics, stay bounded
+   */
+  int max_tenants = kDefaultTenants;
+};
+
 class Server {
  public:
   /// Constructs a new Server object
@@ -41,27 +290,78 @@ class Server {
    * @brief Start the HTTP server
    *
    * @param port port to use for the HTTP server
+   * @param options options to size the HTTP server with
    */
-  void startHttp(uint16_t port) const;
+  void startHttp(uint16_t port, const HttpServerOptions& options = {}) const;
   /// Stop the HTTP server
   void stopHttp() const;
   /**
    * @brief Start the gRPC server
    *
    * @param port port to use for the gRPC server
+   * @param options options to size the gRPC server with
    */
-  void startGrpc(uint16_t port) const;
+  void startGrpc(uint16_t port, const GrpcServerOptions& options = {}) const;
   /// Stop the gRPC server
   void stopGrpc() const;
+  /**
+   * @brief Start the socket server. It serves inference over TCP with the
+   * binary wire format, which sends requests and responses whole with little
+   * overhead. Clients can connect to it with the SocketClient
+   *
+   * @param port port to use for the socket server
+   * @param options options to configure the socket server with
+   */
+  void startSocket(uint16_t port,
+                   const SocketServerOptions& options = {}) const;
+  /// Stop the socket server
+  void stopSocket() const;
+  /**
+   * @brief Start the admin server. It serves the metrics, the health checks
+   * and, optionally, the debugging endpoints over HTTP on a port and thread of
+   * its own so scraping and probing the server doesn't take time from the
+   * threads that serve inference
+   *
+   * @param port port to use for the admin server
+   * @param options options to configure the admin server with
+   */
+  void startAdmin(uint16_t port, const AdminServerOptions& options = {}) const;
+  /// Stop the admin server
+  void stopAdmin() const;
+  /**
+   * @brief Serve a worker to the server that started this process as its host,
+   * over the shared memory channel that the server created. It returns once
+   * the server closes the channel. Workers are hosted in processes of their
+   * own when they're loaded with the "process" parameter
+   *
+   * @param channel the name of the channel to the server
+   */
+  void hostWorker(const std::string& channel) const;
+  /**
+   * @brief Set the least time between serializations of the metrics. Scrapes
+   * that arrive sooner get the last serialization so many collectors scraping
+   * the server cost one serialization per interval
+   *
+   * @param interval the least time between serializations. If zero, each
+   * scrape serializes the metrics
+   */
+  void setScrapeInterval(std::chrono::milliseconds interval) const;
 
   /**
-   * @brief Set the path to the model repository associated with this server
+   * @brief Set the path to the model repository associated with this server.
+   * Existing models are loaded in parallel in the background and the server
+   * isn't ready until they've all loaded. If any fail to load, it stays not
+   * ready.
    *
-   * @param path path to the model repository
+   * @param path path to the model repository or a URL of a remote one, such
+   * as s3://bucket/models, gs://bucket/models or https://host/models
    * @param load_existing load all existing models found at the path
+   * @param options how many models to load at once and whether to load
+   * others when they're first requested
    */
   void setModelRepository(const std::filesystem::path& repository_path,
-                          bool load_existing);
+                          bool load_existing,
+                          const RepositoryOptions& options = {});
   /**
    * @brief Turn on active monitoring of the model repository path for new
    * files. A model repository must be set with setModelRepository() before
@@ -72,6 +372,92 @@ class Server {
    * platforms.
    */
   void enableRepositoryMonitoring(bool use_polling);
+  /**
+   * @brief Mark the server as not ready until setModelRepository() has been
+   * called and the existing models have loaded. Servers that start their
+   * listeners before they set the repository, so liveness checks pass while
+   * it's scanned, call this first so they aren't reported as ready too soon.
+   */
+  void expectModelRepository();
+  /**
+   * @brief Save load-time parameters into a model's config.pbtxt in the model
+   * repository, over any that it has, so they're used the next time it's
+   * loaded. A monitored repository reloads the model with them. It throws if
+   * the model's config can't be read or written.
+   *
+   * @param model name of the model
+   * @param parameters the parameters to save
+   */
+  void saveModelParameters(const std::string& model,
+                           const ParameterMap& parameters) const;
+  /**
+   * @brief Forward requests to other servers in a pool when they're better
+   * served there. Each server reports the work queued for its models to the
+   * others and requests go to a less loaded peer or to one that has their
+   * model loaded. Forwarding needs the HTTP server and the peers need their
+   * HTTP and socket servers running.
+   *
+   * @param options the peers and when to forward to them
+   */
+  void enablePeers(const PeerOptions& options);
+  /**
+   * @brief Give the memory that the server's buffers no longer use back to
+   * the system periodically. Otherwise, the memory taken during a spike in
+   * traffic is held until the server exits.
+   *
+   * @param options how often to trim and how much memory to keep
+   */
+  void enableMemoryTrimming(const MemoryTrimOptions& options);
+  /**
+   * @brief Record the inference requests that arrive at the server to a
+   * compact binary log: when each arrived, its endpoint and the shapes of its
+   * inputs and, optionally, their data. The log can be replayed with its
+   * original timing by amdinfer-perf or read with a TrafficLog. Requests are
+   * written by a thread of their own and are dropped rather than recorded if
+   * the disk falls behind.
+   *
+   * @param options where to record to and how much
+   */
+  void enableTrafficCapture(const TrafficCaptureOptions& options);
+  /**
+   * @brief Limit the inference calls that each tenant sends by their rate,
+   * their bytes per second and how many are in flight. Calls are admitted as
+   * they arrive at the HTTP and gRPC servers, before they're parsed, and calls
+   * over their tenant's limits fail with HTTP status 429 or gRPC status
+   * RESOURCE_EXHAUSTED. Calls without the header are limited together as the
+   * tenant "anonymous". It must be called before the servers start.
+   *
+   * @param options the header that names tenants and their limits
+   */
+  void enableTenantLimits(const TenantLimitOptions& options);
+  /**
+   * @brief Run a dataset file through a model in the background and write
+   * the responses to a file, with as many requests in flight as the options
+   * allow so the model's batcher makes full batches. The dataset is mapped
+   * into memory and read in place and the results are written in large
+   * sequential writes. The results can be read with BulkResults. It throws
+   * if the dataset can't be read or the results can't be written.
+   *
+   * @param options the model, the dataset and where to write to
+   * @return std::string the job's ID
+   */
+  std::string startBulkJob(const BulkJobOptions& options) const;
+  /**
+   * @brief Get how far a bulk job has got. It throws invalid_argument if the
+   * job is unknown
+   *
+   * @param id the job's ID
+   * @return BulkJobProgress
+   */
+  BulkJobProgress getBulkJob(const std::string& id) const;
+  /**
+   * @brief Stop sending a bulk job's samples. The results written so far are
+   * kept in its output with .partial appended. It throws invalid_argument if
+   * the job is unknown
+   *
+   * @param id the job's ID
+   */
+  void cancelBulkJob(const std::string& id) const;
 
   friend class NativeClient;
 
@@ -0,0 +1,88 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the adaptive timeout used by the soft batcher
+ */
+
+#include "amdinfer/batching/adaptive_timeout.hpp"
+
+#include <algorithm>  // for clamp, min
+#include <chrono>     // for duration
+#include <optional>   // for optional
+#include <ratio>      // for milli
+
+namespace amdinfer {
+
+namespace {
+
+// weight given to each new sample in the moving averages
+constexpr auto kSmoothing = 0.1;
+// wait up to this multiple of the expected time for the batch to fill to
+// absorb some jitter in the arrivals
+constexpr auto kFillMargin = 2.0;
+
+void update(std::optional<double>* average, double sample) {
+  if (average->has_value()) {
+    *average = kSmoothing * sample + (1 - kSmoothing) * average->value();
+  } else {
+    *average = sample;
+  }
+}
+
+}  // namespace
+
+AdaptiveTimeout::AdaptiveTimeout(double latency_slo, double max_timeout)
+  : latency_slo_(latency_slo), max_timeout_(max_timeout) {}
+
+void AdaptiveTimeout::recordArrival(util::TimePoint time) {
+  std::lock_guard lock{mutex_};
+  if (last_arrival_.has_value()) {
+    const std::chrono::duration<double, std::milli> gap =
+      time - last_arrival_.value();
+    update(&inter_arrival_, gap.count());
+  }
+  last_arrival_ = time;
+}
+
+void AdaptiveTimeout::recordService(double duration) {
+  std::lock_guard lock{mutex_};
+  update(&service_time_, duration);
+}
+
+double AdaptiveTimeout::getTimeout(size_t batch_size) const {
+  if (batch_size <= 1) {
+    return 0;
+  }
+
+  std::lock_guard lock{mutex_};
+
+  auto budget = latency_slo_ - service_time_.value_or(0);
+  budget = std::clamp(budget, 0.0, max_timeout_);
+  // until there are enough arrivals to estimate from, wait as long as allowed
+  if (!inter_arrival_.has_value()) {
+    return budget;
+  }
+
+  const auto inter_arrival = inter_arrival_.value();
+  if (inter_arrival > budget) {
+    return 0;
+  }
+  const auto fill_time =
+    static_cast<double>(batch_size - 1) * inter_arrival * kFillMargin;
+  return std::min(budget, fill_time);
+}
+
+}  // namespace amdinfer
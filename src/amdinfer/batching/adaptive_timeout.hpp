@@ -0,0 +1,84 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the adaptive timeout used by the soft batcher
+ */
+
+#ifndef GUARD_AMDINFER_BATCHING_ADAPTIVE_TIMEOUT
+#define GUARD_AMDINFER_BATCHING_ADAPTIVE_TIMEOUT
+
+#include <cstddef>   // for size_t
+#include <mutex>     // for mutex
+#include <optional>  // for optional
+
+#include "amdinfer/util/timer.hpp"  // for TimePoint
+
+namespace amdinfer {
+
+/**
+ * @brief The AdaptiveTimeout picks how long a batcher should wait for a batch
+ * to fill. It tracks moving averages of the time between incoming requests and
+ * of the time a batch takes from leaving the batcher until the worker is done
+ * with it. The wait is the longest that still meets the latency SLO but no
+ * longer than the batch is expected to take to fill. If not even one more
+ * request is expected within the SLO, it doesn't wait at all.
+ */
+class AdaptiveTimeout {
+ public:
+  /**
+   * @brief Construct a new AdaptiveTimeout object
+   *
+   * @param latency_slo target latency for requests in milliseconds
+   * @param max_timeout upper bound on the timeout in milliseconds
+   */
+  AdaptiveTimeout(double latency_slo, double max_timeout);
+
+  /**
+   * @brief Record the arrival of a new request at the batcher
+   *
+   * @param time time when the request arrived
+   */
+  void recordArrival(util::TimePoint time);
+  /**
+   * @brief Record the time taken to serve a batch after it left the batcher.
+   * This may be called from the worker threads.
+   *
+   * @param duration service time in milliseconds
+   */
+  void recordService(double duration);
+
+  /**
+   * @brief Get the time to wait, after a batch's first request, for the batch
+   * to fill
+   *
+   * @param batch_size the target batch size
+   * @return double timeout in milliseconds
+   */
+  [[nodiscard]] double getTimeout(size_t batch_size) const;
+
+ private:
+  double latency_slo_;
+  double max_timeout_;
+
+  mutable std::mutex mutex_;
+  std::optional<util::TimePoint> last_arrival_;
+  std::optional<double> inter_arrival_;
+  std::optional<double> service_time_;
+};
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_BATCHING_ADAPTIVE_TIMEOUT
@@ -20,12 +20,34 @@
 #include "amdinfer/batching/batch.hpp"
 
 #include <cassert>
+#include <cstddef>  // for byte, size_t
+#include <memory>   // for make_unique
+#include <mutex>    // for lock_guard
+#include <utility>  // for move
 
 #include "amdinfer/buffers/buffer.hpp"
 #include "amdinfer/observation/tracing.hpp"
 
 namespace amdinfer {
 
+Batch::~Batch() {
+  if (on_complete_) {
+    on_complete_();
+  }
+}
+
+void Batch::addCompletionCallback(std::function<void()> callback) {
+  if (!on_complete_) {
+    on_complete_ = std::move(callback);
+    return;
+  }
+  on_complete_ = [first = std::move(on_complete_),
+                  second = std::move(callback)]() {
+    first();
+    second();
+  };
+}
+
 void Batch::addRequest(InferenceRequestPtr request) {
   requests_.push_back(std::move(request));
 }
@@ -41,6 +63,14 @@ std::vector<Buffer*> Batch::getRawInputBuffers() const {
 
 BufferPtrs Batch::getInputBuffers() { return std::move(input_buffers_); }
 
+void Batch::releaseInputBuffers(
+  const std::function<void(BufferPtr)>& release) {
+  for (auto& buffer : input_buffers_) {
+    release(std::move(buffer));
+  }
+  input_buffers_.clear();
+}
+
 std::vector<Buffer*> Batch::getRawOutputBuffers() const {
   std::vector<Buffer*> buffers;
   buffers.reserve(output_buffers_.size());
@@ -73,7 +103,9 @@ size_t Batch::size() const {
   return requests_.size();
 }
 
-size_t Batch::getInputSize() const { return input_buffers_.size(); }
+size_t Batch::getInputSize() const {
+  return segments_.empty() ? input_buffers_.size() : segments_.size();
+}
 
 size_t Batch::getOutputSize() const { return output_buffers_.size(); }
 
@@ -82,20 +114,158 @@ void Batch::setBuffers(BufferPtrs inputs, BufferPtrs outputs) {
   output_buffers_ = std::move(outputs);
 }
 
+void Batch::addInputBuffer(BufferPtr buffer) {
+  input_buffers_.push_back(std::move(buffer));
+}
+
+void Batch::addSegment(size_t input, BufferSegment segment) {
+  if (input >= segments_.size()) {
+    segments_.resize(input + 1);
+  }
+  segments_[input].push_back(segment);
+}
+
+const BufferSegments& Batch::getSegments(size_t input) const {
+  return segments_.at(input);
+}
+
+bool Batch::isScatterGather() const { return !segments_.empty(); }
+
+void* Batch::getContiguousInput(size_t bytes) const {
+  if (!isScatterGather()) {
+    return input_buffers_.size() == 1 ? input_buffers_[0]->data(0) : nullptr;
+  }
+
+  // there must be one input for its segments to make up the tensor
+  if (segments_.size() != 1) {
+    return nullptr;
+  }
+  const auto& segments = segments_.front();
+  if (segments.empty()) {
+    return nullptr;
+  }
+  auto* start = static_cast<std::byte*>(segments.front().data);
+  size_t size = 0;
+  for (const auto& segment : segments) {
+    if (static_cast<std::byte*>(segment.data) != start + size) {
+      return nullptr;
+    }
+    size += segment.size;
+  }
+  return size == bytes ? start : nullptr;
+}
+
+void Batch::setOffsets(std::vector<std::vector<uint64_t>> offsets) {
+  offsets_ = std::move(offsets);
+  segments_.clear();
+}
+
+const std::vector<uint64_t>& Batch::getOffsets(size_t input) const {
+  return offsets_.at(input);
+}
+
+bool Batch::isRagged() const { return !offsets_.empty(); }
+
+void Batch::addTiming(RequestTimingPtr timing) {
+  timings_.push_back(std::move(timing));
+}
+
+const std::vector<RequestTimingPtr>& Batch::getTimings() const {
+  return timings_;
+}
+
+void Batch::setSequenceStates(std::shared_ptr<SequenceStates> states) {
+  sequence_states_ = std::move(states);
+}
+
+SequenceStates* Batch::getSequenceStates() const {
+  return sequence_states_.get();
+}
+
 #ifdef AMDINFER_ENABLE_TRACING
 void Batch::addTrace(TracePtr trace) { traces_.push_back(std::move(trace)); }
 
 TracePtr& Batch::getTrace(size_t index) { return traces_.at(index); }
+
+void Batch::startSpan(const char* name) {
+  span_ = std::make_unique<BatchTrace>(name, traces_);
+}
+
+void Batch::endSpan() {
+  if (span_ != nullptr) {
+    span_->end();
+  }
+}
 #endif
 
 #ifdef AMDINFER_ENABLE_METRICS
-void Batch::addTime(std::chrono::high_resolution_clock::time_point timestamp) {
+void Batch::addTime(util::TimePoint timestamp) {
   start_times_.push_back(timestamp);
 }
 
-std::chrono::high_resolution_clock::time_point Batch::getTime(size_t index) {
+util::TimePoint Batch::getTime(size_t index) {
   return start_times_.at(index);
 }
 #endif
 
+void Batch::recycle(std::unique_ptr<Batch> batch) {
+  if (batch == nullptr || batch->free_list_ == nullptr) {
+    return;
+  }
+  // the batch doesn't hold its list while it's in it so they don't keep each
+  // other alive
+  auto free_list = std::move(batch->free_list_);
+  batch->reset();
+  free_list->put(std::move(batch));
+}
+
+void Batch::reset() {
+  if (on_complete_) {
+    on_complete_();
+    on_complete_ = nullptr;
+  }
+  // clear() keeps the capacity of each list
+  requests_.clear();
+  input_buffers_.clear();
+  output_buffers_.clear();
+  segments_.clear();
+  offsets_.clear();
+  timings_.clear();
+  sequence_states_.reset();
+#ifdef AMDINFER_ENABLE_TRACING
+  span_.reset();
+  traces_.clear();
+#endif
+#ifdef AMDINFER_ENABLE_METRICS
+  start_times_.clear();
+#endif
+}
+
+BatchFreeList::BatchFreeList(size_t capacity) : capacity_(capacity) {
+  batches_.reserve(capacity);
+}
+
+BatchPtr BatchFreeList::get() {
+  BatchPtr batch;
+  {
+    const std::lock_guard lock{mutex_};
+    if (!batches_.empty()) {
+      batch = std::move(batches_.back());
+      batches_.pop_back();
+    }
+  }
+  if (batch == nullptr) {
+    batch = std::make_unique<Batch>();
+  }
+  batch->free_list_ = shared_from_this();
+  return batch;
+}
+
+void BatchFreeList::put(BatchPtr batch) {
+  const std::lock_guard lock{mutex_};
+  if (batches_.size() < capacity_) {
+    batches_.push_back(std::move(batch));
+  }
+}
+
 }  // namespace amdinfer
@@ -20,13 +20,34 @@
 #ifndef GUARD_AMDINFER_BATCHING_BATCH
 #define GUARD_AMDINFER_BATCHING_BATCH
 
+#include <cstddef>     // for size_t
+#include <cstdint>     // for uint64_t
+#include <functional>  // for function
+#include <memory>      // for shared_ptr, enable_shared_from_this
+#include <mutex>       // for mutex
+#include <vector>      // for vector
+
 #include "amdinfer/build_options.hpp"
+#include "amdinfer/core/request_timing.hpp"  // for RequestTimingPtr
 #include "amdinfer/declarations.hpp"
+#include "amdinfer/util/timer.hpp"           // for TimePoint
 
 namespace amdinfer {
 
+class BatchFreeList;
+class SequenceStates;
 class WorkerInfo;
 
+/// The most empty batches that a batcher's free list keeps by default
+constexpr size_t kDefaultBatchFreeListSize = 16;
+
+/// A contiguous piece of one input tensor's data in a scatter-gather batch
+struct BufferSegment {
+  void* data;
+  size_t size;
+};
+using BufferSegments = std::vector<BufferSegment>;
+
 /**
  * @brief The Batch is what the batcher produces and pushes to the workers. It
  * represents the requests, the buffers associated with the request and other
@@ -35,16 +56,118 @@ class WorkerInfo;
  */
 class Batch {
  public:
+  Batch() = default;                         ///< Constructor
+  Batch(const Batch&) = delete;              ///< Copy constructor
+  Batch& operator=(const Batch&) = delete;   ///< Copy assignment constructor
+  Batch(Batch&& other) = delete;             ///< Move constructor
+  Batch& operator=(Batch&& other) = delete;  ///< Move assignment constructor
+  ~Batch();                                  ///< Destructor
+
   void addRequest(InferenceRequestPtr request);
+  /**
+   * @brief Add a function to call when the batch is destroyed i.e. once the
+   * worker is done with it. Batchers can use it to measure service times.
+   * Callbacks are called in the order they're added.
+   *
+   * @param callback function to call
+   */
+  void addCompletionCallback(std::function<void()> callback);
 
   void setBuffers(BufferPtrs inputs, BufferPtrs outputs);
+  /**
+   * @brief Add a buffer to the batch's input buffers. In a scatter-gather
+   * batch, these are the buffers holding each request's data so they can be
+   * returned to the pool with the batch.
+   *
+   * @param buffer buffer to add
+   */
+  void addInputBuffer(BufferPtr buffer);
+  /**
+   * @brief Add a segment to the scatter-gather view of an input tensor
+   *
+   * @param input index of the input tensor
+   * @param segment location and size of one request's data for this input
+   */
+  void addSegment(size_t input, BufferSegment segment);
   [[nodiscard]] const InferenceRequestPtr& getRequest(size_t index);
   [[nodiscard]] const std::vector<InferenceRequestPtr>& getRequests() const;
   [[nodiscard]] std::vector<BufferPtr> getInputBuffers();
+  /**
+   * @brief Hand each input buffer to a function, such as one that returns it
+   * to the pool. Unlike getInputBuffers(), the batch keeps its emptied list
+   * of buffers so it can be reused
+   *
+   * @param release the function to hand the buffers to
+   */
+  void releaseInputBuffers(const std::function<void(BufferPtr)>& release);
   [[nodiscard]] std::vector<BufferPtr> getOutputBuffers();
   [[nodiscard]] std::vector<Buffer*> getRawInputBuffers() const;
   [[nodiscard]] std::vector<Buffer*> getRawOutputBuffers() const;
 
+  /**
+   * @brief Get the scatter-gather view of an input tensor. It has one segment
+   * per request, in the same order as the requests
+   *
+   * @param input index of the input tensor
+   * @return const BufferSegments&
+   */
+  [[nodiscard]] const BufferSegments& getSegments(size_t input) const;
+  /// Check if the batch's inputs are segments rather than contiguous buffers
+  [[nodiscard]] bool isScatterGather() const;
+  /**
+   * @brief Get the batch's only input if its data is already contiguous so it
+   * can be used in place. This is the case for batches the batcher has
+   * concatenated and for scatter-gather batches whose requests' data happen to
+   * be adjacent, such as batches of one request.
+   *
+   * @param bytes the number of bytes the input tensor needs
+   * @return void* the contiguous data or nullptr if it isn't contiguous
+   */
+  [[nodiscard]] void* getContiguousInput(size_t bytes) const;
+
+  /**
+   * @brief Make the batch ragged. Its requests' inputs are concatenated along
+   * their first dimension in the input buffers, without padding, so they may
+   * differ in their first dimension. Any segments are dropped as the buffers
+   * hold the data.
+   *
+   * @param offsets one list per input tensor of where each request's rows
+   * start along the first dimension, in the order of the requests, and then
+   * the total number of rows
+   */
+  void setOffsets(std::vector<std::vector<uint64_t>> offsets);
+  /**
+   * @brief Get the offsets of an input tensor in a ragged batch. The request
+   * j has the rows from offsets[j] to offsets[j + 1]
+   *
+   * @param input index of the input tensor
+   * @return const std::vector<uint64_t>&
+   */
+  [[nodiscard]] const std::vector<uint64_t>& getOffsets(size_t input) const;
+  /// Check if the batch's inputs are concatenated with offsets
+  [[nodiscard]] bool isRagged() const;
+
+  /**
+   * @brief Add the timing of a request in the batch that asked for it. It's
+   * filled in as the batch is taken by a worker
+   *
+   * @param timing timing of the request
+   */
+  void addTiming(RequestTimingPtr timing);
+  /// Get the timing of the requests in the batch that asked for it
+  [[nodiscard]] const std::vector<RequestTimingPtr>& getTimings() const;
+
+  /**
+   * @brief Set the states of the sequences that the batch's requests are steps
+   * of. Sequence batchers set it so workers can keep the state of each
+   * request's "sequence_slot" between steps
+   *
+   * @param states the states of the batcher's sequences
+   */
+  void setSequenceStates(std::shared_ptr<SequenceStates> states);
+  /// Get the states of the batch's sequences or nullptr if it has none
+  [[nodiscard]] SequenceStates* getSequenceStates() const;
+
   [[nodiscard]] bool empty() const;
   [[nodiscard]] size_t size() const;
   [[nodiscard]] size_t getInputSize() const;
@@ -53,30 +176,97 @@ class Batch {
 #ifdef AMDINFER_ENABLE_TRACING
   void addTrace(TracePtr trace);
   TracePtr& getTrace(size_t index);
+  /**
+   * @brief Start one span for the work a worker does on the whole batch,
+   * linked to the active span of each of its requests, instead of a span in
+   * each request's trace. It ends when endSpan() is called or the batch is
+   * done
+   *
+   * @param name name of the span
+   */
+  void startSpan(const char* name);
+  /// End the span of the batch, if it has one
+  void endSpan();
 #endif
 #ifdef AMDINFER_ENABLE_METRICS
-  void addTime(std::chrono::high_resolution_clock::time_point timestamp);
-  std::chrono::high_resolution_clock::time_point getTime(size_t index);
+  void addTime(util::TimePoint timestamp);
+  util::TimePoint getTime(size_t index);
 #endif
 
   [[nodiscard]] auto begin() const { return requests_.begin(); }
   [[nodiscard]] auto end() const { return requests_.end(); }
 
+  /**
+   * @brief Give a batch back to the free list of the batcher that made it once
+   * the worker is done with it. As if it were destroyed, its completion
+   * callbacks are called and its requests and buffers are released, but its
+   * lists keep their capacity for the batcher's next batch. Batches that
+   * aren't from a free list are destroyed.
+   *
+   * @param batch the batch to recycle
+   */
+  static void recycle(std::unique_ptr<Batch> batch);
+
  private:
+  friend class BatchFreeList;
+
+  /// Call the completion callbacks and empty the batch
+  void reset();
+
   const WorkerInfo* worker_;
   std::vector<InferenceRequestPtr> requests_;
   std::vector<BufferPtr> input_buffers_;
   std::vector<BufferPtr> output_buffers_;
+  std::vector<BufferSegments> segments_;
+  std::vector<std::vector<uint64_t>> offsets_;
+  std::function<void()> on_complete_;
+  std::vector<RequestTimingPtr> timings_;
+  std::shared_ptr<SequenceStates> sequence_states_;
 #ifdef AMDINFER_ENABLE_TRACING
   std::vector<TracePtr> traces_;
+  BatchTracePtr span_;
 #endif
 #ifdef AMDINFER_ENABLE_METRICS
-  std::vector<std::chrono::high_resolution_clock::time_point> start_times_;
+  std::vector<util::TimePoint> start_times_;
 #endif
+  /// the free list that the batch goes back to, which is only set while it's
+  /// in use
+  std::shared_ptr<BatchFreeList> free_list_;
 };
 
 using BatchPtr = std::unique_ptr<Batch>;
 
+/**
+ * @brief The BatchFreeList holds the empty batches of an endpoint's batchers
+ * so that making a batch doesn't allocate it and its lists each time. The
+ * batchers take batches from it and the workers give them back with
+ * Batch::recycle(). It's thread-safe and it keeps a bounded number of batches,
+ * destroying the rest.
+ */
+class BatchFreeList : public std::enable_shared_from_this<BatchFreeList> {
+ public:
+  /**
+   * @brief Construct a new BatchFreeList object
+   *
+   * @param capacity the most empty batches to keep
+   */
+  explicit BatchFreeList(size_t capacity = kDefaultBatchFreeListSize);
+
+  /// Get an empty batch, which goes back to this list when it's recycled
+  [[nodiscard]] BatchPtr get();
+  /**
+   * @brief Keep an empty batch for reuse or destroy it if the list is full
+   *
+   * @param batch the batch to keep, which must be reset
+   */
+  void put(BatchPtr batch);
+
+ private:
+  size_t capacity_;
+  std::mutex mutex_;
+  std::vector<BatchPtr> batches_;
+};
+
 }  // namespace amdinfer
 
 #endif  // GUARD_AMDINFER_BATCHING_BATCH
@@ -0,0 +1,202 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the queue used to pass batches from batchers to workers
+ */
+
+#include "amdinfer/batching/batch_queue.hpp"
+
+#include <atomic>              // for atomic
+#include <chrono>              // for microseconds, steady_clock
+#include <condition_variable>  // for condition_variable
+#include <mutex>               // for mutex, lock_guard, unique_lock
+#include <utility>             // for move
+
+#include "amdinfer/core/request_timing.hpp"  // for RequestTiming
+#include "amdinfer/util/timer.hpp"           // for getTime
+
+namespace amdinfer {
+
+/// The group counts the batches across all its queues to wake up consumers
+struct BatchQueue::Group {
+  std::mutex mutex;
+  std::condition_variable cv;
+  /// changed with the mutex held but spinning consumers read it without it
+  std::atomic<size_t> available{0};
+  std::vector<BatchQueue*> queues;
+};
+
+/**
+ * @brief The activity counts the batches in flight from this queue's consumers
+ * and, if it has a callback, reports how long they're busy
+ */
+struct BatchQueue::Activity {
+  void begin() {
+    std::lock_guard lock{mutex};
+    if (in_flight++ == 0) {
+      busy_since = std::chrono::steady_clock::now();
+    }
+  }
+
+  void end() {
+    std::chrono::duration<double> busy{0};
+    {
+      std::lock_guard lock{mutex};
+      if (--in_flight > 0) {
+        return;
+      }
+      busy = std::chrono::steady_clock::now() - busy_since;
+    }
+    if (callback) {
+      callback(busy.count());
+    }
+  }
+
+  std::mutex mutex;
+  size_t in_flight = 0;
+  std::chrono::steady_clock::time_point busy_since;
+  std::function<void(double)> callback;
+};
+
+BatchQueue::BatchQueue()
+  : group_(std::make_shared<Group>()), activity_(std::make_shared<Activity>()) {
+  group_->queues.push_back(this);
+}
+
+BatchQueue::~BatchQueue() = default;
+
+void BatchQueue::share(const std::vector<BatchQueue*>& queues) {
+  auto group = std::make_shared<Group>();
+  group->queues = queues;
+  for (auto i = 0U; i < queues.size(); ++i) {
+    queues[i]->group_ = group;
+    queues[i]->index_ = i;
+  }
+}
+
+void BatchQueue::trackActivity(std::function<void(double)> callback) {
+  activity_->callback = std::move(callback);
+}
+
+void BatchQueue::trackBatches(std::function<void(size_t, double)> callback) {
+  batch_callback_ =
+    std::make_shared<std::function<void(size_t, double)>>(std::move(callback));
+}
+
+void BatchQueue::setWaitStrategy(const util::WaitStrategy& strategy) {
+  wait_ = strategy;
+}
+
+void BatchQueue::enqueue(BatchPtr batch) {
+  queue_.enqueue(std::move(batch));
+  {
+    std::lock_guard lock{group_->mutex};
+    group_->available++;
+  }
+  group_->cv.notify_one();
+}
+
+bool BatchQueue::try_dequeue(BatchPtr& batch) {
+  {
+    std::lock_guard lock{group_->mutex};
+    if (group_->available == 0) {
+      return false;
+    }
+    group_->available--;
+  }
+  take(batch);
+  return true;
+}
+
+void BatchQueue::wait_dequeue(BatchPtr& batch) {
+  if (util::spin(
+        wait_, util::kWaitForever, [this]() { return group_->available > 0; },
+        [&]() { return this->try_dequeue(batch); })) {
+    return;
+  }
+  {
+    std::unique_lock lock{group_->mutex};
+    group_->cv.wait(lock, [this] { return group_->available > 0; });
+    group_->available--;
+  }
+  take(batch);
+}
+
+bool BatchQueue::wait_dequeue_timed(BatchPtr& batch, int64_t timeout_usecs) {
+  const auto timeout = std::chrono::microseconds(timeout_usecs);
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  if (util::spin(
+        wait_, timeout, [this]() { return group_->available > 0; },
+        [&]() { return this->try_dequeue(batch); })) {
+    return true;
+  }
+  {
+    std::unique_lock lock{group_->mutex};
+    if (!group_->cv.wait_until(lock, deadline,
+                               [this] { return group_->available > 0; })) {
+      return false;
+    }
+    group_->available--;
+  }
+  take(batch);
+  return true;
+}
+
+size_t BatchQueue::size_approx() const { return queue_.size_approx(); }
+
+size_t BatchQueue::inFlight() const {
+  std::lock_guard lock{activity_->mutex};
+  return activity_->in_flight;
+}
+
+void BatchQueue::take(BatchPtr& batch) {
+  // a batch has been reserved for this consumer so one of the queues must have
+  // it. Look in this queue first and then move on to the neighbours
+  const auto& queues = group_->queues;
+  const auto num_queues = queues.size();
+  for (auto i = 0U;; i = (i + 1) % num_queues) {
+    auto* queue = queues[(index_ + i) % num_queues];
+    if (queue->queue_.try_dequeue(batch)) {
+      break;
+    }
+  }
+
+  // the nullptr that stops a consumer isn't work. The batches in flight are
+  // always counted so the endpoint's state can be reported
+  if (batch != nullptr) {
+    activity_->begin();
+    batch->addCompletionCallback(
+      [activity = activity_]() { activity->end(); });
+  }
+  if (batch != nullptr && !batch->getTimings().empty()) {
+    const auto now = util::getTime();
+    for (const auto& timing : batch->getTimings()) {
+      timing->taken = now;
+      timing->batch_size = batch->size();
+    }
+  }
+  if (batch_callback_ != nullptr && batch != nullptr) {
+    batch->addCompletionCallback(
+      [callback = batch_callback_, requests = batch->size(),
+       start = std::chrono::steady_clock::now()]() {
+        const std::chrono::duration<double, std::micro> duration =
+          std::chrono::steady_clock::now() - start;
+        (*callback)(requests, duration.count());
+      });
+  }
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,133 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the queue used to pass batches from batchers to workers
+ */
+
+#ifndef GUARD_AMDINFER_BATCHING_BATCH_QUEUE
+#define GUARD_AMDINFER_BATCHING_BATCH_QUEUE
+
+#include <cstddef>     // for size_t
+#include <cstdint>     // for int64_t
+#include <functional>  // for function
+#include <memory>      // for shared_ptr
+#include <vector>      // for vector
+
+#include "amdinfer/batching/batch.hpp"  // for BatchPtr
+#include "amdinfer/util/queue.hpp"      // for BlockingQueue
+#include "amdinfer/util/wait.hpp"       // for WaitStrategy
+
+namespace amdinfer {
+
+/**
+ * @brief Each batcher pushes its batches to its own BatchQueue. Queues can be
+ * grouped so that their consumers share work: a consumer takes batches from
+ * its own queue first and steals from the other queues in the group when its
+ * own is empty. A single slow worker then doesn't hold up the batches queued
+ * for it while others are idle.
+ *
+ * The methods follow the names of BlockingQueue so workers can consume from
+ * either.
+ */
+class BatchQueue {
+ public:
+  BatchQueue();                                        ///< Constructor
+  BatchQueue(const BatchQueue&) = delete;              ///< Copy constructor
+  BatchQueue& operator=(const BatchQueue&) = delete;   ///< Copy assignment
+  BatchQueue(BatchQueue&& other) = delete;             ///< Move constructor
+  BatchQueue& operator=(BatchQueue&& other) = delete;  ///< Move assignment
+  ~BatchQueue();                                       ///< Destructor
+
+  /**
+   * @brief Group these queues together so their consumers can steal batches
+   * from one another. The queues should be empty and not already in a group.
+   *
+   * @param queues queues to group
+   */
+  static void share(const std::vector<BatchQueue*>& queues);
+
+  /**
+   * @brief Track how long the consumers of this queue are busy. They're busy
+   * from when they take a batch from this queue until all the batches they've
+   * taken are destroyed. Overlapping batches count once so this measures the
+   * time that the consumers had any work in flight. This should be called
+   * before the consumers start.
+   *
+   * @param callback function called with the length of each busy period, in
+   * seconds, as it ends
+   */
+  void trackActivity(std::function<void(double)> callback);
+  /**
+   * @brief Track how long each batch from this queue is with its consumer,
+   * from when it's taken until it's destroyed. This includes responding to
+   * the batch's requests. This should be called before the consumers start.
+   *
+   * @param callback function called with the number of requests in each
+   * batch and its time, in microseconds, as it's destroyed
+   */
+  void trackBatches(std::function<void(size_t, double)> callback);
+  /**
+   * @brief Set how the consumers of this queue wait for batches. By default,
+   * they block. This should be called before the consumers start
+   *
+   * @param strategy how to wait
+   */
+  void setWaitStrategy(const util::WaitStrategy& strategy);
+
+  /// Add a batch to this queue and wake up a consumer in the group
+  void enqueue(BatchPtr batch);
+  /// Take a batch from this queue or a neighbour if there is one available
+  bool try_dequeue(BatchPtr& batch);  // NOLINT(readability-identifier-naming)
+  /// Block until a batch is available from this queue or a neighbour
+  void wait_dequeue(BatchPtr& batch);  // NOLINT(readability-identifier-naming)
+  /**
+   * @brief Block until a batch is available from this queue or a neighbour,
+   * or until the timeout elapses
+   *
+   * @param batch batch to write to
+   * @param timeout_usecs timeout in microseconds
+   * @return bool true if a batch was dequeued
+   */
+  // NOLINTNEXTLINE(readability-identifier-naming)
+  bool wait_dequeue_timed(BatchPtr& batch, int64_t timeout_usecs);
+  /// Get the approximate number of batches in this queue
+  // NOLINTNEXTLINE(readability-identifier-naming)
+  [[nodiscard]] size_t size_approx() const;
+  /**
+   * @brief Get the number of batches that this queue's consumers have taken
+   * and not yet destroyed
+   *
+   * @return size_t
+   */
+  [[nodiscard]] size_t inFlight() const;
+
+ private:
+  struct Group;
+  struct Activity;
+
+  void take(BatchPtr& batch);
+
+  BlockingQueue<BatchPtr> queue_;
+  std::shared_ptr<Group> group_;
+  size_t index_ = 0;
+  std::shared_ptr<Activity> activity_;
+  std::shared_ptr<std::function<void(size_t, double)>> batch_callback_;
+  util::WaitStrategy wait_;
+};
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_BATCHING_BATCH_QUEUE
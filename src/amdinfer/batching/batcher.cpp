@@ -20,19 +20,70 @@
 
 #include "amdinfer/batching/batcher.hpp"
 
+#include <atomic>   // for memory_order_acquire
 #include <cassert>  // for assert
+#include <chrono>   // for duration, microseconds, milliseconds
+#include <cstdint>  // for int32_t
 #include <memory>   // for shared_ptr, make_shared
 #include <string>   // for string
 #include <utility>  // for move
+#include <variant>  // for bad_variant_access
+#include <vector>   // for vector
 
-#include "amdinfer/buffers/buffer.hpp"          // IWYU pragma: keep
-#include "amdinfer/core/memory_pool/pool.hpp"   // for MemoryPool
-#include "amdinfer/core/request_container.hpp"  // for InferenceRequestInput
-#include "amdinfer/core/worker_info.hpp"        // for WorkerInfo
-#include "amdinfer/observation/logging.hpp"  // for Logger, Loggers, Logger...
+#include "amdinfer/batching/endpoint_signals.hpp"  // for EndpointSignals
+#include "amdinfer/buffers/buffer.hpp"             // IWYU pragma: keep
+#include "amdinfer/buffers/cpu.hpp"                // for CpuBuffer
+#include "amdinfer/core/exceptions.hpp"            // for invalid_argument
+#include "amdinfer/core/inference_request.hpp"     // for InferenceRequest
+#include "amdinfer/core/inference_response.hpp"    // for InferenceResponse
+#include "amdinfer/core/memory_pool/pool.hpp"      // for MemoryPool
+#include "amdinfer/core/request_coalescer.hpp"     // for RequestCoalescer
+#include "amdinfer/core/request_container.hpp"     // for InferenceRequestInput
+#include "amdinfer/core/response_callback.hpp"     // for ResponseCallback
+#include "amdinfer/core/tensor.hpp"                // for Tensor
+#include "amdinfer/core/worker_info.hpp"           // for WorkerInfo
+#include "amdinfer/observation/logging.hpp"        // for Logger, Loggers
+#include "amdinfer/observation/metrics.hpp"        // for Metrics, MetricHist...
+#include "amdinfer/util/thread.hpp"                // for setThreadAffinity
 
 namespace amdinfer {
 
+namespace {
+
+/// Get a request's class from its "priority" parameter
+RequestPriority getPriority(const InferenceRequest& request) {
+  const auto& parameters = request.getParameters();
+  if (!parameters.has("priority")) {
+    return RequestPriority::Normal;
+  }
+  int32_t priority = 0;
+  try {
+    priority = parameters.get<int32_t>("priority");
+  } catch (const std::bad_variant_access&) {
+    // batchers that read the priority themselves reject it
+    return RequestPriority::Normal;
+  }
+  if (priority > 0) {
+    return RequestPriority::High;
+  }
+  return priority < 0 ? RequestPriority::Low : RequestPriority::Normal;
+}
+
+/// Whether a buffer's memory is on the host so it can be copied to directly
+bool isHostBuffer(const Buffer& buffer) {
+  switch (buffer.getAllocator()) {
+    case MemoryAllocators::Cpu:
+    case MemoryAllocators::CpuBinned:
+    case MemoryAllocators::SharedMemory:
+    case MemoryAllocators::PinnedHost:
+      return true;
+    default:
+      return false;
+  }
+}
+
+}  // namespace
+
 /**
  * @brief The C++ RequestContainer class encapsulates incoming requests from the
  * C++ API to the batcher.
@@ -40,8 +91,10 @@ namespace amdinfer {
  */
 
 Batcher::Batcher(MemoryPool* pool) : pool_(pool) {
-  this->input_queue_ = std::make_shared<BlockingQueue<RequestContainerPtr>>();
+  this->copier_ = std::make_shared<util::ParallelCopier>(0);
+  this->input_queue_ = std::make_shared<RequestQueue>();
   this->output_queue_ = std::make_shared<BatchPtrQueue>();
+  this->batches_ = std::make_shared<BatchFreeList>();
   this->status_ = BatcherStatus::New;
 #ifdef AMDINFER_ENABLE_LOGGING
   this->logger_ = Logger(Loggers::Server);
@@ -52,14 +105,62 @@ Batcher::Batcher(MemoryPool* pool, ParameterMap* parameters) : Batcher(pool) {
   if (parameters != nullptr) {
     this->parameters_ = *parameters;
   }
+  if (parameters_.has("starvation_limit")) {
+    const auto limit = parameters_.get<int32_t>("starvation_limit");
+    if (limit < 0) {
+      throw invalid_argument("The starvation limit can't be negative");
+    }
+    this->input_queue_ = std::make_shared<RequestQueue>(limit);
+  }
+  if (parameters_.has("wait_strategy")) {
+    wait_.mode =
+      util::parseWaitMode(parameters_.get<std::string>("wait_strategy"));
+  }
+  if (parameters_.has("spin_us")) {
+    const auto spin = parameters_.get<int32_t>("spin_us");
+    if (spin < 0) {
+      throw invalid_argument("The spin time can't be negative");
+    }
+    wait_.spin = std::chrono::microseconds{spin};
+  }
+  if (parameters_.has("copy_threads") ||
+      parameters_.has("parallel_copy_bytes") ||
+      parameters_.has("streaming_copy_bytes")) {
+    auto get_size = [this](const std::string& key, size_t value) {
+      if (!parameters_.has(key)) {
+        return value;
+      }
+      const auto size = parameters_.get<int32_t>(key);
+      if (size < 0) {
+        throw invalid_argument("The batcher's " + key + " can't be negative");
+      }
+      return static_cast<size_t>(size);
+    };
+    this->copier_ = std::make_shared<util::ParallelCopier>(
+      get_size("copy_threads", 0),
+      get_size("parallel_copy_bytes", util::kDefaultParallelCopyBytes),
+      get_size("streaming_copy_bytes", util::kDefaultStreamingCopyBytes));
+  }
+  // the batcher waits on its input queue and the workers on its output queue
+  this->input_queue_->setWaitStrategy(wait_);
+  this->output_queue_->setWaitStrategy(wait_);
 }
 
 Batcher::Batcher(const Batcher& batcher)
   : batch_size_(batcher.batch_size_),
+    scatter_gather_(batcher.scatter_gather_),
+    device_inputs_(batcher.device_inputs_),
+    ragged_(batcher.ragged_),
+    input_casts_(batcher.input_casts_),
     input_queue_(batcher.input_queue_),
-    output_queue_(batcher.output_queue_),
+    output_queue_(std::make_shared<BatchPtrQueue>()),
+    batches_(batcher.batches_),
     model_(batcher.model_),
-    pool_(batcher.pool_) {
+    parameters_(batcher.parameters_),
+    pool_(batcher.pool_),
+    wait_(batcher.wait_),
+    copier_(batcher.copier_) {
+  this->output_queue_->setWaitStrategy(wait_);
   this->status_ = BatcherStatus::New;
 #ifdef AMDINFER_ENABLE_LOGGING
   this->logger_ = Logger(Loggers::Server);
@@ -67,6 +168,11 @@ Batcher::Batcher(const Batcher& batcher)
 }
 
 void Batcher::start(const std::vector<MemoryAllocators>& allocators) {
+  this->cpus_ = util::getCpuAffinity(
+    parameters_.has("cpus") ? parameters_.get<std::string>("cpus") : "",
+    parameters_.has("numa_node") ? parameters_.get<int32_t>("numa_node") : -1);
+  // the helpers copy into the batches so they stay on the batcher's CPUs
+  this->copier_->setAffinity(this->cpus_);
   this->status_ = BatcherStatus::Run;
   this->thread_ = std::thread(&Batcher::run, this, allocators);
 }
@@ -75,21 +181,64 @@ void Batcher::setBatchSize(size_t batch_size) {
   this->batch_size_ = batch_size;
 }
 
+void Batcher::setScatterGather(bool enable) { scatter_gather_ = enable; }
+
+void Batcher::setDeviceInputs(bool enable) { device_inputs_ = enable; }
+
+void Batcher::setRagged(bool enable) { ragged_ = enable; }
+
+void Batcher::setInputCasts(std::vector<InputCast> casts) {
+  input_casts_ = std::move(casts);
+}
+
+std::chrono::microseconds Batcher::getTimeout() const {
+  if (parameters_.has("timeout_us")) {
+    return std::chrono::microseconds(parameters_.get<int32_t>("timeout_us"));
+  }
+  if (parameters_.has("timeout")) {
+    return std::chrono::milliseconds(parameters_.get<int32_t>("timeout"));
+  }
+  return kDefaultBatcherTimeout;
+}
+
 void Batcher::setName(const std::string& name) { this->model_ = name; }
 
 std::string Batcher::getName() const { return this->model_; }
 
-BlockingQueue<RequestContainerPtr>* Batcher::getInputQueue() {
+#ifdef AMDINFER_ENABLE_METRICS
+void Batcher::setSignals(std::shared_ptr<EndpointSignals> signals) {
+  this->signals_ = std::move(signals);
+}
+#endif
+
+RequestQueue* Batcher::getInputQueue() {
   return this->input_queue_.get();
 }
 
 BatchPtrQueue* Batcher::getOutputQueue() { return this->output_queue_.get(); }
 
 void Batcher::enqueue(RequestContainerPtr request) const {
-  this->input_queue_->enqueue(std::move(request));
+  if (request != nullptr && request->timing != nullptr) {
+    request->timing->enqueued = util::getTime();
+  }
+#ifdef AMDINFER_ENABLE_METRICS
+  // the null request that ends the batcher isn't timed
+  if (request != nullptr) {
+    request->enqueue_time = util::getTime();
+  }
+#endif
+  // the input queue keeps the null request that ends the batcher until all
+  // the others are taken so its priority doesn't matter
+  auto priority = RequestPriority::Low;
+  if (request != nullptr) {
+    priority = getPriority(*request->request);
+  }
+  this->input_queue_->enqueue(std::move(request), priority);
 }
 
 void Batcher::run(const std::vector<MemoryAllocators>& allocators) {
+  // pin before allocating so the batch buffers are first touched on this node
+  util::setThreadAffinity(this->cpus_);
   this->doRun(allocators);
   this->status_ = BatcherStatus::Inactive;
 }
@@ -101,6 +250,274 @@ void Batcher::end() {
   this->status_ = BatcherStatus::Dead;
 }
 
+size_t Batcher::writeInput(const RequestContainer& container, size_t index,
+                           Buffer* buffer, size_t offset) const {
+  const auto& request = container.request;
+  const auto& input = request->getInputs()[index];
+  const auto input_bytes = input.getSize() * input.getDatatype().size();
+  const auto* cast = findCast(input_casts_, *request, index);
+
+  size_t new_offset = 0;
+  if (container.input_writers.empty()) {
+    new_offset = cast == nullptr
+                   ? copyInput(buffer, offset, input.getData(), input_bytes)
+                   : writeCast(input, input.getData(), *cast, buffer, offset);
+    pool_->put(std::make_unique<CpuBuffer>(
+      input.getData(), MemoryAllocators::Cpu, input_bytes));
+  } else if (cast == nullptr && !container.input_views.empty() &&
+             !container.device_views) {
+    // inputs that are already serialized in the protocol's message are copied
+    // like the ingress buffers so large ones can be split across threads
+    new_offset =
+      copyInput(buffer, offset, container.input_views[index], input_bytes);
+  } else if (cast == nullptr) {
+    container.input_writers[index](buffer, offset);
+    new_offset = offset + input_bytes;
+  } else {
+    // the protocol layer writes the request's type so it's converted after
+    auto staging = pool_->get({MemoryAllocators::Cpu}, input, 1);
+    container.input_writers[index](staging.get(), 0);
+    new_offset = writeCast(input, staging->data(0), *cast, buffer, offset);
+    pool_->put(std::move(staging));
+  }
+
+  if (cast == nullptr) {
+    request->setInputTensorData(index, buffer->data(offset));
+  } else {
+    auto converted = castTensor(input, *cast);
+    converted.setData(buffer->data(offset));
+    request->setInputTensor(index, std::move(converted));
+  }
+  return new_offset;
+}
+
+size_t Batcher::copyInput(Buffer* buffer, size_t offset, const void* data,
+                          size_t size) const {
+  if (!isHostBuffer(*buffer)) {
+    return buffer->write(data, offset, size);
+  }
+  copier_->copy(buffer->data(offset), data, size);
+  return offset + size;
+}
+
+Tensor Batcher::getBatchTensor(const InferenceRequest& request,
+                               size_t index) const {
+  const auto& input = request.getInputs()[index];
+  if (const auto* cast = findCast(input_casts_, request, index);
+      cast != nullptr) {
+    return castTensor(input, *cast);
+  }
+  return input;
+}
+
+void Batcher::gatherInputs(const RequestContainer& container,
+                           Batch* batch) const {
+  const auto& request = container.request;
+  const auto& inputs = request->getInputs();
+  // ragged batches are concatenated afterwards so they need host data
+  const auto in_place =
+    !container.input_views.empty() &&
+    (!container.device_views || (device_inputs_ && !ragged_));
+  for (auto i = 0U; i < inputs.size(); ++i) {
+    const auto& input = inputs[i];
+    const auto input_bytes = input.getSize() * input.getDatatype().size();
+
+    // inputs in another layout than the model's are transposed here since
+    // reading them in place would need a copy anyway. Other conversions are
+    // left to the worker, which can fuse them with its own copies
+    const auto* cast = findCast(input_casts_, *request, i);
+    if (cast != nullptr && needsTranspose(input, *cast) &&
+        !container.device_views) {
+      const auto tensor = castTensor(input, *cast);
+      auto buffer = pool_->get({MemoryAllocators::Cpu}, tensor, 1);
+      const auto size = writeInput(container, i, buffer.get(), 0);
+      batch->addSegment(i, {buffer->data(0), size});
+      batch->addInputBuffer(std::move(buffer));
+      continue;
+    }
+
+    if (in_place) {
+      // the bytes are owned by the protocol message, not the pool, so there's
+      // no buffer to return afterwards.
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+      auto* data = const_cast<void*>(container.input_views[i]);
+      request->setInputTensorData(i, data);
+      batch->addSegment(i, {data, input_bytes});
+      continue;
+    }
+
+    BufferPtr buffer;
+    if (container.input_writers.empty()) {
+      buffer = std::make_unique<CpuBuffer>(
+        input.getData(), MemoryAllocators::Cpu, input_bytes);
+    } else {
+      buffer = pool_->get({MemoryAllocators::Cpu}, input, 1);
+      container.input_writers[i](buffer.get(), 0);
+      request->setInputTensorData(i, buffer->data(0));
+    }
+    batch->addSegment(i, {buffer->data(0), input_bytes});
+    batch->addInputBuffer(std::move(buffer));
+  }
+}
+
+void Batcher::concatenate(
+  Batch* batch, const std::vector<MemoryAllocators>& allocators) const {
+  const auto& requests = batch->getRequests();
+  std::vector<std::vector<uint64_t>> offsets(batch->getInputSize());
+  BufferPtrs buffers;
+  buffers.reserve(offsets.size());
+  for (auto i = 0U; i < offsets.size(); ++i) {
+    auto& rows = offsets[i];
+    rows.reserve(requests.size() + 1);
+    rows.push_back(0);
+    for (const auto& request : requests) {
+      const auto& shape = request->getInputs()[i].getShape();
+      rows.push_back(rows.back() + (shape.empty() ? 1 : shape[0]));
+    }
+
+    Tensor tensor = requests.front()->getInputs()[i];
+    auto shape = tensor.getShape();
+    if (shape.empty()) {
+      shape.push_back(rows.back());
+    } else {
+      shape[0] = rows.back();
+    }
+    tensor.setShape(std::move(shape));
+    auto& buffer = buffers.emplace_back(pool_->get(allocators, tensor, 1));
+
+    const auto& segments = batch->getSegments(i);
+    size_t offset = 0;
+    for (auto j = 0U; j < requests.size(); ++j) {
+      requests[j]->setInputTensorData(i, buffer->data(offset));
+      offset = copyInput(buffer.get(), offset, segments[j].data,
+                         segments[j].size);
+    }
+  }
+
+  for (auto& buffer : batch->getInputBuffers()) {
+    pool_->put(std::move(buffer));
+  }
+  batch->setBuffers(std::move(buffers), {});
+  batch->setOffsets(std::move(offsets));
+}
+
+bool Batcher::lendInputs(
+  const RequestContainer& container, Batch* batch,
+  const std::vector<MemoryAllocators>& allocators) const {
+  // deferred inputs have no buffers yet and other memory than the pool's host
+  // memory may be what the worker needs, such as pinned or device memory
+  if (!container.input_writers.empty() || allocators.empty() ||
+      allocators.front() != MemoryAllocators::Cpu) {
+    return false;
+  }
+  const auto& request = *container.request;
+  const auto& inputs = request.getInputs();
+  for (auto i = 0U; i < inputs.size(); ++i) {
+    if (findCast(input_casts_, request, i) != nullptr) {
+      return false;
+    }
+  }
+  // the request's inputs already point at the data so they're left as is
+  for (const auto& input : inputs) {
+    const auto input_bytes = input.getSize() * input.getDatatype().size();
+    batch->addInputBuffer(std::make_unique<CpuBuffer>(
+      input.getData(), MemoryAllocators::Cpu, input_bytes));
+  }
+  return true;
+}
+
+void Batcher::releaseInputs(const RequestContainer& container) const {
+  // deferred inputs haven't been written to a buffer yet
+  if (!container.input_writers.empty()) {
+    return;
+  }
+  for (const auto& input : container.request->getInputs()) {
+    const auto input_bytes = input.getSize() * input.getDatatype().size();
+    pool_->put(std::make_unique<CpuBuffer>(
+      input.getData(), MemoryAllocators::Cpu, input_bytes));
+  }
+}
+
+bool Batcher::dropAbandoned(RequestContainer* container) const {
+  const bool cancelled =
+    container->cancelled != nullptr &&
+    container->cancelled->load(std::memory_order_acquire);
+  // most requests have no deadline so skip reading the clock for them
+  if (!cancelled && (container->deadline == util::TimePoint::max() ||
+                     util::getTime() <= container->deadline)) {
+    return false;
+  }
+
+#ifdef AMDINFER_ENABLE_METRICS
+  Metrics::getInstance().incrementCounter(
+    cancelled ? MetricCounterIDs::RequestsCancelled
+              : MetricCounterIDs::RequestsExpired);
+#endif
+  const InferenceResponse error{cancelled ? "Request was cancelled"
+                                          : "Request deadline exceeded"};
+  if (container->coalescer != nullptr) {
+    // the identical requests attached to this one weren't abandoned so it's
+    // answered alone and still run for them if there are any
+    ResponseCallback callback;
+    const bool attached =
+      container->coalescer->detach(container->coalesce_key, &callback);
+    callback(error);
+    container->coalescer = nullptr;
+    if (attached) {
+      container->cancelled = nullptr;
+      container->deadline = util::TimePoint::max();
+      return false;
+    }
+    this->releaseInputs(*container);
+    return true;
+  }
+  this->releaseInputs(*container);
+  container->request->runCallback(error);
+  return true;
+}
+
+void Batcher::markBatched(const RequestContainer& container) {
+  if (container.timing != nullptr) {
+    container.timing->batched = util::getTime();
+  }
+}
+
+#ifdef AMDINFER_ENABLE_METRICS
+void Batcher::recordQueueWait(const RequestContainer& container) const {
+  const auto now = util::getTime();
+  const std::chrono::duration<double, std::micro> wait =
+    now - container.enqueue_time;
+  Metrics::getInstance().observeHistogram(MetricHistogramIDs::BatcherQueueWait,
+                                          model_, wait.count());
+  if (signals_ != nullptr) {
+    signals_->recordQueued(wait.count(), now);
+  }
+}
+
+void Batcher::recordBatch(size_t batch_size,
+                          util::TimePoint fill_start) const {
+  const std::chrono::duration<double, std::micro> fill =
+    util::getTime() - fill_start;
+  auto& metrics = Metrics::getInstance();
+  metrics.observeHistogram(MetricHistogramIDs::BatchFill, model_,
+                           fill.count());
+  metrics.observeHistogram(MetricHistogramIDs::BatchSize, model_,
+                           static_cast<double>(batch_size));
+  metrics.observeHistogram(
+    MetricHistogramIDs::BatchFillRatio, model_,
+    static_cast<double>(batch_size) / static_cast<double>(batch_size_));
+}
+
+void Batcher::recordQueueSizes(size_t pending) const {
+  auto& metrics = Metrics::getInstance();
+  metrics.setGauge(
+    MetricGaugeIDs::QueuesBatcherInput, model_,
+    static_cast<double>(input_queue_->size_approx() + pending));
+  metrics.setGauge(MetricGaugeIDs::QueuesBatcherOutput, model_,
+                   static_cast<double>(output_queue_->size_approx()));
+}
+#endif
+
 #ifdef AMDINFER_ENABLE_LOGGING
 const Logger& Batcher::getLogger() const { return logger_; }
 #endif
@@ -21,22 +21,31 @@
 #ifndef GUARD_AMDINFER_BATCHING_BATCHER
 #define GUARD_AMDINFER_BATCHING_BATCHER
 
+#include <chrono>   // for microseconds, milliseconds
 #include <cstddef>  // for size_t
 #include <memory>   // for unique_ptr, shared_ptr
 #include <string>   // for string
 #include <thread>   // for thread
 #include <vector>   // for vector
 
-#include "amdinfer/batching/batch.hpp"       // for Batch
-#include "amdinfer/build_options.hpp"        // for AMDINFER_ENABLE_LOGGING
-#include "amdinfer/core/parameters.hpp"      // for ParameterMap
-#include "amdinfer/declarations.hpp"         // for BufferPtrs, InferenceReq...
-#include "amdinfer/observation/logging.hpp"  // for LoggerPtr
-#include "amdinfer/observation/tracing.hpp"  // for TracePtr
-#include "amdinfer/util/queue.hpp"           // for BlockingConcurrentQueue
+#include "amdinfer/batching/batch.hpp"          // for Batch
+#include "amdinfer/batching/batch_queue.hpp"    // for BatchQueue
+#include "amdinfer/batching/input_cast.hpp"     // for InputCast
+#include "amdinfer/batching/request_queue.hpp"  // for RequestQueue
+#include "amdinfer/build_options.hpp"           // for AMDINFER_ENABLE_LOGGING
+#include "amdinfer/core/parameters.hpp"         // for ParameterMap
+#include "amdinfer/core/tensor.hpp"             // for Tensor
+#include "amdinfer/declarations.hpp"            // for BufferPtrs, Inferenc...
+#include "amdinfer/observation/logging.hpp"     // for LoggerPtr
+#include "amdinfer/observation/tracing.hpp"     // for TracePtr
+#include "amdinfer/util/parallel_copy.hpp"      // for ParallelCopier
+#include "amdinfer/util/queue.hpp"              // for BlockingConcurrentQueue
+#include "amdinfer/util/timer.hpp"              // for TimePoint
+#include "amdinfer/util/wait.hpp"               // for WaitStrategy
 
 namespace amdinfer {
 class Buffer;
+class EndpointSignals;
 class WorkerInfo;
 class MemoryPool;
 enum class MemoryAllocators;
@@ -46,7 +55,10 @@ namespace amdinfer {
 
 enum class BatcherStatus { New, Run, Inactive, Dead };
 
-using BatchPtrQueue = BlockingQueue<BatchPtr>;
+/// How long batchers wait for a batch to fill by default
+constexpr std::chrono::milliseconds kDefaultBatcherTimeout{100};
+
+using BatchPtrQueue = BatchQueue;
 
 /**
  * @brief The base batcher implementation defines the basic structure of how
@@ -58,6 +70,17 @@ class Batcher {
  public:
   /// Construct a new Batcher object
   explicit Batcher(MemoryPool* pool);
+  /**
+   * @brief Construct a new Batcher object. If the parameters have
+   * "starvation_limit", it sets how many requests of higher priorities are
+   * taken in a row while lower priorities wait. With "copy_threads", inputs of
+   * at least "parallel_copy_bytes" are copied into the batch by that many
+   * helper threads as well as the batcher's and inputs of at least
+   * "streaming_copy_bytes" are copied with non-temporal stores.
+   *
+   * @param pool memory pool to get batch buffers from
+   * @param parameters the batcher's load-time parameters
+   */
   Batcher(MemoryPool* pool, ParameterMap* parameters);
   /**
    * @brief Construct a new Batcher object
@@ -65,7 +88,8 @@ class Batcher {
    * @param name the endpoint corresponding to the batcher's worker group
    */
   // explicit Batcher(const std::string& name);
-  Batcher(const Batcher& batcher);              ///< copy constructor
+  /// Copy constructor: the copy shares the input queue but has its own output
+  Batcher(const Batcher& batcher);
   Batcher& operator=(const Batcher&) = delete;  ///< Copy assignment constructor
   Batcher(Batcher&& other) = delete;            ///< Move constructor
   Batcher& operator=(Batcher&& other) =
@@ -73,7 +97,8 @@ class Batcher {
   virtual ~Batcher() = default;  ///< Destructor
 
   /**
-   * @brief Start the batcher
+   * @brief Start the batcher. If the parameters have "cpus" (a CPU list like
+   * "0-3,8") or "numa_node", the batcher's thread is pinned to those CPUs.
    *
    * @param worker
    */
@@ -84,6 +109,42 @@ class Batcher {
    * @param batch_size target batch size
    */
   void setBatchSize(size_t batch_size);
+  /**
+   * @brief Set whether the batcher produces scatter-gather batches. If so,
+   * requests' input data is left in place and the batch holds a list of
+   * segments per input instead of contiguous buffers. It should only be
+   * enabled for workers that can consume such batches.
+   *
+   * @param enable true to make scatter-gather batches
+   */
+  void setScatterGather(bool enable);
+  /**
+   * @brief Set whether the worker can read inputs that are in GPU memory in
+   * place. If not, such inputs are copied to the host. It only applies to
+   * scatter-gather batches.
+   *
+   * @param enable true to pass GPU inputs to the worker in place
+   */
+  void setDeviceInputs(bool enable);
+  /**
+   * @brief Set whether the batcher produces ragged batches. If so, requests'
+   * inputs may differ in their first dimension and they're concatenated along
+   * it without padding. The batch holds the offsets of each request's rows.
+   * It should only be enabled for workers that can consume such batches.
+   *
+   * @param enable true to make ragged batches
+   */
+  void setRagged(bool enable);
+  /**
+   * @brief Set the types of the worker's model inputs. Contiguous batches
+   * convert the requests' inputs that are of another type that can be
+   * converted to them while they're copied into the batch buffer.
+   * Scatter-gather batches leave the inputs in place so workers that accept
+   * them convert the inputs themselves.
+   *
+   * @param casts the model's inputs
+   */
+  void setInputCasts(std::vector<InputCast> casts);
   /**
    * @brief Set the name of the batcher (i.e. the batcher's worker group
    * endpoint)
@@ -93,9 +154,18 @@ class Batcher {
   void setName(const std::string& name);
   /// Get the batcher's worker group name
   [[nodiscard]] std::string getName() const;
+#ifdef AMDINFER_ENABLE_METRICS
+  /**
+   * @brief Set the signals of the endpoint's load to record the time that
+   * requests wait in the batcher's queue in
+   *
+   * @param signals the endpoint's signals
+   */
+  void setSignals(std::shared_ptr<EndpointSignals> signals);
+#endif
 
   /// Get the batcher's input queue (used to enqueue new requests)
-  BlockingQueue<RequestContainerPtr>* getInputQueue();
+  RequestQueue* getInputQueue();
   /// Get the batcher's output queue (used to push batches to the worker group)
   BatchPtrQueue* getOutputQueue();
 
@@ -104,7 +174,9 @@ class Batcher {
   BatcherStatus getStatus() const;
 
   /**
-   * @brief Enqueue a new request to the batcher
+   * @brief Enqueue a new request to the batcher. Requests with a positive
+   * "priority" parameter are taken before those without one and requests with
+   * a negative priority are taken after them.
    *
    * @param request
    */
@@ -118,13 +190,161 @@ class Batcher {
   [[nodiscard]] const Logger& getLogger() const;
 #endif
 
+  /**
+   * @brief Get how long a batch may wait to fill. It's the "timeout_us"
+   * parameter in microseconds if it's set for models that run in about a
+   * millisecond or less, or else the "timeout" parameter in milliseconds.
+   *
+   * @return std::chrono::microseconds
+   */
+  [[nodiscard]] std::chrono::microseconds getTimeout() const;
+
+  /**
+   * @brief Write one input tensor of a request into a batch buffer and point
+   * the request's input at the written data. If the protocol layer provided an
+   * input writer, the tensor is decoded directly into the batch buffer.
+   * Otherwise, the data is copied from the ingress buffer, which is then
+   * returned to the pool.
+   *
+   * @param container the request container holding the request
+   * @param index index of the input tensor in the request
+   * @param buffer batch buffer to write to
+   * @param offset offset in the batch buffer to write at
+   * @return size_t the offset in the batch buffer after the written tensor
+   */
+  size_t writeInput(const RequestContainer& container, size_t index,
+                    Buffer* buffer, size_t offset) const;
+  /**
+   * @brief Copy bytes into a batch buffer. Large copies into host memory are
+   * split across the helper threads or bypass the cache
+   *
+   * @param buffer batch buffer to write to
+   * @param offset offset in the batch buffer to write at
+   * @param data the bytes to copy
+   * @param size bytes to copy
+   * @return size_t the offset in the batch buffer after the written bytes
+   */
+  size_t copyInput(Buffer* buffer, size_t offset, const void* data,
+                   size_t size) const;
+  /**
+   * @brief Get the tensor that a request's input takes in a contiguous batch,
+   * which has the model's type if the input is converted to it
+   *
+   * @param request the request that has the input
+   * @param index index of the input tensor in the request
+   * @return Tensor
+   */
+  [[nodiscard]] Tensor getBatchTensor(const InferenceRequest& request,
+                                      size_t index) const;
+  /**
+   * @brief Add a request's input tensors to a scatter-gather batch without
+   * copying them. Inputs whose deserialization was deferred by the protocol
+   * layer are first written into a buffer from the pool unless their raw bytes
+   * can be read in place from the protocol message.
+   *
+   * @param container the request container holding the request
+   * @param batch the batch to add the inputs to
+   */
+  void gatherInputs(const RequestContainer& container, Batch* batch) const;
+  /**
+   * @brief Concatenate the segments of a scatter-gather batch into one buffer
+   * per input tensor from the pool and make the batch ragged. The requests'
+   * inputs are pointed at their rows in the buffers and the buffers that held
+   * the segments go back to the pool.
+   *
+   * @param batch the batch to concatenate
+   * @param allocators the allocators to get the buffers from
+   */
+  void concatenate(Batch* batch,
+                   const std::vector<MemoryAllocators>& allocators) const;
+  /**
+   * @brief Move a request's ingress buffers into a contiguous batch as its
+   * input buffers instead of copying them into new ones. It's only for a
+   * request that fills the batch by itself, since the buffers have no room
+   * for more, and only if the worker would get host memory from the pool and
+   * none of the inputs are converted. The buffers go back to the pool with
+   * the batch as the batch's own would.
+   *
+   * @param container the request container holding the request
+   * @param batch the empty batch to add the buffers to
+   * @param allocators the worker's allocators
+   * @return bool - true if the buffers were moved into the batch
+   */
+  bool lendInputs(const RequestContainer& container, Batch* batch,
+                  const std::vector<MemoryAllocators>& allocators) const;
+  /**
+   * @brief Return a request's ingress buffers to the pool without batching it
+   * e.g. if the request is rejected
+   *
+   * @param container the request container holding the request
+   */
+  void releaseInputs(const RequestContainer& container) const;
+  /**
+   * @brief Drop a request instead of batching it if its client has cancelled
+   * it or its deadline has passed. Its inputs are released and it's answered
+   * with an error that nobody may be waiting for. If identical requests are
+   * attached to it by the coalescer, only it's answered and it's still
+   * batched for them.
+   *
+   * @param container the request container holding the request
+   * @return bool - true if the request was dropped
+   */
+  bool dropAbandoned(RequestContainer* container) const;
+  /**
+   * @brief Record when the batcher takes a request from its queue, if the
+   * request asked for its timing
+   *
+   * @param container the request container holding the request
+   */
+  static void markBatched(const RequestContainer& container);
+#ifdef AMDINFER_ENABLE_METRICS
+  /**
+   * @brief Record how long a request waited in the batcher's queue, from when
+   * it was enqueued until the batcher adds it to a batch
+   *
+   * @param container the request container holding the request
+   */
+  void recordQueueWait(const RequestContainer& container) const;
+  /**
+   * @brief Record the size of a batch and how long it took to fill when it's
+   * sent to the workers
+   *
+   * @param batch_size number of requests in the batch
+   * @param fill_start when the batcher started filling the batch
+   */
+  void recordBatch(size_t batch_size, util::TimePoint fill_start) const;
+  /**
+   * @brief Publish the approximate sizes of the batcher's queues for its
+   * endpoint
+   *
+   * @param pending requests the batcher has taken from its input queue but
+   * not yet batched
+   */
+  void recordQueueSizes(size_t pending = 0) const;
+#endif
+
   size_t batch_size_ = 1;
-  std::shared_ptr<BlockingQueue<RequestContainerPtr>> input_queue_;
+  bool scatter_gather_ = false;
+  bool device_inputs_ = false;
+  bool ragged_ = false;
+  /// the types of the model's inputs that requests are converted to
+  std::vector<InputCast> input_casts_;
+  std::shared_ptr<RequestQueue> input_queue_;
   std::shared_ptr<BatchPtrQueue> output_queue_;
+  /// the empty batches to make new ones from, shared by the endpoint's
+  /// batchers
+  std::shared_ptr<BatchFreeList> batches_;
   std::thread thread_;
   std::string model_;
   ParameterMap parameters_;
   MemoryPool* pool_;
+  /// how the batcher and the workers wait on their queues
+  util::WaitStrategy wait_;
+  /// copies large inputs into the batches, shared by the endpoint's batchers
+  std::shared_ptr<util::ParallelCopier> copier_;
+#ifdef AMDINFER_ENABLE_METRICS
+  std::shared_ptr<EndpointSignals> signals_;
+#endif
 
  private:
   /**
@@ -136,6 +356,8 @@ class Batcher {
   virtual void doRun(const std::vector<MemoryAllocators>& allocators) = 0;
 
   BatcherStatus status_;
+  /// CPUs the batcher's thread is pinned to, if any
+  std::vector<int> cpus_;
 
 #ifdef AMDINFER_ENABLE_LOGGING
   Logger logger_{Loggers::Server};
@@ -0,0 +1,364 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the bucket batcher
+ */
+
+#include "amdinfer/batching/bucket.hpp"
+
+#include <algorithm>  // for lower_bound, max, min
+#include <chrono>     // for milliseconds, duration_cast
+#include <cstddef>    // for byte, size_t
+#include <cstdint>    // for int32_t, int64_t, uint64_t
+#include <cstring>    // for memmove, memset
+#include <exception>  // for exception
+#include <memory>     // for unique_ptr, make_unique
+#include <optional>   // for optional, nullopt
+#include <string>     // for string, operator+, to_string
+#include <utility>    // for move
+#include <vector>     // for vector
+
+#include "amdinfer/buffers/buffer.hpp"          // for Buffer
+#include "amdinfer/build_options.hpp"           // for AMDINFER_ENABLE_METRICS
+#include "amdinfer/core/exceptions.hpp"         // for invalid_argument
+#include "amdinfer/core/inference_request.hpp"  // for InferenceRequest
+#include "amdinfer/core/memory_pool/pool.hpp"   // for MemoryPool
+#include "amdinfer/core/parameters.hpp"         // for ParameterMap
+#include "amdinfer/core/request_container.hpp"  // for RequestContainer
+#include "amdinfer/core/tensor.hpp"             // for Tensor
+#include "amdinfer/declarations.hpp"            // for RequestContainerPtr
+#include "amdinfer/observation/logging.hpp"     // for AMDINFER_LOG_DEBUG
+#include "amdinfer/observation/metrics.hpp"     // for Metrics, MetricCounterIDs
+#include "amdinfer/observation/tracing.hpp"     // for Trace
+#include "amdinfer/util/string.hpp"             // for split
+#include "amdinfer/util/thread.hpp"             // for setThreadName
+#include "amdinfer/util/timer.hpp"              // for getTime, TimePoint
+
+namespace amdinfer {
+
+struct BucketBatcher::Bucket {
+  std::vector<RequestContainerPtr> requests;
+  /// when the oldest request in the bucket arrived
+  util::TimePoint opened;
+};
+
+namespace {
+
+std::vector<uint64_t> parseList(const ParameterMap& parameters,
+                                const std::string& key) {
+  std::vector<uint64_t> values;
+  for (const auto& token :
+       util::split(parameters.get<std::string>(key), ",")) {
+    int64_t value = -1;
+    try {
+      value = std::stoll(token);
+    } catch (const std::exception&) {
+      // handled below with the negative values
+    }
+    if (value < 0) {
+      throw invalid_argument("The parameter " + key +
+                             " must have comma-separated integers");
+    }
+    values.push_back(static_cast<uint64_t>(value));
+  }
+  return values;
+}
+
+/**
+ * @brief Pad a tensor's data in place to a longer length along a dimension.
+ * The data is written unpadded at the start of its slot, which has room for
+ * the padded tensor, and each row is moved to its place from the last one so
+ * none are overwritten before they're moved.
+ *
+ * @param data the tensor's data
+ * @param shape the tensor's unpadded shape
+ * @param dim the dimension to pad
+ * @param length the padded length of the dimension
+ * @param element the size of one element in bytes
+ */
+void pad(std::byte* data, const Shape& shape, size_t dim, uint64_t length,
+         size_t element) {
+  size_t outer = 1;
+  for (auto i = 0U; i < dim; ++i) {
+    outer *= shape[i];
+  }
+  size_t inner = element;
+  for (auto i = dim + 1; i < shape.size(); ++i) {
+    inner *= shape[i];
+  }
+  const auto from = shape[dim] * inner;
+  const auto to = length * inner;
+  for (auto row = outer; row-- > 0;) {
+    std::memmove(data + row * to, data + row * from, from);
+    std::memset(data + row * to + from, 0, to - from);
+  }
+}
+
+}  // namespace
+
+BucketBatcher::BucketBatcher(MemoryPool* pool, ParameterMap* parameters)
+  : Batcher(pool, parameters) {
+  if (!this->parameters_.has("buckets")) {
+    throw invalid_argument("The bucket batcher needs the buckets parameter");
+  }
+  lengths_ = parseList(this->parameters_, "buckets");
+  for (auto i = 0U; i < lengths_.size(); ++i) {
+    if (lengths_[i] == 0 || (i > 0 && lengths_[i] <= lengths_[i - 1])) {
+      throw invalid_argument("The buckets must be increasing positive lengths");
+    }
+  }
+
+  if (this->parameters_.has("bucket_timeouts")) {
+    const auto timeouts = parseList(this->parameters_, "bucket_timeouts");
+    if (timeouts.size() != lengths_.size()) {
+      throw invalid_argument("There must be one timeout per bucket");
+    }
+    for (const auto& bucket_timeout : timeouts) {
+      timeouts_.emplace_back(std::chrono::milliseconds(bucket_timeout));
+    }
+  } else {
+    timeouts_.assign(lengths_.size(), this->getTimeout());
+  }
+
+  if (this->parameters_.has("bucket_dim")) {
+    dim_ = this->parameters_.get<int32_t>("bucket_dim");
+  }
+}
+
+std::optional<size_t> BucketBatcher::getDim(size_t rank) const {
+  const auto dim = dim_ < 0 ? static_cast<int64_t>(rank) + dim_ : dim_;
+  if (dim < 0 || dim >= static_cast<int64_t>(rank)) {
+    return std::nullopt;
+  }
+  return static_cast<size_t>(dim);
+}
+
+void BucketBatcher::doRun(const std::vector<MemoryAllocators>& allocators) {
+  auto thread_name = "batch" + this->getName();
+  util::setThreadName(thread_name);
+#ifdef AMDINFER_ENABLE_LOGGING
+  [[maybe_unused]] const auto& logger = this->getLogger();
+#endif
+
+  std::vector<Bucket> buckets(lengths_.size());
+  size_t pending = 0;
+  bool run = true;
+
+  auto flush = [&](size_t index) {
+    auto& bucket = buckets[index];
+    pending -= bucket.requests.size();
+    auto batch = this->makeBatch(&bucket, lengths_[index], allocators);
+    bucket.requests.clear();
+    if (batch->empty()) {
+      return;
+    }
+    AMDINFER_LOG_DEBUG(logger, "Enqueuing batch for " + this->model_ +
+                                 " of length " +
+                                 std::to_string(lengths_[index]) +
+                                 " and size " + std::to_string(batch->size()));
+#ifdef AMDINFER_ENABLE_METRICS
+    const auto batch_size = batch->size();
+#endif
+    this->output_queue_->enqueue(std::move(batch));
+#ifdef AMDINFER_ENABLE_METRICS
+    Metrics::getInstance().incrementCounter(
+      MetricCounterIDs::PipelineEgressBatcher);
+    this->recordBatch(batch_size, bucket.opened);
+#endif
+  };
+
+  auto intake = [&](RequestContainerPtr req) {
+    if (req == nullptr) {
+      run = false;
+      return;
+    }
+    markBatched(*req);
+#ifdef AMDINFER_ENABLE_METRICS
+    // requests may wait longer in their bucket but that time is spent filling
+    // the batch
+    this->recordQueueWait(*req);
+#endif
+
+    if (this->dropAbandoned(req.get())) {
+      return;
+    }
+    const auto& inputs = req->request->getInputs();
+    if (inputs.empty()) {
+      req->request->runCallbackError("Input size is zero");
+      return;
+    }
+    uint64_t length = 0;
+    bool found = false;
+    for (const auto& input : inputs) {
+      const auto& shape = input.getShape();
+      if (const auto dim = this->getDim(shape.size()); dim.has_value()) {
+        length = std::max(length, shape[dim.value()]);
+        found = true;
+      }
+    }
+    const auto bucket =
+      std::lower_bound(lengths_.begin(), lengths_.end(), length);
+    if (!found || bucket == lengths_.end()) {
+      this->releaseInputs(*req);
+      req->request->runCallbackError(
+        found ? "The request's length of " + std::to_string(length) +
+                  " is longer than the largest bucket"
+              : std::string{"The request has no inputs to bucket"});
+      return;
+    }
+
+    const auto index = static_cast<size_t>(bucket - lengths_.begin());
+    auto& requests = buckets[index].requests;
+    if (requests.empty()) {
+      buckets[index].opened = util::getTime();
+    }
+    requests.push_back(std::move(req));
+    pending++;
+    if (requests.size() >= this->batch_size_) {
+      flush(index);
+    }
+  };
+
+  // keep going after the batcher is stopped until all the buckets are sent
+  while (run || pending > 0) {
+    RequestContainerPtr req;
+    if (pending == 0) {
+      this->input_queue_->wait_dequeue(req);
+      intake(std::move(req));
+      continue;
+    }
+
+#ifdef AMDINFER_ENABLE_METRICS
+    this->recordQueueSizes(pending);
+#endif
+
+    // wait for requests until the oldest bucket is due
+    auto due = util::TimePoint::max();
+    for (auto i = 0U; i < buckets.size(); ++i) {
+      if (!buckets[i].requests.empty()) {
+        due = std::min(due, buckets[i].opened + timeouts_[i]);
+      }
+    }
+    const auto now = util::getTime();
+    if (run && now < due) {
+      const auto duration =
+        std::chrono::duration_cast<std::chrono::microseconds>(due - now);
+      if (this->input_queue_->wait_dequeue_timed(req, duration.count())) {
+        intake(std::move(req));
+        continue;
+      }
+    }
+
+    // once stopped, the remaining buckets are sent right away
+    const auto flush_time = util::getTime();
+    for (auto i = 0U; i < buckets.size(); ++i) {
+      const auto& bucket = buckets[i];
+      if (!bucket.requests.empty() &&
+          (!run || bucket.opened + timeouts_[i] <= flush_time)) {
+        flush(i);
+      }
+    }
+  }
+}
+
+BatchPtr BucketBatcher::makeBatch(
+  Bucket* bucket, uint64_t length,
+  const std::vector<MemoryAllocators>& allocators) {
+  auto batch = batches_->get();
+  // the bytes of each padded input of one request
+  std::vector<size_t> slots;
+
+  for (auto& req : bucket->requests) {
+    auto request = req->request;
+    const auto& inputs = request->getInputs();
+
+    std::vector<Tensor> padded;
+    padded.reserve(inputs.size());
+    for (auto i = 0U; i < inputs.size(); ++i) {
+      auto& tensor = padded.emplace_back(this->getBatchTensor(*request, i));
+      auto shape = tensor.getShape();
+      if (const auto dim = this->getDim(shape.size()); dim.has_value()) {
+        shape[dim.value()] = length;
+        tensor.setShape(std::move(shape));
+      }
+    }
+
+    // the requests in a batch must match in all but their lengths
+    if (!slots.empty()) {
+      bool matches = slots.size() == padded.size();
+      for (auto i = 0U; matches && i < padded.size(); ++i) {
+        matches = padded[i].getSize() * padded[i].getDatatype().size() ==
+                  slots[i];
+      }
+      if (!matches) {
+        this->releaseInputs(*req);
+        request->runCallbackError(
+          "The request's inputs don't match the others in its bucket");
+        continue;
+      }
+    }
+
+#ifdef AMDINFER_ENABLE_TRACING
+    auto& trace = req->trace;
+    trace->startSpan("bucket_batcher");
+#endif
+
+#ifdef AMDINFER_ENABLE_METRICS
+    Metrics::getInstance().incrementCounter(
+      MetricCounterIDs::PipelineIngressBatcher);
+#endif
+
+    // padding needs contiguous buffers so scatter-gather isn't used here
+    if (slots.empty()) {
+      for (const auto& tensor : padded) {
+        batch->addInputBuffer(pool_->get(allocators, tensor, batch_size_));
+        slots.push_back(tensor.getSize() * tensor.getDatatype().size());
+      }
+    }
+
+    const auto index = batch->size();
+    auto raw_inputs = batch->getRawInputBuffers();
+    for (auto i = 0U; i < inputs.size(); ++i) {
+      const auto offset = index * slots[i];
+      const auto shape = inputs[i].getShape();
+      this->writeInput(*req, i, raw_inputs[i], offset);
+      if (const auto dim = this->getDim(shape.size()); dim.has_value()) {
+        pad(static_cast<std::byte*>(raw_inputs[i]->data(offset)), shape,
+            dim.value(), length, inputs[i].getDatatype().size());
+      }
+      // the worker sees the padded input where it was written in the batch
+      auto input = inputs[i];
+      input.setShape(padded[i].getShape());
+      request->setInputTensor(i, std::move(input));
+    }
+
+    batch->addRequest(request);
+    if (req->timing != nullptr) {
+      batch->addTiming(req->timing);
+    }
+#ifdef AMDINFER_ENABLE_TRACING
+    trace->endSpan();
+    batch->addTrace(std::move(trace));
+#endif
+#ifdef AMDINFER_ENABLE_METRICS
+    batch->addTime(req->start_time);
+#endif
+  }
+
+  return batch;
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,83 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the bucket batcher implementation
+ */
+
+#ifndef GUARD_AMDINFER_BATCHING_BUCKET
+#define GUARD_AMDINFER_BATCHING_BUCKET
+
+#include <chrono>    // for microseconds
+#include <cstddef>   // for size_t
+#include <cstdint>   // for int32_t, uint64_t
+#include <optional>  // for optional
+#include <vector>    // for vector
+
+#include "amdinfer/batching/batcher.hpp"  // IWYU pragma: export
+
+namespace amdinfer {
+enum class MemoryAllocators;
+class ParameterMap;
+}  // namespace amdinfer
+
+namespace amdinfer {
+
+/**
+ * @brief The BucketBatcher batches requests whose inputs vary in length, such
+ * as the sequences of language models, with others of a similar length. The
+ * "buckets" parameter lists the lengths to batch at, separated by commas, and
+ * each request goes to the smallest bucket that fits its longest input. Its
+ * inputs are padded with zeros to the bucket's length so every request in a
+ * batch has the same shape. The length is measured along the "bucket_dim"
+ * dimension of the inputs, which may be negative to count from the end and
+ * is the last one by default. Inputs that have fewer dimensions aren't
+ * padded.
+ *
+ * Each bucket fills its own batch and sends it once it's full or once its
+ * oldest request has waited for the bucket's timeout. The "bucket_timeouts"
+ * parameter sets one timeout in milliseconds per bucket and otherwise, all
+ * buckets use the batcher's timeout. Requests longer than the largest
+ * bucket are rejected with an error.
+ */
+class BucketBatcher : public Batcher {
+ public:
+  /**
+   * @brief Construct a new BucketBatcher object
+   *
+   * @param pool the memory pool to get buffers from
+   * @param parameters the load-time parameters with the buckets
+   * @throws invalid_argument if the buckets or their timeouts are invalid
+   */
+  BucketBatcher(MemoryPool* pool, ParameterMap* parameters);
+
+ private:
+  struct Bucket;
+
+  void doRun(const std::vector<MemoryAllocators>& allocators) override;
+  /// Get the dimension that an input of this rank is padded along, if any
+  [[nodiscard]] std::optional<size_t> getDim(size_t rank) const;
+  BatchPtr makeBatch(Bucket* bucket, uint64_t length,
+                     const std::vector<MemoryAllocators>& allocators);
+
+  /// the length of each bucket, in increasing order
+  std::vector<uint64_t> lengths_;
+  std::vector<std::chrono::microseconds> timeouts_;
+  int32_t dim_ = -1;
+};
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_BATCHING_BUCKET
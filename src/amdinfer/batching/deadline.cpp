@@ -0,0 +1,258 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the deadline batcher
+ */
+
+#include "amdinfer/batching/deadline.hpp"
+
+#include <algorithm>  // for push_heap, pop_heap, min
+#include <chrono>     // for milliseconds, duration_cast
+#include <cstddef>    // for size_t
+#include <cstdint>    // for int32_t, uint64_t
+#include <memory>     // for unique_ptr, make_unique
+#include <optional>   // for optional, nullopt
+#include <string>     // for operator+, to_string
+#include <utility>    // for move
+#include <variant>    // for bad_variant_access
+#include <vector>     // for vector
+
+#include "amdinfer/buffers/buffer.hpp"          // for Buffer
+#include "amdinfer/build_options.hpp"           // for AMDINFER_ENABLE_METRICS
+#include "amdinfer/core/inference_request.hpp"  // for InferenceRequest
+#include "amdinfer/core/memory_pool/pool.hpp"   // for MemoryPool
+#include "amdinfer/core/parameters.hpp"         // for ParameterMap
+#include "amdinfer/core/request_container.hpp"  // for RequestContainer
+#include "amdinfer/declarations.hpp"            // for RequestContainerPtr
+#include "amdinfer/observation/logging.hpp"     // for AMDINFER_LOG_DEBUG
+#include "amdinfer/observation/metrics.hpp"     // for Metrics, MetricCounterIDs
+#include "amdinfer/observation/tracing.hpp"     // for Trace
+#include "amdinfer/util/queue.hpp"              // for BlockingConcurrentQueue
+#include "amdinfer/util/thread.hpp"             // for setThreadName
+#include "amdinfer/util/timer.hpp"              // for getTime, TimePoint
+
+namespace amdinfer {
+
+struct DeadlineBatcher::PendingRequest {
+  util::TimePoint deadline;
+  int32_t priority;
+  uint64_t sequence;
+  RequestContainerPtr container;
+};
+
+namespace {
+
+// Defines the heap order: true if a should be served after b. It's a template
+// because PendingRequest is private to the batcher
+template <typename T>
+bool servedAfter(const T& a, const T& b) {
+  if (a.priority != b.priority) {
+    return a.priority < b.priority;
+  }
+  if (a.deadline != b.deadline) {
+    return a.deadline > b.deadline;
+  }
+  return a.sequence > b.sequence;
+}
+
+}  // namespace
+
+void DeadlineBatcher::doRun(const std::vector<MemoryAllocators>& allocators) {
+  auto thread_name = "batch" + this->getName();
+  util::setThreadName(thread_name);
+#ifdef AMDINFER_ENABLE_LOGGING
+  [[maybe_unused]] const auto& logger = this->getLogger();
+#endif
+
+  const auto timeout = this->getTimeout();
+
+  std::vector<PendingRequest> pending;
+  uint64_t sequence = 0;
+  bool run = true;
+
+  auto intake = [&](RequestContainerPtr req) {
+    if (req == nullptr) {
+      run = false;
+      return;
+    }
+    markBatched(*req);
+#ifdef AMDINFER_ENABLE_METRICS
+    // requests may wait longer in the pending heap but that time is spent
+    // filling the batch
+    this->recordQueueWait(*req);
+#endif
+
+    const auto& parameters = req->request->getParameters();
+    // requests that the protocol gave a deadline are ordered by it too
+    PendingRequest pending_request{req->deadline, 0, sequence++, nullptr};
+    try {
+      if (parameters.has("deadline_ms")) {
+        pending_request.deadline = std::min(
+          pending_request.deadline,
+          util::getTime() +
+            std::chrono::milliseconds(parameters.get<int32_t>("deadline_ms")));
+      }
+      if (parameters.has("priority")) {
+        pending_request.priority = parameters.get<int32_t>("priority");
+      }
+    } catch (const std::bad_variant_access&) {
+      this->releaseInputs(*req);
+      req->request->runCallbackError(
+        "The deadline_ms and priority parameters must be integers");
+      return;
+    }
+    pending_request.container = std::move(req);
+    pending.push_back(std::move(pending_request));
+    std::push_heap(pending.begin(), pending.end(),
+                   servedAfter<PendingRequest>);
+  };
+
+  // keep going after the batcher is stopped until all accepted requests have
+  // been served or rejected
+  while (run || !pending.empty()) {
+    RequestContainerPtr req;
+    if (pending.empty()) {
+      this->input_queue_->wait_dequeue(req);
+      intake(std::move(req));
+      continue;
+    }
+
+#ifdef AMDINFER_ENABLE_METRICS
+    this->recordQueueSizes(pending.size());
+#endif
+
+#ifdef AMDINFER_ENABLE_METRICS
+    const auto fill_start = util::getTime();
+#endif
+    // wait for the batch to fill but not past the earliest deadline
+    const auto wait_until = util::getTime() + timeout;
+    while (run && pending.size() < this->batch_size_) {
+      const auto limit = std::min(wait_until, pending.front().deadline);
+      const auto now = util::getTime();
+      if (now >= limit) {
+        break;
+      }
+      const auto duration =
+        std::chrono::duration_cast<std::chrono::microseconds>(limit - now);
+      if (!this->input_queue_->wait_dequeue_timed(req, duration.count())) {
+        break;
+      }
+      intake(std::move(req));
+    }
+    // requests that are already waiting may have earlier deadlines
+    while (run && this->input_queue_->try_dequeue(req)) {
+      intake(std::move(req));
+    }
+
+    auto batch = this->makeBatch(&pending, allocators);
+    if (!batch->empty()) {
+      AMDINFER_LOG_DEBUG(logger, "Enqueuing batch for " + this->model_ +
+                                   " of size " + std::to_string(batch->size()));
+#ifdef AMDINFER_ENABLE_METRICS
+      const auto batch_size = batch->size();
+#endif
+      this->output_queue_->enqueue(std::move(batch));
+#ifdef AMDINFER_ENABLE_METRICS
+      Metrics::getInstance().incrementCounter(
+        MetricCounterIDs::PipelineEgressBatcher);
+      this->recordBatch(batch_size, fill_start);
+#endif
+    }
+  }
+}
+
+BatchPtr DeadlineBatcher::makeBatch(
+  std::vector<PendingRequest>* pending,
+  const std::vector<MemoryAllocators>& allocators) {
+  auto batch = batches_->get();
+  size_t batch_size = 0;
+  std::vector<size_t> input_offset;
+
+  const auto now = util::getTime();
+  while (!pending->empty() && batch_size < this->batch_size_) {
+    std::pop_heap(pending->begin(), pending->end(),
+                  servedAfter<PendingRequest>);
+    auto req = std::move(pending->back().container);
+    const auto deadline = pending->back().deadline;
+    pending->pop_back();
+
+    auto request = req->request;
+    if (now > deadline) {
+      this->releaseInputs(*req);
+      request->runCallbackError("Request deadline exceeded");
+      continue;
+    }
+    if (this->dropAbandoned(req.get())) {
+      continue;
+    }
+
+    const auto& inputs = request->getInputs();
+    auto input_size = inputs.size();
+    if (input_size == 0) {
+      request->runCallbackError("Input size is zero");
+      continue;
+    }
+
+#ifdef AMDINFER_ENABLE_TRACING
+    auto& trace = req->trace;
+    trace->startSpan("deadline_batcher");
+#endif
+
+#ifdef AMDINFER_ENABLE_METRICS
+    Metrics::getInstance().incrementCounter(
+      MetricCounterIDs::PipelineIngressBatcher);
+#endif
+
+    if (batch_size == 0 && !(scatter_gather_ || ragged_)) {
+      for (auto i = 0U; i < input_size; ++i) {
+        batch->addInputBuffer(pool_->get(
+          allocators, this->getBatchTensor(*request, i), batch_size_));
+      }
+      input_offset.resize(batch->getInputSize());
+    }
+
+    if (scatter_gather_ || ragged_) {
+      this->gatherInputs(*req, batch.get());
+    } else {
+      auto raw_inputs = batch->getRawInputBuffers();
+      for (auto i = 0U; i < input_size; ++i) {
+        auto& offset = input_offset[i];
+        offset = this->writeInput(*req, i, raw_inputs[i], offset);
+      }
+    }
+
+    batch->addRequest(request);
+    batch_size++;
+    if (req->timing != nullptr) {
+      batch->addTiming(req->timing);
+    }
+#ifdef AMDINFER_ENABLE_TRACING
+    trace->endSpan();
+    batch->addTrace(std::move(trace));
+#endif
+#ifdef AMDINFER_ENABLE_METRICS
+    batch->addTime(req->start_time);
+#endif
+  }
+
+  // ragged batches are gathered and then concatenated without padding
+  if (ragged_ && !batch->empty()) {
+    this->concatenate(batch.get(), allocators);
+  }
+  return batch;
+}
+
+}  // namespace amdinfer
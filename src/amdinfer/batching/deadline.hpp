@@ -0,0 +1,59 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the deadline batcher implementation
+ */
+
+#ifndef GUARD_AMDINFER_BATCHING_DEADLINE
+#define GUARD_AMDINFER_BATCHING_DEADLINE
+
+#include <vector>  // for vector
+
+#include "amdinfer/batching/batcher.hpp"  // IWYU pragma: export
+
+namespace amdinfer {
+enum class MemoryAllocators;
+class WorkerInfo;
+}  // namespace amdinfer
+
+namespace amdinfer {
+
+/**
+ * @brief The DeadlineBatcher serves requests by priority and then by earliest
+ * deadline. A request may set a "priority" parameter, where larger values are
+ * served first and the default is 0, and a "deadline_ms" parameter, the time in
+ * milliseconds after it reaches the batcher by which it must be served.
+ * Requests without a deadline are served after those with one. Like the
+ * SoftBatcher, it waits up to the "timeout" parameter for a batch to fill but
+ * never past the earliest deadline. Requests whose deadline has passed are
+ * rejected with an error instead of being sent to the worker.
+ *
+ */
+class DeadlineBatcher : public Batcher {
+ public:
+  using Batcher::Batcher;
+
+ private:
+  struct PendingRequest;
+
+  void doRun(const std::vector<MemoryAllocators>& allocators) override;
+  BatchPtr makeBatch(std::vector<PendingRequest>* pending,
+                     const std::vector<MemoryAllocators>& allocators);
+};
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_BATCHING_DEADLINE
@@ -0,0 +1,99 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the signals of an endpoint's load that autoscalers use
+ */
+
+#include "amdinfer/batching/endpoint_signals.hpp"
+
+#include <algorithm>  // for max
+#include <cmath>      // for exp
+#include <ratio>      // for micro
+
+namespace amdinfer {
+
+namespace {
+
+/// Get how much of the load at one time is left at a later time
+double remaining(util::TimePoint from, util::TimePoint to, double window) {
+  if (to <= from) {
+    return 1;
+  }
+  const std::chrono::duration<double> elapsed = to - from;
+  return std::exp(-elapsed.count() / window);
+}
+
+}  // namespace
+
+EndpointSignals::EndpointSignals(std::chrono::seconds window)
+  : window_(std::chrono::duration<double>(window).count()) {}
+
+void EndpointSignals::decay(util::TimePoint time) {
+  if (time <= updated_) {
+    return;
+  }
+  const auto factor = remaining(updated_, time, window_);
+  queued_ *= factor;
+  wait_ *= factor;
+  requests_ *= factor;
+  batches_ *= factor;
+  busy_ *= factor;
+  updated_ = time;
+}
+
+void EndpointSignals::recordQueued(double wait, util::TimePoint time) {
+  std::lock_guard lock{mutex_};
+  this->decay(time);
+  queued_ += 1;
+  wait_ += wait;
+}
+
+void EndpointSignals::recordBatch(size_t requests, double duration,
+                                  util::TimePoint time) {
+  std::lock_guard lock{mutex_};
+  this->decay(time);
+  requests_ += static_cast<double>(requests);
+  batches_ += 1;
+  busy_ += duration;
+}
+
+SignalValues EndpointSignals::get(size_t instances,
+                                  util::TimePoint time) const {
+  std::lock_guard lock{mutex_};
+  SignalValues values;
+  // the decayed sum of a steady rate settles at the rate times the window
+  values.throughput =
+    requests_ * remaining(updated_, time, window_) / window_;
+  // the averages are ratios of sums that decay together so they only change
+  // with new events
+  if (queued_ > 0) {
+    values.queue_time = wait_ / queued_;
+  }
+  if (busy_ > 0) {
+    values.service_rate = requests_ / busy_ * std::micro::den;
+  }
+  double batch_time = 0;
+  if (batches_ > 0) {
+    batch_time = busy_ / batches_;
+  }
+  values.capacity = values.service_rate * static_cast<double>(instances);
+  values.headroom = std::max(values.capacity - values.throughput, 0.0);
+  values.concurrency =
+    values.throughput * (values.queue_time + batch_time) / std::micro::den;
+  return values;
+}
+
+}  // namespace amdinfer
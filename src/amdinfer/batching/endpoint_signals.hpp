@@ -0,0 +1,116 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the signals of an endpoint's load that autoscalers use
+ */
+
+#ifndef GUARD_AMDINFER_BATCHING_ENDPOINT_SIGNALS
+#define GUARD_AMDINFER_BATCHING_ENDPOINT_SIGNALS
+
+#include <chrono>   // for seconds
+#include <cstddef>  // for size_t
+#include <mutex>    // for mutex
+
+#include "amdinfer/util/timer.hpp"  // for TimePoint
+
+namespace amdinfer {
+
+/// How long the signals of an endpoint take to forget a change in its load
+constexpr std::chrono::seconds kDefaultSignalWindow{10};
+
+/// The smoothed load of an endpoint at some point in time
+struct SignalValues {
+  /// requests being batched or computed, on average
+  double concurrency = 0;
+  /// time that requests wait for the batcher, in microseconds
+  double queue_time = 0;
+  /// requests finished per second
+  double throughput = 0;
+  /// requests that one instance finishes per second while it's busy
+  double service_rate = 0;
+  /// requests per second that all the instances could finish
+  double capacity = 0;
+  /// requests per second that the endpoint could take on top of its load
+  double headroom = 0;
+};
+
+/**
+ * @brief Tracks the load of an endpoint for autoscalers from the requests
+ * that its batchers take and the batches that its workers finish. The events
+ * are summed with weights that decay exponentially over the window so the
+ * signals follow the recent load and stay smooth between scrapes.
+ *
+ * The capacity is the observed service rate times the number of instances,
+ * so it's only known once some batches have run. The concurrency follows from
+ * Little's law: the throughput times the time that a request spends queued
+ * and in its batch.
+ */
+class EndpointSignals {
+ public:
+  /**
+   * @brief Construct a new EndpointSignals object
+   *
+   * @param window the time constant of the decay
+   */
+  explicit EndpointSignals(std::chrono::seconds window = kDefaultSignalWindow);
+
+  /**
+   * @brief Record that a batcher took a request. This is called from the
+   * batchers' threads.
+   *
+   * @param wait time the request waited in the queue, in microseconds
+   * @param time when the request was taken
+   */
+  void recordQueued(double wait, util::TimePoint time);
+  /**
+   * @brief Record that a worker finished a batch. This is called from the
+   * workers' threads.
+   *
+   * @param requests number of requests in the batch
+   * @param duration time the worker had the batch, in microseconds
+   * @param time when the batch finished
+   */
+  void recordBatch(size_t requests, double duration, util::TimePoint time);
+
+  /**
+   * @brief Get the signals as of some time
+   *
+   * @param instances number of instances serving the endpoint
+   * @param time the time to decay the load to
+   * @return SignalValues
+   */
+  [[nodiscard]] SignalValues get(size_t instances, util::TimePoint time) const;
+
+ private:
+  /// Decay the sums to this time if it's later than the last update
+  void decay(util::TimePoint time);
+
+  double window_;
+
+  mutable std::mutex mutex_;
+  util::TimePoint updated_;
+  double queued_ = 0;
+  /// total wait of the queued requests, in microseconds
+  double wait_ = 0;
+  double requests_ = 0;
+  double batches_ = 0;
+  /// total time of the finished batches, in microseconds
+  double busy_ = 0;
+};
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_BATCHING_ENDPOINT_SIGNALS
@@ -26,7 +26,7 @@
 #include <utility>  // for move
 #include <vector>   // for vector
 
-#include "amdinfer/buffers/cpu.hpp"             // for CpuBuffer
+#include "amdinfer/buffers/buffer.hpp"          // for Buffer
 #include "amdinfer/build_options.hpp"           // for AMDINFER_ENABLE_METRICS
 #include "amdinfer/core/exceptions.hpp"         // for invalid_argument
 #include "amdinfer/core/inference_request.hpp"  // for InferenceRequest
@@ -38,6 +38,7 @@
 #include "amdinfer/observation/tracing.hpp"     // for Trace
 #include "amdinfer/util/queue.hpp"              // for BlockingConcurrentQueue
 #include "amdinfer/util/thread.hpp"             // for setThreadName
+#include "amdinfer/util/timer.hpp"              // for getTime, TimePoint
 
 // IWYU pragma: no_forward_declare amdinfer::Buffer
 
@@ -48,15 +49,22 @@ void HardBatcher::doRun(const std::vector<MemoryAllocators>& allocators) {
   util::setThreadName(thread_name);
   RequestContainerPtr req;
   bool run = true;
+  // reused by each batch to not allocate it again
+  std::vector<size_t> input_offset;
 
   while (run) {
-    auto batch = std::make_unique<Batch>();
+    auto batch = batches_->get();
     size_t batch_size = 0;
+#ifdef AMDINFER_ENABLE_METRICS
+    util::TimePoint fill_start;
+#endif
 
-    std::vector<BufferPtr> input_buffers;
-    std::vector<size_t> input_offset;
     std::vector<size_t> output_offset;
 
+#ifdef AMDINFER_ENABLE_METRICS
+    this->recordQueueSizes();
+#endif
+
     bool first_request = true;
 
     do {
@@ -72,11 +80,19 @@ void HardBatcher::doRun(const std::vector<MemoryAllocators>& allocators) {
       trace->startSpan("hard_batcher");
 #endif
 
+      markBatched(*req);
 #ifdef AMDINFER_ENABLE_METRICS
       Metrics::getInstance().incrementCounter(
         MetricCounterIDs::PipelineIngressBatcher);
+      this->recordQueueWait(*req);
+      if (batch_size == 0) {
+        fill_start = util::getTime();
+      }
 #endif
 
+      if (this->dropAbandoned(req.get())) {
+        continue;
+      }
       auto request = req->request;
       const auto& inputs = request->getInputs();
       auto input_size = inputs.size();
@@ -85,8 +101,12 @@ void HardBatcher::doRun(const std::vector<MemoryAllocators>& allocators) {
         continue;
       }
 
-      if (first_request) {
-        input_buffers.reserve(input_size);
+      // a request that fills the batch by itself lends it its buffers
+      const bool lent = first_request && this->batch_size_ == 1 &&
+                        !(scatter_gather_ || ragged_) &&
+                        this->lendInputs(*req, batch.get(), allocators);
+
+      if (first_request && !(scatter_gather_ || ragged_) && !lent) {
         // auto output_sizes = req->getOutputSizes();
         // TODO(varunsh): the spec does not require the request to have outputs
         // additionally, the output size could be variable so this should be
@@ -95,36 +115,32 @@ void HardBatcher::doRun(const std::vector<MemoryAllocators>& allocators) {
         // std::vector<BufferPtr> output_buffers;
         // output_buffers.reserve(output_sizes.size());
         // std::vector<size_t> output_offset(output_buffers.size(), 0);
-        for (const auto& input : inputs) {
-          input_buffers.push_back(pool_->get(allocators, input, batch_size_));
+        for (auto i = 0U; i < input_size; ++i) {
+          batch->addInputBuffer(pool_->get(
+            allocators, this->getBatchTensor(*request, i), batch_size_));
         }
         // for(const auto& tensor_size : output_sizes) {
         //   output_buffers.push_back(pool_->get(allocators, tensor_size));
         // }
-        input_offset.resize(input_buffers.size());
-        batch->setBuffers(std::move(input_buffers), {});
+        input_offset.assign(batch->getInputSize(), 0);
       }
 
       auto raw_inputs = batch->getRawInputBuffers();
-      auto raw_outputs = batch->getRawOutputBuffers();
-
-      auto old_input_offset = input_offset;
-      for (auto i = 0U; i < input_size; ++i) {
-        const auto& input = inputs[i];
-        auto* raw_input = raw_inputs[i];
-        auto& offset = input_offset[i];
-
-        auto new_offset =
-          raw_input->write(input.getData(), offset,
-                           input.getSize() * input.getDatatype().size());
-        pool_->put(
-          std::make_unique<CpuBuffer>(input.getData(), MemoryAllocators::Cpu));
-        request->setInputTensorData(i, raw_input->data(offset));
-        offset = new_offset;
+
+      if (scatter_gather_ || ragged_) {
+        this->gatherInputs(*req, batch.get());
+      } else if (!lent) {
+        for (auto i = 0U; i < input_size; ++i) {
+          auto& offset = input_offset[i];
+          offset = this->writeInput(*req, i, raw_inputs[i], offset);
+        }
       }
 
       batch->addRequest(request);
       batch_size++;
+      if (req->timing != nullptr) {
+        batch->addTiming(req->timing);
+      }
 #ifdef AMDINFER_ENABLE_TRACING
       trace->endSpan();
       batch->addTrace(std::move(trace));
@@ -136,10 +152,15 @@ void HardBatcher::doRun(const std::vector<MemoryAllocators>& allocators) {
     } while (batch_size % this->batch_size_ != 0);
 
     if (!batch->empty()) {
+      // ragged batches are gathered and then concatenated without padding
+      if (ragged_) {
+        this->concatenate(batch.get(), allocators);
+      }
       this->output_queue_->enqueue(std::move(batch));
 #ifdef AMDINFER_ENABLE_METRICS
       Metrics::getInstance().incrementCounter(
         MetricCounterIDs::PipelineEgressBatcher);
+      this->recordBatch(batch_size, fill_start);
 #endif
     }
   }
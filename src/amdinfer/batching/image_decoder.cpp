@@ -0,0 +1,173 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the decoders the preprocessor can use for encoded images
+ */
+
+#include "amdinfer/batching/image_decoder.hpp"
+
+#include <opencv2/imgcodecs.hpp>  // for imdecode, IMREAD_COLOR
+#include <opencv2/imgproc.hpp>    // for cvtColor, COLOR_BGR2RGB
+
+#ifdef AMDINFER_ENABLE_TURBOJPEG
+#include <turbojpeg.h>  // for tjDecompress2, tjDecompressHeader3
+
+#include <climits>  // for ULONG_MAX
+#include <string>   // for string
+#endif
+
+#include "amdinfer/core/exceptions.hpp"       // for invalid_argument
+#include "amdinfer/pre_post/jpeg_header.hpp"  // for jpegDimensions
+
+namespace amdinfer {
+
+cv::Mat OpencvDecoder::decode(const uint8_t* data, size_t size,
+                              cv::Size min_size, bool rgb) const {
+  int flags = cv::IMREAD_COLOR;
+  if (!min_size.empty()) {
+    // the reduced modes only save time for JPEG images. Others are decoded at
+    // full size and resized
+    if (auto image = pre_post::jpegDimensions(data, size); image) {
+      switch (pre_post::jpegScaleDenominator(*image, min_size.height,
+                                             min_size.width)) {
+        case 2:
+          flags = cv::IMREAD_REDUCED_COLOR_2;
+          break;
+        case 4:
+          flags = cv::IMREAD_REDUCED_COLOR_4;
+          break;
+        case 8:
+          flags = cv::IMREAD_REDUCED_COLOR_8;
+          break;
+        default:
+          break;
+      }
+    }
+  }
+
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+  const cv::Mat raw{1, static_cast<int>(size), CV_8UC1,
+                    const_cast<uint8_t*>(data)};
+  auto image = cv::imdecode(raw, flags);
+  if (image.empty()) {
+    throw invalid_argument("Failed to decode the image");
+  }
+  if (rgb) {
+    cv::cvtColor(image, image, cv::COLOR_BGR2RGB);
+  }
+  return image;
+}
+
+#ifdef AMDINFER_ENABLE_TURBOJPEG
+
+namespace {
+
+/// TurboJPEG handles can't be shared between threads so each thread has one
+tjhandle threadHandle() {
+  struct Handle {
+    Handle() : handle(tjInitDecompress()) {}
+    ~Handle() {
+      if (handle != nullptr) {
+        tjDestroy(handle);
+      }
+    }
+    Handle(const Handle&) = delete;
+    Handle& operator=(const Handle&) = delete;
+    Handle(Handle&&) = delete;
+    Handle& operator=(Handle&&) = delete;
+
+    tjhandle handle;
+  };
+  thread_local Handle handle;
+  if (handle.handle == nullptr) {
+    throw runtime_error("Failed to initialize TurboJPEG");
+  }
+  return handle.handle;
+}
+
+/// Get the smallest scaling factor that keeps the image at least min_size
+tjscalingfactor pickScalingFactor(int height, int width, cv::Size min_size) {
+  tjscalingfactor best{1, 1};
+  if (min_size.empty()) {
+    return best;
+  }
+  int count = 0;
+  const auto* factors = tjGetScalingFactors(&count);
+  auto best_width = width;
+  for (auto i = 0; i < count; ++i) {
+    const auto& factor = factors[i];
+    const auto scaled_width = TJSCALED(width, factor);
+    const auto scaled_height = TJSCALED(height, factor);
+    if (scaled_width >= min_size.width && scaled_height >= min_size.height &&
+        scaled_width < best_width) {
+      best = factor;
+      best_width = scaled_width;
+    }
+  }
+  return best;
+}
+
+}  // namespace
+
+cv::Mat TurbojpegDecoder::decode(const uint8_t* data, size_t size,
+                                 cv::Size min_size, bool rgb) const {
+  if (!pre_post::isJpeg(data, size) || size > ULONG_MAX) {
+    return fallback_.decode(data, size, min_size, rgb);
+  }
+
+  auto* handle = threadHandle();
+  int width = 0;
+  int height = 0;
+  int subsampling = 0;
+  int colorspace = 0;
+  if (tjDecompressHeader3(handle, data, static_cast<unsigned long>(size),
+                          &width, &height, &subsampling, &colorspace) != 0) {
+    throw invalid_argument(std::string{"Failed to decode the image: "} +
+                           tjGetErrorStr2(handle));
+  }
+
+  const auto factor = pickScalingFactor(height, width, min_size);
+  cv::Mat image{TJSCALED(height, factor), TJSCALED(width, factor), CV_8UC3};
+  const auto format = rgb ? TJPF_RGB : TJPF_BGR;
+  // a pitch of 0 means the rows are packed, which they are in a new Mat
+  if (tjDecompress2(handle, data, static_cast<unsigned long>(size), image.data,
+                    image.cols, 0, image.rows, format, 0) != 0) {
+    // warnings, like for extraneous bytes, still produce an image
+    if (tjGetErrorCode(handle) != TJERR_WARNING) {
+      throw invalid_argument(std::string{"Failed to decode the image: "} +
+                             tjGetErrorStr2(handle));
+    }
+  }
+  return image;
+}
+
+#endif  // AMDINFER_ENABLE_TURBOJPEG
+
+std::unique_ptr<ImageDecoder> makeImageDecoder(const std::string& name) {
+  if (name == "opencv") {
+    return std::make_unique<OpencvDecoder>();
+  }
+  if (name == "turbojpeg") {
+#ifdef AMDINFER_ENABLE_TURBOJPEG
+    return std::make_unique<TurbojpegDecoder>();
+#else
+    throw invalid_argument("TurboJPEG is not enabled in this build");
+#endif
+  }
+  throw invalid_argument("Unknown image decoder: " + name);
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,98 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the decoders the preprocessor can use for encoded images
+ */
+
+#ifndef GUARD_AMDINFER_BATCHING_IMAGE_DECODER
+#define GUARD_AMDINFER_BATCHING_IMAGE_DECODER
+
+#include <cstddef>           // for size_t
+#include <cstdint>           // for uint8_t
+#include <memory>            // for unique_ptr
+#include <opencv2/core.hpp>  // for Mat, Size
+#include <string>            // for string
+
+#include "amdinfer/build_options.hpp"  // for AMDINFER_ENABLE_TURBOJPEG
+
+namespace amdinfer {
+
+/**
+ * @brief The base class for image decoders. Decoders must be safe to call from
+ * multiple threads at once.
+ */
+class ImageDecoder {
+ public:
+  ImageDecoder() = default;
+  virtual ~ImageDecoder() = default;
+  ImageDecoder(const ImageDecoder&) = default;             ///< Copy constructor
+  ImageDecoder& operator=(const ImageDecoder&) = default;  ///< Copy assignment
+  ImageDecoder(ImageDecoder&& other) = default;            ///< Move constructor
+  ImageDecoder& operator=(ImageDecoder&& other) = default;  ///< Move assignment
+
+  /**
+   * @brief Decode an image into an 8-bit, 3-channel image
+   *
+   * @param data pointer to the encoded image
+   * @param size size of the data in bytes
+   * @param min_size if not empty, the decoder may return an image that's
+   * smaller than the encoded one but at least min_size to save time on images
+   * that will be scaled down afterwards
+   * @param rgb return the channels in RGB order instead of BGR
+   * @return cv::Mat
+   */
+  virtual cv::Mat decode(const uint8_t* data, size_t size, cv::Size min_size,
+                         bool rgb) const = 0;
+};
+
+/**
+ * @brief Decodes images with OpenCV. JPEG images are scaled down while
+ * decoding, if allowed, with libjpeg's DCT scaling by powers of two.
+ */
+class OpencvDecoder : public ImageDecoder {
+ public:
+  cv::Mat decode(const uint8_t* data, size_t size, cv::Size min_size,
+                 bool rgb) const override;
+};
+
+#ifdef AMDINFER_ENABLE_TURBOJPEG
+/**
+ * @brief Decodes JPEG images with TurboJPEG directly into the requested channel
+ * order and the smallest of its scaling factors that still fits min_size.
+ * Other images are decoded with OpenCV.
+ */
+class TurbojpegDecoder : public ImageDecoder {
+ public:
+  cv::Mat decode(const uint8_t* data, size_t size, cv::Size min_size,
+                 bool rgb) const override;
+
+ private:
+  OpencvDecoder fallback_;
+};
+#endif
+
+/**
+ * @brief Make an image decoder by name: "opencv" or "turbojpeg", if the server
+ * is built with it
+ *
+ * @param name name of the decoder
+ * @return std::unique_ptr<ImageDecoder>
+ */
+std::unique_ptr<ImageDecoder> makeImageDecoder(const std::string& name);
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_BATCHING_IMAGE_DECODER
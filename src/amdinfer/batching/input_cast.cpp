@@ -0,0 +1,299 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements how inputs are converted to the types and layouts that
+ * models take as they're copied into a batch
+ */
+
+#include "amdinfer/batching/input_cast.hpp"
+
+#include <algorithm>  // for min, find_if, max
+#include <array>      // for array
+#include <cstddef>    // for byte
+#include <cstdint>    // for uint8_t, int8_t, uint16_t, uint32_t, uint64_t
+#include <cstring>    // for memcpy
+#include <string>     // for string
+#include <utility>    // for move
+#include <vector>     // for vector
+
+#include "amdinfer/buffers/buffer.hpp"          // for Buffer
+#include "amdinfer/core/exceptions.hpp"         // for invalid_argument
+#include "amdinfer/core/inference_request.hpp"  // for InferenceRequest
+#include "amdinfer/core/parameters.hpp"         // for ParameterMap
+#include "amdinfer/util/convert.hpp"            // for convertScaled
+#include "amdinfer/util/transpose.hpp"          // for transpose
+
+namespace amdinfer {
+
+namespace {
+
+/// The dimensions of the images in a tensor
+struct ImageShape {
+  size_t images;
+  size_t pixels;
+  size_t channels;
+};
+
+ImageShape getImageShape(const Shape& shape, InputLayout layout) {
+  const auto dims = shape.size();
+  ImageShape image{1, 0, 0};
+  for (size_t i = 0; i + 3 < dims; ++i) {
+    image.images *= shape[i];
+  }
+  if (layout == InputLayout::NHWC) {
+    image.pixels = shape[dims - 3] * shape[dims - 2];
+    image.channels = shape[dims - 1];
+  } else {
+    image.pixels = shape[dims - 2] * shape[dims - 1];
+    image.channels = shape[dims - 3];
+  }
+  return image;
+}
+
+const char* toString(InputLayout layout) {
+  return layout == InputLayout::NHWC ? "NHWC" : "NCHW";
+}
+
+InputLayout getLayout(const InferenceRequestInput& input) {
+  const auto& parameters = input.getParameters();
+  if (!parameters.has("layout")) {
+    return InputLayout::Any;
+  }
+  return parseLayout(parameters.get<std::string>("layout"));
+}
+
+void transposeElements(const std::byte* source, size_t rows, size_t cols,
+                       size_t size, std::byte* dest) {
+  // only the width of the elements matters to move them
+  switch (size) {
+    case sizeof(uint8_t):
+      util::transpose(source, rows, cols, dest);
+      break;
+    case sizeof(uint16_t):
+      util::transpose(reinterpret_cast<const uint16_t*>(source), rows, cols,
+                      reinterpret_cast<uint16_t*>(dest));
+      break;
+    case sizeof(uint32_t):
+      util::transpose(reinterpret_cast<const uint32_t*>(source), rows, cols,
+                      reinterpret_cast<uint32_t*>(dest));
+      break;
+    case sizeof(uint64_t):
+      util::transpose(reinterpret_cast<const uint64_t*>(source), rows, cols,
+                      reinterpret_cast<uint64_t*>(dest));
+      break;
+    default:
+      throw invalid_argument("Elements of size " + std::to_string(size) +
+                             " can't be transposed");
+  }
+}
+
+/**
+ * @brief Convert and transpose an input a tile of pixels at a time. The tile
+ * is converted into one scratch buffer and transposed into another, which are
+ * small enough to stay in the cache, and written out with the callback as
+ * (data, offset in elements of the destination, count of elements).
+ */
+template <typename Write>
+void transposeInput(const InferenceRequestInput& input, const void* source,
+                    const InputCast& cast, Write write) {
+  const auto from = input.getDatatype();
+  const auto from_size = from.size();
+  const auto to_size = cast.datatype.size();
+  const auto to_channels_first = cast.layout == InputLayout::NCHW;
+  const auto image = getImageShape(input.getShape(), getLayout(input));
+  const auto image_size = image.pixels * image.channels;
+  const auto tile =
+    std::max<size_t>(util::kConvertChunkSize / image.channels, 1);
+  std::vector<std::byte> converted(tile * image.channels * to_size);
+  std::vector<std::byte> transposed(converted.size());
+
+  const auto* bytes = static_cast<const std::byte*>(source);
+  for (size_t n = 0; n < image.images; ++n) {
+    const auto* image_source = bytes + n * image_size * from_size;
+    const auto image_offset = n * image_size;
+    for (size_t p = 0; p < image.pixels; p += tile) {
+      const auto count = std::min(tile, image.pixels - p);
+      if (to_channels_first) {
+        castInput(image_source + p * image.channels * from_size, from,
+                  count * image.channels, cast, converted.data());
+        transposeElements(converted.data(), count, image.channels, to_size,
+                          transposed.data());
+        for (size_t c = 0; c < image.channels; ++c) {
+          write(transposed.data() + c * count * to_size,
+                image_offset + c * image.pixels + p, count);
+        }
+      } else {
+        for (size_t c = 0; c < image.channels; ++c) {
+          castInput(image_source + (c * image.pixels + p) * from_size, from,
+                    count, cast, converted.data() + c * count * to_size);
+        }
+        transposeElements(converted.data(), image.channels, count, to_size,
+                          transposed.data());
+        write(transposed.data(), image_offset + p * image.channels,
+              count * image.channels);
+      }
+    }
+  }
+}
+
+}  // namespace
+
+InputLayout parseLayout(const std::string& layout) {
+  if (layout.empty()) {
+    return InputLayout::Any;
+  }
+  if (layout == "NHWC") {
+    return InputLayout::NHWC;
+  }
+  if (layout == "NCHW") {
+    return InputLayout::NCHW;
+  }
+  throw invalid_argument("Unknown layout " + layout +
+                         ". It must be NHWC or NCHW");
+}
+
+bool canCast(DataType from, DataType to) {
+  return (from == DataType::Uint8 &&
+          (to == DataType::Fp32 || to == DataType::Fp16)) ||
+         (from == DataType::Fp32 && to == DataType::Int8);
+}
+
+const InputCast* findCast(const std::vector<InputCast>& casts,
+                          const InferenceRequest& request, size_t index) {
+  const auto& inputs = request.getInputs();
+  const auto& input = inputs[index];
+  const InputCast* cast = nullptr;
+  if (casts.size() == 1 && inputs.size() == 1) {
+    cast = &casts.front();
+  } else {
+    const auto found =
+      std::find_if(casts.begin(), casts.end(), [&input](const auto& model) {
+        return model.name == input.getName();
+      });
+    cast = found == casts.end() ? nullptr : &(*found);
+  }
+  // inputs that the model can't take are left for the worker to reject
+  if (cast == nullptr) {
+    return nullptr;
+  }
+  const auto from = input.getDatatype();
+  if (canCast(from, cast->datatype) ||
+      (from == cast->datatype && needsTranspose(input, *cast))) {
+    return cast;
+  }
+  return nullptr;
+}
+
+bool needsTranspose(const InferenceRequestInput& input,
+                    const InputCast& cast) {
+  if (cast.layout == InputLayout::Any || input.getShape().size() < 3) {
+    return false;
+  }
+  const auto layout = getLayout(input);
+  return layout != InputLayout::Any && layout != cast.layout;
+}
+
+InferenceRequestInput castTensor(const InferenceRequestInput& input,
+                                 const InputCast& cast) {
+  auto tensor = input;
+  tensor.setDatatype(cast.datatype);
+  if (needsTranspose(input, cast)) {
+    auto shape = input.getShape();
+    const auto dims = shape.size();
+    if (cast.layout == InputLayout::NCHW) {
+      // HWC -> CHW
+      std::rotate(shape.begin() + dims - 3, shape.begin() + dims - 1,
+                  shape.end());
+    } else {
+      // CHW -> HWC
+      std::rotate(shape.begin() + dims - 3, shape.begin() + dims - 2,
+                  shape.end());
+    }
+    tensor.setShape(std::move(shape));
+    auto parameters = input.getParameters();
+    // put doesn't replace existing values
+    parameters.erase("layout");
+    parameters.put("layout", toString(cast.layout));
+    tensor.setParameters(std::move(parameters));
+  }
+  return tensor;
+}
+
+void castInput(const void* source, DataType from, size_t count,
+               const InputCast& cast, void* dest) {
+  const auto to = cast.datatype;
+  if (from == to) {
+    // empty inputs may be null, which memcpy doesn't allow
+    if (count > 0) {
+      std::memcpy(dest, source, count * from.size());
+    }
+  } else if (from == DataType::Uint8 && to == DataType::Fp32) {
+    util::convertScaled(static_cast<const uint8_t*>(source), count, cast.scale,
+                        cast.offset, static_cast<float*>(dest));
+  } else if (from == DataType::Uint8 && to == DataType::Fp16) {
+    util::convertScaled(static_cast<const uint8_t*>(source), count, cast.scale,
+                        cast.offset, static_cast<fp16*>(dest));
+  } else if (from == DataType::Fp32 && to == DataType::Int8) {
+    util::convertScaled(static_cast<const float*>(source), count, cast.scale,
+                        cast.offset, static_cast<int8_t*>(dest));
+  } else {
+    throw invalid_argument("Inputs of type " + std::string{from.str()} +
+                           " can't be converted to " + to.str());
+  }
+}
+
+void castInput(const InferenceRequestInput& input, const void* source,
+               const InputCast& cast, void* dest) {
+  if (!needsTranspose(input, cast)) {
+    castInput(source, input.getDatatype(), input.getSize(), cast, dest);
+    return;
+  }
+  const auto to_size = cast.datatype.size();
+  auto* dest_bytes = static_cast<std::byte*>(dest);
+  transposeInput(input, source, cast,
+                 [&](const std::byte* data, size_t offset, size_t count) {
+                   std::memcpy(dest_bytes + offset * to_size, data,
+                               count * to_size);
+                 });
+}
+
+size_t writeCast(const InferenceRequestInput& input, const void* source,
+                 const InputCast& cast, Buffer* buffer, size_t offset) {
+  const auto from = input.getDatatype();
+  const auto count = input.getSize();
+  const auto to_size = cast.datatype.size();
+  if (needsTranspose(input, cast)) {
+    transposeInput(input, source, cast,
+                   [&](const std::byte* data, size_t index, size_t elements) {
+                     buffer->write(data, offset + index * to_size,
+                                   elements * to_size);
+                   });
+    return offset + count * to_size;
+  }
+
+  // the widest type converted to is a float
+  std::array<std::byte, util::kConvertChunkSize * sizeof(float)> chunk;
+  const auto from_size = from.size();
+  const auto* bytes = static_cast<const std::byte*>(source);
+  for (size_t i = 0; i < count; i += util::kConvertChunkSize) {
+    const auto size = std::min(count - i, util::kConvertChunkSize);
+    castInput(bytes + i * from_size, from, size, cast, chunk.data());
+    offset = buffer->write(chunk.data(), offset, size * to_size);
+  }
+  return offset;
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,161 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines how inputs are converted to the types and layouts that models
+ * take as they're copied into a batch
+ */
+
+#ifndef GUARD_AMDINFER_BATCHING_INPUT_CAST
+#define GUARD_AMDINFER_BATCHING_INPUT_CAST
+
+#include <cstddef>  // for size_t
+#include <string>   // for string
+#include <vector>   // for vector
+
+#include "amdinfer/core/data_types.hpp"  // for DataType
+
+namespace amdinfer {
+
+class Buffer;
+class InferenceRequest;
+class InferenceRequestInput;
+
+/// The order of the dimensions of an image. The last three dimensions of a
+/// tensor are the image's and any before them are batches of images
+enum class InputLayout {
+  /// the layout isn't known so the tensor is left as it is
+  Any,
+  NHWC,
+  NCHW,
+};
+
+/**
+ * @brief Parse a layout from a model's config or a request's "layout" input
+ * parameter
+ *
+ * @param layout "NHWC", "NCHW" or empty for any layout
+ * @return InputLayout
+ */
+[[nodiscard]] InputLayout parseLayout(const std::string& layout);
+
+/**
+ * @brief The type and layout that a model takes for one of its inputs.
+ * Requests that send another type that can be converted to it are scaled as
+ * x * scale + offset while they're copied so clients can send smaller types,
+ * such as 8-bit images to models that take floats. For fixed-point inputs, the
+ * scale is 2^fix_point. Requests that declare another layout with their
+ * input's "layout" parameter are transposed to the model's layout too so
+ * clients can send images in the order that they have them in.
+ */
+struct InputCast {
+  /// name of the model's input. A model with one input takes any name
+  std::string name;
+  DataType datatype;
+  float scale = 1.0F;
+  float offset = 0.0F;
+  InputLayout layout = InputLayout::Any;
+};
+
+/**
+ * @brief Check if inputs of one type can be converted to another. Uint8 can be
+ * converted to Fp32 and Fp16 and Fp32 can be converted to Int8.
+ *
+ * @param from the type of the request's input
+ * @param to the type of the model's input
+ * @return bool
+ */
+[[nodiscard]] bool canCast(DataType from, DataType to);
+
+/**
+ * @brief Check if a request's input is in another layout than the model takes.
+ * Inputs that don't declare their layout or have fewer than three dimensions
+ * aren't transposed.
+ *
+ * @param input the request's input
+ * @param cast the model's input
+ * @return bool
+ */
+[[nodiscard]] bool needsTranspose(const InferenceRequestInput& input,
+                                  const InputCast& cast);
+
+/**
+ * @brief Get the conversion for a request's input, if it needs one that's
+ * supported
+ *
+ * @param casts the model's inputs
+ * @param request the request that has the input
+ * @param index index of the input in the request
+ * @return const InputCast* - nullptr if the input isn't converted
+ */
+[[nodiscard]] const InputCast* findCast(const std::vector<InputCast>& casts,
+                                        const InferenceRequest& request,
+                                        size_t index);
+
+/**
+ * @brief Get a request's input as the model takes it: with the model's type
+ * and, if it's transposed, its shape and "layout" parameter in the model's
+ * layout. The data isn't changed.
+ *
+ * @param input the request's input
+ * @param cast the model's input
+ * @return InferenceRequestInput
+ */
+[[nodiscard]] InferenceRequestInput castTensor(
+  const InferenceRequestInput& input, const InputCast& cast);
+
+/**
+ * @brief Convert elements to the type of the cast, scaling them on the way.
+ * Elements of the type of the cast are copied as they are.
+ *
+ * @param source elements to convert
+ * @param from type of the elements
+ * @param count number of elements
+ * @param cast the type to convert to and how to scale them
+ * @param dest where to write the converted elements
+ */
+void castInput(const void* source, DataType from, size_t count,
+               const InputCast& cast, void* dest);
+
+/**
+ * @brief Convert a request's input to the type and layout of the cast. Inputs
+ * in another layout are converted and transposed a tile of pixels at a time
+ * so each tile is only read from memory once.
+ *
+ * @param input the request's input, which describes the source
+ * @param source the input's data
+ * @param cast the type and layout to convert to and how to scale the elements
+ * @param dest where to write the converted input
+ */
+void castInput(const InferenceRequestInput& input, const void* source,
+               const InputCast& cast, void* dest);
+
+/**
+ * @brief Convert a request's input and write it to a buffer. It's converted in
+ * chunks so buffers whose memory isn't on the host can be written too.
+ *
+ * @param input the request's input, which describes the source
+ * @param source the input's data
+ * @param cast the type and layout to convert to and how to scale the elements
+ * @param buffer buffer to write to
+ * @param offset offset in the buffer to write at
+ * @return size_t - the offset in the buffer after the written input
+ */
+size_t writeCast(const InferenceRequestInput& input, const void* source,
+                 const InputCast& cast, Buffer* buffer, size_t offset);
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_BATCHING_INPUT_CAST
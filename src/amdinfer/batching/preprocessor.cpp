@@ -0,0 +1,365 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the preprocessing stage that can run in front of a batcher
+ */
+
+#include "amdinfer/batching/preprocessor.hpp"
+
+#include <array>             // for array
+#include <cstddef>           // for size_t
+#include <cstdint>           // for int32_t, int8_t, uint64_t
+#include <exception>         // for exception
+#include <opencv2/core.hpp>  // for Mat, Size, CV_32FC3
+#include <stdexcept>         // for invalid_argument
+#include <string>            // for string, stof
+#include <type_traits>       // for decay_t
+#include <utility>           // for move
+#include <variant>           // for variant, visit
+
+#include "amdinfer/batching/batcher.hpp"           // for Batcher
+#include "amdinfer/batching/image_decoder.hpp"     // for ImageDecoder
+#include "amdinfer/buffers/cpu.hpp"                // for CpuBuffer
+#include "amdinfer/core/data_types.hpp"            // for DataType
+#include "amdinfer/core/exceptions.hpp"            // for invalid_argument
+#include "amdinfer/core/inference_request.hpp"     // for InferenceRequest
+#include "amdinfer/core/memory_pool/pool.hpp"      // for MemoryPool
+#include "amdinfer/core/parameters.hpp"            // for ParameterMap
+#include "amdinfer/core/request_container.hpp"     // for RequestContainer
+#include "amdinfer/observation/tracing.hpp"        // for Trace
+#include "amdinfer/pre_post/image_preprocess.hpp"  // for imagePreprocess
+#include "amdinfer/util/base64.hpp"                // for base64Decode
+#include "amdinfer/util/string.hpp"                // for split
+#include "amdinfer/util/thread.hpp"                // for setThreadName
+
+namespace amdinfer {
+
+struct PreprocessorOptions {
+  std::variant<pre_post::ImagePreprocessOptions<float, 3>,
+               pre_post::ImagePreprocessOptions<int8_t, 3>>
+    image;
+  DataType datatype;
+  std::vector<uint64_t> shape;
+  /// the decoders convert the color themselves since some can do it for free
+  bool rgb = true;
+  /// images may be scaled down while decoding if they'll be resized anyway
+  cv::Size decode_size;
+};
+
+namespace {
+
+constexpr auto kChannels = 3;
+constexpr auto kDefaultThreads = 2;
+
+int32_t getPositive(const ParameterMap& parameters, const std::string& key,
+                    int32_t default_value) {
+  if (!parameters.has(key)) {
+    return default_value;
+  }
+  auto value = parameters.get<int32_t>(key);
+  if (value <= 0) {
+    throw invalid_argument("The parameter " + key + " must be positive");
+  }
+  return value;
+}
+
+std::string getString(const ParameterMap& parameters, const std::string& key,
+                      const std::string& default_value) {
+  return parameters.has(key) ? parameters.get<std::string>(key)
+                             : default_value;
+}
+
+std::array<float, kChannels> getChannels(const ParameterMap& parameters,
+                                         const std::string& key,
+                                         float default_value) {
+  std::array<float, kChannels> values{};
+  values.fill(default_value);
+  if (!parameters.has(key)) {
+    return values;
+  }
+  auto tokens = util::split(parameters.get<std::string>(key), ",");
+  if (tokens.size() != kChannels) {
+    throw invalid_argument("The parameter " + key +
+                           " must have 3 comma-separated values");
+  }
+  try {
+    for (auto i = 0; i < kChannels; ++i) {
+      values[i] = std::stof(tokens[i]);
+    }
+  } catch (const std::exception&) {
+    throw invalid_argument("The parameter " + key + " must have numbers");
+  }
+  return values;
+}
+
+template <typename T>
+pre_post::ImagePreprocessOptions<T, kChannels> makeOptions(
+  const ParameterMap& parameters) {
+  pre_post::ImagePreprocessOptions<T, kChannels> options;
+  options.height = getPositive(parameters, "preprocess_height",
+                               pre_post::kDefaultImageSize);
+  options.width =
+    getPositive(parameters, "preprocess_width", pre_post::kDefaultImageSize);
+
+  // the output size must be known up front to allocate the tensors
+  options.resize = true;
+  auto resize = getString(parameters, "preprocess_resize", "simple");
+  if (resize == "simple") {
+    options.resize_algorithm = pre_post::ResizeAlgorithm::Simple;
+  } else if (resize == "center_crop") {
+    options.resize_algorithm = pre_post::ResizeAlgorithm::CenterCrop;
+  } else if (resize == "letterbox") {
+    options.resize_algorithm = pre_post::ResizeAlgorithm::LetterBoxCrop;
+  } else if (resize == "resize_center_crop") {
+    options.resize_algorithm = pre_post::ResizeAlgorithm::ResizeCenterCrop;
+  } else {
+    throw invalid_argument("Unknown preprocess_resize: " + resize);
+  }
+
+  auto order = getString(parameters, "preprocess_order", "NHWC");
+  if (order == "NHWC") {
+    options.order = pre_post::ImageOrder::NHWC;
+  } else if (order == "NCHW") {
+    options.order = pre_post::ImageOrder::NCHW;
+  } else {
+    throw invalid_argument("Unknown preprocess_order: " + order);
+  }
+
+  const auto mean = getChannels(parameters, "preprocess_mean", 0);
+  const auto std = getChannels(parameters, "preprocess_std", 1);
+  for (auto i = 0; i < kChannels; ++i) {
+    options.mean[i] = static_cast<T>(mean[i]);
+    options.std[i] = static_cast<T>(std[i]);
+  }
+
+  if constexpr (std::is_same_v<T, float>) {
+    // converting and normalizing are fused into one pass
+    options.convert_type = true;
+    options.type = CV_32FC3;
+    options.convert_scale = parameters.has("preprocess_scale")
+                              ? parameters.get<double>("preprocess_scale")
+                              : 1.0;
+    options.normalize = true;
+  } else {
+    options.normalize =
+      parameters.has("preprocess_mean") || parameters.has("preprocess_std");
+    options.assign = !options.normalize;
+  }
+  return options;
+}
+
+/// Checks if the bytes start with the signature of a JPEG or PNG image
+bool isEncodedImage(const char* data, size_t size) {
+  const std::string_view bytes{data, size};
+  return util::startsWith(bytes, "\xFF\xD8\xFF") ||
+         util::startsWith(bytes, "\x89PNG");
+}
+
+cv::Mat decodeImage(const InferenceRequestInput& input,
+                    const ImageDecoder& decoder,
+                    const PreprocessorOptions& options) {
+  const auto* data = static_cast<const char*>(input.getData());
+  auto size = input.getSize();
+  // images sent as JSON strings are base64-encoded
+  std::string decoded;
+  if (!isEncodedImage(data, size)) {
+    decoded = util::base64Decode(data, size);
+    data = decoded.data();
+    size = decoded.size();
+  }
+
+  try {
+    return decoder.decode(reinterpret_cast<const uint8_t*>(data), size,
+                          options.decode_size, options.rgb);
+  } catch (const invalid_argument& e) {
+    throw invalid_argument(std::string{e.what()} + " in input " +
+                           input.getName());
+  }
+}
+
+size_t inputBytes(const InferenceRequestInput& input) {
+  return input.getSize() * input.getDatatype().size();
+}
+
+}  // namespace
+
+Preprocessor::Preprocessor(const std::string& name,
+                           const ParameterMap& parameters,
+                           const Batcher* batcher, const MemoryPool* pool)
+  : options_(std::make_unique<PreprocessorOptions>()),
+    decoder_(makeImageDecoder(
+      getString(parameters, "preprocess_decoder", "opencv"))),
+    batcher_(batcher),
+    pool_(pool) {
+  auto type = parameters.get<std::string>("preprocess");
+  if (type != "image") {
+    throw invalid_argument("Unknown preprocess type: " + type);
+  }
+
+  auto datatype = getString(parameters, "preprocess_datatype", "FP32");
+  options_->datatype = DataType(datatype.c_str());
+  size_t height = 0;
+  size_t width = 0;
+  bool nchw = false;
+  auto record = [&](const auto& options) {
+    height = options.height;
+    width = options.width;
+    nchw = options.order == pre_post::ImageOrder::NCHW;
+    // cropping takes the center of the full-size image so it can't be scaled
+    if (options.resize_algorithm != pre_post::ResizeAlgorithm::CenterCrop) {
+      options_->decode_size = cv::Size{options.width, options.height};
+    }
+    options_->image = options;
+  };
+  if (options_->datatype == DataType::Fp32) {
+    record(makeOptions<float>(parameters));
+  } else if (options_->datatype == DataType::Int8) {
+    record(makeOptions<int8_t>(parameters));
+  } else {
+    throw invalid_argument("Unsupported preprocess_datatype: " + datatype);
+  }
+  if (nchw) {
+    options_->shape = {kChannels, height, width};
+  } else {
+    options_->shape = {height, width, kChannels};
+  }
+  options_->rgb =
+    !parameters.has("preprocess_rgb") || parameters.get<bool>("preprocess_rgb");
+
+  const auto threads =
+    getPositive(parameters, "preprocess_threads", kDefaultThreads);
+  threads_.reserve(threads);
+  for (auto i = 0; i < threads; ++i) {
+    threads_.emplace_back([this, name]() {
+      util::setThreadName("pre" + name);
+      this->run();
+    });
+  }
+}
+
+Preprocessor::~Preprocessor() {
+  // each thread stops at the first nullptr it gets
+  for (auto i = 0U; i < threads_.size(); ++i) {
+    queue_.enqueue(nullptr);
+  }
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+void Preprocessor::enqueue(RequestContainerPtr request) {
+  queue_.enqueue(std::move(request));
+}
+
+void Preprocessor::run() {
+  RequestContainerPtr container;
+  while (true) {
+    queue_.wait_dequeue(container);
+    if (container == nullptr) {
+      break;
+    }
+
+#ifdef AMDINFER_ENABLE_TRACING
+    container->trace->startSpan("preprocess");
+#endif
+    try {
+      this->process(container.get());
+    } catch (const std::exception& e) {
+      AMDINFER_LOG_WARN(logger_, std::string{"Preprocessing failed: "} +
+                                   e.what());
+      // the inputs that weren't deferred are in buffers from the pool
+      if (container->input_writers.empty()) {
+        for (const auto& input : container->request->getInputs()) {
+          pool_->put(std::make_unique<CpuBuffer>(
+            input.getData(), MemoryAllocators::Cpu, inputBytes(input)));
+        }
+      }
+      container->request->runCallbackError(e.what());
+      continue;
+    }
+#ifdef AMDINFER_ENABLE_TRACING
+    container->trace->endSpan();
+#endif
+    batcher_->enqueue(std::move(container));
+  }
+}
+
+void Preprocessor::materializeInputs(RequestContainer* container) const {
+  if (container->input_writers.empty()) {
+    return;
+  }
+  auto& request = container->request;
+  const auto& inputs = request->getInputs();
+  std::vector<BufferPtr> buffers;
+  buffers.reserve(inputs.size());
+  try {
+    for (auto i = 0U; i < inputs.size(); ++i) {
+      buffers.push_back(pool_->get({MemoryAllocators::Cpu}, inputs[i], 1));
+      container->input_writers[i](buffers.back().get(), 0);
+    }
+  } catch (...) {
+    for (auto& buffer : buffers) {
+      pool_->put(std::move(buffer));
+    }
+    throw;
+  }
+  // the buffers are returned to the pool by the batcher using the data
+  // pointers set here
+  for (auto i = 0U; i < inputs.size(); ++i) {
+    request->setInputTensorData(i, buffers[i]->data(0));
+  }
+  container->input_writers.clear();
+  container->input_views.clear();
+  container->device_views = false;
+}
+
+void Preprocessor::process(RequestContainer* container) const {
+  this->materializeInputs(container);
+
+  auto& request = container->request;
+  const auto& inputs = request->getInputs();
+  for (auto i = 0U; i < inputs.size(); ++i) {
+    const auto& input = inputs[i];
+    if (input.getDatatype() != DataType::String) {
+      continue;
+    }
+    auto image = decodeImage(input, *decoder_, *options_);
+
+    InferenceRequestInput output{nullptr, options_->shape, options_->datatype,
+                                 input.getName()};
+    auto buffer = pool_->get({MemoryAllocators::Cpu}, output, 1);
+    try {
+      std::visit(
+        [&](const auto& options) {
+          using T = typename std::decay_t<decltype(options.mean)>::value_type;
+          pre_post::imagePreprocess(image, options,
+                                    static_cast<T*>(buffer->data(0)));
+        },
+        options_->image);
+    } catch (...) {
+      pool_->put(std::move(buffer));
+      throw;
+    }
+    output.setData(buffer->data(0));
+
+    // return the encoded image's buffer before replacing the input
+    pool_->put(std::make_unique<CpuBuffer>(
+      input.getData(), MemoryAllocators::Cpu, inputBytes(input)));
+    request->setInputTensor(i, std::move(output));
+  }
+}
+
+}  // namespace amdinfer
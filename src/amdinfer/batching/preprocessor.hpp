@@ -0,0 +1,112 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the preprocessing stage that can run in front of a batcher
+ */
+
+#ifndef GUARD_AMDINFER_BATCHING_PREPROCESSOR
+#define GUARD_AMDINFER_BATCHING_PREPROCESSOR
+
+#include <memory>  // for unique_ptr
+#include <string>  // for string
+#include <thread>  // for thread
+#include <vector>  // for vector
+
+#include "amdinfer/build_options.hpp"        // for AMDINFER_ENABLE_LOGGING
+#include "amdinfer/declarations.hpp"         // for RequestContainerPtr
+#include "amdinfer/observation/logging.hpp"  // for Logger
+#include "amdinfer/util/queue.hpp"           // for BlockingQueue
+
+namespace amdinfer {
+class Batcher;
+class ImageDecoder;
+class MemoryPool;
+class ParameterMap;
+struct PreprocessorOptions;
+}  // namespace amdinfer
+
+namespace amdinfer {
+
+/**
+ * @brief The Preprocessor decodes images sent as encoded JPEG or PNG bytes and
+ * preprocesses them into tensors on its own threads before passing the
+ * requests on to a batcher. This lets clients send small encoded images instead
+ * of large tensors and overlaps decoding with inference.
+ *
+ * It's configured by the load-time parameters of an endpoint, which may come
+ * from the parameters in a model's config.pbtxt. It's enabled by setting
+ * "preprocess" to "image". Then, every input with the BYTES datatype is
+ * replaced with the preprocessed image. The bytes may be raw or base64-encoded.
+ * The other parameters are:
+ *
+ *  - preprocess_threads: number of threads to use (default 2)
+ *  - preprocess_decoder: "opencv" (default) or "turbojpeg", if it's enabled
+ *  - preprocess_datatype: FP32 (default) or INT8
+ *  - preprocess_height, preprocess_width: size of the output (default 224)
+ *  - preprocess_resize: "simple" (default), "center_crop", "letterbox" or
+ *    "resize_center_crop"
+ *  - preprocess_rgb: convert the decoded BGR images to RGB (default true)
+ *  - preprocess_order: NHWC (default) or NCHW
+ *  - preprocess_scale: factor applied to FP32 pixels before normalizing
+ *    (default 1)
+ *  - preprocess_mean, preprocess_std: comma-separated values for each channel
+ *    used to normalize the pixels as (x * scale - mean) * std (default 0 and 1)
+ */
+class Preprocessor {
+ public:
+  /**
+   * @brief Construct a new Preprocessor object and start its threads
+   *
+   * @param name the endpoint the preprocessor serves
+   * @param parameters the endpoint's load-time parameters
+   * @param batcher the batcher to pass preprocessed requests to
+   * @param pool memory pool to allocate the preprocessed inputs from
+   */
+  Preprocessor(const std::string& name, const ParameterMap& parameters,
+               const Batcher* batcher, const MemoryPool* pool);
+  ~Preprocessor();  ///< Stop the threads after the queued requests are done
+  Preprocessor(const Preprocessor&) = delete;             ///< Copy constructor
+  Preprocessor& operator=(const Preprocessor&) = delete;  ///< Copy assignment
+  Preprocessor(Preprocessor&& other) = delete;            ///< Move constructor
+  Preprocessor& operator=(Preprocessor&& other) = delete;  ///< Move assignment
+
+  /**
+   * @brief Enqueue a new request to preprocess
+   *
+   * @param request
+   */
+  void enqueue(RequestContainerPtr request);
+
+ private:
+  void run();
+  void process(RequestContainer* container) const;
+  /// Write any deferred inputs into buffers so they can be changed in place
+  void materializeInputs(RequestContainer* container) const;
+
+  std::unique_ptr<PreprocessorOptions> options_;
+  std::unique_ptr<ImageDecoder> decoder_;
+  const Batcher* batcher_;
+  const MemoryPool* pool_;
+  BlockingQueue<RequestContainerPtr> queue_;
+  std::vector<std::thread> threads_;
+#ifdef AMDINFER_ENABLE_LOGGING
+  Logger logger_{Loggers::Server};
+#endif
+};
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_BATCHING_PREPROCESSOR
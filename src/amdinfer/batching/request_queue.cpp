@@ -0,0 +1,167 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the queue used to pass requests to batchers by priority
+ */
+
+#include "amdinfer/batching/request_queue.hpp"
+
+#include <chrono>   // for microseconds, steady_clock
+#include <utility>  // for move
+
+#include "amdinfer/core/request_container.hpp"  // IWYU pragma: keep
+
+namespace amdinfer {
+
+RequestQueue::RequestQueue(size_t starvation_limit)
+  : starvation_limit_(starvation_limit) {}
+
+void RequestQueue::setWaitStrategy(const util::WaitStrategy& strategy) {
+  wait_ = strategy;
+}
+
+void RequestQueue::enqueue(RequestContainerPtr request,
+                           RequestPriority priority) {
+  if (request == nullptr) {
+    {
+      std::lock_guard lock{mutex_};
+      stops_++;
+    }
+    cv_.notify_one();
+    return;
+  }
+  const auto index = static_cast<size_t>(priority);
+  queues_.at(index).enqueue(std::move(request));
+  {
+    std::lock_guard lock{mutex_};
+    available_.at(index)++;
+    waiting_++;
+  }
+  cv_.notify_one();
+}
+
+bool RequestQueue::try_dequeue(RequestContainerPtr& request) {
+  size_t priority = 0;
+  {
+    std::lock_guard lock{mutex_};
+    if (!ready()) {
+      return false;
+    }
+    priority = choose();
+  }
+  take(priority, request);
+  return true;
+}
+
+void RequestQueue::wait_dequeue(RequestContainerPtr& request) {
+  if (util::spin(
+        wait_, util::kWaitForever, [this]() { return ready(); },
+        [&]() { return this->try_dequeue(request); })) {
+    return;
+  }
+  size_t priority = 0;
+  {
+    std::unique_lock lock{mutex_};
+    cv_.wait(lock, [this] { return ready(); });
+    priority = choose();
+  }
+  take(priority, request);
+}
+
+bool RequestQueue::wait_dequeue_timed(RequestContainerPtr& request,
+                                      int64_t timeout_usecs) {
+  const auto timeout = std::chrono::microseconds(timeout_usecs);
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  if (util::spin(
+        wait_, timeout, [this]() { return ready(); },
+        [&]() { return this->try_dequeue(request); })) {
+    return true;
+  }
+  size_t priority = 0;
+  {
+    std::unique_lock lock{mutex_};
+    if (!cv_.wait_until(lock, deadline, [this] { return ready(); })) {
+      return false;
+    }
+    priority = choose();
+  }
+  take(priority, request);
+  return true;
+}
+
+size_t RequestQueue::size_approx() const {
+  size_t size = 0;
+  for (const auto& queue : queues_) {
+    size += queue.size_approx();
+  }
+  return size;
+}
+
+size_t RequestQueue::sizeApprox(RequestPriority priority) const {
+  return queues_.at(static_cast<size_t>(priority)).size_approx();
+}
+
+bool RequestQueue::ready() const { return waiting_ > 0 || stops_ > 0; }
+
+size_t RequestQueue::choose() {
+  // a stop is only taken once there are no requests left in any class
+  if (waiting_ == 0) {
+    stops_--;
+    return kRequestPriorities;
+  }
+  // a class that's waited long enough goes first. Otherwise, the highest class
+  // with requests is served
+  size_t chosen = kRequestPriorities;
+  for (auto i = 0U; i < kRequestPriorities; ++i) {
+    if (available_[i] > 0 && starvation_limit_ != 0 &&
+        skipped_[i] >= starvation_limit_) {
+      chosen = i;
+      break;
+    }
+  }
+  if (chosen == kRequestPriorities) {
+    for (auto i = 0U; i < kRequestPriorities; ++i) {
+      if (available_[i] > 0) {
+        chosen = i;
+        break;
+      }
+    }
+  }
+
+  for (auto i = chosen + 1; i < kRequestPriorities; ++i) {
+    if (available_[i] > 0) {
+      skipped_[i]++;
+    }
+  }
+  skipped_[chosen] = 0;
+  available_[chosen]--;
+  waiting_--;
+  return chosen;
+}
+
+void RequestQueue::take(size_t priority, RequestContainerPtr& request) {
+  if (priority == kRequestPriorities) {
+    request = nullptr;
+    return;
+  }
+  // a request has been reserved from this class so its queue must have one,
+  // even if it isn't visible to this consumer yet
+  auto& queue = queues_.at(priority);
+  while (!queue.try_dequeue(request)) {
+  }
+}
+
+}  // namespace amdinfer
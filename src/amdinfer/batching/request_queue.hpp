@@ -0,0 +1,137 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the queue used to pass requests to batchers by priority
+ */
+
+#ifndef GUARD_AMDINFER_BATCHING_REQUEST_QUEUE
+#define GUARD_AMDINFER_BATCHING_REQUEST_QUEUE
+
+#include <array>               // for array
+#include <atomic>              // for atomic
+#include <condition_variable>  // for condition_variable
+#include <cstddef>             // for size_t
+#include <cstdint>             // for int64_t, uint8_t
+#include <mutex>               // for mutex
+
+#include "amdinfer/declarations.hpp"  // for RequestContainerPtr
+#include "amdinfer/util/queue.hpp"    // for BlockingQueue
+#include "amdinfer/util/wait.hpp"     // for WaitStrategy
+
+namespace amdinfer {
+
+/// The classes of requests, in the order they're served
+enum class RequestPriority : uint8_t { High, Normal, Low };
+
+/// Number of request priority classes
+constexpr size_t kRequestPriorities = 3;
+/// Requests of higher classes served in a row while a lower class waits
+constexpr size_t kDefaultStarvationLimit = 8;
+
+/**
+ * @brief Passes requests from an endpoint to its batchers. Each priority class
+ * has its own first-in, first-out queue and batchers take requests from the
+ * highest class that has any. So that lower classes aren't starved while the
+ * higher ones are busy, a waiting class is served next once the starvation
+ * limit of requests from higher classes have been served ahead of it.
+ *
+ * A null request, which stops the batcher, isn't put in any class. It's kept
+ * aside and only taken once every class is empty so the requests queued ahead
+ * of it are all served first, whatever their class.
+ *
+ * The methods follow the names of BlockingQueue so batchers can consume from
+ * either.
+ */
+class RequestQueue {
+ public:
+  /**
+   * @brief Construct a new RequestQueue object
+   *
+   * @param starvation_limit the most requests from higher classes that are
+   * served in a row while a lower class waits. If zero, lower classes wait
+   * until the higher ones are empty
+   */
+  explicit RequestQueue(size_t starvation_limit = kDefaultStarvationLimit);
+
+  /**
+   * @brief Set how consumers wait for requests. By default, they block. This
+   * should be called before the consumers start
+   *
+   * @param strategy how to wait
+   */
+  void setWaitStrategy(const util::WaitStrategy& strategy);
+
+  /**
+   * @brief Add a request to the queue of its class and wake up a consumer. A
+   * null request is taken after all the others, ignoring its priority
+   *
+   * @param request the request to add
+   * @param priority the request's class
+   */
+  void enqueue(RequestContainerPtr request, RequestPriority priority);
+  /// Take the next request if there is one available
+  bool try_dequeue(RequestContainerPtr& request);  // NOLINT
+  /// Block until a request is available
+  void wait_dequeue(RequestContainerPtr& request);  // NOLINT
+  /**
+   * @brief Block until a request is available or until the timeout elapses
+   *
+   * @param request request to write to
+   * @param timeout_usecs timeout in microseconds
+   * @return bool true if a request was dequeued
+   */
+  // NOLINTNEXTLINE(readability-identifier-naming)
+  bool wait_dequeue_timed(RequestContainerPtr& request, int64_t timeout_usecs);
+  /// Get the approximate number of requests in all classes
+  // NOLINTNEXTLINE(readability-identifier-naming)
+  [[nodiscard]] size_t size_approx() const;
+  /// Get the approximate number of requests in one class
+  [[nodiscard]] size_t sizeApprox(RequestPriority priority) const;
+
+ private:
+  /// Check if there's a request or a stop to take
+  [[nodiscard]] bool ready() const;
+  /**
+   * @brief Pick the class to take the next request from. The mutex must be
+   * held and there must be a request or a stop to take
+   *
+   * @return size_t the class or kRequestPriorities to take a stop
+   */
+  size_t choose();
+  void take(size_t priority, RequestContainerPtr& request);
+
+  size_t starvation_limit_;
+  util::WaitStrategy wait_;
+  std::array<BlockingQueue<RequestContainerPtr>, kRequestPriorities> queues_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  /**
+   * @brief requests reserved in all classes that haven't been taken yet. It's
+   * changed with the mutex held but spinning consumers read it without it
+   */
+  std::atomic<size_t> waiting_{0};
+  /// null requests that haven't been taken yet, which are read like waiting_
+  std::atomic<size_t> stops_{0};
+  /// requests reserved for each class that haven't been taken yet
+  std::array<size_t, kRequestPriorities> available_{};
+  /// requests from higher classes served since each class was last served
+  std::array<size_t, kRequestPriorities> skipped_{};
+};
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_BATCHING_REQUEST_QUEUE
@@ -0,0 +1,296 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements how batchers count and split the samples of requests
+ */
+
+#include "amdinfer/batching/samples.hpp"
+
+#include <algorithm>  // for copy_n, max, min
+#include <cstddef>    // for byte
+#include <mutex>      // for mutex, lock_guard
+#include <optional>   // for optional
+#include <string>     // for string
+#include <utility>    // for move
+#include <vector>     // for vector
+
+#include "amdinfer/buffers/buffer.hpp"           // for Buffer
+#include "amdinfer/buffers/cpu.hpp"              // for CpuBuffer
+#include "amdinfer/build_options.hpp"            // for AMDINFER_ENABLE_TRA...
+#include "amdinfer/core/exceptions.hpp"          // for invalid_argument
+#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/core/memory_pool/pool.hpp"    // for MemoryPool
+#include "amdinfer/core/request_container.hpp"   // for RequestContainer
+#include "amdinfer/observation/tracing.hpp"      // for startTrace
+
+namespace amdinfer {
+
+namespace {
+
+size_t inputBytes(const InferenceRequestInput& input) {
+  return input.getSize() * input.getDatatype().size();
+}
+
+}  // namespace
+
+size_t countSamples(const InferenceRequest& request) {
+  std::optional<uint64_t> samples;
+  for (const auto& input : request.getInputs()) {
+    const auto& shape = input.getShape();
+    const uint64_t leading = shape.empty() ? 1 : shape[0];
+    if (samples.has_value() && samples.value() != leading) {
+      throw invalid_argument(
+        "The inputs of a request must have the same number of samples");
+    }
+    samples = leading;
+  }
+  return std::max<size_t>(samples.value_or(1), 1);
+}
+
+Tensor getSample(const Tensor& tensor) {
+  Tensor sample = tensor;
+  auto shape = tensor.getShape();
+  if (!shape.empty()) {
+    shape[0] = 1;
+    sample.setShape(std::move(shape));
+  }
+  return sample;
+}
+
+/// The original request's data, which the parts are written from
+struct SplitRequest::Source {
+  Source(RequestContainerPtr original, MemoryPool* memory_pool)
+    : container(std::move(original)), pool(memory_pool) {
+    const auto& request = container->request;
+    const auto& inputs = request->getInputs();
+    // deferred inputs with host views are read in place from the protocol
+    // message, which outlives the original request
+    const bool in_place = container->input_views.size() == inputs.size() &&
+                          !container->device_views;
+    data.reserve(inputs.size());
+    for (auto i = 0U; i < inputs.size(); ++i) {
+      if (container->input_writers.empty()) {
+        data.push_back(static_cast<const std::byte*>(inputs[i].getData()));
+        continue;
+      }
+      if (in_place) {
+        data.push_back(
+          static_cast<const std::byte*>(container->input_views[i]));
+        continue;
+      }
+      auto& buffer = buffers.emplace_back(
+        pool->get({MemoryAllocators::Cpu}, inputs[i], 1));
+      container->input_writers[i](buffer.get(), 0);
+      data.push_back(static_cast<const std::byte*>(buffer->data(0)));
+    }
+  }
+  Source(const Source&) = delete;
+  Source& operator=(const Source&) = delete;
+  Source(Source&&) = delete;
+  Source& operator=(Source&&) = delete;
+  ~Source() {
+    for (auto& buffer : buffers) {
+      pool->put(std::move(buffer));
+    }
+    // the ingress buffers of inputs that weren't deferred
+    if (container->input_writers.empty()) {
+      const auto& inputs = container->request->getInputs();
+      for (auto i = 0U; i < inputs.size(); ++i) {
+        pool->put(std::make_unique<CpuBuffer>(
+          // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+          const_cast<std::byte*>(data[i]), MemoryAllocators::Cpu,
+          inputBytes(inputs[i])));
+      }
+    }
+  }
+
+  RequestContainerPtr container;
+  MemoryPool* pool;
+  BufferPtrs buffers;
+  /// the data of each input
+  std::vector<const std::byte*> data;
+};
+
+/**
+ * @brief Collects the responses of the parts to respond to the original
+ * request. The parts may run on different instances at once so each part's
+ * outputs are copied to their place in the joined outputs as it's responded
+ * to, instead of keeping the parts' responses to join at the end.
+ */
+struct SplitRequest::Joiner {
+  Joiner(InferenceRequestPtr original, size_t total)
+    : request(std::move(original)), samples(total) {}
+
+  void respond(size_t start, size_t count, const InferenceResponse& response) {
+    if (response.isError()) {
+      this->fail(response.getError());
+      return;
+    }
+    const auto part = response.getOutputs();
+    size_t expected = 0;
+    {
+      std::lock_guard lock{mutex};
+      if (failed) {
+        return;
+      }
+      // the first part to be responded to allocates the joined outputs
+      if (outputs.empty() && !part.empty()) {
+        model = response.getModel();
+        outputs.reserve(part.size());
+        data.reserve(part.size());
+        for (const auto& tensor : part) {
+          auto& output = outputs.emplace_back();
+          output.setName(tensor.getName());
+          output.setDatatype(tensor.getDatatype());
+          auto shape = tensor.getShape();
+          if (shape.empty()) {
+            shape.push_back(samples);
+          } else {
+            shape[0] = samples;
+          }
+          output.setShape(std::move(shape));
+          data.emplace_back(outputBytes(tensor) / count * samples);
+        }
+      }
+      expected = outputs.size();
+    }
+
+    // the parts write to their own samples so they're copied outside the lock
+    if (part.size() != expected) {
+      this->fail("The parts of a request have other outputs");
+      return;
+    }
+    for (auto i = 0U; i < part.size(); ++i) {
+      const auto stride = data[i].size() / samples;
+      if (outputBytes(part[i]) != count * stride) {
+        this->fail(
+          "The outputs of the parts of a request must have one entry per "
+          "sample");
+        return;
+      }
+      const auto* bytes = static_cast<const std::byte*>(part[i].getData());
+      std::copy_n(bytes, count * stride, data[i].begin() + start * stride);
+    }
+
+    {
+      std::lock_guard lock{mutex};
+      received += count;
+      if (failed || received < samples) {
+        return;
+      }
+    }
+    InferenceResponse joined;
+    joined.setID(request->getID());
+    joined.setModel(model);
+    for (auto i = 0U; i < outputs.size(); ++i) {
+      outputs[i].setData(std::move(data[i]));
+      joined.addOutput(std::move(outputs[i]));
+    }
+    request->runCallbackOnce(joined);
+  }
+
+  /// Fail the original request with the first error of its parts
+  void fail(const std::string& error) {
+    {
+      std::lock_guard lock{mutex};
+      if (failed) {
+        return;
+      }
+      failed = true;
+    }
+    request->runCallbackError(error);
+  }
+
+  static size_t outputBytes(const InferenceResponseOutput& output) {
+    return output.getSize() * output.getDatatype().size();
+  }
+
+  InferenceRequestPtr request;
+  /// the samples of the original request
+  size_t samples;
+  std::mutex mutex;
+  std::string model;
+  std::vector<InferenceResponseOutput> outputs;
+  /// the joined data of each output
+  std::vector<std::vector<std::byte>> data;
+  /// the samples of the parts that were responded to
+  size_t received = 0;
+  bool failed = false;
+};
+
+SplitRequest::SplitRequest(RequestContainerPtr container, MemoryPool* pool)
+  : samples_(countSamples(*container->request)) {
+  joiner_ = std::make_shared<Joiner>(container->request, samples_);
+#ifdef AMDINFER_ENABLE_TRACING
+  // the first part continues the request's trace and the others follow it
+  context_ = container->trace->propagate();
+  trace_ = std::move(container->trace);
+#endif
+  source_ = std::make_shared<Source>(std::move(container), pool);
+}
+
+size_t SplitRequest::remaining() const { return samples_ - taken_; }
+
+RequestContainerPtr SplitRequest::take(size_t samples) {
+  samples = std::min(samples, this->remaining());
+  const auto& original = *source_->container;
+  const auto& request = original.request;
+
+  auto part = std::make_unique<RequestContainer>();
+  part->request = std::make_shared<InferenceRequest>(*request);
+  const auto& inputs = request->getInputs();
+  for (auto i = 0U; i < inputs.size(); ++i) {
+    auto input = inputs[i];
+    const auto stride = inputBytes(input) / samples_;
+    auto shape = input.getShape();
+    if (shape.empty()) {
+      shape.push_back(samples);
+    } else {
+      shape[0] = samples;
+    }
+    input.setShape(std::move(shape));
+    input.setData(nullptr);
+    part->request->setInputTensor(i, std::move(input));
+    // the parts are written from the original's data, which is kept until the
+    // last one is written
+    part->input_writers.emplace_back(
+      [source = source_, i, start = taken_ * stride,
+       bytes = samples * stride](Buffer* buffer, size_t offset) {
+        buffer->write(source->data[i] + start, offset, bytes);
+      });
+  }
+
+  const auto start = taken_;
+  part->request->setCallback([joiner = joiner_, start, samples](
+                               const InferenceResponse& response) {
+    joiner->respond(start, samples, response);
+  });
+  taken_ += samples;
+
+  part->timing = original.timing;
+#ifdef AMDINFER_ENABLE_TRACING
+  part->trace =
+    start == 0 ? std::move(trace_) : startTrace("split_request", context_);
+#endif
+#ifdef AMDINFER_ENABLE_METRICS
+  part->start_time = original.start_time;
+  part->enqueue_time = original.enqueue_time;
+#endif
+  return part;
+}
+
+}  // namespace amdinfer
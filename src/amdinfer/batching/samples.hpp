@@ -0,0 +1,104 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines how batchers count and split the samples of requests
+ */
+
+#ifndef GUARD_AMDINFER_BATCHING_SAMPLES
+#define GUARD_AMDINFER_BATCHING_SAMPLES
+
+#include <cstddef>  // for size_t
+#include <memory>   // for shared_ptr
+
+#include "amdinfer/build_options.hpp"        // for AMDINFER_ENABLE_TRACING
+#include "amdinfer/core/tensor.hpp"          // for Tensor
+#include "amdinfer/declarations.hpp"         // for RequestContainerPtr
+#include "amdinfer/observation/tracing.hpp"  // for TracePtr
+
+namespace amdinfer {
+
+class MemoryPool;
+
+/**
+ * @brief Get the number of samples in a request, which is the leading
+ * dimension of its inputs. A request without a leading dimension is one sample
+ *
+ * @param request the request to count
+ * @return size_t
+ * @throws invalid_argument if the inputs' leading dimensions differ
+ */
+size_t countSamples(const InferenceRequest& request);
+
+/**
+ * @brief Get one sample of a tensor i.e. the tensor with a leading dimension
+ * of one
+ *
+ * @param tensor the tensor with a batch of samples
+ * @return Tensor
+ */
+Tensor getSample(const Tensor& tensor);
+
+/**
+ * @brief Splits a request with more samples than fit in a batch into parts
+ * that go in consecutive batches, which the endpoint's instances may run at
+ * the same time. Each part is a request of its own whose inputs are written
+ * from the original's data as it's batched. Each part's outputs are copied to
+ * their place in the joined outputs as it's responded to and once all the
+ * parts are done, the original request gets one response with their outputs
+ * in order along the first dimension. If a part fails, the original request
+ * fails with its error.
+ */
+class SplitRequest {
+ public:
+  /**
+   * @brief Construct a new SplitRequest object. Inputs whose decoding was
+   * deferred by the protocol layer are read in place if they have views on the
+   * host or else written to buffers from the pool so the parts can be written
+   * from them. The original's buffers go back to the pool once the parts are
+   * all written.
+   *
+   * @param container the request to split
+   * @param pool the pool that the request's buffers come from
+   */
+  SplitRequest(RequestContainerPtr container, MemoryPool* pool);
+
+  /// Get the number of samples that aren't in a part yet
+  [[nodiscard]] size_t remaining() const;
+  /**
+   * @brief Make the next part of the request, which has the next samples
+   *
+   * @param samples the number of samples of the part, up to remaining()
+   * @return RequestContainerPtr
+   */
+  RequestContainerPtr take(size_t samples);
+
+ private:
+  struct Source;
+  struct Joiner;
+
+  std::shared_ptr<Source> source_;
+  std::shared_ptr<Joiner> joiner_;
+  size_t samples_;
+  size_t taken_ = 0;
+#ifdef AMDINFER_ENABLE_TRACING
+  TracePtr trace_;
+  StringMap context_;
+#endif
+};
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_BATCHING_SAMPLES
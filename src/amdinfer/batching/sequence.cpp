@@ -0,0 +1,433 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the sequence batcher
+ */
+
+#include "amdinfer/batching/sequence.hpp"
+
+#include <algorithm>    // for min
+#include <chrono>       // for milliseconds, duration_cast
+#include <cstddef>      // for size_t
+#include <cstdint>      // for int32_t
+#include <deque>        // for deque
+#include <memory>       // for unique_ptr, make_unique, make_shared
+#include <optional>     // for optional, nullopt
+#include <string>       // for string, to_string
+#include <string_view>  // for string_view
+#include <utility>      // for move
+#include <variant>      // for bad_variant_access
+#include <vector>       // for vector
+
+#include "amdinfer/buffers/buffer.hpp"          // for Buffer
+#include "amdinfer/build_options.hpp"           // for AMDINFER_ENABLE_METRICS
+#include "amdinfer/core/inference_request.hpp"  // for InferenceRequest
+#include "amdinfer/core/memory_pool/pool.hpp"   // for MemoryPool
+#include "amdinfer/core/parameters.hpp"         // for ParameterMap
+#include "amdinfer/core/request_container.hpp"  // for RequestContainer
+#include "amdinfer/core/tensor.hpp"             // for Tensor
+#include "amdinfer/declarations.hpp"            // for RequestContainerPtr
+#include "amdinfer/observation/logging.hpp"     // for AMDINFER_LOG_DEBUG
+#include "amdinfer/observation/metrics.hpp"     // for Metrics, MetricCounterIDs
+#include "amdinfer/observation/tracing.hpp"     // for Trace
+#include "amdinfer/util/queue.hpp"              // for BlockingConcurrentQueue
+#include "amdinfer/util/thread.hpp"             // for setThreadName
+#include "amdinfer/util/timer.hpp"              // for getTime, TimePoint
+
+namespace amdinfer {
+
+SequenceStates::SequenceStates(MemoryPool* pool,
+                               std::vector<MemoryAllocators> allocators)
+  : pool_(pool), allocators_(std::move(allocators)) {}
+
+SequenceStates::~SequenceStates() {
+  for (auto& [slot, states] : states_) {
+    for (auto& [name, buffer] : states) {
+      pool_->put(std::move(buffer));
+    }
+  }
+}
+
+SequenceStates::State SequenceStates::get(size_t slot, const Tensor& tensor) {
+  std::lock_guard lock{mutex_};
+  auto& buffer = states_[slot][tensor.getName()];
+  if (buffer != nullptr) {
+    return {buffer.get(), false};
+  }
+  buffer = pool_->get(allocators_, tensor, 1);
+  return {buffer.get(), true};
+}
+
+void SequenceStates::reset(size_t slot) {
+  std::lock_guard lock{mutex_};
+  auto iterator = states_.find(slot);
+  if (iterator == states_.end()) {
+    return;
+  }
+  for (auto& [name, buffer] : iterator->second) {
+    pool_->put(std::move(buffer));
+  }
+  states_.erase(iterator);
+}
+
+/// A request waiting for its sequence's slot
+struct SequenceBatcher::Step {
+  RequestContainerPtr container;
+  bool start;
+};
+
+struct SequenceBatcher::Slot {
+  /// the sequence in the slot or empty if the slot is free
+  std::string id;
+  /// the slot's requests in their order, which may remain from an ended
+  /// sequence while the next one starts
+  std::deque<Step> steps;
+  /// true while a batch with one of the slot's requests isn't finished
+  bool busy = false;
+  util::TimePoint last_used;
+};
+
+namespace {
+
+/// The slots whose batches were finished by the workers
+struct Finished {
+  std::mutex mutex;
+  std::vector<size_t> slots;
+};
+
+std::optional<std::string> getSequenceId(const ParameterMap& parameters) {
+  if (!parameters.has("sequence_id")) {
+    return std::nullopt;
+  }
+  try {
+    return parameters.get<std::string>("sequence_id");
+  } catch (const std::bad_variant_access&) {
+    return std::to_string(parameters.get<int32_t>("sequence_id"));
+  }
+}
+
+bool getFlag(const ParameterMap& parameters, std::string_view key) {
+  return parameters.has(key) && parameters.get<bool>(key);
+}
+
+}  // namespace
+
+void SequenceBatcher::doRun(const std::vector<MemoryAllocators>& allocators) {
+  auto thread_name = "batch" + this->getName();
+  util::setThreadName(thread_name);
+#ifdef AMDINFER_ENABLE_LOGGING
+  [[maybe_unused]] const auto& logger = this->getLogger();
+#endif
+
+  const auto timeout = this->getTimeout();
+  auto idle = kDefaultSequenceIdle;
+  if (this->parameters_.has("sequence_idle_ms")) {
+    idle = std::chrono::milliseconds(
+      this->parameters_.get<int32_t>("sequence_idle_ms"));
+  }
+
+  auto states = std::make_shared<SequenceStates>(pool_, allocators);
+  auto finished = std::make_shared<Finished>();
+  std::vector<Slot> slots(this->batch_size_);
+  std::unordered_map<std::string, size_t> sequences;
+  // the slot to start the next batch at so no slot is always served last
+  size_t next_slot = 0;
+  bool run = true;
+
+  auto reject = [this](const RequestContainer& req, const std::string& error) {
+    this->releaseInputs(req);
+    req.request->runCallbackError(error);
+  };
+
+  auto intake = [&](RequestContainerPtr req) {
+    if (req == nullptr) {
+      run = false;
+      return;
+    }
+    // finished batches wake the batcher with an empty container
+    if (req->request == nullptr) {
+      return;
+    }
+    markBatched(*req);
+#ifdef AMDINFER_ENABLE_METRICS
+    // requests may wait longer for their slot but that time is spent filling
+    // the batch
+    this->recordQueueWait(*req);
+#endif
+
+    const auto& parameters = req->request->getParameters();
+    std::optional<std::string> id;
+    bool start = false;
+    bool end = false;
+    try {
+      id = getSequenceId(parameters);
+      start = getFlag(parameters, "sequence_start");
+      end = getFlag(parameters, "sequence_end");
+    } catch (const std::bad_variant_access&) {
+      reject(*req,
+             "The sequence_id parameter must be a string or an integer and "
+             "sequence_start and sequence_end must be booleans");
+      return;
+    }
+    if (!id.has_value()) {
+      reject(*req, "Requests to sequence batchers must set sequence_id");
+      return;
+    }
+
+    auto iterator = sequences.find(id.value());
+    if (iterator == sequences.end()) {
+      if (!start) {
+        reject(*req, "Sequence " + id.value() +
+                       " has not started or was idle for too long");
+        return;
+      }
+      size_t free = 0;
+      while (free < slots.size() && !slots[free].id.empty()) {
+        free++;
+      }
+      if (free == slots.size()) {
+        reject(*req, "All " + std::to_string(slots.size()) +
+                       " sequence slots are in use");
+        return;
+      }
+      slots[free].id = id.value();
+      iterator = sequences.emplace(id.value(), free).first;
+    }
+
+    auto& slot = slots[iterator->second];
+    slot.steps.push_back({std::move(req), start});
+    slot.last_used = util::getTime();
+    if (end) {
+      // the slot can take a new sequence while this one's last steps are
+      // still waiting since they're served in order
+      slot.id.clear();
+      sequences.erase(iterator);
+    }
+  };
+
+  auto collect = [&]() {
+    std::vector<size_t> done;
+    {
+      std::lock_guard lock{finished->mutex};
+      done.swap(finished->slots);
+    }
+    for (const auto index : done) {
+      auto& slot = slots[index];
+      slot.busy = false;
+      if (slot.id.empty() && slot.steps.empty()) {
+        states->reset(index);
+      }
+    }
+  };
+
+  // ends idle sequences and returns when the next one will be idle
+  auto reclaim = [&]() {
+    const auto now = util::getTime();
+    auto next = util::TimePoint::max();
+    for (auto i = 0U; i < slots.size(); ++i) {
+      auto& slot = slots[i];
+      if (slot.id.empty() || slot.busy || !slot.steps.empty()) {
+        continue;
+      }
+      const auto expiry = slot.last_used + idle;
+      if (expiry > now) {
+        next = std::min(next, expiry);
+        continue;
+      }
+      AMDINFER_LOG_DEBUG(logger, "Reclaiming idle sequence " + slot.id +
+                                   " of " + this->model_);
+      sequences.erase(slot.id);
+      slot.id.clear();
+      states->reset(i);
+    }
+    return next;
+  };
+
+  auto ready = [&]() {
+    size_t count = 0;
+    for (const auto& slot : slots) {
+      count += static_cast<size_t>(!slot.busy && !slot.steps.empty());
+    }
+    return count;
+  };
+
+  // true if a sequence that could be in the batch hasn't sent its next step
+  auto expecting = [&]() {
+    for (const auto& slot : slots) {
+      if (!slot.id.empty() && !slot.busy && slot.steps.empty()) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  auto wait = [&](util::TimePoint until) {
+    RequestContainerPtr req;
+    if (until == util::TimePoint::max()) {
+      this->input_queue_->wait_dequeue(req);
+    } else {
+      const auto now = util::getTime();
+      const auto duration =
+        std::chrono::duration_cast<std::chrono::microseconds>(until - now);
+      if (duration.count() <= 0 ||
+          !this->input_queue_->wait_dequeue_timed(req, duration.count())) {
+        return;
+      }
+    }
+    intake(std::move(req));
+  };
+
+  // keep going after the batcher is stopped until all accepted requests have
+  // been served
+  auto waiting = [&]() {
+    for (const auto& slot : slots) {
+      if (!slot.steps.empty()) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  while (run || waiting()) {
+    collect();
+    const auto next_idle = reclaim();
+    if (ready() == 0) {
+      wait(run ? next_idle : util::TimePoint::max());
+      continue;
+    }
+
+#ifdef AMDINFER_ENABLE_METRICS
+    this->recordQueueSizes();
+    const auto fill_start = util::getTime();
+#endif
+    // wait for the batch to fill with the steps of the other sequences that
+    // aren't already in a batch
+    const auto wait_until = util::getTime() + timeout;
+    while (run && ready() < slots.size() && expecting() &&
+           util::getTime() < wait_until) {
+      wait(wait_until);
+      collect();
+    }
+    // requests that are already waiting may be steps of other sequences
+    RequestContainerPtr req;
+    while (run && this->input_queue_->try_dequeue(req)) {
+      intake(std::move(req));
+    }
+    collect();
+
+    auto batch = batches_->get();
+    std::vector<size_t> input_offset;
+    std::vector<size_t> batched;
+    for (auto i = 0U; i < slots.size(); ++i) {
+      const auto index = (next_slot + i) % slots.size();
+      auto& slot = slots[index];
+      if (slot.busy || slot.steps.empty()) {
+        continue;
+      }
+      auto step = std::move(slot.steps.front());
+      slot.steps.pop_front();
+      auto& req = step.container;
+      auto request = req->request;
+
+      const auto& inputs = request->getInputs();
+      auto input_size = inputs.size();
+      if (input_size == 0) {
+        request->runCallbackError("Input size is zero");
+        continue;
+      }
+      if (step.start) {
+        states->reset(index);
+      }
+      auto parameters = request->getParameters();
+      // put() doesn't replace existing values
+      parameters.erase("sequence_slot");
+      parameters.put("sequence_slot", static_cast<int32_t>(index));
+      request->setParameters(std::move(parameters));
+
+#ifdef AMDINFER_ENABLE_TRACING
+      auto& trace = req->trace;
+      trace->startSpan("sequence_batcher");
+#endif
+
+#ifdef AMDINFER_ENABLE_METRICS
+      Metrics::getInstance().incrementCounter(
+        MetricCounterIDs::PipelineIngressBatcher);
+#endif
+
+      if (batched.empty() && !scatter_gather_) {
+        for (auto i = 0U; i < inputs.size(); ++i) {
+          batch->addInputBuffer(pool_->get(
+            allocators, this->getBatchTensor(*request, i), batch_size_));
+        }
+        input_offset.resize(batch->getInputSize());
+      }
+
+      if (scatter_gather_) {
+        this->gatherInputs(*req, batch.get());
+      } else {
+        auto raw_inputs = batch->getRawInputBuffers();
+        for (auto j = 0U; j < input_size; ++j) {
+          auto& offset = input_offset[j];
+          offset = this->writeInput(*req, j, raw_inputs[j], offset);
+        }
+      }
+
+      batch->addRequest(request);
+      if (req->timing != nullptr) {
+        batch->addTiming(req->timing);
+      }
+#ifdef AMDINFER_ENABLE_TRACING
+      trace->endSpan();
+      batch->addTrace(std::move(trace));
+#endif
+#ifdef AMDINFER_ENABLE_METRICS
+      batch->addTime(req->start_time);
+#endif
+      slot.busy = true;
+      slot.last_used = util::getTime();
+      batched.push_back(index);
+    }
+    next_slot = (next_slot + 1) % slots.size();
+
+    if (batched.empty()) {
+      continue;
+    }
+    batch->setSequenceStates(states);
+    // the slots can take their next steps once the worker is done
+    batch->addCompletionCallback([finished, queue = this->input_queue_,
+                                  batched]() {
+      {
+        std::lock_guard lock{finished->mutex};
+        finished->slots.insert(finished->slots.end(), batched.begin(),
+                               batched.end());
+      }
+      queue->enqueue(std::make_unique<RequestContainer>(),
+                     RequestPriority::High);
+    });
+
+    [[maybe_unused]] const auto batch_size = batch->size();
+    AMDINFER_LOG_DEBUG(logger, "Enqueuing batch for " + this->model_ +
+                                 " of size " + std::to_string(batch_size));
+    this->output_queue_->enqueue(std::move(batch));
+#ifdef AMDINFER_ENABLE_METRICS
+    Metrics::getInstance().incrementCounter(
+      MetricCounterIDs::PipelineEgressBatcher);
+    this->recordBatch(batch_size, fill_start);
+#endif
+  }
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,126 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the sequence batcher implementation
+ */
+
+#ifndef GUARD_AMDINFER_BATCHING_SEQUENCE
+#define GUARD_AMDINFER_BATCHING_SEQUENCE
+
+#include <chrono>         // for milliseconds
+#include <cstddef>        // for size_t
+#include <mutex>          // for mutex
+#include <string>         // for string
+#include <unordered_map>  // for unordered_map
+#include <vector>         // for vector
+
+#include "amdinfer/batching/batcher.hpp"  // IWYU pragma: export
+#include "amdinfer/declarations.hpp"      // for BufferPtr
+
+namespace amdinfer {
+enum class MemoryAllocators;
+class Tensor;
+class WorkerInfo;
+}  // namespace amdinfer
+
+namespace amdinfer {
+
+/// How long a sequence may go without requests before its slot is reclaimed
+constexpr std::chrono::milliseconds kDefaultSequenceIdle{60'000};
+
+/**
+ * @brief The state tensors of the sequences in a sequence batcher's slots. The
+ * buffers come from the memory pool and are kept between the requests of a
+ * sequence so stateful workers don't need their clients to send the state
+ * back. A slot is only in one batch at a time so workers can use its state
+ * without further synchronization.
+ */
+class SequenceStates {
+ public:
+  /// A state tensor of a sequence
+  struct State {
+    Buffer* buffer;
+    /// true if the buffer was just allocated and should be initialized
+    bool fresh;
+  };
+
+  /**
+   * @brief Construct a new SequenceStates object
+   *
+   * @param pool the pool to get the state buffers from
+   * @param allocators the allocators that may be used for the buffers
+   */
+  SequenceStates(MemoryPool* pool, std::vector<MemoryAllocators> allocators);
+  SequenceStates(const SequenceStates&) = delete;
+  SequenceStates& operator=(const SequenceStates&) = delete;
+  SequenceStates(SequenceStates&&) = delete;
+  SequenceStates& operator=(SequenceStates&&) = delete;
+  /// Destructor. It returns the state buffers to the pool
+  ~SequenceStates();
+
+  /**
+   * @brief Get a state tensor of the sequence in a slot. It's allocated with
+   * the tensor's size the first time it's asked for in a sequence
+   *
+   * @param slot the sequence's slot
+   * @param tensor the state tensor, which is identified by its name
+   * @return State
+   */
+  State get(size_t slot, const Tensor& tensor);
+  /// Return the state buffers of a slot to the pool
+  void reset(size_t slot);
+
+ private:
+  MemoryPool* pool_;
+  std::vector<MemoryAllocators> allocators_;
+  std::mutex mutex_;
+  std::unordered_map<size_t, std::unordered_map<std::string, BufferPtr>>
+    states_;
+};
+
+/**
+ * @brief The SequenceBatcher batches the requests of stateful models, where
+ * each request is a step of a sequence. Requests set a "sequence_id"
+ * parameter, a string or an integer, and "sequence_start" and "sequence_end"
+ * on the first and last steps. Each sequence is assigned one of the batch
+ * size's slots when it starts and a batch holds at most one step of each
+ * slot. The batcher sets "sequence_slot" on each request to its slot so the
+ * worker can find the sequence's state in the batch's SequenceStates, which
+ * are reset when a sequence starts.
+ *
+ * The next step of a sequence isn't batched until the batch with the previous
+ * one is finished so the steps see each other's state in order, even if the
+ * worker group has many instances. Sequences that don't get a request for the
+ * "sequence_idle_ms" load-time parameter are ended and their slots reclaimed.
+ * Like the SoftBatcher, it waits up to the "timeout" parameter for a batch to
+ * fill. Workers get one sequence batcher regardless of the batchers asked for
+ * so all the steps of a sequence go through the same slots.
+ *
+ */
+class SequenceBatcher : public Batcher {
+ public:
+  using Batcher::Batcher;
+
+ private:
+  struct Step;
+  struct Slot;
+
+  void doRun(const std::vector<MemoryAllocators>& allocators) override;
+};
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_BATCHING_SEQUENCE
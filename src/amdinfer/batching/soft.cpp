@@ -21,18 +21,23 @@
 #include "amdinfer/batching/soft.hpp"
 
 #include <algorithm>  // for max
+#include <chrono>     // for duration
 #include <cstddef>    // for size_t
 #include <cstdint>    // for int32_t
-#include <memory>     // for unique_ptr, allocator
+#include <exception>  // for exception
+#include <memory>     // for unique_ptr, shared_ptr
 #include <ratio>      // for ratio
+#include <set>        // for set
 #include <string>     // for operator+, char_traits
 #include <utility>    // for move
 #include <vector>     // for vector
 
-#include "amdinfer/buffers/cpu.hpp"             // for CpuBuffer
-#include "amdinfer/build_options.hpp"           // for AMDINFER_ENABLE_METRICS
-#include "amdinfer/core/exceptions.hpp"         // for invalid_argument
-#include "amdinfer/core/inference_request.hpp"  // for InferenceRequest
+#include "amdinfer/batching/adaptive_timeout.hpp"  // for AdaptiveTimeout
+#include "amdinfer/batching/samples.hpp"           // for SplitRequest
+#include "amdinfer/buffers/buffer.hpp"             // for Buffer
+#include "amdinfer/build_options.hpp"              // for AMDINFER_ENABLE_...
+#include "amdinfer/core/exceptions.hpp"            // for invalid_argument
+#include "amdinfer/core/inference_request.hpp"     // for InferenceRequest
 #include "amdinfer/core/memory_pool/pool.hpp"
 #include "amdinfer/core/parameters.hpp"         // for ParameterMap
 #include "amdinfer/core/request_container.hpp"  // for InferenceRequestInput
@@ -42,14 +47,32 @@
 #include "amdinfer/observation/metrics.hpp"  // for Metrics, MetricCounterIDs
 #include "amdinfer/observation/tracing.hpp"  // for Trace
 #include "amdinfer/util/queue.hpp"           // for BlockingConcurrentQueue
+#include "amdinfer/util/string.hpp"          // for split
 #include "amdinfer/util/thread.hpp"          // for setThreadName
-#include "amdinfer/util/timer.hpp"           // for Timer
-
-// default batcher timeout in milliseconds
-constexpr auto kDefaultTimeout = 100;
+#include "amdinfer/util/timer.hpp"           // for Timer, getTime
 
 namespace amdinfer {
 
+std::set<size_t> SoftBatcher::getPreferredSizes() const {
+  std::set<size_t> sizes;
+  if (!this->parameters_.has("preferred_batch_sizes")) {
+    return sizes;
+  }
+  const auto list = this->parameters_.get<std::string>("preferred_batch_sizes");
+  for (const auto& token : util::split(list, ",")) {
+    try {
+      const auto size = std::stoul(token);
+      if (size > 0 && size < this->batch_size_) {
+        sizes.insert(size);
+      }
+    } catch (const std::exception&) {
+      AMDINFER_IF_LOGGING(const auto& logger = this->getLogger();)
+      AMDINFER_LOG_WARN(logger, "Ignoring the preferred batch size " + token);
+    }
+  }
+  return sizes;
+}
+
 void SoftBatcher::doRun(const std::vector<MemoryAllocators>& allocators) {
   auto thread_name = "batch" + this->getName();
   util::setThreadName(thread_name);
@@ -59,26 +82,41 @@ void SoftBatcher::doRun(const std::vector<MemoryAllocators>& allocators) {
 
   bool run = true;
 
-  auto timeout = kDefaultTimeout;
-  if (this->parameters_.has("timeout")) {
-    timeout = this->parameters_.get<int32_t>("timeout");
+  const auto timeout = this->getTimeout();
+  // if a latency SLO is set, the timeout is adapted to the load and only acts
+  // as an upper bound on the wait
+  std::shared_ptr<AdaptiveTimeout> adaptive_timeout;
+  if (this->parameters_.has("latency_slo")) {
+    adaptive_timeout = std::make_shared<AdaptiveTimeout>(
+      this->parameters_.get<int32_t>("latency_slo"),
+      std::chrono::duration<double, std::milli>(timeout).count());
   }
+  auto batch_timeout = timeout;
+  // batches are sent as soon as they reach one of these sizes unless more
+  // requests are already waiting to grow them
+  const auto preferred = this->getPreferredSizes();
+
+  // if set, batches are filled to the batch size in samples along the leading
+  // dimension of the requests instead of in requests
+  const bool count_samples = this->parameters_.has("batch_samples") &&
+                             this->parameters_.get<bool>("batch_samples");
+  // the rest of a request that didn't fit in the last batch
+  std::unique_ptr<SplitRequest> split;
+  // reused by each batch to not allocate it again
+  std::vector<size_t> input_offset;
 
-  while (run) {
-    auto batch = std::make_unique<Batch>();
+  while (run || split != nullptr) {
+    auto batch = batches_->get();
     size_t batch_size = 0;
+    size_t samples = 0;
+#ifdef AMDINFER_ENABLE_METRICS
+    util::TimePoint fill_start;
+#endif
 
-    std::vector<BufferPtr> input_buffers;
-    std::vector<size_t> input_offset;
     std::vector<size_t> output_offset;
 
 #ifdef AMDINFER_ENABLE_METRICS
-    Metrics::getInstance().setGauge(
-      MetricGaugeIDs::QueuesBatcherInput,
-      static_cast<double>(input_queue_->size_approx()));
-    Metrics::getInstance().setGauge(
-      MetricGaugeIDs::QueuesBatcherOutput,
-      static_cast<double>(output_queue_->size_approx()));
+    this->recordQueueSizes();
 #endif
 
     bool first_request = true;
@@ -86,19 +124,36 @@ void SoftBatcher::doRun(const std::vector<MemoryAllocators>& allocators) {
 
     do {
       RequestContainerPtr req;
-      if (first_request) {
+      // the rest of a split request starts the next batch
+      const bool carried = first_request && split != nullptr;
+      if (carried) {
+        req = split->take(this->batch_size_);
+        if (split->remaining() == 0) {
+          split.reset();
+        }
+        timer.start();
+      } else if (first_request) {
         // wait for the first request
         this->input_queue_->wait_dequeue(req);
-        timer.add("start");
+        timer.start();
         AMDINFER_LOG_DEBUG(logger,
                            "Got request of a new batch for " + this->model_);
+        if (adaptive_timeout) {
+          const auto adapted = adaptive_timeout->getTimeout(this->batch_size_);
+          batch_timeout = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::duration<double, std::milli>(adapted));
+#ifdef AMDINFER_ENABLE_METRICS
+          Metrics::getInstance().setGauge(MetricGaugeIDs::BatcherTimeout,
+                                          adapted);
+#endif
+        }
       } else {
         timer.stop();
 
-        auto remaining_time = timeout - timer.count<std::milli, int>();
-        // convert duration from milliseconds to microseconds for function
-        auto duration = std::max(remaining_time, 0) * std::kilo::num;
-        bool valid = this->input_queue_->wait_dequeue_timed(req, duration);
+        const auto remaining_time =
+          batch_timeout.count() - timer.count<std::micro, int64_t>();
+        bool valid = this->input_queue_->wait_dequeue_timed(
+          req, std::max<int64_t>(remaining_time, 0));
         if (!valid) {
           break;
         }
@@ -109,16 +164,55 @@ void SoftBatcher::doRun(const std::vector<MemoryAllocators>& allocators) {
         break;
       }
 
+      if (adaptive_timeout && !carried) {
+        adaptive_timeout->recordArrival(util::getTime());
+      }
+
+      if (!carried && this->dropAbandoned(req.get())) {
+        continue;
+      }
+      if (req->request->getInputs().empty()) {
+        req->request->runCallbackError("Input size is zero");
+        continue;
+      }
+
+      if (!carried) {
+        markBatched(*req);
+#ifdef AMDINFER_ENABLE_METRICS
+        this->recordQueueWait(*req);
+#endif
+      }
+
+      if (count_samples && !carried) {
+        try {
+          const auto request_samples = countSamples(*req->request);
+          const auto room = this->batch_size_ - samples;
+          if (request_samples > room) {
+            split = std::make_unique<SplitRequest>(std::move(req), pool_);
+            req = split->take(room);
+          }
+        } catch (const invalid_argument& e) {
+          this->releaseInputs(*req);
+          req->request->runCallbackError(e.what());
+          continue;
+        }
+      }
+      if (count_samples) {
+        samples += countSamples(*req->request);
+      }
+
       auto request = req->request;
       auto& inputs = request->getInputs();
       auto input_size = inputs.size();
-      if (input_size == 0) {
-        request->runCallbackError("Input size is zero");
-        continue;
-      }
 
-      if (first_request) {
-        input_buffers.reserve(input_size);
+      // a request that fills the batch by itself lends it its buffers
+      const bool fills =
+        count_samples ? samples == this->batch_size_ : this->batch_size_ == 1;
+      const bool lent = first_request && fills &&
+                        !(scatter_gather_ || ragged_) &&
+                        this->lendInputs(*req, batch.get(), allocators);
+
+      if (first_request && !(scatter_gather_ || ragged_) && !lent) {
         // auto output_sizes = req->getOutputSizes();
         // TODO(varunsh): the spec does not require the request to have outputs
         // additionally, the output size could be variable so this should be
@@ -127,18 +221,21 @@ void SoftBatcher::doRun(const std::vector<MemoryAllocators>& allocators) {
         // std::vector<BufferPtr> output_buffers;
         // output_buffers.reserve(output_sizes.size());
         // std::vector<size_t> output_offset(output_buffers.size(), 0);
-        for (const auto& input : inputs) {
-          input_buffers.push_back(pool_->get(allocators, input, batch_size_));
+        for (auto i = 0U; i < input_size; ++i) {
+          // sample batches hold the batch size in samples and request batches
+          // hold the same number of requests like the first
+          auto tensor = this->getBatchTensor(*request, i);
+          batch->addInputBuffer(pool_->get(
+            allocators, count_samples ? getSample(tensor) : tensor,
+            batch_size_));
         }
         // for(const auto& tensor_size : output_sizes) {
         //   output_buffers.push_back(pool_->get(allocators, tensor_size));
         // }
-        input_offset.resize(input_buffers.size());
-        batch->setBuffers(std::move(input_buffers), {});
+        input_offset.assign(batch->getInputSize(), 0);
       }
 
       auto raw_inputs = batch->getRawInputBuffers();
-      auto raw_outputs = batch->getRawOutputBuffers();
 
 #ifdef AMDINFER_ENABLE_TRACING
       auto& trace = req->trace;
@@ -148,26 +245,25 @@ void SoftBatcher::doRun(const std::vector<MemoryAllocators>& allocators) {
 #ifdef AMDINFER_ENABLE_METRICS
       Metrics::getInstance().incrementCounter(
         MetricCounterIDs::PipelineIngressBatcher);
+      if (batch_size == 0) {
+        fill_start = util::getTime();
+      }
 #endif
 
-      auto old_input_offset = input_offset;
-
-      for (auto i = 0U; i < input_size; ++i) {
-        const auto& input = inputs[i];
-        auto* raw_input = raw_inputs[i];
-        auto& offset = input_offset[i];
-
-        auto new_offset =
-          raw_input->write(input.getData(), offset,
-                           input.getSize() * input.getDatatype().size());
-        pool_->put(
-          std::make_unique<CpuBuffer>(input.getData(), MemoryAllocators::Cpu));
-        request->setInputTensorData(i, raw_input->data(offset));
-        offset = new_offset;
+      if (scatter_gather_ || ragged_) {
+        this->gatherInputs(*req, batch.get());
+      } else if (!lent) {
+        for (auto i = 0U; i < input_size; ++i) {
+          auto& offset = input_offset[i];
+          offset = this->writeInput(*req, i, raw_inputs[i], offset);
+        }
       }
 
       batch->addRequest(request);
       batch_size++;
+      if (req->timing != nullptr) {
+        batch->addTiming(req->timing);
+      }
 #ifdef AMDINFER_ENABLE_TRACING
       trace->endSpan();
       batch->addTrace(std::move(trace));
@@ -176,15 +272,35 @@ void SoftBatcher::doRun(const std::vector<MemoryAllocators>& allocators) {
       batch->addTime(req->start_time);
 #endif
       first_request = false;
-    } while (batch_size % this->batch_size_ != 0 && run);
+      const auto filled = count_samples ? samples : batch_size;
+      if (preferred.count(filled) > 0 &&
+          this->input_queue_->size_approx() == 0) {
+        break;
+      }
+    } while ((count_samples ? samples < this->batch_size_
+                            : batch_size % this->batch_size_ != 0) &&
+             run);
 
     if (!batch->empty()) {
+      // ragged batches are gathered and then concatenated without padding
+      if (ragged_) {
+        this->concatenate(batch.get(), allocators);
+      }
+      if (adaptive_timeout) {
+        batch->addCompletionCallback(
+          [adaptive_timeout, start = util::getTime()]() {
+            const std::chrono::duration<double, std::milli> duration =
+              util::getTime() - start;
+            adaptive_timeout->recordService(duration.count());
+          });
+      }
       AMDINFER_LOG_DEBUG(logger, "Enqueuing batch for " + this->model_ +
                                    " of size " + std::to_string(batch_size));
       this->output_queue_->enqueue(std::move(batch));
 #ifdef AMDINFER_ENABLE_METRICS
       Metrics::getInstance().incrementCounter(
         MetricCounterIDs::PipelineEgressBatcher);
+      this->recordBatch(count_samples ? samples : batch_size, fill_start);
 #endif
     }
   }
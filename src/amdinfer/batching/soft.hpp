@@ -21,6 +21,9 @@
 #ifndef GUARD_AMDINFER_BATCHING_SOFT
 #define GUARD_AMDINFER_BATCHING_SOFT
 
+#include <cstddef>  // for size_t
+#include <set>      // for set
+
 #include "amdinfer/batching/batcher.hpp"  // IWYU pragma: export
 
 namespace amdinfer {
@@ -33,7 +36,9 @@ namespace amdinfer {
 /**
  * @brief The SoftBatcher attempts to batch requests to the requested batch size
  * but has a timeout that passes an incomplete batch onwards if the batch cannot
- * be completed.
+ * be completed. The "preferred_batch_sizes" parameter lists smaller sizes,
+ * separated by commas, that a batch is sent at as soon as it reaches one if no
+ * more requests are waiting, such as the sizes a model was compiled for.
  *
  */
 class SoftBatcher : public Batcher {
@@ -42,6 +47,8 @@ class SoftBatcher : public Batcher {
 
  private:
   void doRun(const std::vector<MemoryAllocators>& allocators) override;
+  /// Get the preferred batch sizes that are smaller than the batch size
+  [[nodiscard]] std::set<size_t> getPreferredSizes() const;
 };
 
 }  // namespace amdinfer
@@ -20,12 +20,14 @@
 
 #include "amdinfer/clients/client.hpp"
 
-#include <pybind11/cast.h>      // for arg
-#include <pybind11/pybind11.h>  // for module_, sequence, class_, pybind11
-#include <pybind11/stl.h>       // IWYU pragma: keep
+#include <pybind11/cast.h>        // for arg
+#include <pybind11/functional.h>  // IWYU pragma: keep
+#include <pybind11/pybind11.h>    // for module_, sequence, class_, pybind11
+#include <pybind11/stl.h>         // IWYU pragma: keep
 
-#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
-#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/bindings/python/helpers/release_gil.hpp"  // for ReleaseGil
+#include "amdinfer/core/inference_request.hpp"               // for Inference...
+#include "amdinfer/core/inference_response.hpp"              // for Inference...
 
 namespace py = pybind11;
 
@@ -35,16 +37,31 @@ void wrapClient(py::module_ &m) {
   py::class_<Client> client{m, "Client"};
 
   m.def("serverHasExtension", &serverHasExtension, py::arg("client"),
-        py::arg("extension"));
-  m.def("waitUntilServerReady", &waitUntilServerReady, py::arg("client"));
+        py::arg("extension"), ReleaseGil());
+  m.def("waitUntilServerReady", &waitUntilServerReady, py::arg("client"),
+        ReleaseGil());
   m.def("waitUntilModelReady", &waitUntilModelReady, py::arg("client"),
-        py::arg("model"));
+        py::arg("model"), ReleaseGil());
 
   m.def("inferAsyncOrdered", &inferAsyncOrdered, py::arg("client"),
-        py::arg("model"), py::arg("requests"));
+        py::arg("model"), py::arg("requests"), ReleaseGil());
   m.def("inferAsyncOrderedBatched", &inferAsyncOrderedBatched,
         py::arg("client"), py::arg("model"), py::arg("requests"),
-        py::arg("batch_sizes"));
+        py::arg("batch_sizes"), ReleaseGil());
+  m.def("inferAsyncOrderedWindowed",
+        py::overload_cast<Client *, const std::string &,
+                          const std::vector<InferenceRequest> &, size_t>(
+          &inferAsyncOrderedWindowed),
+        py::arg("client"), py::arg("model"), py::arg("requests"),
+        py::arg("window"), ReleaseGil());
+  // the callback takes the GIL back for each response
+  m.def("inferAsyncOrderedWindowed",
+        py::overload_cast<Client *, const std::string &,
+                          const std::vector<InferenceRequest> &, size_t,
+                          const OrderedResponseCallback &>(
+          &inferAsyncOrderedWindowed),
+        py::arg("client"), py::arg("model"), py::arg("requests"),
+        py::arg("window"), py::arg("callback"), ReleaseGil());
 }
 
 }  // namespace amdinfer
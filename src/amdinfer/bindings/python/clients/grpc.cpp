@@ -23,9 +23,11 @@
 #include <pybind11/pybind11.h>  // for class_, init
 #include <pybind11/stl.h>       // IWYU pragma: keep
 
-#include "amdinfer/bindings/python/helpers/docstrings.hpp"  // for DOCS
-#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
-#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/bindings/python/helpers/asyncio.hpp"      // for modelInfe...
+#include "amdinfer/bindings/python/helpers/docstrings.hpp"   // for DOCS
+#include "amdinfer/bindings/python/helpers/release_gil.hpp"  // for ReleaseGil
+#include "amdinfer/core/inference_request.hpp"               // for Inference...
+#include "amdinfer/core/inference_response.hpp"              // for Inference...
 #include "amdinfer/core/parameters.hpp"
 
 namespace py = pybind11;
@@ -36,32 +38,46 @@ class ParameterMap;
 
 void wrapGrpcClient(py::module_ &m) {
   py::class_<GrpcClient, amdinfer::Client>(m, "GrpcClient")
-    .def(py::init<const std::string &>(), py::arg("address"),
+    .def(py::init<const std::string &, const CompressionOptions &>(),
+         py::arg("address"), py::arg("compression") = CompressionOptions(),
          DOCS(GrpcClient, GrpcClient))
+    .def(py::init<const std::string &, int, const CompressionOptions &>(),
+         py::arg("address"), py::arg("channels"),
+         py::arg("compression") = CompressionOptions(),
+         DOCS(GrpcClient, GrpcClient, 2))
     .def("serverMetadata", &GrpcClient::serverMetadata,
-         DOCS(GrpcClient, serverMetadata))
-    .def("serverLive", &GrpcClient::serverLive, DOCS(GrpcClient, serverLive))
-    .def("serverReady", &GrpcClient::serverReady, DOCS(GrpcClient, serverReady))
+         ReleaseGil(), DOCS(GrpcClient, serverMetadata))
+    .def("serverLive", &GrpcClient::serverLive, ReleaseGil(),
+         DOCS(GrpcClient, serverLive))
+    .def("serverReady", &GrpcClient::serverReady, ReleaseGil(),
+         DOCS(GrpcClient, serverReady))
     .def("modelReady", &GrpcClient::modelReady, py::arg("model"),
-         DOCS(GrpcClient, modelReady))
+         ReleaseGil(), DOCS(GrpcClient, modelReady))
     .def("modelMetadata", &GrpcClient::modelMetadata, py::arg("model"),
-         DOCS(GrpcClient, modelMetadata))
+         ReleaseGil(), DOCS(GrpcClient, modelMetadata))
     .def("modelLoad", &GrpcClient::modelLoad, py::arg("model"),
-         py::arg("parameters") = ParameterMap(), DOCS(GrpcClient, modelLoad))
+         py::arg("parameters") = ParameterMap(), ReleaseGil(),
+         DOCS(GrpcClient, modelLoad))
     .def("modelUnload", &GrpcClient::modelUnload, py::arg("model"),
-         DOCS(GrpcClient, modelUnload))
+         ReleaseGil(), DOCS(GrpcClient, modelUnload))
     .def("workerLoad", &GrpcClient::workerLoad, py::arg("model"),
-         py::arg("parameters") = ParameterMap(), DOCS(GrpcClient, workerLoad))
+         py::arg("parameters") = ParameterMap(), ReleaseGil(),
+         DOCS(GrpcClient, workerLoad))
     .def("workerUnload", &GrpcClient::workerUnload, py::arg("model"),
-         DOCS(GrpcClient, workerUnload))
+         ReleaseGil(), DOCS(GrpcClient, workerUnload))
     .def("modelInfer", &GrpcClient::modelInfer, py::arg("model"),
-         py::arg("request"), DOCS(GrpcClient, modelInfer))
-    // cannot wrap future directly in Python
-    // .def("modelInferAsync", &GrpcClient::modelInferAsync, py::arg("model"),
-    //      py::arg("request"), DOCS(GrpcClient, modelInferAsync))
-    .def("modelList", &GrpcClient::modelList, DOCS(GrpcClient, modelList))
+         py::arg("request"), ReleaseGil(), DOCS(GrpcClient, modelInfer))
+    .def("modelInferBatch", &GrpcClient::modelInferBatch, py::arg("model"),
+         py::arg("requests"), ReleaseGil(), DOCS(GrpcClient, modelInferBatch))
+    // the future can't be wrapped directly in Python so it's an asyncio.Future
+    .def("modelInferAsync", &modelInferAsyncio<GrpcClient>, py::arg("model"),
+         py::arg("request"),
+         "Makes an inference request from a coroutine and returns an "
+         "asyncio.Future for its response")
+    .def("modelList", &GrpcClient::modelList, ReleaseGil(),
+         DOCS(GrpcClient, modelList))
     .def("hasHardware", &GrpcClient::hasHardware, py::arg("name"),
-         py::arg("num"), DOCS(GrpcClient, hasHardware));
+         py::arg("num"), ReleaseGil(), DOCS(GrpcClient, hasHardware));
 }
 
 }  // namespace amdinfer
@@ -26,9 +26,11 @@
 
 #include <unordered_map>  // for unordered_map
 
-#include "amdinfer/bindings/python/helpers/docstrings.hpp"  // for DOCS
-#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
-#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/bindings/python/helpers/asyncio.hpp"      // for modelInfe...
+#include "amdinfer/bindings/python/helpers/docstrings.hpp"   // for DOCS
+#include "amdinfer/bindings/python/helpers/release_gil.hpp"  // for ReleaseGil
+#include "amdinfer/core/inference_request.hpp"               // for Inference...
+#include "amdinfer/core/inference_response.hpp"              // for Inference...
 #include "amdinfer/core/parameters.hpp"
 
 namespace py = pybind11;
@@ -45,34 +47,47 @@ void wrapHttpClient(py::module_ &m) {
 
   py::class_<HttpClient, amdinfer::Client>(m, "HttpClient")
     .def(py::init<const std::string &,
-                  const std::unordered_map<std::string, std::string>, int>(),
+                  const std::unordered_map<std::string, std::string>, int,
+                  int, const CompressionOptions &>(),
          py::arg("address"),
          py::arg("headers") = std::unordered_map<std::string, std::string>(),
-         py::arg("parallelism") = parallelism, DOCS(HttpClient, HttpClient))
+         py::arg("parallelism") = parallelism,
+         py::arg("clients_per_loop") = kDefaultHttpClientsPerLoop,
+         py::arg("compression") = CompressionOptions(),
+         DOCS(HttpClient, HttpClient))
     .def("serverMetadata", &HttpClient::serverMetadata,
-         DOCS(HttpClient, serverMetadata))
-    .def("serverLive", &HttpClient::serverLive, DOCS(HttpClient, serverLive))
-    .def("serverReady", &HttpClient::serverReady, DOCS(HttpClient, serverReady))
+         ReleaseGil(), DOCS(HttpClient, serverMetadata))
+    .def("serverLive", &HttpClient::serverLive, ReleaseGil(),
+         DOCS(HttpClient, serverLive))
+    .def("serverReady", &HttpClient::serverReady, ReleaseGil(),
+         DOCS(HttpClient, serverReady))
     .def("modelReady", &HttpClient::modelReady, py::arg("model"),
-         DOCS(HttpClient, modelReady))
+         ReleaseGil(), DOCS(HttpClient, modelReady))
     .def("modelMetadata", &HttpClient::modelMetadata, py::arg("model"),
-         DOCS(HttpClient, modelMetadata))
+         ReleaseGil(), DOCS(HttpClient, modelMetadata))
     .def("modelLoad", &HttpClient::modelLoad, py::arg("model"),
-         py::arg("parameters") = ParameterMap(), DOCS(HttpClient, modelLoad))
+         py::arg("parameters") = ParameterMap(), ReleaseGil(),
+         DOCS(HttpClient, modelLoad))
     .def("modelUnload", &HttpClient::modelUnload, py::arg("model"),
-         DOCS(HttpClient, modelUnload))
+         ReleaseGil(), DOCS(HttpClient, modelUnload))
     .def("workerLoad", &HttpClient::workerLoad, py::arg("model"),
-         py::arg("parameters") = ParameterMap(), DOCS(HttpClient, workerLoad))
+         py::arg("parameters") = ParameterMap(), ReleaseGil(),
+         DOCS(HttpClient, workerLoad))
     .def("workerUnload", &HttpClient::workerUnload, py::arg("model"),
-         DOCS(HttpClient, workerUnload))
+         ReleaseGil(), DOCS(HttpClient, workerUnload))
     .def("modelInfer", &HttpClient::modelInfer, py::arg("model"),
-         py::arg("request"), DOCS(HttpClient, modelInfer))
-    // cannot wrap future directly in Python
-    // .def("modelInferAsync", &HttpClient::modelInferAsync, py::arg("model"),
-    //      py::arg("request"), DOCS(HttpClient, modelInferAsync))
-    .def("modelList", &HttpClient::modelList, DOCS(HttpClient, modelList))
+         py::arg("request"), ReleaseGil(), DOCS(HttpClient, modelInfer))
+    .def("modelInferBatch", &HttpClient::modelInferBatch, py::arg("model"),
+         py::arg("requests"), ReleaseGil(), DOCS(HttpClient, modelInferBatch))
+    // the future can't be wrapped directly in Python so it's an asyncio.Future
+    .def("modelInferAsync", &modelInferAsyncio<HttpClient>, py::arg("model"),
+         py::arg("request"),
+         "Makes an inference request from a coroutine and returns an "
+         "asyncio.Future for its response")
+    .def("modelList", &HttpClient::modelList, ReleaseGil(),
+         DOCS(HttpClient, modelList))
     .def("hasHardware", &HttpClient::hasHardware, py::arg("name"),
-         py::arg("num"), DOCS(HttpClient, hasHardware));
+         py::arg("num"), ReleaseGil(), DOCS(HttpClient, hasHardware));
 }
 
 }  // namespace amdinfer
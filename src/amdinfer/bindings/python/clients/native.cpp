@@ -23,11 +23,12 @@
 #include <pybind11/pybind11.h>  // for class_, init
 #include <pybind11/stl.h>       // IWYU pragma: keep
 
-#include "amdinfer/bindings/python/helpers/docstrings.hpp"  // for DOCS
-#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
-#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/bindings/python/helpers/docstrings.hpp"   // for DOCS
+#include "amdinfer/bindings/python/helpers/release_gil.hpp"  // for ReleaseGil
+#include "amdinfer/core/inference_request.hpp"               // for Inference...
+#include "amdinfer/core/inference_response.hpp"              // for Inference...
 #include "amdinfer/core/parameters.hpp"
-#include "amdinfer/servers/server.hpp"  // for Server
+#include "amdinfer/servers/server.hpp"                       // for Server
 
 namespace py = pybind11;
 
@@ -37,31 +38,34 @@ void wrapNativeClient(py::module_ &m) {
   py::class_<NativeClient, amdinfer::Client>(m, "NativeClient")
     .def(py::init<Server *>(), py::arg("server"))
     .def("serverMetadata", &NativeClient::serverMetadata,
-         DOCS(NativeClient, serverMetadata))
+         ReleaseGil(), DOCS(NativeClient, serverMetadata))
     .def("serverLive", &NativeClient::serverLive,
-         DOCS(NativeClient, serverLive))
+         ReleaseGil(), DOCS(NativeClient, serverLive))
     .def("serverReady", &NativeClient::serverReady,
-         DOCS(NativeClient, serverReady))
+         ReleaseGil(), DOCS(NativeClient, serverReady))
     .def("modelReady", &NativeClient::modelReady, py::arg("model"),
-         DOCS(NativeClient, modelReady))
+         ReleaseGil(), DOCS(NativeClient, modelReady))
     .def("modelMetadata", &NativeClient::modelMetadata, py::arg("model"),
-         DOCS(NativeClient, modelMetadata))
+         ReleaseGil(), DOCS(NativeClient, modelMetadata))
     .def("modelLoad", &NativeClient::modelLoad, py::arg("model"),
-         py::arg("parameters") = ParameterMap(), DOCS(NativeClient, modelLoad))
+         py::arg("parameters") = ParameterMap(), ReleaseGil(),
+         DOCS(NativeClient, modelLoad))
     .def("modelUnload", &NativeClient::modelUnload, py::arg("model"),
-         DOCS(NativeClient, modelUnload))
+         ReleaseGil(), DOCS(NativeClient, modelUnload))
     .def("workerLoad", &NativeClient::workerLoad, py::arg("model"),
-         py::arg("parameters") = ParameterMap(), DOCS(NativeClient, workerLoad))
+         py::arg("parameters") = ParameterMap(), ReleaseGil(),
+         DOCS(NativeClient, workerLoad))
     .def("workerUnload", &NativeClient::workerUnload, py::arg("model"),
-         DOCS(NativeClient, workerUnload))
+         ReleaseGil(), DOCS(NativeClient, workerUnload))
     .def("modelInfer", &NativeClient::modelInfer, py::arg("model"),
-         py::arg("request"), DOCS(NativeClient, modelInfer))
+         py::arg("request"), ReleaseGil(), DOCS(NativeClient, modelInfer))
     // cannot wrap future directly in Python
     // .def("modelInferAsync", &NativeClient::modelInferAsync, py::arg("model"),
     //      py::arg("request"), DOCS(NativeClient, modelInferAsync))
-    .def("modelList", &NativeClient::modelList, DOCS(NativeClient, modelList))
+    .def("modelList", &NativeClient::modelList, ReleaseGil(),
+         DOCS(NativeClient, modelList))
     .def("hasHardware", &NativeClient::hasHardware, py::arg("name"),
-         py::arg("num"), DOCS(NativeClient, hasHardware));
+         py::arg("num"), ReleaseGil(), DOCS(NativeClient, hasHardware));
 }
 
 }  // namespace amdinfer
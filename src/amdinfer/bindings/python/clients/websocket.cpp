@@ -24,9 +24,10 @@
 #include <pybind11/pybind11.h>  // for class_, init
 #include <pybind11/stl.h>       // IWYU pragma: keep
 
-#include "amdinfer/bindings/python/helpers/docstrings.hpp"  // for DOCS
-#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
-#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/bindings/python/helpers/docstrings.hpp"   // for DOCS
+#include "amdinfer/bindings/python/helpers/release_gil.hpp"  // for ReleaseGil
+#include "amdinfer/core/inference_request.hpp"               // for Inference...
+#include "amdinfer/core/inference_response.hpp"              // for Inference...
 #include "amdinfer/core/parameters.hpp"
 
 namespace py = pybind11;
@@ -38,45 +39,72 @@ class ParameterMap;
 void wrapWebSocketClient(py::module_ &m) {
   using amdinfer::WebSocketClient;
 
+  py::enum_<WebSocketProtocol>(m, "WebSocketProtocol")
+    .value("Json", WebSocketProtocol::Json)
+    .value("Binary", WebSocketProtocol::Binary);
+
+  py::enum_<WebSocketWindowPolicy>(m, "WebSocketWindowPolicy")
+    .value("Block", WebSocketWindowPolicy::Block)
+    .value("Skip", WebSocketWindowPolicy::Skip)
+    .value("DropOldest", WebSocketWindowPolicy::DropOldest);
+
   py::class_<WebSocketClient, amdinfer::Client>(m, "WebSocketClient")
-    .def(py::init<const std::string &, const std::string &>(),
+    .def(py::init<const std::string &, const std::string &,
+                  WebSocketProtocol, size_t, WebSocketWindowPolicy>(),
          py::arg("ws_address"), py::arg("http_address"),
+         py::arg("protocol") = WebSocketProtocol::Json, py::arg("window") = 0,
+         py::arg("policy") = WebSocketWindowPolicy::Block,
          DOCS(WebSocketClient, WebSocketClient))
     .def("serverMetadata", &WebSocketClient::serverMetadata,
-         DOCS(WebSocketClient, serverMetadata))
+         ReleaseGil(), DOCS(WebSocketClient, serverMetadata))
     .def("serverLive", &WebSocketClient::serverLive,
-         DOCS(WebSocketClient, serverLive))
+         ReleaseGil(), DOCS(WebSocketClient, serverLive))
     .def("serverReady", &WebSocketClient::serverReady,
-         DOCS(WebSocketClient, serverReady))
+         ReleaseGil(), DOCS(WebSocketClient, serverReady))
     .def("modelReady", &WebSocketClient::modelReady, py::arg("model"),
-         DOCS(WebSocketClient, modelReady))
+         ReleaseGil(), DOCS(WebSocketClient, modelReady))
     .def("modelMetadata", &WebSocketClient::modelMetadata, py::arg("model"),
-         DOCS(WebSocketClient, modelMetadata))
+         ReleaseGil(), DOCS(WebSocketClient, modelMetadata))
     .def("modelLoad", &WebSocketClient::modelLoad, py::arg("model"),
          py::arg("parameters") = ParameterMap(),
-         DOCS(WebSocketClient, modelLoad))
+         ReleaseGil(), DOCS(WebSocketClient, modelLoad))
     .def("modelUnload", &WebSocketClient::modelUnload, py::arg("model"),
-         DOCS(WebSocketClient, modelUnload))
+         ReleaseGil(), DOCS(WebSocketClient, modelUnload))
     .def("workerLoad", &WebSocketClient::workerLoad, py::arg("model"),
          py::arg("parameters") = ParameterMap(),
-         DOCS(WebSocketClient, workerLoad))
+         ReleaseGil(), DOCS(WebSocketClient, workerLoad))
     .def("workerUnload", &WebSocketClient::workerUnload, py::arg("model"),
-         DOCS(WebSocketClient, workerUnload))
+         ReleaseGil(), DOCS(WebSocketClient, workerUnload))
     .def("modelInfer", &WebSocketClient::modelInfer, py::arg("model"),
-         py::arg("request"), DOCS(WebSocketClient, modelInfer))
+         py::arg("request"), ReleaseGil(), DOCS(WebSocketClient, modelInfer))
     // cannot wrap future directly in Python
     // .def("modelInferAsync", &WebSocketClient::modelInferAsync,
     // py::arg("model"),
     //      py::arg("request"), DOCS(WebSocketClient, modelInferAsync))
     .def("modelInferWs", &WebSocketClient::modelInferWs, py::arg("model"),
-         py::arg("request"), DOCS(WebSocketClient, modelInferWs))
+         py::arg("request"), ReleaseGil(), DOCS(WebSocketClient, modelInferWs))
     .def("modelRecv", &WebSocketClient::modelRecv,
-         DOCS(WebSocketClient, modelRecv))
+         ReleaseGil(), DOCS(WebSocketClient, modelRecv))
+    .def(
+      "modelRecvBytes",
+      [](const WebSocketClient &self) {
+        std::string message;
+        {
+          const py::gil_scoped_release release;
+          message = self.modelRecv();
+        }
+        return py::bytes(message);
+      },
+      "Gets one message from the websocket server as bytes. Use this instead "
+      "of modelRecv for binary messages")
+    .def("modelRecvResponse", &WebSocketClient::modelRecvResponse,
+         ReleaseGil(), DOCS(WebSocketClient, modelRecvResponse))
     .def("modelList", &WebSocketClient::modelList,
-         DOCS(WebSocketClient, modelList))
+         ReleaseGil(), DOCS(WebSocketClient, modelList))
     .def("hasHardware", &WebSocketClient::hasHardware, py::arg("name"),
-         py::arg("num"), DOCS(WebSocketClient, hasHardware))
-    .def("close", &WebSocketClient::close, DOCS(WebSocketClient, close));
+         py::arg("num"), ReleaseGil(), DOCS(WebSocketClient, hasHardware))
+    .def("close", &WebSocketClient::close, ReleaseGil(),
+         DOCS(WebSocketClient, close));
 }
 
 }  // namespace amdinfer
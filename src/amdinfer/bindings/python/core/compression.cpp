@@ -0,0 +1,44 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the Python bindings for the compression.hpp header
+ */
+
+#include "amdinfer/core/compression.hpp"
+
+#include <pybind11/pybind11.h>  // for class_, init, enum_
+
+#include "amdinfer/bindings/python/helpers/docstrings.hpp"  // for DOCS
+
+namespace py = pybind11;
+
+namespace amdinfer {
+
+void wrapCompression(py::module_ &m) {
+  py::enum_<Compression>(m, "Compression")
+    .value("None_", Compression::None)
+    .value("Deflate", Compression::Deflate)
+    .value("Gzip", Compression::Gzip);
+
+  py::class_<CompressionOptions>(m, "CompressionOptions")
+    .def(py::init<>(), DOCS(CompressionOptions))
+    .def_readwrite("algorithm", &CompressionOptions::algorithm,
+                   DOCS(CompressionOptions, algorithm))
+    .def_readwrite("threshold", &CompressionOptions::threshold,
+                   DOCS(CompressionOptions, threshold));
+}
+
+}  // namespace amdinfer
@@ -36,6 +36,7 @@ void wrapInferenceResponses(pybind11::module_ &);
 void wrapModelMetadata(pybind11::module_ &);
 void wrapTensor(pybind11::module_ &);
 void wrapInferenceTensor(pybind11::module_ &);
+void wrapCompression(pybind11::module_ &);
 
 void inline wrapCore(pybind11::module_ &m) {
   wrapExceptions(m);
@@ -47,6 +48,7 @@ void inline wrapCore(pybind11::module_ &m) {
   wrapInferenceRequests(m);
   wrapInferenceResponses(m);
   wrapModelMetadata(m);
+  wrapCompression(m);
 }
 
 }  // namespace amdinfer
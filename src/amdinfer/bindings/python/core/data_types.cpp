@@ -57,6 +57,8 @@ void wrapDataType(py::module_& m) {
       "INT64", [](const py::object& /*self*/) { return DataType("INT64"); })
     .def_property_readonly_static(
       "FP16", [](const py::object& /*self*/) { return DataType("FP16"); })
+    .def_property_readonly_static(
+      "BF16", [](const py::object& /*self*/) { return DataType("BF16"); })
     .def_property_readonly_static(
       "FP32", [](const py::object& /*self*/) { return DataType("FP32"); })
     .def_property_readonly_static(
@@ -67,6 +69,8 @@ void wrapDataType(py::module_& m) {
       "FLOAT64", [](const py::object& /*self*/) { return DataType("FP64"); })
     .def_property_readonly_static(
       "STRING", [](const py::object& /*self*/) { return DataType("STRING"); })
+    .def_property_readonly_static(
+      "BYTES", [](const py::object& /*self*/) { return DataType("BYTES"); })
     .def("size", &DataType::size)
     .def("str", &DataType::str)
     // defines the __eq__ operator for the class
@@ -95,7 +99,9 @@ void wrapDataType(py::module_& m) {
     .value("FLOAT32", DataType::Fp32)
     .value("FP64", DataType::Fp64)
     .value("FLOAT64", DataType::Fp64)
-    .value("STRING", DataType::String);
+    .value("STRING", DataType::String)
+    .value("BF16", DataType::Bf16)
+    .value("BYTES", DataType::Bytes);
 
   py::implicitly_convertible<DataType::Value, DataType>();
 }
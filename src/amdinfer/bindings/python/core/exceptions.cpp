@@ -35,6 +35,8 @@ void wrapExceptions(py::module_& m) {
   py::register_exception<invalid_argument>(m, "InvalidArgumentError");
   py::register_exception<environment_not_set_error>(m,
                                                     "EnvironmentNotSetError");
+  py::register_exception<resource_exhausted_error>(m,
+                                                   "ResourceExhaustedError");
 }
 
 }  // namespace amdinfer
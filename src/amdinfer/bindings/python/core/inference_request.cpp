@@ -25,36 +25,57 @@
 #include <pybind11/pybind11.h>  // for class_, init
 #include <pybind11/stl.h>       // IWYU pragma: keep
 
-#include <array>          // for array
-#include <cstring>        // for memcpy
 #include <sstream>        // IWYU pragma: keep
 #include <unordered_map>  // for unordered_map
 
+#include "amdinfer/bindings/python/helpers/arrays.hpp"      // for viewData
 #include "amdinfer/bindings/python/helpers/docstrings.hpp"  // for DOCS
 #include "amdinfer/bindings/python/helpers/keep_alive.hpp"  // for keep_alive
 #include "amdinfer/bindings/python/helpers/print.hpp"       // for toString
+#include "amdinfer/bindings/python/helpers/shape.hpp"       // IWYU pragma: keep
+#include "amdinfer/core/exceptions.hpp"                     // for invalid_a...
 #include "amdinfer/core/inference_response.hpp"
+#include "amdinfer/util/convert.hpp"                        // for convert
 
 namespace py = pybind11;
 
 namespace amdinfer {
 
 template <typename T>
-py::array_t<T> getData(const amdinfer::InferenceRequestInput &self) {
-  auto *data = static_cast<T *>(self.getData());
-  return py::array_t<T>(self.getSize(), data);
-
-  // return py::memoryview::from_memory(data->data(), self.getSize());
+void setData(InferenceRequestInput &self, const py::object &data) {
+  // arrays of the right type are used in place. Anything else is converted to
+  // a new array, which is kept alive with the input in place of the argument
+  auto array =
+    py::array_t<T, py::array::c_style | py::array::forcecast>::ensure(data);
+  if (!array) {
+    throw invalid_argument("The data can't be converted to an array");
+  }
+  // NOLINTNEXTLINE(google-readability-casting)
+  self.setData((void *)(array.data()));
+  py::detail::keep_alive_impl(
+    py::cast(&self, py::return_value_policy::reference), array);
 }
 
-template <typename T>
-void setData(amdinfer::InferenceRequestInput &self, py::array_t<T> &b) {
-  // NOLINTNEXTLINE(google-readability-casting)
-  self.setData((void *)(b.data()));
+/// Numpy has no bf16 so the data is converted from floats into a new array of
+/// its bits, which is kept alive with the input
+void setBf16Data(InferenceRequestInput &self, const py::object &data) {
+  auto floats =
+    py::array_t<float, py::array::c_style | py::array::forcecast>::ensure(data);
+  if (!floats) {
+    throw invalid_argument("The data can't be converted to an array");
+  }
+  const auto size = static_cast<size_t>(floats.size());
+  py::array_t<uint16_t> array(floats.size());
+  auto *bits = static_cast<void *>(array.mutable_data());
+  util::convert(floats.data(), size, static_cast<bf16 *>(bits));
+  self.setData(bits);
+  py::detail::keep_alive_impl(
+    py::cast(&self, py::return_value_policy::reference), array);
 }
 
 void wrapInferenceRequestInput(py::module_ &m) {
-  py::class_<InferenceRequestInput, InferenceTensor>(m, "InferenceRequestInput")
+  py::class_<InferenceRequestInput, InferenceTensor>(m, "InferenceRequestInput",
+                                                     py::buffer_protocol())
     .def(py::init<>(), DOCS(InferenceRequestInput, InferenceRequestInput))
     .def(py::init<const InferenceTensor &>(),
          DOCS(InferenceRequestInput, InferenceRequestInput, 2),
@@ -62,33 +83,37 @@ void wrapInferenceRequestInput(py::module_ &m) {
     .def(py::init<const Tensor &>(),
          DOCS(InferenceRequestInput, InferenceRequestInput, 3),
          py::arg("tensor"))
-    .def(py::init<void *, std::vector<uint64_t>, DataType, std::string>(),
+    .def(py::init<void *, Shape, DataType, std::string>(),
          DOCS(InferenceRequestInput, InferenceRequestInput, 4), py::arg("data"),
          py::arg("shape"), py::arg("data_type"), py::arg("data") = "")
-    .def("setUint8Data", &setData<uint8_t>, KeepAliveAssign())
-    .def("setUint16Data", &setData<uint16_t>, KeepAliveAssign())
-    .def("setUint32Data", &setData<uint32_t>, KeepAliveAssign())
-    .def("setUint64Data", &setData<uint64_t>, KeepAliveAssign())
-    .def("setInt8Data", &setData<int8_t>, KeepAliveAssign())
-    .def("setInt16Data", &setData<int16_t>, KeepAliveAssign())
-    .def("setInt32Data", &setData<int32_t>, KeepAliveAssign())
-    .def("setInt64Data", &setData<int64_t>, KeepAliveAssign())
-    .def("setFp16Data", &setData<amdinfer::fp16>, KeepAliveAssign())
-    .def("setFp32Data", &setData<float>, KeepAliveAssign())
-    .def("setFp64Data", &setData<double>, KeepAliveAssign())
-    .def("setStringData", &setData<unsigned char>, KeepAliveAssign())
-    .def("getUint8Data", &getData<uint8_t>, KeepAliveReturn())
-    .def("getUint16Data", &getData<uint16_t>, KeepAliveReturn())
-    .def("getUint32Data", &getData<uint32_t>, KeepAliveReturn())
-    .def("getUint64Data", &getData<uint64_t>, KeepAliveReturn())
-    .def("getInt8Data", &getData<int8_t>, KeepAliveReturn())
-    .def("getInt16Data", &getData<int16_t>, KeepAliveReturn())
-    .def("getInt32Data", &getData<int32_t>, KeepAliveReturn())
-    .def("getInt64Data", &getData<int64_t>, KeepAliveReturn())
-    .def("getFp16Data", &getData<amdinfer::fp16>, KeepAliveReturn())
-    .def("getFp32Data", &getData<float>, KeepAliveReturn())
-    .def("getFp64Data", &getData<double>, KeepAliveReturn())
-    .def("getStringData", &getData<char>, KeepAliveReturn())
+    .def("setUint8Data", &setData<uint8_t>, py::arg("data"))
+    .def("setUint16Data", &setData<uint16_t>, py::arg("data"))
+    .def("setUint32Data", &setData<uint32_t>, py::arg("data"))
+    .def("setUint64Data", &setData<uint64_t>, py::arg("data"))
+    .def("setInt8Data", &setData<int8_t>, py::arg("data"))
+    .def("setInt16Data", &setData<int16_t>, py::arg("data"))
+    .def("setInt32Data", &setData<int32_t>, py::arg("data"))
+    .def("setInt64Data", &setData<int64_t>, py::arg("data"))
+    .def("setFp16Data", &setData<amdinfer::fp16>, py::arg("data"))
+    .def("setBf16Data", &setBf16Data, py::arg("data"))
+    .def("setFp32Data", &setData<float>, py::arg("data"))
+    .def("setFp64Data", &setData<double>, py::arg("data"))
+    .def("setStringData", &setData<unsigned char>, py::arg("data"))
+    .def("getUint8Data", &viewData<uint8_t, InferenceRequestInput>)
+    .def("getUint16Data", &viewData<uint16_t, InferenceRequestInput>)
+    .def("getUint32Data", &viewData<uint32_t, InferenceRequestInput>)
+    .def("getUint64Data", &viewData<uint64_t, InferenceRequestInput>)
+    .def("getInt8Data", &viewData<int8_t, InferenceRequestInput>)
+    .def("getInt16Data", &viewData<int16_t, InferenceRequestInput>)
+    .def("getInt32Data", &viewData<int32_t, InferenceRequestInput>)
+    .def("getInt64Data", &viewData<int64_t, InferenceRequestInput>)
+    .def("getFp16Data", &viewData<amdinfer::fp16, InferenceRequestInput>)
+    .def("getBf16Data", &copyBf16Data<InferenceRequestInput>)
+    .def("getFp32Data", &viewData<float, InferenceRequestInput>)
+    .def("getFp64Data", &viewData<double, InferenceRequestInput>)
+    .def("getStringData", &viewData<char, InferenceRequestInput>)
+    .def_buffer(
+      [](const InferenceRequestInput &self) { return describeBuffer(self); })
     .def("__repr__",
          [](const InferenceRequestInput &self) {
            return "InferenceRequestInput(" + std::to_string(self.getSize()) +
@@ -30,10 +30,13 @@
 #include <sstream>        // IWYU pragma: keep
 #include <unordered_map>  // for unordered_map
 
+#include "amdinfer/bindings/python/helpers/arrays.hpp"      // for viewData
 #include "amdinfer/bindings/python/helpers/docstrings.hpp"  // for DOCS
 #include "amdinfer/bindings/python/helpers/keep_alive.hpp"  // for keep_alive
 #include "amdinfer/bindings/python/helpers/print.hpp"       // for toString
+#include "amdinfer/bindings/python/helpers/shape.hpp"       // IWYU pragma: keep
 #include "amdinfer/core/inference_request.hpp"
+#include "amdinfer/util/convert.hpp"                        // for convert
 
 namespace py = pybind11;
 
@@ -56,8 +59,13 @@ void wrapInferenceResponse(py::module_ &m) {
 #endif
     .def("getParameters", &InferenceResponse::getParameters,
          DOCS(InferenceResponse, getParameters))
-    .def("getOutputs", &InferenceResponse::getOutputs,
-         py::return_value_policy::reference_internal,
+    .def(
+      "getOutputs",
+      [](const InferenceResponse &self)
+        -> const std::vector<InferenceResponseOutput> & {
+        return self.getOutputs();
+      },
+      py::return_value_policy::reference_internal,
          DOCS(InferenceResponse, getOutputs))
     .def("addOutput", &InferenceResponse::addOutput, py::arg("output"),
          KeepAliveAssign(), DOCS(InferenceResponse, addOutput))
@@ -74,18 +82,21 @@ void wrapInferenceResponse(py::module_ &m) {
 }
 
 template <typename T>
-py::array_t<T> getData(const amdinfer::InferenceResponseOutput &self) {
-  auto *data = static_cast<T *>(self.getData());
-  return py::array_t<T>(self.getSize(), data);
-
-  // return py::memoryview::from_memory(data->data(), self.getSize());
+void setData(amdinfer::InferenceResponseOutput &self, py::array_t<T> &b) {
+  std::vector<std::byte> data;
+  data.resize(b.nbytes());
+  memcpy(data.data(), b.data(), b.nbytes());
+  self.setData(std::move(data));
 }
 
-template <typename T>
-void setData(amdinfer::InferenceResponseOutput &self, py::array_t<T> &b) {
+/// Numpy has no bf16 so the data is converted from floats
+void setBf16Data(amdinfer::InferenceResponseOutput &self,
+                 py::array_t<float, py::array::forcecast> &b) {
+  const auto size = static_cast<size_t>(b.size());
   std::vector<std::byte> data;
-  data.resize(b.size());
-  memcpy(data.data(), b.data(), b.size());
+  data.resize(size * sizeof(bf16));
+  auto *bits = static_cast<void *>(data.data());
+  util::convert(b.data(), size, static_cast<bf16 *>(bits));
   self.setData(std::move(data));
 }
 
@@ -93,11 +104,11 @@ void wrapInferenceResponseOutput(py::module_ &m) {
   // need to use function pointer to disambiguate overloaded function
   // NOLINTNEXTLINE(readability-identifier-naming)
   auto setShape =
-    static_cast<void (InferenceResponseOutput::*)(std::vector<uint64_t>)>(
+    static_cast<void (InferenceResponseOutput::*)(Shape)>(
       &InferenceResponseOutput::setShape);
 
   py::class_<InferenceResponseOutput, InferenceTensor>(
-    m, "InferenceResponseOutput")
+    m, "InferenceResponseOutput", py::buffer_protocol())
     .def(py::init<>(), DOCS(InferenceResponseOutput))
     .def("setUint8Data", &setData<uint8_t>, KeepAliveAssign())
     .def("setUint16Data", &setData<uint16_t>, KeepAliveAssign())
@@ -108,6 +119,7 @@ void wrapInferenceResponseOutput(py::module_ &m) {
     .def("setInt32Data", &setData<int32_t>, KeepAliveAssign())
     .def("setInt64Data", &setData<int64_t>, KeepAliveAssign())
     .def("setFp16Data", &setData<amdinfer::fp16>, KeepAliveAssign())
+    .def("setBf16Data", &setBf16Data, KeepAliveAssign())
     .def("setFp32Data", &setData<float>, KeepAliveAssign())
     .def("setFp64Data", &setData<double>, KeepAliveAssign())
     .def(
@@ -119,18 +131,19 @@ void wrapInferenceResponseOutput(py::module_ &m) {
         self.setData(std::move(data));
       },
       KeepAliveAssign())
-    .def("getUint8Data", &getData<uint8_t>, KeepAliveReturn())
-    .def("getUint16Data", &getData<uint16_t>, KeepAliveReturn())
-    .def("getUint32Data", &getData<uint32_t>, KeepAliveReturn())
-    .def("getUint64Data", &getData<uint64_t>, KeepAliveReturn())
-    .def("getInt8Data", &getData<int8_t>, KeepAliveReturn())
-    .def("getInt16Data", &getData<int16_t>, KeepAliveReturn())
-    .def("getInt32Data", &getData<int32_t>, KeepAliveReturn())
-    .def("getInt64Data", &getData<int64_t>, KeepAliveReturn())
-    .def("getFp16Data", &getData<amdinfer::fp16>, KeepAliveReturn())
-    .def("getFp32Data", &getData<float>, KeepAliveReturn())
-    .def("getFp64Data", &getData<double>, KeepAliveReturn())
-    .def("getStringData", &getData<char>, KeepAliveReturn())
+    .def("getUint8Data", &viewData<uint8_t, InferenceResponseOutput>)
+    .def("getUint16Data", &viewData<uint16_t, InferenceResponseOutput>)
+    .def("getUint32Data", &viewData<uint32_t, InferenceResponseOutput>)
+    .def("getUint64Data", &viewData<uint64_t, InferenceResponseOutput>)
+    .def("getInt8Data", &viewData<int8_t, InferenceResponseOutput>)
+    .def("getInt16Data", &viewData<int16_t, InferenceResponseOutput>)
+    .def("getInt32Data", &viewData<int32_t, InferenceResponseOutput>)
+    .def("getInt64Data", &viewData<int64_t, InferenceResponseOutput>)
+    .def("getFp16Data", &viewData<amdinfer::fp16, InferenceResponseOutput>)
+    .def("getBf16Data", &copyBf16Data<InferenceResponseOutput>)
+    .def("getFp32Data", &viewData<float, InferenceResponseOutput>)
+    .def("getFp64Data", &viewData<double, InferenceResponseOutput>)
+    .def("getStringData", &viewData<char, InferenceResponseOutput>)
     .def_property("name", &InferenceResponseOutput::getName,
                   &InferenceResponseOutput::setName)
     .def_property("shape", &InferenceResponseOutput::getShape, setShape)
@@ -139,6 +152,8 @@ void wrapInferenceResponseOutput(py::module_ &m) {
     .def_property("parameters", &InferenceResponseOutput::getParameters,
                   &InferenceResponseOutput::setParameters)
     .def("getSize", &InferenceResponseOutput::getSize, DOCS(Tensor, getSize))
+    .def_buffer(
+      [](const InferenceResponseOutput &self) { return describeBuffer(self); })
     .def("__repr__",
          [](const InferenceResponseOutput &self) {
            return "InferenceResponseOutput(" + std::to_string(self.getSize()) +
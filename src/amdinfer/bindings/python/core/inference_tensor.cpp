@@ -33,6 +33,7 @@
 #include "amdinfer/bindings/python/helpers/docstrings.hpp"  // for DOCS
 #include "amdinfer/bindings/python/helpers/keep_alive.hpp"  // for keep_alive
 #include "amdinfer/bindings/python/helpers/print.hpp"       // for toString
+#include "amdinfer/bindings/python/helpers/shape.hpp"       // IWYU pragma: keep
 #include "amdinfer/core/inference_response.hpp"
 
 namespace py = pybind11;
@@ -41,7 +42,7 @@ namespace amdinfer {
 
 void wrapInferenceTensor(py::module_ &m) {
   py::class_<InferenceTensor, Tensor>(m, "InferenceTensor")
-    .def(py::init<std::string, std::vector<uint64_t>, amdinfer::DataType>(),
+    .def(py::init<std::string, Shape, amdinfer::DataType>(),
          DOCS(InferenceTensor, InferenceTensor), py::arg("name"),
          py::arg("shape"), py::arg("dataType"))
     .def(py::init<Tensor>(), DOCS(InferenceTensor, InferenceTensor, 2),
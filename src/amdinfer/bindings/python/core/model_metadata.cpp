@@ -58,6 +58,8 @@ void wrapModelMetadata(py::module_ &m) {
     .def_property("name", &ModelMetadata::getName, &ModelMetadata::setName)
     .def("getPlatform", &ModelMetadata::getPlatform,
          DOCS(ModelMetadata, getPlatform))
+    .def_property("parameters", &ModelMetadata::getParameters,
+                  &ModelMetadata::setParameters)
     .def("setReady", &ModelMetadata::setReady, DOCS(ModelMetadata, setReady))
     .def("isReady", &ModelMetadata::isReady, DOCS(ModelMetadata, isReady));
 }
@@ -0,0 +1,125 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines helpers to share tensors' memory with numpy without copying
+ */
+
+#ifndef GUARD_AMDINFER_BINDINGS_PYTHON_HELPERS_ARRAYS
+#define GUARD_AMDINFER_BINDINGS_PYTHON_HELPERS_ARRAYS
+
+#include <pybind11/buffer_info.h>  // for buffer_info
+#include <pybind11/numpy.h>        // for array_t
+#include <pybind11/pybind11.h>     // for cast, format_descriptor
+
+#include <string>       // for string
+#include <type_traits>  // for is_same_v
+#include <utility>      // for move
+#include <vector>       // for vector
+
+#include "amdinfer/core/data_types.hpp"  // for DataType, switchOverTypes
+#include "amdinfer/util/convert.hpp"     // for convert
+
+namespace amdinfer {
+
+/**
+ * @brief Get a numpy array that shares the tensor's data. The array holds a
+ * reference to the tensor's Python object so the data outlives the array
+ *
+ * @tparam T type of the tensor's data
+ * @tparam Tensor a tensor with getData() and getSize()
+ * @param self the tensor
+ * @return pybind11::array_t<T>
+ */
+template <typename T, typename Tensor>
+pybind11::array_t<T> viewData(const Tensor &self) {
+  auto owner =
+    pybind11::cast(&self, pybind11::return_value_policy::reference);
+  return pybind11::array_t<T>(self.getSize(),
+                              static_cast<const T *>(self.getData()), owner);
+}
+
+/**
+ * @brief Get a numpy array of floats copied from the tensor's bf16 data. Numpy
+ * has no bf16 type so the data can't be shared in place
+ *
+ * @tparam Tensor a tensor with getData() and getSize()
+ * @param self the tensor
+ * @return pybind11::array_t<float>
+ */
+template <typename Tensor>
+pybind11::array_t<float> copyBf16Data(const Tensor &self) {
+  const auto size = self.getSize();
+  pybind11::array_t<float> array(static_cast<pybind11::ssize_t>(size));
+  util::convert(static_cast<const bf16 *>(self.getData()), size,
+                array.mutable_data());
+  return array;
+}
+
+/// Get the buffer protocol format of a datatype
+struct BufferFormat {
+  template <typename T>
+  std::string operator()() const {
+    if constexpr (std::is_same_v<T, fp16>) {
+      return "e";
+    } else if constexpr (std::is_same_v<T, bf16>) {
+      // numpy has no bf16 so the raw bits are described instead
+      return "H";
+    } else if constexpr (std::is_same_v<T, char>) {
+      return "B";
+    } else {
+      return pybind11::format_descriptor<T>::format();
+    }
+  }
+};
+
+/**
+ * @brief Describe the tensor's data for the buffer protocol so memoryview()
+ * and numpy.asarray() can use it in place. A tensor without data is described
+ * as an empty buffer
+ *
+ * @tparam Tensor a tensor with getData(), getShape() and getDatatype()
+ * @param self the tensor
+ * @return pybind11::buffer_info
+ */
+template <typename Tensor>
+pybind11::buffer_info describeBuffer(const Tensor &self) {
+  const auto datatype = self.getDatatype();
+  const auto item_size = static_cast<pybind11::ssize_t>(datatype.size());
+  const auto format = switchOverTypes(BufferFormat(), datatype);
+  auto *data = self.getData();
+  if (data == nullptr) {
+    return {nullptr, item_size, format, 1, {0}, {item_size}};
+  }
+
+  const auto &shape = self.getShape();
+  std::vector<pybind11::ssize_t> dimensions(shape.begin(), shape.end());
+  std::vector<pybind11::ssize_t> strides(dimensions.size());
+  auto stride = item_size;
+  for (auto i = dimensions.size(); i > 0; --i) {
+    strides[i - 1] = stride;
+    stride *= dimensions[i - 1];
+  }
+  return {data,
+          item_size,
+          format,
+          static_cast<pybind11::ssize_t>(dimensions.size()),
+          std::move(dimensions),
+          std::move(strides)};
+}
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_BINDINGS_PYTHON_HELPERS_ARRAYS
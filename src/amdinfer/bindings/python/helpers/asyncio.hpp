@@ -0,0 +1,111 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the awaitable inference requests for the Python clients
+ */
+
+#ifndef GUARD_AMDINFER_BINDINGS_PYTHON_HELPERS_ASYNCIO
+#define GUARD_AMDINFER_BINDINGS_PYTHON_HELPERS_ASYNCIO
+
+#include <pybind11/pybind11.h>
+
+#include <memory>   // for shared_ptr, make_shared
+#include <string>   // for string
+#include <utility>  // for move
+
+#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+
+namespace amdinfer {
+
+namespace detail {
+
+/**
+ * @brief The asyncio future of a request in flight and the event loop that it
+ * belongs to. The first client thread to see the response may also be the last
+ * to hold this so the Python objects are released with the GIL held.
+ */
+struct PendingFuture {
+  PendingFuture(pybind11::object loop, pybind11::object future)
+    : loop(std::move(loop)), future(std::move(future)) {}
+  PendingFuture(const PendingFuture&) = delete;
+  PendingFuture& operator=(const PendingFuture&) = delete;
+  PendingFuture(PendingFuture&&) = delete;
+  PendingFuture& operator=(PendingFuture&&) = delete;
+  ~PendingFuture() {
+    pybind11::gil_scoped_acquire gil;
+    loop = pybind11::object{};
+    future = pybind11::object{};
+  }
+
+  pybind11::object loop;
+  pybind11::object future;
+};
+
+/// Set the future's result in its event loop unless it's been cancelled
+inline void resolveFuture(const PendingFuture& pending,
+                          const InferenceResponse& response) {
+  pybind11::gil_scoped_acquire gil;
+  try {
+    auto set_result = pybind11::cpp_function(
+      [](const pybind11::object& future, const pybind11::object& result) {
+        if (!future.attr("done")().cast<bool>()) {
+          future.attr("set_result")(result);
+        }
+      });
+    pending.loop.attr("call_soon_threadsafe")(set_result, pending.future,
+                                              pybind11::cast(response));
+  } catch (const pybind11::error_already_set&) {
+    // the loop is closed so nobody is waiting for the response
+  }
+}
+
+}  // namespace detail
+
+/**
+ * @brief Makes an inference request with the client's callback overload of
+ * modelInferAsync and returns an asyncio future for its response. It must be
+ * called from a coroutine in the running event loop. The GIL is released while
+ * the request is sent and the client's thread that gets the response hands it
+ * to the event loop so the loop's thread never blocks on the request.
+ *
+ * @tparam ClientType a client with a callback overload of modelInferAsync
+ * @param client the client to make the request with
+ * @param model name of the model/worker to request inference to
+ * @param request the request
+ * @return pybind11::object - an asyncio.Future of the InferenceResponse
+ */
+template <typename ClientType>
+pybind11::object modelInferAsyncio(const ClientType& client,
+                                   const std::string& model,
+                                   const InferenceRequest& request) {
+  auto loop = pybind11::module_::import("asyncio").attr("get_running_loop")();
+  auto future = loop.attr("create_future")();
+  auto pending = std::make_shared<detail::PendingFuture>(loop, future);
+
+  {
+    pybind11::gil_scoped_release release;
+    client.modelInferAsync(
+      model, request, [pending](const InferenceResponse& response) {
+        detail::resolveFuture(*pending, response);
+      });
+  }
+  return future;
+}
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_BINDINGS_PYTHON_HELPERS_ASYNCIO
@@ -0,0 +1,35 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the call guard for bound methods that block
+ */
+
+#ifndef GUARD_AMDINFER_BINDINGS_PYTHON_HELPERS_RELEASE_GIL
+#define GUARD_AMDINFER_BINDINGS_PYTHON_HELPERS_RELEASE_GIL
+
+#include <pybind11/pybind11.h>
+
+namespace amdinfer {
+
+// Methods that wait on the network or the server release the GIL while they
+// wait so other Python threads can run. The arguments are converted before it
+// is released and the return value after it is taken back so the method must
+// not touch Python objects itself
+using ReleaseGil = pybind11::call_guard<pybind11::gil_scoped_release>;
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_BINDINGS_PYTHON_HELPERS_RELEASE_GIL
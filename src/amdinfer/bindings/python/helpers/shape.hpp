@@ -0,0 +1,39 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Converts shapes to and from Python lists
+ */
+
+#ifndef GUARD_AMDINFER_BINDINGS_PYTHON_HELPERS_SHAPE
+#define GUARD_AMDINFER_BINDINGS_PYTHON_HELPERS_SHAPE
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include <cstdint>  // for uint64_t
+
+#include "amdinfer/core/shape.hpp"  // for Shape
+
+namespace pybind11::detail {
+
+/// Shapes are lists of ints in Python, like the vectors they replaced
+template <>
+struct type_caster<amdinfer::Shape>
+  : list_caster<amdinfer::Shape, uint64_t> {};
+
+}  // namespace pybind11::detail
+
+#endif  // GUARD_AMDINFER_BINDINGS_PYTHON_HELPERS_SHAPE
@@ -25,6 +25,7 @@
 #include <pybind11/stl.h>       // IWYU pragma: keep
 
 #include <array>    // for array
+#include <cstddef>  // for size_t
 #include <cstdint>  // for int8_t
 #include <opencv2/core.hpp>
 #include <string>  // for string
@@ -65,9 +66,28 @@ void addPreprocessOptions(const py::module& m, const char* name) {
 
 template <typename T>
 auto imagePreprocess(const std::vector<std::string>& paths,
-                     const ImagePreprocessOptions<T>& options) {
-  auto images = pre_post::imagePreprocess(paths, options);
-  py::array_t<T> ret = py::cast(images);
+                     const ImagePreprocessOptions<T>& options, size_t threads) {
+  if (!options.resize) {
+    // the images may have different sizes so each gets its own buffer
+    std::vector<std::vector<T>> images;
+    {
+      py::gil_scoped_release release;
+      images = pre_post::imagePreprocess(paths, options, threads);
+    }
+    py::array_t<T> ret = py::cast(images);
+    return ret;
+  }
+
+  // all the images have the same size so they're written straight into the
+  // returned array
+  const auto size = static_cast<py::ssize_t>(options.height) * options.width *
+                    options.channels;
+  py::array_t<T> ret({static_cast<py::ssize_t>(paths.size()), size});
+  auto* data = ret.mutable_data();
+  {
+    py::gil_scoped_release release;
+    pre_post::imagePreprocess(paths, options, data, threads);
+  }
   return ret;
 }
 
@@ -97,9 +117,9 @@ void wrapPrePost(py::module_& m) {
   addPreprocessOptions<float>(m, "ImagePreprocessOptionsFloat");
 
   m.def("imagePreprocessInt8", &imagePreprocess<int8_t>, py::arg("paths"),
-        py::arg("options"));
+        py::arg("options"), py::arg("threads") = 0);
   m.def("imagePreprocessFloat", &imagePreprocess<float>, py::arg("paths"),
-        py::arg("options"));
+        py::arg("options"), py::arg("threads") = 0);
 }
 
 }  // namespace amdinfer
@@ -21,30 +21,124 @@
 #include "amdinfer/servers/server.hpp"
 
 #include <pybind11/cast.h>            // for arg
+#include <pybind11/chrono.h>          // IWYU pragma: keep
 #include <pybind11/pybind11.h>        // for class_, init
 #include <pybind11/stl.h>             // IWYU pragma: keep
 #include <pybind11/stl/filesystem.h>  // IWYU pragma: keep
 
 #include "amdinfer/bindings/python/helpers/docstrings.hpp"
+#include "amdinfer/bindings/python/helpers/release_gil.hpp"
 
 namespace py = pybind11;
 
 namespace amdinfer {
 
 void wrapServer(py::module_ &m) {
+  py::class_<HttpServerOptions>(m, "HttpServerOptions")
+    .def(py::init<>(), DOCS(HttpServerOptions))
+    .def_readwrite("threads", &HttpServerOptions::threads,
+                   DOCS(HttpServerOptions, threads))
+    .def_readwrite("max_body_size", &HttpServerOptions::max_body_size,
+                   DOCS(HttpServerOptions, max_body_size))
+    .def_readwrite("debug_endpoints", &HttpServerOptions::debug_endpoints,
+                   DOCS(HttpServerOptions, debug_endpoints))
+    .def_readwrite("compression", &HttpServerOptions::compression,
+                   DOCS(HttpServerOptions, compression))
+    .def_readwrite("idle_connection_timeout",
+                   &HttpServerOptions::idle_connection_timeout,
+                   DOCS(HttpServerOptions, idle_connection_timeout))
+    .def_readwrite("keepalive_requests", &HttpServerOptions::keepalive_requests,
+                   DOCS(HttpServerOptions, keepalive_requests))
+    .def_readwrite("pipelining_requests",
+                   &HttpServerOptions::pipelining_requests,
+                   DOCS(HttpServerOptions, pipelining_requests))
+    .def_readwrite("max_connections", &HttpServerOptions::max_connections,
+                   DOCS(HttpServerOptions, max_connections))
+    .def_readwrite("max_connections_per_ip",
+                   &HttpServerOptions::max_connections_per_ip,
+                   DOCS(HttpServerOptions, max_connections_per_ip))
+    .def_readwrite("cors", &HttpServerOptions::cors,
+                   DOCS(HttpServerOptions, cors));
+
+  py::class_<GrpcServerOptions>(m, "GrpcServerOptions")
+    .def(py::init<>(), DOCS(GrpcServerOptions))
+    .def_readwrite("completion_queues", &GrpcServerOptions::completion_queues,
+                   DOCS(GrpcServerOptions, completion_queues))
+    .def_readwrite("threads_per_queue", &GrpcServerOptions::threads_per_queue,
+                   DOCS(GrpcServerOptions, threads_per_queue))
+    .def_readwrite("infer_slots", &GrpcServerOptions::infer_slots,
+                   DOCS(GrpcServerOptions, infer_slots))
+    .def_readwrite("callback_api", &GrpcServerOptions::callback_api,
+                   DOCS(GrpcServerOptions, callback_api))
+    .def_readwrite("request_threads", &GrpcServerOptions::request_threads,
+                   DOCS(GrpcServerOptions, request_threads))
+    .def_readwrite("max_message_size", &GrpcServerOptions::max_message_size,
+                   DOCS(GrpcServerOptions, max_message_size))
+    .def_readwrite("compression", &GrpcServerOptions::compression,
+                   DOCS(GrpcServerOptions, compression))
+    .def_readwrite("unix_socket", &GrpcServerOptions::unix_socket,
+                   DOCS(GrpcServerOptions, unix_socket))
+    .def_readwrite("tcp", &GrpcServerOptions::tcp,
+                   DOCS(GrpcServerOptions, tcp));
+
+  py::class_<SocketServerOptions>(m, "SocketServerOptions")
+    .def(py::init<>(), DOCS(SocketServerOptions))
+    .def_readwrite("max_message_size", &SocketServerOptions::max_message_size,
+                   DOCS(SocketServerOptions, max_message_size))
+    .def_readwrite("tcp_nodelay", &SocketServerOptions::tcp_nodelay,
+                   DOCS(SocketServerOptions, tcp_nodelay));
+
+  py::class_<AdminServerOptions>(m, "AdminServerOptions")
+    .def(py::init<>(), DOCS(AdminServerOptions))
+    .def_readwrite("debug_endpoints", &AdminServerOptions::debug_endpoints,
+                   DOCS(AdminServerOptions, debug_endpoints));
+
+  py::class_<RepositoryOptions>(m, "RepositoryOptions")
+    .def(py::init<>(), DOCS(RepositoryOptions))
+    .def_readwrite("load_threads", &RepositoryOptions::load_threads,
+                   DOCS(RepositoryOptions, load_threads))
+    .def_readwrite("device_loads", &RepositoryOptions::device_loads,
+                   DOCS(RepositoryOptions, device_loads))
+    .def_readwrite("lazy_load", &RepositoryOptions::lazy_load,
+                   DOCS(RepositoryOptions, lazy_load))
+    .def_readwrite("memory_budgets", &RepositoryOptions::memory_budgets,
+                   DOCS(RepositoryOptions, memory_budgets))
+    .def_readwrite("cache_directory", &RepositoryOptions::cache_directory,
+                   DOCS(RepositoryOptions, cache_directory))
+    .def_readwrite("download_threads", &RepositoryOptions::download_threads,
+                   DOCS(RepositoryOptions, download_threads));
+
   py::class_<Server>(m, "Server")
     .def(py::init<>(), DOCS(Server, Server))
     .def("startHttp", &Server::startHttp, py::arg("port"),
+         py::arg("options") = HttpServerOptions{}, ReleaseGil(),
          DOCS(Server, startHttp))
-    .def("stopHttp", &Server::stopHttp, DOCS(Server, stopHttp))
+    .def("stopHttp", &Server::stopHttp, ReleaseGil(), DOCS(Server, stopHttp))
     .def("startGrpc", &Server::startGrpc, py::arg("port"),
+         py::arg("options") = GrpcServerOptions{}, ReleaseGil(),
          DOCS(Server, startGrpc))
-    .def("stopGrpc", &Server::stopGrpc, DOCS(Server, stopGrpc))
+    .def("stopGrpc", &Server::stopGrpc, ReleaseGil(), DOCS(Server, stopGrpc))
+    .def("startSocket", &Server::startSocket, py::arg("port"),
+         py::arg("options") = SocketServerOptions{}, ReleaseGil(),
+         DOCS(Server, startSocket))
+    .def("stopSocket", &Server::stopSocket, ReleaseGil(),
+         DOCS(Server, stopSocket))
+    .def("startAdmin", &Server::startAdmin, py::arg("port"),
+         py::arg("options") = AdminServerOptions{}, ReleaseGil(),
+         DOCS(Server, startAdmin))
+    .def("stopAdmin", &Server::stopAdmin, ReleaseGil(),
+         DOCS(Server, stopAdmin))
+    .def("setScrapeInterval", &Server::setScrapeInterval, py::arg("interval"),
+         DOCS(Server, setScrapeInterval))
     .def("setModelRepository", &Server::setModelRepository,
          py::arg("repository_path"), py::arg("load_existing"),
+         py::arg("options") = RepositoryOptions{}, ReleaseGil(),
          DOCS(Server, setModelRepository))
     .def("enableRepositoryMonitoring", &Server::enableRepositoryMonitoring,
-         py::arg("use_polling"), DOCS(Server, enableRepositoryMonitoring));
+         py::arg("use_polling"), ReleaseGil(),
+         DOCS(Server, enableRepositoryMonitoring))
+    .def("expectModelRepository", &Server::expectModelRepository,
+         DOCS(Server, expectModelRepository));
 }
 
 }  // namespace amdinfer
@@ -196,6 +196,8 @@ def _get_data(request_input: InferenceRequestInput):
         return request_input.getInt64Data()
     if datatype == DataType.FP16:
         return request_input.getFp16Data()
+    if datatype == DataType.BF16:
+        return request_input.getBf16Data()
     if datatype == DataType.FP32:
         return request_input.getFp32Data()
     if datatype == DataType.FP64:
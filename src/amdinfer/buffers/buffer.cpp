@@ -24,13 +24,21 @@
 
 namespace amdinfer {
 
-Buffer::Buffer(MemoryAllocators allocator) : allocator_(allocator) {}
+Buffer::Buffer(MemoryAllocators allocator, size_t size)
+  : allocator_(allocator), size_(size) {}
 
-size_t Buffer::write(void* data, size_t offset, size_t size) {
+size_t Buffer::write(const void* data, size_t offset, size_t size) {
   std::memcpy(this->data(offset), data, size);
   return offset + size;
 }
 
+size_t Buffer::read(void* data, size_t offset, size_t size) {
+  std::memcpy(data, this->data(offset), size);
+  return offset + size;
+}
+
 MemoryAllocators Buffer::getAllocator() const { return allocator_; }
 
+size_t Buffer::size() const { return size_; }
+
 }  // namespace amdinfer
@@ -22,11 +22,14 @@
 #ifndef GUARD_AMDINFER_BUFFERS_BUFFER
 #define GUARD_AMDINFER_BUFFERS_BUFFER
 
+#include <array>    // for array
 #include <cstddef>  // for size_t, byte
 #include <cstring>  // for memcpy
 #include <string>   // for string
 
+#include "amdinfer/core/bytes_tensor.hpp"  // for encodeBytesElement, ...
 #include "amdinfer/core/memory_pool/memory_allocator.hpp"
+#include "amdinfer/util/convert.hpp"  // for convert, kConvertChunkSize
 
 // IWYU is creating a cycle with adding/removing this header
 // IWYU pragma: no_include <algorithm>
@@ -39,7 +42,13 @@ namespace amdinfer {
  */
 class Buffer {
  public:
-  explicit Buffer(MemoryAllocators allocator);
+  /**
+   * @brief Construct a new Buffer object
+   *
+   * @param allocator the allocator that owns this buffer's memory
+   * @param size size of the buffer in bytes. Use zero if it's unknown
+   */
+  explicit Buffer(MemoryAllocators allocator, size_t size = 0);
 
   /// Destroy the Buffer object
   virtual ~Buffer() = default;
@@ -63,7 +72,18 @@ class Buffer {
    * @param size size of the data to write in bytes
    * @return size_t number of bytes actually written
    */
-  virtual size_t write(void* data, size_t offset, size_t size);
+  virtual size_t write(const void* data, size_t offset, size_t size);
+
+  /**
+   * @brief Read data from this buffer into an address. Buffers whose memory
+   * isn't on the host override this and write() to copy it.
+   *
+   * @param data pointer to write the data to
+   * @param offset offset to start reading the data from
+   * @param size size of the data to read in bytes
+   * @return size_t the offset after the data that was read
+   */
+  virtual size_t read(void* data, size_t offset, size_t size);
 
   /**
    * @brief Write a value to the buffer
@@ -91,10 +111,80 @@ class Buffer {
     }
   }
 
+  /**
+   * @brief Write an array of elements to the buffer as type T, converting them
+   * if they're another type. Elements of the same type are written with one
+   * call to write() and others are converted on the stack in chunks so the
+   * cost of write() is paid per chunk rather than per element.
+   *
+   * @tparam T type of the elements in the buffer
+   * @tparam From type of the elements to write
+   * @param data elements to write
+   * @param offset offset to start writing the data
+   * @param count number of elements
+   * @return size_t the offset after the written data
+   */
+  template <typename T, typename From>
+  size_t writeAs(const From* data, size_t offset, size_t count) {
+    if constexpr (std::is_same_v<T, From>) {
+      return this->write(static_cast<const void*>(data), offset,
+                         count * sizeof(T));
+    } else {
+      std::array<T, util::kConvertChunkSize> chunk;
+      for (size_t i = 0; i < count; i += chunk.size()) {
+        const auto size =
+          count - i < chunk.size() ? count - i : chunk.size();
+        util::convert(data + i, size, chunk.data());
+        offset = this->write(static_cast<const void*>(chunk.data()), offset,
+                             size * sizeof(T));
+      }
+      return offset;
+    }
+  }
+
+  /**
+   * @brief Write elements to the buffer in the layout of a BYTES tensor. Short
+   * elements are gathered in a chunk on the stack so the cost of write() is
+   * paid per chunk rather than per element.
+   *
+   * @tparam Elements a container of strings or string views
+   * @param elements the elements to write
+   * @param offset offset to start writing the data
+   * @return size_t the offset after the written data
+   */
+  template <typename Elements>
+  size_t writeBytes(const Elements& elements, size_t offset) {
+    std::array<std::byte, util::kConvertChunkSize * sizeof(float)> chunk;
+    size_t used = 0;
+    for (const auto& element : elements) {
+      const auto size = kBytesLengthSize + element.size();
+      if (used + size > chunk.size() && used > 0) {
+        offset = this->write(chunk.data(), offset, used);
+        used = 0;
+      }
+      if (size > chunk.size()) {
+        // long elements are written from where they are after their length
+        encodeBytesLength(element.size(), chunk.data());
+        offset = this->write(chunk.data(), offset, kBytesLengthSize);
+        offset = this->write(element.data(), offset, element.size());
+        continue;
+      }
+      encodeBytesElement(element, chunk.data() + used);
+      used += size;
+    }
+    if (used > 0) {
+      offset = this->write(chunk.data(), offset, used);
+    }
+    return offset;
+  }
+
   MemoryAllocators getAllocator() const;
+  /// Get the size of the buffer in bytes. It's zero if the size is unknown
+  [[nodiscard]] size_t size() const;
 
  private:
   MemoryAllocators allocator_;
+  size_t size_;
 };
 
 }  // namespace amdinfer
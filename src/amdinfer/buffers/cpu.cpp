@@ -25,8 +25,8 @@
 
 namespace amdinfer {
 
-CpuBuffer::CpuBuffer(void* data, MemoryAllocators allocator)
-  : Buffer(allocator), data_(static_cast<std::byte*>(data)) {}
+CpuBuffer::CpuBuffer(void* data, MemoryAllocators allocator, size_t size)
+  : Buffer(allocator, size), data_(static_cast<std::byte*>(data)) {}
 
 void* CpuBuffer::data(size_t offset) { return data_ + offset; }
 
@@ -38,12 +38,13 @@ enum class MemoryAllocators;
 class CpuBuffer : public Buffer {
  public:
   /**
-   * @brief Construct a new Vector Buffer object
+   * @brief Construct a new CpuBuffer object
    *
-   * @param elements number of elements to store
-   * @param data_type type of element to store
+   * @param data pointer to the memory
+   * @param allocator the allocator that owns the memory
+   * @param size size of the memory in bytes. Use zero if it's unknown
    */
-  CpuBuffer(void* data, MemoryAllocators allocator);
+  CpuBuffer(void* data, MemoryAllocators allocator, size_t size = 0);
 
   /**
    * @brief Returns a pointer to the underlying data
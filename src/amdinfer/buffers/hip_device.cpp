@@ -0,0 +1,65 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the HipDeviceBuffer class
+ */
+
+#include "amdinfer/buffers/hip_device.hpp"
+
+#include <hip/hip_runtime_api.h>  // for hipMemcpy, hipGetErrorString
+
+#include <string>  // for string, operator+
+
+#include "amdinfer/core/exceptions.hpp"  // for external_error
+
+namespace amdinfer {
+
+namespace {
+
+/// Throw an exception if a HIP call failed
+void checkHip(hipError_t status, const std::string& action) {
+  if (status != hipSuccess) {
+    throw external_error("Failed to " + action + ": " +
+                         hipGetErrorString(status));
+  }
+}
+
+}  // namespace
+
+HipDeviceBuffer::HipDeviceBuffer(std::byte* address, size_t size, int device)
+  : Buffer(MemoryAllocators::HipDevice, size),
+    data_(address),
+    device_(device) {}
+
+void* HipDeviceBuffer::data(size_t offset) { return data_ + offset; }
+
+// the other side may also be on a GPU, such as another device buffer, so HIP
+// works out the direction of the copies
+size_t HipDeviceBuffer::write(const void* data, size_t offset, size_t size) {
+  checkHip(hipMemcpy(data_ + offset, data, size, hipMemcpyDefault),
+           "copy to the GPU");
+  return offset + size;
+}
+
+size_t HipDeviceBuffer::read(void* data, size_t offset, size_t size) {
+  checkHip(hipMemcpy(data, data_ + offset, size, hipMemcpyDefault),
+           "copy from the GPU");
+  return offset + size;
+}
+
+int HipDeviceBuffer::getDevice() const { return device_; }
+
+}  // namespace amdinfer
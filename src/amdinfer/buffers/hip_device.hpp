@@ -0,0 +1,65 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the HipDeviceBuffer class
+ */
+
+#ifndef GUARD_AMDINFER_BUFFERS_HIP_DEVICE
+#define GUARD_AMDINFER_BUFFERS_HIP_DEVICE
+
+#include <cstddef>  // for size_t, byte
+
+#include "amdinfer/buffers/buffer.hpp"  // IWYU pragma: export
+
+namespace amdinfer {
+
+/**
+ * @brief HipDeviceBuffer is a view of GPU memory that's owned by the memory
+ * pool's HIP device allocator. Workers on the same GPU can use it in place and
+ * reads and writes from the host are copies.
+ */
+class HipDeviceBuffer : public Buffer {
+ public:
+  /**
+   * @brief Construct a new HipDeviceBuffer object
+   *
+   * @param address device pointer to the start of the buffer
+   * @param size size of the buffer in bytes
+   * @param device index of the GPU the memory is on
+   */
+  HipDeviceBuffer(std::byte* address, size_t size, int device);
+
+  /**
+   * @brief Returns a device pointer to the underlying data
+   *
+   * @return void*
+   */
+  void* data(size_t offset) override;
+
+  size_t write(const void* data, size_t offset, size_t size) override;
+  size_t read(void* data, size_t offset, size_t size) override;
+
+  /// Get the index of the GPU the memory is on
+  [[nodiscard]] int getDevice() const;
+
+ private:
+  std::byte* data_;
+  int device_;
+};
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_BUFFERS_HIP_DEVICE
@@ -0,0 +1,115 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the HipSharedMemoryBuffer class
+ */
+
+#include "amdinfer/buffers/hip_shared_memory.hpp"
+
+#include <hip/hip_runtime_api.h>  // for hipIpcOpenMemHandle, hipMemcpy
+
+#include <cstring>  // for memcpy
+#include <string>   // for string, to_string
+
+#include "amdinfer/core/exceptions.hpp"  // for invalid_argument, external_error
+
+namespace amdinfer {
+
+namespace {
+
+/// Throw an exception if a HIP call failed
+void checkHip(hipError_t status, const std::string& action) {
+  if (status != hipSuccess) {
+    throw external_error("Failed to " + action + ": " +
+                         hipGetErrorString(status));
+  }
+}
+
+}  // namespace
+
+HipSharedMemoryBuffer::HipSharedMemoryBuffer(const std::string& handle,
+                                             int device, size_t offset,
+                                             size_t size)
+  : Buffer(MemoryAllocators::HipSharedMemory, size), device_(device) {
+  if (size == 0) {
+    throw invalid_argument("GPU shared memory region is empty");
+  }
+  hipIpcMemHandle_t ipc_handle;
+  if (handle.size() != sizeof(ipc_handle)) {
+    throw invalid_argument("HIP IPC handles have " +
+                           std::to_string(sizeof(ipc_handle)) +
+                           " bytes, got " + std::to_string(handle.size()));
+  }
+  std::memcpy(&ipc_handle, handle.data(), sizeof(ipc_handle));
+
+  int devices = 0;
+  if (hipGetDeviceCount(&devices) != hipSuccess || device < 0 ||
+      device >= devices) {
+    throw invalid_argument("GPU " + std::to_string(device) +
+                           " does not exist");
+  }
+  // the memory is opened in the context of its own device and the caller's
+  // device is restored afterwards
+  int current = 0;
+  checkHip(hipGetDevice(&current), "get the current GPU");
+  checkHip(hipSetDevice(device), "use GPU " + std::to_string(device));
+  const auto status = hipIpcOpenMemHandle(&base_, ipc_handle,
+                                          hipIpcMemLazyEnablePeerAccess);
+  if (status != hipSuccess) {
+    (void)hipSetDevice(current);
+    throw invalid_argument(std::string{"Could not open the HIP IPC handle: "} +
+                           hipGetErrorString(status));
+  }
+  // the handle is for the start of the allocation so its size bounds the
+  // region
+  hipDeviceptr_t allocation = nullptr;
+  size_t allocation_size = 0;
+  const auto range =
+    hipMemGetAddressRange(&allocation, &allocation_size, base_);
+  (void)hipSetDevice(current);
+  if (range == hipSuccess &&
+      (offset > allocation_size || size > allocation_size - offset)) {
+    (void)hipIpcCloseMemHandle(base_);
+    throw invalid_argument("GPU memory of the HIP IPC handle has " +
+                           std::to_string(allocation_size) +
+                           " bytes, which is smaller than the region");
+  }
+  data_ = static_cast<std::byte*>(base_) + offset;
+}
+
+HipSharedMemoryBuffer::~HipSharedMemoryBuffer() {
+  (void)hipIpcCloseMemHandle(base_);
+}
+
+void* HipSharedMemoryBuffer::data(size_t offset) { return data_ + offset; }
+
+// the data may already be on a GPU, such as an output in device memory
+size_t HipSharedMemoryBuffer::write(const void* data, size_t offset,
+                                    size_t size) {
+  checkHip(hipMemcpy(data_ + offset, data, size, hipMemcpyDefault),
+           "copy to the GPU");
+  return offset + size;
+}
+
+size_t HipSharedMemoryBuffer::read(void* data, size_t offset, size_t size) {
+  checkHip(hipMemcpy(data, data_ + offset, size, hipMemcpyDeviceToHost),
+           "copy from the GPU");
+  return offset + size;
+}
+
+int HipSharedMemoryBuffer::getDevice() const { return device_; }
+
+}  // namespace amdinfer
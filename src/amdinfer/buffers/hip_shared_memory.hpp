@@ -0,0 +1,77 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the HipSharedMemoryBuffer class
+ */
+
+#ifndef GUARD_AMDINFER_BUFFERS_HIP_SHARED_MEMORY
+#define GUARD_AMDINFER_BUFFERS_HIP_SHARED_MEMORY
+
+#include <cstddef>  // for size_t, byte
+#include <string>   // for string
+
+#include "amdinfer/buffers/buffer.hpp"  // IWYU pragma: export
+
+namespace amdinfer {
+
+/**
+ * @brief HipSharedMemoryBuffer opens GPU memory that another process on the
+ * same host exported with hipIpcGetMemHandle. The memory stays on the device
+ * so workers that run on the same GPU can use it in place and reads and writes
+ * from the host are copies.
+ */
+class HipSharedMemoryBuffer : public Buffer {
+ public:
+  /**
+   * @brief Construct a new HipSharedMemoryBuffer object. It throws if the
+   * handle is malformed or can't be opened on the device.
+   *
+   * @param handle the bytes of the hipIpcMemHandle_t of the memory
+   * @param device index of the GPU the memory is on
+   * @param offset offset of the buffer in the allocation in bytes
+   * @param size size of the buffer in bytes
+   */
+  HipSharedMemoryBuffer(const std::string& handle, int device, size_t offset,
+                        size_t size);
+  HipSharedMemoryBuffer(const HipSharedMemoryBuffer&) = delete;
+  HipSharedMemoryBuffer& operator=(const HipSharedMemoryBuffer&) = delete;
+  HipSharedMemoryBuffer(HipSharedMemoryBuffer&&) = delete;
+  HipSharedMemoryBuffer& operator=(HipSharedMemoryBuffer&&) = delete;
+  ~HipSharedMemoryBuffer() override;
+
+  /**
+   * @brief Returns a device pointer to the underlying data
+   *
+   * @return void*
+   */
+  void* data(size_t offset) override;
+
+  size_t write(const void* data, size_t offset, size_t size) override;
+  size_t read(void* data, size_t offset, size_t size) override;
+
+  /// Get the index of the GPU the memory is on
+  [[nodiscard]] int getDevice() const;
+
+ private:
+  /// start of the allocation, which the buffer may be offset from
+  void* base_ = nullptr;
+  std::byte* data_ = nullptr;
+  int device_;
+};
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_BUFFERS_HIP_SHARED_MEMORY
@@ -0,0 +1,79 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the SharedMemoryBuffer class
+ */
+
+#include "amdinfer/buffers/shared_memory.hpp"
+
+#include <fcntl.h>     // for O_RDWR
+#include <sys/mman.h>  // for mmap, munmap, shm_open
+#include <sys/stat.h>  // for fstat, stat
+#include <unistd.h>    // for close, sysconf
+
+#include <cerrno>   // for errno
+#include <cstring>  // for strerror
+
+#include "amdinfer/core/exceptions.hpp"  // for invalid_argument, runtime_error
+
+namespace amdinfer {
+
+SharedMemoryBuffer::SharedMemoryBuffer(const std::string& key, size_t offset,
+                                       size_t size)
+  : Buffer(MemoryAllocators::SharedMemory, size) {
+  if (size == 0) {
+    throw invalid_argument("Shared memory region of " + key + " is empty");
+  }
+
+  const int fd = shm_open(key.c_str(), O_RDWR, 0);
+  if (fd == -1) {
+    throw invalid_argument("Could not open shared memory " + key + ": " +
+                           std::strerror(errno));
+  }
+
+  // the region is checked without adding offset and size, which may overflow
+  struct stat info {};
+  const auto object_size = fstat(fd, &info) == -1
+                             ? size_t{0}
+                             : static_cast<size_t>(info.st_size);
+  if (offset > object_size || size > object_size - offset) {
+    close(fd);
+    throw invalid_argument("Shared memory " + key +
+                           " is smaller than the region");
+  }
+
+  // mmap needs a page-aligned offset so the mapping starts at the page that
+  // holds the start of the region
+  const auto page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  const auto page_offset = offset % page_size;
+  mapping_size_ = page_offset + size;
+  mapping_ = mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE, MAP_SHARED,
+                  fd, static_cast<off_t>(offset - page_offset));
+  const auto error = errno;
+  // the mapping stays valid after the descriptor is closed
+  close(fd);
+  if (mapping_ == MAP_FAILED) {
+    throw runtime_error("Could not map shared memory " + key + ": " +
+                        std::strerror(error));
+  }
+  data_ = static_cast<std::byte*>(mapping_) + page_offset;
+}
+
+SharedMemoryBuffer::~SharedMemoryBuffer() { munmap(mapping_, mapping_size_); }
+
+void* SharedMemoryBuffer::data(size_t offset) { return data_ + offset; }
+
+}  // namespace amdinfer
@@ -0,0 +1,68 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the SharedMemoryBuffer class
+ */
+
+#ifndef GUARD_AMDINFER_BUFFERS_SHARED_MEMORY
+#define GUARD_AMDINFER_BUFFERS_SHARED_MEMORY
+
+#include <cstddef>  // for size_t, byte
+#include <string>   // for string
+
+#include "amdinfer/buffers/buffer.hpp"  // IWYU pragma: export
+
+namespace amdinfer {
+
+/**
+ * @brief SharedMemoryBuffer maps a region of a POSIX shared memory object that
+ * another process on the same host created. The buffer reads and writes the
+ * shared memory in place and unmaps it when it's destroyed.
+ */
+class SharedMemoryBuffer : public Buffer {
+ public:
+  /**
+   * @brief Construct a new SharedMemoryBuffer object. It throws if the object
+   * can't be opened or is smaller than the region.
+   *
+   * @param key name of the shared memory object, as passed to shm_open
+   * @param offset offset of the region in the object in bytes
+   * @param size size of the region in bytes
+   */
+  SharedMemoryBuffer(const std::string& key, size_t offset, size_t size);
+  SharedMemoryBuffer(const SharedMemoryBuffer&) = delete;
+  SharedMemoryBuffer& operator=(const SharedMemoryBuffer&) = delete;
+  SharedMemoryBuffer(SharedMemoryBuffer&&) = delete;
+  SharedMemoryBuffer& operator=(SharedMemoryBuffer&&) = delete;
+  ~SharedMemoryBuffer() override;
+
+  /**
+   * @brief Returns a pointer to the underlying data
+   *
+   * @return void*
+   */
+  void* data(size_t offset) override;
+
+ private:
+  /// start of the mapping, which is page aligned so it may precede the region
+  void* mapping_;
+  size_t mapping_size_;
+  std::byte* data_;
+};
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_BUFFERS_SHARED_MEMORY
@@ -0,0 +1,42 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the XrtBoBuffer class
+ */
+
+#include "amdinfer/buffers/xrt_bo.hpp"
+
+#include <xrt/xrt_bo.h>  // for bo, XCL_BO_SYNC_BO_TO_DEVICE
+
+namespace amdinfer {
+
+XrtBoBuffer::XrtBoBuffer(vart::TensorBuffer* tensor_buffer, xrt::bo* bo,
+                         std::byte* data)
+  : VartTensorBuffer(tensor_buffer, MemoryAllocators::XrtBo),
+    bo_(bo),
+    data_(data) {}
+
+void* XrtBoBuffer::data(size_t offset) { return data_ + offset; }
+
+void XrtBoBuffer::syncToDevice(size_t size) {
+  bo_->sync(XCL_BO_SYNC_BO_TO_DEVICE, size, 0);
+}
+
+void XrtBoBuffer::syncFromDevice(size_t size) {
+  bo_->sync(XCL_BO_SYNC_BO_FROM_DEVICE, size, 0);
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,70 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the XrtBoBuffer class
+ */
+
+#ifndef GUARD_AMDINFER_BUFFERS_XRT_BO
+#define GUARD_AMDINFER_BUFFERS_XRT_BO
+
+#include <cstddef>  // for size_t, byte
+
+#include "amdinfer/buffers/vart_tensor.hpp"  // IWYU pragma: export
+
+namespace xrt {
+class bo;
+}  // namespace xrt
+
+namespace amdinfer {
+
+/**
+ * @brief XrtBoBuffer is an XRT buffer object in the FPGA's memory that's
+ * mapped into the host. The host reads and writes the mapping and its tensor
+ * buffer points the DPU runners at the device memory so running a batch
+ * doesn't copy it again. The mapping and the device are only made consistent
+ * by syncing them.
+ */
+class XrtBoBuffer : public VartTensorBuffer {
+ public:
+  /**
+   * @brief Construct a new XrtBoBuffer object
+   *
+   * @param tensor_buffer the device tensor buffer of the buffer object
+   * @param bo the buffer object, owned by its allocator
+   * @param data start of the buffer object's mapping in the host
+   */
+  XrtBoBuffer(vart::TensorBuffer* tensor_buffer, xrt::bo* bo, std::byte* data);
+
+  /**
+   * @brief Returns a pointer to the data in the mapping
+   *
+   * @return void*
+   */
+  void* data(size_t offset) override;
+
+  /// Copy the start of the mapping to the device
+  void syncToDevice(size_t size);
+  /// Copy the start of the device memory to the mapping
+  void syncFromDevice(size_t size);
+
+ private:
+  xrt::bo* bo_;
+  std::byte* data_;
+};
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_BUFFERS_XRT_BO
@@ -0,0 +1,217 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the methods for caching the metadata and readiness that
+ * another client gets from the server
+ */
+
+#include "amdinfer/clients/cached.hpp"
+
+#include <chrono>         // for steady_clock, milliseconds
+#include <memory>         // for unique_ptr, make_unique
+#include <mutex>          // for mutex, lock_guard
+#include <optional>       // for optional
+#include <string>         // for string
+#include <unordered_map>  // for unordered_map
+#include <utility>        // for move
+#include <vector>         // for vector
+
+#include "amdinfer/core/exceptions.hpp"          // for invalid_argument
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/core/model_metadata.hpp"      // for ModelMetadata
+#include "amdinfer/core/server_metadata.hpp"     // for ServerMetadata
+
+namespace amdinfer {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/// A cached result and when it stops being used
+template <typename T>
+struct Entry {
+  T value;
+  Clock::time_point expiry;
+};
+
+}  // namespace
+
+class CachedClient::CachedClientImpl {
+ public:
+  CachedClientImpl(std::unique_ptr<Client> client,
+                   std::chrono::milliseconds ttl)
+    : client_(std::move(client)), ttl_(ttl) {
+    if (client_ == nullptr) {
+      throw invalid_argument("A CachedClient needs a client to wrap");
+    }
+    if (ttl_.count() < 0) {
+      throw invalid_argument("A CachedClient's ttl can't be negative");
+    }
+  }
+
+  [[nodiscard]] Client* getClient() const { return client_.get(); }
+
+  ServerMetadata serverMetadata() {
+    {
+      std::lock_guard lock{mutex_};
+      if (server_.has_value() && Clock::now() < server_->expiry) {
+        return server_->value;
+      }
+    }
+    auto metadata = client_->serverMetadata();
+    std::lock_guard lock{mutex_};
+    server_ = Entry<ServerMetadata>{metadata, Clock::now() + ttl_};
+    return metadata;
+  }
+
+  bool modelReady(const std::string& model) {
+    {
+      std::lock_guard lock{mutex_};
+      if (auto iterator = ready_.find(model);
+          iterator != ready_.end() && Clock::now() < iterator->second) {
+        return true;
+      }
+    }
+    const auto ready = client_->modelReady(model);
+    // models that aren't ready are asked again so they're seen once they are
+    if (ready) {
+      std::lock_guard lock{mutex_};
+      ready_.insert_or_assign(model, Clock::now() + ttl_);
+    }
+    return ready;
+  }
+
+  ModelMetadata modelMetadata(const std::string& model) {
+    {
+      std::lock_guard lock{mutex_};
+      if (auto iterator = metadata_.find(model);
+          iterator != metadata_.end() &&
+          Clock::now() < iterator->second.expiry) {
+        return iterator->second.value;
+      }
+    }
+    auto metadata = client_->modelMetadata(model);
+    // the tensors of models that are loading aren't known yet
+    if (metadata.isReady()) {
+      std::lock_guard lock{mutex_};
+      metadata_.insert_or_assign(
+        model, Entry<ModelMetadata>{metadata, Clock::now() + ttl_});
+    }
+    return metadata;
+  }
+
+  void invalidate(const std::string& model) {
+    std::lock_guard lock{mutex_};
+    ready_.erase(model);
+    metadata_.erase(model);
+  }
+
+  void invalidate() {
+    std::lock_guard lock{mutex_};
+    server_.reset();
+    ready_.clear();
+    metadata_.clear();
+  }
+
+ private:
+  std::unique_ptr<Client> client_;
+  std::chrono::milliseconds ttl_;
+  std::mutex mutex_;
+  std::optional<Entry<ServerMetadata>> server_;
+  /// model -> when its readiness stops being used
+  std::unordered_map<std::string, Clock::time_point> ready_;
+  std::unordered_map<std::string, Entry<ModelMetadata>> metadata_;
+};
+
+CachedClient::CachedClient(std::unique_ptr<Client> client,
+                           std::chrono::milliseconds ttl)
+  : impl_(std::make_unique<CachedClientImpl>(std::move(client), ttl)) {}
+
+CachedClient::~CachedClient() = default;
+
+ServerMetadata CachedClient::serverMetadata() const {
+  return impl_->serverMetadata();
+}
+
+bool CachedClient::serverLive() const {
+  return impl_->getClient()->serverLive();
+}
+
+bool CachedClient::serverReady() const {
+  return impl_->getClient()->serverReady();
+}
+
+bool CachedClient::modelReady(const std::string& model) const {
+  return impl_->modelReady(model);
+}
+
+ModelMetadata CachedClient::modelMetadata(const std::string& model) const {
+  return impl_->modelMetadata(model);
+}
+
+void CachedClient::modelLoad(const std::string& model,
+                             const ParameterMap& parameters) const {
+  impl_->invalidate(model);
+  impl_->getClient()->modelLoad(model, parameters);
+  impl_->invalidate(model);
+}
+
+void CachedClient::modelUnload(const std::string& model) const {
+  impl_->invalidate(model);
+  impl_->getClient()->modelUnload(model);
+}
+
+InferenceResponse CachedClient::modelInfer(
+  const std::string& model, const InferenceRequest& request) const {
+  auto response = impl_->getClient()->modelInfer(model, request);
+  if (response.isError()) {
+    impl_->invalidate(model);
+  }
+  return response;
+}
+
+InferenceResponseFuture CachedClient::modelInferAsync(
+  const std::string& model, const InferenceRequest& request) const {
+  return impl_->getClient()->modelInferAsync(model, request);
+}
+
+std::vector<std::string> CachedClient::modelList() const {
+  return impl_->getClient()->modelList();
+}
+
+std::string CachedClient::workerLoad(const std::string& worker,
+                                     const ParameterMap& parameters) const {
+  auto endpoint = impl_->getClient()->workerLoad(worker, parameters);
+  impl_->invalidate(endpoint);
+  return endpoint;
+}
+
+void CachedClient::workerUnload(const std::string& worker) const {
+  impl_->invalidate(worker);
+  impl_->getClient()->workerUnload(worker);
+}
+
+bool CachedClient::hasHardware(const std::string& name, int num) const {
+  return impl_->getClient()->hasHardware(name, num);
+}
+
+void CachedClient::invalidate(const std::string& model) const {
+  impl_->invalidate(model);
+}
+
+void CachedClient::invalidate() const { impl_->invalidate(); }
+
+}  // namespace amdinfer
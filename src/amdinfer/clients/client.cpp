@@ -15,15 +15,16 @@
 
 #include "amdinfer/clients/client.hpp"
 
-#include <algorithm>      // for copy, copy_backward
+#include <algorithm>      // for min
 #include <chrono>         // for seconds
 #include <future>         // for future
 #include <queue>          // for queue
 #include <thread>         // for sleep_for
 #include <unordered_set>  // for operator!=, unordered_set
+#include <utility>        // for move
 
 #include "amdinfer/build_options.hpp"            // for AMDINFER_ENABLE_LOGGING
-#include "amdinfer/core/exceptions.hpp"          // for connection_error
+#include "amdinfer/core/exceptions.hpp"          // for connection_error, inv...
 #include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
 #include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
 #include "amdinfer/observation/logging.hpp"  // for getLogDirectory, initLogger
@@ -52,10 +53,15 @@ bool serverHasExtension(const Client* client, const std::string& extension) {
 }
 
 void waitUntilServerReady(const Client* client) {
+  // the server may take a while to load its repository so don't poll it hard
+  const std::chrono::milliseconds delay{100};
   bool ready = false;
   while (!ready) {
     try {
       ready = client->serverReady();
+      if (!ready) {
+        std::this_thread::sleep_for(delay);
+      }
     } catch (const amdinfer::connection_error&) {
       // ignore connection errors
       std::this_thread::sleep_for(std::chrono::seconds(1));
@@ -99,7 +105,7 @@ std::vector<InferenceResponse> inferAsyncOrderedBatched(
   std::queue<InferenceResponseFuture> q;
 
   while (start_index + batch_size < num_requests) {
-    for (auto i = start_index; i < batch_size; ++i) {
+    for (auto i = start_index; i < start_index + batch_size; ++i) {
       q.push(client->modelInferAsync(model, requests[i]));
     }
 
@@ -125,4 +131,43 @@ std::vector<InferenceResponse> inferAsyncOrderedBatched(
   return responses;
 }
 
+void inferAsyncOrderedWindowed(Client* client, const std::string& model,
+                               const std::vector<InferenceRequest>& requests,
+                               size_t window,
+                               const OrderedResponseCallback& callback) {
+  if (window == 0) {
+    throw invalid_argument("The window must hold at least one request");
+  }
+  const auto num_requests = requests.size();
+  std::queue<InferenceResponseFuture> q;
+  size_t sent = 0;
+  for (; sent < std::min(window, num_requests); ++sent) {
+    q.push(client->modelInferAsync(model, requests[sent]));
+  }
+
+  for (auto i = 0U; i < num_requests; ++i) {
+    auto response = q.front().get();
+    q.pop();
+    if (sent < num_requests) {
+      q.push(client->modelInferAsync(model, requests[sent]));
+      sent++;
+    }
+    callback(i, std::move(response));
+  }
+}
+
+std::vector<InferenceResponse> inferAsyncOrderedWindowed(
+  Client* client, const std::string& model,
+  const std::vector<InferenceRequest>& requests, size_t window) {
+  std::vector<InferenceResponse> responses;
+  responses.reserve(requests.size());
+  inferAsyncOrderedWindowed(
+    client, model, requests, window,
+    [&responses](size_t index, InferenceResponse response) {
+      (void)index;
+      responses.push_back(std::move(response));
+    });
+  return responses;
+}
+
 }  // namespace amdinfer
@@ -20,13 +20,19 @@
 
 #include "amdinfer/clients/grpc.hpp"
 
+#include <google/protobuf/message.h>             // for Message
 #include <google/protobuf/repeated_ptr_field.h>  // for RepeatedPtrField
 #include <grpcpp/grpcpp.h>                       // for Status, ClientContext
 
-#include <future>         // for __forced_unwind, async
+#include <atomic>         // for atomic
+#include <future>         // for promise, future
 #include <memory>         // for unique_ptr, shared_ptr
+#include <mutex>          // for call_once, once_flag
+#include <optional>       // for optional
 #include <string>         // for string
+#include <thread>         // for thread
 #include <unordered_set>  // for unordered_set
+#include <utility>        // for move
 #include <vector>         // for vector
 
 #include "amdinfer/clients/grpc_internal.hpp"    // for mapParametersToProto
@@ -37,6 +43,7 @@
 #include "amdinfer/core/parameters.hpp"          // for ParameterMap
 #include "amdinfer/declarations.hpp"             // for InferenceResponseFuture
 #include "amdinfer/observation/observer.hpp"     // for Logger, Observer
+#include "amdinfer/util/thread.hpp"              // for setThreadName
 #include "inference.grpc.pb.h"                   // for GRPCInferenceService...
 #include "inference.pb.h"                        // for ModelMetadataRespons...
 
@@ -45,24 +52,201 @@ using grpc::Status;
 
 namespace amdinfer {
 
+namespace {
+
+/// Compress the request, if it's large enough, when it's sent
+void compressRequest(ClientContext* context,
+                     const google::protobuf::Message& request,
+                     const CompressionOptions& compression) {
+  const auto algorithm =
+    getCompressionAlgorithm(compression, request.ByteSizeLong());
+  if (algorithm != GRPC_COMPRESS_NONE) {
+    context->set_compression_algorithm(algorithm);
+  }
+}
+
+/// An inference request that's in flight on a channel's completion queue
+struct AsyncCall {
+  ClientContext context;
+  inference::ModelInferResponse reply;
+  Status status;
+  std::unique_ptr<
+    ::grpc::ClientAsyncResponseReader<inference::ModelInferResponse>>
+    reader;
+  /// the response is given to the promise if there is one or else to the
+  /// callback
+  std::optional<std::promise<InferenceResponse>> promise;
+  Callback callback;
+};
+
+/// A channel to the server and the completion queue of its requests
+struct GrpcChannel {
+  std::unique_ptr<inference::GRPCInferenceService::Stub> stub;
+  ::grpc::CompletionQueue cq;
+  /// the poller is started with the first asynchronous request
+  std::once_flag poller_started;
+  std::thread poller;
+  /// asynchronous requests in flight on the channel
+  std::atomic<int> outstanding = 0;
+};
+
+}  // namespace
+
 class GrpcClient::GrpcClientImpl {
  public:
-  explicit GrpcClientImpl(const std::shared_ptr<::grpc::Channel>& channel) {
-    this->stub_ = inference::GRPCInferenceService::NewStub(channel);
+  GrpcClientImpl(const std::vector<std::shared_ptr<::grpc::Channel>>& channels,
+                 const CompressionOptions& compression)
+    : compression_(compression) {
+    channels_.reserve(channels.size());
+    for (const auto& channel : channels) {
+      auto& state = channels_.emplace_back(std::make_unique<GrpcChannel>());
+      state->stub = inference::GRPCInferenceService::NewStub(channel);
+    }
+    AMDINFER_IF_LOGGING(observer_.logger = Logger{Loggers::Client});
+  }
+  GrpcClientImpl(GrpcClientImpl const&) = delete;
+  GrpcClientImpl& operator=(const GrpcClientImpl&) = delete;
+  GrpcClientImpl(GrpcClientImpl&& other) = delete;
+  GrpcClientImpl& operator=(GrpcClientImpl&& other) = delete;
+  ~GrpcClientImpl() {
+    // the queues deliver the requests still in flight before they're drained
+    for (auto& channel : channels_) {
+      channel->cq.Shutdown();
+    }
+    for (auto& channel : channels_) {
+      if (channel->poller.joinable()) {
+        channel->poller.join();
+      }
+    }
+  }
+
+  /// Get the stub of the next channel for a synchronous request
+  inference::GRPCInferenceService::Stub* getStub() {
+    const auto index =
+      counter_.fetch_add(1, std::memory_order_relaxed) % channels_.size();
+    return channels_[index]->stub.get();
   }
 
-  inference::GRPCInferenceService::Stub* getStub() { return this->stub_.get(); }
+  const CompressionOptions& getCompression() const { return compression_; }
+
+  /// Send an inference request whose response is delivered by the poller
+  void submit(const std::string& model, const InferenceRequest& request,
+              std::unique_ptr<AsyncCall> call);
 
  private:
-  std::unique_ptr<inference::GRPCInferenceService::Stub> stub_;
+  /**
+   * @brief Get the channel with the fewest asynchronous requests in flight. The
+   * search starts from a different channel each time so ties are spread evenly
+   */
+  GrpcChannel* getChannel();
+  /// Deliver the responses to a channel's requests as they complete
+  void poll(GrpcChannel* channel);
+
+  std::vector<std::unique_ptr<GrpcChannel>> channels_;
+  std::atomic<size_t> counter_ = 0;
+  CompressionOptions compression_;
+  Observer observer_;
 };
 
-GrpcClient::GrpcClient(const std::string& address)
+GrpcChannel* GrpcClient::GrpcClientImpl::getChannel() {
+  const auto start =
+    counter_.fetch_add(1, std::memory_order_relaxed) % channels_.size();
+  auto* best = channels_[start].get();
+  auto least = best->outstanding.load(std::memory_order_relaxed);
+  for (auto i = 1U; i < channels_.size() && least > 0; ++i) {
+    auto* channel = channels_[(start + i) % channels_.size()].get();
+    const auto outstanding =
+      channel->outstanding.load(std::memory_order_relaxed);
+    if (outstanding < least) {
+      best = channel;
+      least = outstanding;
+    }
+  }
+  best->outstanding.fetch_add(1, std::memory_order_relaxed);
+  return best;
+}
+
+void GrpcClient::GrpcClientImpl::submit(const std::string& model,
+                                        const InferenceRequest& request,
+                                        std::unique_ptr<AsyncCall> call) {
+  inference::ModelInferRequest grpc_request;
+  grpc_request.set_model_name(model);
+  mapRequestToProto(request, grpc_request, observer_);
+  compressRequest(&call->context, grpc_request, compression_);
+
+  auto* channel = this->getChannel();
+  std::call_once(channel->poller_started, [this, channel]() {
+    channel->poller = std::thread{&GrpcClientImpl::poll, this, channel};
+  });
+
+  call->reader = channel->stub->PrepareAsyncModelInfer(
+    &call->context, grpc_request, &channel->cq);
+  call->reader->StartCall();
+  // the poller owns the call once it's finished
+  auto* tag = call.release();
+  tag->reader->Finish(&tag->reply, &tag->status, tag);
+}
+
+void GrpcClient::GrpcClientImpl::poll(GrpcChannel* channel) {
+  util::setThreadName("GrpcClient");
+  void* tag = nullptr;
+  bool ok = false;
+  while (channel->cq.Next(&tag, &ok)) {
+    channel->outstanding.fetch_sub(1, std::memory_order_relaxed);
+    std::unique_ptr<AsyncCall> call{static_cast<AsyncCall*>(tag)};
+
+    // errors are returned as error responses since there's no caller to
+    // throw them to
+    InferenceResponse response;
+    if (!ok) {
+      response = InferenceResponse("Failed to complete the gRPC request");
+    } else if (!call->status.ok()) {
+      response = InferenceResponse(call->status.error_message());
+    } else {
+      try {
+        mapProtoToResponse(call->reply, response, observer_);
+      } catch (const runtime_error& e) {
+        response = InferenceResponse(e.what());
+      }
+    }
+
+    if (call->promise.has_value()) {
+      call->promise->set_value(std::move(response));
+    } else {
+      call->callback(response);
+    }
+  }
+}
+
+GrpcClient::GrpcClient(const std::string& address,
+                       const CompressionOptions& compression)
   : GrpcClient(
-      ::grpc::CreateChannel(address, ::grpc::InsecureChannelCredentials())) {}
+      ::grpc::CreateChannel(address, ::grpc::InsecureChannelCredentials()),
+      compression) {}
+
+GrpcClient::GrpcClient(const std::string& address, int channels,
+                       const CompressionOptions& compression) {
+  if (channels <= 0) {
+    throw invalid_argument("The number of gRPC channels must be positive");
+  }
+  std::vector<std::shared_ptr<::grpc::Channel>> pool;
+  pool.reserve(channels);
+  for (auto i = 0; i < channels; ++i) {
+    // channels share connections through gRPC's global subchannel pool unless
+    // they have their own
+    ::grpc::ChannelArguments arguments;
+    arguments.SetInt(GRPC_ARG_USE_LOCAL_SUBCHANNEL_POOL, 1);
+    pool.push_back(::grpc::CreateCustomChannel(
+      address, ::grpc::InsecureChannelCredentials(), arguments));
+  }
+  this->impl_ =
+    std::make_unique<GrpcClient::GrpcClientImpl>(pool, compression);
+}
 
-GrpcClient::GrpcClient(const std::shared_ptr<::grpc::Channel>& channel) {
-  this->impl_ = std::make_unique<GrpcClient::GrpcClientImpl>(channel);
+GrpcClient::GrpcClient(const std::shared_ptr<::grpc::Channel>& channel,
+                       const CompressionOptions& compression) {
+  this->impl_ = std::make_unique<GrpcClient::GrpcClientImpl>(
+    std::vector<std::shared_ptr<::grpc::Channel>>{channel}, compression);
 }
 
 GrpcClient::~GrpcClient() = default;
@@ -161,6 +345,7 @@ ModelMetadata mapProtoToModelMetadata(
     metadata.addInputTensor(output.name(), shape,
                             DataType(output.datatype().c_str()));
   }
+  metadata.setParameters(mapProtoToParameters(resp.parameters()));
   return metadata;
 }
 
@@ -207,7 +392,7 @@ void GrpcClient::modelLoad(const std::string& model,
 
   request.set_name(model);
   auto* params = request.mutable_parameters();
-  mapParametersToProto(parameters.data(), params);
+  mapParametersToProto(parameters, params);
 
   auto* stub = this->impl_->getStub();
   Status status = stub->ModelLoad(&context, request, &reply);
@@ -242,7 +427,7 @@ std::string GrpcClient::workerLoad(const std::string& worker,
 
   request.set_name(worker);
   auto* params = request.mutable_parameters();
-  mapParametersToProto(parameters.data(), params);
+  mapParametersToProto(parameters, params);
 
   auto* stub = this->impl_->getStub();
   Status status = stub->WorkerLoad(&context, request, &reply);
@@ -271,7 +456,8 @@ void GrpcClient::workerUnload(const std::string& worker) const {
 
 InferenceResponse runInference(inference::GRPCInferenceService::Stub* stub,
                                const std::string& model,
-                               const InferenceRequest& request) {
+                               const InferenceRequest& request,
+                               const CompressionOptions& compression) {
   inference::ModelInferRequest grpc_request;
   inference::ModelInferResponse reply;
 
@@ -282,6 +468,7 @@ InferenceResponse runInference(inference::GRPCInferenceService::Stub* stub,
 
   grpc_request.set_model_name(model);
   mapRequestToProto(request, grpc_request, observer);
+  compressRequest(&context, grpc_request, compression);
 
   Status status = stub->ModelInfer(&context, grpc_request, &reply);
 
@@ -296,12 +483,63 @@ InferenceResponse runInference(inference::GRPCInferenceService::Stub* stub,
 
 InferenceResponseFuture GrpcClient::modelInferAsync(
   const std::string& model, const InferenceRequest& request) const {
-  return std::async(runInference, this->impl_->getStub(), model, request);
+  auto call = std::make_unique<AsyncCall>();
+  auto future = call->promise.emplace().get_future();
+  this->impl_->submit(model, request, std::move(call));
+  return future;
+}
+
+void GrpcClient::modelInferAsync(const std::string& model,
+                                 const InferenceRequest& request,
+                                 Callback callback) const {
+  auto call = std::make_unique<AsyncCall>();
+  call->callback = std::move(callback);
+  this->impl_->submit(model, request, std::move(call));
 }
 
 InferenceResponse GrpcClient::modelInfer(
   const std::string& model, const InferenceRequest& request) const {
-  return runInference(this->impl_->getStub(), model, request);
+  return runInference(this->impl_->getStub(), model, request,
+                      this->impl_->getCompression());
+}
+
+std::vector<InferenceResponse> GrpcClient::modelInferBatch(
+  const std::string& model,
+  const std::vector<InferenceRequest>& requests) const {
+  inference::ModelInferBatchRequest grpc_request;
+  inference::ModelInferBatchResponse reply;
+
+  ClientContext context;
+
+  Observer observer;
+  AMDINFER_IF_LOGGING(observer.logger = Logger{Loggers::Client});
+
+  grpc_request.mutable_requests()->Reserve(static_cast<int>(requests.size()));
+  for (const auto& request : requests) {
+    auto* proto = grpc_request.add_requests();
+    proto->set_model_name(model);
+    mapRequestToProto(request, *proto, observer);
+  }
+  compressRequest(&context, grpc_request, this->impl_->getCompression());
+
+  auto* stub = this->impl_->getStub();
+  Status status = stub->ModelInferBatch(&context, grpc_request, &reply);
+
+  if (!status.ok()) {
+    throw bad_status(status.error_message());
+  }
+
+  std::vector<InferenceResponse> responses;
+  responses.reserve(reply.responses_size());
+  for (const auto& proto : reply.responses()) {
+    if (!proto.error_message().empty()) {
+      responses.emplace_back(proto.error_message());
+    } else {
+      mapProtoToResponse(proto.infer_response(), responses.emplace_back(),
+                         observer);
+    }
+  }
+  return responses;
 }
 
 bool GrpcClient::hasHardware(const std::string& name, int num) const {
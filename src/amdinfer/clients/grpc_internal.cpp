@@ -27,18 +27,23 @@
 #include <cstdint>  // for int16_t, int32_t
 #include <cstring>  // for memcpy
 #include <memory>   // for make_shared, shared...
+#include <string>   // for to_string
 #include <utility>  // for move
 #include <variant>  // for visit
 #include <vector>   // for vector, _Bit_reference
 
 #include "amdinfer/build_options.hpp"            // for AMDINFER_ENABLE_LO...
+#include "amdinfer/core/bytes_tensor.hpp"        // for BytesView, encodeBytes
 #include "amdinfer/core/data_types.hpp"          // for DataType, mapTypeToStr
+#include "amdinfer/core/exceptions.hpp"          // for invalid_argument
 #include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
 #include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
 #include "amdinfer/core/model_metadata.hpp"      // for ModelMetadata
 #include "amdinfer/core/request_container.hpp"   // for ParameterMap
+#include "amdinfer/core/shared_memory.hpp"       // for SharedMemoryTensors
 #include "amdinfer/declarations.hpp"             // for InferenceResponseOu...
 #include "amdinfer/observation/observer.hpp"     // for kNumTraceData
+#include "amdinfer/util/convert.hpp"             // for convert
 #include "amdinfer/util/traits.hpp"              // IWYU pragma: keep
 #include "inference.pb.h"                        // for ModelInferResponse_...
 
@@ -48,6 +53,7 @@ void mapProtoToParameters(
   const google::protobuf::Map<std::string, inference::InferParameter>& params,
   ParameterMap& parameters) {
   using ParameterType = inference::InferParameter::ParameterChoiceCase;
+  parameters.reserve(parameters.size() + params.size());
   for (const auto& [key, value] : params) {
     auto type = value.parameter_choice_case();
     switch (type) {
@@ -95,7 +101,7 @@ template <class... Ts>
 Overloaded(Ts...) -> Overloaded<Ts...>;
 
 void mapParametersToProto(
-  const std::map<std::string, amdinfer::Parameter, std::less<>>& parameters,
+  const ParameterMap& parameters,
   google::protobuf::Map<std::string, inference::InferParameter>*
     grpc_parameters) {
   for (const auto& [key, value] : parameters) {
@@ -119,21 +125,20 @@ struct AddDataToTensor {
 
     if constexpr (std::is_same_v<T, char>) {
       contents->Add(data);
-    } else if constexpr (std::is_same_v<T, fp16>) {
-      for (auto i = 0U; i < size; ++i) {
-        contents->Add(static_cast<float>(data[i]));
-      }
     } else {
-      for (auto i = 0U; i < size; ++i) {
+      // grow the field once and convert into it instead of adding each
+      // element, which may be stored in a wider type
+      const auto start = contents->size();
+      contents->Resize(start + static_cast<int>(size), {});
+      util::convert(data, size, contents->mutable_data() + start);
 #ifdef AMDINFER_ENABLE_LOGGING
-        const auto min_size = size > kNumTraceData ? kNumTraceData : size;
-        if (i < min_size) {
-          AMDINFER_LOG_TRACE(observer.logger, "Adding data to tensor: " +
-                                                std::to_string(data[i]));
-        }
-#endif
-        contents->Add(data[i]);
+      const auto min_size = size > kNumTraceData ? kNumTraceData : size;
+      for (auto i = 0U; i < min_size; ++i) {
+        AMDINFER_LOG_TRACE(observer.logger,
+                           "Added data to tensor: " +
+                             std::to_string(contents->Get(start + i)));
       }
+#endif
     }
   }
 };
@@ -145,29 +150,31 @@ void mapRequestToProto(const InferenceRequest& request,
                      "Mapping the InferenceRequest to proto object");
   grpc_request.set_id(request.getID());
 
-  const auto& parameters = request.getParameters();
-  auto params = parameters.data();
   auto* grpc_parameters = grpc_request.mutable_parameters();
-  mapParametersToProto(params, grpc_parameters);
+  mapParametersToProto(request.getParameters(), grpc_parameters);
 
   const auto& inputs = request.getInputs();
   for (const auto& input : inputs) {
     auto* tensor = grpc_request.add_inputs();
 
     tensor->set_name(input.getName());
-    const auto& shape = input.getShape();
-    auto size = 1U;
-    for (const auto& index : shape) {
-      tensor->add_shape(index);
-      size *= index;
-    }
     auto datatype = input.getDatatype();
+    if (datatype == DataType::Bytes) {
+      // BYTES tensors are sent with their number of elements as their shape
+      tensor->add_shape(
+        BytesView{input.getData(), input.getSize()}.size());
+    } else {
+      for (const auto& index : input.getShape()) {
+        tensor->add_shape(index);
+      }
+    }
     tensor->set_datatype(datatype.str());
-    mapParametersToProto(input.getParameters().data(),
+    mapParametersToProto(input.getParameters(),
                          tensor->mutable_parameters());
 
-    switchOverTypes(AddDataToTensor(), input.getDatatype(), input.getData(),
-                    input.getSize(), tensor, observer);
+    grpc_request.add_raw_input_contents(
+      static_cast<const char*>(input.getData()),
+      input.getSize() * datatype.size());
   }
 
   // TODO(varunsh): skipping outputs for now
@@ -183,18 +190,11 @@ struct SetOutputData {
     const auto* contents = getTensorContents<T>(tensor);
     if constexpr (std::is_same_v<T, char>) {
       std::memcpy(data.data(), contents, size * sizeof(std::byte));
-      output->setData(std::move(data));
     } else {
-      if constexpr (util::is_any_v<T, int8_t, uint8_t, int16_t, uint16_t,
-                                   fp16>) {
-        for (auto i = 0U; i < size; ++i) {
-          std::memcpy(&(data[i * sizeof(T)]), &(contents[i]), sizeof(T));
-        }
-      } else {
-        std::memcpy(data.data(), contents, bytes_to_copy);
-      }
-      output->setData(std::move(data));
+      // narrow types are stored in wider proto fields so they're converted
+      util::convert(contents, size, reinterpret_cast<T*>(data.data()));
     }
+    output->setData(std::move(data));
 
     AMDINFER_IF_LOGGING(
       logTraceBuffer(observer.logger, output->getData(), sizeof(T));)
@@ -205,8 +205,20 @@ void mapProtoToResponse(const inference::ModelInferResponse& reply,
                         InferenceResponse& response, const Observer& observer) {
   response.setModel(reply.model_name());
   response.setID(reply.id());
+  if (!reply.parameters().empty()) {
+    response.setParameters(mapProtoToParameters(reply.parameters()));
+  }
+
+  const auto& raw_contents = reply.raw_output_contents();
+  if (!raw_contents.empty() && raw_contents.size() != reply.outputs_size()) {
+    throw invalid_argument("Expected raw contents for all " +
+                           std::to_string(reply.outputs_size()) +
+                           " outputs, got " +
+                           std::to_string(raw_contents.size()));
+  }
 
-  for (const auto& tensor : reply.outputs()) {
+  for (auto i = 0; i < reply.outputs_size(); ++i) {
+    const auto& tensor = reply.outputs(i);
     InferenceResponseOutput output;
     output.setName(tensor.name());
     output.setDatatype(DataType(tensor.datatype().c_str()));
@@ -219,14 +231,42 @@ void mapProtoToResponse(const inference::ModelInferResponse& reply,
     }
     output.setShape(shape);
     // TODO(varunsh): skipping parameters for now
-    switchOverTypes(SetOutputData(), output.getDatatype(), &output, size,
-                    &tensor, observer);
-    response.addOutput(output);
+    if (output.getDatatype() == DataType::Bytes) {
+      // BYTES tensors are sized by their data in the tensor's layout
+      std::vector<std::byte> data;
+      if (raw_contents.empty()) {
+        data = encodeBytes(tensor.contents().bytes_contents());
+      } else {
+        const auto& raw = raw_contents.Get(i);
+        data.resize(raw.size());
+        std::memcpy(data.data(), raw.data(), raw.size());
+      }
+      checkBytesShape(BytesView{data.data(), data.size()}.size(), shape,
+                      tensor.name());
+      output.setShape({data.size()});
+      output.setData(std::move(data));
+    } else if (raw_contents.empty()) {
+      switchOverTypes(SetOutputData(), output.getDatatype(), &output, size,
+                      &tensor, observer);
+    } else {
+      const auto& raw = raw_contents.Get(i);
+      std::vector<std::byte> data(raw.size());
+      std::memcpy(data.data(), raw.data(), raw.size());
+      output.setData(std::move(data));
+    }
+    response.addOutput(std::move(output));
   }
 }
 
-void mapResponseToProto(InferenceResponse response,
-                        inference::ModelInferResponse& reply) {
+namespace {
+
+/// Where the data of a response's outputs goes in its proto
+enum class OutputContents { Typed, Raw, None };
+
+void mapResponse(const InferenceResponse& response,
+                 inference::ModelInferResponse& reply, OutputContents contents,
+                 const SharedMemoryTensors* shared_memory) {
+  const auto raw = contents == OutputContents::Raw;
   Observer observer;
   AMDINFER_IF_LOGGING(observer.logger = Logger{Loggers::Server});
 
@@ -234,28 +274,79 @@ void mapResponseToProto(InferenceResponse response,
                      "Mapping the InferenceResponse to proto object");
   reply.set_model_name(response.getModel());
   reply.set_id(response.getID());
-  auto outputs = response.getOutputs();
+  const auto& outputs = response.getOutputs();
+  // size the repeated fields once rather than growing them output by output
+  reply.mutable_outputs()->Reserve(static_cast<int>(outputs.size()));
+  if (raw) {
+    reply.mutable_raw_output_contents()->Reserve(
+      static_cast<int>(outputs.size()));
+  }
   for (const InferenceResponseOutput& output : outputs) {
     auto* tensor = reply.add_outputs();
     tensor->set_name(output.getName());
     // auto* parameters = tensor->mutable_parameters();
     tensor->set_datatype(output.getDatatype().str());
+    const auto bytes = output.getDatatype() == DataType::Bytes;
     const auto& shape = output.getShape();
-    auto size = 1U;
-    for (const size_t& index : shape) {
-      tensor->add_shape(index);
-      size *= index;
+    tensor->mutable_shape()->Reserve(static_cast<int>(shape.size()));
+    BytesView elements;
+    if (bytes) {
+      // BYTES tensors are sent with their number of elements as their shape
+      elements = BytesView{output.getData(), output.getSize()};
+      tensor->add_shape(elements.size());
+    } else {
+      for (const size_t& index : shape) {
+        tensor->add_shape(index);
+      }
     }
 
-    switchOverTypes(AddDataToTensor(), output.getDatatype(), output.getData(),
-                    output.getSize(), tensor, observer);
+    if (shared_memory != nullptr &&
+        shared_memory->containsOutput(output.getName())) {
+      mapParametersToProto(shared_memory->writeOutput(output),
+                           tensor->mutable_parameters());
+      continue;
+    }
+    if (contents == OutputContents::None) {
+      (*tensor->mutable_parameters())["binary_data_size"].set_int64_param(
+        static_cast<int64_t>(output.getSize() * output.getDatatype().size()));
+    } else if (raw) {
+      reply.add_raw_output_contents(
+        static_cast<const char*>(output.getData()),
+        output.getSize() * output.getDatatype().size());
+    } else if (bytes) {
+      auto* strings = tensor->mutable_contents()->mutable_bytes_contents();
+      strings->Reserve(static_cast<int>(elements.size()));
+      for (const auto& element : elements) {
+        strings->Add(std::string{element});
+      }
+    } else {
+      switchOverTypes(AddDataToTensor(), output.getDatatype(),
+                      output.getData(), output.getSize(), tensor, observer);
+    }
   }
 }
 
+}  // namespace
+
+void mapResponseToProto(const InferenceResponse& response,
+                        inference::ModelInferResponse& reply, bool raw,
+                        const SharedMemoryTensors* shared_memory) {
+  mapResponse(response, reply,
+              raw ? OutputContents::Raw : OutputContents::Typed,
+              shared_memory);
+}
+
+void mapResponseMetadataToProto(const InferenceResponse& response,
+                                inference::ModelInferResponse& reply,
+                                const SharedMemoryTensors* shared_memory) {
+  mapResponse(response, reply, OutputContents::None, shared_memory);
+}
+
 void mapModelMetadataToProto(const ModelMetadata& metadata,
                              inference::ModelMetadataResponse& resp) {
   resp.set_name(metadata.getName());
   resp.set_platform(metadata.getPlatform());
+  mapParametersToProto(metadata.getParameters(), resp.mutable_parameters());
 
   const auto& inputs = metadata.getInputs();
   for (const auto& input : inputs) {
@@ -279,4 +370,19 @@ void mapModelMetadataToProto(const ModelMetadata& metadata,
   }
 }
 
+grpc_compression_algorithm getCompressionAlgorithm(
+  const CompressionOptions& compression, size_t size) {
+  if (size < compression.threshold) {
+    return GRPC_COMPRESS_NONE;
+  }
+  switch (compression.algorithm) {
+    case Compression::Deflate:
+      return GRPC_COMPRESS_DEFLATE;
+    case Compression::Gzip:
+      return GRPC_COMPRESS_GZIP;
+    default:
+      return GRPC_COMPRESS_NONE;
+  }
+}
+
 }  // namespace amdinfer
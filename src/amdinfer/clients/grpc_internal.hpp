@@ -21,14 +21,16 @@
 #ifndef GUARD_AMDINFER_CLIENTS_GRPC_INTERNAL
 #define GUARD_AMDINFER_CLIENTS_GRPC_INTERNAL
 
-#include <cstdint>     // for int16_t, int32_t
-#include <functional>  // for less
-#include <map>         // for map
-#include <string>      // for string
+#include <grpc/compression.h>  // for grpc_compression_algorithm
 
-#include "amdinfer/core/data_types.hpp"  // for fp16
-#include "amdinfer/core/parameters.hpp"  // for Parameter, ParameterMap (ptr...
-#include "amdinfer/util/traits.hpp"      // IWYU pragma: keep
+#include <cstddef>  // for size_t
+#include <cstdint>  // for int16_t, int32_t
+#include <string>   // for string
+
+#include "amdinfer/core/compression.hpp"  // for CompressionOptions
+#include "amdinfer/core/data_types.hpp"   // for fp16, bf16
+#include "amdinfer/core/parameters.hpp"   // for Parameter, ParameterMap (pt...
+#include "amdinfer/util/traits.hpp"       // IWYU pragma: keep
 
 namespace google::protobuf {
 template <typename T, typename U>
@@ -48,9 +50,10 @@ class InferenceRequest;
 class InferenceResponse;
 class ModelMetadata;
 struct Observer;
+class SharedMemoryTensors;
 
 void mapParametersToProto(
-  const std::map<std::string, amdinfer::Parameter, std::less<>>& parameters,
+  const ParameterMap& parameters,
   google::protobuf::Map<std::string, inference::InferParameter>*
     grpc_parameters);
 ParameterMap mapProtoToParameters(
@@ -58,17 +61,61 @@ ParameterMap mapProtoToParameters(
 void mapProtoToParameters(
   const google::protobuf::Map<std::string, inference::InferParameter>& params,
   ParameterMap& parameters);
+/**
+ * @brief Map a request to its proto. The input data is sent as raw contents
+ * so each tensor is copied into the message in one go
+ *
+ * @param request request to map
+ * @param grpc_request proto to map to
+ * @param observer observer for logging
+ */
 void mapRequestToProto(const InferenceRequest& request,
                        inference::ModelInferRequest& grpc_request,
                        const Observer& observer);
-void mapResponseToProto(InferenceResponse response,
-                        inference::ModelInferResponse& reply);
+/**
+ * @brief Map a response to its proto. The output data can be sent as raw
+ * contents, which copies each tensor in one go, or in the typed contents
+ * fields, which copies it element by element.
+ *
+ * @param response response to map
+ * @param reply proto to map to
+ * @param raw whether to use raw contents for the output data
+ * @param shared_memory if not null, outputs it contains are written to shared
+ * memory instead of the proto
+ */
+void mapResponseToProto(const InferenceResponse& response,
+                        inference::ModelInferResponse& reply, bool raw = false,
+                        const SharedMemoryTensors* shared_memory = nullptr);
+/**
+ * @brief Map a response to its proto without the data of its outputs, which
+ * is sent separately. Each output that isn't in shared memory gets the size of
+ * its data in bytes as its "binary_data_size" parameter.
+ *
+ * @param response response to map
+ * @param reply proto to map to
+ * @param shared_memory if not null, outputs it contains are written to shared
+ * memory instead
+ */
+void mapResponseMetadataToProto(
+  const InferenceResponse& response, inference::ModelInferResponse& reply,
+  const SharedMemoryTensors* shared_memory = nullptr);
 void mapProtoToResponse(const inference::ModelInferResponse& reply,
                         InferenceResponse& response, const Observer& observer);
 
 void mapModelMetadataToProto(const ModelMetadata& metadata,
                              inference::ModelMetadataResponse& resp);
 
+/**
+ * @brief Get the gRPC algorithm to compress a message with. Messages smaller
+ * than the threshold aren't compressed.
+ *
+ * @param compression the algorithm and the threshold
+ * @param size size of the message in bytes
+ * @return grpc_compression_algorithm
+ */
+grpc_compression_algorithm getCompressionAlgorithm(
+  const CompressionOptions& compression, size_t size);
+
 template <typename T, typename Tensor>
 constexpr auto* getTensorContents(Tensor* tensor) {
   if constexpr (std::is_same_v<T, bool>) {
@@ -101,7 +148,7 @@ constexpr auto* getTensorContents(Tensor* tensor) {
     } else {
       return tensor->mutable_contents()->mutable_int64_contents();
     }
-  } else if constexpr (util::is_any_v<T, fp16, float>) {
+  } else if constexpr (util::is_any_v<T, fp16, bf16, float>) {
     if constexpr (std::is_const_v<Tensor>) {
       return tensor->contents().fp32_contents().data();
     } else {
@@ -27,16 +27,22 @@
 #include <json/value.h>                   // for Value, arrayValue, obje...
 #include <trantor/net/EventLoopThread.h>  // for EventLoopThread
 
+#include <atomic>         // for atomic, memory_order_relaxed
 #include <cassert>        // for assert
 #include <future>         // for promise
+#include <memory>         // for unique_ptr, make_unique
+#include <mutex>          // for call_once, once_flag
+#include <string>         // for string, to_string
+#include <string_view>    // for string_view
 #include <unordered_set>  // for unordered_set
-#include <utility>        // for tuple_element<>::type
+#include <utility>        // for move, tuple_element<>::type
 #include <vector>
 
 #include "amdinfer/clients/http_internal.hpp"    // for mapParametersToJson
-#include "amdinfer/core/exceptions.hpp"          // for bad_status
+#include "amdinfer/core/exceptions.hpp"          // for bad_status, invalid_...
 #include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
 #include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/util/compression.hpp"         // for compress, decompress
 
 namespace amdinfer {
 
@@ -48,13 +54,53 @@ void addHeaders(const drogon::HttpRequestPtr& req, const StringMap& headers) {
 
 class HttpClient::HttpClientImpl {
  public:
+  /**
+   * @brief A connection that's counted as having a request in flight until
+   * the lease is destroyed or released
+   */
+  class Lease {
+   public:
+    Lease(HttpClientImpl* impl, int index) : impl_(impl), index_(index) {}
+    Lease(Lease const&) = delete;              ///< Copy constructor
+    Lease& operator=(const Lease&) = delete;   ///< Copy assignment
+    Lease(Lease&& other) = delete;             ///< Move constructor
+    Lease& operator=(Lease&& other) = delete;  ///< Move assignment
+    ~Lease() {
+      if (impl_ != nullptr) {
+        impl_->finish(index_);
+      }
+    }
+
+    drogon::HttpClient* operator->() const { return get(); }
+    drogon::HttpClient* get() const { return impl_->clients_[index_].get(); }
+
+    /// Stop tracking the request here. It must be finished with finish()
+    int release() {
+      impl_ = nullptr;
+      return index_;
+    }
+
+   private:
+    HttpClientImpl* impl_;
+    int index_;
+  };
+
   explicit HttpClientImpl(const std::string& address, StringMap headers,
-                          int parallelism)
-    : headers_(std::move(headers)), num_clients_(parallelism) {
-    // arbitrarily use ratio of 16:1 between HttpClients and EventLoops
-    const auto client_thread_ratio = 16;
-    const auto threads = (parallelism / client_thread_ratio) + 1;
+                          int parallelism, int clients_per_loop,
+                          const CompressionOptions& compression)
+    : headers_(std::move(headers)),
+      compression_(compression),
+      num_clients_(parallelism) {
+    if (parallelism <= 0) {
+      throw invalid_argument("The HTTP client's parallelism must be positive");
+    }
+    if (clients_per_loop <= 0) {
+      throw invalid_argument(
+        "The HTTP client's connections per event loop must be positive");
+    }
+    const auto threads = (parallelism / clients_per_loop) + 1;
 
+    outstanding_ = std::make_unique<std::atomic<int>[]>(num_clients_);
     loops_.reserve(threads);
     clients_.reserve(num_clients_);
     for (auto i = 0; i < threads; ++i) {
@@ -71,34 +117,78 @@ class HttpClient::HttpClientImpl {
     }
   }
 
-  drogon::HttpClient* getClient() {
-    const auto& client = clients_[counter_];
-    counter_ = (counter_ + 1) % num_clients_;
-    return client.get();
+  /**
+   * @brief Get the connection with the fewest requests in flight. The search
+   * starts from a different connection each time so ties are spread evenly
+   * and the lease counts the new request until it's done.
+   */
+  Lease getClient() {
+    const auto start = static_cast<int>(
+      counter_.fetch_add(1, std::memory_order_relaxed) % num_clients_);
+    auto best = start;
+    auto least = outstanding_[start].load(std::memory_order_relaxed);
+    for (auto i = 1; i < num_clients_ && least > 0; ++i) {
+      const auto index = (start + i) % num_clients_;
+      const auto outstanding =
+        outstanding_[index].load(std::memory_order_relaxed);
+      if (outstanding < least) {
+        best = index;
+        least = outstanding;
+      }
+    }
+    outstanding_[best].fetch_add(1, std::memory_order_relaxed);
+    return {this, best};
+  }
+
+  /// Finish a request on a connection whose lease was released
+  void finish(int index) {
+    outstanding_[index].fetch_sub(1, std::memory_order_relaxed);
   }
 
   const StringMap& getHeaders() const { return headers_; }
 
+  const CompressionOptions& getCompression() const { return compression_; }
+
   auto getClientNum() const { return num_clients_; }
 
+  /**
+   * @brief Check if requests should use the binary tensor data extension,
+   * which is used if the server advertises it. The server is only asked once
+   * and is asked again if the first attempt throws.
+   */
+  bool useBinary(const HttpClient& client) {
+    std::call_once(binary_flag_, [&] {
+      binary_ = serverHasExtension(&client, "binary_tensor_data");
+    });
+    return binary_;
+  }
+
  private:
   StringMap headers_;
-  int counter_ = 0;
+  CompressionOptions compression_;
+  std::atomic<unsigned int> counter_ = 0;
   int num_clients_;
+  /// requests in flight on each connection. It outlives the event loops so
+  /// responses that arrive as the client is destroyed can still finish
+  std::unique_ptr<std::atomic<int>[]> outstanding_;
   std::vector<std::unique_ptr<trantor::EventLoopThread>> loops_;
   std::vector<drogon::HttpClientPtr> clients_;
+  std::once_flag binary_flag_;
+  bool binary_ = false;
 };
 
 HttpClient::HttpClient(const std::string& address) {
   const auto parallelism = 32;
   this->impl_ = std::make_unique<HttpClient::HttpClientImpl>(
-    address, StringMap{}, parallelism);
+    address, StringMap{}, parallelism, kDefaultHttpClientsPerLoop,
+    CompressionOptions{});
 }
 
 HttpClient::HttpClient(const std::string& address, const StringMap& headers,
-                       int parallelism) {
-  this->impl_ =
-    std::make_unique<HttpClient::HttpClientImpl>(address, headers, parallelism);
+                       int parallelism, int clients_per_loop,
+                       const CompressionOptions& compression) {
+  this->impl_ = std::make_unique<HttpClient::HttpClientImpl>(
+    address, headers, parallelism, clients_per_loop, compression);
 }
 
 // needed for HttpClientImpl forward declaration in WebSocket client
@@ -149,7 +239,7 @@ drogon::HttpRequestPtr createPostRequest(const Json::Value& json,
 }
 
 ServerMetadata HttpClient::serverMetadata() const {
-  auto* client = this->impl_->getClient();
+  auto client = this->impl_->getClient();
   auto req = createGetRequest("/v2", impl_->getHeaders());
 
   auto [result, response] = client->sendRequest(req);
@@ -169,7 +259,7 @@ ServerMetadata HttpClient::serverMetadata() const {
 }
 
 bool HttpClient::serverLive() const {
-  auto* client = this->impl_->getClient();
+  auto client = this->impl_->getClient();
   auto req = createGetRequest("/v2/health/live", impl_->getHeaders());
 
   // arbitrarily setting a 10 second timeout
@@ -182,7 +272,7 @@ bool HttpClient::serverLive() const {
 }
 
 bool HttpClient::serverReady() const {
-  auto* client = this->impl_->getClient();
+  auto client = this->impl_->getClient();
   auto req = createGetRequest("/v2/health/ready", impl_->getHeaders());
 
   auto [result, response] = client->sendRequest(req);
@@ -191,7 +281,7 @@ bool HttpClient::serverReady() const {
 }
 
 bool HttpClient::modelReady(const std::string& model) const {
-  auto* client = this->impl_->getClient();
+  auto client = this->impl_->getClient();
   auto req =
     createGetRequest("/v2/models/" + model + "/ready", impl_->getHeaders());
 
@@ -201,7 +291,7 @@ bool HttpClient::modelReady(const std::string& model) const {
 }
 
 ModelMetadata HttpClient::modelMetadata(const std::string& model) const {
-  auto* client = this->impl_->getClient();
+  auto client = this->impl_->getClient();
   auto req = createGetRequest("/v2/models/" + model, impl_->getHeaders());
 
   auto [result, response] = client->sendRequest(req);
@@ -212,7 +302,7 @@ ModelMetadata HttpClient::modelMetadata(const std::string& model) const {
 
 void HttpClient::modelLoad(const std::string& model,
                            const ParameterMap& parameters) const {
-  auto* client = this->impl_->getClient();
+  auto client = this->impl_->getClient();
 
   Json::Value json = Json::objectValue;
   json = mapParametersToJson(parameters);
@@ -228,7 +318,7 @@ void HttpClient::modelLoad(const std::string& model,
 }
 
 void HttpClient::modelUnload(const std::string& model) const {
-  auto* client = this->impl_->getClient();
+  auto client = this->impl_->getClient();
 
   Json::Value json;
   auto req = createPostRequest(
@@ -244,7 +334,7 @@ void HttpClient::modelUnload(const std::string& model) const {
 
 std::string HttpClient::workerLoad(const std::string& worker,
                                    const ParameterMap& parameters) const {
-  auto* client = this->impl_->getClient();
+  auto client = this->impl_->getClient();
 
   Json::Value json = Json::objectValue;
   json = mapParametersToJson(parameters);
@@ -261,7 +351,7 @@ std::string HttpClient::workerLoad(const std::string& worker,
 }
 
 void HttpClient::workerUnload(const std::string& worker) const {
-  auto* client = this->impl_->getClient();
+  auto client = this->impl_->getClient();
 
   Json::Value json;
   auto req = createPostRequest(json, "/v2/workers/" + worker + "/unload",
@@ -275,26 +365,119 @@ void HttpClient::workerUnload(const std::string& worker) const {
   }
 }
 
+/// Set the body of a request, compressing it if it's large enough
+void setBody(const drogon::HttpRequestPtr& req, std::string body,
+             const StringMap& headers, const CompressionOptions& compression) {
+  if (compression.algorithm != Compression::None) {
+    // responses in either format can be decompressed
+    req->addHeader("Accept-Encoding", "gzip, deflate");
+    if (body.size() >= compression.threshold) {
+      body = util::compress(body, compression.algorithm);
+      req->addHeader("Content-Encoding",
+                     util::getEncodingName(compression.algorithm));
+    }
+  }
+  req->setBody(std::move(body));
+  addHeaders(req, headers);
+}
+
+/**
+ * @brief Create an inference request. The body is written straight from the
+ * request's tensors and, if binary is set, uses the binary tensor data
+ * extension so the input data is sent as raw bytes after the JSON header and
+ * the outputs are requested as binary data, unless the request's parameters
+ * already say otherwise. Bodies at least as large as the threshold are
+ * compressed.
+ */
 auto createInferenceRequest(const std::string& model,
-                            const InferenceRequest& request,
-                            const StringMap& headers) {
+                            const InferenceRequest& request, bool binary,
+                            const StringMap& headers,
+                            const CompressionOptions& compression) {
   if (request.getInputs().empty()) {
     throw invalid_argument("The request's inputs cannot be empty");
   }
 
-  auto json = mapRequestToJson(request);
-  return createPostRequest(json, "/v2/models/" + model + "/infer", headers);
+  std::string body;
+  const auto header_length = writeRequest(request, binary, &body);
+
+  auto req = drogon::HttpRequest::newHttpRequest();
+  req->setMethod(drogon::Post);
+  req->setPath("/v2/models/" + model + "/infer");
+  if (binary) {
+    req->setContentTypeCode(drogon::ContentType::CT_APPLICATION_OCTET_STREAM);
+    req->addHeader(kInferenceHeaderContentLength,
+                   std::to_string(header_length));
+  } else {
+    req->setContentTypeCode(drogon::ContentType::CT_APPLICATION_JSON);
+  }
+  setBody(req, std::move(body), headers, compression);
+  return req;
+}
+
+/// Get the body of a response, decompressing it if needed
+std::string_view getBody(const drogon::HttpResponsePtr& response,
+                         std::string* storage) {
+  std::string_view body = response->body();
+  // Drogon inflates gzip bodies itself and removes the header when it does
+  const auto& encoding = response->getHeader("content-encoding");
+  if (util::parseContentEncoding(encoding) != Compression::None) {
+    *storage = util::decompress(body);
+    body = *storage;
+  }
+  return body;
+}
+
+InferenceResponse parseInferenceResponse(
+  const drogon::HttpResponsePtr& response) {
+  const auto& header_length =
+    response->getHeader(kInferenceHeaderContentLength);
+  // Drogon inflates gzip bodies itself and removes the header when it does
+  const auto& encoding = response->getHeader("content-encoding");
+  if (header_length.empty() && encoding.empty()) {
+    auto json = response->jsonObject();
+    if (json == nullptr) {
+      throw bad_status("Failed to interpret response body as JSON");
+    }
+    return mapJsonToResponse(json.get());
+  }
+
+  std::string storage;
+  const auto body = getBody(response, &storage);
+  Json::Value json;
+  // without the header, the whole body is JSON
+  auto binary = splitBinaryBody(
+    body, header_length.empty() ? std::to_string(body.size()) : header_length,
+    &json);
+  return mapJsonToResponse(&json, binary);
 }
 
 InferenceResponseFuture HttpClient::modelInferAsync(
   const std::string& model, const InferenceRequest& request) const {
-  auto req = createInferenceRequest(model, request, impl_->getHeaders());
   auto prom = std::make_shared<std::promise<amdinfer::InferenceResponse>>();
   auto fut = prom->get_future();
+  this->modelInferAsync(model, request,
+                        [prom](const InferenceResponse& response) {
+                          prom->set_value(response);
+                        });
+  return fut;
+}
 
-  auto* client = this->impl_->getClient();
-  client->sendRequest(req, [prom](drogon::ReqResult result,
-                                  const drogon::HttpResponsePtr& response) {
+void HttpClient::modelInferAsync(const std::string& model,
+                                 const InferenceRequest& request,
+                                 Callback callback) const {
+  auto req = createInferenceRequest(model, request, impl_->useBinary(*this),
+                                    impl_->getHeaders(),
+                                    impl_->getCompression());
+
+  auto client = this->impl_->getClient();
+  auto* connection = client.get();
+  // the request is finished on its connection once the response arrives
+  connection->sendRequest(req, [callback = std::move(callback),
+                                impl = this->impl_.get(),
+                                index = client.release()](
+                                 drogon::ReqResult result,
+                                 const drogon::HttpResponsePtr& response) {
+    impl->finish(index);
     // throwing exceptions asynchronously makes them difficult to process so
     // just return an error object. Unfortunately, there's no way to know which
     // request just errored out since response is likely nullptr if Drogon
@@ -305,37 +488,86 @@ InferenceResponseFuture HttpClient::modelInferAsync(
       if (response->statusCode() != drogon::k200OK) {
         throw bad_status(std::string(response->body()));
       }
-    } catch (const bad_status& e) {
+      callback(parseInferenceResponse(response));
+    } catch (const runtime_error& e) {
       error = e.what();
     }
-    if (error.empty()) {
-      auto resp = response->jsonObject();
-      prom->set_value(mapJsonToResponse(resp.get()));
-    } else {
-      prom->set_value(InferenceResponse(error));
+    if (!error.empty()) {
+      callback(InferenceResponse(error));
     }
   });
-
-  return fut;
 }
 
 InferenceResponse HttpClient::modelInfer(
   const std::string& model, const InferenceRequest& request) const {
-  auto req = createInferenceRequest(model, request, impl_->getHeaders());
+  auto req = createInferenceRequest(model, request, impl_->useBinary(*this),
+                                    impl_->getHeaders(),
+                                    impl_->getCompression());
 
-  auto* client = this->impl_->getClient();
+  auto client = this->impl_->getClient();
   auto [result, response] = client->sendRequest(req);
   checkError(result);
   if (response->statusCode() != drogon::k200OK) {
     throw bad_status(std::string{response->body()});
   }
 
-  auto resp = response->jsonObject();
-  return mapJsonToResponse(resp.get());
+  return parseInferenceResponse(response);
+}
+
+std::vector<InferenceResponse> HttpClient::modelInferBatch(
+  const std::string& model,
+  const std::vector<InferenceRequest>& requests) const {
+  // the requests are written whole into one JSON array
+  std::string body = R"({"requests":[)";
+  std::string json;
+  for (auto i = 0U; i < requests.size(); ++i) {
+    if (requests[i].getInputs().empty()) {
+      throw invalid_argument("The request's inputs cannot be empty");
+    }
+    writeRequest(requests[i], false, &json);
+    if (i > 0) {
+      body += ',';
+    }
+    body += json;
+  }
+  body += "]}";
+
+  auto req = drogon::HttpRequest::newHttpRequest();
+  req->setMethod(drogon::Post);
+  req->setPath("/v2/models/" + model + "/infer_batch");
+  req->setContentTypeCode(drogon::ContentType::CT_APPLICATION_JSON);
+  setBody(req, std::move(body), impl_->getHeaders(), impl_->getCompression());
+
+  auto client = this->impl_->getClient();
+  auto [result, response] = client->sendRequest(req);
+  checkError(result);
+  if (response->statusCode() != drogon::k200OK) {
+    throw bad_status(std::string{response->body()});
+  }
+
+  std::string storage;
+  const auto response_body = getBody(response, &storage);
+  Json::Value reply;
+  splitBinaryBody(response_body, std::to_string(response_body.size()),
+                  &reply);
+  auto& json_responses = reply["responses"];
+  if (!json_responses.isArray() || json_responses.size() != requests.size()) {
+    throw bad_status("Expected a response for each request");
+  }
+  std::vector<InferenceResponse> responses;
+  responses.reserve(requests.size());
+  for (auto& json_response : json_responses) {
+    if (json_response.isMember("error")) {
+      responses.emplace_back(json_response["error"].asString());
+    } else {
+      responses.push_back(mapJsonToResponse(&json_response));
+    }
+  }
+  return responses;
 }
 
 std::vector<std::string> HttpClient::modelList() const {
-  auto* client = this->impl_->getClient();
+  auto client = this->impl_->getClient();
   auto req = createGetRequest("/v2/models", impl_->getHeaders());
 
   auto [result, response] = client->sendRequest(req);
@@ -355,7 +587,7 @@ std::vector<std::string> HttpClient::modelList() const {
 }
 
 bool HttpClient::hasHardware(const std::string& name, int num) const {
-  auto* client = this->impl_->getClient();
+  auto client = this->impl_->getClient();
 
   Json::Value json;
   json["name"] = name;
@@ -32,11 +32,16 @@
 #include <cstddef>      // for size_t, byte
 #include <cstdint>      // for uint64_t, int32_t
 #include <cstring>      // for memcpy
+#include <memory>       // for unique_ptr
+#include <stdexcept>    // for invalid_argument, logic_error
+#include <string>       // for string, stoull
 #include <string_view>  // for basic_string_view
 #include <utility>      // for move
 #include <variant>      // for visit
 
 #include "amdinfer/buffers/buffer.hpp"           // for Buffer
+#include "amdinfer/clients/json_writer.hpp"      // for JsonWriter
+#include "amdinfer/core/bytes_tensor.hpp"        // for BytesView, encodeBytes
 #include "amdinfer/core/data_types.hpp"          // for DataType, mapTypeToStr
 #include "amdinfer/core/exceptions.hpp"          // invalid_argument
 #include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
@@ -118,10 +123,87 @@ struct SetOutputData {
   }
 };
 
-InferenceResponse mapJsonToResponse(Json::Value *json) {
+std::string_view splitBinaryBody(std::string_view body,
+                                 const std::string &header_length,
+                                 Json::Value *json) {
+  size_t length = 0;
+  try {
+    size_t pos = 0;
+    length = std::stoull(header_length, &pos);
+    if (pos != header_length.size()) {
+      throw std::invalid_argument(header_length);
+    }
+  } catch (const std::logic_error &) {
+    throw invalid_argument("Invalid Inference-Header-Content-Length: " +
+                           header_length);
+  }
+  if (length > body.size()) {
+    throw invalid_argument(
+      "Inference-Header-Content-Length is larger than the body");
+  }
+
+  std::string errors;
+  Json::CharReaderBuilder builder;
+  std::unique_ptr<Json::CharReader> reader{builder.newCharReader()};
+  if (!reader->parse(body.data(), body.data() + length, json, &errors)) {
+    throw invalid_argument("Failed to interpret the inference header as JSON");
+  }
+  return body.substr(length);
+}
+
+namespace {
+
+/**
+ * @brief Set the data of a BYTES output. Its shape on the wire counts its
+ * elements so it's checked against them and then replaced with the size of
+ * their encoding.
+ *
+ * @param json the output
+ * @param binary the binary data of the response
+ * @param output the output, whose shape is the response's
+ */
+void setBytesOutput(const Json::Value &json, std::string_view *binary,
+                    InferenceResponseOutput *output) {
+  std::vector<std::byte> data;
+  const auto &parameters = json["parameters"];
+  if (parameters.isMember(kBinaryDataSize)) {
+    const auto size = parameters[kBinaryDataSize].asUInt64();
+    if (size > binary->size()) {
+      throw invalid_argument("Binary data for output " + output->getName() +
+                             " exceeds the body");
+    }
+    // the raw data is already in the layout BYTES tensors use
+    data.resize(size);
+    memcpy(data.data(), binary->data(), size);
+    binary->remove_prefix(size);
+  } else {
+    std::vector<std::string_view> elements;
+    for (const auto &datum : json["data"]) {
+      const char *begin = nullptr;
+      const char *end = nullptr;
+      if (!datum.getString(&begin, &end)) {
+        throw invalid_argument("The elements of BYTES data must be strings");
+      }
+      elements.emplace_back(begin, end - begin);
+    }
+    data = encodeBytes(elements);
+  }
+  checkBytesShape(BytesView{data.data(), data.size()}.size(),
+                  output->getShape(), output->getName());
+  output->setShape({data.size()});
+  output->setData(std::move(data));
+}
+
+}  // namespace
+
+InferenceResponse mapJsonToResponse(Json::Value *json,
+                                    std::string_view binary) {
   InferenceResponse response;
   response.setModel(json->get("model_name", "").asString());
   response.setID(json->get("id", "").asString());
+  if (json->isMember("parameters")) {
+    response.setParameters(mapJsonToParameters((*json)["parameters"]));
+  }
 
   auto json_outputs = json->get("outputs", Json::arrayValue);
   for (const auto &json_output : json_outputs) {
@@ -137,15 +219,62 @@ InferenceResponse mapJsonToResponse(Json::Value *json) {
       shape.push_back(index.asUInt());
     }
     output.setShape(shape);
-    const auto &json_data = json_output["data"];
-    switchOverTypes(SetOutputData(), output.getDatatype(), json_data, &output);
-    response.addOutput(output);
+    const auto &parameters = json_output["parameters"];
+    if (output.getDatatype() == DataType::Bytes) {
+      setBytesOutput(json_output, &binary, &output);
+    } else if (parameters.isMember(kBinaryDataSize)) {
+      const auto size = parameters[kBinaryDataSize].asUInt64();
+      if (size > binary.size()) {
+        throw invalid_argument("Binary data for output " + output.getName() +
+                               " exceeds the body");
+      }
+      std::vector<std::byte> data(size);
+      memcpy(data.data(), binary.data(), size);
+      output.setData(std::move(data));
+      binary.remove_prefix(size);
+    } else {
+      const auto &json_data = json_output["data"];
+      switchOverTypes(SetOutputData(), output.getDatatype(), json_data,
+                      &output);
+    }
+    response.addOutput(std::move(output));
   }
 
   return response;
 }
 
-Json::Value mapRequestToJson(const InferenceRequest &request) {
+namespace {
+
+/**
+ * @brief Add the data of a BYTES input, sending its number of elements as its
+ * shape
+ *
+ * @param input the input
+ * @param binary the binary data of the request, if it uses that extension
+ * @param json the input's JSON
+ */
+void addBytesInput(const InferenceRequestInput &input, std::string *binary,
+                   Json::Value *json) {
+  const BytesView elements{input.getData(), input.getSize()};
+  (*json)["shape"].append(static_cast<Json::UInt64>(elements.size()));
+  if (binary != nullptr) {
+    binary->append(static_cast<const char *>(input.getData()),
+                   input.getSize());
+    (*json)["parameters"][kBinaryDataSize] =
+      static_cast<Json::UInt64>(input.getSize());
+  } else {
+    (*json)["data"] = Json::arrayValue;
+    for (const auto &element : elements) {
+      (*json)["data"].append(
+        Json::Value{element.data(), element.data() + element.size()});
+    }
+  }
+}
+
+}  // namespace
+
+Json::Value mapRequestToJson(const InferenceRequest &request,
+                             std::string *binary) {
   Json::Value json;
   json["id"] = request.getID();
   const auto &parameters = request.getParameters();
@@ -158,12 +287,25 @@ Json::Value mapRequestToJson(const InferenceRequest &request) {
     json_input["datatype"] = input.getDatatype().str();
     json_input["parameters"] = mapParametersToJson(input.getParameters());
     json_input["shape"] = Json::arrayValue;
+    const auto datatype = input.getDatatype();
+    if (datatype == DataType::Bytes) {
+      addBytesInput(input, binary, &json_input);
+      json["inputs"].append(json_input);
+      continue;
+    }
     for (const auto &index : input.getShape()) {
       json_input["shape"].append(static_cast<Json::UInt64>(index));
     }
-    json_input["data"] = Json::arrayValue;
-    switchOverTypes(SetInputData(), input.getDatatype(), &(json_input["data"]),
-                    input.getData(), input.getSize());
+    if (binary != nullptr && datatype != DataType::String) {
+      const auto size = input.getSize() * datatype.size();
+      binary->append(static_cast<const char *>(input.getData()), size);
+      json_input["parameters"][kBinaryDataSize] =
+        static_cast<Json::UInt64>(size);
+    } else {
+      json_input["data"] = Json::arrayValue;
+      switchOverTypes(SetInputData(), datatype, &(json_input["data"]),
+                      input.getData(), input.getSize());
+    }
     json["inputs"].append(json_input);
   }
 
@@ -172,6 +314,122 @@ Json::Value mapRequestToJson(const InferenceRequest &request) {
   return json;
 }
 
+namespace {
+
+/// Upper bound on the JSON of an input around its data, besides its name
+constexpr size_t kInputJsonOverhead = 256;
+
+/**
+ * @brief Write the members of a JSON object holding the parameters
+ *
+ * @param writer the writer, inside the object
+ * @param parameters the parameters
+ * @param skip a parameter to leave out because the caller writes it itself
+ */
+void writeParameters(JsonWriter *writer, const ParameterMap &parameters,
+                     std::string_view skip = {}) {
+  for (const auto &[key, value] : parameters) {
+    if (key == skip) {
+      continue;
+    }
+    writer->key(key);
+    std::visit(
+      Overloaded{[&](bool arg) { writer->boolean(arg); },
+                 [&](double arg) { writer->number(arg); },
+                 [&](int32_t arg) { writer->number(int64_t{arg}); },
+                 [&](const std::string &arg) { writer->string(arg); }},
+      value);
+  }
+}
+
+void writeInput(JsonWriter *writer, const InferenceRequestInput &input,
+                bool binary) {
+  const auto datatype = input.getDatatype();
+  writer->beginObject();
+  writer->key("name");
+  writer->string(input.getName());
+  writer->key("datatype");
+  writer->string(datatype.str());
+  writer->key("shape");
+  writer->beginArray();
+  if (datatype == DataType::Bytes) {
+    // BYTES tensors send their number of elements as their shape
+    const BytesView elements{input.getData(), input.getSize()};
+    writer->number(uint64_t{elements.size()});
+  } else {
+    for (const auto &index : input.getShape()) {
+      writer->number(uint64_t{index});
+    }
+  }
+  writer->endArray();
+  writer->key("parameters");
+  writer->beginObject();
+  writeParameters(writer, input.getParameters(), kBinaryDataSize);
+  if (binary) {
+    writer->key(kBinaryDataSize);
+    writer->number(uint64_t{input.getSize() * datatype.size()});
+  }
+  writer->endObject();
+  if (!binary) {
+    writer->key("data");
+    writer->array(datatype, input.getData(), input.getSize());
+  }
+  writer->endObject();
+}
+
+}  // namespace
+
+size_t writeRequest(const InferenceRequest &request, bool binary,
+                    std::string *body) {
+  const auto &inputs = request.getInputs();
+  // STRING inputs stay in the JSON even with the binary extension
+  const auto is_binary = [binary](const InferenceRequestInput &input) {
+    return binary && input.getDatatype() != DataType::String;
+  };
+
+  // reserve the whole body so writing it doesn't reallocate
+  size_t capacity = kInputJsonOverhead;
+  for (const auto &input : inputs) {
+    const auto datatype = input.getDatatype();
+    capacity += kInputJsonOverhead + input.getName().size();
+    capacity += is_binary(input)
+                  ? input.getSize() * datatype.size()
+                  : getMaxJsonSize(datatype, input.getSize());
+  }
+  body->clear();
+  body->reserve(capacity);
+
+  JsonWriter writer{body};
+  writer.beginObject();
+  writer.key("id");
+  writer.string(request.getID());
+  writer.key("parameters");
+  writer.beginObject();
+  const auto &parameters = request.getParameters();
+  writeParameters(&writer, parameters);
+  if (binary && !parameters.has("binary_data_output")) {
+    writer.key("binary_data_output");
+    writer.boolean(true);
+  }
+  writer.endObject();
+  writer.key("inputs");
+  writer.beginArray();
+  for (const auto &input : inputs) {
+    writeInput(&writer, input, is_binary(input));
+  }
+  writer.endArray();
+  writer.endObject();
+
+  const auto header_length = body->size();
+  for (const auto &input : inputs) {
+    if (is_binary(input)) {
+      body->append(static_cast<const char *>(input.getData()),
+                   input.getSize() * input.getDatatype().size());
+    }
+  }
+  return header_length;
+}
+
 using drogon::HttpStatusCode;
 
 #ifdef AMDINFER_ENABLE_TRACING
@@ -206,6 +464,9 @@ Json::Value modelMetadataToJson(const ModelMetadata &metadata) {
   for (const auto &output : metadata.getOutputs()) {
     ret["inputs"].append(modelMetadataTensorToJson(output));
   }
+  if (!metadata.getParameters().empty()) {
+    ret["parameters"] = mapParametersToJson(metadata.getParameters());
+  }
   return ret;
 }
 
@@ -230,6 +491,9 @@ ModelMetadata mapJsonToModelMetadata(const Json::Value *json) {
     metadata.addOutputTensor(output["name"].asString(), shape,
                              DataType(output["datatype"].asString().c_str()));
   }
+  if (json->isMember("parameters")) {
+    metadata.setParameters(mapJsonToParameters((*json)["parameters"]));
+  }
   return metadata;
 }
 
@@ -25,15 +25,16 @@
 #include <drogon/HttpResponse.h>  // for HttpResponsePtr
 #include <json/value.h>           // for Value
 
-#include <cstddef>     // for size_t
-#include <exception>   // for invalid_argument
-#include <functional>  // for function
-#include <memory>      // for shared_ptr
-#include <string>      // for string
-#include <vector>      // for vector
+#include <cstddef>      // for size_t
+#include <exception>    // for invalid_argument
+#include <functional>   // for function
+#include <memory>       // for shared_ptr
+#include <string>       // for string
+#include <string_view>  // for string_view
+#include <vector>       // for vector
 
 #include "amdinfer/build_options.hpp"        // for AMDINFER_ENABLE_TRA...
-#include "amdinfer/core/data_types.hpp"      // for fp16
+#include "amdinfer/core/data_types.hpp"      // for fp16, bf16
 #include "amdinfer/core/model_metadata.hpp"  // for ModelMetadata
 #include "amdinfer/core/parameters.hpp"      // for ParameterMap (ptr ...
 #include "amdinfer/declarations.hpp"         // for BufferRawPtrs, Infe...
@@ -50,8 +51,64 @@ namespace amdinfer {
 ParameterMap mapJsonToParameters(Json::Value json);
 Json::Value mapParametersToJson(const ParameterMap &parameters);
 
-InferenceResponse mapJsonToResponse(Json::Value *json);
-Json::Value mapRequestToJson(const InferenceRequest &request);
+/// HTTP header holding the size of the JSON header in a binary tensor body
+constexpr auto kInferenceHeaderContentLength =
+  "Inference-Header-Content-Length";
+/// Tensor parameter holding the size of its data in the binary section
+constexpr auto kBinaryDataSize = "binary_data_size";
+
+/**
+ * @brief Split a body using the binary tensor data extension. The first
+ * header_length bytes of the body are parsed as JSON into json and the rest of
+ * the body is returned, holding the binary data of the tensors.
+ *
+ * @param body the full HTTP body
+ * @param header_length value of the Inference-Header-Content-Length header
+ * @param json the parsed JSON header
+ * @return std::string_view the binary data following the JSON header
+ */
+std::string_view splitBinaryBody(std::string_view body,
+                                 const std::string &header_length,
+                                 Json::Value *json);
+
+/**
+ * @brief Convert a JSON response to an InferenceResponse. Outputs that have
+ * the binary_data_size parameter take their data from the binary section, in
+ * order, instead of from the JSON.
+ *
+ * @param json the JSON response
+ * @param binary binary section of the body, if any
+ * @return InferenceResponse
+ */
+InferenceResponse mapJsonToResponse(Json::Value *json,
+                                    std::string_view binary = {});
+
+/**
+ * @brief Convert an InferenceRequest to JSON. If binary is not null, the data
+ * of all non-string inputs is appended to it instead of being added to the
+ * JSON as arrays.
+ *
+ * @param request the request to convert
+ * @param binary the binary section of the body to build, if any
+ * @return Json::Value
+ */
+Json::Value mapRequestToJson(const InferenceRequest &request,
+                             std::string *binary = nullptr);
+
+/**
+ * @brief Write the body of an inference request straight from its tensors
+ * without building a JSON DOM. With the binary tensor data extension, the data
+ * of all non-string inputs follows the JSON header as raw bytes and the
+ * outputs are requested as binary data, unless the request's parameters
+ * already say otherwise.
+ *
+ * @param request the request to write
+ * @param binary whether to use the binary tensor data extension
+ * @param body the body, which is replaced
+ * @return size_t - the size of the JSON header at the start of the body
+ */
+size_t writeRequest(const InferenceRequest &request, bool binary,
+                    std::string *body);
 
 #ifdef AMDINFER_ENABLE_TRACING
 void propagate(drogon::HttpResponse *resp, const StringMap &context);
@@ -77,6 +134,8 @@ struct SetInputData {
           return data_ptr[index];
         } else if constexpr (util::is_any_v<T, fp16>) {
           return half_float::half_cast<float>(data_ptr[index]);
+        } else if constexpr (util::is_any_v<T, bf16>) {
+          return static_cast<float>(data_ptr[index]);
         } else {
           static_assert(!sizeof(T), "Invalid type to SetInputData");
         }
@@ -101,7 +160,7 @@ constexpr auto jsonValueToType(const Json::Value &datum) {
     return datum.asInt();
   } else if constexpr (std::is_same_v<T, int64_t>) {
     return datum.asInt64();
-  } else if constexpr (util::is_any_v<T, fp16, float>) {
+  } else if constexpr (util::is_any_v<T, fp16, bf16, float>) {
     return datum.asFloat();
   } else if constexpr (std::is_same_v<T, double>) {
     return datum.asDouble();
@@ -0,0 +1,273 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements a writer for JSON bodies that formats the tensor data
+ * straight into the body instead of building a JSON DOM
+ */
+
+#include "amdinfer/clients/json_writer.hpp"
+
+#include <json/writer.h>  // for StreamWriterBuilder, writeString
+
+#include <charconv>     // for to_chars
+#include <cmath>        // for isnan, isinf
+#include <cstring>      // for memcpy
+#include <limits>       // for numeric_limits
+#include <string>       // for string
+#include <string_view>  // for string_view
+#include <type_traits>  // for is_same_v, is_floating_point_v
+
+#include "amdinfer/core/bytes_tensor.hpp"  // for BytesView
+#include "amdinfer/core/data_types.hpp"    // for DataType, switchOverTypes
+#include "amdinfer/util/traits.hpp"        // for is_any_v
+
+namespace amdinfer {
+
+namespace {
+
+/// The longest text of one element of type T
+template <typename T>
+constexpr size_t getMaxChars() {
+  if constexpr (std::is_same_v<T, bool>) {
+    return sizeof("false") - 1;
+  } else if constexpr (util::is_any_v<T, fp16, bf16>) {
+    return getMaxChars<float>();
+  } else if constexpr (std::is_floating_point_v<T>) {
+    // the sign, point, exponent and a ".0" suffix around the digits
+    const auto extra = 9;
+    return std::numeric_limits<T>::max_digits10 + extra;
+  } else {
+    // the sign and the partial digit digits10 leaves out
+    return std::numeric_limits<T>::digits10 + 2;
+  }
+}
+
+/// Escaped characters take up to six characters, as in \u001f
+constexpr size_t kMaxEscapedChars = 6;
+
+char* copyText(char* dest, std::string_view text) {
+  std::memcpy(dest, text.data(), text.size());
+  return dest + text.size();
+}
+
+template <typename T>
+char* formatFloat(char* dest, char* end, T value) {
+  // JSON has no NaN or infinity so they're written as jsoncpp writes them
+  if (std::isnan(value)) {
+    return copyText(dest, "null");
+  }
+  if (std::isinf(value)) {
+    return copyText(dest, value < 0 ? "-1e+9999" : "1e+9999");
+  }
+  auto* ptr = std::to_chars(dest, end, value).ptr;
+  // keep floats recognizable as floats like jsoncpp does
+  for (auto* c = dest; c < ptr; ++c) {
+    if (*c == '.' || *c == 'e') {
+      return ptr;
+    }
+  }
+  return copyText(ptr, ".0");
+}
+
+/// Format a value at dest, which must have getMaxChars<T>() characters
+template <typename T>
+char* formatNumber(char* dest, T value) {
+  auto* end = dest + getMaxChars<T>();
+  if constexpr (std::is_same_v<T, bool>) {
+    return copyText(dest, value ? "true" : "false");
+  } else if constexpr (util::is_any_v<T, fp16, bf16>) {
+    return formatFloat(dest, end, static_cast<float>(value));
+  } else if constexpr (std::is_floating_point_v<T>) {
+    return formatFloat(dest, end, value);
+  } else {
+    return std::to_chars(dest, end, value).ptr;
+  }
+}
+
+void escape(std::string* out, std::string_view value) {
+  const auto start = out->size();
+  out->resize(start + value.size() * kMaxEscapedChars + 2);
+  auto* ptr = out->data() + start;
+  *ptr++ = '"';
+  for (const auto c : value) {
+    const auto byte = static_cast<unsigned char>(c);
+    if (c == '"' || c == '\\') {
+      *ptr++ = '\\';
+      *ptr++ = c;
+    } else if (c == '\n') {
+      ptr = copyText(ptr, "\\n");
+    } else if (c == '\r') {
+      ptr = copyText(ptr, "\\r");
+    } else if (c == '\t') {
+      ptr = copyText(ptr, "\\t");
+    } else if (byte < 0x20) {
+      constexpr std::string_view kHex = "0123456789abcdef";
+      const auto nibble = 4;
+      ptr = copyText(ptr, "\\u00");
+      *ptr++ = kHex[byte >> nibble];
+      *ptr++ = kHex[byte & 0xF];
+    } else {
+      *ptr++ = c;
+    }
+  }
+  *ptr++ = '"';
+  out->resize(ptr - out->data());
+}
+
+struct MaxJsonSize {
+  template <typename T>
+  size_t operator()(size_t count) const {
+    if constexpr (std::is_same_v<T, char>) {
+      // BYTES elements are shorter than their length so this covers them too
+      return count * kMaxEscapedChars + 2;
+    } else {
+      // each element is followed by a comma, except the last, and the
+      // brackets fit in the leftover
+      return count * (getMaxChars<T>() + 1) + 2;
+    }
+  }
+};
+
+template <typename T>
+void appendNumber(std::string* out, T value) {
+  const auto start = out->size();
+  out->resize(start + getMaxChars<T>());
+  auto* ptr = formatNumber(out->data() + start, value);
+  out->resize(ptr - out->data());
+}
+
+struct WriteArray {
+  template <typename T>
+  void operator()(std::string* out, const void* data, size_t count) const {
+    if constexpr (std::is_same_v<T, char>) {
+      out->push_back('[');
+      escape(out, {static_cast<const char*>(data), count});
+      out->push_back(']');
+    } else {
+      // the array is formatted in place in the string, which is only grown
+      // once for all the elements and then trimmed
+      const auto* values = static_cast<const T*>(data);
+      const auto start = out->size();
+      out->resize(start + MaxJsonSize().operator()<T>(count));
+      auto* ptr = out->data() + start;
+      *ptr++ = '[';
+      for (size_t i = 0; i < count; ++i) {
+        if (i > 0) {
+          *ptr++ = ',';
+        }
+        ptr = formatNumber(ptr, values[i]);
+      }
+      *ptr++ = ']';
+      out->resize(ptr - out->data());
+    }
+  }
+};
+
+}  // namespace
+
+JsonWriter::JsonWriter(std::string* out) : out_(out) {}
+
+void JsonWriter::separate() {
+  if (after_key_) {
+    after_key_ = false;
+  } else if (!first_) {
+    out_->push_back(',');
+  }
+  first_ = false;
+}
+
+void JsonWriter::beginObject() {
+  separate();
+  out_->push_back('{');
+  first_ = true;
+}
+
+void JsonWriter::endObject() {
+  out_->push_back('}');
+  first_ = false;
+}
+
+void JsonWriter::beginArray() {
+  separate();
+  out_->push_back('[');
+  first_ = true;
+}
+
+void JsonWriter::endArray() {
+  out_->push_back(']');
+  first_ = false;
+}
+
+void JsonWriter::key(std::string_view key) {
+  separate();
+  escape(out_, key);
+  out_->push_back(':');
+  after_key_ = true;
+}
+
+void JsonWriter::string(std::string_view value) {
+  separate();
+  escape(out_, value);
+}
+
+void JsonWriter::boolean(bool value) {
+  separate();
+  out_->append(value ? "true" : "false");
+}
+
+void JsonWriter::number(int64_t value) {
+  separate();
+  appendNumber(out_, value);
+}
+
+void JsonWriter::number(uint64_t value) {
+  separate();
+  appendNumber(out_, value);
+}
+
+void JsonWriter::number(double value) {
+  separate();
+  appendNumber(out_, value);
+}
+
+void JsonWriter::json(const Json::Value& value) {
+  static const auto builder = [] {
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "";
+    return builder;
+  }();
+  separate();
+  out_->append(Json::writeString(builder, value));
+}
+
+void JsonWriter::array(DataType datatype, const void* data, size_t count) {
+  if (datatype == DataType::Bytes) {
+    beginArray();
+    for (const auto& element : BytesView{data, count}) {
+      string(element);
+    }
+    endArray();
+    return;
+  }
+  separate();
+  switchOverTypes(WriteArray(), datatype, out_, data, count);
+}
+
+size_t getMaxJsonSize(DataType datatype, size_t count) {
+  return switchOverTypes(MaxJsonSize(), datatype, count);
+}
+
+}  // namespace amdinfer
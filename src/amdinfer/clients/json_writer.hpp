@@ -0,0 +1,99 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines a writer for JSON bodies that formats the tensor data
+ * straight into the body instead of building a JSON DOM
+ */
+
+#ifndef GUARD_AMDINFER_CLIENTS_JSON_WRITER
+#define GUARD_AMDINFER_CLIENTS_JSON_WRITER
+
+#include <json/value.h>  // for Value
+
+#include <cstddef>      // for size_t
+#include <cstdint>      // for int64_t, uint64_t
+#include <string>       // for string
+#include <string_view>  // for string_view
+
+#include "amdinfer/core/data_types.hpp"  // for DataType
+
+namespace amdinfer {
+
+/**
+ * @brief Writes JSON text into a string as it goes. Members and elements are
+ * separated automatically so objects are written as a sequence of key() and
+ * value calls between beginObject() and endObject(). The data of tensors is
+ * formatted with std::to_chars, which for floats gives the shortest text that
+ * reads back as the same value.
+ */
+class JsonWriter {
+ public:
+  /**
+   * @brief Construct a new JsonWriter object
+   *
+   * @param out the string to append to, which must outlive the writer
+   */
+  explicit JsonWriter(std::string* out);
+
+  void beginObject();
+  void endObject();
+  void beginArray();
+  void endArray();
+
+  /// Write the key of the next member of the current object
+  void key(std::string_view key);
+  /// Write a string, escaping it as needed
+  void string(std::string_view value);
+  void boolean(bool value);
+  void number(int64_t value);
+  void number(uint64_t value);
+  void number(double value);
+  /// Write a value from a JSON DOM, such as the parameters of a tensor
+  void json(const Json::Value& value);
+
+  /**
+   * @brief Write the data of a tensor as an array. STRING tensors are written
+   * as one string and BYTES tensors as an array of their elements.
+   *
+   * @param datatype the datatype of the data
+   * @param data the data
+   * @param count the number of elements for numeric and STRING tensors or the
+   * size in bytes for BYTES tensors
+   */
+  void array(DataType datatype, const void* data, size_t count);
+
+ private:
+  /// Write the separator before the next value, if it needs one
+  void separate();
+
+  std::string* out_;
+  bool first_ = true;
+  bool after_key_ = false;
+};
+
+/**
+ * @brief Get an upper bound on the text of an array of the tensor data, which
+ * can be used to reserve the body before writing it
+ *
+ * @param datatype the datatype of the data
+ * @param count the number of elements
+ * @return size_t
+ */
+size_t getMaxJsonSize(DataType datatype, size_t count);
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_CLIENTS_JSON_WRITER
@@ -21,6 +21,7 @@
 
 #include "amdinfer/clients/native.hpp"
 
+#include <cstddef>  // for size_t
 #include <future>   // for future, promise
 #include <memory>   // for unique_ptr, make_unique
 #include <string>   // for string
@@ -58,7 +59,9 @@ ServerMetadata NativeClient::serverMetadata() const {
   return SharedState::serverMetadata();
 }
 bool NativeClient::serverLive() const { return true; }
-bool NativeClient::serverReady() const { return true; }
+bool NativeClient::serverReady() const {
+  return impl_->state->serverReady();
+}
 
 ModelMetadata NativeClient::modelMetadata(const std::string& model) const {
   return impl_->state->modelMetadata(model);
@@ -93,40 +96,89 @@ InferenceRequestPtr getRequest(const InferenceRequest& req,
   return request;
 }
 
+/**
+ * @brief Let the batcher read the request's inputs where they are. Workers
+ * that accept scatter-gather batches read them in place and the others have
+ * them copied straight into their batch buffers, so they're never staged in
+ * the pool.
+ */
+void viewInputs(const InferenceRequest& request, RequestContainer* container) {
+  const auto& inputs = request.getInputs();
+  container->input_views.reserve(inputs.size());
+  container->input_writers.reserve(inputs.size());
+  for (const auto& input : inputs) {
+    const auto* data = input.getData();
+    const auto size = input.getSize() * input.getDatatype().size();
+    container->input_views.push_back(data);
+    container->input_writers.emplace_back(
+      [data, size](Buffer* buffer, size_t offset) {
+        buffer->write(data, offset, size);
+      });
+  }
+}
+
 InferenceResponseFuture setCallback(InferenceRequest* request) {
-  auto promise = std::make_shared<std::promise<amdinfer::InferenceResponse>>();
-  auto future = promise->get_future();
-  Callback callback = [promise](const InferenceResponse& response) {
-    promise->set_value(response);
-  };
-  request->setCallback(std::move(callback));
+  // the callback is move-only so it can own the promise without allocating
+  std::promise<InferenceResponse> promise;
+  auto future = promise.get_future();
+  request->setCallback([promise = std::move(promise)](
+                         const InferenceResponse& response) mutable {
+    promise.set_value(response);
+  });
   return future;
 }
 
-InferenceResponseFuture NativeClient::modelInferAsync(
-  const std::string& model, const InferenceRequest& request) const {
+/// Start a container for a new request, whose trace is started if tracing
+std::unique_ptr<RequestContainer> startRequest() {
 #ifdef AMDINFER_ENABLE_METRICS
   Metrics::getInstance().incrementCounter(MetricCounterIDs::CppNative);
 #endif
+  auto request_container = std::make_unique<RequestContainer>();
+#ifdef AMDINFER_ENABLE_TRACING
+  request_container->trace = startTrace("modelInferAsync");
+  request_container->trace->startSpan("C++ enqueue");
+#endif
+  return request_container;
+}
 
+void submitRequest(SharedState* state, const std::string& model,
+                   std::unique_ptr<RequestContainer> request_container) {
 #ifdef AMDINFER_ENABLE_TRACING
-  auto trace = startTrace(&(__func__[0]));
-  trace->startSpan("C++ enqueue");
+  request_container->trace->endSpan();
 #endif
+  state->modelInfer(model, std::move(request_container));
+}
+
+InferenceResponseFuture NativeClient::modelInferAsync(
+  const std::string& model, const InferenceRequest& request) const {
+  auto request_container = startRequest();
   auto new_request = getRequest(request, impl_->state->getPool());
   auto future = setCallback(new_request.get());
-  auto request_container = std::make_unique<RequestContainer>();
   request_container->request = std::move(new_request);
+  submitRequest(impl_->state, model, std::move(request_container));
+  return future;
+}
 
-#ifdef AMDINFER_ENABLE_TRACING
-  trace->endSpan();
-  request_container->trace = std::move(trace);
-#endif
-  impl_->state->modelInfer(model, std::move(request_container));
-
+InferenceResponseFuture NativeClient::modelInferAsync(
+  const std::string& model, InferenceRequestPtr request) const {
+  auto request_container = startRequest();
+  viewInputs(*request, request_container.get());
+  auto future = setCallback(request.get());
+  request_container->request = std::move(request);
+  submitRequest(impl_->state, model, std::move(request_container));
   return future;
 }
 
+void NativeClient::modelInferAsync(const std::string& model,
+                                   InferenceRequestPtr request,
+                                   Callback callback) const {
+  auto request_container = startRequest();
+  viewInputs(*request, request_container.get());
+  request->setCallback(std::move(callback));
+  request_container->request = std::move(request);
+  submitRequest(impl_->state, model, std::move(request_container));
+}
+
 InferenceResponse NativeClient::modelInfer(
   const std::string& model, const InferenceRequest& request) const {
   auto future = modelInferAsync(model, request);
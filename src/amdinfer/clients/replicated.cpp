@@ -0,0 +1,468 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the methods for spreading requests over several replicas
+ * of a server
+ */
+
+#include "amdinfer/clients/replicated.hpp"
+
+#include <algorithm>           // for nth_element, any_of, all_of
+#include <atomic>              // for atomic
+#include <chrono>              // for microseconds, duration
+#include <condition_variable>  // for condition_variable
+#include <cstddef>             // for size_t
+#include <exception>           // for exception, current_exception
+#include <future>              // for promise, future, future_status
+#include <limits>              // for numeric_limits
+#include <memory>              // for unique_ptr, make_unique
+#include <mutex>               // for mutex, lock_guard, unique_lock
+#include <optional>            // for optional
+#include <string>              // for string
+#include <thread>              // for thread
+#include <utility>             // for move
+#include <vector>              // for vector
+
+#include "amdinfer/core/exceptions.hpp"          // for invalid_argument
+#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/util/thread.hpp"              // for setThreadName
+#include "amdinfer/util/timer.hpp"               // for getTime, TimePoint
+
+namespace amdinfer {
+
+namespace {
+
+/// Weight of the latest request in a replica's moving average latency
+constexpr double kLatencyWeight = 0.2;
+/// Latency in us recorded for a request that failed to reach its replica
+constexpr double kFailureLatency = 1'000'000;
+/// Number of recent latencies that the hedging delay is taken from
+constexpr size_t kLatencyWindow = 128;
+/// Requests aren't hedged until this many latencies have been recorded
+constexpr size_t kMinHedgeSamples = 16;
+/// How often the requests in flight are checked for responses and hedging
+constexpr std::chrono::microseconds kPollInterval{50};
+
+struct Replica {
+  explicit Replica(std::unique_ptr<Client> client)
+    : client(std::move(client)) {}
+
+  std::unique_ptr<Client> client;
+  std::atomic<int> outstanding = 0;
+  /// moving average latency in us or zero if it's not been measured
+  double latency = 0;
+};
+
+/// A request sent to one replica
+struct Attempt {
+  Replica* replica;
+  InferenceResponseFuture future;
+  util::TimePoint start;
+};
+
+/// A request that's waiting for the response of one or more replicas
+struct Race {
+  std::string model;
+  /// kept to send the request again if it's hedged
+  InferenceRequest request;
+  std::vector<Attempt> attempts;
+  /// when the request is sent to a second replica
+  util::TimePoint hedge_at;
+  std::promise<InferenceResponse> promise;
+  /// the last error response, which is returned if no replica succeeds
+  std::optional<InferenceResponse> error;
+};
+
+bool isReady(const InferenceResponseFuture& future) {
+  return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+}  // namespace
+
+class ReplicatedClient::ReplicatedClientImpl {
+ public:
+  ReplicatedClientImpl(std::vector<std::unique_ptr<Client>> clients,
+                       double hedge_percentile)
+    : hedge_percentile_(hedge_percentile) {
+    if (clients.empty()) {
+      throw invalid_argument("A ReplicatedClient needs at least one replica");
+    }
+    if (hedge_percentile < 0 || hedge_percentile >= 1) {
+      throw invalid_argument("The hedge percentile must be in [0, 1)");
+    }
+    replicas_.reserve(clients.size());
+    for (auto& client : clients) {
+      replicas_.push_back(std::make_unique<Replica>(std::move(client)));
+    }
+    latencies_.reserve(kLatencyWindow);
+    watcher_ = std::thread{&ReplicatedClientImpl::watch, this};
+  }
+
+  ReplicatedClientImpl(const ReplicatedClientImpl&) = delete;
+  ReplicatedClientImpl& operator=(const ReplicatedClientImpl&) = delete;
+  ReplicatedClientImpl(ReplicatedClientImpl&&) = delete;
+  ReplicatedClientImpl& operator=(ReplicatedClientImpl&&) = delete;
+  ~ReplicatedClientImpl() {
+    {
+      std::lock_guard lock{mutex_};
+      stop_ = true;
+    }
+    cv_.notify_one();
+    watcher_.join();
+  }
+
+  /// Get the client of the replica that would take the next request
+  Client* getClient() { return getReplica(nullptr)->client.get(); }
+
+  [[nodiscard]] const std::vector<std::unique_ptr<Replica>>& replicas() const {
+    return replicas_;
+  }
+
+  [[nodiscard]] bool hedging() const {
+    return hedge_percentile_ > 0 && replicas_.size() > 1;
+  }
+
+  /// Make a request on the best replica and wait for its response inline
+  InferenceResponse infer(const std::string& model,
+                          const InferenceRequest& request);
+  /// Make a request that the watcher hedges and answers
+  InferenceResponseFuture inferAsync(const std::string& model,
+                                     const InferenceRequest& request);
+
+ private:
+  Replica* getReplica(const Replica* exclude);
+  Attempt send(Replica* replica, const std::string& model,
+               const InferenceRequest& request);
+  InferenceResponse collect(Attempt* attempt);
+  void record(Replica* replica, double latency);
+  util::TimePoint hedgeAt(util::TimePoint start);
+  bool advance(Race* race, util::TimePoint now, std::vector<Attempt>* losers);
+  void watch();
+
+  std::vector<std::unique_ptr<Replica>> replicas_;
+  double hedge_percentile_;
+  std::atomic<size_t> counter_ = 0;
+
+  /// guards the replicas' latencies and the recent latencies
+  std::mutex stats_mutex_;
+  std::vector<double> latencies_;
+  size_t next_latency_ = 0;
+
+  /// guards the incoming requests and stopping the watcher
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::vector<std::unique_ptr<Race>> incoming_;
+  bool stop_ = false;
+  std::thread watcher_;
+};
+
+Replica* ReplicatedClient::ReplicatedClientImpl::getReplica(
+  const Replica* exclude) {
+  // ties go to the replicas in turn so unmeasured ones are all tried
+  const auto start =
+    counter_.fetch_add(1, std::memory_order_relaxed) % replicas_.size();
+  Replica* best = nullptr;
+  auto best_score = std::numeric_limits<double>::max();
+  std::lock_guard lock{stats_mutex_};
+  for (auto i = 0U; i < replicas_.size(); ++i) {
+    auto* replica = replicas_[(start + i) % replicas_.size()].get();
+    if (replica == exclude) {
+      continue;
+    }
+    const auto outstanding =
+      replica->outstanding.load(std::memory_order_relaxed);
+    const auto score = replica->latency * (outstanding + 1);
+    if (best == nullptr || score < best_score) {
+      best = replica;
+      best_score = score;
+    }
+  }
+  return best;
+}
+
+Attempt ReplicatedClient::ReplicatedClientImpl::send(
+  Replica* replica, const std::string& model, const InferenceRequest& request) {
+  replica->outstanding.fetch_add(1, std::memory_order_relaxed);
+  const auto start = util::getTime();
+  try {
+    return {replica, replica->client->modelInferAsync(model, request), start};
+  } catch (const std::exception&) {
+    std::promise<InferenceResponse> promise;
+    promise.set_exception(std::current_exception());
+    return {replica, promise.get_future(), start};
+  }
+}
+
+InferenceResponse ReplicatedClient::ReplicatedClientImpl::collect(
+  Attempt* attempt) {
+  auto* replica = attempt->replica;
+  replica->outstanding.fetch_sub(1, std::memory_order_relaxed);
+  try {
+    auto response = attempt->future.get();
+    const std::chrono::duration<double, std::micro> latency =
+      util::getTime() - attempt->start;
+    record(replica, latency.count());
+    return response;
+  } catch (const std::exception& e) {
+    // replicas that can't be reached aren't tried again until the others slow
+    record(replica, kFailureLatency);
+    return InferenceResponse{e.what()};
+  }
+}
+
+void ReplicatedClient::ReplicatedClientImpl::record(Replica* replica,
+                                                    double latency) {
+  std::lock_guard lock{stats_mutex_};
+  replica->latency = replica->latency == 0
+                       ? latency
+                       : kLatencyWeight * latency +
+                           (1 - kLatencyWeight) * replica->latency;
+  if (latencies_.size() < kLatencyWindow) {
+    latencies_.push_back(latency);
+  } else {
+    latencies_[next_latency_] = latency;
+    next_latency_ = (next_latency_ + 1) % kLatencyWindow;
+  }
+}
+
+util::TimePoint ReplicatedClient::ReplicatedClientImpl::hedgeAt(
+  util::TimePoint start) {
+  if (!hedging()) {
+    return util::TimePoint::max();
+  }
+  std::vector<double> latencies;
+  {
+    std::lock_guard lock{stats_mutex_};
+    if (latencies_.size() < kMinHedgeSamples) {
+      return util::TimePoint::max();
+    }
+    latencies = latencies_;
+  }
+  const auto index = static_cast<size_t>(
+    hedge_percentile_ * static_cast<double>(latencies.size() - 1));
+  std::nth_element(latencies.begin(), latencies.begin() + index,
+                   latencies.end());
+  return start + std::chrono::duration_cast<util::TimePoint::duration>(
+                   std::chrono::duration<double, std::micro>(latencies[index]));
+}
+
+InferenceResponse ReplicatedClient::ReplicatedClientImpl::infer(
+  const std::string& model, const InferenceRequest& request) {
+  auto attempt = send(getReplica(nullptr), model, request);
+  return collect(&attempt);
+}
+
+InferenceResponseFuture ReplicatedClient::ReplicatedClientImpl::inferAsync(
+  const std::string& model, const InferenceRequest& request) {
+  auto race = std::make_unique<Race>();
+  race->model = model;
+  if (hedging()) {
+    race->request = request;
+  }
+  auto attempt = send(getReplica(nullptr), model, request);
+  race->hedge_at = hedgeAt(attempt.start);
+  race->attempts.push_back(std::move(attempt));
+  auto future = race->promise.get_future();
+  {
+    std::lock_guard lock{mutex_};
+    incoming_.push_back(std::move(race));
+  }
+  cv_.notify_one();
+  return future;
+}
+
+bool ReplicatedClient::ReplicatedClientImpl::advance(
+  Race* race, util::TimePoint now, std::vector<Attempt>* losers) {
+  auto& attempts = race->attempts;
+  for (auto it = attempts.begin(); it != attempts.end();) {
+    if (!isReady(it->future)) {
+      ++it;
+      continue;
+    }
+    auto response = collect(&(*it));
+    it = attempts.erase(it);
+    if (!response.isError()) {
+      // the others are still watched to keep their replicas' latencies
+      for (auto& attempt : attempts) {
+        losers->push_back(std::move(attempt));
+      }
+      race->promise.set_value(std::move(response));
+      return true;
+    }
+    race->error = std::move(response);
+  }
+  if (attempts.empty()) {
+    race->promise.set_value(std::move(race->error.value()));
+    return true;
+  }
+
+  if (now >= race->hedge_at) {
+    race->hedge_at = util::TimePoint::max();
+    auto* replica = getReplica(attempts.front().replica);
+    attempts.push_back(send(replica, race->model, race->request));
+  }
+  return false;
+}
+
+void ReplicatedClient::ReplicatedClientImpl::watch() {
+  util::setThreadName("Replicated");
+  std::vector<std::unique_ptr<Race>> races;
+  std::vector<Attempt> losers;
+  while (true) {
+    {
+      std::unique_lock lock{mutex_};
+      const auto woken = [this]() { return stop_ || !incoming_.empty(); };
+      // the futures can't notify the watcher so it polls them while there are
+      // requests in flight
+      if (races.empty() && losers.empty()) {
+        cv_.wait(lock, woken);
+      } else {
+        cv_.wait_for(lock, kPollInterval, woken);
+      }
+      if (stop_) {
+        return;
+      }
+      for (auto& race : incoming_) {
+        races.push_back(std::move(race));
+      }
+      incoming_.clear();
+    }
+
+    const auto now = util::getTime();
+    races.erase(std::remove_if(races.begin(), races.end(),
+                               [&](const std::unique_ptr<Race>& race) {
+                                 return advance(race.get(), now, &losers);
+                               }),
+                races.end());
+    losers.erase(std::remove_if(losers.begin(), losers.end(),
+                                [this](Attempt& attempt) {
+                                  if (!isReady(attempt.future)) {
+                                    return false;
+                                  }
+                                  collect(&attempt);
+                                  return true;
+                                }),
+                 losers.end());
+  }
+}
+
+ReplicatedClient::ReplicatedClient(
+  std::vector<std::unique_ptr<Client>> replicas, double hedge_percentile)
+  : impl_(std::make_unique<ReplicatedClientImpl>(std::move(replicas),
+                                                 hedge_percentile)) {}
+
+ReplicatedClient::~ReplicatedClient() = default;
+
+ServerMetadata ReplicatedClient::serverMetadata() const {
+  return impl_->getClient()->serverMetadata();
+}
+
+bool ReplicatedClient::serverLive() const {
+  const auto& replicas = impl_->replicas();
+  return std::any_of(replicas.begin(), replicas.end(), [](const auto& replica) {
+    try {
+      return replica->client->serverLive();
+    } catch (const connection_error&) {
+      return false;
+    }
+  });
+}
+
+bool ReplicatedClient::serverReady() const {
+  const auto& replicas = impl_->replicas();
+  return std::any_of(replicas.begin(), replicas.end(), [](const auto& replica) {
+    try {
+      return replica->client->serverReady();
+    } catch (const connection_error&) {
+      return false;
+    }
+  });
+}
+
+bool ReplicatedClient::modelReady(const std::string& model) const {
+  const auto& replicas = impl_->replicas();
+  return std::any_of(replicas.begin(), replicas.end(),
+                     [&model](const auto& replica) {
+                       try {
+                         return replica->client->modelReady(model);
+                       } catch (const connection_error&) {
+                         return false;
+                       }
+                     });
+}
+
+ModelMetadata ReplicatedClient::modelMetadata(const std::string& model) const {
+  return impl_->getClient()->modelMetadata(model);
+}
+
+void ReplicatedClient::modelLoad(const std::string& model,
+                                 const ParameterMap& parameters) const {
+  for (const auto& replica : impl_->replicas()) {
+    replica->client->modelLoad(model, parameters);
+  }
+}
+
+void ReplicatedClient::modelUnload(const std::string& model) const {
+  for (const auto& replica : impl_->replicas()) {
+    replica->client->modelUnload(model);
+  }
+}
+
+InferenceResponse ReplicatedClient::modelInfer(
+  const std::string& model, const InferenceRequest& request) const {
+  if (impl_->hedging()) {
+    return impl_->inferAsync(model, request).get();
+  }
+  return impl_->infer(model, request);
+}
+
+InferenceResponseFuture ReplicatedClient::modelInferAsync(
+  const std::string& model, const InferenceRequest& request) const {
+  return impl_->inferAsync(model, request);
+}
+
+std::vector<std::string> ReplicatedClient::modelList() const {
+  return impl_->getClient()->modelList();
+}
+
+std::string ReplicatedClient::workerLoad(const std::string& worker,
+                                         const ParameterMap& parameters) const {
+  std::string endpoint;
+  for (const auto& replica : impl_->replicas()) {
+    auto replica_endpoint = replica->client->workerLoad(worker, parameters);
+    if (endpoint.empty()) {
+      endpoint = std::move(replica_endpoint);
+    }
+  }
+  return endpoint;
+}
+
+void ReplicatedClient::workerUnload(const std::string& worker) const {
+  for (const auto& replica : impl_->replicas()) {
+    replica->client->workerUnload(worker);
+  }
+}
+
+bool ReplicatedClient::hasHardware(const std::string& name, int num) const {
+  const auto& replicas = impl_->replicas();
+  return std::all_of(replicas.begin(), replicas.end(),
+                     [&name, num](const auto& replica) {
+                       return replica->client->hasHardware(name, num);
+                     });
+}
+
+}  // namespace amdinfer
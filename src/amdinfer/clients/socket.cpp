@@ -0,0 +1,286 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the methods for interacting with the server over a socket
+ */
+
+#include "amdinfer/clients/socket.hpp"
+
+#include <netdb.h>        // for addrinfo, getaddrinfo, freeaddrinfo
+#include <netinet/in.h>   // for IPPROTO_TCP
+#include <netinet/tcp.h>  // for TCP_NODELAY
+#include <sys/socket.h>   // for socket, connect, shutdown, setsockopt
+#include <unistd.h>       // for close
+
+#include <array>          // for array
+#include <atomic>         // for atomic_bool
+#include <cstdint>        // for uint64_t
+#include <future>         // for promise
+#include <memory>         // for unique_ptr, make_unique
+#include <mutex>          // for mutex, lock_guard
+#include <string>         // for string
+#include <thread>         // for thread
+#include <unordered_map>  // for unordered_map
+#include <utility>        // for move
+#include <vector>         // for vector
+
+#include "amdinfer/clients/http.hpp"             // for HttpClient
+#include "amdinfer/core/exceptions.hpp"          // for connection_error
+#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/core/wire_format.hpp"         // for encodeRequest
+#include "amdinfer/servers/server.hpp"           // for kDefaultSocketMes...
+
+namespace amdinfer {
+
+class SocketClient::SocketClientImpl {
+ public:
+  SocketClientImpl(const std::string& socket_address,
+                   const std::string& http_address)
+    : address_(socket_address),
+      http_client_(std::make_unique<HttpClient>(http_address)) {}
+
+  ~SocketClientImpl() { close(); }
+
+  /// Copy constructor
+  SocketClientImpl(SocketClientImpl const&) = delete;
+  /// Copy assignment constructor
+  SocketClientImpl& operator=(const SocketClientImpl&) = delete;
+  /// Move constructor
+  SocketClientImpl(SocketClientImpl&& other) = delete;
+  /// Move assignment constructor
+  SocketClientImpl& operator=(SocketClientImpl&& other) = delete;
+
+  InferenceResponseFuture infer(const std::string& model,
+                                const InferenceRequest& request) {
+    std::promise<InferenceResponse> promise;
+    auto future = promise.get_future();
+
+    std::lock_guard send_lock{send_mutex_};
+    connect();
+    // tags start at one since the server replies to unreadable messages with 0
+    const auto tag = ++last_tag_;
+    {
+      std::lock_guard lock{pending_mutex_};
+      // checked with the lock so the reader can't miss the promise on closing
+      if (closed_) {
+        throw connection_error("The connection to the server closed");
+      }
+      pending_.emplace(tag, std::move(promise));
+    }
+    if (!sendMessage(socket_, encodeRequest(tag, model, request))) {
+      std::lock_guard lock{pending_mutex_};
+      pending_.erase(tag);
+      throw connection_error("Cannot send the request to " + address_);
+    }
+    return future;
+  }
+
+  void close() {
+    std::lock_guard send_lock{send_mutex_};
+    disconnect();
+  }
+
+  HttpClient* getHttpClient() { return http_client_.get(); }
+
+ private:
+  /// Connect to the server if there's no open connection. Sends must be locked
+  void connect() {
+    if (socket_ >= 0 && !closed_) {
+      return;
+    }
+    disconnect();
+
+    const auto separator = address_.rfind(':');
+    if (separator == std::string::npos) {
+      throw invalid_argument("The socket address must be host:port, not " +
+                             address_);
+    }
+    const auto host = address_.substr(0, separator);
+    const auto port = address_.substr(separator + 1);
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses = nullptr;
+    if (::getaddrinfo(host.c_str(), port.c_str(), &hints, &addresses) != 0) {
+      throw connection_error("Cannot resolve " + address_);
+    }
+    for (auto* info = addresses; info != nullptr; info = info->ai_next) {
+      socket_ = ::socket(info->ai_family, info->ai_socktype | SOCK_CLOEXEC,
+                         info->ai_protocol);
+      if (socket_ < 0) {
+        continue;
+      }
+      if (::connect(socket_, info->ai_addr, info->ai_addrlen) == 0) {
+        break;
+      }
+      ::close(socket_);
+      socket_ = -1;
+    }
+    ::freeaddrinfo(addresses);
+    if (socket_ < 0) {
+      throw connection_error("Cannot connect to the server at " + address_);
+    }
+
+    const int enable = 1;
+    ::setsockopt(socket_, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+    closed_ = false;
+    reader_ = std::thread{&SocketClientImpl::read, this};
+  }
+
+  /// Close the connection, if any. Sends must be locked
+  void disconnect() {
+    if (socket_ < 0) {
+      return;
+    }
+    ::shutdown(socket_, SHUT_RDWR);
+    reader_.join();
+    ::close(socket_);
+    socket_ = -1;
+  }
+
+  /// Read responses and fulfill the promises of their requests by their tags
+  void read() {
+    std::array<std::byte, sizeof(WireHeader)> raw_header;
+    std::vector<std::byte> body;
+    while (receive(socket_, raw_header.data(), raw_header.size())) {
+      WireHeader header;
+      try {
+        header = decodeHeader(raw_header.data(), kDefaultSocketMessageSize);
+      } catch (const invalid_argument&) {
+        break;
+      }
+      body.resize(header.bodySize());
+      if (!receive(socket_, body.data(), body.size())) {
+        break;
+      }
+
+      std::promise<InferenceResponse> promise;
+      {
+        std::lock_guard lock{pending_mutex_};
+        auto iterator = pending_.find(header.tag);
+        if (iterator == pending_.end()) {
+          continue;
+        }
+        promise = std::move(iterator->second);
+        pending_.erase(iterator);
+      }
+      try {
+        promise.set_value(decodeResponse(header, body.data()));
+      } catch (const invalid_argument& e) {
+        promise.set_value(InferenceResponse{e.what()});
+      }
+    }
+
+    // the requests still pending won't get responses on this connection
+    std::lock_guard lock{pending_mutex_};
+    closed_ = true;
+    for (auto& [tag, promise] : pending_) {
+      promise.set_value(
+        InferenceResponse{"The connection to the server closed"});
+    }
+    pending_.clear();
+  }
+
+  std::string address_;
+  std::unique_ptr<HttpClient> http_client_;
+  int socket_ = -1;
+  std::atomic_bool closed_ = true;
+  std::thread reader_;
+  uint64_t last_tag_ = 0;
+  std::mutex send_mutex_;
+  std::mutex pending_mutex_;
+  std::unordered_map<uint64_t, std::promise<InferenceResponse>> pending_;
+};
+
+SocketClient::SocketClient(const std::string& socket_address,
+                           const std::string& http_address) {
+  this->impl_ = std::make_unique<SocketClient::SocketClientImpl>(
+    socket_address, http_address);
+}
+
+SocketClient::~SocketClient() = default;
+
+void SocketClient::close() const { impl_->close(); }
+
+ServerMetadata SocketClient::serverMetadata() const {
+  const auto* client = this->impl_->getHttpClient();
+  return client->serverMetadata();
+}
+
+bool SocketClient::serverLive() const {
+  const auto* client = this->impl_->getHttpClient();
+  return client->serverLive();
+}
+
+bool SocketClient::serverReady() const {
+  const auto* client = this->impl_->getHttpClient();
+  return client->serverReady();
+}
+
+bool SocketClient::modelReady(const std::string& model) const {
+  const auto* client = this->impl_->getHttpClient();
+  return client->modelReady(model);
+}
+
+ModelMetadata SocketClient::modelMetadata(const std::string& model) const {
+  const auto* client = this->impl_->getHttpClient();
+  return client->modelMetadata(model);
+}
+
+void SocketClient::modelLoad(const std::string& model,
+                             const ParameterMap& parameters) const {
+  const auto* client = this->impl_->getHttpClient();
+  client->modelLoad(model, parameters);
+}
+
+void SocketClient::modelUnload(const std::string& model) const {
+  const auto* client = this->impl_->getHttpClient();
+  client->modelUnload(model);
+}
+
+std::string SocketClient::workerLoad(const std::string& worker,
+                                     const ParameterMap& parameters) const {
+  const auto* client = this->impl_->getHttpClient();
+  return client->workerLoad(worker, parameters);
+}
+
+void SocketClient::workerUnload(const std::string& worker) const {
+  const auto* client = this->impl_->getHttpClient();
+  client->workerUnload(worker);
+}
+
+std::vector<std::string> SocketClient::modelList() const {
+  const auto* client = this->impl_->getHttpClient();
+  return client->modelList();
+}
+
+bool SocketClient::hasHardware(const std::string& name, int num) const {
+  const auto* client = this->impl_->getHttpClient();
+  return client->hasHardware(name, num);
+}
+
+InferenceResponseFuture SocketClient::modelInferAsync(
+  const std::string& model, const InferenceRequest& request) const {
+  return impl_->infer(model, request);
+}
+
+InferenceResponse SocketClient::modelInfer(
+  const std::string& model, const InferenceRequest& request) const {
+  return impl_->infer(model, request).get();
+}
+
+}  // namespace amdinfer
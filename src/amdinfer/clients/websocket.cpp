@@ -33,19 +33,25 @@
 
 #include <cassert>  // for assert
 #include <chrono>   // for milliseconds
+#include <cstddef>  // for size_t
+#include <string>   // for string, to_string
 #include <thread>   // for sleep_for
 
-#include "amdinfer/clients/http.hpp"             // for HttpClient
-#include "amdinfer/clients/http_internal.hpp"    // for mapRequestToJson
-#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
-#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/clients/http.hpp"                // for HttpClient
+#include "amdinfer/clients/http_internal.hpp"       // for mapRequestToJson
+#include "amdinfer/clients/websocket_internal.hpp"  // for encodeRequestFrame
+#include "amdinfer/core/inference_request.hpp"      // for InferenceRequest
+#include "amdinfer/core/inference_response.hpp"     // for InferenceResponse
 
 namespace amdinfer {
 
 class WebSocketClient::WebSocketClientImpl {
  public:
   WebSocketClientImpl(const std::string& ws_address,
-                      const std::string& http_address) {
+                      const std::string& http_address,
+                      WebSocketProtocol protocol, size_t window,
+                      WebSocketWindowPolicy policy)
+    : protocol_(protocol), window_(window), policy_(policy) {
     using drogon::WebSocketMessageType;
 
     loop_.run();
@@ -79,6 +85,10 @@ class WebSocketClient::WebSocketClientImpl {
             queue_.enqueue(message);
             break;
           }
+          case WebSocketMessageType::Binary: {
+            queue_.enqueue(message);
+            break;
+          }
           case WebSocketMessageType::Close: {
             ws_client_->stop();
             break;
@@ -116,6 +126,14 @@ class WebSocketClient::WebSocketClientImpl {
       auto req = drogon::HttpRequest::newHttpRequest();
       req->setMethod(drogon::Get);
       req->setPath("/models/infer");
+      if (protocol_ == WebSocketProtocol::Binary) {
+        req->setParameter(kWebsocketProtocol, kWebsocketBinaryProtocol);
+      }
+      if (window_ > 0) {
+        req->setParameter(kWebsocketWindow, std::to_string(window_));
+        req->setParameter(kWebsocketWindowPolicy,
+                          getWindowPolicyName(policy_));
+      }
       ws_client_->connectToServer(
         req, [](drogon::ReqResult r, const drogon::HttpResponsePtr& /*resp*/,
                 const drogon::WebSocketClientPtr& wsptr) {
@@ -133,13 +151,25 @@ class WebSocketClient::WebSocketClientImpl {
   std::string recv() {
     std::string response;
     queue_.wait_dequeue(response);
+    // acknowledge the message once it's consumed so the server can send more
+    if (window_ > 0) {
+      if (auto connection = ws_client_->getConnection();
+          connection != nullptr && connection->connected()) {
+        connection->send("{\"" + std::string{kWebsocketAck} +
+                         "\":" + std::to_string(response.size()) + "}");
+      }
+    }
     return response;
   }
 
   drogon::WebSocketClient* getWsClient() { return ws_client_.get(); }
   HttpClient* getHttpClient() { return http_client_.get(); }
+  [[nodiscard]] WebSocketProtocol getProtocol() const { return protocol_; }
 
  private:
+  WebSocketProtocol protocol_;
+  size_t window_;
+  WebSocketWindowPolicy policy_;
   trantor::EventLoopThread loop_;
   std::unique_ptr<HttpClient> http_client_;
   drogon::WebSocketClientPtr ws_client_;
@@ -147,9 +177,11 @@ class WebSocketClient::WebSocketClientImpl {
 };
 
 WebSocketClient::WebSocketClient(const std::string& ws_address,
-                                 const std::string& http_address) {
+                                 const std::string& http_address,
+                                 WebSocketProtocol protocol, size_t window,
+                                 WebSocketWindowPolicy policy) {
   this->impl_ = std::make_unique<WebSocketClient::WebSocketClientImpl>(
-    ws_address, http_address);
+    ws_address, http_address, protocol, window, policy);
 }
 
 WebSocketClient::~WebSocketClient() = default;
@@ -235,21 +267,31 @@ void WebSocketClient::modelInferWs(const std::string& model,
                                    const InferenceRequest& request) const {
   auto* client = this->impl_->getWsClient();
 
-  auto json = mapRequestToJson(request);
-  json["model"] = model;
-  Json::StreamWriterBuilder builder;
-  builder["indentation"] = "";  // remove whitespace
-  const std::string message = Json::writeString(builder, json);
-
   auto connection = client->getConnection();
   if (connection == nullptr || connection->disconnected()) {
     impl_->connect();
     connection = client->getConnection();
     assert(connection != nullptr);
   }
+
+  if (impl_->getProtocol() == WebSocketProtocol::Binary) {
+    connection->send(encodeRequestFrame(model, request),
+                     drogon::WebSocketMessageType::Binary);
+    return;
+  }
+
+  auto json = mapRequestToJson(request);
+  json["model"] = model;
+  Json::StreamWriterBuilder builder;
+  builder["indentation"] = "";  // remove whitespace
+  const std::string message = Json::writeString(builder, json);
   connection->send(message);
 }
 
 std::string WebSocketClient::modelRecv() const { return impl_->recv(); }
 
+InferenceResponse WebSocketClient::modelRecvResponse() const {
+  return decodeResponseFrame(impl_->recv());
+}
+
 }  // namespace amdinfer
@@ -0,0 +1,361 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the binary frames used for inference over websocket
+ */
+
+#include "amdinfer/clients/websocket_internal.hpp"
+
+#include <cstddef>      // for byte, size_t
+#include <cstdint>      // for uint16_t, uint32_t, uint64_t
+#include <cstring>      // for memcpy
+#include <limits>       // for numeric_limits
+#include <string>       // for string
+#include <string_view>  // for string_view
+#include <type_traits>  // for is_unsigned_v
+#include <utility>      // for move
+#include <variant>      // for get_if, get
+#include <vector>       // for vector
+
+#include "amdinfer/core/exceptions.hpp"          // for invalid_argument
+#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/core/inference_tensor.hpp"    // for InferenceTensor
+#include "amdinfer/core/tensor.hpp"              // for Tensor
+
+namespace amdinfer {
+
+namespace {
+
+constexpr uint8_t kErrorFlag = 0x1;
+constexpr auto kBitsPerByte = 8U;
+constexpr uint8_t kByteMask = 0xFF;
+
+/// Appends little-endian fields to a frame
+class FrameWriter {
+ public:
+  template <typename T>
+  void putInt(T value) {
+    static_assert(std::is_unsigned_v<T>);
+    for (auto i = 0U; i < sizeof(T); ++i) {
+      frame_.push_back(static_cast<char>(value & kByteMask));
+      value >>= kBitsPerByte;
+    }
+  }
+
+  template <typename Length>
+  void putString(std::string_view str, const char *field) {
+    if (str.size() > std::numeric_limits<Length>::max()) {
+      throw invalid_argument(std::string{"The "} + field +
+                             " is too long for a binary frame");
+    }
+    putInt(static_cast<Length>(str.size()));
+    frame_.append(str);
+  }
+
+  void putParameters(const ParameterMap &parameters) {
+    if (parameters.size() > std::numeric_limits<uint16_t>::max()) {
+      throw invalid_argument("Too many parameters for a binary frame");
+    }
+    putInt(static_cast<uint16_t>(parameters.size()));
+    for (const auto &[key, value] : parameters) {
+      putString<uint16_t>(key, "parameter key");
+      // the type of the parameter is the index of its type in the variant
+      putInt(static_cast<uint8_t>(value.index()));
+      if (const auto *boolean = std::get_if<bool>(&value)) {
+        putInt(static_cast<uint8_t>(*boolean));
+      } else if (const auto *integer = std::get_if<int32_t>(&value)) {
+        putInt(static_cast<uint32_t>(*integer));
+      } else if (const auto *floating = std::get_if<double>(&value)) {
+        uint64_t bits = 0;
+        std::memcpy(&bits, floating, sizeof(bits));
+        putInt(bits);
+      } else {
+        putString<uint32_t>(std::get<std::string>(value), "parameter value");
+      }
+    }
+  }
+
+  void putTensor(const FrameTensor &tensor) {
+    putString<uint16_t>(tensor.name, "tensor name");
+    putInt(static_cast<uint8_t>(tensor.datatype));
+    if (tensor.shape.size() > std::numeric_limits<uint8_t>::max()) {
+      throw invalid_argument("Tensor " + tensor.name +
+                             " has too many dimensions for a binary frame");
+    }
+    putInt(static_cast<uint8_t>(tensor.shape.size()));
+    for (const auto &dimension : tensor.shape) {
+      putInt(static_cast<uint64_t>(dimension));
+    }
+    putParameters(tensor.parameters);
+    putInt(static_cast<uint64_t>(tensor.data.size()));
+    frame_.append(tensor.data);
+  }
+
+  void reserve(size_t size) { frame_.reserve(size); }
+
+  std::string release() { return std::move(frame_); }
+
+ private:
+  std::string frame_;
+};
+
+/// Reads little-endian fields from a frame, checking that they're in bounds
+class FrameReader {
+ public:
+  explicit FrameReader(std::string_view frame) : frame_(frame) {}
+
+  std::string_view getBytes(uint64_t size) {
+    if (size > frame_.size()) {
+      throw invalid_argument("The binary frame ends unexpectedly");
+    }
+    auto bytes = frame_.substr(0, size);
+    frame_.remove_prefix(size);
+    return bytes;
+  }
+
+  template <typename T>
+  T getInt() {
+    const auto bytes = getBytes(sizeof(T));
+    T value = 0;
+    for (auto i = sizeof(T); i > 0; --i) {
+      const auto byte = static_cast<uint8_t>(bytes[i - 1]);
+      value = static_cast<T>((value << kBitsPerByte) | byte);
+    }
+    return value;
+  }
+
+  template <typename Length>
+  std::string_view getString() {
+    return getBytes(getInt<Length>());
+  }
+
+  ParameterMap getParameters() {
+    ParameterMap parameters;
+    const auto count = getInt<uint16_t>();
+    for (auto i = 0U; i < count; ++i) {
+      const std::string key{getString<uint16_t>()};
+      const auto type = getInt<uint8_t>();
+      switch (type) {
+        case 0:
+          parameters.put(key, getInt<uint8_t>() != 0);
+          break;
+        case 1:
+          parameters.put(key, static_cast<int32_t>(getInt<uint32_t>()));
+          break;
+        case 2: {
+          const auto bits = getInt<uint64_t>();
+          double value = 0;
+          std::memcpy(&value, &bits, sizeof(value));
+          parameters.put(key, value);
+          break;
+        }
+        case 3:
+          parameters.put(key, std::string{getString<uint32_t>()});
+          break;
+        default:
+          throw invalid_argument("Unknown type of parameter " + key +
+                                 " in the binary frame");
+      }
+    }
+    return parameters;
+  }
+
+  FrameTensor getTensor() {
+    FrameTensor tensor;
+    tensor.name = getString<uint16_t>();
+    const auto datatype = getInt<uint8_t>();
+    if (datatype >= DataType::Unknown) {
+      throw invalid_argument("Unknown datatype of tensor " + tensor.name +
+                             " in the binary frame");
+    }
+    tensor.datatype = static_cast<DataType::Value>(datatype);
+    const auto dimensions = getInt<uint8_t>();
+    tensor.shape.reserve(dimensions);
+    for (auto i = 0U; i < dimensions; ++i) {
+      tensor.shape.push_back(getInt<uint64_t>());
+    }
+    tensor.parameters = getParameters();
+    tensor.data = getString<uint64_t>();
+    return tensor;
+  }
+
+  [[nodiscard]] bool empty() const { return frame_.empty(); }
+
+ private:
+  std::string_view frame_;
+};
+
+FrameTensor mapTensorToFrame(const InferenceTensor &tensor,
+                             const void *data) {
+  FrameTensor frame_tensor;
+  frame_tensor.name = tensor.getName();
+  frame_tensor.datatype = tensor.getDatatype();
+  frame_tensor.shape = tensor.getShape();
+  frame_tensor.parameters = tensor.getParameters();
+  frame_tensor.data = {static_cast<const char *>(data),
+                       getFrameDataSize(tensor)};
+  return frame_tensor;
+}
+
+}  // namespace
+
+const char *getWindowPolicyName(WebSocketWindowPolicy policy) {
+  switch (policy) {
+    case WebSocketWindowPolicy::Skip:
+      return "skip";
+    case WebSocketWindowPolicy::DropOldest:
+      return "drop_oldest";
+    default:
+      return "block";
+  }
+}
+
+WebSocketWindowPolicy parseWindowPolicy(std::string_view name) {
+  if (name.empty() || name == "block") {
+    return WebSocketWindowPolicy::Block;
+  }
+  if (name == "skip") {
+    return WebSocketWindowPolicy::Skip;
+  }
+  if (name == "drop_oldest") {
+    return WebSocketWindowPolicy::DropOldest;
+  }
+  throw invalid_argument("Unknown websocket window policy: " +
+                         std::string{name});
+}
+
+size_t getFrameDataSize(const Tensor &tensor) {
+  const auto datatype = tensor.getDatatype();
+  if (datatype == DataType::String) {
+    return tensor.getSize();
+  }
+  return tensor.getSize() * datatype.size();
+}
+
+std::string encodeFrame(const Frame &frame) {
+  if (frame.tensors.size() > std::numeric_limits<uint16_t>::max()) {
+    throw invalid_argument("Too many tensors for a binary frame");
+  }
+
+  size_t data_size = 0;
+  for (const auto &tensor : frame.tensors) {
+    data_size += tensor.data.size();
+  }
+  // the metadata is small next to the data so this avoids most reallocations
+  constexpr auto kMetadataEstimate = 256;
+  FrameWriter writer;
+  writer.reserve(data_size + kMetadataEstimate);
+
+  writer.putInt(kWebsocketFrameVersion);
+  writer.putInt(frame.error ? kErrorFlag : uint8_t{0});
+  writer.putInt(static_cast<uint16_t>(frame.tensors.size()));
+  writer.putString<uint16_t>(frame.model, "model name");
+  writer.putString<uint16_t>(frame.id, "ID");
+  writer.putParameters(frame.parameters);
+  if (frame.error) {
+    writer.putString<uint32_t>(frame.error_message, "error message");
+  }
+  for (const auto &tensor : frame.tensors) {
+    writer.putTensor(tensor);
+  }
+  return writer.release();
+}
+
+Frame decodeFrame(std::string_view message) {
+  FrameReader reader{message};
+  const auto version = reader.getInt<uint8_t>();
+  if (version != kWebsocketFrameVersion) {
+    throw invalid_argument("Unsupported version of the binary frame: " +
+                           std::to_string(version));
+  }
+
+  Frame frame;
+  frame.error = (reader.getInt<uint8_t>() & kErrorFlag) != 0;
+  const auto tensors = reader.getInt<uint16_t>();
+  frame.model = reader.getString<uint16_t>();
+  frame.id = reader.getString<uint16_t>();
+  frame.parameters = reader.getParameters();
+  if (frame.error) {
+    frame.error_message = reader.getString<uint32_t>();
+  }
+  frame.tensors.reserve(tensors);
+  for (auto i = 0U; i < tensors; ++i) {
+    frame.tensors.push_back(reader.getTensor());
+  }
+  if (!reader.empty()) {
+    throw invalid_argument("The binary frame has data after its last tensor");
+  }
+  return frame;
+}
+
+std::string encodeRequestFrame(const std::string &model,
+                               const InferenceRequest &request) {
+  Frame frame;
+  frame.model = model;
+  frame.id = request.getID();
+  frame.parameters = request.getParameters();
+  for (const auto &input : request.getInputs()) {
+    frame.tensors.push_back(mapTensorToFrame(input, input.getData()));
+  }
+  return encodeFrame(frame);
+}
+
+std::string encodeResponseFrame(const InferenceResponse &response) {
+  Frame frame;
+  frame.model = response.getModel();
+  frame.id = response.getID();
+  if (response.isError()) {
+    frame.error = true;
+    frame.error_message = response.getError();
+    return encodeFrame(frame);
+  }
+
+  const auto &outputs = response.getOutputs();
+  for (const auto &output : outputs) {
+    frame.tensors.push_back(mapTensorToFrame(output, output.getData()));
+  }
+  return encodeFrame(frame);
+}
+
+InferenceResponse decodeResponseFrame(std::string_view message) {
+  auto frame = decodeFrame(message);
+  if (frame.error) {
+    InferenceResponse response{frame.error_message};
+    response.setID(frame.id);
+    response.setModel(frame.model);
+    return response;
+  }
+
+  InferenceResponse response;
+  response.setID(frame.id);
+  response.setModel(frame.model);
+  response.setParameters(std::move(frame.parameters));
+  for (auto &tensor : frame.tensors) {
+    InferenceResponseOutput output;
+    output.setName(tensor.name);
+    output.setDatatype(tensor.datatype);
+    output.setShape(tensor.shape);
+    output.setParameters(std::move(tensor.parameters));
+    std::vector<std::byte> data(tensor.data.size());
+    std::memcpy(data.data(), tensor.data.data(), tensor.data.size());
+    output.setData(std::move(data));
+    response.addOutput(std::move(output));
+  }
+  return response;
+}
+
+}  // namespace amdinfer
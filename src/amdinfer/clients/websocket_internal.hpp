@@ -0,0 +1,163 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the binary frames used for inference over websocket
+ */
+
+#ifndef GUARD_AMDINFER_CLIENTS_WEBSOCKET_INTERNAL
+#define GUARD_AMDINFER_CLIENTS_WEBSOCKET_INTERNAL
+
+#include <cstddef>      // for size_t
+#include <cstdint>      // for uint64_t, uint8_t
+#include <string>       // for string
+#include <string_view>  // for string_view
+#include <vector>       // for vector
+
+#include "amdinfer/clients/websocket.hpp"  // for WebSocketWindowPolicy
+#include "amdinfer/core/data_types.hpp"     // for DataType
+#include "amdinfer/core/parameters.hpp"     // for ParameterMap
+#include "amdinfer/declarations.hpp"        // for InferenceRequest, Infe...
+
+namespace amdinfer {
+
+class Tensor;
+
+/// Query parameter of the websocket upgrade request that picks the protocol
+constexpr auto kWebsocketProtocol = "protocol";
+/// Value of the protocol query parameter to use binary frames
+constexpr auto kWebsocketBinaryProtocol = "binary";
+/// Query parameter of the upgrade request with the send window in bytes
+constexpr auto kWebsocketWindow = "window";
+/// Query parameter of the upgrade request that picks the window's policy
+constexpr auto kWebsocketWindowPolicy = "window_policy";
+/// Member of the text messages that clients send to acknowledge bytes
+constexpr auto kWebsocketAck = "ack";
+/// Request parameter that asks the streaming workers for binary outputs
+constexpr auto kBinaryOutputs = "binary";
+/// Version of the binary frames, which is the first byte of each frame
+constexpr uint8_t kWebsocketFrameVersion = 1;
+
+/// A tensor in a binary frame
+struct FrameTensor {
+  std::string name;
+  DataType datatype;
+  std::vector<uint64_t> shape;
+  ParameterMap parameters;
+  /// the tensor's raw data. When decoded, it points into the frame
+  std::string_view data;
+};
+
+/**
+ * @brief A binary frame holds a request or a response without any JSON or
+ * base64. All integers are little-endian and, in order, a frame has:
+ *
+ *   - u8 version, u8 flags (bit 0 is set for errors), u16 number of tensors
+ *   - u16 length and bytes of the model's name
+ *   - u16 length and bytes of the ID
+ *   - the parameters: a u16 count and then, for each, a u16 length and the
+ *     bytes of its key, a u8 type (0 bool, 1 int32, 2 double, 3 string) and
+ *     its value as a u8, an i32, an f64 or a u32 length and the bytes
+ *   - for errors, a u32 length and bytes of the error message
+ *   - for each tensor, a u16 length and bytes of its name, a u8 datatype, a u8
+ *     number of dimensions, a u64 for each dimension, its parameters and a u64
+ *     length and bytes of its raw data
+ *
+ * Tensor data is sent as is, in the sender's native byte order.
+ */
+struct Frame {
+  std::string model;
+  std::string id;
+  ParameterMap parameters;
+  bool error = false;
+  std::string error_message;
+  std::vector<FrameTensor> tensors;
+};
+
+/**
+ * @brief Get the name of a window policy to send in the upgrade request
+ *
+ * @param policy the policy
+ * @return const char*
+ */
+const char *getWindowPolicyName(WebSocketWindowPolicy policy);
+
+/**
+ * @brief Get a window policy from its name. If the name isn't known, an
+ * exception is thrown.
+ *
+ * @param name the name of the policy
+ * @return WebSocketWindowPolicy
+ */
+WebSocketWindowPolicy parseWindowPolicy(std::string_view name);
+
+/**
+ * @brief Get the size in bytes of a tensor's data in a binary frame. Strings
+ * are sent as their characters so each element is one byte
+ *
+ * @param tensor the tensor
+ * @return size_t
+ */
+size_t getFrameDataSize(const Tensor &tensor);
+
+/**
+ * @brief Encode a frame to send as a binary websocket message
+ *
+ * @param frame the frame to encode
+ * @return std::string
+ */
+std::string encodeFrame(const Frame &frame);
+
+/**
+ * @brief Decode a binary websocket message. The data of the tensors points
+ * into the message so the message must outlive the frame. If the message isn't
+ * a valid frame, an exception is thrown.
+ *
+ * @param message the binary websocket message
+ * @return Frame
+ */
+Frame decodeFrame(std::string_view message);
+
+/**
+ * @brief Encode a request to a model as a binary frame
+ *
+ * @param model the model to send the request to
+ * @param request the request to encode
+ * @return std::string
+ */
+std::string encodeRequestFrame(const std::string &model,
+                               const InferenceRequest &request);
+
+/**
+ * @brief Encode a response as a binary frame. Error responses are encoded with
+ * the error flag and their message
+ *
+ * @param response the response to encode
+ * @return std::string
+ */
+std::string encodeResponseFrame(const InferenceResponse &response);
+
+/**
+ * @brief Decode a binary frame to a response, copying the data of the outputs.
+ * If the message isn't a valid frame, an exception is thrown.
+ *
+ * @param message the binary websocket message
+ * @return InferenceResponse
+ */
+InferenceResponse decodeResponseFrame(std::string_view message);
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_CLIENTS_WEBSOCKET_INTERNAL
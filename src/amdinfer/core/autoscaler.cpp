@@ -0,0 +1,133 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the policy that scales the instances of a worker group
+ */
+
+#include "amdinfer/core/autoscaler.hpp"
+
+#include <algorithm>  // for max
+#include <string>     // for string
+
+#include "amdinfer/core/exceptions.hpp"  // for invalid_argument
+#include "amdinfer/core/parameters.hpp"  // for ParameterMap
+
+namespace amdinfer {
+
+namespace {
+
+/// A group that's busy for more of its time than this scales up
+constexpr auto kBusyUtilization = 0.8;
+/// A group that's busy for less of its time than this is idle
+constexpr auto kIdleUtilization = 0.3;
+
+size_t getCount(const ParameterMap& parameters, const std::string& key) {
+  const auto count = parameters.get<int32_t>(key);
+  if (count <= 0) {
+    throw invalid_argument("The " + key + " must be positive");
+  }
+  return static_cast<size_t>(count);
+}
+
+}  // namespace
+
+std::optional<AutoscaleLimits> parseAutoscaleLimits(
+  const ParameterMap& parameters, size_t instances) {
+  const bool has_min = parameters.has("min_instances");
+  const bool has_max = parameters.has("max_instances");
+  if (!has_min && !has_max) {
+    return std::nullopt;
+  }
+
+  AutoscaleLimits limits;
+  limits.min_instances =
+    has_min ? getCount(parameters, "min_instances") : instances;
+  limits.max_instances =
+    has_max ? getCount(parameters, "max_instances")
+            : std::max(limits.min_instances, instances);
+  if (limits.max_instances < limits.min_instances) {
+    throw invalid_argument(
+      "The max_instances can't be less than the min_instances");
+  }
+  if (parameters.has("scale_queue_time_us")) {
+    const auto queue_time = parameters.get<int32_t>("scale_queue_time_us");
+    if (queue_time < 0) {
+      throw invalid_argument("The scale_queue_time_us can't be negative");
+    }
+    limits.queue_time = queue_time;
+  }
+  if (parameters.has("scale_idle_s")) {
+    const auto idle = parameters.get<int32_t>("scale_idle_s");
+    if (idle < 0) {
+      throw invalid_argument("The scale_idle_s can't be negative");
+    }
+    limits.idle = std::chrono::seconds{idle};
+  }
+  return limits;
+}
+
+Autoscaler::Autoscaler(const AutoscaleLimits& limits) : limits_(limits) {}
+
+const AutoscaleLimits& Autoscaler::getLimits() const { return limits_; }
+
+int Autoscaler::decide(const SignalValues& signals, size_t instances,
+                       util::TimePoint time) {
+  std::lock_guard lock{mutex_};
+  if (pending_) {
+    return 0;
+  }
+  if (instances < limits_.min_instances) {
+    pending_ = true;
+    return 1;
+  }
+
+  const auto utilization =
+    signals.capacity > 0 ? signals.throughput / signals.capacity : 0;
+  // the queue time is the average of the recent requests so it only counts
+  // while the group still has some load
+  const bool busy =
+    utilization > kBusyUtilization ||
+    (signals.queue_time > limits_.queue_time && utilization > kIdleUtilization);
+  if (utilization >= kIdleUtilization) {
+    idle_since_.reset();
+  } else if (!idle_since_.has_value()) {
+    idle_since_ = time;
+  }
+
+  // the signals take about a window to show the effect of the last step
+  const bool settled =
+    !changed_.has_value() || time - *changed_ >= kDefaultSignalWindow;
+  if (busy && settled && instances < limits_.max_instances) {
+    pending_ = true;
+    return 1;
+  }
+  if (idle_since_.has_value() && time - *idle_since_ >= limits_.idle &&
+      instances > limits_.min_instances) {
+    pending_ = true;
+    return -1;
+  }
+  return 0;
+}
+
+void Autoscaler::finish(util::TimePoint time) {
+  std::lock_guard lock{mutex_};
+  pending_ = false;
+  changed_ = time;
+  // the group has to stay idle for the whole time again to lose another one
+  idle_since_.reset();
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,118 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the policy that scales the instances of a worker group
+ */
+
+#ifndef GUARD_AMDINFER_CORE_AUTOSCALER
+#define GUARD_AMDINFER_CORE_AUTOSCALER
+
+#include <chrono>    // for seconds, milliseconds
+#include <cstddef>   // for size_t
+#include <cstdint>   // for int32_t
+#include <mutex>     // for mutex
+#include <optional>  // for optional
+
+#include "amdinfer/batching/endpoint_signals.hpp"  // for SignalValues
+#include "amdinfer/util/timer.hpp"                 // for TimePoint
+
+namespace amdinfer {
+
+class ParameterMap;
+
+/// How often the autoscaled worker groups are checked
+constexpr std::chrono::milliseconds kAutoscaleInterval{1000};
+/// The queue time above which a busy group gets another instance, in us
+constexpr int32_t kDefaultScaleQueueTime = 5000;
+/// How long a group must be idle before one of its instances is retired
+constexpr std::chrono::seconds kDefaultScaleIdle{60};
+
+/// The limits of scaling a worker group
+struct AutoscaleLimits {
+  size_t min_instances = 1;
+  size_t max_instances = 1;
+  /// the queue time above which a busy group scales up, in microseconds
+  double queue_time = kDefaultScaleQueueTime;
+  /// how long a group must be idle before it scales down
+  std::chrono::seconds idle = kDefaultScaleIdle;
+};
+
+/**
+ * @brief Get the autoscaling limits of a worker group from its load-time
+ * parameters: "min_instances", "max_instances", "scale_queue_time_us" and
+ * "scale_idle_s". Setting either of the instance counts enables autoscaling
+ * and the other one defaults to the number of instances loaded.
+ *
+ * @param parameters the group's load-time parameters
+ * @param instances the number of instances loaded
+ * @return std::optional<AutoscaleLimits> the limits or nullopt if the group
+ * isn't autoscaled
+ */
+std::optional<AutoscaleLimits> parseAutoscaleLimits(
+  const ParameterMap& parameters, size_t instances);
+
+/**
+ * @brief Decides when a worker group should gain or lose an instance from the
+ * signals of its load. A group scales up when its instances are busy for most
+ * of their time or requests wait too long in its queue while it's loaded, and
+ * it scales down once it's been mostly idle for a while. The gap between the
+ * two utilizations and the idle time keep it from flapping.
+ *
+ * Only one step is taken at a time. After a step, the group doesn't scale up
+ * again until the signals have had a window to reflect the new instance.
+ */
+class Autoscaler {
+ public:
+  /**
+   * @brief Construct a new Autoscaler object
+   *
+   * @param limits the limits of scaling the group
+   */
+  explicit Autoscaler(const AutoscaleLimits& limits);
+
+  [[nodiscard]] const AutoscaleLimits& getLimits() const;
+
+  /**
+   * @brief Decide whether the group should scale. If it should, no other step
+   * is decided until this one is finished
+   *
+   * @param signals the group's load
+   * @param instances the group's instances
+   * @param time the time of the check
+   * @return int 1 to add an instance, -1 to retire one or 0 to stay
+   */
+  int decide(const SignalValues& signals, size_t instances,
+             util::TimePoint time);
+  /**
+   * @brief Record that the last step decided was taken or abandoned
+   *
+   * @param time when the step finished
+   */
+  void finish(util::TimePoint time);
+
+ private:
+  AutoscaleLimits limits_;
+
+  std::mutex mutex_;
+  bool pending_ = false;
+  std::optional<util::TimePoint> changed_;
+  /// when the group last became idle, if it still is
+  std::optional<util::TimePoint> idle_since_;
+};
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_CORE_AUTOSCALER
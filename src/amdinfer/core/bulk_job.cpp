@@ -0,0 +1,70 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the reader of the results of bulk jobs
+ */
+
+#include "amdinfer/core/bulk_job.hpp"
+
+#include <utility>  // for move
+
+#include "amdinfer/core/exceptions.hpp"   // for invalid_argument
+#include "amdinfer/core/wire_format.hpp"  // for decodeHeader, decodeResponse
+#include "amdinfer/util/mapped_file.hpp"  // for MappedFile
+
+namespace amdinfer {
+
+const char* toString(BulkJobState state) {
+  switch (state) {
+    case BulkJobState::Running:
+      return "running";
+    case BulkJobState::Done:
+      return "done";
+    case BulkJobState::Failed:
+      return "failed";
+    case BulkJobState::Cancelled:
+      return "cancelled";
+    default:
+      return "unknown";
+  }
+}
+
+BulkResults::BulkResults(const std::filesystem::path& path)
+  : file_(std::make_unique<util::MappedFile>(path, true)) {}
+
+BulkResults::BulkResults(BulkResults&&) noexcept = default;
+BulkResults& BulkResults::operator=(BulkResults&&) noexcept = default;
+BulkResults::~BulkResults() = default;
+
+std::optional<BulkResult> BulkResults::next() {
+  const auto size = file_->size();
+  if (offset_ == size) {
+    return std::nullopt;
+  }
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  const auto* data = reinterpret_cast<const std::byte*>(file_->data());
+  const auto remaining = size - offset_;
+  if (remaining < sizeof(WireHeader)) {
+    throw invalid_argument("Malformed result in the bulk job's results");
+  }
+  const auto header =
+    decodeHeader(data + offset_, remaining - sizeof(WireHeader));
+  const auto* body = data + offset_ + sizeof(WireHeader);
+  offset_ += sizeof(WireHeader) + header.bodySize();
+  return BulkResult{header.tag, decodeResponse(header, body)};
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,596 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the datasets that bulk jobs read and the jobs that run
+ * them
+ */
+
+#include "amdinfer/core/bulk_jobs.hpp"
+
+#include <jsoncpp/json/reader.h>  // for CharReaderBuilder, CharReader
+#include <jsoncpp/json/value.h>   // for Value
+
+#include <algorithm>      // for min
+#include <cstring>        // for memcpy, memcmp
+#include <exception>      // for exception
+#include <limits>         // for numeric_limits
+#include <stdexcept>      // for logic_error
+#include <string_view>    // for string_view
+#include <system_error>   // for error_code
+#include <unordered_map>  // for unordered_map
+#include <utility>        // for move
+
+#include "amdinfer/buffers/buffer.hpp"           // for Buffer
+#include "amdinfer/build_options.hpp"            // for AMDINFER_ENABLE_MET...
+#include "amdinfer/core/exceptions.hpp"          // for invalid_argument
+#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/core/request_container.hpp"   // for RequestContainer
+#include "amdinfer/core/traffic_log.hpp"         // for kTrafficLogMagic
+#include "amdinfer/core/wire_format.hpp"         // for decodeHeader, enco...
+#include "amdinfer/util/thread.hpp"              // for setThreadName
+#include "amdinfer/util/timer.hpp"               // for getTime
+
+namespace fs = std::filesystem;
+
+namespace amdinfer {
+
+namespace {
+
+/// Chunks of results that may wait for the writer before no more are sent
+constexpr size_t kBulkWriteBacklog = 4;
+
+/// Get the value of a key in the dictionary that's the header of a .npy file
+std::string_view npyValue(std::string_view header, const std::string& key) {
+  auto start = header.find("'" + key + "'");
+  if (start != std::string_view::npos) {
+    start = header.find(':', start);
+  }
+  if (start == std::string_view::npos) {
+    throw invalid_argument("The .npy header has no " + key);
+  }
+  start = header.find_first_not_of(' ', start + 1);
+  if (start == std::string_view::npos) {
+    throw invalid_argument("The .npy header has no " + key);
+  }
+  size_t end = 0;
+  if (header[start] == '(') {
+    end = header.find(')', start);
+    if (end != std::string_view::npos) {
+      end++;
+    }
+  } else if (header[start] == '\'') {
+    end = header.find('\'', start + 1);
+    if (end != std::string_view::npos) {
+      end++;
+    }
+  } else {
+    end = header.find_first_of(",}", start);
+  }
+  if (end == std::string_view::npos) {
+    throw invalid_argument("The .npy header's " + key + " is malformed");
+  }
+  return header.substr(start, end - start);
+}
+
+/// Parse a .npy shape such as (8, 3, 224, 224) or (8,)
+std::vector<uint64_t> parseNpyShape(std::string_view shape) {
+  std::vector<uint64_t> dims;
+  shape = shape.substr(1, shape.size() - 2);
+  while (!shape.empty()) {
+    const auto end = std::min(shape.find(','), shape.size());
+    const std::string dim{shape.substr(0, end)};
+    shape.remove_prefix(std::min(end + 1, shape.size()));
+    if (dim.find_first_not_of(' ') == std::string::npos) {
+      continue;
+    }
+    try {
+      dims.push_back(std::stoull(dim));
+    } catch (const std::logic_error&) {
+      throw invalid_argument("The .npy shape has an invalid dimension: " +
+                             dim);
+    }
+  }
+  return dims;
+}
+
+/// Map a .npy type such as <f4 to a datatype
+DataType npyType(std::string_view descr) {
+  static const std::unordered_map<std::string_view, DataType> types{
+    {"b1", DataType::Bool},
+    {"u1", DataType::Uint8},
+    {"u2", DataType::Uint16},
+    {"u4", DataType::Uint32},
+    {"u8", DataType::Uint64},
+    {"i1", DataType::Int8},
+    {"i2", DataType::Int16},
+    {"i4", DataType::Int32},
+    {"i8", DataType::Int64},
+    {"f2", DataType::Fp16},
+    {"f4", DataType::Fp32},
+    {"f8", DataType::Fp64}};
+  const auto found =
+    descr.size() == 3 ? types.find(descr.substr(1)) : types.end();
+  // the data is read in the host's byte order, which is little-endian
+  if (found == types.end() ||
+      (descr[0] == '>' && found->second.size() > 1)) {
+    throw invalid_argument("Unsupported .npy type: " + std::string{descr});
+  }
+  return found->second;
+}
+
+/// Map a safetensors type such as F32 to a datatype
+DataType safetensorsType(const std::string& dtype) {
+  static const std::unordered_map<std::string, DataType> types{
+    {"BOOL", DataType::Bool},
+    {"U8", DataType::Uint8},
+    {"U16", DataType::Uint16},
+    {"U32", DataType::Uint32},
+    {"U64", DataType::Uint64},
+    {"I8", DataType::Int8},
+    {"I16", DataType::Int16},
+    {"I32", DataType::Int32},
+    {"I64", DataType::Int64},
+    {"F16", DataType::Fp16},
+    {"BF16", DataType::Bf16},
+    {"F32", DataType::Fp32},
+    {"F64", DataType::Fp64}};
+  const auto found = types.find(dtype);
+  if (found == types.end()) {
+    throw invalid_argument("Unsupported safetensors type: " + dtype);
+  }
+  return found->second;
+}
+
+/**
+ * @brief Let the batcher read the request's inputs where they are in the
+ * dataset, as the native client does, so they're never staged in the pool
+ */
+void viewInputs(const InferenceRequest& request, RequestContainer* container) {
+  const auto& inputs = request.getInputs();
+  container->input_views.reserve(inputs.size());
+  container->input_writers.reserve(inputs.size());
+  for (const auto& input : inputs) {
+    const auto* data = input.getData();
+    const auto size = input.getSize() * input.getDatatype().size();
+    container->input_views.push_back(data);
+    container->input_writers.emplace_back(
+      [data, size](Buffer* buffer, size_t offset) {
+        buffer->write(data, offset, size);
+      });
+  }
+}
+
+}  // namespace
+
+Dataset::Dataset(const fs::path& path, const std::string& input_name)
+  : file_(path, true) {
+  const auto extension = path.extension();
+  if (extension == ".npy") {
+    readNpy(input_name);
+  } else if (extension == ".safetensors") {
+    readSafetensors();
+  } else {
+    readRecords();
+  }
+}
+
+void Dataset::readNpy(const std::string& input_name) {
+  const std::string_view file{file_.data(), file_.size()};
+  const std::string_view magic{"\x93NUMPY", 6};
+  const size_t version_1_start = 10;
+  const size_t version_2_start = 12;
+  if (file.size() < version_2_start || file.substr(0, magic.size()) != magic) {
+    throw invalid_argument("The dataset isn't a .npy file");
+  }
+  const auto major = static_cast<uint8_t>(file[magic.size()]);
+  size_t start = version_1_start;
+  size_t header_size = 0;
+  if (major == 1) {
+    uint16_t size = 0;
+    std::memcpy(&size, file.data() + magic.size() + 2, sizeof(size));
+    header_size = size;
+  } else {
+    uint32_t size = 0;
+    std::memcpy(&size, file.data() + magic.size() + 2, sizeof(size));
+    header_size = size;
+    start = version_2_start;
+  }
+  if (header_size > file.size() - start) {
+    throw invalid_argument("The .npy header is larger than the file");
+  }
+  const auto header = file.substr(start, header_size);
+  if (npyValue(header, "fortran_order") != "False") {
+    throw invalid_argument("Fortran-ordered .npy datasets aren't supported");
+  }
+  const auto dims = parseNpyShape(npyValue(header, "shape"));
+  if (dims.empty()) {
+    throw invalid_argument("The .npy dataset must have a dimension of samples");
+  }
+  Tensor tensor;
+  tensor.name = input_name;
+  auto descr = npyValue(header, "descr");
+  // the type is quoted
+  tensor.type = npyType(descr.substr(1, descr.size() - 2));
+  tensor.shape = Shape(dims.begin() + 1, dims.end());
+  tensor.data = file.data() + start + header_size;
+  addTensor(std::move(tensor), dims[0], file.size() - start - header_size);
+}
+
+void Dataset::readSafetensors() {
+  uint64_t header_size = 0;
+  if (file_.size() < sizeof(header_size)) {
+    throw invalid_argument("The dataset isn't a safetensors file");
+  }
+  std::memcpy(&header_size, file_.data(), sizeof(header_size));
+  if (header_size > file_.size() - sizeof(header_size)) {
+    throw invalid_argument("The safetensors header is larger than the file");
+  }
+  const auto* begin = file_.data() + sizeof(header_size);
+  const auto* data = begin + header_size;
+  const auto data_size = file_.size() - sizeof(header_size) - header_size;
+
+  Json::CharReaderBuilder builder;
+  const std::unique_ptr<Json::CharReader> reader{builder.newCharReader()};
+  Json::Value header;
+  std::string errors;
+  if (!reader->parse(begin, data, &header, &errors) || !header.isObject()) {
+    throw invalid_argument("The safetensors header is malformed: " + errors);
+  }
+
+  for (const auto& name : header.getMemberNames()) {
+    if (name == "__metadata__") {
+      continue;
+    }
+    const auto& entry = header[name];
+    const auto& shape = entry["shape"];
+    const auto& offsets = entry["data_offsets"];
+    const auto malformed =
+      invalid_argument("The safetensors tensor " + name + " is malformed");
+    if (!entry["dtype"].isString() || !shape.isArray() || shape.empty() ||
+        !offsets.isArray() || offsets.size() != 2) {
+      throw malformed;
+    }
+    std::vector<uint64_t> dims;
+    for (const auto& dim : shape) {
+      if (!dim.isUInt64()) {
+        throw malformed;
+      }
+      dims.push_back(dim.asUInt64());
+    }
+    const auto& first = offsets[Json::ArrayIndex{0}];
+    const auto& last = offsets[Json::ArrayIndex{1}];
+    if (!first.isUInt64() || !last.isUInt64() ||
+        first.asUInt64() > last.asUInt64() || last.asUInt64() > data_size) {
+      throw malformed;
+    }
+
+    Tensor tensor;
+    tensor.name = name;
+    tensor.type = safetensorsType(entry["dtype"].asString());
+    tensor.shape = Shape(dims.begin() + 1, dims.end());
+    tensor.data = data + first.asUInt64();
+    addTensor(std::move(tensor), dims[0], last.asUInt64() - first.asUInt64());
+  }
+  if (tensors_.empty()) {
+    throw invalid_argument("The safetensors dataset has no tensors");
+  }
+}
+
+void Dataset::readRecords() {
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  const auto* data = reinterpret_cast<const std::byte*>(file_.data());
+  const auto size = file_.size();
+  size_t offset = 0;
+  // traffic logs are records after their header
+  if (size >= sizeof(TrafficLogHeader) &&
+      std::memcmp(file_.data(), kTrafficLogMagic.data(),
+                  kTrafficLogMagic.size()) == 0) {
+    offset = sizeof(TrafficLogHeader);
+  }
+  while (size - offset >= sizeof(WireHeader)) {
+    const auto header =
+      decodeHeader(data + offset, std::numeric_limits<uint64_t>::max());
+    if (header.kind != WireKind::Request) {
+      throw invalid_argument("The dataset has a record that isn't a request");
+    }
+    if ((header.flags & kTrafficNoPayload) != 0) {
+      throw invalid_argument(
+        "The dataset has a record that was recorded without its data");
+    }
+    // a record that's cut off ends the dataset, as in a traffic log
+    if (header.bodySize() > size - offset - sizeof(WireHeader)) {
+      break;
+    }
+    records_.push_back(offset);
+    offset += sizeof(WireHeader) + header.bodySize();
+  }
+  samples_ = records_.size();
+}
+
+void Dataset::addTensor(Tensor tensor, uint64_t samples, uint64_t bytes) {
+  tensor.stride = tensor.type.size();
+  for (const auto dim : tensor.shape) {
+    tensor.stride *= dim;
+  }
+  // each sample of a tensor of samples of scalars is a tensor of one scalar
+  if (tensor.shape.empty()) {
+    tensor.shape = Shape{1};
+  }
+  if (tensor.stride != 0 && samples > bytes / tensor.stride) {
+    throw invalid_argument("The dataset's tensor " + tensor.name +
+                           " is smaller than its shape");
+  }
+  if (!tensors_.empty() && samples != samples_) {
+    throw invalid_argument(
+      "The dataset's tensors must all have the same number of samples");
+  }
+  samples_ = samples;
+  tensors_.push_back(std::move(tensor));
+}
+
+InferenceRequestPtr Dataset::request(size_t sample) const {
+  if (!records_.empty()) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    const auto* data = reinterpret_cast<const std::byte*>(file_.data()) +
+                       records_.at(sample);
+    const auto header =
+      decodeHeader(data, std::numeric_limits<uint64_t>::max());
+    return decodeRequest(header, data + sizeof(WireHeader)).request;
+  }
+
+  auto request = std::make_shared<InferenceRequest>();
+  for (const auto& tensor : tensors_) {
+    // the inputs are only read but requests hold mutable pointers
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+    auto* data = const_cast<char*>(tensor.data + sample * tensor.stride);
+    request->addInputTensor(data, tensor.shape, tensor.type, tensor.name);
+  }
+  return request;
+}
+
+BulkJob::BulkJob(const BulkJobOptions& options, Submit submit)
+  : output_(options.output),
+    partial_(options.output.string() + ".partial"),
+    max_in_flight_(options.in_flight == 0 ? kDefaultBulkInFlight
+                                          : options.in_flight),
+    submit_(std::move(submit)),
+    dataset_(std::make_unique<Dataset>(options.input, options.input_name)),
+    file_(partial_, std::ios::binary | std::ios::trunc),
+    start_(std::chrono::steady_clock::now()),
+    total_(dataset_->size()) {
+  if (!file_) {
+    throw runtime_error("Could not create the results " + partial_.string());
+  }
+  buffer_.reserve(kBulkWriteSize);
+  writer_ = std::thread{&BulkJob::write, this};
+  thread_ = std::thread{&BulkJob::run, this};
+}
+
+BulkJob::~BulkJob() {
+  cancel();
+  thread_.join();
+}
+
+BulkJobProgress BulkJob::progress() const {
+  BulkJobProgress progress;
+  progress.submitted = submitted_;
+  progress.completed = completed_;
+  progress.failed = failed_;
+  std::lock_guard lock{mutex_};
+  progress.state = state_;
+  progress.error = error_;
+  progress.total = total_;
+  const auto end = state_ == BulkJobState::Running
+                     ? std::chrono::steady_clock::now()
+                     : end_;
+  progress.seconds = std::chrono::duration<double>(end - start_).count();
+  return progress;
+}
+
+void BulkJob::cancel() {
+  {
+    std::lock_guard lock{mutex_};
+    cancelled_ = true;
+  }
+  window_.notify_all();
+}
+
+BulkJobProgress BulkJob::wait() const {
+  {
+    std::unique_lock lock{mutex_};
+    finished_.wait(lock,
+                   [this]() { return state_ != BulkJobState::Running; });
+  }
+  return progress();
+}
+
+void BulkJob::run() {
+  util::setThreadName("bulk");
+  std::string error;
+  for (size_t sample = 0; sample < total_; ++sample) {
+    {
+      std::unique_lock lock{mutex_};
+      window_.wait(lock, [this]() {
+        return cancelled_ || (in_flight_ < max_in_flight_ &&
+                              backlog_ < kBulkWriteBacklog * kBulkWriteSize);
+      });
+      if (cancelled_) {
+        break;
+      }
+      in_flight_++;
+    }
+    try {
+      auto request = dataset_->request(sample);
+      auto container = std::make_unique<RequestContainer>();
+#ifdef AMDINFER_ENABLE_METRICS
+      container->start_time = util::getTime();
+#endif
+      viewInputs(*request, container.get());
+      request->setCallback([this, sample](const InferenceResponse& response) {
+        respond(sample, response);
+      });
+      container->request = std::move(request);
+      // counted first so it's never behind the responses
+      submitted_++;
+      submit_(std::move(container));
+    } catch (const std::exception& e) {
+      // the request's callback isn't run if it couldn't be sent
+      error = e.what();
+      submitted_--;
+      std::lock_guard lock{mutex_};
+      in_flight_--;
+      break;
+    }
+  }
+
+  std::unique_lock lock{mutex_};
+  window_.wait(lock, [this]() { return in_flight_ == 0; });
+  flush();
+  const auto cancelled = cancelled_;
+  lock.unlock();
+  queue_.enqueue(std::vector<std::byte>{});
+  writer_.join();
+  // the requests are done with the dataset so it's unmapped
+  dataset_.reset();
+
+  if (error.empty() && write_failed_) {
+    error = "Could not write the results " + partial_.string();
+  }
+  std::error_code rename_error;
+  if (error.empty() && !cancelled) {
+    fs::rename(partial_, output_, rename_error);
+    if (rename_error) {
+      error = "Could not rename the results to " + output_.string();
+    }
+  }
+  if (!error.empty()) {
+    finish(BulkJobState::Failed, error);
+  } else {
+    finish(cancelled ? BulkJobState::Cancelled : BulkJobState::Done, "");
+  }
+}
+
+void BulkJob::write() {
+  util::setThreadName("bulkWriter");
+  std::vector<std::byte> chunk;
+  while (true) {
+    queue_.wait_dequeue(chunk);
+    if (chunk.empty()) {
+      break;
+    }
+    if (!write_failed_) {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+      file_.write(reinterpret_cast<const char*>(chunk.data()),
+                  static_cast<std::streamsize>(chunk.size()));
+      write_failed_ = !file_;
+    }
+    {
+      std::lock_guard lock{mutex_};
+      backlog_ -= chunk.size();
+    }
+    window_.notify_all();
+  }
+  file_.close();
+  write_failed_ = write_failed_ || file_.fail();
+}
+
+void BulkJob::respond(uint64_t sample, const InferenceResponse& response) {
+  // the outputs are copied into the results so the response can be freed
+  const auto message = encodeResponse(sample, response);
+  if (response.isError()) {
+    failed_++;
+  }
+  {
+    std::lock_guard lock{mutex_};
+    for (const auto& segment : message.segments()) {
+      buffer_.insert(buffer_.end(), segment.data, segment.data + segment.size);
+    }
+    if (buffer_.size() >= kBulkWriteSize) {
+      flush();
+    }
+    completed_++;
+    in_flight_--;
+    // notified under the lock as the job may be destroyed once it's released
+    window_.notify_all();
+  }
+}
+
+void BulkJob::flush() {
+  if (buffer_.empty()) {
+    return;
+  }
+  backlog_ += buffer_.size();
+  queue_.enqueue(std::move(buffer_));
+  buffer_ = {};
+  buffer_.reserve(kBulkWriteSize);
+}
+
+void BulkJob::finish(BulkJobState state, const std::string& error) {
+  {
+    std::lock_guard lock{mutex_};
+    state_ = state;
+    error_ = error;
+    end_ = std::chrono::steady_clock::now();
+  }
+  finished_.notify_all();
+}
+
+std::string BulkJobs::start(const BulkJobOptions& options,
+                            BulkJob::Submit submit) {
+  auto job = std::make_unique<BulkJob>(options, std::move(submit));
+  std::lock_guard lock{mutex_};
+  const auto id = ++last_id_;
+  jobs_.try_emplace(id, std::move(job));
+  return std::to_string(id);
+}
+
+BulkJobProgress BulkJobs::progress(const std::string& id) const {
+  return get(id)->progress();
+}
+
+void BulkJobs::cancel(const std::string& id) const { get(id)->cancel(); }
+
+std::vector<std::pair<std::string, BulkJobProgress>> BulkJobs::list() const {
+  std::vector<std::pair<std::string, BulkJobProgress>> jobs;
+  std::lock_guard lock{mutex_};
+  jobs.reserve(jobs_.size());
+  for (const auto& [id, job] : jobs_) {
+    jobs.emplace_back(std::to_string(id), job->progress());
+  }
+  return jobs;
+}
+
+BulkJob* BulkJobs::get(const std::string& id) const {
+  uint64_t key = 0;
+  try {
+    size_t parsed = 0;
+    key = std::stoull(id, &parsed);
+    if (parsed != id.size()) {
+      key = 0;
+    }
+  } catch (const std::logic_error&) {
+    key = 0;
+  }
+  std::lock_guard lock{mutex_};
+  const auto found = jobs_.find(key);
+  if (found == jobs_.end()) {
+    throw invalid_argument("Bulk job " + id + " not found");
+  }
+  return found->second.get();
+}
+
+}  // namespace amdinfer
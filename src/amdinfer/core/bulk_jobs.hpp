@@ -0,0 +1,221 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the datasets that bulk jobs read and the jobs that run them
+ * through the server's endpoints
+ */
+
+#ifndef GUARD_AMDINFER_CORE_BULK_JOBS
+#define GUARD_AMDINFER_CORE_BULK_JOBS
+
+#include <atomic>              // for atomic
+#include <chrono>              // for steady_clock
+#include <condition_variable>  // for condition_variable
+#include <cstddef>             // for size_t, byte
+#include <cstdint>             // for uint64_t
+#include <filesystem>          // for path
+#include <fstream>             // for ofstream
+#include <functional>          // for function
+#include <map>                 // for map
+#include <memory>              // for unique_ptr
+#include <mutex>               // for mutex
+#include <string>              // for string
+#include <thread>              // for thread
+#include <utility>             // for pair
+#include <vector>              // for vector
+
+#include "amdinfer/core/bulk_job.hpp"    // for BulkJobOptions, BulkJobProgress
+#include "amdinfer/core/data_types.hpp"  // for DataType
+#include "amdinfer/core/shape.hpp"       // for Shape
+#include "amdinfer/declarations.hpp"     // for InferenceRequestPtr
+#include "amdinfer/util/mapped_file.hpp"  // for MappedFile
+#include "amdinfer/util/queue.hpp"        // for BlockingQueue
+
+namespace amdinfer {
+
+struct RequestContainer;
+
+/// Bytes of results that a bulk job writes to its file at once
+constexpr size_t kBulkWriteSize = 8ULL * 1024 * 1024;
+
+/**
+ * @brief A dataset file mapped into memory. The requests that it makes for
+ * its samples point into the mapping so the samples are read from the page
+ * cache as they're batched rather than copied first, and the mapping must
+ * outlive them.
+ */
+class Dataset {
+ public:
+  /**
+   * @brief Map a dataset in the format that its extension names. It throws
+   * file_read_error if it can't be read and invalid_argument if it's not a
+   * dataset of its format
+   *
+   * @param path the dataset to map
+   * @param input_name the name of the input of .npy datasets
+   */
+  Dataset(const std::filesystem::path& path, const std::string& input_name);
+
+  /// Get the number of samples
+  [[nodiscard]] size_t size() const { return samples_; }
+
+  /**
+   * @brief Make the request of a sample, whose inputs point into the dataset.
+   * It throws invalid_argument if the sample's record is malformed
+   *
+   * @param sample the index of the sample
+   * @return InferenceRequestPtr
+   */
+  [[nodiscard]] InferenceRequestPtr request(size_t sample) const;
+
+ private:
+  /// A tensor in the dataset whose first dimension is the samples
+  struct Tensor {
+    std::string name;
+    DataType type;
+    /// the shape of each sample
+    Shape shape;
+    const char* data = nullptr;
+    /// bytes of each sample
+    size_t stride = 0;
+  };
+
+  void readNpy(const std::string& input_name);
+  void readSafetensors();
+  void readRecords();
+  /// Check the tensor fits in the file and add it
+  void addTensor(Tensor tensor, uint64_t samples, uint64_t bytes);
+
+  util::MappedFile file_;
+  std::vector<Tensor> tensors_;
+  /// the offset of each record in a dataset of records
+  std::vector<size_t> records_;
+  size_t samples_ = 0;
+};
+
+/**
+ * @brief Runs a dataset through an endpoint in the background and writes the
+ * responses to a file. A thread of its own sends each sample as a request,
+ * keeping a number of them in flight so the endpoint's batcher always has
+ * full batches to make, and another writes the responses in large sequential
+ * writes as they complete. The results are written to <output>.partial and
+ * renamed to the output once the job is done. This is safe to use from
+ * multiple threads at once.
+ */
+class BulkJob {
+ public:
+  /// Sends a request to the job's endpoint. It throws if it can't be sent
+  using Submit = std::function<void(std::unique_ptr<RequestContainer>)>;
+
+  /**
+   * @brief Construct a new BulkJob object and start it. It throws if the
+   * dataset can't be read or the results can't be written
+   *
+   * @param options what to run. The input must be resolved already
+   * @param submit sends requests to the endpoint
+   */
+  BulkJob(const BulkJobOptions& options, Submit submit);
+  BulkJob(const BulkJob&) = delete;
+  BulkJob& operator=(const BulkJob&) = delete;
+  BulkJob(BulkJob&&) = delete;
+  BulkJob& operator=(BulkJob&&) = delete;
+  /// Destructor. Cancels the job and waits for the requests in flight
+  ~BulkJob();
+
+  /// Get how far the job has got
+  [[nodiscard]] BulkJobProgress progress() const;
+  /// Stop sending samples. Those in flight finish before the job is over
+  void cancel();
+  /// Wait until the job is over and get how it went
+  BulkJobProgress wait() const;
+
+ private:
+  /// Send the samples and finish the job. Runs in its own thread
+  void run();
+  /// Write the results to the file. Runs in its own thread
+  void write();
+  /// Add a response to the results. Called by the endpoint's threads
+  void respond(uint64_t sample, const InferenceResponse& response);
+  /// Hand the results that are buffered to the writer. The mutex must be held
+  void flush();
+  /// End the job in a state
+  void finish(BulkJobState state, const std::string& error);
+
+  std::filesystem::path output_;
+  std::filesystem::path partial_;
+  size_t max_in_flight_;
+  Submit submit_;
+  std::unique_ptr<Dataset> dataset_;
+  std::ofstream file_;
+  std::chrono::steady_clock::time_point start_;
+  std::chrono::steady_clock::time_point end_;
+  size_t total_;
+
+  std::atomic<uint64_t> submitted_ = 0;
+  std::atomic<uint64_t> completed_ = 0;
+  std::atomic<uint64_t> failed_ = 0;
+  /// set by the writer if the results couldn't be written
+  std::atomic<bool> write_failed_ = false;
+
+  /// responses waiting to be handed to the writer
+  std::vector<std::byte> buffer_;
+  /// bytes handed to the writer that it hasn't written yet
+  size_t backlog_ = 0;
+  size_t in_flight_ = 0;
+  bool cancelled_ = false;
+  BulkJobState state_ = BulkJobState::Running;
+  std::string error_;
+  mutable std::mutex mutex_;
+  /// notified when requests complete, results are written or it's cancelled
+  std::condition_variable window_;
+  mutable std::condition_variable finished_;
+
+  /// an empty chunk stops the writer thread
+  BlockingQueue<std::vector<std::byte>> queue_;
+  std::thread writer_;
+  std::thread thread_;
+};
+
+/// The bulk jobs that a server has started, by their IDs
+class BulkJobs {
+ public:
+  /**
+   * @brief Start a job. It throws if the job can't be started
+   *
+   * @param options what to run. The input must be resolved already
+   * @param submit sends requests to the job's endpoint
+   * @return std::string the job's ID
+   */
+  std::string start(const BulkJobOptions& options, BulkJob::Submit submit);
+  /// Get how far a job has got. It throws invalid_argument if it's unknown
+  [[nodiscard]] BulkJobProgress progress(const std::string& id) const;
+  /// Cancel a job. It throws invalid_argument if it's unknown
+  void cancel(const std::string& id) const;
+  /// Get how far each job has got, in the order they were started
+  [[nodiscard]] std::vector<std::pair<std::string, BulkJobProgress>> list()
+    const;
+
+ private:
+  [[nodiscard]] BulkJob* get(const std::string& id) const;
+
+  uint64_t last_id_ = 0;
+  std::map<uint64_t, std::unique_ptr<BulkJob>> jobs_;
+  mutable std::mutex mutex_;
+};
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_CORE_BULK_JOBS
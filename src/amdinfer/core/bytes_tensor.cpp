@@ -0,0 +1,58 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the views of BYTES tensors
+ */
+
+#include "amdinfer/core/bytes_tensor.hpp"
+
+#include <string>  // for string, to_string
+
+#include "amdinfer/util/containers.hpp"  // for containerProduct
+
+namespace amdinfer {
+
+BytesView::BytesView(const void* data, size_t size) {
+  const auto* bytes = static_cast<const char*>(data);
+  size_t offset = 0;
+  while (offset < size) {
+    if (size - offset < kBytesLengthSize) {
+      throw invalid_argument("BYTES tensor ends in the middle of a length");
+    }
+    uint32_t length = 0;
+    std::memcpy(&length, bytes + offset, kBytesLengthSize);
+    offset += kBytesLengthSize;
+    if (length > size - offset) {
+      throw invalid_argument("BYTES tensor element " +
+                             std::to_string(elements_.size()) +
+                             " is longer than the tensor");
+    }
+    elements_.emplace_back(bytes + offset, length);
+    offset += length;
+  }
+}
+
+void checkBytesShape(size_t elements, const Shape& shape,
+                     std::string_view name) {
+  const auto expected = util::containerProduct(shape);
+  if (elements != expected) {
+    throw invalid_argument("BYTES tensor " + std::string{name} + " has " +
+                           std::to_string(elements) + " elements, expected " +
+                           std::to_string(expected));
+  }
+}
+
+}  // namespace amdinfer
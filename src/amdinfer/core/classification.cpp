@@ -0,0 +1,127 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the server-side classification of output tensors
+ */
+
+#include "amdinfer/core/classification.hpp"
+
+#include <algorithm>    // for find_if, min
+#include <cstddef>      // for size_t, byte
+#include <cstdint>      // for int32_t, uint64_t
+#include <cstring>      // for memcpy
+#include <type_traits>  // for is_same_v
+#include <utility>      // for move
+#include <variant>      // for bad_variant_access
+#include <vector>       // for vector
+
+#include "amdinfer/core/data_types.hpp"          // for DataType, switchOver...
+#include "amdinfer/core/exceptions.hpp"          // for invalid_argument
+#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/core/parameters.hpp"          // for ParameterMap
+#include "amdinfer/pre_post/get_top_k.hpp"       // for getTopK
+
+namespace amdinfer {
+
+namespace {
+
+/// Get the (index, score) pairs of the top k classes of each row
+struct TopK {
+  template <typename T>
+  std::vector<float> operator()(const void* data, size_t rows, size_t classes,
+                                int k) const {
+    if constexpr (std::is_same_v<T, char>) {
+      throw invalid_argument("String outputs can't be classified");
+    } else {
+      const auto* values = static_cast<const T*>(data);
+      std::vector<float> pairs;
+      pairs.reserve(rows * std::min(static_cast<size_t>(k), classes) * 2);
+      for (size_t i = 0; i < rows; ++i) {
+        const auto* row = values + (i * classes);
+        for (auto index : pre_post::getTopK(row, classes, k)) {
+          pairs.push_back(static_cast<float>(index));
+          pairs.push_back(static_cast<float>(row[index]));
+        }
+      }
+      return pairs;
+    }
+  }
+};
+
+}  // namespace
+
+Classifications getClassifications(const InferenceRequest& request) {
+  Classifications classifications;
+  for (const auto& output : request.getOutputs()) {
+    const auto& parameters = output.getParameters();
+    if (!parameters.has("classification")) {
+      continue;
+    }
+    int32_t k = 0;
+    try {
+      k = parameters.get<int32_t>("classification");
+    } catch (const std::bad_variant_access&) {
+      throw invalid_argument(
+        "The classification parameter must be a positive integer");
+    }
+    if (k <= 0) {
+      throw invalid_argument(
+        "The classification parameter must be a positive integer");
+    }
+    classifications.emplace_back(output.getName(), k);
+  }
+  return classifications;
+}
+
+void classify(InferenceResponse* response,
+              const Classifications& classifications) {
+  if (response->isError()) {
+    return;
+  }
+  // moving the outputs out leaves the response without any to add them back
+  auto outputs = std::move(*response).getOutputs();
+  for (auto& output : outputs) {
+    const auto classification =
+      std::find_if(classifications.begin(), classifications.end(),
+                   [&output](const auto& entry) {
+                     return entry.first == output.getName();
+                   });
+    auto shape = output.getShape();
+    if (classification == classifications.end() || shape.empty() ||
+        shape.back() == 0) {
+      response->addOutput(std::move(output));
+      continue;
+    }
+
+    const auto classes = static_cast<size_t>(shape.back());
+    const auto rows = output.getSize() / classes;
+    const auto k = classification->second;
+    const auto pairs = switchOverTypes(TopK(), output.getDatatype(),
+                                       output.getData(), rows, classes, k);
+
+    std::vector<std::byte> data(pairs.size() * sizeof(float));
+    std::memcpy(data.data(), pairs.data(), data.size());
+    shape.back() = std::min(static_cast<uint64_t>(k), shape.back());
+    shape.push_back(2);
+    output.setDatatype(DataType::Fp32);
+    output.setShape(shape);
+    output.setData(std::move(data));
+    response->addOutput(std::move(output));
+  }
+}
+
+}  // namespace amdinfer
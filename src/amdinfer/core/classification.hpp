@@ -0,0 +1,60 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the server-side classification of output tensors
+ */
+
+#ifndef GUARD_AMDINFER_CORE_CLASSIFICATION
+#define GUARD_AMDINFER_CORE_CLASSIFICATION
+
+#include <string>   // for string
+#include <utility>  // for pair
+#include <vector>   // for vector
+
+namespace amdinfer {
+
+class InferenceRequest;
+class InferenceResponse;
+
+/// The outputs to classify by their names and the number of classes to keep
+using Classifications = std::vector<std::pair<std::string, int>>;
+
+/**
+ * @brief Get the outputs of a request that have the "classification"
+ * parameter, which is the number of top classes to return for that output
+ *
+ * @param request the request to check
+ * @return Classifications - the outputs to classify, which is empty for most
+ * requests
+ */
+[[nodiscard]] Classifications getClassifications(
+  const InferenceRequest& request);
+
+/**
+ * @brief Replace the classified outputs of a response with the top k classes
+ * of each row. The last dimension of an output is taken to be its classes and
+ * it's replaced by [k, 2] pairs of the class index and its score as FP32,
+ * largest first. Other outputs are left as they are.
+ *
+ * @param response the response to change
+ * @param classifications the outputs to classify
+ */
+void classify(InferenceResponse* response,
+              const Classifications& classifications);
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_CORE_CLASSIFICATION
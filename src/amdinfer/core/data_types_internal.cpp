@@ -100,7 +100,7 @@ xir::DataType mapTypeToXir(DataType type) {
     case DataType::Int64:
       retval.type = xir::DataType::XINT;
       break;
-    // case DataType::Fp16 fall through to default handler
+    // case DataType::Fp16 and Bf16 fall through to default handler
     case DataType::Fp32:
     case DataType::Fp64:
       retval.type = xir::DataType::FLOAT;
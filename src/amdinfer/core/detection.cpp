@@ -0,0 +1,169 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the server-side detection post-processing of output
+ * tensors
+ */
+
+#include "amdinfer/core/detection.hpp"
+
+#include <algorithm>    // for find_if
+#include <cstddef>      // for size_t, byte
+#include <cstdint>      // for int32_t, uint64_t
+#include <cstring>      // for memcpy
+#include <type_traits>  // for is_same_v
+#include <utility>      // for move
+#include <variant>      // for bad_variant_access
+#include <vector>       // for vector
+
+#include "amdinfer/core/data_types.hpp"          // for DataType, switchOver...
+#include "amdinfer/core/exceptions.hpp"          // for invalid_argument
+#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/core/parameters.hpp"          // for ParameterMap
+
+namespace amdinfer {
+
+namespace {
+
+/// The number of floats in each row of a detection output
+constexpr size_t kRowSize = pre_post::kDetectionFloats + 1;
+
+/// Convert an output to floats for the detection
+struct ToFloats {
+  template <typename T>
+  std::vector<float> operator()(const void* data, size_t size) const {
+    if constexpr (std::is_same_v<T, char>) {
+      throw invalid_argument("String outputs can't be detected");
+    } else {
+      const auto* values = static_cast<const T*>(data);
+      std::vector<float> floats(size);
+      for (size_t i = 0; i < size; ++i) {
+        floats[i] = static_cast<float>(values[i]);
+      }
+      return floats;
+    }
+  }
+};
+
+double getThreshold(const ParameterMap& parameters, const std::string& key) {
+  double threshold = 0;
+  try {
+    threshold = parameters.get<double>(key);
+  } catch (const std::bad_variant_access&) {
+    throw invalid_argument("The " + key +
+                           " parameter must be a number in [0, 1]");
+  }
+  if (threshold < 0 || threshold > 1) {
+    throw invalid_argument("The " + key +
+                           " parameter must be a number in [0, 1]");
+  }
+  return threshold;
+}
+
+}  // namespace
+
+DetectionOutputs getDetectionOutputs(const InferenceRequest& request) {
+  DetectionOutputs outputs;
+  for (const auto& output : request.getOutputs()) {
+    const auto& parameters = output.getParameters();
+    if (!parameters.has("detection")) {
+      continue;
+    }
+    pre_post::DetectionOptions options;
+    options.score_threshold =
+      static_cast<float>(getThreshold(parameters, "detection"));
+    if (parameters.has("iou_threshold")) {
+      options.iou_threshold =
+        static_cast<float>(getThreshold(parameters, "iou_threshold"));
+    }
+    if (parameters.has("max_detections")) {
+      int32_t max_detections = -1;
+      try {
+        max_detections = parameters.get<int32_t>("max_detections");
+      } catch (const std::bad_variant_access&) {
+        // the check below rejects it
+      }
+      if (max_detections < 0) {
+        throw invalid_argument(
+          "The max_detections parameter must be a non-negative integer");
+      }
+      options.max_detections = static_cast<size_t>(max_detections);
+    }
+    outputs.emplace_back(output.getName(), options);
+  }
+  return outputs;
+}
+
+void detect(InferenceResponse* response, const DetectionOutputs& outputs) {
+  if (response->isError()) {
+    return;
+  }
+  // moving the outputs out leaves the response without any to add them back
+  auto tensors = std::move(*response).getOutputs();
+  for (auto& tensor : tensors) {
+    const auto detection = std::find_if(
+      outputs.begin(), outputs.end(), [&tensor](const auto& entry) {
+        return entry.first == tensor.getName();
+      });
+    if (detection == outputs.end()) {
+      response->addOutput(std::move(tensor));
+      continue;
+    }
+
+    const auto& shape = tensor.getShape();
+    if ((shape.size() != 2 && shape.size() != 3) ||
+        shape.back() <= pre_post::detail::kBoxValues) {
+      throw invalid_argument("The " + tensor.getName() +
+                             " output must be [batch, boxes, 5 + classes]");
+    }
+    const auto images = shape.size() == 3 ? shape[0] : 1;
+    const auto boxes = shape[shape.size() - 2];
+    const auto classes = shape.back() - pre_post::detail::kBoxValues;
+
+    pre_post::Detections detections;
+    if (tensor.getDatatype() == DataType::Fp32) {
+      detections =
+        pre_post::detect(static_cast<const float*>(tensor.getData()), images,
+                         boxes, classes, detection->second);
+    } else {
+      const auto floats = switchOverTypes(ToFloats(), tensor.getDatatype(),
+                                          tensor.getData(), tensor.getSize());
+      detections = pre_post::detect(floats.data(), images, boxes, classes,
+                                    detection->second);
+    }
+
+    // each row is the index of its image followed by its box
+    std::vector<std::byte> data(detections.boxes.size() * kRowSize *
+                                sizeof(float));
+    auto* rows = reinterpret_cast<float*>(data.data());
+    for (size_t i = 0; i < images; ++i) {
+      for (size_t j = 0; j < detections.count(i); ++j) {
+        *rows = static_cast<float>(i);
+        std::memcpy(rows + 1, detections.data(i) + j,
+                    sizeof(pre_post::Detection));
+        rows += kRowSize;
+      }
+    }
+    tensor.setDatatype(DataType::Fp32);
+    tensor.setShape({static_cast<uint64_t>(detections.boxes.size()),
+                     static_cast<uint64_t>(kRowSize)});
+    tensor.setData(std::move(data));
+    response->addOutput(std::move(tensor));
+  }
+}
+
+}  // namespace amdinfer
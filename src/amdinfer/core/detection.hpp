@@ -0,0 +1,67 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the server-side detection post-processing of output tensors
+ */
+
+#ifndef GUARD_AMDINFER_CORE_DETECTION
+#define GUARD_AMDINFER_CORE_DETECTION
+
+#include <string>   // for string
+#include <utility>  // for pair
+#include <vector>   // for vector
+
+#include "amdinfer/pre_post/detection.hpp"  // for DetectionOptions
+
+namespace amdinfer {
+
+class InferenceRequest;
+class InferenceResponse;
+
+/// The outputs to post-process by their names and the options to use
+using DetectionOutputs =
+  std::vector<std::pair<std::string, pre_post::DetectionOptions>>;
+
+/**
+ * @brief Get the outputs of a request that have the "detection" parameter,
+ * which is the score threshold for the boxes of that output. The optional
+ * "iou_threshold" and "max_detections" parameters of the output set the
+ * suppression's IoU threshold and the most boxes kept for each image.
+ *
+ * @param request the request to check
+ * @return DetectionOutputs - the outputs to post-process, which is empty for
+ * most requests
+ */
+[[nodiscard]] DetectionOutputs getDetectionOutputs(
+  const InferenceRequest& request);
+
+/**
+ * @brief Replace the detection outputs of a response with their decoded boxes
+ * after non-maximum suppression. An output is taken to be [batch, boxes,
+ * 5 + classes] YOLO-style predictions, or [boxes, 5 + classes] for a single
+ * image, and it's replaced by [count, 7] rows of the image's index in the
+ * batch, the class, the score and the box's top-left corner, width and height
+ * as FP32, ordered by image and then by score. Other outputs are left as they
+ * are.
+ *
+ * @param response the response to change
+ * @param outputs the outputs to post-process
+ */
+void detect(InferenceResponse* response, const DetectionOutputs& outputs);
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_CORE_DETECTION
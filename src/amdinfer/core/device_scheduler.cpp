@@ -0,0 +1,235 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the scheduler that shares a device between endpoints
+ */
+
+#include "amdinfer/core/device_scheduler.hpp"
+
+#include <algorithm>  // for max, min
+#include <string>     // for string, to_string
+#include <utility>    // for move, exchange
+
+#include "amdinfer/build_options.hpp"        // for AMDINFER_ENABLE_METRICS
+#include "amdinfer/core/exceptions.hpp"      // for invalid_argument
+#include "amdinfer/observation/logging.hpp"  // for Logger, AMDINFER_LOG_WARN
+#include "amdinfer/observation/metrics.hpp"  // for Metrics
+
+namespace amdinfer {
+
+namespace {
+
+/// the schedulers by device, which are removed once no worker holds them
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+std::map<std::string, std::weak_ptr<DeviceScheduler>> schedulers;
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+std::mutex schedulers_mutex;
+
+}  // namespace
+
+DeviceScheduler::Turn::Turn(std::shared_ptr<DeviceScheduler> scheduler,
+                            std::string endpoint)
+  : scheduler_(std::move(scheduler)),
+    endpoint_(std::move(endpoint)),
+    start_(std::chrono::steady_clock::now()) {}
+
+DeviceScheduler::Turn::Turn(Turn&& other) noexcept
+  : scheduler_(std::move(other.scheduler_)),
+    endpoint_(std::move(other.endpoint_)),
+    start_(other.start_) {}
+
+DeviceScheduler::Turn& DeviceScheduler::Turn::operator=(Turn&& other) noexcept {
+  if (this != &other) {
+    release();
+    scheduler_ = std::move(other.scheduler_);
+    endpoint_ = std::move(other.endpoint_);
+    start_ = other.start_;
+  }
+  return *this;
+}
+
+DeviceScheduler::Turn::~Turn() { release(); }
+
+void DeviceScheduler::Turn::release() {
+  if (auto scheduler = std::exchange(scheduler_, nullptr);
+      scheduler != nullptr) {
+    const std::chrono::duration<double> held =
+      std::chrono::steady_clock::now() - start_;
+    scheduler->finish(endpoint_, held.count());
+  }
+}
+
+std::shared_ptr<DeviceScheduler> DeviceScheduler::get(
+  const std::string& device) {
+  const std::lock_guard lock{schedulers_mutex};
+  auto& scheduler = schedulers[device];
+  if (auto existing = scheduler.lock(); existing != nullptr) {
+    return existing;
+  }
+  auto created = std::make_shared<DeviceScheduler>(device);
+  scheduler = created;
+  return created;
+}
+
+DeviceScheduler::DeviceScheduler(std::string device)
+  : device_(std::move(device)) {}
+
+void DeviceScheduler::addEndpoint(const std::string& endpoint, double weight,
+                                  int32_t priority) {
+  if (weight <= 0) {
+    throw invalid_argument("The device weight of " + endpoint +
+                           " must be positive");
+  }
+  {
+    const std::lock_guard lock{mutex_};
+    auto& state = endpoints_[endpoint];
+    state.weight = weight;
+    state.priority = priority;
+    state.workers++;
+  }
+  turns_.notify_all();
+}
+
+void DeviceScheduler::removeEndpoint(const std::string& endpoint) {
+  {
+    const std::lock_guard lock{mutex_};
+    auto it = endpoints_.find(endpoint);
+    if (it == endpoints_.end()) {
+      return;
+    }
+    auto& state = it->second;
+    if (state.workers > 0) {
+      state.workers--;
+    }
+    if (state.workers == 0 && state.waiting == 0 && state.running == 0) {
+      endpoints_.erase(it);
+    }
+    if (endpoints_.empty()) {
+      jobs_.reset();
+    }
+  }
+  turns_.notify_all();
+}
+
+void DeviceScheduler::setJobs(size_t jobs) {
+  {
+    const std::lock_guard lock{mutex_};
+    if (jobs_.has_value() && jobs_.value() != jobs) {
+      const auto error = "The device " + device_ + " already runs at most " +
+                         std::to_string(jobs_.value()) + " jobs so it can't " +
+                         "run at most " + std::to_string(jobs);
+      AMDINFER_IF_LOGGING(Logger logger{Loggers::Server};)
+      AMDINFER_LOG_WARN(logger, error);
+      throw invalid_argument(error);
+    }
+    jobs_ = jobs;
+  }
+  turns_.notify_all();
+}
+
+DeviceScheduler::Turn DeviceScheduler::acquire(const std::string& endpoint) {
+  std::unique_lock lock{mutex_};
+  auto& state = startWaiting(endpoint);
+  turns_.wait(lock, [this, &state]() { return isNext(state); });
+  state.waiting--;
+  state.running++;
+  running_++;
+  return Turn{shared_from_this(), endpoint};
+}
+
+std::optional<DeviceScheduler::Turn> DeviceScheduler::tryAcquire(
+  const std::string& endpoint) {
+  const std::lock_guard lock{mutex_};
+  auto& state = startWaiting(endpoint);
+  state.waiting--;
+  if (!isNext(state)) {
+    return std::nullopt;
+  }
+  state.running++;
+  running_++;
+  return Turn{shared_from_this(), endpoint};
+}
+
+double DeviceScheduler::getDeviceTime(const std::string& endpoint) const {
+  const std::lock_guard lock{mutex_};
+  auto it = endpoints_.find(endpoint);
+  return it != endpoints_.end() ? it->second.seconds : 0;
+}
+
+DeviceScheduler::Endpoint& DeviceScheduler::startWaiting(
+  const std::string& endpoint) {
+  auto& state = endpoints_[endpoint];
+  if (state.waiting == 0 && state.running == 0) {
+    // an endpoint that was idle catches up with the least charged of the busy
+    // ones so it can't save up turns while it has nothing to run
+    std::optional<double> least;
+    for (const auto& [name, other] : endpoints_) {
+      if (&other != &state && (other.waiting > 0 || other.running > 0)) {
+        least = std::min(least.value_or(other.charged), other.charged);
+      }
+    }
+    state.charged = std::max(state.charged, least.value_or(0));
+  }
+  state.waiting++;
+  return state;
+}
+
+bool DeviceScheduler::isNext(const Endpoint& endpoint) const {
+  const auto jobs = jobs_.value_or(0);
+  if (jobs == 0) {
+    return true;
+  }
+  if (running_ >= jobs) {
+    return false;
+  }
+  for (const auto& [name, other] : endpoints_) {
+    if (&other == &endpoint || other.waiting == 0) {
+      continue;
+    }
+    if (other.priority > endpoint.priority ||
+        (other.priority == endpoint.priority &&
+         other.charged < endpoint.charged)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void DeviceScheduler::finish(const std::string& endpoint, double seconds) {
+  {
+    const std::lock_guard lock{mutex_};
+    auto it = endpoints_.find(endpoint);
+    if (it != endpoints_.end()) {
+      auto& state = it->second;
+      state.running--;
+      state.seconds += seconds;
+      state.charged += seconds / state.weight;
+      if (state.workers == 0 && state.waiting == 0 && state.running == 0) {
+        endpoints_.erase(it);
+      }
+    }
+    if (endpoints_.empty()) {
+      jobs_.reset();
+    }
+    running_--;
+  }
+  turns_.notify_all();
+#ifdef AMDINFER_ENABLE_METRICS
+  Metrics::getInstance().addDeviceTime(device_, endpoint, seconds);
+#endif
+}
+
+}  // namespace amdinfer
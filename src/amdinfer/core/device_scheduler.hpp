@@ -0,0 +1,167 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the scheduler that shares a device between the endpoints
+ * whose workers run on it
+ */
+
+#ifndef GUARD_AMDINFER_CORE_DEVICE_SCHEDULER
+#define GUARD_AMDINFER_CORE_DEVICE_SCHEDULER
+
+#include <chrono>              // for steady_clock
+#include <condition_variable>  // for condition_variable
+#include <cstddef>             // for size_t
+#include <cstdint>             // for int32_t
+#include <map>                 // for map
+#include <memory>              // for shared_ptr
+#include <mutex>               // for mutex
+#include <optional>            // for optional
+#include <string>              // for string
+
+namespace amdinfer {
+
+/// Endpoints get this share of a device, relative to the others, by default
+constexpr double kDefaultDeviceWeight = 1.0;
+
+/**
+ * @brief Shares a device, such as a GPU or a DPU, between the endpoints whose
+ * workers run on it. Workers take a turn before they start a job on the device
+ * and give it back once the job is done. If the device runs at most a number
+ * of jobs at once, waiting endpoints get turns by their priority and then by
+ * weighted fair queuing: an endpoint is charged the device time of its jobs
+ * divided by its weight and the one that's been charged the least goes next,
+ * so a busy endpoint can't starve the others. Without a limit, turns are
+ * never waited for and only the device time of each endpoint is recorded.
+ *
+ * There's one scheduler per device, shared by all the workers on it, which is
+ * safe to use from multiple threads.
+ */
+class DeviceScheduler : public std::enable_shared_from_this<DeviceScheduler> {
+ public:
+  /// Holds an endpoint's turn on the device until it's released
+  class Turn {
+   public:
+    Turn() = default;
+    Turn(const Turn&) = delete;             ///< Copy constructor
+    Turn& operator=(const Turn&) = delete;  ///< Copy assignment
+    Turn(Turn&& other) noexcept;            ///< Move constructor
+    Turn& operator=(Turn&& other) noexcept;  ///< Move assignment
+    ~Turn();                                 ///< Destructor
+
+    /// Give the turn back and charge its endpoint for the time it was held
+    void release();
+
+   private:
+    friend class DeviceScheduler;
+    Turn(std::shared_ptr<DeviceScheduler> scheduler, std::string endpoint);
+
+    std::shared_ptr<DeviceScheduler> scheduler_;
+    std::string endpoint_;
+    std::chrono::steady_clock::time_point start_;
+  };
+
+  /**
+   * @brief Get the scheduler of a device, which is made the first time it's
+   * asked for and lives while any worker holds it
+   *
+   * @param device the device's name, such as gpu0
+   * @return std::shared_ptr<DeviceScheduler>
+   */
+  static std::shared_ptr<DeviceScheduler> get(const std::string& device);
+
+  /**
+   * @brief Construct a new DeviceScheduler object. Use get() to share the
+   * device's scheduler instead.
+   *
+   * @param device the device's name
+   */
+  explicit DeviceScheduler(std::string device);
+
+  /**
+   * @brief Add a worker of an endpoint to the device. Each endpoint has one
+   * weight and priority, which are updated by its latest worker.
+   *
+   * @param endpoint the worker's endpoint
+   * @param weight share of the device relative to other endpoints of the same
+   * priority. It must be positive
+   * @param priority endpoints with higher priorities go first
+   */
+  void addEndpoint(const std::string& endpoint, double weight,
+                   int32_t priority);
+  /// Remove a worker of an endpoint from the device
+  void removeEndpoint(const std::string& endpoint);
+
+  /**
+   * @brief Set the most jobs that may run on the device at once. The limit
+   * belongs to the device so it's kept until all its endpoints are removed and
+   * a load that asks for a different one is rejected.
+   *
+   * @param jobs the limit or zero to never wait for turns
+   * @throws invalid_argument if the device already has a different limit
+   */
+  void setJobs(size_t jobs);
+
+  /**
+   * @brief Wait for a turn on the device. A worker must not hold a turn of its
+   * own that it only releases after this returns unless the device isn't
+   * limited.
+   *
+   * @param endpoint the endpoint to run a job for
+   * @return Turn
+   */
+  [[nodiscard]] Turn acquire(const std::string& endpoint);
+  /**
+   * @brief Take a turn on the device if it's the endpoint's turn right away
+   *
+   * @param endpoint the endpoint to run a job for
+   * @return std::optional<Turn> the turn or nullopt if it would have to wait
+   */
+  [[nodiscard]] std::optional<Turn> tryAcquire(const std::string& endpoint);
+
+  /// Get the device time in seconds that an endpoint's jobs have held so far
+  [[nodiscard]] double getDeviceTime(const std::string& endpoint) const;
+
+ private:
+  struct Endpoint {
+    double weight = kDefaultDeviceWeight;
+    int32_t priority = 0;
+    /// device time charged so far, divided by the weight
+    double charged = 0;
+    /// device time held so far, in seconds
+    double seconds = 0;
+    size_t workers = 0;
+    size_t waiting = 0;
+    size_t running = 0;
+  };
+
+  /// Find or add an endpoint and mark it as waiting. The mutex must be held
+  Endpoint& startWaiting(const std::string& endpoint);
+  /// Whether it's a waiting endpoint's turn. The mutex must be held
+  [[nodiscard]] bool isNext(const Endpoint& endpoint) const;
+  void finish(const std::string& endpoint, double seconds);
+
+  std::string device_;
+  /// the limit on jobs, which is unset until an endpoint asks for one
+  std::optional<size_t> jobs_;
+  size_t running_ = 0;
+  std::map<std::string, Endpoint> endpoints_;
+  mutable std::mutex mutex_;
+  std::condition_variable turns_;
+};
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_CORE_DEVICE_SCHEDULER
@@ -19,27 +19,283 @@
 
 #include "amdinfer/core/endpoints.hpp"
 
-#include <cassert>      // for assert
+#include <algorithm>    // for min
+#include <chrono>       // for milliseconds
+#include <cstddef>      // for size_t
+#include <cstdint>      // for int32_t
+#include <exception>    // for exception_ptr, rethrow_exception
+#include <memory>       // for shared_ptr, atomic_load, atomic_store
+#include <mutex>        // for lock_guard, unique_lock
+#include <optional>     // for optional, nullopt
+#include <thread>       // for thread, yield, sleep_for
 #include <type_traits>  // for __decay_and_strip<>::__type
+#include <utility>      // for move
+#include <variant>      // for bad_variant_access
 
-#include "amdinfer/batching/batcher.hpp"        // for Batcher
-#include "amdinfer/build_options.hpp"           // for kMaxModelNameSize
-#include "amdinfer/core/exceptions.hpp"         // for invalid_argument
-#include "amdinfer/core/parameters.hpp"         // for ParameterMap
-#include "amdinfer/core/request_container.hpp"  // for RequestContainer
-#include "amdinfer/core/worker_info.hpp"        // for WorkerInfo
-#include "amdinfer/util/thread.hpp"             // for setThreadName
+#include "amdinfer/batching/batcher.hpp"         // for Batcher
+#include "amdinfer/buffers/cpu.hpp"              // for CpuBuffer
+#include "amdinfer/build_options.hpp"            // for kMaxModelNameSize
+#ifdef AMDINFER_ENABLE_PREPROCESSING
+#include "amdinfer/batching/preprocessor.hpp"  // for Preprocessor
+#endif
+#include "amdinfer/core/autoscaler.hpp"          // for Autoscaler
+#include "amdinfer/core/classification.hpp"      // for Classifications
+#include "amdinfer/core/detection.hpp"           // for DetectionOutputs
+#include "amdinfer/core/ensemble.hpp"            // for Ensemble
+#include "amdinfer/core/exceptions.hpp"          // for invalid_argument, res...
+#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/core/parameters.hpp"          // for ParameterMap
+#include "amdinfer/core/queue_limit.hpp"         // for QueueLimit
+#include "amdinfer/core/request_coalescer.hpp"   // for RequestCoalescer
+#include "amdinfer/core/request_container.hpp"   // for RequestContainer
+#include "amdinfer/core/request_key.hpp"         // for RequestKey
+#include "amdinfer/core/requested_outputs.hpp"   // for filterOutputs
+#include "amdinfer/core/response_cache.hpp"      // for ResponseCache
+#include "amdinfer/core/response_callback.hpp"   // for ResponseCallback
+#include "amdinfer/core/worker_info.hpp"         // for WorkerInfo
+#include "amdinfer/observation/metrics.hpp"      // for Metrics
+#include "amdinfer/observation/tracing.hpp"      // for Trace
+#include "amdinfer/util/thread.hpp"              // for setThreadName
+#include "amdinfer/util/timer.hpp"               // for getTime
 
 namespace amdinfer {
 
-Endpoints::Endpoints() {
+/**
+ * @brief Wait until the caller holds the only reference to a worker that has
+ * been removed from the endpoint table. Any other references come from
+ * readers that found it in an older table so no new ones can appear.
+ *
+ * @param worker the unpublished worker
+ */
+void waitForReaders(const std::shared_ptr<WorkerInfo>& worker) {
+  // readers usually let go right away so it yields a few times before it
+  // sleeps between checks instead of keeping a core busy
+  constexpr int kYields = 64;
+  constexpr std::chrono::milliseconds kPoll{1};
+  for (auto i = 0; worker.use_count() > 1; ++i) {
+    if (i < kYields) {
+      std::this_thread::yield();
+    } else {
+      std::this_thread::sleep_for(kPoll);
+    }
+  }
+}
+
+/**
+ * @brief Report why a worker failed to load as an invalid_argument so it's
+ * handled like any other request for a model that can't be used
+ *
+ * @param endpoint the endpoint that failed to load
+ * @param eptr the error from loading the worker
+ */
+[[noreturn]] void throwLoadError(const std::string& endpoint,
+                                 const std::exception_ptr& eptr) {
+  try {
+    std::rethrow_exception(eptr);
+  } catch (const std::exception& e) {
+    throw invalid_argument("Worker " + endpoint +
+                           " failed to load: " + e.what());
+  } catch (...) {
+    throw invalid_argument("Worker " + endpoint + " failed to load");
+  }
+}
+
+/**
+ * @brief Return the ingress buffers of a request that won't be batched to the
+ * pool. Requests whose inputs are written by the batcher don't have any.
+ *
+ * @param request the request that isn't enqueued
+ * @param pool the pool that the request's input buffers came from
+ */
+void releaseInputs(const RequestContainer& request, const MemoryPool* pool) {
+  if (request.input_writers.empty()) {
+    for (const auto& input : request.request->getInputs()) {
+      pool->put(std::make_unique<CpuBuffer>(
+        input.getData(), MemoryAllocators::Cpu,
+        input.getSize() * input.getDatatype().size()));
+    }
+  }
+}
+
+/**
+ * @brief Answer a request from the response cache without enqueuing it
+ *
+ * @param request the request to answer
+ * @param response the cached response
+ * @param pool the pool that the request's input buffers came from
+ */
+void respondFromCache(RequestContainer* request, InferenceResponse* response,
+                      const MemoryPool* pool) {
+  auto& inference_request = request->request;
+  // the inputs were only read in place so their buffers are returned here
+  releaseInputs(*request, pool);
+  response->setID(inference_request->getID());
+  inference_request->runCallbackOnce(*response);
+}
+
+/**
+ * @brief Take room for a request in its endpoint's queue. If the queue is
+ * full, the request is rejected straight away so clients can back off or try
+ * another server instead of waiting behind the backlog.
+ *
+ * @param endpoint the endpoint the request is for
+ * @param limit the endpoint's queue limit
+ * @param request the request to enqueue
+ * @param pool the pool that the request's input buffers came from
+ */
+void admit(const std::string& endpoint, QueueLimit* limit,
+           RequestContainer* request, const MemoryPool* pool) {
+  size_t bytes = 0;
+  for (const auto& input : request->request->getInputs()) {
+    bytes += input.getSize() * input.getDatatype().size();
+  }
+  auto ticket = limit->tryAcquire(bytes);
+  if (!ticket.has_value()) {
+#ifdef AMDINFER_ENABLE_METRICS
+    Metrics::getInstance().incrementCounter(MetricCounterIDs::RequestsRejected);
+#endif
+    releaseInputs(*request, pool);
+    throw resource_exhausted_error("The queue of " + endpoint + " is full");
+  }
+  request->queue_ticket = std::move(*ticket);
+}
+
+/**
+ * @brief Bound how long a request may wait in the queue by its "timeout_ms"
+ * parameter, if it has one. This applies to every protocol, including those
+ * that can't tell the server when the client gives up on a request.
+ *
+ * @param request the request to read the timeout of
+ * @param pool the pool that the request's input buffers came from
+ */
+void setTimeout(RequestContainer* request, const MemoryPool* pool) {
+  const auto& parameters = request->request->getParameters();
+  if (!parameters.has("timeout_ms")) {
+    return;
+  }
+  int32_t timeout = 0;
+  try {
+    timeout = parameters.get<int32_t>("timeout_ms");
+  } catch (const std::bad_variant_access&) {
+    releaseInputs(*request, pool);
+    throw invalid_argument("The timeout_ms parameter must be an integer");
+  }
+  request->deadline = std::min(
+    request->deadline, util::getTime() + std::chrono::milliseconds(timeout));
+}
+
+/**
+ * @brief Classify the outputs of the request's response that are requested
+ * with the "classification" parameter. This wraps the callback outside of the
+ * cache and coalescing so the responses from the cache and of coalesced
+ * requests are classified for each request.
+ *
+ * @param request the request to classify the response of
+ * @param pool the pool that the request's input buffers came from
+ */
+void classifyResponse(RequestContainer* request, const MemoryPool* pool) {
+  Classifications classifications;
+  try {
+    classifications = getClassifications(*request->request);
+  } catch (const invalid_argument&) {
+    releaseInputs(*request, pool);
+    throw;
+  }
+  if (classifications.empty()) {
+    return;
+  }
+  auto callback = request->request->getCallback();
+  request->request->setCallback(
+    [classifications = std::move(classifications),
+     callback = std::move(callback)](const InferenceResponse& response) {
+      auto classified = response;
+      try {
+        classify(&classified, classifications);
+      } catch (const invalid_argument& e) {
+        classified = InferenceResponse{e.what()};
+      }
+      callback(classified);
+    });
+}
+
+/**
+ * @brief Decode and suppress the boxes of the outputs of the request's response
+ * that are requested with the "detection" parameter. Like the classification,
+ * this wraps the callback outside of the cache and coalescing.
+ *
+ * @param request the request to post-process the response of
+ * @param pool the pool that the request's input buffers came from
+ */
+void detectResponse(RequestContainer* request, const MemoryPool* pool) {
+  DetectionOutputs outputs;
+  try {
+    outputs = getDetectionOutputs(*request->request);
+  } catch (const invalid_argument&) {
+    releaseInputs(*request, pool);
+    throw;
+  }
+  if (outputs.empty()) {
+    return;
+  }
+  auto callback = request->request->getCallback();
+  request->request->setCallback(
+    [outputs = std::move(outputs),
+     callback = std::move(callback)](const InferenceResponse& response) {
+      auto detected = response;
+      try {
+        detect(&detected, outputs);
+      } catch (const invalid_argument& e) {
+        detected = InferenceResponse{e.what()};
+      }
+      callback(detected);
+    });
+}
+
+/**
+ * @brief Remove the outputs of the request's response that it didn't ask for.
+ * Like the classification, this is done for each request since the cached and
+ * coalesced responses may be shared by requests asking for other outputs.
+ *
+ * @param request the request to filter the response of
+ */
+void filterResponse(RequestContainer* request) {
+  auto requested = getRequestedOutputs(*request->request);
+  if (requested.empty()) {
+    return;
+  }
+  auto callback = request->request->getCallback();
+  request->request->setCallback(
+    [requested = std::move(requested),
+     callback = std::move(callback)](const InferenceResponse& response) {
+      auto filtered = response;
+      filterOutputs(&filtered, requested);
+      callback(filtered);
+    });
+}
+
+Endpoints::Endpoints()
+  : workers_(std::make_shared<const EndpointTable>()),
+    ensembles_(std::make_shared<const EnsembleTable>()),
+    load_states_(std::make_shared<const LoadStateTable>()) {
   update_thread_ = std::thread(&Endpoints::updateManager, this, &update_queue_);
+#ifdef AMDINFER_ENABLE_METRICS
+  autoscale_thread_ = std::thread(&Endpoints::autoscale, this);
+#endif
 }
 
 Endpoints::~Endpoints() { this->shutdown(); }
 
 std::string Endpoints::load(const std::string& worker,
                             ParameterMap parameters) {
+  // async isn't part of the worker's identity so it's removed before the
+  // parameters are used to find the endpoint
+  bool async = false;
+  if (parameters.has("async")) {
+    async = parameters.get<bool>("async");
+    parameters.erase("async");
+  }
+
   std::shared_ptr<amdinfer::UpdateCommand> request;
   std::string retval;
   retval.reserve(kMaxModelNameSize);
@@ -56,95 +312,294 @@ std::string Endpoints::load(const std::string& worker,
     std::rethrow_exception(request->eptr);
   }
   auto endpoint = *(static_cast<std::string*>(request->retval));
+  if (!async) {
+    this->waitForLoad(endpoint);
+  }
   return endpoint;
 }
 
+std::string Endpoints::loadEnsemble(EnsembleConfig config) {
+  std::string retval;
+  retval.reserve(kMaxModelNameSize);
+  auto request = std::make_shared<UpdateCommand>(
+    UpdateCommandType::LoadEnsemble, "", &config, &retval);
+  update_queue_.enqueue(request);
+
+  while (retval.empty() && request->eptr == nullptr) {
+    std::this_thread::yield();
+  }
+  if (request->eptr != nullptr) {
+    std::rethrow_exception(request->eptr);
+  }
+  return retval;
+}
+
 void Endpoints::unload(const std::string& endpoint) {
-  if (this->exists(endpoint)) {
+  if (aliases_.erase(endpoint)) {
+    const auto prefix = endpoint + "/";
+    for (const auto& version : this->list()) {
+      if (version.compare(0, prefix.size(), prefix) == 0) {
+        this->unload(version);
+      }
+    }
+    return;
+  }
+
+  // unloading a failed load just forgets about it. One that's still loading
+  // is torn down by the update thread once it finishes
+  bool loading = false;
+  if (auto state = this->getLoadState(endpoint); state.has_value()) {
+    if (state->status == LoadStatus::Failed) {
+      this->setLoadState(endpoint, std::nullopt);
+    } else {
+      loading = true;
+    }
+  }
+  if (loading || this->exists(endpoint)) {
     auto request =
       std::make_shared<UpdateCommand>(UpdateCommandType::Unload, endpoint);
     update_queue_.enqueue(request);
   }
 }
 
-// TODO(varunsh): race condition if workers are shutting down
+void Endpoints::setAlias(const std::string& name,
+                         const std::string& endpoint) {
+  aliases_.set(name, endpoint);
+}
+
+std::string Endpoints::resolve(const std::string& name) const {
+  return aliases_.resolve(name);
+}
+
 void Endpoints::infer(const std::string& endpoint,
                       std::unique_ptr<RequestContainer> request) const {
-  WorkerInfo* worker = this->unsafeGet(endpoint);
+  classifyResponse(request.get(), getPool());
+  detectResponse(request.get(), getPool());
+  filterResponse(request.get());
+  // holding the worker keeps it alive and loaded until the request is queued
+  std::string target;
+  auto worker = this->getResolved(endpoint, &target);
   if (worker == nullptr) {
+    if (auto ensemble = this->getEnsemble(target); ensemble != nullptr) {
+#ifdef AMDINFER_ENABLE_TRACING
+      if (request->trace != nullptr) {
+        request->trace->tailSample(request->request.get(), std::nullopt);
+      }
+#endif
+      ensemble->infer(std::move(request));
+      return;
+    }
     throw invalid_argument("Worker " + endpoint + " not found");
   }
+#ifdef AMDINFER_ENABLE_TRACING
+  // tail sampling decides whether to keep the trace once the request responds
+  if (request->trace != nullptr) {
+    request->trace->tailSample(request->request.get(),
+                               worker->getTraceLatency());
+  }
+#endif
+  setTimeout(request.get(), getPool());
+  auto cache = worker->getCache();
+  std::optional<RequestKey> cache_key;
+  if (cache != nullptr) {
+    cache_key = ResponseCache::key(*request);
+    if (cache_key.has_value()) {
+      if (auto response = cache->get(*cache_key); response.has_value()) {
+        respondFromCache(request.get(), &(*response), getPool());
+        return;
+      }
+    }
+  }
+  auto coalescer = worker->getCoalescer();
+  std::optional<RequestKey> coalesce_key;
+  if (coalescer != nullptr) {
+    coalesce_key = RequestCoalescer::key(*request);
+    if (coalesce_key.has_value()) {
+      // the attached request's inputs were only read to hash them
+      if (coalescer->join(*coalesce_key, request->request.get())) {
+        releaseInputs(*request, getPool());
+        return;
+      }
+      // the coalescer answers this request after the attached ones
+      request->request->setCallback(
+        [coalescer, key = *coalesce_key](const InferenceResponse& response) {
+          coalescer->finish(key, response);
+        });
+      request->coalescer = coalescer.get();
+      request->coalesce_key = *coalesce_key;
+    }
+  }
+  // the response is cached before the attached requests are answered so the
+  // next identical request is a hit rather than run again
+  if (cache_key.has_value()) {
+    auto callback = request->request->getCallback();
+    request->request->setCallback(
+      [cache, key = *cache_key,
+       callback = std::move(callback)](const InferenceResponse& response) {
+        cache->put(key, response);
+        callback(response);
+      });
+  }
+  if (auto* limit = worker->getQueueLimit(); limit != nullptr) {
+    try {
+      admit(endpoint, limit, request.get(), getPool());
+    } catch (const resource_exhausted_error& e) {
+      // the caller gets the error but the requests attached to this one are
+      // only answered through their callbacks
+      if (coalesce_key.has_value()) {
+        ResponseCallback callback;
+        if (coalescer->detach(*coalesce_key, &callback)) {
+          coalescer->finish(*coalesce_key, InferenceResponse{e.what()});
+        }
+      }
+      throw;
+    }
+  }
+#ifdef AMDINFER_ENABLE_PREPROCESSING
+  if (auto* preprocessor = worker->getPreprocessor(); preprocessor != nullptr) {
+    preprocessor->enqueue(std::move(request));
+    return;
+  }
+#endif
   const auto* batcher = worker->getBatcher();
   batcher->enqueue(std::move(request));
 }
 
-bool Endpoints::exists(const std::string& endpoint) {
-  int retval = -1;
-  auto request = std::make_shared<UpdateCommand>(UpdateCommandType::Exists,
-                                                 endpoint, nullptr, &retval);
-  update_queue_.enqueue(request);
+bool Endpoints::exists(const std::string& endpoint) const {
+  const auto target = this->resolve(endpoint);
+  return this->get(target) != nullptr || this->getEnsemble(target) != nullptr;
+}
 
-  while (retval == -1 && request->eptr == nullptr) {
-    std::this_thread::yield();
+bool Endpoints::ready(const std::string& endpoint) const {
+  if (auto target = this->resolve(endpoint); target != endpoint) {
+    return this->ready(target);
   }
-  if (request->eptr != nullptr) {
-    std::rethrow_exception(request->eptr);
+  if (auto state = this->getLoadState(endpoint); state.has_value()) {
+    if (state->status == LoadStatus::Failed) {
+      throwLoadError(endpoint, state->eptr);
+    }
+    return false;
+  }
+  if (auto ensemble = this->getEnsemble(endpoint); ensemble != nullptr) {
+    for (const auto& model : ensemble->getModels()) {
+      if (!this->exists(model) || !this->ready(model)) {
+        return false;
+      }
+    }
+    return true;
   }
-  return retval != 0;
+  return this->metadata(endpoint).isReady();
 }
 
-bool Endpoints::ready(const std::string& endpoint) {
-  std::shared_ptr<amdinfer::UpdateCommand> request;
-  int ready = -1;
-  request = std::make_shared<UpdateCommand>(UpdateCommandType::Ready, endpoint,
-                                            nullptr, &ready);
-  update_queue_.enqueue(request);
-  while (ready == -1 && request->eptr == nullptr) {
-    std::this_thread::yield();
+std::vector<std::string> Endpoints::list() const {
+  auto table = this->snapshot();
+  auto ensembles = std::atomic_load(&ensembles_);
+  auto aliases = aliases_.snapshot();
+  std::vector<std::string> endpoints;
+  endpoints.reserve(table->size() + ensembles->size() + aliases->size());
+  for (const auto& [endpoint, _] : *table) {
+    endpoints.push_back(endpoint);
   }
-  if (request->eptr != nullptr) {
-    std::rethrow_exception(request->eptr);
+  for (const auto& [endpoint, _] : *ensembles) {
+    endpoints.push_back(endpoint);
   }
-  return ready != 0;
+  for (const auto& [alias, _] : *aliases) {
+    endpoints.push_back(alias);
+  }
+  return endpoints;
 }
 
-std::vector<std::string> Endpoints::list() {
-  std::shared_ptr<amdinfer::UpdateCommand> request;
-  std::vector<std::string> endpoints;
-  bool retval = false;
-  request = std::make_shared<UpdateCommand>(UpdateCommandType::List, "",
-                                            &endpoints, &retval);
-  update_queue_.enqueue(request);
-  while (!retval && request->eptr == nullptr) {
-    std::this_thread::yield();
+std::vector<EndpointState> Endpoints::states() const {
+  auto table = this->snapshot();
+  std::vector<EndpointState> states;
+  states.reserve(table->size());
+  for (const auto& [endpoint, worker] : *table) {
+    states.push_back(worker->getState());
   }
-  if (request->eptr != nullptr) {
-    std::rethrow_exception(request->eptr);
+  return states;
+}
+
+std::optional<size_t> Endpoints::queued(const std::string& endpoint) const {
+  std::string target;
+  auto worker = this->getResolved(endpoint, &target);
+  if (worker != nullptr) {
+    return worker->getQueued();
   }
-  return endpoints;
+  if (this->getEnsemble(target) != nullptr) {
+    return 0;
+  }
+  return std::nullopt;
 }
 
-ModelMetadata Endpoints::metadata(const std::string& endpoint) {
-  std::shared_ptr<amdinfer::UpdateCommand> request;
-  ModelMetadata metadata{"", ""};
-  bool retval = false;
-  request = std::make_shared<UpdateCommand>(UpdateCommandType::Metadata,
-                                            endpoint, &metadata, &retval);
-  update_queue_.enqueue(request);
-  while (!retval && request->eptr == nullptr) {
-    std::this_thread::yield();
+std::unordered_map<std::string, size_t> Endpoints::loads() const {
+  auto table = this->snapshot();
+  std::unordered_map<std::string, size_t> loads;
+  for (const auto& [endpoint, worker] : *table) {
+    loads.try_emplace(endpoint, worker->getQueued());
   }
-  if (request->eptr != nullptr) {
-    std::rethrow_exception(request->eptr);
+  auto aliases = aliases_.snapshot();
+  for (const auto& [name, endpoint] : *aliases) {
+    if (auto iterator = loads.find(endpoint); iterator != loads.end()) {
+      loads.try_emplace(name, iterator->second);
+    }
+  }
+  return loads;
+}
+
+#ifdef AMDINFER_ENABLE_METRICS
+std::map<std::string, SignalValues> Endpoints::signals() const {
+  auto table = this->snapshot();
+  std::map<std::string, SignalValues> signals;
+  for (const auto& [endpoint, worker] : *table) {
+    signals.try_emplace(endpoint, worker->getSignals());
+  }
+  return signals;
+}
+#endif
+
+ModelMetadata Endpoints::metadata(const std::string& endpoint) const {
+  if (auto target = this->resolve(endpoint); target != endpoint) {
+    return this->metadata(target);
+  }
+  auto worker = this->get(endpoint);
+  if (worker != nullptr) {
+    return worker->getMetadata();
+  }
+  if (auto ensemble = this->getEnsemble(endpoint); ensemble != nullptr) {
+    auto metadata = ensemble->getMetadata();
+    metadata.setReady(this->ready(endpoint));
+    return metadata;
   }
-  return metadata;
+  if (auto state = this->getLoadState(endpoint); state.has_value()) {
+    if (state->status == LoadStatus::Failed) {
+      throwLoadError(endpoint, state->eptr);
+    }
+    // the tensors aren't known until the worker is loaded
+    ModelMetadata metadata{endpoint, ""};
+    metadata.setReady(false);
+    return metadata;
+  }
+  throw invalid_argument("Worker " + endpoint + " not found");
 }
 
 const MemoryPool* Endpoints::getPool() const { return &pool_; }
 
+MemoryPool* Endpoints::getPool() { return &pool_; }
+
 // TODO(varunsh): if multiple commands sent post-shutdown, they will linger
 // in the queue and may cause problems
 void Endpoints::shutdown() {
+#ifdef AMDINFER_ENABLE_METRICS
+  // stopped first so it doesn't ask for steps after the update thread ends
+  if (this->autoscale_thread_.joinable()) {
+    {
+      std::lock_guard lock{autoscale_mutex_};
+      stop_autoscaling_ = true;
+    }
+    autoscale_cv_.notify_all();
+    this->autoscale_thread_.join();
+  }
+#endif
   if (this->update_thread_.joinable()) {
     auto request = std::make_shared<UpdateCommand>(UpdateCommandType::Shutdown);
     update_queue_.enqueue(request);
@@ -173,43 +628,27 @@ void Endpoints::updateManager(UpdateCommandQueue* input_queue) {
           request->eptr = std::current_exception();
         }
         break;
-      case UpdateCommandType::Unload:
-        this->unsafeUnload(request->key);
-        break;
-      case UpdateCommandType::Exists:
+      case UpdateCommandType::LoadEnsemble:
         try {
-          *static_cast<int*>(request->retval) =
-            static_cast<int>(this->unsafeExists(request->key));
+          auto* config = static_cast<EnsembleConfig*>(request->object);
+          auto endpoint = this->unsafeLoadEnsemble(config);
+          static_cast<std::string*>(request->retval)->assign(endpoint);
         } catch (...) {
           request->eptr = std::current_exception();
         }
         break;
-      case UpdateCommandType::Ready:
-        try {
-          auto metadata = this->unsafeMetadata(request->key);
-          *static_cast<int*>(request->retval) =
-            static_cast<int>(metadata.isReady());
-        } catch (...) {
-          request->eptr = std::current_exception();
-        }
+      case UpdateCommandType::LoadDone:
+        this->unsafeFinishLoad(request->key);
         break;
-      case UpdateCommandType::List:
-        try {
-          auto* list = static_cast<std::vector<std::string>*>(request->object);
-          this->unsafeList(list);
-          *static_cast<bool*>(request->retval) = true;
-        } catch (...) {
-          request->eptr = std::current_exception();
-        }
+      case UpdateCommandType::Unload:
+        this->unsafeUnload(request->key);
         break;
-      case UpdateCommandType::Metadata:
-        try {
-          auto* metadata = static_cast<ModelMetadata*>(request->object);
-          *metadata = this->unsafeMetadata(request->key);
-          *static_cast<bool*>(request->retval) = true;
-        } catch (...) {
-          request->eptr = std::current_exception();
-        }
+      case UpdateCommandType::ScaleUp:
+      case UpdateCommandType::ScaleDown:
+#ifdef AMDINFER_ENABLE_METRICS
+        this->unsafeScale(request->key,
+                          request->cmd == UpdateCommandType::ScaleUp);
+#endif
         break;
       case UpdateCommandType::Shutdown:
         this->unsafeShutdown();
@@ -227,25 +666,77 @@ std::string Endpoints::unsafeLoad(const std::string& worker,
     share = parameters->get<bool>("share");
     parameters->erase("share");
   }
+  // the number of instances isn't part of the endpoint's identity so loading
+  // more instances of a model adds them to its existing endpoint
+  size_t instances = 1;
+  if (parameters->has("instances")) {
+    const auto count = parameters->get<int32_t>("instances");
+    if (count <= 0) {
+      throw invalid_argument("The number of instances must be positive");
+    }
+    instances = count;
+    parameters->erase("instances");
+  }
 
   auto endpoint = this->insertWorker(worker, *parameters);
-  auto* worker_info = this->unsafeGet(endpoint);
+  auto worker_info = this->get(endpoint);
 
   std::string worker_name = endpoint;
   if (parameters->has("worker")) {
     worker_name = parameters->get<std::string>("worker");
   }
 
-  // if the worker doesn't exist yet, we need to create it
+  // the same worker is already loading so the caller can share its load. A
+  // load after an unload keeps the endpoint and instances that aren't shared
+  // are added once it's loaded
+  if (auto task = load_tasks_.find(endpoint); task != load_tasks_.end()) {
+    if (!share) {
+      auto* pool = this->unsafeGetPool(endpoint, *parameters);
+      task->second->pending.push_back(
+        {worker_name, *parameters, pool, instances});
+    }
+    task->second->unload = false;
+    return endpoint;
+  }
+
+  MemoryPool* pool = nullptr;
   try {
-    if (worker_info == nullptr) {
-      auto new_worker =
-        std::make_unique<WorkerInfo>(worker_name, parameters, &pool_);
-      this->workers_.try_emplace(endpoint, std::move(new_worker));
-      // if the worker exists but the share parameter is false, we need to add
-      // one
-    } else if (!share) {
-      worker_info->addAndStartWorker(worker_name, parameters, &pool_);
+    pool = this->unsafeGetPool(endpoint, *parameters);
+  } catch (...) {
+    this->unsafeUnload(endpoint);
+    throw;
+  }
+
+  // if the worker doesn't exist yet, we need to create it. This can take a
+  // long time so it's done in its own thread and the worker is published by
+  // the update thread once it's loaded
+  if (worker_info == nullptr) {
+    this->setLoadState(endpoint, LoadState{});
+    auto task = std::make_unique<LoadTask>();
+    task->thread = std::thread([this, task = task.get(), endpoint, worker_name,
+                                instances, pool,
+                                parameters = *parameters]() mutable {
+      util::setThreadName("load");
+      try {
+        task->worker = std::make_shared<WorkerInfo>(
+          endpoint, worker_name, &parameters, pool, instances);
+      } catch (...) {
+        task->eptr = std::current_exception();
+      }
+      update_queue_.enqueue(
+        std::make_shared<UpdateCommand>(UpdateCommandType::LoadDone, endpoint));
+    });
+    load_tasks_.try_emplace(endpoint, std::move(task));
+    return endpoint;
+  }
+
+  try {
+    // if the worker exists but the share parameter is false, we need to add
+    // the requested instances to it
+    if (!share) {
+      for (auto i = 0U; i < instances; ++i) {
+        worker_info->addAndStartWorker(worker_name, parameters, pool);
+      }
     }
   } catch (...) {
     // undo the load if the worker creation fails
@@ -255,21 +746,105 @@ std::string Endpoints::unsafeLoad(const std::string& worker,
   return endpoint;
 }
 
+std::string Endpoints::unsafeLoadEnsemble(EnsembleConfig* config) {
+  auto endpoint = config->metadata.getName();
+  if (this->get(endpoint) != nullptr ||
+      load_tasks_.find(endpoint) != load_tasks_.end()) {
+    throw invalid_argument("Ensemble " + endpoint +
+                           " has the same name as a worker");
+  }
+  auto ensemble = std::make_shared<const Ensemble>(
+    std::move(*config),
+    [this](const std::string& model,
+           std::unique_ptr<RequestContainer> request) {
+      this->infer(model, std::move(request));
+    },
+    &pool_);
+
+  auto table = *(std::atomic_load(&ensembles_));
+  table.insert_or_assign(endpoint, std::move(ensemble));
+  this->publishEnsembles(std::move(table));
+  return endpoint;
+}
+
+void Endpoints::unsafeFinishLoad(const std::string& endpoint) {
+  auto node = load_tasks_.extract(endpoint);
+  if (node.empty()) {
+    return;
+  }
+  auto& task = node.mapped();
+  task->thread.join();
+
+  if (task->unload) {
+    // the endpoint was unloaded while it was loading so it's never published
+    if (task->worker != nullptr) {
+      task->worker->shutdown();
+    }
+    this->unsafeUnload(endpoint);
+    this->setLoadState(endpoint, std::nullopt);
+  } else if (task->eptr == nullptr) {
+    // the load already succeeded for its callers so the instances that can't
+    // be added are only logged, as when scaling
+    for (auto& pending : task->pending) {
+      try {
+        for (auto i = 0U; i < pending.count; ++i) {
+          task->worker->addAndStartWorker(pending.worker, &pending.parameters,
+                                          pending.pool);
+        }
+      } catch (const std::exception& e) {
+        AMDINFER_LOG_WARN(logger_, "Cannot add an instance to " + endpoint +
+                                     ": " + e.what());
+      }
+    }
+    auto table = *(this->snapshot());
+    table.try_emplace(endpoint, std::move(task->worker));
+    this->publish(std::move(table));
+    this->setLoadState(endpoint, std::nullopt);
+  } else {
+    // undo the load if the worker creation fails
+    this->unsafeUnload(endpoint);
+    this->setLoadState(endpoint, LoadState{LoadStatus::Failed, task->eptr});
+  }
+}
+
 void Endpoints::unsafeUnload(const std::string& endpoint) {
+  // requests already running in an ensemble hold it until they're done
+  if (this->getEnsemble(endpoint) != nullptr) {
+    auto table = *(std::atomic_load(&ensembles_));
+    table.erase(endpoint);
+    this->publishEnsembles(std::move(table));
+    return;
+  }
+
+  // an endpoint that's still loading isn't published yet
+  if (auto task = load_tasks_.find(endpoint); task != load_tasks_.end()) {
+    task->second->unload = true;
+    return;
+  }
+
   auto hyphen_pos = endpoint.find('-');
   auto worker =
     hyphen_pos != std::string::npos ? endpoint.substr(0, hyphen_pos) : endpoint;
 
-  auto* worker_info = this->unsafeGet(endpoint);
+  auto worker_info = this->get(endpoint);
+  const bool last_worker =
+    worker_info == nullptr || worker_info->getGroupSize() <= 1;
+
   if (worker_info != nullptr) {
+    // remove the endpoint before unloading its last worker so no new requests
+    // can find it and wait for readers that found it earlier to finish
+    if (last_worker) {
+      auto table = *(this->snapshot());
+      table.erase(endpoint);
+      this->publish(std::move(table));
+      waitForReaders(worker_info);
+    }
     worker_info->unload();
   }
 
   // if it's a brand-new worker that failed or the last worker being unloaded,
   // clean up our parameters and endpoint metadata
-  if (worker_info == nullptr || worker_info->getGroupSize() == 0) {
-    this->workers_.erase(endpoint);
-
+  if (last_worker) {
     if (worker_endpoints_.find(worker) != worker_endpoints_.end()) {
       auto& map = worker_endpoints_.at(worker);
       if (worker_parameters_.find(endpoint) != worker_parameters_.end()) {
@@ -285,45 +860,191 @@ void Endpoints::unsafeUnload(const std::string& endpoint) {
   }
 }
 
-bool Endpoints::unsafeExists(const std::string& endpoint) const {
-  return workers_.find(endpoint) != workers_.end();
+#ifdef AMDINFER_ENABLE_METRICS
+void Endpoints::unsafeScale(const std::string& endpoint, bool up) {
+  auto worker_info = this->get(endpoint);
+  if (worker_info == nullptr) {
+    return;
+  }
+  auto* autoscaler = worker_info->getAutoscaler();
+  try {
+    if (up) {
+      AMDINFER_LOG_INFO(logger_, "Adding an instance to " + endpoint);
+      worker_info->addInstance(
+        this->unsafeGetPool(endpoint, worker_parameters_.at(endpoint)));
+    } else if (worker_info->getGroupSize() >
+               autoscaler->getLimits().min_instances) {
+      AMDINFER_LOG_INFO(logger_, "Retiring an instance of " + endpoint);
+      worker_info->unload();
+    }
+  } catch (const std::exception& e) {
+    AMDINFER_LOG_WARN(logger_, "Cannot scale " + endpoint + ": " + e.what());
+  }
+  autoscaler->finish(util::getTime());
 }
 
-WorkerInfo* Endpoints::unsafeGet(const std::string& endpoint) const {
-  if (auto iterator = workers_.find(endpoint); iterator != workers_.end()) {
-    return iterator->second.get();
+void Endpoints::autoscale() {
+  util::setThreadName("autoscale");
+  std::unique_lock lock{autoscale_mutex_};
+  while (!autoscale_cv_.wait_for(lock, kAutoscaleInterval,
+                                 [this]() { return stop_autoscaling_; })) {
+    lock.unlock();
+    const auto now = util::getTime();
+    const auto table = this->snapshot();
+    for (const auto& [endpoint, worker_info] : *table) {
+      auto* autoscaler = worker_info->getAutoscaler();
+      if (autoscaler == nullptr) {
+        continue;
+      }
+      const auto step = autoscaler->decide(
+        worker_info->getSignals(), worker_info->getGroupSize(), now);
+      if (step != 0) {
+        update_queue_.enqueue(std::make_shared<UpdateCommand>(
+          step > 0 ? UpdateCommandType::ScaleUp : UpdateCommandType::ScaleDown,
+          endpoint));
+      }
+    }
+    lock.lock();
+  }
+}
+#endif
+
+std::shared_ptr<const EndpointTable> Endpoints::snapshot() const {
+  return std::atomic_load(&workers_);
+}
+
+std::shared_ptr<WorkerInfo> Endpoints::get(const std::string& endpoint) const {
+  auto table = this->snapshot();
+  if (auto iterator = table->find(endpoint); iterator != table->end()) {
+    return iterator->second;
   }
   return nullptr;
 }
 
-void Endpoints::unsafeList(std::vector<std::string>* list) const {
-  assert(list != nullptr);
-  assert(list->empty());
-  list->reserve(workers_.size());
-  for (const auto& [worker, _] : workers_) {
-    list->push_back(worker);
+std::shared_ptr<WorkerInfo> Endpoints::getResolved(
+  const std::string& name, std::string* endpoint) const {
+  auto target = this->resolve(name);
+  auto worker = this->get(target);
+  // a swap may have moved the alias and unloaded the endpoint it resolved to
+  while (worker == nullptr) {
+    auto current = this->resolve(name);
+    if (current == target) {
+      break;
+    }
+    target = std::move(current);
+    worker = this->get(target);
   }
+  *endpoint = std::move(target);
+  return worker;
 }
 
-// FIXME(varunsh): potential race condition if the worker is being deleted
-ModelMetadata Endpoints::unsafeMetadata(const std::string& endpoint) const {
-  const auto* worker = this->unsafeGet(endpoint);
-  if (worker == nullptr) {
-    throw invalid_argument("Worker " + endpoint + " not found");
+std::shared_ptr<const Ensemble> Endpoints::getEnsemble(
+  const std::string& endpoint) const {
+  auto table = std::atomic_load(&ensembles_);
+  if (auto iterator = table->find(endpoint); iterator != table->end()) {
+    return iterator->second;
   }
-  return worker->getMetadata();
+  return nullptr;
+}
+
+void Endpoints::setLoadState(const std::string& endpoint,
+                             std::optional<LoadState> state) {
+  {
+    std::lock_guard lock{load_mutex_};
+    auto table = *(std::atomic_load(&load_states_));
+    if (state.has_value()) {
+      table.insert_or_assign(endpoint, std::move(state.value()));
+    } else {
+      table.erase(endpoint);
+    }
+    std::atomic_store(&load_states_,
+                      std::make_shared<const LoadStateTable>(std::move(table)));
+  }
+  load_done_.notify_all();
+}
+
+std::optional<LoadState> Endpoints::getLoadState(
+  const std::string& endpoint) const {
+  auto table = std::atomic_load(&load_states_);
+  if (auto iterator = table->find(endpoint); iterator != table->end()) {
+    return iterator->second;
+  }
+  return std::nullopt;
+}
+
+void Endpoints::waitForLoad(const std::string& endpoint) const {
+  std::unique_lock lock{load_mutex_};
+  std::exception_ptr eptr = nullptr;
+  load_done_.wait(lock, [&]() {
+    auto table = std::atomic_load(&load_states_);
+    auto iterator = table->find(endpoint);
+    if (iterator == table->end()) {
+      return true;
+    }
+    eptr = iterator->second.eptr;
+    return iterator->second.status != LoadStatus::Loading;
+  });
+  if (eptr != nullptr) {
+    std::rethrow_exception(eptr);
+  }
+}
+
+void Endpoints::publish(EndpointTable table) {
+  std::atomic_store(&workers_,
+                    std::make_shared<const EndpointTable>(std::move(table)));
+}
+
+void Endpoints::publishEnsembles(EnsembleTable table) {
+  std::atomic_store(&ensembles_,
+                    std::make_shared<const EnsembleTable>(std::move(table)));
 }
 
 void Endpoints::unsafeShutdown() {
-  for (auto const& worker_info : this->workers_) {
-    worker_info.second->shutdown();
+  // wait for any loads in progress and wake anyone waiting on them
+  for (auto& [endpoint, task] : load_tasks_) {
+    task->thread.join();
+    if (task->worker != nullptr) {
+      task->worker->shutdown();
+    }
+    auto error = std::make_exception_ptr(
+      runtime_error("Server shut down while loading " + endpoint));
+    this->setLoadState(endpoint, LoadState{LoadStatus::Failed, error});
+  }
+  load_tasks_.clear();
+
+  this->publishEnsembles({});
+  auto table = this->snapshot();
+  this->publish({});
+  for (const auto& [endpoint, worker_info] : *table) {
+    waitForReaders(worker_info);
+    worker_info->shutdown();
   }
-  this->workers_.clear();
   this->worker_endpoints_.clear();
   this->worker_indices_.clear();
   this->worker_parameters_.clear();
 }
 
+MemoryPool* Endpoints::unsafeGetPool(const std::string& endpoint,
+                                     const ParameterMap& parameters) {
+  if (!parameters.has("memory_pool_mb")) {
+    return &pool_;
+  }
+  if (auto found = partitions_.find(endpoint); found != partitions_.end()) {
+    return found->second.get();
+  }
+  const auto budget = parameters.get<int32_t>("memory_pool_mb");
+  if (budget <= 0) {
+    throw invalid_argument("The memory pool's budget must be positive");
+  }
+  const bool overflow = parameters.has("memory_pool_overflow") &&
+                        parameters.get<bool>("memory_pool_overflow");
+  constexpr size_t kMiB = 1'048'576;
+  auto partition = std::make_unique<MemoryPool>(
+    &pool_, endpoint, static_cast<size_t>(budget) * kMiB, overflow);
+  return partitions_.try_emplace(endpoint, std::move(partition))
+    .first->second.get();
+}
+
 std::string Endpoints::insertWorker(const std::string& worker,
                                     const ParameterMap& parameters) {
   if (worker_endpoints_.find(worker) == worker_endpoints_.end()) {
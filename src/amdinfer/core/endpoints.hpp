@@ -20,26 +20,34 @@
 #ifndef GUARD_AMDINFER_CORE_ENDPOINTS
 #define GUARD_AMDINFER_CORE_ENDPOINTS
 
-#include <exception>      // for exception_ptr
-#include <map>            // for map
-#include <memory>         // for allocator, uniq...
-#include <string>         // for string
-#include <thread>         // for thread
-#include <unordered_map>  // for unordered_map
-#include <utility>        // for move
-#include <vector>         // for vector
+#include <condition_variable>  // for condition_variable
+#include <exception>           // for exception_ptr
+#include <map>                 // for map
+#include <memory>              // for allocator, uniq...
+#include <mutex>               // for mutex
+#include <optional>            // for optional
+#include <string>              // for string
+#include <thread>              // for thread
+#include <unordered_map>       // for unordered_map
+#include <utility>             // for move
+#include <vector>              // for vector
 
 #include "amdinfer/build_options.hpp"          // for AMDINFER_ENABLE...
 #include "amdinfer/core/memory_pool/pool.hpp"  // for MemoryPool
 #include "amdinfer/core/model_metadata.hpp"    // for ModelMetadata
+#include "amdinfer/core/model_versions.hpp"    // for Aliases
 #include "amdinfer/core/parameters.hpp"        // for ParameterMap
 #include "amdinfer/observation/logging.hpp"    // for Logger, Loggers
 #include "amdinfer/util/queue.hpp"             // for BlockingQueue
 
 namespace amdinfer {
 
+class Ensemble;
+struct EnsembleConfig;
 class RequestContainer;
 class WorkerInfo;
+struct EndpointState;
+struct SignalValues;
 
 /**
  * @brief IDs used to specify commands to update the Manager
@@ -47,11 +55,15 @@ class WorkerInfo;
  */
 enum class UpdateCommandType {
   Load,
+  /// Load an ensemble, which is created by the update thread itself
+  LoadEnsemble,
+  /// Sent by a load thread once its worker is loaded or has failed to load
+  LoadDone,
   Unload,
-  Exists,
-  Ready,
-  List,
-  Metadata,
+  /// Add an instance to an autoscaled worker group
+  ScaleUp,
+  /// Retire an instance of an autoscaled worker group
+  ScaleDown,
   Shutdown,
 };
 
@@ -81,25 +93,133 @@ struct UpdateCommand {
 };
 using UpdateCommandQueue = BlockingQueue<std::shared_ptr<UpdateCommand>>;
 
+/// endpoint -> WorkerInfo
+using EndpointTable =
+  std::unordered_map<std::string, std::shared_ptr<WorkerInfo>>;
+
+/// ensemble -> Ensemble
+using EnsembleTable =
+  std::unordered_map<std::string, std::shared_ptr<const Ensemble>>;
+
+/// The state of an endpoint's load
+enum class LoadStatus {
+  Loading,
+  Failed,
+};
+
+/// The state of an endpoint's load that isn't ready yet
+struct LoadState {
+  LoadStatus status = LoadStatus::Loading;
+  /// The reason the load failed, if it did
+  std::exception_ptr eptr = nullptr;
+};
+
+/// endpoint -> state of its load that isn't ready
+using LoadStateTable = std::unordered_map<std::string, LoadState>;
+
+/// Instances asked for by a load of an endpoint that was still loading
+struct PendingInstances {
+  std::string worker;
+  ParameterMap parameters;
+  MemoryPool* pool;
+  size_t count;
+};
+
+/// An endpoint's load that's running in its own thread
+struct LoadTask {
+  std::thread thread;
+  /// The loaded worker, set by the load thread on success
+  std::shared_ptr<WorkerInfo> worker;
+  /// The error, set by the load thread on failure
+  std::exception_ptr eptr = nullptr;
+  /// Set if the endpoint is unloaded before its load finishes
+  bool unload = false;
+  /// Instances from loads with share set to false, added once it's loaded
+  std::vector<PendingInstances> pending;
+};
+
 class Endpoints {
  public:
   Endpoints();
   ~Endpoints();
 
+  /**
+   * @brief Load a worker. Loading happens in its own thread so independent
+   * endpoints load in parallel without blocking other updates. By default,
+   * this waits for the load to finish. If the "async" parameter is true, it
+   * returns the endpoint as soon as it's known and the load's progress is
+   * reported through ready() and metadata().
+   *
+   * @param worker name of the worker to load
+   * @param parameters load-time parameters
+   * @return std::string the endpoint of the worker
+   */
   std::string load(const std::string& worker, ParameterMap parameters);
+  /**
+   * @brief Load an ensemble. Loading an ensemble with the same name as one
+   * that's loaded replaces it. Its models should be loaded separately and it's
+   * only ready when all of them are.
+   *
+   * @param config the ensemble's definition
+   * @return std::string the endpoint of the ensemble
+   */
+  std::string loadEnsemble(EnsembleConfig config);
+  /**
+   * @brief Unload an endpoint. Requests that are queued for it are run before
+   * its workers stop. Unloading an alias removes it and unloads the endpoint
+   * it routes to and the other versions of it, which are named alias/version
+   *
+   * @param endpoint the endpoint or alias to unload
+   */
   void unload(const std::string& endpoint);
 
+  /**
+   * @brief Route the requests for a name to an endpoint, such as a model to
+   * the endpoint of its current version. Setting an existing alias swaps it
+   * atomically so each request goes to either the old endpoint or the new
+   * one. Aliases are resolved before endpoints of the same name.
+   *
+   * @param name the name that requests use
+   * @param endpoint the endpoint to route them to
+   */
+  void setAlias(const std::string& name, const std::string& endpoint);
+  /// Get the endpoint that a name routes to, which is itself if it's not an
+  /// alias
+  [[nodiscard]] std::string resolve(const std::string& name) const;
+
   void infer(const std::string& endpoint,
              std::unique_ptr<RequestContainer> request) const;
 
-  bool exists(const std::string& endpoint);
-  // WorkerInfo* get(const std::string& endpoint);
-  bool ready(const std::string& endpoint);
+  bool exists(const std::string& endpoint) const;
+  /**
+   * @brief Checks if an endpoint is ready. It's not ready while it's still
+   * loading and this throws if its load failed or it doesn't exist
+   *
+   * @param endpoint the endpoint to check
+   */
+  bool ready(const std::string& endpoint) const;
 
-  std::vector<std::string> list();
-  ModelMetadata metadata(const std::string& endpoint);
+  std::vector<std::string> list() const;
+  ModelMetadata metadata(const std::string& endpoint) const;
+  /// Get the state of the queues and workers of each loaded worker group
+  std::vector<EndpointState> states() const;
+  /**
+   * @brief Get how much work is queued for an endpoint or alias
+   *
+   * @param endpoint the endpoint to check
+   * @return std::optional<size_t> the queued work or nullopt if it's not
+   * loaded. Ensembles have none of their own
+   */
+  std::optional<size_t> queued(const std::string& endpoint) const;
+  /// Get the work queued for each loaded endpoint and alias
+  std::unordered_map<std::string, size_t> loads() const;
+#ifdef AMDINFER_ENABLE_METRICS
+  /// Get the smoothed signals of the load of each loaded worker group
+  std::map<std::string, SignalValues> signals() const;
+#endif
 
   const MemoryPool* getPool() const;
+  MemoryPool* getPool();
 
   void shutdown();
 
@@ -111,12 +231,41 @@ class Endpoints {
   std::unordered_map<std::string, int> worker_indices_;
   // endpoint -> parameters
   std::unordered_map<std::string, ParameterMap> worker_parameters_;
-  // endpoint -> Worker_Info*
-  std::unordered_map<std::string, std::unique_ptr<WorkerInfo>> workers_;
+  /**
+   * @brief The current endpoints. Readers take a snapshot of this table with
+   * an atomic load and never wait on the update thread, even while it's
+   * loading a model. Only the update thread changes the table and it does so
+   * by publishing a modified copy with an atomic store.
+   */
+  std::shared_ptr<const EndpointTable> workers_;
+  /// The current ensembles, which are read and published like workers_
+  std::shared_ptr<const EnsembleTable> ensembles_;
+  /// The current aliases, which are read like workers_ but may be changed
+  /// by any thread
+  Aliases aliases_;
+  /// endpoint -> load in progress. Only the update thread uses it
+  std::unordered_map<std::string, std::unique_ptr<LoadTask>> load_tasks_;
+  /**
+   * @brief endpoint -> state of loads that aren't ready. It's read like
+   * workers_ so ready() and metadata() never take a lock but it's published by
+   * threads holding load_mutex_, which load_done_ waits on
+   */
+  std::shared_ptr<const LoadStateTable> load_states_;
+  mutable std::mutex load_mutex_;
+  mutable std::condition_variable load_done_;
   /// A queue used to sequentially order changes to the Manager state
   UpdateCommandQueue update_queue_;
   std::thread update_thread_;
+#ifdef AMDINFER_ENABLE_METRICS
+  /// checks the autoscaled worker groups and asks the update thread to scale
+  std::thread autoscale_thread_;
+  std::mutex autoscale_mutex_;
+  std::condition_variable autoscale_cv_;
+  bool stop_autoscaling_ = false;
+#endif
   MemoryPool pool_;
+  /// endpoint -> its partition of pool_. Only the update thread uses it
+  std::unordered_map<std::string, std::unique_ptr<MemoryPool>> partitions_;
 #ifdef AMDINFER_ENABLE_LOGGING
   Logger logger_{Loggers::Server};
 #endif
@@ -134,16 +283,62 @@ class Endpoints {
                            const ParameterMap& parameters);
 
   std::string unsafeLoad(const std::string& worker, ParameterMap* parameters);
+  std::string unsafeLoadEnsemble(EnsembleConfig* config);
+  void unsafeFinishLoad(const std::string& endpoint);
   void unsafeUnload(const std::string& endpoint);
-
-  bool unsafeExists(const std::string& endpoint) const;
-  WorkerInfo* unsafeGet(const std::string& endpoint) const;
-  // bool unsafeReady(const std::string& endpoint) const;
-
-  void unsafeList(std::vector<std::string>* list) const;
-  ModelMetadata unsafeMetadata(const std::string& endpoint) const;
+#ifdef AMDINFER_ENABLE_METRICS
+  /// Take the step that an autoscaled worker group's policy decided on
+  void unsafeScale(const std::string& endpoint, bool up);
+  /// Check the autoscaled worker groups periodically. Runs in its own thread
+  void autoscale();
+#endif
 
   void unsafeShutdown();
+  /**
+   * @brief Get the pool that an endpoint's buffers come from. Endpoints that
+   * are loaded with a budget in memory_pool_mb get a partition of the shared
+   * pool that's created by their first load and kept, even after they're
+   * unloaded, since responses may still hold its buffers. Only the update
+   * thread may call this
+   *
+   * @param endpoint the endpoint to get the pool for
+   * @param parameters the endpoint's load-time parameters
+   * @return MemoryPool*
+   */
+  MemoryPool* unsafeGetPool(const std::string& endpoint,
+                            const ParameterMap& parameters);
+
+  /// Get the current table of endpoints
+  [[nodiscard]] std::shared_ptr<const EndpointTable> snapshot() const;
+  /// Get a worker from the current table or nullptr if it doesn't exist
+  [[nodiscard]] std::shared_ptr<WorkerInfo> get(
+    const std::string& endpoint) const;
+  /**
+   * @brief Resolve a name and get the worker it routes to or nullptr if it
+   * doesn't exist. If an alias is swapped and its old endpoint is unloaded
+   * while it's resolved, it's resolved again.
+   *
+   * @param name the endpoint or alias to resolve
+   * @param endpoint set to the endpoint that it resolves to
+   * @return std::shared_ptr<WorkerInfo>
+   */
+  [[nodiscard]] std::shared_ptr<WorkerInfo> getResolved(
+    const std::string& name, std::string* endpoint) const;
+  /// Replace the table of endpoints. Only the update thread may call this
+  void publish(EndpointTable table);
+  /// Get an ensemble from the current table or nullptr if it doesn't exist
+  [[nodiscard]] std::shared_ptr<const Ensemble> getEnsemble(
+    const std::string& endpoint) const;
+  /// Replace the table of ensembles. Only the update thread may call this
+  void publishEnsembles(EnsembleTable table);
+  /// Set or clear (with std::nullopt) the state of a load that isn't ready
+  void setLoadState(const std::string& endpoint,
+                    std::optional<LoadState> state);
+  /// Get the state of a load or std::nullopt if it's ready or unknown
+  [[nodiscard]] std::optional<LoadState> getLoadState(
+    const std::string& endpoint) const;
+  /// Wait for an endpoint's load to finish, throwing if it failed
+  void waitForLoad(const std::string& endpoint) const;
 };
 
 }  // namespace amdinfer
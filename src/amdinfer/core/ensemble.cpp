@@ -0,0 +1,361 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements ensembles, which run a graph of models inside the server
+ */
+
+#include "amdinfer/core/ensemble.hpp"
+
+#include <cstddef>        // for byte, size_t
+#include <exception>      // for exception
+#include <mutex>          // for mutex, lock_guard
+#include <optional>       // for optional
+#include <string>         // for string
+#include <unordered_map>  // for unordered_map
+#include <utility>        // for move
+
+#include "amdinfer/buffers/buffer.hpp"           // for Buffer
+#include "amdinfer/buffers/cpu.hpp"              // for CpuBuffer
+#include "amdinfer/build_options.hpp"            // for AMDINFER_ENABLE_TRACING
+#include "amdinfer/core/exceptions.hpp"          // for invalid_argument
+#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/core/memory_pool/pool.hpp"    // for MemoryPool
+#include "amdinfer/core/request_container.hpp"   // for RequestContainer
+#include "amdinfer/observation/tracing.hpp"      // for startTrace, Trace
+#include "amdinfer/util/timer.hpp"               // for TimePoint
+
+namespace amdinfer {
+
+struct Ensemble::Run {
+  std::shared_ptr<const Ensemble> ensemble;
+  InferenceRequestPtr request;
+  /// tensor -> its data once it's ready. It's never resized so references to
+  /// ready tensors stay valid while other steps finish
+  std::vector<std::optional<InferenceResponseOutput>> tensors;
+  /// step -> the number of its inputs that aren't ready
+  std::vector<size_t> missing;
+  /// the number of steps that haven't finished
+  size_t remaining = 0;
+  /// the number of steps that are enqueued
+  size_t running = 0;
+  /// the first error from a step, if any
+  std::string error;
+  std::mutex mutex;
+#ifdef AMDINFER_ENABLE_TRACING
+  TracePtr trace;
+#endif
+#ifdef AMDINFER_ENABLE_METRICS
+  util::TimePoint start_time;
+#endif
+};
+
+namespace {
+
+/// Get a pointer that returns the data, from a pool buffer, to the pool once
+/// the last tensor using it is destroyed
+std::shared_ptr<std::byte> poolData(void* data, size_t size,
+                                    const MemoryPool* pool) {
+  return {static_cast<std::byte*>(data), [pool, size](std::byte* ptr) {
+            pool->put(
+              std::make_unique<CpuBuffer>(ptr, MemoryAllocators::Cpu, size));
+          }};
+}
+
+/// Get a pointer to data that's owned by something that outlives the request
+std::shared_ptr<std::byte> viewData(const void* data) {
+  // the aliasing constructor with an empty owner makes a non-owning pointer
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+  auto* pointer = static_cast<std::byte*>(const_cast<void*>(data));
+  return {std::shared_ptr<void>{}, pointer};
+}
+
+}  // namespace
+
+Ensemble::Ensemble(EnsembleConfig config, EnsembleDispatch dispatch,
+                   const MemoryPool* pool)
+  : metadata_(std::move(config.metadata)),
+    dispatch_(std::move(dispatch)),
+    pool_(pool) {
+  const auto& name = metadata_.getName();
+  if (config.steps.empty()) {
+    throw invalid_argument("Ensemble " + name + " has no steps");
+  }
+
+  std::unordered_map<std::string, size_t> indices;
+  const auto produce = [&](const std::string& tensor) {
+    if (!indices.try_emplace(tensor, tensors_.size()).second) {
+      throw invalid_argument("Tensor " + tensor + " in ensemble " + name +
+                             " is produced more than once");
+    }
+    tensors_.push_back(tensor);
+    return tensors_.size() - 1;
+  };
+  const auto find = [&](const std::string& tensor) {
+    auto iterator = indices.find(tensor);
+    if (iterator == indices.end()) {
+      throw invalid_argument("Tensor " + tensor + " in ensemble " + name +
+                             " is never produced");
+    }
+    return iterator->second;
+  };
+
+  for (const auto& input : metadata_.getInputs()) {
+    inputs_.push_back(produce(input.getName()));
+  }
+  steps_.reserve(config.steps.size());
+  for (auto& step : config.steps) {
+    if (step.inputs.empty()) {
+      throw invalid_argument("Model " + step.model + " in ensemble " + name +
+                             " has no inputs");
+    }
+    Step& added = steps_.emplace_back();
+    added.model = std::move(step.model);
+    for (const auto& output : step.outputs) {
+      added.outputs.push_back(produce(output));
+    }
+  }
+  consumers_.resize(tensors_.size());
+  for (auto i = 0U; i < steps_.size(); ++i) {
+    for (const auto& input : config.steps[i].inputs) {
+      const auto index = find(input);
+      steps_[i].inputs.push_back(index);
+      consumers_[index].push_back(i);
+    }
+  }
+  for (const auto& output : metadata_.getOutputs()) {
+    outputs_.push_back(find(output.getName()));
+  }
+
+  // run the graph without any data to make sure every step can start
+  std::vector<size_t> missing;
+  missing.reserve(steps_.size());
+  for (const auto& step : steps_) {
+    missing.push_back(step.inputs.size());
+  }
+  std::vector<size_t> ready = inputs_;
+  size_t started = 0;
+  while (!ready.empty()) {
+    const auto tensor = ready.back();
+    ready.pop_back();
+    for (const auto step : consumers_[tensor]) {
+      if (--missing[step] == 0) {
+        started++;
+        ready.insert(ready.end(), steps_[step].outputs.begin(),
+                     steps_[step].outputs.end());
+      }
+    }
+  }
+  if (started != steps_.size()) {
+    throw invalid_argument("The models in ensemble " + name + " form a cycle");
+  }
+}
+
+void Ensemble::infer(std::unique_ptr<RequestContainer> request) const {
+  auto run = std::make_shared<Run>();
+  run->ensemble = shared_from_this();
+  run->request = std::move(request->request);
+#ifdef AMDINFER_ENABLE_TRACING
+  run->trace = std::move(request->trace);
+  run->trace->startSpan("ensemble");
+#endif
+#ifdef AMDINFER_ENABLE_METRICS
+  run->start_time = request->start_time;
+#endif
+  run->tensors.resize(tensors_.size());
+
+  // the ensemble owns the inputs from here on so they're read in place by the
+  // first steps and returned to the pool once the last step using them is done
+  const auto& inputs = run->request->getInputs();
+  for (auto i = 0U; i < inputs.size() && i < inputs_.size(); ++i) {
+    const auto& input = inputs[i];
+    const auto size = input.getSize() * input.getDatatype().size();
+    auto& tensor = run->tensors[inputs_[i]].emplace();
+    tensor.setName(tensors_[inputs_[i]]);
+    tensor.setShape(input.getShape());
+    tensor.setDatatype(input.getDatatype());
+    // the steps read the ensemble's tensors on the host
+    if (!request->input_views.empty() && !request->device_views) {
+      tensor.setData(viewData(request->input_views[i]), size);
+    } else if (!request->input_writers.empty()) {
+      auto buffer = pool_->get({MemoryAllocators::Cpu}, input, 1);
+      auto data = poolData(buffer->data(0), size, pool_);
+      request->input_writers[i](buffer.get(), 0);
+      tensor.setData(std::move(data), size);
+    } else {
+      tensor.setData(poolData(input.getData(), size, pool_), size);
+    }
+  }
+  if (request->input_views.empty() && request->input_writers.empty()) {
+    // return any extra inputs that weren't adopted above
+    for (auto i = inputs_.size(); i < inputs.size(); ++i) {
+      const auto& input = inputs[i];
+      pool_->put(std::make_unique<CpuBuffer>(
+        input.getData(), MemoryAllocators::Cpu,
+        input.getSize() * input.getDatatype().size()));
+    }
+  }
+  if (inputs.size() != inputs_.size()) {
+    run->request->runCallbackError(
+      "Ensemble " + metadata_.getName() + " expects " +
+      std::to_string(inputs_.size()) + " inputs but got " +
+      std::to_string(inputs.size()));
+    return;
+  }
+
+  std::vector<size_t> ready;
+  run->missing.reserve(steps_.size());
+  for (auto i = 0U; i < steps_.size(); ++i) {
+    run->missing.push_back(steps_[i].inputs.size());
+  }
+  for (const auto tensor : inputs_) {
+    for (const auto step : consumers_[tensor]) {
+      if (--run->missing[step] == 0) {
+        ready.push_back(step);
+      }
+    }
+  }
+  run->remaining = steps_.size();
+  run->running = ready.size();
+  this->launch(run, ready);
+}
+
+const ModelMetadata& Ensemble::getMetadata() const { return metadata_; }
+
+std::vector<std::string> Ensemble::getModels() const {
+  std::vector<std::string> models;
+  models.reserve(steps_.size());
+  for (const auto& step : steps_) {
+    models.push_back(step.model);
+  }
+  return models;
+}
+
+void Ensemble::launch(const std::shared_ptr<Run>& run,
+                      const std::vector<size_t>& steps) const {
+  for (const auto index : steps) {
+    const auto& step = steps_[index];
+    auto request = std::make_shared<InferenceRequest>();
+    request->setID(run->request->getID());
+    request->setParameters(run->request->getParameters());
+    auto container = std::make_unique<RequestContainer>();
+
+    // ready tensors don't change so the step reads them in place if it can
+    // and otherwise its batcher copies them once into the batch
+    for (const auto tensor_index : step.inputs) {
+      const auto& tensor = *run->tensors[tensor_index];
+      request->addInputTensor(nullptr, tensor.getShape(), tensor.getDatatype(),
+                              tensor.getName());
+      const auto size = tensor.getSize() * tensor.getDatatype().size();
+      // outputs left on a GPU are handed over there to steps that can read
+      // them and only copied to the host for the others
+      auto* source = tensor.getBuffer();
+      if (source != nullptr &&
+          source->getAllocator() == MemoryAllocators::HipDevice) {
+        container->input_views.push_back(source->data(0));
+        container->input_writers.emplace_back(
+          [source, size](Buffer* buffer, size_t offset) {
+            source->read(buffer->data(offset), 0, size);
+          });
+        container->device_views = true;
+        continue;
+      }
+      const auto* data = tensor.getData();
+      container->input_views.push_back(data);
+      container->input_writers.emplace_back(
+        [data, size](Buffer* buffer, size_t offset) {
+          buffer->write(data, offset, size);
+        });
+    }
+    request->setCallback([run, index](const InferenceResponse& response) {
+      run->ensemble->finishStep(run, index, response);
+    });
+    container->request = std::move(request);
+#ifdef AMDINFER_ENABLE_TRACING
+    container->trace = startTrace(step.model.c_str());
+#endif
+#ifdef AMDINFER_ENABLE_METRICS
+    container->start_time = run->start_time;
+#endif
+
+    try {
+      dispatch_(step.model, std::move(container));
+    } catch (const std::exception& e) {
+      this->finishStep(run, index, InferenceResponse{e.what()});
+    }
+  }
+}
+
+void Ensemble::finishStep(const std::shared_ptr<Run>& run, size_t step,
+                          const InferenceResponse& response) const {
+  const auto& outputs = steps_[step].outputs;
+  std::vector<size_t> ready;
+  bool done = false;
+  {
+    std::lock_guard lock{run->mutex};
+    run->running--;
+    run->remaining--;
+    if (run->error.empty()) {
+      const auto& model = steps_[step].model;
+      if (response.isError()) {
+        run->error = "Model " + model + " failed: " + response.getError();
+      } else if (response.getOutputs().size() < outputs.size()) {
+        run->error = "Model " + model + " returned fewer outputs than expected";
+      }
+    }
+    if (run->error.empty()) {
+      const auto& results = response.getOutputs();
+      for (auto i = 0U; i < outputs.size(); ++i) {
+        auto& tensor = run->tensors[outputs[i]].emplace(results[i]);
+        tensor.setName(tensors_[outputs[i]]);
+        for (const auto consumer : consumers_[outputs[i]]) {
+          if (--run->missing[consumer] == 0) {
+            ready.push_back(consumer);
+          }
+        }
+      }
+      run->running += ready.size();
+    }
+    // after an error, the running steps may still be reading the request's
+    // inputs so the request is only released once they're done
+    done = run->running == 0 && (!run->error.empty() || run->remaining == 0);
+  }
+
+  this->launch(run, ready);
+  if (done) {
+    this->finish(run.get());
+  }
+}
+
+void Ensemble::finish(Run* run) const {
+#ifdef AMDINFER_ENABLE_TRACING
+  run->trace->endSpan();
+#endif
+  if (!run->error.empty()) {
+    run->request->runCallbackError(run->error);
+    return;
+  }
+
+  InferenceResponse response;
+  response.setModel(metadata_.getName());
+  response.setID(run->request->getID());
+  for (const auto tensor : outputs_) {
+    response.addOutput(*run->tensors[tensor]);
+  }
+  run->request->runCallbackOnce(response);
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,130 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines ensembles, which run a graph of models inside the server
+ */
+
+#ifndef GUARD_AMDINFER_CORE_ENSEMBLE
+#define GUARD_AMDINFER_CORE_ENSEMBLE
+
+#include <cstddef>     // for size_t
+#include <functional>  // for function
+#include <memory>      // for shared_ptr, unique_ptr, enable_shared_from_this
+#include <string>      // for string
+#include <vector>      // for vector
+
+#include "amdinfer/core/model_metadata.hpp"  // for ModelMetadata
+
+namespace amdinfer {
+
+class InferenceResponse;
+class MemoryPool;
+struct RequestContainer;
+
+/// A model run by an ensemble
+struct EnsembleStep {
+  /// The endpoint of the model
+  std::string model;
+  /// The ensemble tensors passed to the model as its inputs, in order
+  std::vector<std::string> inputs;
+  /// The names given to the model's outputs in the ensemble, in order
+  std::vector<std::string> outputs;
+};
+
+/// The definition of an ensemble from its config file
+struct EnsembleConfig {
+  /// The name, inputs and outputs of the ensemble
+  ModelMetadata metadata;
+  std::vector<EnsembleStep> steps;
+};
+
+/// Sends the request for one of an ensemble's models to the model's endpoint
+using EnsembleDispatch =
+  std::function<void(const std::string&, std::unique_ptr<RequestContainer>)>;
+
+/**
+ * @brief An ensemble runs a graph of models for each request. Its inputs are
+ * passed to the models that use them and the outputs of each model are passed
+ * to the models that use them in turn, so the tensors between models stay in
+ * the server. Each model starts as soon as all of its inputs are ready so
+ * independent branches of the graph run in parallel.
+ */
+class Ensemble : public std::enable_shared_from_this<Ensemble> {
+ public:
+  /**
+   * @brief Construct a new Ensemble object. This throws if a tensor is used
+   * before it's produced, it's produced more than once or the models form a
+   * cycle.
+   *
+   * @param config the ensemble's definition
+   * @param dispatch sends the requests for the models to their endpoints. It
+   * may throw if a request can't be enqueued
+   * @param pool memory pool to stage the ensemble's inputs in
+   */
+  Ensemble(EnsembleConfig config, EnsembleDispatch dispatch,
+           const MemoryPool* pool);
+
+  /**
+   * @brief Run the ensemble for a request. This returns once the first models
+   * are enqueued and the request's callback is run once the last model is
+   * done or any of them fails.
+   *
+   * @param request the request to run
+   */
+  void infer(std::unique_ptr<RequestContainer> request) const;
+
+  /// Get the ensemble's metadata. It's ready only if all its models are
+  [[nodiscard]] const ModelMetadata& getMetadata() const;
+  /// Get the endpoints of the models that the ensemble runs
+  [[nodiscard]] std::vector<std::string> getModels() const;
+
+ private:
+  /// The state of the ensemble for one request
+  struct Run;
+
+  /// A step with its tensors as indices into tensors_
+  struct Step {
+    std::string model;
+    std::vector<size_t> inputs;
+    std::vector<size_t> outputs;
+  };
+
+  /// Enqueue the given steps. Their inputs must be ready
+  void launch(const std::shared_ptr<Run>& run,
+              const std::vector<size_t>& steps) const;
+  /// Save the outputs of a finished step and launch the steps it unblocks
+  void finishStep(const std::shared_ptr<Run>& run, size_t step,
+                  const InferenceResponse& response) const;
+  /// Respond to the request once no steps are running
+  void finish(Run* run) const;
+
+  ModelMetadata metadata_;
+  std::vector<Step> steps_;
+  /// The names of the ensemble's tensors
+  std::vector<std::string> tensors_;
+  /// The tensors that are the ensemble's inputs, in order
+  std::vector<size_t> inputs_;
+  /// The tensors that are the ensemble's outputs, in order
+  std::vector<size_t> outputs_;
+  /// tensor -> steps that use it, once per use
+  std::vector<std::vector<size_t>> consumers_;
+  EnsembleDispatch dispatch_;
+  const MemoryPool* pool_;
+};
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_CORE_ENSEMBLE
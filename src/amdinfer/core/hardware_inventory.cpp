@@ -0,0 +1,217 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the inventory of the hardware the server may use
+ */
+
+#include "amdinfer/core/hardware_inventory.hpp"
+
+#include <cctype>        // for isdigit
+#include <cstdint>       // for uint64_t
+#include <exception>     // for exception
+#include <filesystem>    // for directory_iterator, path
+#include <fstream>       // for ifstream
+#include <string>        // for string, operator+, to_string
+#include <system_error>  // for error_code
+#include <utility>       // for move
+
+#include "amdinfer/build_options.hpp"        // for AMDINFER_ENABLE_VITIS
+#include "amdinfer/observation/logging.hpp"  // for Logger, AMDINFER_LOG_WARN
+#include "amdinfer/util/thread.hpp"          // for getAvailableCpus
+
+#ifdef AMDINFER_ENABLE_VITIS
+#include <jsoncpp/json/reader.h>   // for CharReaderBuilder, CharReader
+#include <jsoncpp/json/value.h>    // for Value
+#include <sockpp/socket.h>         // for socket_initializer
+#include <sockpp/tcp_connector.h>  // for tcp_connector
+
+#include "amdinfer/core/exceptions.hpp"  // for external_error
+#endif
+
+namespace fs = std::filesystem;
+
+namespace amdinfer {
+
+namespace {
+
+#ifdef AMDINFER_ENABLE_VITIS
+/**
+ * @brief Ask XRM for the CUs on the FPGAs. If it isn't running, there are none
+ * to use. It throws if XRM's response can't be read
+ *
+ * @return Kernels
+ */
+Kernels getXrmKernels() {
+  Kernels kernels;
+
+  sockpp::socket_initializer sock_init;
+  const auto default_xrm_port = 9763;
+  sockpp::tcp_connector conn({"localhost", default_xrm_port});
+  if (!conn) {
+    return kernels;
+  }
+
+  const std::string request(R"({"request":{"name":"list","requestId":"1"}})");
+  if (conn.write(request) == -1) {
+    throw external_error("Failed to send the request to XRM");
+  }
+
+  int total_len = 0;
+  if (conn.read_n(&total_len, 4) == -1) {
+    throw external_error("Failed to read the size of XRM's response");
+  }
+  std::string response_str;
+  response_str.resize(total_len);
+  if (conn.read_n(response_str.data(), total_len) == -1) {
+    throw external_error("Failed to read XRM's response");
+  }
+
+  std::string errors;
+  Json::CharReaderBuilder builder;
+  const std::unique_ptr<Json::CharReader> reader{builder.newCharReader()};
+  Json::Value response;
+  if (!reader->parse(response_str.c_str(),
+                     response_str.data() + response_str.length(), &response,
+                     &errors)) {
+    throw external_error("Failed to parse XRM's response: " + errors);
+  }
+
+  try {
+    auto data = response["response"]["data"];
+    auto num_fpgas = std::stoi(data["deviceNumber"].asString());
+    for (auto i = 0; i < num_fpgas; ++i) {
+      auto device = data["device_" + std::to_string(i)];
+      if (!device.isMember("cuNumber   ")) {
+        continue;
+      }
+      auto cu_num = std::stoi(device["cuNumber   "].asString());
+      for (auto j = 0; j < cu_num; ++j) {
+        auto kernel =
+          device["cu_" + std::to_string(j)]["kernelName   "].asString();
+        kernels[kernel]++;
+      }
+    }
+  } catch (const std::exception& e) {
+    throw external_error(std::string{"Unexpected response from XRM: "} +
+                         e.what());
+  }
+
+  return kernels;
+}
+#endif
+
+/// Count the KFD topology nodes with SIMDs, which are the GPUs
+int countGpus() {
+  const fs::path nodes{"/sys/class/kfd/kfd/topology/nodes"};
+  std::error_code error;
+  int gpus = 0;
+  for (const auto& node : fs::directory_iterator(nodes, error)) {
+    std::ifstream properties{node.path() / "properties"};
+    std::string key;
+    uint64_t value = 0;
+    while (properties >> key >> value) {
+      if (key == "simd_count") {
+        gpus += value > 0 ? 1 : 0;
+        break;
+      }
+    }
+  }
+  return gpus;
+}
+
+/// Count the NUMA nodes that sysfs reports, which is at least one
+int countNumaNodes() {
+  const fs::path nodes{"/sys/devices/system/node"};
+  std::error_code error;
+  int count = 0;
+  for (const auto& node : fs::directory_iterator(nodes, error)) {
+    const auto name = node.path().filename().string();
+    if (name.rfind("node", 0) == 0 && name.size() > 4 &&
+        std::isdigit(static_cast<unsigned char>(name[4])) != 0) {
+      count++;
+    }
+  }
+  return count > 0 ? count : 1;
+}
+
+}  // namespace
+
+Hardware probeHardware() {
+  Hardware hardware;
+#ifdef AMDINFER_ENABLE_VITIS
+  hardware.kernels = getXrmKernels();
+#endif
+  hardware.gpus = countGpus();
+  hardware.cpus = util::getAvailableCpus();
+  hardware.numa_nodes = countNumaNodes();
+  return hardware;
+}
+
+HardwareInventory& HardwareInventory::get() {
+  const std::chrono::seconds refresh_interval{5};
+  static HardwareInventory inventory{probeHardware, refresh_interval};
+  return inventory;
+}
+
+HardwareInventory::HardwareInventory(Probe probe,
+                                     std::chrono::milliseconds interval)
+  : probe_(std::move(probe)), interval_(interval) {}
+
+HardwareInventory::~HardwareInventory() {
+  {
+    const std::lock_guard lock{mutex_};
+    stop_ = true;
+  }
+  stopped_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+std::shared_ptr<const Hardware> HardwareInventory::read() {
+  // if the first lookup throws, the next read tries again
+  std::call_once(started_, [this]() {
+    auto hardware = std::make_shared<const Hardware>(probe_());
+    const std::lock_guard lock{mutex_};
+    hardware_ = std::move(hardware);
+    thread_ = std::thread{&HardwareInventory::run, this};
+  });
+  const std::lock_guard lock{mutex_};
+  return hardware_;
+}
+
+void HardwareInventory::refresh() {
+  try {
+    auto hardware = std::make_shared<const Hardware>(probe_());
+    const std::lock_guard lock{mutex_};
+    hardware_ = std::move(hardware);
+  } catch (const std::exception& e) {
+    AMDINFER_IF_LOGGING(Logger logger{Loggers::Server};)
+    AMDINFER_LOG_WARN(logger, std::string{"Failed to look up the hardware: "} +
+                                e.what());
+  }
+}
+
+void HardwareInventory::run() {
+  std::unique_lock lock{mutex_};
+  while (!stopped_.wait_for(lock, interval_, [this]() { return stop_; })) {
+    lock.unlock();
+    refresh();
+    lock.lock();
+  }
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,115 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the inventory of the hardware the server may use, which is
+ * refreshed in the background
+ */
+
+#ifndef GUARD_AMDINFER_CORE_HARDWARE_INVENTORY
+#define GUARD_AMDINFER_CORE_HARDWARE_INVENTORY
+
+#include <chrono>              // for milliseconds
+#include <condition_variable>  // for condition_variable
+#include <functional>          // for function
+#include <memory>              // for shared_ptr
+#include <mutex>               // for mutex, once_flag
+#include <thread>              // for thread
+
+#include "amdinfer/declarations.hpp"  // for Kernels
+
+namespace amdinfer {
+
+/// The hardware the server found the last time it looked
+struct Hardware {
+  /// the FPGA kernels that XRM reports and the number of CUs of each
+  Kernels kernels;
+  /// the number of AMD GPUs that the kernel driver reports
+  int gpus = 0;
+  /// the number of CPUs the server may run on
+  int cpus = 0;
+  /// the number of NUMA nodes
+  int numa_nodes = 0;
+};
+
+/**
+ * @brief Look up the hardware from XRM, sysfs and the process's CPU affinity.
+ * Hardware that can't be looked up, such as FPGAs when XRM isn't running, is
+ * reported as absent
+ *
+ * @return Hardware
+ */
+Hardware probeHardware();
+
+/**
+ * @brief Caches what hardware the server has so checking it doesn't query
+ * XRM and sysfs each time. The first read looks up the hardware and starts a
+ * thread that looks it up again at an interval, so hardware that's added or
+ * claimed by other processes is seen within the interval. If a lookup fails,
+ * the last one that succeeded is kept.
+ *
+ * There's one inventory for the process, which is safe to use from multiple
+ * threads.
+ */
+class HardwareInventory {
+ public:
+  /// Looks up the hardware
+  using Probe = std::function<Hardware()>;
+
+  /// Get the process's inventory, which looks up the hardware every 5 seconds
+  static HardwareInventory& get();
+
+  /**
+   * @brief Construct a new HardwareInventory object. Use get() to share the
+   * process's inventory instead
+   *
+   * @param probe looks up the hardware
+   * @param interval how often to look it up again once it's first read
+   */
+  HardwareInventory(Probe probe, std::chrono::milliseconds interval);
+  HardwareInventory(const HardwareInventory&) = delete;
+  HardwareInventory& operator=(const HardwareInventory&) = delete;
+  HardwareInventory(HardwareInventory&&) = delete;
+  HardwareInventory& operator=(HardwareInventory&&) = delete;
+  /// Destructor. Stops the refreshing thread
+  ~HardwareInventory();
+
+  /**
+   * @brief Get the hardware as of the last lookup. The first call looks it up
+   * and throws if that fails
+   *
+   * @return std::shared_ptr<const Hardware>
+   */
+  [[nodiscard]] std::shared_ptr<const Hardware> read();
+
+  /// Look up the hardware now, keeping the last lookup if it fails
+  void refresh();
+
+ private:
+  void run();
+
+  Probe probe_;
+  std::chrono::milliseconds interval_;
+  std::shared_ptr<const Hardware> hardware_;
+  std::once_flag started_;
+  bool stop_ = false;
+  std::thread thread_;
+  std::condition_variable stopped_;
+  mutable std::mutex mutex_;
+};
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_CORE_HARDWARE_INVENTORY
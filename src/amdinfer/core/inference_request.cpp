@@ -25,11 +25,30 @@
 
 namespace amdinfer {
 
-void InferenceRequest::setCallback(Callback &&callback) {
+InferenceRequest::InferenceRequest(const InferenceRequest &other)
+  : id_(other.id_),
+    parameters_(other.parameters_),
+    inputs_(other.inputs_),
+    outputs_(other.outputs_) {}
+
+InferenceRequest &InferenceRequest::operator=(const InferenceRequest &other) {
+  if (this != &other) {
+    id_ = other.id_;
+    parameters_ = other.parameters_;
+    inputs_ = other.inputs_;
+    outputs_ = other.outputs_;
+    callback_ = nullptr;
+  }
+  return *this;
+}
+
+void InferenceRequest::setCallback(ResponseCallback &&callback) {
   callback_ = std::move(callback);
 }
 
-Callback InferenceRequest::getCallback() { return std::move(callback_); }
+ResponseCallback InferenceRequest::getCallback() {
+  return std::move(callback_);
+}
 
 void InferenceRequest::runCallbackOnce(const InferenceResponse &response) {
   if (this->callback_ != nullptr) {
@@ -46,8 +65,7 @@ void InferenceRequest::runCallbackError(std::string_view error_msg) {
   this->runCallback(InferenceResponse(std::string{error_msg}));
 }
 
-void InferenceRequest::addInputTensor(void *data,
-                                      const std::vector<uint64_t> &shape,
+void InferenceRequest::addInputTensor(void *data, const Shape &shape,
                                       DataType data_type,
                                       const std::string &name) {
   this->inputs_.emplace_back(data, shape, data_type, name);
@@ -57,6 +75,13 @@ void InferenceRequest::addInputTensor(InferenceRequestInput input) {
   this->inputs_.push_back(std::move(input));
 }
 
+void InferenceRequest::setInputTensor(size_t index,
+                                      InferenceRequestInput input) {
+  if (index < inputs_.size()) {
+    inputs_.at(index) = std::move(input);
+  }
+}
+
 void InferenceRequest::setInputTensorData(size_t index, void *data) {
   if (index < inputs_.size()) {
     auto &input = inputs_.at(index);
@@ -79,8 +104,7 @@ void InferenceRequest::addOutputTensor(const InferenceRequestOutput &output) {
   this->outputs_.push_back(output);
 }
 
-InferenceRequestInput::InferenceRequestInput(void *data,
-                                             std::vector<uint64_t> shape,
+InferenceRequestInput::InferenceRequestInput(void *data, Shape shape,
                                              DataType data_type,
                                              std::string name)
   : InferenceTensor(std::move(name), std::move(shape), data_type),
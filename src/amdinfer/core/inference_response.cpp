@@ -19,6 +19,11 @@
 
 #include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
 
+#include <memory>   // for make_shared
+#include <mutex>    // for call_once, once_flag
+#include <utility>  // for move
+
+#include "amdinfer/buffers/buffer.hpp"          // for Buffer
 #include "amdinfer/core/inference_request.hpp"  // for InferenceRequest
 #include "amdinfer/util/memory.hpp"
 
@@ -37,7 +42,11 @@ void InferenceResponse::setModel(const std::string &model) {
   this->model_ = model;
 }
 
-std::string InferenceResponse::getModel() { return this->model_; }
+std::string InferenceResponse::getModel() const { return this->model_; }
+
+void InferenceResponse::setParameters(ParameterMap parameters) {
+  this->parameters_ = std::make_shared<ParameterMap>(std::move(parameters));
+}
 
 bool InferenceResponse::isError() const { return !this->error_msg_.empty(); }
 
@@ -47,10 +56,19 @@ void InferenceResponse::addOutput(const InferenceResponseOutput &output) {
   this->outputs_.push_back(output);
 }
 
-std::vector<InferenceResponseOutput> InferenceResponse::getOutputs() const {
+void InferenceResponse::addOutput(InferenceResponseOutput &&output) {
+  this->outputs_.push_back(std::move(output));
+}
+
+const std::vector<InferenceResponseOutput> &InferenceResponse::getOutputs()
+  const & {
   return this->outputs_;
 }
 
+std::vector<InferenceResponseOutput> InferenceResponse::getOutputs() && {
+  return std::move(this->outputs_);
+}
+
 #ifdef AMDINFER_ENABLE_TRACING
 void InferenceResponse::setContext(StringMap &&context) {
   this->context_ = std::move(context);
@@ -78,12 +96,68 @@ std::ostream &operator<<(std::ostream &os, InferenceResponse const &self) {
 InferenceResponseOutput::InferenceResponseOutput()
   : InferenceTensor("", {}, DataType::Unknown) {}
 
+/// A buffer that an output's data is in and its copy on the host, if made
+struct InferenceResponseOutput::BufferData {
+  std::shared_ptr<Buffer> buffer;
+  size_t size;
+  std::once_flag copied;
+  std::vector<std::byte> host;
+};
+
 void InferenceResponseOutput::setData(std::vector<std::byte> &&buffer) {
-  data_ = std::move(buffer);
+  data_ = std::make_shared<std::vector<std::byte>>(std::move(buffer));
+  borrowed_data_.reset();
+  borrowed_size_ = 0;
+  buffer_data_.reset();
+}
+
+void InferenceResponseOutput::setData(std::shared_ptr<std::byte> data,
+                                      size_t size) {
+  data_.reset();
+  borrowed_data_ = std::move(data);
+  borrowed_size_ = size;
+  buffer_data_.reset();
+}
+
+void InferenceResponseOutput::setData(std::shared_ptr<Buffer> buffer,
+                                      size_t size) {
+  data_.reset();
+  borrowed_data_.reset();
+  borrowed_size_ = 0;
+  buffer_data_ = std::make_shared<BufferData>();
+  buffer_data_->buffer = std::move(buffer);
+  buffer_data_->size = size;
 }
 
 void *InferenceResponseOutput::getData() const {
-  return (void *)data_.data();  // NOLINT(google-readability-casting)
+  if (buffer_data_ != nullptr) {
+    auto &data = *buffer_data_;
+    // the copy is made once for all the copies of this output, even if they're
+    // read by different threads
+    std::call_once(data.copied, [&data]() {
+      data.host.resize(data.size);
+      data.buffer->read(data.host.data(), 0, data.size);
+    });
+    return data.host.data();
+  }
+  if (borrowed_data_ != nullptr) {
+    return borrowed_data_.get();
+  }
+  return data_ != nullptr ? data_->data() : nullptr;
+}
+
+Buffer *InferenceResponseOutput::getBuffer() const {
+  return buffer_data_ != nullptr ? buffer_data_->buffer.get() : nullptr;
+}
+
+size_t InferenceResponseOutput::getDataSize() const {
+  if (buffer_data_ != nullptr) {
+    return buffer_data_->size;
+  }
+  if (borrowed_data_ != nullptr) {
+    return borrowed_size_;
+  }
+  return data_ != nullptr ? data_->size() : 0;
 }
 
 struct InferenceResponseOutputSizes {
@@ -93,7 +167,7 @@ struct InferenceResponseOutputSizes {
 size_t InferenceResponseOutput::serializeSize() const {
   auto size = InferenceTensor::serializeSize();
   size += sizeof(InferenceResponseOutputSizes);
-  size += data_.size();
+  size += getDataSize();
   return size;
 }
 
@@ -101,9 +175,10 @@ std::byte *InferenceResponseOutput::serialize(std::byte *data_out) const {
   auto *data = data_out;
   data = InferenceTensor::serialize(data);
 
-  InferenceResponseOutputSizes metadata{data_.size()};
+  InferenceResponseOutputSizes metadata{getDataSize()};
   data = util::copy(metadata, data, sizeof(InferenceResponseOutputSizes));
-  data = util::copy(data_.data(), data, metadata.data);
+  data = util::copy(static_cast<const std::byte *>(getData()), data,
+                    metadata.data);
   assert(data_out + this->serializeSize() == data);
   return data;
 }
@@ -116,8 +191,11 @@ const std::byte *InferenceResponseOutput::deserialize(
     *reinterpret_cast<const InferenceResponseOutputSizes *>(data_in);
   data_in += sizeof(InferenceResponseOutputSizes);
 
-  data_.resize(metadata.data);
-  return util::copy(data_in, data_.data(), metadata.data);
+  borrowed_data_.reset();
+  borrowed_size_ = 0;
+  buffer_data_.reset();
+  data_ = std::make_shared<std::vector<std::byte>>(metadata.data);
+  return util::copy(data_in, data_->data(), metadata.data);
 }
 
 std::ostream &operator<<(std::ostream &os,
@@ -0,0 +1,203 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the loader that loads models from the repository on demand
+ */
+
+#include "amdinfer/core/lazy_loader.hpp"
+
+#include <exception>      // for exception
+#include <system_error>   // for error_code
+#include <thread>         // for thread
+#include <unordered_map>  // for unordered_map
+#include <utility>        // for move
+#include <vector>         // for vector
+
+#include "amdinfer/build_options.hpp"            // for AMDINFER_ENABLE_M...
+#include "amdinfer/core/endpoints.hpp"           // for Endpoints
+#include "amdinfer/core/exceptions.hpp"          // for invalid_argument
+#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/core/model_budget.hpp"        // for ModelBudget
+#include "amdinfer/core/model_repository.hpp"    // for loadModel, getMod...
+#include "amdinfer/core/parameters.hpp"          // for ParameterMap
+#include "amdinfer/core/request_container.hpp"   // for RequestContainer
+#include "amdinfer/declarations.hpp"             // for RequestContainerPtr
+#include "amdinfer/observation/logging.hpp"      // for AMDINFER_LOG_INFO
+#include "amdinfer/observation/metrics.hpp"      // for Metrics
+
+namespace fs = std::filesystem;
+
+namespace amdinfer {
+
+struct LazyLoader::State {
+  explicit State(std::map<std::string, size_t> budgets)
+    : budget(std::move(budgets)) {}
+
+  std::mutex mutex;
+  ModelBudget budget;
+  /// model -> requests waiting for it while it loads
+  std::unordered_map<std::string, std::vector<RequestContainerPtr>> pending;
+};
+
+LazyLoader::LazyLoader(fs::path repository, Endpoints* endpoints,
+                       std::map<std::string, size_t> budgets)
+  : repository_(std::move(repository)),
+    endpoints_(endpoints),
+    state_(std::make_shared<State>(std::move(budgets))) {}
+
+LazyLoader::~LazyLoader() {
+  std::unique_lock lock{loads_mutex_};
+  loads_done_.wait(lock, [this]() { return loads_ == 0; });
+}
+
+bool LazyLoader::inRepository(const std::string& model) const {
+  // the name comes from the request so it mustn't leave the repository
+  if (model.empty() || model == "." || model == ".." ||
+      model.find('/') != std::string::npos) {
+    return false;
+  }
+  std::error_code error;
+  return fs::is_directory(repository_ / model, error);
+}
+
+void LazyLoader::infer(const std::string& model,
+                       std::unique_ptr<RequestContainer> request) {
+  bool in_budget = false;
+  {
+    std::lock_guard lock{state_->mutex};
+    if (auto pending = state_->pending.find(model);
+        pending != state_->pending.end()) {
+      pending->second.push_back(std::move(request));
+      return;
+    }
+    in_budget = state_->budget.contains(model);
+    if (in_budget) {
+      state_->budget.acquire(model);
+    } else if (!endpoints_->exists(model) && inRepository(model)) {
+      state_->pending[model].push_back(std::move(request));
+#ifdef AMDINFER_ENABLE_METRICS
+      Metrics::getInstance().incrementCounter(
+        MetricCounterIDs::ModelColdStarts);
+#endif
+      {
+        std::lock_guard loads_lock{loads_mutex_};
+        loads_++;
+      }
+      std::thread{&LazyLoader::load, this, model}.detach();
+      return;
+    }
+  }
+
+  if (in_budget) {
+    submit(model, std::move(request));
+  } else {
+    // loaded in another way or not a model that can be loaded
+    endpoints_->infer(model, std::move(request));
+  }
+}
+
+void LazyLoader::submit(const std::string& model,
+                        std::unique_ptr<RequestContainer> request) {
+  auto& inference_request = request->request;
+  inference_request->setCallback(
+    [state = state_, model, callback = inference_request->getCallback()](
+      const InferenceResponse& response) {
+      {
+        std::lock_guard lock{state->mutex};
+        state->budget.release(model);
+      }
+      callback(response);
+    });
+
+  try {
+    endpoints_->infer(model, std::move(request));
+  } catch (const invalid_argument&) {
+    // the model was unloaded in another way so it's loaded again next time
+    std::lock_guard lock{state_->mutex};
+    state_->budget.remove(model);
+    throw;
+  } catch (...) {
+    // the request was refused so its callback won't release it
+    std::lock_guard lock{state_->mutex};
+    state_->budget.release(model);
+    throw;
+  }
+}
+
+void LazyLoader::load(const std::string& model) {
+  AMDINFER_IF_LOGGING(Logger logger{Loggers::Server};)
+  const auto device = getModelDevice(repository_, model);
+  const auto bytes = getModelSize(repository_, model);
+
+  std::vector<std::string> evicted;
+  {
+    std::lock_guard lock{state_->mutex};
+    evicted = state_->budget.add(model, device, bytes);
+  }
+  for (const auto& idle : evicted) {
+    AMDINFER_LOG_INFO(logger, "Unloading " + idle + " to make room for " +
+                                model + " on " + device);
+    endpoints_->unload(idle);
+#ifdef AMDINFER_ENABLE_METRICS
+    Metrics::getInstance().incrementCounter(MetricCounterIDs::ModelEvictions);
+#endif
+  }
+
+  std::string error;
+  try {
+    loadModel(repository_, model, ParameterMap{}, endpoints_);
+  } catch (const std::exception& e) {
+    error = "Model " + model + " failed to load: " + e.what();
+    AMDINFER_LOG_WARN(logger, error);
+  }
+
+  std::vector<RequestContainerPtr> requests;
+  {
+    std::lock_guard lock{state_->mutex};
+    requests = std::move(state_->pending.at(model));
+    state_->pending.erase(model);
+    if (error.empty()) {
+      for (size_t i = 0; i < requests.size(); ++i) {
+        state_->budget.acquire(model);
+      }
+      // the model was held while it loaded
+      state_->budget.release(model);
+    } else {
+      state_->budget.remove(model);
+    }
+  }
+
+  for (auto& request : requests) {
+    if (!error.empty()) {
+      request->request->runCallbackError(error);
+      continue;
+    }
+    auto inference_request = request->request;
+    try {
+      submit(model, std::move(request));
+    } catch (const std::exception& e) {
+      // the caller isn't waiting on the submission so the error is its response
+      inference_request->runCallbackError(e.what());
+    }
+  }
+
+  std::lock_guard lock{loads_mutex_};
+  loads_--;
+  loads_done_.notify_all();
+}
+
+}  // namespace amdinfer
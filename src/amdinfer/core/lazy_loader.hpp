@@ -0,0 +1,101 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the loader that loads models from the repository on demand
+ */
+
+#ifndef GUARD_AMDINFER_CORE_LAZY_LOADER
+#define GUARD_AMDINFER_CORE_LAZY_LOADER
+
+#include <condition_variable>  // for condition_variable
+#include <cstddef>             // for size_t
+#include <filesystem>          // for path
+#include <map>                 // for map
+#include <memory>              // for shared_ptr, unique_ptr
+#include <mutex>               // for mutex
+#include <string>              // for string
+
+namespace amdinfer {
+
+class Endpoints;
+struct RequestContainer;
+
+/**
+ * @brief Loads models from the repository when they're first requested. The
+ * requests that arrive while a model loads are queued and submitted once it's
+ * loaded or answered with an error if it fails to load. If loading a model
+ * would exceed the memory budget of its device, idle models that were loaded
+ * on demand are unloaded least recently used first to make room. A model's
+ * memory is estimated by the size of its files in the repository.
+ *
+ * Models loaded in other ways, such as with modelLoad, are served as usual
+ * and never unloaded by the loader.
+ */
+class LazyLoader {
+ public:
+  /**
+   * @brief Construct a new LazyLoader object
+   *
+   * @param repository path to the repository
+   * @param endpoints the endpoints to load models into
+   * @param budgets most bytes that the models loaded on demand may take on
+   * each kind of device: cpu, gpu or dpu. Devices that aren't listed, or whose
+   * budget is zero, are unlimited
+   */
+  LazyLoader(std::filesystem::path repository, Endpoints* endpoints,
+             std::map<std::string, size_t> budgets);
+  LazyLoader(const LazyLoader&) = delete;
+  LazyLoader& operator=(const LazyLoader&) = delete;
+  LazyLoader(LazyLoader&&) = delete;
+  LazyLoader& operator=(LazyLoader&&) = delete;
+  /// Destructor. It waits for the loads in progress to finish
+  ~LazyLoader();
+
+  /**
+   * @brief Submit a request to a model, loading it from the repository first
+   * if it's not loaded
+   *
+   * @param model the model to run
+   * @param request the request to submit
+   */
+  void infer(const std::string& model,
+             std::unique_ptr<RequestContainer> request);
+
+ private:
+  struct State;
+
+  /// Load a model and submit the requests waiting for it. Runs in its own
+  /// thread
+  void load(const std::string& model);
+  /// Submit a request to a model in the budget, tracking it while it runs
+  void submit(const std::string& model,
+              std::unique_ptr<RequestContainer> request);
+  /// Check if a model can be loaded from the repository
+  [[nodiscard]] bool inRepository(const std::string& model) const;
+
+  std::filesystem::path repository_;
+  Endpoints* endpoints_;
+  /// shared with the callbacks of the requests in flight, which may outlive
+  /// the loader
+  std::shared_ptr<State> state_;
+  std::mutex loads_mutex_;
+  std::condition_variable loads_done_;
+  size_t loads_ = 0;
+};
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_CORE_LAZY_LOADER
@@ -0,0 +1,96 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the scheduler that runs model loads in parallel
+ */
+
+#include "amdinfer/core/load_scheduler.hpp"
+
+#include <algorithm>  // for max, min
+#include <thread>     // for thread
+#include <utility>    // for move
+
+namespace amdinfer {
+
+LoadScheduler::LoadScheduler(LoadLimits limits) : limits_(std::move(limits)) {
+  limits_.threads = std::max(limits_.threads, size_t{1});
+}
+
+void LoadScheduler::run(std::vector<Load> loads) {
+  const auto threads = std::min(limits_.threads, loads.size());
+  {
+    std::lock_guard lock{mutex_};
+    pending_ = std::move(loads);
+  }
+
+  std::vector<std::thread> workers;
+  workers.reserve(threads);
+  for (size_t i = 0; i < threads; ++i) {
+    workers.emplace_back(&LoadScheduler::work, this);
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+}
+
+void LoadScheduler::stop() {
+  std::lock_guard lock{mutex_};
+  stopped_ = true;
+  pending_.clear();
+  cv_.notify_all();
+}
+
+size_t LoadScheduler::next() const {
+  for (size_t i = 0; i < pending_.size(); ++i) {
+    const auto& device = pending_[i].device;
+    const auto limit = limits_.devices.find(device);
+    if (limit == limits_.devices.end() || limit->second == 0) {
+      return i;
+    }
+    const auto running = running_.find(device);
+    if (running == running_.end() || running->second < limit->second) {
+      return i;
+    }
+  }
+  return pending_.size();
+}
+
+void LoadScheduler::work() {
+  std::unique_lock lock{mutex_};
+  while (!stopped_ && !pending_.empty()) {
+    auto index = next();
+    if (index == pending_.size()) {
+      // every pending load is on a device that's full so wait for one to end
+      cv_.wait(lock);
+      continue;
+    }
+
+    auto load = std::move(pending_[index]);
+    pending_.erase(pending_.begin() + static_cast<std::ptrdiff_t>(index));
+    running_[load.device]++;
+    lock.unlock();
+    try {
+      load.function();
+    } catch (...) {
+      // the load reports its own errors
+    }
+    lock.lock();
+    running_[load.device]--;
+    cv_.notify_all();
+  }
+}
+
+}  // namespace amdinfer
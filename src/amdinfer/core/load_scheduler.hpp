@@ -0,0 +1,88 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the scheduler that runs model loads in parallel
+ */
+
+#ifndef GUARD_AMDINFER_CORE_LOAD_SCHEDULER
+#define GUARD_AMDINFER_CORE_LOAD_SCHEDULER
+
+#include <condition_variable>  // for condition_variable
+#include <cstddef>             // for size_t
+#include <functional>          // for function
+#include <map>                 // for map
+#include <mutex>               // for mutex
+#include <string>              // for string
+#include <vector>              // for vector
+
+namespace amdinfer {
+
+/// How many loads may run at once
+struct LoadLimits {
+  /// the most loads that run at once
+  size_t threads = 1;
+  /// the most loads that run at once on each kind of device. Devices that
+  /// aren't listed, or whose limit is zero, are only limited by the threads
+  std::map<std::string, size_t> devices;
+};
+
+/// A load to run and the kind of device, such as gpu, that it loads onto
+struct Load {
+  std::string device;
+  std::function<void()> function;
+};
+
+/**
+ * @brief Runs independent loads in parallel up to some limits. Each thread
+ * takes the first pending load whose device has room so loads on a busy
+ * device don't hold up the others. It's safe to stop from another thread.
+ */
+class LoadScheduler {
+ public:
+  /**
+   * @brief Construct a new LoadScheduler object
+   *
+   * @param limits how many loads may run at once
+   */
+  explicit LoadScheduler(LoadLimits limits);
+
+  /**
+   * @brief Run loads and wait for them to finish. Loads that throw are
+   * the caller's to report so exceptions that escape them are dropped.
+   *
+   * @param loads the loads to run
+   */
+  void run(std::vector<Load> loads);
+
+  /// Skip the loads that haven't started yet. Running loads still finish
+  void stop();
+
+ private:
+  void work();
+  /// Get the index of the next pending load that can run, or the size if none
+  [[nodiscard]] size_t next() const;
+
+  LoadLimits limits_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::vector<Load> pending_;
+  std::map<std::string, size_t> running_;
+  bool stopped_ = false;
+};
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_CORE_LOAD_SCHEDULER
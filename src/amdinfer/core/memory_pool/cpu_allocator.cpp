@@ -19,8 +19,15 @@
 
 #include "amdinfer/core/memory_pool/cpu_allocator.hpp"
 
+#include <sys/mman.h>  // for mmap, munmap, madvise, MAP_FAILED
+
+#include <algorithm>
 #include <cassert>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <string>
 #include <vector>
 
 #include "amdinfer/buffers/cpu.hpp"
@@ -29,13 +36,120 @@
 
 namespace amdinfer {
 
-CpuAllocator::CpuAllocator(size_t block_size, size_t max_allocate)
-  : max_allocate_(max_allocate), block_size_(block_size) {}
+namespace {
+
+constexpr size_t kPageSize = 4'096;
+// the size of transparent huge pages on x86
+constexpr size_t kHugePageSize = 2'097'152;
+
+size_t roundUp(size_t size, size_t multiple) {
+  return (size + multiple - 1) & ~(multiple - 1);
+}
+
+}  // namespace
+
+CpuAllocator::CpuAllocator(size_t block_size, size_t max_allocate,
+                           size_t alignment)
+  : CpuAllocator(MemoryAllocators::Cpu, block_size, max_allocate, alignment) {}
+
+CpuAllocator::CpuAllocator(MemoryAllocators type, size_t block_size,
+                           size_t max_allocate, size_t alignment)
+  : max_allocate_(max_allocate),
+    block_size_(block_size),
+    alignment_(alignment),
+    type_(type) {
+  if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+    throw invalid_argument("The alignment must be a power of two");
+  }
+}
+
+CpuAllocator::~CpuAllocator() { freeBlocks(); }
+
+std::byte* CpuAllocator::allocateBlock(size_t size) {
+  const auto pages = roundUp(size, kPageSize);
+  // huge pages are only used where they're aligned to their size so an extra
+  // one is mapped to align the block in and the rest is unmapped again
+  const bool huge = size >= kHugePageSize;
+  const auto length = huge ? pages + kHugePageSize : pages;
+  void* mapping = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (mapping == MAP_FAILED) {
+    // the memory pool falls back to the next allocator on runtime errors
+    throw runtime_error(std::string{"Failed to map memory: "} +
+                        std::strerror(errno));
+  }
+
+  auto* block = static_cast<std::byte*>(mapping);
+  if (huge) {
+    const auto address = reinterpret_cast<uintptr_t>(mapping);
+    const auto head = roundUp(address, kHugePageSize) - address;
+    if (head > 0) {
+      munmap(mapping, head);
+    }
+    block += head;
+    if (head < kHugePageSize) {
+      munmap(block + pages, kHugePageSize - head);
+    }
+    // it's only advice so the block still works if huge pages are disabled
+    madvise(block, pages, MADV_HUGEPAGE);
+  }
+
+  // the kernel zeroes the pages so touching one byte of each is enough to
+  // fault them in on this thread
+  for (size_t offset = 0; offset < size; offset += kPageSize) {
+    block[offset] = std::byte{0};
+  }
+  return block;
+}
+
+void CpuAllocator::freeBlock(std::byte* block, size_t size) {
+  munmap(block, size);
+}
+
+BufferPtr CpuAllocator::makeBuffer(std::byte* address, size_t size) {
+  return std::make_unique<CpuBuffer>(address, type_, size);
+}
+
+void CpuAllocator::freeBlocks() {
+  const std::lock_guard lock{mutex_};
+  for (const auto& [block, size] : blocks_) {
+    this->freeBlock(block, size);
+  }
+  blocks_.clear();
+  headers_.clear();
+}
 
 BufferPtr CpuAllocator::get(const Tensor& tensor, size_t batch_size) {
   auto size = tensor.getSize() * tensor.getDatatype().size() * batch_size;
 
   const std::lock_guard lock{mutex_};
+  return this->allocate(size);
+}
+
+BufferPtrs CpuAllocator::getBulk(const Tensor& tensor, size_t batch_size,
+                                 size_t count) {
+  auto size = tensor.getSize() * tensor.getDatatype().size() * batch_size;
+
+  BufferPtrs buffers;
+  buffers.reserve(count);
+  const std::lock_guard lock{mutex_};
+  for (auto i = 0U; i < count; i++) {
+    try {
+      buffers.push_back(this->allocate(size));
+    } catch (const runtime_error&) {
+      if (buffers.empty()) {
+        throw;
+      }
+      break;
+    }
+  }
+  return buffers;
+}
+
+BufferPtr CpuAllocator::allocate(size_t requested) {
+  // the buffer reports the size it was asked for but takes up to the next
+  // multiple of the alignment in the block so the next buffer is aligned
+  const auto size = roundUp(requested, alignment_);
   auto best = headers_.end();
   const auto end = headers_.end();
   for (auto it = headers_.begin(); it != end; it++) {
@@ -47,10 +161,11 @@ BufferPtr CpuAllocator::get(const Tensor& tensor, size_t batch_size) {
   }
 
   if (best != end) {
+    in_use_ += size;
     if (best->size == size) {
       best->free = false;
       // std::cout << "Matched " << size << " bytes\n";
-      return std::make_unique<CpuBuffer>(best->address, MemoryAllocators::Cpu);
+      return this->makeBuffer(best->address, requested);
     }
     const auto& new_block =
       headers_.emplace(best, best->address, size, false, best->block_id);
@@ -58,19 +173,19 @@ BufferPtr CpuAllocator::get(const Tensor& tensor, size_t batch_size) {
     best->size -= size;
     best->address += size;
     // std::cout << "Partitioned " << size << " bytes\n";
-    return std::make_unique<CpuBuffer>(new_block->address,
-                                       MemoryAllocators::Cpu);
+    return this->makeBuffer(new_block->address, requested);
   }
 
   auto size_to_allocate = std::max(size, block_size_);
   if (allocated_ + size_to_allocate > max_allocate_) {
+    failures_++;
     throw runtime_error("Too much requested");
   }
-  auto& new_block = data_.emplace_back();
-  new_block.resize(size_to_allocate);
+  auto* retval = this->allocateBlock(size_to_allocate);
+  blocks_.emplace_back(retval, size_to_allocate);
   allocated_ += size_to_allocate;
+  in_use_ += size;
 
-  auto* retval = new_block.data();
   block_id_++;
 
   headers_.emplace_back(retval, size, false, block_id_);
@@ -82,11 +197,22 @@ BufferPtr CpuAllocator::get(const Tensor& tensor, size_t batch_size) {
   }
 
   // std::cout << "Allocated " << size << " bytes\n";
-  return std::make_unique<CpuBuffer>(retval, MemoryAllocators::Cpu);
+  return this->makeBuffer(retval, requested);
 }
 
 void CpuAllocator::put(const void* address) {
   const std::lock_guard lock{mutex_};
+  this->release(address);
+}
+
+void CpuAllocator::putBulk(const std::vector<const void*>& addresses) {
+  const std::lock_guard lock{mutex_};
+  for (const auto* address : addresses) {
+    this->release(address);
+  }
+}
+
+void CpuAllocator::release(const void* address) {
   const auto end = headers_.end();
   auto found = headers_.end();
   for (auto it = headers_.begin(); it != end; it++) {
@@ -99,6 +225,7 @@ void CpuAllocator::put(const void* address) {
   if (found == end) {
     throw runtime_error("Address not found");
   }
+  in_use_ -= found->size;
 
   // if the previous is free and from the same block, merge the two
   if (found != std::begin(headers_)) {
@@ -127,4 +254,56 @@ void CpuAllocator::put(const void* address) {
   // std::cout << "Freed memory\n";
 }
 
+size_t CpuAllocator::trim(size_t keep) {
+  const std::lock_guard lock{mutex_};
+  size_t freed = 0;
+  // the oldest blocks are kept since the newer ones were added for spikes
+  auto block = blocks_.end();
+  while (block != blocks_.begin() && allocated_ > keep) {
+    --block;
+    const auto& [address, size] = *block;
+    // free buffers are merged with their neighbours so a block without any
+    // buffers has one free header that starts at the block
+    auto header = std::find_if(headers_.begin(), headers_.end(),
+                               [start = address](const auto& item) {
+                                 return item.address == start;
+                               });
+    if (header == headers_.end() || !header->free || header->size != size) {
+      continue;
+    }
+    headers_.erase(header);
+    this->freeBlock(address, size);
+    allocated_ -= size;
+    freed += size;
+    block = blocks_.erase(block);
+  }
+  return freed;
+}
+
+bool CpuAllocator::owns(const void* address) {
+  const auto* byte = static_cast<const std::byte*>(address);
+  const std::lock_guard lock{mutex_};
+  return std::any_of(blocks_.begin(), blocks_.end(), [byte](const auto& item) {
+    const auto& [block, size] = item;
+    return byte >= block && byte < block + size;
+  });
+}
+
+AllocatorStats CpuAllocator::getStats() {
+  const std::lock_guard lock{mutex_};
+  AllocatorStats stats{allocated_, in_use_, 0, failures_};
+  size_t free = 0;
+  for (const auto& header : headers_) {
+    if (header.free) {
+      stats.largest_free = std::max(stats.largest_free, header.size);
+      free += header.size;
+    }
+  }
+  if (free > 0) {
+    stats.fragmentation = 1.0 - static_cast<double>(stats.largest_free) /
+                                  static_cast<double>(free);
+  }
+  return stats;
+}
+
 }  // namespace amdinfer
@@ -23,6 +23,7 @@
 #include <cstddef>
 #include <list>
 #include <mutex>
+#include <utility>
 #include <vector>
 
 #include "amdinfer/core/memory_pool/memory_allocator.hpp"
@@ -31,23 +32,109 @@ namespace amdinfer {
 
 struct MemoryHeader;
 
+/**
+ * @brief The CpuAllocator divides blocks of host memory into buffers. Blocks
+ * are mapped from the kernel rather than the heap so large ones can use
+ * transparent huge pages, which cuts the TLB misses and page faults of large
+ * batches.
+ */
 class CpuAllocator : public MemoryAllocator {
  public:
-  explicit CpuAllocator(size_t block_size, size_t max_allocated = -1);
+  /**
+   * @brief Construct a new CpuAllocator object
+   *
+   * @param block_size smallest block of memory to allocate at once
+   * @param max_allocated most bytes to allocate in total
+   * @param alignment the buffers start at multiples of this many bytes in
+   * their block, which must be a power of two. At 1, they're packed together
+   */
+  explicit CpuAllocator(size_t block_size, size_t max_allocated = -1,
+                        size_t alignment = 1);
+  CpuAllocator(const CpuAllocator&) = delete;
+  CpuAllocator& operator=(const CpuAllocator&) = delete;
+  CpuAllocator(CpuAllocator&&) = delete;
+  CpuAllocator& operator=(CpuAllocator&&) = delete;
+  ~CpuAllocator() override;
 
   [[nodiscard]] BufferPtr get(const Tensor& tensor, size_t batch_size) override;
   void put(const void* address) override;
 
-  // void free(const void* address);
+  [[nodiscard]] BufferPtrs getBulk(const Tensor& tensor, size_t batch_size,
+                                   size_t count) override;
+  void putBulk(const std::vector<const void*>& addresses) override;
+
+  /// Free the newest blocks that have no buffers until at most keep bytes are
+  /// allocated
+  size_t trim(size_t keep) override;
+
+  [[nodiscard]] bool owns(const void* address) override;
+
+  [[nodiscard]] AllocatorStats getStats() override;
+
+ protected:
+  /**
+   * @brief Construct a new CpuAllocator object whose buffers are labelled
+   * with another allocator. Allocators of other kinds of host memory extend
+   * this class to reuse how it divides its blocks into buffers.
+   *
+   * @param type the allocator that the buffers are returned to
+   * @param block_size smallest block of memory to allocate at once
+   * @param max_allocated most bytes to allocate in total
+   * @param alignment the alignment of the buffers in their block
+   */
+  CpuAllocator(MemoryAllocators type, size_t block_size, size_t max_allocated,
+               size_t alignment);
+
+  /**
+   * @brief Allocate a block of memory. By default, it's page-aligned anonymous
+   * memory, on huge pages if it's at least one huge page, and its pages are
+   * touched by the thread that allocates it so they're on its NUMA node and
+   * the first batches don't fault them in. It isn't zeroed beyond what the
+   * kernel does.
+   *
+   * @param size size of the block in bytes
+   * @return std::byte*
+   */
+  virtual std::byte* allocateBlock(size_t size);
+  /**
+   * @brief Free a block returned by allocateBlock()
+   *
+   * @param block the block to free
+   * @param size the size that the block was allocated with
+   */
+  virtual void freeBlock(std::byte* block, size_t size);
+  /**
+   * @brief Make the buffer for part of a block. By default, it's a CpuBuffer
+   * labelled with this allocator
+   *
+   * @param address start of the buffer
+   * @param size size of the buffer in bytes
+   * @return BufferPtr
+   */
+  virtual BufferPtr makeBuffer(std::byte* address, size_t size);
+  /**
+   * @brief Free all the blocks. The destructors of subclasses must call this
+   * since the base class' destructor can't call their freeBlock()
+   */
+  void freeBlocks();
 
  private:
+  // these methods assume the mutex is held
+  BufferPtr allocate(size_t size);
+  void release(const void* address);
+
   size_t allocated_ = 0;
+  size_t in_use_ = 0;
+  size_t failures_ = 0;
   size_t max_allocate_;
   size_t block_size_;
   size_t block_id_ = 0;
+  size_t alignment_;
+  MemoryAllocators type_ = MemoryAllocators::Cpu;
   std::mutex mutex_;
   std::list<MemoryHeader> headers_;
-  std::list<std::vector<std::byte>> data_;
+  /// the blocks and their sizes
+  std::list<std::pair<std::byte*, size_t>> blocks_;
 };
 
 }  // namespace amdinfer
@@ -0,0 +1,160 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the size-class CPU allocator
+ */
+
+#include "amdinfer/core/memory_pool/cpu_binned_allocator.hpp"
+
+#include <algorithm>  // for max
+#include <memory>     // for make_unique
+
+#include "amdinfer/buffers/cpu.hpp"
+#include "amdinfer/core/exceptions.hpp"
+
+namespace amdinfer {
+
+namespace {
+
+/// Get the index of the smallest power-of-two class that can hold size bytes
+size_t getBin(size_t size, size_t min_shift) {
+  size_t bin = min_shift;
+  while ((size_t{1} << bin) < size) {
+    bin++;
+  }
+  return bin;
+}
+
+}  // namespace
+
+CpuBinnedAllocator::CpuBinnedAllocator(size_t block_size, size_t max_allocated)
+  : max_allocate_(max_allocated), block_size_(block_size) {}
+
+BufferPtr CpuBinnedAllocator::get(const Tensor& tensor, size_t batch_size) {
+  auto size = tensor.getSize() * tensor.getDatatype().size() * batch_size;
+
+  const std::lock_guard lock{mutex_};
+  return this->allocate(size);
+}
+
+BufferPtrs CpuBinnedAllocator::getBulk(const Tensor& tensor, size_t batch_size,
+                                       size_t count) {
+  auto size = tensor.getSize() * tensor.getDatatype().size() * batch_size;
+
+  BufferPtrs buffers;
+  buffers.reserve(count);
+  const std::lock_guard lock{mutex_};
+  for (auto i = 0U; i < count; i++) {
+    try {
+      buffers.push_back(this->allocate(size));
+    } catch (const runtime_error&) {
+      if (buffers.empty()) {
+        throw;
+      }
+      break;
+    }
+  }
+  return buffers;
+}
+
+BufferPtr CpuBinnedAllocator::allocate(size_t size) {
+  // sizes past the largest class would shift past the width of size_t while
+  // looking for their bin
+  if (size > size_t{1} << (kNumBins - 1)) {
+    failures_++;
+    throw runtime_error("Too much requested");
+  }
+  auto bin = getBin(std::max(size, size_t{1}), kMinBinShift);
+
+  auto& free_list = free_lists_.at(bin);
+  if (free_list.empty()) {
+    this->grow(bin);
+  }
+
+  auto* address = free_list.back();
+  free_list.pop_back();
+  bins_.try_emplace(address, bin);
+  in_use_ += size_t{1} << bin;
+  return std::make_unique<CpuBuffer>(address, MemoryAllocators::CpuBinned,
+                                     size);
+}
+
+void CpuBinnedAllocator::grow(size_t bin) {
+  const auto chunk_size = size_t{1} << bin;
+  const auto size_to_allocate = std::max(chunk_size, block_size_);
+  if (allocated_ + size_to_allocate > max_allocate_) {
+    failures_++;
+    throw runtime_error("Too much requested");
+  }
+
+  auto& new_block = data_.emplace_back();
+  new_block.resize(size_to_allocate);
+  allocated_ += size_to_allocate;
+
+  auto& free_list = free_lists_.at(bin);
+  const auto chunks = size_to_allocate / chunk_size;
+  free_list.reserve(free_list.size() + chunks);
+  // push in reverse so the chunks are handed out in address order
+  for (auto i = chunks; i > 0; i--) {
+    free_list.push_back(new_block.data() + ((i - 1) * chunk_size));
+  }
+}
+
+void CpuBinnedAllocator::put(const void* address) {
+  const std::lock_guard lock{mutex_};
+  this->release(address);
+}
+
+void CpuBinnedAllocator::putBulk(const std::vector<const void*>& addresses) {
+  const std::lock_guard lock{mutex_};
+  for (const auto* address : addresses) {
+    this->release(address);
+  }
+}
+
+void CpuBinnedAllocator::release(const void* address) {
+  auto found = bins_.find(address);
+  if (found == bins_.end()) {
+    throw runtime_error("Address not found");
+  }
+
+  // the address came from one of our blocks so the const_cast is safe
+  auto* chunk = static_cast<std::byte*>(const_cast<void*>(address));
+  free_lists_.at(found->second).push_back(chunk);
+  in_use_ -= size_t{1} << found->second;
+  bins_.erase(found);
+}
+
+bool CpuBinnedAllocator::owns(const void* address) {
+  // only the chunks that are handed out can be returned
+  const std::lock_guard lock{mutex_};
+  return bins_.find(address) != bins_.end();
+}
+
+AllocatorStats CpuBinnedAllocator::getStats() {
+  const std::lock_guard lock{mutex_};
+  AllocatorStats stats{allocated_, in_use_, 0, failures_};
+  // a free chunk can only serve requests of its own class
+  for (auto bin = kNumBins; bin > 0; bin--) {
+    if (!free_lists_.at(bin - 1).empty()) {
+      stats.largest_free = size_t{1} << (bin - 1);
+      break;
+    }
+  }
+  return stats;
+}
+
+}  // namespace amdinfer
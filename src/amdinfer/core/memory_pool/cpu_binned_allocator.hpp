@@ -0,0 +1,89 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the size-class CPU allocator
+ */
+
+#ifndef GUARD_AMDINFER_CORE_MEMORY_POOL_CPU_BINNED_ALLOCATOR
+#define GUARD_AMDINFER_CORE_MEMORY_POOL_CPU_BINNED_ALLOCATOR
+
+#include <array>
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "amdinfer/core/memory_pool/memory_allocator.hpp"
+
+namespace amdinfer {
+
+/**
+ * @brief The CpuBinnedAllocator rounds every request up to a power-of-two size
+ * class and keeps a free list per class. Unlike the CpuAllocator, get() and
+ * put() don't scan the list of headers: allocation pops from the bin's free
+ * list and freeing looks up the address in a hash map. The cost is internal
+ * fragmentation of up to 2x for sizes that aren't a power of two.
+ *
+ * Classes smaller than the block size are carved out of shared blocks of
+ * block_size bytes. Larger classes are allocated individually. Memory is never
+ * returned to the system but freed chunks are reused by their class.
+ */
+class CpuBinnedAllocator : public MemoryAllocator {
+ public:
+  /**
+   * @brief Construct a new CpuBinnedAllocator object
+   *
+   * @param block_size size of the blocks that the small classes share
+   * @param max_allocated most bytes to allocate in total
+   */
+  explicit CpuBinnedAllocator(size_t block_size, size_t max_allocated = -1);
+
+  [[nodiscard]] BufferPtr get(const Tensor& tensor, size_t batch_size) override;
+  void put(const void* address) override;
+
+  [[nodiscard]] BufferPtrs getBulk(const Tensor& tensor, size_t batch_size,
+                                   size_t count) override;
+  void putBulk(const std::vector<const void*>& addresses) override;
+
+  [[nodiscard]] bool owns(const void* address) override;
+
+  [[nodiscard]] AllocatorStats getStats() override;
+
+ private:
+  static constexpr size_t kMinBinShift = 6;  // smallest class is 64 bytes
+  static constexpr size_t kNumBins = 64;
+
+  // these methods assume the mutex is held
+  BufferPtr allocate(size_t size);
+  void release(const void* address);
+  /// Allocate and partition new memory for the given bin
+  void grow(size_t bin);
+
+  size_t allocated_ = 0;
+  size_t in_use_ = 0;
+  size_t failures_ = 0;
+  size_t max_allocate_;
+  size_t block_size_;
+  std::mutex mutex_;
+  std::array<std::vector<std::byte*>, kNumBins> free_lists_;
+  std::unordered_map<const void*, size_t> bins_;
+  std::list<std::vector<std::byte>> data_;
+};
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_CORE_MEMORY_POOL_CPU_BINNED_ALLOCATOR
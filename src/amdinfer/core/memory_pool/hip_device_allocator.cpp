@@ -0,0 +1,155 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the HipDeviceAllocator class
+ */
+
+#include "amdinfer/core/memory_pool/hip_device_allocator.hpp"
+
+#include <hip/hip_runtime_api.h>  // for hipMalloc, hipFree, hipSetDevice
+
+#include <algorithm>  // for max
+#include <memory>     // for make_unique, unique_ptr
+#include <string>     // for string, operator+
+
+#include "amdinfer/buffers/hip_device.hpp"  // for HipDeviceBuffer
+#include "amdinfer/core/exceptions.hpp"     // for runtime_error
+
+namespace amdinfer {
+
+namespace {
+
+// the alignment of hipMalloc() so buffers in a block are aligned like it
+constexpr size_t kDeviceAlignment = 256;
+
+/**
+ * @brief Divides the memory of one GPU into buffers. The blocks are allocated
+ * and freed on that GPU, whichever device the calling thread is using
+ */
+class DeviceBlocks : public CpuAllocator {
+ public:
+  DeviceBlocks(int device, size_t block_size, size_t max_allocated)
+    : CpuAllocator(MemoryAllocators::HipDevice, block_size, max_allocated,
+                   kDeviceAlignment),
+      device_(device) {}
+  DeviceBlocks(const DeviceBlocks&) = delete;
+  DeviceBlocks& operator=(const DeviceBlocks&) = delete;
+  DeviceBlocks(DeviceBlocks&&) = delete;
+  DeviceBlocks& operator=(DeviceBlocks&&) = delete;
+  ~DeviceBlocks() override { freeBlocks(); }
+
+ private:
+  std::byte* allocateBlock(size_t size) override {
+    int current = 0;
+    (void)hipGetDevice(&current);
+    void* block = nullptr;
+    auto status = hipSetDevice(device_);
+    if (status == hipSuccess) {
+      status = hipMalloc(&block, size);
+    }
+    (void)hipSetDevice(current);
+    if (status != hipSuccess) {
+      // the memory pool falls back to the next allocator on runtime errors
+      throw runtime_error(std::string{"Failed to allocate GPU memory: "} +
+                          hipGetErrorString(status));
+    }
+    return static_cast<std::byte*>(block);
+  }
+
+  void freeBlock(std::byte* block, [[maybe_unused]] size_t size) override {
+    // nothing can be done about errors while freeing
+    (void)hipFree(block);
+  }
+
+  BufferPtr makeBuffer(std::byte* address, size_t size) override {
+    return std::make_unique<HipDeviceBuffer>(address, size, device_);
+  }
+
+  int device_;
+};
+
+}  // namespace
+
+HipDeviceAllocator::HipDeviceAllocator(size_t block_size,
+                                       size_t max_allocated)
+  : block_size_(block_size), max_allocated_(max_allocated) {}
+
+HipDeviceAllocator::~HipDeviceAllocator() = default;
+
+CpuAllocator* HipDeviceAllocator::getDevice() {
+  int device = 0;
+  if (const auto status = hipGetDevice(&device); status != hipSuccess) {
+    throw runtime_error(std::string{"Failed to get the current GPU: "} +
+                        hipGetErrorString(status));
+  }
+  const std::lock_guard lock{mutex_};
+  auto& allocator = devices_[device];
+  if (allocator == nullptr) {
+    allocator =
+      std::make_unique<DeviceBlocks>(device, block_size_, max_allocated_);
+  }
+  return allocator.get();
+}
+
+CpuAllocator* HipDeviceAllocator::findDevice(const void* address) {
+  hipPointerAttribute_t attributes;
+  if (hipPointerGetAttributes(&attributes, address) != hipSuccess) {
+    // clear the error so it's not returned by later calls
+    (void)hipGetLastError();
+    throw runtime_error("Address not found");
+  }
+  const std::lock_guard lock{mutex_};
+  auto allocator = devices_.find(attributes.device);
+  if (allocator == devices_.end()) {
+    throw runtime_error("Address not found");
+  }
+  return allocator->second.get();
+}
+
+BufferPtr HipDeviceAllocator::get(const Tensor& tensor, size_t batch_size) {
+  return this->getDevice()->get(tensor, batch_size);
+}
+
+void HipDeviceAllocator::put(const void* address) {
+  this->findDevice(address)->put(address);
+}
+
+BufferPtrs HipDeviceAllocator::getBulk(const Tensor& tensor, size_t batch_size,
+                                       size_t count) {
+  return this->getDevice()->getBulk(tensor, batch_size, count);
+}
+
+void HipDeviceAllocator::putBulk(const std::vector<const void*>& addresses) {
+  for (const auto* address : addresses) {
+    this->put(address);
+  }
+}
+
+AllocatorStats HipDeviceAllocator::getStats() {
+  const std::lock_guard lock{mutex_};
+  AllocatorStats stats;
+  for (const auto& [device, allocator] : devices_) {
+    const auto device_stats = allocator->getStats();
+    stats.allocated += device_stats.allocated;
+    stats.in_use += device_stats.in_use;
+    stats.largest_free =
+      std::max(stats.largest_free, device_stats.largest_free);
+    stats.failures += device_stats.failures;
+  }
+  return stats;
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,83 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the HipDeviceAllocator class
+ */
+
+#ifndef GUARD_AMDINFER_CORE_MEMORY_POOL_HIP_DEVICE_ALLOCATOR
+#define GUARD_AMDINFER_CORE_MEMORY_POOL_HIP_DEVICE_ALLOCATOR
+
+#include <cstddef>  // for size_t
+#include <map>      // for map
+#include <memory>   // for unique_ptr
+#include <mutex>    // for mutex
+#include <vector>   // for vector
+
+#include "amdinfer/core/memory_pool/cpu_allocator.hpp"  // for CpuAllocator
+#include "amdinfer/declarations.hpp"                    // for BufferPtr
+
+namespace amdinfer {
+
+/**
+ * @brief The HipDeviceAllocator serves buffers in GPU memory so workers can
+ * leave their outputs on the device. Each GPU has its own blocks from
+ * hipMalloc(), which are divided into buffers like the CpuAllocator does and
+ * kept when the buffers are returned. Since hipMalloc() and hipFree()
+ * synchronize the device, the memory isn't given back until the pool is
+ * destroyed.
+ *
+ * Buffers are allocated on the calling thread's current device.
+ */
+class HipDeviceAllocator : public MemoryAllocator {
+ public:
+  /**
+   * @brief Construct a new HipDeviceAllocator object
+   *
+   * @param block_size smallest block of memory to allocate at once on a GPU
+   * @param max_allocated most bytes to allocate in total on each GPU
+   */
+  explicit HipDeviceAllocator(size_t block_size, size_t max_allocated = -1);
+  HipDeviceAllocator(const HipDeviceAllocator&) = delete;
+  HipDeviceAllocator& operator=(const HipDeviceAllocator&) = delete;
+  HipDeviceAllocator(HipDeviceAllocator&&) = delete;
+  HipDeviceAllocator& operator=(HipDeviceAllocator&&) = delete;
+  ~HipDeviceAllocator() override;
+
+  [[nodiscard]] BufferPtr get(const Tensor& tensor, size_t batch_size) override;
+  void put(const void* address) override;
+
+  [[nodiscard]] BufferPtrs getBulk(const Tensor& tensor, size_t batch_size,
+                                   size_t count) override;
+  void putBulk(const std::vector<const void*>& addresses) override;
+
+  /// Get the statistics summed over all the GPUs
+  [[nodiscard]] AllocatorStats getStats() override;
+
+ private:
+  /// Get the allocator for the calling thread's current GPU
+  CpuAllocator* getDevice();
+  /// Get the allocator for the GPU that holds an address
+  CpuAllocator* findDevice(const void* address);
+
+  size_t block_size_;
+  size_t max_allocated_;
+  std::mutex mutex_;
+  std::map<int, std::unique_ptr<CpuAllocator>> devices_;
+};
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_CORE_MEMORY_POOL_HIP_DEVICE_ALLOCATOR
@@ -0,0 +1,58 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the default bulk operations of memory allocators
+ */
+
+#include "amdinfer/core/memory_pool/memory_allocator.hpp"
+
+#include "amdinfer/buffers/buffer.hpp"
+#include "amdinfer/core/exceptions.hpp"
+
+namespace amdinfer {
+
+BufferPtrs MemoryAllocator::getBulk(const Tensor& tensor, size_t batch_size,
+                                    size_t count) {
+  BufferPtrs buffers;
+  buffers.reserve(count);
+  for (auto i = 0U; i < count; i++) {
+    try {
+      buffers.push_back(this->get(tensor, batch_size));
+    } catch (const runtime_error&) {
+      if (buffers.empty()) {
+        throw;
+      }
+      break;
+    }
+  }
+  return buffers;
+}
+
+void MemoryAllocator::putBulk(const std::vector<const void*>& addresses) {
+  for (const auto* address : addresses) {
+    this->put(address);
+  }
+}
+
+size_t MemoryAllocator::trim([[maybe_unused]] size_t keep) { return 0; }
+
+bool MemoryAllocator::owns([[maybe_unused]] const void* address) {
+  return true;
+}
+
+AllocatorStats MemoryAllocator::getStats() { return {}; }
+
+}  // namespace amdinfer
@@ -21,13 +21,23 @@
 #define GUARD_AMDINFER_CORE_MEMORY_POOL_MEMORY_ALLOCATOR
 
 #include <cstddef>  // for size_t
+#include <vector>   // for vector
 
 #include "amdinfer/core/tensor.hpp"
 #include "amdinfer/declarations.hpp"
 
 namespace amdinfer {
 
-enum class MemoryAllocators { Cpu, VartTensor };
+enum class MemoryAllocators {
+  Cpu,
+  CpuBinned,
+  VartTensor,
+  SharedMemory,
+  HipSharedMemory,
+  PinnedHost,
+  HipDevice,
+  XrtBo
+};
 
 struct MemoryHeader {
   std::byte* address;
@@ -39,6 +49,26 @@ struct MemoryHeader {
     : address(address), free(free), size(size), block_id(block_id) {}
 };
 
+/// A snapshot of how much memory an allocator holds and how it's used
+struct AllocatorStats {
+  /// bytes the allocator has taken from the system
+  size_t allocated = 0;
+  /**
+   * @brief bytes handed out to buffers. This includes buffers held in the
+   * memory pool's thread caches
+   */
+  size_t in_use = 0;
+  /// size of the largest request that can be served without allocating more
+  size_t largest_free = 0;
+  /// number of requests that failed because the allocator hit its limit
+  size_t failures = 0;
+  /**
+   * @brief share of the free memory that's outside the largest free range,
+   * from 0 when it's all in one range to near 1 when it's scattered
+   */
+  double fragmentation = 0;
+};
+
 class MemoryAllocator {
  public:
   virtual ~MemoryAllocator() = default;
@@ -47,6 +77,50 @@ class MemoryAllocator {
   [[nodiscard]] virtual BufferPtr get(const Tensor& tensor,
                                       size_t batch_size) = 0;
   virtual void put(const void* address) = 0;
+
+  /**
+   * @brief Get up to count buffers for the same tensor at once. Allocators
+   * can override this to amortize their locking across the whole batch. It
+   * stops early if the allocator runs out of memory after getting at least
+   * one buffer.
+   *
+   * @param tensor tensor to allocate memory for
+   * @param batch_size number of tensors to allocate in each buffer
+   * @param count number of buffers to get
+   * @return BufferPtrs
+   */
+  [[nodiscard]] virtual BufferPtrs getBulk(const Tensor& tensor,
+                                           size_t batch_size, size_t count);
+
+  /// Return many addresses at once. By default, this calls put() for each one
+  virtual void putBulk(const std::vector<const void*>& addresses);
+
+  /**
+   * @brief Give the memory that isn't used by any buffer back to the system
+   * until the allocator holds at most keep bytes. Allocators that can't give
+   * memory back don't by default.
+   *
+   * @param keep the bytes the allocator may keep
+   * @return size_t the bytes given back
+   */
+  virtual size_t trim(size_t keep);
+
+  /**
+   * @brief Check if a buffer's address was handed out by this allocator.
+   * Allocators that can't tell claim every address by default.
+   *
+   * @param address the start of the buffer
+   * @return bool
+   */
+  [[nodiscard]] virtual bool owns(const void* address);
+
+  /**
+   * @brief Get the allocator's current statistics. Allocators that don't
+   * track them return zeros.
+   *
+   * @return AllocatorStats
+   */
+  [[nodiscard]] virtual AllocatorStats getStats();
 };
 
 }  // namespace amdinfer
@@ -0,0 +1,56 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the PinnedHostAllocator class
+ */
+
+#include "amdinfer/core/memory_pool/pinned_host_allocator.hpp"
+
+#include <hip/hip_runtime_api.h>  // for hipHostMalloc, hipHostFree
+
+#include <string>  // for string, operator+
+
+#include "amdinfer/core/exceptions.hpp"  // for runtime_error
+
+namespace amdinfer {
+
+PinnedHostAllocator::PinnedHostAllocator(size_t block_size,
+                                         size_t max_allocated,
+                                         size_t alignment)
+  : CpuAllocator(MemoryAllocators::PinnedHost, block_size, max_allocated,
+                 alignment) {}
+
+PinnedHostAllocator::~PinnedHostAllocator() { freeBlocks(); }
+
+std::byte* PinnedHostAllocator::allocateBlock(size_t size) {
+  void* block = nullptr;
+  // the memory is pinned to pages on allocation so it doesn't need touching
+  if (const auto status = hipHostMalloc(&block, size, hipHostMallocDefault);
+      status != hipSuccess) {
+    // the memory pool falls back to the next allocator on runtime errors
+    throw runtime_error(std::string{"Failed to allocate pinned memory: "} +
+                        hipGetErrorString(status));
+  }
+  return static_cast<std::byte*>(block);
+}
+
+void PinnedHostAllocator::freeBlock(std::byte* block,
+                                    [[maybe_unused]] size_t size) {
+  // nothing can be done about errors while freeing
+  (void)hipHostFree(block);
+}
+
+}  // namespace amdinfer
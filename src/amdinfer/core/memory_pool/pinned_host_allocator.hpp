@@ -0,0 +1,60 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the PinnedHostAllocator class
+ */
+
+#ifndef GUARD_AMDINFER_CORE_MEMORY_POOL_PINNED_HOST_ALLOCATOR
+#define GUARD_AMDINFER_CORE_MEMORY_POOL_PINNED_HOST_ALLOCATOR
+
+#include <cstddef>  // for size_t, byte
+
+#include "amdinfer/core/memory_pool/cpu_allocator.hpp"  // for CpuAllocator
+
+namespace amdinfer {
+
+/**
+ * @brief The PinnedHostAllocator divides page-locked host memory from
+ * hipHostMalloc() into buffers like the CpuAllocator does. The GPU can read and
+ * write this memory with DMA so batches built in it are copied to and from the
+ * device without another copy through a staging buffer.
+ */
+class PinnedHostAllocator : public CpuAllocator {
+ public:
+  /**
+   * @brief Construct a new PinnedHostAllocator object
+   *
+   * @param block_size smallest block of memory to allocate at once
+   * @param max_allocated most bytes to allocate in total. Page-locked memory
+   * can't be swapped out so it should be bounded
+   * @param alignment the alignment of the buffers in their block
+   */
+  explicit PinnedHostAllocator(size_t block_size, size_t max_allocated = -1,
+                               size_t alignment = 1);
+  PinnedHostAllocator(const PinnedHostAllocator&) = delete;
+  PinnedHostAllocator& operator=(const PinnedHostAllocator&) = delete;
+  PinnedHostAllocator(PinnedHostAllocator&&) = delete;
+  PinnedHostAllocator& operator=(PinnedHostAllocator&&) = delete;
+  ~PinnedHostAllocator() override;
+
+ private:
+  std::byte* allocateBlock(size_t size) override;
+  void freeBlock(std::byte* block, size_t size) override;
+};
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_CORE_MEMORY_POOL_PINNED_HOST_ALLOCATOR
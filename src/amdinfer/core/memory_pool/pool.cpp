@@ -19,41 +19,465 @@
 
 #include "amdinfer/core/memory_pool/pool.hpp"
 
+#include <algorithm>      // for remove
+#include <atomic>         // for atomic
+#include <mutex>          // for mutex, lock_guard
+#include <string>         // for string, to_string
+#include <tuple>          // for tuple
+#include <unordered_map>  // for unordered_map
+#include <utility>        // for move
+
 #include "amdinfer/buffers/cpu.hpp"
 #include "amdinfer/core/exceptions.hpp"
 #include "amdinfer/core/memory_pool/cpu_allocator.hpp"
+#include "amdinfer/core/memory_pool/cpu_binned_allocator.hpp"
+#include "amdinfer/core/memory_pool/hip_device_allocator.hpp"
+#include "amdinfer/core/memory_pool/pinned_host_allocator.hpp"
 #include "amdinfer/core/memory_pool/vart_tensor_allocator.hpp"
+#include "amdinfer/core/memory_pool/xrt_bo_allocator.hpp"
+#include "amdinfer/observation/metrics.hpp"
 
 namespace amdinfer {
 
 const size_t kDefaultCpuBlockSize = 1'048'576;  // arbitrarily 1MiB
+// CPU buffers are aligned to cache lines for SIMD loads and pinned buffers to
+// pages for DMA
+const size_t kCpuAlignment = 64;
+#ifdef AMDINFER_ENABLE_MIGRAPHX
+const size_t kPinnedAlignment = 4'096;
+#endif
+// buffers larger than this bypass the thread caches
+const size_t kMaxCachedBufferSize = 65'536;
+// maximum number of buffers of one size held in a thread's cache
+const size_t kMagazineSize = 32;
+// buffers to get from the allocator on a cache miss
+const size_t kRefillSize = kMagazineSize / 4;
+#ifdef AMDINFER_ENABLE_MIGRAPHX
+// page-locked memory can't be swapped out so beyond this, workers that prefer
+// it fall back to pageable memory
+const size_t kMaxPinnedSize = 1'073'741'824;  // arbitrarily 1GiB
+// GPU memory is allocated in larger blocks since each allocation synchronizes
+// the device
+const size_t kDefaultDeviceBlockSize = 16'777'216;  // arbitrarily 16MiB
+#endif
+
+namespace {
+
+#ifdef AMDINFER_ENABLE_METRICS
+std::string getName(MemoryAllocators allocator) {
+  switch (allocator) {
+    case MemoryAllocators::Cpu:
+      return "cpu";
+    case MemoryAllocators::CpuBinned:
+      return "cpu_binned";
+    case MemoryAllocators::VartTensor:
+      return "vart_tensor";
+    case MemoryAllocators::PinnedHost:
+      return "pinned_host";
+    case MemoryAllocators::HipDevice:
+      return "hip_device";
+    case MemoryAllocators::XrtBo:
+      return "xrt_bo";
+    default:
+      return std::to_string(static_cast<int>(allocator));
+  }
+}
+#endif
+
+bool isCacheable(MemoryAllocators allocator, size_t size) {
+  return (allocator == MemoryAllocators::Cpu ||
+          allocator == MemoryAllocators::CpuBinned ||
+          allocator == MemoryAllocators::PinnedHost) &&
+         size > 0 && size <= kMaxCachedBufferSize;
+}
+
+/**
+ * @brief The pools that are currently alive. Threads check this before
+ * flushing their cache on exit in case the pool was destroyed first.
+ */
+struct PoolRegistry {
+  std::mutex mutex;
+  std::unordered_map<uint64_t, const MemoryPool*> pools;
+  uint64_t counter = 0;
+};
+
+PoolRegistry& getRegistry() {
+  static PoolRegistry registry;
+  return registry;
+}
+
+}  // namespace
+
+/**
+ * @brief The ThreadCache holds the free buffers owned by one thread. The
+ * addresses are still considered allocated by the underlying allocators so
+ * any thread can free a buffer that another thread got from its cache.
+ */
+class ThreadCache {
+ public:
+  ThreadCache() = default;
+  ThreadCache(ThreadCache const&) = delete;
+  ThreadCache& operator=(const ThreadCache&) = delete;
+  ThreadCache(ThreadCache&& other) = delete;
+  ThreadCache& operator=(ThreadCache&& other) = delete;
+
+  ~ThreadCache() {
+#ifdef AMDINFER_ENABLE_METRICS
+    this->publishHits();
+#endif
+    auto& registry = getRegistry();
+    const std::lock_guard lock{registry.mutex};
+    for (auto& [key, magazine] : magazines_) {
+      const auto& [id, allocator, size] = key;
+      if (auto pool = registry.pools.find(id); pool != registry.pools.end()) {
+        pool->second->allocators_.at(allocator)->putBulk(magazine);
+      }
+    }
+  }
+
+  static ThreadCache& get() {
+    thread_local ThreadCache cache;
+    return cache;
+  }
+
+#ifdef AMDINFER_ENABLE_METRICS
+  /// Count a hit. Hits are published with the next miss or flush, which take
+  /// an allocator's lock anyway, so hits don't touch the shared counters
+  void hit() { hits_++; }
+
+  void publishHits() {
+    if (hits_ > 0) {
+      Metrics::getInstance().incrementCounter(
+        MetricCounterIDs::MemoryPoolCacheHit, hits_);
+      hits_ = 0;
+    }
+  }
+#endif
+
+  std::vector<const void*>& getMagazine(uint64_t id,
+                                        MemoryAllocators allocator,
+                                        size_t size) {
+    return magazines_[{id, allocator, size}];
+  }
+
+  void flush(const MemoryPool* pool) {
+#ifdef AMDINFER_ENABLE_METRICS
+    this->publishHits();
+#endif
+    for (auto& [key, magazine] : magazines_) {
+      const auto& [id, allocator, size] = key;
+      if (id == pool->id_ && !magazine.empty()) {
+        pool->allocators_.at(allocator)->putBulk(magazine);
+        magazine.clear();
+      }
+    }
+  }
+
+ private:
+  using Key = std::tuple<uint64_t, MemoryAllocators, size_t>;
+  struct KeyHash {
+    size_t operator()(const Key& key) const {
+      const auto& [id, allocator, size] = key;
+      const auto shift = 7;
+      return (std::hash<uint64_t>{}(id) << shift) ^
+             (std::hash<size_t>{}(size) << 1) ^
+             std::hash<int>{}(static_cast<int>(allocator));
+    }
+  };
+
+  std::unordered_map<Key, std::vector<const void*>, KeyHash> magazines_;
+#ifdef AMDINFER_ENABLE_METRICS
+  size_t hits_ = 0;
+#endif
+};
 
 MemoryPool::MemoryPool() {
-  allocators_.try_emplace(MemoryAllocators::Cpu,
-                          std::make_unique<CpuAllocator>(kDefaultCpuBlockSize));
+  allocators_.try_emplace(
+    MemoryAllocators::Cpu,
+    std::make_unique<CpuAllocator>(kDefaultCpuBlockSize, -1, kCpuAlignment));
+  allocators_.try_emplace(
+    MemoryAllocators::CpuBinned,
+    std::make_unique<CpuBinnedAllocator>(kDefaultCpuBlockSize));
 #ifdef AMDINFER_ENABLE_VITIS
   allocators_.try_emplace(MemoryAllocators::VartTensor,
                           std::make_unique<VartTensorAllocator>());
 #endif
+#ifdef AMDINFER_ENABLE_XRT
+  allocators_.try_emplace(MemoryAllocators::XrtBo,
+                          std::make_unique<XrtBoAllocator>());
+#endif
+#ifdef AMDINFER_ENABLE_MIGRAPHX
+  allocators_.try_emplace(MemoryAllocators::PinnedHost,
+                          std::make_unique<PinnedHostAllocator>(
+                            kDefaultCpuBlockSize, kMaxPinnedSize,
+                            kPinnedAlignment));
+  allocators_.try_emplace(
+    MemoryAllocators::HipDevice,
+    std::make_unique<HipDeviceAllocator>(kDefaultDeviceBlockSize));
+#endif
+  this->registerPool();
+}
+
+MemoryPool::MemoryPool(const MemoryPool* parent, std::string name,
+                       size_t budget, bool overflow)
+  : name_(std::move(name)), parent_(parent), overflow_(overflow) {
+  allocators_.try_emplace(
+    MemoryAllocators::Cpu,
+    std::make_unique<CpuAllocator>(kDefaultCpuBlockSize, budget,
+                                   kCpuAlignment));
+  allocators_.try_emplace(
+    MemoryAllocators::CpuBinned,
+    std::make_unique<CpuBinnedAllocator>(kDefaultCpuBlockSize, budget));
+  this->registerPool();
+
+  const std::lock_guard lock{parent_->partitions_mutex_};
+  parent_->partitions_.push_back(this);
+}
+
+void MemoryPool::registerPool() {
+  {
+    auto& registry = getRegistry();
+    const std::lock_guard lock{registry.mutex};
+    id_ = registry.counter++;
+    registry.pools.try_emplace(id_, this);
+  }
+
+#ifdef AMDINFER_ENABLE_METRICS
+  // reading the stats takes the allocators' locks so it's only done on scrapes
+  scrape_callback_ = Metrics::getInstance().addScrapeCallback([this]() {
+    auto& metrics = Metrics::getInstance();
+    for (const auto& [allocator, stats] : this->getStats()) {
+      const auto name = name_.empty() ? getName(allocator)
+                                      : name_ + "/" + getName(allocator);
+      metrics.setGauge(MetricGaugeIDs::MemoryAllocatorAllocated, name,
+                       static_cast<double>(stats.allocated));
+      metrics.setGauge(MetricGaugeIDs::MemoryAllocatorInUse, name,
+                       static_cast<double>(stats.in_use));
+      metrics.setGauge(MetricGaugeIDs::MemoryAllocatorLargestFree, name,
+                       static_cast<double>(stats.largest_free));
+      metrics.setGauge(MetricGaugeIDs::MemoryAllocatorFailures, name,
+                       static_cast<double>(stats.failures));
+      metrics.setGauge(MetricGaugeIDs::MemoryAllocatorFragmentation, name,
+                       stats.fragmentation);
+    }
+  });
+#endif
+}
+
+MemoryPool::~MemoryPool() {
+  if (trimmer_.joinable()) {
+    {
+      const std::lock_guard lock{trim_mutex_};
+      stop_trimming_ = true;
+    }
+    trim_cv_.notify_all();
+    trimmer_.join();
+  }
+  if (parent_ != nullptr) {
+    const std::lock_guard lock{parent_->partitions_mutex_};
+    auto& partitions = parent_->partitions_;
+    partitions.erase(std::remove(partitions.begin(), partitions.end(), this),
+                     partitions.end());
+  }
+#ifdef AMDINFER_ENABLE_METRICS
+  Metrics::getInstance().removeScrapeCallback(scrape_callback_);
+#endif
+  auto& registry = getRegistry();
+  const std::lock_guard lock{registry.mutex};
+  registry.pools.erase(id_);
 }
 
 std::unique_ptr<Buffer> MemoryPool::get(
   const std::vector<MemoryAllocators>& allocators, const Tensor& tensor,
   size_t batch_size) const {
+  const auto size =
+    tensor.getSize() * tensor.getDatatype().size() * batch_size;
+  // the host allocators of a partition that may overflow to its parent
+  std::vector<MemoryAllocators> overflow;
   for (const auto& allocator : allocators) {
+    if (allocators_.find(allocator) == allocators_.end()) {
+      // a partition gets the other kinds of memory from its parent and the
+      // allocators that aren't in this build are skipped
+      if (parent_ != nullptr) {
+        try {
+          return parent_->get({allocator}, tensor, batch_size);
+        } catch (const runtime_error&) {
+          continue;
+        }
+      }
+      continue;
+    }
+    if (overflow_) {
+      overflow.push_back(allocator);
+    }
     try {
-      return allocators_.at(allocator)->get(tensor, batch_size);
+      if (!isCacheable(allocator, size)) {
+        return allocators_.at(allocator)->get(tensor, batch_size);
+      }
+
+      auto& cache = ThreadCache::get();
+      auto& magazine = cache.getMagazine(id_, allocator, size);
+#ifdef AMDINFER_ENABLE_METRICS
+      if (!magazine.empty()) {
+        cache.hit();
+      }
+#endif
+      if (magazine.empty()) {
+#ifdef AMDINFER_ENABLE_METRICS
+        Metrics::getInstance().incrementCounter(
+          MetricCounterIDs::MemoryPoolCacheMiss);
+        cache.publishHits();
+#endif
+        auto buffers =
+          allocators_.at(allocator)->getBulk(tensor, batch_size, kRefillSize);
+        for (auto& buffer : buffers) {
+          magazine.push_back(buffer->data(0));
+        }
+      }
+
+      auto* address = const_cast<void*>(magazine.back());
+      magazine.pop_back();
+      return std::make_unique<CpuBuffer>(address, allocator, size);
     } catch (const runtime_error&) {
       continue;
     }
   }
+  if (!overflow.empty()) {
+    return parent_->get(overflow, tensor, batch_size);
+  }
   throw runtime_error("Memory could not be allocated");
 }
 
 void MemoryPool::put(std::unique_ptr<Buffer> memory) const {
   const auto allocator = memory->getAllocator();
   const auto* address = memory->data(0);
-  allocators_.at(allocator)->put(address);
+  const auto size = memory->size();
+  if (parent_ != nullptr) {
+    // the buffers of a partition may also come from its parent, such as the
+    // requests' inputs and the memory that overflowed
+    auto found = allocators_.find(allocator);
+    if (found == allocators_.end() || !found->second->owns(address)) {
+      parent_->put(std::move(memory));
+      return;
+    }
+  }
+  if (!isCacheable(allocator, size)) {
+    allocators_.at(allocator)->put(address);
+    return;
+  }
+
+  auto& cache = ThreadCache::get();
+  auto& magazine = cache.getMagazine(id_, allocator, size);
+  magazine.push_back(address);
+  if (magazine.size() > kMagazineSize) {
+#ifdef AMDINFER_ENABLE_METRICS
+    cache.publishHits();
+#endif
+    // return the older half of the magazine so the hot buffers stay cached
+    const auto half = magazine.begin() + kMagazineSize / 2;
+    allocators_.at(allocator)->putBulk({magazine.begin(), half});
+    magazine.erase(magazine.begin(), half);
+  }
+}
+
+std::shared_ptr<MemoryAllocator> MemoryPool::getOwner(
+  Buffer* buffer) const {
+  const auto allocator = buffer->getAllocator();
+  auto found = allocators_.find(allocator);
+  if (parent_ != nullptr) {
+    if (found == allocators_.end() || !found->second->owns(buffer->data(0))) {
+      return parent_->getOwner(buffer);
+    }
+  }
+  return allocators_.at(allocator);
+}
+
+void MemoryPool::reserve(const std::vector<MemoryAllocators>& allocators,
+                         const Tensor& tensor, size_t batch_size,
+                         size_t count) const {
+  for (const auto& allocator : allocators) {
+    auto found = allocators_.find(allocator);
+    if (found == allocators_.end()) {
+      if (parent_ != nullptr) {
+        try {
+          parent_->reserve({allocator}, tensor, batch_size, count);
+          return;
+        } catch (const runtime_error&) {
+          continue;
+        }
+      }
+      continue;
+    }
+    try {
+      // the buffers skip the thread caches so any thread gets them later
+      const auto buffers = found->second->getBulk(tensor, batch_size, count);
+      std::vector<const void*> addresses;
+      addresses.reserve(buffers.size());
+      for (const auto& buffer : buffers) {
+        addresses.push_back(buffer->data(0));
+      }
+      found->second->putBulk(addresses);
+      return;
+    } catch (const runtime_error&) {
+      continue;
+    }
+  }
+  throw runtime_error("Memory could not be reserved");
+}
+
+void MemoryPool::flushThreadCache() const { ThreadCache::get().flush(this); }
+
+size_t MemoryPool::trim(size_t keep) const {
+  size_t freed = 0;
+  for (const auto& [allocator, memory] : allocators_) {
+    freed += memory->trim(keep);
+  }
+  const std::lock_guard lock{partitions_mutex_};
+  for (const auto* partition : partitions_) {
+    freed += partition->trim(keep);
+  }
+  return freed;
+}
+
+void MemoryPool::startTrimming(std::chrono::milliseconds interval,
+                               size_t keep) {
+  {
+    const std::lock_guard lock{trim_mutex_};
+    trim_interval_ = interval;
+    trim_keep_ = keep;
+  }
+  if (trimmer_.joinable()) {
+    // wake the trimmer so it waits for the new interval
+    trim_cv_.notify_all();
+    return;
+  }
+  trimmer_ = std::thread{&MemoryPool::trimPeriodically, this};
+}
+
+void MemoryPool::trimPeriodically() {
+  std::unique_lock lock{trim_mutex_};
+  while (!stop_trimming_) {
+    const auto interval = trim_interval_;
+    if (trim_cv_.wait_for(lock, interval, [&]() {
+          return stop_trimming_ || trim_interval_ != interval;
+        })) {
+      continue;
+    }
+    const auto keep = trim_keep_;
+    lock.unlock();
+    this->trim(keep);
+    lock.lock();
+  }
+}
+
+std::vector<std::pair<MemoryAllocators, AllocatorStats>> MemoryPool::getStats()
+  const {
+  std::vector<std::pair<MemoryAllocators, AllocatorStats>> stats;
+  stats.reserve(allocators_.size());
+  for (const auto& [allocator, memory] : allocators_) {
+    stats.emplace_back(allocator, memory->getStats());
+  }
+  return stats;
 }
 
 }  // namespace amdinfer
@@ -20,9 +20,16 @@
 #ifndef GUARD_AMDINFER_CORE_MEMORY_POOL_POOL
 #define GUARD_AMDINFER_CORE_MEMORY_POOL_POOL
 
+#include <chrono>
+#include <condition_variable>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "amdinfer/build_options.hpp"
@@ -31,17 +38,135 @@
 
 namespace amdinfer {
 
+/**
+ * @brief The MemoryPool holds the allocators that batchers, workers and the
+ * servers get their memory from. Small CPU buffers are served from a bounded
+ * per-thread cache in front of the allocators so that the common case of
+ * allocating and freeing request tensors doesn't contend on the allocators'
+ * locks. The caches are refilled from and flushed to the allocators in bulk.
+ *
+ * A pool can be partitioned so a model that allocates more than expected
+ * can't exhaust the memory of the others. Each partition has its own host
+ * allocators with their own budget and gets the other kinds of memory from
+ * the pool it partitions. Buffers can be put back to either pool since they
+ * go to whichever one they came from.
+ */
 class MemoryPool {
  public:
   MemoryPool();
+  /**
+   * @brief Construct a partition of another pool. The parent must outlive it
+   *
+   * @param parent the pool to partition
+   * @param name the name of the partition, which labels its metrics
+   * @param budget most bytes that each of the partition's host allocators may
+   * allocate
+   * @param overflow if true, host memory comes from the parent once the budget
+   * is used up instead of failing
+   */
+  MemoryPool(const MemoryPool* parent, std::string name, size_t budget,
+             bool overflow);
+  ~MemoryPool();
+  MemoryPool(MemoryPool const&) = delete;             ///< Copy constructor
+  MemoryPool& operator=(const MemoryPool&) = delete;  ///< Copy assignment
+  MemoryPool(MemoryPool&& other) = delete;            ///< Move constructor
+  MemoryPool& operator=(MemoryPool&& other) = delete;  ///< Move assignment
 
   std::unique_ptr<Buffer> get(const std::vector<MemoryAllocators>& allocators,
                               const Tensor& tensor, size_t batch_size) const;
   void put(std::unique_ptr<Buffer> memory) const;
 
+  /**
+   * @brief Get the allocator that a buffer came from. Holding it keeps the
+   * buffer's memory allocated after the pool is destroyed so memory that
+   * leaves the server, such as a response's outputs, can outlive it. The
+   * buffer is then given back with the allocator's put() instead of the pool's.
+   *
+   * @param buffer a buffer from this pool or the pool it partitions
+   * @return std::shared_ptr<MemoryAllocator>
+   */
+  [[nodiscard]] std::shared_ptr<MemoryAllocator> getOwner(
+    Buffer* buffer) const;
+
+  /**
+   * @brief Allocate the memory for some buffers ahead of time so getting them
+   * later doesn't allocate. The buffers are taken from the first of the
+   * allocators that can hold them and given straight back to it so the memory
+   * stays allocated and its pages are already touched. If the allocator runs
+   * out of memory partway, the buffers it could hold are still reserved.
+   *
+   * @param allocators the allocators to try in order
+   * @param tensor tensor to reserve memory for
+   * @param batch_size number of tensors in each buffer
+   * @param count number of buffers to reserve
+   */
+  void reserve(const std::vector<MemoryAllocators>& allocators,
+               const Tensor& tensor, size_t batch_size, size_t count) const;
+
+  /// Return all the memory cached by the calling thread to the allocators
+  void flushThreadCache() const;
+
+  /**
+   * @brief Give the memory that no buffer uses back to the system until each
+   * allocator holds at most keep bytes. Memory cached by threads is still in
+   * use. Allocators that synchronize devices to free memory keep it. The
+   * partitions of the pool are trimmed too.
+   *
+   * @param keep the bytes each allocator may keep
+   * @return size_t the bytes given back
+   */
+  size_t trim(size_t keep) const;
+
+  /**
+   * @brief Trim the allocators periodically from a background thread so a
+   * spike in traffic doesn't hold on to its memory for the life of the pool.
+   * Calling this again changes the interval and the limit.
+   *
+   * @param interval the time between trims
+   * @param keep the bytes each allocator may keep
+   */
+  void startTrimming(std::chrono::milliseconds interval, size_t keep);
+
+  /**
+   * @brief Get the statistics of each allocator. With metrics enabled, they're
+   * also published as gauges labelled by allocator whenever metrics are
+   * scraped.
+   *
+   * @return std::vector<std::pair<MemoryAllocators, AllocatorStats>>
+   */
+  [[nodiscard]] std::vector<std::pair<MemoryAllocators, AllocatorStats>>
+  getStats() const;
+
  private:
-  std::unordered_map<MemoryAllocators, std::unique_ptr<MemoryAllocator>>
+  friend class ThreadCache;
+
+  /// Add the pool to the registry and publish its statistics
+  void registerPool();
+  /// Trim the allocators every interval until the pool is destroyed
+  void trimPeriodically();
+
+  uint64_t id_;
+  /// the name that labels the pool's metrics, which is empty if it's not a
+  /// partition
+  std::string name_;
+  /// the pool that this one partitions, if any
+  const MemoryPool* parent_ = nullptr;
+  bool overflow_ = false;
+  mutable std::mutex partitions_mutex_;
+  mutable std::vector<const MemoryPool*> partitions_;
+#ifdef AMDINFER_ENABLE_METRICS
+  size_t scrape_callback_;
+#endif
+  /// the allocators are shared with the memory that's given out with its owner
+  std::unordered_map<MemoryAllocators, std::shared_ptr<MemoryAllocator>>
     allocators_;
+
+  std::mutex trim_mutex_;
+  std::condition_variable trim_cv_;
+  std::chrono::milliseconds trim_interval_{};
+  size_t trim_keep_ = 0;
+  bool stop_trimming_ = false;
+  std::thread trimmer_;
 };
 
 }  // namespace amdinfer
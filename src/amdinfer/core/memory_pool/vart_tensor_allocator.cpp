@@ -19,9 +19,10 @@
 
 #include "amdinfer/core/memory_pool/vart_tensor_allocator.hpp"
 
-#include <cassert>
-#include <iostream>
-#include <vector>
+#include <functional>  // for hash
+#include <memory>      // for make_unique
+#include <string>      // for string
+#include <vector>      // for vector
 #include <xir/util/data_type.hpp>  // for DataType
 
 #include "amdinfer/buffers/vart_tensor.hpp"
@@ -31,31 +32,38 @@
 
 namespace amdinfer {
 
+size_t VartTensorKeyHash::operator()(const VartTensorKey& key) const {
+  // boost::hash_combine
+  constexpr size_t kMagic = 0x9e3779b9;
+  auto seed = std::hash<std::string>{}(key.name);
+  auto combine = [&seed](size_t value) {
+    seed ^= value + kMagic + (seed << 6) + (seed >> 2);
+  };
+  combine(std::hash<Shape>{}(key.shape));
+  combine(static_cast<size_t>(DataType::Value(key.datatype)));
+  combine(key.batch_size);
+  return seed;
+}
+
 VartTensorAllocator::VartTensorAllocator(size_t max_allocate)
   : max_allocate_(max_allocate) {}
 
 BufferPtr VartTensorAllocator::get(const Tensor& tensor, size_t batch_size) {
-  const auto& name = tensor.getName();
-  const auto& shape = tensor.getShape();
-  const auto datatype = tensor.getDatatype();
+  VartTensorKey key{tensor.getName(), tensor.getShape(), tensor.getDatatype(),
+                    batch_size};
 
   const std::lock_guard lock{mutex_};
-  auto found = headers_.end();
-  const auto end = headers_.end();
-  for (auto it = headers_.begin(); it != end; it++) {
-    if (it->free && it->name == name && it->shape == shape &&
-        it->datatype == datatype && it->batch_size == batch_size) {
-      found = it;
-      break;
-    }
-  }
-
-  if (found != end) {
-    found->free = false;
-    return std::make_unique<VartTensorBuffer>(found->address,
+  auto& free_list = free_lists_[key];
+  if (!free_list.empty()) {
+    auto& allocation = allocations_.at(free_list.back());
+    free_list.pop_back();
+    allocation.free = false;
+    return std::make_unique<VartTensorBuffer>(allocation.buffer,
                                               MemoryAllocators::VartTensor);
   }
 
+  const auto& shape = key.shape;
+  const auto datatype = key.datatype;
   auto size_to_allocate = tensor.getSize() * datatype.size() * batch_size;
   if (allocated_ + size_to_allocate > max_allocate_) {
     throw runtime_error("Too much requested");
@@ -63,34 +71,31 @@ BufferPtr VartTensorAllocator::get(const Tensor& tensor, size_t batch_size) {
 
   auto xir_type = mapTypeToXir(datatype);
   std::vector<int> xir_shape{shape.begin(), shape.end()};
-  tensors_.emplace_back(xir::Tensor::create(name, xir_shape, xir_type));
+  tensors_.emplace_back(xir::Tensor::create(key.name, xir_shape, xir_type));
   buffers_.emplace_back(tensors_.back().get());
 
   allocated_ += size_to_allocate;
 
   auto* retval = reinterpret_cast<std::byte*>(&(buffers_.back()));
+  auto buffer =
+    std::make_unique<VartTensorBuffer>(retval, MemoryAllocators::VartTensor);
+  // references to the values of an unordered_map stay valid through rehashing
+  allocations_.emplace(buffer->data(0), Allocation{retval, &free_list, false});
 
-  headers_.emplace_back(retval, false, name, shape, datatype, batch_size);
-
-  return std::make_unique<VartTensorBuffer>(retval,
-                                            MemoryAllocators::VartTensor);
+  return buffer;
 }
 
 void VartTensorAllocator::put(const void* address) {
   const std::lock_guard lock{mutex_};
-  const auto end = headers_.end();
-  auto found = headers_.end();
-  for (auto it = headers_.begin(); it != end; it++) {
-    if (it->address == address) {
-      found->free = true;
-      // std::cout << "Freed memory\n";
-      return;
-    }
-  }
-
-  if (found == end) {
+  auto found = allocations_.find(address);
+  if (found == allocations_.end()) {
     throw runtime_error("Address not found");
   }
+  auto& allocation = found->second;
+  if (!allocation.free) {
+    allocation.free = true;
+    allocation.free_list->push_back(address);
+  }
 }
 
 }  // namespace amdinfer
@@ -27,35 +27,41 @@
 #include <cstddef>
 #include <list>
 #include <mutex>
+#include <string>
+#include <unordered_map>
 #include <vart/experimental/runner_helper.hpp>  // for CpuFlatTensorBufferOwned
 #include <vector>
 #include <xir/tensor/tensor.hpp>  // for Tensor
 
 #include "amdinfer/core/data_types.hpp"
 #include "amdinfer/core/memory_pool/memory_allocator.hpp"
+#include "amdinfer/core/shape.hpp"
 
 namespace amdinfer {
 
-struct VartTensorHeader {
-  std::byte* address;
-  bool free;
-
+/// The signature of the tensors that a VartTensor buffer can be reused for
+struct VartTensorKey {
   std::string name;
-  std::vector<uint64_t> shape;
+  Shape shape;
   DataType datatype;
   size_t batch_size;
 
-  VartTensorHeader(std::byte* address, bool free, const std::string& name,
-                   const std::vector<uint64_t>& shape, DataType datatype,
-                   size_t batch_size)
-    : address(address),
-      free(free),
-      name(name),
-      shape(shape),
-      datatype(datatype),
-      batch_size(batch_size) {}
+  bool operator==(const VartTensorKey& other) const {
+    return name == other.name && shape == other.shape &&
+           datatype == other.datatype && batch_size == other.batch_size;
+  }
+};
+
+struct VartTensorKeyHash {
+  size_t operator()(const VartTensorKey& key) const;
 };
 
+/**
+ * @brief The VartTensorAllocator allocates VART tensor buffers. Buffers are
+ * only reused for tensors with the same signature so there's a free list per
+ * signature. Freeing looks up the buffer's data address in a hash map so
+ * neither get() nor put() scan the existing buffers.
+ */
 class VartTensorAllocator : public MemoryAllocator {
  public:
   explicit VartTensorAllocator(size_t max_allocated = -1);
@@ -63,14 +69,24 @@ class VartTensorAllocator : public MemoryAllocator {
   [[nodiscard]] BufferPtr get(const Tensor& tensor, size_t batch_size) override;
   void put(const void* address) override;
 
-  // void free(const void* address);
-
  private:
+  /// The tensor buffer for an address and the free list it belongs to
+  struct Allocation {
+    std::byte* buffer;
+    std::vector<const void*>* free_list;
+    bool free;
+  };
+
   size_t allocated_ = 0;
   size_t max_allocate_;
   std::mutex mutex_;
 
-  std::list<VartTensorHeader> headers_;
+  /// the data addresses of the free buffers for each signature
+  std::unordered_map<VartTensorKey, std::vector<const void*>,
+                     VartTensorKeyHash>
+    free_lists_;
+  /// the allocations by the address of their data, which is what's freed
+  std::unordered_map<const void*, Allocation> allocations_;
   std::list<std::unique_ptr<xir::Tensor>> tensors_;
   std::list<vart::CpuFlatTensorBufferOwned> buffers_;
 };
@@ -0,0 +1,130 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the XrtBoAllocator class
+ */
+
+#include "amdinfer/core/memory_pool/xrt_bo_allocator.hpp"
+
+#include <algorithm>  // for max
+#include <cstdint>    // for uint64_t
+#include <exception>  // for exception
+#include <iterator>   // for prev
+#include <memory>     // for make_unique
+#include <string>     // for string, operator+
+#include <vector>     // for vector
+
+#include "amdinfer/buffers/xrt_bo.hpp"            // for XrtBoBuffer
+#include "amdinfer/core/data_types_internal.hpp"  // for mapTypeToXir
+#include "amdinfer/core/exceptions.hpp"           // for runtime_error
+
+namespace amdinfer {
+
+XrtBoAllocator::XrtBoAllocator(unsigned int device, uint32_t memory_group,
+                               size_t max_allocated)
+  : device_index_(device),
+    memory_group_(memory_group),
+    max_allocate_(max_allocated) {}
+
+BufferPtr XrtBoAllocator::get(const Tensor& tensor, size_t batch_size) {
+  VartTensorKey key{tensor.getName(), tensor.getShape(), tensor.getDatatype(),
+                    batch_size};
+
+  const std::lock_guard lock{mutex_};
+  auto& free_list = free_lists_[key];
+  if (!free_list.empty()) {
+    auto& allocation = *allocations_.at(free_list.back());
+    free_list.pop_back();
+    allocation.free = false;
+    in_use_ += static_cast<size_t>(allocation.tensor->get_data_size());
+    return std::make_unique<XrtBoBuffer>(
+      allocation.buffer.get(), &allocation.bo,
+      allocation.bo.map<std::byte*>());
+  }
+
+  // the tensor has the shape of the whole batch, as for VART tensors
+  const auto& shape = key.shape;
+  auto xir_tensor = xir::Tensor::create(
+    key.name, std::vector<int>{shape.begin(), shape.end()},
+    mapTypeToXir(key.datatype));
+  const auto size = static_cast<size_t>(xir_tensor->get_data_size());
+  if (allocated_ + size > max_allocate_) {
+    failures_++;
+    throw runtime_error("Too much requested");
+  }
+
+  try {
+    if (!device_.has_value()) {
+      device_.emplace(device_index_);
+    }
+    xrt::bo bo{*device_, size, xrt::bo::flags::normal, memory_group_};
+
+    // the DPU reads each batch from its own physical address
+    const auto batches = static_cast<size_t>(xir_tensor->get_shape().at(0));
+    std::vector<uint64_t> addresses;
+    addresses.reserve(batches);
+    for (size_t i = 0; i < batches; ++i) {
+      addresses.push_back(bo.address() + i * (size / batches));
+    }
+    auto buffer = vart::TensorBuffer::create_unowned_device_tensor_buffer(
+      xir_tensor.get(), addresses.data(), addresses.size());
+
+    auto* data = bo.map<std::byte*>();
+    storage_.push_back({std::move(xir_tensor), std::move(bo),
+                        std::move(buffer), &free_list, false});
+    allocations_.emplace(data, std::prev(storage_.end()));
+    allocated_ += size;
+    in_use_ += size;
+    auto& allocation = storage_.back();
+    return std::make_unique<XrtBoBuffer>(allocation.buffer.get(),
+                                         &allocation.bo, data);
+  } catch (const std::exception& e) {
+    // the memory pool falls back to the next allocator on runtime errors
+    failures_++;
+    throw runtime_error(std::string{"Failed to allocate an XRT buffer: "} +
+                        e.what());
+  }
+}
+
+void XrtBoAllocator::put(const void* address) {
+  const std::lock_guard lock{mutex_};
+  auto found = allocations_.find(address);
+  if (found == allocations_.end()) {
+    throw runtime_error("Address not found");
+  }
+  auto& allocation = *found->second;
+  if (!allocation.free) {
+    allocation.free = true;
+    in_use_ -= static_cast<size_t>(allocation.tensor->get_data_size());
+    allocation.free_list->push_back(address);
+  }
+}
+
+AllocatorStats XrtBoAllocator::getStats() {
+  const std::lock_guard lock{mutex_};
+  AllocatorStats stats{allocated_, in_use_, 0, failures_};
+  for (const auto& [key, free_list] : free_lists_) {
+    if (!free_list.empty()) {
+      const auto size = allocations_.at(free_list.back())
+                          ->tensor->get_data_size();
+      stats.largest_free =
+        std::max(stats.largest_free, static_cast<size_t>(size));
+    }
+  }
+  return stats;
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,107 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the XrtBoAllocator class
+ */
+
+#ifndef GUARD_AMDINFER_CORE_MEMORY_POOL_XRT_BO_ALLOCATOR
+#define GUARD_AMDINFER_CORE_MEMORY_POOL_XRT_BO_ALLOCATOR
+
+#include "amdinfer/build_options.hpp"
+
+#ifdef AMDINFER_ENABLE_XRT
+
+#include <cstddef>                 // for size_t
+#include <cstdint>                 // for uint32_t
+#include <list>                    // for list
+#include <memory>                  // for unique_ptr
+#include <mutex>                   // for mutex
+#include <optional>                // for optional
+#include <unordered_map>           // for unordered_map
+#include <vart/tensor_buffer.hpp>  // for TensorBuffer
+#include <vector>                  // for vector
+#include <xir/tensor/tensor.hpp>   // for Tensor
+#include <xrt/xrt_bo.h>            // for bo
+#include <xrt/xrt_device.h>        // for device
+
+#include "amdinfer/core/memory_pool/memory_allocator.hpp"
+#include "amdinfer/core/memory_pool/vart_tensor_allocator.hpp"  // for Vart...
+
+namespace amdinfer {
+
+/**
+ * @brief The XrtBoAllocator allocates XRT buffer objects in the FPGA's memory
+ * for DPU tensors. The batchers write requests straight into the buffer
+ * objects' host mappings and the DPU runners read the device memory in place
+ * so a batch is only copied to the device when it's synced. Like the
+ * VartTensorAllocator, buffers are only reused for tensors with the same
+ * signature.
+ *
+ * The device is opened on the first allocation so servers without an FPGA
+ * fall back to the next allocator.
+ */
+class XrtBoAllocator : public MemoryAllocator {
+ public:
+  /**
+   * @brief Construct a new XrtBoAllocator object
+   *
+   * @param device index of the FPGA to allocate on
+   * @param memory_group memory bank of the FPGA that the DPU reads
+   * @param max_allocated most bytes to allocate in total
+   */
+  explicit XrtBoAllocator(unsigned int device = 0, uint32_t memory_group = 0,
+                          size_t max_allocated = -1);
+
+  [[nodiscard]] BufferPtr get(const Tensor& tensor, size_t batch_size) override;
+  void put(const void* address) override;
+
+  [[nodiscard]] AllocatorStats getStats() override;
+
+ private:
+  /// A buffer object, its device tensor buffer and the free list it's on
+  struct Allocation {
+    std::unique_ptr<xir::Tensor> tensor;
+    xrt::bo bo;
+    std::unique_ptr<vart::TensorBuffer> buffer;
+    std::vector<const void*>* free_list;
+    bool free;
+  };
+
+  unsigned int device_index_;
+  uint32_t memory_group_;
+  size_t max_allocate_;
+  size_t allocated_ = 0;
+  size_t in_use_ = 0;
+  size_t failures_ = 0;
+  std::mutex mutex_;
+  std::optional<xrt::device> device_;
+
+  /// the mapped addresses of the free buffers for each signature
+  std::unordered_map<VartTensorKey, std::vector<const void*>,
+                     VartTensorKeyHash>
+    free_lists_;
+  /// the allocations by their mapped address, which is what's freed. The
+  /// list keeps them in place for the buffers that point to them
+  std::unordered_map<const void*, std::list<Allocation>::iterator>
+    allocations_;
+  std::list<Allocation> storage_;
+};
+
+}  // namespace amdinfer
+
+#endif
+
+#endif  // GUARD_AMDINFER_CORE_MEMORY_POOL_XRT_BO_ALLOCATOR
@@ -0,0 +1,104 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the loaded models that are shared by the workers that run
+ * them
+ */
+
+#include "amdinfer/core/model_artifacts.hpp"
+
+#include <map>           // for map
+#include <mutex>         // for mutex, lock_guard
+#include <optional>      // for optional
+#include <string>        // for to_string
+#include <system_error>  // for error_code
+
+#include "amdinfer/core/exceptions.hpp"  // for runtime_error
+
+namespace amdinfer {
+
+namespace {
+
+/// A model that's loaded or being loaded
+struct Artifact {
+  std::mutex mutex;
+  std::optional<std::type_index> type;
+  std::weak_ptr<void> value;
+};
+
+/// the artifacts by key, which are unloaded once no worker holds them
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+std::map<std::string, std::shared_ptr<Artifact>> artifacts;
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+std::mutex artifacts_mutex;
+
+}  // namespace
+
+std::shared_ptr<void> getModelArtifact(
+  const std::string& key, std::type_index type,
+  const std::function<std::shared_ptr<void>()>& load) {
+  std::shared_ptr<Artifact> artifact;
+  {
+    const std::lock_guard lock{artifacts_mutex};
+    // the entries of artifacts that were unloaded are dropped as others are
+    // looked up
+    for (auto it = artifacts.begin(); it != artifacts.end();) {
+      if (it->first != key && it->second.use_count() == 1 &&
+          it->second->value.expired()) {
+        it = artifacts.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    auto& entry = artifacts[key];
+    if (entry == nullptr) {
+      entry = std::make_shared<Artifact>();
+    }
+    artifact = entry;
+  }
+
+  const std::lock_guard lock{artifact->mutex};
+  if (auto existing = artifact->value.lock(); existing != nullptr) {
+    if (artifact->type != type) {
+      throw runtime_error("The model artifact " + key +
+                          " is held with another type");
+    }
+    return existing;
+  }
+  auto loaded = load();
+  artifact->type = type;
+  artifact->value = loaded;
+  return loaded;
+}
+
+std::string getModelArtifactKey(const std::filesystem::path& model,
+                                const std::string& options) {
+  // the same file is found by different paths, eg. through the repository
+  // and directly
+  std::error_code error;
+  auto path = std::filesystem::weakly_canonical(model, error);
+  if (error) {
+    path = model;
+  }
+  // a file that's replaced in place is loaded again instead of being shared
+  // with the workers that loaded the old one
+  const auto modified = std::filesystem::last_write_time(path, error);
+  const auto stamp =
+    error ? 0 : static_cast<long long>(modified.time_since_epoch().count());
+  return options + ":" + path.string() + ":" + std::to_string(stamp);
+}
+
+}  // namespace amdinfer
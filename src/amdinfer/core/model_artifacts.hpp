@@ -0,0 +1,82 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the loaded models that are shared by the workers that run
+ * them
+ */
+
+#ifndef GUARD_AMDINFER_CORE_MODEL_ARTIFACTS
+#define GUARD_AMDINFER_CORE_MODEL_ARTIFACTS
+
+#include <filesystem>  // for path
+#include <functional>  // for function
+#include <memory>      // for shared_ptr, static_pointer_cast
+#include <string>      // for string
+#include <typeindex>   // for type_index
+#include <utility>     // for forward
+
+namespace amdinfer {
+
+/**
+ * @brief Get a model that's loaded once and shared by all the workers that ask
+ * for it with the same key. If no worker holds it, it's loaded again. Loads of
+ * the same key wait for each other so a model is only loaded once at a time.
+ * A key can only hold one type of artifact.
+ *
+ * @param key identifies the model and everything its loaded form depends on
+ * @param type the type of the artifact
+ * @param load loads the model if it isn't held. It may throw and the next
+ * worker to ask for the model tries again
+ * @return std::shared_ptr<void>
+ */
+std::shared_ptr<void> getModelArtifact(
+  const std::string& key, std::type_index type,
+  const std::function<std::shared_ptr<void>()>& load);
+
+/**
+ * @brief Get a model that's loaded once and shared by all the workers that ask
+ * for it with the same key. Since they share it, workers should only read it
+ * or synchronize their use of it
+ *
+ * @tparam T the type of the artifact
+ * @tparam F a callable that returns a std::shared_ptr<T>
+ * @param key identifies the model and everything its loaded form depends on
+ * @param load loads the model if it isn't held
+ * @return std::shared_ptr<T>
+ */
+template <typename T, typename F>
+std::shared_ptr<T> getModelArtifact(const std::string& key, F&& load) {
+  return std::static_pointer_cast<T>(getModelArtifact(
+    key, typeid(T), [&load]() -> std::shared_ptr<void> {
+      return std::shared_ptr<T>{std::forward<F>(load)()};
+    }));
+}
+
+/**
+ * @brief Make the key of a model artifact from the model's file and the
+ * options that change how it's loaded, such as its precision. Workers start
+ * the options with their name so different workers don't share a key
+ *
+ * @param model the model's file
+ * @param options the options that the loaded model depends on
+ * @return std::string
+ */
+std::string getModelArtifactKey(const std::filesystem::path& model,
+                                const std::string& options);
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_CORE_MODEL_ARTIFACTS
@@ -0,0 +1,92 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the memory budget of the models that are loaded on demand
+ */
+
+#include "amdinfer/core/model_budget.hpp"
+
+#include <algorithm>  // for sort
+#include <utility>    // for move, pair
+
+namespace amdinfer {
+
+ModelBudget::ModelBudget(std::map<std::string, size_t> budgets)
+  : budgets_(std::move(budgets)) {}
+
+std::vector<std::string> ModelBudget::add(const std::string& model,
+                                          const std::string& device,
+                                          size_t bytes) {
+  remove(model);
+  std::vector<std::string> evicted;
+  auto& used = used_[device];
+  const auto budget = budgets_.find(device);
+  if (budget != budgets_.end() && budget->second > 0 &&
+      used + bytes > budget->second) {
+    std::vector<std::pair<uint64_t, std::string>> idle;
+    for (const auto& [name, state] : models_) {
+      if (state.device == device && state.in_flight == 0) {
+        idle.emplace_back(state.last_used, name);
+      }
+    }
+    std::sort(idle.begin(), idle.end());
+    for (const auto& [last_used, name] : idle) {
+      if (used + bytes <= budget->second) {
+        break;
+      }
+      used -= models_.at(name).bytes;
+      models_.erase(name);
+      evicted.push_back(name);
+    }
+  }
+
+  used += bytes;
+  models_[model] = Model{device, bytes, 1, ++clock_};
+  return evicted;
+}
+
+void ModelBudget::remove(const std::string& model) {
+  if (auto iterator = models_.find(model); iterator != models_.end()) {
+    used_[iterator->second.device] -= iterator->second.bytes;
+    models_.erase(iterator);
+  }
+}
+
+bool ModelBudget::contains(const std::string& model) const {
+  return models_.find(model) != models_.end();
+}
+
+void ModelBudget::acquire(const std::string& model) {
+  auto& state = models_.at(model);
+  state.in_flight++;
+  state.last_used = ++clock_;
+}
+
+void ModelBudget::release(const std::string& model) {
+  if (auto iterator = models_.find(model);
+      iterator != models_.end() && iterator->second.in_flight > 0) {
+    iterator->second.in_flight--;
+  }
+}
+
+size_t ModelBudget::used(const std::string& device) const {
+  if (auto iterator = used_.find(device); iterator != used_.end()) {
+    return iterator->second;
+  }
+  return 0;
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,95 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the memory budget of the models that are loaded on demand
+ */
+
+#ifndef GUARD_AMDINFER_CORE_MODEL_BUDGET
+#define GUARD_AMDINFER_CORE_MODEL_BUDGET
+
+#include <cstddef>        // for size_t
+#include <cstdint>        // for uint64_t
+#include <map>            // for map
+#include <string>         // for string
+#include <unordered_map>  // for unordered_map
+#include <vector>         // for vector
+
+namespace amdinfer {
+
+/**
+ * @brief Tracks the memory that models take on each kind of device and picks
+ * the models to unload to make room for another. A model is idle while it has
+ * no requests in flight and idle models are unloaded least recently used
+ * first. Models that are busy are never picked, even if the budget is
+ * exceeded without them.
+ *
+ * It's not safe to use from multiple threads without a lock.
+ */
+class ModelBudget {
+ public:
+  /**
+   * @brief Construct a new ModelBudget object
+   *
+   * @param budgets most bytes that models may take on each kind of device.
+   * Devices that aren't listed, or whose budget is zero, are unlimited
+   */
+  explicit ModelBudget(std::map<std::string, size_t> budgets);
+
+  /**
+   * @brief Add a model that's about to be loaded. It's held as if it had a
+   * request in flight until it's released so it can't be picked while it
+   * loads.
+   *
+   * @param model name of the model
+   * @param device kind of device that the model loads onto
+   * @param bytes memory that the model takes
+   * @return std::vector<std::string> the idle models to unload to make room,
+   * least recently used first. They're removed from the budget already
+   */
+  std::vector<std::string> add(const std::string& model,
+                               const std::string& device, size_t bytes);
+  /// Remove a model that's unloaded or failed to load
+  void remove(const std::string& model);
+  /// Check if a model is in the budget
+  [[nodiscard]] bool contains(const std::string& model) const;
+
+  /// Record that a request to a model started, which makes it the most
+  /// recently used. The model must be in the budget
+  void acquire(const std::string& model);
+  /// Record that a request to a model finished. Unknown models are ignored
+  void release(const std::string& model);
+
+  /// Get the bytes that models take on a kind of device
+  [[nodiscard]] size_t used(const std::string& device) const;
+
+ private:
+  struct Model {
+    std::string device;
+    size_t bytes;
+    size_t in_flight;
+    uint64_t last_used;
+  };
+
+  std::map<std::string, size_t> budgets_;
+  std::map<std::string, size_t> used_;
+  std::unordered_map<std::string, Model> models_;
+  /// increases with each use to order the models by when they were used
+  uint64_t clock_ = 0;
+};
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_CORE_MODEL_BUDGET
@@ -38,9 +38,8 @@ void ModelMetadata::addInputTensor(const std::string &name,
 
 void ModelMetadata::addInputTensor(const std::string &name,
                                    std::vector<int> shape, DataType datatype) {
-  std::vector<uint64_t> new_shape;
-  std::copy(shape.begin(), shape.end(), std::back_inserter(new_shape));
-  this->inputs_.emplace_back(name, new_shape, datatype);
+  this->inputs_.emplace_back(name, Shape(shape.begin(), shape.end()),
+                             datatype);
 }
 
 void ModelMetadata::addInputTensor(const Tensor &tensor) {
@@ -56,9 +55,8 @@ void ModelMetadata::addOutputTensor(const std::string &name,
 
 void ModelMetadata::addOutputTensor(const std::string &name,
                                     std::vector<int> shape, DataType datatype) {
-  std::vector<uint64_t> new_shape;
-  std::copy(shape.begin(), shape.end(), std::back_inserter(new_shape));
-  this->outputs_.emplace_back(name, new_shape, datatype);
+  this->outputs_.emplace_back(name, Shape(shape.begin(), shape.end()),
+                              datatype);
 }
 
 void ModelMetadata::addOutputTensor(const Tensor &tensor) {
@@ -77,6 +75,14 @@ const std::string &ModelMetadata::getPlatform() const {
   return this->platform_;
 }
 
+void ModelMetadata::setParameters(const ParameterMap &parameters) {
+  this->parameters_ = parameters;
+}
+
+const ParameterMap &ModelMetadata::getParameters() const {
+  return this->parameters_;
+}
+
 const std::vector<ModelMetadataTensor> &ModelMetadata::getInputs() const {
   return this->inputs_;
 }
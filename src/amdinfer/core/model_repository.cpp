@@ -20,14 +20,34 @@
 #include <google/protobuf/repeated_ptr_field.h>        // for RepeatedPtrField
 #include <google/protobuf/text_format.h>               // for TextFormat
 
-#include <chrono>      // for milliseconds
-#include <filesystem>  // for path, operator/
-#include <thread>      // for sleep_for
+#include <algorithm>     // for find, sort, min, max
+#include <cstdint>       // for uintmax_t
+#include <chrono>        // for milliseconds, steady_clock
+#include <exception>     // for exception
+#include <filesystem>    // for path, operator/, rename
+#include <fstream>       // for ofstream
+#include <mutex>         // for lock_guard, unique_lock
+#include <string>        // for string, to_string
+#include <system_error>  // for error_code
+#include <thread>        // for thread
+#include <type_traits>   // for decay_t, is_same_v
+#include <utility>       // for move
+#include <variant>       // for visit
+#include <vector>        // for vector
 
+#include "amdinfer/build_options.hpp"        // for AMDINFER_ENABLE_HTTP
+#include "amdinfer/core/data_types.hpp"      // for DataType
 #include "amdinfer/core/endpoints.hpp"       // for Endpoints
+#include "amdinfer/core/ensemble.hpp"        // for EnsembleConfig
 #include "amdinfer/core/exceptions.hpp"      // for runtime_error
+#include "amdinfer/core/model_metadata.hpp"  // for ModelMetadata
+#include "amdinfer/core/model_versions.hpp"  // for sortVersions
+#include "amdinfer/core/object_store.hpp"    // for makeObjectStore
 #include "amdinfer/core/parameters.hpp"      // for ParameterMap
 #include "amdinfer/observation/logging.hpp"  // for AMDINFER_LOG_D...
+#include "amdinfer/observation/metrics.hpp"  // for Metrics
+#include "amdinfer/util/model_cache.hpp"     // for getModelCacheDirectory
+#include "amdinfer/util/timer.hpp"           // for Timer
 #include "model_config.pb.h"                 // for Config, InferP...
 
 namespace fs = std::filesystem;
@@ -67,24 +87,31 @@ void mapProtoToParameters2(
   }
 }
 
-void parseModel(const fs::path& repository, const std::string& model,
-                ParameterMap* parameters) {
+namespace {
+
+/**
+ * @brief Read a model's config file from the repository
+ *
+ * @param repository path to the repository
+ * @param model name of the model
+ * @param model_path set to the directory of the model
+ * @return inference::Config
+ */
+inference::Config readConfig(const fs::path& repository,
+                             const std::string& model, fs::path* model_path) {
   const fs::path config_file = "config.pbtxt";
 
-  auto model_path = repository / model;
-  auto config_path = model_path / config_file;
+  *model_path = repository / model;
+  auto config_path = *model_path / config_file;
 
   // KServe can sometimes create directories like model/model/config_file
   // so if model/config_file doesn't exist, try searching a directory lower too
   if (!fs::exists(config_path) &&
-      fs::exists(model_path / model / config_file)) {
-    model_path /= model;
-    config_path = model_path / config_file;
+      fs::exists(*model_path / model / config_file)) {
+    *model_path /= model;
+    config_path = *model_path / config_file;
   }
 
-  // TODO(varunsh): support other versions than 1/
-  const std::string model_base = model_path / "1/saved_model";
-
   inference::Config config;
 
   // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg, hicpp-vararg)
@@ -102,6 +129,91 @@ void parseModel(const fs::path& repository, const std::string& model,
     throw file_read_error("Config file " + config_path.string() +
                           " could not be parsed");
   }
+  return config;
+}
+
+/**
+ * @brief Get the target that an ONNX model is compiled for by MIGraphX. The
+ * config's target parameter picks one explicitly. Otherwise, it's the GPU if
+ * the host has one that ROCm can use and the CPU if not.
+ *
+ * @param config the model's config
+ * @return std::string gpu or cpu
+ */
+std::string getOnnxTarget(const inference::Config& config) {
+  const auto& parameters = config.parameters();
+  if (auto iterator = parameters.find("target");
+      iterator != parameters.end() && iterator->second.has_string_param()) {
+    return iterator->second.string_param();
+  }
+  // the ROCm kernel driver's device is only there if there's a GPU to use
+  std::error_code error;
+  return fs::exists("/dev/kfd", error) ? "gpu" : "cpu";
+}
+
+/**
+ * @brief Get the versions of a model to load, oldest first. They're the ones
+ * listed in its config or, if there are none, the numbered directories of the
+ * model. If there are none of either, it's version 1.
+ *
+ * @param config the model's config
+ * @param model_path the directory of the model
+ * @return std::vector<std::string>
+ */
+std::vector<std::string> getVersions(const inference::Config& config,
+                                     const fs::path& model_path) {
+  std::vector<std::string> versions{config.versions().begin(),
+                                    config.versions().end()};
+  if (versions.empty()) {
+    std::error_code error;
+    for (fs::directory_iterator iterator{model_path, error};
+         !error && iterator != fs::directory_iterator();
+         iterator.increment(error)) {
+      auto name = iterator->path().filename().string();
+      if (iterator->is_directory(error) && isNumericVersion(name)) {
+        versions.push_back(std::move(name));
+      }
+    }
+  }
+  if (versions.empty()) {
+    versions.emplace_back("1");
+  }
+
+  sortVersions(&versions);
+  return versions;
+}
+
+/// Map a model's batching options to the batcher's load parameters
+void parseDynamicBatching(const inference::Config::DynamicBatching& batching,
+                          ParameterMap* parameters) {
+  if (batching.max_batch_size() > 0) {
+    parameters->put("batch_size", static_cast<int>(batching.max_batch_size()));
+  }
+  if (batching.preferred_batch_size_size() > 0) {
+    std::string sizes;
+    for (const auto& size : batching.preferred_batch_size()) {
+      sizes += (sizes.empty() ? "" : ",") + std::to_string(size);
+    }
+    parameters->put("preferred_batch_sizes", sizes);
+  }
+  // as in Triton, batches don't wait for more requests if there's no delay
+  parameters->put("timeout_us",
+                  static_cast<int>(batching.max_queue_delay_microseconds()));
+  if (batching.max_queue_size() > 0) {
+    parameters->put("max_queue_size",
+                    static_cast<int>(batching.max_queue_size()));
+  }
+  if (batching.has_priority()) {
+    parameters->put("starvation_limit",
+                    static_cast<int>(batching.priority().starvation_limit()));
+  }
+}
+
+/// Map the config of a version of a model that's run by a worker to its load
+/// parameters
+void parseConfig(const inference::Config& config, const fs::path& model_path,
+                 const std::string& version, ParameterMap* parameters) {
+  const std::string model_base = model_path / version / "saved_model";
 
   if (config.platform() == "tensorflow_graphdef") {
     const auto& inputs = config.inputs();
@@ -132,6 +244,7 @@ void parseModel(const fs::path& repository, const std::string& model,
   } else if (config.platform() == "onnx_onnxv1") {
     parameters->put("worker", "migraphx");
     parameters->put("model", model_base + ".onnx");
+    parameters->put("target", getOnnxTarget(config));
   } else if (config.platform() == "migraphx_mxr") {
     parameters->put("worker", "migraphx");
     parameters->put("model", model_base + ".mxr");
@@ -142,27 +255,392 @@ void parseModel(const fs::path& repository, const std::string& model,
     throw invalid_argument("Unknown platform: " + config.platform());
   }
 
+  // the workers take one layout for all of their image inputs
+  for (const auto& input : config.inputs()) {
+    if (!input.layout().empty()) {
+      parameters->put("input_layout", input.layout());
+    }
+  }
+  if (config.has_dynamic_batching()) {
+    parseDynamicBatching(config.dynamic_batching(), parameters);
+  }
   mapProtoToParameters2(config.parameters(), parameters);
+  if (config.instances() > 0) {
+    parameters->put("instances", static_cast<int>(config.instances()));
+  }
+}
+
+/// Map the config of an ensemble to its definition
+EnsembleConfig parseEnsemble(const inference::Config& config,
+                             const std::string& model) {
+  EnsembleConfig ensemble{ModelMetadata{model, config.platform()}, {}};
+  for (const auto& input : config.inputs()) {
+    ensemble.metadata.addInputTensor(
+      input.name(),
+      std::vector<int>(input.shape().begin(), input.shape().end()),
+      DataType(input.datatype().c_str()));
+  }
+  for (const auto& output : config.outputs()) {
+    ensemble.metadata.addOutputTensor(
+      output.name(),
+      std::vector<int>(output.shape().begin(), output.shape().end()),
+      DataType(output.datatype().c_str()));
+  }
+  for (const auto& step : config.steps()) {
+    ensemble.steps.push_back(
+      {step.model_name(),
+       std::vector<std::string>(step.inputs().begin(), step.inputs().end()),
+       std::vector<std::string>(step.outputs().begin(), step.outputs().end())});
+  }
+  return ensemble;
+}
+
+/**
+ * @brief Load the versions of a model that's run by a worker and route the
+ * model's requests to its latest version. If the model is already serving,
+ * the new versions are loaded and warmed up before the model's alias is
+ * swapped to them so no request waits on them. Then the versions that
+ * aren't in the config anymore are unloaded once they've run the requests
+ * that were queued for them.
+ *
+ * @param config the model's config
+ * @param model_path the directory of the model
+ * @param model name of the model
+ * @param parameters load-time parameters
+ * @param endpoints the endpoints to load the model into
+ */
+void loadVersions(const inference::Config& config, const fs::path& model_path,
+                  const std::string& model, const ParameterMap& parameters,
+                  Endpoints* endpoints) {
+  const bool swap = endpoints->exists(model);
+  std::vector<std::string> loaded;
+  for (const auto& version : getVersions(config, model_path)) {
+    auto updated_parameters = parameters;
+    parseConfig(config, model_path, version, &updated_parameters);
+    // the parameters given at load time take precedence over the config's
+    for (const auto& [key, value] : parameters) {
+      std::visit([&updated_parameters, &key = key](
+                   const auto& data) { updated_parameters.put(key, data); },
+                 value);
+    }
+    if (swap) {
+      // the alias can only move to versions that are ready
+      updated_parameters.erase("async");
+      if (!updated_parameters.has("warmup")) {
+        updated_parameters.put("warmup", 1);
+      }
+    }
+    loaded.push_back(
+      endpoints->load(versionEndpoint(model, version), updated_parameters));
+  }
+  endpoints->setAlias(model, loaded.back());
+
+  const auto prefix = model + "/";
+  for (const auto& endpoint : endpoints->list()) {
+    if (endpoint.compare(0, prefix.size(), prefix) == 0 &&
+        std::find(loaded.begin(), loaded.end(), endpoint) == loaded.end()) {
+      endpoints->unload(endpoint);
+    }
+  }
+}
+
+/**
+ * @brief Load a model and, if it's an ensemble, the models it runs
+ *
+ * @param repository path to the repository
+ * @param model name of the model
+ * @param parameters load-time parameters
+ * @param endpoints the endpoints to load the model into
+ * @param ensembles the ensembles being loaded that include this model
+ */
+void loadModel(const fs::path& repository, const std::string& model,
+               const ParameterMap& parameters, Endpoints* endpoints,
+               std::vector<std::string>* ensembles) {
+  fs::path model_path;
+  auto config = readConfig(repository, model, &model_path);
+  if (config.platform() != "ensemble") {
+    loadVersions(config, model_path, model, parameters, endpoints);
+    return;
+  }
+
+  if (std::find(ensembles->begin(), ensembles->end(), model) !=
+      ensembles->end()) {
+    throw invalid_argument("Ensemble " + model + " includes itself");
+  }
+  ensembles->push_back(model);
+  for (const auto& step : config.steps()) {
+    if (!endpoints->exists(step.model_name())) {
+      loadModel(repository, step.model_name(), ParameterMap{}, endpoints,
+                ensembles);
+    }
+  }
+  ensembles->pop_back();
+  endpoints->loadEnsemble(parseEnsemble(config, model));
+}
+
+/// Make the store that a remote repository is read from
+std::unique_ptr<ObjectStore> makeRemoteStore(const std::string& url,
+                                             size_t connections) {
+#ifdef AMDINFER_ENABLE_HTTP
+  return makeObjectStore(url, connections);
+#else
+  (void)connections;
+  throw invalid_argument("The repository " + url +
+                         " is remote, which needs HTTP to be enabled");
+#endif
+}
+
+/// Load or unload a model to match its config in the repository
+void applyChange(const fs::path& repository, const std::string& model,
+                 Endpoints* endpoints) {
+  AMDINFER_IF_LOGGING(Logger logger{Loggers::Server};)
+  // changing the config of a loaded model swaps it to the new versions
+  // without unloading it first so its requests keep being served
+  if (fs::exists(repository / model / "config.pbtxt")) {
+    try {
+      loadModel(repository, model, ParameterMap{}, endpoints);
+      AMDINFER_LOG_INFO(logger, "Loaded " + model + " from the repository");
+    } catch (const std::exception& e) {
+      AMDINFER_LOG_WARN(logger, "Error loading " + model + ": " + e.what());
+    }
+  } else if (endpoints->exists(model)) {
+    endpoints->unload(model);
+  }
+}
+
+}  // namespace
+
+std::string versionEndpoint(const std::string& model,
+                            const std::string& version) {
+  return model + "/" + version;
+}
+
+void parseModel(const fs::path& repository, const std::string& model,
+                ParameterMap* parameters) {
+  fs::path model_path;
+  auto config = readConfig(repository, model, &model_path);
+  parseConfig(config, model_path, getVersions(config, model_path).back(),
+              parameters);
+}
+
+void loadModel(const fs::path& repository, const std::string& model,
+               const ParameterMap& parameters, Endpoints* endpoints) {
+  std::vector<std::string> ensembles;
+  loadModel(repository, model, parameters, endpoints, &ensembles);
+}
+
+ModelRepository::~ModelRepository() {
+  // stop the events before the listener that handles them is destroyed
+  file_watcher_.reset();
+  stopLoading();
+}
+
+void ModelRepository::stopLoading() {
+  if (scheduler_ != nullptr) {
+    scheduler_->stop();
+  }
+  // loads that are waiting for their files stop waiting
+  if (remote_ != nullptr) {
+    remote_->stop();
+  }
+  if (loader_.joinable()) {
+    loader_.join();
+  }
+}
+
+std::string getModelDevice(const fs::path& repository,
+                           const std::string& model) {
+  fs::path model_path;
+  try {
+    const auto config = readConfig(repository, model, &model_path);
+    const auto& platform = config.platform();
+    if (platform == "ensemble") {
+      return "";
+    }
+    if (platform == "onnx_onnxv1") {
+      return getOnnxTarget(config);
+    }
+    if (platform == "migraphx_mxr") {
+      return "gpu";
+    }
+    if (platform == "vitis_xmodel") {
+      return "dpu";
+    }
+    return "cpu";
+  } catch (const runtime_error&) {
+    return "";
+  }
+}
+
+size_t getModelSize(const fs::path& repository, const std::string& model) {
+  size_t bytes = 0;
+  std::error_code error;
+  for (fs::recursive_directory_iterator iterator{repository / model, error};
+       !error && iterator != fs::recursive_directory_iterator();
+       iterator.increment(error)) {
+    if (iterator->is_regular_file(error)) {
+      bytes += iterator->file_size(error);
+    }
+  }
+  return bytes;
+}
+
+void saveModelParameters(const fs::path& repository, const std::string& model,
+                         const ParameterMap& parameters) {
+  fs::path model_path;
+  auto config = readConfig(repository, model, &model_path);
+  auto* batching =
+    config.has_dynamic_batching() ? config.mutable_dynamic_batching() : nullptr;
+  for (const auto& [key, value] : parameters) {
+    const auto* integer = std::get_if<int32_t>(&value);
+    if (integer != nullptr && key == "instances") {
+      config.set_instances(*integer);
+    } else if (integer != nullptr && batching != nullptr &&
+               key == "batch_size") {
+      batching->set_max_batch_size(*integer);
+    } else if (integer != nullptr && batching != nullptr &&
+               key == "timeout_us") {
+      batching->set_max_queue_delay_microseconds(*integer);
+    } else {
+      auto& parameter = (*config.mutable_parameters())[key];
+      std::visit(
+        [&parameter](const auto& data) {
+          using T = std::decay_t<decltype(data)>;
+          if constexpr (std::is_same_v<T, bool>) {
+            parameter.set_bool_param(data);
+          } else if constexpr (std::is_same_v<T, int32_t>) {
+            parameter.set_int64_param(data);
+          } else if constexpr (std::is_same_v<T, double>) {
+            parameter.set_double_param(data);
+          } else {
+            parameter.set_string_param(data);
+          }
+        },
+        value);
+    }
+  }
+
+  std::string text;
+  if (!google::protobuf::TextFormat::PrintToString(config, &text)) {
+    throw runtime_error("The config of " + model + " could not be printed");
+  }
+  const auto config_path = model_path / "config.pbtxt";
+  auto temporary = config_path;
+  temporary += ".tmp";
+  {
+    std::ofstream file{temporary};
+    file << text;
+    if (!file) {
+      throw file_read_error("Config file " + temporary.string() +
+                            " could not be written");
+    }
+  }
+  std::error_code error;
+  fs::rename(temporary, config_path, error);
+  if (error) {
+    throw file_read_error("Config file " + config_path.string() +
+                          " could not be replaced: " + error.message());
+  }
 }
 
 void ModelRepository::setRepository(const fs::path& repository_path,
-                                    bool load_existing) {
+                                    bool load_existing,
+                                    const LoadLimits& limits,
+                                    const RemoteOptions& remote) {
+  stopLoading();
+  remote_.reset();
   repository_ = repository_path;
-  if (fs::exists(repository_path) && load_existing) {
-    AMDINFER_IF_LOGGING(Logger logger{Loggers::Server};)
+  load_threads_ = limits.threads;
+
+  std::vector<std::string> models;
+  if (const auto url = repository_path.string(); isRemoteRepository(url)) {
+    auto options = remote;
+    if (options.cache.empty()) {
+      const auto cache = util::getModelCacheDirectory();
+      options.cache = cache.empty() ? cache : cache / "remote";
+    }
+    remote_ = std::make_unique<RemoteRepository>(
+      makeRemoteStore(url, options.threads), options);
+    repository_ = remote_->start();
+    if (load_existing) {
+      models = remote_->models();
+    }
+  } else if (fs::exists(repository_path) && load_existing) {
     for (const auto& path : fs::directory_iterator(repository_)) {
       if (path.is_directory()) {
-        auto model = path.path().filename();
-        try {
-          ParameterMap params;
-          endpoints_->load(model, params);
-        } catch (const amdinfer::runtime_error& e) {
-          AMDINFER_LOG_INFO(
-            logger, "Error loading " + model.string() + ": " + e.what());
-        }
+        models.push_back(path.path().filename());
       }
     }
   }
+  {
+    std::lock_guard lock{mutex_};
+    progress_ = {models.size(), 0, 0};
+  }
+  if (models.empty()) {
+    return;
+  }
+
+  std::vector<Load> loads;
+  loads.reserve(models.size());
+  for (const auto& model : models) {
+    loads.push_back({getModelDevice(repository_, model),
+                     [this, model]() { loadExisting(model); }});
+  }
+
+  // load in the background so the servers can start and report the progress
+  scheduler_ = std::make_unique<LoadScheduler>(limits);
+  loader_ = std::thread{[this, loads = std::move(loads)]() mutable {
+    util::Timer timer{true};
+    scheduler_->run(std::move(loads));
+    timer.stop();
+
+    [[maybe_unused]] const auto seconds = timer.count();
+    AMDINFER_IF_LOGGING(Logger logger{Loggers::Server};)
+    AMDINFER_LOG_INFO(logger, "Starting the server: models took " +
+                                std::to_string(seconds) + " s");
+#ifdef AMDINFER_ENABLE_METRICS
+    Metrics::getInstance().setStartupTime("models", seconds);
+#endif
+  }};
+}
+
+void ModelRepository::loadExisting(const std::string& model) {
+  AMDINFER_IF_LOGGING(Logger logger{Loggers::Server};)
+  if (remote_ != nullptr && !remote_->waitForModel(model)) {
+    AMDINFER_LOG_WARN(logger, "Error downloading " + model);
+    std::lock_guard lock{mutex_};
+    progress_.failed++;
+    return;
+  }
+  try {
+    loadModel(repository_, model, ParameterMap{}, endpoints_);
+  } catch (const std::exception& e) {
+    AMDINFER_LOG_WARN(logger, "Error loading " + model + ": " + e.what());
+    std::lock_guard lock{mutex_};
+    progress_.failed++;
+    return;
+  }
+
+  std::lock_guard lock{mutex_};
+  progress_.loaded++;
+  AMDINFER_LOG_INFO(logger, "Loaded " + model + " from the repository (" +
+                              std::to_string(progress_.loaded) + "/" +
+                              std::to_string(progress_.models) + ")");
+}
+
+void ModelRepository::expect() {
+  std::lock_guard lock{mutex_};
+  progress_.pending = true;
+}
+
+RepositoryProgress ModelRepository::getProgress() const {
+  std::lock_guard lock{mutex_};
+  return progress_;
+}
+
+bool ModelRepository::ready() const {
+  const auto progress = getProgress();
+  return progress.done() && progress.failed == 0;
 }
 
 std::string ModelRepository::getRepository() const {
@@ -171,62 +649,16 @@ std::string ModelRepository::getRepository() const {
 
 void ModelRepository::enableMonitoring(bool use_polling) {
   file_watcher_ = std::make_unique<efsw::FileWatcher>(use_polling);
-  listener_ =
-    std::make_unique<amdinfer::UpdateListener>(repository_, endpoints_);
+  listener_ = std::make_unique<amdinfer::UpdateListener>(
+    repository_,
+    [repository = repository_, endpoints = endpoints_](
+      const std::string& model) { applyChange(repository, model, endpoints); },
+    load_threads_);
 
   file_watcher_->addWatch(repository_.string(), listener_.get(), true);
   file_watcher_->watch();
 }
 
-void UpdateListener::handleFileAction(
-  [[maybe_unused]] efsw::WatchID watch_id, const std::string& dir,
-  const std::string& filename, efsw::Action action,
-  [[maybe_unused]] std::string old_filename) {
-  AMDINFER_IF_LOGGING(Logger logger{Loggers::Server};)
-  // arbitrary delay to make sure filesystem has settled
-  const std::chrono::milliseconds delay{100};
-  if (filename == "config.pbtxt") {
-    if (action == efsw::Actions::Add) {
-      std::this_thread::sleep_for(delay);
-      auto model = fs::path(dir).parent_path().filename();
-      ParameterMap params;
-      try {
-        parseModel(repository_, model, &params);
-        endpoints_->load(model, params);
-      } catch (const runtime_error&) {
-        AMDINFER_LOG_INFO(logger, "Error loading " + model.string());
-      }
-    } else if (action == efsw::Actions::Delete) {
-      // arbitrary delay to make sure filesystem has settled
-      std::this_thread::sleep_for(delay);
-      auto model = fs::path(dir).parent_path().filename();
-      endpoints_->unload(model.string());
-    }
-  }
-
-  switch (action) {
-    case efsw::Actions::Add:
-      AMDINFER_LOG_DEBUG(
-        logger, "DIR (" + dir + ") FILE (" + filename + ") has event Added");
-      break;
-    case efsw::Actions::Delete:
-      AMDINFER_LOG_DEBUG(
-        logger, "DIR (" + dir + ") FILE (" + filename + ") has event Delete");
-      break;
-    case efsw::Actions::Modified:
-      AMDINFER_LOG_DEBUG(
-        logger, "DIR (" + dir + ") FILE (" + filename + ") has event Modified");
-      break;
-    case efsw::Actions::Moved:
-      AMDINFER_LOG_DEBUG(logger, "DIR (" + dir + ") FILE (" + filename +
-                                   ") has event Moved from (" + old_filename +
-                                   ")");
-      break;
-    default:
-      AMDINFER_LOG_ERROR(logger, "Should never happen");
-  }
-}
-
 void ModelRepository::setEndpoints(Endpoints* endpoints) {
   endpoints_ = endpoints;
 }
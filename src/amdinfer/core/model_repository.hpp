@@ -16,43 +16,165 @@
 #ifndef GUARD_AMDINFER_CORE_MODEL_REPOSITORY
 #define GUARD_AMDINFER_CORE_MODEL_REPOSITORY
 
-#include <efsw/efsw.hpp>  // for FileWatcher, Action, FileWatchListener, Wat...
+#include <efsw/efsw.hpp>  // for FileWatcher
+#include <cstddef>        // for size_t
 #include <filesystem>     // for path
 #include <memory>         // for unique_ptr
+#include <mutex>          // for mutex
 #include <string>         // for string
+#include <thread>         // for thread
+
+#include "amdinfer/core/load_scheduler.hpp"     // for LoadLimits, LoadScheduler
+#include "amdinfer/core/remote_repository.hpp"  // for RemoteOptions, Remote...
+#include "amdinfer/core/update_listener.hpp"    // for UpdateListener
 
 namespace amdinfer {
 
 class Endpoints;
 class ParameterMap;
 
-class UpdateListener : public efsw::FileWatchListener {
- public:
-  UpdateListener(const std::filesystem::path& repository, Endpoints* endpoints)
-    : repository_(repository), endpoints_(endpoints) {}
-  void handleFileAction(efsw::WatchID watch_id, const std::string& dir,
-                        const std::string& filename, efsw::Action action,
-                        std::string old_filename) override;
-
- private:
-  std::filesystem::path repository_;
-  Endpoints* endpoints_;
-};
+/**
+ * @brief Get the endpoint of a version of a model. Requests to the model are
+ * routed to the endpoint of its latest version
+ *
+ * @param model name of the model
+ * @param version the version, which is the name of its directory in the model
+ * @return std::string model/version
+ */
+std::string versionEndpoint(const std::string& model,
+                            const std::string& version);
 
 void parseModel(const std::filesystem::path& repository,
                 const std::string& model, ParameterMap* parameters);
 
+/**
+ * @brief Load a model from the repository. If it's an ensemble, the models it
+ * runs that aren't loaded yet are loaded from the repository first. Otherwise,
+ * each of its versions is loaded as model/version and the model is an alias of
+ * the latest one. Loading a model that's loaded already swaps it to the
+ * versions in its current config without interrupting its requests.
+ *
+ * @param repository path to the repository
+ * @param model name of the model
+ * @param parameters load-time parameters
+ * @param endpoints the endpoints to load the model into
+ */
+void loadModel(const std::filesystem::path& repository,
+               const std::string& model, const ParameterMap& parameters,
+               Endpoints* endpoints);
+
+/// The progress of loading the models that were in the repository when it
+/// was set
+struct RepositoryProgress {
+  size_t models = 0;
+  size_t loaded = 0;
+  size_t failed = 0;
+  /// set if the repository is expected but it hasn't been scanned yet
+  bool pending = false;
+
+  /// Check if every model has been loaded or has failed to load
+  [[nodiscard]] bool done() const {
+    return !pending && loaded + failed == models;
+  }
+};
+
+/**
+ * @brief Get the kind of device that a model in the repository loads onto
+ * from its platform: cpu, gpu or dpu. The models of an ensemble are loaded on
+ * their own devices so ensembles, and models whose config can't be read, have
+ * none.
+ *
+ * @param repository path to the repository
+ * @param model name of the model
+ * @return std::string
+ */
+std::string getModelDevice(const std::filesystem::path& repository,
+                           const std::string& model);
+
+/**
+ * @brief Get the size of a model's files in the repository. It estimates the
+ * memory that the model takes once it's loaded
+ *
+ * @param repository path to the repository
+ * @param model name of the model
+ * @return size_t
+ */
+size_t getModelSize(const std::filesystem::path& repository,
+                    const std::string& model);
+
+/**
+ * @brief Save parameters into a model's config in the repository so they're
+ * used the next time it's loaded. The instances and, if the config has dynamic
+ * batching, the batch size and timeout are saved in their fields and the rest
+ * as parameters. The config is replaced whole so a monitored repository only
+ * sees the new one
+ *
+ * @param repository path to the repository
+ * @param model name of the model
+ * @param parameters the parameters to save over those in the config
+ */
+void saveModelParameters(const std::filesystem::path& repository,
+                         const std::string& model,
+                         const ParameterMap& parameters);
+
 class ModelRepository {
  public:
+  ModelRepository() = default;
+  ModelRepository(const ModelRepository&) = delete;
+  ModelRepository& operator=(const ModelRepository&) = delete;
+  ModelRepository(ModelRepository&&) = delete;
+  ModelRepository& operator=(ModelRepository&&) = delete;
+  /// Destructor. Loads that haven't started are skipped
+  ~ModelRepository();
+
+  /**
+   * @brief Set the path to the repository. If existing models are loaded,
+   * they're loaded in parallel in the background up to the limits and the
+   * progress of the loads can be checked with getProgress()
+   *
+   * If the repository is a URL, such as s3://bucket/models, it's mirrored in
+   * a local cache. Its models are downloaded in the background and each of
+   * the existing models is loaded as soon as its files are downloaded. It
+   * throws if the repository can't be listed.
+   *
+   * @param repository_path path or URL of the repository
+   * @param load_existing load the models that are in the repository already
+   * @param limits how many models to load at once. The devices are the kinds
+   * of devices that the models' platforms run on: cpu, gpu or dpu
+   * @param remote how to download a remote repository. If there's no cache,
+   * it's in the remote directory of the model cache
+   */
   void setRepository(const std::filesystem::path& repository_path,
-                     bool load_existing);
+                     bool load_existing, const LoadLimits& limits = {},
+                     const RemoteOptions& remote = {});
+  /// Get the path to the repository, which is the local mirror if it's remote
   std::string getRepository() const;
   void setEndpoints(Endpoints* endpoints);
   void enableMonitoring(bool use_polling);
+  /**
+   * @brief Mark the repository as not ready until setRepository() has scanned
+   * it, for servers that start listening before they set the repository
+   */
+  void expect();
+
+  /// Get the progress of loading the existing models
+  RepositoryProgress getProgress() const;
+  /// Check if the existing models have all loaded without errors
+  bool ready() const;
 
  private:
+  void stopLoading();
+  /// Load one of the existing models and record its progress
+  void loadExisting(const std::string& model);
+
   std::filesystem::path repository_;
-  Endpoints* endpoints_;
+  Endpoints* endpoints_ = nullptr;
+  size_t load_threads_ = 1;
+  mutable std::mutex mutex_;
+  RepositoryProgress progress_;
+  std::unique_ptr<LoadScheduler> scheduler_;
+  std::unique_ptr<RemoteRepository> remote_;
+  std::thread loader_;
   std::unique_ptr<efsw::FileWatcher> file_watcher_;
   std::unique_ptr<UpdateListener> listener_;
 };
@@ -0,0 +1,89 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the order of model versions and the aliases that route
+ * models to their latest version
+ */
+
+#include "amdinfer/core/model_versions.hpp"
+
+#include <algorithm>  // for all_of, min, sort, unique
+#include <cctype>     // for isdigit
+#include <utility>    // for move
+
+namespace amdinfer {
+
+bool isNumericVersion(const std::string& version) {
+  return !version.empty() &&
+         std::all_of(version.begin(), version.end(),
+                     [](unsigned char c) { return std::isdigit(c) != 0; });
+}
+
+bool isOlderVersion(const std::string& a, const std::string& b) {
+  if (!isNumericVersion(a) || !isNumericVersion(b)) {
+    return a < b;
+  }
+  // without leading zeros, numbers with fewer digits are smaller
+  const auto a_start = std::min(a.find_first_not_of('0'), a.size());
+  const auto b_start = std::min(b.find_first_not_of('0'), b.size());
+  const auto a_digits = a.size() - a_start;
+  const auto b_digits = b.size() - b_start;
+  if (a_digits != b_digits) {
+    return a_digits < b_digits;
+  }
+  return a.compare(a_start, a_digits, b, b_start, b_digits) < 0;
+}
+
+void sortVersions(std::vector<std::string>* versions) {
+  std::sort(versions->begin(), versions->end(), isOlderVersion);
+  versions->erase(std::unique(versions->begin(), versions->end()),
+                  versions->end());
+}
+
+Aliases::Aliases() : table_(std::make_shared<const AliasTable>()) {}
+
+void Aliases::set(const std::string& name, const std::string& endpoint) {
+  std::lock_guard lock{mutex_};
+  auto table = *(std::atomic_load(&table_));
+  table.insert_or_assign(name, endpoint);
+  std::atomic_store(&table_,
+                    std::make_shared<const AliasTable>(std::move(table)));
+}
+
+bool Aliases::erase(const std::string& name) {
+  std::lock_guard lock{mutex_};
+  auto table = *(std::atomic_load(&table_));
+  if (table.erase(name) == 0) {
+    return false;
+  }
+  std::atomic_store(&table_,
+                    std::make_shared<const AliasTable>(std::move(table)));
+  return true;
+}
+
+std::string Aliases::resolve(const std::string& name) const {
+  auto table = std::atomic_load(&table_);
+  if (auto iterator = table->find(name); iterator != table->end()) {
+    return iterator->second;
+  }
+  return name;
+}
+
+std::shared_ptr<const AliasTable> Aliases::snapshot() const {
+  return std::atomic_load(&table_);
+}
+
+}  // namespace amdinfer
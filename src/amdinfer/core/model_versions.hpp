@@ -0,0 +1,84 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the order of model versions and the aliases that route
+ * models to their latest version
+ */
+
+#ifndef GUARD_AMDINFER_CORE_MODEL_VERSIONS
+#define GUARD_AMDINFER_CORE_MODEL_VERSIONS
+
+#include <memory>         // for shared_ptr
+#include <mutex>          // for mutex
+#include <string>         // for string
+#include <unordered_map>  // for unordered_map
+#include <vector>         // for vector
+
+namespace amdinfer {
+
+/// Check if a version is a number, which orders it by its value
+bool isNumericVersion(const std::string& version);
+
+/**
+ * @brief Check if a version is older than another. Versions that are both
+ * numbers are ordered by their value, ignoring leading zeros, so 9 is older
+ * than 10. Otherwise, they're ordered as strings.
+ *
+ * @param a a version
+ * @param b another version
+ * @return bool true if a is older than b
+ */
+bool isOlderVersion(const std::string& a, const std::string& b);
+
+/**
+ * @brief Sort versions oldest first and remove the duplicates
+ *
+ * @param versions the versions to sort
+ */
+void sortVersions(std::vector<std::string>* versions);
+
+/// name -> endpoint
+using AliasTable = std::unordered_map<std::string, std::string>;
+
+/**
+ * @brief Routes names to endpoints, such as a model to the endpoint of its
+ * current version. Readers take a snapshot of the table with an atomic load
+ * and never wait. Changes publish a modified copy with an atomic store so
+ * each lookup sees either the old table or the new one.
+ */
+class Aliases {
+ public:
+  Aliases();
+
+  /// Route a name to an endpoint, replacing its old endpoint atomically
+  void set(const std::string& name, const std::string& endpoint);
+  /// Remove an alias. Returns false if the name isn't an alias
+  bool erase(const std::string& name);
+  /// Get the endpoint that a name routes to, which is itself if it's not an
+  /// alias
+  [[nodiscard]] std::string resolve(const std::string& name) const;
+  /// Get the current table of aliases
+  [[nodiscard]] std::shared_ptr<const AliasTable> snapshot() const;
+
+ private:
+  std::shared_ptr<const AliasTable> table_;
+  /// Held while the table is changed so concurrent changes aren't lost
+  std::mutex mutex_;
+};
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_CORE_MODEL_VERSIONS
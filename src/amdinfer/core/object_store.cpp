@@ -0,0 +1,325 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the stores that remote model repositories are read from
+ */
+
+#include "amdinfer/core/object_store.hpp"
+
+#include <drogon/HttpClient.h>            // for HttpClient, HttpClientPtr
+#include <drogon/HttpRequest.h>           // for HttpRequest, HttpRequestPtr
+#include <drogon/HttpResponse.h>          // for HttpResponsePtr
+#include <json/reader.h>                  // for CharReaderBuilder, CharReader
+#include <json/value.h>                   // for Value
+#include <trantor/net/EventLoopThread.h>  // for EventLoopThread
+
+#include <algorithm>  // for max
+#include <atomic>     // for atomic
+#include <cstdlib>    // for getenv
+#include <cstring>    // for memcpy
+#include <utility>    // for move
+#include <vector>     // for vector
+
+#include "amdinfer/core/exceptions.hpp"  // for invalid_argument, bad_status
+
+namespace amdinfer {
+
+namespace {
+
+/// Seconds to wait for each request to the store
+constexpr double kRequestTimeout = 60.0;
+
+enum class StoreKind { S3, Gcs, Http };
+
+/// Get the text between the first tag of some name in XML and its end
+std::string getXmlValue(const std::string& xml, const std::string& tag,
+                        size_t start = 0,
+                        size_t end = std::string::npos) {
+  const auto open = "<" + tag + ">";
+  const auto begin = xml.find(open, start);
+  if (begin == std::string::npos || begin >= end) {
+    return "";
+  }
+  const auto value = begin + open.size();
+  const auto close = xml.find("</" + tag + ">", value);
+  if (close == std::string::npos || close > end) {
+    return "";
+  }
+
+  // undo the escaping of the five predefined entities
+  std::string text;
+  const auto raw = xml.substr(value, close - value);
+  for (size_t i = 0; i < raw.size(); ++i) {
+    if (raw[i] != '&') {
+      text += raw[i];
+      continue;
+    }
+    const auto semicolon = raw.find(';', i);
+    const auto entity = raw.substr(i, semicolon - i + 1);
+    if (entity == "&amp;") {
+      text += '&';
+    } else if (entity == "&lt;") {
+      text += '<';
+    } else if (entity == "&gt;") {
+      text += '>';
+    } else if (entity == "&quot;") {
+      text += '"';
+    } else if (entity == "&apos;") {
+      text += '\'';
+    } else {
+      text += raw[i];
+      continue;
+    }
+    i = semicolon;
+  }
+  return text;
+}
+
+/// Remove the prefix of the repository from the name of a file in it
+std::string stripPrefix(const std::string& name, const std::string& prefix) {
+  if (name.compare(0, prefix.size(), prefix) != 0) {
+    return "";
+  }
+  return name.substr(prefix.size());
+}
+
+/**
+ * @brief A repository that's read over HTTP. Each read takes the next of a
+ * pool of connections so parts of files are downloaded in parallel.
+ */
+class HttpObjectStore : public ObjectStore {
+ public:
+  HttpObjectStore(const std::string& url, size_t connections) : name_(url) {
+    const auto scheme_end = url.find("://");
+    const auto scheme = url.substr(0, scheme_end);
+    auto location = url.substr(scheme_end + 3);
+    while (!location.empty() && location.back() == '/') {
+      location.pop_back();
+    }
+    const auto separator = location.find('/');
+    const auto authority = location.substr(0, separator);
+    auto path =
+      separator == std::string::npos ? "" : location.substr(separator + 1);
+    if (authority.empty()) {
+      throw invalid_argument("The repository " + url + " has no host");
+    }
+    prefix_ = path.empty() ? "" : path + "/";
+
+    if (scheme == "s3") {
+      kind_ = StoreKind::S3;
+      if (const auto* endpoint = std::getenv("AWS_ENDPOINT_URL");
+          endpoint != nullptr) {
+        host_ = endpoint;
+        bucket_path_ = "/" + authority;
+      } else {
+        host_ = "https://" + authority + ".s3.amazonaws.com";
+      }
+    } else if (scheme == "gs") {
+      kind_ = StoreKind::Gcs;
+      host_ = "https://storage.googleapis.com";
+      bucket_ = authority;
+      bucket_path_ = "/" + authority;
+      if (const auto* token = std::getenv("GOOGLE_OAUTH_ACCESS_TOKEN");
+          token != nullptr) {
+        authorization_ = std::string{"Bearer "} + token;
+      }
+    } else if (scheme == "http" || scheme == "https") {
+      kind_ = StoreKind::Http;
+      host_ = scheme + "://" + authority;
+    } else {
+      throw invalid_argument("Unknown kind of repository: " + url);
+    }
+
+    connections = std::max(connections, size_t{1});
+    loop_.run();
+    clients_.reserve(connections);
+    for (size_t i = 0; i < connections; ++i) {
+      clients_.push_back(
+        drogon::HttpClient::newHttpClient(host_, loop_.getLoop()));
+    }
+  }
+
+  [[nodiscard]] std::string name() const override { return name_; }
+
+  std::vector<RemoteObject> list() override {
+    switch (kind_) {
+      case StoreKind::S3:
+        return listS3();
+      case StoreKind::Gcs:
+        return listGcs();
+      default:
+        return parseManifest(
+          get(bucket_path_ + "/" + prefix_ + kRepositoryManifest, {}));
+    }
+  }
+
+  void read(const RemoteObject& object, size_t offset, size_t size,
+            char* data) override {
+    auto request = makeRequest(bucket_path_ + "/" + prefix_ + object.path);
+    request->addHeader("Range", "bytes=" + std::to_string(offset) + "-" +
+                                  std::to_string(offset + size - 1));
+    // a file that changes while it's downloaded fails rather than mixing
+    // the parts of two versions
+    if (!object.etag.empty()) {
+      if (kind_ == StoreKind::Gcs) {
+        request->addHeader("x-goog-if-generation-match", object.etag);
+      } else {
+        request->addHeader("If-Match", object.etag);
+      }
+    }
+
+    const auto response = send(request);
+    const auto status = response->statusCode();
+    const bool whole = offset == 0 && size == object.size;
+    if (status != drogon::k206PartialContent &&
+        !(status == drogon::k200OK && whole)) {
+      throw bad_status("Reading " + object.path + " failed with HTTP " +
+                       std::to_string(static_cast<int>(status)));
+    }
+    const auto body = response->getBody();
+    if (body.size() != size) {
+      throw runtime_error("Got " + std::to_string(body.size()) + " of " +
+                          std::to_string(size) + " bytes of " + object.path);
+    }
+    std::memcpy(data, body.data(), size);
+  }
+
+ private:
+  drogon::HttpRequestPtr makeRequest(const std::string& path) const {
+    auto request = drogon::HttpRequest::newHttpRequest();
+    request->setMethod(drogon::Get);
+    request->setPath(path);
+    if (!authorization_.empty()) {
+      request->addHeader("Authorization", authorization_);
+    }
+    return request;
+  }
+
+  drogon::HttpResponsePtr send(const drogon::HttpRequestPtr& request) {
+    const auto index =
+      counter_.fetch_add(1, std::memory_order_relaxed) % clients_.size();
+    auto [result, response] =
+      clients_[index]->sendRequest(request, kRequestTimeout);
+    if (result != drogon::ReqResult::Ok) {
+      throw connection_error("Could not reach " + host_ + " for " + name_);
+    }
+    return response;
+  }
+
+  /// Get the body of a request that must succeed
+  std::string get(const std::string& path,
+                  const std::vector<std::pair<std::string, std::string>>&
+                    parameters) {
+    auto request = makeRequest(path);
+    for (const auto& [key, value] : parameters) {
+      request->setParameter(key, value);
+    }
+    const auto response = send(request);
+    if (response->statusCode() != drogon::k200OK) {
+      throw bad_status(
+        "Listing " + name_ + " failed with HTTP " +
+        std::to_string(static_cast<int>(response->statusCode())));
+    }
+    return std::string{response->getBody()};
+  }
+
+  std::vector<RemoteObject> listS3() {
+    std::vector<RemoteObject> objects;
+    std::string token;
+    do {
+      std::vector<std::pair<std::string, std::string>> parameters{
+        {"list-type", "2"}, {"prefix", prefix_}};
+      if (!token.empty()) {
+        parameters.emplace_back("continuation-token", token);
+      }
+      const auto xml = get(bucket_path_ + "/", parameters);
+
+      const std::string open = "<Contents>";
+      const std::string close = "</Contents>";
+      for (auto begin = xml.find(open); begin != std::string::npos;
+           begin = xml.find(open, begin + 1)) {
+        const auto end = xml.find(close, begin);
+        RemoteObject object;
+        object.path = stripPrefix(getXmlValue(xml, "Key", begin, end), prefix_);
+        object.etag = getXmlValue(xml, "ETag", begin, end);
+        object.size = std::stoull("0" + getXmlValue(xml, "Size", begin, end));
+        if (!object.path.empty() && object.path.back() != '/') {
+          objects.push_back(std::move(object));
+        }
+      }
+
+      token = getXmlValue(xml, "IsTruncated") == "true"
+                ? getXmlValue(xml, "NextContinuationToken")
+                : "";
+    } while (!token.empty());
+    return objects;
+  }
+
+  std::vector<RemoteObject> listGcs() {
+    std::vector<RemoteObject> objects;
+    std::string token;
+    do {
+      std::vector<std::pair<std::string, std::string>> parameters{
+        {"prefix", prefix_},
+        {"fields", "items(name,size,generation),nextPageToken"}};
+      if (!token.empty()) {
+        parameters.emplace_back("pageToken", token);
+      }
+      const auto body = get("/storage/v1/b/" + bucket_ + "/o", parameters);
+
+      Json::Value json;
+      std::string errors;
+      Json::CharReaderBuilder builder;
+      std::unique_ptr<Json::CharReader> reader{builder.newCharReader()};
+      if (!reader->parse(body.data(), body.data() + body.size(), &json,
+                         &errors)) {
+        throw invalid_argument("Failed to parse the objects in " + name_);
+      }
+      for (const auto& item : json["items"]) {
+        RemoteObject object;
+        object.path = stripPrefix(item["name"].asString(), prefix_);
+        object.etag = item["generation"].asString();
+        object.size = std::stoull("0" + item["size"].asString());
+        if (!object.path.empty() && object.path.back() != '/') {
+          objects.push_back(std::move(object));
+        }
+      }
+      token = json.get("nextPageToken", "").asString();
+    } while (!token.empty());
+    return objects;
+  }
+
+  std::string name_;
+  StoreKind kind_ = StoreKind::Http;
+  std::string host_;
+  std::string bucket_;
+  /// the path of the bucket on the host, if it's not in the host's name
+  std::string bucket_path_;
+  std::string prefix_;
+  std::string authorization_;
+  trantor::EventLoopThread loop_;
+  std::vector<drogon::HttpClientPtr> clients_;
+  std::atomic<size_t> counter_ = 0;
+};
+
+}  // namespace
+
+std::unique_ptr<ObjectStore> makeObjectStore(const std::string& url,
+                                             size_t connections) {
+  return std::make_unique<HttpObjectStore>(url, connections);
+}
+
+}  // namespace amdinfer
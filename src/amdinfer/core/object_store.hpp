@@ -0,0 +1,55 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the stores that remote model repositories are read from
+ */
+
+#ifndef GUARD_AMDINFER_CORE_OBJECT_STORE
+#define GUARD_AMDINFER_CORE_OBJECT_STORE
+
+#include <cstddef>  // for size_t
+#include <memory>   // for unique_ptr
+#include <string>   // for string
+
+#include "amdinfer/core/remote_repository.hpp"  // for ObjectStore
+
+namespace amdinfer {
+
+/// The file that lists the files of a repository that's served over HTTP
+constexpr auto kRepositoryManifest = "manifest.txt";
+
+/**
+ * @brief Make the store for a remote repository from its URL:
+ *
+ *   - s3://bucket/prefix reads from S3 or, if AWS_ENDPOINT_URL is set, from
+ *     the S3-compatible server at that URL. Buckets must allow anonymous
+ *     reads as requests aren't signed
+ *   - gs://bucket/prefix reads from Google Cloud Storage. If
+ *     GOOGLE_OAUTH_ACCESS_TOKEN is set, it's sent as a bearer token
+ *   - http://host/path and https://host/path read from any server that
+ *     supports range requests. The repository's files are listed in its
+ *     manifest.txt, as parsed by parseManifest()
+ *
+ * @param url the URL of the repository
+ * @param connections how many connections to read with
+ * @return std::unique_ptr<ObjectStore>
+ */
+std::unique_ptr<ObjectStore> makeObjectStore(const std::string& url,
+                                             size_t connections);
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_CORE_OBJECT_STORE
@@ -19,58 +19,101 @@
 
 #include "amdinfer/core/parameters.hpp"
 
+#include <algorithm>    // for lower_bound
 #include <cassert>      // for assert
 #include <cstdint>      // for int32_t
 #include <cstring>      // for size_t, memcpy
 #include <tuple>        // for tuple
 #include <type_traits>  // for add_const<>::type, decay_t
+#include <utility>      // for forward, move
+#include <variant>      // for variant_size_v
 #include <vector>       // for vector
 
-#include "amdinfer/util/memory.hpp"  // for copy
+#include "amdinfer/core/exceptions.hpp"  // for invalid_argument
+#include "amdinfer/util/memory.hpp"      // for copy
 
 namespace amdinfer {
 
+ParameterMap::ConstIterator ParameterMap::lowerBound(
+  std::string_view key) const {
+  return std::lower_bound(parameters_.begin(), parameters_.end(), key,
+                          [](const auto &parameter, std::string_view k) {
+                            return parameter.first < k;
+                          });
+}
+
+ParameterMap::ConstIterator ParameterMap::find(std::string_view key) const {
+  // most maps are empty so skip the search
+  if (parameters_.empty()) {
+    return parameters_.end();
+  }
+  auto it = lowerBound(key);
+  if (it != parameters_.end() && it->first == key) {
+    return it;
+  }
+  return parameters_.end();
+}
+
+template <typename T>
+void ParameterMap::emplace(const std::string &key, T &&value) {
+  // like the map this replaced, an existing key keeps its value
+  const auto it = lowerBound(key);
+  if (it != parameters_.end() && it->first == key) {
+    return;
+  }
+  parameters_.emplace(it, key, std::forward<T>(value));
+}
+
 void ParameterMap::put(const std::string &key, bool value) {
-  this->parameters_.try_emplace(key, value);
+  this->emplace(key, value);
 }
 
 void ParameterMap::put(const std::string &key, double value) {
-  this->parameters_.try_emplace(key, value);
+  this->emplace(key, value);
 }
 
 void ParameterMap::put(const std::string &key, int32_t value) {
-  this->parameters_.try_emplace(key, value);
+  this->emplace(key, value);
 }
 
 void ParameterMap::put(const std::string &key, const std::string &value) {
-  this->parameters_.try_emplace(key, value);
+  this->emplace(key, value);
 }
 
 void ParameterMap::put(const std::string &key, const char *value) {
-  this->parameters_.try_emplace(key, std::string{value});
+  this->emplace(key, std::string{value});
 }
 
 void ParameterMap::erase(const std::string &key) {
-  if (this->parameters_.find(key) != this->parameters_.end()) {
-    this->parameters_.erase(key);
+  const auto it = this->find(key);
+  if (it != parameters_.end()) {
+    parameters_.erase(it);
   }
 }
 
-bool ParameterMap::has(const std::string &key) const {
-  return this->parameters_.find(key) != this->parameters_.end();
+bool ParameterMap::has(std::string_view key) const {
+  return this->find(key) != this->parameters_.end();
 }
 
 void ParameterMap::rename(const std::string &key, const std::string &new_key) {
-  auto node = parameters_.extract(key);
-  node.key() = new_key;
-  parameters_.insert(std::move(node));
+  const auto it = this->find(key);
+  if (it == parameters_.end()) {
+    return;
+  }
+  auto value = std::move(parameters_[it - parameters_.begin()].second);
+  parameters_.erase(it);
+  this->emplace(new_key, std::move(value));
 }
 
 size_t ParameterMap::size() const { return parameters_.size(); }
 
 bool ParameterMap::empty() const { return parameters_.empty(); }
 
-ParameterMap::Iterator ParameterMap::begin() { return parameters_.begin(); }
+void ParameterMap::reserve(size_t size) { parameters_.reserve(size); }
+
+ParameterMap::Iterator ParameterMap::begin() {
+  return Iterator{parameters_.begin()};
+}
 ParameterMap::ConstIterator ParameterMap::begin() const {
   return parameters_.cbegin();
 }
@@ -78,7 +121,9 @@ ParameterMap::ConstIterator ParameterMap::cbegin() const {
   return parameters_.cbegin();
 }
 
-ParameterMap::Iterator ParameterMap::end() { return parameters_.end(); }
+ParameterMap::Iterator ParameterMap::end() {
+  return Iterator{parameters_.end()};
+}
 ParameterMap::ConstIterator ParameterMap::end() const {
   return parameters_.cend();
 }
@@ -86,7 +131,7 @@ ParameterMap::ConstIterator ParameterMap::cend() const {
   return parameters_.cend();
 }
 
-std::map<std::string, Parameter, std::less<>> ParameterMap::data() const {
+const ParameterMap::Container &ParameterMap::data() const {
   return parameters_;
 }
 
@@ -164,22 +209,33 @@ template <typename... Ts>
   return kTable.at(i)();
 }
 
+namespace {
+
+/// Read a size written by serialize(), which may not be aligned
+size_t readSize(const std::byte **data_in) {
+  size_t size = 0;
+  std::memcpy(&size, *data_in, sizeof(size_t));
+  *data_in += sizeof(size_t);
+  return size;
+}
+
+}  // namespace
+
 const std::byte *ParameterMap::deserialize(const std::byte *data_in) {
   parameters_.clear();
 
-  auto size = std::to_integer<size_t>(*data_in);
-  data_in += sizeof(size_t);
+  auto size = readSize(&data_in);
   std::vector<std::tuple<size_t, size_t, size_t>> params;
-  params.reserve(size);
   for (auto i = 0U; i < size; i++) {
-    auto index = std::to_integer<size_t>(*data_in);
-    data_in += sizeof(size_t);
-    auto key_size = std::to_integer<size_t>(*data_in);
-    data_in += sizeof(size_t);
-    auto data_size = std::to_integer<size_t>(*data_in);
-    data_in += sizeof(size_t);
+    auto index = readSize(&data_in);
+    auto key_size = readSize(&data_in);
+    auto data_size = readSize(&data_in);
+    if (index >= std::variant_size_v<Parameter>) {
+      throw invalid_argument("Unknown type of parameter in serialized data");
+    }
     params.emplace_back(index, key_size, data_size);
   }
+  parameters_.reserve(size);
   for (const auto &[index, key_size, data_size] : params) {
     std::string key;
     key.resize(key_size);
@@ -195,12 +251,15 @@ const std::byte *ParameterMap::deserialize(const std::byte *data_in) {
           std::memcpy(value.data(), data_in, n);
           data_in += n;
         } else {
+          if (n != sizeof(T)) {
+            throw invalid_argument("Wrong parameter size in serialized data");
+          }
           std::memcpy(&value, data_in, n);
           data_in += n;
         }
       },
       param);
-    parameters_.try_emplace(key, param);
+    this->emplace(key, std::move(param));
   }
   return data_in;
 }
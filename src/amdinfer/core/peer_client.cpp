@@ -0,0 +1,92 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the connections to peer servers
+ */
+
+#include "amdinfer/core/peer_client.hpp"
+
+#include <drogon/HttpClient.h>            // for HttpClient, HttpClientPtr
+#include <drogon/HttpRequest.h>           // for HttpRequest, HttpRequestPtr
+#include <drogon/HttpResponse.h>          // for HttpResponsePtr
+#include <json/value.h>                   // for Value
+#include <trantor/net/EventLoopThread.h>  // for EventLoopThread
+
+#include "amdinfer/clients/socket.hpp"   // for SocketClient
+#include "amdinfer/core/exceptions.hpp"  // for connection_error, bad_status
+
+namespace amdinfer {
+
+namespace {
+
+/// Seconds to wait for a peer's load. It's fetched again soon anyway
+constexpr double kLoadTimeout = 1.0;
+
+class SocketPeer : public Peer {
+ public:
+  explicit SocketPeer(const PeerAddress& address)
+    : name_(address.socket),
+      http_address_(address.http),
+      client_(address.socket, address.http) {
+    loop_.run();
+    http_ = drogon::HttpClient::newHttpClient(http_address_, loop_.getLoop());
+  }
+
+  [[nodiscard]] std::string name() const override { return name_; }
+
+  PeerLoad load() override {
+    auto request = drogon::HttpRequest::newHttpRequest();
+    request->setMethod(drogon::Get);
+    request->setPath(kPeerLoadPath);
+    auto [result, response] = http_->sendRequest(request, kLoadTimeout);
+    if (result != drogon::ReqResult::Ok) {
+      throw connection_error("Could not reach " + http_address_);
+    }
+    const auto json = response->getJsonObject();
+    if (response->statusCode() != drogon::k200OK || json == nullptr) {
+      throw bad_status(
+        "Getting the load failed with HTTP " +
+        std::to_string(static_cast<int>(response->statusCode())));
+    }
+
+    PeerLoad load;
+    const auto& endpoints = (*json)["endpoints"];
+    for (const auto& name : endpoints.getMemberNames()) {
+      load.try_emplace(name, endpoints[name].asUInt64());
+    }
+    return load;
+  }
+
+  InferenceResponseFuture infer(const std::string& model,
+                                const InferenceRequest& request) override {
+    return client_.modelInferAsync(model, request);
+  }
+
+ private:
+  std::string name_;
+  std::string http_address_;
+  SocketClient client_;
+  trantor::EventLoopThread loop_;
+  drogon::HttpClientPtr http_;
+};
+
+}  // namespace
+
+std::unique_ptr<Peer> makePeer(const std::string& address) {
+  return std::make_unique<SocketPeer>(parsePeerAddress(address));
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,45 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the connections to peer servers
+ */
+
+#ifndef GUARD_AMDINFER_CORE_PEER_CLIENT
+#define GUARD_AMDINFER_CORE_PEER_CLIENT
+
+#include <memory>  // for unique_ptr
+#include <string>  // for string
+
+#include "amdinfer/core/peers.hpp"  // for Peer
+
+namespace amdinfer {
+
+/// The path that servers report the load of their endpoints to peers at
+constexpr auto kPeerLoadPath = "/v2/peers/load";
+
+/**
+ * @brief Make the connection to a peer server. Its load is fetched from its
+ * HTTP server and requests are sent to its socket server in the binary wire
+ * format
+ *
+ * @param address the peer's address as host:socket_port:http_port
+ * @return std::unique_ptr<Peer>
+ */
+std::unique_ptr<Peer> makePeer(const std::string& address);
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_CORE_PEER_CLIENT
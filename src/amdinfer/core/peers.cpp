@@ -0,0 +1,252 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the router that forwards requests to peer servers
+ */
+
+#include "amdinfer/core/peers.hpp"
+
+#include <cstddef>    // for byte
+#include <exception>  // for exception
+#include <utility>    // for move
+#include <variant>    // for bad_variant_access
+
+#include "amdinfer/buffers/cpu.hpp"              // for CpuBuffer
+#include "amdinfer/core/exceptions.hpp"          // for invalid_argument
+#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/core/memory_pool/pool.hpp"    // for MemoryPool
+#include "amdinfer/core/parameters.hpp"          // for ParameterMap
+#include "amdinfer/core/request_container.hpp"   // for RequestContainer
+#include "amdinfer/observation/logging.hpp"      // for AMDINFER_LOG_WARN
+#include "amdinfer/util/queue.hpp"               // for BlockingQueue
+#include "amdinfer/util/thread.hpp"              // for setThreadName
+
+namespace amdinfer {
+
+namespace {
+
+/// A request that was forwarded and is waiting for its response
+struct Forwarded {
+  InferenceRequestPtr request;
+  InferenceResponseFuture future;
+};
+
+size_t inputBytes(const InferenceRequestInput& input) {
+  return input.getSize() * input.getDatatype().size();
+}
+
+}  // namespace
+
+PeerAddress parsePeerAddress(const std::string& address) {
+  const auto http = address.rfind(':');
+  const auto socket =
+    http == std::string::npos || http == 0 ? std::string::npos
+                                           : address.rfind(':', http - 1);
+  if (socket == std::string::npos || socket == 0 ||
+      socket + 1 == http || http + 1 == address.size()) {
+    throw invalid_argument(
+      "The peer address must be host:socket_port:http_port, not " + address);
+  }
+  const auto host = address.substr(0, socket);
+  return {host + address.substr(socket, http - socket),
+          "http://" + host + address.substr(http)};
+}
+
+struct PeerRouter::State {
+  std::unique_ptr<Peer> peer;
+  /// the peer's last fetched load, guarded by the router's mutex
+  PeerLoad load;
+  bool reachable = false;
+  BlockingQueue<std::unique_ptr<Forwarded>> responses;
+  std::thread responder;
+};
+
+PeerRouter::PeerRouter(std::vector<std::unique_ptr<Peer>> peers,
+                       const PeerLimits& limits, const MemoryPool* pool)
+  : limits_(limits), pool_(pool) {
+  peers_.reserve(peers.size());
+  for (auto& peer : peers) {
+    auto& state = peers_.emplace_back(std::make_unique<State>());
+    state->peer = std::move(peer);
+    // each peer's responses are waited for in order in its own thread so a
+    // slow peer doesn't hold up the others
+    state->responder = std::thread([state = state.get()]() {
+      util::setThreadName("Peer");
+      while (true) {
+        std::unique_ptr<Forwarded> forwarded;
+        state->responses.wait_dequeue(forwarded);
+        if (forwarded == nullptr) {
+          break;
+        }
+        try {
+          forwarded->request->runCallbackOnce(forwarded->future.get());
+        } catch (const std::exception& e) {
+          forwarded->request->runCallbackError(e.what());
+        }
+      }
+    });
+  }
+  this->refresh();
+  poller_ = std::thread{&PeerRouter::poll, this};
+}
+
+PeerRouter::~PeerRouter() {
+  {
+    std::lock_guard lock{mutex_};
+    stop_ = true;
+  }
+  cv_.notify_all();
+  poller_.join();
+  for (auto& state : peers_) {
+    state->responses.enqueue(nullptr);
+    state->responder.join();
+  }
+}
+
+void PeerRouter::refresh() {
+  for (auto& state : peers_) {
+    PeerLoad load;
+    bool reachable = true;
+    try {
+      load = state->peer->load();
+    } catch (const std::exception& e) {
+      AMDINFER_IF_LOGGING(Logger logger{Loggers::Server};)
+      AMDINFER_LOG_DEBUG(logger, "Cannot get the load of peer " +
+                                   state->peer->name() + ": " + e.what());
+      reachable = false;
+    }
+    std::lock_guard lock{mutex_};
+    state->load = std::move(load);
+    state->reachable = reachable;
+  }
+}
+
+void PeerRouter::poll() {
+  util::setThreadName("PeerPoll");
+  std::unique_lock lock{mutex_};
+  while (!cv_.wait_for(lock, limits_.interval, [this]() { return stop_; })) {
+    lock.unlock();
+    this->refresh();
+    lock.lock();
+  }
+}
+
+std::optional<size_t> PeerRouter::choose(const std::string& model,
+                                         std::optional<size_t> local) {
+  if (local.has_value() && *local < limits_.threshold) {
+    return std::nullopt;
+  }
+  std::optional<size_t> best;
+  size_t best_load = 0;
+  std::lock_guard lock{mutex_};
+  for (auto i = 0U; i < peers_.size(); ++i) {
+    const auto& state = peers_[i];
+    if (!state->reachable) {
+      continue;
+    }
+    auto iterator = state->load.find(model);
+    if (iterator == state->load.end()) {
+      continue;
+    }
+    if (!best.has_value() || iterator->second < best_load) {
+      best = i;
+      best_load = iterator->second;
+    }
+  }
+  if (!best.has_value() || (local.has_value() && best_load >= *local)) {
+    return std::nullopt;
+  }
+  // counted until the next fetch replaces the load
+  peers_[*best]->load[model]++;
+  return best;
+}
+
+bool PeerRouter::forward(const std::string& model, std::optional<size_t> local,
+                         std::unique_ptr<RequestContainer>* request) {
+  auto& container = **request;
+  auto& inference_request = container.request;
+  const auto& parameters = inference_request->getParameters();
+  if (parameters.has("forward")) {
+    try {
+      if (!parameters.get<bool>("forward")) {
+        return false;
+      }
+    } catch (const std::bad_variant_access&) {
+      throw invalid_argument("The forward parameter must be a bool");
+    }
+  }
+  const auto index = this->choose(model, local);
+  if (!index.has_value()) {
+    return false;
+  }
+
+  // the inputs that are decoded by the batcher are written out so they can be
+  // sent. The writers are kept so the request can still be served here if the
+  // peer can't take it
+  std::vector<std::vector<std::byte>> staging;
+  if (!container.input_writers.empty()) {
+    const auto& inputs = inference_request->getInputs();
+    const bool in_place = container.input_views.size() == inputs.size() &&
+                          !container.device_views;
+    staging.reserve(inputs.size());
+    for (auto i = 0U; i < inputs.size(); ++i) {
+      if (in_place) {
+        inference_request->setInputTensorData(
+          i, const_cast<void*>(container.input_views[i]));
+        continue;
+      }
+      auto& data = staging.emplace_back(inputBytes(inputs[i]));
+      CpuBuffer buffer{data.data(), MemoryAllocators::Cpu, data.size()};
+      container.input_writers[i](&buffer, 0);
+      inference_request->setInputTensorData(i, data.data());
+    }
+  }
+
+  auto updated = parameters;
+  // put() doesn't replace existing values
+  updated.erase("forward");
+  updated.put("forward", false);
+  inference_request->setParameters(std::move(updated));
+
+  auto& state = peers_[*index];
+  InferenceResponseFuture future;
+  try {
+    future = state->peer->infer(model, *inference_request);
+  } catch (const std::exception& e) {
+    AMDINFER_IF_LOGGING(Logger logger{Loggers::Server};)
+    AMDINFER_LOG_WARN(logger, "Cannot forward a request to peer " +
+                                state->peer->name() + ": " + e.what());
+    std::lock_guard lock{mutex_};
+    state->reachable = false;
+    return false;
+  }
+
+  // the request was sent so the buffers of inputs that aren't decoded by the
+  // batcher go back to the pool now
+  if (container.input_writers.empty()) {
+    for (const auto& input : inference_request->getInputs()) {
+      pool_->put(std::make_unique<CpuBuffer>(
+        input.getData(), MemoryAllocators::Cpu, inputBytes(input)));
+    }
+  }
+  state->responses.enqueue(std::make_unique<Forwarded>(
+    Forwarded{std::move(inference_request), std::move(future)}));
+  request->reset();
+  return true;
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,171 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the router that forwards requests to peer servers
+ */
+
+#ifndef GUARD_AMDINFER_CORE_PEERS
+#define GUARD_AMDINFER_CORE_PEERS
+
+#include <chrono>              // for milliseconds
+#include <condition_variable>  // for condition_variable
+#include <cstddef>             // for size_t
+#include <memory>              // for unique_ptr
+#include <mutex>               // for mutex
+#include <optional>            // for optional
+#include <string>              // for string
+#include <thread>              // for thread
+#include <unordered_map>       // for unordered_map
+#include <vector>              // for vector
+
+#include "amdinfer/declarations.hpp"  // for InferenceResponseFuture
+
+namespace amdinfer {
+
+class MemoryPool;
+struct RequestContainer;
+
+/// The requests and batches queued on each endpoint of a server, by name
+using PeerLoad = std::unordered_map<std::string, size_t>;
+
+/// How often the loads of the peers are fetched
+constexpr std::chrono::milliseconds kDefaultPeerInterval{100};
+/// The queued work on an endpoint before its requests may be forwarded
+constexpr size_t kDefaultPeerThreshold = 8;
+
+/// The addresses of a peer's servers
+struct PeerAddress {
+  /// host:port of the peer's socket server
+  std::string socket;
+  /// http://host:port of the peer's HTTP server
+  std::string http;
+};
+
+/**
+ * @brief Parse the address of a peer given as host:socket_port:http_port
+ *
+ * @param address the address to parse
+ * @return PeerAddress
+ */
+PeerAddress parsePeerAddress(const std::string& address);
+
+/// Another server that requests may be forwarded to
+class Peer {
+ public:
+  Peer() = default;
+  Peer(const Peer&) = delete;
+  Peer& operator=(const Peer&) = delete;
+  Peer(Peer&&) = delete;
+  Peer& operator=(Peer&&) = delete;
+  virtual ~Peer() = default;
+
+  /// Get a name for the peer to use in messages
+  [[nodiscard]] virtual std::string name() const = 0;
+  /// Get the work queued on each endpoint that's loaded on the peer
+  virtual PeerLoad load() = 0;
+  /**
+   * @brief Send a request to the peer. The request is sent by the time this
+   * returns so its data may be released
+   *
+   * @param model the model to send the request to
+   * @param request the request to send
+   * @return InferenceResponseFuture
+   */
+  virtual InferenceResponseFuture infer(const std::string& model,
+                                        const InferenceRequest& request) = 0;
+};
+
+/// The limits of forwarding requests to peers
+struct PeerLimits {
+  /// how often the loads of the peers are fetched
+  std::chrono::milliseconds interval = kDefaultPeerInterval;
+  /**
+   * @brief requests go to a peer once at least this many requests and batches
+   * are queued for their model here and the peer has less queued for it
+   */
+  size_t threshold = kDefaultPeerThreshold;
+};
+
+/**
+ * @brief Forwards requests to peer servers. It fetches the load of each peer
+ * in the background and a request goes to the least loaded peer if its model
+ * isn't loaded here but is on the peer, or if the work queued for its model
+ * here reached the threshold and the peer has less. Forwarded requests are
+ * sent with "forward" set to false so the peer serves them itself, and
+ * clients may set it too to keep a request here.
+ *
+ * The loads are only as fresh as the last fetch so each forwarded request
+ * counts against its peer's load until the next one to not send them all to
+ * the same peer. Peers that can't be reached aren't used until a fetch
+ * succeeds.
+ */
+class PeerRouter {
+ public:
+  /**
+   * @brief Construct a new PeerRouter object and start fetching the loads of
+   * the peers
+   *
+   * @param peers the peers to forward to
+   * @param limits the limits of forwarding
+   * @param pool the pool that the requests' input buffers come from
+   */
+  PeerRouter(std::vector<std::unique_ptr<Peer>> peers, const PeerLimits& limits,
+             const MemoryPool* pool);
+  PeerRouter(const PeerRouter&) = delete;
+  PeerRouter& operator=(const PeerRouter&) = delete;
+  PeerRouter(PeerRouter&&) = delete;
+  PeerRouter& operator=(PeerRouter&&) = delete;
+  /// Destructor. It waits for the responses of the forwarded requests
+  ~PeerRouter();
+
+  /**
+   * @brief Forward a request to a peer if it's better served there. If it's
+   * not forwarded, the request is left as it was to be served here
+   *
+   * @param model the model that the request is for
+   * @param local the work queued here for the model or nullopt if it's not
+   * loaded here
+   * @param request the request to forward
+   * @return bool true if the request was forwarded
+   */
+  bool forward(const std::string& model, std::optional<size_t> local,
+               std::unique_ptr<RequestContainer>* request);
+
+  /// Fetch the loads of the peers now
+  void refresh();
+
+ private:
+  struct State;
+
+  /// Choose the peer to forward a request to, if any
+  std::optional<size_t> choose(const std::string& model,
+                               std::optional<size_t> local);
+  /// Fetch the loads of the peers periodically. Runs in its own thread
+  void poll();
+
+  PeerLimits limits_;
+  const MemoryPool* pool_;
+  std::vector<std::unique_ptr<State>> peers_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stop_ = false;
+  std::thread poller_;
+};
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_CORE_PEERS
@@ -0,0 +1,419 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the shared memory channel between the server and the
+ * processes that host its workers
+ */
+
+#include "amdinfer/core/process_channel.hpp"
+
+#include <fcntl.h>        // for O_CREAT, O_EXCL, O_RDWR
+#include <linux/futex.h>  // for FUTEX_WAIT, FUTEX_WAKE
+#include <sys/mman.h>     // for mmap, munmap, shm_open, shm_unlink
+#include <sys/stat.h>     // for fstat, stat
+#include <sys/syscall.h>  // for SYS_futex
+#include <time.h>         // for timespec
+#include <unistd.h>       // for close, ftruncate, syscall
+
+#include <atomic>   // for atomic, memory_order_acquire, memory_order...
+#include <cerrno>   // for errno
+#include <climits>  // for INT_MAX
+#include <cstring>  // for memcpy, strerror
+#include <new>      // for placement new
+#include <utility>  // for move
+#include <vector>   // for vector
+
+#include "amdinfer/core/data_types.hpp"  // for DataType
+#include "amdinfer/core/exceptions.hpp"  // for invalid_argument, runtime_error
+#include "amdinfer/core/tensor.hpp"      // for Tensor
+
+namespace amdinfer {
+
+namespace {
+
+/// The first bytes of a channel's memory, "AMDCHAN" in memory
+constexpr uint64_t kChannelMagic = 0x4E414843444D41;
+/// The most messages in flight in each direction
+constexpr size_t kRingSize = 1024;
+/// Messages start on cache lines so the two processes don't share them
+constexpr size_t kAlignment = 64;
+/// How many times a receiver checks for a message before it sleeps
+constexpr int kSpins = 1000;
+/// How long a sender sleeps at most before it checks if it's closed
+constexpr std::chrono::milliseconds kSendPoll{100};
+
+/// The memory of each message starts with this
+struct Block {
+  /// cleared by the receiver once it's done with the message
+  std::atomic<uint32_t> used;
+  uint32_t reserved;
+  /// the size of the block, including this header, in bytes
+  uint64_t size;
+};
+
+size_t align(size_t size, size_t alignment) {
+  return (size + alignment - 1) / alignment * alignment;
+}
+
+uint32_t* futexWord(std::atomic<uint32_t>* word) {
+  static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t));
+  return reinterpret_cast<uint32_t*>(word);
+}
+
+/// Sleep until the word is woken if it still holds the value
+void futexWait(std::atomic<uint32_t>* word, uint32_t value,
+               std::chrono::nanoseconds timeout) {
+  const auto seconds =
+    std::chrono::duration_cast<std::chrono::seconds>(timeout);
+  const timespec time{seconds.count(), (timeout - seconds).count()};
+  // the word is shared between processes so the futex can't be private
+  syscall(SYS_futex, futexWord(word), FUTEX_WAIT, value, &time, nullptr, 0);
+}
+
+void futexWake(std::atomic<uint32_t>* word) {
+  syscall(SYS_futex, futexWord(word), FUTEX_WAKE, INT_MAX, nullptr, nullptr,
+          0);
+}
+
+}  // namespace
+
+/// One direction of the channel
+struct ProcessChannel::Lane {
+  /// the number of messages sent, written by the sender
+  alignas(kAlignment) std::atomic<uint64_t> head;
+  /// the number of messages received, written by the receiver
+  alignas(kAlignment) std::atomic<uint64_t> tail;
+  /// bumped for each message sent so the receiver can sleep on it
+  alignas(kAlignment) std::atomic<uint32_t> sent;
+  std::atomic<uint32_t> receiver_waiting;
+  /// bumped as messages are received and released so the sender can sleep
+  alignas(kAlignment) std::atomic<uint32_t> released;
+  std::atomic<uint32_t> sender_waiting;
+  /// the offsets of the messages in flight in the lane's memory
+  alignas(kAlignment) uint64_t offsets[kRingSize];  // NOLINT(*-c-arrays)
+};
+
+struct ProcessChannel::Header {
+  uint64_t magic;
+  /// the size of each lane's memory for messages
+  uint64_t bytes;
+  std::atomic<uint32_t> closed;
+  /// requests from the parent and then responses from the child
+  Lane lanes[2];  // NOLINT(*-c-arrays)
+};
+
+/// The channel's mapping, which is held by the channel and its messages
+struct ProcessChannel::Memory {
+  void* mapping = MAP_FAILED;
+  size_t size = 0;
+  Header* header = nullptr;
+
+  Memory(const std::string& name, size_t bytes, bool create) {
+    const int flags = create ? O_RDWR | O_CREAT | O_EXCL : O_RDWR;
+    const int fd = shm_open(name.c_str(), flags, S_IRUSR | S_IWUSR);
+    if (fd == -1) {
+      throw invalid_argument("Could not open the channel " + name + ": " +
+                             std::strerror(errno));
+    }
+    const auto page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    if (create) {
+      size = align(sizeof(Header), page_size) + 2 * bytes;
+      if (ftruncate(fd, static_cast<off_t>(size)) == -1) {
+        const auto error = errno;
+        ::close(fd);
+        shm_unlink(name.c_str());
+        throw runtime_error("Could not size the channel " + name + ": " +
+                            std::strerror(error));
+      }
+    } else {
+      struct stat info {};
+      if (fstat(fd, &info) == -1 ||
+          static_cast<size_t>(info.st_size) < sizeof(Header)) {
+        ::close(fd);
+        throw invalid_argument(name + " is not a channel");
+      }
+      size = static_cast<size_t>(info.st_size);
+    }
+    mapping =
+      mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    const auto error = errno;
+    // the mapping stays valid after the descriptor is closed
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+      if (create) {
+        shm_unlink(name.c_str());
+      }
+      throw runtime_error("Could not map the channel " + name + ": " +
+                          std::strerror(error));
+    }
+
+    if (create) {
+      header = new (mapping) Header{};
+      header->bytes = bytes;
+      header->magic = kChannelMagic;
+    } else {
+      header = static_cast<Header*>(mapping);
+      if (header->magic != kChannelMagic ||
+          size < align(sizeof(Header), page_size) + 2 * header->bytes) {
+        munmap(mapping, size);
+        throw invalid_argument(name + " is not a channel");
+      }
+    }
+    arena_offset = align(sizeof(Header), page_size);
+  }
+  Memory(const Memory&) = delete;
+  Memory& operator=(const Memory&) = delete;
+  Memory(Memory&&) = delete;
+  Memory& operator=(Memory&&) = delete;
+  ~Memory() { munmap(mapping, size); }
+
+  /// Get the memory for the messages of a lane
+  [[nodiscard]] std::byte* arena(const Lane* lane) const {
+    const auto index = lane == &header->lanes[0] ? 0 : 1;
+    return static_cast<std::byte*>(mapping) + arena_offset +
+           (index * header->bytes);
+  }
+
+ private:
+  size_t arena_offset = 0;
+};
+
+ProcessChannel::ProcessChannel(const std::string& name, size_t bytes)
+  : ProcessChannel(name, bytes, true) {}
+
+ProcessChannel::ProcessChannel(const std::string& name)
+  : ProcessChannel(name, 0, false) {}
+
+ProcessChannel::ProcessChannel(const std::string& name, size_t bytes,
+                               bool create)
+  : name_(name), parent_(create), linked_(create) {
+  if (create && bytes < kAlignment) {
+    throw invalid_argument("The channel's memory is too small");
+  }
+  memory_ = std::make_shared<Memory>(name, align(bytes, kAlignment), create);
+}
+
+ProcessChannel::~ProcessChannel() {
+  // the child's name is removed by the parent, which created it
+  if (parent_) {
+    this->unlink();
+  }
+}
+
+ProcessChannel::Lane* ProcessChannel::sendLane() const {
+  return &memory_->header->lanes[parent_ ? 0 : 1];
+}
+
+ProcessChannel::Lane* ProcessChannel::receiveLane() const {
+  return &memory_->header->lanes[parent_ ? 1 : 0];
+}
+
+void ProcessChannel::reclaim(Lane* lane) {
+  const auto bytes = memory_->header->bytes;
+  auto* arena = memory_->arena(lane);
+  while (reclaimed_ < write_) {
+    auto* block = reinterpret_cast<Block*>(arena + (reclaimed_ % bytes));
+    if (block->used.load(std::memory_order_acquire) != 0) {
+      break;
+    }
+    reclaimed_ += block->size;
+  }
+}
+
+bool ProcessChannel::send(const WireMessage& message) {
+  const auto bytes = memory_->header->bytes;
+  const auto needed = align(sizeof(Block) + message.size(), kAlignment);
+  if (needed > bytes) {
+    throw invalid_argument("The message of " + std::to_string(message.size()) +
+                           " bytes is larger than the channel's memory");
+  }
+
+  std::lock_guard lock{send_mutex_};
+  auto* lane = this->sendLane();
+  auto* arena = memory_->arena(lane);
+  const auto head = lane->head.load(std::memory_order_relaxed);
+  // a message doesn't wrap around so the end of the memory is padded instead
+  uint64_t padding = 0;
+  auto fits = [&]() {
+    this->reclaim(lane);
+    const auto position = write_ % bytes;
+    padding = position + needed > bytes ? bytes - position : 0;
+    return head - lane->tail.load(std::memory_order_acquire) < kRingSize &&
+           write_ + padding + needed - reclaimed_ <= bytes;
+  };
+  while (!fits()) {
+    if (this->isClosed()) {
+      return false;
+    }
+    const auto seen = lane->released.load();
+    lane->sender_waiting.store(1);
+    if (!fits()) {
+      futexWait(&lane->released, seen, kSendPoll);
+    }
+    lane->sender_waiting.store(0);
+  }
+  if (this->isClosed()) {
+    return false;
+  }
+
+  if (padding > 0) {
+    auto* block = reinterpret_cast<Block*>(arena + (write_ % bytes));
+    block->size = padding;
+    block->used.store(0, std::memory_order_relaxed);
+    write_ += padding;
+  }
+  const auto position = write_ % bytes;
+  auto* block = reinterpret_cast<Block*>(arena + position);
+  block->size = needed;
+  block->used.store(1, std::memory_order_relaxed);
+  auto* data = reinterpret_cast<std::byte*>(block + 1);
+  for (const auto& segment : message.segments()) {
+    std::memcpy(data, segment.data, segment.size);
+    data += segment.size;
+  }
+  write_ += needed;
+
+  lane->offsets[head % kRingSize] = position;
+  lane->head.store(head + 1, std::memory_order_release);
+  lane->sent.fetch_add(1);
+  if (lane->receiver_waiting.load() != 0) {
+    futexWake(&lane->sent);
+  }
+  return true;
+}
+
+std::optional<ChannelMessage> ProcessChannel::receive(
+  std::chrono::milliseconds timeout) {
+  std::unique_lock lock{receive_mutex_};
+  auto* lane = this->receiveLane();
+  const auto tail = lane->tail.load(std::memory_order_relaxed);
+  auto arrived = [lane, tail]() {
+    return lane->head.load(std::memory_order_acquire) != tail;
+  };
+
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  for (auto i = 0; !arrived(); ++i) {
+    if (this->isClosed()) {
+      return std::nullopt;
+    }
+    if (i < kSpins) {
+      continue;
+    }
+    const auto remaining = deadline - std::chrono::steady_clock::now();
+    if (remaining <= std::chrono::nanoseconds::zero()) {
+      return std::nullopt;
+    }
+    const auto seen = lane->sent.load();
+    lane->receiver_waiting.store(1);
+    if (!arrived() && !this->isClosed()) {
+      futexWait(&lane->sent, seen, remaining);
+    }
+    lane->receiver_waiting.store(0);
+  }
+
+  auto* arena = memory_->arena(lane);
+  auto* block =
+    reinterpret_cast<Block*>(arena + lane->offsets[tail % kRingSize]);
+  lane->tail.store(tail + 1, std::memory_order_release);
+  lock.unlock();
+
+  // the memory is given back once the message is released, even if it's bad
+  auto release = [memory = memory_, lane](const void* pointer) {
+    auto* released = static_cast<Block*>(const_cast<void*>(pointer));
+    released->used.store(0, std::memory_order_release);
+    lane->released.fetch_add(1);
+    if (lane->sender_waiting.load() != 0) {
+      futexWake(&lane->released);
+    }
+  };
+  std::shared_ptr<const void> owner{block, std::move(release)};
+  const auto* data = reinterpret_cast<const std::byte*>(block + 1);
+  ChannelMessage message;
+  message.header = decodeHeader(
+    data, block->size - sizeof(Block) - sizeof(WireHeader));
+  message.body = data + sizeof(WireHeader);
+  message.owner = std::move(owner);
+  return message;
+}
+
+void ProcessChannel::close() {
+  auto* header = memory_->header;
+  header->closed.store(1);
+  for (auto& lane : header->lanes) {
+    futexWake(&lane.sent);
+    futexWake(&lane.released);
+  }
+}
+
+bool ProcessChannel::isClosed() const {
+  return memory_->header->closed.load() != 0;
+}
+
+void ProcessChannel::unlink() {
+  if (linked_) {
+    shm_unlink(name_.c_str());
+    linked_ = false;
+  }
+}
+
+const std::string& ProcessChannel::getName() const { return name_; }
+
+InferenceResponse describeModel(const ModelMetadata& metadata) {
+  InferenceResponse response;
+  response.setModel(metadata.getName());
+  response.setID(metadata.getPlatform());
+  const auto add = [&response](const Tensor& tensor, const char* kind) {
+    std::vector<std::byte> data(tensor.serializeSize());
+    tensor.serialize(data.data());
+    InferenceResponseOutput output;
+    output.setName(kind);
+    output.setDatatype(DataType::Uint8);
+    output.setShape({data.size()});
+    output.setData(std::move(data));
+    response.addOutput(output);
+  };
+  for (const auto& tensor : metadata.getInputs()) {
+    add(tensor, "input");
+  }
+  for (const auto& tensor : metadata.getOutputs()) {
+    add(tensor, "output");
+  }
+  return response;
+}
+
+ModelMetadata readModel(const InferenceResponse& response) {
+  if (response.isError()) {
+    throw runtime_error(response.getError());
+  }
+  ModelMetadata metadata{response.getModel(), response.getID()};
+  for (const auto& output : response.getOutputs()) {
+    Tensor tensor{"", {}, DataType::Uint8};
+    if (output.getDatatype() != DataType::Uint8 || output.getSize() == 0) {
+      throw invalid_argument("The response doesn't describe a model");
+    }
+    tensor.deserialize(static_cast<const std::byte*>(output.getData()));
+    if (output.getName() == "input") {
+      metadata.addInputTensor(tensor);
+    } else if (output.getName() == "output") {
+      metadata.addOutputTensor(tensor);
+    } else {
+      throw invalid_argument("The response doesn't describe a model");
+    }
+  }
+  return metadata;
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,162 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the shared memory channel between the server and the
+ * processes that host its workers
+ */
+
+#ifndef GUARD_AMDINFER_CORE_PROCESS_CHANNEL
+#define GUARD_AMDINFER_CORE_PROCESS_CHANNEL
+
+#include <chrono>    // for milliseconds
+#include <cstddef>   // for size_t, byte
+#include <cstdint>   // for uint64_t
+#include <memory>    // for shared_ptr
+#include <mutex>     // for mutex
+#include <optional>  // for optional
+#include <string>    // for string
+
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/core/model_metadata.hpp"      // for ModelMetadata
+#include "amdinfer/core/wire_format.hpp"         // for WireHeader, WireMessage
+
+namespace amdinfer {
+
+/// The default size of the memory for the messages in each direction
+constexpr size_t kDefaultChannelBytes = 64UL * 1024 * 1024;
+
+/// A message received from a channel
+struct ChannelMessage {
+  WireHeader header;
+  /// the header.bodySize() bytes of the message, in the channel's memory
+  const std::byte* body = nullptr;
+  /// the message's memory is given back to the sender once this is released
+  std::shared_ptr<const void> owner;
+};
+
+/**
+ * @brief A channel between two processes in POSIX shared memory that carries
+ * messages in the wire format in both directions. Each direction has a
+ * lock-free ring of the messages' offsets and the memory that holds them. A
+ * message is written once into the memory in place and read there by the
+ * other process, which gives the memory back by releasing the message. The
+ * memory is reclaimed in the order that it was written so a message that's
+ * held for long stops the sender once it's wrapped around to it. A process
+ * that waits for the other sleeps on a futex only once it's found nothing to
+ * do so busy channels don't make system calls.
+ *
+ * The parent creates the channel and sends requests. The child opens it by
+ * name and sends responses. Sending from several threads at once is safe, as
+ * is receiving, but each takes a lock within its process.
+ */
+class ProcessChannel {
+ public:
+  /**
+   * @brief Create a channel. It throws if the name is taken or the memory
+   * can't be mapped.
+   *
+   * @param name the name of the shared memory object, which starts with "/"
+   * @param bytes the size of the memory for each direction's messages
+   */
+  ProcessChannel(const std::string& name, size_t bytes);
+  /**
+   * @brief Open a channel that another process created. It throws if it
+   * doesn't exist or isn't a channel.
+   *
+   * @param name the name of the shared memory object
+   */
+  explicit ProcessChannel(const std::string& name);
+  ProcessChannel(const ProcessChannel&) = delete;
+  ProcessChannel& operator=(const ProcessChannel&) = delete;
+  ProcessChannel(ProcessChannel&&) = delete;
+  ProcessChannel& operator=(ProcessChannel&&) = delete;
+  /// Destructor. The memory stays mapped while received messages are held
+  ~ProcessChannel();
+
+  /**
+   * @brief Send a message, waiting for memory if the other process hasn't
+   * released enough of the earlier ones. It throws if the message is larger
+   * than the memory for its direction.
+   *
+   * @param message the message to send
+   * @return bool - false if the channel was closed first
+   */
+  bool send(const WireMessage& message);
+
+  /**
+   * @brief Receive the next message from the other process
+   *
+   * @param timeout the longest to wait for one
+   * @return std::optional<ChannelMessage> - the message or nullopt if none
+   * arrived in time or the channel is closed
+   */
+  std::optional<ChannelMessage> receive(std::chrono::milliseconds timeout);
+
+  /// Close the channel for both processes and wake any that wait on it
+  void close();
+  /// Check if either process has closed the channel
+  [[nodiscard]] bool isClosed() const;
+  /// Remove the channel's name once both processes have it mapped
+  void unlink();
+
+  [[nodiscard]] const std::string& getName() const;
+
+ private:
+  struct Lane;
+  struct Header;
+  struct Memory;
+
+  ProcessChannel(const std::string& name, size_t bytes, bool create);
+  [[nodiscard]] Lane* sendLane() const;
+  [[nodiscard]] Lane* receiveLane() const;
+  /// Give back the memory of the released messages in order
+  void reclaim(Lane* lane);
+
+  std::string name_;
+  bool parent_;
+  /// whether the channel's name hasn't been removed yet
+  bool linked_ = true;
+  std::shared_ptr<Memory> memory_;
+  std::mutex send_mutex_;
+  std::mutex receive_mutex_;
+  /// where the next message is written, counted from the start
+  uint64_t write_ = 0;
+  /// where the oldest message that hasn't been reclaimed starts
+  uint64_t reclaimed_ = 0;
+};
+
+/**
+ * @brief Describe a model's metadata as a response so the process that loads
+ * it can send it back over a channel. Each tensor is a serialized output of
+ * bytes named for whether it's an input or an output of the model and the
+ * platform is carried as the response's ID
+ *
+ * @param metadata the metadata to describe
+ * @return InferenceResponse
+ */
+InferenceResponse describeModel(const ModelMetadata& metadata);
+/**
+ * @brief Read a model's metadata back from a response made by describeModel().
+ * It throws if the response doesn't describe a model.
+ *
+ * @param response the response to read
+ * @return ModelMetadata
+ */
+ModelMetadata readModel(const InferenceResponse& response);
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_CORE_PROCESS_CHANNEL
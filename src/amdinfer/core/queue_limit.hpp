@@ -0,0 +1,127 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the limit on the requests waiting to be batched for an
+ * endpoint
+ */
+
+#ifndef GUARD_AMDINFER_CORE_QUEUE_LIMIT
+#define GUARD_AMDINFER_CORE_QUEUE_LIMIT
+
+#include <atomic>    // for atomic, memory_order_relaxed
+#include <cstddef>   // for size_t
+#include <memory>    // for shared_ptr, enable_shared_from_this
+#include <optional>  // for optional
+#include <utility>   // for exchange, move
+
+namespace amdinfer {
+
+/**
+ * @brief Bounds the requests that an endpoint has accepted but not yet batched
+ * by their number and the bytes of their input tensors. Each accepted request
+ * holds a ticket, which gives its room back once the request is destroyed
+ * after it's batched or rejected. It's safe to use from multiple threads and
+ * must be owned by a shared_ptr.
+ */
+class QueueLimit : public std::enable_shared_from_this<QueueLimit> {
+ public:
+  /// Holds a request's room in the queue until it's destroyed
+  class Ticket {
+   public:
+    Ticket() = default;
+    Ticket(const Ticket&) = delete;             ///< Copy constructor
+    Ticket& operator=(const Ticket&) = delete;  ///< Copy assignment
+    /// Move constructor
+    Ticket(Ticket&& other) noexcept
+      : limit_(std::move(other.limit_)), bytes_(other.bytes_) {}
+    /// Move assignment
+    Ticket& operator=(Ticket&& other) noexcept {
+      if (this != &other) {
+        release();
+        limit_ = std::move(other.limit_);
+        bytes_ = other.bytes_;
+      }
+      return *this;
+    }
+    ~Ticket() { release(); }  ///< Destructor
+
+    /// Give the room back to the queue, if it's still held
+    void release() {
+      if (auto limit = std::exchange(limit_, nullptr); limit != nullptr) {
+        limit->requests_.fetch_sub(1, std::memory_order_relaxed);
+        limit->bytes_.fetch_sub(bytes_, std::memory_order_relaxed);
+      }
+    }
+
+   private:
+    friend class QueueLimit;
+    Ticket(std::shared_ptr<QueueLimit> limit, size_t bytes)
+      : limit_(std::move(limit)), bytes_(bytes) {}
+
+    std::shared_ptr<QueueLimit> limit_;
+    size_t bytes_ = 0;
+  };
+
+  /**
+   * @brief Construct a new QueueLimit object
+   *
+   * @param max_requests the most requests that may wait. If zero, the number
+   * isn't limited
+   * @param max_bytes the most bytes of input data that may wait. If zero, the
+   * size isn't limited
+   */
+  QueueLimit(size_t max_requests, size_t max_bytes)
+    : max_requests_(max_requests), max_bytes_(max_bytes) {}
+
+  /**
+   * @brief Take room for a request in the queue. A request that's larger than
+   * the byte limit is still accepted if nothing else is waiting so it can't be
+   * rejected forever.
+   *
+   * @param bytes size of the request's input tensors
+   * @return std::optional<Ticket> the room or nullopt if the queue is full
+   */
+  [[nodiscard]] std::optional<Ticket> tryAcquire(size_t bytes) {
+    const auto requests = requests_.fetch_add(1, std::memory_order_relaxed);
+    const auto queued = bytes_.fetch_add(bytes, std::memory_order_relaxed);
+    if ((max_requests_ != 0 && requests >= max_requests_) ||
+        (max_bytes_ != 0 && queued != 0 && queued + bytes > max_bytes_)) {
+      requests_.fetch_sub(1, std::memory_order_relaxed);
+      bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+      return std::nullopt;
+    }
+    return Ticket{shared_from_this(), bytes};
+  }
+
+  /// Get the approximate number of requests holding tickets
+  [[nodiscard]] size_t requests() const {
+    return requests_.load(std::memory_order_relaxed);
+  }
+  /// Get the approximate bytes of input data holding tickets
+  [[nodiscard]] size_t bytes() const {
+    return bytes_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  size_t max_requests_;
+  size_t max_bytes_;
+  std::atomic<size_t> requests_{0};
+  std::atomic<size_t> bytes_{0};
+};
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_CORE_QUEUE_LIMIT
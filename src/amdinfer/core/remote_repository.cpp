@@ -0,0 +1,438 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the mirror of a remote model repository in a local cache
+ */
+
+#include "amdinfer/core/remote_repository.hpp"
+
+#include <fcntl.h>   // for open, O_CREAT, O_TRUNC, O_WRONLY
+#include <unistd.h>  // for close, ftruncate, getpid, pwrite
+
+#include <algorithm>     // for max, min, all_of
+#include <array>         // for array
+#include <cerrno>        // for errno, EINTR
+#include <cstdint>       // for uint64_t
+#include <cstdio>        // for snprintf
+#include <exception>     // for exception
+#include <fstream>       // for ofstream, ifstream
+#include <iterator>      // for make_move_iterator
+#include <sstream>       // for istringstream
+#include <system_error>  // for error_code
+#include <utility>       // for move
+
+#include "amdinfer/core/exceptions.hpp"      // for invalid_argument
+#include "amdinfer/observation/logging.hpp"  // for Logger, AMDINFER_LOG_WARN
+#include "amdinfer/util/hash.hpp"            // for xxh64
+#include "amdinfer/util/model_cache.hpp"     // for hashFile, storeInModelC...
+
+namespace fs = std::filesystem;
+
+namespace amdinfer {
+
+namespace {
+
+/// The name of the file that configures each model
+constexpr auto kConfigFile = "config.pbtxt";
+
+std::string toHex(uint64_t value) {
+  std::array<char, sizeof(value) * 2 + 1> hex{};
+  std::snprintf(hex.data(), hex.size(), "%016llx",
+                static_cast<unsigned long long>(value));
+  return hex.data();
+}
+
+std::string hashString(const std::string& value) {
+  return toHex(util::xxh64(value.data(), value.size()));
+}
+
+/// Check that a path stays in the repository so a listing can't write outside
+/// of the mirror
+bool isSafePath(const std::string& path) {
+  const fs::path relative{path};
+  if (path.empty() || relative.is_absolute() || path.back() == '/') {
+    return false;
+  }
+  for (const auto& part : relative) {  // NOLINT(readability-use-anyofallof)
+    if (part == "..") {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Check that a hash is one util::hashFile() makes, which is 16 lowercase hex
+/// digits, so a listing can't use it to name a path outside of the cache
+bool isValidHash(const std::string& hash) {
+  constexpr size_t kHashLength = sizeof(uint64_t) * 2;
+  return hash.size() == kHashLength &&
+         std::all_of(hash.begin(), hash.end(), [](char c) {
+           return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f');
+         });
+}
+
+/// Get the model that a file belongs to, which is its top directory
+std::string getModel(const std::string& path) {
+  const auto separator = path.find('/');
+  return separator == std::string::npos ? "" : path.substr(0, separator);
+}
+
+/// Link a file in the cache to another path, or copy it if it can't be linked
+bool linkFile(const fs::path& source, const fs::path& destination) {
+  return util::storeInModelCache(destination, [&](const fs::path& path) {
+    std::error_code error;
+    fs::create_hard_link(source, path, error);
+    if (error) {
+      fs::copy_file(source, path);
+    }
+  });
+}
+
+}  // namespace
+
+bool isRemoteRepository(const std::string& repository) {
+  return repository.find("://") != std::string::npos;
+}
+
+std::vector<RemoteObject> parseManifest(const std::string& manifest) {
+  std::vector<RemoteObject> objects;
+  std::istringstream stream{manifest};
+  std::string line;
+  while (std::getline(stream, line)) {
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    const auto first = line.find(' ');
+    const auto second =
+      first == std::string::npos ? first : line.find(' ', first + 1);
+    if (second == std::string::npos) {
+      throw invalid_argument("Invalid line in the manifest: " + line);
+    }
+
+    RemoteObject object;
+    try {
+      size_t parsed = 0;
+      object.size = std::stoull(line.substr(0, first), &parsed);
+      if (parsed != first) {
+        throw invalid_argument("");
+      }
+    } catch (const std::exception&) {
+      throw invalid_argument("Invalid size in the manifest: " + line);
+    }
+    object.hash = line.substr(first + 1, second - first - 1);
+    if (object.hash == "-") {
+      object.hash.clear();
+    } else if (!isValidHash(object.hash)) {
+      throw invalid_argument("Invalid hash in the manifest: " + line);
+    }
+    object.path = line.substr(second + 1);
+    objects.push_back(std::move(object));
+  }
+  return objects;
+}
+
+RemoteRepository::RemoteRepository(std::unique_ptr<ObjectStore> store,
+                                   RemoteOptions options)
+  : store_(std::move(store)), options_(std::move(options)) {
+  if (options_.cache.empty()) {
+    throw invalid_argument("Remote repositories need a cache directory");
+  }
+  options_.threads = std::max(options_.threads, size_t{1});
+  options_.chunk_size = std::max(options_.chunk_size, size_t{1});
+  mirror_ = options_.cache / "repositories" / hashString(store_->name());
+}
+
+RemoteRepository::~RemoteRepository() { stop(); }
+
+fs::path RemoteRepository::start() {
+  AMDINFER_IF_LOGGING(Logger logger{Loggers::Server};)
+  auto objects = store_->list();
+  // the mirror is linked again from the cache so files that were removed
+  // from the repository don't linger
+  fs::remove_all(mirror_);
+  fs::create_directories(options_.cache / "objects");
+  fs::create_directories(mirror_);
+
+  // configs go first so the models' devices are known before they're loaded
+  std::vector<File> configs;
+  std::vector<File> files;
+  for (auto& object : objects) {
+    if (!isSafePath(object.path)) {
+      AMDINFER_LOG_WARN(logger, "Skipping " + object.path +
+                                  " as it's outside of the repository");
+      continue;
+    }
+    if (!object.hash.empty() && !isValidHash(object.hash)) {
+      AMDINFER_LOG_WARN(logger, "Skipping " + object.path +
+                                  " as its hash " + object.hash +
+                                  " is invalid");
+      continue;
+    }
+    auto model = getModel(object.path);
+    if (model.empty()) {
+      continue;
+    }
+    File file;
+    file.config = object.path == model + "/" + kConfigFile;
+    file.model = std::move(model);
+    file.object = std::move(object);
+    (file.config ? configs : files).push_back(std::move(file));
+  }
+
+  std::unique_lock lock{mutex_};
+  files_ = std::move(configs);
+  pending_configs_ = files_.size();
+  files_.insert(files_.end(), std::make_move_iterator(files.begin()),
+                std::make_move_iterator(files.end()));
+  for (const auto& file : files_) {
+    auto& model = models_[file.model];
+    if (model.files == 0) {
+      model_order_.push_back(file.model);
+    }
+    model.files++;
+  }
+
+  for (size_t i = 0; i < files_.size(); ++i) {
+    if (linkCached(files_[i])) {
+      done(i, false);
+    } else {
+      queue(i);
+    }
+  }
+
+  const auto threads = std::min(options_.threads, chunks_.size());
+  threads_.reserve(threads);
+  for (size_t i = 0; i < threads; ++i) {
+    threads_.emplace_back(&RemoteRepository::work, this);
+  }
+  cv_.wait(lock, [this]() { return stop_ || pending_configs_ == 0; });
+  return mirror_;
+}
+
+std::vector<std::string> RemoteRepository::models() const {
+  std::lock_guard lock{mutex_};
+  return model_order_;
+}
+
+bool RemoteRepository::waitForModel(const std::string& model) {
+  std::unique_lock lock{mutex_};
+  auto found = models_.find(model);
+  if (found == models_.end()) {
+    return false;
+  }
+  const auto& state = found->second;
+  cv_.wait(lock, [&]() { return stop_ || state.files == 0; });
+  return state.files == 0 && !state.failed;
+}
+
+void RemoteRepository::stop() {
+  {
+    std::lock_guard lock{mutex_};
+    stop_ = true;
+    chunks_.clear();
+  }
+  cv_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+  threads_.clear();
+
+  // remove the parts of files whose downloads were stopped
+  std::error_code error;
+  for (auto& file : files_) {
+    if (file.descriptor >= 0) {
+      close(file.descriptor);
+      file.descriptor = -1;
+      fs::remove(file.temp_path, error);
+    }
+  }
+}
+
+fs::path RemoteRepository::refPath(const RemoteObject& object) const {
+  // without a version or hash, there's no way to tell if a file has changed
+  if (object.etag.empty() && object.hash.empty()) {
+    return {};
+  }
+  const auto key = store_->name() + "\n" + object.path + "\n" + object.etag +
+                   "\n" + object.hash + "\n" + std::to_string(object.size);
+  return options_.cache / "refs" / hashString(key);
+}
+
+bool RemoteRepository::linkCached(const File& file) const {
+  auto hash = file.object.hash;
+  if (hash.empty()) {
+    const auto ref = refPath(file.object);
+    if (ref.empty()) {
+      return false;
+    }
+    std::ifstream stream{ref};
+    if (!(stream >> hash) || !isValidHash(hash)) {
+      return false;
+    }
+  }
+
+  const auto object = options_.cache / "objects" / hash;
+  std::error_code error;
+  if (fs::file_size(object, error) != file.object.size || error) {
+    return false;
+  }
+  return linkFile(object, mirror_ / file.object.path);
+}
+
+void RemoteRepository::queue(size_t index) {
+  auto& file = files_[index];
+  file.temp_path = options_.cache / "objects" /
+                   (".part." + hashString(store_->name() + file.object.path) +
+                    "." + std::to_string(getpid()));
+  file.descriptor =
+    open(file.temp_path.c_str(), O_CREAT | O_TRUNC | O_WRONLY, 0644);
+  if (file.descriptor < 0 ||
+      ftruncate(file.descriptor, static_cast<off_t>(file.object.size)) != 0) {
+    AMDINFER_IF_LOGGING(Logger logger{Loggers::Server};)
+    AMDINFER_LOG_WARN(logger, "Could not create " + file.temp_path.string());
+    done(index, true);
+    return;
+  }
+
+  const auto size = file.object.size;
+  if (size == 0) {
+    // empty files have nothing to download but are still finished by a part
+    file.chunks = 1;
+    chunks_.push_back({index, 0, 0});
+    return;
+  }
+  file.chunks = (size + options_.chunk_size - 1) / options_.chunk_size;
+  for (size_t offset = 0; offset < size; offset += options_.chunk_size) {
+    chunks_.push_back(
+      {index, offset, std::min(options_.chunk_size, size - offset)});
+  }
+}
+
+void RemoteRepository::work() {
+  std::unique_lock lock{mutex_};
+  while (!stop_ && !chunks_.empty()) {
+    const auto chunk = chunks_.front();
+    chunks_.pop_front();
+    auto& file = files_[chunk.file];
+
+    bool failed = file.failed;
+    if (!failed) {
+      lock.unlock();
+      try {
+        download(chunk);
+      } catch (const std::exception& e) {
+        AMDINFER_IF_LOGGING(Logger logger{Loggers::Server};)
+        AMDINFER_LOG_WARN(logger, "Error downloading " + file.object.path +
+                                    ": " + e.what());
+        failed = true;
+      }
+      lock.lock();
+    }
+
+    file.failed = file.failed || failed;
+    file.chunks--;
+    if (file.chunks > 0) {
+      continue;
+    }
+    if (file.failed) {
+      close(file.descriptor);
+      file.descriptor = -1;
+      std::error_code error;
+      fs::remove(file.temp_path, error);
+      done(chunk.file, true);
+      continue;
+    }
+    lock.unlock();
+    finish(chunk.file);
+    lock.lock();
+  }
+}
+
+void RemoteRepository::download(const Chunk& chunk) {
+  const auto& file = files_[chunk.file];
+  std::vector<char> data(chunk.size);
+  if (chunk.size > 0) {
+    store_->read(file.object, chunk.offset, chunk.size, data.data());
+  }
+
+  size_t written = 0;
+  while (written < chunk.size) {
+    const auto count =
+      pwrite(file.descriptor, data.data() + written, chunk.size - written,
+             static_cast<off_t>(chunk.offset + written));
+    if (count < 0 && errno == EINTR) {
+      continue;
+    }
+    if (count <= 0) {
+      throw runtime_error("Could not write to " + file.temp_path.string());
+    }
+    written += static_cast<size_t>(count);
+  }
+}
+
+void RemoteRepository::finish(size_t index) {
+  AMDINFER_IF_LOGGING(Logger logger{Loggers::Server};)
+  // no other thread touches the file once its last part is downloaded
+  auto& file = files_[index];
+  close(file.descriptor);
+  file.descriptor = -1;
+
+  bool failed = false;
+  std::error_code error;
+  try {
+    const auto hash = util::hashFile(file.temp_path);
+    if (!file.object.hash.empty() && hash != file.object.hash) {
+      throw runtime_error("its hash " + hash + " doesn't match " +
+                          file.object.hash);
+    }
+    // the file is stored under its hash so identical files are stored once
+    const auto object = options_.cache / "objects" / hash;
+    fs::rename(file.temp_path, object);
+    if (const auto ref = refPath(file.object); !ref.empty()) {
+      util::storeInModelCache(ref, [&](const fs::path& path) {
+        std::ofstream{path} << hash;
+      });
+    }
+    if (!linkFile(object, mirror_ / file.object.path)) {
+      throw runtime_error("it couldn't be added to the mirror");
+    }
+  } catch (const std::exception& e) {
+    AMDINFER_LOG_WARN(logger,
+                      "Error storing " + file.object.path + ": " + e.what());
+    fs::remove(file.temp_path, error);
+    failed = true;
+  }
+
+  std::lock_guard lock{mutex_};
+  done(index, failed);
+}
+
+void RemoteRepository::done(size_t index, bool failed) {
+  auto& file = files_[index];
+  file.failed = failed;
+  auto& model = models_[file.model];
+  model.files--;
+  model.failed = model.failed || failed;
+  if (file.config) {
+    pending_configs_--;
+  }
+  cv_.notify_all();
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,203 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the mirror of a remote model repository in a local cache
+ */
+
+#ifndef GUARD_AMDINFER_CORE_REMOTE_REPOSITORY
+#define GUARD_AMDINFER_CORE_REMOTE_REPOSITORY
+
+#include <condition_variable>  // for condition_variable
+#include <cstddef>             // for size_t
+#include <deque>               // for deque
+#include <filesystem>          // for path
+#include <map>                 // for map
+#include <memory>              // for unique_ptr
+#include <mutex>               // for mutex
+#include <string>              // for string
+#include <thread>              // for thread
+#include <vector>              // for vector
+
+namespace amdinfer {
+
+/// A file in a remote repository
+struct RemoteObject {
+  /// path of the file in the repository, such as mnist/1/model.onnx
+  std::string path;
+  /// size of the file in bytes
+  size_t size = 0;
+  /// the version of the file that the store reports, such as its ETag. Empty
+  /// if the store doesn't version its files
+  std::string etag;
+  /// the hash of the file's contents from util::hashFile(), if it's known
+  std::string hash;
+};
+
+/**
+ * @brief A store of files, such as a bucket, that holds a model repository.
+ * Its methods are called from many threads at once.
+ */
+class ObjectStore {
+ public:
+  ObjectStore() = default;
+  ObjectStore(const ObjectStore&) = delete;
+  ObjectStore& operator=(const ObjectStore&) = delete;
+  ObjectStore(ObjectStore&&) = delete;
+  ObjectStore& operator=(ObjectStore&&) = delete;
+  virtual ~ObjectStore() = default;
+
+  /// Get a name that identifies the repository, such as its URL
+  [[nodiscard]] virtual std::string name() const = 0;
+  /// List the files in the repository. It throws if they can't be listed
+  virtual std::vector<RemoteObject> list() = 0;
+  /**
+   * @brief Read part of a file. It throws if the part can't be read whole or
+   * the file has changed from the version that was listed.
+   *
+   * @param object the file to read
+   * @param offset where to start reading in bytes
+   * @param size how many bytes to read
+   * @param data where to write the bytes
+   */
+  virtual void read(const RemoteObject& object, size_t offset, size_t size,
+                    char* data) = 0;
+};
+
+/// Check if a repository is a URL, such as s3://bucket/models, so it's remote
+bool isRemoteRepository(const std::string& repository);
+
+/**
+ * @brief Parse a manifest of a repository's files. Each line is the size of a
+ * file in bytes, its hash or "-" if it has none, and its path, separated by
+ * spaces. Blank lines and lines that start with # are skipped. Hashes must be
+ * the 16 lowercase hex digits that util::hashFile() makes.
+ *
+ * @param manifest the manifest to parse
+ * @return std::vector<RemoteObject>
+ */
+std::vector<RemoteObject> parseManifest(const std::string& manifest);
+
+/// How a remote repository is downloaded
+struct RemoteOptions {
+  /// the directory that holds the downloaded files
+  std::filesystem::path cache;
+  /// how many parts of files are downloaded at once
+  size_t threads = 8;
+  /// the size of each part of a file that's downloaded in one request
+  size_t chunk_size = 8UL << 20;
+};
+
+/**
+ * @brief Mirrors a remote repository in a local directory so its models can
+ * be loaded like those of a local one. Files are downloaded in parts in
+ * parallel into a cache where they're stored under the hash of their contents
+ * so files that haven't changed aren't downloaded again and files that are
+ * the same in different repositories are stored once. Each is checked against
+ * its size and, if it's known, its hash before it's linked into the mirror.
+ *
+ * The configs of the models are downloaded first and the rest of the files
+ * model by model in the order they're listed so models can be loaded as soon
+ * as their own files arrive.
+ */
+class RemoteRepository {
+ public:
+  /**
+   * @brief Construct a new RemoteRepository object
+   *
+   * @param store the store that holds the repository
+   * @param options how to download it
+   */
+  RemoteRepository(std::unique_ptr<ObjectStore> store, RemoteOptions options);
+  RemoteRepository(const RemoteRepository&) = delete;
+  RemoteRepository& operator=(const RemoteRepository&) = delete;
+  RemoteRepository(RemoteRepository&&) = delete;
+  RemoteRepository& operator=(RemoteRepository&&) = delete;
+  /// Destructor. Downloads that haven't finished are stopped
+  ~RemoteRepository();
+
+  /**
+   * @brief List the repository, download the configs of its models and start
+   * downloading the rest of its files in the background. It throws if the
+   * repository can't be listed
+   *
+   * @return std::filesystem::path the local directory that mirrors it
+   */
+  std::filesystem::path start();
+  /// Get the models in the repository in the order they're downloaded
+  [[nodiscard]] std::vector<std::string> models() const;
+  /**
+   * @brief Wait until all the files of a model are in the mirror
+   *
+   * @param model name of the model
+   * @return bool - false if any of its files failed to download or the
+   * downloads were stopped
+   */
+  bool waitForModel(const std::string& model);
+  /// Stop downloading. Parts that are downloading still finish
+  void stop();
+
+ private:
+  struct File {
+    RemoteObject object;
+    std::string model;
+    /// the file that the parts are written to
+    std::filesystem::path temp_path;
+    int descriptor = -1;
+    /// the parts that haven't been downloaded yet
+    size_t chunks = 0;
+    bool config = false;
+    bool failed = false;
+  };
+  struct Model {
+    size_t files = 0;
+    bool failed = false;
+  };
+  struct Chunk {
+    size_t file;
+    size_t offset;
+    size_t size;
+  };
+
+  /// Link the file into the mirror if the cache has it already
+  bool linkCached(const File& file) const;
+  /// Set up the temporary file and queue the parts of a file to download
+  void queue(size_t index);
+  void work();
+  void download(const Chunk& chunk);
+  /// Verify a downloaded file and move it into the cache and the mirror
+  void finish(size_t index);
+  /// Record that a file is done. The lock must be held
+  void done(size_t index, bool failed);
+  [[nodiscard]] std::filesystem::path refPath(const RemoteObject& object) const;
+
+  std::unique_ptr<ObjectStore> store_;
+  RemoteOptions options_;
+  std::filesystem::path mirror_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::vector<File> files_;
+  std::vector<std::string> model_order_;
+  std::map<std::string, Model> models_;
+  std::deque<Chunk> chunks_;
+  size_t pending_configs_ = 0;
+  bool stop_ = false;
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_CORE_REMOTE_REPOSITORY
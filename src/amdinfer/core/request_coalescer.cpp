@@ -0,0 +1,105 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the coalescing of identical requests that are in flight at
+ * the same time
+ */
+
+#include "amdinfer/core/request_coalescer.hpp"
+
+#include <utility>  // for move
+
+#include "amdinfer/build_options.hpp"            // for AMDINFER_ENABLE_METRICS
+#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/core/parameters.hpp"          // for ParameterMap
+#include "amdinfer/core/request_container.hpp"   // for RequestContainer
+#include "amdinfer/core/response_cache.hpp"      // for ResponseCache
+#include "amdinfer/observation/metrics.hpp"      // for Metrics
+
+namespace amdinfer {
+
+std::optional<RequestKey> RequestCoalescer::key(
+  const RequestContainer& request) {
+  const auto& parameters = request.request->getParameters();
+  if (parameters.has("coalesce") && !parameters.get<bool>("coalesce")) {
+    return std::nullopt;
+  }
+  return ResponseCache::hash(request);
+}
+
+bool RequestCoalescer::join(const RequestKey& key,
+                            InferenceRequest* request) {
+  {
+    std::lock_guard lock{mutex_};
+    auto [iterator, inserted] = in_flight_.try_emplace(key);
+    if (inserted) {
+      iterator->second.leader = request->getCallback();
+      return false;
+    }
+    iterator->second.waiters.push_back(
+      {request->getID(), request->getCallback()});
+  }
+#ifdef AMDINFER_ENABLE_METRICS
+  Metrics::getInstance().incrementCounter(MetricCounterIDs::RequestsCoalesced);
+#endif
+  return true;
+}
+
+void RequestCoalescer::finish(const RequestKey& key,
+                              const InferenceResponse& response) {
+  Flight flight;
+  {
+    std::lock_guard lock{mutex_};
+    if (auto iterator = in_flight_.find(key); iterator != in_flight_.end()) {
+      flight = std::move(iterator->second);
+      in_flight_.erase(iterator);
+    }
+  }
+
+  // the response's data may only be valid until its own callback returns so
+  // the waiters are answered here rather than later
+  for (auto& waiter : flight.waiters) {
+    auto copy = response;
+    copy.setID(waiter.id);
+    waiter.callback(copy);
+  }
+  if (flight.leader) {
+    flight.leader(response);
+  }
+}
+
+bool RequestCoalescer::detach(const RequestKey& key,
+                              ResponseCallback* callback) {
+  std::lock_guard lock{mutex_};
+  auto iterator = in_flight_.find(key);
+  if (iterator == in_flight_.end()) {
+    return false;
+  }
+  *callback = std::move(iterator->second.leader);
+  if (iterator->second.waiters.empty()) {
+    in_flight_.erase(iterator);
+    return false;
+  }
+  return true;
+}
+
+size_t RequestCoalescer::size() const {
+  std::lock_guard lock{mutex_};
+  return in_flight_.size();
+}
+
+}  // namespace amdinfer
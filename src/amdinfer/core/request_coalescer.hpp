@@ -0,0 +1,119 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the coalescing of identical requests that are in flight at
+ * the same time
+ */
+
+#ifndef GUARD_AMDINFER_CORE_REQUEST_COALESCER
+#define GUARD_AMDINFER_CORE_REQUEST_COALESCER
+
+#include <cstddef>        // for size_t
+#include <mutex>          // for mutex
+#include <optional>       // for optional
+#include <string>         // for string
+#include <unordered_map>  // for unordered_map
+#include <vector>         // for vector
+
+#include "amdinfer/core/request_key.hpp"        // for RequestKey, Reque...
+#include "amdinfer/core/response_callback.hpp"  // for ResponseCallback
+
+namespace amdinfer {
+
+class InferenceRequest;
+class InferenceResponse;
+struct RequestContainer;
+
+/**
+ * @brief Coalesces the identical requests to an endpoint that arrive while one
+ * of them is queued or running. The first is run as usual and the others wait
+ * for its response instead of running the model again. If the first is
+ * abandoned by its client, it's detached and still run for the others.
+ * Requests are identified by the same hash as the response cache. This is safe
+ * to use from multiple threads at once.
+ */
+class RequestCoalescer {
+ public:
+  /**
+   * @brief Get the key of a request. Requests with the "coalesce" parameter set
+   * to false aren't coalesced and neither are requests whose input data is only
+   * written into the batch later.
+   *
+   * @param request the request to identify
+   * @return std::optional<RequestKey> the key or nullopt if it isn't
+   * coalesced
+   */
+  [[nodiscard]] static std::optional<RequestKey> key(
+    const RequestContainer& request);
+
+  /**
+   * @brief Attach a request to the identical one in flight, if there is one.
+   * The request's callback is taken to be run with that request's response.
+   * Otherwise, the request is the one in flight for its key until finish() is
+   * called with its response. Its callback is taken too and it's answered last
+   * so its callback should be set to call finish().
+   *
+   * @param key the key of the request
+   * @param request the request to attach
+   * @return bool - true if the request was attached and shouldn't be run
+   */
+  bool join(const RequestKey& key, InferenceRequest* request);
+
+  /**
+   * @brief Answer the requests attached to the one in flight for a key and
+   * then the request itself with its response. Later requests with the key are
+   * run again.
+   *
+   * @param key the key of the request in flight
+   * @param response its response
+   */
+  void finish(const RequestKey& key, const InferenceResponse& response);
+
+  /**
+   * @brief Detach the request in flight for a key from the requests attached
+   * to it, such as when its client cancels it, and give back the callback it
+   * joined with. If any are attached, they still wait for finish() so the
+   * request should still run. Otherwise, later requests with the key are run
+   * again and the request's own finish() must not be called.
+   *
+   * @param key the key of the request in flight
+   * @param callback set to the callback the request joined with
+   * @return bool - true if requests are attached and it should still run
+   */
+  bool detach(const RequestKey& key, ResponseCallback* callback);
+
+  /// Get the number of requests in flight that others may attach to
+  [[nodiscard]] size_t size() const;
+
+ private:
+  struct Waiter {
+    std::string id;
+    ResponseCallback callback;
+  };
+
+  struct Flight {
+    /// the callback of the request that's run, which is empty once detached
+    ResponseCallback leader;
+    std::vector<Waiter> waiters;
+  };
+
+  std::unordered_map<RequestKey, Flight, RequestKeyHash> in_flight_;
+  mutable std::mutex mutex_;
+};
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_CORE_REQUEST_COALESCER
@@ -22,18 +22,97 @@
 #ifndef GUARD_AMDINFER_CORE_REQUEST_CONTAINER_INTERNAL
 #define GUARD_AMDINFER_CORE_REQUEST_CONTAINER_INTERNAL
 
+#include <array>            // for array
+#include <atomic>           // for atomic
+#include <cstddef>          // for size_t, byte
+#include <functional>       // for function
+#include <memory_resource>  // for monotonic_buffer_resource
+#include <vector>           // for vector
+
 #include "amdinfer/build_options.hpp"
+#include "amdinfer/core/queue_limit.hpp"     // for QueueLimit
+#include "amdinfer/core/request_key.hpp"     // for RequestKey
+#include "amdinfer/core/request_timing.hpp"  // for RequestTimingPtr
 #include "amdinfer/declarations.hpp"
+#include "amdinfer/util/timer.hpp"           // for TimePoint
 
 namespace amdinfer {
 
+class RequestCoalescer;
+
+/**
+ * @brief An input writer deserializes one input tensor of a request directly
+ * into a buffer at the given offset. Protocol layers that support it can defer
+ * the decoding to the batcher so the data is written once into the batch
+ * buffer instead of being staged in an intermediate ingress buffer.
+ */
+using InputWriter = std::function<void(Buffer* buffer, size_t offset)>;
+
+/// Bytes stored in each container for its per-input vectors
+constexpr size_t kRequestArenaSize = 512;
+
 struct RequestContainer {
+  RequestContainer() : input_writers(&arena_), input_views(&arena_) {}
+  // the vectors allocate from the container's own arena so it can't be moved
+  RequestContainer(const RequestContainer&) = delete;
+  RequestContainer(RequestContainer&&) = delete;
+  RequestContainer& operator=(const RequestContainer&) = delete;
+  RequestContainer& operator=(RequestContainer&&) = delete;
+  ~RequestContainer() = default;
+
+ private:
+  /**
+   * @brief The per-input vectors are allocated from this buffer, which is part
+   * of the container, so requests with a few inputs don't allocate for them.
+   * Larger requests fall back to the heap and it's all freed with the
+   * container.
+   */
+  std::array<std::byte, kRequestArenaSize> arena_buffer_;
+  std::pmr::monotonic_buffer_resource arena_{
+    arena_buffer_.data(), arena_buffer_.size(), std::pmr::new_delete_resource()};
+
+ public:
   InferenceRequestPtr request;
+  /// If not empty, there's one writer per input and the input data is unset
+  std::pmr::vector<InputWriter> input_writers;
+  /**
+   * @brief If not empty, there's one entry per input pointing at its already
+   * serialized bytes in the protocol message. The message outlives the request
+   * so these may be read in place instead of being written to a buffer.
+   */
+  std::pmr::vector<const void*> input_views;
+  /**
+   * @brief If true, some views point at GPU memory so only workers that accept
+   * device inputs may read them in place. Others use the writers, which copy
+   * the data to the host.
+   */
+  bool device_views = false;
+  /// If set, the request's timing is recorded here to return with its response
+  RequestTimingPtr timing;
+  /// The request's room in its endpoint's queue, if the queue is bounded
+  QueueLimit::Ticket queue_ticket;
+  /**
+   * @brief If set, the protocol sets this flag when the client cancels the
+   * request. It's valid until the request's callback is run.
+   */
+  const std::atomic<bool>* cancelled = nullptr;
+  /// The request is dropped if it's still queued when this time passes
+  util::TimePoint deadline = util::TimePoint::max();
+  /**
+   * @brief If set, identical requests may be attached to this one and answered
+   * with its response, so it's detached from them instead of dropped when it's
+   * abandoned. It's valid until the request's callback is run.
+   */
+  RequestCoalescer* coalescer = nullptr;
+  /// The key the request is in flight with in its coalescer, if it's set
+  RequestKey coalesce_key;
 #ifdef AMDINFER_ENABLE_TRACING
   TracePtr trace;
 #endif
 #ifdef AMDINFER_ENABLE_METRICS
-  std::chrono::_V2::system_clock::time_point start_time;
+  util::TimePoint start_time;
+  /// when the request was added to its batcher's queue
+  util::TimePoint enqueue_time;
 #endif
 };
 
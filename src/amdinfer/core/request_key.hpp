@@ -0,0 +1,55 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the key that identical requests share
+ */
+
+#ifndef GUARD_AMDINFER_CORE_REQUEST_KEY
+#define GUARD_AMDINFER_CORE_REQUEST_KEY
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint64_t
+
+namespace amdinfer {
+
+/**
+ * @brief Identifies a request by two independently seeded hashes of its
+ * parameters and inputs. Requests are only taken to be identical if both
+ * match so the response of one request isn't given to another whose hash just
+ * collides with it.
+ */
+struct RequestKey {
+  /// the hash that the cache and coalescer look requests up by
+  uint64_t hash = 0;
+  /// the hash that checks that a request found by the first is the same
+  uint64_t check = 0;
+
+  /// Check if the keys are of identical requests
+  bool operator==(const RequestKey& other) const {
+    return hash == other.hash && check == other.check;
+  }
+  /// Check if the keys are of different requests
+  bool operator!=(const RequestKey& other) const { return !(*this == other); }
+};
+
+/// Hashes a RequestKey for unordered containers
+struct RequestKeyHash {
+  size_t operator()(const RequestKey& key) const { return key.hash; }
+};
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_CORE_REQUEST_KEY
@@ -0,0 +1,66 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the timing of a request that clients can ask to be
+ * returned with its response
+ */
+
+#include "amdinfer/core/request_timing.hpp"
+
+#include <chrono>   // for duration
+#include <cstdint>  // for int32_t
+#include <string>   // for string
+#include <variant>  // for bad_variant_access
+
+#include "amdinfer/core/exceptions.hpp"  // for invalid_argument
+
+namespace amdinfer {
+
+namespace {
+
+/// Get the microseconds between two times or 0 if either isn't set
+double elapsed(util::TimePoint start, util::TimePoint stop) {
+  if (start == util::TimePoint{} || stop == util::TimePoint{}) {
+    return 0;
+  }
+  const std::chrono::duration<double, std::micro> duration = stop - start;
+  return duration.count();
+}
+
+}  // namespace
+
+bool RequestTiming::requested(const ParameterMap& parameters) {
+  if (!parameters.has(kRequestTiming)) {
+    return false;
+  }
+  try {
+    return parameters.get<bool>(kRequestTiming);
+  } catch (const std::bad_variant_access&) {
+    throw invalid_argument("Parameter '" + std::string{kRequestTiming} +
+                           "' must be a boolean");
+  }
+}
+
+ParameterMap RequestTiming::parameters() const {
+  ParameterMap parameters;
+  parameters.put(kTimingQueue, elapsed(enqueued, batched));
+  parameters.put(kTimingBatchWait, elapsed(batched, taken));
+  parameters.put(kTimingCompute, elapsed(taken, util::getTime()));
+  parameters.put(kTimingBatchSize, static_cast<int32_t>(batch_size));
+  return parameters;
+}
+
+}  // namespace amdinfer
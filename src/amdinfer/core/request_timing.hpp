@@ -0,0 +1,81 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the timing of a request that clients can ask to be returned
+ * with its response
+ */
+
+#ifndef GUARD_AMDINFER_CORE_REQUEST_TIMING
+#define GUARD_AMDINFER_CORE_REQUEST_TIMING
+
+#include <cstddef>  // for size_t
+#include <memory>   // for shared_ptr
+
+#include "amdinfer/core/parameters.hpp"  // for ParameterMap
+#include "amdinfer/util/timer.hpp"       // for TimePoint
+
+namespace amdinfer {
+
+/// The boolean parameter of a request that asks for its timing
+constexpr auto kRequestTiming = "timing";
+/// The response parameter with the microseconds spent in the batcher's queue
+constexpr auto kTimingQueue = "queue_time_us";
+/// The response parameter with the microseconds waiting for the batch to run
+constexpr auto kTimingBatchWait = "batch_wait_us";
+/// The response parameter with the microseconds the worker took to respond
+constexpr auto kTimingCompute = "compute_time_us";
+/// The response parameter with the size of the batch the request ran in
+constexpr auto kTimingBatchSize = "batch_size";
+
+/**
+ * @brief The times a request reaches each stage on its way to the worker. The
+ * server creates one for the requests that ask for it and adds it to their
+ * responses. Each time is set once, by the thread that owns the request at
+ * that stage, before the request is passed on.
+ */
+struct RequestTiming {
+  /// when the request was added to its batcher's queue
+  util::TimePoint enqueued;
+  /// when the batcher took the request from the queue to add to a batch
+  util::TimePoint batched;
+  /// when a worker took the batch
+  util::TimePoint taken;
+  /// number of requests in the batch
+  size_t batch_size = 0;
+
+  /**
+   * @brief Check if a request asks for its timing. It throws if the parameter
+   * isn't a boolean
+   *
+   * @param parameters the request's parameters
+   */
+  static bool requested(const ParameterMap& parameters);
+
+  /**
+   * @brief Get the timing as response parameters, where the worker's time
+   * ends now. Stages the request skipped, such as when it's served from a
+   * cache, take no time and the batch size is 0 if it never ran in a batch.
+   *
+   * @return ParameterMap
+   */
+  [[nodiscard]] ParameterMap parameters() const;
+};
+
+using RequestTimingPtr = std::shared_ptr<RequestTiming>;
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_CORE_REQUEST_TIMING
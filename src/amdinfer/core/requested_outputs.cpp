@@ -0,0 +1,103 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements how the outputs that a request asks for are chosen
+ */
+
+#include "amdinfer/core/requested_outputs.hpp"
+
+#include <algorithm>  // for find, min, all_of, none_of
+#include <utility>    // for move
+
+#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+
+namespace amdinfer {
+
+std::vector<SelectedOutput> selectOutputs(const InferenceRequest& request,
+                                          const std::vector<std::string>& names,
+                                          size_t count,
+                                          const std::string& default_name) {
+  const auto& outputs = request.getOutputs();
+  const auto nameOf = [&](size_t index) {
+    return index < names.size() && default_name.empty() ? names[index]
+                                                        : default_name;
+  };
+
+  std::vector<SelectedOutput> selected;
+  if (outputs.empty()) {
+    selected.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+      selected.push_back({i, nameOf(i)});
+    }
+    return selected;
+  }
+
+  selected.reserve(outputs.size());
+  for (const auto& output : outputs) {
+    const auto name = output.getName();
+    const auto found = std::find(names.begin(), names.end(), name);
+    if (found == names.end()) {
+      selected.clear();
+      break;
+    }
+    selected.push_back({static_cast<size_t>(found - names.begin()), name});
+  }
+  if (!selected.empty()) {
+    return selected;
+  }
+
+  // the request's outputs rename the model's in order
+  const auto used = std::min(outputs.size(), count);
+  for (size_t i = 0; i < used; ++i) {
+    auto name = outputs[i].getName();
+    selected.push_back({i, name.empty() ? nameOf(i) : std::move(name)});
+  }
+  return selected;
+}
+
+std::vector<std::string> getRequestedOutputs(const InferenceRequest& request) {
+  std::vector<std::string> requested;
+  const auto& outputs = request.getOutputs();
+  requested.reserve(outputs.size());
+  for (const auto& output : outputs) {
+    requested.push_back(output.getName());
+  }
+  return requested;
+}
+
+void filterOutputs(InferenceResponse* response,
+                   const std::vector<std::string>& requested) {
+  const auto& outputs = response->getOutputs();
+  const auto wanted = [&requested](const InferenceResponseOutput& output) {
+    return std::find(requested.begin(), requested.end(), output.getName()) !=
+           requested.end();
+  };
+  if (std::all_of(outputs.begin(), outputs.end(), wanted) ||
+      std::none_of(outputs.begin(), outputs.end(), wanted)) {
+    return;
+  }
+
+  // moving the outputs out leaves the response without any to add them back
+  auto all = std::move(*response).getOutputs();
+  for (auto& output : all) {
+    if (wanted(output)) {
+      response->addOutput(std::move(output));
+    }
+  }
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,80 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines how the outputs that a request asks for are chosen
+ */
+
+#ifndef GUARD_AMDINFER_CORE_REQUESTED_OUTPUTS
+#define GUARD_AMDINFER_CORE_REQUESTED_OUTPUTS
+
+#include <cstddef>  // for size_t
+#include <string>   // for string
+#include <vector>   // for vector
+
+namespace amdinfer {
+
+class InferenceRequest;
+class InferenceResponse;
+
+/// An output of the model to return and the name to return it with
+struct SelectedOutput {
+  size_t index;
+  std::string name;
+};
+
+/**
+ * @brief Choose which of a model's outputs to return for a request so workers
+ * only copy those. If the request doesn't list any outputs, all of them are
+ * returned. If every output it lists is one of the model's, only those are
+ * returned in the request's order. Otherwise, the request's outputs name the
+ * model's outputs in order and only that many are returned.
+ *
+ * @param request the request to choose the outputs of
+ * @param names the names of the model's outputs, which may be empty if the
+ * model doesn't name them
+ * @param count the number of the model's outputs
+ * @param default_name the name of outputs that the request doesn't name or
+ * empty to use the model's names
+ * @return std::vector<SelectedOutput>
+ */
+[[nodiscard]] std::vector<SelectedOutput> selectOutputs(
+  const InferenceRequest& request, const std::vector<std::string>& names,
+  size_t count, const std::string& default_name);
+
+/**
+ * @brief Get the names of the outputs that a request asks for
+ *
+ * @param request the request to check
+ * @return std::vector<std::string> - the names, which is empty if the request
+ * doesn't list any and so accepts all of them
+ */
+[[nodiscard]] std::vector<std::string> getRequestedOutputs(
+  const InferenceRequest& request);
+
+/**
+ * @brief Remove the outputs of a response that weren't requested so they
+ * aren't serialized. If none of the response's outputs were requested, such as
+ * when the worker names its outputs differently, it's left as it is.
+ *
+ * @param response the response to change
+ * @param requested the names of the requested outputs
+ */
+void filterOutputs(InferenceResponse* response,
+                   const std::vector<std::string>& requested);
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_CORE_REQUESTED_OUTPUTS
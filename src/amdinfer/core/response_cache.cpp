@@ -0,0 +1,186 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the cache of responses that an endpoint can answer
+ * repeated requests from
+ */
+
+#include "amdinfer/core/response_cache.hpp"
+
+#include <cstddef>  // for byte, size_t
+#include <cstdint>  // for uint64_t
+#include <cstring>  // for memcpy
+#include <utility>  // for move
+#include <vector>   // for vector
+
+#include "amdinfer/build_options.hpp"           // for AMDINFER_ENABLE_METRICS
+#include "amdinfer/core/data_types.hpp"         // for DataType
+#include "amdinfer/core/inference_request.hpp"  // for InferenceRequest
+#include "amdinfer/core/parameters.hpp"         // for ParameterMap
+#include "amdinfer/core/request_container.hpp"  // for RequestContainer
+#include "amdinfer/observation/metrics.hpp"     // for Metrics
+#include "amdinfer/util/hash.hpp"               // for xxh64
+
+namespace amdinfer {
+
+namespace {
+
+/// the seed of the hash that checks a key, which is arbitrary but not zero
+constexpr uint64_t kCheckSeed = 0x9E3779B97F4A7C15ULL;
+
+size_t outputBytes(const InferenceResponseOutput& output) {
+  return output.getSize() * output.getDatatype().size();
+}
+
+/// Make an output like the given one without its data
+InferenceResponseOutput emptyOutput(const InferenceResponseOutput& output) {
+  InferenceResponseOutput copy;
+  copy.setName(output.getName());
+  copy.setShape(output.getShape());
+  copy.setDatatype(output.getDatatype());
+  copy.setParameters(output.getParameters());
+  return copy;
+}
+
+}  // namespace
+
+ResponseCache::ResponseCache(size_t capacity) : capacity_(capacity) {}
+
+std::optional<RequestKey> ResponseCache::key(const RequestContainer& request) {
+  const auto& parameters = request.request->getParameters();
+  if (parameters.has("cache") && !parameters.get<bool>("cache")) {
+    return std::nullopt;
+  }
+  return hash(request);
+}
+
+std::optional<RequestKey> ResponseCache::hash(
+  const RequestContainer& request) {
+  const auto& inputs = request.request->getInputs();
+  // inputs that are only decoded into the batch or are in GPU memory aren't
+  // on the host to hash
+  if ((!request.input_writers.empty() && request.input_views.empty()) ||
+      request.device_views) {
+    return std::nullopt;
+  }
+  const auto& parameters = request.request->getParameters();
+
+  std::vector<std::byte> serialized(parameters.serializeSize());
+  parameters.serialize(serialized.data());
+  RequestKey key{0, kCheckSeed};
+  const auto add = [&key](const void* data, size_t size) {
+    key.hash = util::xxh64(data, size, key.hash);
+    key.check = util::xxh64(data, size, key.check);
+  };
+  add(serialized.data(), serialized.size());
+  for (auto i = 0U; i < inputs.size(); ++i) {
+    const auto& input = inputs[i];
+    const auto& name = input.getName();
+    const auto& shape = input.getShape();
+    const auto datatype = static_cast<int>(input.getDatatype());
+    add(name.data(), name.size());
+    add(shape.data(), shape.size() * sizeof(shape[0]));
+    add(&datatype, sizeof(datatype));
+
+    const auto* data =
+      request.input_views.empty() ? input.getData() : request.input_views[i];
+    add(data, input.getSize() * input.getDatatype().size());
+  }
+  return key;
+}
+
+std::optional<InferenceResponse> ResponseCache::get(const RequestKey& key) {
+  std::shared_ptr<const InferenceResponse> cached;
+  {
+    std::lock_guard lock{mutex_};
+    if (auto iterator = index_.find(key); iterator != index_.end()) {
+      entries_.splice(entries_.begin(), entries_, iterator->second);
+      cached = iterator->second->response;
+    }
+  }
+#ifdef AMDINFER_ENABLE_METRICS
+  Metrics::getInstance().incrementCounter(
+    cached != nullptr ? MetricCounterIDs::ResponseCacheHit
+                      : MetricCounterIDs::ResponseCacheMiss);
+#endif
+  if (cached == nullptr) {
+    return std::nullopt;
+  }
+
+  // the outputs point into the cached response and keep it alive so it can be
+  // dropped from the cache while the response is being sent
+  InferenceResponse response;
+  response.setModel(cached->getModel());
+  for (const auto& output : cached->getOutputs()) {
+    auto copy = emptyOutput(output);
+    std::shared_ptr<std::byte> data{cached,
+                                    static_cast<std::byte*>(output.getData())};
+    copy.setData(std::move(data), outputBytes(output));
+    response.addOutput(std::move(copy));
+  }
+  return response;
+}
+
+void ResponseCache::put(const RequestKey& key,
+                        const InferenceResponse& response) {
+  if (response.isError()) {
+    return;
+  }
+  size_t bytes = 0;
+  for (const auto& output : response.getOutputs()) {
+    bytes += outputBytes(output);
+  }
+  if (bytes > capacity_) {
+    return;
+  }
+
+  // the outputs may borrow memory pool buffers, which shouldn't be held by the
+  // cache, so the data is copied
+  auto cached = std::make_shared<InferenceResponse>();
+  cached->setModel(response.getModel());
+  for (const auto& output : response.getOutputs()) {
+    auto copy = emptyOutput(output);
+    std::vector<std::byte> data(outputBytes(output));
+    if (!data.empty()) {
+      std::memcpy(data.data(), output.getData(), data.size());
+    }
+    copy.setData(std::move(data));
+    cached->addOutput(std::move(copy));
+  }
+
+  std::lock_guard lock{mutex_};
+  if (auto iterator = index_.find(key); iterator != index_.end()) {
+    size_ -= iterator->second->bytes;
+    entries_.erase(iterator->second);
+    index_.erase(iterator);
+  }
+  while (size_ + bytes > capacity_) {
+    const auto& last = entries_.back();
+    size_ -= last.bytes;
+    index_.erase(last.key);
+    entries_.pop_back();
+  }
+  entries_.push_front({key, std::move(cached), bytes});
+  index_.try_emplace(key, entries_.begin());
+  size_ += bytes;
+}
+
+size_t ResponseCache::size() const {
+  std::lock_guard lock{mutex_};
+  return size_;
+}
+
+}  // namespace amdinfer
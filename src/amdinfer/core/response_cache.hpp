@@ -0,0 +1,115 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the cache of responses that an endpoint can answer repeated
+ * requests from
+ */
+
+#ifndef GUARD_AMDINFER_CORE_RESPONSE_CACHE
+#define GUARD_AMDINFER_CORE_RESPONSE_CACHE
+
+#include <cstddef>        // for size_t
+#include <list>           // for list
+#include <memory>         // for shared_ptr
+#include <mutex>          // for mutex
+#include <optional>       // for optional
+#include <unordered_map>  // for unordered_map
+
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/core/request_key.hpp"         // for RequestKey
+
+namespace amdinfer {
+
+struct RequestContainer;
+
+/**
+ * @brief A least-recently-used cache of the responses of an endpoint. Requests
+ * are identified by two differently seeded XXH64 hashes of their input tensors
+ * and parameters so a repeated request can be answered without running the
+ * model. The cache is safe to use from multiple threads at once.
+ */
+class ResponseCache {
+ public:
+  /**
+   * @brief Construct a new ResponseCache object
+   *
+   * @param capacity the most bytes of output data to keep. Responses larger
+   * than this aren't cached
+   */
+  explicit ResponseCache(size_t capacity);
+
+  /**
+   * @brief Get the key of a request. Requests with the "cache" parameter set
+   * to false aren't cached and neither are requests whose input data is only
+   * written into the batch later.
+   *
+   * @param request the request to identify
+   * @return std::optional<RequestKey> the key or nullopt if it isn't cached
+   */
+  [[nodiscard]] static std::optional<RequestKey> key(
+    const RequestContainer& request);
+  /**
+   * @brief Get the hash of a request's parameters and input tensors, which
+   * identifies identical requests. Requests whose input data is only written
+   * into the batch later can't be hashed.
+   *
+   * @param request the request to hash
+   * @return std::optional<RequestKey> the hash or nullopt if it can't be
+   * hashed
+   */
+  [[nodiscard]] static std::optional<RequestKey> hash(
+    const RequestContainer& request);
+
+  /**
+   * @brief Get the response for a key. The response shares the data of the
+   * cached one so no tensor data is copied.
+   *
+   * @param key the key of the request
+   * @return std::optional<InferenceResponse> the response or nullopt on a miss
+   */
+  [[nodiscard]] std::optional<InferenceResponse> get(const RequestKey& key);
+
+  /**
+   * @brief Save a copy of a response. Errors aren't saved and the least
+   * recently used responses are dropped until the new one fits.
+   *
+   * @param key the key of the request
+   * @param response the response to save
+   */
+  void put(const RequestKey& key, const InferenceResponse& response);
+
+  /// Get the number of bytes of output data in the cache
+  [[nodiscard]] size_t size() const;
+
+ private:
+  struct Entry {
+    RequestKey key;
+    std::shared_ptr<const InferenceResponse> response;
+    size_t bytes;
+  };
+
+  size_t capacity_;
+  size_t size_ = 0;
+  /// the most recently used entry is at the front
+  std::list<Entry> entries_;
+  std::unordered_map<RequestKey, std::list<Entry>::iterator, RequestKeyHash>
+    index_;
+  mutable std::mutex mutex_;
+};
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_CORE_RESPONSE_CACHE
@@ -0,0 +1,289 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the system and GPU shared memory regions that clients on
+ * the same host can pass tensors through
+ */
+
+#include "amdinfer/core/shared_memory.hpp"
+
+#include <cmath>    // for floor
+#include <cstdint>  // for int32_t
+#include <limits>   // for numeric_limits
+#include <utility>  // for move
+#include <variant>  // for bad_variant_access
+
+#include "amdinfer/buffers/shared_memory.hpp"    // for SharedMemoryBuffer
+#include "amdinfer/build_options.hpp"            // for AMDINFER_ENABLE_MI...
+#include "amdinfer/core/exceptions.hpp"          // for invalid_argument
+#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse...
+#include "amdinfer/core/request_container.hpp"   // for RequestContainer
+
+#ifdef AMDINFER_ENABLE_MIGRAPHX
+#include "amdinfer/buffers/hip_shared_memory.hpp"  // for HipSharedMemory...
+#endif
+
+namespace amdinfer {
+
+namespace {
+
+/// Read a size from the parameters, which may be too large for an int32
+size_t getSize(const ParameterMap& parameters, const std::string& key,
+               const std::string& tensor) {
+  double value = -1;
+  try {
+    value = parameters.get<int32_t>(key);
+  } catch (const std::bad_variant_access&) {
+    try {
+      value = parameters.get<double>(key);
+    } catch (const std::bad_variant_access&) {
+      // the error is thrown below
+    }
+  }
+  if (value < 0 || std::floor(value) != value) {
+    throw invalid_argument("Parameter '" + key + "' of tensor " + tensor +
+                           " must be a non-negative integer");
+  }
+  return static_cast<size_t>(value);
+}
+
+void putSize(ParameterMap* parameters, const std::string& key, size_t value) {
+  parameters->erase(key);
+  if (value <= static_cast<size_t>(std::numeric_limits<int32_t>::max())) {
+    parameters->put(key, static_cast<int32_t>(value));
+  } else {
+    parameters->put(key, static_cast<double>(value));
+  }
+}
+
+std::shared_ptr<Buffer> map(const SharedMemoryRegion& region) {
+  if (region.allocator == MemoryAllocators::SharedMemory) {
+    return std::make_shared<SharedMemoryBuffer>(region.key, region.offset,
+                                                region.byte_size);
+  }
+#ifdef AMDINFER_ENABLE_MIGRAPHX
+  if (region.allocator == MemoryAllocators::HipSharedMemory) {
+    return std::make_shared<HipSharedMemoryBuffer>(
+      region.key, region.device, region.offset, region.byte_size);
+  }
+#endif
+  throw invalid_argument("Shared memory region " + region.name +
+                         " is a kind of memory this server doesn't support");
+}
+
+}  // namespace
+
+void* SharedMemoryBlock::data() const { return buffer->data(offset); }
+
+bool SharedMemoryBlock::onDevice() const {
+  return buffer->getAllocator() == MemoryAllocators::HipSharedMemory;
+}
+
+void SharedMemoryRegistry::add(const SharedMemoryRegion& region) {
+  if (region.name.empty()) {
+    throw invalid_argument("Shared memory regions must have a name");
+  }
+  // mapping the memory may be slow so it's done outside the lock
+  auto buffer = map(region);
+
+  std::lock_guard lock{mutex_};
+  auto [iterator, added] =
+    regions_.try_emplace(region.name, Entry{region, std::move(buffer)});
+  if (!added) {
+    throw invalid_argument("Shared memory region " + region.name +
+                           " is already registered");
+  }
+}
+
+void SharedMemoryRegistry::remove(const std::string& name,
+                                  MemoryAllocators allocator) {
+  std::lock_guard lock{mutex_};
+  if (name.empty()) {
+    for (auto iterator = regions_.begin(); iterator != regions_.end();) {
+      if (iterator->second.region.allocator == allocator) {
+        iterator = regions_.erase(iterator);
+      } else {
+        ++iterator;
+      }
+    }
+    return;
+  }
+  auto iterator = regions_.find(name);
+  if (iterator != regions_.end() &&
+      iterator->second.region.allocator == allocator) {
+    regions_.erase(iterator);
+  }
+}
+
+std::vector<SharedMemoryRegion> SharedMemoryRegistry::status(
+  const std::string& name, MemoryAllocators allocator) const {
+  std::lock_guard lock{mutex_};
+  std::vector<SharedMemoryRegion> regions;
+  if (name.empty()) {
+    regions.reserve(regions_.size());
+    for (const auto& [region_name, entry] : regions_) {
+      if (entry.region.allocator == allocator) {
+        regions.push_back(entry.region);
+      }
+    }
+    return regions;
+  }
+
+  auto iterator = regions_.find(name);
+  if (iterator == regions_.end() ||
+      iterator->second.region.allocator != allocator) {
+    throw invalid_argument("Shared memory region " + name +
+                           " is not registered");
+  }
+  regions.push_back(iterator->second.region);
+  return regions;
+}
+
+SharedMemoryBlock SharedMemoryRegistry::get(const std::string& name,
+                                            size_t offset, size_t size) const {
+  std::lock_guard lock{mutex_};
+  auto iterator = regions_.find(name);
+  if (iterator == regions_.end()) {
+    throw invalid_argument("Shared memory region " + name +
+                           " is not registered");
+  }
+  const auto& [region, buffer] = iterator->second;
+  if (offset > region.byte_size || size > region.byte_size - offset) {
+    throw invalid_argument("Shared memory region " + name + " has " +
+                           std::to_string(region.byte_size) +
+                           " bytes, which is too small for " +
+                           std::to_string(size) + " bytes at offset " +
+                           std::to_string(offset));
+  }
+  return {buffer, offset};
+}
+
+SharedMemoryTensors::SharedMemoryTensors(const SharedMemoryRegistry* registry)
+  : registry_(registry) {}
+
+bool SharedMemoryTensors::uses(const ParameterMap& parameters) {
+  return parameters.has(kSharedMemoryRegion);
+}
+
+bool SharedMemoryTensors::addInput(const InferenceRequestInput& input,
+                                   RequestContainer* container) {
+  const auto& parameters = input.getParameters();
+  if (!uses(parameters)) {
+    return false;
+  }
+
+  size_t byte_size = 0;
+  auto block = find(parameters, input.getName(), &byte_size);
+  const auto bytes = input.getSize() * input.getDatatype().size();
+  if (byte_size != bytes) {
+    throw invalid_argument("Shared memory of input " + input.getName() +
+                           " has " + std::to_string(byte_size) +
+                           " bytes, expected " + std::to_string(bytes));
+  }
+
+  // the region stays mapped while the request's callback holds this object
+  auto* data = block.data();
+  if (block.onDevice()) {
+    // batchers for workers that can't read GPU memory copy it to the host
+    container->input_writers.emplace_back(
+      [source = block.buffer.get(), offset = block.offset, bytes](
+        Buffer* buffer, size_t buffer_offset) {
+        source->read(buffer->data(buffer_offset), offset, bytes);
+      });
+    container->device_views = true;
+  } else {
+    container->input_writers.emplace_back(
+      [data, bytes](Buffer* buffer, size_t offset) {
+        buffer->write(data, offset, bytes);
+      });
+  }
+  container->input_views.push_back(data);
+  inputs_.push_back(std::move(block.buffer));
+  return true;
+}
+
+void SharedMemoryTensors::addOutputs(const InferenceRequest& request) {
+  for (const auto& output : request.getOutputs()) {
+    const auto& parameters = output.getParameters();
+    if (!uses(parameters)) {
+      continue;
+    }
+    const auto name = output.getName();
+    size_t byte_size = 0;
+    auto block = find(parameters, name, &byte_size);
+    outputs_.try_emplace(name, Output{std::move(block), byte_size, parameters});
+  }
+}
+
+bool SharedMemoryTensors::containsOutput(const std::string& name) const {
+  return outputs_.find(name) != outputs_.end();
+}
+
+ParameterMap SharedMemoryTensors::writeOutput(
+  const InferenceResponseOutput& output) const {
+  const auto& name = output.getName();
+  const auto& [block, byte_size, parameters] = outputs_.at(name);
+  const auto bytes = output.getSize() * output.getDatatype().size();
+  if (bytes > byte_size) {
+    throw invalid_argument("Output " + name + " has " + std::to_string(bytes) +
+                           " bytes, which doesn't fit in its " +
+                           std::to_string(byte_size) +
+                           " bytes of shared memory");
+  }
+  if (bytes != 0) {
+    // outputs that are still on a GPU are copied straight into GPU regions
+    auto* source = output.getBuffer();
+    if (block.onDevice() && source != nullptr &&
+        source->getAllocator() == MemoryAllocators::HipDevice) {
+      block.buffer->write(source->data(0), block.offset, bytes);
+    } else {
+      block.buffer->write(output.getData(), block.offset, bytes);
+    }
+  }
+
+  auto reported = parameters;
+  putSize(&reported, kSharedMemoryByteSize, bytes);
+  return reported;
+}
+
+SharedMemoryBlock SharedMemoryTensors::find(
+  const ParameterMap& parameters, const std::string& tensor,
+  size_t* byte_size) const {
+  if (registry_ == nullptr) {
+    throw invalid_argument("Tensor " + tensor +
+                           " is in shared memory, which isn't supported here");
+  }
+  std::string region;
+  try {
+    region = parameters.get<std::string>(kSharedMemoryRegion);
+  } catch (const std::bad_variant_access&) {
+    throw invalid_argument("Parameter '" + std::string{kSharedMemoryRegion} +
+                           "' of tensor " + tensor + " must be a string");
+  }
+  if (!parameters.has(kSharedMemoryByteSize)) {
+    throw invalid_argument("Tensor " + tensor + " is in shared memory but has "
+                           "no '" + std::string{kSharedMemoryByteSize} +
+                           "' parameter");
+  }
+  *byte_size = getSize(parameters, kSharedMemoryByteSize, tensor);
+  const auto offset = parameters.has(kSharedMemoryOffset)
+                        ? getSize(parameters, kSharedMemoryOffset, tensor)
+                        : 0;
+  return registry_->get(region, offset, *byte_size);
+}
+
+}  // namespace amdinfer
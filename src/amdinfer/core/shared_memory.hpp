@@ -0,0 +1,212 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the system and GPU shared memory regions that clients on the
+ * same host can pass tensors through
+ */
+
+#ifndef GUARD_AMDINFER_CORE_SHARED_MEMORY
+#define GUARD_AMDINFER_CORE_SHARED_MEMORY
+
+#include <cstddef>        // for size_t, byte
+#include <memory>         // for shared_ptr
+#include <mutex>          // for mutex
+#include <string>         // for string
+#include <unordered_map>  // for unordered_map
+#include <vector>         // for vector
+
+#include "amdinfer/core/memory_pool/memory_allocator.hpp"  // for MemoryAllo...
+#include "amdinfer/core/parameters.hpp"                    // for ParameterMap
+
+namespace amdinfer {
+
+class Buffer;
+class InferenceRequest;
+class InferenceRequestInput;
+class InferenceResponseOutput;
+struct RequestContainer;
+
+/// The parameter of a tensor naming the region its data is in
+constexpr auto kSharedMemoryRegion = "shared_memory_region";
+/// The parameter of a tensor with the offset of its data in the region
+constexpr auto kSharedMemoryOffset = "shared_memory_offset";
+/// The parameter of a tensor with the size of its data in bytes
+constexpr auto kSharedMemoryByteSize = "shared_memory_byte_size";
+
+struct SharedMemoryRegion {
+  std::string name;
+  /**
+   * @brief name of the POSIX shared memory object the region is in or, for
+   * GPU memory, the bytes of the hipIpcMemHandle_t of its allocation
+   */
+  std::string key;
+  /// offset of the region in the object in bytes
+  size_t offset;
+  size_t byte_size;
+  /// SharedMemory for system memory or HipSharedMemory for GPU memory
+  MemoryAllocators allocator = MemoryAllocators::SharedMemory;
+  /// index of the GPU that GPU memory is on
+  int device = 0;
+};
+
+/// Part of a registered region that a tensor uses
+struct SharedMemoryBlock {
+  /// the region's memory, which stays mapped while it's held
+  std::shared_ptr<Buffer> buffer;
+  /// offset of the block in the buffer in bytes
+  size_t offset;
+
+  /// Get a pointer to the block, which is a device pointer for GPU memory
+  [[nodiscard]] void* data() const;
+  /// Check if the block is in GPU memory
+  [[nodiscard]] bool onDevice() const;
+};
+
+/**
+ * @brief The shared memory regions that clients have registered with the
+ * server, as in the KServe shared memory extensions. Registering a region maps
+ * it into the server once so requests can then name it to pass tensors without
+ * sending them over the socket. System and GPU regions share one namespace.
+ * It's safe to use from multiple threads at once.
+ */
+class SharedMemoryRegistry {
+ public:
+  /**
+   * @brief Register a region. It throws if the name is already registered or
+   * the region can't be mapped. GPU regions need the server to be built with
+   * MIGraphX, which brings in HIP.
+   *
+   * @param region region to register
+   */
+  void add(const SharedMemoryRegion& region);
+
+  /**
+   * @brief Unregister a region. Requests that use it keep it mapped until
+   * they're done so its memory can be released at any time.
+   *
+   * @param name name of the region or empty to unregister all regions
+   * @param allocator the kind of memory of the regions to unregister
+   */
+  void remove(const std::string& name,
+              MemoryAllocators allocator = MemoryAllocators::SharedMemory);
+
+  /**
+   * @brief Get the registered regions. It throws if a named region isn't
+   * registered or is a different kind of memory.
+   *
+   * @param name name of a region or empty to get all regions
+   * @param allocator the kind of memory of the regions to get
+   * @return std::vector<SharedMemoryRegion>
+   */
+  [[nodiscard]] std::vector<SharedMemoryRegion> status(
+    const std::string& name,
+    MemoryAllocators allocator = MemoryAllocators::SharedMemory) const;
+
+  /**
+   * @brief Get the memory of part of a region. It throws if the region isn't
+   * registered or the part doesn't fit in it.
+   *
+   * @param name name of the region
+   * @param offset offset in the region in bytes
+   * @param size size in bytes
+   * @return SharedMemoryBlock the memory, which keeps the region mapped
+   */
+  [[nodiscard]] SharedMemoryBlock get(const std::string& name, size_t offset,
+                                      size_t size) const;
+
+ private:
+  struct Entry {
+    SharedMemoryRegion region;
+    std::shared_ptr<Buffer> buffer;
+  };
+
+  std::unordered_map<std::string, Entry> regions_;
+  mutable std::mutex mutex_;
+};
+
+/**
+ * @brief The tensors of one request that are in shared memory. Servers find
+ * the inputs and outputs that use it when parsing a request and keep this
+ * object with the request's callback so the regions stay mapped until the
+ * response is sent.
+ */
+class SharedMemoryTensors {
+ public:
+  /**
+   * @brief Construct a new SharedMemoryTensors object
+   *
+   * @param registry the registered regions. If null, requests that use shared
+   * memory are rejected
+   */
+  explicit SharedMemoryTensors(const SharedMemoryRegistry* registry = nullptr);
+
+  /// Check if a tensor with these parameters is in shared memory
+  [[nodiscard]] static bool uses(const ParameterMap& parameters);
+
+  /**
+   * @brief Add the writer and view of an input that's in shared memory to its
+   * request's container. The size of the data must match the input's shape
+   * and datatype. Views of GPU memory mark the container's views as being on
+   * the device.
+   *
+   * @param input the input to find the data of
+   * @param container the container of the input's request
+   * @return bool true if the input is in shared memory
+   */
+  bool addInput(const InferenceRequestInput& input,
+                RequestContainer* container);
+
+  /**
+   * @brief Find the requested outputs of a request that should be written to
+   * shared memory
+   *
+   * @param request the request to check
+   */
+  void addOutputs(const InferenceRequest& request);
+
+  /// Check if the named output should be written to shared memory
+  [[nodiscard]] bool containsOutput(const std::string& name) const;
+
+  /**
+   * @brief Copy the data of an output into its region. It throws if the
+   * output is larger than the space requested for it or can't be copied to
+   * the GPU
+   *
+   * @param output the output to write
+   * @return ParameterMap the parameters to report for the output in the
+   * response, with the number of bytes written
+   */
+  [[nodiscard]] ParameterMap writeOutput(
+    const InferenceResponseOutput& output) const;
+
+ private:
+  struct Output {
+    SharedMemoryBlock block;
+    size_t byte_size;
+    ParameterMap parameters;
+  };
+
+  SharedMemoryBlock find(const ParameterMap& parameters,
+                         const std::string& tensor, size_t* byte_size) const;
+
+  const SharedMemoryRegistry* registry_;
+  std::vector<std::shared_ptr<Buffer>> inputs_;
+  std::unordered_map<std::string, Output> outputs_;
+};
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_CORE_SHARED_MEMORY
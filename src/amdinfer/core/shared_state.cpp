@@ -19,32 +19,25 @@
 
 #include "amdinfer/core/shared_state.hpp"
 
-#include <jsoncpp/json/reader.h>  // for CharReaderBuilder, Char...
-#include <jsoncpp/json/value.h>   // for Value
-
 #include <cassert>        // for assert
 #include <filesystem>     // for path
-#include <iostream>       // for operator<<, basic_ostream
-#include <string>         // for string, operator+, stoi
+#include <string>         // for string
 #include <unordered_map>  // for operator==, unordered_m...
 #include <unordered_set>  // for unordered_set
 #include <utility>        // for move, pair
-
-#include "amdinfer/build_options.hpp"          // for AMDINFER_ENABLE_VITIS
-#include "amdinfer/core/endpoints.hpp"         // for Endpoints
-#include "amdinfer/core/exceptions.hpp"        // for external_error, invalid...
-#include "amdinfer/core/model_repository.hpp"  // for ModelRepository
-#include "amdinfer/core/parameters.hpp"        // for ParameterMap
-#include "amdinfer/core/request_container.hpp"  // for ServerMetadata, ModelMe...
+#include <vector>         // for vector
+
+#include "amdinfer/build_options.hpp"            // for AMDINFER_ENABLE_METRICS
+#include "amdinfer/core/endpoints.hpp"           // for Endpoints
+#include "amdinfer/core/hardware_inventory.hpp"  // for HardwareInventory
+#include "amdinfer/core/model_repository.hpp"    // for ModelRepository
+#include "amdinfer/core/parameters.hpp"          // for ParameterMap
+#include "amdinfer/core/request_container.hpp"   // for ServerMetadata, Mod...
+#include "amdinfer/core/worker_info.hpp"         // for EndpointState
 #include "amdinfer/observation/observer.hpp"
-#include "amdinfer/util/string.hpp"  // for isLower
+#include "amdinfer/util/string.hpp"  // for isLower, toLower
 #include "amdinfer/version.hpp"      // for kAmdinferVersion
 
-#ifdef AMDINFER_ENABLE_VITIS
-#include <sockpp/socket.h>         // for socket, socket_initializer
-#include <sockpp/tcp_connector.h>  // for tcp_connector
-#endif
-
 namespace fs = std::filesystem;
 
 namespace amdinfer {
@@ -52,7 +45,14 @@ namespace amdinfer {
 ServerMetadata SharedState::serverMetadata() {
   std::unordered_set<std::string> extensions;
   ServerMetadata metadata{"amdinfer", kAmdinferVersion, extensions};
+  metadata.extensions.emplace("system_shared_memory");
 
+#ifdef AMDINFER_ENABLE_HTTP
+  metadata.extensions.emplace("binary_tensor_data");
+#endif
+#if defined(AMDINFER_ENABLE_HTTP) || defined(AMDINFER_ENABLE_GRPC)
+  metadata.extensions.emplace("infer_batch");
+#endif
 #ifdef AMDINFER_ENABLE_AKS
   metadata.extensions.emplace("aks");
 #endif
@@ -67,6 +67,7 @@ ServerMetadata SharedState::serverMetadata() {
 #endif
 #ifdef AMDINFER_ENABLE_MIGRAPHX
   metadata.extensions.emplace("migraphx");
+  metadata.extensions.emplace("hip_shared_memory");
 #endif
   return metadata;
 }
@@ -75,10 +76,7 @@ void SharedState::modelLoad(const std::string& model,
                             const ParameterMap& parameters) {
   assert(util::isLower(model));
 
-  ParameterMap updated_parameters = parameters;
-
-  parseModel(repository_.getRepository(), model, &updated_parameters);
-  endpoints_.load(model, updated_parameters);
+  loadModel(repository_.getRepository(), model, parameters, &endpoints_);
 }
 
 void SharedState::modelUnload(const std::string& model) {
@@ -101,6 +99,21 @@ void SharedState::workerUnload(const std::string& worker) {
 
 void SharedState::modelInfer(const std::string& model,
                              std::unique_ptr<RequestContainer> request) {
+  // requests are recorded as they arrive, before they're forwarded or their
+  // model is loaded, and the requests of ensembles' steps aren't recorded
+  if (recorder_ != nullptr) {
+    recorder_->record(model, *request);
+  }
+  // models that aren't loaded here are looked for on the peers before they're
+  // loaded on demand
+  if (peers_ != nullptr &&
+      peers_->forward(model, endpoints_.queued(model), &request)) {
+    return;
+  }
+  if (lazy_loader_ != nullptr) {
+    lazy_loader_->infer(model, std::move(request));
+    return;
+  }
   endpoints_.infer(model, std::move(request));
 }
 
@@ -110,75 +123,29 @@ bool SharedState::modelReady(const std::string& model) {
 
 std::vector<std::string> SharedState::modelList() { return endpoints_.list(); }
 
-ModelMetadata SharedState::modelMetadata(const std::string& model) {
-  return endpoints_.metadata(model);
+std::vector<EndpointState> SharedState::endpointStates() {
+  return endpoints_.states();
 }
 
-Kernels SharedState::getHardware() {
-  Kernels kernels;
-
-#ifdef AMDINFER_ENABLE_VITIS
-  sockpp::socket_initializer sock_init;
-  const auto default_xrm_port = 9763;
-  sockpp::tcp_connector conn({"localhost", default_xrm_port});
-  if (!conn) {
-    std::cerr << "Error connecting to server"
-              << "\n\t" << conn.last_error_str() << std::endl;
-  }
-
-  std::string request(R"({"request":{"name":"list","requestId":"1"}})");
-
-  auto bar = conn.write(request);
-  if (bar == -1) {
-    throw external_error("Bytes no match");
-  }
-
-  int total_len = 0;
-  auto len_read = conn.read_n(&total_len, 4);
-  if (len_read == -1) {
-    throw external_error("wrong number of bytes read initially");
-  }
-  std::string response_str;
-  response_str.resize(total_len);
-  auto bytes_read = conn.read_n(response_str.data(), total_len);
-  if (bytes_read == -1) {
-    throw external_error("wrong number of bytes read at data");
-  }
-
-  std::string errors;
-  Json::CharReaderBuilder builder;
-  Json::CharReader* reader = builder.newCharReader();
-  Json::Value response;
-  reader->parse(response_str.c_str(),
-                response_str.data() + response_str.length(), &response,
-                &errors);
-
-  auto data = response["response"]["data"];
-  auto num_fpgas = std::stoi(data["deviceNumber"].asString());
-  for (auto i = 0; i < num_fpgas; ++i) {
-    auto device = data["device_" + std::to_string(i)];
-    if (!device.isMember("cuNumber   ")) {
-      continue;
-    }
-    auto cu_num = std::stoi(device["cuNumber   "].asString());
-    for (auto j = 0; j < cu_num; ++j) {
-      auto kernel =
-        device["cu_" + std::to_string(j)]["kernelName   "].asString();
-      if (kernels.find(kernel) == kernels.end()) {
-        kernels.try_emplace(kernel, 1);
-      } else {
-        kernels.at(kernel)++;
-      }
-    }
-  }
+PeerLoad SharedState::peerLoad() const { return endpoints_.loads(); }
 
+#ifdef AMDINFER_ENABLE_METRICS
+std::map<std::string, SignalValues> SharedState::signals() const {
+  return endpoints_.signals();
+}
 #endif
 
-  return kernels;
+ModelMetadata SharedState::modelMetadata(const std::string& model) {
+  return endpoints_.metadata(model);
+}
+
+Kernels SharedState::getHardware() {
+  return HardwareInventory::get().read()->kernels;
 }
 
 bool SharedState::hasHardware(const std::string& name, int num) {
-  auto kernels = SharedState::getHardware();
+  const auto hardware = HardwareInventory::get().read();
+  const auto& kernels = hardware->kernels;
 
   auto kernel_iterator = kernels.find(name);
   if (kernel_iterator == kernels.end()) {
@@ -189,14 +156,93 @@ bool SharedState::hasHardware(const std::string& name, int num) {
 
 const MemoryPool* SharedState::getPool() const { return endpoints_.getPool(); }
 
+SharedMemoryRegistry* SharedState::getSharedMemory() { return &shared_memory_; }
+
+TenantLimiter* SharedState::getTenantLimiter() const {
+  return tenant_limiter_.get();
+}
+
 void SharedState::setRepository(const fs::path& repository_path,
-                                bool load_existing) {
+                                bool load_existing, const LoadLimits& limits,
+                                const RemoteOptions& remote) {
   repository_.setEndpoints(&endpoints_);
-  repository_.setRepository(repository_path, load_existing);
+  repository_.setRepository(repository_path, load_existing, limits, remote);
+}
+
+bool SharedState::serverReady() const { return repository_.ready(); }
+
+RepositoryProgress SharedState::repositoryProgress() const {
+  return repository_.getProgress();
 }
 
 void SharedState::enableRepositoryMonitoring(bool use_polling) {
   repository_.enableMonitoring(use_polling);
 }
 
+void SharedState::expectRepository() { repository_.expect(); }
+
+void SharedState::saveModelParameters(const std::string& model,
+                                      const ParameterMap& parameters) const {
+  assert(util::isLower(model));
+
+  amdinfer::saveModelParameters(repository_.getRepository(), model,
+                                parameters);
+}
+
+void SharedState::enableLazyLoading(
+  const std::map<std::string, size_t>& budgets) {
+  lazy_loader_ = std::make_unique<LazyLoader>(repository_.getRepository(),
+                                              &endpoints_, budgets);
+}
+
+void SharedState::enablePeers(std::vector<std::unique_ptr<Peer>> peers,
+                              const PeerLimits& limits) {
+  peers_ = std::make_unique<PeerRouter>(std::move(peers), limits,
+                                        endpoints_.getPool());
+}
+
+void SharedState::enableMemoryTrimming(std::chrono::milliseconds interval,
+                                       size_t keep) {
+  endpoints_.getPool()->startTrimming(interval, keep);
+}
+
+void SharedState::enableTrafficCapture(const std::filesystem::path& path,
+                                       const RecorderLimits& limits) {
+  recorder_ = std::make_unique<TrafficRecorder>(path, limits);
+}
+
+void SharedState::enableTenantLimits(
+  const std::string& header, const TenantLimits& limits,
+  const std::map<std::string, TenantLimits>& tenants, size_t max_tenants) {
+  tenant_limiter_ =
+    std::make_unique<TenantLimiter>(header, limits, tenants, max_tenants);
+}
+
+std::string SharedState::startBulkJob(const BulkJobOptions& options) {
+  auto resolved = options;
+  resolved.model = util::toLower(options.model);
+  const auto repository = repository_.getRepository();
+  if (resolved.input.is_relative() && !repository.empty()) {
+    resolved.input = fs::path{repository} / resolved.input;
+  }
+  return bulk_jobs_.start(
+    resolved,
+    [this, model = resolved.model](std::unique_ptr<RequestContainer> request) {
+      modelInfer(model, std::move(request));
+    });
+}
+
+BulkJobProgress SharedState::bulkJobProgress(const std::string& id) const {
+  return bulk_jobs_.progress(id);
+}
+
+void SharedState::cancelBulkJob(const std::string& id) const {
+  bulk_jobs_.cancel(id);
+}
+
+std::vector<std::pair<std::string, BulkJobProgress>> SharedState::bulkJobs()
+  const {
+  return bulk_jobs_.list();
+}
+
 }  // namespace amdinfer
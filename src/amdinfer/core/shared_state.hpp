@@ -20,15 +20,26 @@
 #ifndef GUARD_AMDINFER_CORE_SHARED_STATE
 #define GUARD_AMDINFER_CORE_SHARED_STATE
 
+#include <chrono>      // for milliseconds
+#include <cstddef>     // for size_t
 #include <filesystem>  // for path
+#include <map>         // for map
 #include <memory>      // for unique_ptr
 #include <string>      // for string
+#include <utility>     // for pair
 #include <vector>      // for vector
 
+#include "amdinfer/core/bulk_job.hpp"          // for BulkJobOptions, Bul...
+#include "amdinfer/core/bulk_jobs.hpp"         // for BulkJobs
 #include "amdinfer/core/endpoints.hpp"         // for Endpoints
+#include "amdinfer/core/lazy_loader.hpp"       // for LazyLoader
 #include "amdinfer/core/model_metadata.hpp"    // for ModelMetadata
-#include "amdinfer/core/model_repository.hpp"  // for ModelRepository
+#include "amdinfer/core/model_repository.hpp"  // for ModelRepository, Rep...
+#include "amdinfer/core/peers.hpp"             // for PeerRouter, PeerLimits
 #include "amdinfer/core/server_metadata.hpp"   // for ServerMetadata
+#include "amdinfer/core/shared_memory.hpp"     // for SharedMemoryRegistry
+#include "amdinfer/core/tenant_limiter.hpp"    // for TenantLimiter, Tena...
+#include "amdinfer/core/traffic_recorder.hpp"  // for TrafficRecorder, Rec...
 #include "amdinfer/declarations.hpp"           // for Kernels
 
 namespace amdinfer {
@@ -45,9 +56,21 @@ class SharedState {
   void workerUnload(const std::string& worker);
 
   static ServerMetadata serverMetadata();
+  /// Check if the models in the repository at startup have all loaded
+  bool serverReady() const;
+  /// Get the progress of loading the models in the repository at startup
+  RepositoryProgress repositoryProgress() const;
   std::vector<std::string> modelList();
   bool modelReady(const std::string& model);
   ModelMetadata modelMetadata(const std::string& model);
+  /// Get the state of the queues and workers of each loaded worker group
+  std::vector<EndpointState> endpointStates();
+  /// Get the work queued for each loaded endpoint, as reported to peers
+  PeerLoad peerLoad() const;
+#ifdef AMDINFER_ENABLE_METRICS
+  /// Get the smoothed load of each loaded endpoint, as reported to autoscalers
+  std::map<std::string, SignalValues> signals() const;
+#endif
 
   void modelInfer(const std::string& model,
                   std::unique_ptr<RequestContainer> request);
@@ -56,14 +79,86 @@ class SharedState {
   static bool hasHardware(const std::string& name, int num);
 
   const MemoryPool* getPool() const;
+  /// Get the shared memory regions that clients have registered
+  SharedMemoryRegistry* getSharedMemory();
+  /// Get the limits on each tenant's calls, or nullptr if there are none
+  TenantLimiter* getTenantLimiter() const;
 
   void setRepository(const std::filesystem::path& repository_path,
-                     bool load_existing);
+                     bool load_existing, const LoadLimits& limits = {},
+                     const RemoteOptions& remote = {});
   void enableRepositoryMonitoring(bool use_polling);
+  /// Mark the server as not ready until the repository is set
+  void expectRepository();
+  /// Save parameters into a model's config in the repository
+  void saveModelParameters(const std::string& model,
+                           const ParameterMap& parameters) const;
+  /**
+   * @brief Load models from the repository when they're first requested. A
+   * model repository must be set first
+   *
+   * @param budgets most bytes that these models may take on each kind of
+   * device. Idle ones are unloaded to stay within it
+   */
+  void enableLazyLoading(const std::map<std::string, size_t>& budgets);
+  /**
+   * @brief Forward requests to peer servers when they're better served there
+   *
+   * @param peers the peers to forward to
+   * @param limits the limits of forwarding
+   */
+  void enablePeers(std::vector<std::unique_ptr<Peer>> peers,
+                   const PeerLimits& limits);
+  /**
+   * @brief Give the memory pool's idle memory back to the system periodically
+   *
+   * @param interval the time between trims
+   * @param keep the bytes each allocator may keep
+   */
+  void enableMemoryTrimming(std::chrono::milliseconds interval, size_t keep);
+  /**
+   * @brief Record the requests that arrive to a traffic log
+   *
+   * @param path the log to record to
+   * @param limits what to record
+   */
+  void enableTrafficCapture(const std::filesystem::path& path,
+                            const RecorderLimits& limits);
+  /**
+   * @brief Limit the inference calls that each tenant sends. The servers
+   * admit each call under these limits as it arrives
+   *
+   * @param header the header that names the tenant
+   * @param limits the limits of tenants that aren't listed
+   * @param tenants the limits of particular tenants
+   * @param max_tenants most unlisted tenants that are limited apart
+   */
+  void enableTenantLimits(const std::string& header,
+                          const TenantLimits& limits,
+                          const std::map<std::string, TenantLimits>& tenants,
+                          size_t max_tenants);
+
+  /// Start running a dataset through a model. It throws if it can't start
+  std::string startBulkJob(const BulkJobOptions& options);
+  /// Get how far a bulk job has got. It throws invalid_argument if unknown
+  BulkJobProgress bulkJobProgress(const std::string& id) const;
+  /// Cancel a bulk job. It throws invalid_argument if it's unknown
+  void cancelBulkJob(const std::string& id) const;
+  /// Get how far each bulk job has got by their IDs
+  std::vector<std::pair<std::string, BulkJobProgress>> bulkJobs() const;
 
  private:
+  /// destroyed last since the requests in flight hold tickets from it
+  std::unique_ptr<TenantLimiter> tenant_limiter_;
   Endpoints endpoints_;
   ModelRepository repository_;
+  SharedMemoryRegistry shared_memory_;
+  /// destroyed first so its loads finish while the endpoints exist
+  std::unique_ptr<LazyLoader> lazy_loader_;
+  std::unique_ptr<PeerRouter> peers_;
+  std::unique_ptr<TrafficRecorder> recorder_;
+  /// destroyed before the rest so their requests finish while they exist
+  BulkJobs bulk_jobs_;
 };
 
 }  // namespace amdinfer
@@ -0,0 +1,243 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the limits on what each tenant may send to the server
+ */
+
+#include "amdinfer/core/tenant_limiter.hpp"
+
+#include <algorithm>  // for max, min
+#include <array>      // for array
+#include <chrono>     // for duration_cast, nanoseconds, steady_clock
+#include <limits>     // for numeric_limits
+#include <mutex>      // for unique_lock, shared_lock
+
+#include "amdinfer/observation/metrics.hpp"  // for Metrics, TenantTraffic
+#include "amdinfer/util/string.hpp"          // for toLower
+
+namespace amdinfer {
+
+namespace {
+
+constexpr double kNanoseconds = 1e9;
+
+int64_t getNanoseconds() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+           std::chrono::steady_clock::now().time_since_epoch())
+    .count();
+}
+
+}  // namespace
+
+const char* toString(TenantRejection rejection) {
+  switch (rejection) {
+    case TenantRejection::Rate:
+      return "The tenant is over its limit of requests per second";
+    case TenantRejection::Bytes:
+      return "The tenant is over its limit of bytes per second";
+    case TenantRejection::InFlight:
+      return "The tenant is over its limit of requests in flight";
+    default:
+      return "";
+  }
+}
+
+RateBucket::RateBucket(double rate, double burst) {
+  if (rate > 0) {
+    interval_ = kNanoseconds / rate;
+    tolerance_ = static_cast<int64_t>(std::max(burst, 0.0) * kNanoseconds);
+  }
+}
+
+int64_t RateBucket::cost(double amount) const {
+  // a cost this large keeps the bucket empty for centuries without the time
+  // overflowing
+  constexpr auto kMaxCost = static_cast<double>(
+    std::numeric_limits<int64_t>::max() / 4);
+  return static_cast<int64_t>(std::min(amount * interval_, kMaxCost));
+}
+
+bool RateBucket::take(double amount, int64_t now) {
+  if (interval_ <= 0) {
+    return true;
+  }
+  const auto cost = this->cost(amount);
+  auto full_at = full_at_.load(std::memory_order_relaxed);
+  while (true) {
+    // the bucket holds tolerance_ less the time until it's full again
+    if (full_at > now && full_at + cost - now > tolerance_) {
+      return false;
+    }
+    const auto next = std::max(full_at, now) + cost;
+    if (full_at_.compare_exchange_weak(full_at, next,
+                                       std::memory_order_relaxed)) {
+      return true;
+    }
+  }
+}
+
+void RateBucket::giveBack(double amount) {
+  if (interval_ > 0) {
+    full_at_.fetch_sub(cost(amount), std::memory_order_relaxed);
+  }
+}
+
+TenantTicket::TenantTicket(TenantTicket&& other) noexcept
+  : in_flight_(other.in_flight_), rejection_(other.rejection_) {
+  other.in_flight_ = nullptr;
+}
+
+TenantTicket& TenantTicket::operator=(TenantTicket&& other) noexcept {
+  if (this != &other) {
+    release();
+    in_flight_ = other.in_flight_;
+    rejection_ = other.rejection_;
+    other.in_flight_ = nullptr;
+  }
+  return *this;
+}
+
+TenantTicket::~TenantTicket() { release(); }
+
+void TenantTicket::release() {
+  if (in_flight_ != nullptr) {
+    in_flight_->fetch_sub(1, std::memory_order_relaxed);
+    in_flight_ = nullptr;
+  }
+}
+
+struct TenantLimiter::Tenant {
+  explicit Tenant(const TenantLimits& limits)
+    : requests(limits.requests_per_second, limits.burst),
+      bytes(limits.bytes_per_second, limits.burst),
+      max_in_flight(limits.max_in_flight) {}
+
+  RateBucket requests;
+  RateBucket bytes;
+  uint64_t max_in_flight;
+  std::atomic<uint64_t> in_flight = 0;
+  std::atomic<uint64_t> admitted = 0;
+  std::atomic<uint64_t> admitted_bytes = 0;
+  /// the calls turned away for each reason but None, in order
+  std::array<std::atomic<uint64_t>, 3> rejected{};
+};
+
+TenantLimiter::TenantLimiter(const std::string& header,
+                             const TenantLimits& limits,
+                             const std::map<std::string, TenantLimits>& tenants,
+                             size_t max_tenants)
+  : header_(util::toLower(header)),
+    limits_(limits),
+    max_tenants_(max_tenants) {
+  for (const auto& [name, tenant_limits] : tenants) {
+    tenants_.try_emplace(name, std::make_unique<Tenant>(tenant_limits));
+  }
+  // these take the default limits unless they're listed
+  const auto add = [this](const std::string& name) {
+    auto& tenant = tenants_[name];
+    if (tenant == nullptr) {
+      tenant = std::make_unique<Tenant>(limits_);
+    }
+    return tenant.get();
+  };
+  anonymous_ = add("anonymous");
+  other_ = add("other");
+#ifdef AMDINFER_ENABLE_METRICS
+  scrape_callback_ =
+    Metrics::getInstance().addScrapeCallback([this]() { collect(); });
+#endif
+}
+
+TenantLimiter::~TenantLimiter() {
+#ifdef AMDINFER_ENABLE_METRICS
+  Metrics::getInstance().removeScrapeCallback(scrape_callback_);
+#endif
+}
+
+TenantTicket TenantLimiter::admit(std::string_view tenant, size_t bytes) {
+  auto* state = get(tenant);
+  const auto reject = [state](TenantRejection rejection) {
+    state->rejected.at(static_cast<size_t>(rejection) - 1)
+      .fetch_add(1, std::memory_order_relaxed);
+    return TenantTicket{rejection};
+  };
+
+  // the place in flight is taken first since it's given back exactly if the
+  // call is turned away
+  const auto in_flight =
+    state->in_flight.fetch_add(1, std::memory_order_relaxed);
+  TenantTicket ticket{&state->in_flight};
+  if (state->max_in_flight > 0 && in_flight >= state->max_in_flight) {
+    return reject(TenantRejection::InFlight);
+  }
+  const auto now = getNanoseconds();
+  if (!state->requests.take(1, now)) {
+    return reject(TenantRejection::Rate);
+  }
+  if (!state->bytes.take(static_cast<double>(bytes), now)) {
+    state->requests.giveBack(1);
+    return reject(TenantRejection::Bytes);
+  }
+  state->admitted.fetch_add(1, std::memory_order_relaxed);
+  state->admitted_bytes.fetch_add(bytes, std::memory_order_relaxed);
+  return ticket;
+}
+
+TenantLimiter::Tenant* TenantLimiter::get(std::string_view name) {
+  if (name.empty()) {
+    return anonymous_;
+  }
+  {
+    std::shared_lock lock{mutex_};
+    if (auto found = tenants_.find(name); found != tenants_.end()) {
+      return found->second.get();
+    }
+    if (added_ >= max_tenants_) {
+      return other_;
+    }
+  }
+  std::unique_lock lock{mutex_};
+  auto [found, added] = tenants_.try_emplace(std::string{name}, nullptr);
+  if (added) {
+    // another thread may have filled the last place since the lookup
+    if (added_ >= max_tenants_) {
+      tenants_.erase(found);
+      return other_;
+    }
+    found->second = std::make_unique<Tenant>(limits_);
+    added_++;
+  }
+  return found->second.get();
+}
+
+void TenantLimiter::collect() const {
+#ifdef AMDINFER_ENABLE_METRICS
+  std::shared_lock lock{mutex_};
+  for (const auto& [name, tenant] : tenants_) {
+    TenantTraffic traffic;
+    traffic.requests = tenant->admitted.load(std::memory_order_relaxed);
+    traffic.bytes = tenant->admitted_bytes.load(std::memory_order_relaxed);
+    traffic.in_flight = tenant->in_flight.load(std::memory_order_relaxed);
+    for (auto i = 0U; i < tenant->rejected.size(); ++i) {
+      traffic.rejected.at(i) =
+        tenant->rejected.at(i).load(std::memory_order_relaxed);
+    }
+    Metrics::getInstance().setTenantTraffic(name, traffic);
+  }
+#endif
+}
+
+}  // namespace amdinfer
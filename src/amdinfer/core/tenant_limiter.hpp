@@ -0,0 +1,201 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the limits on what each tenant may send to the server
+ */
+
+#ifndef GUARD_AMDINFER_CORE_TENANT_LIMITER
+#define GUARD_AMDINFER_CORE_TENANT_LIMITER
+
+#include <atomic>        // for atomic
+#include <cstddef>       // for size_t
+#include <cstdint>       // for uint64_t, int64_t
+#include <functional>    // for less
+#include <map>           // for map
+#include <memory>        // for unique_ptr
+#include <shared_mutex>  // for shared_mutex
+#include <string>        // for string
+#include <string_view>   // for string_view
+
+#include "amdinfer/build_options.hpp"  // for AMDINFER_ENABLE_METRICS
+
+namespace amdinfer {
+
+/// Most tenants that are limited apart by default
+constexpr size_t kDefaultMaxTenants = 1024;
+
+/// Limits on what one tenant may send. Zero means no limit
+struct TenantLimits {
+  /// inference calls per second
+  double requests_per_second = 0;
+  /// bytes of inference calls per second
+  double bytes_per_second = 0;
+  /// seconds of its rates that an idle tenant may send at once
+  double burst = 1;
+  /// most inference calls in flight at once
+  size_t max_in_flight = 0;
+};
+
+/// Why a call was turned away by its tenant's limits
+enum class TenantRejection { None, Rate, Bytes, InFlight };
+
+/// Get why a call was turned away, as an error message
+const char* toString(TenantRejection rejection);
+
+/**
+ * @brief A token bucket kept as the time at which it's full again, in the
+ * manner of the generic cell rate algorithm, so taking from it is one
+ * compare-and-swap and no lock is needed
+ */
+class RateBucket {
+ public:
+  /**
+   * @brief Construct a new RateBucket object
+   *
+   * @param rate units per second that refill the bucket. If zero, it's never
+   * empty
+   * @param burst seconds of the rate that the bucket holds
+   */
+  RateBucket(double rate, double burst);
+
+  /**
+   * @brief Take from the bucket if it has enough. A full bucket gives any
+   * amount, going into debt, so calls larger than the bucket aren't turned
+   * away forever
+   *
+   * @param amount the units to take
+   * @param now the time in nanoseconds on the steady clock
+   * @return bool false if the bucket doesn't have enough
+   */
+  bool take(double amount, int64_t now);
+  /// Put back what was taken, for a call that was turned away afterwards
+  void giveBack(double amount);
+
+ private:
+  [[nodiscard]] int64_t cost(double amount) const;
+
+  /// nanoseconds that refill one unit, or zero if there's no limit
+  double interval_ = 0;
+  /// nanoseconds that the bucket may run ahead of the time
+  int64_t tolerance_ = 0;
+  /// when the bucket is full again, in nanoseconds on the steady clock
+  std::atomic<int64_t> full_at_ = 0;
+};
+
+class TenantLimiter;
+
+/**
+ * @brief A call's place in its tenant's calls in flight, which it holds until
+ * it responds. Tickets of calls without limits and of calls that were turned
+ * away hold no place.
+ */
+class TenantTicket {
+ public:
+  /// Construct a ticket for a call without limits
+  TenantTicket() = default;
+  /// Construct the ticket of a call that was turned away
+  explicit TenantTicket(TenantRejection rejection) : rejection_(rejection) {}
+  TenantTicket(const TenantTicket&) = delete;
+  TenantTicket& operator=(const TenantTicket&) = delete;
+  TenantTicket(TenantTicket&& other) noexcept;             ///< Move constructor
+  TenantTicket& operator=(TenantTicket&& other) noexcept;  ///< Move assignment
+  ~TenantTicket();  ///< Destructor. Releases the ticket
+
+  /// Check if the call was turned away
+  [[nodiscard]] bool rejected() const {
+    return rejection_ != TenantRejection::None;
+  }
+  /// Get why the call was turned away, if it was
+  [[nodiscard]] TenantRejection rejection() const { return rejection_; }
+  /// Give up the call's place in flight. Later calls do nothing
+  void release();
+
+ private:
+  friend TenantLimiter;
+  explicit TenantTicket(std::atomic<uint64_t>* in_flight)
+    : in_flight_(in_flight) {}
+
+  std::atomic<uint64_t>* in_flight_ = nullptr;
+  TenantRejection rejection_ = TenantRejection::None;
+};
+
+/**
+ * @brief Limits the inference calls that each tenant sends to the server by
+ * their rate, their bytes per second and how many are in flight. Tenants are
+ * named by the value of a header, such as a tenant ID or an API key, and each
+ * has buckets of its own so one that floods the server is turned away without
+ * taking from the others. Admitting a call only takes a shared lock to find
+ * its tenant and updates the tenant's atomics. This is safe to use from
+ * multiple threads at once.
+ */
+class TenantLimiter {
+ public:
+  /**
+   * @brief Construct a new TenantLimiter object
+   *
+   * @param header the header, or gRPC metadata key, that names the tenant
+   * @param limits the limits of tenants that aren't listed
+   * @param tenants the limits of particular tenants
+   * @param max_tenants most unlisted tenants that are limited apart. Later
+   * ones are limited together as the tenant "other"
+   */
+  TenantLimiter(const std::string& header, const TenantLimits& limits,
+                const std::map<std::string, TenantLimits>& tenants = {},
+                size_t max_tenants = kDefaultMaxTenants);
+  TenantLimiter(const TenantLimiter&) = delete;
+  TenantLimiter& operator=(const TenantLimiter&) = delete;
+  TenantLimiter(TenantLimiter&&) = delete;
+  TenantLimiter& operator=(TenantLimiter&&) = delete;
+  ~TenantLimiter();  ///< Destructor
+
+  /// Get the header that names the tenant, in lowercase
+  [[nodiscard]] const std::string& header() const { return header_; }
+
+  /**
+   * @brief Admit a call under its tenant's limits. Calls without the header
+   * are limited together as the tenant "anonymous"
+   *
+   * @param tenant the value of the call's header, if any
+   * @param bytes the size of the call
+   * @return TenantTicket the call's ticket, which may be rejected
+   */
+  TenantTicket admit(std::string_view tenant, size_t bytes);
+
+ private:
+  struct Tenant;
+
+  [[nodiscard]] Tenant* get(std::string_view name);
+  /// Set the tenants' traffic in the metrics. Runs as each scrape starts
+  void collect() const;
+
+  std::string header_;
+  TenantLimits limits_;
+  size_t max_tenants_;
+  /// the unlisted tenants that were added as their calls arrived
+  size_t added_ = 0;
+  Tenant* anonymous_ = nullptr;
+  Tenant* other_ = nullptr;
+  /// the tenants by name, which are never removed
+  std::map<std::string, std::unique_ptr<Tenant>, std::less<>> tenants_;
+  mutable std::shared_mutex mutex_;
+#ifdef AMDINFER_ENABLE_METRICS
+  size_t scrape_callback_ = 0;
+#endif
+};
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_CORE_TENANT_LIMITER
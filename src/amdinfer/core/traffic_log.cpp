@@ -0,0 +1,79 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the reader of traffic logs
+ */
+
+#include "amdinfer/core/traffic_log.hpp"
+
+#include <limits>   // for numeric_limits
+#include <utility>  // for move
+
+#include "amdinfer/core/exceptions.hpp"   // for runtime_error, invalid_arg...
+#include "amdinfer/core/wire_format.hpp"  // for decodeHeader, decodeRequest
+
+namespace amdinfer {
+
+TrafficLog::TrafficLog(const std::filesystem::path& path)
+  : file_(path, std::ios::binary) {
+  if (!file_) {
+    throw runtime_error("Could not open the traffic log " + path.string());
+  }
+  size_ = std::filesystem::file_size(path);
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  file_.read(reinterpret_cast<char*>(&header_), sizeof(header_));
+  if (!file_ || header_.magic != kTrafficLogMagic) {
+    throw invalid_argument(path.string() + " is not a traffic log");
+  }
+}
+
+std::optional<TrafficRecord> TrafficLog::next() {
+  std::array<std::byte, sizeof(WireHeader)> head{};
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  file_.read(reinterpret_cast<char*>(head.data()), head.size());
+  if (!file_) {
+    return std::nullopt;
+  }
+  const auto header =
+    decodeHeader(head.data(), std::numeric_limits<uint64_t>::max());
+  const auto payload = (header.flags & kTrafficNoPayload) == 0;
+  // a record that's cut off ends the log but a size that's larger than the
+  // whole log is corrupt rather than cut off
+  const auto recorded = payload ? header.bodySize() : header.metadata_size;
+  if (recorded > size_) {
+    throw invalid_argument("Malformed record in the traffic log");
+  }
+
+  // the data that wasn't recorded is left as zeros after the metadata
+  auto body = std::make_shared<std::vector<std::byte>>(header.bodySize());
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  file_.read(reinterpret_cast<char*>(body->data()),
+             static_cast<std::streamsize>(recorded));
+  if (!file_) {
+    return std::nullopt;
+  }
+
+  auto decoded = decodeRequest(header, body->data());
+  TrafficRecord record;
+  record.arrival = std::chrono::nanoseconds{decoded.tag};
+  record.endpoint = std::move(decoded.model);
+  record.request = std::move(decoded.request);
+  record.payload = payload;
+  record.data = std::move(body);
+  return record;
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,144 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the recorder of the inference traffic that arrives at a
+ * server
+ */
+
+#include "amdinfer/core/traffic_recorder.hpp"
+
+#include <chrono>   // for duration_cast, nanoseconds, system_clock
+#include <cmath>    // for floor
+#include <cstring>  // for memcpy
+
+#include "amdinfer/core/exceptions.hpp"         // for runtime_error
+#include "amdinfer/core/inference_request.hpp"  // for InferenceRequest
+#include "amdinfer/core/request_container.hpp"  // for RequestContainer
+#include "amdinfer/core/traffic_log.hpp"        // for TrafficLogHeader
+#include "amdinfer/core/wire_format.hpp"        // for encodeRequest
+#include "amdinfer/observation/logging.hpp"     // for AMDINFER_LOG_WARN
+#include "amdinfer/util/thread.hpp"             // for setThreadName
+
+namespace amdinfer {
+
+TrafficRecorder::TrafficRecorder(const std::filesystem::path& path,
+                                 const RecorderLimits& limits)
+  : limits_(limits),
+    start_(std::chrono::steady_clock::now()),
+    file_(path, std::ios::binary | std::ios::trunc) {
+  TrafficLogHeader header;
+  header.start_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::system_clock::now().time_since_epoch())
+                      .count();
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  file_.flush();
+  if (!file_) {
+    throw runtime_error("Could not create the traffic log " + path.string());
+  }
+  size_ = sizeof(header);
+  thread_ = std::thread{&TrafficRecorder::write, this};
+}
+
+TrafficRecorder::~TrafficRecorder() {
+  queue_.enqueue(std::vector<std::byte>{});
+  thread_.join();
+}
+
+void TrafficRecorder::record(const std::string& endpoint,
+                             const RequestContainer& request) {
+  if (full_.load(std::memory_order_relaxed)) {
+    return;
+  }
+  const auto arrival = std::chrono::steady_clock::now() - start_;
+  // the n-th request is sampled when the running total of the rate crosses a
+  // whole number so the sampled ones are spread evenly
+  const auto index = arrivals_.fetch_add(1, std::memory_order_relaxed);
+  const auto rate = limits_.sample_rate;
+  if (std::floor(static_cast<double>(index + 1) * rate) ==
+      std::floor(static_cast<double>(index) * rate)) {
+    return;
+  }
+
+  // the data is only on the host before the batcher if it's in the inputs or
+  // in the protocol's message
+  const auto on_host =
+    !request.device_views &&
+    (request.input_writers.empty() || !request.input_views.empty());
+  const auto payload = limits_.payloads && on_host;
+
+  const auto tag = static_cast<uint64_t>(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(arrival).count());
+  auto message = encodeRequest(tag, endpoint, *request.request);
+  WireHeader header;
+  std::memcpy(&header, message.head.data(), sizeof(header));
+  if (payload) {
+    for (auto i = 0U; i < request.input_views.size(); ++i) {
+      message.data[i].data =
+        static_cast<const std::byte*>(request.input_views[i]);
+    }
+  } else {
+    header.flags |= kTrafficNoPayload;
+    std::memcpy(message.head.data(), &header, sizeof(header));
+    message.data.clear();
+  }
+
+  const auto size = message.size();
+  if (backlog_.fetch_add(size) + size > limits_.backlog) {
+    backlog_ -= size;
+    ++dropped_;
+    return;
+  }
+  queue_.enqueue(message.flatten());
+}
+
+uint64_t TrafficRecorder::recorded() const { return recorded_; }
+
+uint64_t TrafficRecorder::dropped() const { return dropped_; }
+
+void TrafficRecorder::write() {
+  util::setThreadName("recorder");
+  AMDINFER_IF_LOGGING(Logger logger{Loggers::Server};)
+
+  std::vector<std::byte> record;
+  while (true) {
+    queue_.wait_dequeue(record);
+    if (record.empty()) {
+      break;
+    }
+    backlog_ -= record.size();
+    if (full_ || size_ + record.size() > limits_.max_bytes) {
+      if (!full_.exchange(true)) {
+        AMDINFER_LOG_WARN(logger, "The traffic log is full so the recording "
+                                  "has stopped");
+      }
+      ++dropped_;
+      continue;
+    }
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    file_.write(reinterpret_cast<const char*>(record.data()),
+                static_cast<std::streamsize>(record.size()));
+    size_ += record.size();
+    ++recorded_;
+    // the log is kept whole up to its last record if the server is killed
+    if (queue_.size_approx() == 0) {
+      file_.flush();
+    }
+  }
+  file_.flush();
+}
+
+}  // namespace amdinfer
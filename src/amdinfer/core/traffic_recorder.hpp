@@ -0,0 +1,122 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the recorder of the inference traffic that arrives at a
+ * server
+ */
+
+#ifndef GUARD_AMDINFER_CORE_TRAFFIC_RECORDER
+#define GUARD_AMDINFER_CORE_TRAFFIC_RECORDER
+
+#include <atomic>      // for atomic
+#include <chrono>      // for steady_clock
+#include <cstddef>     // for byte
+#include <cstdint>     // for uint64_t
+#include <filesystem>  // for path
+#include <fstream>     // for ofstream
+#include <string>      // for string
+#include <thread>      // for thread
+#include <vector>      // for vector
+
+#include "amdinfer/util/queue.hpp"  // for BlockingQueue
+
+namespace amdinfer {
+
+struct RequestContainer;
+
+/// Most bytes that a traffic log may grow to by default
+constexpr uint64_t kDefaultRecorderMaxBytes = 1024ULL * 1024 * 1024;
+/// Most bytes of recorded requests waiting to be written by default
+constexpr uint64_t kDefaultRecorderBacklog = 64ULL * 1024 * 1024;
+
+/// What a recorder records and how much
+struct RecorderLimits {
+  /// fraction of the requests that are recorded, evenly spaced
+  double sample_rate = 1;
+  /// the recording stops once the log would grow past this many bytes
+  uint64_t max_bytes = kDefaultRecorderMaxBytes;
+  /// record the data of the inputs and not just their shapes
+  bool payloads = false;
+  /**
+   * @brief requests are dropped rather than recorded while this many bytes
+   * are waiting to be written so a slow disk doesn't hold up inference
+   */
+  uint64_t backlog = kDefaultRecorderBacklog;
+};
+
+/**
+ * @brief Records the requests that arrive at a server to a traffic log that
+ * a TrafficLog can replay. Each request is encoded by the thread that records
+ * it, which copies its data if payloads are recorded, and is written to the
+ * log by the recorder's own thread. This is safe to use from multiple threads
+ * at once.
+ */
+class TrafficRecorder {
+ public:
+  /**
+   * @brief Construct a new TrafficRecorder object. It replaces the log at the
+   * path and throws if it can't be created
+   *
+   * @param path the log to write
+   * @param limits what to record
+   */
+  TrafficRecorder(const std::filesystem::path& path,
+                  const RecorderLimits& limits);
+  TrafficRecorder(const TrafficRecorder&) = delete;
+  TrafficRecorder& operator=(const TrafficRecorder&) = delete;
+  TrafficRecorder(TrafficRecorder&&) = delete;
+  TrafficRecorder& operator=(TrafficRecorder&&) = delete;
+  /// Write the requests that are waiting and close the log
+  ~TrafficRecorder();
+
+  /**
+   * @brief Record a request as it arrives, if it's sampled. Inputs whose
+   * data is in GPU memory or is only decoded into the batch later are
+   * recorded without their data
+   *
+   * @param endpoint the endpoint, alias or model it's sent to
+   * @param request the request
+   */
+  void record(const std::string& endpoint, const RequestContainer& request);
+
+  /// Get the number of requests that were recorded
+  [[nodiscard]] uint64_t recorded() const;
+  /// Get the number of sampled requests that were dropped
+  [[nodiscard]] uint64_t dropped() const;
+
+ private:
+  /// Write the recorded requests to the log. Runs in its own thread
+  void write();
+
+  RecorderLimits limits_;
+  std::chrono::steady_clock::time_point start_;
+  std::ofstream file_;
+  /// bytes written to the log. Only the writer thread uses it
+  uint64_t size_ = 0;
+  std::atomic<uint64_t> arrivals_ = 0;
+  std::atomic<uint64_t> recorded_ = 0;
+  std::atomic<uint64_t> dropped_ = 0;
+  std::atomic<uint64_t> backlog_ = 0;
+  /// set once the log is full so later requests aren't encoded
+  std::atomic<bool> full_ = false;
+  /// an empty record stops the writer thread
+  BlockingQueue<std::vector<std::byte>> queue_;
+  std::thread thread_;
+};
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_CORE_TRAFFIC_RECORDER
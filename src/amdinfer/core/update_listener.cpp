@@ -0,0 +1,187 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements how changes to a monitored repository are coalesced
+ */
+
+#include "amdinfer/core/update_listener.hpp"
+
+#include <algorithm>     // for max, min, sort
+#include <cstdint>       // for uintmax_t
+#include <system_error>  // for error_code
+#include <utility>       // for move
+#include <vector>        // for vector
+
+#include "amdinfer/observation/logging.hpp"  // for AMDINFER_LOG_DEBUG
+
+namespace fs = std::filesystem;
+
+namespace amdinfer {
+
+UpdateListener::UpdateListener(fs::path repository, ApplyChange apply,
+                               size_t loads, std::chrono::milliseconds settle)
+  : repository_(std::move(repository)),
+    apply_(std::move(apply)),
+    loads_(std::max(loads, size_t{1})),
+    settle_(settle) {
+  repository_ = repository_.lexically_normal();
+  if (repository_.filename().empty()) {
+    repository_ = repository_.parent_path();
+  }
+  dispatcher_ = std::thread{&UpdateListener::dispatch, this};
+}
+
+UpdateListener::~UpdateListener() {
+  std::unique_lock lock{mutex_};
+  stop_ = true;
+  cv_.notify_all();
+  lock.unlock();
+  dispatcher_.join();
+
+  lock.lock();
+  cv_.wait(lock, [this]() { return applying_.empty(); });
+}
+
+void UpdateListener::handleFileAction(
+  [[maybe_unused]] efsw::WatchID watch_id, const std::string& dir,
+  const std::string& filename, efsw::Action action,
+  [[maybe_unused]] std::string old_filename) {
+  AMDINFER_IF_LOGGING(Logger logger{Loggers::Server};)
+  switch (action) {
+    case efsw::Actions::Add:
+      AMDINFER_LOG_DEBUG(
+        logger, "DIR (" + dir + ") FILE (" + filename + ") has event Added");
+      break;
+    case efsw::Actions::Delete:
+      AMDINFER_LOG_DEBUG(
+        logger, "DIR (" + dir + ") FILE (" + filename + ") has event Delete");
+      break;
+    case efsw::Actions::Modified:
+      AMDINFER_LOG_DEBUG(
+        logger, "DIR (" + dir + ") FILE (" + filename + ") has event Modified");
+      break;
+    case efsw::Actions::Moved:
+      AMDINFER_LOG_DEBUG(logger, "DIR (" + dir + ") FILE (" + filename +
+                                   ") has event Moved from (" + old_filename +
+                                   ")");
+      break;
+    default:
+      AMDINFER_LOG_ERROR(logger, "Should never happen");
+  }
+
+  // the model is the top directory of the file in the repository
+  const auto relative =
+    (fs::path(dir) / filename).lexically_normal().lexically_relative(
+      repository_);
+  if (relative.empty() || *relative.begin() == "..") {
+    return;
+  }
+  auto model = relative.begin()->string();
+  const bool config = relative == fs::path(model) / "config.pbtxt";
+
+  // every event pushes back the deadline so a burst of events is coalesced
+  // into one change per model
+  std::lock_guard lock{mutex_};
+  auto& change = changes_[model];
+  change.deadline = Clock::now() + settle_;
+  change.config = change.config || config;
+  cv_.notify_all();
+}
+
+void UpdateListener::dispatch() {
+  std::unique_lock lock{mutex_};
+  while (!stop_) {
+    startSettled();
+
+    // wait for the next deadline, a new event or a load to finish
+    auto next = Clock::time_point::max();
+    if (applying_.size() < loads_) {
+      for (const auto& [model, change] : changes_) {
+        if (applying_.count(model) == 0) {
+          next = std::min(next, change.deadline);
+        }
+      }
+    }
+    if (next == Clock::time_point::max()) {
+      cv_.wait(lock);
+    } else {
+      cv_.wait_until(lock, next);
+    }
+  }
+}
+
+void UpdateListener::startSettled() {
+  const auto now = Clock::now();
+  for (auto it = changes_.begin(); it != changes_.end();) {
+    const auto model = it->first;
+    auto& change = it->second;
+    // changes to a model that's loading wait for it to finish
+    if (change.deadline > now || applying_.count(model) != 0 ||
+        applying_.size() >= loads_) {
+      ++it;
+      continue;
+    }
+    // changes to the other files of a model aren't applied by themselves
+    if (!change.config) {
+      it = changes_.erase(it);
+      continue;
+    }
+    // some copies write files without events so the files must also stay
+    // the same between two deadlines
+    auto current = snapshot(model);
+    if (current != change.snapshot) {
+      change.snapshot = std::move(current);
+      change.deadline = now + settle_;
+      ++it;
+      continue;
+    }
+
+    it = changes_.erase(it);
+    applying_.insert(model);
+    std::thread{[this, model]() {
+      apply_(model);
+      // notify with the lock held so the destructor can't finish first
+      std::lock_guard lock{mutex_};
+      applying_.erase(model);
+      cv_.notify_all();
+    }}.detach();
+  }
+}
+
+std::string UpdateListener::snapshot(const std::string& model) const {
+  std::vector<std::string> files;
+  std::error_code error;
+  for (fs::recursive_directory_iterator iterator{repository_ / model, error};
+       !error && iterator != fs::recursive_directory_iterator();
+       iterator.increment(error)) {
+    const auto size = iterator->is_regular_file(error)
+                        ? iterator->file_size(error)
+                        : std::uintmax_t{0};
+    const auto time = iterator->last_write_time(error);
+    files.push_back(iterator->path().string() + ":" + std::to_string(size) +
+                    ":" +
+                    std::to_string(time.time_since_epoch().count()));
+  }
+  std::sort(files.begin(), files.end());
+
+  std::string snapshot;
+  for (const auto& file : files) {
+    snapshot += file + "\n";
+  }
+  return snapshot;
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,111 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines how changes to a monitored repository are coalesced
+ */
+
+#ifndef GUARD_AMDINFER_CORE_UPDATE_LISTENER
+#define GUARD_AMDINFER_CORE_UPDATE_LISTENER
+
+#include <efsw/efsw.hpp>       // for Action, FileWatchListener, WatchID
+#include <chrono>              // for milliseconds, steady_clock
+#include <condition_variable>  // for condition_variable
+#include <cstddef>             // for size_t
+#include <filesystem>          // for path
+#include <functional>          // for function
+#include <map>                 // for map
+#include <mutex>               // for mutex
+#include <set>                 // for set
+#include <string>              // for string
+#include <thread>              // for thread
+
+namespace amdinfer {
+
+/// How long a model's files must be unchanged before its changes are applied
+constexpr std::chrono::milliseconds kRepositorySettle{100};
+
+/**
+ * @brief Applies changes to a monitored repository. The events for the files
+ * of each model are coalesced and its change is only applied once they've
+ * stopped for the settle time and the sizes and modification times of its
+ * files haven't changed over another settle time, so a model that's still
+ * being copied isn't loaded. Then the change is applied in the background so
+ * events keep being handled and changes to different models are applied in
+ * parallel.
+ *
+ * Only changes to a model's config.pbtxt are applied so copy the rest of a
+ * model's files before its config.
+ */
+class UpdateListener : public efsw::FileWatchListener {
+ public:
+  /// Applies the settled change to a model, such as loading its new config
+  using ApplyChange = std::function<void(const std::string& model)>;
+
+  /**
+   * @brief Construct a new UpdateListener object
+   *
+   * @param repository path to the repository
+   * @param apply applies a model's change
+   * @param loads the most changes that are applied at once
+   * @param settle how long a model's files must be unchanged
+   */
+  UpdateListener(std::filesystem::path repository, ApplyChange apply,
+                 size_t loads = 1,
+                 std::chrono::milliseconds settle = kRepositorySettle);
+  UpdateListener(const UpdateListener&) = delete;
+  UpdateListener& operator=(const UpdateListener&) = delete;
+  UpdateListener(UpdateListener&&) = delete;
+  UpdateListener& operator=(UpdateListener&&) = delete;
+  /// Destructor. Changes that are waiting are dropped and loads finish first
+  ~UpdateListener() override;
+
+  void handleFileAction(efsw::WatchID watch_id, const std::string& dir,
+                        const std::string& filename, efsw::Action action,
+                        std::string old_filename) override;
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Change {
+    Clock::time_point deadline;
+    /// the model's config was added, changed or removed
+    bool config = false;
+    /// the sizes and modification times of the model's files at the deadline
+    std::string snapshot;
+  };
+
+  void dispatch();
+  /// Start applying the changes that have settled. The lock must be held
+  void startSettled();
+  [[nodiscard]] std::string snapshot(const std::string& model) const;
+
+  std::filesystem::path repository_;
+  ApplyChange apply_;
+  size_t loads_;
+  std::chrono::milliseconds settle_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::map<std::string, Change> changes_;
+  /// the models whose changes are being applied
+  std::set<std::string> applying_;
+  bool stop_ = false;
+  std::thread dispatcher_;
+};
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_CORE_UPDATE_LISTENER
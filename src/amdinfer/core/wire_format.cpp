@@ -0,0 +1,470 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the binary wire format for whole requests and responses
+ */
+
+#include "amdinfer/core/wire_format.hpp"
+
+#include <sys/socket.h>  // for sendmsg, recv, msghdr, MSG_NOSIGNAL
+#include <sys/uio.h>     // for iovec
+
+#include <algorithm>  // for min
+#include <cerrno>     // for errno, EINTR
+#include <climits>    // for IOV_MAX
+#include <cstring>    // for memcpy
+#include <memory>     // for make_shared
+#include <string>     // for string
+#include <utility>    // for move
+#include <variant>    // for variant_size_v
+#include <vector>     // for vector
+
+#include "amdinfer/core/data_types.hpp"          // for DataType
+#include "amdinfer/core/exceptions.hpp"          // for invalid_argument
+#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/core/inference_tensor.hpp"    // for InferenceTensor
+#include "amdinfer/core/parameters.hpp"          // for ParameterMap
+
+namespace amdinfer {
+
+static_assert(sizeof(WireHeader) == 32, "The header must not have padding");
+
+namespace {
+
+/// Sizes written by Tensor::serialize() before the tensor's fields
+constexpr auto kTensorSizes = 3;
+/// Serialized objects start at multiples of this from the start of the body
+constexpr size_t kWireAlignment = alignof(uint64_t);
+
+/// Get the size in bytes of a tensor's data. Each character of a string is one
+size_t getDataSize(const Tensor& tensor) {
+  const auto datatype = tensor.getDatatype();
+  if (datatype == DataType::String) {
+    return tensor.getSize();
+  }
+  return tensor.getSize() * datatype.size();
+}
+
+class Writer {
+ public:
+  explicit Writer(std::vector<std::byte>* data) : data_(data) {}
+
+  void write(const void* data, size_t size) {
+    const auto offset = data_->size();
+    data_->resize(offset + size);
+    if (size > 0) {
+      std::memcpy(data_->data() + offset, data, size);
+    }
+  }
+
+  void write(uint64_t value) { write(&value, sizeof(value)); }
+
+  void write(const std::string& value) {
+    write(static_cast<uint64_t>(value.size()));
+    write(value.data(), value.size());
+  }
+
+  void write(const Serializable& object) {
+    align();
+    const auto offset = data_->size();
+    data_->resize(offset + object.serializeSize());
+    object.serialize(data_->data() + offset);
+  }
+
+  void write(const InferenceTensor& tensor, size_t data_size) {
+    // only the metadata of the tensor is in the metadata. Its data follows
+    align();
+    const auto offset = data_->size();
+    data_->resize(offset + tensor.InferenceTensor::serializeSize());
+    tensor.InferenceTensor::serialize(data_->data() + offset);
+    write(static_cast<uint64_t>(data_size));
+  }
+
+ private:
+  /// Pad with zeros so objects that read their sizes in place are aligned
+  void align() {
+    const auto padding = (kWireAlignment - data_->size() % kWireAlignment) %
+                         kWireAlignment;
+    data_->resize(data_->size() + padding);
+  }
+
+  std::vector<std::byte>* data_;
+};
+
+/**
+ * @brief Reads a message while checking that nothing is read past its end.
+ * Serializable objects don't know the size of their data so their sizes are
+ * checked here before deserializing them.
+ */
+class Reader {
+ public:
+  Reader(const std::byte* data, uint64_t size)
+    : start_(data), data_(data), size_(size) {}
+
+  const std::byte* take(uint64_t size) {
+    if (size > size_) {
+      throw invalid_argument("The message ends before its metadata");
+    }
+    const auto* data = data_;
+    data_ += size;
+    size_ -= size;
+    return data;
+  }
+
+  uint64_t readU64() {
+    uint64_t value = 0;
+    std::memcpy(&value, take(sizeof(value)), sizeof(value));
+    return value;
+  }
+
+  std::string readString() {
+    const auto size = readU64();
+    const auto* data = take(size);
+    return {reinterpret_cast<const char*>(data), size};
+  }
+
+  void read(ParameterMap* parameters) {
+    align();
+    readParameters(parameters);
+  }
+
+  void read(InferenceTensor* tensor) {
+    align();
+    const auto* start = data_;
+    const auto name = readU64();
+    const auto shape = readU64();
+    const auto datatype = readU64();
+    if (shape % sizeof(uint64_t) != 0 || datatype != sizeof(uint8_t)) {
+      throw invalid_argument("Malformed tensor in the message");
+    }
+    take(name);
+    take(shape);
+    take(datatype);
+    tensor->Tensor::deserialize(start);
+    if (tensor->getDatatype() >= DataType::Unknown) {
+      throw invalid_argument("Unknown datatype of tensor " +
+                             tensor->getName());
+    }
+
+    // the tensor's parameters follow it without padding
+    ParameterMap parameters;
+    readParameters(&parameters);
+    tensor->setParameters(std::move(parameters));
+  }
+
+  [[nodiscard]] uint64_t remaining() const { return size_; }
+
+ private:
+  void readParameters(ParameterMap* parameters) {
+    const auto* start = data_;
+    // the counts and sizes of all the parameters come first
+    const auto count = readU64();
+    uint64_t size = 0;
+    for (auto i = 0U; i < count; ++i) {
+      if (readU64() >= std::variant_size_v<Parameter>) {
+        throw invalid_argument("Unknown type of parameter in the message");
+      }
+      const auto key_size = readU64();
+      const auto value_size = readU64();
+      // checked one at a time so the sum can't overflow
+      if (key_size > size_ || value_size > size_ - key_size ||
+          size > size_ - key_size - value_size) {
+        throw invalid_argument("The message ends before its metadata");
+      }
+      size += key_size + value_size;
+    }
+    take(size);
+    parameters->deserialize(start);
+  }
+
+  /// Skip the padding before a serialized object
+  void align() {
+    const auto offset = static_cast<size_t>(data_ - start_);
+    take((kWireAlignment - offset % kWireAlignment) % kWireAlignment);
+  }
+
+  const std::byte* start_;
+  const std::byte* data_;
+  uint64_t size_;
+};
+
+static_assert(sizeof(size_t) == sizeof(uint64_t),
+              "Serialized sizes are read as u64");
+
+WireMessage startMessage(WireKind kind, uint64_t tag) {
+  WireMessage message;
+  WireHeader header;
+  header.kind = kind;
+  header.tag = tag;
+  message.head.resize(sizeof(WireHeader));
+  std::memcpy(message.head.data(), &header, sizeof(WireHeader));
+  return message;
+}
+
+void finishMessage(WireMessage* message, uint16_t flags) {
+  WireHeader header;
+  std::memcpy(&header, message->head.data(), sizeof(WireHeader));
+  header.flags = flags;
+  header.metadata_size = message->head.size() - sizeof(WireHeader);
+  for (const auto& segment : message->data) {
+    header.data_size += segment.size;
+  }
+  std::memcpy(message->head.data(), &header, sizeof(WireHeader));
+}
+
+/**
+ * @brief Read the tensors of a message. Their metadata is read first and the
+ * data of each follows the metadata in order
+ *
+ * @tparam TensorType type of the tensors
+ * @tparam F a function to pass each tensor and its data to
+ * @param header the message's header
+ * @param reader the reader of the metadata, at the number of tensors
+ * @param body the message after its header
+ * @param f called with each tensor and a pointer to its data
+ */
+template <typename TensorType, typename F>
+void readTensors(const WireHeader& header, Reader* reader,
+                 const std::byte* body, F f) {
+  const auto count = reader->readU64();
+  Reader data{body + header.metadata_size, header.data_size};
+  // each tensor takes at least this many bytes so a bad count is caught before
+  // it's used to allocate
+  constexpr auto kMinTensorSize = (kTensorSizes + 2) * sizeof(uint64_t);
+  if (count > reader->remaining() / kMinTensorSize) {
+    throw invalid_argument("Malformed tensors in the message");
+  }
+  for (auto i = 0U; i < count; ++i) {
+    TensorType tensor;
+    reader->read(&tensor);
+    const auto size = reader->readU64();
+    if (size != getDataSize(tensor)) {
+      throw invalid_argument("Data size of tensor " + tensor.getName() +
+                             " does not match its shape and datatype");
+    }
+    f(std::move(tensor), data.take(size), size);
+  }
+  if (reader->remaining() != 0 || data.remaining() != 0) {
+    throw invalid_argument("The message has more data than its tensors");
+  }
+}
+
+}  // namespace
+
+size_t WireMessage::size() const {
+  auto size = head.size();
+  for (const auto& segment : data) {
+    size += segment.size;
+  }
+  return size;
+}
+
+std::vector<WireSegment> WireMessage::segments() const {
+  std::vector<WireSegment> segments;
+  segments.reserve(data.size() + 1);
+  segments.push_back({head.data(), head.size()});
+  for (const auto& segment : data) {
+    if (segment.size > 0) {
+      segments.push_back(segment);
+    }
+  }
+  return segments;
+}
+
+std::vector<std::byte> WireMessage::flatten() const {
+  std::vector<std::byte> message;
+  message.reserve(size());
+  for (const auto& segment : segments()) {
+    message.insert(message.end(), segment.data, segment.data + segment.size);
+  }
+  return message;
+}
+
+WireMessage encodeRequest(uint64_t tag, const std::string& model,
+                          const InferenceRequest& request) {
+  auto message = startMessage(WireKind::Request, tag);
+  Writer writer{&message.head};
+  writer.write(model);
+  writer.write(request.getID());
+  writer.write(request.getParameters());
+
+  const auto& inputs = request.getInputs();
+  writer.write(static_cast<uint64_t>(inputs.size()));
+  message.data.reserve(inputs.size());
+  for (const auto& input : inputs) {
+    const auto size = getDataSize(input);
+    writer.write(input, size);
+    message.data.push_back({static_cast<const std::byte*>(input.getData()),
+                            size});
+  }
+  finishMessage(&message, 0);
+  return message;
+}
+
+WireMessage encodeResponse(uint64_t tag, const InferenceResponse& response) {
+  auto message = startMessage(WireKind::Response, tag);
+  Writer writer{&message.head};
+  writer.write(response.getModel());
+  writer.write(response.getID());
+  if (response.isError()) {
+    writer.write(response.getError());
+    writer.write(uint64_t{0});
+    finishMessage(&message, kWireError);
+    return message;
+  }
+
+  writer.write(std::string{});
+  const auto& outputs = response.getOutputs();
+  writer.write(static_cast<uint64_t>(outputs.size()));
+  message.data.reserve(outputs.size());
+  for (const auto& output : outputs) {
+    const auto size = getDataSize(output);
+    writer.write(output, size);
+    message.data.push_back({static_cast<const std::byte*>(output.getData()),
+                            size});
+  }
+  finishMessage(&message, 0);
+  return message;
+}
+
+WireHeader decodeHeader(const std::byte* data, uint64_t max_size) {
+  WireHeader header;
+  std::memcpy(&header, data, sizeof(WireHeader));
+  if (header.magic != kWireMagic) {
+    throw invalid_argument("The message doesn't start with the magic number");
+  }
+  if (header.version != kWireVersion) {
+    throw invalid_argument("Unsupported version of the wire format: " +
+                           std::to_string(header.version));
+  }
+  if (header.kind != WireKind::Request && header.kind != WireKind::Response) {
+    throw invalid_argument("Unknown kind of message");
+  }
+  // checked separately so the sum can't overflow
+  if (header.metadata_size > max_size ||
+      header.data_size > max_size - header.metadata_size) {
+    throw invalid_argument("The message is larger than the maximum size");
+  }
+  return header;
+}
+
+WireRequest decodeRequest(const WireHeader& header, const std::byte* body) {
+  if (header.kind != WireKind::Request) {
+    throw invalid_argument("The message isn't a request");
+  }
+  Reader reader{body, header.metadata_size};
+  WireRequest decoded;
+  decoded.tag = header.tag;
+  decoded.model = reader.readString();
+
+  auto request = std::make_shared<InferenceRequest>();
+  request->setID(reader.readString());
+  ParameterMap parameters;
+  reader.read(&parameters);
+  request->setParameters(std::move(parameters));
+
+  readTensors<InferenceRequestInput>(
+    header, &reader, body,
+    [&request](InferenceRequestInput input, const std::byte* data, size_t) {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+      input.setData(const_cast<std::byte*>(data));
+      request->addInputTensor(std::move(input));
+    });
+  decoded.request = std::move(request);
+  return decoded;
+}
+
+InferenceResponse decodeResponse(const WireHeader& header,
+                                 const std::byte* body) {
+  if (header.kind != WireKind::Response) {
+    throw invalid_argument("The message isn't a response");
+  }
+  Reader reader{body, header.metadata_size};
+  auto model = reader.readString();
+  auto id = reader.readString();
+  auto error = reader.readString();
+
+  InferenceResponse response;
+  if ((header.flags & kWireError) != 0) {
+    response = InferenceResponse{error};
+  }
+  response.setModel(model);
+  response.setID(id);
+  readTensors<InferenceResponseOutput>(
+    header, &reader, body,
+    [&response](InferenceResponseOutput output, const std::byte* data,
+                size_t size) {
+      output.setData(std::vector<std::byte>(data, data + size));
+      response.addOutput(std::move(output));
+    });
+  return response;
+}
+
+bool sendMessage(int socket, const WireMessage& message) {
+  const auto segments = message.segments();
+  std::vector<iovec> vectors;
+  vectors.reserve(segments.size());
+  for (const auto& segment : segments) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+    vectors.push_back({const_cast<std::byte*>(segment.data), segment.size});
+  }
+
+  size_t index = 0;
+  while (index < vectors.size()) {
+    msghdr header{};
+    header.msg_iov = &vectors[index];
+    header.msg_iovlen =
+      std::min(vectors.size() - index, static_cast<size_t>(IOV_MAX));
+    // a closed peer is reported as an error rather than raising SIGPIPE
+    const auto sent = ::sendmsg(socket, &header, MSG_NOSIGNAL);
+    if (sent < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    // skip the segments that were sent whole and resume in the partial one
+    auto remaining = static_cast<size_t>(sent);
+    while (index < vectors.size() && remaining >= vectors[index].iov_len) {
+      remaining -= vectors[index].iov_len;
+      ++index;
+    }
+    if (remaining > 0) {
+      auto& vector = vectors[index];
+      vector.iov_base = static_cast<std::byte*>(vector.iov_base) + remaining;
+      vector.iov_len -= remaining;
+    }
+  }
+  return true;
+}
+
+bool receive(int socket, std::byte* data, size_t size) {
+  while (size > 0) {
+    const auto received = ::recv(socket, data, size, 0);
+    if (received < 0 && errno == EINTR) {
+      continue;
+    }
+    if (received <= 0) {
+      return false;
+    }
+    data += received;
+    size -= static_cast<size_t>(received);
+  }
+  return true;
+}
+
+}  // namespace amdinfer
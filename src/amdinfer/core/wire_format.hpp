@@ -0,0 +1,193 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the binary wire format for whole requests and responses
+ */
+
+#ifndef GUARD_AMDINFER_CORE_WIRE_FORMAT
+#define GUARD_AMDINFER_CORE_WIRE_FORMAT
+
+#include <cstddef>  // for byte, size_t
+#include <cstdint>  // for uint64_t, uint32_t, uint8_t, uint16_t
+#include <string>   // for string
+#include <vector>   // for vector
+
+#include "amdinfer/declarations.hpp"  // for InferenceRequestPtr
+
+namespace amdinfer {
+
+class InferenceRequest;
+class InferenceResponse;
+
+/// The first four bytes of every message, "AMDI" in memory
+constexpr uint32_t kWireMagic = 0x49444D41;
+/// Version of the wire format. Messages of other versions are rejected
+constexpr uint8_t kWireVersion = 1;
+
+/// What a message holds
+enum class WireKind : uint8_t { Request, Response };
+
+/**
+ * @brief The fixed-size header that starts every message. The sizes of the
+ * metadata and data that follow it prefix the message so a reader can read
+ * it whole before decoding it.
+ *
+ * A message is the header followed by its metadata and then the data of its
+ * tensors, back to back in order. The metadata is written with the tensors'
+ * Serializable implementations and, in order, has:
+ *
+ *   - a u64 length and the bytes of the model's name
+ *   - a u64 length and the bytes of the ID
+ *   - for requests, their serialized ParameterMap
+ *   - for responses, a u64 length and the bytes of the error message
+ *   - a u64 number of tensors and, for each, its serialized InferenceTensor
+ *     and its u64 data size
+ *
+ * Each serialized ParameterMap and InferenceTensor is padded with zeros to
+ * start at a multiple of eight bytes from the start of the metadata.
+ * Everything is in the sender's native byte order and sizes, as Serializable
+ * is, so peers must share an architecture. A peer of another byte order sees
+ * the wrong magic number.
+ */
+struct WireHeader {
+  uint32_t magic = kWireMagic;
+  uint8_t version = kWireVersion;
+  WireKind kind = WireKind::Request;
+  /// bit 0 is set for error responses
+  uint16_t flags = 0;
+  /// chosen by the sender of a request and echoed in its response
+  uint64_t tag = 0;
+  uint64_t metadata_size = 0;
+  uint64_t data_size = 0;
+
+  /// Get the size of the message after its header
+  [[nodiscard]] uint64_t bodySize() const { return metadata_size + data_size; }
+};
+
+/// Flag set in the header of error responses
+constexpr uint16_t kWireError = 1;
+
+/// A contiguous range of memory to send
+struct WireSegment {
+  const std::byte* data;
+  size_t size;
+};
+
+/**
+ * @brief An encoded message. The header and metadata are encoded into memory
+ * owned by the message but the tensors' data is referenced where it is so it
+ * can be sent with a scatter-gather write, such as writev(), without copying.
+ * The tensors must outlive the message.
+ */
+struct WireMessage {
+  /// the header and metadata
+  std::vector<std::byte> head;
+  /// the data of each tensor, in order
+  std::vector<WireSegment> data;
+
+  /// Get the total size of the message in bytes
+  [[nodiscard]] size_t size() const;
+  /// Get the segments of the message in order, starting with the head
+  [[nodiscard]] std::vector<WireSegment> segments() const;
+  /// Copy the message into contiguous memory
+  [[nodiscard]] std::vector<std::byte> flatten() const;
+};
+
+/// A request decoded from a message
+struct WireRequest {
+  uint64_t tag = 0;
+  std::string model;
+  /// the request, whose inputs' data points into the message
+  InferenceRequestPtr request;
+};
+
+/**
+ * @brief Encode a request to a model. The data of its inputs is sent as is
+ *
+ * @param tag the tag to identify the request's response with
+ * @param model the model to send the request to
+ * @param request the request to encode
+ * @return WireMessage
+ */
+WireMessage encodeRequest(uint64_t tag, const std::string& model,
+                          const InferenceRequest& request);
+
+/**
+ * @brief Encode a response. Error responses are encoded with the error flag
+ * and their message
+ *
+ * @param tag the tag of the request that this responds to
+ * @param response the response to encode
+ * @return WireMessage
+ */
+WireMessage encodeResponse(uint64_t tag, const InferenceResponse& response);
+
+/**
+ * @brief Decode the header at the start of a message. It throws if it's not a
+ * header of this version or the message is larger than the maximum size
+ *
+ * @param data the sizeof(WireHeader) bytes that start a message
+ * @param max_size the most bytes that are accepted after the header
+ * @return WireHeader
+ */
+WireHeader decodeHeader(const std::byte* data, uint64_t max_size);
+
+/**
+ * @brief Decode a request. The data of the inputs points into the body so it
+ * must outlive the request. If it's not a valid request, an exception is
+ * thrown.
+ *
+ * @param header the message's decoded header
+ * @param body the bodySize() bytes that follow the header
+ * @return WireRequest
+ */
+WireRequest decodeRequest(const WireHeader& header, const std::byte* body);
+
+/**
+ * @brief Decode a response, copying the data of its outputs. If it's not a
+ * valid response, an exception is thrown.
+ *
+ * @param header the message's decoded header
+ * @param body the bodySize() bytes that follow the header
+ * @return InferenceResponse
+ */
+InferenceResponse decodeResponse(const WireHeader& header,
+                                 const std::byte* body);
+
+/**
+ * @brief Send a message on a connected socket. Its segments are sent with
+ * scatter-gather writes so the tensors' data isn't copied. Writes from
+ * different threads to the same socket must be serialized by the caller
+ *
+ * @param socket the socket to write to
+ * @param message the message to send
+ * @return bool - false if the connection failed before the message was sent
+ */
+bool sendMessage(int socket, const WireMessage& message);
+
+/**
+ * @brief Read exactly some number of bytes from a connected socket
+ *
+ * @param socket the socket to read from
+ * @param data where to write the bytes
+ * @param size the number of bytes to read
+ * @return bool - false if the connection closed or failed first
+ */
+bool receive(int socket, std::byte* data, size_t size);
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_CORE_WIRE_FORMAT
@@ -23,20 +23,41 @@
 
 #include <dlfcn.h>  // for dlerror, dlopen, dlsym, RTL...
 
-#include <cctype>       // for toupper
-#include <climits>      // for UINT_MAX
-#include <cstdint>      // for int32_t
-#include <exception>    // for exception
-#include <string>       // for string, operator+, basic_st...
-#include <type_traits>  // for remove_reference<>::type
-#include <utility>      // for pair, move, make_pair
-
-#include "amdinfer/batching/batcher.hpp"  // for Batcher, BatcherStatus, Bat...
-#include "amdinfer/core/exceptions.hpp"   // for invalid_argument, external_...
+#include <algorithm>      // for any_of, clamp
+#include <cctype>         // for toupper
+#include <chrono>         // for milliseconds
+#include <climits>        // for UINT_MAX
+#include <cstdint>        // for int32_t
+#include <exception>      // for exception
+#include <mutex>          // for lock_guard, unique_lock
+#include <string>         // for string, operator+, basic_st...
+#include <thread>         // for get_id, thread
+#include <type_traits>    // for remove_reference<>::type
+#include <unordered_map>  // for unordered_map
+#include <utility>        // for pair, move, make_pair
+#include <vector>         // for vector
+
+#include "amdinfer/batching/batch.hpp"             // for Batch
+#include "amdinfer/batching/batcher.hpp"           // for Batcher, BatchQueue...
+#include "amdinfer/batching/endpoint_signals.hpp"  // for EndpointSignals
+#ifdef AMDINFER_ENABLE_PREPROCESSING
+#include "amdinfer/batching/preprocessor.hpp"  // for Preprocessor
+#endif
+#include "amdinfer/build_options.hpp"           // for AMDINFER_ENABLE_METRICS
+#include "amdinfer/core/autoscaler.hpp"         // for Autoscaler
+#include "amdinfer/core/exceptions.hpp"         // for invalid_argument, exte...
+#include "amdinfer/core/inference_request.hpp"  // for InferenceRequest
 #include "amdinfer/core/memory_pool/pool.hpp"   // for MemoryPool
 #include "amdinfer/core/parameters.hpp"         // for ParameterMap
+#include "amdinfer/core/queue_limit.hpp"        // for QueueLimit
+#include "amdinfer/core/request_coalescer.hpp"  // for RequestCoalescer
 #include "amdinfer/core/request_container.hpp"  // for ModelMetadata
-#include "amdinfer/workers/worker.hpp"  // for Worker, WorkerStatus, Worke...
+#include "amdinfer/core/response_cache.hpp"     // for ResponseCache
+#include "amdinfer/observation/logging.hpp"     // for AMDINFER_LOG_WARN
+#include "amdinfer/observation/metrics.hpp"     // for Metrics
+#include "amdinfer/util/string.hpp"             // for toLower
+#include "amdinfer/util/timer.hpp"              // for Timer
+#include "amdinfer/workers/worker.hpp"          // for Worker, WorkerStatus, ...
 
 namespace amdinfer {
 
@@ -85,6 +106,21 @@ void* findFunc(const std::string& func, const std::string& so_path) {
   return fptr;
 }
 
+namespace {
+
+/// Get the workers compiled into the server. It's made on first use since the
+/// workers register themselves as the server starts
+std::unordered_map<std::string, WorkerFactory>& getStaticWorkers() {
+  static std::unordered_map<std::string, WorkerFactory> workers;
+  return workers;
+}
+
+}  // namespace
+
+void registerWorker(const std::string& name, WorkerFactory factory) {
+  getStaticWorkers()[name] = factory;
+}
+
 workers::Worker* getWorker(const std::string& name) {
   // multiple workers with different configurations may exist. Remove the config
   // tag that starts with "-" in the name prior to loading the .so
@@ -93,6 +129,12 @@ workers::Worker* getWorker(const std::string& name) {
   if (auto hyphen_pos = name.find('-'); hyphen_pos != std::string::npos) {
     lib_name.erase(hyphen_pos);
   }
+  // workers compiled into the server are made without opening their library
+  const auto& static_workers = getStaticWorkers();
+  if (const auto it = static_workers.find(util::toLower(lib_name));
+      it != static_workers.end()) {
+    return it->second();
+  }
   std::string library =
     std::string("libworker") + lib_name + std::string(".so");
 
@@ -104,12 +146,129 @@ workers::Worker* getWorker(const std::string& name) {
   return worker;
 }
 
-WorkerInfo::WorkerInfo(const std::string& name, ParameterMap* parameters,
-                       MemoryPool* pool) {
-  this->addAndStartWorker(name, parameters, pool);
+/**
+ * @brief Log and report how long a phase of loading a worker took
+ *
+ * @param endpoint the worker's endpoint
+ * @param phase the phase's name
+ * @param seconds duration of the phase
+ */
+void recordLoadPhase([[maybe_unused]] const std::string& endpoint,
+                     [[maybe_unused]] const std::string& phase,
+                     [[maybe_unused]] double seconds) {
+  AMDINFER_IF_LOGGING(Logger logger{Loggers::Server};)
+  AMDINFER_LOG_INFO(logger, "Loading " + endpoint + ": " + phase + " took " +
+                              std::to_string(seconds) + " s");
+#ifdef AMDINFER_ENABLE_METRICS
+  Metrics::getInstance().setModelLoadTime(endpoint, phase, seconds);
+#endif
+}
+
+WorkerInfo::WorkerInfo(const std::string& endpoint, const std::string& name,
+                       ParameterMap* parameters, MemoryPool* pool,
+                       size_t instances)
+  : endpoint_(endpoint) {
+  constexpr size_t kMegabyte = 1024 * 1024;
+  if (auto limits = parseAutoscaleLimits(*parameters, instances);
+      limits.has_value()) {
+#ifdef AMDINFER_ENABLE_METRICS
+    // the group starts within its limits and keeps what it needs to add more
+    instances = std::clamp(instances, limits->min_instances,
+                           limits->max_instances);
+    autoscaler_ = std::make_unique<Autoscaler>(*limits);
+    name_ = name;
+    parameters_ = *parameters;
+#else
+    throw invalid_argument(
+      "Autoscaling is not enabled in this build of the server");
+#endif
+  }
+  // by default, each instance gets its own batcher so they don't all wait on
+  // one queue
+  default_batchers_ = instances;
+  try {
+    if (parameters->has("drain_timeout_ms")) {
+      const auto timeout = parameters->get<int32_t>("drain_timeout_ms");
+      if (timeout < 0) {
+        throw invalid_argument("The drain timeout can't be negative");
+      }
+      drain_timeout_ = std::chrono::milliseconds{timeout};
+    }
+    for (auto i = 0U; i < instances; ++i) {
+      this->addAndStartWorker(name, parameters, pool);
+    }
+    if (parameters->has("preprocess")) {
+#ifdef AMDINFER_ENABLE_PREPROCESSING
+      preprocessor_ = std::make_unique<Preprocessor>(endpoint, *parameters,
+                                                     this->getBatcher(), pool);
+#else
+      throw invalid_argument(
+        "Preprocessing is not enabled in this build of the server");
+#endif
+    }
+    if (parameters->has("response_cache_mb")) {
+      const auto megabytes = parameters->get<int32_t>("response_cache_mb");
+      if (megabytes <= 0) {
+        throw invalid_argument("The response cache size must be positive");
+      }
+      cache_ = std::make_shared<ResponseCache>(megabytes * kMegabyte);
+    }
+    if (parameters->has("coalesce") && parameters->get<bool>("coalesce")) {
+      coalescer_ = std::make_shared<RequestCoalescer>();
+    }
+    if (parameters->has("max_queue_size") || parameters->has("max_queue_mb")) {
+      const auto requests = parameters->has("max_queue_size")
+                              ? parameters->get<int32_t>("max_queue_size")
+                              : 0;
+      const auto megabytes = parameters->has("max_queue_mb")
+                               ? parameters->get<int32_t>("max_queue_mb")
+                               : 0;
+      if (requests < 0 || megabytes < 0) {
+        throw invalid_argument("The queue limits can't be negative");
+      }
+      queue_limit_ = std::make_shared<QueueLimit>(
+        static_cast<size_t>(requests),
+        static_cast<size_t>(megabytes) * kMegabyte);
+    }
+    if (parameters->has("trace_latency_ms")) {
+      const auto latency = parameters->get<int32_t>("trace_latency_ms");
+      if (latency < 0) {
+        throw invalid_argument("The trace latency can't be negative");
+      }
+      trace_latency_ = std::chrono::milliseconds{latency};
+    }
+  } catch (...) {
+    // stop the instances that did start
+    this->shutdown();
+    throw;
+  }
+
+#ifdef AMDINFER_ENABLE_METRICS
+  // the signals decay with time so they're computed as they're scraped
+  scrape_callback_ = Metrics::getInstance().addScrapeCallback([this]() {
+    const auto signals = this->getSignals();
+    auto& metrics = Metrics::getInstance();
+    metrics.setGauge(MetricGaugeIDs::SignalsConcurrency, endpoint_,
+                     signals.concurrency);
+    metrics.setGauge(MetricGaugeIDs::SignalsQueueTime, endpoint_,
+                     signals.queue_time);
+    metrics.setGauge(MetricGaugeIDs::SignalsThroughput, endpoint_,
+                     signals.throughput);
+    metrics.setGauge(MetricGaugeIDs::SignalsCapacity, endpoint_,
+                     signals.capacity);
+    metrics.setGauge(MetricGaugeIDs::SignalsHeadroom, endpoint_,
+                     signals.headroom);
+  });
+#endif
 }
 
 WorkerInfo::~WorkerInfo() {
+#ifdef AMDINFER_ENABLE_METRICS
+  Metrics::getInstance().removeScrapeCallback(scrape_callback_);
+#endif
+#ifdef AMDINFER_ENABLE_PREPROCESSING
+  preprocessor_.reset();
+#endif
   batchers_.clear();
   for (const auto& [thread_id, worker] : workers_) {
     delete worker;  // NOLINT(cppcoreguidelines-owning-memory)
@@ -118,8 +277,29 @@ WorkerInfo::~WorkerInfo() {
 
 void WorkerInfo::addAndStartWorker(const std::string& name,
                                    ParameterMap* parameters, MemoryPool* pool) {
-  auto* worker = getWorker(name);
+  size_t instance = 0;
+  while (std::any_of(instances_.begin(), instances_.end(),
+                     [instance](const auto& pair) {
+                       return pair.second == instance;
+                     })) {
+    instance++;
+  }
+  ParameterMap instance_parameters = *parameters;
+  instance_parameters.put("instance", static_cast<int32_t>(instance));
+  parameters = &instance_parameters;
+
+  // the Process worker hosts the worker in a child process instead
+  const bool process =
+    parameters->has("process") && parameters->get<bool>("process");
+  if (process) {
+    instance_parameters.put("worker", name);
+  }
+
+  util::Timer timer{true};
+  auto* worker = getWorker(process ? "process" : name);
+  worker->setEndpoint(endpoint_);
   worker->init(parameters);
+  timer.add(util::Mark::Init);
 
   std::vector<MemoryAllocators> allocators = worker->getAllocators();
   ;
@@ -131,21 +311,69 @@ void WorkerInfo::addAndStartWorker(const std::string& name,
   } catch (...) {
     throw runtime_error("Unknown error occurred");
   }
+  timer.add(util::Mark::Acquire);
 
   this->batch_size_ = worker->getBatchSize();
   worker->setPool(pool);
+  worker->preallocate(parameters);
+  timer.add(util::Mark::Preallocate);
+
+  // the worker isn't ready until it's warmed up
+  try {
+    worker->warmUp(parameters);
+  } catch (const std::exception& e) {
+    throw external_error(e.what());
+  } catch (...) {
+    throw runtime_error("Unknown error occurred");
+  }
+  timer.add(util::Mark::Warmup);
+  recordLoadPhase(endpoint_, "init",
+                  timer.count(util::Mark::Start, util::Mark::Init));
+  recordLoadPhase(endpoint_, "acquire",
+                  timer.count(util::Mark::Init, util::Mark::Acquire));
+  recordLoadPhase(endpoint_, "preallocate",
+                  timer.count(util::Mark::Acquire, util::Mark::Preallocate));
+  recordLoadPhase(endpoint_, "warmup",
+                  timer.count(util::Mark::Preallocate, util::Mark::Warmup));
 
   if (this->batchers_.empty()) {
-    int32_t batcher_count = 1;
+    auto batcher_count = static_cast<int32_t>(default_batchers_);
     if (parameters->has("batchers")) {
       batcher_count = parameters->get<int32_t>("batchers");
     }
     this->batchers_ = worker->makeBatcher(batcher_count, parameters, pool);
-
-    for (const auto& batcher : this->batchers_) {
-      batcher->setName(name);
+    const bool ragged =
+      parameters->has("ragged") && parameters->get<bool>("ragged");
+
+    std::vector<BatchPtrQueue*> queues;
+    queues.reserve(this->batchers_.size());
+    for (auto i = 0U; i < this->batchers_.size(); ++i) {
+      const auto& batcher = this->batchers_[i];
+      batcher->setName(endpoint_);
       batcher->setBatchSize(this->batch_size_);
+      batcher->setScatterGather(worker->acceptsScatterGather());
+      batcher->setDeviceInputs(worker->acceptsDeviceInputs());
+      batcher->setRagged(worker->acceptsRaggedBatches() && ragged);
+      batcher->setInputCasts(worker->getInputCasts());
+      auto* queue = batcher->getOutputQueue();
+#ifdef AMDINFER_ENABLE_METRICS
+      // the instances consuming from the same queue are reported together
+      queue->trackActivity([endpoint = endpoint_, i](double seconds) {
+        Metrics::getInstance().addInstanceBusyTime(endpoint, i, seconds);
+      });
+      queue->trackBatches([endpoint = endpoint_, signals = signals_](
+                            size_t requests, double duration) {
+        Metrics::getInstance().observeHistogram(
+          MetricHistogramIDs::WorkerExecution, endpoint, duration);
+        signals->recordBatch(requests, duration, util::getTime());
+      });
+      batcher->setSignals(signals_);
+#endif
+      queues.push_back(queue);
     }
+    // each worker consumes from one batcher's queue but steals from the others
+    // if its own is empty
+    BatchQueue::share(queues);
   }
 
   for (const auto& batcher : this->batchers_) {
@@ -153,16 +381,57 @@ void WorkerInfo::addAndStartWorker(const std::string& name,
       batcher->start(allocators);
     }
   }
-  auto thread = worker->spawn(this->batchers_[0]->getOutputQueue());
+  // spread the workers over the batchers' queues
+  const auto& batcher = batchers_[instance % batchers_.size()];
+  worker->setStopCallback([this]() {
+    const std::lock_guard lock{stop_mutex_};
+    stopped_.push_back(std::this_thread::get_id());
+    stop_cv_.notify_all();
+  });
+  auto thread = worker->spawn(batcher->getOutputQueue());
 
   auto thread_id = thread.get_id();
 
   this->worker_threads_.insert(std::make_pair(thread_id, std::move(thread)));
+  const std::lock_guard lock{workers_mutex_};
   this->workers_.insert(std::make_pair(thread_id, worker));
+  this->instances_.insert(std::make_pair(thread_id, instance));
 }
 
+#ifdef AMDINFER_ENABLE_METRICS
+void WorkerInfo::addInstance(MemoryPool* pool) {
+  this->addAndStartWorker(name_, &parameters_, pool);
+}
+#endif
+
 Batcher* WorkerInfo::getBatcher() { return this->batchers_[0].get(); }
 
+#ifdef AMDINFER_ENABLE_PREPROCESSING
+Preprocessor* WorkerInfo::getPreprocessor() {
+  return this->preprocessor_.get();
+}
+#endif
+
+std::shared_ptr<ResponseCache> WorkerInfo::getCache() const {
+  return this->cache_;
+}
+
+std::shared_ptr<RequestCoalescer> WorkerInfo::getCoalescer() const {
+  return this->coalescer_;
+}
+
+std::optional<std::chrono::milliseconds> WorkerInfo::getTraceLatency() const {
+  return this->trace_latency_;
+}
+
+Autoscaler* WorkerInfo::getAutoscaler() const {
+  return this->autoscaler_.get();
+}
+
+QueueLimit* WorkerInfo::getQueueLimit() const {
+  return this->queue_limit_.get();
+}
+
 void WorkerInfo::join(std::thread::id id) {
   auto& thread = worker_threads_.at(id);
   if (thread.joinable()) {
@@ -179,50 +448,97 @@ void WorkerInfo::joinAll() {
 }
 
 void WorkerInfo::unload() {
-  this->batchers_[0]->getOutputQueue()->enqueue(nullptr);
-
-  bool last_worker = this->workers_.size() == 1;
+  const bool last_worker = this->getGroupSize() == 1;
+#ifdef AMDINFER_ENABLE_PREPROCESSING
+  // finish preprocessing the queued requests while the workers can still run
+  // them
   if (last_worker) {
-    this->joinAll();
-    // we enqueue nullptrs to kill the batchers but don't know which batcher
-    // may receive the nullptr if there are multiple. So, we loop through all of
-    // of them until we find one that's inactive, indicating it received the
-    // nullptr, and end that one.
+    preprocessor_.reset();
+  }
+#endif
+  if (last_worker) {
+    // stop the batchers first so the requests queued before the unload are
+    // batched, and the workers run these batches before they stop. The
+    // batchers share an input queue and each one stops at the first nullptr
+    // it gets so enqueuing one per batcher stops all of them
     for (const auto& batcher : this->batchers_) {
       batcher->enqueue(nullptr);
-      auto i = -1;
-      BatcherStatus status;
-      do {
-        i = (i + 1) % this->batchers_.size();
-        status = batchers_[i]->getStatus();
-      } while (status != BatcherStatus::Inactive);
-      this->batchers_[i]->end();
+    }
+    for (const auto& batcher : this->batchers_) {
+      batcher->end();
     }
   }
+  // the worker that takes the nullptr runs the batches ahead of it and stops
+  this->batchers_[0]->getOutputQueue()->enqueue(nullptr);
 
-  std::thread::id id;
-  bool found = false;
-  while (!found) {
-    for (const auto& [thread_id, worker] : this->workers_) {
-      if (worker->getStatus() == workers::WorkerStatus::Inactive) {
-        id = thread_id;
-        found = true;
-        this->join(thread_id);
-        break;
-      }
-    }
+  const auto id = this->waitForStop(last_worker);
+  this->join(id);
+  workers::Worker* worker = nullptr;
+  {
+    const std::lock_guard lock{workers_mutex_};
+    worker = this->workers_.at(id);
   }
-  auto* worker = this->workers_[id];
   worker->release();
   worker->destroy();
 
+  const std::lock_guard lock{workers_mutex_};
   if (last_worker) {
     delete worker;  // NOLINT(cppcoreguidelines-owning-memory)
   }
   this->workers_.erase(id);
+  this->instances_.erase(id);
+}
+
+std::thread::id WorkerInfo::waitForStop(bool drain) {
+  std::unique_lock lock{stop_mutex_};
+  const auto stopped = [this]() { return !stopped_.empty(); };
+  // no new requests reach the last worker so the batches queued for it can be
+  // failed without another worker missing them
+  if (drain && !stop_cv_.wait_for(lock, drain_timeout_, stopped)) {
+    lock.unlock();
+    this->failQueued();
+    lock.lock();
+  }
+  stop_cv_.wait(lock, stopped);
+
+  const auto id = stopped_.front();
+  stopped_.erase(stopped_.begin());
+  return id;
 }
 
-size_t WorkerInfo::getGroupSize() const { return this->workers_.size(); }
+void WorkerInfo::failQueued() {
+  const auto error =
+    "Worker " + endpoint_ + " was unloaded before the request could run";
+  [[maybe_unused]] size_t failed = 0;
+  bool stop = false;
+  // dequeuing steals from the other queues in the group so one queue is enough
+  auto* queue = this->batchers_[0]->getOutputQueue();
+  BatchPtr batch;
+  while (queue->try_dequeue(batch)) {
+    if (batch == nullptr) {
+      stop = true;
+      continue;
+    }
+    for (const auto& request : batch->getRequests()) {
+      request->runCallbackError(error);
+    }
+    failed += batch->size();
+  }
+  // put back the nullptr so the worker still stops after its current batch
+  if (stop) {
+    queue->enqueue(nullptr);
+  }
+
+  AMDINFER_IF_LOGGING(Logger logger{Loggers::Server};)
+  AMDINFER_LOG_WARN(logger, "Unloading " + endpoint_ + " timed out so " +
+                              std::to_string(failed) +
+                              " queued requests got errors");
+}
+
+size_t WorkerInfo::getGroupSize() const {
+  const std::lock_guard lock{workers_mutex_};
+  return this->workers_.size();
+}
 
 void WorkerInfo::shutdown() {
   auto workers = this->getGroupSize();
@@ -232,8 +548,52 @@ void WorkerInfo::shutdown() {
 }
 
 ModelMetadata WorkerInfo::getMetadata() const {
+  const std::lock_guard lock{workers_mutex_};
   auto* worker_class = workers_.begin()->second;
   return worker_class->getMetadata();
 }
 
+EndpointState WorkerInfo::getState() const {
+  EndpointState state;
+  state.endpoint = endpoint_;
+  // the batchers share one input queue
+  if (!batchers_.empty()) {
+    state.input_queue = batchers_[0]->getInputQueue()->size_approx();
+  }
+  for (const auto& batcher : batchers_) {
+    auto* queue = batcher->getOutputQueue();
+    state.output_queue += queue->size_approx();
+    state.in_flight += queue->inFlight();
+  }
+
+  const std::lock_guard lock{workers_mutex_};
+  for (const auto& [thread_id, worker] : workers_) {
+    state.workers.try_emplace(instances_.at(thread_id), worker->getStatus());
+  }
+  return state;
+}
+
+#ifdef AMDINFER_ENABLE_METRICS
+SignalValues WorkerInfo::getSignals() const {
+  size_t instances = 0;
+  {
+    const std::lock_guard lock{workers_mutex_};
+    instances = workers_.size();
+  }
+  return signals_->get(instances, util::getTime());
+}
+#endif
+
+size_t WorkerInfo::getQueued() const {
+  size_t queued = 0;
+  if (!batchers_.empty()) {
+    queued = batchers_[0]->getInputQueue()->size_approx();
+  }
+  for (const auto& batcher : batchers_) {
+    auto* queue = batcher->getOutputQueue();
+    queued += queue->size_approx() + queue->inFlight();
+  }
+  return queued;
+}
+
 }  // namespace amdinfer
@@ -22,37 +22,87 @@
 #ifndef GUARD_AMDINFER_CORE_WORKER_INFO
 #define GUARD_AMDINFER_CORE_WORKER_INFO
 
-#include <cstddef>  // for size_t
-#include <map>      // for map
-#include <memory>   // for unique_ptr
-#include <string>   // for string
-#include <thread>   // for thread, thread::id
-#include <vector>   // for vector
+#include <chrono>              // for milliseconds, seconds
+#include <condition_variable>  // for condition_variable
+#include <cstddef>             // for size_t
+#include <map>                 // for map
+#include <memory>              // for shared_ptr, unique_ptr
+#include <mutex>               // for mutex
+#include <optional>            // for optional
+#include <string>              // for string
+#include <thread>              // for thread, thread::id
+#include <vector>              // for vector
 
-#include "amdinfer/declarations.hpp"  // for BufferPtr
-#include "amdinfer/util/queue.hpp"    // for BufferPtrsQueuePtr
+#include "amdinfer/batching/endpoint_signals.hpp"  // for SignalValues
+#include "amdinfer/build_options.hpp"              // for AMDINFER_ENABLE_PRE...
+#include "amdinfer/core/autoscaler.hpp"            // for Autoscaler
+#include "amdinfer/core/parameters.hpp"            // for ParameterMap
+#include "amdinfer/declarations.hpp"               // for BufferPtr
+#include "amdinfer/util/queue.hpp"                 // for BufferPtrsQueuePtr
 
 namespace amdinfer {
 class Batcher;
-class ParameterMap;
 class ModelMetadata;
 class MemoryPool;
+class Preprocessor;
+class QueueLimit;
+class RequestCoalescer;
+class ResponseCache;
 namespace workers {
 class Worker;
+enum class WorkerStatus;
 }  // namespace workers
 }  // namespace amdinfer
 
 namespace amdinfer {
 
+/// How long the last worker of a group may run the queued batches by default
+constexpr std::chrono::seconds kDefaultDrainTimeout{30};
+
+/// Makes a new worker, as each worker's library does with getWorker
+using WorkerFactory = workers::Worker* (*)();
+
+/**
+ * @brief Register a worker that's compiled into the server so it's made
+ * without opening its library. The workers in AMDINFER_STATIC_WORKERS register
+ * themselves as the server starts
+ *
+ * @param name the name of the worker's library in lowercase, such as "echo"
+ * @param factory the function that makes the worker
+ */
+void registerWorker(const std::string& name, WorkerFactory factory);
+
+/// A point-in-time view of the queues and workers of a worker group
+struct EndpointState {
+  std::string endpoint;
+  /// requests waiting to be batched
+  size_t input_queue = 0;
+  /// batches waiting for a worker
+  size_t output_queue = 0;
+  /// batches that workers have taken and not finished
+  size_t in_flight = 0;
+  /// instance -> status of each worker in the group
+  std::map<size_t, workers::WorkerStatus> workers;
+};
+
 /**
  * @brief Stores the metadata associated with a worker. Instances of this class
  * are saved in the Manager.
  */
 class WorkerInfo {
  public:
-  /// Construct a new WorkerInfo object
-  WorkerInfo(const std::string& name, ParameterMap* parameters,
-             MemoryPool* pool);
+  /**
+   * @brief Construct a new WorkerInfo object and start some instances of the
+   * worker in its group
+   *
+   * @param endpoint the endpoint that the worker group serves
+   * @param name name of the worker to load
+   * @param parameters pointer to parameters. Should not be nullptr
+   * @param pool memory pool for the workers and batchers
+   * @param instances number of instances of the worker to start
+   */
+  WorkerInfo(const std::string& endpoint, const std::string& name,
+             ParameterMap* parameters, MemoryPool* pool, size_t instances = 1);
   ~WorkerInfo();                           ///> Destroy a WorkerInfo object
   WorkerInfo(WorkerInfo const&) = delete;  ///< Copy constructor
   /// Copy assignment constructor
@@ -67,21 +117,82 @@ class WorkerInfo {
    * @return InferenceRequestPtrQueue*
    */
   Batcher* getBatcher();
+#ifdef AMDINFER_ENABLE_PREPROCESSING
+  /**
+   * @brief Get the preprocessor that requests should be sent to instead of the
+   * batcher, if the worker group has one
+   *
+   * @return Preprocessor* or nullptr if the requests go to the batcher directly
+   */
+  Preprocessor* getPreprocessor();
+#endif
+  /**
+   * @brief Get the cache of responses that requests should be looked up in
+   * first, if the worker group has one
+   *
+   * @return std::shared_ptr<ResponseCache> or nullptr if there's no cache
+   */
+  std::shared_ptr<ResponseCache> getCache() const;
+  /**
+   * @brief Get the coalescer that identical requests in flight are attached to,
+   * if the worker group coalesces them
+   *
+   * @return std::shared_ptr<RequestCoalescer> or nullptr if they all run
+   */
+  std::shared_ptr<RequestCoalescer> getCoalescer() const;
+  /**
+   * @brief Get the limit on the requests waiting to be batched, if the worker
+   * group's queue is bounded
+   *
+   * @return QueueLimit* or nullptr if any number of requests may wait
+   */
+  QueueLimit* getQueueLimit() const;
+  /**
+   * @brief Get the latency past which the traces of the group's requests are
+   * kept when tracing is tail sampled, if the group sets its own
+   *
+   * @return std::optional<std::chrono::milliseconds>
+   */
+  std::optional<std::chrono::milliseconds> getTraceLatency() const;
+  /**
+   * @brief Get the policy that scales the group, if it's autoscaled
+   *
+   * @return Autoscaler* or nullptr if the group is only scaled by loads
+   */
+  Autoscaler* getAutoscaler() const;
   /// Blocks until the associated worker's thread joins
   void join(std::thread::id id);
   void joinAll();  ///< Blocks until all workers in the group join
 
   /**
    * @brief Start a new worker in the group with the given parameters. The name
-   * is used to uniquely identify a particular worker to dynamically load.
+   * is used to uniquely identify a particular worker to dynamically load. The
+   * worker also gets an "instance" parameter with the lowest index that no
+   * other worker in the group has, which it can use to pick a device.
    *
    * @param name
    * @param parameters pointer to parameters. Should not be nullptr
    */
   void addAndStartWorker(const std::string& name, ParameterMap* parameters,
                          MemoryPool* pool);
+#ifdef AMDINFER_ENABLE_METRICS
+  /**
+   * @brief Start another instance of an autoscaled group with the worker and
+   * parameters that the group was loaded with
+   *
+   * @param pool memory pool for the worker
+   */
+  void addInstance(MemoryPool* pool);
+#endif
 
-  /// unload one worker from this worker group
+  /**
+   * @brief Unload one worker from this worker group. The worker runs the
+   * batches ahead of it before it stops. Unloading the last worker first
+   * batches the requests already queued, including partial batches, and waits
+   * for them to run. If they haven't run within the drain timeout, which is
+   * set with the "drain_timeout_ms" load-time parameter, the batches still
+   * queued get error responses and only the running ones are waited for.
+   */
   void unload();
   /// unload all workers from this worker group
   void shutdown();
@@ -94,10 +205,77 @@ class WorkerInfo {
 
   ModelMetadata getMetadata() const;
 
+  /**
+   * @brief Get the current state of the group's queues and workers. It's safe
+   * to call from any thread while workers are added and unloaded.
+   *
+   * @return EndpointState
+   */
+  [[nodiscard]] EndpointState getState() const;
+  /**
+   * @brief Get how much work is queued for the group: the requests waiting to
+   * be batched and the batches waiting for or taken by a worker
+   *
+   * @return size_t
+   */
+  [[nodiscard]] size_t getQueued() const;
+#ifdef AMDINFER_ENABLE_METRICS
+  /**
+   * @brief Get the smoothed signals of the group's load for autoscalers. It's
+   * safe to call from any thread while workers are added and unloaded.
+   *
+   * @return SignalValues
+   */
+  [[nodiscard]] SignalValues getSignals() const;
+#endif
+
  private:
+  /**
+   * @brief Block until a worker has stopped and return its thread's ID
+   *
+   * @param drain whether to fail the queued batches after the drain timeout
+   * @return std::thread::id
+   */
+  std::thread::id waitForStop(bool drain);
+  /// Respond to the batches left in the queues with errors
+  void failQueued();
+
   std::map<std::thread::id, std::thread> worker_threads_;
   std::map<std::thread::id, workers::Worker*> workers_;
+  std::map<std::thread::id, size_t> instances_;
+  /// guards changes to workers_ and instances_ against readers of the state
+  mutable std::mutex workers_mutex_;
+  /// guards stopped_, which workers add their threads' IDs to as they stop
+  std::mutex stop_mutex_;
+  std::condition_variable stop_cv_;
+  std::vector<std::thread::id> stopped_;
+  std::chrono::milliseconds drain_timeout_ = kDefaultDrainTimeout;
   std::vector<std::unique_ptr<Batcher>> batchers_;
+#ifdef AMDINFER_ENABLE_PREPROCESSING
+  std::unique_ptr<Preprocessor> preprocessor_;
+#endif
+  /// shared with the callbacks of the requests that fill it
+  std::shared_ptr<ResponseCache> cache_;
+  /// shared with the callbacks of the requests that others are attached to
+  std::shared_ptr<RequestCoalescer> coalescer_;
+  /// shared with the tickets of the requests that are waiting
+  std::shared_ptr<QueueLimit> queue_limit_;
+  std::optional<std::chrono::milliseconds> trace_latency_;
+  std::unique_ptr<Autoscaler> autoscaler_;
+#ifdef AMDINFER_ENABLE_METRICS
+  /// the worker and parameters that an autoscaled group adds instances with
+  std::string name_;
+  ParameterMap parameters_;
+#endif
+  std::string endpoint_;
+#ifdef AMDINFER_ENABLE_METRICS
+  /// shared with the group's batchers and the callbacks of their queues
+  std::shared_ptr<EndpointSignals> signals_ =
+    std::make_shared<EndpointSignals>();
+  size_t scrape_callback_ = 0;
+#endif
+  /// number of batchers to make if the parameters don't set it
+  size_t default_batchers_ = 1;
   size_t batch_size_ = 1;
 
   friend class Manager;
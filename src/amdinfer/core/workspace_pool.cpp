@@ -0,0 +1,172 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the pool of device memory that the workers on a device
+ * share
+ */
+
+#include "amdinfer/core/workspace_pool.hpp"
+
+#include <cassert>  // for assert
+#include <string>   // for to_string
+#include <utility>  // for move, exchange
+
+#include "amdinfer/core/exceptions.hpp"  // for runtime_error
+
+namespace amdinfer {
+
+namespace {
+
+/// the pools by device, which are removed once no worker holds them
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+std::map<std::string, std::weak_ptr<WorkspacePool>> pools;
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+std::mutex pools_mutex;
+
+}  // namespace
+
+WorkspacePool::Lease::Lease(std::shared_ptr<WorkspacePool> pool, void* data,
+                            size_t size)
+  : pool_(std::move(pool)), data_(data), size_(size) {}
+
+WorkspacePool::Lease::Lease(Lease&& other) noexcept
+  : pool_(std::move(other.pool_)),
+    data_(std::exchange(other.data_, nullptr)),
+    size_(std::exchange(other.size_, 0)) {}
+
+WorkspacePool::Lease& WorkspacePool::Lease::operator=(Lease&& other) noexcept {
+  if (this != &other) {
+    release();
+    pool_ = std::move(other.pool_);
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+  }
+  return *this;
+}
+
+WorkspacePool::Lease::~Lease() { release(); }
+
+void WorkspacePool::Lease::release() {
+  if (auto pool = std::exchange(pool_, nullptr); pool != nullptr) {
+    pool->put(std::exchange(data_, nullptr), std::exchange(size_, 0));
+  }
+}
+
+std::shared_ptr<WorkspacePool> WorkspacePool::get(const std::string& device,
+                                                  Allocate allocate,
+                                                  Free free) {
+  const std::lock_guard lock{pools_mutex};
+  auto& pool = pools[device];
+  if (auto existing = pool.lock(); existing != nullptr) {
+    return existing;
+  }
+  auto created =
+    std::make_shared<WorkspacePool>(std::move(allocate), std::move(free));
+  pool = created;
+  return created;
+}
+
+WorkspacePool::WorkspacePool(Allocate allocate, Free free)
+  : allocate_(std::move(allocate)), free_(std::move(free)) {}
+
+WorkspacePool::~WorkspacePool() {
+  // leases hold the pool so none are left by the time it's destroyed
+  assert(allocated_ == idle_.size() * workspace_size_);
+  for (auto* data : idle_) {
+    free_(data);
+  }
+}
+
+void WorkspacePool::reserve(size_t bytes) {
+  const std::lock_guard lock{mutex_};
+  reservations_[bytes]++;
+  resize();
+}
+
+void WorkspacePool::unreserve(size_t bytes) {
+  const std::lock_guard lock{mutex_};
+  auto reservation = reservations_.find(bytes);
+  if (reservation == reservations_.end()) {
+    return;
+  }
+  if (--reservation->second == 0) {
+    reservations_.erase(reservation);
+  }
+  resize();
+}
+
+WorkspacePool::Lease WorkspacePool::acquire() {
+  std::unique_lock lock{mutex_};
+  const auto size = workspace_size_;
+  if (!idle_.empty()) {
+    auto* data = idle_.back();
+    idle_.pop_back();
+    return {shared_from_this(), data, size};
+  }
+  // the memory is allocated without holding the lock so other workers can
+  // lease and return workspaces in the meantime
+  allocated_ += size;
+  lock.unlock();
+  auto* data = size == 0 ? nullptr : allocate_(size);
+  if (size != 0 && data == nullptr) {
+    lock.lock();
+    allocated_ -= size;
+    throw runtime_error("Could not allocate a workspace of " +
+                        std::to_string(size) + " bytes");
+  }
+  return {shared_from_this(), data, size};
+}
+
+size_t WorkspacePool::getWorkspaceSize() const {
+  const std::lock_guard lock{mutex_};
+  return workspace_size_;
+}
+
+size_t WorkspacePool::getAllocatedSize() const {
+  const std::lock_guard lock{mutex_};
+  return allocated_;
+}
+
+void WorkspacePool::put(void* data, size_t size) {
+  std::unique_lock lock{mutex_};
+  // workspaces of an older size are freed rather than kept
+  if (size != workspace_size_ || data == nullptr) {
+    allocated_ -= size;
+    lock.unlock();
+    if (data != nullptr) {
+      free_(data);
+    }
+    return;
+  }
+  idle_.push_back(data);
+}
+
+void WorkspacePool::resize() {
+  const auto size = reservations_.empty() ? 0 : reservations_.rbegin()->first;
+  if (size == workspace_size_) {
+    return;
+  }
+  // the leased workspaces are freed as they're returned since they no longer
+  // match
+  for (auto* data : idle_) {
+    free_(data);
+  }
+  allocated_ -= idle_.size() * workspace_size_;
+  idle_.clear();
+  workspace_size_ = size;
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,148 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the pool of device memory that the workers on a device share
+ * for the buffers of their jobs in flight
+ */
+
+#ifndef GUARD_AMDINFER_CORE_WORKSPACE_POOL
+#define GUARD_AMDINFER_CORE_WORKSPACE_POOL
+
+#include <cstddef>     // for size_t
+#include <functional>  // for function
+#include <map>         // for map
+#include <memory>      // for shared_ptr
+#include <mutex>       // for mutex
+#include <string>      // for string
+#include <vector>      // for vector
+
+namespace amdinfer {
+
+/**
+ * @brief Shares workspaces of device memory between the workers on a device.
+ * Each worker reserves the size it needs for a job and leases a workspace
+ * while the job is in flight on the device, in place of keeping buffers of its
+ * own for each job it may have in flight. The workspaces are the size of the
+ * largest reservation and there's one for each job in flight at once, which
+ * the device's scheduler bounds if it limits its jobs, so loading more models
+ * on the device costs no more memory unless they need larger workspaces.
+ * Leasing never waits: if all workspaces are leased, another is allocated.
+ *
+ * There's one pool per device, shared by all the workers on it, which is safe
+ * to use from multiple threads.
+ */
+class WorkspacePool : public std::enable_shared_from_this<WorkspacePool> {
+ public:
+  /// Allocates device memory of a size or returns nullptr if there's none
+  using Allocate = std::function<void*(size_t)>;
+  /// Frees memory from the allocate function
+  using Free = std::function<void(void*)>;
+
+  /// Holds a workspace until it's released
+  class Lease {
+   public:
+    Lease() = default;
+    Lease(const Lease&) = delete;             ///< Copy constructor
+    Lease& operator=(const Lease&) = delete;  ///< Copy assignment
+    Lease(Lease&& other) noexcept;            ///< Move constructor
+    Lease& operator=(Lease&& other) noexcept;  ///< Move assignment
+    ~Lease();                                  ///< Destructor
+
+    /// Get the start of the workspace or nullptr if there's none
+    [[nodiscard]] void* data() const { return data_; }
+    /// Get the size of the workspace in bytes
+    [[nodiscard]] size_t size() const { return size_; }
+
+    /// Give the workspace back to the pool
+    void release();
+
+   private:
+    friend class WorkspacePool;
+    Lease(std::shared_ptr<WorkspacePool> pool, void* data, size_t size);
+
+    std::shared_ptr<WorkspacePool> pool_;
+    void* data_ = nullptr;
+    size_t size_ = 0;
+  };
+
+  /**
+   * @brief Get the pool of a device, which is made the first time it's asked
+   * for and lives while any worker holds it. The functions of the first call
+   * are used by all of them
+   *
+   * @param device the device's name, such as gpu0
+   * @param allocate allocates memory on the device
+   * @param free frees memory on the device
+   * @return std::shared_ptr<WorkspacePool>
+   */
+  static std::shared_ptr<WorkspacePool> get(const std::string& device,
+                                            Allocate allocate, Free free);
+
+  /**
+   * @brief Construct a new WorkspacePool object. Use get() to share the
+   * device's pool instead
+   *
+   * @param allocate allocates memory on the device
+   * @param free frees memory on the device
+   */
+  WorkspacePool(Allocate allocate, Free free);
+  WorkspacePool(const WorkspacePool&) = delete;
+  WorkspacePool& operator=(const WorkspacePool&) = delete;
+  WorkspacePool(WorkspacePool&&) = delete;
+  WorkspacePool& operator=(WorkspacePool&&) = delete;
+  /// Destructor. The workspaces must all be released first
+  ~WorkspacePool();
+
+  /// Reserve a size of workspace for a worker's jobs
+  void reserve(size_t bytes);
+  /// Give back a reservation once the worker no longer runs jobs
+  void unreserve(size_t bytes);
+
+  /**
+   * @brief Lease a workspace at least as large as every reservation, reusing
+   * an idle one if there is one. It throws if the memory can't be allocated
+   *
+   * @return Lease
+   */
+  [[nodiscard]] Lease acquire();
+
+  /// Get the size in bytes of each workspace
+  [[nodiscard]] size_t getWorkspaceSize() const;
+  /// Get the bytes held by all the workspaces, leased or idle
+  [[nodiscard]] size_t getAllocatedSize() const;
+
+ private:
+  void put(void* data, size_t size);
+  /**
+   * @brief Size the workspaces for the largest reservation, freeing the idle
+   * ones if it changes. The mutex must be held
+   */
+  void resize();
+
+  Allocate allocate_;
+  Free free_;
+  /// the reserved sizes and the number of reservations of each
+  std::map<size_t, size_t> reservations_;
+  size_t workspace_size_ = 0;
+  size_t allocated_ = 0;
+  /// idle workspaces, all of the workspace size
+  std::vector<void*> idle_;
+  mutable std::mutex mutex_;
+};
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_CORE_WORKSPACE_POOL
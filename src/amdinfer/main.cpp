@@ -19,16 +19,27 @@
  * the amdinfer-server executable
  */
 
+#include <algorithm>            // for max
+#include <chrono>               // for milliseconds
 #include <csignal>              // for signal, SIGINT, SIGTERM
 #include <cstdint>              // for uint16_t
-#include <cstdlib>              // for exit
+#include <cstddef>              // for size_t
+#include <cstdlib>              // for exit, setenv
 #include <cxxopts/cxxopts.hpp>  // for value, OptionAdder, Options
 #include <iostream>             // for operator<<, basic_ostream
-#include <string>               // for string, allocator, char_...
+#include <map>                  // for map
+#include <sstream>              // for stringstream
+#include <stdexcept>            // for logic_error
+#include <string>               // for string, stoi, to_string, getline
 
 #include "amdinfer/build_options.hpp"        // for AMDINFER_ENABLE_HTTP
+#include "amdinfer/core/compression.hpp"     // for Compression
+#include "amdinfer/core/exceptions.hpp"      // for invalid_argument
 #include "amdinfer/observation/logging.hpp"  // for AMDINFER_LOG_INFO, Logger
+#include "amdinfer/observation/tracing.hpp"  // for kTraceSampleRatioEnv
 #include "amdinfer/servers/server.hpp"       // for Server
+#include "amdinfer/util/model_cache.hpp"     // for kModelCacheEnv
+#include "amdinfer/util/thread.hpp"          // for setThreadAffinity
 
 volatile bool usr_interrupt = false;
 
@@ -43,6 +54,129 @@ void signalCallbackHandler([[maybe_unused]] int signum) {
   usr_interrupt = true;
 }
 
+/**
+ * @brief Parse a thread or queue count given on the command line
+ *
+ * @param value a positive integer or "auto" to derive it from the CPUs
+ * @return int
+ */
+int parseThreadCount(const std::string& value) {
+  if (value == "auto") {
+    return amdinfer::kThreadsAuto;
+  }
+  size_t parsed = 0;
+  int count = 0;
+  try {
+    count = std::stoi(value, &parsed);
+  } catch (const std::logic_error&) {
+    parsed = 0;
+  }
+  if (parsed != value.size() || count <= 0) {
+    throw amdinfer::invalid_argument(
+      "Expected a positive integer or auto, got " + value);
+  }
+  return count;
+}
+
+/**
+ * @brief Parse per-device values given on the command line
+ *
+ * @param value comma-separated device=value pairs, such as gpu=1,dpu=2
+ * @return std::map<std::string, std::string>
+ */
+std::map<std::string, std::string> parseDeviceValues(
+  const std::string& value) {
+  std::map<std::string, std::string> values;
+  std::stringstream stream{value};
+  std::string pair;
+  while (std::getline(stream, pair, ',')) {
+    const auto separator = pair.find('=');
+    if (separator == std::string::npos || separator == 0) {
+      throw amdinfer::invalid_argument("Expected device=value, got " + pair);
+    }
+    values[pair.substr(0, separator)] = pair.substr(separator + 1);
+  }
+  return values;
+}
+
+/**
+ * @brief Parse a size in MiB given on the command line
+ *
+ * @param value a non-negative integer
+ * @return size_t the size in bytes
+ */
+size_t parseMebibytes(const std::string& value) {
+  size_t parsed = 0;
+  unsigned long long mebibytes = 0;
+  try {
+    mebibytes = std::stoull(value, &parsed);
+  } catch (const std::logic_error&) {
+    parsed = 0;
+  }
+  if (value.empty() || parsed != value.size() || value.front() == '-') {
+    throw amdinfer::invalid_argument("Expected a size in MiB, got " + value);
+  }
+  const auto mebibyte_bits = 20U;
+  return static_cast<size_t>(mebibytes) << mebibyte_bits;
+}
+
+/**
+ * @brief Parse a tenant's limits given on the command line
+ *
+ * @param value requests_per_second[:bytes_per_second[:max_in_flight]]
+ * @param defaults the limits of the fields that are left out
+ * @return amdinfer::TenantLimit
+ */
+amdinfer::TenantLimit parseTenantLimit(const std::string& value,
+                                       const amdinfer::TenantLimit& defaults) {
+  auto limit = defaults;
+  std::stringstream stream{value};
+  std::string field;
+  for (auto i = 0; std::getline(stream, field, ':'); ++i) {
+    size_t parsed = 0;
+    double number = 0;
+    try {
+      number = std::stod(field, &parsed);
+    } catch (const std::logic_error&) {
+      parsed = 0;
+    }
+    if (field.empty() || parsed != field.size() || number < 0 || i > 2) {
+      throw amdinfer::invalid_argument(
+        "Expected requests_per_second[:bytes_per_second[:max_in_flight]], "
+        "got " +
+        value);
+    }
+    if (i == 0) {
+      limit.requests_per_second = number;
+    } else if (i == 1) {
+      limit.bytes_per_second = number;
+    } else {
+      limit.max_in_flight = static_cast<int>(number);
+    }
+  }
+  return limit;
+}
+
+/**
+ * @brief Parse a compression algorithm given on the command line
+ *
+ * @param value one of none, gzip or deflate
+ * @return amdinfer::Compression
+ */
+amdinfer::Compression parseCompression(const std::string& value) {
+  if (value == "none") {
+    return amdinfer::Compression::None;
+  }
+  if (value == "gzip") {
+    return amdinfer::Compression::Gzip;
+  }
+  if (value == "deflate") {
+    return amdinfer::Compression::Deflate;
+  }
+  throw amdinfer::invalid_argument("Expected none, gzip or deflate, got " +
+                                   value);
+}
+
 /**
  * @brief Parses command line options and starts amdinfer-server
  *
@@ -64,20 +198,56 @@ int main(int argc, char* argv[]) {
 
 #ifdef AMDINFER_ENABLE_HTTP
   uint16_t http_port = kDefaultHttpPort;
+  amdinfer::HttpServerOptions http_options;
+  std::string http_threads = std::to_string(http_options.threads);
+  std::string http_compression = "none";
+  bool http_no_cors = false;
+  amdinfer::PeerOptions peer_options;
 #endif
 #ifdef AMDINFER_ENABLE_GRPC
   uint16_t grpc_port = kDefaultGrpcPort;
+  amdinfer::GrpcServerOptions grpc_options;
+  std::string grpc_queues = std::to_string(grpc_options.completion_queues);
+  std::string grpc_threads = std::to_string(grpc_options.threads_per_queue);
+  std::string grpc_request_threads = "auto";
+  std::string grpc_compression = "none";
+  bool grpc_no_tcp = false;
 #endif
+  uint16_t socket_port = 0;
+  amdinfer::SocketServerOptions socket_options;
+  uint16_t admin_port = 0;
+  amdinfer::AdminServerOptions admin_options;
+  int metrics_scrape_interval = 0;
   std::string model_repository = "/mnt/models";
   bool repository_monitoring = false;
   bool use_polling_watcher = false;
   bool repository_load_existing = false;
+  amdinfer::RepositoryOptions repository_options;
+  std::string repository_load_threads =
+    std::to_string(repository_options.load_threads);
+  std::string repository_device_loads;
+  std::string repository_memory_budgets;
+  std::string model_cache;
+  std::string cpus;
+  int numa_node = -1;
+  bool fast_start = false;
+  amdinfer::MemoryTrimOptions memory_trim_options;
+  bool memory_trim = false;
+  amdinfer::TrafficCaptureOptions capture_options;
+  amdinfer::TenantLimitOptions tenant_options;
+  std::string tenant_limits;
+  std::string worker_host;
+#ifdef AMDINFER_ENABLE_TRACING
+  std::string trace_sample_ratio;
+  std::string trace_tail_latency;
+#endif
 
   try {
     cxxopts::Options options("amdinfer-server", "Inference in the cloud");
     // clang-format off
     options.add_options()
-    ("model-repository", "Path to the model repository",
+    ("model-repository",
+      "Path to the model repository or the URL of a remote one such as s3://bucket/models, gs://bucket/models or https://host/models",
       cxxopts::value(model_repository))
     ("repository-load-existing",
       "Load all models found in the model repository as the server starts",
@@ -85,14 +255,182 @@ int main(int argc, char* argv[]) {
     ("repository-monitoring",
       "Actively monitor the model-repository directory for new models. Sets repository-load-existing to true if enabled",
       cxxopts::value(repository_monitoring))
+    ("repository-load-threads",
+      "Number of existing models in the model repository to load at once, or auto for one per CPU",
+      cxxopts::value(repository_load_threads))
+    ("repository-device-loads",
+      "Most existing models to load at once onto each kind of device, as device=count pairs such as gpu=1,dpu=1",
+      cxxopts::value(repository_device_loads))
+    ("repository-lazy-load",
+      "Load models from the model repository when they're first requested",
+      cxxopts::value(repository_options.lazy_load))
+    ("repository-memory-budgets",
+      "Most memory in MiB that lazily loaded models may take on each kind of device, as device=size pairs such as gpu=16384. Idle models are unloaded to stay within it",
+      cxxopts::value(repository_memory_budgets))
+    ("repository-cache",
+      "Directory to download remote model repositories to. Defaults to the remote directory in the model cache",
+      cxxopts::value(repository_options.cache_directory))
+    ("repository-download-threads",
+      "Number of parts of files to download from a remote model repository at once",
+      cxxopts::value(repository_options.download_threads))
     ("use-polling-watcher", "Use polling to monitor model-repository directory",
       cxxopts::value(use_polling_watcher))
+    ("model-cache",
+      "Directory to cache compiled models in. Defaults to $AMDINFER_MODEL_CACHE or $HOME/.amdinfer/cache",
+      cxxopts::value(model_cache))
 #ifdef AMDINFER_ENABLE_HTTP
     ("http-port", "Port to use for HTTP server", cxxopts::value(http_port))
+    ("http-threads", "Number of HTTP I/O threads or auto to use one per CPU",
+      cxxopts::value(http_threads))
+    ("http-max-body-size", "Maximum size of a HTTP request body in bytes",
+      cxxopts::value(http_options.max_body_size))
+    ("http-debug-endpoints",
+      "Serve endpoints to profile the server and dump the state of its queues and workers",
+      cxxopts::value(http_options.debug_endpoints))
+    ("http-compression",
+      "Compress inference responses that accept it with none, gzip or deflate, falling back to the other algorithm if only it's accepted",
+      cxxopts::value(http_compression))
+    ("http-compression-threshold",
+      "Smallest HTTP response in bytes to compress",
+      cxxopts::value(http_options.compression.threshold))
+    ("http-stream-threshold",
+      "Smallest binary data in bytes of an HTTP response to send with chunked encoding or 0 to never stream",
+      cxxopts::value(http_options.stream_threshold))
+    ("http-idle-timeout",
+      "Seconds to keep idle HTTP connections open or 0 to keep them until clients close them",
+      cxxopts::value(http_options.idle_connection_timeout))
+    ("http-keepalive-requests",
+      "Most requests served on a HTTP connection before it's closed or 0 for no limit",
+      cxxopts::value(http_options.keepalive_requests))
+    ("http-pipelining-requests",
+      "Most pipelined requests pending on a HTTP connection or 0 for no limit",
+      cxxopts::value(http_options.pipelining_requests))
+    ("http-max-connections", "Most HTTP connections open at once",
+      cxxopts::value(http_options.max_connections))
+    ("http-max-connections-per-ip",
+      "Most HTTP connections open from one IP or 0 for no limit",
+      cxxopts::value(http_options.max_connections_per_ip))
+    ("http-no-cors",
+      "Don't add the Access-Control-Allow-Origin header to HTTP responses",
+      cxxopts::value(http_no_cors))
+    ("peers",
+      "Other servers in the pool to forward requests to when they're less loaded or have the model loaded, as comma-separated host:socket_port:http_port",
+      cxxopts::value(peer_options.peers))
+    ("peer-poll-interval", "Milliseconds between fetches of the peers' loads",
+      cxxopts::value(peer_options.poll_interval))
+    ("peer-forward-threshold",
+      "Requests and batches queued for a model before its requests may go to a less loaded peer",
+      cxxopts::value(peer_options.forward_threshold))
 #endif
 #ifdef AMDINFER_ENABLE_GRPC
     ("grpc-port", "Port to use for gRPC server", cxxopts::value(grpc_port))
+    ("grpc-completion-queues",
+      "Number of gRPC completion queues or auto to use one per CPU",
+      cxxopts::value(grpc_queues))
+    ("grpc-threads-per-queue",
+      "Number of threads polling each gRPC completion queue or auto to divide the CPUs between the queues",
+      cxxopts::value(grpc_threads))
+    ("grpc-infer-slots",
+      "Number of inference calls posted on each gRPC completion queue to accept requests",
+      cxxopts::value(grpc_options.infer_slots))
+    ("grpc-callback-api",
+      "Serve gRPC calls on gRPC's callback API instead of polling completion queues",
+      cxxopts::value(grpc_options.callback_api))
+    ("grpc-request-threads",
+      "Number of threads mapping gRPC inference requests with the callback API or auto to use one per CPU",
+      cxxopts::value(grpc_request_threads))
+    ("grpc-max-message-size", "Maximum size of a gRPC message in bytes",
+      cxxopts::value(grpc_options.max_message_size))
+    ("grpc-compression",
+      "Compress gRPC inference responses with none, gzip or deflate",
+      cxxopts::value(grpc_compression))
+    ("grpc-compression-threshold",
+      "Smallest gRPC response in bytes to compress",
+      cxxopts::value(grpc_options.compression.threshold))
+    ("grpc-unix-socket",
+      "Path of a Unix domain socket for the gRPC server to listen on as well",
+      cxxopts::value(grpc_options.unix_socket))
+    ("grpc-no-tcp",
+      "Only listen on the gRPC Unix domain socket, not the gRPC port",
+      cxxopts::value(grpc_no_tcp))
+#endif
+    ("socket-port",
+      "Port to use for the socket server, which serves inference with the binary wire format. If 0, it's not started",
+      cxxopts::value(socket_port))
+    ("socket-max-message-size",
+      "Maximum size of a request to the socket server in bytes",
+      cxxopts::value(socket_options.max_message_size))
+    ("admin-port",
+      "Port to use for the admin server, which serves the metrics and health checks on a thread of its own apart from inference. If 0, it's not started",
+      cxxopts::value(admin_port))
+    ("admin-debug-endpoints",
+      "Serve endpoints to profile the server and dump the state of its queues and workers on the admin server",
+      cxxopts::value(admin_options.debug_endpoints))
+    ("admin-bulk-jobs",
+      "Serve endpoints to run dataset files on the server's disk through models in bulk on the admin server",
+      cxxopts::value(admin_options.bulk_jobs))
+    ("metrics-scrape-interval",
+      "Least milliseconds between serializations of the metrics. Scrapes that arrive sooner get the last one. If 0, each scrape serializes them",
+      cxxopts::value(metrics_scrape_interval))
+    ("cpus",
+      "CPU list (e.g. 0-3,8) to pin the server's threads to. Endpoints inherit it unless loaded with their own cpus or numa_node parameter",
+      cxxopts::value(cpus))
+    ("numa-node",
+      "NUMA node to pin the server's threads to. Ignored if cpus is set",
+      cxxopts::value(numa_node))
+    ("fast-start",
+      "Start the HTTP, gRPC and socket servers before scanning the model repository so liveness checks pass while its models load. The server isn't ready until they've loaded",
+      cxxopts::value(fast_start))
+    ("memory-trim",
+      "Periodically give the memory that the server's buffers no longer use back to the system",
+      cxxopts::value(memory_trim))
+    ("memory-trim-interval", "Seconds between trims of the server's memory",
+      cxxopts::value(memory_trim_options.interval))
+    ("memory-keep-mb",
+      "MiB that each of the server's allocators may keep allocated when its memory is trimmed. Memory in use is always kept",
+      cxxopts::value(memory_trim_options.keep_mb))
+    ("record-traffic",
+      "Record the inference requests that arrive to this file so they can be replayed with amdinfer-perf --replay",
+      cxxopts::value(capture_options.path))
+    ("record-sample-rate", "Fraction of the requests to record, from 0 to 1",
+      cxxopts::value(capture_options.sample_rate))
+    ("record-max-mb", "MiB that the recording may grow to before it stops",
+      cxxopts::value(capture_options.max_mb))
+    ("record-payloads",
+      "Record the data of the requests' inputs and not just their shapes",
+      cxxopts::value(capture_options.payloads))
+    ("tenant-header",
+      "Header, or gRPC metadata key, that names the tenant of each inference call for the tenant limits",
+      cxxopts::value(tenant_options.header))
+    ("tenant-requests-per-second",
+      "Inference calls per second that each tenant may send. Calls over a tenant's limits fail with HTTP status 429 or gRPC status RESOURCE_EXHAUSTED. If 0, there's no limit",
+      cxxopts::value(tenant_options.limits.requests_per_second))
+    ("tenant-bytes-per-second",
+      "Bytes of inference calls per second that each tenant may send. If 0, there's no limit",
+      cxxopts::value(tenant_options.limits.bytes_per_second))
+    ("tenant-max-in-flight",
+      "Inference calls that each tenant may have in flight at once. If 0, there's no limit",
+      cxxopts::value(tenant_options.limits.max_in_flight))
+    ("tenant-burst",
+      "Seconds of its rates that an idle tenant may send at once",
+      cxxopts::value(tenant_options.burst))
+    ("tenant-limits",
+      "Limits of particular tenants as comma-separated tenant=requests_per_second[:bytes_per_second[:max_in_flight]] entries. Fields left out take the limits of the other tenants",
+      cxxopts::value(tenant_limits))
+    ("tenant-max-tenants",
+      "Tenants that are limited apart. Calls from any later ones are limited together as the tenant \"other\"",
+      cxxopts::value(tenant_options.max_tenants))
+#ifdef AMDINFER_ENABLE_TRACING
+    ("trace-sample-ratio",
+      "Fraction of new traces to sample, from 0 to 1. Defaults to $AMDINFER_TRACE_SAMPLE_RATIO or 1. Requests that continue a trace follow the caller's decision",
+      cxxopts::value(trace_sample_ratio))
+    ("trace-tail-latency-ms",
+      "Tail sample traces, keeping those of inference requests that fail or take longer than this and the other traces at the sampling ratio, which then defaults to 0. Defaults to $AMDINFER_TRACE_TAIL_LATENCY_MS. Endpoints can set their own with the trace_latency_ms load-time parameter",
+      cxxopts::value(trace_tail_latency))
 #endif
+    ("worker-host",
+      "Serve a worker over this shared memory channel instead of starting the servers. The server starts itself this way for workers loaded with the process parameter",
+      cxxopts::value(worker_host))
     ("help", "Print help");
     // clang-format on
 
@@ -102,12 +440,117 @@ int main(int argc, char* argv[]) {
       std::cout << options.help({""}) << "\n";
       exit(0);
     }
+
+    repository_options.load_threads = parseThreadCount(repository_load_threads);
+    for (const auto& [device, loads] :
+         parseDeviceValues(repository_device_loads)) {
+      repository_options.device_loads[device] = parseThreadCount(loads);
+    }
+    for (const auto& [device, budget] :
+         parseDeviceValues(repository_memory_budgets)) {
+      repository_options.memory_budgets[device] = parseMebibytes(budget);
+    }
+    for (const auto& [tenant, limit] : parseDeviceValues(tenant_limits)) {
+      tenant_options.tenants[tenant] =
+        parseTenantLimit(limit, tenant_options.limits);
+    }
+#ifdef AMDINFER_ENABLE_HTTP
+    http_options.threads = parseThreadCount(http_threads);
+    http_options.compression.algorithm = parseCompression(http_compression);
+    http_options.cors = !http_no_cors;
+#endif
+#ifdef AMDINFER_ENABLE_GRPC
+    grpc_options.completion_queues = parseThreadCount(grpc_queues);
+    grpc_options.threads_per_queue = parseThreadCount(grpc_threads);
+    grpc_options.request_threads = parseThreadCount(grpc_request_threads);
+    grpc_options.compression.algorithm = parseCompression(grpc_compression);
+    grpc_options.tcp = !grpc_no_tcp;
+    if (grpc_options.infer_slots <= 0) {
+      throw amdinfer::invalid_argument("grpc-infer-slots must be positive");
+    }
+    if (grpc_no_tcp && grpc_options.unix_socket.empty()) {
+      throw amdinfer::invalid_argument(
+        "grpc-no-tcp needs grpc-unix-socket to be set");
+    }
+#endif
+#ifdef AMDINFER_ENABLE_TRACING
+    if (!trace_sample_ratio.empty()) {
+      amdinfer::parseTraceSampleRatio(trace_sample_ratio);
+    }
+    if (!trace_tail_latency.empty()) {
+      amdinfer::parseTraceTailLatency(trace_tail_latency);
+    }
+#endif
   } catch (const cxxopts::OptionException& e) {
     std::cout << "Error parsing options: " << e.what() << "\n";
     exit(1);
+  } catch (const amdinfer::invalid_argument& e) {
+    std::cout << "Error parsing options: " << e.what() << "\n";
+    exit(1);
+  }
+
+  // threads inherit the affinity of the thread that starts them so pinning
+  // here, before the server starts any, pins the HTTP, gRPC and endpoint
+  // threads too
+  try {
+    amdinfer::util::setThreadAffinity(
+      amdinfer::util::getCpuAffinity(cpus, numa_node));
+  } catch (const amdinfer::invalid_argument& e) {
+    std::cout << "Error setting CPU affinity: " << e.what() << "\n";
+    exit(1);
   }
 
+  // workers read the cache directory from the environment unless they're
+  // loaded with their own cache_dir parameter
+  if (!model_cache.empty()) {
+    setenv(amdinfer::util::kModelCacheEnv, model_cache.c_str(), 1);
+  }
+#ifdef AMDINFER_ENABLE_TRACING
+  // the server reads the sampling ratio from the environment as it starts
+  if (!trace_sample_ratio.empty()) {
+    setenv(amdinfer::kTraceSampleRatioEnv, trace_sample_ratio.c_str(), 1);
+  }
+  if (!trace_tail_latency.empty()) {
+    setenv(amdinfer::kTraceTailLatencyEnv, trace_tail_latency.c_str(), 1);
+  }
+#endif
+
   amdinfer::Server server;
+  // a host only serves its worker to the server that started it and exits
+  // once the server is done with it
+  if (!worker_host.empty()) {
+    try {
+      server.hostWorker(worker_host);
+    } catch (const amdinfer::runtime_error& e) {
+      std::cout << "Error hosting the worker: " << e.what() << "\n";
+      exit(1);
+    }
+    return 0;
+  }
+  server.setScrapeInterval(
+    std::chrono::milliseconds{std::max(metrics_scrape_interval, 0)});
+  if (memory_trim) {
+    server.enableMemoryTrimming(memory_trim_options);
+  }
+  if (!capture_options.path.empty()) {
+    try {
+      server.enableTrafficCapture(capture_options);
+    } catch (const amdinfer::runtime_error& e) {
+      std::cout << "Error recording traffic: " << e.what() << "\n";
+      exit(1);
+    }
+  }
+  if (tenant_options.limits.requests_per_second > 0 ||
+      tenant_options.limits.bytes_per_second > 0 ||
+      tenant_options.limits.max_in_flight > 0 ||
+      !tenant_options.tenants.empty()) {
+    try {
+      server.enableTenantLimits(tenant_options);
+    } catch (const amdinfer::invalid_argument& e) {
+      std::cout << "Error limiting tenants: " << e.what() << "\n";
+      exit(1);
+    }
+  }
 
   AMDINFER_IF_LOGGING(amdinfer::Logger logger{amdinfer::Loggers::Server};)
 
@@ -117,21 +560,63 @@ int main(int argc, char* argv[]) {
     repository_load_existing = true;
   }
 
-  server.setModelRepository(model_repository, repository_load_existing);
-  AMDINFER_LOG_INFO(logger, "Using model repository: " + model_repository);
+  const auto set_repository = [&]() {
+    server.setModelRepository(model_repository, repository_load_existing,
+                              repository_options);
+    AMDINFER_LOG_INFO(logger, "Using model repository: " + model_repository);
 
-  if (repository_monitoring) {
-    server.enableRepositoryMonitoring(use_polling_watcher);
+    if (repository_monitoring) {
+      server.enableRepositoryMonitoring(use_polling_watcher);
+    }
+  };
+
+  // scanning a remote repository downloads the models' configs so the servers
+  // start first to pass liveness checks, but they aren't ready until then
+  if (fast_start) {
+    server.expectModelRepository();
+  } else {
+    set_repository();
   }
 
 #ifdef AMDINFER_ENABLE_GRPC
-  std::cout << "gRPC server starting at port " << grpc_port << "\n";
-  server.startGrpc(grpc_port);
+  if (grpc_options.tcp) {
+    std::cout << "gRPC server starting at port " << grpc_port << "\n";
+  }
+  if (!grpc_options.unix_socket.empty()) {
+    std::cout << "gRPC server starting at unix:" << grpc_options.unix_socket
+              << "\n";
+  }
+  server.startGrpc(grpc_port, grpc_options);
 #endif
 
+  if (socket_port != 0) {
+    std::cout << "Socket server starting at port " << socket_port << "\n";
+    server.startSocket(socket_port, socket_options);
+  }
+
+  if (admin_port != 0) {
+    std::cout << "Admin server starting at port " << admin_port << "\n";
+    server.startAdmin(admin_port, admin_options);
+  }
+
 #ifdef AMDINFER_ENABLE_HTTP
   std::cout << "HTTP server starting at port " << http_port << std::endl;
-  server.startHttp(http_port);
+  server.startHttp(http_port, http_options);
+#endif
+
+  if (fast_start) {
+    set_repository();
+  }
+
+#ifdef AMDINFER_ENABLE_HTTP
+  if (!peer_options.peers.empty()) {
+    try {
+      server.enablePeers(peer_options);
+    } catch (const amdinfer::invalid_argument& e) {
+      std::cout << "Error adding peers: " << e.what() << "\n";
+      exit(1);
+    }
+  }
 #endif
 
   // wait until right signal occurs to terminate the server
@@ -47,12 +47,11 @@ void run(amdinfer::Batch* batch, amdinfer::Batch* new_batch) {
   amdinfer::Logger logger{amdinfer::Loggers::Server};
 
   const auto batch_size = batch->size();
-  for (unsigned int j = 0; j < batch_size; j++) {
-    const auto& req = batch->getRequest(j);
 #ifdef AMDINFER_ENABLE_TRACING
-    auto& trace = batch->getTrace(j);
-    trace->startSpan("echo");
+  batch->startSpan("echo");
 #endif
+  for (unsigned int j = 0; j < batch_size; j++) {
+    const auto& req = batch->getRequest(j);
     const auto& new_request = new_batch->getRequest(j);
     new_request->setCallback(req->getCallback());
 
@@ -80,14 +79,16 @@ void run(amdinfer::Batch* batch, amdinfer::Batch* new_batch) {
     }
 
 #ifdef AMDINFER_ENABLE_TRACING
-    trace->endSpan();
-    new_batch->addTrace(std::move(trace));
+    new_batch->addTrace(std::move(batch->getTrace(j)));
 #endif
 
 #ifdef AMDINFER_ENABLE_METRICS
     new_batch->addTime(batch->getTime(j));
 #endif
   }
+#ifdef AMDINFER_ENABLE_TRACING
+  batch->endSpan();
+#endif
 }
 
 }  // extern "C"
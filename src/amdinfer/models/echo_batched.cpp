@@ -0,0 +1,85 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the echo_batched model, which behaves like echo_multi
+ * using the C ABI of model_abi.h
+ */
+
+#include <array>    // for array
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint32_t, uint64_t
+
+#include "amdinfer/core/model_abi.h"  // for AmdinferBatch, AmdinferTensorInfo
+
+namespace {
+
+const int kInputTensors = 2;
+const std::array<uint64_t, kInputTensors> kInputLengths = {1, 2};
+const int kOutputTensors = 3;
+const std::array<uint64_t, kOutputTensors> kOutputLengths = {1, 4, 3};
+
+const std::array<AmdinferTensorInfo, kInputTensors> kInputs = {
+  {{"input0", AMDINFER_UINT32, &kInputLengths[0], 1},
+   {"input1", AMDINFER_UINT32, &kInputLengths[1], 1}}};
+const std::array<AmdinferTensorInfo, kOutputTensors> kOutputs = {
+  {{"output0", AMDINFER_UINT32, &kOutputLengths[0], 1},
+   {"output1", AMDINFER_UINT32, &kOutputLengths[1], 1},
+   {"output2", AMDINFER_UINT32, &kOutputLengths[2], 1}}};
+
+}  // namespace
+
+extern "C" {
+
+uint32_t amdinferModelAbiVersion() { return AMDINFER_MODEL_ABI_VERSION; }
+
+size_t amdinferModelInputs(const AmdinferTensorInfo** tensors) {
+  *tensors = kInputs.data();
+  return kInputs.size();
+}
+
+size_t amdinferModelOutputs(const AmdinferTensorInfo** tensors) {
+  *tensors = kOutputs.data();
+  return kOutputs.size();
+}
+
+int32_t amdinferModelRun(AmdinferBatch* batch) {
+  // the outputs repeat the inputs of each request, in order
+  constexpr auto kInputNum = kInputLengths[0] + kInputLengths[1];
+  for (size_t j = 0; j < batch->size; ++j) {
+    std::array<uint32_t, kInputNum> args{};
+    size_t index = 0;
+    for (auto i = 0; i < kInputTensors; ++i) {
+      const auto* input = static_cast<const uint32_t*>(batch->inputs[i].data) +
+                          j * kInputLengths.at(i);
+      for (auto k = 0U; k < kInputLengths.at(i); ++k) {
+        args.at(index++) = input[k];
+      }
+    }
+
+    index = 0;
+    for (auto i = 0; i < kOutputTensors; ++i) {
+      auto* output = static_cast<uint32_t*>(batch->outputs[i].data) +
+                     j * kOutputLengths.at(i);
+      for (auto k = 0U; k < kOutputLengths.at(i); ++k) {
+        output[k] = args.at(index);
+        index = (index + 1) % kInputNum;
+      }
+    }
+  }
+  return 0;
+}
+
+}  // extern "C"
@@ -20,21 +20,26 @@
 
 #include "amdinfer/observation/logging.hpp"
 
+#include <spdlog/async.h>                     // for async_logger, init_thr...
 #include <spdlog/sinks/basic_file_sink.h>     // for basic_file_sink_mt, bas...
 #include <spdlog/sinks/stdout_color_sinks.h>  // for ansicolor_stdout_sink
 #include <spdlog/spdlog.h>
 
-#include <cassert>   // for assert
-#include <cstdlib>   // for getenv
-#include <iterator>  // for begin, end
-#include <memory>    // for allocator, make_shared
-#include <string>    // for string, operator+, char...
-#include <vector>    // for vector
+#include <algorithm>  // for min
+#include <cassert>    // for assert
+#include <cstdlib>    // for atexit, getenv
+#include <iterator>   // for begin, end
+#include <memory>     // for allocator, make_shared
+#include <string>     // for string, operator+, char...
+#include <vector>     // for vector
 
 #include "amdinfer/core/exceptions.hpp"
 
 namespace amdinfer {
 
+/// Number of messages that can wait to be written before logging blocks
+constexpr auto kLogQueueSize = 8192;
+
 constexpr spdlog::level::level_enum getLevel(LogLevel level) {
   switch (level) {
     case LogLevel::Trace:
@@ -63,12 +68,16 @@ void initLogger(const LogOptions& options) {
   assert(options.console_enable || options.file_enable);
 
   std::vector<spdlog::sink_ptr> sinks;
+  // the logger's level is the lowest of its sinks so messages that no sink
+  // would write are dropped before they're built
+  auto level = spdlog::level::off;
 
   if (options.console_enable) {
     auto console_sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
     console_sink->set_level(getLevel(options.console_level));
     console_sink->set_pattern("[amdinfer] [%^%l%$] %v");
     sinks.push_back(console_sink);
+    level = std::min(level, getLevel(options.console_level));
   }
 
   if (options.file_enable) {
@@ -77,15 +86,28 @@ void initLogger(const LogOptions& options) {
       std::make_shared<spdlog::sinks::basic_file_sink_mt>(log_file, true);
     file_sink->set_level(getLevel(options.file_level));
     sinks.push_back(file_sink);
+    level = std::min(level, getLevel(options.file_level));
   }
 
-  logger = std::make_shared<spdlog::logger>(options.logger_name,
-                                            std::begin(sinks), std::end(sinks));
-  logger->set_level(spdlog::level::trace);
+  // messages are written by a background thread so logging doesn't wait on
+  // the console or disk. If it falls behind, the caller waits for room in the
+  // queue so no messages are lost
+  if (spdlog::thread_pool() == nullptr) {
+    spdlog::init_thread_pool(kLogQueueSize, 1);
+    // write out the queued messages and stop the thread before exiting
+    static const auto kRegistered = std::atexit(shutdownLogging);
+    (void)kRegistered;
+  }
+  logger = std::make_shared<spdlog::async_logger>(
+    options.logger_name, std::begin(sinks), std::end(sinks),
+    spdlog::thread_pool(), spdlog::async_overflow_policy::block);
+  logger->set_level(level);
   logger->flush_on(spdlog::level::info);
   spdlog::register_logger(logger);
 }
 
+void shutdownLogging() { spdlog::shutdown(); }
+
 Logger::Logger(Loggers name) { set(name); }
 
 void Logger::set(Loggers name) {
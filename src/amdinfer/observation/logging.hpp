@@ -28,7 +28,12 @@
 
 #ifdef AMDINFER_ENABLE_LOGGING
 
-#ifndef NDEBUG
+// the minimum level that's compiled in can be set at build time and messages
+// below it are removed
+#if defined(AMDINFER_LOG_ACTIVE_LEVEL)
+// NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
+#define SPDLOG_ACTIVE_LEVEL AMDINFER_LOG_ACTIVE_LEVEL
+#elif !defined(NDEBUG)
 // used for debug builds
 // NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
 #define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
@@ -40,21 +45,63 @@
 
 #include <spdlog/spdlog.h>
 
+// The message is only evaluated if the logger would log it so building the
+// message string costs nothing below the run-time level
+// NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
+#define AMDINFER_LOG_CALL(logger, level, message)          \
+  do {                                                     \
+    auto* amdinfer_logger = (logger).get();                \
+    if (amdinfer_logger->should_log(level)) {              \
+      SPDLOG_LOGGER_CALL(amdinfer_logger, level, message); \
+    }                                                      \
+  } while (0)
+
+// Messages below the compile-time level are removed. They're kept in an
+// unevaluated context so variables only used for logging aren't unused
+// NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
+#define AMDINFER_LOG_DISCARD(logger, message) \
+  static_cast<void>(sizeof((logger).get()) + sizeof(message))
+
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_TRACE
 // NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
 #define AMDINFER_LOG_TRACE(logger, message) \
-  SPDLOG_LOGGER_TRACE((logger).get(), message)
+  AMDINFER_LOG_CALL(logger, spdlog::level::trace, message)
+#else
+// NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
+#define AMDINFER_LOG_TRACE(logger, message) AMDINFER_LOG_DISCARD(logger, message)
+#endif
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_DEBUG
 // NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
 #define AMDINFER_LOG_DEBUG(logger, message) \
-  SPDLOG_LOGGER_DEBUG((logger).get(), message)
+  AMDINFER_LOG_CALL(logger, spdlog::level::debug, message)
+#else
+// NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
+#define AMDINFER_LOG_DEBUG(logger, message) AMDINFER_LOG_DISCARD(logger, message)
+#endif
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_INFO
 // NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
 #define AMDINFER_LOG_INFO(logger, message) \
-  SPDLOG_LOGGER_INFO((logger).get(), message)
+  AMDINFER_LOG_CALL(logger, spdlog::level::info, message)
+#else
+// NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
+#define AMDINFER_LOG_INFO(logger, message) AMDINFER_LOG_DISCARD(logger, message)
+#endif
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_WARN
 // NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
 #define AMDINFER_LOG_WARN(logger, message) \
-  SPDLOG_LOGGER_WARN((logger).get(), message)
+  AMDINFER_LOG_CALL(logger, spdlog::level::warn, message)
+#else
+// NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
+#define AMDINFER_LOG_WARN(logger, message) AMDINFER_LOG_DISCARD(logger, message)
+#endif
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_ERROR
 // NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
 #define AMDINFER_LOG_ERROR(logger, message) \
-  SPDLOG_LOGGER_ERROR((logger).get(), message)
+  AMDINFER_LOG_CALL(logger, spdlog::level::err, message)
+#else
+// NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
+#define AMDINFER_LOG_ERROR(logger, message) AMDINFER_LOG_DISCARD(logger, message)
+#endif
 
 // NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
 #define AMDINFER_IF_LOGGING(args) args
@@ -100,6 +147,11 @@ class Logger {
 
 /// Initialize logging for the inference server
 void initLogger(const LogOptions& options);
+/**
+ * @brief Write out the queued messages and drop the loggers. It's called when
+ * the process exits and logging can be initialized again after it.
+ */
+void shutdownLogging();
 
 /// get log directory
 std::string getLogDirectory();
@@ -20,60 +20,258 @@
 
 #include "amdinfer/observation/metrics.hpp"
 
+#include <prometheus/client_metric.h>    // for ClientMetric
 #include <prometheus/collectable.h>      // for Collectable
 #include <prometheus/counter.h>          // for Builder, Counter, BuildCounter
 #include <prometheus/family.h>           // for Family
 #include <prometheus/gauge.h>            // for Gauge, BuildGauge
 #include <prometheus/metric_family.h>    // for MetricFamily
+#include <prometheus/metric_type.h>      // for MetricType
 #include <prometheus/serializer.h>       // for Serializer
-#include <prometheus/summary.h>          // for CKMSQuantiles, CKMSQuantiles...
 #include <prometheus/text_serializer.h>  // for TextSerializer
 
-#include <iterator>  // for move_iterator, make_move_ite...
-#include <memory>    // for weak_ptr, allocator, shared_ptr
-#include <ratio>     // for micro
-#include <string>    // for string
-#include <vector>    // for vector
+#include <algorithm>   // for clamp, lower_bound, is_sorted
+#include <cassert>     // for assert
+#include <chrono>      // for duration, steady_clock
+#include <functional>  // for less, cref, function
+#include <iterator>    // for move_iterator, make_move_ite...
+#include <limits>      // for numeric_limits
+#include <memory>      // for weak_ptr, allocator, shared_ptr
+#include <mutex>       // for lock_guard
+#include <numeric>     // for accumulate
+#include <ratio>       // for micro
+#include <string>      // for string
+#include <thread>      // for thread
+#include <tuple>       // for tuple, make_tuple
+#include <utility>     // for move
+#include <vector>      // for vector
 
 #include "amdinfer/util/timer.hpp"  // for Timer
 
 namespace amdinfer {
 
+namespace {
+
+/// the exclusions alive on this thread
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+thread_local size_t exclusions = 0;
+
+// keep shards that different threads write to on separate cache lines
+constexpr size_t kCacheLineSize = 64;
+constexpr size_t kCountsPerLine = kCacheLineSize / sizeof(uint64_t);
+constexpr size_t kMaxShards = 64;
+
+/// Get the number of shards per metric, which is one per hardware thread
+size_t getShardCount() {
+  static const size_t count = [] {
+    const size_t threads = std::thread::hardware_concurrency();
+    return std::clamp<size_t>(threads, 1, kMaxShards);
+  }();
+  return count;
+}
+
+/// Get the shard of the calling thread. Threads are assigned shards in turn
+size_t getShard() {
+  static std::atomic<size_t> next_thread{0};
+  thread_local const size_t shard =
+    next_thread.fetch_add(1, std::memory_order_relaxed) % getShardCount();
+  return shard;
+}
+
+/// Add to an atomic double. Shards are rarely shared so this rarely retries
+void add(std::atomic<double>* target, double value) {
+  auto current = target->load(std::memory_order_relaxed);
+  while (!target->compare_exchange_weak(current, current + value,
+                                        std::memory_order_relaxed)) {
+  }
+}
+
+std::vector<prometheus::ClientMetric::Label> toLabels(
+  const std::map<std::string, std::string>& labels) {
+  std::vector<prometheus::ClientMetric::Label> converted;
+  converted.reserve(labels.size());
+  for (const auto& [name, value] : labels) {
+    converted.push_back({name, value});
+  }
+  return converted;
+}
+
+prometheus::ClientMetric::Histogram toHistogram(
+  const ShardedHistogram& histogram) {
+  prometheus::ClientMetric::Histogram metric;
+  const auto counts = histogram.counts();
+  const auto& buckets = histogram.getBuckets();
+  metric.bucket.reserve(counts.size());
+  for (auto i = 0U; i < counts.size(); ++i) {
+    metric.sample_count += counts[i];
+    metric.bucket.push_back(
+      {metric.sample_count, i < buckets.size()
+                              ? buckets[i]
+                              : std::numeric_limits<double>::infinity()});
+  }
+  metric.sample_sum = histogram.sum();
+  return metric;
+}
+
+}  // namespace
+
+struct alignas(kCacheLineSize) ShardedCounter::Shard {
+  std::atomic<double> value{0};
+};
+
+ShardedCounter::ShardedCounter()
+  : shards_(std::make_unique<Shard[]>(getShardCount())) {}
+
+ShardedCounter::ShardedCounter(ShardedCounter&& other) noexcept = default;
+ShardedCounter& ShardedCounter::operator=(ShardedCounter&& other) noexcept =
+  default;
+ShardedCounter::~ShardedCounter() = default;
+
+void ShardedCounter::increment(double value) {
+  add(&shards_[getShard()].value, value);
+}
+
+double ShardedCounter::value() const {
+  double total = 0;
+  for (auto i = 0U; i < getShardCount(); ++i) {
+    total += shards_[i].value.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+struct alignas(kCacheLineSize) ShardedHistogram::Shard {
+  std::atomic<double> sum{0};
+};
+
+ShardedHistogram::ShardedHistogram(std::vector<double> buckets)
+  : buckets_(std::move(buckets)),
+    // round the counts of a shard, with the overflow bucket, up to full lines
+    stride_((buckets_.size() + kCountsPerLine) / kCountsPerLine *
+            kCountsPerLine),
+    sums_(std::make_unique<Shard[]>(getShardCount())) {
+  assert(std::is_sorted(buckets_.begin(), buckets_.end()));
+  // the counts are value-initialized to zero
+  const auto size = stride_ * getShardCount();
+  counts_ = std::make_unique<std::atomic<uint64_t>[]>(size);
+}
+
+ShardedHistogram::ShardedHistogram(ShardedHistogram&& other) noexcept = default;
+ShardedHistogram& ShardedHistogram::operator=(
+  ShardedHistogram&& other) noexcept = default;
+ShardedHistogram::~ShardedHistogram() = default;
+
+void ShardedHistogram::observe(double value) {
+  // like Prometheus, a bucket holds the values up to and including its bound
+  const auto bucket = static_cast<size_t>(
+    std::lower_bound(buckets_.begin(), buckets_.end(), value) -
+    buckets_.begin());
+  const auto shard = getShard();
+  counts_[shard * stride_ + bucket].fetch_add(1, std::memory_order_relaxed);
+  add(&sums_[shard].sum, value);
+}
+
+const std::vector<double>& ShardedHistogram::getBuckets() const {
+  return buckets_;
+}
+
+std::vector<uint64_t> ShardedHistogram::counts() const {
+  std::vector<uint64_t> counts(buckets_.size() + 1, 0);
+  for (auto shard = 0U; shard < getShardCount(); ++shard) {
+    const auto* shard_counts = &counts_[shard * stride_];
+    for (auto i = 0U; i < counts.size(); ++i) {
+      counts[i] += shard_counts[i].load(std::memory_order_relaxed);
+    }
+  }
+  return counts;
+}
+
+double ShardedHistogram::sum() const {
+  double total = 0;
+  for (auto i = 0U; i < getShardCount(); ++i) {
+    total += sums_[i].sum.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+double ShardedHistogram::quantile(const std::vector<uint64_t>& counts,
+                                  double quantile) const {
+  const auto total = std::accumulate(counts.begin(), counts.end(), uint64_t{0});
+  if (total == 0) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+  const auto rank = quantile * static_cast<double>(total);
+  uint64_t seen = 0;
+  for (auto i = 0U; i < buckets_.size(); ++i) {
+    if (counts[i] == 0) {
+      continue;
+    }
+    const auto before = static_cast<double>(seen);
+    seen += counts[i];
+    if (static_cast<double>(seen) >= rank) {
+      const auto lower = i == 0 ? 0.0 : buckets_[i - 1];
+      const auto fraction =
+        (rank - before) / static_cast<double>(counts[i]);
+      return lower + (buckets_[i] - lower) * fraction;
+    }
+  }
+  // the quantile is in the overflow bucket, which has no upper bound
+  return buckets_.empty() ? std::numeric_limits<double>::quiet_NaN()
+                          : buckets_.back();
+}
+
 CounterFamily::CounterFamily(
-  const std::string& name, const std::string& help,
-  prometheus::Registry* registry,
+  std::string name, std::string help,
   const std::unordered_map<MetricCounterIDs,
                            std::map<std::string, std::string>>& labels)
-  : family_(
-      prometheus::BuildCounter().Name(name).Help(help).Register(*registry)) {
+  : name_(std::move(name)), help_(std::move(help)) {
   for (const auto& [id, label] : labels) {
-    counters_.emplace(id, family_.Add(label));
+    counters_.try_emplace(id, label, ShardedCounter{});
   }
 }
 
 void CounterFamily::increment(MetricCounterIDs id) {
-  if (this->counters_.find(id) != this->counters_.end()) {
-    auto& counter = this->counters_.at(id);
-    counter.Increment();
+  if (auto iterator = this->counters_.find(id);
+      iterator != this->counters_.end()) {
+    iterator->second.second.increment(1);
   }
 }
 
 void CounterFamily::increment(MetricCounterIDs id, size_t increment) {
-  if (this->counters_.find(id) != this->counters_.end()) {
-    auto& counter = this->counters_.at(id);
-    counter.Increment(static_cast<double>(increment));
+  if (auto iterator = this->counters_.find(id);
+      iterator != this->counters_.end()) {
+    iterator->second.second.increment(static_cast<double>(increment));
+  }
+}
+
+void CounterFamily::collect(
+  std::vector<prometheus::MetricFamily>* metrics) const {
+  prometheus::MetricFamily family{name_, help_, prometheus::MetricType::Counter,
+                                  {}};
+  family.metric.reserve(counters_.size());
+  for (const auto& [id, counter] : counters_) {
+    prometheus::ClientMetric metric;
+    metric.label = toLabels(counter.first);
+    metric.counter.value = counter.second.value();
+    family.metric.push_back(std::move(metric));
   }
+  metrics->push_back(std::move(family));
 }
 
 GaugeFamily::GaugeFamily(
   const std::string& name, const std::string& help,
   prometheus::Registry* registry,
   const std::unordered_map<MetricGaugeIDs, std::map<std::string, std::string>>&
-    labels)
+    labels,
+  std::string label)
   : family_(
-      prometheus::BuildGauge().Name(name).Help(help).Register(*registry)) {
-  for (const auto& [id, label] : labels) {
-    gauges_.emplace(id, family_.Add(label));
+      prometheus::BuildGauge().Name(name).Help(help).Register(*registry)),
+    labels_(labels),
+    label_(std::move(label)) {
+  if (!label_.empty()) {
+    return;
+  }
+  for (const auto& [id, gauge_labels] : labels) {
+    gauges_.emplace(id, family_.Add(gauge_labels));
   }
 }
 
@@ -84,58 +282,354 @@ void GaugeFamily::set(MetricGaugeIDs id, double value) {
   }
 }
 
+void GaugeFamily::set(MetricGaugeIDs id, const std::string& label,
+                      double value) {
+  auto found = this->labels_.find(id);
+  if (found == this->labels_.end() || this->label_.empty()) {
+    return;
+  }
+  auto labels = found->second;
+  labels.emplace(this->label_, label);
+  // the family returns the existing gauge if these labels are already known
+  family_.Add(labels).Set(value);
+}
+
+void GaugeFamily::remove(MetricGaugeIDs id, const std::string& label) {
+  auto found = this->labels_.find(id);
+  if (found == this->labels_.end() || this->label_.empty()) {
+    return;
+  }
+  auto labels = found->second;
+  labels.emplace(this->label_, label);
+  family_.Remove(&family_.Add(labels));
+}
+
 SummaryFamily::SummaryFamily(
-  const std::string& name, const std::string& help,
-  prometheus::Registry* registry,
-  const std::unordered_map<MetricSummaryIDs, prometheus::Summary::Quantiles>&
-    quantiles)
-  : family_(
-      prometheus::BuildSummary().Name(name).Help(help).Register(*registry)) {
+  std::string name, std::string help,
+  const std::unordered_map<MetricSummaryIDs, std::vector<double>>& quantiles)
+  : name_(std::move(name)), help_(std::move(help)) {
+  // buckets that grow by 2^(1/8) from 1 to about 10^8 keep the estimated
+  // quantiles within 5% of the data
+  constexpr auto kGrowth = 1.0905077326652577;
+  constexpr auto kBuckets = 214;
+  std::vector<double> buckets;
+  buckets.reserve(kBuckets);
+  auto bound = 1.0;
+  for (auto i = 0; i < kBuckets; ++i) {
+    buckets.push_back(bound);
+    bound *= kGrowth;
+  }
   for (const auto& [id, quantile] : quantiles) {
-    summaries_.emplace(id, family_.Add({}, quantile));
+    summaries_.try_emplace(id, quantile, ShardedHistogram{buckets});
   }
 }
 
 void SummaryFamily::observe(MetricSummaryIDs id, double value) {
-  if (this->summaries_.find(id) != this->summaries_.end()) {
-    auto& summary = this->summaries_.at(id);
-    summary.Observe(value);
+  if (auto iterator = this->summaries_.find(id);
+      iterator != this->summaries_.end()) {
+    iterator->second.second.observe(value);
+  }
+}
+
+void SummaryFamily::collect(
+  std::vector<prometheus::MetricFamily>* metrics) const {
+  prometheus::MetricFamily family{name_, help_, prometheus::MetricType::Summary,
+                                  {}};
+  family.metric.reserve(summaries_.size());
+  for (const auto& [id, summary] : summaries_) {
+    const auto& [quantiles, histogram] = summary;
+    const auto counts = histogram.counts();
+    prometheus::ClientMetric metric;
+    metric.summary.sample_count =
+      std::accumulate(counts.begin(), counts.end(), uint64_t{0});
+    metric.summary.sample_sum = histogram.sum();
+    for (const auto quantile : quantiles) {
+      metric.summary.quantile.push_back(
+        {quantile, histogram.quantile(counts, quantile)});
+    }
+    family.metric.push_back(std::move(metric));
+  }
+  metrics->push_back(std::move(family));
+}
+
+HistogramFamily::HistogramFamily(
+  std::string name, std::string help,
+  const std::unordered_map<MetricHistogramIDs,
+                           std::map<std::string, std::string>>& labels,
+  std::vector<double> buckets)
+  : name_(std::move(name)),
+    help_(std::move(help)),
+    labels_(labels),
+    buckets_(std::move(buckets)) {}
+
+void HistogramFamily::observe(MetricHistogramIDs id, const std::string& model,
+                              double value) {
+  // the histograms are never removed so each thread can keep the ones it found
+  using Key = std::tuple<const HistogramFamily*, MetricHistogramIDs,
+                         std::string>;
+  thread_local std::map<Key, ShardedHistogram*, std::less<>> cache;
+
+  auto iterator = cache.find(std::make_tuple(this, id, std::cref(model)));
+  if (iterator == cache.end()) {
+    auto* histogram = this->get(id, model);
+    if (histogram == nullptr) {
+      return;
+    }
+    iterator = cache.try_emplace(Key{this, id, model}, histogram).first;
+  }
+  iterator->second->observe(value);
+}
+
+ShardedHistogram* HistogramFamily::get(MetricHistogramIDs id,
+                                       const std::string& model) {
+  if (this->labels_.find(id) == this->labels_.end()) {
+    return nullptr;
   }
+  std::lock_guard lock{mutex_};
+  auto& histogram = histograms_[{id, model}];
+  if (histogram == nullptr) {
+    histogram = std::make_unique<ShardedHistogram>(buckets_);
+  }
+  return histogram.get();
+}
+
+void HistogramFamily::collect(
+  std::vector<prometheus::MetricFamily>* metrics) const {
+  prometheus::MetricFamily family{name_, help_,
+                                  prometheus::MetricType::Histogram, {}};
+  std::lock_guard lock{mutex_};
+  family.metric.reserve(histograms_.size());
+  for (const auto& [key, histogram] : histograms_) {
+    const auto& [id, model] = key;
+    auto labels = labels_.at(id);
+    labels.emplace("model", model);
+    prometheus::ClientMetric metric;
+    metric.label = toLabels(labels);
+    metric.histogram = toHistogram(*histogram);
+    family.metric.push_back(std::move(metric));
+  }
+  metrics->push_back(std::move(family));
+}
+
+void DeviceFamily::add(const std::string& device) {
+  std::lock_guard lock{mutex_};
+  devices_.try_emplace(device);
+}
+
+void DeviceFamily::start(const std::string& device) {
+  std::lock_guard lock{mutex_};
+  auto& state = devices_[device];
+  if (state.in_flight == 0) {
+    state.busy_since = Clock::now();
+  }
+  state.in_flight++;
+}
+
+void DeviceFamily::finish(const std::string& device) {
+  std::lock_guard lock{mutex_};
+  auto found = devices_.find(device);
+  if (found == devices_.end() || found->second.in_flight == 0) {
+    return;
+  }
+  auto& state = found->second;
+  state.in_flight--;
+  if (state.in_flight == 0) {
+    state.busy_seconds +=
+      std::chrono::duration<double>(Clock::now() - state.busy_since).count();
+  }
+}
+
+void DeviceFamily::transfer(const std::string& device,
+                            DeviceTransfer direction, size_t bytes) {
+  std::lock_guard lock{mutex_};
+  devices_[device].transferred.at(static_cast<size_t>(direction)) +=
+    static_cast<double>(bytes);
+}
+
+void DeviceFamily::collect(
+  std::vector<prometheus::MetricFamily>* metrics) const {
+  prometheus::MetricFamily busy{
+    "amdinfer_device_busy_seconds_total",
+    "Time that each device has spent with at least one job in flight",
+    prometheus::MetricType::Counter,
+    {}};
+  prometheus::MetricFamily in_flight{"amdinfer_device_jobs_in_flight",
+                                     "Number of jobs in flight on each device",
+                                     prometheus::MetricType::Gauge,
+                                     {}};
+  prometheus::MetricFamily transferred{
+    "amdinfer_device_transferred_bytes_total",
+    "Bytes copied between the host and each device",
+    prometheus::MetricType::Counter,
+    {}};
+
+  const auto now = Clock::now();
+  std::lock_guard lock{mutex_};
+  for (const auto& [device, state] : devices_) {
+    // the time of the jobs in flight is included so busy devices don't look
+    // idle until their jobs finish
+    auto busy_seconds = state.busy_seconds;
+    if (state.in_flight > 0) {
+      busy_seconds +=
+        std::chrono::duration<double>(now - state.busy_since).count();
+    }
+    prometheus::ClientMetric metric;
+    metric.label = {{"device", device}};
+    metric.counter.value = busy_seconds;
+    busy.metric.push_back(metric);
+
+    metric = {};
+    metric.label = {{"device", device}};
+    metric.gauge.value = static_cast<double>(state.in_flight);
+    in_flight.metric.push_back(metric);
+
+    for (const auto& [direction, name] :
+         {std::make_pair(DeviceTransfer::HostToDevice, "host_to_device"),
+          std::make_pair(DeviceTransfer::DeviceToHost, "device_to_host")}) {
+      metric = {};
+      metric.label = {{"device", device}, {"direction", name}};
+      metric.counter.value =
+        state.transferred.at(static_cast<size_t>(direction));
+      transferred.metric.push_back(metric);
+    }
+  }
+  metrics->push_back(std::move(busy));
+  metrics->push_back(std::move(in_flight));
+  metrics->push_back(std::move(transferred));
+}
+
+void TenantFamily::set(const std::string& tenant,
+                       const TenantTraffic& traffic) {
+  std::lock_guard lock{mutex_};
+  tenants_[tenant] = traffic;
 }
 
-// the arguments are percentile and error
+void TenantFamily::collect(
+  std::vector<prometheus::MetricFamily>* metrics) const {
+  prometheus::MetricFamily requests{
+    "amdinfer_tenant_requests_total",
+    "Number of inference calls admitted from each tenant",
+    prometheus::MetricType::Counter,
+    {}};
+  prometheus::MetricFamily bytes{
+    "amdinfer_tenant_bytes_total",
+    "Bytes of the inference calls admitted from each tenant",
+    prometheus::MetricType::Counter,
+    {}};
+  prometheus::MetricFamily in_flight{
+    "amdinfer_tenant_requests_in_flight",
+    "Number of admitted inference calls from each tenant that haven't "
+    "responded",
+    prometheus::MetricType::Gauge,
+    {}};
+  prometheus::MetricFamily rejected{
+    "amdinfer_tenant_rejected_total",
+    "Number of inference calls from each tenant turned away by its limits",
+    prometheus::MetricType::Counter,
+    {}};
+
+  std::lock_guard lock{mutex_};
+  for (const auto& [tenant, traffic] : tenants_) {
+    prometheus::ClientMetric metric;
+    metric.label = {{"tenant", tenant}};
+    metric.counter.value = static_cast<double>(traffic.requests);
+    requests.metric.push_back(metric);
+
+    metric.counter.value = static_cast<double>(traffic.bytes);
+    bytes.metric.push_back(metric);
+
+    metric = {};
+    metric.label = {{"tenant", tenant}};
+    metric.gauge.value = static_cast<double>(traffic.in_flight);
+    in_flight.metric.push_back(metric);
+
+    const std::array<const char*, 3> reasons{"rate", "bytes", "in_flight"};
+    for (auto i = 0U; i < reasons.size(); ++i) {
+      metric = {};
+      metric.label = {{"tenant", tenant}, {"reason", reasons.at(i)}};
+      metric.counter.value = static_cast<double>(traffic.rejected.at(i));
+      rejected.metric.push_back(metric);
+    }
+  }
+  metrics->push_back(std::move(requests));
+  metrics->push_back(std::move(bytes));
+  metrics->push_back(std::move(in_flight));
+  metrics->push_back(std::move(rejected));
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp)
+const std::vector<double> kQuantiles{0.5, 0.9, 0.99};
+
+// latencies from 10us to 10s, in microseconds
 // NOLINTNEXTLINE(cert-err58-cpp)
-const prometheus::detail::CKMSQuantiles::Quantile kPercentile50{0.5, 0.05};
+const std::vector<double> kLatencyBuckets{
+  10,     25,     50,      100,     250,     500,     1000,    2500,    5000,
+  10000,  25000,  50000,   100000,  250000,  500000,  1000000, 2500000, 5000000,
+  10000000};
 // NOLINTNEXTLINE(cert-err58-cpp)
-const prometheus::detail::CKMSQuantiles::Quantile kPercentile90{0.9, 0.01};
+const std::vector<double> kBatchSizeBuckets{
+  1, 2, 4, 8, 16, 32, 64, 128, 256};
 // NOLINTNEXTLINE(cert-err58-cpp)
-const prometheus::detail::CKMSQuantiles::Quantile kPercentile99{0.99, 0.001};
+const std::vector<double> kFillRatioBuckets{
+  0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8, 0.9, 1};
 
 Metrics::Metrics()
   : ingress_requests_total_(
       "amdinfer_requests_ingress_total",
-      "Number of incoming requests to amdinfer-server", registry_.get(),
+      "Number of incoming requests to amdinfer-server",
       {{MetricCounterIDs::CppNative, {{"api", "cpp"}, {"method", "native"}}},
        {MetricCounterIDs::RestGet, {{"api", "rest"}, {"method", "GET"}}},
        {MetricCounterIDs::RestPost, {{"api", "rest"}, {"method", "POST"}}}}),
     pipeline_ingress_total_(
       "amdinfer_pipeline_ingress_total",
       "Number of incoming requests at different pipeline stages",
-      registry_.get(),
       {{MetricCounterIDs::PipelineIngressBatcher, {{"stage", "batcher"}}},
        {MetricCounterIDs::PipelineIngressWorker, {{"stage", "worker"}}}}),
     pipeline_egress_total_(
       "amdinfer_pipeline_egress_total",
       "Number of outgoing requests at different pipeline stages",
-      registry_.get(),
       {{MetricCounterIDs::PipelineEgressBatcher, {{"stage", "batcher"}}},
        {MetricCounterIDs::PipelineEgressWorker, {{"stage", "worker"}}}}),
     bytes_transferred_("exposer_transferred_bytes_total",
-                       "Transferred bytes to metrics services", registry_.get(),
+                       "Transferred bytes to metrics services",
                        {{MetricCounterIDs::TransferredBytes, {}}}),
     num_scrapes_("exposer_scrapes_total",
-                 "Number of times metrics were scraped", registry_.get(),
+                 "Number of times metrics were scraped",
                  {{MetricCounterIDs::MetricScrapes, {}}}),
+    memory_pool_cache_total_(
+      "amdinfer_memory_pool_cache_total",
+      "Number of buffer requests served by the memory pool's thread caches",
+      {{MetricCounterIDs::MemoryPoolCacheHit, {{"result", "hit"}}},
+       {MetricCounterIDs::MemoryPoolCacheMiss, {{"result", "miss"}}}}),
+    response_cache_total_(
+      "amdinfer_response_cache_total",
+      "Number of requests looked up in the endpoints' response caches",
+      {{MetricCounterIDs::ResponseCacheHit, {{"result", "hit"}}},
+       {MetricCounterIDs::ResponseCacheMiss, {{"result", "miss"}}}}),
+    requests_coalesced_total_(
+      "amdinfer_requests_coalesced_total",
+      "Number of requests answered with the response of an identical request "
+      "in flight",
+      {{MetricCounterIDs::RequestsCoalesced, {}}}),
+    requests_rejected_total_(
+      "amdinfer_requests_rejected_total",
+      "Number of requests rejected because their endpoint's queue was full or "
+      "dropped from it because they were cancelled or expired",
+      {{MetricCounterIDs::RequestsRejected, {{"reason", "queue_full"}}},
+       {MetricCounterIDs::RequestsCancelled, {{"reason", "cancelled"}}},
+       {MetricCounterIDs::RequestsExpired, {{"reason", "deadline"}}}}),
+    model_cold_starts_total_(
+      "amdinfer_model_cold_starts_total",
+      "Number of models loaded from the repository by their first request",
+      {{MetricCounterIDs::ModelColdStarts, {}}}),
+    model_evictions_total_(
+      "amdinfer_model_evictions_total",
+      "Number of idle models unloaded to fit others in their device's budget",
+      {{MetricCounterIDs::ModelEvictions, {}}}),
+    websocket_frames_dropped_total_(
+      "amdinfer_websocket_frames_dropped_total",
+      "Number of responses dropped because a websocket client fell behind",
+      {{MetricCounterIDs::WebsocketFramesDropped, {}}}),
     queue_sizes_total_("amdinfer_queue_sizes_total",
                        "Number of elements in the queues in amdinfer-server",
                        registry_.get(),
@@ -146,26 +640,106 @@ Metrics::Metrics()
                         {MetricGaugeIDs::QueuesBufferInput,
                          {{"direction", "input"}, {"stage", "buffer"}}},
                         {MetricGaugeIDs::QueuesBufferOutput,
-                         {{"direction", "output"}, {"stage", "buffer"}}}}),
+                         {{"direction", "output"}, {"stage", "buffer"}}}},
+                       "model"),
+    batcher_timeout_(
+      "amdinfer_batcher_timeout",
+      "Timeout chosen by adaptive batchers for the latest batch, in ms",
+      registry_.get(), {{MetricGaugeIDs::BatcherTimeout, {}}}),
+    memory_allocator_bytes_(
+      "amdinfer_memory_allocator_bytes",
+      "Memory held by the memory pool's allocators, in bytes",
+      registry_.get(),
+      {{MetricGaugeIDs::MemoryAllocatorAllocated, {{"state", "allocated"}}},
+       {MetricGaugeIDs::MemoryAllocatorInUse, {{"state", "in_use"}}},
+       {MetricGaugeIDs::MemoryAllocatorLargestFree,
+        {{"state", "largest_free"}}}},
+      "allocator"),
+    memory_allocator_failures_(
+      "amdinfer_memory_allocator_failures",
+      "Number of requests the memory pool's allocators couldn't serve",
+      registry_.get(), {{MetricGaugeIDs::MemoryAllocatorFailures, {}}},
+      "allocator"),
+    memory_allocator_fragmentation_(
+      "amdinfer_memory_allocator_fragmentation",
+      "Share of the free memory of the memory pool's allocators that's outside "
+      "their largest free range",
+      registry_.get(), {{MetricGaugeIDs::MemoryAllocatorFragmentation, {}}},
+      "allocator"),
+    endpoint_signals_(
+      "amdinfer_endpoint_signals",
+      "Smoothed load of each endpoint for autoscalers. The times are in "
+      "microseconds and the rates in requests per second",
+      registry_.get(),
+      {{MetricGaugeIDs::SignalsConcurrency, {{"signal", "concurrency"}}},
+       {MetricGaugeIDs::SignalsQueueTime, {{"signal", "queue_time"}}},
+       {MetricGaugeIDs::SignalsThroughput, {{"signal", "throughput"}}},
+       {MetricGaugeIDs::SignalsCapacity, {{"signal", "capacity"}}},
+       {MetricGaugeIDs::SignalsHeadroom, {{"signal", "headroom"}}}},
+      "model"),
+    websocket_buffered_bytes_(
+      "amdinfer_websocket_buffered_bytes",
+      "Bytes sent on each websocket connection that the client hasn't "
+      "acknowledged yet or queued to send",
+      registry_.get(), {{MetricGaugeIDs::WebsocketBufferedBytes, {}}},
+      "connection"),
     metric_latency_("exposer_request_latencies",
                     "Latencies of serving scrape requests, in microseconds",
-                    registry_.get(),
-                    {{MetricSummaryIDs::MetricLatency,
-                      prometheus::Summary::Quantiles{
-                        kPercentile50, kPercentile90, kPercentile99}}}),
+                    {{MetricSummaryIDs::MetricLatency, kQuantiles}}),
     request_latency_("amdinfer_request_latency",
                      "Latencies of serving requests, in microseconds",
-                     registry_.get(),
-                     {{MetricSummaryIDs::RequestLatency,
-                       prometheus::Summary::Quantiles{
-                         kPercentile50, kPercentile90, kPercentile99}}}) {
+                     {{MetricSummaryIDs::RequestLatency, kQuantiles}}),
+    stage_latency_(
+      "amdinfer_stage_latency",
+      "Time spent in each stage of serving requests, in microseconds",
+      {{MetricHistogramIDs::IngressParse, {{"stage", "parse"}}},
+       {MetricHistogramIDs::BatcherQueueWait, {{"stage", "queue"}}},
+       {MetricHistogramIDs::BatchFill, {{"stage", "batch_fill"}}},
+       {MetricHistogramIDs::WorkerExecution, {{"stage", "worker"}}},
+       {MetricHistogramIDs::ResponseSerialization, {{"stage", "serialize"}}}},
+      kLatencyBuckets),
+    batch_size_("amdinfer_batch_size",
+                "Number of requests in the batches sent to the workers",
+                {{MetricHistogramIDs::BatchSize, {}}}, kBatchSizeBuckets),
+    batch_fill_ratio_(
+      "amdinfer_batch_fill_ratio",
+      "Size of the batches sent to the workers relative to the batch size",
+      {{MetricHistogramIDs::BatchFillRatio, {}}}, kFillRatioBuckets),
+    instance_busy_total_(
+      prometheus::BuildCounter()
+        .Name("amdinfer_instance_busy_seconds_total")
+        .Help("Time that each model instance has spent running batches")
+        .Register(*registry_)),
+    device_time_total_(
+      prometheus::BuildCounter()
+        .Name("amdinfer_device_time_seconds_total")
+        .Help("Time that each model's jobs have held turns on shared devices")
+        .Register(*registry_)),
+    startup_seconds_(prometheus::BuildGauge()
+                       .Name("amdinfer_startup_seconds")
+                       .Help("Time that each phase of starting the server took")
+                       .Register(*registry_)),
+    model_load_seconds_(
+      prometheus::BuildGauge()
+        .Name("amdinfer_model_load_seconds")
+        .Help("Time that each phase of loading each model's worker took")
+        .Register(*registry_)) {
   std::lock_guard lock{this->collectables_mutex_};
   collectables_.push_back(this->registry_);
 
   this->serializer_ = std::make_unique<prometheus::TextSerializer>();
 }
 
+MetricsExclusion::MetricsExclusion() { exclusions++; }
+
+MetricsExclusion::~MetricsExclusion() { exclusions--; }
+
+bool MetricsExclusion::active() { return exclusions > 0; }
+
 void Metrics::incrementCounter(MetricCounterIDs id, size_t increment) {
+  if (MetricsExclusion::active()) {
+    return;
+  }
   switch (id) {
     case MetricCounterIDs::RestGet:
     case MetricCounterIDs::RestPost:
@@ -186,6 +760,31 @@ void Metrics::incrementCounter(MetricCounterIDs id, size_t increment) {
     case MetricCounterIDs::MetricScrapes:
       this->num_scrapes_.increment(id);
       break;
+    case MetricCounterIDs::MemoryPoolCacheHit:
+    case MetricCounterIDs::MemoryPoolCacheMiss:
+      this->memory_pool_cache_total_.increment(id, increment);
+      break;
+    case MetricCounterIDs::ResponseCacheHit:
+    case MetricCounterIDs::ResponseCacheMiss:
+      this->response_cache_total_.increment(id);
+      break;
+    case MetricCounterIDs::RequestsCoalesced:
+      this->requests_coalesced_total_.increment(id);
+      break;
+    case MetricCounterIDs::RequestsRejected:
+    case MetricCounterIDs::RequestsCancelled:
+    case MetricCounterIDs::RequestsExpired:
+      this->requests_rejected_total_.increment(id);
+      break;
+    case MetricCounterIDs::ModelColdStarts:
+      this->model_cold_starts_total_.increment(id);
+      break;
+    case MetricCounterIDs::ModelEvictions:
+      this->model_evictions_total_.increment(id);
+      break;
+    case MetricCounterIDs::WebsocketFramesDropped:
+      this->websocket_frames_dropped_total_.increment(id, increment);
+      break;
     default:
       break;
   }
@@ -199,12 +798,71 @@ void Metrics::setGauge(MetricGaugeIDs id, double value) {
     case MetricGaugeIDs::QueuesBufferOutput:
       this->queue_sizes_total_.set(id, value);
       break;
+    case MetricGaugeIDs::BatcherTimeout:
+      this->batcher_timeout_.set(id, value);
+      break;
     default:
       break;
   }
 }
 
+void Metrics::setGauge(MetricGaugeIDs id, const std::string& label,
+                       double value) {
+  switch (id) {
+    case MetricGaugeIDs::QueuesBatcherInput:
+    case MetricGaugeIDs::QueuesBatcherOutput:
+    case MetricGaugeIDs::QueuesBufferInput:
+    case MetricGaugeIDs::QueuesBufferOutput:
+      this->queue_sizes_total_.set(id, label, value);
+      break;
+    case MetricGaugeIDs::MemoryAllocatorAllocated:
+    case MetricGaugeIDs::MemoryAllocatorInUse:
+    case MetricGaugeIDs::MemoryAllocatorLargestFree:
+      this->memory_allocator_bytes_.set(id, label, value);
+      break;
+    case MetricGaugeIDs::MemoryAllocatorFailures:
+      this->memory_allocator_failures_.set(id, label, value);
+      break;
+    case MetricGaugeIDs::MemoryAllocatorFragmentation:
+      this->memory_allocator_fragmentation_.set(id, label, value);
+      break;
+    case MetricGaugeIDs::SignalsConcurrency:
+    case MetricGaugeIDs::SignalsQueueTime:
+    case MetricGaugeIDs::SignalsThroughput:
+    case MetricGaugeIDs::SignalsCapacity:
+    case MetricGaugeIDs::SignalsHeadroom:
+      this->endpoint_signals_.set(id, label, value);
+      break;
+    case MetricGaugeIDs::WebsocketBufferedBytes:
+      this->websocket_buffered_bytes_.set(id, label, value);
+      break;
+    default:
+      break;
+  }
+}
+
+void Metrics::removeGauge(MetricGaugeIDs id, const std::string& label) {
+  if (id == MetricGaugeIDs::WebsocketBufferedBytes) {
+    this->websocket_buffered_bytes_.remove(id, label);
+  }
+}
+
+size_t Metrics::addScrapeCallback(std::function<void()> callback) {
+  std::lock_guard lock{this->scrape_callbacks_mutex_};
+  const auto id = scrape_callback_id_++;
+  scrape_callbacks_.try_emplace(id, std::move(callback));
+  return id;
+}
+
+void Metrics::removeScrapeCallback(size_t id) {
+  std::lock_guard lock{this->scrape_callbacks_mutex_};
+  scrape_callbacks_.erase(id);
+}
+
 void Metrics::observeSummary(MetricSummaryIDs id, double value) {
+  if (MetricsExclusion::active()) {
+    return;
+  }
   switch (id) {
     case MetricSummaryIDs::MetricLatency:
       this->metric_latency_.observe(id, value);
@@ -217,11 +875,124 @@ void Metrics::observeSummary(MetricSummaryIDs id, double value) {
   }
 }
 
+void Metrics::observeHistogram(MetricHistogramIDs id, const std::string& model,
+                               double value) {
+  if (MetricsExclusion::active()) {
+    return;
+  }
+  switch (id) {
+    case MetricHistogramIDs::IngressParse:
+    case MetricHistogramIDs::BatcherQueueWait:
+    case MetricHistogramIDs::BatchFill:
+    case MetricHistogramIDs::WorkerExecution:
+    case MetricHistogramIDs::ResponseSerialization:
+      this->stage_latency_.observe(id, model, value);
+      break;
+    case MetricHistogramIDs::BatchSize:
+      this->batch_size_.observe(id, model, value);
+      break;
+    case MetricHistogramIDs::BatchFillRatio:
+      this->batch_fill_ratio_.observe(id, model, value);
+      break;
+    default:
+      break;
+  }
+}
+
+void Metrics::addInstanceBusyTime(const std::string& model, size_t instance,
+                                  double seconds) {
+  if (MetricsExclusion::active()) {
+    return;
+  }
+  // the family returns the existing counter if these labels are already known
+  auto& counter = instance_busy_total_.Add(
+    {{"model", model}, {"instance", std::to_string(instance)}});
+  counter.Increment(seconds);
+}
+
+void Metrics::addDeviceTime(const std::string& device,
+                            const std::string& model, double seconds) {
+  if (MetricsExclusion::active()) {
+    return;
+  }
+  auto& counter =
+    device_time_total_.Add({{"device", device}, {"model", model}});
+  counter.Increment(seconds);
+}
+
+void Metrics::setStartupTime(const std::string& phase, double seconds) {
+  startup_seconds_.Add({{"phase", phase}}).Set(seconds);
+}
+
+void Metrics::setModelLoadTime(const std::string& model,
+                               const std::string& phase, double seconds) {
+  model_load_seconds_.Add({{"model", model}, {"phase", phase}}).Set(seconds);
+}
+
+void Metrics::addDevice(const std::string& device) {
+  this->devices_.add(device);
+}
+
+void Metrics::startDeviceJob(const std::string& device) {
+  this->devices_.start(device);
+}
+
+void Metrics::finishDeviceJob(const std::string& device) {
+  this->devices_.finish(device);
+}
+
+void Metrics::addDeviceTransfer(const std::string& device,
+                                DeviceTransfer direction, size_t bytes) {
+  this->devices_.transfer(device, direction, bytes);
+}
+
+void Metrics::setTenantTraffic(const std::string& tenant,
+                               const TenantTraffic& traffic) {
+  this->tenants_.set(tenant, traffic);
+}
+
+void Metrics::setScrapeInterval(std::chrono::milliseconds interval) {
+  std::lock_guard lock{scrape_mutex_};
+  scrape_interval_ = interval;
+  last_metrics_.clear();
+}
+
 std::string Metrics::getMetrics() {
+  std::string response;
+  {
+    std::lock_guard lock{scrape_mutex_};
+    const auto now = std::chrono::steady_clock::now();
+    if (last_metrics_.empty() || now - last_scrape_ >= scrape_interval_) {
+      response = serialize();
+      if (scrape_interval_.count() > 0) {
+        last_metrics_ = response;
+        last_scrape_ = now;
+      }
+    } else {
+      response = last_metrics_;
+    }
+  }
+
+  this->bytes_transferred_.increment(MetricCounterIDs::TransferredBytes,
+                                     response.length());
+  this->num_scrapes_.increment(MetricCounterIDs::MetricScrapes);
+
+  return response;
+}
+
+std::string Metrics::serialize() {
   util::Timer timer{true};
 
   std::vector<prometheus::MetricFamily> metrics;
 
+  {
+    // callbacks are run with the lock held so they can't run after removal
+    std::lock_guard lock{this->scrape_callbacks_mutex_};
+    for (const auto& [id, callback] : scrape_callbacks_) {
+      callback();
+    }
+  }
+
   {
     std::lock_guard<std::mutex> lock{this->collectables_mutex_};
 
@@ -237,17 +1008,32 @@ std::string Metrics::getMetrics() {
     }
   }
 
+  ingress_requests_total_.collect(&metrics);
+  pipeline_ingress_total_.collect(&metrics);
+  pipeline_egress_total_.collect(&metrics);
+  bytes_transferred_.collect(&metrics);
+  num_scrapes_.collect(&metrics);
+  memory_pool_cache_total_.collect(&metrics);
+  response_cache_total_.collect(&metrics);
+  requests_coalesced_total_.collect(&metrics);
+  requests_rejected_total_.collect(&metrics);
+  model_cold_starts_total_.collect(&metrics);
+  model_evictions_total_.collect(&metrics);
+  websocket_frames_dropped_total_.collect(&metrics);
+  metric_latency_.collect(&metrics);
+  request_latency_.collect(&metrics);
+  stage_latency_.collect(&metrics);
+  batch_size_.collect(&metrics);
+  batch_fill_ratio_.collect(&metrics);
+  devices_.collect(&metrics);
+  tenants_.collect(&metrics);
+
   std::string response = serializer_->Serialize(metrics);
-  auto body_size = response.length();
 
   timer.stop();
   auto duration = timer.count<std::micro>();
   this->observeSummary(MetricSummaryIDs::MetricLatency, duration);
 
-  this->bytes_transferred_.increment(MetricCounterIDs::TransferredBytes,
-                                     body_size);
-  this->num_scrapes_.increment(MetricCounterIDs::MetricScrapes);
-
   return response;
 }
 
@@ -23,14 +23,19 @@
 
 #include <prometheus/registry.h>    // for Registry
 #include <prometheus/serializer.h>  // for Serializer
-#include <prometheus/summary.h>     // for Summary, BuildSummary, Summa...
 
+#include <array>          // for array
+#include <atomic>         // for atomic
+#include <chrono>         // for steady_clock
 #include <cstddef>        // for size_t
+#include <cstdint>        // for uint64_t
+#include <functional>     // for function
 #include <map>            // for map
 #include <memory>         // for weak_ptr, shared_ptr, uni...
 #include <mutex>          // for mutex
 #include <string>         // for string
 #include <unordered_map>  // for unordered_map
+#include <utility>        // for pair
 #include <vector>         // for vector
 
 #include "amdinfer/build_options.hpp"  // for AMDINFER_ENABLE_METRICS
@@ -43,6 +48,7 @@ class Counter;
 class Gauge;
 template <class T>
 class Family;
+struct MetricFamily;
 }  // namespace prometheus
 
 namespace amdinfer {
@@ -58,6 +64,17 @@ enum class MetricCounterIDs {
   PipelineEgressWorker,
   TransferredBytes,
   MetricScrapes,
+  MemoryPoolCacheHit,
+  MemoryPoolCacheMiss,
+  ResponseCacheHit,
+  ResponseCacheMiss,
+  RequestsCoalesced,
+  RequestsRejected,
+  RequestsCancelled,
+  RequestsExpired,
+  ModelColdStarts,
+  ModelEvictions,
+  WebsocketFramesDropped,
 };
 
 /// Defines the IDs of the tracked gauges
@@ -66,6 +83,18 @@ enum class MetricGaugeIDs {
   QueuesBatcherOutput,
   QueuesBufferInput,
   QueuesBufferOutput,
+  BatcherTimeout,
+  MemoryAllocatorAllocated,
+  MemoryAllocatorInUse,
+  MemoryAllocatorLargestFree,
+  MemoryAllocatorFailures,
+  MemoryAllocatorFragmentation,
+  SignalsConcurrency,
+  SignalsQueueTime,
+  SignalsThroughput,
+  SignalsCapacity,
+  SignalsHeadroom,
+  WebsocketBufferedBytes,
 };
 
 /// Defines the IDs of the tracked summaries
@@ -74,6 +103,107 @@ enum class MetricSummaryIDs {
   RequestLatency,
 };
 
+/// Defines the IDs of the tracked histograms, which are labelled by endpoint
+enum class MetricHistogramIDs {
+  IngressParse,
+  BatcherQueueWait,
+  BatchFill,
+  WorkerExecution,
+  ResponseSerialization,
+  BatchSize,
+  BatchFillRatio,
+};
+
+/// Defines the directions that data is copied in between the host and devices
+enum class DeviceTransfer {
+  HostToDevice,
+  DeviceToHost,
+};
+
+/**
+ * @brief A counter that's split into shards so that threads can increment it
+ * without contending with each other. Each thread adds to its own shard with
+ * relaxed atomics and the shards are only summed when the counter is read.
+ */
+class ShardedCounter {
+ public:
+  ShardedCounter();  ///< Constructor
+  /// Copy constructor
+  ShardedCounter(const ShardedCounter&) = delete;
+  /// Copy assignment
+  ShardedCounter& operator=(const ShardedCounter&) = delete;
+  /// Move constructor
+  ShardedCounter(ShardedCounter&& other) noexcept;
+  /// Move assignment
+  ShardedCounter& operator=(ShardedCounter&& other) noexcept;
+  ~ShardedCounter();  ///< Destructor
+
+  /// Add to the counter
+  void increment(double value);
+  /// Get the sum of all the shards
+  [[nodiscard]] double value() const;
+
+ private:
+  struct Shard;
+
+  std::unique_ptr<Shard[]> shards_;
+};
+
+/**
+ * @brief A histogram with fixed buckets that's split into shards like the
+ * ShardedCounter. Observing a value only touches the calling thread's shard
+ * and the shards are merged when the histogram is read.
+ */
+class ShardedHistogram {
+ public:
+  /**
+   * @brief Construct a new ShardedHistogram object
+   *
+   * @param buckets increasing upper bounds of the buckets. Values above the
+   * last bound go in an extra overflow bucket
+   */
+  explicit ShardedHistogram(std::vector<double> buckets);
+  /// Copy constructor
+  ShardedHistogram(const ShardedHistogram&) = delete;
+  /// Copy assignment
+  ShardedHistogram& operator=(const ShardedHistogram&) = delete;
+  /// Move constructor
+  ShardedHistogram(ShardedHistogram&& other) noexcept;
+  /// Move assignment
+  ShardedHistogram& operator=(ShardedHistogram&& other) noexcept;
+  ~ShardedHistogram();  ///< Destructor
+
+  /// Record one value
+  void observe(double value);
+
+  /// Get the upper bounds of the buckets, without the overflow bucket
+  [[nodiscard]] const std::vector<double>& getBuckets() const;
+  /// Get the merged number of values in each bucket, including the overflow
+  [[nodiscard]] std::vector<uint64_t> counts() const;
+  /// Get the merged sum of the recorded values
+  [[nodiscard]] double sum() const;
+
+  /**
+   * @brief Estimate a quantile of the recorded values by interpolating within
+   * the bucket that holds it so the error is at most the bucket's width
+   *
+   * @param counts counts of the buckets, as returned by counts()
+   * @param quantile the quantile to estimate, between 0 and 1
+   * @return double
+   */
+  [[nodiscard]] double quantile(const std::vector<uint64_t>& counts,
+                                double quantile) const;
+
+ private:
+  struct Shard;
+
+  std::vector<double> buckets_;
+  /// each shard's counts are padded to whole cache lines
+  size_t stride_;
+  std::unique_ptr<std::atomic<uint64_t>[]> counts_;
+  std::unique_ptr<Shard[]> sums_;
+};
+
 /**
  * @brief The CounterFamily class stores the tracked counters and
  * provides methods to increment them using an ID.
@@ -86,12 +216,10 @@ class CounterFamily {
    *
    * @param name name of the counter
    * @param help help message for the counter
-   * @param registry
    * @param labels map of IDs to counter labels
    */
   CounterFamily(
-    const std::string& name, const std::string& help,
-    prometheus::Registry* registry,
+    std::string name, std::string help,
     const std::unordered_map<MetricCounterIDs,
                              std::map<std::string, std::string>>& labels);
 
@@ -100,9 +228,16 @@ class CounterFamily {
   /// Increment the named counter by increment
   void increment(MetricCounterIDs id, size_t increment);
 
+  /// Add the merged counters to the metrics
+  void collect(std::vector<prometheus::MetricFamily>* metrics) const;
+
  private:
-  prometheus::Family<prometheus::Counter>& family_;
-  std::unordered_map<MetricCounterIDs, prometheus::Counter&> counters_;
+  std::string name_;
+  std::string help_;
+  std::unordered_map<
+    MetricCounterIDs,
+    std::pair<std::map<std::string, std::string>, ShardedCounter>>
+    counters_;
 };
 
 /**
@@ -119,23 +254,37 @@ class GaugeFamily {
    * @param help help message for the gauge
    * @param registry
    * @param labels map of IDs to gauge labels
+   * @param label name of a label whose value is given when a gauge is set,
+   * such as the endpoint. If it's not empty, gauges are only added once
+   * they're set
    */
   GaugeFamily(const std::string& name, const std::string& help,
               prometheus::Registry* registry,
               const std::unordered_map<
-                MetricGaugeIDs, std::map<std::string, std::string>>& labels);
+                MetricGaugeIDs, std::map<std::string, std::string>>& labels,
+              std::string label = "");
 
   /// Set the named gauge to a particular value
   void set(MetricGaugeIDs id, double value);
+  /// Set the named gauge with this value of the family's label
+  void set(MetricGaugeIDs id, const std::string& label, double value);
+  /// Remove the named gauge with this value of the family's label
+  void remove(MetricGaugeIDs id, const std::string& label);
 
  private:
   prometheus::Family<prometheus::Gauge>& family_;
   std::unordered_map<MetricGaugeIDs, prometheus::Gauge&> gauges_;
+  std::unordered_map<MetricGaugeIDs, std::map<std::string, std::string>>
+    labels_;
+  std::string label_;
 };
 
 /**
  * @brief The SummaryFamily class stores the tracked summaries and
- * provides methods to record events.
+ * provides methods to record events. The summaries are kept as fine-grained
+ * histograms and their quantiles are estimated from them when they're
+ * collected, which is cheaper than tracking quantiles as events are recorded.
+ * The quantiles are over all the events since the server started.
  *
  */
 class SummaryFamily {
@@ -145,21 +294,161 @@ class SummaryFamily {
    *
    * @param name name of the summary
    * @param help help message of the summary
-   * @param registry
    * @param quantiles map of IDs to quantiles to compute
    */
   SummaryFamily(
-    const std::string& name, const std::string& help,
-    prometheus::Registry* registry,
-    const std::unordered_map<MetricSummaryIDs, prometheus::Summary::Quantiles>&
+    std::string name, std::string help,
+    const std::unordered_map<MetricSummaryIDs, std::vector<double>>&
       quantiles);
 
   /// Record an event for a particular summary
   void observe(MetricSummaryIDs id, double value);
 
+  /// Add the summaries and their estimated quantiles to the metrics
+  void collect(std::vector<prometheus::MetricFamily>* metrics) const;
+
  private:
-  prometheus::Family<prometheus::Summary>& family_;
-  std::unordered_map<MetricSummaryIDs, prometheus::Summary&> summaries_;
+  std::string name_;
+  std::string help_;
+  std::unordered_map<MetricSummaryIDs,
+                     std::pair<std::vector<double>, ShardedHistogram>>
+    summaries_;
+};
+
+/**
+ * @brief The HistogramFamily class stores the tracked histograms and provides
+ * methods to record events. Each endpoint gets its own histogram, which is
+ * created the first time the endpoint records an event. Threads cache the
+ * histograms they've used so only the first event from each thread takes a
+ * lock.
+ *
+ */
+class HistogramFamily {
+ public:
+  /**
+   * @brief Construct a new HistogramFamily object
+   *
+   * @param name name of the histogram
+   * @param help help message of the histogram
+   * @param labels map of IDs to histogram labels
+   * @param buckets upper bounds of the histograms' buckets
+   */
+  HistogramFamily(
+    std::string name, std::string help,
+    const std::unordered_map<MetricHistogramIDs,
+                             std::map<std::string, std::string>>& labels,
+    std::vector<double> buckets);
+
+  /// Record an event for a particular histogram and endpoint
+  void observe(MetricHistogramIDs id, const std::string& model, double value);
+
+  /// Add the merged histograms to the metrics
+  void collect(std::vector<prometheus::MetricFamily>* metrics) const;
+
+ private:
+  ShardedHistogram* get(MetricHistogramIDs id, const std::string& model);
+
+  std::string name_;
+  std::string help_;
+  std::unordered_map<MetricHistogramIDs, std::map<std::string, std::string>>
+    labels_;
+  std::vector<double> buckets_;
+  /// the histograms by ID and endpoint, which are never removed
+  std::map<std::pair<MetricHistogramIDs, std::string>,
+           std::unique_ptr<ShardedHistogram>>
+    histograms_;
+  mutable std::mutex mutex_;
+};
+
+/**
+ * @brief The DeviceFamily class tracks how hard the workers keep each device,
+ * such as a GPU or a DPU, busy. A device is busy while it has at least one job
+ * in flight so jobs that overlap on it aren't counted twice and the rate of
+ * its busy time is its utilization. Devices are added once they're used or
+ * when they're listed up front so idle ones report zero.
+ *
+ */
+class DeviceFamily {
+ public:
+  /// Add a device that hasn't been used yet. Does nothing if it's there
+  void add(const std::string& device);
+  /// Mark the start of a job on the device
+  void start(const std::string& device);
+  /// Mark the end of a job on the device
+  void finish(const std::string& device);
+  /// Add to the bytes copied between the host and the device
+  void transfer(const std::string& device, DeviceTransfer direction,
+                size_t bytes);
+
+  /// Add the devices' busy time, jobs in flight and transfers to the metrics
+  void collect(std::vector<prometheus::MetricFamily>* metrics) const;
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Device {
+    size_t in_flight = 0;
+    Clock::time_point busy_since;
+    double busy_seconds = 0;
+    std::array<double, 2> transferred{};
+  };
+
+  std::map<std::string, Device> devices_;
+  mutable std::mutex mutex_;
+};
+
+/// What a tenant has sent at ingress, as counted by the tenant limits
+struct TenantTraffic {
+  /// inference calls that were admitted
+  uint64_t requests = 0;
+  /// bytes of the calls that were admitted
+  uint64_t bytes = 0;
+  /// admitted calls that haven't responded
+  uint64_t in_flight = 0;
+  /// calls turned away over the rate, bytes and in-flight limits, in order
+  std::array<uint64_t, 3> rejected{};
+};
+
+/**
+ * @brief The TenantFamily class exports the traffic of each tenant that the
+ * tenant limits track. The limits count it with their own atomics and set it
+ * here as each scrape starts so admitting a call doesn't touch the metrics.
+ *
+ */
+class TenantFamily {
+ public:
+  /// Set a tenant's traffic
+  void set(const std::string& tenant, const TenantTraffic& traffic);
+
+  /// Add the tenants' throughput, calls in flight and rejections
+  void collect(std::vector<prometheus::MetricFamily>* metrics) const;
+
+ private:
+  std::map<std::string, TenantTraffic> tenants_;
+  mutable std::mutex mutex_;
+};
+
+/**
+ * @brief Leaves what its thread records out of the request, latency and busy
+ * time metrics while it's alive. Workers hold one while they run their warm-up
+ * batches so the synthetic requests don't count as traffic. The device jobs
+ * and transfers are still recorded since jobs may finish on other threads.
+ */
+class MetricsExclusion {
+ public:
+  MetricsExclusion();  ///< Constructor
+  /// Copy constructor
+  MetricsExclusion(const MetricsExclusion&) = delete;
+  /// Copy assignment
+  MetricsExclusion& operator=(const MetricsExclusion&) = delete;
+  /// Move constructor
+  MetricsExclusion(MetricsExclusion&&) = delete;
+  /// Move assignment
+  MetricsExclusion& operator=(MetricsExclusion&&) = delete;
+  ~MetricsExclusion();  ///< Destructor
+
+  /// Check if the calling thread's metrics are left out
+  static bool active();
 };
 
 /**
@@ -184,10 +473,21 @@ class Metrics {
   /**
    * @brief Returns the collected metrics as a serialized string. This logic was
    * influenced by the examples included in prometheus-cpp pull (handler.cc).
+   * The sharded metrics are merged here so recording them stays cheap.
+   * Scrapes within the scrape interval of the last serialization get its
+   * result again.
    *
    * @return std::string
    */
   std::string getMetrics();
+  /**
+   * @brief Set the least time between serializations of the metrics. Scrapes
+   * from several collectors then cost one serialization per interval. If
+   * zero, the default, each scrape serializes them
+   *
+   * @param interval the least time between serializations
+   */
+  void setScrapeInterval(std::chrono::milliseconds interval);
   /**
    * @brief Increment one named counter
    *
@@ -203,6 +503,40 @@ class Metrics {
    */
   void setGauge(MetricGaugeIDs id, double value);
 
+  /**
+   * @brief Set one gauge of a family that's labelled per endpoint or per
+   * allocator
+   *
+   * @param id gauge to set
+   * @param label the model's endpoint or the allocator's name
+   * @param value value to set the gauge to
+   */
+  void setGauge(MetricGaugeIDs id, const std::string& label, double value);
+  /**
+   * @brief Remove one gauge of a labelled family, such as a websocket
+   * connection's gauge once it closes
+   *
+   * @param id gauge to remove
+   * @param label the value of the family's label
+   */
+  void removeGauge(MetricGaugeIDs id, const std::string& label);
+
+  /**
+   * @brief Add a callback that's run at the start of each scrape. It can set
+   * gauges whose values are cheaper to read when they're scraped than to
+   * update as they change. The callback must not add or remove callbacks.
+   *
+   * @param callback the function to run
+   * @return size_t an ID to remove the callback with
+   */
+  size_t addScrapeCallback(std::function<void()> callback);
+  /**
+   * @brief Remove a callback. Once this returns, the callback won't run again
+   *
+   * @param id the ID returned when the callback was added
+   */
+  void removeScrapeCallback(size_t id);
+
   /**
    * @brief Record one event in a summary
    *
@@ -211,12 +545,106 @@ class Metrics {
    */
   void observeSummary(MetricSummaryIDs id, double value);
 
+  /**
+   * @brief Record one event in an endpoint's histogram. Latencies are in
+   * microseconds.
+   *
+   * @param id histogram to make the observation
+   * @param model the model's endpoint
+   * @param value value to record
+   */
+  void observeHistogram(MetricHistogramIDs id, const std::string& model,
+                        double value);
+
+  /**
+   * @brief Add to the time that one instance of a model has spent running
+   * batches. The rate of this counter is the instance's utilization.
+   *
+   * @param model the model's endpoint
+   * @param instance index of the instance
+   * @param seconds busy time to add
+   */
+  void addInstanceBusyTime(const std::string& model, size_t instance,
+                           double seconds);
+  /**
+   * @brief Add to the time that a model's jobs have held turns on a shared
+   * device. Its rate relative to the other models' is the model's share of
+   * the device.
+   *
+   * @param device the device's name, such as gpu0
+   * @param model the model's endpoint
+   * @param seconds device time to add
+   */
+  void addDeviceTime(const std::string& device, const std::string& model,
+                     double seconds);
+  /**
+   * @brief Set how long a phase of starting the server took, such as starting
+   * the HTTP server or loading the models in the repository
+   *
+   * @param phase the phase's name
+   * @param seconds duration of the phase
+   */
+  void setStartupTime(const std::string& phase, double seconds);
+  /**
+   * @brief Set how long a phase of loading a model's worker took: init,
+   * acquire or warmup. Each instance of the worker replaces the last value
+   *
+   * @param model the model's endpoint
+   * @param phase the phase's name
+   * @param seconds duration of the phase
+   */
+  void setModelLoadTime(const std::string& model, const std::string& phase,
+                        double seconds);
+
+  /**
+   * @brief List a device in the device metrics before any job runs on it so
+   * it reports as idle rather than being absent
+   *
+   * @param device the device's name, such as gpu0
+   */
+  void addDevice(const std::string& device);
+  /**
+   * @brief Mark the start of a job on a device. Each call must be matched by
+   * a call to finishDeviceJob() once the device is done with the job, which
+   * may be in another thread.
+   *
+   * @param device the device's name, such as gpu0
+   */
+  void startDeviceJob(const std::string& device);
+  /**
+   * @brief Mark the end of a job on a device
+   *
+   * @param device the device's name, such as gpu0
+   */
+  void finishDeviceJob(const std::string& device);
+  /**
+   * @brief Add to the bytes copied between the host and a device
+   *
+   * @param device the device's name, such as gpu0
+   * @param direction which way the data was copied
+   * @param bytes number of bytes copied
+   */
+  void addDeviceTransfer(const std::string& device, DeviceTransfer direction,
+                         size_t bytes);
+  /**
+   * @brief Set what a tenant has sent at ingress. The tenant limits set it for
+   * each of their tenants as each scrape starts
+   *
+   * @param tenant the tenant's name
+   * @param traffic the tenant's counts since the server started
+   */
+  void setTenantTraffic(const std::string& tenant,
+                        const TenantTraffic& traffic);
+
  private:
   /// Construct a new Metrics object
   Metrics();
   /// Destroy the Metrics object
   ~Metrics() = default;
 
+  /// Run the scrape callbacks and serialize the metrics
+  std::string serialize();
+
   std::shared_ptr<prometheus::Registry> registry_ =
     std::make_shared<prometheus::Registry>();
   std::unique_ptr<prometheus::Serializer> serializer_;
@@ -228,9 +656,40 @@ class Metrics {
   CounterFamily pipeline_egress_total_;
   CounterFamily bytes_transferred_;
   CounterFamily num_scrapes_;
+  CounterFamily memory_pool_cache_total_;
+  CounterFamily response_cache_total_;
+  CounterFamily requests_coalesced_total_;
+  CounterFamily requests_rejected_total_;
+  CounterFamily model_cold_starts_total_;
+  CounterFamily model_evictions_total_;
+  CounterFamily websocket_frames_dropped_total_;
+  std::map<size_t, std::function<void()>> scrape_callbacks_;
+  size_t scrape_callback_id_ = 0;
+  std::mutex scrape_callbacks_mutex_;
+  /// held while serializing so concurrent scrapes wait for one result
+  std::mutex scrape_mutex_;
+  std::chrono::milliseconds scrape_interval_{0};
+  std::chrono::steady_clock::time_point last_scrape_;
+  std::string last_metrics_;
+
   GaugeFamily queue_sizes_total_;
+  GaugeFamily batcher_timeout_;
+  GaugeFamily memory_allocator_bytes_;
+  GaugeFamily memory_allocator_failures_;
+  GaugeFamily memory_allocator_fragmentation_;
+  GaugeFamily endpoint_signals_;
+  GaugeFamily websocket_buffered_bytes_;
   SummaryFamily metric_latency_;
   SummaryFamily request_latency_;
+  HistogramFamily stage_latency_;
+  HistogramFamily batch_size_;
+  HistogramFamily batch_fill_ratio_;
+  prometheus::Family<prometheus::Counter>& instance_busy_total_;
+  prometheus::Family<prometheus::Counter>& device_time_total_;
+  prometheus::Family<prometheus::Gauge>& startup_seconds_;
+  prometheus::Family<prometheus::Gauge>& model_load_seconds_;
+  DeviceFamily devices_;
+  TenantFamily tenants_;
 };
 
 }  // namespace amdinfer
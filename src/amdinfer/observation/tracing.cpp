@@ -25,10 +25,15 @@
 #include <opentelemetry/context/runtime_context.h>
 #include <opentelemetry/exporters/jaeger/jaeger_exporter.h>
 #include <opentelemetry/sdk/resource/resource.h>
+#include <opentelemetry/sdk/trace/batch_span_processor.h>
+#include <opentelemetry/sdk/trace/batch_span_processor_options.h>
 #include <opentelemetry/sdk/trace/exporter.h>
 #include <opentelemetry/sdk/trace/processor.h>
 #include <opentelemetry/sdk/trace/recordable.h>
-#include <opentelemetry/sdk/trace/simple_processor.h>
+#include <opentelemetry/sdk/trace/sampler.h>
+#include <opentelemetry/sdk/trace/samplers/always_on.h>
+#include <opentelemetry/sdk/trace/samplers/parent.h>
+#include <opentelemetry/sdk/trace/samplers/trace_id_ratio.h>
 #include <opentelemetry/sdk/trace/tracer_provider.h>
 #include <opentelemetry/std/utility.h>
 #include <opentelemetry/trace/canonical_code.h>
@@ -40,14 +45,26 @@
 #include <opentelemetry/trace/tracer.h>
 #include <opentelemetry/trace/tracer_provider.h>
 
+#include <atomic>  // for atomic
 #include <chrono>
 #include <cstdint>
+#include <cstdlib>  // for getenv
+#include <cstring>  // for memcpy
 #include <ext/alloc_traits.h>
+#include <limits>  // for numeric_limits
+#include <list>    // for list
 #include <map>
+#include <mutex>      // for mutex, lock_guard
+#include <stdexcept>  // for logic_error
 #include <string>
 #include <unordered_map>
-#include <utility>  // for move
+#include <utility>  // for move, pair
 #include <variant>  // for get
+#include <vector>   // for vector
+
+#include "amdinfer/core/exceptions.hpp"          // for invalid_argument
+#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
 
 #ifdef AMDINFER_ENABLE_TRACING
 
@@ -57,6 +74,249 @@ namespace nostd = opentelemetry::nostd;
 
 namespace amdinfer {
 
+namespace {
+
+// the exporter sends up to a batch of spans at this interval from a background
+// thread. If the queue is full, new spans are dropped rather than blocking the
+// requests they belong to
+constexpr auto kTraceQueueSize = 2048;
+constexpr auto kTraceExportBatchSize = 512;
+constexpr std::chrono::milliseconds kTraceExportDelay{1000};
+// how long to wait for the queued spans to be exported at shutdown
+constexpr std::chrono::milliseconds kTraceShutdownTimeout{2000};
+// the traces held by tail sampling are dropped, oldest first, past this many
+// and each trace's spans past the second limit are dropped so the memory used
+// is bounded if requests never respond
+constexpr auto kTailMaxTraces = 4096U;
+constexpr auto kTailMaxSpans = 256U;
+// the decisions about recent traces are remembered for the spans that end after
+constexpr auto kTailMaxDecisions = 4096U;
+
+/// The bytes of a trace ID
+using TraceKey = std::string;
+
+TraceKey traceKey(const trace_api::TraceId& id) {
+  const auto bytes = id.Id();
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  return {reinterpret_cast<const char*>(bytes.data()), bytes.size()};
+}
+
+/// Records a span for the next processor and remembers the span's trace
+class TailRecordable : public trace_sdk::Recordable {
+ public:
+  explicit TailRecordable(std::unique_ptr<trace_sdk::Recordable> recordable)
+    : recordable_(std::move(recordable)) {}
+
+  void SetIdentity(const trace_api::SpanContext& span_context,
+                   trace_api::SpanId parent_span_id) noexcept override {
+    trace_ = traceKey(span_context.trace_id());
+    recordable_->SetIdentity(span_context, parent_span_id);
+  }
+  void SetAttribute(
+    nostd::string_view key,
+    const opentelemetry::common::AttributeValue& value) noexcept override {
+    recordable_->SetAttribute(key, value);
+  }
+  void AddEvent(nostd::string_view name,
+                opentelemetry::common::SystemTimestamp timestamp,
+                const opentelemetry::common::KeyValueIterable& attributes)
+    noexcept override {
+    recordable_->AddEvent(name, timestamp, attributes);
+  }
+  void AddLink(const trace_api::SpanContext& span_context,
+               const opentelemetry::common::KeyValueIterable& attributes)
+    noexcept override {
+    recordable_->AddLink(span_context, attributes);
+  }
+  void SetStatus(trace_api::StatusCode code,
+                 nostd::string_view description) noexcept override {
+    recordable_->SetStatus(code, description);
+  }
+  void SetName(nostd::string_view name) noexcept override {
+    recordable_->SetName(name);
+  }
+  void SetSpanKind(trace_api::SpanKind span_kind) noexcept override {
+    recordable_->SetSpanKind(span_kind);
+  }
+  void SetResource(
+    const opentelemetry::sdk::resource::Resource& resource) noexcept override {
+    recordable_->SetResource(resource);
+  }
+  void SetStartTime(
+    opentelemetry::common::SystemTimestamp start_time) noexcept override {
+    recordable_->SetStartTime(start_time);
+  }
+  void SetDuration(std::chrono::nanoseconds duration) noexcept override {
+    recordable_->SetDuration(duration);
+  }
+  void SetInstrumentationLibrary(
+    const trace_sdk::InstrumentationLibrary& library) noexcept override {
+    recordable_->SetInstrumentationLibrary(library);
+  }
+
+  [[nodiscard]] const TraceKey& trace() const { return trace_; }
+  [[nodiscard]] trace_sdk::Recordable& get() { return *recordable_; }
+  std::unique_ptr<trace_sdk::Recordable> release() {
+    return std::move(recordable_);
+  }
+
+ private:
+  std::unique_ptr<trace_sdk::Recordable> recordable_;
+  TraceKey trace_;
+};
+
+/**
+ * @brief Holds the ended spans of each trace until it's decided whether the
+ * trace is kept and passes the spans of the kept traces to the next processor.
+ * Traces are kept by a decision or if their ID falls within the ratio, which
+ * is the same test for every span of a trace.
+ */
+class TailSampler : public trace_sdk::SpanProcessor {
+ public:
+  TailSampler(std::unique_ptr<trace_sdk::SpanProcessor> processor,
+              double ratio)
+    : processor_(std::move(processor)), ratio_(ratio) {}
+
+  std::unique_ptr<trace_sdk::Recordable> MakeRecordable() noexcept override {
+    return std::make_unique<TailRecordable>(processor_->MakeRecordable());
+  }
+
+  void OnStart(trace_sdk::Recordable& span,
+               const trace_api::SpanContext& parent_context) noexcept override {
+    processor_->OnStart(static_cast<TailRecordable&>(span).get(),
+                        parent_context);
+  }
+
+  void OnEnd(std::unique_ptr<trace_sdk::Recordable>&& span) noexcept override {
+    auto& recordable = static_cast<TailRecordable&>(*span);
+    {
+      std::lock_guard lock{mutex_};
+      auto it = decisions_.find(recordable.trace());
+      if (it == decisions_.end()) {
+        auto& pending = this->getPending(recordable.trace());
+        if (pending.spans.size() < kTailMaxSpans) {
+          pending.spans.push_back(std::move(span));
+        }
+        return;
+      }
+      if (!it->second) {
+        return;
+      }
+    }
+    processor_->OnEnd(recordable.release());
+  }
+
+  bool ForceFlush(std::chrono::microseconds timeout) noexcept override {
+    return processor_->ForceFlush(timeout);
+  }
+
+  bool Shutdown(std::chrono::microseconds timeout) noexcept override {
+    return processor_->Shutdown(timeout);
+  }
+
+  /// Hold a trace until decide() is called instead of when it finishes
+  void hold(const TraceKey& trace) {
+    std::lock_guard lock{mutex_};
+    if (decisions_.find(trace) == decisions_.end()) {
+      this->getPending(trace).held = true;
+    }
+  }
+
+  /// Decide a trace that isn't held once it ends
+  void finish(const TraceKey& trace) {
+    {
+      std::lock_guard lock{mutex_};
+      if (auto it = index_.find(trace);
+          it != index_.end() && it->second->held) {
+        return;
+      }
+    }
+    this->decide(trace, false);
+  }
+
+  /**
+   * @brief Decide whether to export a trace's spans. The first decision about
+   * a trace is the one that's used
+   *
+   * @param trace the trace
+   * @param keep whether to keep it, even if it's outside the ratio
+   */
+  void decide(const TraceKey& trace, bool keep) {
+    keep = keep || this->sampled(trace);
+    std::vector<std::unique_ptr<trace_sdk::Recordable>> spans;
+    {
+      std::lock_guard lock{mutex_};
+      if (!decisions_.try_emplace(trace, keep).second) {
+        return;
+      }
+      decided_.push_back(trace);
+      if (decided_.size() > kTailMaxDecisions) {
+        decisions_.erase(decided_.front());
+        decided_.pop_front();
+      }
+      if (auto it = index_.find(trace); it != index_.end()) {
+        spans = std::move(it->second->spans);
+        pending_.erase(it->second);
+        index_.erase(it);
+      }
+    }
+    if (keep) {
+      for (auto& span : spans) {
+        processor_->OnEnd(static_cast<TailRecordable&>(*span).release());
+      }
+    }
+  }
+
+ private:
+  struct Pending {
+    TraceKey trace;
+    std::vector<std::unique_ptr<trace_sdk::Recordable>> spans;
+    /// whether a request decides the trace rather than its end
+    bool held = false;
+  };
+
+  /// Get the spans held for a trace, making room for it if it's new
+  Pending& getPending(const TraceKey& trace) {
+    if (auto it = index_.find(trace); it != index_.end()) {
+      return *it->second;
+    }
+    if (pending_.size() >= kTailMaxTraces) {
+      index_.erase(pending_.front().trace);
+      pending_.pop_front();
+    }
+    auto it = pending_.insert(pending_.end(), Pending{trace, {}, false});
+    index_.emplace(trace, it);
+    return *it;
+  }
+
+  [[nodiscard]] bool sampled(const TraceKey& trace) const {
+    // the last half of a W3C trace ID is random
+    uint64_t value = 0;
+    std::memcpy(&value, trace.data() + trace.size() - sizeof(value),
+                sizeof(value));
+    return ratio_ >= 1 ||
+           static_cast<double>(value) <
+             ratio_ * static_cast<double>(std::numeric_limits<uint64_t>::max());
+  }
+
+  std::unique_ptr<trace_sdk::SpanProcessor> processor_;
+  double ratio_;
+  std::mutex mutex_;
+  /// the traces that are held, oldest first
+  std::list<Pending> pending_;
+  std::unordered_map<TraceKey, std::list<Pending>::iterator> index_;
+  std::unordered_map<TraceKey, bool> decisions_;
+  /// the decided traces, oldest first
+  std::list<TraceKey> decided_;
+};
+
+/// the tail sampler, owned by the tracer provider, if tracing is tail sampled
+std::atomic<TailSampler*> tail_sampler = nullptr;
+/// the latency past which inference requests' traces are kept
+std::chrono::milliseconds tail_latency{0};
+
+}  // namespace
+
 /**
  * @brief This class provides the interface to hold the HTTP context from
  * incoming requests so we can propogate it. This class is taken from the HTTP
@@ -103,12 +363,43 @@ void startTracer() {
   //   opentelemetry::exporter::trace::OStreamSpanExporter());
   auto exporter = std::unique_ptr<trace_sdk::SpanExporter>(
     new opentelemetry::exporter::jaeger::JaegerExporter());
-  auto processor =
-    std::make_unique<trace_sdk::SimpleSpanProcessor>(std::move(exporter));
+  trace_sdk::BatchSpanProcessorOptions options;
+  options.max_queue_size = kTraceQueueSize;
+  options.max_export_batch_size = kTraceExportBatchSize;
+  options.schedule_delay_millis = kTraceExportDelay;
+  auto processor = std::make_unique<trace_sdk::BatchSpanProcessor>(
+    std::move(exporter), options);
+
+  const auto* tail_env = std::getenv(kTraceTailLatencyEnv);
+  // tail sampling keeps the traces of slow or failed requests so only a
+  // fraction of the rest are kept by default
+  auto ratio = tail_env == nullptr ? 1.0 : 0.0;
+  if (const auto* env = std::getenv(kTraceSampleRatioEnv); env != nullptr) {
+    ratio = parseTraceSampleRatio(env);
+  }
+  std::shared_ptr<trace_sdk::Sampler> root_sampler;
+  std::unique_ptr<trace_sdk::SpanProcessor> span_processor;
+  if (tail_env == nullptr) {
+    root_sampler = std::make_shared<trace_sdk::TraceIdRatioBasedSampler>(ratio);
+    span_processor = std::move(processor);
+  } else {
+    // every trace is recorded and the sampler decides what's exported
+    tail_latency = parseTraceTailLatency(tail_env);
+    root_sampler = std::make_shared<trace_sdk::AlwaysOnSampler>();
+    auto tail = std::make_unique<TailSampler>(std::move(processor), ratio);
+    tail_sampler = tail.get();
+    span_processor = std::move(tail);
+  }
+  // follow the caller's decision if the request continues a trace
+  auto sampler =
+    std::make_unique<trace_sdk::ParentBasedSampler>(std::move(root_sampler));
+
   auto provider =
     nostd::shared_ptr<trace_api::TracerProvider>(new trace_sdk::TracerProvider(
-      std::move(processor), opentelemetry::sdk::resource::Resource::Create(
-                              {{"service.name", "amdinfer"}})));
+      std::move(span_processor),
+      opentelemetry::sdk::resource::Resource::Create(
+        {{"service.name", "amdinfer"}}),
+      std::move(sampler)));
 
   auto propagator =
     nostd::shared_ptr<opentelemetry::context::propagation::TextMapPropagator>(
@@ -128,11 +419,42 @@ nostd::shared_ptr<trace_api::Tracer> getTracer() {
 
 void stopTracer() {
   auto tracer = getTracer();
-  tracer->Close(std::chrono::milliseconds(1));
+  tracer->Close(kTraceShutdownTimeout);
+}
+
+double parseTraceSampleRatio(const std::string& value) {
+  size_t parsed = 0;
+  double ratio = -1;
+  try {
+    ratio = std::stod(value, &parsed);
+  } catch (const std::logic_error&) {
+    parsed = 0;
+  }
+  if (parsed != value.size() || !(ratio >= 0 && ratio <= 1)) {
+    throw invalid_argument("Expected a trace sampling ratio from 0 to 1, got " +
+                           value);
+  }
+  return ratio;
+}
+
+std::chrono::milliseconds parseTraceTailLatency(const std::string& value) {
+  size_t parsed = 0;
+  long long latency = -1;
+  try {
+    latency = std::stoll(value, &parsed);
+  } catch (const std::logic_error&) {
+    parsed = 0;
+  }
+  if (parsed != value.size() || latency < 0) {
+    throw invalid_argument(
+      "Expected a tail sampling latency of at least 0 ms, got " + value);
+  }
+  return std::chrono::milliseconds{latency};
 }
 
 Trace::Trace(const char* name,
-             const opentelemetry::v1::trace::StartSpanOptions& options) {
+             const opentelemetry::v1::trace::StartSpanOptions& options)
+  : start_(std::chrono::steady_clock::now()) {
   auto tracer = getTracer();
   this->spans_.emplace(tracer->StartSpan(name, options));
 }
@@ -151,10 +473,14 @@ void Trace::setAttribute(nostd::string_view key,
 }
 
 void Trace::setAttributes(const ParameterMap& parameters) {
-  auto data = parameters.data();
+  // spans that aren't sampled drop their attributes anyway
+  if (!this->spans_.top()->IsRecording()) {
+    return;
+  }
+  const auto& data = parameters.data();
   // a range-based for loop doesn't work here because we can't pass the key when
   // it's a structured binding.
-  for (auto& it : data) {
+  for (const auto& it : data) {
     const auto& key = it.first;
     const auto& value = it.second;
     std::visit(
@@ -194,9 +520,90 @@ StringMap Trace::propagate() {
 }
 
 void Trace::endTrace() {
+  if (this->spans_.empty()) {
+    return;
+  }
+  const auto context = this->getContext();
   while (!this->spans_.empty()) {
     this->endSpan();
   }
+  // traces that aren't held for a request are decided as they end
+  if (auto* sampler = tail_sampler.load();
+      sampler != nullptr && !decided_ && context.IsSampled()) {
+    decided_ = true;
+    sampler->finish(traceKey(context.trace_id()));
+  }
+}
+
+trace_api::SpanContext Trace::getContext() const {
+  return this->spans_.top()->GetContext();
+}
+
+void Trace::tailSample(InferenceRequest* request,
+                       std::optional<std::chrono::milliseconds> latency) {
+  auto* sampler = tail_sampler.load();
+  if (sampler == nullptr || decided_ || this->spans_.empty()) {
+    return;
+  }
+  const auto context = this->getContext();
+  auto callback = request->getCallback();
+  // traces that the caller didn't sample aren't recorded
+  if (!context.IsSampled() || callback == nullptr) {
+    request->setCallback(std::move(callback));
+    return;
+  }
+  decided_ = true;
+  auto trace = traceKey(context.trace_id());
+  sampler->hold(trace);
+  // the decision is part of the callback so it follows the callback to the
+  // requests of an ensemble's later steps. Only the first response decides
+  request->setCallback(
+    [sampler, trace = std::move(trace), start = start_,
+     threshold = latency.value_or(tail_latency),
+     callback = std::move(callback)](const InferenceResponse& response) {
+      const auto late = std::chrono::steady_clock::now() - start >= threshold;
+      sampler->decide(trace, response.isError() || late);
+      callback(response);
+    });
+}
+
+BatchTrace::BatchTrace(const char* name, const std::vector<TracePtr>& traces) {
+  using Link = std::pair<trace_api::SpanContext, std::map<std::string, bool>>;
+  std::vector<Link> links;
+  links.reserve(traces.size());
+  auto parent = trace_api::SpanContext::GetInvalid();
+  for (const auto& trace : traces) {
+    if (trace == nullptr) {
+      continue;
+    }
+    auto context = trace->getContext();
+    // the parent is the first sampled request or else the first request
+    if (!parent.IsValid() || (context.IsSampled() && !parent.IsSampled())) {
+      parent = context;
+    }
+    links.emplace_back(context, std::map<std::string, bool>{});
+  }
+  trace_api::StartSpanOptions options;
+  options.parent = parent;
+
+  const std::map<std::string, int64_t> attributes{
+    {"batch_size", static_cast<int64_t>(traces.size())}};
+  auto tracer = getTracer();
+  span_ = tracer->StartSpan(name, attributes, links, options);
+}
+
+BatchTrace::~BatchTrace() { this->end(); }
+
+void BatchTrace::setAttribute(
+  nostd::string_view key, const opentelemetry::common::AttributeValue& value) {
+  span_->SetAttribute(key, value);
+}
+
+void BatchTrace::end() {
+  if (!ended_) {
+    span_->End();
+    ended_ = true;
+  }
 }
 
 TracePtr startTrace(const char* name) { return std::make_unique<Trace>(name); }
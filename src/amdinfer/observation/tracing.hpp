@@ -21,8 +21,12 @@
 #ifndef GUARD_AMDINFER_OBSERVATION_TRACING
 #define GUARD_AMDINFER_OBSERVATION_TRACING
 
-#include <memory>  // for shared_ptr, uniqu...
-#include <stack>   // for stack
+#include <chrono>    // for milliseconds, steady_clock
+#include <memory>    // for shared_ptr, uniqu...
+#include <optional>  // for optional
+#include <stack>     // for stack
+#include <string>    // for string
+#include <vector>    // for vector
 
 #include "amdinfer/build_options.hpp"    // for AMDINFER_ENABLE_TR...
 #include "amdinfer/core/parameters.hpp"  // for ParameterMap
@@ -40,13 +44,53 @@
 #include <opentelemetry/nostd/shared_ptr.h>
 #include <opentelemetry/std/string_view.h>          // for string_view
 #include <opentelemetry/trace/span.h>               // for span
+#include <opentelemetry/trace/span_context.h>       // for SpanContext
 #include <opentelemetry/trace/span_startoptions.h>  // for StartSpanOptions
 
 namespace amdinfer {
 
-/// initialize tracing globally
+/// Environment variable with the fraction of new traces to sample, from 0 to 1
+constexpr auto kTraceSampleRatioEnv = "AMDINFER_TRACE_SAMPLE_RATIO";
+
+/**
+ * @brief Environment variable with the milliseconds past which the traces of
+ * inference requests are kept when tracing is tail sampled. Setting it turns
+ * on tail sampling
+ */
+constexpr auto kTraceTailLatencyEnv = "AMDINFER_TRACE_TAIL_LATENCY_MS";
+
+/**
+ * @brief Parse a trace sampling ratio. It throws if the value isn't a number
+ * from 0 to 1.
+ *
+ * @param value the ratio as a string
+ * @return double
+ */
+double parseTraceSampleRatio(const std::string& value);
+
+/**
+ * @brief Parse the latency past which tail sampling keeps traces. It throws
+ * if the value isn't a non-negative number of milliseconds.
+ *
+ * @param value the milliseconds as a string
+ * @return std::chrono::milliseconds
+ */
+std::chrono::milliseconds parseTraceTailLatency(const std::string& value);
+
+/**
+ * @brief Initialize tracing globally. Traces that continue a trace from an
+ * incoming request are sampled if the caller sampled it. New traces are
+ * sampled at the ratio given by kTraceSampleRatioEnv, which defaults to all of
+ * them. Sampled spans are exported in batches from a background thread.
+ *
+ * If kTraceTailLatencyEnv is set, tracing is tail sampled instead. Every trace
+ * is recorded but its spans are held in memory until it's decided whether to
+ * keep them. The traces of inference requests are kept if the request fails
+ * or responds later than the latency, and the other traces and a fraction of
+ * the fast ones are kept at the ratio, which defaults to none of them.
+ */
 void startTracer();
-/// clean up the tracing prior to shutdown
+/// clean up the tracing prior to shutdown, exporting any queued spans
 void stopTracer();
 
 /**
@@ -84,12 +128,65 @@ class Trace final {
   /// Ends the trace
   void endTrace();
 
+  /// get the context of the active span in the trace, e.g. to link to it
+  [[nodiscard]] opentelemetry::trace::SpanContext getContext() const;
+
+  /**
+   * @brief Hold the trace's spans, if tracing is tail sampled, until the
+   * request's callback first runs, instead of deciding when the trace ends.
+   * The trace is kept if the response is an error or arrives later than the
+   * latency after the trace started
+   *
+   * @param request the request that the trace follows
+   * @param latency the endpoint's latency or nullopt to use the server's
+   */
+  void tailSample(InferenceRequest* request,
+                  std::optional<std::chrono::milliseconds> latency);
+
  private:
   std::stack<opentelemetry::nostd::shared_ptr<opentelemetry::trace::Span>>
     spans_;
+  std::chrono::steady_clock::time_point start_;
+  /// set once a request or the end of the trace decides whether to keep it
+  bool decided_ = false;
   // std::unique_ptr<opentelemetry::trace::Scope> scope_;
 };
 
+/**
+ * @brief The BatchTrace object records work done on a batch of requests at
+ * once as one span linked to the active span of each request, rather than as
+ * the same span in each request's trace. The span is a child of the first
+ * sampled request so it's only sampled if one of its requests is.
+ */
+class BatchTrace final {
+ public:
+  /**
+   * @brief Start the span of a batch
+   *
+   * @param name name of the span
+   * @param traces the traces of the batch's requests
+   */
+  BatchTrace(const char* name, const std::vector<TracePtr>& traces);
+  ~BatchTrace();
+  BatchTrace(BatchTrace const&) = delete;  ///< Copy constructor
+  /// Copy assignment constructor
+  BatchTrace& operator=(const BatchTrace&) = delete;
+  BatchTrace(BatchTrace&& other) = delete;  ///< Move constructor
+  /// Move assignment constructor
+  BatchTrace& operator=(BatchTrace&& other) = delete;
+
+  /// set an attribute in the batch's span
+  void setAttribute(opentelemetry::nostd::string_view key,
+                    const opentelemetry::common::AttributeValue& value);
+
+  /// end the batch's span. Later calls do nothing
+  void end();
+
+ private:
+  opentelemetry::nostd::shared_ptr<opentelemetry::trace::Span> span_;
+  bool ended_ = false;
+};
+
 /// Start a trace with the given name
 TracePtr startTrace(const char* name);
 
@@ -16,13 +16,34 @@
 #ifndef GUARD_AMDINFER_PRE_POST_CENTER_CROP
 #define GUARD_AMDINFER_PRE_POST_CENTER_CROP
 
-#include <opencv2/core.hpp>  // for cv::Mat
+#include <algorithm>            // for max, min
+#include <opencv2/core.hpp>     // for Mat, Rect, Size
+#include <opencv2/imgproc.hpp>  // for resize, INTER_LINEAR
+#include <stdexcept>            // for invalid_argument
 
 namespace amdinfer::pre_post {
 
+/**
+ * @brief Get the region of an image with the given size in its center
+ *
+ * @param img the image to crop
+ * @param height height of the region
+ * @param width width of the region
+ * @return cv::Rect
+ */
+inline cv::Rect centerCropRect(const cv::Mat& img, int height, int width) {
+  if (height > img.rows || width > img.cols) {
+    throw std::invalid_argument("The crop is larger than the image");
+  }
+  const int offset_width = (img.cols - width) / 2;
+  const int offset_height = (img.rows - height) / 2;
+  return {offset_width, offset_height, width, height};
+}
+
 /**
  * @brief Image preprocessing helper.  Crops the input `img` from center to a
- * specific dimension specified
+ * specific dimension specified. The result is a view of the input image so
+ * nothing is copied but its rows are not contiguous.
  *
  * @param img: Image which needs to be cropped
  * @param height: height of the output image
@@ -30,11 +51,30 @@ namespace amdinfer::pre_post {
  * @return cv::Mat: Image cropped to required shape
  */
 inline cv::Mat centerCrop(cv::Mat img, int height, int width) {
-  const int offset_width = (img.cols - width) / 2;
-  const int offset_height = (img.rows - height) / 2;
-  const cv::Rect roi(offset_width, offset_height, width, height);
-  img = img(roi);
-  return img;
+  return img(centerCropRect(img, height, width));
+}
+
+/**
+ * @brief Scale an image so it covers the given size while keeping its aspect
+ * ratio and crop the center of it. Only the part of the image that's kept is
+ * resized and it's written straight into the output, so there's no
+ * intermediate image.
+ *
+ * @param img the image to resize and crop
+ * @param height height of the output image
+ * @param width width of the output image
+ * @param output the output image. If it already has the right size and type,
+ * e.g. if it wraps an output tensor, it's written in place
+ */
+inline void resizeCenterCrop(const cv::Mat& img, int height, int width,
+                             cv::Mat* output) {
+  const auto scale = std::max(static_cast<double>(height) / img.rows,
+                              static_cast<double>(width) / img.cols);
+  // the region of the input that covers the output once scaled
+  const auto rows = std::min(img.rows, static_cast<int>(height / scale + 0.5));
+  const auto cols = std::min(img.cols, static_cast<int>(width / scale + 0.5));
+  cv::resize(img(centerCropRect(img, rows, cols)), *output,
+             cv::Size(width, height), 0, 0, cv::INTER_LINEAR);
 }
 
 }  // namespace amdinfer::pre_post
@@ -0,0 +1,395 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the post-processing of detection models: decoding their
+ * boxes, suppressing the overlapping ones and packing the rest by image
+ */
+
+#ifndef GUARD_AMDINFER_PRE_POST_DETECTION
+#define GUARD_AMDINFER_PRE_POST_DETECTION
+
+#include <algorithm>  // for sort, max, min, stable_sort
+#include <cstddef>    // for size_t
+#include <cstdint>    // for uint32_t
+#include <cstring>    // for memcpy
+#include <vector>     // for vector
+
+#include "amdinfer/pre_post/simd.hpp"  // for AMDINFER_X86_SIMD, hasAvx2
+
+namespace amdinfer::pre_post {
+
+/// A detected box: its class, its score and its top-left corner and size
+struct Detection {
+  float class_id;
+  float score;
+  float x;
+  float y;
+  float w;
+  float h;
+};
+
+/// The number of floats in a Detection
+constexpr size_t kDetectionFloats = sizeof(Detection) / sizeof(float);
+
+/// The options of the detection's post-processing
+struct DetectionOptions {
+  /// Boxes that score less than this are dropped before the NMS
+  float score_threshold = 0.25F;
+  /// Boxes that overlap a better box of their class by more than this IoU are
+  /// suppressed
+  float iou_threshold = 0.45F;
+  /// The most boxes that are kept for each image. If it's zero, all are kept
+  size_t max_detections = 300;
+};
+
+/// The detections of a batch, packed back to back by image
+struct Detections {
+  std::vector<Detection> boxes;
+  /// The boxes of image i are from boxes[offsets[i]] up to boxes[offsets[i+1]]
+  std::vector<size_t> offsets;
+
+  /// Get the number of boxes of an image
+  [[nodiscard]] size_t count(size_t image) const {
+    return offsets[image + 1] - offsets[image];
+  }
+  /// Get the boxes of an image
+  [[nodiscard]] const Detection* data(size_t image) const {
+    return boxes.data() + offsets[image];
+  }
+};
+
+namespace detail {
+
+/// The number of values before the class scores in a prediction
+constexpr size_t kBoxValues = 5;
+
+/// A box that passed the score threshold and the image it's in
+struct Candidate {
+  Detection detection;
+  uint32_t image;
+};
+
+/// Decode one prediction and keep it if it scores well enough
+inline void decodeBox(const float* row, size_t classes, float threshold,
+                      uint32_t image, std::vector<Candidate>* candidates) {
+  const auto* scores = row + kBoxValues;
+  size_t best = 0;
+  for (size_t i = 1; i < classes; ++i) {
+    if (scores[i] > scores[best]) {
+      best = i;
+    }
+  }
+  const auto score = row[4] * scores[best];
+  if (score < threshold) {
+    return;
+  }
+  const auto width = row[2];
+  const auto height = row[3];
+  candidates->push_back({{static_cast<float>(best), score, row[0] - width / 2,
+                          row[1] - height / 2, width, height},
+                         image});
+}
+
+// Since the class scores are at most 1, a box can only pass the threshold if
+// its objectness does. Most boxes don't, so the kernels only check their
+// objectness first and decode the few that pass.
+
+inline void decodeScalar(const float* data, size_t boxes, size_t classes,
+                         float threshold, uint32_t image,
+                         std::vector<Candidate>* candidates) {
+  const auto stride = kBoxValues + classes;
+  for (size_t i = 0; i < boxes; ++i) {
+    const auto* row = data + (i * stride);
+    if (row[4] >= threshold) {
+      decodeBox(row, classes, threshold, image, candidates);
+    }
+  }
+}
+
+/// The boxes kept so far for one class of an image, with their corners and
+/// areas in separate arrays so they're compared with a candidate in parallel
+struct KeptBoxes {
+  std::vector<float> x1;
+  std::vector<float> y1;
+  std::vector<float> x2;
+  std::vector<float> y2;
+  std::vector<float> area;
+
+  void clear() {
+    x1.clear();
+    y1.clear();
+    x2.clear();
+    y2.clear();
+    area.clear();
+  }
+
+  void add(const Detection& box) {
+    x1.push_back(box.x);
+    y1.push_back(box.y);
+    x2.push_back(box.x + box.w);
+    y2.push_back(box.y + box.h);
+    area.push_back(box.w * box.h);
+  }
+
+  [[nodiscard]] size_t size() const { return area.size(); }
+};
+
+/// Check if a box overlaps the kept box i by more than the IoU. The division
+/// is avoided by comparing the intersection with the IoU times the union
+inline bool overlaps(const KeptBoxes& kept, size_t i, const Detection& box,
+                     float iou) {
+  const auto width = std::min(kept.x2[i], box.x + box.w) -
+                     std::max(kept.x1[i], box.x);
+  const auto height = std::min(kept.y2[i], box.y + box.h) -
+                      std::max(kept.y1[i], box.y);
+  if (width <= 0 || height <= 0) {
+    return false;
+  }
+  const auto intersection = width * height;
+  return intersection > iou * (kept.area[i] + box.w * box.h - intersection);
+}
+
+inline bool suppressedScalar(const KeptBoxes& kept, const Detection& box,
+                             float iou) {
+  for (size_t i = 0; i < kept.size(); ++i) {
+    if (overlaps(kept, i, box, iou)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+#ifdef AMDINFER_X86_SIMD
+
+__attribute__((target("avx2,fma"))) inline void decodeAvx2(
+  const float* data, size_t boxes, size_t classes, float threshold,
+  uint32_t image, std::vector<Candidate>* candidates) {
+  constexpr size_t kLanes = 8;
+  const auto stride = kBoxValues + classes;
+  // the objectness of eight boxes is gathered from their rows at once
+  const auto offsets = _mm256_mullo_epi32(
+    _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+    _mm256_set1_epi32(static_cast<int>(stride)));
+  const auto threshold_splat = _mm256_set1_ps(threshold);
+  size_t i = 0;
+  for (; i + kLanes <= boxes; i += kLanes) {
+    const auto* rows = data + (i * stride);
+    const auto objectness = _mm256_i32gather_ps(rows + 4, offsets, 4);
+    auto mask = static_cast<unsigned>(_mm256_movemask_ps(
+      _mm256_cmp_ps(objectness, threshold_splat, _CMP_GE_OQ)));
+    while (mask != 0) {
+      const auto lane = static_cast<size_t>(__builtin_ctz(mask));
+      decodeBox(rows + (lane * stride), classes, threshold, image, candidates);
+      mask &= mask - 1;
+    }
+  }
+  decodeScalar(data + (i * stride), boxes - i, classes, threshold, image,
+               candidates);
+}
+
+__attribute__((target("avx2,fma"))) inline bool suppressedAvx2(
+  const KeptBoxes& kept, const Detection& box, float iou) {
+  constexpr size_t kLanes = 8;
+  const auto x1 = _mm256_set1_ps(box.x);
+  const auto y1 = _mm256_set1_ps(box.y);
+  const auto x2 = _mm256_set1_ps(box.x + box.w);
+  const auto y2 = _mm256_set1_ps(box.y + box.h);
+  const auto area = _mm256_set1_ps(box.w * box.h);
+  const auto iou_splat = _mm256_set1_ps(iou);
+  const auto zero = _mm256_setzero_ps();
+  size_t i = 0;
+  for (; i + kLanes <= kept.size(); i += kLanes) {
+    const auto width = _mm256_max_ps(
+      zero, _mm256_sub_ps(_mm256_min_ps(_mm256_loadu_ps(&kept.x2[i]), x2),
+                          _mm256_max_ps(_mm256_loadu_ps(&kept.x1[i]), x1)));
+    const auto height = _mm256_max_ps(
+      zero, _mm256_sub_ps(_mm256_min_ps(_mm256_loadu_ps(&kept.y2[i]), y2),
+                          _mm256_max_ps(_mm256_loadu_ps(&kept.y1[i]), y1)));
+    const auto intersection = _mm256_mul_ps(width, height);
+    const auto sum = _mm256_add_ps(_mm256_loadu_ps(&kept.area[i]), area);
+    const auto limit =
+      _mm256_mul_ps(iou_splat, _mm256_sub_ps(sum, intersection));
+    if (_mm256_movemask_ps(
+          _mm256_cmp_ps(intersection, limit, _CMP_GT_OQ)) != 0) {
+      return true;
+    }
+  }
+  for (; i < kept.size(); ++i) {
+    if (overlaps(kept, i, box, iou)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+#endif  // AMDINFER_X86_SIMD
+
+inline void decode(const float* data, size_t boxes, size_t classes,
+                   float threshold, uint32_t image,
+                   std::vector<Candidate>* candidates) {
+#ifdef AMDINFER_X86_SIMD
+  static const bool has_avx2 = hasAvx2();
+  if (has_avx2) {
+    decodeAvx2(data, boxes, classes, threshold, image, candidates);
+    return;
+  }
+#endif
+  decodeScalar(data, boxes, classes, threshold, image, candidates);
+}
+
+inline bool suppressed(const KeptBoxes& kept, const Detection& box,
+                       float iou) {
+#ifdef AMDINFER_X86_SIMD
+  static const bool has_avx2 = hasAvx2();
+  if (has_avx2) {
+    return suppressedAvx2(kept, box, iou);
+  }
+#endif
+  return suppressedScalar(kept, box, iou);
+}
+
+/**
+ * @brief Suppress the candidates that overlap a better one of the same class
+ * in the same image and pack the rest by image, best first
+ *
+ * @param candidates the candidates of all the images. They're reordered
+ * @param images the number of images
+ * @param options the detection's options
+ * @return Detections
+ */
+inline Detections suppress(std::vector<Candidate>* candidates, size_t images,
+                           const DetectionOptions& options) {
+  // one sort groups the candidates of the whole batch by image and class so
+  // each group is suppressed in one pass from its best candidate down
+  std::sort(candidates->begin(), candidates->end(),
+            [](const Candidate& a, const Candidate& b) {
+              if (a.image != b.image) {
+                return a.image < b.image;
+              }
+              if (a.detection.class_id != b.detection.class_id) {
+                return a.detection.class_id < b.detection.class_id;
+              }
+              return a.detection.score > b.detection.score;
+            });
+
+  Detections detections;
+  detections.offsets.reserve(images + 1);
+  detections.offsets.push_back(0);
+  KeptBoxes kept;
+  auto candidate = candidates->begin();
+  for (size_t image = 0; image < images; ++image) {
+    const auto start = detections.boxes.size();
+    while (candidate != candidates->end() && candidate->image == image) {
+      kept.clear();
+      const auto class_id = candidate->detection.class_id;
+      for (; candidate != candidates->end() && candidate->image == image &&
+             candidate->detection.class_id == class_id;
+           ++candidate) {
+        if (!suppressed(kept, candidate->detection, options.iou_threshold)) {
+          kept.add(candidate->detection);
+          detections.boxes.push_back(candidate->detection);
+        }
+      }
+    }
+    // the image's boxes are ordered by score across its classes
+    const auto begin = detections.boxes.begin() + static_cast<long>(start);
+    std::stable_sort(begin, detections.boxes.end(),
+                     [](const Detection& a, const Detection& b) {
+                       return a.score > b.score;
+                     });
+    if (options.max_detections > 0 &&
+        detections.boxes.size() - start > options.max_detections) {
+      detections.boxes.resize(start + options.max_detections);
+    }
+    detections.offsets.push_back(detections.boxes.size());
+  }
+  return detections;
+}
+
+}  // namespace detail
+
+/**
+ * @brief Decode the predictions of a batch of images from a YOLO-style
+ * detection model and run class-aware non-maximum suppression (NMS) over the
+ * whole batch. Each prediction is the center, width and height of a box, its
+ * objectness and the score of each class, all of them in [0, 1] except the
+ * box. A box's score is its objectness times its best class score. The widest
+ * SIMD instructions the CPU supports are picked at runtime.
+ *
+ * @param data the [images, boxes, 5 + classes] predictions
+ * @param images the number of images
+ * @param boxes the number of predictions for each image
+ * @param classes the number of classes
+ * @param options the detection's options
+ * @return Detections - the kept boxes, with their top-left corners, packed by
+ * image and ordered by score
+ */
+inline Detections detect(const float* data, size_t images, size_t boxes,
+                         size_t classes, const DetectionOptions& options = {}) {
+  std::vector<detail::Candidate> candidates;
+  if (classes > 0) {
+    const auto image_size = boxes * (detail::kBoxValues + classes);
+    for (size_t i = 0; i < images; ++i) {
+      detail::decode(data + (i * image_size), boxes, classes,
+                     options.score_threshold, static_cast<uint32_t>(i),
+                     &candidates);
+    }
+  }
+  return detail::suppress(&candidates, images, options);
+}
+
+/**
+ * @brief Pack the detections of a batch that are already decoded and
+ * suppressed, like the outputs of the AKS detection graphs, by image. Each row
+ * is the index of its image in the batch followed by a Detection. The rows are
+ * counted by image first so each box is copied once into its place. Rows of
+ * images outside the batch are dropped.
+ *
+ * @param rows the [count, 1 + kDetectionFloats] rows
+ * @param count the number of rows
+ * @param images the number of images in the batch
+ * @return Detections
+ */
+inline Detections packDetections(const float* rows, size_t count,
+                                 size_t images) {
+  constexpr size_t kStride = kDetectionFloats + 1;
+  Detections detections;
+  detections.offsets.assign(images + 1, 0);
+  for (size_t i = 0; i < count; ++i) {
+    const auto image = rows[i * kStride];
+    if (image >= 0 && image < static_cast<float>(images)) {
+      detections.offsets[static_cast<size_t>(image) + 1]++;
+    }
+  }
+  for (size_t i = 0; i < images; ++i) {
+    detections.offsets[i + 1] += detections.offsets[i];
+  }
+
+  detections.boxes.resize(detections.offsets.back());
+  auto next = detections.offsets;
+  for (size_t i = 0; i < count; ++i) {
+    const auto* row = rows + (i * kStride);
+    if (row[0] >= 0 && row[0] < static_cast<float>(images)) {
+      std::memcpy(&detections.boxes[next[static_cast<size_t>(row[0])]++],
+                  row + 1, sizeof(Detection));
+    }
+  }
+  return detections;
+}
+
+}  // namespace amdinfer::pre_post
+
+#endif  // GUARD_AMDINFER_PRE_POST_DETECTION
@@ -16,36 +16,85 @@
 #ifndef GUARD_AMDINFER_PRE_POST_GET_TOP_K
 #define GUARD_AMDINFER_PRE_POST_GET_TOP_K
 
-#include <queue>
-#include <vector>
+#include <algorithm>   // for make_heap, pop_heap, push_heap, sort_heap
+#include <cstddef>     // for size_t
+#include <functional>  // for greater
+#include <utility>     // for pair
+#include <vector>      // for vector
 
 namespace amdinfer::pre_post {
 
 /**
- * @brief After running softmax, get the labels associated with the top k values
+ * @brief Get the indices of the top k values of the data, largest first. Equal
+ * values are ordered by descending index. Since softmax doesn't change the
+ * order of the values, this can be run on the raw output or after softmax.
  *
+ * Only the k largest values seen so far are kept in a min-heap so this takes
+ * O(size * log(k)) time and the values don't need to be copied.
+ *
+ * @tparam T type of the data
  * @param d pointer to the data
  * @param size number of elements in the data
- * @param k number of top elements to return
+ * @param k number of top elements to return. It's limited to size
  * @return std::vector<int>
  */
-inline std::vector<int> getTopK(const double* d, size_t size, int k) {
-  std::priority_queue<std::pair<float, int>> q;
+template <typename T>
+std::vector<int> getTopK(const T* d, size_t size, int k) {
+  using Entry = std::pair<T, int>;
+  const auto count = std::min(static_cast<size_t>(std::max(k, 0)), size);
+  if (count == 0) {
+    return {};
+  }
 
-  for (auto i = 0U; i < size; ++i) {
-    q.push(std::pair<float, int>(d[i], i));
+  // with std::greater, the front of the heap is the smallest entry kept
+  const std::greater<Entry> compare;
+  std::vector<Entry> heap;
+  heap.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    heap.emplace_back(d[i], static_cast<int>(i));
+  }
+  std::make_heap(heap.begin(), heap.end(), compare);
+  for (auto i = count; i < size; ++i) {
+    Entry entry{d[i], static_cast<int>(i)};
+    if (compare(entry, heap.front())) {
+      std::pop_heap(heap.begin(), heap.end(), compare);
+      heap.back() = entry;
+      std::push_heap(heap.begin(), heap.end(), compare);
+    }
   }
+  // sorting with std::greater puts the largest entries first
+  std::sort_heap(heap.begin(), heap.end(), compare);
 
   std::vector<int> top_k_index;
-  top_k_index.reserve(k);
-  for (auto i = 0; i < k; ++i) {
-    const auto& [prob, index] = q.top();
+  top_k_index.reserve(count);
+  for (const auto& [value, index] : heap) {
     top_k_index.push_back(index);
-    q.pop();
   }
   return top_k_index;
 }
 
+/**
+ * @brief Get the indices of the top k values of each row of [batch, classes]
+ * data
+ *
+ * @tparam T type of the data
+ * @param d pointer to the data
+ * @param batch number of rows
+ * @param classes number of elements in each row
+ * @param k number of top elements to return per row
+ * @return std::vector<std::vector<int>> the top k indices of each row
+ */
+template <typename T>
+std::vector<std::vector<int>> getTopK(const T* d, size_t batch, size_t classes,
+                                      int k) {
+  std::vector<std::vector<int>> top_k;
+  top_k.reserve(batch);
+  for (size_t i = 0; i < batch; ++i) {
+    top_k.push_back(getTopK(d + (i * classes), classes, k));
+  }
+  return top_k;
+}
+
 }  // namespace amdinfer::pre_post
 
 #endif  // GUARD_AMDINFER_PRE_POST_GET_TOP_K
@@ -16,29 +16,40 @@
 #ifndef GUARD_AMDINFER_PRE_POST_IMAGE_PREPROCESS
 #define GUARD_AMDINFER_PRE_POST_IMAGE_PREPROCESS
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
+#include <deque>
+#include <exception>
+#include <mutex>
 #include <opencv2/core.hpp>       // for Mat, Vec3b, MatSize, Vec, CV_8SC3
 #include <opencv2/imgcodecs.hpp>  // for imread
 #include <opencv2/imgproc.hpp>    // for resize
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 #include "amdinfer/pre_post/center_crop.hpp"
+#include "amdinfer/pre_post/letterbox.hpp"
+#include "amdinfer/pre_post/normalize.hpp"
 
 namespace amdinfer::pre_post {
 
-enum class ImageOrder {
-  NHWC,
-  NCHW,
-};
-
 enum class ResizeAlgorithm {
+  /// resize to the output size, ignoring the aspect ratio
   Simple,
+  /// crop the center of the image without resizing it
   CenterCrop,
+  /// scale the image to fit in the output and pad the rest
   LetterBoxCrop,
+  /// scale the image to cover the output and crop its center
+  ResizeCenterCrop,
 };
 
 const auto kDefaultImageSize = 224;
@@ -71,107 +82,385 @@ struct ImagePreprocessOptions {
 
 namespace detail {
 
-template <typename T, typename F>
-void nestedLoop(int a, int b, int c, T* output, F f) {
-  for (int i = 0; i < a; i++) {
-    for (int j = 0; j < b; j++) {
-      for (int k = 0; k < c; k++) {
-        auto output_index = (i * b * c) + (j * c) + k;
-        output[output_index] = static_cast<T>(f(i, j, k));
-      }
-    }
-  }
-}
-
 template <typename T, int kChannels>
 void normalize(const cv::Mat& img, ImageOrder order, T* output, const T* mean,
                const T* std) {
-  auto height = img.size[0];
-  auto width = img.size[1];
+  // the image is continuous so its elements can be walked over directly
+  const auto pixels = static_cast<size_t>(img.size[0]) * img.size[1];
+  const auto* input = img.ptr<T>();
   switch (order) {
     case ImageOrder::NHWC:
-      nestedLoop(
-        height, width, kChannels, output, [&](int h, int w, int c) -> T {
-          return (static_cast<T>(img.at<cv::Vec<T, kChannels>>(h, w)[c]) -
-                  mean[c]) *
-                 std[c];
-        });
+      for (size_t i = 0; i < pixels * kChannels; i++) {
+        const auto c = i % kChannels;
+        output[i] = static_cast<T>((input[i] - mean[c]) * std[c]);
+      }
       break;
     case ImageOrder::NCHW:
-      nestedLoop(kChannels, height, width, output, [&](int c, int h, int w) {
-        return (static_cast<T>(img.at<cv::Vec<T, kChannels>>(h, w)[c]) -
-                mean[c]) *
-               std[c];
-      });
+      for (int c = 0; c < kChannels; c++) {
+        auto* channel = output + (c * pixels);
+        for (size_t p = 0; p < pixels; p++) {
+          channel[p] =
+            static_cast<T>((input[(p * kChannels) + c] - mean[c]) * std[c]);
+        }
+      }
       break;
     default:
       throw std::invalid_argument("Unknown image order");
   }
 }
 
+/**
+ * @brief Run f(i) for i in [0, count) on up to the given number of threads. If
+ * threads is zero, one thread per core is used. The first exception thrown by
+ * f is rethrown once all the threads are done.
+ */
+template <typename F>
+void parallelFor(size_t count, size_t threads, F f) {
+  if (threads == 0) {
+    threads = std::max(std::thread::hardware_concurrency(), 1U);
+  }
+  threads = std::min(threads, count);
+  if (threads <= 1) {
+    for (size_t i = 0; i < count; i++) {
+      f(i);
+    }
+    return;
+  }
+
+  std::atomic_size_t next = 0;
+  std::mutex mutex;
+  std::exception_ptr error;
+  auto work = [&]() {
+    try {
+      for (auto i = next++; i < count; i = next++) {
+        f(i);
+      }
+    } catch (...) {
+      const std::lock_guard lock{mutex};
+      if (error == nullptr) {
+        error = std::current_exception();
+      }
+      // skip the remaining images
+      next = count;
+    }
+  };
+  std::vector<std::thread> pool;
+  pool.reserve(threads - 1);
+  for (size_t i = 1; i < threads; i++) {
+    pool.emplace_back(work);
+  }
+  work();
+  for (auto& thread : pool) {
+    thread.join();
+  }
+  if (error != nullptr) {
+    std::rethrow_exception(error);
+  }
+}
+
 }  // namespace detail
 
+/**
+ * @brief Holds images after they've been decoded, color-converted and resized
+ * so preprocessing the same path again skips straight to normalization. When
+ * it's full, the oldest image is evicted. A cache should only be used with one
+ * set of preprocessing options since the stored images depend on them. It's
+ * safe to share between threads.
+ */
+class ImageCache {
+ public:
+  /// Construct a new cache that holds up to capacity images
+  explicit ImageCache(size_t capacity) : capacity_(capacity) {}
+
+  /// Get the image for a path if it's cached and an empty image otherwise
+  cv::Mat get(const std::string& path) const {
+    const std::lock_guard lock{mutex_};
+    if (auto it = images_.find(path); it != images_.end()) {
+      return it->second;
+    }
+    return {};
+  }
+
+  /// Add an image to the cache. The image must not be modified afterwards
+  void put(const std::string& path, const cv::Mat& image) {
+    const std::lock_guard lock{mutex_};
+    if (capacity_ == 0 || images_.find(path) != images_.end()) {
+      return;
+    }
+    if (images_.size() == capacity_) {
+      images_.erase(order_.front());
+      order_.pop_front();
+    }
+    images_.emplace(path, image);
+    order_.push_back(path);
+  }
+
+ private:
+  size_t capacity_;
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, cv::Mat> images_;
+  std::deque<std::string> order_;
+};
+
+namespace detail {
+
+/// Make output refer to the image or, if it already holds an image of the
+/// same size and type, copy it there
+inline void assignImage(const cv::Mat& img, cv::Mat* output) {
+  if (output->empty()) {
+    *output = img;
+  } else {
+    img.copyTo(*output);
+  }
+}
+
+/**
+ * @brief Color-convert and resize a decoded image. If the output already has
+ * the final size and type, e.g. if it wraps an output tensor, the image is
+ * resized straight into it. Otherwise, it refers to the result, which may be a
+ * view of the input image if it's only cropped.
+ */
 template <typename T>
-std::vector<std::vector<T>> imagePreprocess(
-  const std::vector<std::string>& paths,
-  const ImagePreprocessOptions<T, 3>& options) {
-  std::vector<std::vector<T>> outputs;
-  outputs.reserve(paths.size());
+void prepareImage(const cv::Mat& image,
+                  const ImagePreprocessOptions<T, 3>& options,
+                  cv::Mat* output) {
+  auto img = image;
+  if (options.convert_color) {
+    // convert into a new image so the input isn't changed
+    cv::Mat converted;
+    cv::cvtColor(img, converted, options.color_code);
+    img = converted;
+  }
 
+  if (!options.resize) {
+    assignImage(img, output);
+    return;
+  }
   const auto& height = options.height;
   const auto& width = options.width;
-  const auto& channels = options.channels;
+  switch (options.resize_algorithm) {
+    case ResizeAlgorithm::Simple:
+      cv::resize(img, *output, cv::Size(width, height), 0, 0,
+                 cv::INTER_LINEAR);
+      break;
+    case ResizeAlgorithm::CenterCrop:
+      assignImage(centerCrop(img, height, width), output);
+      break;
+    case ResizeAlgorithm::LetterBoxCrop:
+      letterbox(img, height, width, output);
+      break;
+    case ResizeAlgorithm::ResizeCenterCrop:
+      resizeCenterCrop(img, height, width, output);
+      break;
+    default:
+      throw std::invalid_argument("Unknown resize algorithm");
+  }
+}
 
-  constexpr auto kChannels = 3;
-  assert(channels == kChannels);
+inline cv::Mat readImage(const std::string& path) {
+  auto img = cv::imread(path);
+  if (img.empty()) {
+    throw std::invalid_argument(std::string("Unable to load image ") + path);
+  }
+  return img;
+}
 
-  auto index = 0;
-  for (const auto& path : paths) {
-    auto img = cv::imread(path);
-    if (img.empty()) {
-      throw std::invalid_argument(std::string("Unable to load image ") + path);
-    }
-    if (options.convert_color) {
-      cv::cvtColor(img, img, options.color_code);
+/// Decode, color-convert and resize an image, using the cache if there is one
+template <typename T>
+cv::Mat loadImage(const std::string& path,
+                  const ImagePreprocessOptions<T, 3>& options,
+                  ImageCache* cache) {
+  if (cache != nullptr) {
+    if (auto img = cache->get(path); !img.empty()) {
+      return img;
     }
+  }
 
-    if (options.resize) {
-      switch (options.resize_algorithm) {
-        case ResizeAlgorithm::Simple:
-          cv::resize(img, img, cv::Size(width, height), cv::INTER_LINEAR);
-          break;
-        case ResizeAlgorithm::CenterCrop:
-          img = centerCrop(img, height, width);
-          break;
-        default:
-          throw std::invalid_argument("Unknown resize algorithm");
-      }
-    }
+  cv::Mat img;
+  prepareImage(readImage(path), options, &img);
 
-    if (options.convert_type) {
-      img.convertTo(img, options.type, options.convert_scale);
+  if (cache != nullptr) {
+    // a crop would keep the full decoded image alive in the cache
+    cache->put(path, img.isContinuous() ? img : img.clone());
+  }
+  return img;
+}
+
+/**
+ * @brief Check if the preprocessed image is just the 8-bit resized image, in
+ * which case it can be resized straight into the output
+ */
+template <typename T>
+bool resizesInPlace(const ImagePreprocessOptions<T, 3>& options) {
+  return sizeof(T) == 1 && options.resize && options.assign &&
+         !options.convert_type && !options.normalize;
+}
+
+/// Get the number of elements the preprocessed image will have
+inline size_t imageSize(const cv::Mat& img, int channels) {
+  return static_cast<size_t>(img.size[0]) * img.size[1] * channels;
+}
+
+/**
+ * @brief Convert and normalize a loaded image, writing the result to output,
+ * which must have room for imageSize() elements. The image isn't modified so
+ * it can be shared through a cache.
+ */
+template <typename T>
+void writeImage(const cv::Mat& loaded,
+                const ImagePreprocessOptions<T, 3>& options, T* output) {
+  constexpr auto kChannels = 3;
+
+  // 8-bit images converted to floats are converted and normalized together
+  // in one pass instead
+  bool fuse = false;
+  if constexpr (std::is_same_v<T, float>) {
+    fuse = options.normalize && options.convert_type && !options.assign &&
+           options.type == CV_32FC3 && loaded.type() == CV_8UC3;
+  }
+  cv::Mat img = loaded;
+  if (options.convert_type && !fuse) {
+    loaded.convertTo(img, options.type, options.convert_scale);
+  } else if (!fuse && !img.isContinuous()) {
+    // the other paths walk over the image directly. The fused one reads the
+    // rows of a view in place
+    img = img.clone();
+  }
+
+  const auto size = imageSize(img, options.channels);
+  if (options.normalize) {
+    const auto* mean = options.mean.data();
+    const auto* std = options.std.data();
+    if constexpr (std::is_same_v<T, float>) {
+      if (fuse) {
+        normalize(img.ptr<uint8_t>(), img.rows, img.cols, img.step[0],
+                  options.order, static_cast<float>(options.convert_scale),
+                  mean, std, output);
+      }
     }
-    img = img.isContinuous() ? img : img.clone();
-
-    auto size = img.size[0] * img.size[1] * channels;
-    outputs.emplace_back();
-    auto& output = outputs[index++];
-    output.resize(size);
-
-    if (options.normalize) {
-      const auto* mean = options.mean.data();
-      const auto* std = options.std.data();
-      detail::normalize<T, kChannels>(img, options.order, output.data(), mean,
-                                      std);
+    if (!fuse) {
+      detail::normalize<T, kChannels>(img, options.order, output, mean, std);
     }
+  }
+
+  if (options.assign) {
+    std::copy(img.data, img.data + size, output);
+  }
+}
 
-    if (options.assign) {
-      output.assign(img.data, img.data + size);
+/**
+ * @brief Preprocess a decoded image into output, which has room for height *
+ * width * channels elements. If the result is the 8-bit resized image, it's
+ * resized straight into the output.
+ */
+template <typename T>
+void preprocessImage(const cv::Mat& image,
+                     const ImagePreprocessOptions<T, 3>& options, T* output) {
+  if (resizesInPlace(options)) {
+    cv::Mat wrapped{options.height, options.width, CV_8UC3, output};
+    prepareImage(image, options, &wrapped);
+    // the image was reallocated if it doesn't have the type of the output
+    if (wrapped.data != reinterpret_cast<uint8_t*>(output)) {
+      writeImage(wrapped, options, output);
     }
+    return;
+  }
+
+  cv::Mat img;
+  prepareImage(image, options, &img);
+  if (img.size[0] != options.height || img.size[1] != options.width) {
+    throw std::invalid_argument(
+      "The image doesn't match the size in the options");
   }
+  writeImage(img, options, output);
+}
+
+}  // namespace detail
+
+/**
+ * @brief Preprocess images in parallel, returning each in its own buffer
+ *
+ * @tparam T type of the preprocessed data
+ * @param paths paths to the images
+ * @param options preprocessing options
+ * @param threads number of threads to use. If zero, one per core is used
+ * @return std::vector<std::vector<T>> the preprocessed images in order
+ */
+template <typename T>
+std::vector<std::vector<T>> imagePreprocess(
+  const std::vector<std::string>& paths,
+  const ImagePreprocessOptions<T, 3>& options, size_t threads = 0) {
+  constexpr auto kChannels = 3;
+  assert(options.channels == kChannels);
+
+  std::vector<std::vector<T>> outputs(paths.size());
+  detail::parallelFor(paths.size(), threads, [&](size_t i) {
+    auto img = detail::loadImage(paths[i], options, nullptr);
+    auto& output = outputs[i];
+    output.resize(detail::imageSize(img, options.channels));
+    detail::writeImage(img, options, output.data());
+  });
   return outputs;
 }
 
+/**
+ * @brief Preprocess a batch of images in parallel, writing them back to back
+ * into one contiguous buffer. All the images must end up with the size given
+ * in the options so resizing should be enabled unless the images already have
+ * this size.
+ *
+ * @tparam T type of the preprocessed data
+ * @param paths paths to the images
+ * @param options preprocessing options
+ * @param output buffer with room for paths.size() * height * width * channels
+ * elements
+ * @param threads number of threads to use. If zero, one per core is used
+ * @param cache optional cache of decoded and resized images
+ */
+template <typename T>
+void imagePreprocess(const std::vector<std::string>& paths,
+                     const ImagePreprocessOptions<T, 3>& options, T* output,
+                     size_t threads = 0, ImageCache* cache = nullptr) {
+  constexpr auto kChannels = 3;
+  assert(options.channels == kChannels);
+
+  const auto image_size =
+    static_cast<size_t>(options.height) * options.width * options.channels;
+  detail::parallelFor(paths.size(), threads, [&](size_t i) {
+    auto* image_output = output + (i * image_size);
+    if (cache == nullptr && detail::resizesInPlace(options)) {
+      detail::preprocessImage(detail::readImage(paths[i]), options,
+                              image_output);
+      return;
+    }
+    auto img = detail::loadImage(paths[i], options, cache);
+    if (img.size[0] != options.height || img.size[1] != options.width) {
+      throw std::invalid_argument("The image " + paths[i] +
+                                  " doesn't match the size of the batch");
+    }
+    detail::writeImage(img, options, image_output);
+  });
+}
+
+/**
+ * @brief Preprocess an image that's already been decoded, e.g. with
+ * cv::imdecode, writing the result to output. Resizing should be enabled so the
+ * output has a known size of height * width * channels elements.
+ *
+ * @tparam T type of the preprocessed data
+ * @param image the decoded 8-bit image
+ * @param options preprocessing options
+ * @param output buffer with room for height * width * channels elements
+ */
+template <typename T>
+void imagePreprocess(const cv::Mat& image,
+                     const ImagePreprocessOptions<T, 3>& options, T* output) {
+  constexpr auto kChannels = 3;
+  assert(options.channels == kChannels);
+
+  detail::preprocessImage(image, options, output);
+}
+
 }  // namespace amdinfer::pre_post
 
 #endif  // GUARD_AMDINFER_PRE_POST_IMAGE_PREPROCESS
@@ -0,0 +1,153 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines helpers to read the size of a JPEG image from its header so
+ * it can be decoded at a reduced scale
+ */
+
+#ifndef GUARD_AMDINFER_PRE_POST_JPEG_HEADER
+#define GUARD_AMDINFER_PRE_POST_JPEG_HEADER
+
+#include <array>     // for array
+#include <cstddef>   // for size_t
+#include <cstdint>   // for uint8_t
+#include <optional>  // for optional, nullopt
+
+namespace amdinfer::pre_post {
+
+struct ImageDimensions {
+  int height = 0;
+  int width = 0;
+};
+
+namespace detail {
+
+constexpr uint8_t kJpegMarker = 0xFF;
+
+/// Check if the marker starts a frame, which holds the size of the image
+inline bool isStartOfFrame(uint8_t marker) {
+  // 0xC4, 0xC8 and 0xCC are in the same range but aren't frames
+  return marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 &&
+         marker != 0xC8 && marker != 0xCC;
+}
+
+/// Check if the marker has no segment after it
+inline bool isStandalone(uint8_t marker) {
+  return marker == 0x01 || (marker >= 0xD0 && marker <= 0xD8);
+}
+
+inline int readShort(const uint8_t* data) { return (data[0] << 8) | data[1]; }
+
+}  // namespace detail
+
+/**
+ * @brief Check if the data starts with the JPEG start-of-image marker
+ *
+ * @param data pointer to the encoded image
+ * @param size size of the data in bytes
+ */
+inline bool isJpeg(const uint8_t* data, size_t size) {
+  return size >= 3 && data[0] == detail::kJpegMarker && data[1] == 0xD8 &&
+         data[2] == detail::kJpegMarker;
+}
+
+/**
+ * @brief Get the size of a JPEG image by walking its segments up to the first
+ * frame header without decoding anything
+ *
+ * @param data pointer to the encoded image
+ * @param size size of the data in bytes
+ * @return std::optional<ImageDimensions> the size or nullopt if the data isn't
+ * a JPEG image or the header is truncated
+ */
+inline std::optional<ImageDimensions> jpegDimensions(const uint8_t* data,
+                                                     size_t size) {
+  if (!isJpeg(data, size)) {
+    return std::nullopt;
+  }
+
+  size_t position = 2;
+  while (position < size) {
+    if (data[position] != detail::kJpegMarker) {
+      return std::nullopt;
+    }
+    // markers may be padded with any number of 0xFF bytes
+    while (position < size && data[position] == detail::kJpegMarker) {
+      position++;
+    }
+    if (position == size) {
+      return std::nullopt;
+    }
+    const auto marker = data[position++];
+    if (detail::isStandalone(marker)) {
+      continue;
+    }
+    // the length of the segment includes the 2 bytes of the length itself
+    if (position + 2 > size) {
+      return std::nullopt;
+    }
+    const auto length = static_cast<size_t>(detail::readShort(data + position));
+    if (detail::isStartOfFrame(marker)) {
+      // length (2), precision (1), height (2), width (2)
+      constexpr auto kFrameHeader = 7;
+      if (length < kFrameHeader || position + kFrameHeader > size) {
+        return std::nullopt;
+      }
+      return ImageDimensions{detail::readShort(data + position + 3),
+                             detail::readShort(data + position + 5)};
+    }
+    // the image data started or ended without a frame header
+    if (marker == 0xDA || marker == 0xD9 || length < 2) {
+      return std::nullopt;
+    }
+    position += length;
+  }
+  return std::nullopt;
+}
+
+/**
+ * @brief Get the largest power-of-two factor, up to 8, that a JPEG image can
+ * be scaled down by while decoding such that it's still at least the target
+ * size. The decoder skips most of the inverse DCT work for the scaled image so
+ * large images that are resized after decoding are much faster to decode.
+ *
+ * @param image the size of the encoded image
+ * @param height the minimum height of the decoded image
+ * @param width the minimum width of the decoded image
+ * @return int 1, 2, 4 or 8
+ */
+inline int jpegScaleDenominator(const ImageDimensions& image, int height,
+                                int width) {
+  if (height <= 0 || width <= 0) {
+    return 1;
+  }
+  // the decoders round the scaled size up
+  const auto scaled = [](int size, int denominator) {
+    return (size + denominator - 1) / denominator;
+  };
+  constexpr std::array kDenominators{8, 4, 2};
+  for (const auto denominator : kDenominators) {
+    if (scaled(image.height, denominator) >= height &&
+        scaled(image.width, denominator) >= width) {
+      return denominator;
+    }
+  }
+  return 1;
+}
+
+}  // namespace amdinfer::pre_post
+
+#endif  // GUARD_AMDINFER_PRE_POST_JPEG_HEADER
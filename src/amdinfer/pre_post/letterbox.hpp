@@ -0,0 +1,94 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the letterbox resize used by detection models like YOLO
+ */
+
+#ifndef GUARD_AMDINFER_PRE_POST_LETTERBOX
+#define GUARD_AMDINFER_PRE_POST_LETTERBOX
+
+#include <algorithm>            // for min, max
+#include <opencv2/core.hpp>     // for Mat, Rect, Scalar, Size
+#include <opencv2/imgproc.hpp>  // for resize, INTER_LINEAR
+
+namespace amdinfer::pre_post {
+
+/// The value of the padding around letterboxed images by default
+constexpr auto kLetterboxPad = 128;
+
+/**
+ * @brief Get the region of the output that a letterboxed image is resized
+ * into. The image is scaled to fit in the output while keeping its aspect
+ * ratio and centered. Detections in the output can be mapped back to the
+ * original image by subtracting the offset of this region and dividing by the
+ * scale.
+ *
+ * @param rows height of the image
+ * @param cols width of the image
+ * @param height height of the output
+ * @param width width of the output
+ * @return cv::Rect
+ */
+inline cv::Rect letterboxRect(int rows, int cols, int height, int width) {
+  const auto scale = std::min(static_cast<double>(height) / rows,
+                              static_cast<double>(width) / cols);
+  const auto scaled_rows =
+    std::max(1, std::min(height, static_cast<int>(rows * scale + 0.5)));
+  const auto scaled_cols =
+    std::max(1, std::min(width, static_cast<int>(cols * scale + 0.5)));
+  return {(width - scaled_cols) / 2, (height - scaled_rows) / 2, scaled_cols,
+          scaled_rows};
+}
+
+/**
+ * @brief Resize an image to fit in the output while keeping its aspect ratio
+ * and pad the rest. The image is resized straight into its region of the
+ * output and only the borders around it are filled, so there's no
+ * intermediate image and no pixel is written twice.
+ *
+ * @param img the image to resize
+ * @param height height of the output image
+ * @param width width of the output image
+ * @param output the output image. If it already has the right size and type,
+ * e.g. if it wraps an output tensor, it's written in place
+ * @param pad the value to pad with
+ */
+inline void letterbox(const cv::Mat& img, int height, int width,
+                      cv::Mat* output,
+                      const cv::Scalar& pad = cv::Scalar::all(kLetterboxPad)) {
+  output->create(height, width, img.type());
+  const auto rect = letterboxRect(img.rows, img.cols, height, width);
+
+  // the image covers the full width or height so at most two opposite
+  // borders need to be filled
+  if (rect.y > 0 || rect.height < height) {
+    (*output)(cv::Rect(0, 0, width, rect.y)).setTo(pad);
+    const auto bottom = rect.y + rect.height;
+    (*output)(cv::Rect(0, bottom, width, height - bottom)).setTo(pad);
+  }
+  if (rect.x > 0 || rect.width < width) {
+    (*output)(cv::Rect(0, rect.y, rect.x, rect.height)).setTo(pad);
+    const auto right = rect.x + rect.width;
+    (*output)(cv::Rect(right, rect.y, width - right, rect.height)).setTo(pad);
+  }
+
+  auto region = (*output)(rect);
+  cv::resize(img, region, rect.size(), 0, 0, cv::INTER_LINEAR);
+}
+
+}  // namespace amdinfer::pre_post
+
+#endif  // GUARD_AMDINFER_PRE_POST_LETTERBOX
@@ -0,0 +1,324 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines kernels that convert 8-bit, 3-channel images to normalized
+ * floats and write them in NHWC or NCHW order in one pass
+ */
+
+#ifndef GUARD_AMDINFER_PRE_POST_NORMALIZE
+#define GUARD_AMDINFER_PRE_POST_NORMALIZE
+
+#include <array>    // for array
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint8_t
+
+#include "amdinfer/pre_post/simd.hpp"  // for AMDINFER_X86_SIMD, hasAvx2
+
+namespace amdinfer::pre_post {
+
+enum class ImageOrder {
+  NHWC,
+  NCHW,
+};
+
+namespace detail {
+
+constexpr auto kNormalizeChannels = 3;
+
+using ChannelFactors = std::array<float, kNormalizeChannels>;
+
+/**
+ * @brief Folds the scale, mean and std together so each element is normalized
+ * with one multiply-add: (x * scale - mean) * std = x * factor + offset
+ */
+struct NormalizeFactors {
+  NormalizeFactors(float scale, const float* mean, const float* std) {
+    for (auto c = 0; c < kNormalizeChannels; ++c) {
+      factor[c] = scale * std[c];
+      offset[c] = -mean[c] * std[c];
+    }
+  }
+
+  ChannelFactors factor;
+  ChannelFactors offset;
+};
+
+/**
+ * @brief Normalize pixels [start, pixels). In NCHW order, the channel planes of
+ * the output are plane elements apart, or pixels apart if it's 0, so the rows
+ * of a larger image can be written separately.
+ */
+inline void normalizeScalar(const uint8_t* input, size_t pixels,
+                            ImageOrder order, const NormalizeFactors& factors,
+                            float* output, size_t start = 0, size_t plane = 0) {
+  const auto& factor = factors.factor;
+  const auto& offset = factors.offset;
+  plane = plane == 0 ? pixels : plane;
+  for (auto p = start; p < pixels; ++p) {
+    for (auto c = 0; c < kNormalizeChannels; ++c) {
+      const auto value =
+        static_cast<float>(input[(p * kNormalizeChannels) + c]) * factor[c] +
+        offset[c];
+      if (order == ImageOrder::NHWC) {
+        output[(p * kNormalizeChannels) + c] = value;
+      } else {
+        output[(c * plane) + p] = value;
+      }
+    }
+  }
+}
+
+#ifdef AMDINFER_X86_SIMD
+
+constexpr auto kRegisterBytes = 16;
+
+using ShuffleMask = std::array<char, kRegisterBytes>;
+
+/**
+ * @brief Get the byte shuffle masks that gather each channel of 8-bit pixels
+ * that are spread over consecutive 16-byte registers into one register. The
+ * mask [c][r] picks the bytes of channel c from register r and zeros the rest.
+ *
+ * @tparam kRegisters number of 16-byte registers the pixels span
+ */
+template <int kRegisters>
+std::array<std::array<ShuffleMask, kRegisters>, kNormalizeChannels>
+channelMasks() {
+  constexpr auto kZero = static_cast<char>(0x80);
+  std::array<std::array<ShuffleMask, kRegisters>, kNormalizeChannels> masks{};
+  for (auto c = 0; c < kNormalizeChannels; ++c) {
+    for (auto& mask : masks[c]) {
+      mask.fill(kZero);
+    }
+    for (auto j = 0; j < kRegisterBytes; ++j) {
+      const auto position = c + (kNormalizeChannels * j);
+      if (position < kRegisters * kRegisterBytes) {
+        masks[c][position / kRegisterBytes][j] =
+          static_cast<char>(position % kRegisterBytes);
+      }
+    }
+  }
+  return masks;
+}
+
+/// The factors and offsets for each lane of the registers in NHWC order
+template <size_t kLanes>
+struct LaneFactors {
+  std::array<std::array<float, kLanes>, kNormalizeChannels> factor;
+  std::array<std::array<float, kLanes>, kNormalizeChannels> offset;
+};
+
+template <size_t kLanes>
+LaneFactors<kLanes> laneFactors(const NormalizeFactors& factors) {
+  LaneFactors<kLanes> lanes{};
+  for (size_t k = 0; k < kNormalizeChannels; ++k) {
+    for (size_t j = 0; j < kLanes; ++j) {
+      const auto c = ((k * kLanes) + j) % kNormalizeChannels;
+      lanes.factor[k][j] = factors.factor[c];
+      lanes.offset[k][j] = factors.offset[c];
+    }
+  }
+  return lanes;
+}
+
+__attribute__((target("avx2"))) inline __m128i loadMask(
+  const ShuffleMask& mask) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask.data()));
+}
+
+/// Convert 16 bytes to floats. The zero-masked conversions with a full mask
+/// are the same as the plain ones but avoid the undefined source operands
+/// that GCC warns about
+__attribute__((target("avx512f"))) inline __m512 toFloat512(__m128i bytes) {
+  constexpr __mmask16 kAll = 0xFFFF;
+  return _mm512_maskz_cvtepi32_ps(kAll,
+                                  _mm512_maskz_cvtepu8_epi32(kAll, bytes));
+}
+
+__attribute__((target("avx2,fma"))) inline void normalizeAvx2(
+  const uint8_t* input, size_t pixels, ImageOrder order,
+  const NormalizeFactors& factors, float* output, size_t plane = 0) {
+  constexpr size_t kPixels = 8;
+  size_t p = 0;
+  plane = plane == 0 ? pixels : plane;
+  if (order == ImageOrder::NHWC) {
+    // 8 pixels are 24 floats so the channel of each lane repeats every 3
+    // registers
+    const auto lanes = laneFactors<kPixels>(factors);
+    for (; p + kPixels <= pixels; p += kPixels) {
+      const auto* src = input + (p * kNormalizeChannels);
+      auto* dst = output + (p * kNormalizeChannels);
+      for (auto k = 0; k < kNormalizeChannels; ++k) {
+        const auto bytes = _mm_loadl_epi64(
+          reinterpret_cast<const __m128i*>(src + (k * kPixels)));
+        const auto x = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(bytes));
+        const auto factor = _mm256_loadu_ps(lanes.factor[k].data());
+        const auto offset = _mm256_loadu_ps(lanes.offset[k].data());
+        _mm256_storeu_ps(dst + (k * kPixels),
+                         _mm256_fmadd_ps(x, factor, offset));
+      }
+    }
+  } else {
+    // the 24 bytes of 8 pixels are split over a 16- and an 8-byte load and
+    // each channel is gathered from both with shuffles
+    const auto masks = channelMasks<2>();
+    for (; p + kPixels <= pixels; p += kPixels) {
+      const auto* src = input + (p * kNormalizeChannels);
+      const auto low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+      const auto high =
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + 16));
+      for (auto c = 0; c < kNormalizeChannels; ++c) {
+        const auto bytes =
+          _mm_or_si128(_mm_shuffle_epi8(low, loadMask(masks[c][0])),
+                       _mm_shuffle_epi8(high, loadMask(masks[c][1])));
+        const auto x = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(bytes));
+        _mm256_storeu_ps(
+          output + (c * plane) + p,
+          _mm256_fmadd_ps(x, _mm256_set1_ps(factors.factor[c]),
+                          _mm256_set1_ps(factors.offset[c])));
+      }
+    }
+  }
+  normalizeScalar(input, pixels, order, factors, output, p, plane);
+}
+
+__attribute__((target("avx512f"))) inline void normalizeAvx512(
+  const uint8_t* input, size_t pixels, ImageOrder order,
+  const NormalizeFactors& factors, float* output, size_t plane = 0) {
+  constexpr size_t kPixels = 16;
+  size_t p = 0;
+  plane = plane == 0 ? pixels : plane;
+  if (order == ImageOrder::NHWC) {
+    const auto lanes = laneFactors<kPixels>(factors);
+    for (; p + kPixels <= pixels; p += kPixels) {
+      const auto* src = input + (p * kNormalizeChannels);
+      auto* dst = output + (p * kNormalizeChannels);
+      for (auto k = 0; k < kNormalizeChannels; ++k) {
+        const auto bytes = _mm_loadu_si128(
+          reinterpret_cast<const __m128i*>(src + (k * kPixels)));
+        const auto x = toFloat512(bytes);
+        const auto factor = _mm512_loadu_ps(lanes.factor[k].data());
+        const auto offset = _mm512_loadu_ps(lanes.offset[k].data());
+        _mm512_storeu_ps(dst + (k * kPixels),
+                         _mm512_fmadd_ps(x, factor, offset));
+      }
+    }
+  } else {
+    // the 48 bytes of 16 pixels span 3 loads
+    const auto masks = channelMasks<3>();
+    for (; p + kPixels <= pixels; p += kPixels) {
+      const auto* src = input + (p * kNormalizeChannels);
+      const auto first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+      const auto second =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16));
+      const auto third =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 32));
+      for (auto c = 0; c < kNormalizeChannels; ++c) {
+        auto bytes = _mm_shuffle_epi8(first, loadMask(masks[c][0]));
+        bytes =
+          _mm_or_si128(bytes, _mm_shuffle_epi8(second, loadMask(masks[c][1])));
+        bytes =
+          _mm_or_si128(bytes, _mm_shuffle_epi8(third, loadMask(masks[c][2])));
+        const auto x = toFloat512(bytes);
+        _mm512_storeu_ps(
+          output + (c * plane) + p,
+          _mm512_fmadd_ps(x, _mm512_set1_ps(factors.factor[c]),
+                          _mm512_set1_ps(factors.offset[c])));
+      }
+    }
+  }
+  normalizeScalar(input, pixels, order, factors, output, p, plane);
+}
+
+#endif  // AMDINFER_X86_SIMD
+
+/// Normalize with the widest SIMD instructions the CPU supports
+inline void normalizeDispatch(const uint8_t* input, size_t pixels,
+                              ImageOrder order, const NormalizeFactors& factors,
+                              float* output, size_t plane) {
+#ifdef AMDINFER_X86_SIMD
+  static const bool has_avx512 = hasAvx512();
+  static const bool has_avx2 = hasAvx2();
+  if (has_avx512) {
+    normalizeAvx512(input, pixels, order, factors, output, plane);
+    return;
+  }
+  if (has_avx2) {
+    normalizeAvx2(input, pixels, order, factors, output, plane);
+    return;
+  }
+#endif
+  normalizeScalar(input, pixels, order, factors, output, 0, plane);
+}
+
+}  // namespace detail
+
+/**
+ * @brief Convert an 8-bit image with 3 interleaved channels to floats and
+ * normalize it in one pass, computing (x * scale - mean[c]) * std[c] for each
+ * element. The widest SIMD instructions the CPU supports are picked at runtime.
+ *
+ * @param input the pixels of the image in HWC order
+ * @param pixels the number of pixels i.e. height * width
+ * @param order the order to write the output in
+ * @param scale scale to apply to the raw values before normalizing
+ * @param mean the mean of each channel
+ * @param std the factor to multiply each channel by after subtracting the mean
+ * @param output buffer with room for pixels * 3 floats
+ */
+inline void normalize(const uint8_t* input, size_t pixels, ImageOrder order,
+                      float scale, const float* mean, const float* std,
+                      float* output) {
+  const detail::NormalizeFactors factors{scale, mean, std};
+  detail::normalizeDispatch(input, pixels, order, factors, output, pixels);
+}
+
+/**
+ * @brief Normalize an image like normalize() but read its rows, which may be
+ * padded, from stride bytes apart. This lets a region of a larger image, like
+ * a crop, be normalized without copying it first.
+ *
+ * @param input the first pixel of the image in HWC order
+ * @param rows the height of the image
+ * @param cols the width of the image
+ * @param stride the distance between the starts of the rows in bytes
+ * @param order the order to write the output in
+ * @param scale scale to apply to the raw values before normalizing
+ * @param mean the mean of each channel
+ * @param std the factor to multiply each channel by after subtracting the mean
+ * @param output buffer with room for rows * cols * 3 floats
+ */
+inline void normalize(const uint8_t* input, size_t rows, size_t cols,
+                      size_t stride, ImageOrder order, float scale,
+                      const float* mean, const float* std, float* output) {
+  const auto row_bytes = cols * detail::kNormalizeChannels;
+  if (stride == row_bytes) {
+    normalize(input, rows * cols, order, scale, mean, std, output);
+    return;
+  }
+  const detail::NormalizeFactors factors{scale, mean, std};
+  const auto pixels = rows * cols;
+  for (size_t r = 0; r < rows; ++r) {
+    auto* row = order == ImageOrder::NHWC ? output + (r * row_bytes)
+                                          : output + (r * cols);
+    detail::normalizeDispatch(input + (r * stride), cols, order, factors, row,
+                              pixels);
+  }
+}
+
+}  // namespace amdinfer::pre_post
+
+#endif  // GUARD_AMDINFER_PRE_POST_NORMALIZE
@@ -16,15 +16,16 @@
 #ifndef GUARD_AMDINFER_PRE_POST_RESNET50_POSTPROCESS
 #define GUARD_AMDINFER_PRE_POST_RESNET50_POSTPROCESS
 
-#include <vector>
+#include <cstddef>  // for size_t
+#include <vector>   // for vector
 
-#include "amdinfer/pre_post/get_top_k.hpp"
-#include "amdinfer/pre_post/softmax.hpp"
+#include "amdinfer/pre_post/get_top_k.hpp"  // for getTopK
 
 namespace amdinfer::pre_post {
 
 /**
- * @brief Perform postprocessing of the data
+ * @brief Perform postprocessing of the data. Softmax doesn't change the order
+ * of the values so the top k are picked from the raw data directly.
  *
  * @tparam T the expected type of the data
  * @param output output from the server
@@ -33,11 +34,23 @@ namespace amdinfer::pre_post {
  */
 template <typename T>
 std::vector<int> resnet50Postprocess(const T* data, size_t size, int k) {
-  std::vector<double> softmax;
-  softmax.resize(size, 0);
+  return getTopK(data, size, k);
+}
 
-  calcSoftmax(data, size, softmax.data());
-  return getTopK(softmax.data(), size, k);
+/**
+ * @brief Perform postprocessing of a batch of [batch, classes] data
+ *
+ * @tparam T the expected type of the data
+ * @param data output from the server
+ * @param batch number of rows in the data
+ * @param classes number of classes in each row
+ * @param k number of top elements to return per row
+ * @return std::vector<std::vector<int>>
+ */
+template <typename T>
+std::vector<std::vector<int>> resnet50Postprocess(const T* data, size_t batch,
+                                                  size_t classes, int k) {
+  return getTopK(data, batch, classes, k);
 }
 
 }  // namespace amdinfer::pre_post
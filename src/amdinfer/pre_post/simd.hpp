@@ -0,0 +1,65 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the checks used to pick SIMD kernels at runtime. The kernels
+ * are compiled for their instruction sets with target attributes so the rest
+ * of the code doesn't need any special flags.
+ */
+
+#ifndef GUARD_AMDINFER_PRE_POST_SIMD
+#define GUARD_AMDINFER_PRE_POST_SIMD
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define AMDINFER_X86_SIMD
+#include <immintrin.h>
+// older compilers can't target the bf16 conversion instructions
+#if (defined(__clang__) && __clang_major__ >= 9) || \
+  (!defined(__clang__) && __GNUC__ >= 10)
+#define AMDINFER_X86_AVX512_BF16
+#endif
+#endif
+
+namespace amdinfer::pre_post::detail {
+
+#ifdef AMDINFER_X86_SIMD
+
+inline bool hasAvx2() {
+  return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+}
+
+inline bool hasAvx512() { return __builtin_cpu_supports("avx512f"); }
+
+inline bool hasAvx512Vbmi() {
+  return __builtin_cpu_supports("avx512bw") &&
+         __builtin_cpu_supports("avx512vbmi");
+}
+
+inline bool hasF16c() {
+  return __builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c");
+}
+
+#ifdef AMDINFER_X86_AVX512_BF16
+inline bool hasAvx512Bf16() {
+  return __builtin_cpu_supports("avx512f") &&
+         __builtin_cpu_supports("avx512bf16");
+}
+#endif
+
+#endif  // AMDINFER_X86_SIMD
+
+}  // namespace amdinfer::pre_post::detail
+
+#endif  // GUARD_AMDINFER_PRE_POST_SIMD
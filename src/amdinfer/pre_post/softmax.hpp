@@ -16,10 +16,413 @@
 #ifndef GUARD_AMDINFER_PRE_POST_SOFTMAX
 #define GUARD_AMDINFER_PRE_POST_SOFTMAX
 
-#include <cstddef>
+#include <algorithm>    // for max
+#include <array>        // for array
+#include <cmath>        // for exp
+#include <cstddef>      // for size_t
+#include <cstdint>      // for int64_t
+#include <type_traits>  // for is_same_v
+
+#include "amdinfer/pre_post/simd.hpp"  // for AMDINFER_X86_SIMD, hasAvx2
 
 namespace amdinfer::pre_post {
 
+namespace detail {
+
+template <typename T>
+void softmaxScalar(const T* data, size_t size, T* result) {
+  auto max = data[0];
+  for (size_t i = 1; i < size; i++) {
+    max = std::max(max, data[i]);
+  }
+
+  T sum = 0;
+  for (size_t i = 0; i < size; i++) {
+    result[i] = std::exp(data[i] - max);
+    sum += result[i];
+  }
+
+  const auto scale = 1 / sum;
+  for (size_t i = 0; i < size; i++) {
+    result[i] *= scale;
+  }
+}
+
+#ifdef AMDINFER_X86_SIMD
+
+// The vector exponentials only need to handle x <= 0 since the maximum is
+// subtracted first. The input is split into n * ln(2) + r with |r| <= ln(2) / 2
+// so exp(x) = 2^n * exp(r), where exp(r) is a polynomial and 2^n is built
+// directly in the exponent bits. Inputs are clamped so 2^n stays a normal
+// number, where exp(x) is already negligible next to exp(0) = 1.
+
+constexpr float kLog2eF = 1.44269504088896341F;
+// ln(2) split into a part with an exact product with n and the remainder
+constexpr float kLn2HiF = 0.693359375F;
+constexpr float kLn2LoF = -2.12194440e-4F;
+constexpr float kMinExpF = -87.0F;
+constexpr int kFloatBias = 127;
+constexpr int kFloatMantissa = 23;
+// the minimax polynomial for exp(r) from Cephes' expf
+constexpr std::array<float, 6> kExpCoefficientsF{
+  1.9875691500E-4F, 1.3981999507E-3F, 8.3334519073E-3F,
+  4.1665795894E-2F, 1.6666665459E-1F, 5.0000001201E-1F};
+
+constexpr double kLog2e = 1.4426950408889634074;
+constexpr double kLn2Hi = 6.93145751953125E-1;
+constexpr double kLn2Lo = 1.42860682030941723212E-6;
+constexpr double kMinExp = -708.0;
+constexpr int64_t kDoubleBias = 1023;
+constexpr int kDoubleMantissa = 52;
+// adding 1.5 * 2^52 to an integral double puts the integer in its low bits
+constexpr double kRoundMagic = 6755399441055744.0;
+// the Taylor series for exp(r) up to r^13 / 13!, highest power first
+constexpr std::array<double, 12> kExpCoefficients{
+  1.0 / 6227020800, 1.0 / 479001600, 1.0 / 39916800, 1.0 / 3628800,
+  1.0 / 362880,     1.0 / 40320,     1.0 / 5040,     1.0 / 720,
+  1.0 / 120,        1.0 / 24,        1.0 / 6,        1.0 / 2};
+
+__attribute__((target("avx2,fma"))) inline __m256 expAvx2(__m256 x) {
+  x = _mm256_max_ps(x, _mm256_set1_ps(kMinExpF));
+  const auto n = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(kLog2eF)),
+                                 _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  auto r = _mm256_fnmadd_ps(n, _mm256_set1_ps(kLn2HiF), x);
+  r = _mm256_fnmadd_ps(n, _mm256_set1_ps(kLn2LoF), r);
+
+  auto p = _mm256_set1_ps(kExpCoefficientsF[0]);
+  for (size_t i = 1; i < kExpCoefficientsF.size(); ++i) {
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(kExpCoefficientsF[i]));
+  }
+  p = _mm256_fmadd_ps(p, _mm256_mul_ps(r, r), r);
+  p = _mm256_add_ps(p, _mm256_set1_ps(1));
+
+  auto exponent = _mm256_add_epi32(_mm256_cvtps_epi32(n),
+                                   _mm256_set1_epi32(kFloatBias));
+  exponent = _mm256_slli_epi32(exponent, kFloatMantissa);
+  return _mm256_mul_ps(p, _mm256_castsi256_ps(exponent));
+}
+
+__attribute__((target("avx2,fma"))) inline __m256d expAvx2(__m256d x) {
+  x = _mm256_max_pd(x, _mm256_set1_pd(kMinExp));
+  const auto n = _mm256_round_pd(_mm256_mul_pd(x, _mm256_set1_pd(kLog2e)),
+                                 _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  auto r = _mm256_fnmadd_pd(n, _mm256_set1_pd(kLn2Hi), x);
+  r = _mm256_fnmadd_pd(n, _mm256_set1_pd(kLn2Lo), r);
+
+  auto p = _mm256_set1_pd(kExpCoefficients[0]);
+  for (size_t i = 1; i < kExpCoefficients.size(); ++i) {
+    p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(kExpCoefficients[i]));
+  }
+  p = _mm256_fmadd_pd(p, _mm256_mul_pd(r, r), r);
+  p = _mm256_add_pd(p, _mm256_set1_pd(1));
+
+  // there's no conversion from doubles to 64-bit integers in AVX2
+  const auto magic = _mm256_set1_pd(kRoundMagic);
+  auto exponent = _mm256_sub_epi64(
+    _mm256_castpd_si256(_mm256_add_pd(n, magic)), _mm256_castpd_si256(magic));
+  exponent = _mm256_add_epi64(exponent, _mm256_set1_epi64x(kDoubleBias));
+  exponent = _mm256_slli_epi64(exponent, kDoubleMantissa);
+  return _mm256_mul_pd(p, _mm256_castsi256_pd(exponent));
+}
+
+// The AVX512 kernels use the zero-masked forms of some instructions with a
+// full mask. They're the same as the plain ones but avoid the undefined source
+// operands that GCC warns about
+constexpr __mmask16 kAll16 = 0xFFFF;
+constexpr __mmask8 kAll8 = 0xFF;
+
+__attribute__((target("avx512f"))) inline __m512 expAvx512(__m512 x) {
+  x = _mm512_maskz_max_ps(kAll16, x, _mm512_set1_ps(kMinExpF));
+  const auto n = _mm512_maskz_roundscale_ps(
+    kAll16, _mm512_mul_ps(x, _mm512_set1_ps(kLog2eF)),
+    _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  auto r = _mm512_fnmadd_ps(n, _mm512_set1_ps(kLn2HiF), x);
+  r = _mm512_fnmadd_ps(n, _mm512_set1_ps(kLn2LoF), r);
+
+  auto p = _mm512_set1_ps(kExpCoefficientsF[0]);
+  for (size_t i = 1; i < kExpCoefficientsF.size(); ++i) {
+    p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(kExpCoefficientsF[i]));
+  }
+  p = _mm512_fmadd_ps(p, _mm512_mul_ps(r, r), r);
+  p = _mm512_add_ps(p, _mm512_set1_ps(1));
+
+  auto exponent = _mm512_add_epi32(_mm512_maskz_cvtps_epi32(kAll16, n),
+                                   _mm512_set1_epi32(kFloatBias));
+  exponent = _mm512_maskz_slli_epi32(kAll16, exponent, kFloatMantissa);
+  return _mm512_mul_ps(p, _mm512_castsi512_ps(exponent));
+}
+
+__attribute__((target("avx512f"))) inline __m512d expAvx512(__m512d x) {
+  x = _mm512_maskz_max_pd(kAll8, x, _mm512_set1_pd(kMinExp));
+  const auto n = _mm512_maskz_roundscale_pd(
+    kAll8, _mm512_mul_pd(x, _mm512_set1_pd(kLog2e)),
+    _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  auto r = _mm512_fnmadd_pd(n, _mm512_set1_pd(kLn2Hi), x);
+  r = _mm512_fnmadd_pd(n, _mm512_set1_pd(kLn2Lo), r);
+
+  auto p = _mm512_set1_pd(kExpCoefficients[0]);
+  for (size_t i = 1; i < kExpCoefficients.size(); ++i) {
+    p = _mm512_fmadd_pd(p, r, _mm512_set1_pd(kExpCoefficients[i]));
+  }
+  p = _mm512_fmadd_pd(p, _mm512_mul_pd(r, r), r);
+  p = _mm512_add_pd(p, _mm512_set1_pd(1));
+
+  // converting to 64-bit integers needs AVX512DQ so use the same trick as AVX2
+  const auto magic = _mm512_set1_pd(kRoundMagic);
+  auto exponent = _mm512_sub_epi64(
+    _mm512_castpd_si512(_mm512_add_pd(n, magic)), _mm512_castpd_si512(magic));
+  exponent = _mm512_add_epi64(exponent, _mm512_set1_epi64(kDoubleBias));
+  exponent = _mm512_maskz_slli_epi64(kAll8, exponent, kDoubleMantissa);
+  return _mm512_mul_pd(p, _mm512_castsi512_pd(exponent));
+}
+
+/// Reduce the lanes of a register stored to memory with f
+template <typename T, size_t kLanes, typename F>
+T reduce(const std::array<T, kLanes>& lanes, F f) {
+  auto value = lanes[0];
+  for (size_t i = 1; i < kLanes; ++i) {
+    value = f(value, lanes[i]);
+  }
+  return value;
+}
+
+// The kernels below share the same three passes: find the maximum, compute
+// and sum the exponentials and then scale by the inverse of the sum. The
+// elements left over after the vector loops are handled one at a time.
+
+__attribute__((target("avx2,fma"))) inline void softmaxAvx2(const float* data,
+                                                            size_t size,
+                                                            float* result) {
+  constexpr size_t kLanes = 8;
+  std::array<float, kLanes> lanes{};
+  size_t i = 0;
+
+  auto max_vector = _mm256_set1_ps(data[0]);
+  for (; i + kLanes <= size; i += kLanes) {
+    max_vector = _mm256_max_ps(max_vector, _mm256_loadu_ps(data + i));
+  }
+  _mm256_storeu_ps(lanes.data(), max_vector);
+  auto max = reduce(lanes, [](float a, float b) { return std::max(a, b); });
+  for (; i < size; ++i) {
+    max = std::max(max, data[i]);
+  }
+
+  const auto max_splat = _mm256_set1_ps(max);
+  auto sum_vector = _mm256_setzero_ps();
+  for (i = 0; i + kLanes <= size; i += kLanes) {
+    const auto value =
+      expAvx2(_mm256_sub_ps(_mm256_loadu_ps(data + i), max_splat));
+    _mm256_storeu_ps(result + i, value);
+    sum_vector = _mm256_add_ps(sum_vector, value);
+  }
+  _mm256_storeu_ps(lanes.data(), sum_vector);
+  auto sum = reduce(lanes, [](float a, float b) { return a + b; });
+  for (; i < size; ++i) {
+    result[i] = std::exp(data[i] - max);
+    sum += result[i];
+  }
+
+  const auto scale = 1 / sum;
+  const auto scale_splat = _mm256_set1_ps(scale);
+  for (i = 0; i + kLanes <= size; i += kLanes) {
+    _mm256_storeu_ps(result + i,
+                     _mm256_mul_ps(_mm256_loadu_ps(result + i), scale_splat));
+  }
+  for (; i < size; ++i) {
+    result[i] *= scale;
+  }
+}
+
+__attribute__((target("avx2,fma"))) inline void softmaxAvx2(const double* data,
+                                                            size_t size,
+                                                            double* result) {
+  constexpr size_t kLanes = 4;
+  std::array<double, kLanes> lanes{};
+  size_t i = 0;
+
+  auto max_vector = _mm256_set1_pd(data[0]);
+  for (; i + kLanes <= size; i += kLanes) {
+    max_vector = _mm256_max_pd(max_vector, _mm256_loadu_pd(data + i));
+  }
+  _mm256_storeu_pd(lanes.data(), max_vector);
+  auto max = reduce(lanes, [](double a, double b) { return std::max(a, b); });
+  for (; i < size; ++i) {
+    max = std::max(max, data[i]);
+  }
+
+  const auto max_splat = _mm256_set1_pd(max);
+  auto sum_vector = _mm256_setzero_pd();
+  for (i = 0; i + kLanes <= size; i += kLanes) {
+    const auto value =
+      expAvx2(_mm256_sub_pd(_mm256_loadu_pd(data + i), max_splat));
+    _mm256_storeu_pd(result + i, value);
+    sum_vector = _mm256_add_pd(sum_vector, value);
+  }
+  _mm256_storeu_pd(lanes.data(), sum_vector);
+  auto sum = reduce(lanes, [](double a, double b) { return a + b; });
+  for (; i < size; ++i) {
+    result[i] = std::exp(data[i] - max);
+    sum += result[i];
+  }
+
+  const auto scale = 1 / sum;
+  const auto scale_splat = _mm256_set1_pd(scale);
+  for (i = 0; i + kLanes <= size; i += kLanes) {
+    _mm256_storeu_pd(result + i,
+                     _mm256_mul_pd(_mm256_loadu_pd(result + i), scale_splat));
+  }
+  for (; i < size; ++i) {
+    result[i] *= scale;
+  }
+}
+
+__attribute__((target("avx512f"))) inline void softmaxAvx512(const float* data,
+                                                             size_t size,
+                                                             float* result) {
+  constexpr size_t kLanes = 16;
+  std::array<float, kLanes> lanes{};
+  size_t i = 0;
+
+  auto max_vector = _mm512_set1_ps(data[0]);
+  for (; i + kLanes <= size; i += kLanes) {
+    max_vector =
+      _mm512_maskz_max_ps(kAll16, max_vector, _mm512_loadu_ps(data + i));
+  }
+  _mm512_storeu_ps(lanes.data(), max_vector);
+  auto max = reduce(lanes, [](float a, float b) { return std::max(a, b); });
+  for (; i < size; ++i) {
+    max = std::max(max, data[i]);
+  }
+
+  const auto max_splat = _mm512_set1_ps(max);
+  auto sum_vector = _mm512_setzero_ps();
+  for (i = 0; i + kLanes <= size; i += kLanes) {
+    const auto value =
+      expAvx512(_mm512_sub_ps(_mm512_loadu_ps(data + i), max_splat));
+    _mm512_storeu_ps(result + i, value);
+    sum_vector = _mm512_add_ps(sum_vector, value);
+  }
+  _mm512_storeu_ps(lanes.data(), sum_vector);
+  auto sum = reduce(lanes, [](float a, float b) { return a + b; });
+  for (; i < size; ++i) {
+    result[i] = std::exp(data[i] - max);
+    sum += result[i];
+  }
+
+  const auto scale = 1 / sum;
+  const auto scale_splat = _mm512_set1_ps(scale);
+  for (i = 0; i + kLanes <= size; i += kLanes) {
+    _mm512_storeu_ps(result + i,
+                     _mm512_mul_ps(_mm512_loadu_ps(result + i), scale_splat));
+  }
+  for (; i < size; ++i) {
+    result[i] *= scale;
+  }
+}
+
+__attribute__((target("avx512f"))) inline void softmaxAvx512(
+  const double* data, size_t size, double* result) {
+  constexpr size_t kLanes = 8;
+  std::array<double, kLanes> lanes{};
+  size_t i = 0;
+
+  auto max_vector = _mm512_set1_pd(data[0]);
+  for (; i + kLanes <= size; i += kLanes) {
+    max_vector =
+      _mm512_maskz_max_pd(kAll8, max_vector, _mm512_loadu_pd(data + i));
+  }
+  _mm512_storeu_pd(lanes.data(), max_vector);
+  auto max = reduce(lanes, [](double a, double b) { return std::max(a, b); });
+  for (; i < size; ++i) {
+    max = std::max(max, data[i]);
+  }
+
+  const auto max_splat = _mm512_set1_pd(max);
+  auto sum_vector = _mm512_setzero_pd();
+  for (i = 0; i + kLanes <= size; i += kLanes) {
+    const auto value =
+      expAvx512(_mm512_sub_pd(_mm512_loadu_pd(data + i), max_splat));
+    _mm512_storeu_pd(result + i, value);
+    sum_vector = _mm512_add_pd(sum_vector, value);
+  }
+  _mm512_storeu_pd(lanes.data(), sum_vector);
+  auto sum = reduce(lanes, [](double a, double b) { return a + b; });
+  for (; i < size; ++i) {
+    result[i] = std::exp(data[i] - max);
+    sum += result[i];
+  }
+
+  const auto scale = 1 / sum;
+  const auto scale_splat = _mm512_set1_pd(scale);
+  for (i = 0; i + kLanes <= size; i += kLanes) {
+    _mm512_storeu_pd(result + i,
+                     _mm512_mul_pd(_mm512_loadu_pd(result + i), scale_splat));
+  }
+  for (; i < size; ++i) {
+    result[i] *= scale;
+  }
+}
+
+#endif  // AMDINFER_X86_SIMD
+
+template <typename T>
+void softmaxDispatch(const T* data, size_t size, T* result) {
+  if (size == 0) {
+    return;
+  }
+#ifdef AMDINFER_X86_SIMD
+  static const bool has_avx512 = hasAvx512();
+  static const bool has_avx2 = hasAvx2();
+  if (has_avx512) {
+    softmaxAvx512(data, size, result);
+    return;
+  }
+  if (has_avx2) {
+    softmaxAvx2(data, size, result);
+    return;
+  }
+#endif
+  softmaxScalar(data, size, result);
+}
+
+}  // namespace detail
+
+/**
+ * @brief Calculate softmax of the data. The widest SIMD instructions the CPU
+ * supports are picked at runtime.
+ *
+ * @param data pointer to the raw data
+ * @param size number of elements in the raw data
+ * @param result pointer to store the computed results. It may be the same as
+ * data
+ */
+inline void softmax(const float* data, size_t size, float* result) {
+  detail::softmaxDispatch(data, size, result);
+}
+
+/// @copydoc softmax(const float*, size_t, float*)
+inline void softmax(const double* data, size_t size, double* result) {
+  detail::softmaxDispatch(data, size, result);
+}
+
+/**
+ * @brief Calculate softmax of each row of [batch, classes] data
+ *
+ * @tparam T float or double
+ * @param data pointer to the raw data
+ * @param batch number of rows
+ * @param classes number of elements in each row
+ * @param result pointer to store the computed results. It may be the same as
+ * data
+ */
+template <typename T>
+void softmax(const T* data, size_t batch, size_t classes, T* result) {
+  static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>);
+  for (size_t i = 0; i < batch; ++i) {
+    softmax(data + (i * classes), classes, result + (i * classes));
+  }
+}
+
 /**
  * @brief Calculate softmax of the data
  *
@@ -30,22 +433,14 @@ namespace amdinfer::pre_post {
  */
 template <typename T>
 void calcSoftmax(const T* data, size_t size, double* result) {
-  double sum = 0;
-
-  auto max = data[0];
-  for (size_t i = 1; i < size; i++) {
-    if (data[i] > max) {
-      max = data[i];
+  if constexpr (std::is_same_v<T, double>) {
+    softmax(data, size, result);
+  } else {
+    // widen the data in place and run softmax over it
+    for (size_t i = 0; i < size; i++) {
+      result[i] = static_cast<double>(data[i]);
     }
-  }
-
-  for (size_t i = 0; i < size; i++) {
-    result[i] = exp(data[i] - max);
-    sum += result[i];
-  }
-
-  for (size_t i = 0; i < size; i++) {
-    result[i] /= sum;
+    softmax(result, size, result);
   }
 }
 
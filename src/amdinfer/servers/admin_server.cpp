@@ -0,0 +1,534 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the admin server
+ */
+
+#include "amdinfer/servers/admin_server.hpp"
+
+#include <netinet/in.h>  // for sockaddr_in, htonl, htons, INADDR_ANY
+#include <sys/socket.h>  // for accept4, bind, listen, recv, send
+#include <sys/time.h>    // for timeval
+#include <unistd.h>      // for close
+
+#include <algorithm>    // for min
+#include <array>        // for array
+#include <cctype>       // for isxdigit
+#include <cerrno>       // for errno, EINTR, ECONNABORTED
+#include <chrono>       // for seconds, steady_clock
+#include <cstdio>       // for snprintf
+#include <cstring>      // for strerror
+#include <map>          // for map
+#include <optional>     // for optional, nullopt
+#include <stdexcept>    // for logic_error
+#include <string>       // for string, to_string
+#include <string_view>  // for string_view
+#include <utility>      // for pair
+#include <vector>       // for vector
+
+#include "amdinfer/core/bulk_job.hpp"          // for BulkJobOptions, Bul...
+#include "amdinfer/core/exceptions.hpp"        // for runtime_error
+#include "amdinfer/core/model_repository.hpp"  // for RepositoryProgress
+#include "amdinfer/core/shared_state.hpp"      // for SharedState
+#include "amdinfer/core/worker_info.hpp"       // for EndpointState
+#include "amdinfer/observation/metrics.hpp"    // for Metrics
+#include "amdinfer/util/profiler.hpp"          // for CpuProfiler
+#include "amdinfer/util/thread.hpp"            // for setThreadName
+#include "amdinfer/workers/worker.hpp"         // for toString
+
+namespace amdinfer {
+
+/// A request to the admin server
+struct AdminRequest {
+  std::string method;
+  std::string path;
+  std::map<std::string, std::string> query;
+};
+
+namespace {
+
+/// How long to wait before accepting again after an unexpected error
+constexpr std::chrono::milliseconds kAcceptRetryDelay{10};
+/// Most bytes in a request's line and headers
+constexpr size_t kMaxRequestHead = 8192;
+/// How long a client has to send its request before it's dropped
+constexpr std::chrono::seconds kRequestTimeout{1};
+
+constexpr auto kOk = 200;
+constexpr auto kBadRequest = 400;
+constexpr auto kNotFound = 404;
+constexpr auto kMethodNotAllowed = 405;
+constexpr auto kConflict = 409;
+constexpr auto kInternalServerError = 500;
+constexpr auto kServiceUnavailable = 503;
+
+const char* reason(int status) {
+  switch (status) {
+    case kOk:
+      return "OK";
+    case kBadRequest:
+      return "Bad Request";
+    case kNotFound:
+      return "Not Found";
+    case kMethodNotAllowed:
+      return "Method Not Allowed";
+    case kConflict:
+      return "Conflict";
+    case kServiceUnavailable:
+      return "Service Unavailable";
+    default:
+      return "Internal Server Error";
+  }
+}
+
+/// Quote a string as a JSON string
+std::string quote(std::string_view text) {
+  std::string quoted{"\""};
+  for (const auto c : text) {
+    if (c == '"' || c == '\\') {
+      quoted.push_back('\\');
+      quoted.push_back(c);
+    } else if (static_cast<unsigned char>(c) < ' ') {
+      const auto kEscapeSize = sizeof("\\u0000");
+      std::array<char, kEscapeSize> escape{};
+      std::snprintf(escape.data(), escape.size(), "\\u%04x", c);
+      quoted += escape.data();
+    } else {
+      quoted.push_back(c);
+    }
+  }
+  quoted.push_back('"');
+  return quoted;
+}
+
+std::string errorBody(std::string_view error) {
+  return R"({"error":)" + quote(error) + "}";
+}
+
+/// Send a whole response and ask the client to close the connection
+void sendResponse(int fd, int status, const std::string& body,
+                  std::string_view type = "application/json") {
+  std::string message = "HTTP/1.1 " + std::to_string(status) + " " +
+                        reason(status) + "\r\nContent-Type: ";
+  message.append(type);
+  message += "\r\nContent-Length: " + std::to_string(body.size()) +
+             "\r\nConnection: close\r\n\r\n" + body;
+  size_t sent = 0;
+  while (sent < message.size()) {
+    const auto bytes = ::send(fd, message.data() + sent, message.size() - sent,
+                              MSG_NOSIGNAL);
+    if (bytes < 0 && errno == EINTR) {
+      continue;
+    }
+    if (bytes <= 0) {
+      // the client has gone so there's no one to tell
+      return;
+    }
+    sent += static_cast<size_t>(bytes);
+  }
+}
+
+/// Read the line and headers of a request, or nothing if the client is slow
+std::optional<std::string> receiveHead(int fd) {
+  const timeval timeout{kRequestTimeout.count(), 0};
+  ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  const auto deadline = std::chrono::steady_clock::now() + kRequestTimeout;
+
+  std::string head;
+  std::array<char, kMaxRequestHead> chunk;
+  while (head.find("\r\n\r\n") == std::string::npos) {
+    if (head.size() >= kMaxRequestHead ||
+        std::chrono::steady_clock::now() > deadline) {
+      return std::nullopt;
+    }
+    const auto bytes = ::recv(fd, chunk.data(), chunk.size(), 0);
+    if (bytes < 0 && errno == EINTR) {
+      continue;
+    }
+    if (bytes <= 0) {
+      return std::nullopt;
+    }
+    head.append(chunk.data(), static_cast<size_t>(bytes));
+  }
+  return head;
+}
+
+/// Decode the escapes in a query's value, such as %2F for /
+std::string decode(std::string_view value) {
+  constexpr auto kHex = 16;
+  std::string decoded;
+  decoded.reserve(value.size());
+  for (size_t i = 0; i < value.size(); ++i) {
+    if (value[i] == '+') {
+      decoded.push_back(' ');
+    } else if (value[i] == '%' && i + 2 < value.size() &&
+               std::isxdigit(static_cast<unsigned char>(value[i + 1])) != 0 &&
+               std::isxdigit(static_cast<unsigned char>(value[i + 2])) != 0) {
+      const std::string hex{value.substr(i + 1, 2)};
+      decoded.push_back(static_cast<char>(std::stoi(hex, nullptr, kHex)));
+      i += 2;
+    } else {
+      decoded.push_back(value[i]);
+    }
+  }
+  return decoded;
+}
+
+/// Parse the request line of a request, such as GET /metrics HTTP/1.1
+std::optional<AdminRequest> parseRequest(const std::string& head) {
+  const auto line = std::string_view{head}.substr(0, head.find("\r\n"));
+  const auto method_end = line.find(' ');
+  const auto target_end = line.find(' ', method_end + 1);
+  if (method_end == std::string_view::npos ||
+      target_end == std::string_view::npos) {
+    return std::nullopt;
+  }
+
+  AdminRequest request;
+  request.method = line.substr(0, method_end);
+  auto target = line.substr(method_end + 1, target_end - method_end - 1);
+  const auto query_start = target.find('?');
+  request.path = target.substr(0, query_start);
+  if (query_start == std::string_view::npos) {
+    return request;
+  }
+  auto query = target.substr(query_start + 1);
+  while (!query.empty()) {
+    const auto pair = query.substr(0, query.find('&'));
+    const auto equals = pair.find('=');
+    if (equals != std::string_view::npos) {
+      request.query.emplace(pair.substr(0, equals),
+                            decode(pair.substr(equals + 1)));
+    }
+    query.remove_prefix(std::min(pair.size() + 1, query.size()));
+  }
+  return request;
+}
+
+/// Read an integer query parameter, using the default if it's not given
+std::optional<int> getIntParameter(const AdminRequest& request,
+                                   const std::string& key, int default_value) {
+  const auto iterator = request.query.find(key);
+  if (iterator == request.query.end() || iterator->second.empty()) {
+    return default_value;
+  }
+  const auto& value = iterator->second;
+  try {
+    size_t parsed = 0;
+    const auto number = std::stoi(value, &parsed);
+    if (parsed == value.size()) {
+      return number;
+    }
+  } catch (const std::logic_error&) {
+    // an invalid number is reported by the caller
+  }
+  return std::nullopt;
+}
+
+std::string readyBody(const RepositoryProgress& progress) {
+  return R"({"models":)" + std::to_string(progress.models) +
+         R"(,"loaded":)" + std::to_string(progress.loaded) +
+         R"(,"failed":)" + std::to_string(progress.failed) + "}";
+}
+
+std::string stateBody(const std::vector<EndpointState>& states) {
+  std::string body = R"({"endpoints":[)";
+  for (const auto& state : states) {
+    if (body.back() == '}') {
+      body.push_back(',');
+    }
+    body += R"({"name":)" + quote(state.endpoint) + R"(,"input_queue":)" +
+            std::to_string(state.input_queue) + R"(,"output_queue":)" +
+            std::to_string(state.output_queue) + R"(,"in_flight_batches":)" +
+            std::to_string(state.in_flight) + R"(,"workers":[)";
+    for (const auto& [instance, status] : state.workers) {
+      if (body.back() == '}') {
+        body.push_back(',');
+      }
+      body += R"({"instance":)" + std::to_string(instance) + R"(,"status":)" +
+              quote(workers::toString(status)) + "}";
+    }
+    body += "]}";
+  }
+  return body + "]}";
+}
+
+std::string jobBody(const std::string& id, const BulkJobProgress& progress) {
+  std::string body = R"({"id":)" + quote(id) + R"(,"state":)" +
+                     quote(toString(progress.state)) + R"(,"total":)" +
+                     std::to_string(progress.total) + R"(,"submitted":)" +
+                     std::to_string(progress.submitted) + R"(,"completed":)" +
+                     std::to_string(progress.completed) + R"(,"failed":)" +
+                     std::to_string(progress.failed) + R"(,"seconds":)" +
+                     std::to_string(progress.seconds);
+  if (!progress.error.empty()) {
+    body += R"(,"error":)" + quote(progress.error);
+  }
+  return body + "}";
+}
+
+std::string jobsBody(
+  const std::vector<std::pair<std::string, BulkJobProgress>>& jobs) {
+  std::string body = R"({"jobs":[)";
+  for (const auto& [id, progress] : jobs) {
+    if (body.back() == '}') {
+      body.push_back(',');
+    }
+    body += jobBody(id, progress);
+  }
+  return body + "]}";
+}
+
+}  // namespace
+
+AdminServer::AdminServer(SharedState* state, uint16_t port,
+                         const AdminServerOptions& options)
+  : state_(state), options_(options) {
+  listener_ = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (listener_ < 0) {
+    throw runtime_error(std::string{"Could not create the admin server: "} +
+                        std::strerror(errno));
+  }
+  const int enable = 1;
+  ::setsockopt(listener_, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_ANY);
+  address.sin_port = htons(port);
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  const auto* generic = reinterpret_cast<sockaddr*>(&address);
+  if (::bind(listener_, generic, sizeof(address)) != 0 ||
+      ::listen(listener_, SOMAXCONN) != 0) {
+    const auto error = errno;
+    ::close(listener_);
+    throw runtime_error("Could not listen on port " + std::to_string(port) +
+                        ": " + std::strerror(error));
+  }
+  thread_ = std::thread{&AdminServer::serve, this};
+  AMDINFER_LOG_INFO(logger_, "Admin server listening on port " +
+                               std::to_string(port));
+}
+
+AdminServer::~AdminServer() { stop(); }
+
+void AdminServer::stop() {
+  {
+    // the lock makes sure that a waiting profile sees the change
+    std::lock_guard lock{mutex_};
+    if (!running_.exchange(false)) {
+      return;
+    }
+  }
+  stopped_.notify_all();
+  // shutting the socket down wakes the thread that's blocked on it
+  ::shutdown(listener_, SHUT_RDWR);
+  thread_.join();
+  ::close(listener_);
+  if (profile_thread_.joinable()) {
+    profile_thread_.join();
+  }
+}
+
+void AdminServer::serve() {
+  util::setThreadName("admin");
+  while (running_) {
+    const int fd = ::accept4(listener_, nullptr, nullptr, SOCK_CLOEXEC);
+    if (fd < 0) {
+      if (!running_) {
+        break;
+      }
+      if (errno != EINTR && errno != ECONNABORTED) {
+        AMDINFER_LOG_WARN(logger_, std::string{"Failed to accept: "} +
+                                     std::strerror(errno));
+        std::this_thread::sleep_for(kAcceptRetryDelay);
+      }
+      continue;
+    }
+    respond(fd);
+  }
+}
+
+void AdminServer::respond(int fd) {
+  const auto head = receiveHead(fd);
+  const auto request =
+    head.has_value() ? parseRequest(*head) : std::optional<AdminRequest>{};
+  if (!request.has_value()) {
+    if (head.has_value()) {
+      sendResponse(fd, kBadRequest, errorBody("Malformed request"));
+    }
+    ::close(fd);
+    return;
+  }
+
+  AMDINFER_LOG_DEBUG(logger_, "Received admin request for " + request->path);
+  const auto& path = request->path;
+  const auto debug = path.rfind("/v2/debug/", 0) == 0;
+  const auto jobs = path == "/v2/jobs" || path.rfind("/v2/jobs/", 0) == 0;
+  if (jobs && !options_.bulk_jobs) {
+    sendResponse(fd, kNotFound, errorBody("Bulk jobs are disabled"));
+  } else if (jobs) {
+    bulkJobs(fd, *request);
+  } else if (request->method != "GET") {
+    sendResponse(fd, kMethodNotAllowed, errorBody("Only GET is supported"));
+  } else if (path == "/v2/health/live") {
+    sendResponse(fd, kOk, "");
+  } else if (path == "/v2/health/ready") {
+    if (state_->serverReady()) {
+      sendResponse(fd, kOk, "");
+    } else {
+      sendResponse(fd, kServiceUnavailable,
+                   readyBody(state_->repositoryProgress()));
+    }
+#ifdef AMDINFER_ENABLE_METRICS
+  } else if (path == "/metrics") {
+    sendResponse(fd, kOk, Metrics::getInstance().getMetrics(),
+                 "text/plain; version=0.0.4");
+#endif
+  } else if (debug && !options_.debug_endpoints) {
+    sendResponse(fd, kNotFound, errorBody("Debugging endpoints are disabled"));
+  } else if (path == "/v2/debug/state") {
+    sendResponse(fd, kOk, stateBody(state_->endpointStates()));
+  } else if (path == "/v2/debug/profile") {
+    if (profile(fd, *request)) {
+      return;
+    }
+  } else {
+    sendResponse(fd, kNotFound, errorBody("Unknown endpoint " + path));
+  }
+  ::close(fd);
+}
+
+bool AdminServer::profile(int fd, const AdminRequest& request) {
+  const auto seconds =
+    getIntParameter(request, "seconds", util::kDefaultProfileSeconds);
+  if (!seconds.has_value() || *seconds <= 0 ||
+      *seconds > util::kMaxProfileSeconds) {
+    sendResponse(fd, kBadRequest,
+                 errorBody("The profile's seconds must be between 1 and " +
+                           std::to_string(util::kMaxProfileSeconds)));
+    return false;
+  }
+  const auto frequency =
+    getIntParameter(request, "frequency", util::kDefaultProfileFrequency);
+  if (!frequency.has_value()) {
+    sendResponse(fd, kBadRequest,
+                 errorBody("The profile's frequency must be an integer"));
+    return false;
+  }
+
+  // the last profile's thread is done, or about to be, once it has stopped
+  if (profile_thread_.joinable()) {
+    if (util::CpuProfiler::running()) {
+      sendResponse(fd, kConflict, errorBody("A profile is already running"));
+      return false;
+    }
+    profile_thread_.join();
+  }
+  try {
+    util::CpuProfiler::start(*frequency);
+  } catch (const invalid_argument& e) {
+    sendResponse(fd, kBadRequest, errorBody(e.what()));
+    return false;
+  } catch (const runtime_error& e) {
+    sendResponse(fd, kConflict, errorBody(e.what()));
+    return false;
+  }
+  profile_thread_ =
+    std::thread{&AdminServer::finishProfile, this, fd, *seconds};
+  return true;
+}
+
+void AdminServer::bulkJobs(int fd, const AdminRequest& request) {
+  const auto& method = request.method;
+  if (request.path == "/v2/jobs" && method == "GET") {
+    sendResponse(fd, kOk, jobsBody(state_->bulkJobs()));
+    return;
+  }
+  if (request.path == "/v2/jobs" && method == "POST") {
+    const auto find = [&request](const std::string& key) {
+      const auto iterator = request.query.find(key);
+      return iterator == request.query.end() ? std::string{}
+                                             : iterator->second;
+    };
+    BulkJobOptions options;
+    options.model = find("model");
+    options.input = find("input");
+    options.output = find("output");
+    if (options.model.empty() || options.input.empty() ||
+        options.output.empty()) {
+      sendResponse(fd, kBadRequest,
+                   errorBody("A job needs a model, an input and an output"));
+      return;
+    }
+    if (const auto name = find("input_name"); !name.empty()) {
+      options.input_name = name;
+    }
+    const auto in_flight = getIntParameter(
+      request, "in_flight", static_cast<int>(kDefaultBulkInFlight));
+    if (!in_flight.has_value() || *in_flight <= 0) {
+      sendResponse(fd, kBadRequest,
+                   errorBody("The job's in_flight must be a positive integer"));
+      return;
+    }
+    options.in_flight = static_cast<size_t>(*in_flight);
+    try {
+      const auto id = state_->startBulkJob(options);
+      sendResponse(fd, kOk, R"({"id":)" + quote(id) + "}");
+    } catch (const invalid_argument& e) {
+      sendResponse(fd, kBadRequest, errorBody(e.what()));
+    } catch (const file_read_error& e) {
+      sendResponse(fd, kBadRequest, errorBody(e.what()));
+    } catch (const runtime_error& e) {
+      sendResponse(fd, kInternalServerError, errorBody(e.what()));
+    }
+    return;
+  }
+
+  const std::string_view prefix{"/v2/jobs/"};
+  if (request.path.size() <= prefix.size() ||
+      (method != "GET" && method != "DELETE")) {
+    sendResponse(fd, kMethodNotAllowed,
+                 errorBody("Jobs support GET, POST and DELETE"));
+    return;
+  }
+  const auto id = request.path.substr(prefix.size());
+  try {
+    if (method == "DELETE") {
+      state_->cancelBulkJob(id);
+    }
+    sendResponse(fd, kOk, jobBody(id, state_->bulkJobProgress(id)));
+  } catch (const invalid_argument& e) {
+    sendResponse(fd, kNotFound, errorBody(e.what()));
+  }
+}
+
+void AdminServer::finishProfile(int fd, int seconds) {
+  util::setThreadName("admin");
+  {
+    std::unique_lock lock{mutex_};
+    stopped_.wait_for(lock, std::chrono::seconds(seconds),
+                      [this]() { return !running_; });
+  }
+  try {
+    sendResponse(fd, kOk, util::CpuProfiler::stop(), "text/plain");
+  } catch (const runtime_error& e) {
+    sendResponse(fd, kInternalServerError, errorBody(e.what()));
+  }
+  ::close(fd);
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,94 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the admin server, which serves the metrics, health checks and
+ * debugging endpoints apart from inference
+ */
+
+#ifndef GUARD_AMDINFER_SERVERS_ADMIN_SERVER
+#define GUARD_AMDINFER_SERVERS_ADMIN_SERVER
+
+#include <atomic>              // for atomic_bool
+#include <condition_variable>  // for condition_variable
+#include <cstdint>             // for uint16_t
+#include <mutex>               // for mutex
+#include <thread>              // for thread
+
+#include "amdinfer/build_options.hpp"        // for AMDINFER_ENABLE_LOGGING
+#include "amdinfer/observation/logging.hpp"  // for Logger
+#include "amdinfer/servers/server.hpp"       // for AdminServerOptions
+
+namespace amdinfer {
+
+class SharedState;
+struct AdminRequest;
+
+/**
+ * @brief The admin server serves the metrics, the health checks and the
+ * debugging endpoints over plain HTTP on one thread of its own. Each
+ * connection gets one response and is closed. It's kept apart from the HTTP
+ * server so scrapes and probes, which may arrive often from several parties,
+ * don't wait behind or hold up inference requests. A profile is answered from
+ * another thread once it's done so it doesn't block the other endpoints.
+ */
+class AdminServer {
+ public:
+  /**
+   * @brief Construct a new AdminServer object and start listening
+   *
+   * @param state the server's state to report on
+   * @param port the port to listen on
+   * @param options options to configure the server with
+   */
+  AdminServer(SharedState* state, uint16_t port,
+              const AdminServerOptions& options);
+  AdminServer(const AdminServer&) = delete;
+  AdminServer& operator=(const AdminServer&) = delete;
+  AdminServer(AdminServer&&) = delete;
+  AdminServer& operator=(AdminServer&&) = delete;
+  /// Destructor. It stops the server
+  ~AdminServer();
+
+  /// Stop accepting connections and cut short a running profile
+  void stop();
+
+ private:
+  void serve();
+  /// Read a request from a connection and respond to it
+  void respond(int fd);
+  /// Start a profile. It's true if the connection is left to be answered later
+  bool profile(int fd, const AdminRequest& request);
+  /// Send the profile once it's done or the server stops
+  void finishProfile(int fd, int seconds);
+  /// Start, list, get or cancel bulk jobs
+  void bulkJobs(int fd, const AdminRequest& request);
+
+  SharedState* state_;
+  AdminServerOptions options_;
+  int listener_ = -1;
+  std::atomic_bool running_ = true;
+  std::thread thread_;
+  std::thread profile_thread_;
+  std::mutex mutex_;
+  std::condition_variable stopped_;
+#ifdef AMDINFER_ENABLE_LOGGING
+  Logger logger_{Loggers::Server};
+#endif
+};
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_SERVERS_ADMIN_SERVER
@@ -20,76 +20,263 @@
 
 #include "amdinfer/servers/grpc_server.hpp"
 
+#include <google/protobuf/arena.h>               // for Arena
 #include <google/protobuf/repeated_ptr_field.h>  // for RepeatedPtrField
 #include <grpc/support/log.h>                    // for GPR_ASSERT, GPR_UNL...
 #include <grpcpp/grpcpp.h>                       // for ServerCompletionQueue
 
+#include <algorithm>      // for min
+#include <atomic>         // for atomic
 #include <cassert>        // for assert
+#include <chrono>         // for duration
 #include <cstddef>        // for size_t, byte
 #include <cstdint>        // for uint64_t, int16_t
-#include <cstring>        // for memcpy
+#include <deque>          // for deque
 #include <exception>      // for exception
 #include <memory>         // for unique_ptr, shared_ptr
+#include <mutex>          // for mutex, lock_guard
+#include <new>            // for operator new, operator delete
 #include <string>         // for allocator, string
-#include <thread>         // for thread, yield
+#include <string_view>    // for string_view
+#include <thread>         // for thread
+#include <unordered_map>  // for unordered_map
 #include <unordered_set>  // for unordered_set
-#include <utility>        // for move
+#include <utility>        // for move, forward
 #include <vector>         // for vector
 
 #include "amdinfer/buffers/buffer.hpp"           // for Buffer
 #include "amdinfer/build_options.hpp"            // for AMDINFER_ENABLE_LOG...
 #include "amdinfer/clients/grpc_internal.hpp"    // for mapProtoToParameters
+#include "amdinfer/core/bytes_tensor.hpp"        // for BytesView, getBytes...
+#include "amdinfer/core/compression.hpp"         // for CompressionOptions
 #include "amdinfer/core/data_types.hpp"          // for DataType, DataType:...
-#include "amdinfer/core/exceptions.hpp"          // for invalid_argument
+#include "amdinfer/core/exceptions.hpp"          // for invalid_argument, re...
 #include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
 #include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/core/model_repository.hpp"    // for versionEndpoint
 #include "amdinfer/core/parameters.hpp"          // for ParameterMap
 #include "amdinfer/core/request_container.hpp"   // for RequestContainer
+#include "amdinfer/core/request_timing.hpp"      // for RequestTiming
+#include "amdinfer/core/shared_memory.hpp"       // for SharedMemoryTensors
 #include "amdinfer/core/shared_state.hpp"        // for SharedState
+#include "amdinfer/core/tenant_limiter.hpp"      // for TenantTicket, Tena...
 #include "amdinfer/declarations.hpp"             // for BufferRawPtrs, Infe...
 #include "amdinfer/observation/observer.hpp"     // for Logger, Loggers
 #include "amdinfer/util/containers.hpp"          // for containerProduct
+#include "amdinfer/util/ctpl.hpp"                // for ThreadPool
 #include "amdinfer/util/string.hpp"              // for toLower
+#include "amdinfer/util/timer.hpp"               // for getTime
 #include "amdinfer/util/traits.hpp"              // IWYU pragma: keep
 #include "inference.grpc.pb.h"                   // for GRPCInferenceServic...
 #include "inference.pb.h"                        // for InferTensorContents
 
-namespace amdinfer {
-class CallDataModelInfer;
-class CallDataModelMetadata;
-class CallDataModelLoad;
-class CallDataWorkerLoad;
-class CallDataModelReady;
-class CallDataModelUnload;
-class CallDataWorkerUnload;
-class CallDataServerLive;
-class CallDataServerMetadata;
-class CallDataServerReady;
-class CallDataHasHardware;
-class CallDataModelList;
-}  // namespace amdinfer
-
 // use aliases to prevent clashes between grpc:: and amdinfer::grpc::
 using ServerBuilder = grpc::ServerBuilder;
 using ServerCompletionQueue = grpc::ServerCompletionQueue;
 template <typename T>
 using ServerAsyncResponseWriter = grpc::ServerAsyncResponseWriter<T>;
+template <typename W, typename R>
+using ServerAsyncReaderWriter = grpc::ServerAsyncReaderWriter<W, R>;
 using ServerContext = grpc::ServerContext;
+using CallbackServerContext = grpc::CallbackServerContext;
 using Server = grpc::Server;
 using StatusCode = grpc::StatusCode;
 
-// namespace inference {
-// using StreamModelInferRequest = ModelInferRequest;
-// using StreamModelInferResponse = ModelInferResponse;
-// }
-
 namespace amdinfer {
 
 using AsyncService = inference::GRPCInferenceService::AsyncService;
 
+/**
+ * @brief How inference responses are compressed. Like the server, it's global
+ * and it's set once as the server starts, before any calls are handled.
+ */
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+CompressionOptions response_compression;
+
+/// Size in bytes of the first block of each pooled arena, which it keeps
+constexpr size_t kArenaBlockSize = 16 * 1024;
+/// Most arenas kept in the pool. More are freed when they're returned
+constexpr size_t kMaxPooledArenas = 256;
+/// Request parameter that asks for a streamed response's data in chunks
+constexpr auto kChunkBytes = "chunk_bytes";
+/// Response parameter set on the metadata that the chunks of data follow
+constexpr auto kChunked = "chunked";
+
+/**
+ * @brief An arena that starts on a block of its own. The block is kept when
+ * the arena is reset so a reused arena serves small calls without allocating.
+ */
+class PooledArena {
+ public:
+  PooledArena()
+    : block_(std::make_unique<char[]>(kArenaBlockSize)),
+      arena_(makeOptions(block_.get())) {}
+
+  google::protobuf::Arena* get() { return &arena_; }
+
+  /// Free everything allocated on the arena except its first block
+  void reset() { arena_.Reset(); }
+
+ private:
+  static google::protobuf::ArenaOptions makeOptions(char* block) {
+    google::protobuf::ArenaOptions options;
+    options.initial_block = block;
+    options.initial_block_size = kArenaBlockSize;
+    return options;
+  }
+
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays)
+  std::unique_ptr<char[]> block_;
+  google::protobuf::Arena arena_;
+};
+
+/**
+ * @brief Arenas to allocate the messages of calls on. Each call takes an arena
+ * from the pool and its messages are freed at once when the arena's returned,
+ * rather than field by field.
+ */
+class ArenaPool {
+ public:
+  /// Returns an arena to the pool when its call is done
+  class Release {
+   public:
+    explicit Release(ArenaPool* pool) : pool_(pool) {}
+    void operator()(PooledArena* arena) const { pool_->put(arena); }
+
+   private:
+    ArenaPool* pool_;
+  };
+  using Ptr = std::unique_ptr<PooledArena, Release>;
+
+  /// Get an arena, reusing a returned one if there is one
+  Ptr get() {
+    {
+      std::lock_guard lock{mutex_};
+      if (!arenas_.empty()) {
+        auto* arena = arenas_.back().release();
+        arenas_.pop_back();
+        return Ptr{arena, Release{this}};
+      }
+    }
+    return Ptr{new PooledArena, Release{this}};
+  }
+
+ private:
+  void put(PooledArena* arena) {
+    std::unique_ptr<PooledArena> owned{arena};
+    // reset outside the lock as it runs the destructors of the messages
+    owned->reset();
+    std::lock_guard lock{mutex_};
+    if (arenas_.size() < kMaxPooledArenas) {
+      arenas_.push_back(std::move(owned));
+    }
+  }
+
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<PooledArena>> arenas_;
+};
+
+/**
+ * @brief The arenas of the server's calls. It's global, rather than a member of
+ * the server, so it outlives any calls still pending as the server is destroyed
+ */
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+ArenaPool arena_pool;
+
+/// Most freed calls of each size whose memory is kept for new calls
+constexpr size_t kMaxPooledCalls = 1024;
+
+/**
+ * @brief Keeps the memory of finished calls for new ones. gRPC doesn't allow a
+ * call's context to serve another RPC so each RPC still constructs its call,
+ * but the one posted to replace a call that started reuses a finished one's
+ * memory instead of allocating. Like the arena pool, it's global so it
+ * outlives the calls.
+ */
+class CallPool {
+ public:
+  CallPool() = default;
+  CallPool(const CallPool&) = delete;
+  CallPool& operator=(const CallPool&) = delete;
+  CallPool(CallPool&&) = delete;
+  CallPool& operator=(CallPool&&) = delete;
+  ~CallPool() {
+    for (auto& [size, blocks] : blocks_) {
+      for (auto* block : blocks) {
+        ::operator delete(block);
+      }
+    }
+  }
+
+  /// Get memory for a call, reusing a freed call's if there is one
+  void* get(size_t size) {
+    {
+      std::lock_guard lock{mutex_};
+      auto& blocks = blocks_[size];
+      if (!blocks.empty()) {
+        auto* block = blocks.back();
+        blocks.pop_back();
+        return block;
+      }
+    }
+    return ::operator new(size);
+  }
+
+  /// Keep the memory of a destroyed call for the next one of its size
+  void put(void* block, size_t size) {
+    {
+      std::lock_guard lock{mutex_};
+      auto& blocks = blocks_[size];
+      if (blocks.size() < kMaxPooledCalls) {
+        blocks.push_back(block);
+        return;
+      }
+    }
+    ::operator delete(block);
+  }
+
+ private:
+  std::mutex mutex_;
+  std::unordered_map<size_t, std::vector<void*>> blocks_;
+};
+
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+CallPool call_pool;
+
+/**
+ * @brief Admit a call under its tenant's limits, if there are any. The tenant
+ * is named by the call's metadata and the call is sized by its message
+ *
+ * @param state the server's state
+ * @param context the call's context
+ * @param message the call's message
+ * @return TenantTicket the call's ticket, which may be rejected
+ */
+template <typename Message>
+TenantTicket admitTenant(SharedState* state,
+                         const ::grpc::ServerContextBase& context,
+                         const Message& message) {
+  auto* limiter = state->getTenantLimiter();
+  if (limiter == nullptr) {
+    return {};
+  }
+  const auto& metadata = context.client_metadata();
+  std::string_view tenant;
+  if (auto found = metadata.find(limiter->header()); found != metadata.end()) {
+    tenant = {found->second.data(), found->second.size()};
+  }
+  return limiter->admit(tenant, message.ByteSizeLong());
+}
+
 class CallDataBase {
  public:
-  virtual void proceed() = 0;
+  /**
+   * @brief Handle an event from the completion queue for this tag
+   *
+   * @param ok false if the operation failed e.g. the call was cancelled, the
+   * client closed its side of a stream or the server is shutting down
+   */
+  virtual void proceed(bool ok) = 0;
 };
 
 template <typename RequestType, typename ReplyType>
@@ -98,36 +285,91 @@ class CallData : public CallDataBase {
   // Take in the "service" instance (in this case representing an asynchronous
   // server) and the completion queue "cq" used for asynchronous communication
   // with the gRPC runtime.
-  CallData(AsyncService* service, ::grpc::ServerCompletionQueue* cq)
-    : service_(service), cq_(cq), status_(Create) {}
+  CallData(AsyncService* service, ::grpc::ServerCompletionQueue* cq,
+           SharedState* state)
+    : service_(service),
+      cq_(cq),
+      state_(state),
+      arena_(arena_pool.get()),
+      request_(*google::protobuf::Arena::CreateMessage<RequestType>(
+        arena_->get())),
+      reply_(
+        *google::protobuf::Arena::CreateMessage<ReplyType>(arena_->get())),
+      status_(Create) {}
 
   virtual ~CallData() = default;
 
-  void proceed() override {
+  // calls are created and deleted for every RPC so their memory is pooled
+  static void* operator new(size_t size) { return call_pool.get(size); }
+  static void operator delete(void* block, size_t size) {
+    call_pool.put(block, size);
+  }
+
+  void proceed(bool ok) override {
     if (status_ == Create) {
       // Make this instance progress to the Process state.
       status_ = Process;
 
+      // gRPC says when the call is done, which is as soon as the client
+      // cancels it or its deadline passes, but only if the call starts
+      ctx_.AsyncNotifyWhenDone(&done_tag_);
       waitForRequest();
     } else if (status_ == Process) {
+      if (!ok) {
+        // the call never started so there's nothing to respond to
+        delete this;
+        return;
+      }
       addNewCallData();
 
-      // queue_->enqueue(this);
-      // status_ = Wait;
-      handleRequest();
+      // the call may be finished, and so deleted, from another thread before
+      // handleRequest() returns so nothing may be touched after it
       status_ = Wait;
-    } else if (status_ == Wait) {
-      std::this_thread::yield();
+      handleRequest();
     } else {
+      // the only event after the request arrives is the one from finishing it
       assert(status_ == Finish);
-      // Once in the Finish state, deallocate ourselves (CallData).
-      delete this;
+      release();
     }
   }
 
   virtual void finish(const ::grpc::Status& status) = 0;
 
  protected:
+  /// Start the call by waiting for a request
+  void start() { proceed(true); }
+
+  /**
+   * @brief Let the batchers drop the call's request if the client cancels it
+   * or its deadline passes while it's queued
+   *
+   * @param container the call's request
+   */
+  void watchCancellation(RequestContainer* container) const {
+    container->cancelled = &cancelled_;
+    container->deadline = std::min(container->deadline, ctx_.deadline());
+  }
+
+  void setCompression(grpc_compression_algorithm algorithm) {
+    ctx_.set_compression_algorithm(algorithm);
+  }
+
+  /**
+   * @brief Admit the call under its tenant's limits. A call that's turned away
+   * is finished with RESOURCE_EXHAUSTED and mustn't be touched afterwards
+   *
+   * @return bool true if the call was admitted
+   */
+  bool admit() {
+    ticket_ = admitTenant(state_, ctx_, request_);
+    if (!ticket_.rejected()) {
+      return true;
+    }
+    finish(::grpc::Status(StatusCode::RESOURCE_EXHAUSTED,
+                          toString(ticket_.rejection())));
+    return false;
+  }
+
   // When we handle a request of this type, we need to tell
   // the completion queue to wait for new requests of the same type.
   virtual void addNewCallData() = 0;
@@ -144,15 +386,48 @@ class CallData : public CallDataBase {
   // of compression, authentication, as well as to send metadata back to the
   // client.
   ::grpc::ServerContext ctx_;
+  SharedState* state_;
+  // The arena that the messages are allocated on
+  ArenaPool::Ptr arena_;
 
   // What we get from the client.
-  RequestType request_;
+  RequestType& request_;
   // What we send back to the client.
-  ReplyType reply_;
+  ReplyType& reply_;
 
   // Let's implement a tiny state machine with the following states.
   enum CallStatus { Create, Process, Wait, Finish };
   CallStatus status_;  // The current serving state.
+  /// the call's place in its tenant's calls in flight until it's finished
+  TenantTicket ticket_;
+
+ private:
+  /// Forwards the event of the call being done to the call
+  class DoneTag : public CallDataBase {
+   public:
+    explicit DoneTag(CallData* call) : call_(call) {}
+    void proceed([[maybe_unused]] bool ok) override {
+      call_->cancelled_.store(call_->ctx_.IsCancelled(),
+                              std::memory_order_release);
+      call_->release();
+    }
+
+   private:
+    CallData* call_;
+  };
+
+  /// Delete the call once it's been finished and gRPC says that it's done, in
+  /// either order
+  void release() {
+    if (events_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      delete this;
+    }
+  }
+
+  DoneTag done_tag_{this};
+  std::atomic<bool> cancelled_ = false;
+  /// the finish and done events that are left once the call has started
+  std::atomic<int> events_ = 2;
 };
 
 template <typename RequestType, typename ReplyType>
@@ -161,14 +436,17 @@ class CallDataUnary : public CallData<RequestType, ReplyType> {
   // Take in the "service" instance (in this case representing an asynchronous
   // server) and the completion queue "cq" used for asynchronous communication
   // with the gRPC runtime.
-  CallDataUnary(AsyncService* service, ::grpc::ServerCompletionQueue* cq)
-    : CallData<RequestType, ReplyType>(service, cq), responder_(&this->ctx_) {}
+  CallDataUnary(AsyncService* service, ::grpc::ServerCompletionQueue* cq,
+                SharedState* state)
+    : CallData<RequestType, ReplyType>(service, cq, state),
+      responder_(&this->ctx_) {}
 
   void finish(const ::grpc::Status& status) override {
     // And we are done! Let the gRPC runtime know we've finished, using the
     // memory address of this instance as the uniquely identifying tag for
     // the event.
     this->status_ = this->Finish;
+    this->ticket_.release();
     responder_.Finish(this->reply_, status, this);
   }
 
@@ -177,107 +455,185 @@ class CallDataUnary : public CallData<RequestType, ReplyType> {
   ::grpc::ServerAsyncResponseWriter<ReplyType> responder_;
 };
 
+/**
+ * @brief A unary call on the callback API. gRPC owns the request and the reply
+ * and the call deletes itself once gRPC is done with it, after it's finished.
+ * There's no state machine as gRPC only calls back once the call is done.
+ */
 template <typename RequestType, typename ReplyType>
-class CallDataServerStream : public CallData<RequestType, ReplyType> {
+class CallbackUnary : public ::grpc::ServerUnaryReactor {
  public:
-  // Take in the "service" instance (in this case representing an asynchronous
-  // server) and the completion queue "cq" used for asynchronous communication
-  // with the gRPC runtime.
-  CallDataServerStream(AsyncService* service, ::grpc::ServerCompletionQueue* cq)
-    : CallData<RequestType, ReplyType>(service, cq), responder_(&this->ctx_) {}
+  CallbackUnary(CallbackServerContext* context, const RequestType* request,
+                ReplyType* reply, SharedState* state)
+    : context_(context), request_(*request), reply_(*reply), state_(state) {}
 
-  void write(const ReplyType& response) { responder_->Write(response, this); }
+  /// Handle the call. It may be finished later from another thread
+  void run() { handleRequest(); }
 
-  void finish(const ::grpc::Status& status) override {
-    // And we are done! Let the gRPC runtime know we've finished, using the
-    // memory address of this instance as the uniquely identifying tag for
-    // the event.
-    this->status_ = this->Finish;
-    responder_.Finish(this->reply_, status, this);
+  void finish(const ::grpc::Status& status) {
+    ticket_.release();
+    this->Finish(status);
+  }
+
+  void OnDone() override { delete this; }
+
+  void OnCancel() override {
+    cancelled_.store(true, std::memory_order_release);
   }
 
  protected:
-  // The means to get back to the client.
-  ::grpc::ServerAsyncWriter<ReplyType> responder_;
+  /// Calls are run by the service once they're constructed
+  void start() {}
+
+  /**
+   * @brief Let the batchers drop the call's request if the client cancels it
+   * or its deadline passes while it's queued
+   *
+   * @param container the call's request
+   */
+  void watchCancellation(RequestContainer* container) const {
+    container->cancelled = &cancelled_;
+    container->deadline = std::min(container->deadline, context_->deadline());
+  }
+
+  void setCompression(grpc_compression_algorithm algorithm) {
+    context_->set_compression_algorithm(algorithm);
+  }
+
+  /**
+   * @brief Admit the call under its tenant's limits. A call that's turned away
+   * is finished with RESOURCE_EXHAUSTED and mustn't be touched afterwards
+   *
+   * @return bool true if the call was admitted
+   */
+  bool admit() {
+    ticket_ = admitTenant(state_, *context_, request_);
+    if (!ticket_.rejected()) {
+      return true;
+    }
+    finish(::grpc::Status(StatusCode::RESOURCE_EXHAUSTED,
+                          toString(ticket_.rejection())));
+    return false;
+  }
+
+  virtual void handleRequest() noexcept = 0;
+
+  CallbackServerContext* context_;
+  const RequestType& request_;
+  ReplyType& reply_;
+  SharedState* state_;
+
+ private:
+  std::atomic<bool> cancelled_ = false;
+  /// the call's place in its tenant's calls in flight until it's finished
+  TenantTicket ticket_;
 };
 
-struct WriteData {
-  template <typename T, typename Tensor>
-  void operator()(Buffer* buffer, Tensor* tensor, size_t offset, size_t size,
-                  [[maybe_unused]] const Observer& observer) const {
-    auto* contents = getTensorContents<T>(tensor);
-    if constexpr (util::is_any_v<T, bool, uint32_t, uint64_t, int32_t, int64_t,
-                                 float, double, char>) {
-      auto* dest = static_cast<std::byte*>(buffer->data(offset));
-      std::memcpy(dest, contents, size * sizeof(T));
-    } else if constexpr (util::is_any_v<T, uint8_t, uint16_t, int8_t, int16_t,
-                                        fp16>) {
-      for (size_t i = 0; i < size; i++) {
-#ifdef AMDINFER_ENABLE_LOGGING
-        if (const auto min_size = size > kNumTraceData ? kNumTraceData : size;
-            i < min_size) {
-          AMDINFER_LOG_TRACE(observer.logger,
-                             "Writing data to buffer: " +
-                               std::to_string(static_cast<T>(contents[i])));
-        }
-#endif
-        offset = buffer->write(static_cast<T>(contents[i]), offset);
-      }
-    } else {
-      static_assert(!sizeof(T), "Invalid type to WriteData");
+using InputTensor = inference::ModelInferRequest_InferInputTensor;
+/// Writes the typed contents of a proto tensor into a buffer
+using TensorWriter = void (*)(Buffer* buffer, const InputTensor& tensor,
+                              size_t offset, size_t size);
+
+template <typename T>
+void writeTensor(Buffer* buffer, const InputTensor& tensor, size_t offset,
+                 size_t size) {
+  if constexpr (std::is_same_v<T, char>) {
+    // string tensors are written from their bytes, up to the tensor's size
+    for (const auto& bytes : tensor.contents().bytes_contents()) {
+      const auto count = std::min(bytes.size(), size);
+      offset = buffer->write(bytes.data(), offset, count);
+      size -= count;
     }
+  } else {
+    // narrow types are stored in wider proto fields so they're converted in
+    // bulk as they're written
+    buffer->writeAs<T>(getTensorContents<T>(&tensor), offset, size);
+  }
+}
+
+/// Resolves the writer for a datatype once, when the request is parsed
+struct GetTensorWriter {
+  template <typename T>
+  TensorWriter operator()() const {
+    return &writeTensor<T>;
   }
 };
 
+// Each endpoint's handler is written once and templated on its base so it can
+// run on either API: CallData##endpoint polls a completion queue and
+// Callback##endpoint is a reactor of the callback API. addNewCallData() and
+// waitForRequest() are only used, and so only instantiated, by the former.
 #ifdef AMDINFER_ENABLE_LOGGING
 // NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
-#define CALLDATA_IMPL(endpoint, type)                                      \
-  class CallData##endpoint                                                 \
-    : public CallData##type<inference::endpoint##Request,                  \
-                            inference::endpoint##Response> {               \
-   public:                                                                 \
-    CallData##endpoint(AsyncService* service, ServerCompletionQueue* cq,   \
-                       SharedState* state)                                 \
-      : CallData##type(service, cq), state_(state) {                       \
-      proceed();                                                           \
-    }                                                                      \
-                                                                           \
-   private:                                                                \
-    Logger logger_{Loggers::Server};                                       \
-    SharedState* state_;                                                   \
-                                                                           \
-   protected:                                                              \
-    void addNewCallData() override {                                       \
-      new CallData##endpoint(service_, cq_, state_);                       \
-    }                                                                      \
-    void waitForRequest() override {                                       \
-      service_->Request##endpoint(&ctx_, &request_, &responder_, cq_, cq_, \
-                                  this);                                   \
-    }                                                                      \
+#define CALLDATA_IMPL(endpoint, type)                                          \
+  template <typename Base>                                                     \
+  class Handler##endpoint;                                                     \
+  using CallData##endpoint =                                                   \
+    Handler##endpoint<CallData##type<inference::endpoint##Request,             \
+                                     inference::endpoint##Response>>;          \
+  using Callback##endpoint =                                                   \
+    Handler##endpoint<Callback##type<inference::endpoint##Request,             \
+                                     inference::endpoint##Response>>;          \
+  template <typename Base>                                                     \
+  class Handler##endpoint final : public Base {                                \
+   public:                                                                     \
+    template <typename... Args>                                                \
+    explicit Handler##endpoint(Args&&... args)                                 \
+      : Base(std::forward<Args>(args)...) {                                    \
+      this->start();                                                           \
+    }                                                                          \
+    using Base::finish;                                                        \
+                                                                               \
+   private:                                                                    \
+    using Base::reply_;                                                        \
+    using Base::request_;                                                      \
+    using Base::state_;                                                        \
+    Logger logger_{Loggers::Server};                                           \
+                                                                               \
+   protected:                                                                  \
+    void addNewCallData() {                                                    \
+      new Handler##endpoint(this->service_, this->cq_, state_);                \
+    }                                                                          \
+    void waitForRequest() {                                                    \
+      this->service_->Request##endpoint(&this->ctx_, &this->request_,          \
+                                        &this->responder_, this->cq_,          \
+                                        this->cq_, this);                      \
+    }                                                                          \
     void handleRequest() noexcept override
 #else
-#define CALLDATA_IMPL(endpoint, type)                                      \
-  class CallData##endpoint                                                 \
-    : public CallData##type<inference::endpoint##Request,                  \
-                            inference::endpoint##Response> {               \
-   public:                                                                 \
-    CallData##endpoint(AsyncService* service, ServerCompletionQueue* cq,   \
-                       SharedState* state)                                 \
-      : CallData##type(service, cq), state_(state) {                       \
-      proceed();                                                           \
-    }                                                                      \
-                                                                           \
-   private:                                                                \
-    SharedState* state_;                                                   \
-                                                                           \
-   protected:                                                              \
-    void addNewCallData() override {                                       \
-      new CallData##endpoint(service_, cq_, state_);                       \
-    }                                                                      \
-    void waitForRequest() override {                                       \
-      service_->Request##endpoint(&ctx_, &request_, &responder_, cq_, cq_, \
-                                  this);                                   \
-    }                                                                      \
+#define CALLDATA_IMPL(endpoint, type)                                          \
+  template <typename Base>                                                     \
+  class Handler##endpoint;                                                     \
+  using CallData##endpoint =                                                   \
+    Handler##endpoint<CallData##type<inference::endpoint##Request,             \
+                                     inference::endpoint##Response>>;          \
+  using Callback##endpoint =                                                   \
+    Handler##endpoint<Callback##type<inference::endpoint##Request,             \
+                                     inference::endpoint##Response>>;          \
+  template <typename Base>                                                     \
+  class Handler##endpoint final : public Base {                                \
+   public:                                                                     \
+    template <typename... Args>                                                \
+    explicit Handler##endpoint(Args&&... args)                                 \
+      : Base(std::forward<Args>(args)...) {                                    \
+      this->start();                                                           \
+    }                                                                          \
+    using Base::finish;                                                        \
+                                                                               \
+   private:                                                                    \
+    using Base::reply_;                                                        \
+    using Base::request_;                                                      \
+    using Base::state_;                                                        \
+                                                                               \
+   protected:                                                                  \
+    void addNewCallData() {                                                    \
+      new Handler##endpoint(this->service_, this->cq_, state_);                \
+    }                                                                          \
+    void waitForRequest() {                                                    \
+      this->service_->Request##endpoint(&this->ctx_, &this->request_,          \
+                                        &this->responder_, this->cq_,          \
+                                        this->cq_, this);                      \
+    }                                                                          \
     void handleRequest() noexcept override
 #endif
 
@@ -294,11 +650,47 @@ const inference::ModelInferRequest& getRequest() const {
 }
 
 inference::ModelInferResponse& getReply() { return this->reply_; }
+
+/// Compress the reply, if it's large enough, before it's finished
+void compressReply() {
+  const auto algorithm = getCompressionAlgorithm(response_compression,
+                                                 this->reply_.ByteSizeLong());
+  if (algorithm != GRPC_COMPRESS_NONE) {
+    this->setCompression(algorithm);
+  }
+}
 CALLDATA_IMPL_END
 
+
+/// BYTES tensors are sized by their elements rather than their shape so the
+/// request's shape is checked against them and replaced with their size
+void addBytesInput(const InputTensor& req, const std::string* raw,
+                   InferenceRequestInput* input, RequestContainer* container) {
+  if (raw != nullptr) {
+    // raw contents are already in the tensor's layout
+    checkBytesShape(BytesView{raw->data(), raw->size()}.size(),
+                    input->getShape(), req.name());
+    input->setShape({raw->size()});
+    container->input_writers.emplace_back(
+      [raw](Buffer* buffer, size_t offset) {
+        buffer->write(raw->data(), offset, raw->size());
+      });
+    container->input_views.push_back(raw->data());
+    return;
+  }
+  const auto& contents = req.contents().bytes_contents();
+  checkBytesShape(contents.size(), input->getShape(), req.name());
+  input->setShape({getBytesSize(contents)});
+  container->input_writers.emplace_back(
+    [&contents](Buffer* buffer, size_t offset) {
+      buffer->writeBytes(contents, offset);
+    });
+}
+
 InferenceRequestInput getInput(
   const inference::ModelInferRequest_InferInputTensor& req,
-  const MemoryPool* pool) {
+  const std::string* raw, RequestContainer* container,
+  SharedMemoryTensors* shared_memory) {
   Observer observer;
   AMDINFER_IF_LOGGING(observer.logger = Logger{Loggers::Server});
 
@@ -318,17 +710,45 @@ InferenceRequestInput getInput(
 
   input.setParameters(mapProtoToParameters(req.parameters()));
 
-  auto size = input.getSize();
-  auto buffer = pool->get({MemoryAllocators::Cpu}, input, 1);
-  input.setData(buffer->data(0));
-  // auto* dest = static_cast<std::byte*>(input_buffer->data(offset));
-  AMDINFER_LOG_TRACE(observer.logger, "Writing " + std::to_string(size) +
-                                        " elements of type " +
-                                        input.getDatatype().str() + " to " +
-                                        util::addressToString(buffer->data(0)));
-
-  switchOverTypes(WriteData(), input.getDatatype(), buffer.get(), &req, 0, size,
-                  observer);
+  // the data stays in the proto until the batcher has reserved space for it in
+  // the batch buffer so it's only copied once. The proto is owned by the
+  // CallData object, which outlives the request
+  input.setData(nullptr);
+  if (input.getDatatype() == DataType::Bytes) {
+    addBytesInput(req, raw, &input, container);
+    return input;
+  }
+  if (shared_memory->addInput(input, container)) {
+    return input;
+  }
+  if (raw != nullptr) {
+    const auto bytes = input.getSize() * input.getDatatype().size();
+    if (raw->size() != bytes) {
+      throw invalid_argument("Raw contents of input " + req.name() + " have " +
+                             std::to_string(raw->size()) + " bytes, expected " +
+                             std::to_string(bytes));
+    }
+    // raw contents are already in the tensor's memory layout so they're
+    // copied in one go or read in place
+    container->input_writers.emplace_back(
+      [raw, bytes](Buffer* buffer, size_t offset) {
+        buffer->write(raw->data(), offset, bytes);
+      });
+    container->input_views.push_back(raw->data());
+    return input;
+  }
+  container->input_writers.emplace_back(
+    [&req, write = switchOverTypes(GetTensorWriter(), input.getDatatype()),
+     datatype = input.getDatatype(),
+     size = input.getSize()](Buffer* buffer, size_t offset) {
+      [[maybe_unused]] Observer observer;
+      AMDINFER_IF_LOGGING(observer.logger = Logger{Loggers::Server});
+      AMDINFER_LOG_TRACE(observer.logger,
+                         "Writing " + std::to_string(size) +
+                           " elements of type " + datatype.str() + " to " +
+                           util::addressToString(buffer->data(offset)));
+      write(buffer, req, offset, size);
+    });
 
   return input;
 }
@@ -342,15 +762,37 @@ InferenceRequestOutput getOutput(
   return output;
 }
 
-void setCallback(InferenceRequest* request, CallDataModelInfer* calldata) {
-  Callback callback = [calldata](const InferenceResponse& response) {
+template <typename Call>
+void setCallback(InferenceRequest* request, Call* calldata,
+                 SharedMemoryTensors shared_memory, RequestTimingPtr timing) {
+  // reply in the same encoding the client used
+  const auto raw = !calldata->getRequest().raw_input_contents().empty();
+  ResponseCallback callback = [calldata, raw,
+                               shared_memory = std::move(shared_memory),
+                               timing = std::move(timing)](
+                                const InferenceResponse& response) {
     if (response.isError()) {
       calldata->finish(
         ::grpc::Status(StatusCode::UNKNOWN, response.getError()));
       return;
     }
     try {
-      mapResponseToProto(response, calldata->getReply());
+#ifdef AMDINFER_ENABLE_METRICS
+      const auto start = util::getTime();
+#endif
+      mapResponseToProto(response, calldata->getReply(), raw, &shared_memory);
+      if (timing != nullptr) {
+        mapParametersToProto(timing->parameters(),
+                             calldata->getReply().mutable_parameters());
+      }
+      calldata->compressReply();
+#ifdef AMDINFER_ENABLE_METRICS
+      const std::chrono::duration<double, std::micro> duration =
+        util::getTime() - start;
+      Metrics::getInstance().observeHistogram(
+        MetricHistogramIDs::ResponseSerialization,
+        calldata->getRequest().model_name(), duration.count());
+#endif
     } catch (const invalid_argument& e) {
       calldata->finish(::grpc::Status(StatusCode::UNKNOWN, e.what()));
       return;
@@ -365,8 +807,10 @@ void setCallback(InferenceRequest* request, CallDataModelInfer* calldata) {
   request->setCallback(std::move(callback));
 }
 
+
 InferenceRequestPtr getRequest(const inference::ModelInferRequest& grpc_request,
-                               const MemoryPool* pool) {
+                               RequestContainer* container,
+                               SharedMemoryTensors* shared_memory) {
   [[maybe_unused]] Observer observer;
   AMDINFER_IF_LOGGING(observer.logger = Logger{Loggers::Server});
 
@@ -381,8 +825,36 @@ InferenceRequestPtr getRequest(const inference::ModelInferRequest& grpc_request,
 
   request->setCallback(nullptr);
 
+  // as in KServe, if raw contents are used, they're used for all the inputs
+  // that aren't in shared memory
+  const auto& raw_contents = grpc_request.raw_input_contents();
+  const auto use_raw = !raw_contents.empty();
+  auto in_shared_memory =
+    [](const inference::ModelInferRequest_InferInputTensor& input) {
+      return input.parameters().count(kSharedMemoryRegion) != 0;
+    };
+  auto raw_inputs = 0;
   for (const auto& input : grpc_request.inputs()) {
-    request->addInputTensor(getInput(input, pool));
+    raw_inputs += in_shared_memory(input) ? 0 : 1;
+  }
+  if (use_raw && raw_contents.size() != raw_inputs) {
+    throw invalid_argument("Expected raw contents for " +
+                           std::to_string(raw_inputs) + " inputs, got " +
+                           std::to_string(raw_contents.size()));
+  }
+
+  container->input_writers.reserve(grpc_request.inputs_size());
+  container->input_views.reserve(grpc_request.inputs_size());
+  auto raw_index = 0;
+  for (const auto& input : grpc_request.inputs()) {
+    const auto* raw = use_raw && !in_shared_memory(input)
+                        ? &raw_contents.Get(raw_index++)
+                        : nullptr;
+    request->addInputTensor(getInput(input, raw, container, shared_memory));
+  }
+  // inputs can only be read in place if they all can be
+  if (container->input_views.size() != container->input_writers.size()) {
+    container->input_views.clear();
   }
 
   if (grpc_request.outputs_size() != 0) {
@@ -390,17 +862,19 @@ InferenceRequestPtr getRequest(const inference::ModelInferRequest& grpc_request,
       request->addOutputTensor(getOutput(output));
     }
   }
+  shared_memory->addOutputs(*request);
 
   return request;
 }
 
-// CALLDATA_IMPL(StreamModelInfer, ServerStream);
-
-//  public:
-//   const inference::ModelInferRequest& getRequest() const {
-//     return this->request_;
-//   }
-// CALLDATA_IMPL_END
+/// Get the endpoint that serves a version of a model, or the model itself if
+/// the version is empty
+std::string getEndpoint(const std::string& model, const std::string& version) {
+  if (version.empty()) {
+    return model;
+  }
+  return versionEndpoint(model, version);
+}
 
 void grpcUnaryCallback(CallDataModelInfer* calldata,
                        const InferenceResponse& response) {
@@ -429,13 +903,13 @@ CALLDATA_IMPL(ServerLive, Unary) {
 CALLDATA_IMPL_END
 
 CALLDATA_IMPL(ServerReady, Unary) {
-  reply_.set_ready(true);
+  reply_.set_ready(state_->serverReady());
   finish(::grpc::Status::OK);
 }
 CALLDATA_IMPL_END
 
 CALLDATA_IMPL(ModelReady, Unary) {
-  const auto& model = request_.name();
+  const auto model = getEndpoint(request_.name(), request_.version());
   try {
     reply_.set_ready(state_->modelReady(model));
     finish(::grpc::Status::OK);
@@ -450,7 +924,7 @@ CALLDATA_IMPL(ModelReady, Unary) {
 CALLDATA_IMPL_END
 
 CALLDATA_IMPL(ModelMetadata, Unary) {
-  const auto& model = request_.name();
+  const auto model = getEndpoint(request_.name(), request_.version());
   try {
     auto metadata = state_->modelMetadata(model);
     mapModelMetadataToProto(metadata, reply_);
@@ -486,10 +960,9 @@ CALLDATA_IMPL_END
 CALLDATA_IMPL(ModelLoad, Unary) {
   auto parameters = mapProtoToParameters(request_.parameters());
 
-  auto* model = request_.mutable_name();
-  util::toLower(model);
+  const auto model = util::toLower(request_.name());
   try {
-    state_->modelLoad(*model, parameters);
+    state_->modelLoad(model, parameters);
   } catch (const runtime_error& e) {
     AMDINFER_LOG_ERROR(logger_, e.what());
     finish(::grpc::Status(StatusCode::NOT_FOUND, e.what()));
@@ -504,9 +977,8 @@ CALLDATA_IMPL(ModelLoad, Unary) {
 CALLDATA_IMPL_END
 
 CALLDATA_IMPL(ModelUnload, Unary) {
-  auto* model = request_.mutable_name();
-  util::toLower(model);
-  state_->modelUnload(*model);
+  const auto model = util::toLower(request_.name());
+  state_->modelUnload(model);
   finish(::grpc::Status::OK);
 }
 CALLDATA_IMPL_END
@@ -514,11 +986,10 @@ CALLDATA_IMPL_END
 CALLDATA_IMPL(WorkerLoad, Unary) {
   auto parameters = mapProtoToParameters(request_.parameters());
 
-  auto* model = request_.mutable_name();
-  util::toLower(model);
+  const auto model = util::toLower(request_.name());
 
   try {
-    auto endpoint = state_->workerLoad(*model, parameters);
+    auto endpoint = state_->workerLoad(model, parameters);
     reply_.set_endpoint(endpoint);
     finish(::grpc::Status::OK);
   } catch (const runtime_error& e) {
@@ -532,9 +1003,8 @@ CALLDATA_IMPL(WorkerLoad, Unary) {
 CALLDATA_IMPL_END
 
 CALLDATA_IMPL(WorkerUnload, Unary) {
-  auto* worker = request_.mutable_name();
-  util::toLower(worker);
-  state_->workerUnload(*worker);
+  const auto worker = util::toLower(request_.name());
+  state_->workerUnload(worker);
   finish(::grpc::Status::OK);
 }
 CALLDATA_IMPL_END
@@ -546,8 +1016,104 @@ CALLDATA_IMPL(HasHardware, Unary) {
 }
 CALLDATA_IMPL_END
 
-void CallDataModelInfer::handleRequest() noexcept {
-  const auto& model = request_.model_name();
+CALLDATA_IMPL(SystemSharedMemoryStatus, Unary) {
+  try {
+    const auto regions = state_->getSharedMemory()->status(request_.name());
+    auto* statuses = reply_.mutable_regions();
+    for (const auto& region : regions) {
+      auto& status = (*statuses)[region.name];
+      status.set_name(region.name);
+      status.set_key(region.key);
+      status.set_offset(region.offset);
+      status.set_byte_size(region.byte_size);
+    }
+  } catch (const invalid_argument& e) {
+    finish(::grpc::Status(StatusCode::NOT_FOUND, e.what()));
+    return;
+  }
+  finish(::grpc::Status::OK);
+}
+CALLDATA_IMPL_END
+
+CALLDATA_IMPL(SystemSharedMemoryRegister, Unary) {
+  try {
+    state_->getSharedMemory()->add({request_.name(), request_.key(),
+                                    request_.offset(), request_.byte_size()});
+  } catch (const invalid_argument& e) {
+    AMDINFER_LOG_INFO(logger_, e.what());
+    finish(::grpc::Status(StatusCode::INVALID_ARGUMENT, e.what()));
+    return;
+  } catch (const std::exception& e) {
+    AMDINFER_LOG_ERROR(logger_, e.what());
+    finish(::grpc::Status(StatusCode::UNKNOWN, e.what()));
+    return;
+  }
+  finish(::grpc::Status::OK);
+}
+CALLDATA_IMPL_END
+
+CALLDATA_IMPL(SystemSharedMemoryUnregister, Unary) {
+  state_->getSharedMemory()->remove(request_.name());
+  finish(::grpc::Status::OK);
+}
+CALLDATA_IMPL_END
+
+CALLDATA_IMPL(HipSharedMemoryStatus, Unary) {
+  try {
+    const auto regions = state_->getSharedMemory()->status(
+      request_.name(), MemoryAllocators::HipSharedMemory);
+    auto* statuses = reply_.mutable_regions();
+    for (const auto& region : regions) {
+      auto& status = (*statuses)[region.name];
+      status.set_name(region.name);
+      status.set_device_id(region.device);
+      status.set_offset(region.offset);
+      status.set_byte_size(region.byte_size);
+    }
+  } catch (const invalid_argument& e) {
+    finish(::grpc::Status(StatusCode::NOT_FOUND, e.what()));
+    return;
+  }
+  finish(::grpc::Status::OK);
+}
+CALLDATA_IMPL_END
+
+CALLDATA_IMPL(HipSharedMemoryRegister, Unary) {
+  try {
+    state_->getSharedMemory()->add(
+      {request_.name(), request_.raw_handle(), request_.offset(),
+       request_.byte_size(), MemoryAllocators::HipSharedMemory,
+       static_cast<int>(request_.device_id())});
+  } catch (const invalid_argument& e) {
+    AMDINFER_LOG_INFO(logger_, e.what());
+    finish(::grpc::Status(StatusCode::INVALID_ARGUMENT, e.what()));
+    return;
+  } catch (const std::exception& e) {
+    AMDINFER_LOG_ERROR(logger_, e.what());
+    finish(::grpc::Status(StatusCode::UNKNOWN, e.what()));
+    return;
+  }
+  finish(::grpc::Status::OK);
+}
+CALLDATA_IMPL_END
+
+CALLDATA_IMPL(HipSharedMemoryUnregister, Unary) {
+  state_->getSharedMemory()->remove(request_.name(),
+                                    MemoryAllocators::HipSharedMemory);
+  finish(::grpc::Status::OK);
+}
+CALLDATA_IMPL_END
+
+template <typename Base>
+void HandlerModelInfer<Base>::handleRequest() noexcept {
+  if (!this->admit()) {
+    return;
+  }
+  const auto model =
+    getEndpoint(request_.model_name(), request_.model_version());
+#ifdef AMDINFER_ENABLE_METRICS
+  const auto now = util::getTime();
+#endif
 #ifdef AMDINFER_ENABLE_TRACING
   auto trace = startTrace(&(__func__[0]));
   trace->setAttribute("model", model);
@@ -555,15 +1121,32 @@ void CallDataModelInfer::handleRequest() noexcept {
 #endif
 
   try {
-    auto request = amdinfer::getRequest(request_, state_->getPool());
-    setCallback(request.get(), this);
     auto request_container = std::make_unique<RequestContainer>();
+    SharedMemoryTensors shared_memory{state_->getSharedMemory()};
+    auto request =
+      amdinfer::getRequest(request_, request_container.get(), &shared_memory);
+    if (RequestTiming::requested(request->getParameters())) {
+      request_container->timing = std::make_shared<RequestTiming>();
+    }
+    setCallback(request.get(), this, std::move(shared_memory),
+                request_container->timing);
     request_container->request = request;
+    this->watchCancellation(request_container.get());
+#ifdef AMDINFER_ENABLE_METRICS
+    request_container->start_time = now;
+    const std::chrono::duration<double, std::micro> parse =
+      util::getTime() - now;
+    Metrics::getInstance().observeHistogram(MetricHistogramIDs::IngressParse,
+                                            model, parse.count());
+#endif
 #ifdef AMDINFER_ENABLE_TRACING
     trace->endSpan();
     request_container->trace = std::move(trace);
 #endif
     state_->modelInfer(model, std::move(request_container));
+  } catch (const resource_exhausted_error& e) {
+    AMDINFER_LOG_DEBUG(logger_, e.what());
+    finish(::grpc::Status(StatusCode::RESOURCE_EXHAUSTED, e.what()));
   } catch (const invalid_argument& e) {
     AMDINFER_LOG_INFO(logger_, e.what());
     finish(::grpc::Status(StatusCode::NOT_FOUND, e.what()));
@@ -573,16 +1156,675 @@ void CallDataModelInfer::handleRequest() noexcept {
   }
 }
 
+/**
+ * @brief Handles a ModelInferBatch call. Its requests are parsed and submitted
+ * in one pass and each one writes its response into its own slot of the reply,
+ * which was sized up front, so they're returned in order. The call finishes
+ * once the last response is in and the requests' inputs stay in the call's
+ * request until then.
+ */
+CALLDATA_IMPL(ModelInferBatch, Unary) {
+  // the batch is admitted as one call with all of its requests' bytes
+  if (!this->admit()) {
+    return;
+  }
+  const auto size = request_.requests_size();
+  auto* responses = reply_.mutable_responses();
+  responses->Reserve(size);
+  for (auto i = 0; i < size; ++i) {
+    responses->Add();
+  }
+  // the call itself holds one until all the requests are submitted
+  auto remaining = std::make_shared<std::atomic<int>>(size + 1);
+  auto release = [this, remaining]() {
+    if (remaining->fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      finish(::grpc::Status::OK);
+    }
+  };
+
+  for (auto i = 0; i < size; ++i) {
+    const auto& proto = request_.requests(i);
+    auto* reply = responses->Mutable(i);
+    const auto model = getEndpoint(proto.model_name(), proto.model_version());
+    try {
+      auto request_container = std::make_unique<RequestContainer>();
+      SharedMemoryTensors shared_memory{state_->getSharedMemory()};
+      auto request =
+        amdinfer::getRequest(proto, request_container.get(), &shared_memory);
+      if (RequestTiming::requested(request->getParameters())) {
+        request_container->timing = std::make_shared<RequestTiming>();
+      }
+      const auto raw = !proto.raw_input_contents().empty();
+      request->setCallback([reply, raw, release,
+                            shared_memory = std::move(shared_memory),
+                            timing = request_container->timing](
+                             const InferenceResponse& response) {
+        if (response.isError()) {
+          reply->set_error_message(response.getError());
+        } else {
+          try {
+            mapResponseToProto(response, *reply->mutable_infer_response(), raw,
+                               &shared_memory);
+            if (timing != nullptr) {
+              mapParametersToProto(
+                timing->parameters(),
+                reply->mutable_infer_response()->mutable_parameters());
+            }
+          } catch (const invalid_argument& e) {
+            reply->set_error_message(e.what());
+          }
+        }
+        release();
+      });
+      request_container->request = request;
+      this->watchCancellation(request_container.get());
+#ifdef AMDINFER_ENABLE_METRICS
+      request_container->start_time = util::getTime();
+#endif
+      state_->modelInfer(model, std::move(request_container));
+    } catch (const std::exception& e) {
+      AMDINFER_LOG_INFO(logger_, e.what());
+      reply->set_error_message(e.what());
+      reply->mutable_infer_response()->set_id(proto.id());
+      reply->mutable_infer_response()->set_model_name(model);
+      release();
+    }
+  }
+  release();
+}
+CALLDATA_IMPL_END
+
+/**
+ * @brief Handles one ModelStreamInfer call. The client can send any number of
+ * requests over the stream and each response is written back as soon as it's
+ * ready so clients can pipeline requests without the setup cost of a new RPC
+ * each time. Only one read and one write may be pending at a time so responses
+ * are queued until it's their turn. The derived class performs the reads,
+ * writes and the final status on its API with startWrite() and startFinish().
+ *
+ * @tparam Derived the class of the stream on either API
+ */
+template <typename Derived>
+class StreamInfer {
+ protected:
+  using Response = inference::ModelStreamInferResponse;
+
+  /**
+   * @brief Keeps a request's proto alive while its inputs may still be read.
+   * It's owned by the request's callback so it's destroyed once no more
+   * responses can be sent for the request, which may be more than one for
+   * streaming workers.
+   */
+  class PendingRequest {
+   public:
+    PendingRequest(StreamInfer* stream,
+                   std::unique_ptr<inference::ModelInferRequest> proto)
+      : stream_(stream), proto_(std::move(proto)) {
+      stream_->addPending();
+    }
+    PendingRequest(const PendingRequest&) = delete;
+    PendingRequest(PendingRequest&&) = delete;
+    PendingRequest& operator=(const PendingRequest&) = delete;
+    PendingRequest& operator=(PendingRequest&&) = delete;
+    ~PendingRequest() { stream_->removePending(); }
+
+    [[nodiscard]] const inference::ModelInferRequest& get() const {
+      return *proto_;
+    }
+
+    /// Hold the request's place in its tenant's calls in flight
+    void hold(TenantTicket ticket) { ticket_ = std::move(ticket); }
+
+   private:
+    StreamInfer* stream_;
+    std::unique_ptr<inference::ModelInferRequest> proto_;
+    TenantTicket ticket_;
+  };
+
+  /**
+   * @brief The data of a response's outputs that's sent after its metadata, a
+   * chunk at a time. Each chunk is one raw_output_contents entry of at most
+   * chunk_bytes and the chunks follow the outputs in order. Only the chunk
+   * being written is ever serialized.
+   */
+  class ChunkedReply {
+   public:
+    ChunkedReply(const InferenceResponse& response,
+                 const SharedMemoryTensors& shared_memory, size_t chunk_bytes)
+      : response_(response), chunk_bytes_(chunk_bytes) {
+      for (const auto& output : response_.getOutputs()) {
+        const auto size = output.getSize() * output.getDatatype().size();
+        if (size > 0 && !shared_memory.containsOutput(output.getName())) {
+          data_.emplace_back(static_cast<const char*>(output.getData()), size);
+        }
+      }
+    }
+
+    /// Get the bytes of the outputs that are sent in chunks
+    [[nodiscard]] size_t size() const {
+      size_t size = 0;
+      for (const auto& data : data_) {
+        size += data.size();
+      }
+      return size;
+    }
+
+    /**
+     * @brief Replace the reply's contents with the next chunk
+     *
+     * @param reply the reply to write the chunk into
+     * @return bool false if all the chunks were sent
+     */
+    bool next(Response* reply) {
+      if (index_ == data_.size()) {
+        return false;
+      }
+      const auto& data = data_[index_];
+      const auto length = std::min(chunk_bytes_, data.size() - offset_);
+      auto* proto = reply->mutable_infer_response();
+      proto->Clear();
+      proto->set_id(response_.getID());
+      proto->set_model_name(response_.getModel());
+      proto->add_raw_output_contents(data.data() + offset_, length);
+      offset_ += length;
+      if (offset_ == data.size()) {
+        index_++;
+        offset_ = 0;
+      }
+      return true;
+    }
+
+   private:
+    // a copy shares the data of the outputs so it lives as long as this does
+    InferenceResponse response_;
+    std::vector<std::string_view> data_;
+    size_t chunk_bytes_;
+    size_t index_ = 0;
+    size_t offset_ = 0;
+  };
+
+  /// A response waiting to be written and the chunks that follow it, if any
+  struct QueuedResponse {
+    Response reply;
+    std::shared_ptr<ChunkedReply> chunks;
+  };
+
+  explicit StreamInfer(SharedState* state) : state_(state) {}
+
+  /// Set the stream's algorithm before anything is written to it
+  static void setCompression(::grpc::ServerContextBase* context) {
+    // each response is then compressed only if it's large enough
+    const auto algorithm =
+      getCompressionAlgorithm({response_compression.algorithm, 0}, 0);
+    if (algorithm != GRPC_COMPRESS_NONE) {
+      context->set_compression_algorithm(algorithm);
+    }
+  }
+
+  void handleRequest(const std::shared_ptr<PendingRequest>& pending) noexcept;
+
+  /// The client has closed its side of the stream
+  void onReadsDone() {
+    std::lock_guard lock{mutex_};
+    reading_ = false;
+    finishIfDone();
+  }
+
+  void onWriteDone(bool ok) {
+    std::lock_guard lock{mutex_};
+    // the next chunk reuses the message so the chunks of a response aren't
+    // interleaved with other responses
+    auto& front = responses_.front();
+    if (ok && front.chunks != nullptr && front.chunks->next(&front.reply)) {
+      writeFront();
+      return;
+    }
+    responses_.pop_front();
+    if (!ok) {
+      // the client is gone so the remaining responses are dropped
+      broken_ = true;
+      responses_.clear();
+    }
+    if (responses_.empty()) {
+      writing_ = false;
+      finishIfDone();
+    } else {
+      writeFront();
+    }
+  }
+
+  /// Wait for the thread that finished the stream to release the lock
+  void waitForFinish() { std::lock_guard lock{mutex_}; }
+
+  SharedState* state_;
+
+ private:
+  Derived* derived() { return static_cast<Derived*>(this); }
+
+  /// Write the response at the front of the queue. Hold mutex_
+  void writeFront() {
+    ::grpc::WriteOptions options;
+    const auto& reply = responses_.front().reply;
+    const auto size = reply.ByteSizeLong();
+    if (getCompressionAlgorithm(response_compression, size) ==
+        GRPC_COMPRESS_NONE) {
+      options.set_no_compression();
+    }
+    derived()->startWrite(reply, options);
+  }
+
+  void write(Response response,
+             std::shared_ptr<ChunkedReply> chunks = nullptr) {
+    std::lock_guard lock{mutex_};
+    if (broken_) {
+      return;
+    }
+    responses_.push_back({std::move(response), std::move(chunks)});
+    // only one write may be pending at a time so others wait their turn
+    if (!writing_) {
+      writing_ = true;
+      writeFront();
+    }
+  }
+
+  void addPending() {
+    std::lock_guard lock{mutex_};
+    pending_++;
+  }
+
+  void removePending() {
+    std::lock_guard lock{mutex_};
+    pending_--;
+    finishIfDone();
+  }
+
+  /// End the stream once nothing more can be read or written. Hold mutex_
+  void finishIfDone() {
+    if (!reading_ && !writing_ && pending_ == 0 && !finished_) {
+      finished_ = true;
+      derived()->startFinish();
+    }
+  }
+
+  std::mutex mutex_;
+  std::deque<QueuedResponse> responses_;
+  int pending_ = 0;
+  bool reading_ = true;
+  bool writing_ = false;
+  bool broken_ = false;
+  bool finished_ = false;
+
+#ifdef AMDINFER_ENABLE_LOGGING
+  Logger logger_{Loggers::Server};
+#endif
+};
+
+template <typename Derived>
+void StreamInfer<Derived>::handleRequest(
+  const std::shared_ptr<PendingRequest>& pending) noexcept {
+  const auto& proto = pending->get();
+  const auto model = getEndpoint(proto.model_name(), proto.model_version());
+#ifdef AMDINFER_ENABLE_METRICS
+  const auto now = util::getTime();
+#endif
+#ifdef AMDINFER_ENABLE_TRACING
+  auto trace = startTrace(&(__func__[0]));
+  trace->setAttribute("model", model);
+  trace->startSpan("request_handler");
+#endif
+
+  try {
+    // each request on the stream is admitted as a call of its own
+    auto ticket = admitTenant(state_, derived()->context(), proto);
+    if (ticket.rejected()) {
+      throw resource_exhausted_error(toString(ticket.rejection()));
+    }
+    pending->hold(std::move(ticket));
+    auto request_container = std::make_unique<RequestContainer>();
+    SharedMemoryTensors shared_memory{state_->getSharedMemory()};
+    auto request =
+      amdinfer::getRequest(proto, request_container.get(), &shared_memory);
+    if (RequestTiming::requested(request->getParameters())) {
+      request_container->timing = std::make_shared<RequestTiming>();
+    }
+    // reply in the same encoding the client used
+    const auto raw = !proto.raw_input_contents().empty();
+    size_t chunk_bytes = 0;
+    const auto& parameters = request->getParameters();
+    if (parameters.has(kChunkBytes)) {
+      const auto value = parameters.get<int32_t>(kChunkBytes);
+      if (value <= 0) {
+        throw invalid_argument("The chunk_bytes parameter must be positive");
+      }
+      chunk_bytes = static_cast<size_t>(value);
+    }
+    request->setCallback([this, pending, raw, chunk_bytes,
+                          shared_memory = std::move(shared_memory),
+                          timing = request_container->timing](
+                           const InferenceResponse& response) {
+      Response reply;
+      std::shared_ptr<ChunkedReply> chunks;
+      if (response.isError()) {
+        reply.set_error_message(response.getError());
+      } else {
+        try {
+#ifdef AMDINFER_ENABLE_METRICS
+          const auto start = util::getTime();
+#endif
+          if (chunk_bytes > 0) {
+            chunks = std::make_shared<ChunkedReply>(response, shared_memory,
+                                                    chunk_bytes);
+            if (chunks->size() <= chunk_bytes) {
+              chunks = nullptr;
+            }
+          }
+          auto* infer_response = reply.mutable_infer_response();
+          if (chunks != nullptr) {
+            mapResponseMetadataToProto(response, *infer_response,
+                                       &shared_memory);
+            (*infer_response->mutable_parameters())[kChunked].set_bool_param(
+              true);
+          } else {
+            mapResponseToProto(response, *infer_response, raw,
+                               &shared_memory);
+          }
+          if (timing != nullptr) {
+            mapParametersToProto(
+              timing->parameters(),
+              reply.mutable_infer_response()->mutable_parameters());
+          }
+#ifdef AMDINFER_ENABLE_METRICS
+          const std::chrono::duration<double, std::micro> duration =
+            util::getTime() - start;
+          Metrics::getInstance().observeHistogram(
+            MetricHistogramIDs::ResponseSerialization,
+            pending->get().model_name(), duration.count());
+#endif
+        } catch (const invalid_argument& e) {
+          reply.set_error_message(e.what());
+          chunks = nullptr;
+        }
+      }
+      write(std::move(reply), std::move(chunks));
+    });
+    request_container->request = request;
+#ifdef AMDINFER_ENABLE_METRICS
+    request_container->start_time = now;
+    const std::chrono::duration<double, std::micro> parse =
+      util::getTime() - now;
+    Metrics::getInstance().observeHistogram(MetricHistogramIDs::IngressParse,
+                                            model, parse.count());
+#endif
+#ifdef AMDINFER_ENABLE_TRACING
+    trace->endSpan();
+    request_container->trace = std::move(trace);
+#endif
+    state_->modelInfer(model, std::move(request_container));
+  } catch (const std::exception& e) {
+    AMDINFER_LOG_INFO(logger_, e.what());
+    Response reply;
+    reply.set_error_message(e.what());
+    reply.mutable_infer_response()->set_id(proto.id());
+    reply.mutable_infer_response()->set_model_name(model);
+    write(std::move(reply));
+  }
+}
+
+/**
+ * @brief A ModelStreamInfer call on a completion queue. Reads, writes and the
+ * final status can be pending at the same time so each gets its own tag.
+ */
+class CallDataModelStreamInfer final
+  : public StreamInfer<CallDataModelStreamInfer> {
+ public:
+  CallDataModelStreamInfer(AsyncService* service, ServerCompletionQueue* cq,
+                           SharedState* state)
+    : StreamInfer(state), service_(service), cq_(cq), stream_(&ctx_) {
+    service_->RequestModelStreamInfer(&ctx_, &stream_, cq_, cq_,
+                                      &connect_tag_);
+  }
+
+ private:
+  friend StreamInfer;
+  using Handler = void (CallDataModelStreamInfer::*)(bool);
+
+  /// A completion queue tag that forwards its events to the stream
+  class Tag : public CallDataBase {
+   public:
+    Tag(CallDataModelStreamInfer* stream, Handler handler)
+      : stream_(stream), handler_(handler) {}
+    void proceed(bool ok) override { (stream_->*handler_)(ok); }
+
+   private:
+    CallDataModelStreamInfer* stream_;
+    Handler handler_;
+  };
+
+  void onConnect(bool ok) {
+    if (!ok) {
+      // the server is shutting down
+      delete this;
+      return;
+    }
+    new CallDataModelStreamInfer(service_, cq_, state_);
+    setCompression(&ctx_);
+    read();
+  }
+
+  void read() {
+    request_ = std::make_unique<inference::ModelInferRequest>();
+    stream_.Read(request_.get(), &read_tag_);
+  }
+
+  void onRead(bool ok) {
+    if (!ok) {
+      onReadsDone();
+      return;
+    }
+    handleRequest(std::make_shared<PendingRequest>(this, std::move(request_)));
+    read();
+  }
+
+  void onWrite(bool ok) { onWriteDone(ok); }
+
+  void onFinish([[maybe_unused]] bool ok) {
+    waitForFinish();
+    delete this;
+  }
+
+  void startWrite(const Response& response, ::grpc::WriteOptions options) {
+    stream_.Write(response, options, &write_tag_);
+  }
+
+  void startFinish() { stream_.Finish(::grpc::Status::OK, &finish_tag_); }
+
+  [[nodiscard]] const ::grpc::ServerContextBase& context() const {
+    return ctx_;
+  }
+
+  AsyncService* service_;
+  ServerCompletionQueue* cq_;
+  ::grpc::ServerContext ctx_;
+  ServerAsyncReaderWriter<Response, inference::ModelInferRequest> stream_;
+  std::unique_ptr<inference::ModelInferRequest> request_;
+
+  Tag connect_tag_{this, &CallDataModelStreamInfer::onConnect};
+  Tag read_tag_{this, &CallDataModelStreamInfer::onRead};
+  Tag write_tag_{this, &CallDataModelStreamInfer::onWrite};
+  Tag finish_tag_{this, &CallDataModelStreamInfer::onFinish};
+};
+
+/**
+ * @brief A ModelStreamInfer call on the callback API. gRPC reacts to reads and
+ * writes on its own threads so each request is mapped and submitted on the
+ * request pool with the next read already started.
+ */
+class CallbackModelStreamInfer final
+  : public ::grpc::ServerBidiReactor<inference::ModelInferRequest,
+                                     inference::ModelStreamInferResponse>,
+    public StreamInfer<CallbackModelStreamInfer> {
+ public:
+  CallbackModelStreamInfer(CallbackServerContext* context, SharedState* state,
+                           util::ThreadPool* pool)
+    : StreamInfer(state), context_(context), pool_(pool) {
+    setCompression(context);
+    read();
+  }
+
+  void OnReadDone(bool ok) override {
+    if (!ok) {
+      onReadsDone();
+      return;
+    }
+    auto pending = std::make_shared<PendingRequest>(this, std::move(request_));
+    read();
+    pool_->push([this, pending](int) { handleRequest(pending); });
+  }
+
+  void OnWriteDone(bool ok) override { onWriteDone(ok); }
+
+  void OnDone() override {
+    waitForFinish();
+    delete this;
+  }
+
+ private:
+  friend StreamInfer;
+
+  void read() {
+    request_ = std::make_unique<inference::ModelInferRequest>();
+    StartRead(request_.get());
+  }
+
+  void startWrite(const Response& response, ::grpc::WriteOptions options) {
+    StartWrite(&response, options);
+  }
+
+  void startFinish() { Finish(::grpc::Status::OK); }
+
+  [[nodiscard]] const ::grpc::ServerContextBase& context() const {
+    return *context_;
+  }
+
+  CallbackServerContext* context_;
+  util::ThreadPool* pool_;
+  std::unique_ptr<inference::ModelInferRequest> request_;
+};
+
+/// Allocates the request and the reply of each ModelInfer call on an arena
+class ArenaAllocator final
+  : public ::grpc::MessageAllocator<inference::ModelInferRequest,
+                                    inference::ModelInferResponse> {
+ public:
+  ::grpc::MessageHolder<inference::ModelInferRequest,
+                        inference::ModelInferResponse>*
+  AllocateMessages() override {
+    return new Holder;
+  }
+
+ private:
+  class Holder final
+    : public ::grpc::MessageHolder<inference::ModelInferRequest,
+                                   inference::ModelInferResponse> {
+   public:
+    Holder() : arena_(arena_pool.get()) {
+      set_request(
+        google::protobuf::Arena::CreateMessage<inference::ModelInferRequest>(
+          arena_->get()));
+      set_response(
+        google::protobuf::Arena::CreateMessage<inference::ModelInferResponse>(
+          arena_->get()));
+    }
+
+    void Release() override { delete this; }
+
+   private:
+    ArenaPool::Ptr arena_;
+  };
+};
+
+/// Number of threads for the calls that load and unload models and workers
+constexpr auto kControlThreads = 2;
+
+// NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
+#define CALLBACK_UNARY(endpoint)                                            \
+  ::grpc::ServerUnaryReactor* endpoint(                                     \
+    CallbackServerContext* context, const inference::endpoint##Request* req, \
+    inference::endpoint##Response* reply) override {                        \
+    auto* call = new Callback##endpoint(context, req, reply, state_);       \
+    call->run();                                                            \
+    return call;                                                            \
+  }
+
+// NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
+#define CALLBACK_UNARY_ON(endpoint, pool)                                   \
+  ::grpc::ServerUnaryReactor* endpoint(                                     \
+    CallbackServerContext* context, const inference::endpoint##Request* req, \
+    inference::endpoint##Response* reply) override {                        \
+    auto* call = new Callback##endpoint(context, req, reply, state_);       \
+    (pool).push([call](int) { call->run(); });                              \
+    return call;                                                            \
+  }
+
+/**
+ * @brief The service on gRPC's callback API. gRPC calls these methods on its
+ * own threads as calls arrive and each call finishes itself so there are no
+ * completion queues to poll. Quick calls are handled in place but inference
+ * requests are mapped and submitted on the request pool so gRPC's threads
+ * only move messages, and loading, which may take a while, has its own pool.
+ */
+class CallbackService final
+  : public inference::GRPCInferenceService::CallbackService {
+ public:
+  CallbackService(SharedState* state, int request_threads)
+    : state_(state), requests_(request_threads), control_(kControlThreads) {
+    SetMessageAllocatorFor_ModelInfer(&allocator_);
+  }
+
+  CALLBACK_UNARY(ServerLive)
+  CALLBACK_UNARY(ServerReady)
+  CALLBACK_UNARY(ModelReady)
+  CALLBACK_UNARY(ServerMetadata)
+  CALLBACK_UNARY(ModelMetadata)
+  CALLBACK_UNARY(ModelList)
+  CALLBACK_UNARY(HasHardware)
+  CALLBACK_UNARY(SystemSharedMemoryStatus)
+  CALLBACK_UNARY(SystemSharedMemoryRegister)
+  CALLBACK_UNARY(SystemSharedMemoryUnregister)
+  CALLBACK_UNARY(HipSharedMemoryStatus)
+  CALLBACK_UNARY(HipSharedMemoryRegister)
+  CALLBACK_UNARY(HipSharedMemoryUnregister)
+  CALLBACK_UNARY_ON(ModelInfer, requests_)
+  CALLBACK_UNARY_ON(ModelInferBatch, requests_)
+  CALLBACK_UNARY_ON(ModelLoad, control_)
+  CALLBACK_UNARY_ON(ModelUnload, control_)
+  CALLBACK_UNARY_ON(WorkerLoad, control_)
+  CALLBACK_UNARY_ON(WorkerUnload, control_)
+
+  ::grpc::ServerBidiReactor<inference::ModelInferRequest,
+                            inference::ModelStreamInferResponse>*
+  ModelStreamInfer(CallbackServerContext* context) override {
+    return new CallbackModelStreamInfer(context, state_, &requests_);
+  }
+
+ private:
+  SharedState* state_;
+  ArenaAllocator allocator_;
+  util::ThreadPool requests_;
+  util::ThreadPool control_;
+};
+
 class GrpcServer final {
  public:
   /// Get the singleton GrpcServer instance
-  static GrpcServer& getInstance() { return create("", -1, nullptr); }
+  static GrpcServer& getInstance() { return create("", {}, nullptr); }
 
   // using this singleton approach here because the start() method is state-
   // independent. The HTTP server is already global like this
-  static GrpcServer& create(const std::string& address, const int cq_count,
+  static GrpcServer& create(const std::string& address,
+                            const GrpcServerOptions& options,
                             SharedState* state) {
-    static GrpcServer server(address, cq_count, state);
+    static GrpcServer server(address, options, state);
     return server;
   }
 
@@ -612,32 +1854,52 @@ class GrpcServer final {
   }
 
  private:
-  GrpcServer(const std::string& address, const int cq_count, SharedState* state)
-    : state_(state) {
+  GrpcServer(const std::string& address, const GrpcServerOptions& options,
+             SharedState* state)
+    : infer_slots_(options.infer_slots), state_(state) {
+    response_compression = options.compression;
     ServerBuilder builder;
-    builder.SetMaxReceiveMessageSize(kMaxGrpcMessageSize);
-    builder.SetMaxSendMessageSize(kMaxGrpcMessageSize);
+    builder.SetMaxReceiveMessageSize(options.max_message_size);
+    builder.SetMaxSendMessageSize(options.max_message_size);
     // Listen on the given address without any authentication mechanism.
-    builder.AddListeningPort(address, ::grpc::InsecureServerCredentials());
-    // Register "service_" as the instance through which we'll communicate
-    // with clients. In this case it corresponds to an *asynchronous* service.
-    builder.RegisterService(&service_);
-    // Get hold of the completion queue used for the asynchronous
-    // communication with the gRPC runtime.
-    for (auto i = 0; i < cq_count; i++) {
-      cq_.push_back(builder.AddCompletionQueue());
+    if (options.tcp) {
+      builder.AddListeningPort(address, ::grpc::InsecureServerCredentials());
+    }
+    if (!options.unix_socket.empty()) {
+      // gRPC replaces a stale socket left at the path by an earlier server
+      builder.AddListeningPort("unix:" + options.unix_socket,
+                               ::grpc::InsecureServerCredentials());
+    }
+    if (options.callback_api) {
+      // gRPC runs the calls of the callback API on its own threads
+      callback_service_ =
+        std::make_unique<CallbackService>(state, options.request_threads);
+      builder.RegisterService(callback_service_.get());
+    } else {
+      // Register "service_" as the instance through which we'll communicate
+      // with clients. In this case it corresponds to an *asynchronous*
+      // service.
+      builder.RegisterService(&service_);
+      // Get hold of the completion queue used for the asynchronous
+      // communication with the gRPC runtime.
+      for (auto i = 0; i < options.completion_queues; i++) {
+        cq_.push_back(builder.AddCompletionQueue());
+      }
     }
     // Finally assemble the server.
     server_ = builder.BuildAndStart();
 
-    // Start threads to handle incoming RPCs
-    for (auto i = 0; i < cq_count; i++) {
-      threads_.emplace_back(&GrpcServer::handleRpcs, this, i);
+    // Start threads to handle incoming RPCs. Next() is thread-safe so a
+    // completion queue may be polled by more than one thread
+    for (auto i = 0U; i < cq_.size(); i++) {
+      for (auto j = 0; j < options.threads_per_queue; j++) {
+        threads_.emplace_back(&GrpcServer::handleRpcs, this, i);
+      }
     }
   }
 
   // This can be run in multiple threads if needed.
-  void handleRpcs(int index) {
+  void handleRpcs(size_t index) {
     const auto& my_cq = cq_.at(index);
 
     // Spawn a new CallData instance to serve new clients.
@@ -651,9 +1913,20 @@ class GrpcServer final {
     new CallDataModelUnload(&service_, my_cq.get(), state_);
     new CallDataWorkerLoad(&service_, my_cq.get(), state_);
     new CallDataWorkerUnload(&service_, my_cq.get(), state_);
-    new CallDataModelInfer(&service_, my_cq.get(), state_);
+    // each call posts a replacement as it starts but many are posted up front
+    // so a burst of calls doesn't wait for the queue's threads to repost them
+    for (auto i = 0; i < infer_slots_; i++) {
+      new CallDataModelInfer(&service_, my_cq.get(), state_);
+    }
     new CallDataHasHardware(&service_, my_cq.get(), state_);
-    // new CallDataStreamModelInfer(&service_, my_cq.get());
+    new CallDataModelStreamInfer(&service_, my_cq.get(), state_);
+    new CallDataModelInferBatch(&service_, my_cq.get(), state_);
+    new CallDataSystemSharedMemoryStatus(&service_, my_cq.get(), state_);
+    new CallDataSystemSharedMemoryRegister(&service_, my_cq.get(), state_);
+    new CallDataSystemSharedMemoryUnregister(&service_, my_cq.get(), state_);
+    new CallDataHipSharedMemoryStatus(&service_, my_cq.get(), state_);
+    new CallDataHipSharedMemoryRegister(&service_, my_cq.get(), state_);
+    new CallDataHipSharedMemoryUnregister(&service_, my_cq.get(), state_);
     void* tag = nullptr;  // uniquely identifies a request.
     bool ok = false;
     while (true) {
@@ -668,25 +1941,29 @@ class GrpcServer final {
       // The return value of Next should always be checked. This return value
       // tells us whether there is any kind of event or cq_ is shutting down.
       auto event_received = my_cq->Next(&tag, &ok);
-      if (GPR_UNLIKELY(!(ok && event_received))) {
+      if (GPR_UNLIKELY(!event_received)) {
         break;
       }
-      static_cast<CallDataBase*>(tag)->proceed();
+      // failed events are passed on so their tags can clean up after them
+      static_cast<CallDataBase*>(tag)->proceed(ok);
     }
   }
 
   std::vector<std::unique_ptr<::grpc::ServerCompletionQueue>> cq_;
   inference::GRPCInferenceService::AsyncService service_;
+  std::unique_ptr<CallbackService> callback_service_;
   std::unique_ptr<::grpc::Server> server_;
   std::vector<std::thread> threads_;
+  /// inference calls waiting for an RPC on each completion queue
+  int infer_slots_;
   SharedState* state_;
 };
 
 namespace grpc {
 
-void start(SharedState* state, int port) {
+void start(SharedState* state, int port, const GrpcServerOptions& options) {
   const std::string address = "0.0.0.0:" + std::to_string(port);
-  GrpcServer::create(address, 1, state);
+  GrpcServer::create(address, options, state);
 }
 
 void stop() {
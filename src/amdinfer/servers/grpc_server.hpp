@@ -22,6 +22,7 @@
 #define GUARD_AMDINFER_SERVERS_GRPC_SERVER
 
 #include "amdinfer/build_options.hpp"
+#include "amdinfer/servers/server.hpp"
 
 #ifdef AMDINFER_ENABLE_GRPC
 
@@ -31,7 +32,7 @@ class SharedState;
 
 namespace amdinfer::grpc {
 
-void start(SharedState* state, int port);
+void start(SharedState* state, int port, const GrpcServerOptions& options);
 void stop();
 
 }  // namespace amdinfer::grpc
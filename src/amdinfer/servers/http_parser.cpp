@@ -0,0 +1,402 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements a parser for JSON inference requests that keeps the tensor
+ * data out of the JSON DOM
+ */
+
+#include "amdinfer/servers/http_parser.hpp"
+
+#include <json/reader.h>  // for CharReader, CharReaderBuilder
+#include <json/value.h>   // for Value, arrayValue, objectValue
+
+#include <charconv>      // for from_chars
+#include <cstdlib>       // for strtod, strtof
+#include <limits>        // for numeric_limits
+#include <memory>        // for unique_ptr, make_shared
+#include <string>        // for string, to_string
+#include <string_view>   // for string_view
+#include <system_error>  // for errc
+#include <type_traits>   // for is_same_v, is_integral_v
+#include <vector>        // for vector
+
+#include "amdinfer/buffers/buffer.hpp"   // for Buffer
+#include "amdinfer/core/data_types.hpp"  // for DataType, switchOverTypes
+#include "amdinfer/core/exceptions.hpp"  // for invalid_argument
+
+namespace amdinfer {
+
+namespace {
+
+constexpr bool isWhitespace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+/// Checks if c ends a bare JSON value like a number or a literal
+constexpr bool isDelimiter(char c) {
+  return isWhitespace(c) || c == ',' || c == ']' || c == '}' || c == ':';
+}
+
+/**
+ * @brief Walks over JSON text without building any DOM. Values are skipped
+ * over and returned as raw text, checking only that strings are terminated
+ * and brackets are balanced. The text of values that are kept is later
+ * validated by the code that interprets it.
+ */
+class JsonScanner {
+ public:
+  explicit JsonScanner(std::string_view text) : text_(text) {}
+
+  /// Get the next non-whitespace character or '\0' at the end of the text
+  char peek() {
+    skipWhitespace();
+    return pos_ < text_.size() ? text_[pos_] : '\0';
+  }
+
+  /// Consume the next non-whitespace character if it's c
+  bool consume(char c) {
+    if (peek() == c) {
+      ++pos_;
+      return true;
+    }
+    return false;
+  }
+
+  /// Consume the next non-whitespace character, which must be c
+  void expect(char c) {
+    if (!consume(c)) {
+      throw invalid_argument(std::string{"Malformed JSON: expected '"} + c +
+                             "' at position " + std::to_string(pos_));
+    }
+  }
+
+  /// Skip over the next value and return its raw text
+  std::string_view value() {
+    const auto c = peek();
+    const auto start = pos_;
+    if (c == '"') {
+      skipString();
+    } else if (c == '{' || c == '[') {
+      skipContainer();
+    } else {
+      while (pos_ < text_.size() && !isDelimiter(text_[pos_])) {
+        ++pos_;
+      }
+      if (pos_ == start) {
+        throw invalid_argument("Malformed JSON: expected a value at position " +
+                               std::to_string(pos_));
+      }
+    }
+    return text_.substr(start, pos_ - start);
+  }
+
+  /// Checks if only whitespace is left
+  bool done() { return peek() == '\0' && pos_ == text_.size(); }
+
+ private:
+  void skipWhitespace() {
+    while (pos_ < text_.size() && isWhitespace(text_[pos_])) {
+      ++pos_;
+    }
+  }
+
+  void skipString() {
+    ++pos_;  // opening quote
+    while (pos_ < text_.size()) {
+      const auto c = text_[pos_];
+      if (c == '\\') {
+        pos_ += 2;
+      } else {
+        ++pos_;
+        if (c == '"') {
+          return;
+        }
+      }
+    }
+    throw invalid_argument("Malformed JSON: unterminated string");
+  }
+
+  void skipContainer() {
+    std::vector<char> closers;
+    while (pos_ < text_.size()) {
+      const auto c = text_[pos_];
+      if (c == '"') {
+        skipString();
+        continue;
+      }
+      if (c == '{') {
+        closers.push_back('}');
+      } else if (c == '[') {
+        closers.push_back(']');
+      } else if (c == '}' || c == ']') {
+        if (closers.back() != c) {
+          throw invalid_argument("Malformed JSON: mismatched brackets");
+        }
+        closers.pop_back();
+      }
+      ++pos_;
+      if (closers.empty()) {
+        return;
+      }
+    }
+    throw invalid_argument("Malformed JSON: unterminated array or object");
+  }
+
+  std::string_view text_;
+  size_t pos_ = 0;
+};
+
+Json::Value toJson(Json::CharReader* reader, std::string_view text) {
+  Json::Value value;
+  std::string errors;
+  if (!reader->parse(text.data(), text.data() + text.size(), &value,
+                     &errors)) {
+    throw invalid_argument("Failed to interpret request body as JSON: " +
+                           errors);
+  }
+  return value;
+}
+
+std::unique_ptr<Json::CharReader> makeReader() {
+  Json::CharReaderBuilder builder;
+  return std::unique_ptr<Json::CharReader>{builder.newCharReader()};
+}
+
+class RequestParser {
+ public:
+  RequestParser(std::string_view body, std::vector<std::string_view>* data)
+    : scanner_(body), data_(data), reader_(makeReader()) {}
+
+  std::shared_ptr<Json::Value> parse() {
+    auto root = std::make_shared<Json::Value>(Json::objectValue);
+    scanner_.expect('{');
+    if (!scanner_.consume('}')) {
+      do {
+        auto name = key();
+        if (name == "inputs") {
+          parseInputs(&(*root)[name]);
+        } else {
+          (*root)[name] = toJson(reader_.get(), scanner_.value());
+        }
+      } while (scanner_.consume(','));
+      scanner_.expect('}');
+    }
+    if (!scanner_.done()) {
+      throw invalid_argument("Malformed JSON: trailing data after request");
+    }
+    return root;
+  }
+
+ private:
+  std::string key() {
+    if (scanner_.peek() != '"') {
+      throw invalid_argument("Malformed JSON: expected a key");
+    }
+    auto raw = scanner_.value();
+    scanner_.expect(':');
+    if (raw.find('\\') == std::string_view::npos) {
+      return std::string{raw.substr(1, raw.size() - 2)};
+    }
+    return toJson(reader_.get(), raw).asString();
+  }
+
+  void parseInputs(Json::Value* inputs) {
+    // malformed inputs are kept as is for the request validation to reject
+    if (scanner_.peek() != '[') {
+      *inputs = toJson(reader_.get(), scanner_.value());
+      return;
+    }
+    *inputs = Json::arrayValue;
+    scanner_.expect('[');
+    if (scanner_.consume(']')) {
+      return;
+    }
+    do {
+      parseInput(&inputs->append(Json::objectValue));
+    } while (scanner_.consume(','));
+    scanner_.expect(']');
+  }
+
+  void parseInput(Json::Value* input) {
+    std::string_view data;
+    if (scanner_.peek() != '{') {
+      *input = toJson(reader_.get(), scanner_.value());
+      data_->push_back(data);
+      return;
+    }
+    scanner_.expect('{');
+    if (!scanner_.consume('}')) {
+      do {
+        auto name = key();
+        if (name == "data") {
+          data = scanner_.value();
+        } else {
+          (*input)[name] = toJson(reader_.get(), scanner_.value());
+        }
+      } while (scanner_.consume(','));
+      scanner_.expect('}');
+    }
+    data_->push_back(data);
+  }
+
+  JsonScanner scanner_;
+  std::vector<std::string_view>* data_;
+  std::unique_ptr<Json::CharReader> reader_;
+};
+
+[[noreturn]] void throwConversionError() {
+  throw invalid_argument(
+    "Could not convert some data to the provided data type");
+}
+
+template <typename T>
+T parseNumber(std::string_view token) {
+  const char* begin = token.data();
+  const char* end = begin + token.size();
+  if constexpr (std::is_same_v<T, bool>) {
+    if (token == "true") {
+      return true;
+    }
+    if (token == "false") {
+      return false;
+    }
+    return parseNumber<double>(token) != 0;
+  } else if constexpr (std::is_integral_v<T>) {
+    T value{};
+    auto [ptr, ec] = std::from_chars(begin, end, value);
+    if (ec == std::errc{} && ptr == end) {
+      return value;
+    }
+    // integers may also be written in floating point notation e.g. 1.0
+    auto real = parseNumber<double>(token);
+    if (real < static_cast<double>(std::numeric_limits<T>::lowest()) ||
+        real > static_cast<double>(std::numeric_limits<T>::max())) {
+      throwConversionError();
+    }
+    return static_cast<T>(real);
+  } else {
+    // JSON numbers start with a digit or minus sign. This also rejects things
+    // like "inf" and "nan" that strtod would otherwise accept
+    if (token.empty() ||
+        (token[0] != '-' && (token[0] < '0' || token[0] > '9'))) {
+      throwConversionError();
+    }
+    // the token is always followed by a delimiter in the text so strtod stops
+    // before reading past it
+    char* ptr = nullptr;
+    T value{};
+    if constexpr (std::is_same_v<T, double>) {
+      value = std::strtod(begin, &ptr);
+    } else {
+      value = static_cast<T>(std::strtof(begin, &ptr));
+    }
+    if (ptr != end) {
+      throwConversionError();
+    }
+    return value;
+  }
+}
+
+struct ParseArray {
+  template <typename T>
+  size_t operator()(std::string_view text, Buffer* buffer) const {
+    if constexpr (std::is_same_v<T, char>) {
+      auto reader = makeReader();
+      auto json = toJson(reader.get(), text);
+      if (!json.isArray()) {
+        throw invalid_argument("'data' must be an array");
+      }
+      size_t offset = 0;
+      try {
+        for (const auto& datum : json) {
+          offset = buffer->write(datum.asString(), offset);
+        }
+      } catch (const Json::LogicError&) {
+        throwConversionError();
+      }
+      return offset;
+    } else {
+      if (text.empty() || text[0] != '[') {
+        throw invalid_argument("'data' must be an array");
+      }
+      const auto capacity = buffer->size();
+      size_t offset = 0;
+      size_t pos = 0;
+      bool need_separator = false;
+      while (pos < text.size()) {
+        const auto c = text[pos];
+        if (isWhitespace(c) || c == ']') {
+          ++pos;
+        } else if (c == ',' || (c == '[' && !need_separator)) {
+          need_separator = false;
+          ++pos;
+        } else if (need_separator) {
+          throw invalid_argument("Malformed JSON: expected ',' in 'data'");
+        } else {
+          auto end = pos;
+          while (end < text.size() && !isDelimiter(text[end])) {
+            ++end;
+          }
+          auto value = parseNumber<T>(text.substr(pos, end - pos));
+          if (capacity != 0 && offset + sizeof(T) > capacity) {
+            throw invalid_argument(
+              "The input 'data' has more elements than its shape");
+          }
+          offset = buffer->write(value, offset);
+          need_separator = true;
+          pos = end;
+        }
+      }
+      return offset;
+    }
+  }
+};
+
+}  // namespace
+
+std::shared_ptr<Json::Value> parseJsonRequest(
+  std::string_view body, std::vector<std::string_view>* data) {
+  RequestParser parser{body, data};
+  return parser.parse();
+}
+
+size_t parseJsonArray(std::string_view text, DataType datatype,
+                      Buffer* buffer) {
+  return switchOverTypes(ParseArray(), datatype, text, buffer);
+}
+
+std::vector<std::string> parseJsonStrings(std::string_view text) {
+  auto reader = makeReader();
+  auto json = toJson(reader.get(), text);
+  return getJsonStrings(json);
+}
+
+std::vector<std::string> getJsonStrings(const Json::Value& json) {
+  if (!json.isArray()) {
+    throw invalid_argument("'data' must be an array");
+  }
+  std::vector<std::string> elements;
+  elements.reserve(json.size());
+  for (const auto& datum : json) {
+    if (!datum.isString()) {
+      throw invalid_argument("The elements of BYTES data must be strings");
+    }
+    elements.push_back(datum.asString());
+  }
+  return elements;
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,83 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines a parser for JSON inference requests that keeps the tensor
+ * data out of the JSON DOM
+ */
+
+#ifndef GUARD_AMDINFER_SERVERS_HTTP_PARSER
+#define GUARD_AMDINFER_SERVERS_HTTP_PARSER
+
+#include <json/value.h>  // for Value
+
+#include <cstddef>      // for size_t
+#include <memory>       // for shared_ptr
+#include <string>       // for string
+#include <string_view>  // for string_view
+#include <vector>       // for vector
+
+#include "amdinfer/core/data_types.hpp"  // for DataType
+
+namespace amdinfer {
+
+class Buffer;
+
+/**
+ * @brief Parse a JSON inference request. The "data" arrays of the inputs are
+ * not added to the returned JSON. Instead, their raw text is returned in data,
+ * with one entry per input in order, so it can be parsed straight into a buffer
+ * once the input's datatype and shape are known. Inputs without data get an
+ * empty entry.
+ *
+ * @param body the JSON text of the request
+ * @param data the raw text of the data array of each input
+ * @return std::shared_ptr<Json::Value> the rest of the request
+ */
+std::shared_ptr<Json::Value> parseJsonRequest(
+  std::string_view body, std::vector<std::string_view>* data);
+
+/**
+ * @brief Parse the raw text of a JSON data array into a buffer. Nested arrays
+ * are flattened in row-major order.
+ *
+ * @param text the raw text of the array
+ * @param datatype the datatype of the elements
+ * @param buffer the buffer to write to, starting at offset zero
+ * @return size_t the number of bytes written
+ */
+size_t parseJsonArray(std::string_view text, DataType datatype, Buffer* buffer);
+
+/**
+ * @brief Parse the raw text of the JSON data array of a BYTES tensor, which
+ * must be a flat array of strings
+ *
+ * @param text the raw text of the array
+ * @return std::vector<std::string> the elements
+ */
+std::vector<std::string> parseJsonStrings(std::string_view text);
+
+/**
+ * @brief Get the elements of the JSON data array of a BYTES tensor, which must
+ * be a flat array of strings
+ *
+ * @param json the array
+ * @return std::vector<std::string> the elements
+ */
+std::vector<std::string> getJsonStrings(const Json::Value& json);
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_SERVERS_HTTP_PARSER
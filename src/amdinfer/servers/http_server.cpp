@@ -25,29 +25,53 @@
 #include <json/value.h>               // for Value, arrayValue
 #include <trantor/utils/Logger.h>     // for Logger, Logger::Warn
 
-#include <chrono>         // for high_resolution_clock
+#include <algorithm>      // for any_of, min
+#include <chrono>         // for duration
+#include <climits>        // for CHAR_BIT
+#include <cstdint>        // for uint8_t
+#include <cstring>        // for memcpy
 #include <memory>         // for shared_ptr, __share...
+#include <mutex>          // for mutex, lock_guard
+#include <optional>       // for optional
+#include <stdexcept>      // for length_error
 #include <string>         // for allocator, operator+
+#include <string_view>    // for string_view
+#include <unordered_map>  // for unordered_map
 #include <unordered_set>  // for unordered_set
 #include <utility>        // for move
+#include <variant>        // for bad_variant_access
 #include <vector>         // for vector
 
 #include "amdinfer/buffers/buffer.hpp"            // for BufferPtr
+#include "amdinfer/buffers/cpu.hpp"               // for CpuBuffer
 #include "amdinfer/build_options.hpp"             // for AMDINFER_ENABLE_TRACING
 #include "amdinfer/clients/http_internal.hpp"     // for propagate, errorHtt...
+#include "amdinfer/clients/json_writer.hpp"       // for JsonWriter
+#include "amdinfer/core/bytes_tensor.hpp"         // for BytesView, getBytesSize
 #include "amdinfer/core/exceptions.hpp"           // for runtime_error, inva...
 #include "amdinfer/core/inference_request.hpp"    // for InferenceRequest
 #include "amdinfer/core/inference_response.hpp"   // for InferenceResponse
+#include "amdinfer/core/model_repository.hpp"     // for versionEndpoint
 #include "amdinfer/core/parameters.hpp"           // for ParameterMap
 #include "amdinfer/core/request_container.hpp"    // for ParameterMap
+#include "amdinfer/core/request_timing.hpp"       // for RequestTiming
+#include "amdinfer/core/shared_memory.hpp"        // for SharedMemoryTensors
 #include "amdinfer/core/shared_state.hpp"         // for SharedState
+#include "amdinfer/core/tenant_limiter.hpp"       // for TenantLimiter, Ten...
+#include "amdinfer/core/worker_info.hpp"          // for EndpointState
 #include "amdinfer/observation/logging.hpp"       // for Logger, AMDINFER_LOG...
 #include "amdinfer/observation/metrics.hpp"       // for Metrics, MetricCoun...
 #include "amdinfer/observation/tracing.hpp"       // for startTrace, Trace
+#include "amdinfer/servers/http_parser.hpp"       // for parseJsonRequest
+#include "amdinfer/servers/server_internal.hpp"   // for recordStartupPhase
 #include "amdinfer/servers/websocket_server.hpp"  // for WebsocketServer
+#include "amdinfer/util/base64.hpp"               // for base64Decode
 #include "amdinfer/util/compression.hpp"          // for zDecompress
 #include "amdinfer/util/containers.hpp"           // for containerProduct
+#include "amdinfer/util/profiler.hpp"             // for CpuProfiler
 #include "amdinfer/util/string.hpp"               // for toLower
+#include "amdinfer/util/timer.hpp"                // for getTime
+#include "amdinfer/workers/worker.hpp"            // for WorkerStatus
 
 using drogon::HttpRequestPtr;
 using drogon::HttpResponse;
@@ -58,8 +82,11 @@ namespace amdinfer {
 
 namespace http {
 
-void start(SharedState *state, uint16_t port) {
-  auto controller = std::make_shared<HttpServer>(state);
+void start(SharedState *state, uint16_t port, HttpServerOptions options) {
+  const auto start_time = util::getTime();
+  auto controller =
+    std::make_shared<HttpServer>(state, options.debug_endpoints,
+                                 options.compression, options.stream_threshold);
   auto ws_controller = std::make_shared<WebsocketServer>(state);
 
   auto &app = drogon::app();
@@ -72,14 +99,31 @@ void start(SharedState *state, uint16_t port) {
   app.setLogLevel(trantor::Logger::kFatal).setLogPath(".");
 #endif
 
-  app.addListener("0.0.0.0", port)
-    .setThreadNum(kDefaultDrogonThreads)
-    .registerPostHandlingAdvice([](const drogon::HttpRequestPtr &req,
-                                   const drogon::HttpResponsePtr &resp) {
+  if (options.cors) {
+    app.registerPostHandlingAdvice([](const drogon::HttpRequestPtr &req,
+                                      const drogon::HttpResponsePtr &resp) {
       (void)req;  // suppress unused variable warning
       resp->addHeader("Access-Control-Allow-Origin", "*");
-    })
-    .setClientMaxBodySize(kMaxClientBodySize)
+    });
+  }
+
+  // this runs once the listener is open and the event loops have started
+  app.registerBeginningAdvice([start_time]() {
+    const std::chrono::duration<double> duration =
+      util::getTime() - start_time;
+    recordStartupPhase("http", duration.count());
+  });
+
+  app.addListener("0.0.0.0", port)
+    .setThreadNum(options.threads)
+    .setClientMaxBodySize(options.max_body_size)
+    .setIdleConnectionTimeout(options.idle_connection_timeout)
+    .setKeepaliveRequestsNumber(options.keepalive_requests)
+    .setPipeliningRequestsNumber(options.pipelining_requests)
+    .setMaxConnectionNum(options.max_connections)
+    .setMaxConnectionNumPerIP(options.max_connections_per_ip)
+    // responses are compressed by the server per its compression options
+    .enableGzip(false)
     .disableSigtermHandling()
     // .enableRunAsDaemon()
     .run();
@@ -89,69 +133,212 @@ void stop() { drogon::app().quit(); }
 
 }  // namespace http
 
-std::shared_ptr<Json::Value> parseJson(const drogon::HttpRequest *req) {
-#ifdef AMDINFER_ENABLE_LOGGING
-  Logger logger{Loggers::Server};
-#endif
+/// Checks if the data starts with a zlib header, which can't start a JSON body
+bool isZlibStream(std::string_view data) {
+  // a CMF byte of 0x78 is deflate with a 32K window, as zlib writes by default,
+  // and the CMF and FLG bytes together must be a multiple of 31
+  const auto cmf_deflate = 0x78;
+  const auto fcheck_divisor = 31;
+  if (data.size() < 2) {
+    return false;
+  }
+  const auto cmf = static_cast<uint8_t>(data[0]);
+  const auto flg = static_cast<uint8_t>(data[1]);
+  return cmf == cmf_deflate &&
+         ((cmf << CHAR_BIT) | flg) % fcheck_divisor == 0;
+}
 
-  // attempt to get the JSON object directly first
-  const auto &json_obj = req->getJsonObject();
-  if (json_obj != nullptr) {
-    return json_obj;
+/**
+ * @brief Get the body of a request. If its Content-Encoding header is gzip or
+ * deflate, the body is decompressed once into storage, which must outlive the
+ * returned view. Like uncompressed bodies, it may be at most the maximum body
+ * size once decompressed.
+ *
+ * @param req the HTTP request
+ * @param storage holds the decompressed body, if needed
+ * @return std::string_view
+ */
+std::string_view getBody(const drogon::HttpRequest *req, std::string *storage) {
+  auto body = req->body();
+  const auto &header = req->getHeader("content-encoding");
+  const auto encoding = util::parseContentEncoding(header);
+  if (encoding != Compression::None) {
+    *storage = util::decompress(body, drogon::app().getClientMaxBodySize());
+    body = *storage;
   }
+  return body;
+}
 
-  AMDINFER_LOG_DEBUG(logger, "Failed to get JSON data directly");
+/**
+ * @brief Parse the JSON body of an inference request, keeping the data arrays
+ * of the inputs out of the DOM. Besides bodies with a Content-Encoding header,
+ * a zlib-compressed body is recognized by its header and decompressed once
+ * into storage, which must outlive the returned data views.
+ *
+ * @param req the HTTP request
+ * @param storage holds the decompressed body, if needed
+ * @param data the raw text of the data array of each input
+ * @return std::shared_ptr<Json::Value>
+ */
+std::shared_ptr<Json::Value> parseJson(const drogon::HttpRequest *req,
+                                       std::string *storage,
+                                       std::vector<std::string_view> *data) {
+  auto body = getBody(req, storage);
+  if (isZlibStream(body)) {
+    *storage = util::zDecompress(body.data(), static_cast<int>(body.size()));
+    body = *storage;
+  }
 
-  // if it's not valid, then we need to attempt to parse the body
-  auto root = std::make_shared<Json::Value>();
+  return parseJsonRequest(body, data);
+}
 
-  std::string errors;
-  Json::CharReaderBuilder builder;
-  Json::CharReader *reader = builder.newCharReader();
-  auto body = req->getBody();
-  bool success =
-    reader->parse(body.data(), body.data() + body.size(), root.get(), &errors);
-  if (success) {
-    return root;
+/**
+ * @brief Tracks which outputs of a request should be returned as binary data
+ * using the binary tensor data extension. An output's "binary_data" parameter
+ * takes precedence over the request's "binary_data_output" parameter.
+ */
+class BinaryOutputs {
+ public:
+  explicit BinaryOutputs(const InferenceRequest &request) {
+    all_ = getFlag(request.getParameters(), "binary_data_output");
+    any_ = all_;
+    for (const auto &output : request.getOutputs()) {
+      const auto &parameters = output.getParameters();
+      if (parameters.has("binary_data")) {
+        auto flag = getFlag(parameters, "binary_data");
+        outputs_.try_emplace(output.getName(), flag);
+        any_ = any_ || flag;
+      }
+    }
   }
 
-  AMDINFER_LOG_DEBUG(logger, "Failed to interpret body as JSON data");
+  /// Checks if any output may be returned as binary data
+  [[nodiscard]] bool any() const { return any_; }
 
-  // if it's still not valid, attempt to uncompress the body and convert to JSON
-  auto body_decompress = util::zDecompress(body.data(), body.length());
-  success = reader->parse(body_decompress.data(),
-                          body_decompress.data() + body_decompress.size(),
-                          root.get(), &errors);
-  if (success) {
-    return root;
+  /// Checks if the named output should be returned as binary data
+  [[nodiscard]] bool contains(const std::string &name) const {
+    auto iter = outputs_.find(name);
+    return iter != outputs_.end() ? iter->second : all_;
   }
 
-  throw invalid_argument("Failed to interpret request body as JSON");
-}
+ private:
+  static bool getFlag(const ParameterMap &parameters, const std::string &key) {
+    if (!parameters.has(key)) {
+      return false;
+    }
+    try {
+      return parameters.get<bool>(key);
+    } catch (const std::bad_variant_access &) {
+      throw invalid_argument("Parameter '" + key + "' must be a boolean");
+    }
+  }
 
-Json::Value parseResponse(InferenceResponse response) {
-  Json::Value ret;
-  ret["model_name"] = response.getModel();
-  ret["outputs"] = Json::arrayValue;
-  ret["id"] = response.getID();
-  auto outputs = response.getOutputs();
-  for (const InferenceResponseOutput &output : outputs) {
-    Json::Value json_output;
-    json_output["name"] = output.getName();
-    json_output["parameters"] = Json::objectValue;
-    json_output["data"] = Json::arrayValue;
-    json_output["shape"] = Json::arrayValue;
-    json_output["datatype"] = output.getDatatype().str();
-    const auto &shape = output.getShape();
-    for (const size_t &index : shape) {
-      json_output["shape"].append(static_cast<Json::UInt>(index));
+  bool all_ = false;
+  bool any_ = false;
+  std::unordered_map<std::string, bool> outputs_;
+};
+
+/**
+ * @brief Write an output of a response. Outputs in shared memory and binary
+ * outputs only have their parameters in the JSON and the rest have their data
+ * formatted straight into it.
+ *
+ * @param writer the writer of the response's JSON
+ * @param output the output
+ * @param binary_outputs the outputs to return as binary data
+ * @param shared_memory the outputs to write to shared memory
+ * @param binary the binary data of the response, which points into the outputs
+ */
+void writeOutput(JsonWriter *writer, const InferenceResponseOutput &output,
+                 const BinaryOutputs &binary_outputs,
+                 const SharedMemoryTensors &shared_memory,
+                 std::vector<std::string_view> *binary) {
+  const auto &name = output.getName();
+  const auto datatype = output.getDatatype();
+  writer->beginObject();
+  writer->key("name");
+  writer->string(name);
+  writer->key("datatype");
+  writer->string(datatype.str());
+  writer->key("shape");
+  writer->beginArray();
+  if (datatype == DataType::Bytes) {
+    const BytesView elements{output.getData(), output.getSize()};
+    writer->number(static_cast<uint64_t>(elements.size()));
+  } else {
+    for (const auto &dim : output.getShape()) {
+      writer->number(dim);
     }
+  }
+  writer->endArray();
+
+  writer->key("parameters");
+  if (datatype != DataType::Bytes && shared_memory.containsOutput(name)) {
+    writer->json(mapParametersToJson(shared_memory.writeOutput(output)));
+  } else if (datatype != DataType::String && binary_outputs.contains(name)) {
+    // the data of BYTES outputs is in the layout of the binary extension
+    const auto size = output.getSize() * datatype.size();
+    binary->emplace_back(static_cast<const char *>(output.getData()), size);
+    writer->beginObject();
+    writer->key(kBinaryDataSize);
+    writer->number(static_cast<uint64_t>(size));
+    writer->endObject();
+  } else {
+    writer->beginObject();
+    writer->endObject();
+    writer->key("data");
+    writer->array(datatype, output.getData(), output.getSize());
+  }
+  writer->endObject();
+}
 
-    switchOverTypes(SetInputData(), output.getDatatype(),
-                    &(json_output["data"]), output.getData(), output.getSize());
-    ret["outputs"].append(json_output);
+/**
+ * @brief Write the JSON of a response without building a JSON DOM. The body is
+ * reserved up front for the data of its outputs so it's written in one pass.
+ *
+ * @param response the response
+ * @param binary_outputs the outputs to return as binary data
+ * @param shared_memory the outputs to write to shared memory
+ * @param timing the timing of the request to add to the response, if any
+ * @param binary the binary data of the response, which points into the outputs
+ * @return std::string
+ */
+std::string writeResponse(const InferenceResponse &response,
+                          const BinaryOutputs &binary_outputs,
+                          const SharedMemoryTensors &shared_memory,
+                          const RequestTiming *timing,
+                          std::vector<std::string_view> *binary) {
+  // room for the names, shapes, parameters and other metadata
+  const size_t metadata_size = 256;
+  const auto &outputs = response.getOutputs();
+  auto size = metadata_size;
+  for (const auto &output : outputs) {
+    size += metadata_size;
+    if (!binary_outputs.contains(output.getName())) {
+      size += getMaxJsonSize(output.getDatatype(), output.getSize());
+    }
+  }
+  std::string body;
+  body.reserve(size);
+
+  JsonWriter writer{&body};
+  writer.beginObject();
+  writer.key("model_name");
+  writer.string(response.getModel());
+  writer.key("id");
+  writer.string(response.getID());
+  if (timing != nullptr) {
+    writer.key("parameters");
+    writer.json(mapParametersToJson(timing->parameters()));
+  }
+  writer.key("outputs");
+  writer.beginArray();
+  for (const InferenceResponseOutput &output : outputs) {
+    writeOutput(&writer, output, binary_outputs, shared_memory, binary);
   }
-  return ret;
+  writer.endArray();
+  writer.endObject();
+  return body;
 }
 
 struct WriteData {
@@ -175,9 +362,155 @@ drogon::HttpResponsePtr errorHttpResponse(const std::string &error,
   return resp;
 }
 
+/**
+ * @brief Get the size of the binary data of a response, which writeOutput()
+ * writes for the binary outputs that aren't in shared memory
+ *
+ * @param response the response
+ * @param binary_outputs the outputs to return as binary data
+ * @param shared_memory the outputs to write to shared memory
+ * @return size_t
+ */
+size_t getBinarySize(const InferenceResponse &response,
+                     const BinaryOutputs &binary_outputs,
+                     const SharedMemoryTensors &shared_memory) {
+  size_t size = 0;
+  for (const auto &output : response.getOutputs()) {
+    const auto &name = output.getName();
+    const auto datatype = output.getDatatype();
+    if ((datatype == DataType::Bytes || !shared_memory.containsOutput(name)) &&
+        datatype != DataType::String && binary_outputs.contains(name)) {
+      size += output.getSize() * datatype.size();
+    }
+  }
+  return size;
+}
+
+/**
+ * @brief Create a response using the binary tensor data extension where the
+ * JSON is followed by the raw bytes of the binary outputs
+ *
+ * @param json the JSON text of the response
+ * @param binary the binary data of the outputs
+ * @return drogon::HttpResponsePtr
+ */
+drogon::HttpResponsePtr binaryHttpResponse(
+  std::string json, const std::vector<std::string_view> &binary) {
+  auto body = std::move(json);
+  const auto header_length = body.size();
+  auto size = header_length;
+  for (const auto &data : binary) {
+    size += data.size();
+  }
+  body.reserve(size);
+  for (const auto &data : binary) {
+    body.append(data);
+  }
+
+  auto resp = drogon::HttpResponse::newHttpResponse();
+  resp->addHeader(kInferenceHeaderContentLength,
+                  std::to_string(header_length));
+  resp->setContentTypeCode(drogon::ContentType::CT_APPLICATION_OCTET_STREAM);
+  resp->setBody(std::move(body));
+  return resp;
+}
+
+/**
+ * @brief Create a response using the binary tensor data extension that's sent
+ * with chunked transfer encoding. The JSON goes first and then the binary
+ * outputs are copied into the chunks straight from their buffers so the body
+ * is never assembled in memory and its first bytes are sent sooner.
+ *
+ * @param response the response, which is kept until the last chunk is sent
+ * @param json the JSON text of the response
+ * @param binary the binary data of the outputs, which points into the response
+ * @return drogon::HttpResponsePtr
+ */
+drogon::HttpResponsePtr streamHttpResponse(
+  std::shared_ptr<const InferenceResponse> response, std::string json,
+  std::vector<std::string_view> binary) {
+  const auto header_length = json.size();
+  struct Stream {
+    std::shared_ptr<const InferenceResponse> response;
+    std::string json;
+    std::vector<std::string_view> segments;
+    size_t index = 0;
+  };
+  auto stream = std::make_shared<Stream>();
+  stream->response = std::move(response);
+  stream->json = std::move(json);
+  stream->segments.reserve(binary.size() + 1);
+  stream->segments.emplace_back(stream->json);
+  stream->segments.insert(stream->segments.end(), binary.begin(),
+                          binary.end());
+
+  auto resp = drogon::HttpResponse::newStreamResponse(
+    [stream](char *buffer, size_t size) -> size_t {
+      // it's called without a buffer once the stream is done or aborted
+      if (buffer == nullptr) {
+        stream->response.reset();
+        return 0;
+      }
+      size_t written = 0;
+      auto &segments = stream->segments;
+      while (written < size && stream->index < segments.size()) {
+        auto &segment = segments[stream->index];
+        const auto count = std::min(size - written, segment.size());
+        std::memcpy(buffer + written, segment.data(), count);
+        written += count;
+        segment.remove_prefix(count);
+        if (segment.empty()) {
+          stream->index++;
+        }
+      }
+      return written;
+    },
+    "", drogon::ContentType::CT_APPLICATION_OCTET_STREAM);
+  resp->addHeader(kInferenceHeaderContentLength,
+                  std::to_string(header_length));
+  return resp;
+}
+
 using DrogonCallback = std::function<void(const drogon::HttpResponsePtr &)>;
 
-HttpServer::HttpServer(SharedState *state) : state_(state) {
+/**
+ * @brief Admit a call under its tenant's limits, if there are any. An admitted
+ * call's callback is wrapped to give up its place in flight as it responds and
+ * a call that's turned away fails with status 429
+ *
+ * @param state the server's state
+ * @param req the call
+ * @param callback the call's callback
+ * @return bool true if the call was admitted
+ */
+bool admitTenant(SharedState *state, const HttpRequestPtr &req,
+                 DrogonCallback *callback) {
+  auto *limiter = state->getTenantLimiter();
+  if (limiter == nullptr) {
+    return true;
+  }
+  auto ticket =
+    limiter->admit(req->getHeader(limiter->header()), req->body().size());
+  if (ticket.rejected()) {
+    (*callback)(errorHttpResponse(toString(ticket.rejection()),
+                                  HttpStatusCode::k429TooManyRequests));
+    return false;
+  }
+  *callback = [callback = std::move(*callback),
+               ticket = std::make_shared<TenantTicket>(std::move(ticket))](
+                const HttpResponsePtr &resp) {
+    ticket->release();
+    callback(resp);
+  };
+  return true;
+}
+
+HttpServer::HttpServer(SharedState *state, bool debug,
+                       CompressionOptions compression, size_t stream_threshold)
+  : state_(state),
+    debug_(debug),
+    compression_(compression),
+    stream_threshold_(stream_threshold) {
   AMDINFER_LOG_DEBUG(logger_, "Constructed HttpServer");
 }
 
@@ -213,10 +546,20 @@ void HttpServer::getServerReady(
 #endif
   (void)req;  // suppress unused variable warning
 
-  // for now, assuming that server is always ready (assumes that user has loaded
-  // all the required models).
+  // the server is ready once the models in the repository at startup have
+  // loaded. Until then, report how far along the loads are
+  if (state_->serverReady()) {
+    callback(HttpResponse::newHttpResponse());
+    return;
+  }
 
-  auto resp = HttpResponse::newHttpResponse();
+  const auto progress = state_->repositoryProgress();
+  Json::Value ret;
+  ret["models"] = static_cast<Json::UInt64>(progress.models);
+  ret["loaded"] = static_cast<Json::UInt64>(progress.loaded);
+  ret["failed"] = static_cast<Json::UInt64>(progress.failed);
+  auto resp = HttpResponse::newHttpJsonResponse(ret);
+  resp->setStatusCode(HttpStatusCode::k503ServiceUnavailable);
   callback(resp);
 }
 
@@ -308,6 +651,19 @@ void HttpServer::modelList(
   callback(resp);
 }
 
+void HttpServer::peerLoad(
+  [[maybe_unused]] const HttpRequestPtr &req,
+  std::function<void(const HttpResponsePtr &)> &&callback) const {
+  // peers fetch it often so it's not logged at a higher level
+  AMDINFER_LOG_DEBUG(logger_, "Received peerLoad request");
+  Json::Value json;
+  json["endpoints"] = Json::objectValue;
+  for (const auto &[endpoint, queued] : state_->peerLoad()) {
+    json["endpoints"][endpoint] = static_cast<Json::UInt64>(queued);
+  }
+  callback(HttpResponse::newHttpJsonResponse(json));
+}
+
 void HttpServer::hasHardware(
   const HttpRequestPtr &req,
   std::function<void(const HttpResponsePtr &)> &&callback) const {
@@ -334,8 +690,87 @@ void HttpServer::hasHardware(
   callback(resp);
 }
 
-InferenceRequestInput getInput(const Json::Value &json,
-                               const MemoryPool *pool) {
+/**
+ * @brief Read an input's binary data where it is in the body, which outlives
+ * the request, instead of copying it into a buffer from the pool. It's
+ * written into the batch by an input writer or read in place by the worker.
+ *
+ * @param input the input
+ * @param binary the binary data of the request, starting at the input's
+ * @param size the size of the input's binary data
+ * @param container the container to add the input's writer and view to
+ */
+void viewBinaryData(InferenceRequestInput *input, std::string_view *binary,
+                    size_t size, RequestContainer *container) {
+  const auto *data = binary->data();
+  container->input_writers.emplace_back(
+    [data, size](Buffer *buffer, size_t offset) {
+      buffer->write(data, offset, size);
+    });
+  container->input_views.push_back(data);
+  binary->remove_prefix(size);
+  input->setData(nullptr);
+}
+
+/**
+ * @brief Set the data of a BYTES input. Its shape counts its elements so it's
+ * checked against them and then replaced with the size of their encoding.
+ *
+ * @param input the input, whose shape is the request's
+ * @param pool the pool to allocate its buffer from
+ * @param binary the binary data of the request, if it uses that extension
+ * @param binary_size the size of the input's binary data, if it has any
+ * @param data_text the raw text of the input's data array, if it was parsed
+ * @param json the input
+ * @param views if set, binary data is read in place through this container
+ */
+void setBytesData(InferenceRequestInput *input, const MemoryPool *pool,
+                  std::string_view *binary, std::optional<size_t> binary_size,
+                  std::string_view data_text, const Json::Value &json,
+                  RequestContainer *views) {
+  const auto shape = input->getShape();
+  if (binary_size.has_value()) {
+    const auto size = binary_size.value();
+    if (size > binary->size()) {
+      throw invalid_argument("Binary data for input " + input->getName() +
+                             " exceeds the body");
+    }
+    // the raw data is already in the layout BYTES tensors use
+    checkBytesShape(BytesView{binary->data(), size}.size(), shape,
+                    input->getName());
+    input->setShape({size});
+    if (views != nullptr) {
+      viewBinaryData(input, binary, size, views);
+      return;
+    }
+    auto buffer = pool->get({MemoryAllocators::Cpu}, *input, 1);
+    buffer->write(binary->data(), 0, size);
+    binary->remove_prefix(size);
+    input->setData(buffer->data(0));
+    return;
+  }
+
+  std::vector<std::string> elements;
+  if (!data_text.empty()) {
+    elements = parseJsonStrings(data_text);
+  } else if (json.isMember("data")) {
+    elements = getJsonStrings(json["data"]);
+  } else {
+    throw invalid_argument("No 'data' key present in request input");
+  }
+  checkBytesShape(elements.size(), shape, input->getName());
+  input->setShape({getBytesSize(elements)});
+  auto buffer = pool->get({MemoryAllocators::Cpu}, *input, 1);
+  buffer->writeBytes(elements, 0);
+  input->setData(buffer->data(0));
+}
+
+InferenceRequestInput getInput(const Json::Value &json, const MemoryPool *pool,
+                               std::string_view *binary,
+                               std::string_view data_text,
+                               RequestContainer *container,
+                               SharedMemoryTensors *shared_memory,
+                               bool in_place) {
   InferenceRequestInput input;
 
   input.setData(nullptr);
@@ -364,18 +799,62 @@ InferenceRequestInput getInput(const Json::Value &json,
   // getting it as CString didn't work elsewhere
   auto data_type_str = json.get("datatype", "").asString();
   input.setDatatype(DataType(data_type_str.c_str()));
+  std::optional<size_t> binary_size;
   if (json.isMember("parameters")) {
     auto parameters = json.get("parameters", Json::objectValue);
+    if (parameters.isMember(kBinaryDataSize)) {
+      if (!parameters[kBinaryDataSize].isUInt64()) {
+        throw invalid_argument("'binary_data_size' must be a uint64");
+      }
+      binary_size = parameters[kBinaryDataSize].asUInt64();
+      parameters.removeMember(kBinaryDataSize);
+    }
     input.setParameters(mapJsonToParameters(parameters));
   }
 
+  if (input.getDatatype() == DataType::Bytes) {
+    setBytesData(&input, pool, binary, binary_size, data_text, json,
+                 in_place ? container : nullptr);
+    return input;
+  }
+
+  if (shared_memory->addInput(input, container)) {
+    return input;
+  }
+
+  if (binary_size.has_value()) {
+    const auto size = binary_size.value();
+    if (size != input.getSize() * input.getDatatype().size()) {
+      throw invalid_argument("Binary data size of input " + input.getName() +
+                             " does not match its shape and datatype");
+    }
+    if (size > binary->size()) {
+      throw invalid_argument("Binary data for input " + input.getName() +
+                             " exceeds the body");
+    }
+    if (in_place) {
+      viewBinaryData(&input, binary, size, container);
+      return input;
+    }
+    auto buffer = pool->get({MemoryAllocators::Cpu}, input, 1);
+    buffer->write(binary->data(), 0, size);
+    binary->remove_prefix(size);
+    input.setData(buffer->data(0));
+    return input;
+  }
+
   auto buffer = pool->get({MemoryAllocators::Cpu}, input, 1);
+  size_t offset = 0;
+  input.setData(buffer->data(offset));
+  if (!data_text.empty()) {
+    parseJsonArray(data_text, input.getDatatype(), buffer.get());
+    return input;
+  }
+
   if (!json.isMember("data")) {
     throw invalid_argument("No 'data' key present in request input");
   }
   auto data = json.get("data", Json::arrayValue);
-  size_t offset = 0;
-  input.setData(buffer->data(offset));
   try {
     for (auto const &i : data) {
       offset = switchOverTypes(WriteData(), input.getDatatype(), buffer.get(),
@@ -399,17 +878,78 @@ InferenceRequestOutput getOutput(const Json::Value &json) {
   return output;
 }
 
-void setCallback(InferenceRequest *request, DrogonCallback &&drogon_callback) {
-  Callback callback = [callback = std::move(drogon_callback)](
-                        const InferenceResponse &response) {
+/**
+ * @brief Compress the body of a successful response with the negotiated
+ * algorithm if it's large enough to be worth it
+ *
+ * @param resp the response to compress
+ * @param compression the negotiated algorithm and the threshold
+ */
+void compressResponse(drogon::HttpResponse *resp,
+                      const CompressionOptions &compression) {
+  if (compression.algorithm == Compression::None ||
+      resp->body().size() < compression.threshold) {
+    return;
+  }
+  resp->setBody(util::compress(resp->body(), compression.algorithm));
+  resp->addHeader("Content-Encoding",
+                  util::getEncodingName(compression.algorithm));
+}
+
+void setCallback(InferenceRequest *request, DrogonCallback &&drogon_callback,
+                 SharedMemoryTensors shared_memory, const std::string &model,
+                 RequestTimingPtr timing, CompressionOptions compression,
+                 size_t stream_threshold, std::shared_ptr<const void> body) {
+  // evaluated first since it may throw and the callback isn't yet moved from
+  BinaryOutputs outputs{*request};
+  ResponseCallback callback = [callback = std::move(drogon_callback),
+                               binary_outputs = std::move(outputs),
+                               shared_memory = std::move(shared_memory), model,
+                               timing = std::move(timing), compression,
+                               stream_threshold,
+                               // the inputs read in place need the body
+                               body = std::move(body)](
+                                const InferenceResponse &response) {
     drogon::HttpResponsePtr resp;
     if (response.isError()) {
       resp =
         errorHttpResponse(response.getError(), HttpStatusCode::k400BadRequest);
     } else {
       try {
-        Json::Value ret = parseResponse(response);
-        resp = drogon::HttpResponse::newHttpJsonResponse(ret);
+#ifdef AMDINFER_ENABLE_METRICS
+        const auto start = util::getTime();
+#endif
+        // large binary responses that aren't compressed are streamed, which
+        // needs the response's outputs to outlive this callback. Its copy
+        // shares the outputs' data with it
+        std::shared_ptr<const InferenceResponse> streamed;
+        if (binary_outputs.any() && stream_threshold > 0 &&
+            compression.algorithm == Compression::None &&
+            getBinarySize(response, binary_outputs, shared_memory) >=
+              stream_threshold) {
+          streamed = std::make_shared<InferenceResponse>(response);
+        }
+        const auto &source = streamed != nullptr ? *streamed : response;
+        std::vector<std::string_view> binary;
+        auto json = writeResponse(source, binary_outputs, shared_memory,
+                                  timing.get(), &binary);
+        if (streamed != nullptr) {
+          resp = streamHttpResponse(std::move(streamed), std::move(json),
+                                    std::move(binary));
+        } else if (binary_outputs.any()) {
+          resp = binaryHttpResponse(std::move(json), binary);
+        } else {
+          resp = drogon::HttpResponse::newHttpResponse();
+          resp->setContentTypeCode(drogon::ContentType::CT_APPLICATION_JSON);
+          resp->setBody(std::move(json));
+        }
+        compressResponse(resp.get(), compression);
+#ifdef AMDINFER_ENABLE_METRICS
+        const std::chrono::duration<double, std::micro> duration =
+          util::getTime() - start;
+        Metrics::getInstance().observeHistogram(
+          MetricHistogramIDs::ResponseSerialization, model, duration.count());
+#endif
       } catch (const invalid_argument &e) {
         resp = errorHttpResponse(e.what(), HttpStatusCode::k400BadRequest);
       }
@@ -423,8 +963,35 @@ void setCallback(InferenceRequest *request, DrogonCallback &&drogon_callback) {
   request->setCallback(std::move(callback));
 }
 
+/**
+ * @brief Move an input's data out of its pool buffer into an input writer so
+ * it can be written into the batch along with inputs in shared memory. The
+ * buffer goes back to the pool with the writer.
+ *
+ * @param input the input to defer
+ * @param pool the pool the input's buffer is from
+ * @param container the container to add the writer to
+ */
+void deferInput(InferenceRequestInput *input, const MemoryPool *pool,
+                RequestContainer *container) {
+  const auto bytes = input->getSize() * input->getDatatype().size();
+  std::shared_ptr<std::byte> data{
+    static_cast<std::byte *>(input->getData()), [pool, bytes](std::byte *ptr) {
+      pool->put(std::make_unique<CpuBuffer>(ptr, MemoryAllocators::Cpu, bytes));
+    }};
+  container->input_writers.emplace_back(
+    [data = std::move(data), bytes](Buffer *buffer, size_t offset) {
+      buffer->write(data.get(), offset, bytes);
+    });
+  input->setData(nullptr);
+}
+
 InferenceRequestPtr getRequest(const std::shared_ptr<Json::Value> &json,
-                               const MemoryPool *pool) {
+                               const MemoryPool *pool, std::string_view binary,
+                               const std::vector<std::string_view> &data,
+                               RequestContainer *container,
+                               SharedMemoryTensors *shared_memory,
+                               bool in_place) {
   auto request = std::make_shared<InferenceRequest>();
 
   if (json->isMember("id")) {
@@ -447,13 +1014,40 @@ InferenceRequestPtr getRequest(const std::shared_ptr<Json::Value> &json,
 
   request->setCallback(nullptr);
 
+  // without a container, requests that use shared memory are rejected
+  SharedMemoryTensors unsupported;
+  if (container == nullptr || shared_memory == nullptr) {
+    shared_memory = &unsupported;
+  }
+  // input writers are used for all the inputs or none so if any input is in
+  // shared memory or read in place from the body, the others are deferred too
+  in_place = in_place && container != nullptr && !binary.empty();
+  const auto deferred =
+    container != nullptr &&
+    (in_place ||
+     std::any_of(inputs.begin(), inputs.end(), [](const Json::Value &input) {
+       return input.isObject() && input["parameters"].isObject() &&
+              input["parameters"].isMember(kSharedMemoryRegion);
+     }));
+
   const auto input_num = inputs.size();
   for (auto i = 0U; i < input_num; ++i) {
     const auto &input = inputs[i];
     if (!input.isObject()) {
       throw invalid_argument("At least one element in 'inputs' is not an obj");
     }
-    request->addInputTensor(getInput(input, pool));
+    auto data_text = i < data.size() ? data[i] : std::string_view{};
+    auto tensor = getInput(input, pool, &binary, data_text, container,
+                           shared_memory, in_place);
+    if (deferred && tensor.getData() != nullptr) {
+      deferInput(&tensor, pool, container);
+    }
+    request->addInputTensor(std::move(tensor));
+  }
+  // inputs can only be read in place if they're all in shared memory or the
+  // body
+  if (deferred && container->input_views.size() != input_num) {
+    container->input_views.clear();
   }
 
   if (json->isMember("outputs")) {
@@ -465,6 +1059,7 @@ InferenceRequestPtr getRequest(const std::shared_ptr<Json::Value> &json,
       request->addOutputTensor(getOutput(json_output));
     }
   }
+  shared_memory->addOutputs(*request);
 
   return request;
 }
@@ -480,37 +1075,287 @@ void HttpServer::modelInfer(
 
   AMDINFER_LOG_INFO(logger_, "Received modelInfer request for " + model);
 #ifdef AMDINFER_ENABLE_METRICS
-  auto now = std::chrono::high_resolution_clock::now();
+  auto now = util::getTime();
   Metrics::getInstance().incrementCounter(MetricCounterIDs::RestPost);
 #endif
+  if (!admitTenant(state_, req, &callback)) {
+    return;
+  }
 
 #ifdef AMDINFER_ENABLE_TRACING
   trace->startSpan("request_handler");
 #endif
 
-  auto json = req->getJsonObject();
+  // the request's callback shares this one so a request that the endpoint
+  // turns away after its callback is set can still be answered here
+  auto respond = std::make_shared<DrogonCallback>(std::move(callback));
   try {
-    auto request = getRequest(json, state_->getPool());
-    setCallback(request.get(), std::move(callback));
+    std::shared_ptr<Json::Value> json;
+    std::string_view binary;
+    std::string storage;
+    std::vector<std::string_view> data;
+    // the binary data is read in place from the body so it's kept alive with
+    // the request instead of being copied into buffers from the pool
+    std::shared_ptr<const void> body_owner;
+    const auto &header_length = req->getHeader(kInferenceHeaderContentLength);
+    if (header_length.empty()) {
+      json = parseJson(req.get(), &storage, &data);
+    } else {
+      json = std::make_shared<Json::Value>();
+      auto decompressed = std::make_shared<std::string>();
+      const auto body = getBody(req.get(), decompressed.get());
+      binary = splitBinaryBody(body, header_length, json.get());
+      if (decompressed->empty()) {
+        body_owner = req;
+      } else {
+        body_owner = std::move(decompressed);
+      }
+    }
     auto request_container = std::make_unique<RequestContainer>();
+    SharedMemoryTensors shared_memory{state_->getSharedMemory()};
+    auto request =
+      getRequest(json, state_->getPool(), binary, data, request_container.get(),
+                 &shared_memory, body_owner != nullptr);
+    if (RequestTiming::requested(request->getParameters())) {
+      request_container->timing = std::make_shared<RequestTiming>();
+    }
+    // responses are compressed with the preferred algorithm, if accepted
+    auto compression = compression_;
+    compression.algorithm = util::negotiateEncoding(
+      req->getHeader("accept-encoding"), compression_.algorithm);
+    setCallback(
+      request.get(),
+      [respond](const HttpResponsePtr &resp) { (*respond)(resp); },
+      std::move(shared_memory), model, request_container->timing, compression,
+      stream_threshold_, std::move(body_owner));
     request_container->request = request;
 #ifdef AMDINFER_ENABLE_METRICS
     request_container->start_time = now;
+    const std::chrono::duration<double, std::micro> parse =
+      util::getTime() - now;
+    Metrics::getInstance().observeHistogram(MetricHistogramIDs::IngressParse,
+                                            model, parse.count());
 #endif
 #ifdef AMDINFER_ENABLE_TRACING
     trace->endSpan();
     request_container->trace = std::move(trace);
 #endif
     state_->modelInfer(model, std::move(request_container));
+  } catch (const resource_exhausted_error &e) {
+    AMDINFER_LOG_DEBUG(logger_, e.what());
+    auto resp =
+      errorHttpResponse(e.what(), HttpStatusCode::k503ServiceUnavailable);
+#ifdef AMDINFER_ENABLE_TRACING
+    // the trace is moved into the request once it's submitted
+    if (trace != nullptr) {
+      auto context = trace->propagate();
+      propagate(resp.get(), context);
+    }
+#endif
+    (*respond)(resp);
   } catch (const invalid_argument &e) {
     AMDINFER_LOG_INFO(logger_, e.what());
     auto resp = errorHttpResponse(e.what(), HttpStatusCode::k400BadRequest);
 #ifdef AMDINFER_ENABLE_TRACING
-    auto context = trace->propagate();
-    propagate(resp.get(), context);
+    if (trace != nullptr) {
+      auto context = trace->propagate();
+      propagate(resp.get(), context);
+    }
 #endif
-    callback(resp);
+    (*respond)(resp);
+  }
+}
+
+/**
+ * @brief Collects the responses to the requests of an infer_batch call and
+ * sends them in one HTTP response once the last one arrives. Each response is
+ * written to its own slot so they're returned in the order of the requests.
+ */
+class BatchResponses {
+ public:
+  BatchResponses(size_t size, DrogonCallback callback,
+                 CompressionOptions compression)
+    : responses_(size),
+      // the call itself holds one until all the requests are submitted
+      remaining_(size + 1),
+      callback_(std::move(callback)),
+      compression_(compression) {}
+
+  /// Set the JSON of the response to a request
+  void set(size_t index, std::string json) {
+    {
+      std::lock_guard lock{mutex_};
+      responses_.at(index) = std::move(json);
+    }
+    release();
+  }
+
+  /// Mark a request or the call as done and send the responses if it's last
+  void release() {
+    {
+      std::lock_guard lock{mutex_};
+      if (--remaining_ > 0) {
+        return;
+      }
+    }
+    send();
+  }
+
+ private:
+  void send() const {
+    constexpr std::string_view kBegin = R"({"responses":[)";
+    constexpr std::string_view kEnd = "]}";
+    auto size = kBegin.size() + kEnd.size();
+    for (const auto &response : responses_) {
+      size += response.size() + 1;
+    }
+    std::string body;
+    body.reserve(size);
+    body += kBegin;
+    for (auto i = 0U; i < responses_.size(); ++i) {
+      if (i > 0) {
+        body += ',';
+      }
+      body += responses_[i];
+    }
+    body += kEnd;
+    auto resp = drogon::HttpResponse::newHttpResponse();
+    resp->setContentTypeCode(drogon::ContentType::CT_APPLICATION_JSON);
+    resp->setBody(std::move(body));
+    compressResponse(resp.get(), compression_);
+    callback_(resp);
   }
+
+  std::mutex mutex_;
+  std::vector<std::string> responses_;
+  size_t remaining_;
+  DrogonCallback callback_;
+  CompressionOptions compression_;
+};
+
+/// Write the JSON of an error in a batch's response
+std::string writeError(const std::string &error) {
+  std::string body;
+  JsonWriter writer{&body};
+  writer.beginObject();
+  writer.key("error");
+  writer.string(error);
+  writer.endObject();
+  return body;
+}
+
+void HttpServer::modelInferBatch(
+  const HttpRequestPtr &req,
+  std::function<void(const HttpResponsePtr &)> &&callback,
+  std::string const &model) const {
+  AMDINFER_LOG_INFO(logger_, "Received modelInferBatch request for " + model);
+#ifdef AMDINFER_ENABLE_METRICS
+  Metrics::getInstance().incrementCounter(MetricCounterIDs::RestPost);
+#endif
+  // the batch is admitted as one call with all of its bytes
+  if (!admitTenant(state_, req, &callback)) {
+    return;
+  }
+
+  auto json = std::make_shared<Json::Value>();
+  try {
+    std::string storage;
+    auto body = getBody(req.get(), &storage);
+    if (isZlibStream(body)) {
+      storage = util::zDecompress(body.data(), static_cast<int>(body.size()));
+      body = storage;
+    }
+    // the requests' data is in the JSON so it's parsed whole
+    splitBinaryBody(body, std::to_string(body.size()), json.get());
+    if (!json->isMember("requests") || !(*json)["requests"].isArray()) {
+      throw invalid_argument("No 'requests' array present in request");
+    }
+  } catch (const invalid_argument &e) {
+    AMDINFER_LOG_INFO(logger_, e.what());
+    callback(errorHttpResponse(e.what(), HttpStatusCode::k400BadRequest));
+    return;
+  }
+
+  auto &requests = (*json)["requests"];
+  auto compression = compression_;
+  compression.algorithm = util::negotiateEncoding(
+    req->getHeader("accept-encoding"), compression_.algorithm);
+  auto responses = std::make_shared<BatchResponses>(
+    requests.size(), std::move(callback), compression);
+  // the requests are parsed and submitted in one pass and each one fails on
+  // its own without failing the others
+  for (auto i = 0U; i < requests.size(); ++i) {
+    try {
+#ifdef AMDINFER_ENABLE_METRICS
+      const auto now = util::getTime();
+#endif
+      if (!requests[i].isObject()) {
+        throw invalid_argument("At least one element in 'requests' is not an "
+                               "obj");
+      }
+      auto request_container = std::make_unique<RequestContainer>();
+      SharedMemoryTensors shared_memory{state_->getSharedMemory()};
+      // each request's JSON shares the lifetime of the batch's
+      auto request = getRequest(
+        std::shared_ptr<Json::Value>(json, &requests[i]), state_->getPool(), {},
+        {}, request_container.get(), &shared_memory);
+      BinaryOutputs binary_outputs{*request};
+      if (binary_outputs.any()) {
+        throw invalid_argument(
+          "Binary outputs aren't supported by infer_batch");
+      }
+      if (RequestTiming::requested(request->getParameters())) {
+        request_container->timing = std::make_shared<RequestTiming>();
+      }
+      request->setCallback(
+        [responses, index = i, binary_outputs = std::move(binary_outputs),
+         shared_memory = std::move(shared_memory),
+         timing = request_container->timing](
+          const InferenceResponse &response) {
+          if (response.isError()) {
+            responses->set(index, writeError(response.getError()));
+            return;
+          }
+          try {
+            responses->set(index,
+                           writeResponse(response, binary_outputs,
+                                         shared_memory, timing.get(), nullptr));
+          } catch (const invalid_argument &e) {
+            responses->set(index, writeError(e.what()));
+          }
+        });
+      request_container->request = request;
+#ifdef AMDINFER_ENABLE_METRICS
+      request_container->start_time = now;
+#endif
+      state_->modelInfer(model, std::move(request_container));
+    } catch (const runtime_error &e) {
+      AMDINFER_LOG_INFO(logger_, e.what());
+      responses->set(i, writeError(e.what()));
+    }
+  }
+  responses->release();
+}
+
+void HttpServer::getModelVersionReady(
+  const HttpRequestPtr &req,
+  std::function<void(const HttpResponsePtr &)> &&callback,
+  std::string const &model, std::string const &version) const {
+  getModelReady(req, std::move(callback), versionEndpoint(model, version));
+}
+
+void HttpServer::getModelVersionMetadata(
+  const HttpRequestPtr &req,
+  std::function<void(const HttpResponsePtr &)> &&callback,
+  std::string const &model, std::string const &version) const {
+  getModelMetadata(req, std::move(callback), versionEndpoint(model, version));
+}
+
+void HttpServer::modelVersionInfer(
+  const HttpRequestPtr &req,
+  std::function<void(const HttpResponsePtr &)> &&callback,
+  std::string const &model, std::string const &version) const {
+  modelInfer(req, std::move(callback), versionEndpoint(model, version));
 }
 
 void HttpServer::modelLoad(
@@ -646,6 +1491,287 @@ void HttpServer::workerUnload(
   callback(resp);
 }
 
+/**
+ * @brief Create a response with the status of the named shared memory region,
+ * or all regions if the name is empty
+ *
+ * @param registry the registered regions
+ * @param name name of the region
+ * @param allocator the kind of memory of the regions
+ * @return HttpResponsePtr
+ */
+HttpResponsePtr sharedMemoryStatusResponse(
+  const SharedMemoryRegistry *registry, const std::string &name,
+  MemoryAllocators allocator = MemoryAllocators::SharedMemory) {
+  try {
+    Json::Value ret = Json::arrayValue;
+    for (const auto &region : registry->status(name, allocator)) {
+      Json::Value status;
+      status["name"] = region.name;
+      // the IPC handles of GPU regions are only meaningful to the server
+      if (allocator == MemoryAllocators::HipSharedMemory) {
+        status["device_id"] = region.device;
+      } else {
+        status["key"] = region.key;
+      }
+      status["offset"] = static_cast<Json::UInt64>(region.offset);
+      status["byte_size"] = static_cast<Json::UInt64>(region.byte_size);
+      ret.append(status);
+    }
+    return HttpResponse::newHttpJsonResponse(ret);
+  } catch (const invalid_argument &e) {
+    return errorHttpResponse(e.what(), HttpStatusCode::k404NotFound);
+  }
+}
+
+void HttpServer::sharedMemoryStatus(
+  [[maybe_unused]] const HttpRequestPtr &req,
+  std::function<void(const HttpResponsePtr &)> &&callback) const {
+  AMDINFER_LOG_INFO(logger_, "Received sharedMemoryStatus request");
+  callback(sharedMemoryStatusResponse(state_->getSharedMemory(), ""));
+}
+
+void HttpServer::sharedMemoryRegionStatus(
+  [[maybe_unused]] const HttpRequestPtr &req,
+  std::function<void(const HttpResponsePtr &)> &&callback,
+  const std::string &region) const {
+  AMDINFER_LOG_INFO(logger_,
+                    "Received sharedMemoryStatus request for " + region);
+  callback(sharedMemoryStatusResponse(state_->getSharedMemory(), region));
+}
+
+void HttpServer::sharedMemoryRegister(
+  const HttpRequestPtr &req,
+  std::function<void(const HttpResponsePtr &)> &&callback,
+  const std::string &region) const {
+  AMDINFER_LOG_INFO(logger_,
+                    "Received sharedMemoryRegister request for " + region);
+
+  const auto &json = req->getJsonObject();
+  const auto body = json != nullptr ? *json : Json::Value{};
+  const auto &key = body["key"];
+  const auto offset = body.get("offset", 0);
+  const auto &byte_size = body["byte_size"];
+  if (!key.isString() || !offset.isUInt64() || !byte_size.isUInt64()) {
+    callback(errorHttpResponse(
+      "The body must have a string 'key', a uint64 'byte_size' and an "
+      "optional uint64 'offset'",
+      HttpStatusCode::k400BadRequest));
+    return;
+  }
+
+  HttpResponsePtr resp;
+  try {
+    state_->getSharedMemory()->add(
+      {region, key.asString(), offset.asUInt64(), byte_size.asUInt64()});
+    resp = HttpResponse::newHttpResponse();
+  } catch (const runtime_error &e) {
+    AMDINFER_LOG_INFO(logger_, e.what());
+    resp = errorHttpResponse(e.what(), HttpStatusCode::k400BadRequest);
+  }
+  callback(resp);
+}
+
+void HttpServer::sharedMemoryUnregister(
+  [[maybe_unused]] const HttpRequestPtr &req,
+  std::function<void(const HttpResponsePtr &)> &&callback) const {
+  AMDINFER_LOG_INFO(logger_, "Received sharedMemoryUnregister request");
+  state_->getSharedMemory()->remove("");
+  callback(HttpResponse::newHttpResponse());
+}
+
+void HttpServer::sharedMemoryRegionUnregister(
+  [[maybe_unused]] const HttpRequestPtr &req,
+  std::function<void(const HttpResponsePtr &)> &&callback,
+  const std::string &region) const {
+  AMDINFER_LOG_INFO(logger_,
+                    "Received sharedMemoryUnregister request for " + region);
+  state_->getSharedMemory()->remove(region);
+  callback(HttpResponse::newHttpResponse());
+}
+
+void HttpServer::hipSharedMemoryStatus(
+  [[maybe_unused]] const HttpRequestPtr &req,
+  std::function<void(const HttpResponsePtr &)> &&callback) const {
+  AMDINFER_LOG_INFO(logger_, "Received hipSharedMemoryStatus request");
+  callback(sharedMemoryStatusResponse(state_->getSharedMemory(), "",
+                                      MemoryAllocators::HipSharedMemory));
+}
+
+void HttpServer::hipSharedMemoryRegionStatus(
+  [[maybe_unused]] const HttpRequestPtr &req,
+  std::function<void(const HttpResponsePtr &)> &&callback,
+  const std::string &region) const {
+  AMDINFER_LOG_INFO(logger_,
+                    "Received hipSharedMemoryStatus request for " + region);
+  callback(sharedMemoryStatusResponse(state_->getSharedMemory(), region,
+                                      MemoryAllocators::HipSharedMemory));
+}
+
+void HttpServer::hipSharedMemoryRegister(
+  const HttpRequestPtr &req,
+  std::function<void(const HttpResponsePtr &)> &&callback,
+  const std::string &region) const {
+  AMDINFER_LOG_INFO(logger_,
+                    "Received hipSharedMemoryRegister request for " + region);
+
+  const auto &json = req->getJsonObject();
+  const auto body = json != nullptr ? *json : Json::Value{};
+  const auto &handle = body["raw_handle"];
+  const auto &device = body["device_id"];
+  const auto offset = body.get("offset", 0);
+  const auto &byte_size = body["byte_size"];
+  if (!handle.isObject() || !handle["b64"].isString() || !device.isInt() ||
+      !offset.isUInt64() || !byte_size.isUInt64()) {
+    callback(errorHttpResponse(
+      "The body must have a 'raw_handle' object with a base64 string 'b64', "
+      "an int 'device_id', a uint64 'byte_size' and an optional uint64 "
+      "'offset'",
+      HttpStatusCode::k400BadRequest));
+    return;
+  }
+
+  HttpResponsePtr resp;
+  try {
+    state_->getSharedMemory()->add(
+      {region, util::base64Decode(handle["b64"].asString()), offset.asUInt64(),
+       byte_size.asUInt64(), MemoryAllocators::HipSharedMemory,
+       device.asInt()});
+    resp = HttpResponse::newHttpResponse();
+  } catch (const runtime_error &e) {
+    AMDINFER_LOG_INFO(logger_, e.what());
+    resp = errorHttpResponse(e.what(), HttpStatusCode::k400BadRequest);
+  } catch (const std::length_error &) {
+    resp = errorHttpResponse("The raw handle isn't valid base64",
+                             HttpStatusCode::k400BadRequest);
+  }
+  callback(resp);
+}
+
+void HttpServer::hipSharedMemoryUnregister(
+  [[maybe_unused]] const HttpRequestPtr &req,
+  std::function<void(const HttpResponsePtr &)> &&callback) const {
+  AMDINFER_LOG_INFO(logger_, "Received hipSharedMemoryUnregister request");
+  state_->getSharedMemory()->remove("", MemoryAllocators::HipSharedMemory);
+  callback(HttpResponse::newHttpResponse());
+}
+
+void HttpServer::hipSharedMemoryRegionUnregister(
+  [[maybe_unused]] const HttpRequestPtr &req,
+  std::function<void(const HttpResponsePtr &)> &&callback,
+  const std::string &region) const {
+  AMDINFER_LOG_INFO(logger_,
+                    "Received hipSharedMemoryUnregister request for " + region);
+  state_->getSharedMemory()->remove(region, MemoryAllocators::HipSharedMemory);
+  callback(HttpResponse::newHttpResponse());
+}
+
+namespace {
+
+/// Read an integer query parameter, using the default if it's not given
+std::optional<int> getIntParameter(const HttpRequestPtr &req,
+                                   const std::string &key, int default_value) {
+  const auto &value = req->getParameter(key);
+  if (value.empty()) {
+    return default_value;
+  }
+  try {
+    size_t parsed = 0;
+    const auto number = std::stoi(value, &parsed);
+    if (parsed == value.size()) {
+      return number;
+    }
+  } catch (const std::logic_error &) {
+    // an invalid number is reported by the caller
+  }
+  return std::nullopt;
+}
+
+}  // namespace
+
+void HttpServer::debugProfile(
+  const HttpRequestPtr &req,
+  std::function<void(const HttpResponsePtr &)> &&callback) const {
+  AMDINFER_LOG_INFO(logger_, "Received debugProfile request");
+  if (!debug_) {
+    callback(errorHttpResponse("Debugging endpoints are disabled",
+                               HttpStatusCode::k404NotFound));
+    return;
+  }
+
+  const auto seconds =
+    getIntParameter(req, "seconds", util::kDefaultProfileSeconds);
+  if (!seconds.has_value() || *seconds <= 0 ||
+      *seconds > util::kMaxProfileSeconds) {
+    callback(errorHttpResponse("The profile's seconds must be between 1 and " +
+                                 std::to_string(util::kMaxProfileSeconds),
+                               HttpStatusCode::k400BadRequest));
+    return;
+  }
+  const auto frequency =
+    getIntParameter(req, "frequency", util::kDefaultProfileFrequency);
+  if (!frequency.has_value()) {
+    callback(errorHttpResponse("The profile's frequency must be an integer",
+                               HttpStatusCode::k400BadRequest));
+    return;
+  }
+
+  try {
+    util::CpuProfiler::start(*frequency);
+  } catch (const invalid_argument &e) {
+    callback(errorHttpResponse(e.what(), HttpStatusCode::k400BadRequest));
+    return;
+  } catch (const runtime_error &e) {
+    callback(errorHttpResponse(e.what(), HttpStatusCode::k409Conflict));
+    return;
+  }
+
+  // the response is sent from a timer so no I/O thread waits on the profile
+  drogon::app().getLoop()->runAfter(
+    *seconds, [callback = std::move(callback)]() {
+      HttpResponsePtr resp;
+      try {
+        resp = HttpResponse::newHttpResponse();
+        resp->setBody(util::CpuProfiler::stop());
+        resp->setContentTypeCode(drogon::ContentType::CT_TEXT_PLAIN);
+      } catch (const runtime_error &e) {
+        resp = errorHttpResponse(e.what(),
+                                 HttpStatusCode::k500InternalServerError);
+      }
+      callback(resp);
+    });
+}
+
+void HttpServer::debugState(
+  [[maybe_unused]] const HttpRequestPtr &req,
+  std::function<void(const HttpResponsePtr &)> &&callback) const {
+  AMDINFER_LOG_INFO(logger_, "Received debugState request");
+  if (!debug_) {
+    callback(errorHttpResponse("Debugging endpoints are disabled",
+                               HttpStatusCode::k404NotFound));
+    return;
+  }
+
+  Json::Value json;
+  json["endpoints"] = Json::arrayValue;
+  for (const auto &state : state_->endpointStates()) {
+    Json::Value endpoint;
+    endpoint["name"] = state.endpoint;
+    endpoint["input_queue"] = static_cast<Json::UInt64>(state.input_queue);
+    endpoint["output_queue"] = static_cast<Json::UInt64>(state.output_queue);
+    endpoint["in_flight_batches"] = static_cast<Json::UInt64>(state.in_flight);
+    endpoint["workers"] = Json::arrayValue;
+    for (const auto &[instance, status] : state.workers) {
+      Json::Value worker;
+      worker["instance"] = static_cast<Json::UInt64>(instance);
+      worker["status"] = workers::toString(status);
+      endpoint["workers"].append(worker);
+    }
+    json["endpoints"].append(endpoint);
+  }
+  callback(HttpResponse::newHttpJsonResponse(json));
+}
+
 #endif  // AMDINFER_ENABLE_HTTP
 
 #ifdef AMDINFER_ENABLE_METRICS
@@ -660,6 +1786,25 @@ void HttpServer::metrics(
   resp->setContentTypeCode(drogon::ContentType::CT_TEXT_PLAIN);
   callback(resp);
 }
+
+void HttpServer::signals(
+  [[maybe_unused]] const HttpRequestPtr &req,
+  std::function<void(const HttpResponsePtr &)> &&callback) const {
+  // autoscalers poll it often so it's not logged at a higher level
+  AMDINFER_LOG_DEBUG(logger_, "Received signals request");
+  Json::Value json;
+  json["endpoints"] = Json::objectValue;
+  for (const auto &[endpoint, signals] : state_->signals()) {
+    auto &values = json["endpoints"][endpoint];
+    values["concurrency"] = signals.concurrency;
+    values["queue_time_us"] = signals.queue_time;
+    values["throughput"] = signals.throughput;
+    values["service_rate"] = signals.service_rate;
+    values["capacity"] = signals.capacity;
+    values["headroom"] = signals.headroom;
+  }
+  callback(HttpResponse::newHttpJsonResponse(json));
+}
 #endif
 
 }  // namespace amdinfer
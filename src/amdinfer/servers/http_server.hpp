@@ -21,13 +21,18 @@
 #ifndef GUARD_AMDINFER_SERVERS_HTTP_SERVER
 #define GUARD_AMDINFER_SERVERS_HTTP_SERVER
 
-#include <cstdint>     // for uint16_t
-#include <functional>  // for function
-#include <string>      // for allocator, string
+#include <cstddef>      // for size_t
+#include <cstdint>      // for uint16_t
+#include <functional>   // for function
+#include <string>       // for allocator, string
+#include <string_view>  // for string_view
+#include <vector>       // for vector
 
 #include "amdinfer/build_options.hpp"  // for AMDINFER_ENABLE_HTTP, PROT...
+#include "amdinfer/core/compression.hpp"        // for CompressionOptions
 #include "amdinfer/core/request_container.hpp"  // for InferenceRequestBuilder
 #include "amdinfer/observation/logging.hpp"     // for LoggerPtr
+#include "amdinfer/servers/server.hpp"          // for HttpServerOptions
 
 #ifdef AMDINFER_ENABLE_HTTP
 #include <drogon/HttpController.h>  // for ADD_METHOD_TO, HttpContro...
@@ -39,12 +44,39 @@
 namespace amdinfer {
 
 class SharedState;
+class SharedMemoryTensors;
 class MemoryPool;
+struct RequestContainer;
 
 #ifdef AMDINFER_ENABLE_HTTP
 
-InferenceRequestPtr getRequest(const std::shared_ptr<Json::Value> &json,
-                               const MemoryPool *pool);
+/**
+ * @brief Convert a JSON request to an InferenceRequest, copying the data of
+ * the inputs into buffers from the pool. Inputs that have the binary_data_size
+ * parameter take their data from the binary section, in order. Otherwise, the
+ * data comes from the raw JSON text in data, if the parser left it out of the
+ * DOM, or from the input's "data" key.
+ *
+ * If any input is in shared memory, the inputs are written into the batch by
+ * the container's input writers instead and the shared memory tensors are
+ * added to shared_memory. Without a container, shared memory isn't supported.
+ * Similarly, if the binary section outlives the request, its inputs can be
+ * read in place from it instead of being copied into buffers.
+ *
+ * @param json the JSON request
+ * @param pool memory pool to get buffers from
+ * @param binary binary section of the body, if any
+ * @param data raw text of the data array of each input, if any
+ * @param container container for the request's input writers, if any
+ * @param shared_memory the request's tensors in shared memory, if any
+ * @param in_place read the binary inputs in place through the container
+ * @return InferenceRequestPtr
+ */
+InferenceRequestPtr getRequest(
+  const std::shared_ptr<Json::Value> &json, const MemoryPool *pool,
+  std::string_view binary = {}, const std::vector<std::string_view> &data = {},
+  RequestContainer *container = nullptr,
+  SharedMemoryTensors *shared_memory = nullptr, bool in_place = false);
 
 /**
  * @brief The HTTP server for handling REST requests extends the base
@@ -53,8 +85,18 @@ InferenceRequestPtr getRequest(const std::shared_ptr<Json::Value> &json,
  */
 class HttpServer : public drogon::HttpController<HttpServer, false> {
  public:
-  /// Constructor
-  explicit HttpServer(SharedState *state);
+  /**
+   * @brief Constructor
+   *
+   * @param state the server's shared state
+   * @param debug serve the debugging endpoints
+   * @param compression how to compress inference responses
+   * @param stream_threshold the smallest binary data of a response in bytes
+   * that's streamed or zero to never stream them
+   */
+  explicit HttpServer(SharedState *state, bool debug = false,
+                      CompressionOptions compression = {},
+                      size_t stream_threshold = kDefaultHttpStreamThreshold);
 
   METHOD_LIST_BEGIN
 
@@ -82,6 +124,21 @@ class HttpServer : public drogon::HttpController<HttpServer, false> {
   /// Register the modelInfer endpoint
   ADD_METHOD_TO(HttpServer::modelInfer, "v2/models/{model}/infer", drogon::Post,
                 drogon::Options);
+  /// Register the modelInferBatch endpoint
+  ADD_METHOD_TO(HttpServer::modelInferBatch, "v2/models/{model}/infer_batch",
+                drogon::Post, drogon::Options);
+  /// Register the getModelVersionReady endpoint
+  ADD_METHOD_TO(HttpServer::getModelVersionReady,
+                "v2/models/{model}/versions/{version}/ready", drogon::Get,
+                drogon::Options);
+  /// Register the getModelVersionMetadata endpoint
+  ADD_METHOD_TO(HttpServer::getModelVersionMetadata,
+                "v2/models/{model}/versions/{version}", drogon::Get,
+                drogon::Options);
+  /// Register the modelVersionInfer endpoint
+  ADD_METHOD_TO(HttpServer::modelVersionInfer,
+                "v2/models/{model}/versions/{version}/infer", drogon::Post,
+                drogon::Options);
   /// Register the load endpoint
   ADD_METHOD_TO(HttpServer::modelLoad, "v2/repository/models/{model}/load",
                 drogon::Post, drogon::Options);
@@ -94,9 +151,55 @@ class HttpServer : public drogon::HttpController<HttpServer, false> {
   /// Register the workerUnload endpoint
   ADD_METHOD_TO(HttpServer::workerUnload, "v2/workers/{worker}/unload",
                 drogon::Post, drogon::Options);
+  /// Register the sharedMemoryStatus endpoint
+  ADD_METHOD_TO(HttpServer::sharedMemoryStatus, "v2/systemsharedmemory/status",
+                drogon::Get, drogon::Options);
+  /// Register the sharedMemoryRegionStatus endpoint
+  ADD_METHOD_TO(HttpServer::sharedMemoryRegionStatus,
+                "v2/systemsharedmemory/region/{region}/status", drogon::Get,
+                drogon::Options);
+  /// Register the sharedMemoryRegister endpoint
+  ADD_METHOD_TO(HttpServer::sharedMemoryRegister,
+                "v2/systemsharedmemory/region/{region}/register", drogon::Post,
+                drogon::Options);
+  /// Register the sharedMemoryUnregister endpoint
+  ADD_METHOD_TO(HttpServer::sharedMemoryUnregister,
+                "v2/systemsharedmemory/unregister", drogon::Post,
+                drogon::Options);
+  /// Register the sharedMemoryRegionUnregister endpoint
+  ADD_METHOD_TO(HttpServer::sharedMemoryRegionUnregister,
+                "v2/systemsharedmemory/region/{region}/unregister",
+                drogon::Post, drogon::Options);
+  /// Register the hipSharedMemoryStatus endpoint
+  ADD_METHOD_TO(HttpServer::hipSharedMemoryStatus, "v2/hipsharedmemory/status",
+                drogon::Get, drogon::Options);
+  /// Register the hipSharedMemoryRegionStatus endpoint
+  ADD_METHOD_TO(HttpServer::hipSharedMemoryRegionStatus,
+                "v2/hipsharedmemory/region/{region}/status", drogon::Get,
+                drogon::Options);
+  /// Register the hipSharedMemoryRegister endpoint
+  ADD_METHOD_TO(HttpServer::hipSharedMemoryRegister,
+                "v2/hipsharedmemory/region/{region}/register", drogon::Post,
+                drogon::Options);
+  /// Register the hipSharedMemoryUnregister endpoint
+  ADD_METHOD_TO(HttpServer::hipSharedMemoryUnregister,
+                "v2/hipsharedmemory/unregister", drogon::Post,
+                drogon::Options);
+  /// Register the hipSharedMemoryRegionUnregister endpoint
+  ADD_METHOD_TO(HttpServer::hipSharedMemoryRegionUnregister,
+                "v2/hipsharedmemory/region/{region}/unregister", drogon::Post,
+                drogon::Options);
+  /// Register the peerLoad endpoint
+  ADD_METHOD_TO(HttpServer::peerLoad, "v2/peers/load", drogon::Get);
+  /// Register the debugProfile endpoint
+  ADD_METHOD_TO(HttpServer::debugProfile, "v2/debug/profile", drogon::Get);
+  /// Register the debugState endpoint
+  ADD_METHOD_TO(HttpServer::debugState, "v2/debug/state", drogon::Get);
 #ifdef AMDINFER_ENABLE_METRICS
   /// Register the metrics endpoint
   ADD_METHOD_TO(HttpServer::metrics, "metrics", drogon::Get);
+  /// Register the signals endpoint
+  ADD_METHOD_TO(HttpServer::signals, "v2/signals", drogon::Get);
 #endif
   METHOD_LIST_END
 
@@ -187,6 +290,63 @@ class HttpServer : public drogon::HttpController<HttpServer, false> {
     std::function<void(const drogon::HttpResponsePtr &)> &&callback,
     std::string const &model) const;
 
+  /**
+   * @brief Handles several inference requests for a model in one call. The
+   * body is a JSON object whose "requests" array holds the requests and the
+   * response's "responses" array holds their responses in the same order.
+   * Each request fails on its own, with an error object in its place, so the
+   * call returns 200 unless the body can't be parsed. The data of the inputs
+   * and outputs is in the JSON.
+   *
+   * @param req the REST request object
+   * @param callback the callback function to respond to the client
+   * @param model name of the model to serve the requests
+   */
+  void modelInferBatch(
+    const drogon::HttpRequestPtr &req,
+    std::function<void(const drogon::HttpResponsePtr &)> &&callback,
+    std::string const &model) const;
+
+  /**
+   * @brief Returns 200 if a specific version of a model is ready for
+   * inferencing
+   *
+   * @param req the REST request object
+   * @param callback the callback function to respond to the client
+   * @param model name of the model
+   * @param version version of the model to serve the request
+   */
+  void getModelVersionReady(
+    const drogon::HttpRequestPtr &req,
+    std::function<void(const drogon::HttpResponsePtr &)> &&callback,
+    std::string const &model, std::string const &version) const;
+
+  /**
+   * @brief Returns metadata associated with a specific version of a model
+   *
+   * @param req the REST request object
+   * @param callback the callback function to respond to the client
+   * @param model name of the model
+   * @param version version of the model to serve the request
+   */
+  void getModelVersionMetadata(
+    const drogon::HttpRequestPtr &req,
+    std::function<void(const drogon::HttpResponsePtr &)> &&callback,
+    std::string const &model, std::string const &version) const;
+
+  /**
+   * @brief Handles inference requests for specific versions of named models
+   *
+   * @param req the REST request object
+   * @param callback the callback function to respond to the client
+   * @param model name of the model
+   * @param version version of the model to serve the request
+   */
+  void modelVersionInfer(
+    const drogon::HttpRequestPtr &req,
+    std::function<void(const drogon::HttpResponsePtr &)> &&callback,
+    std::string const &model, std::string const &version) const;
+
   /**
    * @brief Loads and starts a model
    *
@@ -235,6 +395,159 @@ class HttpServer : public drogon::HttpController<HttpServer, false> {
     std::function<void(const drogon::HttpResponsePtr &)> &&callback,
     std::string const &worker) const;
 
+  /**
+   * @brief Returns the status of all the registered system shared memory
+   * regions
+   *
+   * @param req the REST request object
+   * @param callback the callback function to respond to the client
+   */
+  void sharedMemoryStatus(
+    const drogon::HttpRequestPtr &req,
+    std::function<void(const drogon::HttpResponsePtr &)> &&callback) const;
+
+  /**
+   * @brief Returns the status of a system shared memory region
+   *
+   * @param req the REST request object
+   * @param callback the callback function to respond to the client
+   * @param region name of the region
+   */
+  void sharedMemoryRegionStatus(
+    const drogon::HttpRequestPtr &req,
+    std::function<void(const drogon::HttpResponsePtr &)> &&callback,
+    std::string const &region) const;
+
+  /**
+   * @brief Registers a system shared memory region. The body has the "key"
+   * of the shared memory object, the "offset" of the region in it and its
+   * "byte_size"
+   *
+   * @param req the REST request object
+   * @param callback the callback function to respond to the client
+   * @param region name of the region
+   */
+  void sharedMemoryRegister(
+    const drogon::HttpRequestPtr &req,
+    std::function<void(const drogon::HttpResponsePtr &)> &&callback,
+    std::string const &region) const;
+
+  /**
+   * @brief Unregisters all the system shared memory regions
+   *
+   * @param req the REST request object
+   * @param callback the callback function to respond to the client
+   */
+  void sharedMemoryUnregister(
+    const drogon::HttpRequestPtr &req,
+    std::function<void(const drogon::HttpResponsePtr &)> &&callback) const;
+
+  /**
+   * @brief Unregisters a system shared memory region
+   *
+   * @param req the REST request object
+   * @param callback the callback function to respond to the client
+   * @param region name of the region
+   */
+  void sharedMemoryRegionUnregister(
+    const drogon::HttpRequestPtr &req,
+    std::function<void(const drogon::HttpResponsePtr &)> &&callback,
+    std::string const &region) const;
+
+  /**
+   * @brief Returns the status of all the registered GPU shared memory regions
+   *
+   * @param req the REST request object
+   * @param callback the callback function to respond to the client
+   */
+  void hipSharedMemoryStatus(
+    const drogon::HttpRequestPtr &req,
+    std::function<void(const drogon::HttpResponsePtr &)> &&callback) const;
+
+  /**
+   * @brief Returns the status of a GPU shared memory region
+   *
+   * @param req the REST request object
+   * @param callback the callback function to respond to the client
+   * @param region name of the region
+   */
+  void hipSharedMemoryRegionStatus(
+    const drogon::HttpRequestPtr &req,
+    std::function<void(const drogon::HttpResponsePtr &)> &&callback,
+    std::string const &region) const;
+
+  /**
+   * @brief Registers a GPU shared memory region. The body has the base64
+   * "raw_handle" of the hipIpcMemHandle_t of the allocation, the "device_id"
+   * of its GPU, the "offset" of the region in it and its "byte_size"
+   *
+   * @param req the REST request object
+   * @param callback the callback function to respond to the client
+   * @param region name of the region
+   */
+  void hipSharedMemoryRegister(
+    const drogon::HttpRequestPtr &req,
+    std::function<void(const drogon::HttpResponsePtr &)> &&callback,
+    std::string const &region) const;
+
+  /**
+   * @brief Unregisters all the GPU shared memory regions
+   *
+   * @param req the REST request object
+   * @param callback the callback function to respond to the client
+   */
+  void hipSharedMemoryUnregister(
+    const drogon::HttpRequestPtr &req,
+    std::function<void(const drogon::HttpResponsePtr &)> &&callback) const;
+
+  /**
+   * @brief Unregisters a GPU shared memory region
+   *
+   * @param req the REST request object
+   * @param callback the callback function to respond to the client
+   * @param region name of the region
+   */
+  void hipSharedMemoryRegionUnregister(
+    const drogon::HttpRequestPtr &req,
+    std::function<void(const drogon::HttpResponsePtr &)> &&callback,
+    std::string const &region) const;
+
+  /**
+   * @brief Returns the work queued for each loaded endpoint, which peer
+   * servers fetch to decide where to forward requests
+   *
+   * @param req the REST request object
+   * @param callback the callback function to respond to the client
+   */
+  void peerLoad(
+    const drogon::HttpRequestPtr &req,
+    std::function<void(const drogon::HttpResponsePtr &)> &&callback) const;
+
+  /**
+   * @brief Profiles the server's CPU use for the number of seconds in the
+   * "seconds" query parameter, at the rate in "frequency", and returns the
+   * stacks in the folded format. It's only served if the debugging endpoints
+   * are enabled
+   *
+   * @param req the REST request object
+   * @param callback the callback function to respond to the client
+   */
+  void debugProfile(
+    const drogon::HttpRequestPtr &req,
+    std::function<void(const drogon::HttpResponsePtr &)> &&callback) const;
+
+  /**
+   * @brief Returns the depths of the queues, the batches in flight and the
+   * status of the workers of each endpoint. It's only served if the debugging
+   * endpoints are enabled
+   *
+   * @param req the REST request object
+   * @param callback the callback function to respond to the client
+   */
+  void debugState(
+    const drogon::HttpRequestPtr &req,
+    std::function<void(const drogon::HttpResponsePtr &)> &&callback) const;
+
 #ifdef AMDINFER_ENABLE_METRICS
   /**
    * @brief Returns the raw collected metric data
@@ -245,9 +558,23 @@ class HttpServer : public drogon::HttpController<HttpServer, false> {
   void metrics(
     const drogon::HttpRequestPtr &req,
     std::function<void(const drogon::HttpResponsePtr &)> &&callback) const;
+
+  /**
+   * @brief Returns the smoothed load of each loaded endpoint, which
+   * autoscalers can scale the model servers on
+   *
+   * @param req the REST request object
+   * @param callback the callback function to respond to the client
+   */
+  void signals(
+    const drogon::HttpRequestPtr &req,
+    std::function<void(const drogon::HttpResponsePtr &)> &&callback) const;
 #endif
  private:
   SharedState *state_;
+  bool debug_;
+  CompressionOptions compression_;
+  size_t stream_threshold_;
 #ifdef AMDINFER_ENABLE_LOGGING
   Logger logger_{Loggers::Server};
 #endif
@@ -261,8 +588,9 @@ namespace http {
  * @brief Start the HTTP REST server
  *
  * @param port the port to use for the server
+ * @param options options to size the server with
  */
-void start(SharedState *state, uint16_t port);
+void start(SharedState *state, uint16_t port, HttpServerOptions options);
 
 /// Stop the REST server
 void stop();
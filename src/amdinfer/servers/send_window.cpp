@@ -0,0 +1,120 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the send window that bounds the bytes buffered for a slow
+ * websocket client
+ */
+
+#include "amdinfer/servers/send_window.hpp"
+
+#include <algorithm>  // for min
+#include <utility>    // for move
+
+namespace amdinfer {
+
+SendWindow::SendWindow(size_t window, WebSocketWindowPolicy policy,
+                       Sender sender)
+  : window_(window), policy_(policy), sender_(std::move(sender)) {}
+
+size_t SendWindow::push(std::string message, bool binary, bool droppable) {
+  if (!bounded()) {
+    sender_(message, binary);
+    return 0;
+  }
+
+  std::unique_lock lock{mutex_};
+  if (closed_) {
+    return 0;
+  }
+  Message msg{std::move(message), binary};
+  const auto size = msg.data.size();
+  if (!droppable || (queued_.empty() && fits(size))) {
+    send(msg);
+    return 0;
+  }
+
+  switch (policy_) {
+    case WebSocketWindowPolicy::Skip:
+      return 1;
+    case WebSocketWindowPolicy::DropOldest: {
+      queued_bytes_ += size;
+      queued_.push_back(std::move(msg));
+      // keep at most a window's worth queued, always keeping the newest
+      size_t dropped = 0;
+      while (queued_.size() > 1 && queued_bytes_ > window_) {
+        queued_bytes_ -= queued_.front().data.size();
+        queued_.pop_front();
+        ++dropped;
+      }
+      return dropped;
+    }
+    default:
+      cv_.wait(lock, [&] { return closed_ || fits(size); });
+      if (!closed_) {
+        send(msg);
+      }
+      return 0;
+  }
+}
+
+void SendWindow::ack(size_t bytes) {
+  if (!bounded()) {
+    return;
+  }
+  std::lock_guard lock{mutex_};
+  in_flight_ -= std::min(bytes, in_flight_);
+  flush();
+  cv_.notify_all();
+}
+
+void SendWindow::close() {
+  std::lock_guard lock{mutex_};
+  closed_ = true;
+  queued_.clear();
+  queued_bytes_ = 0;
+  cv_.notify_all();
+}
+
+size_t SendWindow::buffered() const {
+  std::lock_guard lock{mutex_};
+  return in_flight_ + queued_bytes_;
+}
+
+bool SendWindow::closed() const {
+  std::lock_guard lock{mutex_};
+  return closed_;
+}
+
+bool SendWindow::fits(size_t size) const {
+  return in_flight_ == 0 || in_flight_ + size <= window_;
+}
+
+void SendWindow::send(const Message& message) {
+  // sending under the lock keeps the messages in order
+  in_flight_ += message.data.size();
+  sender_(message.data, message.binary);
+}
+
+void SendWindow::flush() {
+  while (!queued_.empty() && fits(queued_.front().data.size())) {
+    auto message = std::move(queued_.front());
+    queued_.pop_front();
+    queued_bytes_ -= message.data.size();
+    send(message);
+  }
+}
+
+}  // namespace amdinfer
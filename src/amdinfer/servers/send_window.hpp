@@ -0,0 +1,110 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the send window that bounds the bytes buffered for a slow
+ * websocket client
+ */
+
+#ifndef GUARD_AMDINFER_SERVERS_SEND_WINDOW
+#define GUARD_AMDINFER_SERVERS_SEND_WINDOW
+
+#include <condition_variable>  // for condition_variable
+#include <cstddef>             // for size_t
+#include <deque>               // for deque
+#include <functional>          // for function
+#include <mutex>               // for mutex
+#include <string>              // for string
+
+#include "amdinfer/clients/websocket.hpp"  // for WebSocketWindowPolicy
+
+namespace amdinfer {
+
+/**
+ * @brief The SendWindow tracks the bytes sent on a connection that the client
+ * hasn't acknowledged yet. Messages are sent while they fit in the window and
+ * the policy decides what happens to the rest. A message is always sent if
+ * nothing is in flight so messages larger than the window still get through.
+ * The websocket connection doesn't expose how much it has buffered so the
+ * window relies on the client acknowledging the bytes it has consumed.
+ */
+class SendWindow {
+ public:
+  /// Sends one message, which is binary if the flag is set
+  using Sender = std::function<void(const std::string&, bool)>;
+
+  /**
+   * @brief Construct a new SendWindow object
+   *
+   * @param window bytes that may be in flight. If it's zero, messages are
+   * always sent right away
+   * @param policy what to do with messages while the window is full
+   * @param sender sends messages on the connection
+   */
+  SendWindow(size_t window, WebSocketWindowPolicy policy, Sender sender);
+
+  /**
+   * @brief Send a message or apply the policy if it doesn't fit. With the
+   * Block policy, this waits until it fits or the window is closed.
+   *
+   * @param message the message to send
+   * @param binary whether to send it as a binary message
+   * @param droppable whether the policy may drop the message. Errors aren't
+   * so they're sent even if the window is full
+   * @return size_t number of messages dropped by this call
+   */
+  size_t push(std::string message, bool binary, bool droppable = true);
+  /**
+   * @brief Acknowledge bytes that the client has consumed, sending any queued
+   * messages that now fit and waking blocked senders
+   *
+   * @param bytes number of bytes acknowledged
+   */
+  void ack(size_t bytes);
+  /// Stop sending and wake blocked senders, such as when the connection closes
+  void close();
+
+  /// Get the bytes in flight and queued
+  [[nodiscard]] size_t buffered() const;
+  /// Check if the window has been closed
+  [[nodiscard]] bool closed() const;
+  /// Check if the window bounds the bytes in flight
+  [[nodiscard]] bool bounded() const { return window_ > 0; }
+
+ private:
+  struct Message {
+    std::string data;
+    bool binary;
+  };
+
+  [[nodiscard]] bool fits(size_t size) const;
+  void send(const Message& message);
+  void flush();
+
+  const size_t window_;
+  const WebSocketWindowPolicy policy_;
+  Sender sender_;
+
+  size_t in_flight_ = 0;
+  std::deque<Message> queued_;
+  size_t queued_bytes_ = 0;
+  bool closed_ = false;
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+};
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_SERVERS_SEND_WINDOW
@@ -15,23 +15,46 @@
 
 #include "amdinfer/servers/server.hpp"
 
-#include <cstdlib>  // for getenv
-#include <string>   // for operator+, string
-#include <thread>   // for thread
+#include <algorithm>  // for max
+#include <chrono>     // for milliseconds, seconds
+#include <cstdint>    // for uint64_t
+#include <cstdlib>    // for getenv
+#include <map>        // for map
+#include <memory>     // for make_unique
+#include <string>     // for operator+, string
+#include <thread>     // for thread
+#include <utility>    // for move
+#include <vector>     // for vector
 
 #include "amdinfer/build_options.hpp"            // for AMDINFER_ENABLE_HTTP
 #include "amdinfer/core/exceptions.hpp"          // for environment_not_set_e...
+#include "amdinfer/core/hardware_inventory.hpp"  // for HardwareInventory
+#include "amdinfer/core/load_scheduler.hpp"      // for LoadLimits
+#include "amdinfer/core/peers.hpp"               // for Peer, PeerLimits
 #include "amdinfer/core/shared_state.hpp"        // for SharedState
+#include "amdinfer/core/tenant_limiter.hpp"      // for TenantLimits
+#include "amdinfer/core/traffic_recorder.hpp"    // for RecorderLimits
 #include "amdinfer/observation/logging.hpp"      // for initLogger, getLogDir...
+#include "amdinfer/observation/metrics.hpp"      // for Metrics
 #include "amdinfer/observation/tracing.hpp"      // for startTracer, stopTracer
+#include "amdinfer/servers/admin_server.hpp"     // for AdminServer
 #include "amdinfer/servers/grpc_server.hpp"      // for start, stop
 #include "amdinfer/servers/http_server.hpp"      // for stop, start
 #include "amdinfer/servers/server_internal.hpp"  // for ServerImpl
+#include "amdinfer/servers/socket_server.hpp"    // for SocketServer
+#include "amdinfer/servers/worker_host.hpp"      // for WorkerHost
+#include "amdinfer/util/string.hpp"              // for toLower
+#include "amdinfer/util/thread.hpp"              // for getAvailableCpus
+#include "amdinfer/util/timer.hpp"               // for Timer
 
 #ifdef AMDINFER_ENABLE_AKS
 #include <aks/AksSysManagerExt.h>  // for SysManagerExt
 #endif
 
+#ifdef AMDINFER_ENABLE_HTTP
+#include "amdinfer/core/peer_client.hpp"  // for makePeer
+#endif
+
 namespace fs = std::filesystem;
 
 namespace amdinfer {
@@ -50,6 +73,16 @@ void initializeServerLogging() {
 #endif
 }
 
+void recordStartupPhase([[maybe_unused]] const std::string& phase,
+                        [[maybe_unused]] double seconds) {
+  AMDINFER_IF_LOGGING(Logger logger{Loggers::Server};)
+  AMDINFER_LOG_INFO(logger, "Starting the server: " + phase + " took " +
+                              std::to_string(seconds) + " s");
+#ifdef AMDINFER_ENABLE_METRICS
+  Metrics::getInstance().setStartupTime(phase, seconds);
+#endif
+}
+
 void terminate() {
 #ifdef AMDINFER_ENABLE_TRACING
   stopTracer();
@@ -61,6 +94,7 @@ void terminate() {
 }
 
 Server::Server() {
+  util::Timer timer{true};
   initializeServerLogging();
   this->impl_ = std::make_unique<Server::ServerImpl>();
 
@@ -68,6 +102,27 @@ Server::Server() {
   startTracer();
 #endif
 
+  // look up the hardware once at startup so requests don't wait for it
+  try {
+    [[maybe_unused]] const auto hardware = HardwareInventory::get().read();
+    AMDINFER_IF_LOGGING(Logger logger{Loggers::Server};)
+    AMDINFER_LOG_INFO(logger, "Found " + std::to_string(hardware->gpus) +
+                                " GPUs and " + std::to_string(hardware->cpus) +
+                                " CPUs over " +
+                                std::to_string(hardware->numa_nodes) +
+                                " NUMA nodes");
+#ifdef AMDINFER_ENABLE_METRICS
+    for (auto i = 0; i < hardware->gpus; ++i) {
+      Metrics::getInstance().addDevice("gpu" + std::to_string(i));
+    }
+#endif
+  } catch (const external_error& e) {
+    AMDINFER_IF_LOGGING(Logger logger{Loggers::Server};)
+    AMDINFER_LOG_WARN(logger,
+                      std::string{"Failed to look up the hardware: "} +
+                        e.what());
+  }
+
 #ifdef AMDINFER_ENABLE_AKS
   auto* aks_sys_manager = AKS::SysManagerExt::getGlobal();
 
@@ -79,18 +134,29 @@ Server::Server() {
   const auto kernel_dir = std::string{aks_root} + "/kernel_zoo";
   aks_sys_manager->loadKernels(kernel_dir);
 #endif
+  timer.stop();
+  recordStartupPhase("initialize", timer.count());
 }
 
 Server::~Server() {
   stopHttp();
   stopGrpc();
+  stopSocket();
+  stopAdmin();
   terminate();
 }
 
-void Server::startHttp([[maybe_unused]] uint16_t port) const {
+void Server::startHttp(
+  [[maybe_unused]] uint16_t port,
+  [[maybe_unused]] const HttpServerOptions& options) const {
 #ifdef AMDINFER_ENABLE_HTTP
   if (!impl_->http_started) {
-    impl_->http_thread = std::thread{http::start, &(impl_->state), port};
+    auto http_options = options;
+    if (http_options.threads == kThreadsAuto) {
+      http_options.threads = util::getAvailableCpus();
+    }
+    impl_->http_thread =
+      std::thread{http::start, &(impl_->state), port, http_options};
     impl_->http_started = true;
   }
 #endif
@@ -108,11 +174,32 @@ void Server::stopHttp() const {
 #endif
 }
 
-void Server::startGrpc([[maybe_unused]] uint16_t port) const {
+void Server::startGrpc(
+  [[maybe_unused]] uint16_t port,
+  [[maybe_unused]] const GrpcServerOptions& options) const {
 #ifdef AMDINFER_ENABLE_GRPC
   if (!impl_->grpc_started) {
-    grpc::start(&(impl_->state), port);
+    if (!options.tcp && options.unix_socket.empty()) {
+      throw invalid_argument(
+        "The gRPC server needs a Unix domain socket if it doesn't use TCP");
+    }
+    const auto cpus = util::getAvailableCpus();
+    auto grpc_options = options;
+    if (grpc_options.completion_queues == kThreadsAuto) {
+      grpc_options.completion_queues = cpus;
+    }
+    if (grpc_options.threads_per_queue == kThreadsAuto) {
+      grpc_options.threads_per_queue =
+        std::max(1, cpus / grpc_options.completion_queues);
+    }
+    if (grpc_options.request_threads == kThreadsAuto) {
+      grpc_options.request_threads = cpus;
+    }
+    util::Timer timer{true};
+    grpc::start(&(impl_->state), port, grpc_options);
     impl_->grpc_started = true;
+    timer.stop();
+    recordStartupPhase("grpc", timer.count());
   }
 #endif
 }
@@ -126,13 +213,165 @@ void Server::stopGrpc() const {
 #endif
 }
 
+void Server::startSocket(uint16_t port,
+                         const SocketServerOptions& options) const {
+  if (impl_->socket_server == nullptr) {
+    util::Timer timer{true};
+    impl_->socket_server =
+      std::make_unique<SocketServer>(&(impl_->state), port, options);
+    timer.stop();
+    recordStartupPhase("socket", timer.count());
+  }
+}
+
+void Server::stopSocket() const {
+  // the server stops when it's destroyed
+  impl_->socket_server.reset();
+}
+
+void Server::hostWorker(const std::string& channel) const {
+  WorkerHost host{&(impl_->state), channel};
+  host.run();
+}
+
+void Server::startAdmin(uint16_t port,
+                        const AdminServerOptions& options) const {
+  if (impl_->admin_server == nullptr) {
+    util::Timer timer{true};
+    impl_->admin_server =
+      std::make_unique<AdminServer>(&(impl_->state), port, options);
+    timer.stop();
+    recordStartupPhase("admin", timer.count());
+  }
+}
+
+void Server::stopAdmin() const {
+  // the server stops when it's destroyed
+  impl_->admin_server.reset();
+}
+
+void Server::setScrapeInterval(
+  [[maybe_unused]] std::chrono::milliseconds interval) const {
+#ifdef AMDINFER_ENABLE_METRICS
+  Metrics::getInstance().setScrapeInterval(interval);
+#endif
+}
+
 void Server::setModelRepository(const fs::path& repository_path,
-                                bool load_existing) {
-  impl_->state.setRepository(repository_path, load_existing);
+                                bool load_existing,
+                                const RepositoryOptions& options) {
+  util::Timer timer{true};
+  const auto threads = options.load_threads == kThreadsAuto
+                         ? util::getAvailableCpus()
+                         : options.load_threads;
+  LoadLimits limits;
+  limits.threads = static_cast<size_t>(std::max(threads, 1));
+  for (const auto& [device, loads] : options.device_loads) {
+    limits.devices[device] = static_cast<size_t>(std::max(loads, 0));
+  }
+  RemoteOptions remote;
+  remote.cache = options.cache_directory;
+  remote.threads = static_cast<size_t>(std::max(options.download_threads, 1));
+  impl_->state.setRepository(repository_path, load_existing, limits, remote);
+  if (options.lazy_load) {
+    impl_->state.enableLazyLoading(options.memory_budgets);
+  }
+  // the existing models keep loading in the background
+  timer.stop();
+  recordStartupPhase("repository", timer.count());
 }
 
 void Server::enableRepositoryMonitoring(bool use_polling) {
+  util::Timer timer{true};
   impl_->state.enableRepositoryMonitoring(use_polling);
+  timer.stop();
+  recordStartupPhase("monitoring", timer.count());
+}
+
+void Server::expectModelRepository() { impl_->state.expectRepository(); }
+
+void Server::saveModelParameters(const std::string& model,
+                                 const ParameterMap& parameters) const {
+  impl_->state.saveModelParameters(util::toLower(model), parameters);
+}
+
+void Server::enablePeers([[maybe_unused]] const PeerOptions& options) {
+#ifdef AMDINFER_ENABLE_HTTP
+  std::vector<std::unique_ptr<Peer>> peers;
+  peers.reserve(options.peers.size());
+  for (const auto& address : options.peers) {
+    peers.push_back(makePeer(address));
+  }
+  PeerLimits limits;
+  limits.interval =
+    std::chrono::milliseconds{std::max(options.poll_interval, 1)};
+  limits.threshold =
+    static_cast<size_t>(std::max(options.forward_threshold, 0));
+  impl_->state.enablePeers(std::move(peers), limits);
+#else
+  throw invalid_argument("Forwarding to peers needs the HTTP server");
+#endif
+}
+
+void Server::enableMemoryTrimming(const MemoryTrimOptions& options) {
+  constexpr size_t kMiB = 1'048'576;
+  impl_->state.enableMemoryTrimming(
+    std::chrono::seconds{std::max(options.interval, 1)},
+    static_cast<size_t>(std::max(options.keep_mb, 0)) * kMiB);
+}
+
+void Server::enableTrafficCapture(const TrafficCaptureOptions& options) {
+  constexpr uint64_t kMiB = 1'048'576;
+  if (options.sample_rate <= 0 || options.sample_rate > 1) {
+    throw invalid_argument("The sample rate of the traffic must be in (0, 1]");
+  }
+  RecorderLimits limits;
+  limits.sample_rate = options.sample_rate;
+  limits.max_bytes = static_cast<uint64_t>(std::max(options.max_mb, 0)) * kMiB;
+  limits.payloads = options.payloads;
+  impl_->state.enableTrafficCapture(options.path, limits);
+}
+
+void Server::enableTenantLimits(const TenantLimitOptions& options) {
+  if (options.header.empty()) {
+    throw invalid_argument("The header that names tenants must be set");
+  }
+  if (options.burst <= 0) {
+    throw invalid_argument("The burst of the tenant limits must be positive");
+  }
+  const auto convert = [&options](const std::string& name,
+                                  const TenantLimit& limit) {
+    if (limit.requests_per_second < 0 || limit.bytes_per_second < 0 ||
+        limit.max_in_flight < 0) {
+      throw invalid_argument("The limits of tenant " + name +
+                             " can't be negative");
+    }
+    TenantLimits limits;
+    limits.requests_per_second = limit.requests_per_second;
+    limits.bytes_per_second = limit.bytes_per_second;
+    limits.burst = options.burst;
+    limits.max_in_flight = static_cast<size_t>(limit.max_in_flight);
+    return limits;
+  };
+  std::map<std::string, TenantLimits> tenants;
+  for (const auto& [name, limit] : options.tenants) {
+    tenants.try_emplace(name, convert(name, limit));
+  }
+  impl_->state.enableTenantLimits(
+    options.header, convert("default", options.limits), tenants,
+    static_cast<size_t>(std::max(options.max_tenants, 0)));
+}
+
+std::string Server::startBulkJob(const BulkJobOptions& options) const {
+  return impl_->state.startBulkJob(options);
+}
+
+BulkJobProgress Server::getBulkJob(const std::string& id) const {
+  return impl_->state.bulkJobProgress(id);
+}
+
+void Server::cancelBulkJob(const std::string& id) const {
+  impl_->state.cancelBulkJob(id);
 }
 
 }  // namespace amdinfer
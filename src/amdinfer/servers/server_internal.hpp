@@ -16,15 +16,27 @@
 #ifndef GUARD_AMDINFER_SERVERS_SERVER_INTERNAL
 #define GUARD_AMDINFER_SERVERS_SERVER_INTERNAL
 
+#include <memory>
+#include <string>
 #include <thread>
 
 #include "amdinfer/build_options.hpp"
 #include "amdinfer/core/model_repository.hpp"
 #include "amdinfer/core/shared_state.hpp"
+#include "amdinfer/servers/admin_server.hpp"
 #include "amdinfer/servers/server.hpp"
+#include "amdinfer/servers/socket_server.hpp"
 
 namespace amdinfer {
 
+/**
+ * @brief Log and report how long a phase of starting the server took
+ *
+ * @param phase the phase's name
+ * @param seconds duration of the phase
+ */
+void recordStartupPhase(const std::string& phase, double seconds);
+
 struct Server::ServerImpl {
 #ifdef AMDINFER_ENABLE_HTTP
   bool http_started = false;
@@ -33,6 +45,8 @@ struct Server::ServerImpl {
 #ifdef AMDINFER_ENABLE_GRPC
   bool grpc_started = false;
 #endif
+  std::unique_ptr<SocketServer> socket_server;
+  std::unique_ptr<AdminServer> admin_server;
   SharedState state;
 };
 
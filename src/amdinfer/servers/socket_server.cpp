@@ -0,0 +1,251 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the socket server
+ */
+
+#include "amdinfer/servers/socket_server.hpp"
+
+#include <netinet/in.h>   // for sockaddr_in, htonl, htons, INADDR_ANY
+#include <netinet/tcp.h>  // for TCP_NODELAY
+#include <sys/socket.h>   // for accept4, bind, listen, setsockopt, shutdown
+#include <unistd.h>       // for close
+
+#include <array>    // for array
+#include <cerrno>   // for errno, EINTR, ECONNABORTED
+#include <chrono>   // for milliseconds
+#include <cstring>  // for strerror
+#include <memory>   // for shared_ptr, make_shared, make_unique
+#include <mutex>    // for lock_guard
+#include <string>   // for string, to_string
+#include <thread>   // for thread, sleep_for
+#include <utility>  // for move
+#include <vector>   // for vector
+
+#include "amdinfer/buffers/buffer.hpp"           // for Buffer
+#include "amdinfer/core/exceptions.hpp"          // for runtime_error
+#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/core/request_container.hpp"   // for RequestContainer
+#include "amdinfer/core/shared_state.hpp"        // for SharedState
+#include "amdinfer/core/wire_format.hpp"         // for decodeRequest
+#include "amdinfer/observation/tracing.hpp"      // for startTrace
+#include "amdinfer/util/string.hpp"              // for toLower
+
+namespace amdinfer {
+
+/// How long to wait before accepting again after an unexpected error
+constexpr std::chrono::milliseconds kAcceptRetryDelay{10};
+
+struct SocketServer::Connection {
+  explicit Connection(int fd) : socket(fd) {}
+  Connection(const Connection&) = delete;
+  Connection& operator=(const Connection&) = delete;
+  Connection(Connection&&) = delete;
+  Connection& operator=(Connection&&) = delete;
+  /// The socket is closed once no pending response can write to it
+  ~Connection() { ::close(socket); }
+
+  /// Send a message whole so responses from different threads don't interleave
+  void send(const WireMessage& message) {
+    std::lock_guard lock{mutex};
+    // if it fails, the reading thread sees the connection close
+    sendMessage(socket, message);
+  }
+
+  void sendError(uint64_t tag, const std::string& error,
+                 const std::string& id = "") {
+    InferenceResponse response{error};
+    response.setID(id);
+    send(encodeResponse(tag, response));
+  }
+
+  const int socket;
+  std::mutex mutex;
+};
+
+SocketServer::SocketServer(SharedState* state, uint16_t port,
+                           const SocketServerOptions& options)
+  : state_(state), options_(options) {
+  listener_ = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (listener_ < 0) {
+    throw runtime_error(std::string{"Could not create the socket server: "} +
+                        std::strerror(errno));
+  }
+  const int enable = 1;
+  ::setsockopt(listener_, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_ANY);
+  address.sin_port = htons(port);
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  const auto* generic = reinterpret_cast<sockaddr*>(&address);
+  if (::bind(listener_, generic, sizeof(address)) != 0 ||
+      ::listen(listener_, SOMAXCONN) != 0) {
+    const auto error = errno;
+    ::close(listener_);
+    throw runtime_error("Could not listen on port " + std::to_string(port) +
+                        ": " + std::strerror(error));
+  }
+  acceptor_ = std::thread{&SocketServer::accept, this};
+  AMDINFER_LOG_INFO(logger_, "Socket server listening on port " +
+                               std::to_string(port));
+}
+
+SocketServer::~SocketServer() { stop(); }
+
+void SocketServer::stop() {
+  if (!running_.exchange(false)) {
+    return;
+  }
+  // shutting the sockets down wakes the threads that are blocked on them
+  ::shutdown(listener_, SHUT_RDWR);
+  acceptor_.join();
+  ::close(listener_);
+
+  std::lock_guard lock{mutex_};
+  // only reading is stopped so responses to pending requests are still sent
+  for (const auto& session : sessions_) {
+    if (auto connection = session.connection.lock(); connection != nullptr) {
+      ::shutdown(connection->socket, SHUT_RD);
+    }
+  }
+  for (auto& session : sessions_) {
+    session.thread.join();
+  }
+  sessions_.clear();
+}
+
+void SocketServer::accept() {
+  while (running_) {
+    const int fd = ::accept4(listener_, nullptr, nullptr, SOCK_CLOEXEC);
+    if (fd < 0) {
+      if (!running_) {
+        break;
+      }
+      if (errno != EINTR && errno != ECONNABORTED) {
+        // such as running out of descriptors, which may pass
+        AMDINFER_LOG_WARN(logger_, std::string{"Failed to accept: "} +
+                                     std::strerror(errno));
+        std::this_thread::sleep_for(kAcceptRetryDelay);
+      }
+      continue;
+    }
+    if (options_.tcp_nodelay) {
+      const int enable = 1;
+      ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+    }
+
+    auto connection = std::make_shared<Connection>(fd);
+    std::lock_guard lock{mutex_};
+    reap();
+    auto& session = sessions_.emplace_back();
+    session.connection = connection;
+    session.thread = std::thread{&SocketServer::serve, this,
+                                 std::move(connection), &session.done};
+  }
+}
+
+void SocketServer::reap() {
+  for (auto it = sessions_.begin(); it != sessions_.end();) {
+    if (it->done) {
+      it->thread.join();
+      it = sessions_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void SocketServer::serve(std::shared_ptr<Connection> connection,
+                         std::atomic_bool* done) const {
+  std::array<std::byte, sizeof(WireHeader)> raw_header;
+  while (receive(connection->socket, raw_header.data(), raw_header.size())) {
+    WireHeader header;
+    try {
+      header = decodeHeader(raw_header.data(), options_.max_message_size);
+    } catch (const invalid_argument& e) {
+      // without a valid header, where the next message starts is unknown
+      AMDINFER_LOG_INFO(logger_, e.what());
+      connection->sendError(0, e.what());
+      break;
+    }
+    // the body is left uninitialized since it's about to be overwritten
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays)
+    std::shared_ptr<std::byte[]> body{new std::byte[header.bodySize()]};
+    if (!receive(connection->socket, body.get(), header.bodySize())) {
+      break;
+    }
+    submit(connection, header, std::move(body));
+  }
+  *done = true;
+}
+
+void SocketServer::submit(const std::shared_ptr<Connection>& connection,
+                          const WireHeader& header,
+                          // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays)
+                          std::shared_ptr<std::byte[]> body) const {
+#ifdef AMDINFER_ENABLE_TRACING
+  auto trace = startTrace(&(__func__[0]));
+  trace->startSpan("socket_handler");
+#endif
+
+  WireRequest decoded;
+  try {
+    decoded = decodeRequest(header, body.get());
+  } catch (const invalid_argument& e) {
+    AMDINFER_LOG_INFO(logger_, e.what());
+    connection->sendError(header.tag, e.what());
+    return;
+  }
+  const auto& request = decoded.request;
+
+  auto request_container = std::make_unique<RequestContainer>();
+  // the inputs are read where they are in the body, which the callback keeps
+  // alive for as long as the request
+  const auto& inputs = request->getInputs();
+  request_container->input_views.reserve(inputs.size());
+  request_container->input_writers.reserve(inputs.size());
+  for (const auto& input : inputs) {
+    const auto* data = input.getData();
+    const auto size = input.getSize() * input.getDatatype().size();
+    request_container->input_views.push_back(data);
+    request_container->input_writers.emplace_back(
+      [data, size](Buffer* buffer, size_t offset) {
+        buffer->write(data, offset, size);
+      });
+  }
+  request->setCallback([connection, body = std::move(body),
+                        tag = decoded.tag](const InferenceResponse& response) {
+    connection->send(encodeResponse(tag, response));
+  });
+  request_container->request = request;
+#ifdef AMDINFER_ENABLE_TRACING
+  trace->endSpan();
+  request_container->trace = std::move(trace);
+#endif
+
+  try {
+    state_->modelInfer(util::toLower(decoded.model),
+                       std::move(request_container));
+  } catch (const runtime_error& e) {
+    AMDINFER_LOG_INFO(logger_, e.what());
+    connection->sendError(decoded.tag, e.what(), request->getID());
+  }
+}
+
+}  // namespace amdinfer
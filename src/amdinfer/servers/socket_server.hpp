@@ -0,0 +1,104 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the socket server, which serves inference with the binary
+ * wire format
+ */
+
+#ifndef GUARD_AMDINFER_SERVERS_SOCKET_SERVER
+#define GUARD_AMDINFER_SERVERS_SOCKET_SERVER
+
+#include <atomic>   // for atomic_bool
+#include <cstddef>  // for byte
+#include <cstdint>  // for uint16_t
+#include <list>     // for list
+#include <memory>   // for shared_ptr
+#include <mutex>    // for mutex
+#include <thread>   // for thread
+
+#include "amdinfer/build_options.hpp"        // for AMDINFER_ENABLE_LOGGING
+#include "amdinfer/observation/logging.hpp"  // for Logger
+#include "amdinfer/servers/server.hpp"       // for SocketServerOptions
+
+namespace amdinfer {
+
+class SharedState;
+struct WireHeader;
+
+/**
+ * @brief The socket server accepts TCP connections whose clients send requests
+ * in the binary wire format. Each connection is read by its own thread, which
+ * decodes each request in place and submits it. Responses are sent back on the
+ * connection as they complete, tagged with their requests' tags, so a client
+ * may pipeline many requests on one connection.
+ */
+class SocketServer {
+ public:
+  /**
+   * @brief Construct a new SocketServer object and start listening
+   *
+   * @param state the server's state to submit requests to
+   * @param port the port to listen on
+   * @param options options to configure the server with
+   */
+  SocketServer(SharedState* state, uint16_t port,
+               const SocketServerOptions& options);
+  SocketServer(const SocketServer&) = delete;
+  SocketServer& operator=(const SocketServer&) = delete;
+  SocketServer(SocketServer&&) = delete;
+  SocketServer& operator=(SocketServer&&) = delete;
+  /// Destructor. It stops the server
+  ~SocketServer();
+
+  /// Stop accepting connections and close the open ones
+  void stop();
+
+ private:
+  struct Connection;
+  struct Session {
+    /// the connection is closed once its thread and pending responses are done
+    std::weak_ptr<Connection> connection;
+    /// set once the thread is done reading from the connection
+    std::atomic_bool done = false;
+    std::thread thread;
+  };
+
+  void accept();
+  void serve(std::shared_ptr<Connection> connection,
+             std::atomic_bool* done) const;
+  /// Decode a request whose body has been read and submit it
+  void submit(const std::shared_ptr<Connection>& connection,
+              const WireHeader& header,
+              // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays)
+              std::shared_ptr<std::byte[]> body) const;
+  /// Join the threads of connections that have closed
+  void reap();
+
+  SharedState* state_;
+  SocketServerOptions options_;
+  int listener_ = -1;
+  std::atomic_bool running_ = true;
+  std::thread acceptor_;
+  std::mutex mutex_;
+  std::list<Session> sessions_;
+#ifdef AMDINFER_ENABLE_LOGGING
+  Logger logger_{Loggers::Server};
+#endif
+};
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_SERVERS_SOCKET_SERVER
@@ -18,19 +18,27 @@
 #include <json/reader.h>  // for CharReader, CharReaderBui...
 #include <json/value.h>   // for Value, arrayValue
 
-#include <algorithm>  // for transform
-#include <cctype>     // for tolower
+#include <cstddef>    // for size_t
+#include <exception>  // for exception
 #include <memory>     // for allocator, shared_ptr
 #include <string>     // for string, operator+, char_t...
 #include <utility>    // for move
 
-#include "amdinfer/core/exceptions.hpp"          // for invalid_argument
-#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
-#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
-#include "amdinfer/core/request_container.hpp"   // for ParameterMapPtr
-#include "amdinfer/core/shared_state.hpp"        // for SharedState
-#include "amdinfer/observation/tracing.hpp"      // for startSpan, Span
-#include "amdinfer/servers/http_server.hpp"      // for RequestBuilder
+#include "amdinfer/buffers/buffer.hpp"                     // for Buffer
+#include "amdinfer/clients/websocket_internal.hpp"         // for decodeFrame
+#include "amdinfer/core/data_types.hpp"                    // for DataType
+#include "amdinfer/core/exceptions.hpp"                    // for invalid_arg...
+#include "amdinfer/core/inference_request.hpp"             // for InferenceR...
+#include "amdinfer/core/inference_response.hpp"            // for InferenceR...
+#include "amdinfer/core/memory_pool/memory_allocator.hpp"  // for MemoryAll...
+#include "amdinfer/core/memory_pool/pool.hpp"              // for MemoryPool
+#include "amdinfer/core/request_container.hpp"             // for RequestCon...
+#include "amdinfer/core/shared_state.hpp"                  // for SharedState
+#include "amdinfer/observation/metrics.hpp"                // for Metrics
+#include "amdinfer/observation/tracing.hpp"                // for startSpan
+#include "amdinfer/servers/http_server.hpp"                // for getRequest
+#include "amdinfer/servers/send_window.hpp"                // for SendWindow
+#include "amdinfer/util/string.hpp"                        // for toLower
 
 using drogon::HttpRequestPtr;
 using drogon::WebSocketConnectionPtr;
@@ -38,17 +46,152 @@ using drogon::WebSocketMessageType;
 
 namespace amdinfer::http {
 
+namespace {
+
+/// The protocol that a connection negotiated when it was opened
+enum class Protocol { Json, Binary };
+
+/// The state of a connection, which is set as its context when it's opened
+struct Connection {
+  Protocol protocol = Protocol::Json;
+  /// bounds the bytes sent to the client that it hasn't acknowledged
+  std::unique_ptr<SendWindow> window;
+  /// the client's address, to label the connection's metrics
+  std::string name;
+};
+
+bool isBinary(const WebSocketConnectionPtr &conn) {
+  const auto context = conn->getContext<Connection>();
+  return context != nullptr && context->protocol == Protocol::Binary;
+}
+
+#ifdef AMDINFER_ENABLE_METRICS
+void setBufferedGauge(const Connection &context) {
+  // closed connections have had their gauge removed
+  if (context.window->bounded() && !context.window->closed()) {
+    Metrics::getInstance().setGauge(MetricGaugeIDs::WebsocketBufferedBytes,
+                                    context.name, context.window->buffered());
+  }
+}
+#endif
+
+/**
+ * @brief Send a message through the connection's send window
+ *
+ * @param conn the connection
+ * @param message the message
+ * @param binary whether to send it as a binary message
+ * @param droppable whether the window's policy may drop it
+ */
+void sendMessage(const WebSocketConnectionPtr &conn, std::string message,
+                 bool binary, bool droppable = true) {
+  const auto context = conn->getContext<Connection>();
+  if (context == nullptr) {
+    conn->send(message, binary ? WebSocketMessageType::Binary
+                               : WebSocketMessageType::Text);
+    return;
+  }
+  [[maybe_unused]] const auto dropped =
+    context->window->push(std::move(message), binary, droppable);
+#ifdef AMDINFER_ENABLE_METRICS
+  if (dropped > 0) {
+    Metrics::getInstance().incrementCounter(
+      MetricCounterIDs::WebsocketFramesDropped, dropped);
+  }
+  setBufferedGauge(*context);
+#endif
+}
+
+void sendError(const WebSocketConnectionPtr &conn, bool binary,
+               const std::string &error, const std::string &id = "") {
+  if (binary) {
+    InferenceResponse response{error};
+    response.setID(id);
+    sendMessage(conn, encodeResponseFrame(response), true, false);
+  } else {
+    sendMessage(conn, error, false, false);
+  }
+}
+
+/// Acknowledge bytes that the client has consumed
+void ack(const WebSocketConnectionPtr &conn, size_t bytes) {
+  const auto context = conn->getContext<Connection>();
+  if (context == nullptr) {
+    return;
+  }
+  context->window->ack(bytes);
+#ifdef AMDINFER_ENABLE_METRICS
+  setBufferedGauge(*context);
+#endif
+}
+
+/**
+ * @brief Convert a binary frame to an InferenceRequest, copying the data of
+ * the inputs into buffers from the pool. Unless the frame says otherwise, the
+ * request asks for binary outputs since the connection uses binary frames
+ *
+ * @param frame the decoded binary frame
+ * @param pool memory pool to get buffers from
+ * @return InferenceRequestPtr
+ */
+InferenceRequestPtr getRequest(const Frame &frame, const MemoryPool *pool) {
+  auto request = std::make_shared<InferenceRequest>();
+  request->setID(frame.id);
+  auto parameters = frame.parameters;
+  if (!parameters.has(kBinaryOutputs)) {
+    parameters.put(kBinaryOutputs, true);
+  }
+  request->setParameters(std::move(parameters));
+
+  for (const auto &tensor : frame.tensors) {
+    InferenceRequestInput input;
+    input.setName(tensor.name);
+    input.setDatatype(tensor.datatype);
+    input.setShape(tensor.shape);
+    input.setParameters(tensor.parameters);
+    const auto size = getFrameDataSize(input);
+    if (tensor.data.size() != size) {
+      throw invalid_argument("Data size of input " + input.getName() +
+                             " does not match its shape and datatype");
+    }
+    auto buffer = pool->get({MemoryAllocators::Cpu}, input, 1);
+    buffer->write(tensor.data.data(), 0, size);
+    input.setData(buffer->data(0));
+    request->addInputTensor(std::move(input));
+  }
+  return request;
+}
+
+}  // namespace
+
 void setCallback(InferenceRequest *request,
-                 drogon::WebSocketConnectionPtr conn) {
-  Callback callback = [conn =
-                         std::move(conn)](const InferenceResponse &response) {
-    if (response.isError()) {
-      conn->send(response.getError());
+                 drogon::WebSocketConnectionPtr conn, bool binary) {
+  ResponseCallback callback = [conn = std::move(conn),
+                               binary](const InferenceResponse &response) {
+    if (!conn->connected()) {
+      return;
+    }
+    if (binary) {
+      // whole responses are sent as binary frames, errors included
+      try {
+        sendMessage(conn, encodeResponseFrame(response), true,
+                    !response.isError());
+      } catch (const invalid_argument &e) {
+        sendError(conn, binary, e.what(), response.getID());
+      }
+    } else if (response.isError()) {
+      sendError(conn, binary, response.getError());
     } else {
-      auto outputs = response.getOutputs();
-      const auto *msg = static_cast<char *>(outputs[0].getData());
-      if (conn->connected()) {
-        conn->send(msg, outputs[0].getSize());
+      const auto &outputs = response.getOutputs();
+      const auto &output = outputs[0];
+      const auto *msg = static_cast<char *>(output.getData());
+      // string outputs are sent as text and the rest as raw binary data
+      const auto datatype = output.getDatatype();
+      if (datatype == DataType::String) {
+        sendMessage(conn, std::string(msg, output.getSize()), false);
+      } else {
+        sendMessage(conn, std::string(msg, output.getSize() * datatype.size()),
+                    true);
       }
     }
   };
@@ -72,36 +215,57 @@ void WebsocketServer::handleNewMessage(const WebSocketConnectionPtr &conn,
     return;
   }
 
-  auto json = std::make_shared<Json::Value>();
-  std::string errors;
-  Json::CharReaderBuilder builder;
-  Json::CharReader *reader = builder.newCharReader();
-  bool parsing_successful = reader->parse(
-    message.data(), message.data() + message.size(), json.get(), &errors);
-  delete reader;  // NOLINT(cppcoreguidelines-owning-memory)
-
-  // if we fail to get the JSON object, return
-  if (!parsing_successful) {
-    AMDINFER_LOG_INFO(logger_, "Failed to parse JSON request to websocket");
-    conn->shutdown(drogon::CloseCode::kInvalidMessage,
-                   "No JSON could be parsed in the request");
-    return;
-  }
-
+  const auto binary = isBinary(conn);
   std::string model;
-  if (json->isMember("model")) {
-    model = json->get("model", "").asString();
+  InferenceRequestPtr request;
+  if (binary && type == WebSocketMessageType::Binary) {
+    // errors in binary frames are sent back so the connection stays open
+    try {
+      const auto frame = decodeFrame(message);
+      model = util::toLower(frame.model);
+      request = getRequest(frame, state_->getPool());
+    } catch (const invalid_argument &e) {
+      AMDINFER_LOG_INFO(logger_, e.what());
+      sendError(conn, binary, e.what());
+      return;
+    }
   } else {
-    AMDINFER_LOG_INFO(logger_, "No model request found in websocket");
-    conn->shutdown(drogon::CloseCode::kInvalidMessage,
-                   "No model found in request");
-    return;
+    auto json = std::make_shared<Json::Value>();
+    std::string errors;
+    Json::CharReaderBuilder builder;
+    Json::CharReader *reader = builder.newCharReader();
+    bool parsing_successful = reader->parse(
+      message.data(), message.data() + message.size(), json.get(), &errors);
+    delete reader;  // NOLINT(cppcoreguidelines-owning-memory)
+
+    // if we fail to get the JSON object, return
+    if (!parsing_successful) {
+      AMDINFER_LOG_INFO(logger_, "Failed to parse JSON request to websocket");
+      conn->shutdown(drogon::CloseCode::kInvalidMessage,
+                     "No JSON could be parsed in the request");
+      return;
+    }
+
+    if (json->isMember(kWebsocketAck) && !json->isMember("model")) {
+      const auto &bytes = (*json)[kWebsocketAck];
+      if (bytes.isUInt64()) {
+        ack(conn, bytes.asUInt64());
+      }
+      return;
+    }
+
+    if (json->isMember("model")) {
+      model = util::toLower(json->get("model", "").asString());
+    } else {
+      AMDINFER_LOG_INFO(logger_, "No model request found in websocket");
+      conn->shutdown(drogon::CloseCode::kInvalidMessage,
+                     "No model found in request");
+      return;
+    }
+    request = getRequest(json, state_->getPool());
   }
-  std::transform(model.begin(), model.end(), model.begin(),
-                 [](unsigned char c) { return std::tolower(c); });
 
-  auto request = getRequest(json, state_->getPool());
-  setCallback(request.get(), conn);
+  setCallback(request.get(), conn, binary);
   auto request_container = std::make_unique<RequestContainer>();
   request_container->request = request;
 #ifdef AMDINFER_ENABLE_TRACING
@@ -113,7 +277,11 @@ void WebsocketServer::handleNewMessage(const WebSocketConnectionPtr &conn,
     state_->modelInfer(model, std::move(request_container));
   } catch (const runtime_error &e) {
     AMDINFER_LOG_INFO(logger_, e.what());
-    conn->shutdown(drogon::CloseCode::kInvalidMessage, e.what());
+    if (binary) {
+      sendError(conn, binary, e.what(), request->getID());
+    } else {
+      conn->shutdown(drogon::CloseCode::kInvalidMessage, e.what());
+    }
     return;
   }
 }
@@ -121,15 +289,52 @@ void WebsocketServer::handleNewMessage(const WebSocketConnectionPtr &conn,
 void WebsocketServer::handleConnectionClosed(
   const WebSocketConnectionPtr &conn) {
   AMDINFER_LOG_INFO(logger_, "Websocket closed");
-  // (void)conn;  // suppress unused variable warning
+  // wake any workers blocked on the window
+  if (const auto context = conn->getContext<Connection>(); context != nullptr) {
+    context->window->close();
+#ifdef AMDINFER_ENABLE_METRICS
+    if (context->window->bounded()) {
+      Metrics::getInstance().removeGauge(MetricGaugeIDs::WebsocketBufferedBytes,
+                                         context->name);
+    }
+#endif
+  }
   conn->shutdown();
 }
 
 void WebsocketServer::handleNewConnection(const HttpRequestPtr &req,
                                           const WebSocketConnectionPtr &conn) {
   AMDINFER_LOG_INFO(logger_, "New websocket connection");
-  (void)conn;  // suppress unused variable warning
-  (void)req;   // suppress unused variable warning
+  auto context = std::make_shared<Connection>();
+  if (req->getParameter(kWebsocketProtocol) == kWebsocketBinaryProtocol) {
+    context->protocol = Protocol::Binary;
+  }
+  context->name = conn->peerAddr().toIpPort();
+
+  size_t window = 0;
+  WebSocketWindowPolicy policy = WebSocketWindowPolicy::Block;
+  try {
+    if (const auto &value = req->getParameter(kWebsocketWindow);
+        !value.empty()) {
+      window = std::stoull(value);
+    }
+    policy = parseWindowPolicy(req->getParameter(kWebsocketWindowPolicy));
+  } catch (const std::exception &e) {
+    AMDINFER_LOG_INFO(logger_, e.what());
+    conn->shutdown(drogon::CloseCode::kInvalidMessage,
+                   "Invalid websocket window");
+    return;
+  }
+  // the sender doesn't keep the connection alive since it's in its context
+  std::weak_ptr<drogon::WebSocketConnection> weak_conn = conn;
+  context->window = std::make_unique<SendWindow>(
+    window, policy, [weak_conn](const std::string &message, bool binary) {
+      if (auto conn = weak_conn.lock(); conn != nullptr) {
+        conn->send(message, binary ? WebSocketMessageType::Binary
+                                   : WebSocketMessageType::Text);
+      }
+    });
+  conn->setContext(std::move(context));
 }
 
 }  // namespace amdinfer::http
@@ -0,0 +1,130 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the worker host
+ */
+
+#include "amdinfer/servers/worker_host.hpp"
+
+#include <sys/prctl.h>  // for prctl, PR_SET_PDEATHSIG
+
+#include <chrono>     // for milliseconds
+#include <csignal>    // for SIGKILL
+#include <exception>  // for exception
+#include <memory>     // for make_unique
+#include <optional>   // for optional
+#include <utility>    // for move
+
+#include "amdinfer/buffers/buffer.hpp"           // for Buffer
+#include "amdinfer/core/exceptions.hpp"          // for runtime_error
+#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/core/request_container.hpp"   // for RequestContainer
+#include "amdinfer/core/shared_state.hpp"        // for SharedState
+#include "amdinfer/core/wire_format.hpp"         // for decodeRequest
+
+namespace amdinfer {
+
+/// How often the host checks if the channel was closed while it's idle
+constexpr std::chrono::milliseconds kHostPoll{100};
+
+WorkerHost::WorkerHost(SharedState* state, const std::string& channel)
+  : state_(state), channel_(channel) {
+  prctl(PR_SET_PDEATHSIG, SIGKILL);
+}
+
+void WorkerHost::run() {
+  if (!load()) {
+    return;
+  }
+  while (!channel_.isClosed()) {
+    auto message = channel_.receive(kHostPoll);
+    if (message.has_value()) {
+      submit(std::move(message.value()));
+    }
+  }
+  // the worker finishes its requests as it's unloaded, though their responses
+  // have nowhere to go
+  state_->workerUnload(endpoint_);
+}
+
+bool WorkerHost::load() {
+  std::optional<ChannelMessage> message;
+  while (!message.has_value()) {
+    if (channel_.isClosed()) {
+      return false;
+    }
+    message = channel_.receive(kHostPoll);
+  }
+
+  InferenceResponse reply;
+  try {
+    const auto decoded = decodeRequest(message->header, message->body);
+    endpoint_ = state_->workerLoad(decoded.model,
+                                   decoded.request->getParameters());
+    reply = describeModel(state_->modelMetadata(endpoint_));
+  } catch (const std::exception& e) {
+    AMDINFER_LOG_ERROR(logger_, e.what());
+    reply = InferenceResponse{e.what()};
+  }
+  channel_.send(encodeResponse(message->header.tag, reply));
+  return !reply.isError();
+}
+
+void WorkerHost::submit(ChannelMessage message) {
+  const auto tag = message.header.tag;
+  WireRequest decoded;
+  try {
+    decoded = decodeRequest(message.header, message.body);
+  } catch (const invalid_argument& e) {
+    AMDINFER_LOG_INFO(logger_, e.what());
+    channel_.send(encodeResponse(tag, InferenceResponse{e.what()}));
+    return;
+  }
+  const auto& request = decoded.request;
+
+  auto request_container = std::make_unique<RequestContainer>();
+  // the inputs are read where they are in the channel, which the callback
+  // keeps from being reused for as long as the request
+  const auto& inputs = request->getInputs();
+  request_container->input_views.reserve(inputs.size());
+  request_container->input_writers.reserve(inputs.size());
+  for (const auto& input : inputs) {
+    const auto* data = input.getData();
+    const auto size = input.getSize() * input.getDatatype().size();
+    request_container->input_views.push_back(data);
+    request_container->input_writers.emplace_back(
+      [data, size](Buffer* buffer, size_t offset) {
+        buffer->write(data, offset, size);
+      });
+  }
+  request->setCallback([channel = &channel_, owner = std::move(message.owner),
+                        tag](const InferenceResponse& response) {
+    channel->send(encodeResponse(tag, response));
+  });
+  request_container->request = request;
+
+  try {
+    state_->modelInfer(endpoint_, std::move(request_container));
+  } catch (const runtime_error& e) {
+    AMDINFER_LOG_INFO(logger_, e.what());
+    InferenceResponse response{e.what()};
+    response.setID(request->getID());
+    channel_.send(encodeResponse(tag, response));
+  }
+}
+
+}  // namespace amdinfer
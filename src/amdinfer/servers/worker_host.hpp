@@ -0,0 +1,71 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the worker host, which serves one worker to the server that
+ * started it
+ */
+
+#ifndef GUARD_AMDINFER_SERVERS_WORKER_HOST
+#define GUARD_AMDINFER_SERVERS_WORKER_HOST
+
+#include <string>  // for string
+
+#include "amdinfer/build_options.hpp"         // for AMDINFER_ENABLE_LOGGING
+#include "amdinfer/core/process_channel.hpp"  // for ProcessChannel
+#include "amdinfer/observation/logging.hpp"   // for Logger
+
+namespace amdinfer {
+
+class SharedState;
+
+/**
+ * @brief The worker host runs in a process started by the Process worker of
+ * another server. It opens the channel that the server created, loads the
+ * worker that it's sent and then submits the requests that arrive on the
+ * channel to it, sending back their responses, until the server closes the
+ * channel.
+ */
+class WorkerHost {
+ public:
+  /**
+   * @brief Construct a new WorkerHost object and open its channel. The host
+   * is killed if its parent exits so it isn't left running.
+   *
+   * @param state the host's state to load the worker into
+   * @param channel the name of the channel to the server
+   */
+  WorkerHost(SharedState* state, const std::string& channel);
+
+  /// Load the worker and serve it until the channel is closed
+  void run();
+
+ private:
+  /// Load the worker from the first message, replying with its metadata
+  bool load();
+  /// Decode a request in place and submit it to the worker
+  void submit(ChannelMessage message);
+
+  SharedState* state_;
+  ProcessChannel channel_;
+  std::string endpoint_;
+#ifdef AMDINFER_ENABLE_LOGGING
+  Logger logger_{Loggers::Server};
+#endif
+};
+
+}  // namespace amdinfer
+
+#endif  // GUARD_AMDINFER_SERVERS_WORKER_HOST
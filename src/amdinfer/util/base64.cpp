@@ -15,74 +15,356 @@
 
 /**
  * @file
- * @brief Implements base64 encoding/decoding
+ * @brief Implements base64 encoding/decoding. Whole blocks are converted with
+ * SIMD kernels, if the CPU supports them, and the rest with scalar code.
  */
 
 #include "amdinfer/util/base64.hpp"
 
-#include <stdexcept>
+#include <array>        // for array
+#include <cstddef>      // for size_t
+#include <cstdint>      // for uint8_t, uint32_t
+#include <string>       // for string
+#include <string_view>  // for string_view
 
-// this define is needed for compilation but its value isn't used here
-// NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
-#define BUFFERSIZE 4096
-#include <b64/decode.h>
-#include <b64/encode.h>
+#include "amdinfer/pre_post/simd.hpp"  // for AMDINFER_X86_SIMD, hasAvx2
 
 namespace amdinfer::util {
 
-constexpr size_t minDecodeLength(size_t length) { return (length * 3 + 3) / 4; }
+namespace {
 
-std::string base64Decode(std::string in) {
-  return base64Decode(in.data(), in.length());
-}
-
-std::string base64Decode(const char* in, size_t in_length) {
-  std::string s;
-  s.resize(minDecodeLength(in_length));
+constexpr std::string_view kAlphabet =
+  "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+constexpr char kPadding = '=';
+/// Set in the decoding table for characters outside the alphabet
+constexpr uint8_t kInvalid = 0x80;
+constexpr auto kSextetBits = 6;
+constexpr uint32_t kSextetMask = 0x3F;
+constexpr uint32_t kByteMask = 0xFF;
 
-  base64::base64_decodestate state;
-  base64::base64_init_decodestate(&state);
-  int out_length = base64::base64_decode_block(in, in_length, s.data(), &state);
-
-  if (out_length < 0) {
-    throw std::length_error("Base64 decoded string failed");
+constexpr std::array<uint8_t, 256> makeDecodeTable() {
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init)
+  std::array<uint8_t, 256> table{};
+  for (auto& entry : table) {
+    entry = kInvalid;
   }
-
-  s.resize(out_length);
-  return s;
+  for (size_t i = 0; i < kAlphabet.size(); ++i) {
+    table[static_cast<uint8_t>(kAlphabet[i])] = static_cast<uint8_t>(i);
+  }
+  return table;
 }
 
+/// Maps characters to their 6-bit values, or kInvalid
+constexpr auto kDecodeTable = makeDecodeTable();
+
+/// Decoded bytes of length characters, which is exact without padding
+constexpr size_t maxDecodeLength(size_t length) { return (length * 3 + 3) / 4; }
+
 /**
- * @brief Compute the minimum space needed for a base64-encoded string. Base64
- * produces 4 output bytes for every 3 input bytes.
+ * @brief Compute the space needed for a base64-encoded string. Base64 produces
+ * 4 output bytes for every 3 input bytes, with padding.
  *
  * @param length length of the string to encode
  * @return constexpr size_t
  */
-constexpr size_t minEncodeLength(size_t length) {
-  return (((4 * length / 3) + 3) & ~3);
+constexpr size_t encodeLength(size_t length) { return (length + 2) / 3 * 4; }
+
+void encodeScalar(const uint8_t* in, size_t length, char* out) {
+  size_t i = 0;
+  for (; i + 3 <= length; i += 3) {
+    const uint32_t block = (in[i] << 16U) | (in[i + 1] << 8U) | in[i + 2];
+    *out++ = kAlphabet[block >> 18U];
+    *out++ = kAlphabet[(block >> 12U) & kSextetMask];
+    *out++ = kAlphabet[(block >> 6U) & kSextetMask];
+    *out++ = kAlphabet[block & kSextetMask];
+  }
+  const auto rest = length - i;
+  if (rest > 0) {
+    const uint32_t block = (in[i] << 16U) | (rest == 2 ? in[i + 1] << 8U : 0);
+    *out++ = kAlphabet[block >> 18U];
+    *out++ = kAlphabet[(block >> 12U) & kSextetMask];
+    *out++ = rest == 2 ? kAlphabet[(block >> 6U) & kSextetMask] : kPadding;
+    *out++ = kPadding;
+  }
 }
 
-std::string base64Encode(std::string in) {
-  return base64Encode(in.data(), in.length());
+/// Decode, skipping characters outside the alphabet, and return the length
+size_t decodeScalar(const uint8_t* in, size_t length, char* out) {
+  char* start = out;
+  uint32_t block = 0;
+  size_t sextets = 0;
+  for (size_t i = 0; i < length; ++i) {
+    const auto value = kDecodeTable[in[i]];
+    if (value == kInvalid) {
+      continue;
+    }
+    block = (block << kSextetBits) | value;
+    if (++sextets == 4) {
+      *out++ = static_cast<char>(block >> 16U);
+      *out++ = static_cast<char>((block >> 8U) & kByteMask);
+      *out++ = static_cast<char>(block & kByteMask);
+      block = 0;
+      sextets = 0;
+    }
+  }
+  // a trailing sextet alone doesn't make a byte
+  if (sextets == 2) {
+    *out++ = static_cast<char>(block >> 4U);
+  } else if (sextets == 3) {
+    *out++ = static_cast<char>(block >> 10U);
+    *out++ = static_cast<char>((block >> 2U) & kByteMask);
+  }
+  return out - start;
 }
 
-std::string base64Encode(const char* in, size_t in_length) {
-  std::string s;
-  s.resize(minEncodeLength(in_length));
+#ifdef AMDINFER_X86_SIMD
+
+// The kernels below follow Muła and Lemire, "Faster Base64 Encoding and
+// Decoding Using AVX2 Instructions" and "Base64 encoding and decoding at
+// almost the speed of a memory copy". Each returns how much of the input it
+// converted, always in whole blocks, and leaves the rest to the scalar code.
+
+/// Encode 24 bytes at a time and return how many bytes were encoded
+__attribute__((target("avx2"))) size_t encodeAvx2(const uint8_t* in,
+                                                  size_t length, char* out) {
+  // each lane takes 12 bytes and splits their 6-bit groups into bytes
+  const auto reshuffle = _mm256_setr_epi8(
+    1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,  //
+    1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+  // the offset from each range of 6-bit values to its characters
+  const auto offsets = _mm256_setr_epi8(
+    'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+    '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0,
+    'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+    '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
 
-  base64::base64_encodestate state;
-  base64::base64_init_encodestate(&state);
-  int code_length =
-    base64::base64_encode_block(in, in_length, s.data(), &state);
-  code_length += base64::base64_encode_blockend(s.data() + code_length, &state);
+  // the second lane's load reads 28 bytes in all
+  constexpr size_t kRead = 32;
+  constexpr size_t kBlock = 24;
+  constexpr size_t kLane = 12;
+  size_t i = 0;
+  for (; i + kRead <= length; i += kBlock) {
+    const auto* src = reinterpret_cast<const __m128i*>(in + i);
+    const auto* src_hi = reinterpret_cast<const __m128i*>(in + i + kLane);
+    auto input = _mm256_inserti128_si256(
+      _mm256_castsi128_si256(_mm_loadu_si128(src)), _mm_loadu_si128(src_hi), 1);
+    input = _mm256_shuffle_epi8(input, reshuffle);
+    const auto t0 = _mm256_and_si256(input, _mm256_set1_epi32(0x0fc0fc00));
+    const auto t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+    const auto t2 = _mm256_and_si256(input, _mm256_set1_epi32(0x003f03f0));
+    const auto t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+    const auto indices = _mm256_or_si256(t1, t3);
 
-  if (code_length < 0) {
-    throw std::length_error("Base64 encoding string failed");
+    // 0-25 map to 13, 26-51 to 0, 52-61 to 1-10 and 62 and 63 to 11 and 12
+    auto ranges = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+    const auto less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+    ranges =
+      _mm256_or_si256(ranges, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+    const auto chars =
+      _mm256_add_epi8(_mm256_shuffle_epi8(offsets, ranges), indices);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i / 3 * 4), chars);
   }
+  return i;
+}
+
+/// Decode 32 characters at a time, stopping at the first block with any
+/// outside the alphabet, and return how many characters were decoded
+__attribute__((target("avx2"))) size_t decodeAvx2(const uint8_t* in,
+                                                  size_t length, char* out) {
+  // a character is valid if its entries in these tables share no bits
+  const auto lut_lo = _mm256_setr_epi8(
+    0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A,
+    0x1B, 0x1B, 0x1B, 0x1A, 0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+    0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+  const auto lut_hi = _mm256_setr_epi8(
+    0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10,
+    0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+    0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+  // the offset from each range of characters to their 6-bit values
+  const auto lut_roll =
+    _mm256_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+                     0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+  const auto mask_2f = _mm256_set1_epi8(0x2F);
+  const auto pack = _mm256_setr_epi8(
+    2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,  //
+    2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+  const auto pack_lanes = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, -1, -1);
+
+  // each block is stored as 32 bytes, of which 24 are decoded, so stop while
+  // the output still has room for the padding
+  constexpr size_t kBlock = 32;
+  constexpr size_t kReserve = 44;
+  size_t i = 0;
+  for (; i + kReserve <= length; i += kBlock) {
+    auto str = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+    const auto hi_nibbles =
+      _mm256_and_si256(_mm256_srli_epi32(str, 4), mask_2f);
+    const auto lo_nibbles = _mm256_and_si256(str, mask_2f);
+    const auto hi = _mm256_shuffle_epi8(lut_hi, hi_nibbles);
+    const auto lo = _mm256_shuffle_epi8(lut_lo, lo_nibbles);
+    if (_mm256_testz_si256(lo, hi) == 0) {
+      break;
+    }
+    const auto eq_2f = _mm256_cmpeq_epi8(str, mask_2f);
+    const auto roll =
+      _mm256_shuffle_epi8(lut_roll, _mm256_add_epi8(eq_2f, hi_nibbles));
+    str = _mm256_add_epi8(str, roll);
+
+    // join the 6-bit values into 24-bit groups, big-endian, and pack them
+    const auto pairs =
+      _mm256_maddubs_epi16(str, _mm256_set1_epi32(0x01400140));
+    auto groups = _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+    groups = _mm256_shuffle_epi8(groups, pack);
+    groups = _mm256_permutevar8x32_epi32(groups, pack_lanes);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i / 4 * 3), groups);
+  }
+  return i;
+}
+
+// GCC 12 warns that the pass-through values of the unmasked VBMI intrinsics
+// may be uninitialized so the zero-masked forms are used instead
+constexpr __mmask64 kAllBytes = ~__mmask64{0};
+
+/// Encode 48 bytes at a time and return how many bytes were encoded
+__attribute__((target("avx512f,avx512bw,avx512vbmi"))) size_t encodeAvx512(
+  const uint8_t* in, size_t length, char* out) {
+  // copy each group of 3 bytes into 4, as bytes 1, 0, 2 and 1
+  const auto reshuffle = _mm512_setr_epi32(
+    0x01020001, 0x04050304, 0x07080607, 0x0a0b090a, 0x0d0e0c0d, 0x10110f10,
+    0x13141213, 0x16171516, 0x191a1819, 0x1c1d1b1c, 0x1f201e1f, 0x22232122,
+    0x25262425, 0x28292728, 0x2b2c2a2b, 0x2e2f2d2e);
+  // the bit offsets of the four 6-bit groups in each pair of 32-bit words
+  const auto shifts = _mm512_set1_epi64(0x3036242a1016040a);
+  const auto alphabet = _mm512_loadu_si512(kAlphabet.data());
+
+  constexpr size_t kRead = 64;
+  constexpr size_t kBlock = 48;
+  size_t i = 0;
+  for (; i + kRead <= length; i += kBlock) {
+    auto input = _mm512_loadu_si512(in + i);
+    input = _mm512_maskz_permutexvar_epi8(kAllBytes, reshuffle, input);
+    // the permute only uses the low 6 bits of each byte
+    const auto indices =
+      _mm512_maskz_multishift_epi64_epi8(kAllBytes, shifts, input);
+    _mm512_storeu_si512(
+      out + i / 3 * 4,
+      _mm512_maskz_permutexvar_epi8(kAllBytes, indices, alphabet));
+  }
+  return i;
+}
 
-  s.resize(code_length);
+/// Decode 64 characters at a time, stopping at the first block with any
+/// outside the alphabet, and return how many characters were decoded
+__attribute__((target("avx512f,avx512bw,avx512vbmi"))) size_t decodeAvx512(
+  const uint8_t* in, size_t length, char* out) {
+  // the two halves of the decoding table for the ASCII characters
+  const auto table_lo = _mm512_loadu_si512(kDecodeTable.data());
+  const auto table_hi = _mm512_loadu_si512(kDecodeTable.data() + 64);
+  // get bytes 2, 1 and 0 of each 32-bit group
+  const auto pack = _mm512_setr_epi32(
+    0x06000102, 0x090a0405, 0x0c0d0e08, 0x16101112, 0x191a1415, 0x1c1d1e18,
+    0x26202122, 0x292a2425, 0x2c2d2e28, 0x36303132, 0x393a3435, 0x3c3d3e38, 0,
+    0, 0, 0);
+
+  // each block is stored as 64 bytes, of which 48 are decoded, so stop while
+  // the output still has room for the padding
+  constexpr size_t kBlock = 64;
+  constexpr size_t kReserve = 88;
+  size_t i = 0;
+  for (; i + kReserve <= length; i += kBlock) {
+    const auto str = _mm512_loadu_si512(in + i);
+    const auto values = _mm512_permutex2var_epi8(table_lo, str, table_hi);
+    // non-ASCII characters have the high bit set themselves
+    if (_mm512_movepi8_mask(_mm512_or_si512(values, str)) != 0) {
+      break;
+    }
+    const auto pairs =
+      _mm512_maddubs_epi16(values, _mm512_set1_epi32(0x01400140));
+    const auto groups =
+      _mm512_madd_epi16(pairs, _mm512_set1_epi32(0x00011000));
+    // only the first 48 bytes are decoded
+    const __mmask64 decoded = 0xFFFFFFFFFFFF;
+    _mm512_storeu_si512(out + i / 4 * 3,
+                        _mm512_maskz_permutexvar_epi8(decoded, pack, groups));
+  }
+  return i;
+}
+
+#endif
+
+}  // namespace
+
+namespace detail {
+
+Base64Kernel getBase64Kernel() {
+#ifdef AMDINFER_X86_SIMD
+  static const auto kernel = [] {
+    if (pre_post::detail::hasAvx512Vbmi()) {
+      return Base64Kernel::Avx512Vbmi;
+    }
+    if (pre_post::detail::hasAvx2()) {
+      return Base64Kernel::Avx2;
+    }
+    return Base64Kernel::Scalar;
+  }();
+  return kernel;
+#else
+  return Base64Kernel::Scalar;
+#endif
+}
+
+std::string base64Decode(const char* in, size_t in_len, Base64Kernel kernel) {
+  std::string s;
+  s.resize(maxDecodeLength(in_len));
+  const auto* src = reinterpret_cast<const uint8_t*>(in);
+
+  size_t decoded = 0;
+#ifdef AMDINFER_X86_SIMD
+  if (kernel == Base64Kernel::Avx512Vbmi) {
+    decoded = decodeAvx512(src, in_len, s.data());
+  } else if (kernel == Base64Kernel::Avx2) {
+    decoded = decodeAvx2(src, in_len, s.data());
+  }
+#endif
+  auto* dest = s.data() + decoded / 4 * 3;
+  dest += decodeScalar(src + decoded, in_len - decoded, dest);
+  s.resize(dest - s.data());
   return s;
 }
 
+std::string base64Encode(const char* in, size_t in_len, Base64Kernel kernel) {
+  std::string s;
+  s.resize(encodeLength(in_len));
+  const auto* src = reinterpret_cast<const uint8_t*>(in);
+
+  size_t encoded = 0;
+#ifdef AMDINFER_X86_SIMD
+  if (kernel == Base64Kernel::Avx512Vbmi) {
+    encoded = encodeAvx512(src, in_len, s.data());
+  } else if (kernel == Base64Kernel::Avx2) {
+    encoded = encodeAvx2(src, in_len, s.data());
+  }
+#endif
+  encodeScalar(src + encoded, in_len - encoded, s.data() + encoded / 3 * 4);
+  return s;
+}
+
+}  // namespace detail
+
+std::string base64Decode(std::string_view in) {
+  return base64Decode(in.data(), in.length());
+}
+
+std::string base64Decode(const char* in, size_t in_len) {
+  return detail::base64Decode(in, in_len, detail::getBase64Kernel());
+}
+
+std::string base64Encode(std::string_view in) {
+  return base64Encode(in.data(), in.length());
+}
+
+std::string base64Encode(const char* in, size_t in_len) {
+  return detail::base64Encode(in, in_len, detail::getBase64Kernel());
+}
+
 }  // namespace amdinfer::util
@@ -21,18 +21,22 @@
 #ifndef GUARD_AMDINFER_UTIL_BASE64
 #define GUARD_AMDINFER_UTIL_BASE64
 
-#include <cstddef>  // for size_t
-#include <string>   // for string
+#include <cstddef>      // for size_t
+#include <string>       // for string
+#include <string_view>  // for string_view
 
 namespace amdinfer::util {
 
 /**
- * @brief Decodes a base64-encoded string and returns it
+ * @brief Decodes a base64-encoded string and returns it. Characters outside
+ * the base64 alphabet, such as line breaks and padding, are skipped. Runs of
+ * valid characters are decoded with AVX-512 VBMI or AVX2 if the CPU supports
+ * them.
  *
  * @param in the encoded string
  * @return std::string decoded string
  */
-std::string base64Decode(std::string in);
+std::string base64Decode(std::string_view in);
 
 /**
  * @brief Decodes a base64-encoded string and returns it
@@ -44,12 +48,14 @@ std::string base64Decode(std::string in);
 std::string base64Decode(const char* in, size_t in_len);
 
 /**
- * @brief Encodes a string with base64 and returns it
+ * @brief Encodes a string with base64 and returns it. The output is padded
+ * and has no line breaks. It's encoded with AVX-512 VBMI or AVX2 if the CPU
+ * supports them.
  *
  * @param in string to encode
  * @return std::string encoded string
  */
-std::string base64Encode(std::string in);
+std::string base64Encode(std::string_view in);
 
 /**
  * @brief Encodes a string with base64 and returns it
@@ -59,6 +65,23 @@ std::string base64Encode(std::string in);
  * @return std::string encoded string
  */
 std::string base64Encode(const char* in, size_t in_len);
+
+namespace detail {
+
+/// The instruction sets that the base64 kernels are written for, in order
+enum class Base64Kernel { Scalar, Avx2, Avx512Vbmi };
+
+/// Get the fastest base64 kernel that the CPU supports
+Base64Kernel getBase64Kernel();
+
+/// Decode with the given kernel, which the CPU must support
+std::string base64Decode(const char* in, size_t in_len, Base64Kernel kernel);
+
+/// Encode with the given kernel, which the CPU must support
+std::string base64Encode(const char* in, size_t in_len, Base64Kernel kernel);
+
+}  // namespace detail
+
 }  // namespace amdinfer::util
 
 #endif  // GUARD_AMDINFER_UTIL_BASE64
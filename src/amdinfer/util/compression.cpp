@@ -17,8 +17,14 @@
 
 #include <zlib.h>  // for z_stream, inflate, inflateEnd, Z_OK, Z_NO_FLUSH
 
-#include <array>    // for array
-#include <cstring>  // for memset
+#include <array>      // for array
+#include <cctype>     // for tolower
+#include <cstring>    // for memset
+#include <limits>     // for numeric_limits
+#include <stdexcept>  // for logic_error
+#include <string>     // for string, stod
+
+#include "amdinfer/core/exceptions.hpp"  // for invalid_argument
 
 namespace amdinfer::util {
 
@@ -52,4 +58,182 @@ std::string zDecompress(const char *str, int len) {
   return "";
 }
 
+namespace {
+
+/// zlib's window size. Adding 16 writes gzip and adding 32 reads either format
+constexpr auto kWindowBits = 15;
+constexpr auto kGzipWindowBits = kWindowBits + 16;
+constexpr auto kDetectWindowBits = kWindowBits + 32;
+constexpr auto kMemoryLevel = 8;
+
+std::string_view trim(std::string_view str) {
+  const auto *whitespace = " \t";
+  const auto start = str.find_first_not_of(whitespace);
+  if (start == std::string_view::npos) {
+    return {};
+  }
+  const auto end = str.find_last_not_of(whitespace);
+  return str.substr(start, end - start + 1);
+}
+
+std::string lower(std::string_view str) {
+  std::string lowered{str};
+  for (auto &c : lowered) {
+    c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+  }
+  return lowered;
+}
+
+}  // namespace
+
+std::string compress(std::string_view data, Compression algorithm) {
+  if (algorithm == Compression::None) {
+    return std::string{data};
+  }
+  if (data.size() > std::numeric_limits<uInt>::max()) {
+    throw invalid_argument("The data is too large to compress");
+  }
+
+  z_stream zs;
+  memset(&zs, 0, sizeof(zs));
+  const auto window_bits =
+    algorithm == Compression::Gzip ? kGzipWindowBits : kWindowBits;
+  // the fastest level keeps most of the savings on the bandwidth at a fraction
+  // of the time of the higher levels
+  if (deflateInit2(&zs, Z_BEST_SPEED, Z_DEFLATED, window_bits, kMemoryLevel,
+                   Z_DEFAULT_STRATEGY) != Z_OK) {
+    throw runtime_error("Failed to initialize zlib to compress");
+  }
+
+  std::string out_string;
+  out_string.resize(deflateBound(&zs, static_cast<uLong>(data.size())));
+  const auto *input = reinterpret_cast<const Bytef *>(data.data());
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+  zs.next_in = const_cast<Bytef *>(input);
+  zs.avail_in = static_cast<uInt>(data.size());
+  zs.next_out = reinterpret_cast<Bytef *>(out_string.data());
+  zs.avail_out = static_cast<uInt>(out_string.size());
+  // the output has room for the worst case so it finishes in one call
+  const auto ret = deflate(&zs, Z_FINISH);
+  deflateEnd(&zs);
+  if (ret != Z_STREAM_END) {
+    throw runtime_error("Failed to compress the data");
+  }
+  out_string.resize(zs.total_out);
+  return out_string;
+}
+
+std::string decompress(std::string_view data, size_t max_size) {
+  const auto chunk_size = 32'768;
+  if (data.size() > std::numeric_limits<uInt>::max()) {
+    throw invalid_argument("The data is too large to decompress");
+  }
+
+  z_stream zs;
+  memset(&zs, 0, sizeof(zs));
+  if (inflateInit2(&zs, kDetectWindowBits) != Z_OK) {
+    throw runtime_error("Failed to initialize zlib to decompress");
+  }
+  const auto *input = reinterpret_cast<const Bytef *>(data.data());
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+  zs.next_in = const_cast<Bytef *>(input);
+  zs.avail_in = static_cast<uInt>(data.size());
+
+  int ret = Z_OK;
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
+  std::array<char, chunk_size> out_buffer;
+  std::string out_string;
+  do {
+    zs.next_out = reinterpret_cast<Bytef *>(out_buffer.data());
+    zs.avail_out = out_buffer.size();
+    ret = inflate(&zs, Z_NO_FLUSH);
+    const auto produced = out_buffer.size() - zs.avail_out;
+    if (out_string.size() + produced > max_size) {
+      inflateEnd(&zs);
+      throw invalid_argument("The decompressed data exceeds " +
+                             std::to_string(max_size) + " bytes");
+    }
+    out_string.append(out_buffer.data(), produced);
+  } while (ret == Z_OK);
+  inflateEnd(&zs);
+  if (ret != Z_STREAM_END) {
+    throw invalid_argument("The compressed data is invalid");
+  }
+  return out_string;
+}
+
+const char *getEncodingName(Compression algorithm) {
+  switch (algorithm) {
+    case Compression::Deflate:
+      return "deflate";
+    case Compression::Gzip:
+      return "gzip";
+    default:
+      return "identity";
+  }
+}
+
+Compression parseContentEncoding(std::string_view encoding) {
+  const auto name = lower(trim(encoding));
+  if (name.empty() || name == "identity") {
+    return Compression::None;
+  }
+  if (name == "gzip" || name == "x-gzip") {
+    return Compression::Gzip;
+  }
+  if (name == "deflate") {
+    return Compression::Deflate;
+  }
+  throw invalid_argument("Unsupported Content-Encoding: " + name);
+}
+
+Compression negotiateEncoding(std::string_view accept_encoding,
+                              Compression preferred) {
+  if (preferred == Compression::None) {
+    return Compression::None;
+  }
+
+  bool gzip = false;
+  bool deflate = false;
+  while (!accept_encoding.empty()) {
+    const auto comma = accept_encoding.find(',');
+    auto coding = accept_encoding.substr(0, comma);
+    accept_encoding.remove_prefix(
+      comma == std::string_view::npos ? accept_encoding.size() : comma + 1);
+
+    // codings with a quality of 0 are explicitly not acceptable
+    bool acceptable = true;
+    const auto semicolon = coding.find(';');
+    if (semicolon != std::string_view::npos) {
+      const auto parameter = lower(trim(coding.substr(semicolon + 1)));
+      if (parameter.rfind("q=", 0) == 0) {
+        try {
+          acceptable = std::stod(parameter.substr(2)) > 0;
+        } catch (const std::logic_error &) {
+          acceptable = false;
+        }
+      }
+      coding = coding.substr(0, semicolon);
+    }
+
+    const auto name = lower(trim(coding));
+    if (name == "gzip" || name == "x-gzip" || name == "*") {
+      gzip = gzip || acceptable;
+    }
+    if (name == "deflate" || name == "*") {
+      deflate = deflate || acceptable;
+    }
+  }
+
+  const auto accepted = [&](Compression algorithm) {
+    return algorithm == Compression::Gzip ? gzip : deflate;
+  };
+  if (accepted(preferred)) {
+    return preferred;
+  }
+  const auto other = preferred == Compression::Gzip ? Compression::Deflate
+                                                    : Compression::Gzip;
+  return accepted(other) ? other : Compression::None;
+}
+
 }  // namespace amdinfer::util
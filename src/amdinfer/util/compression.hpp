@@ -16,7 +16,12 @@
 #ifndef GUARD_AMDINFER_HELPERS_COMPRESSION
 #define GUARD_AMDINFER_HELPERS_COMPRESSION
 
-#include <string>
+#include <cstddef>      // for size_t
+#include <limits>       // for numeric_limits
+#include <string>       // for string
+#include <string_view>  // for string_view
+
+#include "amdinfer/core/compression.hpp"  // for Compression
 
 namespace amdinfer::util {
 
@@ -29,6 +34,56 @@ namespace amdinfer::util {
  */
 std::string zDecompress(const char *str, int len);
 
+/**
+ * @brief Compress data with zlib in the given format
+ *
+ * @param data the data to compress
+ * @param algorithm the format to compress to. If None, the data is copied.
+ * @return std::string the compressed data
+ */
+std::string compress(std::string_view data, Compression algorithm);
+
+/**
+ * @brief Decompress data in either the zlib or the gzip format. If the data
+ * isn't valid, an exception is thrown.
+ *
+ * @param data the compressed data
+ * @param max_size the most bytes that the data may decompress to
+ * @return std::string the decompressed data
+ */
+std::string decompress(std::string_view data,
+                       size_t max_size = std::numeric_limits<size_t>::max());
+
+/**
+ * @brief Get the name of an algorithm as used by the HTTP Content-Encoding and
+ * Accept-Encoding headers
+ *
+ * @param algorithm the algorithm
+ * @return const char*
+ */
+const char *getEncodingName(Compression algorithm);
+
+/**
+ * @brief Get the algorithm of a HTTP Content-Encoding header. If the encoding
+ * isn't supported, an exception is thrown.
+ *
+ * @param encoding value of the header
+ * @return Compression
+ */
+Compression parseContentEncoding(std::string_view encoding);
+
+/**
+ * @brief Pick the algorithm to compress a response with from the HTTP
+ * Accept-Encoding header of its request. The preferred algorithm is used if
+ * it's accepted and, if not, the other supported one is, if it's accepted.
+ *
+ * @param accept_encoding value of the header
+ * @param preferred the algorithm to use if it's accepted
+ * @return Compression None if no supported algorithm is accepted
+ */
+Compression negotiateEncoding(std::string_view accept_encoding,
+                              Compression preferred);
+
 }  // namespace amdinfer::util
 
 #endif  // GUARD_AMDINFER_HELPERS_COMPRESSION
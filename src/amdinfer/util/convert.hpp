@@ -0,0 +1,278 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines helper functions to convert arrays of elements between types,
+ * optionally scaling them
+ */
+
+#ifndef GUARD_AMDINFER_UTIL_CONVERT
+#define GUARD_AMDINFER_UTIL_CONVERT
+
+#include <cmath>        // for nearbyint
+#include <cstddef>      // for size_t
+#include <cstdint>      // for uint8_t, int8_t
+#include <cstring>      // for memcpy
+#include <limits>       // for numeric_limits
+#include <type_traits>  // for is_same_v, is_integral_v
+
+#include "amdinfer/core/data_types.hpp"  // for fp16, bf16
+#include "amdinfer/pre_post/simd.hpp"    // for AMDINFER_X86_SIMD, hasAvx2
+
+namespace amdinfer::util {
+
+/// Elements that are converted on the stack at a time before they're written
+constexpr size_t kConvertChunkSize = 1024;
+
+namespace detail {
+
+template <typename To, typename From>
+void convertScalar(const From* source, size_t count, To* dest) {
+  for (size_t i = 0; i < count; ++i) {
+    dest[i] = static_cast<To>(source[i]);
+  }
+}
+
+template <typename To, typename From>
+void convertScaledScalar(const From* source, size_t count, float scale,
+                         float offset, To* dest) {
+  for (size_t i = 0; i < count; ++i) {
+    auto value = static_cast<float>(source[i]) * scale + offset;
+    if constexpr (std::is_integral_v<To>) {
+      // NaNs saturate to the lowest value like the vector kernels
+      const auto lowest = static_cast<float>(std::numeric_limits<To>::min());
+      const auto highest = static_cast<float>(std::numeric_limits<To>::max());
+      value = value >= lowest ? value : lowest;
+      value = value <= highest ? value : highest;
+      dest[i] = static_cast<To>(std::nearbyint(value));
+    } else {
+      dest[i] = static_cast<To>(value);
+    }
+  }
+}
+
+#ifdef AMDINFER_X86_SIMD
+
+constexpr size_t kF16cWidth = 8;
+constexpr size_t kAvx2Width = 8;
+constexpr size_t kAvx512Width = 16;
+
+__attribute__((target("avx,f16c"))) inline void floatToHalfF16c(
+  const float* source, size_t count, fp16* dest) {
+  size_t i = 0;
+  for (; i + kF16cWidth <= count; i += kF16cWidth) {
+    const auto values = _mm256_cvtps_ph(_mm256_loadu_ps(source + i),
+                                        _MM_FROUND_TO_NEAREST_INT);
+    std::memcpy(static_cast<void*>(dest + i), &values, sizeof(values));
+  }
+  convertScalar(source + i, count - i, dest + i);
+}
+
+__attribute__((target("avx,f16c"))) inline void halfToFloatF16c(
+  const fp16* source, size_t count, float* dest) {
+  size_t i = 0;
+  for (; i + kF16cWidth <= count; i += kF16cWidth) {
+    __m128i values;
+    const auto* half = static_cast<const void*>(source + i);
+    std::memcpy(&values, half, sizeof(values));
+    _mm256_storeu_ps(dest + i, _mm256_cvtph_ps(values));
+  }
+  convertScalar(source + i, count - i, dest + i);
+}
+
+__attribute__((target("avx2,fma"))) inline __m256 scaleBytesAvx2(
+  const uint8_t* source, __m256 scale, __m256 offset) {
+  const auto* bytes = static_cast<const void*>(source);
+  const auto ints =
+    _mm256_cvtepu8_epi32(_mm_loadl_epi64(static_cast<const __m128i*>(bytes)));
+  return _mm256_fmadd_ps(_mm256_cvtepi32_ps(ints), scale, offset);
+}
+
+__attribute__((target("avx2,fma"))) inline void bytesToFloatAvx2(
+  const uint8_t* source, size_t count, float scale, float offset,
+  float* dest) {
+  const auto scales = _mm256_set1_ps(scale);
+  const auto offsets = _mm256_set1_ps(offset);
+  size_t i = 0;
+  for (; i + kAvx2Width <= count; i += kAvx2Width) {
+    _mm256_storeu_ps(dest + i, scaleBytesAvx2(source + i, scales, offsets));
+  }
+  convertScaledScalar(source + i, count - i, scale, offset, dest + i);
+}
+
+__attribute__((target("avx2,fma,f16c"))) inline void bytesToHalfAvx2(
+  const uint8_t* source, size_t count, float scale, float offset,
+  fp16* dest) {
+  const auto scales = _mm256_set1_ps(scale);
+  const auto offsets = _mm256_set1_ps(offset);
+  size_t i = 0;
+  for (; i + kAvx2Width <= count; i += kAvx2Width) {
+    const auto values =
+      _mm256_cvtps_ph(scaleBytesAvx2(source + i, scales, offsets),
+                      _MM_FROUND_TO_NEAREST_INT);
+    std::memcpy(static_cast<void*>(dest + i), &values, sizeof(values));
+  }
+  convertScaledScalar(source + i, count - i, scale, offset, dest + i);
+}
+
+// the floats are clamped before they're rounded since out of range values
+// convert to the lowest integer rather than saturating
+__attribute__((target("avx2,fma"))) inline __m256i quantizeAvx2(
+  const float* source, __m256 scale, __m256 offset) {
+  const auto lowest =
+    _mm256_set1_ps(static_cast<float>(std::numeric_limits<int8_t>::min()));
+  const auto highest =
+    _mm256_set1_ps(static_cast<float>(std::numeric_limits<int8_t>::max()));
+  auto scaled = _mm256_fmadd_ps(_mm256_loadu_ps(source), scale, offset);
+  scaled = _mm256_min_ps(_mm256_max_ps(scaled, lowest), highest);
+  return _mm256_cvtps_epi32(scaled);
+}
+
+__attribute__((target("avx2,fma"))) inline void floatToCharAvx2(
+  const float* source, size_t count, float scale, float offset, int8_t* dest) {
+  const auto scales = _mm256_set1_ps(scale);
+  const auto offsets = _mm256_set1_ps(offset);
+  size_t i = 0;
+  for (; i + 2 * kAvx2Width <= count; i += 2 * kAvx2Width) {
+    // packing works within 128-bit lanes so the shorts are put back in order
+    // before they're packed again
+    const auto low = quantizeAvx2(source + i, scales, offsets);
+    const auto high = quantizeAvx2(source + i + kAvx2Width, scales, offsets);
+    const auto shorts =
+      _mm256_permute4x64_epi64(_mm256_packs_epi32(low, high), 0xD8);
+    const auto chars = _mm_packs_epi16(_mm256_castsi256_si128(shorts),
+                                       _mm256_extracti128_si256(shorts, 1));
+    std::memcpy(dest + i, &chars, sizeof(chars));
+  }
+  convertScaledScalar(source + i, count - i, scale, offset, dest + i);
+}
+
+#ifdef AMDINFER_X86_AVX512_BF16
+// the instruction treats denormal floats as zero, unlike the scalar rounding,
+// but they're far below the precision of bf16 anyway
+__attribute__((target("avx512f,avx512bf16"))) inline void floatToBf16Avx512(
+  const float* source, size_t count, bf16* dest) {
+  size_t i = 0;
+  for (; i + kAvx512Width <= count; i += kAvx512Width) {
+    const auto values = _mm512_cvtneps_pbh(_mm512_loadu_ps(source + i));
+    std::memcpy(static_cast<void*>(dest + i), &values, sizeof(values));
+  }
+  convertScalar(source + i, count - i, dest + i);
+}
+#endif
+
+#endif  // AMDINFER_X86_SIMD
+
+}  // namespace detail
+
+/**
+ * @brief Copy an array of elements, converting each one to another type. The
+ * types are known at compile time so arrays of the same type are copied in one
+ * go and the loop for others can be vectorized by the compiler. Conversions
+ * from floats to fp16 and bf16 and from fp16 to floats use the F16C and
+ * AVX-512 BF16 instructions if the CPU supports them.
+ *
+ * @tparam To type to convert to
+ * @tparam From type to convert from
+ * @param source elements to convert
+ * @param count number of elements
+ * @param dest where to write the converted elements
+ */
+template <typename To, typename From>
+void convert(const From* source, size_t count, To* dest) {
+  if constexpr (std::is_same_v<To, From>) {
+    // empty arrays may be null, which memcpy doesn't allow
+    if (count > 0) {
+      std::memcpy(dest, source, count * sizeof(To));
+    }
+    return;
+  }
+#ifdef AMDINFER_X86_SIMD
+  if constexpr (std::is_same_v<From, float> && std::is_same_v<To, fp16>) {
+    static const bool has_f16c = pre_post::detail::hasF16c();
+    if (has_f16c) {
+      detail::floatToHalfF16c(source, count, dest);
+      return;
+    }
+  }
+  if constexpr (std::is_same_v<From, fp16> && std::is_same_v<To, float>) {
+    static const bool has_f16c = pre_post::detail::hasF16c();
+    if (has_f16c) {
+      detail::halfToFloatF16c(source, count, dest);
+      return;
+    }
+  }
+#ifdef AMDINFER_X86_AVX512_BF16
+  if constexpr (std::is_same_v<From, float> && std::is_same_v<To, bf16>) {
+    static const bool has_bf16 = pre_post::detail::hasAvx512Bf16();
+    if (has_bf16) {
+      detail::floatToBf16Avx512(source, count, dest);
+      return;
+    }
+  }
+#endif
+#endif
+  if constexpr (!std::is_same_v<To, From>) {
+    detail::convertScalar(source, count, dest);
+  }
+}
+
+/**
+ * @brief Copy an array of elements, converting each one to another type after
+ * scaling it as x * scale + offset. Integers are rounded to the nearest value
+ * and saturated. Conversions from 8-bit integers to floats and fp16 and from
+ * floats to 8-bit integers use AVX2 if the CPU supports it.
+ *
+ * @tparam To type to convert to
+ * @tparam From type to convert from
+ * @param source elements to convert
+ * @param count number of elements
+ * @param scale factor to multiply each element by
+ * @param offset value to add to each element after scaling it
+ * @param dest where to write the converted elements
+ */
+template <typename To, typename From>
+void convertScaled(const From* source, size_t count, float scale, float offset,
+                   To* dest) {
+#ifdef AMDINFER_X86_SIMD
+  if constexpr (std::is_same_v<From, uint8_t> && std::is_same_v<To, float>) {
+    static const bool has_avx2 = pre_post::detail::hasAvx2();
+    if (has_avx2) {
+      detail::bytesToFloatAvx2(source, count, scale, offset, dest);
+      return;
+    }
+  }
+  if constexpr (std::is_same_v<From, uint8_t> && std::is_same_v<To, fp16>) {
+    static const bool has_avx2 =
+      pre_post::detail::hasAvx2() && pre_post::detail::hasF16c();
+    if (has_avx2) {
+      detail::bytesToHalfAvx2(source, count, scale, offset, dest);
+      return;
+    }
+  }
+  if constexpr (std::is_same_v<From, float> && std::is_same_v<To, int8_t>) {
+    static const bool has_avx2 = pre_post::detail::hasAvx2();
+    if (has_avx2) {
+      detail::floatToCharAvx2(source, count, scale, offset, dest);
+      return;
+    }
+  }
+#endif
+  detail::convertScaledScalar(source, count, scale, offset, dest);
+}
+
+}  // namespace amdinfer::util
+
+#endif  // GUARD_AMDINFER_UTIL_CONVERT
@@ -19,7 +19,7 @@
 #include <algorithm>           // for max
 #include <ext/alloc_traits.h>  // for __alloc_traits<>::value_type
 
-#include "amdinfer/util/thread.hpp"  // for setThreadName
+#include "amdinfer/util/thread.hpp"  // for setThreadName, setThreadAffinity
 
 namespace amdinfer::util {
 
@@ -47,6 +47,13 @@ int ThreadPool::getIdle() const { return waiting_; }
 
 std::thread &ThreadPool::getThread(int i) { return *threads_[i]; }
 
+void ThreadPool::setAffinity(const std::vector<int> &cpus) {
+  cpus_ = cpus;
+  for (auto &thread : threads_) {
+    amdinfer::util::setThreadAffinity(*thread, cpus_);
+  }
+}
+
 // change the number of threads in the pool
 // should be called from one thread, otherwise be careful to not interleave,
 // also with this->stop() thread_num must be >= 0
@@ -178,6 +185,7 @@ void ThreadPool::setThread(int i) {
     }
   };
   threads_[i] = std::make_unique<std::thread>(f);
+  amdinfer::util::setThreadAffinity(*threads_[i], cpus_);
 }
 
 }  // namespace amdinfer::util
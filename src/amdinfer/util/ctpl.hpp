@@ -62,6 +62,10 @@ class ThreadPool {
   int getIdle() const;
   std::thread &getThread(int i);
 
+  // pin the pool's current and future threads to these CPUs. If empty, new
+  // threads are left unpinned
+  void setAffinity(const std::vector<int> &cpus);
+
   // change the number of threads in the pool
   // should be called from one thread, otherwise be careful to not interleave,
   // also with this->stop() nThreads must be >= 0
@@ -129,6 +133,7 @@ class ThreadPool {
   std::atomic<bool> done_ = false;
   std::atomic<bool> stop_ = false;
   std::atomic<int> waiting_ = 0;  // how many threads are waiting
+  std::vector<int> cpus_;         // CPUs to pin the threads to, if any
 
   std::mutex mutex_;
   std::condition_variable cv_;
@@ -0,0 +1,141 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines a fast non-cryptographic hash for large buffers
+ */
+
+#ifndef GUARD_AMDINFER_UTIL_HASH
+#define GUARD_AMDINFER_UTIL_HASH
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint64_t, uint32_t, uint8_t
+#include <cstring>  // for memcpy
+
+namespace amdinfer::util {
+
+namespace detail {
+
+constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t kPrime4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t kPrime5 = 0x27D4EB2F165667C5ULL;
+
+inline uint64_t rotl(uint64_t value, int bits) {
+  return (value << bits) | (value >> (64 - bits));
+}
+
+inline uint64_t read64(const uint8_t* data) {
+  uint64_t value = 0;
+  std::memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+inline uint32_t read32(const uint8_t* data) {
+  uint32_t value = 0;
+  std::memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+inline uint64_t round(uint64_t accumulator, uint64_t input) {
+  accumulator += input * kPrime2;
+  return rotl(accumulator, 31) * kPrime1;
+}
+
+inline uint64_t mergeRound(uint64_t accumulator, uint64_t value) {
+  accumulator ^= round(0, value);
+  return accumulator * kPrime1 + kPrime4;
+}
+
+}  // namespace detail
+
+/**
+ * @brief Hash data with XXH64. It reads 32 bytes per step in four independent
+ * lanes so it runs at close to memory bandwidth, which makes it suitable for
+ * hashing whole tensors. The result matches the reference implementation on
+ * little-endian machines.
+ *
+ * @param data pointer to the data
+ * @param size size of the data in bytes
+ * @param seed the seed. Chaining hashes through the seed hashes several
+ * buffers as one key
+ * @return uint64_t
+ */
+inline uint64_t xxh64(const void* data, size_t size, uint64_t seed = 0) {
+  using detail::kPrime1;
+  using detail::kPrime2;
+  using detail::kPrime3;
+  using detail::kPrime4;
+  using detail::kPrime5;
+  using detail::rotl;
+
+  const auto* position = static_cast<const uint8_t*>(data);
+  const auto* end = position + size;
+  uint64_t hash = 0;
+
+  constexpr auto kStripe = 32;
+  if (size >= kStripe) {
+    uint64_t lane1 = seed + kPrime1 + kPrime2;
+    uint64_t lane2 = seed + kPrime2;
+    uint64_t lane3 = seed;
+    uint64_t lane4 = seed - kPrime1;
+    const auto* limit = end - kStripe;
+    do {
+      lane1 = detail::round(lane1, detail::read64(position));
+      lane2 = detail::round(lane2, detail::read64(position + 8));
+      lane3 = detail::round(lane3, detail::read64(position + 16));
+      lane4 = detail::round(lane4, detail::read64(position + 24));
+      position += kStripe;
+    } while (position <= limit);
+
+    hash = rotl(lane1, 1) + rotl(lane2, 7) + rotl(lane3, 12) + rotl(lane4, 18);
+    hash = detail::mergeRound(hash, lane1);
+    hash = detail::mergeRound(hash, lane2);
+    hash = detail::mergeRound(hash, lane3);
+    hash = detail::mergeRound(hash, lane4);
+  } else {
+    hash = seed + kPrime5;
+  }
+
+  hash += static_cast<uint64_t>(size);
+
+  while (position + 8 <= end) {
+    hash ^= detail::round(0, detail::read64(position));
+    hash = rotl(hash, 27) * kPrime1 + kPrime4;
+    position += 8;
+  }
+  if (position + 4 <= end) {
+    hash ^= static_cast<uint64_t>(detail::read32(position)) * kPrime1;
+    hash = rotl(hash, 23) * kPrime2 + kPrime3;
+    position += 4;
+  }
+  while (position < end) {
+    hash ^= (*position) * kPrime5;
+    hash = rotl(hash, 11) * kPrime1;
+    position++;
+  }
+
+  hash ^= hash >> 33;
+  hash *= kPrime2;
+  hash ^= hash >> 29;
+  hash *= kPrime3;
+  hash ^= hash >> 32;
+  return hash;
+}
+
+}  // namespace amdinfer::util
+
+#endif  // GUARD_AMDINFER_UTIL_HASH
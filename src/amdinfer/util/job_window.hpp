@@ -0,0 +1,68 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines a window that bounds the jobs a worker has in progress
+ */
+
+#ifndef GUARD_AMDINFER_UTIL_JOB_WINDOW
+#define GUARD_AMDINFER_UTIL_JOB_WINDOW
+
+#include <condition_variable>  // for condition_variable
+#include <cstddef>             // for size_t
+#include <mutex>               // for mutex, unique_lock, lock_guard
+
+namespace amdinfer::util {
+
+/**
+ * @brief Counts jobs that are in progress, blocking new ones while there are
+ * as many in progress as the window allows. Jobs may finish in any order
+ */
+class JobWindow {
+ public:
+  explicit JobWindow(size_t size) : size_(size) {}
+
+  /// Wait for room in the window and add a job to it
+  void acquire() {
+    std::unique_lock lock{mutex_};
+    cv_.wait(lock, [this]() { return count_ < size_; });
+    ++count_;
+  }
+
+  /// Remove a finished job from the window
+  void release() {
+    {
+      std::lock_guard lock{mutex_};
+      --count_;
+    }
+    cv_.notify_all();
+  }
+
+  /// Wait until all the jobs in the window are finished
+  void drain() {
+    std::unique_lock lock{mutex_};
+    cv_.wait(lock, [this]() { return count_ == 0; });
+  }
+
+ private:
+  size_t size_;
+  size_t count_ = 0;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+};
+
+}  // namespace amdinfer::util
+
+#endif  // GUARD_AMDINFER_UTIL_JOB_WINDOW
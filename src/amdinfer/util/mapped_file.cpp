@@ -0,0 +1,87 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements a read-only memory mapping of a file
+ */
+
+#include "amdinfer/util/mapped_file.hpp"
+
+#include <fcntl.h>     // for open, O_CLOEXEC, O_RDONLY
+#include <sys/mman.h>  // for mmap, munmap, madvise, MAP_FAILED
+#include <sys/stat.h>  // for fstat, stat
+#include <unistd.h>    // for close
+
+#include <string>   // for operator+
+#include <utility>  // for exchange
+
+#include "amdinfer/core/exceptions.hpp"  // for file_read_error
+
+namespace amdinfer::util {
+
+MappedFile::MappedFile(const std::filesystem::path& path, bool sequential) {
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+  const int descriptor = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (descriptor < 0) {
+    throw file_read_error("Could not open " + path.string());
+  }
+
+  struct stat status {};
+  if (fstat(descriptor, &status) != 0) {
+    close(descriptor);
+    throw file_read_error("Could not get the size of " + path.string());
+  }
+  size_ = static_cast<size_t>(status.st_size);
+
+  // mmap doesn't map empty files
+  if (size_ > 0) {
+    void* mapping = mmap(nullptr, size_, PROT_READ, MAP_SHARED, descriptor, 0);
+    if (mapping == MAP_FAILED) {
+      close(descriptor);
+      throw file_read_error("Could not map " + path.string());
+    }
+    // the whole model is read as it's loaded so start reading it in now but
+    // files larger than memory are only read ahead of where they're used
+    madvise(mapping, size_, sequential ? MADV_SEQUENTIAL : MADV_WILLNEED);
+    data_ = static_cast<const char*>(mapping);
+  }
+  // the mapping keeps the file open
+  close(descriptor);
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+  : data_(std::exchange(other.data_, nullptr)),
+    size_(std::exchange(other.size_, 0)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+  if (this != &other) {
+    unmap();
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+  }
+  return *this;
+}
+
+MappedFile::~MappedFile() { unmap(); }
+
+void MappedFile::unmap() noexcept {
+  if (data_ != nullptr) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+    munmap(const_cast<char*>(data_), size_);
+    data_ = nullptr;
+  }
+}
+
+}  // namespace amdinfer::util
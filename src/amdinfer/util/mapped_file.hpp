@@ -0,0 +1,69 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines a read-only memory mapping of a file
+ */
+
+#ifndef GUARD_AMDINFER_UTIL_MAPPED_FILE
+#define GUARD_AMDINFER_UTIL_MAPPED_FILE
+
+#include <cstddef>     // for size_t
+#include <filesystem>  // for path
+
+namespace amdinfer::util {
+
+/**
+ * @brief Maps a file into memory read-only. The pages are shared with the page
+ * cache so every process and worker that maps the same model shares one copy
+ * of it, and it's read from disk as it's used rather than copied into a
+ * buffer first. The file shouldn't be modified while it's mapped; files in
+ * the model cache are replaced by renaming, which is safe.
+ */
+class MappedFile {
+ public:
+  /**
+   * @brief Map a file. It throws file_read_error if it can't be mapped
+   *
+   * @param path the file to map
+   * @param sequential the file is read once from start to end, such as a
+   * dataset, so it's read ahead as it's used instead of all at once
+   */
+  explicit MappedFile(const std::filesystem::path& path,
+                      bool sequential = false);
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  /// Move constructor
+  MappedFile(MappedFile&& other) noexcept;
+  /// Move assignment operator
+  MappedFile& operator=(MappedFile&& other) noexcept;
+  /// Destructor. The file is unmapped
+  ~MappedFile();
+
+  /// Get the contents of the file. Empty files have no data
+  [[nodiscard]] const char* data() const { return data_; }
+  /// Get the size of the file in bytes
+  [[nodiscard]] size_t size() const { return size_; }
+
+ private:
+  void unmap() noexcept;
+
+  const char* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+}  // namespace amdinfer::util
+
+#endif  // GUARD_AMDINFER_UTIL_MAPPED_FILE
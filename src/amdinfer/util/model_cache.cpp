@@ -0,0 +1,137 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements a cache for compiled models that's shared between workers
+ */
+
+#include "amdinfer/util/model_cache.hpp"
+
+#include <unistd.h>  // for getpid
+
+#include <array>         // for array
+#include <cstdint>       // for uint64_t
+#include <cstdio>        // for snprintf
+#include <cstdlib>       // for getenv
+#include <fstream>       // for ifstream
+#include <functional>    // for hash
+#include <string>        // for string, to_string
+#include <system_error>  // for error_code
+#include <thread>        // for this_thread
+
+#include "amdinfer/core/exceptions.hpp"  // for file_read_error
+
+namespace fs = std::filesystem;
+
+namespace amdinfer::util {
+
+std::string hashFile(const fs::path& path) {
+  std::ifstream file{path, std::ios::binary};
+  if (!file) {
+    throw file_read_error("Could not open " + path.string() + " to hash it");
+  }
+
+  // 64-bit FNV-1a
+  constexpr uint64_t kOffsetBasis = 0xcbf29ce484222325;
+  constexpr uint64_t kPrime = 0x100000001b3;
+  constexpr size_t kChunkSize = 1 << 20;
+
+  uint64_t hash = kOffsetBasis;
+  std::string chunk(kChunkSize, '\0');
+  while (file) {
+    file.read(chunk.data(), kChunkSize);
+    const auto count = static_cast<size_t>(file.gcount());
+    for (size_t i = 0; i < count; ++i) {
+      hash ^= static_cast<unsigned char>(chunk[i]);
+      hash *= kPrime;
+    }
+  }
+
+  std::array<char, sizeof(hash) * 2 + 1> hex{};
+  std::snprintf(hex.data(), hex.size(), "%016llx",
+                static_cast<unsigned long long>(hash));
+  return hex.data();
+}
+
+fs::path getModelCacheDirectory(const std::string& directory) {
+  if (!directory.empty()) {
+    return directory;
+  }
+  if (const auto* env = std::getenv(kModelCacheEnv); env != nullptr) {
+    return env;
+  }
+  if (const auto* home = std::getenv("HOME"); home != nullptr) {
+    return fs::path{home} / ".amdinfer" / "cache";
+  }
+  return {};
+}
+
+namespace {
+
+/// Replace characters that may not be safe in a file name
+std::string sanitize(std::string name) {
+  for (auto& c : name) {
+    const bool safe = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                      (c >= '0' && c <= '9') || c == '.' || c == '-';
+    if (!safe) {
+      c = '-';
+    }
+  }
+  return name;
+}
+
+}  // namespace
+
+fs::path getModelCachePath(const fs::path& directory,
+                           const ModelCacheKey& key) {
+  auto name = sanitize(key.model.stem().string()) + "_" + hashFile(key.model) +
+              "_" + sanitize(key.device) + "_" + sanitize(key.framework) +
+              "_b" + std::to_string(key.batch_size) + key.extension;
+  return directory / name;
+}
+
+bool storeInModelCache(const fs::path& path,
+                       const std::function<void(const fs::path&)>& write) {
+  std::error_code error;
+  fs::create_directories(path.parent_path(), error);
+  if (error) {
+    return false;
+  }
+
+  // the temporary file is unique to this thread so concurrent loads of the
+  // same model don't write to the same file. The last rename wins but all
+  // the writers produce the same file
+  const auto thread_id =
+    std::hash<std::thread::id>{}(std::this_thread::get_id());
+  auto temp_path = path;
+  temp_path += ".tmp." + std::to_string(getpid()) + "." +
+               std::to_string(thread_id);
+
+  try {
+    write(temp_path);
+  } catch (...) {
+    fs::remove(temp_path, error);
+    return false;
+  }
+
+  fs::rename(temp_path, path, error);
+  if (error) {
+    fs::remove(temp_path, error);
+    return false;
+  }
+  return true;
+}
+
+}  // namespace amdinfer::util
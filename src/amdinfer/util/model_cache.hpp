@@ -0,0 +1,93 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines a cache for compiled models that's shared between workers
+ */
+
+#ifndef GUARD_AMDINFER_UTIL_MODEL_CACHE
+#define GUARD_AMDINFER_UTIL_MODEL_CACHE
+
+#include <filesystem>  // for path
+#include <functional>  // for function
+#include <string>      // for string
+
+namespace amdinfer::util {
+
+/// Environment variable that sets the default model cache directory
+constexpr auto kModelCacheEnv = "AMDINFER_MODEL_CACHE";
+
+/// Describes everything that a compiled model depends on
+struct ModelCacheKey {
+  /// the source model that's compiled
+  std::filesystem::path model;
+  /// the device it's compiled for e.g. gpu-gfx90a
+  std::string device;
+  /// the framework and version that compiled it e.g. migraphx-2.5.0
+  std::string framework;
+  /// the batch size it's compiled for
+  int batch_size = 1;
+  /// the file extension of the compiled model e.g. .mxr
+  std::string extension;
+};
+
+/**
+ * @brief Hash the contents of a file
+ *
+ * @param path the file to hash
+ * @return std::string the hash as hex
+ */
+std::string hashFile(const std::filesystem::path& path);
+
+/**
+ * @brief Get the model cache directory. If no directory is given, it uses the
+ * directory from the AMDINFER_MODEL_CACHE environment variable or defaults to
+ * $HOME/.amdinfer/cache.
+ *
+ * @param directory a directory to use or empty to use the default
+ * @return std::filesystem::path the cache directory or empty if none is known
+ */
+std::filesystem::path getModelCacheDirectory(const std::string& directory = "");
+
+/**
+ * @brief Get the path in the cache for a compiled model. The file name holds a
+ * hash of the model's contents and the rest of the key so models are only
+ * reused when nothing they depend on has changed.
+ *
+ * @param directory the cache directory
+ * @param key the key describing the compiled model
+ * @return std::filesystem::path
+ */
+std::filesystem::path getModelCachePath(const std::filesystem::path& directory,
+                                        const ModelCacheKey& key);
+
+/**
+ * @brief Atomically add a file to the cache. The file is written to a
+ * temporary file in the cache directory that's renamed to its final path so
+ * readers never see a partially written file. Failing to write to the cache,
+ * e.g. because it's read-only, isn't an error so it's reported in the return
+ * value instead.
+ *
+ * @param path the path in the cache to write to
+ * @param write a function that writes the file at the path it's given
+ * @return bool true if the file was added to the cache
+ */
+bool storeInModelCache(
+  const std::filesystem::path& path,
+  const std::function<void(const std::filesystem::path&)>& write);
+
+}  // namespace amdinfer::util
+
+#endif  // GUARD_AMDINFER_UTIL_MODEL_CACHE
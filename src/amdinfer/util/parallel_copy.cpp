@@ -0,0 +1,134 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements copies of large buffers that are split across threads
+ */
+
+#include "amdinfer/util/parallel_copy.hpp"
+
+#include <algorithm>           // for min
+#include <condition_variable>  // for condition_variable
+#include <cstddef>             // for byte
+#include <cstdint>             // for uintptr_t
+#include <cstring>             // for memcpy
+#include <mutex>               // for mutex, lock_guard, unique_lock
+
+#ifdef __SSE2__
+#include <emmintrin.h>  // for _mm_stream_si128, _mm_loadu_si128, ...
+#endif
+
+namespace amdinfer::util {
+
+namespace {
+
+/// Chunks are a multiple of a cache line so threads don't share lines
+constexpr size_t kCacheLine = 64;
+
+void copyChunk(void* dest, const void* src, size_t size, bool streaming) {
+  if (streaming) {
+    copyStreaming(dest, src, size);
+  } else {
+    std::memcpy(dest, src, size);
+  }
+}
+
+}  // namespace
+
+void copyStreaming(void* dest, const void* src, size_t size) {
+#ifdef __SSE2__
+  constexpr size_t kVector = sizeof(__m128i);
+  constexpr size_t kUnroll = 4;
+  auto* out = static_cast<std::byte*>(dest);
+  const auto* in = static_cast<const std::byte*>(src);
+
+  // the stores need an aligned destination so the head is copied normally
+  const auto misaligned = reinterpret_cast<uintptr_t>(out) % kVector;
+  const auto head = std::min(misaligned == 0 ? 0 : kVector - misaligned, size);
+  std::memcpy(out, in, head);
+  out += head;
+  in += head;
+  size -= head;
+
+  // NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
+  for (; size >= kVector * kUnroll; size -= kVector * kUnroll) {
+    const auto* from = reinterpret_cast<const __m128i*>(in);
+    auto* to = reinterpret_cast<__m128i*>(out);
+    const auto a = _mm_loadu_si128(from);
+    const auto b = _mm_loadu_si128(from + 1);
+    const auto c = _mm_loadu_si128(from + 2);
+    const auto d = _mm_loadu_si128(from + 3);
+    _mm_stream_si128(to, a);
+    _mm_stream_si128(to + 1, b);
+    _mm_stream_si128(to + 2, c);
+    _mm_stream_si128(to + 3, d);
+    out += kVector * kUnroll;
+    in += kVector * kUnroll;
+  }
+  // NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
+  std::memcpy(out, in, size);
+  // the stores are weakly ordered so they're fenced before the data is used
+  _mm_sfence();
+#else
+  std::memcpy(dest, src, size);
+#endif
+}
+
+ParallelCopier::ParallelCopier(size_t threads, size_t parallel_bytes,
+                               size_t streaming_bytes)
+  : parallel_bytes_(parallel_bytes),
+    streaming_bytes_(streaming_bytes),
+    pool_(threads) {}
+
+void ParallelCopier::setAffinity(const std::vector<int>& cpus) {
+  pool_.setAffinity(cpus);
+}
+
+void ParallelCopier::copy(void* dest, const void* src, size_t size) {
+  const auto streaming = size >= streaming_bytes_;
+  const auto threads = pool_.getSize();
+  if (threads == 0 || size < parallel_bytes_) {
+    copyChunk(dest, src, size, streaming);
+    return;
+  }
+
+  // the calling thread takes the last chunk, which may be shorter
+  const auto chunks = threads + 1;
+  auto chunk = (size + chunks - 1) / chunks;
+  chunk = (chunk + kCacheLine - 1) / kCacheLine * kCacheLine;
+  auto* out = static_cast<std::byte*>(dest);
+  const auto* in = static_cast<const std::byte*>(src);
+
+  const auto helpers = (size - 1) / chunk;
+  std::mutex mutex;
+  std::condition_variable done;
+  size_t pending = helpers;
+  for (auto i = 0U; i < helpers; ++i) {
+    pool_.submit([&, offset = i * chunk]() {
+      copyChunk(out + offset, in + offset, chunk, streaming);
+      std::lock_guard lock{mutex};
+      if (--pending == 0) {
+        done.notify_one();
+      }
+    });
+  }
+  const auto offset = helpers * chunk;
+  copyChunk(out + offset, in + offset, size - offset, streaming);
+
+  std::unique_lock lock{mutex};
+  done.wait(lock, [&pending]() { return pending == 0; });
+}
+
+}  // namespace amdinfer::util
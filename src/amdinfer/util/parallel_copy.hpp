@@ -0,0 +1,93 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines copies of large buffers that are split across threads
+ */
+
+#ifndef GUARD_AMDINFER_UTIL_PARALLEL_COPY
+#define GUARD_AMDINFER_UTIL_PARALLEL_COPY
+
+#include <cstddef>  // for size_t
+#include <vector>   // for vector
+
+#include "amdinfer/util/work_stealing_pool.hpp"  // for WorkStealingPool
+
+namespace amdinfer::util {
+
+/// Bytes of a copy at which it's split across threads by default
+constexpr size_t kDefaultParallelCopyBytes = 1024ULL * 1024;
+/// Bytes of a copy at which it bypasses the cache by default
+constexpr size_t kDefaultStreamingCopyBytes = 32ULL * 1024 * 1024;
+
+/**
+ * @brief Copy bytes with non-temporal stores, which write to memory without
+ * reading the destination into the cache first. A copy that's larger than the
+ * cache then doesn't evict everything else from it. Without SSE2, it's a
+ * memcpy.
+ *
+ * @param dest address to copy to
+ * @param src address to copy from
+ * @param size bytes to copy
+ */
+void copyStreaming(void* dest, const void* src, size_t size);
+
+/**
+ * @brief The ParallelCopier splits large copies into one chunk per thread so
+ * a copy isn't limited by the memory bandwidth that one core can use. The
+ * calling thread copies a chunk too and waits for the others. Copies below
+ * the threshold, or all of them if there are no helper threads, are done by
+ * the calling thread alone. Copies at the streaming threshold use
+ * non-temporal stores.
+ */
+class ParallelCopier {
+ public:
+  /**
+   * @brief Construct a new ParallelCopier object
+   *
+   * @param threads the helper threads to start
+   * @param parallel_bytes bytes of a copy at which it's split across threads
+   * @param streaming_bytes bytes of a copy at which it bypasses the cache
+   */
+  explicit ParallelCopier(size_t threads,
+                          size_t parallel_bytes = kDefaultParallelCopyBytes,
+                          size_t streaming_bytes = kDefaultStreamingCopyBytes);
+
+  /**
+   * @brief Pin the helper threads to CPUs, such as the ones of the thread
+   * that copies, so the copies stay on its NUMA node
+   *
+   * @param cpus the CPUs to pin to
+   */
+  void setAffinity(const std::vector<int>& cpus);
+
+  /**
+   * @brief Copy bytes between buffers in host memory that don't overlap
+   *
+   * @param dest address to copy to
+   * @param src address to copy from
+   * @param size bytes to copy
+   */
+  void copy(void* dest, const void* src, size_t size);
+
+ private:
+  size_t parallel_bytes_;
+  size_t streaming_bytes_;
+  WorkStealingPool pool_;
+};
+
+}  // namespace amdinfer::util
+
+#endif  // GUARD_AMDINFER_UTIL_PARALLEL_COPY
@@ -0,0 +1,288 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines a bounded queue and a pipeline of stages that run on their
+ * own threads and pass items to each other through these queues
+ */
+
+#ifndef GUARD_AMDINFER_UTIL_PIPELINE
+#define GUARD_AMDINFER_UTIL_PIPELINE
+
+#include <algorithm>           // for max
+#include <atomic>              // for atomic_bool, atomic_size_t
+#include <condition_variable>  // for condition_variable
+#include <cstddef>             // for size_t
+#include <exception>           // for exception_ptr, current_exception
+#include <functional>          // for function
+#include <map>                 // for map
+#include <memory>              // for make_shared
+#include <mutex>               // for mutex, lock_guard, unique_lock
+#include <optional>            // for optional, nullopt
+#include <queue>               // for queue
+#include <string>              // for string
+#include <thread>              // for thread
+#include <utility>             // for move
+#include <vector>              // for vector
+
+#include "amdinfer/util/thread.hpp"  // for setThreadName
+
+namespace amdinfer::util {
+
+/**
+ * @brief A blocking queue with a fixed capacity. Producers block while it's
+ * full so a fast stage can't run arbitrarily far ahead of a slow one. Once it's
+ * closed, new items are rejected and consumers drain what's left.
+ *
+ * @tparam T type of the items
+ */
+template <typename T>
+class BoundedQueue {
+ public:
+  /// Construct a new BoundedQueue that holds up to capacity items
+  explicit BoundedQueue(size_t capacity)
+    : capacity_(std::max<size_t>(capacity, 1)) {}
+
+  /**
+   * @brief Add an item, blocking while the queue is full
+   *
+   * @param item item to add
+   * @return bool false if the queue is closed and the item was dropped
+   */
+  bool push(T item) {
+    std::unique_lock lock{mutex_};
+    not_full_.wait(lock,
+                   [this] { return closed_ || items_.size() < capacity_; });
+    if (closed_) {
+      return false;
+    }
+    items_.push(std::move(item));
+    lock.unlock();
+    not_empty_.notify_one();
+    return true;
+  }
+
+  /**
+   * @brief Take an item, blocking while the queue is empty
+   *
+   * @return std::optional<T> the item or nullopt if the queue is closed and
+   * empty
+   */
+  std::optional<T> pop() {
+    std::unique_lock lock{mutex_};
+    not_empty_.wait(lock, [this] { return closed_ || !items_.empty(); });
+    if (items_.empty()) {
+      return std::nullopt;
+    }
+    std::optional<T> item{std::move(items_.front())};
+    items_.pop();
+    lock.unlock();
+    not_full_.notify_one();
+    return item;
+  }
+
+  /// Stop accepting items and wake up any blocked producers and consumers
+  void close() {
+    {
+      std::lock_guard lock{mutex_};
+      closed_ = true;
+    }
+    not_full_.notify_all();
+    not_empty_.notify_all();
+  }
+
+ private:
+  size_t capacity_;
+  std::mutex mutex_;
+  std::condition_variable not_full_;
+  std::condition_variable not_empty_;
+  std::queue<T> items_;
+  bool closed_ = false;
+};
+
+/**
+ * @brief Runs the stages of a pipeline on their own threads. Each stage takes
+ * items from one BoundedQueue and pushes its results to the next. When a
+ * stage's input is closed and drained, it closes its output so the end of the
+ * input flows through the whole pipeline. If any stage throws, the pipeline
+ * stops: every queue is closed and the error is rethrown by join().
+ *
+ * The queues must outlive the pipeline's threads so join() should be called
+ * before they're destroyed. If the pipeline is destroyed first, it's stopped
+ * so threads blocked on the queues can exit.
+ */
+class Pipeline {
+ public:
+  Pipeline() = default;                            ///< Constructor
+  Pipeline(const Pipeline&) = delete;              ///< Copy constructor
+  Pipeline& operator=(const Pipeline&) = delete;   ///< Copy assignment
+  Pipeline(Pipeline&& other) = delete;             ///< Move constructor
+  Pipeline& operator=(Pipeline&& other) = delete;  ///< Move assignment
+  /// Stop the pipeline and wait for its threads without rethrowing errors
+  ~Pipeline() {
+    this->stop();
+    for (auto& thread : threads_) {
+      if (thread.joinable()) {
+        thread.join();
+      }
+    }
+  }
+
+  /**
+   * @brief Start the first stage of the pipeline. One thread calls generate
+   * and pushes its results to the output until it returns nullopt.
+   *
+   * @param name name of the stage's thread
+   * @param output queue to push the generated items to
+   * @param generate function returning the next item or nullopt at the end
+   */
+  template <typename Out, typename F>
+  void addSource(const std::string& name, BoundedQueue<Out>* output,
+                 F generate) {
+    this->addQueue(output);
+    threads_.emplace_back([this, name, output, generate]() mutable {
+      setThreadName(name);
+      try {
+        while (!stopped_) {
+          auto item = generate();
+          if (!item.has_value() || !output->push(std::move(*item))) {
+            break;
+          }
+        }
+      } catch (...) {
+        this->fail(std::current_exception());
+      }
+      output->close();
+    });
+  }
+
+  /**
+   * @brief Start a stage of the pipeline. Its threads take items from the
+   * input, process them and push the results to the output. Since the threads
+   * run in parallel, items may leave a stage in a different order than they
+   * entered it.
+   *
+   * @param name name of the stage's threads
+   * @param threads number of threads to run the stage with
+   * @param input queue to take items from
+   * @param output queue to push the processed items to
+   * @param process function that turns an input item into an output item
+   */
+  template <typename In, typename Out, typename F>
+  void addStage(const std::string& name, size_t threads,
+                BoundedQueue<In>* input, BoundedQueue<Out>* output,
+                F process) {
+    this->addQueue(input);
+    this->addQueue(output);
+    threads = std::max<size_t>(threads, 1);
+    // the last of the stage's threads to finish ends the stage
+    auto remaining = std::make_shared<std::atomic_size_t>(threads);
+    for (auto i = 0U; i < threads; ++i) {
+      threads_.emplace_back([this, name, input, output, process, remaining]() {
+        setThreadName(name);
+        try {
+          while (!stopped_) {
+            auto item = input->pop();
+            if (!item.has_value() ||
+                !output->push(process(std::move(*item)))) {
+              break;
+            }
+          }
+        } catch (...) {
+          this->fail(std::current_exception());
+        }
+        if (--(*remaining) == 0) {
+          output->close();
+        }
+      });
+    }
+  }
+
+  /// Wait for all the stages to finish and rethrow the first error, if any
+  void join() {
+    for (auto& thread : threads_) {
+      if (thread.joinable()) {
+        thread.join();
+      }
+    }
+    threads_.clear();
+    if (error_ != nullptr) {
+      std::rethrow_exception(error_);
+    }
+  }
+
+  /// Close all the queues so the stages stop without finishing their input
+  void stop() {
+    std::lock_guard lock{mutex_};
+    this->closeAll();
+  }
+
+ private:
+  template <typename T>
+  void addQueue(BoundedQueue<T>* queue) {
+    std::lock_guard lock{mutex_};
+    closers_.emplace_back([queue]() { queue->close(); });
+  }
+
+  void fail(std::exception_ptr error) {
+    std::lock_guard lock{mutex_};
+    if (error_ == nullptr) {
+      error_ = std::move(error);
+    }
+    this->closeAll();
+  }
+
+  // requires holding the mutex
+  void closeAll() {
+    stopped_ = true;
+    for (const auto& close : closers_) {
+      close();
+    }
+  }
+
+  std::vector<std::thread> threads_;
+  std::mutex mutex_;
+  std::vector<std::function<void()>> closers_;
+  std::exception_ptr error_;
+  std::atomic_bool stopped_ = false;
+};
+
+/**
+ * @brief Pop items from a queue until it's closed and drained and pass them to
+ * consume in order. Since the stages of a pipeline may reorder items, items
+ * that arrive early are held until all the ones before them have been consumed.
+ *
+ * @param queue queue to pop from
+ * @param index function returning an item's position, counting from zero
+ * @param consume function to call with each item in order
+ */
+template <typename T, typename Index, typename Consume>
+void popInOrder(BoundedQueue<T>* queue, Index index, Consume consume) {
+  std::map<size_t, T> pending;
+  size_t next = 0;
+  while (auto item = queue->pop()) {
+    const auto position = index(*item);
+    pending.emplace(position, std::move(*item));
+    for (auto it = pending.find(next); it != pending.end();
+         it = pending.find(++next)) {
+      consume(std::move(it->second));
+      pending.erase(it);
+    }
+  }
+}
+
+}  // namespace amdinfer::util
+
+#endif  // GUARD_AMDINFER_UTIL_PIPELINE
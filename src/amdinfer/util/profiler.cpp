@@ -0,0 +1,257 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements a sampling CPU profiler for the running server
+ */
+
+#include "amdinfer/util/profiler.hpp"
+
+#include <cxxabi.h>     // for __cxa_demangle
+#include <dlfcn.h>      // for dladdr, Dl_info
+#include <execinfo.h>   // for backtrace
+#include <sys/prctl.h>  // for prctl, PR_GET_NAME
+#include <sys/time.h>   // for setitimer, itimerval, ITIMER_PROF
+
+#include <algorithm>      // for min
+#include <array>          // for array
+#include <atomic>         // for atomic
+#include <cerrno>         // for errno
+#include <csignal>        // for sigaction, SIGPROF
+#include <cstdint>        // for uintptr_t
+#include <cstdlib>        // for free
+#include <cstring>        // for strerror
+#include <map>            // for map
+#include <memory>         // for unique_ptr
+#include <mutex>          // for mutex, lock_guard
+#include <sstream>        // for ostringstream
+#include <string>         // for string, to_string
+#include <thread>         // for yield
+#include <unordered_map>  // for unordered_map
+#include <utility>        // for move
+#include <vector>         // for vector
+
+#include "amdinfer/core/exceptions.hpp"  // for invalid_argument, runtime_error
+
+namespace amdinfer::util {
+
+namespace {
+
+constexpr auto kMaxFrames = 64;
+// the signal handler and the signal trampoline
+constexpr auto kSkippedFrames = 2;
+// threads' names are at most 16 bytes including the null terminator
+constexpr auto kThreadNameSize = 16;
+constexpr auto kMaxFrequency = 1000;
+constexpr auto kMicroseconds = 1'000'000;
+
+struct Sample {
+  std::array<char, kThreadNameSize> thread;
+  int depth;
+  std::array<void*, kMaxFrames> frames;
+};
+
+struct Profile {
+  explicit Profile(size_t max_samples) : samples(max_samples) {}
+
+  std::vector<Sample> samples;
+  std::atomic<size_t> next = 0;
+};
+
+// the handler only touches these atomics and the preallocated samples so it's
+// safe to run at any point in any thread
+std::atomic<Profile*> active_profile = nullptr;
+std::atomic<int> active_handlers = 0;
+
+struct ProfilerState {
+  std::mutex mutex;
+  std::unique_ptr<Profile> profile;
+  struct sigaction previous {};
+};
+
+ProfilerState& getState() {
+  static ProfilerState state;
+  return state;
+}
+
+void handleSample(int signal, siginfo_t* info, void* context) {
+  (void)signal;
+  (void)info;
+  (void)context;
+  const auto saved_errno = errno;
+  // counting the handler before loading the profile lets stop() wait for any
+  // handler that might still use it
+  active_handlers.fetch_add(1);
+  auto* profile = active_profile.load();
+  if (profile != nullptr) {
+    const auto index = profile->next.fetch_add(1, std::memory_order_relaxed);
+    if (index < profile->samples.size()) {
+      auto& sample = profile->samples[index];
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg, hicpp-vararg)
+      prctl(PR_GET_NAME, sample.thread.data());
+      sample.depth = backtrace(sample.frames.data(), kMaxFrames);
+    }
+  }
+  active_handlers.fetch_sub(1);
+  errno = saved_errno;
+}
+
+void setTimer(int frequency) {
+  itimerval timer{};
+  timer.it_interval.tv_usec = frequency == 0 ? 0 : kMicroseconds / frequency;
+  timer.it_value = timer.it_interval;
+  if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+    throw runtime_error(std::string{"Could not set the profiling timer: "} +
+                        std::strerror(errno));
+  }
+}
+
+/// Name a frame by its symbol or, failing that, by its offset in its binary
+std::string symbolize(void* address) {
+  Dl_info info{};
+  if (dladdr(address, &info) == 0) {
+    std::ostringstream name;
+    name << address;
+    return name.str();
+  }
+  if (info.dli_sname != nullptr) {
+    int status = 0;
+    char* demangled =
+      abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+    if (status == 0 && demangled != nullptr) {
+      std::string name{demangled};
+      std::free(demangled);  // NOLINT(cppcoreguidelines-no-malloc)
+      return name;
+    }
+    return info.dli_sname;
+  }
+
+  std::string binary = info.dli_fname != nullptr ? info.dli_fname : "";
+  binary = binary.substr(binary.find_last_of('/') + 1);
+  std::ostringstream name;
+  name << binary << "+0x" << std::hex
+       << (reinterpret_cast<uintptr_t>(address) -
+           reinterpret_cast<uintptr_t>(info.dli_fbase));
+  return name.str();
+}
+
+}  // namespace
+
+void CpuProfiler::start(int frequency, size_t max_samples) {
+  if (frequency <= 0 || frequency > kMaxFrequency) {
+    throw invalid_argument("The profiling frequency must be between 1 and " +
+                           std::to_string(kMaxFrequency));
+  }
+
+  auto& state = getState();
+  const std::lock_guard lock{state.mutex};
+  if (state.profile != nullptr) {
+    throw runtime_error("A profile is already running");
+  }
+
+  // the first call of backtrace may allocate as it loads the unwinder so it's
+  // done here rather than in the handler
+  std::array<void*, 1> frames{};
+  backtrace(frames.data(), frames.size());
+
+  state.profile = std::make_unique<Profile>(max_samples);
+  active_profile.store(state.profile.get());
+
+  struct sigaction action {};
+  action.sa_sigaction = handleSample;
+  action.sa_flags = SA_RESTART | SA_SIGINFO;
+  sigemptyset(&action.sa_mask);
+  try {
+    if (sigaction(SIGPROF, &action, &state.previous) != 0) {
+      throw runtime_error(std::string{"Could not handle SIGPROF: "} +
+                          std::strerror(errno));
+    }
+    setTimer(frequency);
+  } catch (...) {
+    active_profile.store(nullptr);
+    state.profile.reset();
+    throw;
+  }
+}
+
+std::string CpuProfiler::stop() {
+  auto& state = getState();
+  std::unique_ptr<Profile> profile;
+  {
+    const std::lock_guard lock{state.mutex};
+    if (state.profile == nullptr) {
+      throw runtime_error("No profile is running");
+    }
+    setTimer(0);
+    active_profile.store(nullptr);
+    while (active_handlers.load() != 0) {
+      std::this_thread::yield();
+    }
+    // a signal that's already pending could still arrive so it's ignored
+    // rather than left to its default action, which ends the process
+    auto previous = state.previous;
+    if ((previous.sa_flags & SA_SIGINFO) == 0 &&
+        previous.sa_handler == SIG_DFL) {
+      previous.sa_handler = SIG_IGN;
+    }
+    sigaction(SIGPROF, &previous, nullptr);
+    profile = std::move(state.profile);
+  }
+
+  const auto taken = profile->next.load();
+  const auto kept = std::min(taken, profile->samples.size());
+
+  std::unordered_map<void*, std::string> names;
+  std::map<std::string, size_t> stacks;
+  for (auto i = 0U; i < kept; ++i) {
+    const auto& sample = profile->samples[i];
+    std::string stack{sample.thread.data()};
+    if (stack.empty()) {
+      stack = "[unnamed]";
+    }
+    for (auto j = sample.depth - 1; j >= kSkippedFrames; --j) {
+      auto* address = sample.frames.at(j);
+      auto found = names.find(address);
+      if (found == names.end()) {
+        // return addresses point after the call so step back into it to find
+        // the caller's symbol. The innermost frame is where it was interrupted
+        auto* lookup = j == kSkippedFrames
+                         ? address
+                         : static_cast<void*>(static_cast<char*>(address) - 1);
+        found = names.try_emplace(address, symbolize(lookup)).first;
+      }
+      stack += ';';
+      stack += found->second;
+    }
+    stacks[stack]++;
+  }
+
+  std::ostringstream folded;
+  for (const auto& [stack, count] : stacks) {
+    folded << stack << ' ' << count << '\n';
+  }
+  if (taken > kept) {
+    folded << "[dropped] " << taken - kept << '\n';
+  }
+  return folded.str();
+}
+
+bool CpuProfiler::running() {
+  auto& state = getState();
+  const std::lock_guard lock{state.mutex};
+  return state.profile != nullptr;
+}
+
+}  // namespace amdinfer::util
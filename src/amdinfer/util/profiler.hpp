@@ -0,0 +1,78 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines a sampling CPU profiler for the running server
+ */
+
+#ifndef GUARD_AMDINFER_UTIL_PROFILER
+#define GUARD_AMDINFER_UTIL_PROFILER
+
+#include <cstddef>  // for size_t
+#include <string>   // for string
+
+namespace amdinfer::util {
+
+/// Number of samples per second of CPU time taken by default
+constexpr auto kDefaultProfileFrequency = 100;
+/// Number of samples kept by default. Later samples are counted as dropped
+constexpr size_t kDefaultProfileSamples = 16384;
+/// Seconds that the debugging endpoints profile for by default
+constexpr auto kDefaultProfileSeconds = 10;
+/// Most seconds that the debugging endpoints may profile for
+constexpr auto kMaxProfileSeconds = 60;
+
+/**
+ * @brief The CpuProfiler samples the stacks of the threads that are using the
+ * CPU. A profiling timer interrupts whichever thread is running as the process
+ * uses CPU time so busy threads are sampled in proportion to their use and
+ * idle threads aren't sampled at all. Each sample is labelled with the name
+ * of its thread, as set by setThreadName(). The timer can't fire more often
+ * than the kernel's tick so higher frequencies are capped by it.
+ *
+ * Only one profile can run in a process at a time. It takes over SIGPROF while
+ * it runs so it can't be used with other profilers that need the signal.
+ */
+class CpuProfiler {
+ public:
+  /**
+   * @brief Start sampling. It throws if a profile is already running or the
+   * timer can't be set
+   *
+   * @param frequency samples per second of CPU time
+   * @param max_samples maximum number of samples to keep
+   */
+  static void start(int frequency = kDefaultProfileFrequency,
+                    size_t max_samples = kDefaultProfileSamples);
+
+  /**
+   * @brief Stop sampling and get the profile in the folded stack format. Each
+   * line is a unique stack with the thread's name and its frames, from the
+   * outermost, separated by semicolons followed by the number of samples of
+   * it. Frames that can't be named are given as the offset in their binary
+   * for addr2line. It's the format that flamegraph.pl reads and that pprof
+   * and speedscope can import. It throws if no profile is running.
+   *
+   * @return std::string
+   */
+  static std::string stop();
+
+  /// Check if a profile is running
+  [[nodiscard]] static bool running();
+};
+
+}  // namespace amdinfer::util
+
+#endif  // GUARD_AMDINFER_UTIL_PROFILER
@@ -16,12 +16,21 @@
 #ifndef GUARD_AMDINFER_HELPERS_THREAD
 #define GUARD_AMDINFER_HELPERS_THREAD
 
-#include <string>
+#include <algorithm>  // for max
+#include <cstddef>    // for size_t, ptrdiff_t
+#include <fstream>    // for ifstream
+#include <string>     // for string, stoi, getline
+#include <thread>     // for thread
+#include <vector>     // for vector
 
 #ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
 #include <sys/prctl.h>
 #endif
 
+#include "amdinfer/core/exceptions.hpp"  // for invalid_argument
+
 namespace amdinfer::util {
 /**
  * @brief Attempt to set the calling thread's name. Note, this may or may not
@@ -43,6 +52,203 @@ inline void setThreadName(const std::string& name) {
   util::setThreadName(name.c_str());
 }
 
+/**
+ * @brief Parse a CPU list in the kernel's cpulist format (e.g. "0-3,8,10-11")
+ * into the individual CPU indices it names. An empty list returns no CPUs.
+ *
+ * @param list CPU list to parse
+ * @return std::vector<int>
+ */
+inline std::vector<int> parseCpuList(const std::string& list) {
+  std::vector<int> cpus;
+  size_t start = 0;
+  while (start < list.size()) {
+    auto end = list.find(',', start);
+    if (end == std::string::npos) {
+      end = list.size();
+    }
+    const auto range = list.substr(start, end - start);
+    start = end + 1;
+    if (range.empty()) {
+      continue;
+    }
+    try {
+      size_t parsed = 0;
+      const auto first = std::stoi(range, &parsed);
+      auto last = first;
+      if (parsed < range.size() && range[parsed] == '-') {
+        last = std::stoi(range.substr(parsed + 1));
+      }
+      if (first < 0 || last < first) {
+        throw invalid_argument("Invalid CPU range: " + range);
+      }
+      for (auto cpu = first; cpu <= last; ++cpu) {
+        cpus.push_back(cpu);
+      }
+    } catch (const std::logic_error&) {
+      throw invalid_argument("Invalid CPU list: " + list);
+    }
+  }
+  return cpus;
+}
+
+/**
+ * @brief Get the CPUs that belong to a NUMA node, as reported by sysfs
+ *
+ * @param node index of the NUMA node
+ * @return std::vector<int>
+ */
+inline std::vector<int> getNumaNodeCpus(int node) {
+  const auto path =
+    "/sys/devices/system/node/node" + std::to_string(node) + "/cpulist";
+  std::ifstream file(path);
+  std::string list;
+  if (!file || !std::getline(file, list)) {
+    throw invalid_argument("NUMA node " + std::to_string(node) +
+                           " does not exist");
+  }
+  return parseCpuList(list);
+}
+
+/**
+ * @brief Get the CPUs a thread should be pinned to given a CPU list and/or a
+ * NUMA node. If both are given, the CPU list is used. If neither is given,
+ * no CPUs are returned and the thread should be left unpinned.
+ *
+ * @param cpus CPU list to use. May be empty
+ * @param numa_node NUMA node to use. Ignored if negative
+ * @return std::vector<int>
+ */
+inline std::vector<int> getCpuAffinity(const std::string& cpus,
+                                       int numa_node) {
+  if (!cpus.empty()) {
+    return parseCpuList(cpus);
+  }
+  if (numa_node >= 0) {
+    return getNumaNodeCpus(numa_node);
+  }
+  return {};
+}
+
+/**
+ * @brief Get the number of CPUs the calling thread may run on. This respects
+ * any affinity set on the process e.g. by taskset or with setThreadAffinity
+ *
+ * @return int
+ */
+inline int getAvailableCpus() {
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+    return CPU_COUNT(&set);
+  }
+#endif
+  return std::max(1U, std::thread::hardware_concurrency());
+}
+
+/**
+ * @brief Get the CPUs the calling thread may run on. Unlike getAvailableCpus,
+ * this returns the individual CPUs rather than their count.
+ *
+ * @return std::vector<int>
+ */
+inline std::vector<int> getAllowedCpus() {
+  std::vector<int> cpus;
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+    for (auto cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &set)) {
+        cpus.push_back(cpu);
+      }
+    }
+    return cpus;
+  }
+#endif
+  const auto count = std::max(1U, std::thread::hardware_concurrency());
+  for (auto cpu = 0U; cpu < count; ++cpu) {
+    cpus.push_back(static_cast<int>(cpu));
+  }
+  return cpus;
+}
+
+/**
+ * @brief Split a set of CPUs into contiguous groups of nearly equal sizes in
+ * the given order. The earlier groups get the extra CPUs if they don't divide
+ * evenly.
+ *
+ * @param cpus CPUs to split
+ * @param groups number of groups to make
+ * @return std::vector<std::vector<int>>
+ */
+inline std::vector<std::vector<int>> splitCpus(const std::vector<int>& cpus,
+                                               size_t groups) {
+  if (groups == 0 || groups > cpus.size()) {
+    throw invalid_argument("Cannot split " + std::to_string(cpus.size()) +
+                           " CPUs into " + std::to_string(groups) + " groups");
+  }
+  std::vector<std::vector<int>> split(groups);
+  const auto size = cpus.size() / groups;
+  const auto extra = cpus.size() % groups;
+  auto it = cpus.begin();
+  for (auto i = 0U; i < groups; ++i) {
+    const auto count = static_cast<std::ptrdiff_t>(size + (i < extra ? 1 : 0));
+    split[i].assign(it, it + count);
+    it += count;
+  }
+  return split;
+}
+
+#ifdef __linux__
+/**
+ * @brief Attempt to pin a thread to a set of CPUs. Like setThreadName, this
+ * silently fails if pinning isn't possible. Threads that a pinned thread
+ * starts inherit its affinity and memory it first touches is placed on its
+ * NUMA node.
+ *
+ * @param thread native handle of the thread to pin
+ * @param cpus CPUs to pin to. If empty, the thread is left unchanged
+ * @return bool whether the thread's affinity was changed
+ */
+inline bool setThreadAffinity(pthread_t thread, const std::vector<int>& cpus) {
+  if (cpus.empty()) {
+    return false;
+  }
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (const auto& cpu : cpus) {
+    if (cpu < CPU_SETSIZE) {
+      CPU_SET(cpu, &set);
+    }
+  }
+  return pthread_setaffinity_np(thread, sizeof(set), &set) == 0;
+}
+#endif
+
+/// Attempt to pin the calling thread to a set of CPUs
+inline bool setThreadAffinity(const std::vector<int>& cpus) {
+#ifdef __linux__
+  return util::setThreadAffinity(pthread_self(), cpus);
+#else
+  (void)cpus;
+  return false;
+#endif
+}
+
+/// std::thread overload for setThreadAffinity
+inline bool setThreadAffinity(std::thread& thread,
+                              const std::vector<int>& cpus) {
+#ifdef __linux__
+  return util::setThreadAffinity(thread.native_handle(), cpus);
+#else
+  (void)thread;
+  (void)cpus;
+  return false;
+#endif
+}
+
 }  // namespace amdinfer::util
 
 #endif  // GUARD_AMDINFER_HELPERS_THREAD
@@ -14,40 +14,60 @@
 
 /**
  * @file
- * @brief Implements a helper timer class
+ * @brief Implements the calibration of the server's clock
  */
 
 #include "amdinfer/util/timer.hpp"
 
-#include <utility>  // for pair
+#ifdef AMDINFER_TSC_CLOCK
+#include <cpuid.h>  // for __get_cpuid
+#endif
 
 namespace amdinfer::util {
 
-TimePoint getTime() { return std::chrono::high_resolution_clock::now(); }
-
-Timer::Timer(TimePoint time) { add("start", time); }
-
-Timer::Timer(bool start) {
-  if (start) {
-    this->start();
+TscCalibration calibrateTsc() {
+  TscCalibration calibration;
+#ifdef AMDINFER_TSC_CLOCK
+  // bit 8 of EDX in this leaf is set if the counter is invariant
+  constexpr unsigned kPowerLeaf = 0x80000007;
+  constexpr unsigned kInvariantTsc = 1U << 8U;
+  unsigned eax = 0;
+  unsigned ebx = 0;
+  unsigned ecx = 0;
+  unsigned edx = 0;
+  if (__get_cpuid(kPowerLeaf, &eax, &ebx, &ecx, &edx) == 0 ||
+      (edx & kInvariantTsc) == 0) {
+    return calibration;
   }
-}
-
-void Timer::start() { add("start"); }
-
-void Timer::stop() { add("stop"); }
 
-void Timer::add(const std::string& label) { add(label, getTime()); }
-
-void Timer::add(const std::string& label, TimePoint time) {
-  auto point = times_.find(label);
-  if (point == times_.end()) {
-    times_.try_emplace(label, time);
-  } else {
-    point->second = time;
+  // the rate is measured over a few milliseconds, which is precise to a few
+  // parts per million, so the first time the clock is read is a bit slower
+  using Steady = std::chrono::steady_clock;
+  constexpr std::chrono::milliseconds kCalibration{5};
+  const auto start = Steady::now();
+  const auto start_ticks = __rdtsc();
+  auto stop = start;
+  while (stop - start < kCalibration) {
+    stop = Steady::now();
+  }
+  const auto stop_ticks = __rdtsc();
+  const auto ns =
+    std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count();
+  const auto ticks = stop_ticks - start_ticks;
+  if (ticks == 0) {
+    return calibration;
   }
-}
 
-void Timer::clear() { times_.clear(); }
+  constexpr auto kShift = 32;
+  calibration.scale = (static_cast<uint64_t>(ns) << kShift) / ticks;
+  calibration.base_ticks = stop_ticks;
+  calibration.base_ns =
+    std::chrono::duration_cast<std::chrono::nanoseconds>(
+      stop.time_since_epoch())
+      .count();
+  calibration.enabled = true;
+#endif
+  return calibration;
+}
 
 }  // namespace amdinfer::util
@@ -14,23 +14,115 @@
 
 /**
  * @file
- * @brief Defines a helper timer class
+ * @brief Defines the server's clock and a helper timer class
  */
 
 #ifndef GUARD_AMDINFER_UTIL_TIMER
 #define GUARD_AMDINFER_UTIL_TIMER
 
-#include <chrono>         // IWYU pragma: export
-#include <ratio>          // for ratio
-#include <string>         // for string
-#include <unordered_map>  // for unordered_map
+#include <array>    // for array
+#include <chrono>   // IWYU pragma: export
+#include <cstddef>  // for size_t
+#include <cstdint>  // for int64_t, uint64_t, uint8_t
+#include <ratio>    // for ratio
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>  // for __rdtsc
+#define AMDINFER_TSC_CLOCK
+#endif
 
 namespace amdinfer::util {
 
-using TimePoint = std::chrono::_V2::system_clock::time_point;
+/**
+ * @brief The conversion of the CPU's timestamp counter to nanoseconds. It's
+ * measured against the steady clock once per process
+ */
+struct TscCalibration {
+  /// false if the counter can't be used and the steady clock is used instead
+  bool enabled = false;
+  /// the counter when it was calibrated
+  uint64_t base_ticks = 0;
+  /// the steady clock's nanoseconds when it was calibrated
+  int64_t base_ns = 0;
+  /// nanoseconds per tick in 32.32 fixed point
+  uint64_t scale = 0;
+};
+
+/**
+ * @brief Calibrate the timestamp counter. It's only enabled if the CPU reports
+ * an invariant counter, which ticks at a constant rate in every power state
+ * and is synchronized across cores
+ *
+ * @return TscCalibration
+ */
+TscCalibration calibrateTsc();
+
+/// Get the process's calibration, which is measured the first time it's used
+inline const TscCalibration& getTscCalibration() {
+  static const TscCalibration calibration = calibrateTsc();
+  return calibration;
+}
 
-TimePoint getTime();
+/**
+ * @brief A steady clock that's cheap enough to read on every request. On x86
+ * CPUs with an invariant timestamp counter, it reads the counter and scales
+ * it to nanoseconds without a system call. Otherwise, it's the steady clock.
+ * Its times are only comparable within a process.
+ */
+struct Clock {
+  using rep = int64_t;
+  using period = std::nano;
+  using duration = std::chrono::nanoseconds;
+  using time_point = std::chrono::time_point<Clock>;
+  static constexpr bool is_steady = true;
+
+  static time_point now() noexcept {
+    const auto& tsc = getTscCalibration();
+#ifdef AMDINFER_TSC_CLOCK
+    if (tsc.enabled) {
+      constexpr auto kShift = 32;
+      // a core whose counter is a few ticks behind may read before the base
+      const auto ticks = static_cast<int64_t>(__rdtsc() - tsc.base_ticks);
+      __extension__ using Wide = __int128;
+      const auto ns = static_cast<int64_t>(
+        (static_cast<Wide>(ticks) * tsc.scale) >> kShift);
+      return time_point{duration{tsc.base_ns + ns}};
+    }
+#endif
+    (void)tsc;
+    return time_point{std::chrono::duration_cast<duration>(
+      std::chrono::steady_clock::now().time_since_epoch())};
+  }
+};
+
+using TimePoint = Clock::time_point;
 
+inline TimePoint getTime() { return Clock::now(); }
+
+/// The points in time that a Timer holds, each in a fixed slot
+enum class Mark : uint8_t {
+  Start,
+  Stop,
+  /// when the request being timed arrived
+  Arrival,
+  /// when the model started and finished running
+  InferStart,
+  InferStop,
+  /// when each phase of loading a worker finished
+  Init,
+  Acquire,
+  Preallocate,
+  Warmup,
+};
+
+/// The number of marks in a Timer
+constexpr size_t kTimerMarks = 9;
+
+/**
+ * @brief A timer holds the times of a fixed set of marks in an array so adding
+ * them doesn't allocate or hash a name and it can time the hot path of every
+ * request.
+ */
 class Timer {
  public:
   /**
@@ -38,58 +130,54 @@ class Timer {
    *
    * @param time set the start time to this value
    */
-  explicit Timer(TimePoint time);
+  explicit Timer(TimePoint time) { add(Mark::Start, time); }
   /**
    * @brief Construct a new Timer object
    *
    * @param start start the timer on construction
    */
-  explicit Timer(bool start = false);
+  explicit Timer(bool start = false) {
+    if (start) {
+      this->start();
+    }
+  }
 
+  /// Set the Start mark to the current time
+  void start() { add(Mark::Start); }
+  /// Set the Stop mark to the current time
+  void stop() { add(Mark::Stop); }
   /**
-   * @brief Add or replace the label "start" with the current time
-   *
-   */
-  void start();
-  /**
-   * @brief Add or replace the label "stop" with the current time
+   * @brief Set a mark to the current time
    *
+   * @param mark the mark to set
    */
-  void stop();
+  void add(Mark mark) { add(mark, getTime()); }
   /**
-   * @brief Add or replace the given label with the current time
+   * @brief Set a mark to the given time
    *
-   * @param label label to assign to the current timestamp
-   */
-  void add(const std::string& label);
-  /**
-   * @brief Add or replace the given label with the given time
-   *
-   * @param label label to assign to the timestamp
+   * @param mark the mark to set
    * @param time the timestamp
    */
-  void add(const std::string& label, TimePoint time);
+  void add(Mark mark, TimePoint time) {
+    times_[static_cast<size_t>(mark)] = time;
+  }
 
-  /**
-   * @brief Clear all the saved timestamps
-   *
-   */
-  void clear();
+  /// Clear all the saved timestamps
+  void clear() { times_.fill(TimePoint{}); }
 
   /**
-   * @brief Return the duration between two labeled timestamps
+   * @brief Return the duration between two marks
    *
    * @tparam U the ratio to convert the time e.g. std::micro for microseconds
    * @tparam T the type to return the time as
-   * @param start the label for the start time
-   * @param stop the label for the stop time
+   * @param start the mark of the start time
+   * @param stop the mark of the stop time
    * @return T the duration between the start and stop time in the right units
    */
   template <typename U = std::ratio<1, 1>, typename T = double>
-  T count(const std::string& start = "start",
-          const std::string& stop = "stop") {
-    const auto& start_time = times_.at(start);
-    const auto& stop_time = times_.at(stop);
+  T count(Mark start = Mark::Start, Mark stop = Mark::Stop) const {
+    const auto& start_time = times_[static_cast<size_t>(start)];
+    const auto& stop_time = times_[static_cast<size_t>(stop)];
 
     auto duration = std::chrono::duration_cast<std::chrono::duration<T, U>>(
       stop_time - start_time);
@@ -97,7 +185,7 @@ class Timer {
   }
 
  private:
-  std::unordered_map<std::string, TimePoint> times_;
+  std::array<TimePoint, kTimerMarks> times_{};
 };
 
 }  // namespace amdinfer::util
@@ -0,0 +1,151 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines a helper function to transpose matrices in cache-sized tiles
+ */
+
+#ifndef GUARD_AMDINFER_UTIL_TRANSPOSE
+#define GUARD_AMDINFER_UTIL_TRANSPOSE
+
+#include <algorithm>  // for min
+#include <cstddef>    // for size_t
+
+#include "amdinfer/pre_post/simd.hpp"  // for AMDINFER_X86_SIMD, hasAvx2
+
+namespace amdinfer::util {
+
+/// Rows and columns of the tiles that matrices are transposed in
+constexpr size_t kTransposeBlock = 32;
+
+namespace detail {
+
+template <typename T>
+void transposeScalar(const T* source, size_t rows, size_t cols,
+                     size_t source_stride, size_t dest_stride, T* dest) {
+  for (size_t i = 0; i < rows; ++i) {
+    for (size_t j = 0; j < cols; ++j) {
+      dest[j * dest_stride + i] = source[i * source_stride + j];
+    }
+  }
+}
+
+template <typename T>
+void transposeBlocked(const T* source, size_t rows, size_t cols, T* dest) {
+  for (size_t i = 0; i < rows; i += kTransposeBlock) {
+    const auto tile_rows = std::min(rows - i, kTransposeBlock);
+    for (size_t j = 0; j < cols; j += kTransposeBlock) {
+      const auto tile_cols = std::min(cols - j, kTransposeBlock);
+      transposeScalar(source + i * cols + j, tile_rows, tile_cols, cols, rows,
+                      dest + j * rows + i);
+    }
+  }
+}
+
+#ifdef AMDINFER_X86_SIMD
+
+constexpr size_t kTransposeWidth = 8;
+
+/// Transpose an 8x8 tile of 32-bit elements in registers
+__attribute__((target("avx2"))) inline void transpose8x8Avx2(
+  const float* source, size_t source_stride, size_t dest_stride, float* dest) {
+  // std::array drops the vector types' alignment attributes
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays, modernize-avoid-c-arrays)
+  __m256 rows[kTransposeWidth];
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays, modernize-avoid-c-arrays)
+  __m256 pairs[kTransposeWidth];
+  for (size_t i = 0; i < kTransposeWidth; ++i) {
+    rows[i] = _mm256_loadu_ps(source + i * source_stride);
+  }
+  // interleave pairs of rows, then pairs of pairs and then the 128-bit halves
+  for (size_t i = 0; i < kTransposeWidth; i += 2) {
+    pairs[i] = _mm256_unpacklo_ps(rows[i], rows[i + 1]);
+    pairs[i + 1] = _mm256_unpackhi_ps(rows[i], rows[i + 1]);
+  }
+  for (size_t i = 0; i < kTransposeWidth; i += 4) {
+    rows[i] = _mm256_shuffle_ps(pairs[i], pairs[i + 2], 0x44);
+    rows[i + 1] = _mm256_shuffle_ps(pairs[i], pairs[i + 2], 0xEE);
+    rows[i + 2] = _mm256_shuffle_ps(pairs[i + 1], pairs[i + 3], 0x44);
+    rows[i + 3] = _mm256_shuffle_ps(pairs[i + 1], pairs[i + 3], 0xEE);
+  }
+  for (size_t i = 0; i < kTransposeWidth / 2; ++i) {
+    pairs[i] = _mm256_permute2f128_ps(rows[i], rows[i + 4], 0x20);
+    pairs[i + 4] = _mm256_permute2f128_ps(rows[i], rows[i + 4], 0x31);
+  }
+  for (size_t i = 0; i < kTransposeWidth; ++i) {
+    _mm256_storeu_ps(dest + i * dest_stride, pairs[i]);
+  }
+}
+
+__attribute__((target("avx2"))) inline void transposeAvx2(const float* source,
+                                                          size_t rows,
+                                                          size_t cols,
+                                                          float* dest) {
+  for (size_t i0 = 0; i0 < rows; i0 += kTransposeBlock) {
+    const auto row_end = std::min(rows, i0 + kTransposeBlock);
+    for (size_t j0 = 0; j0 < cols; j0 += kTransposeBlock) {
+      const auto col_end = std::min(cols, j0 + kTransposeBlock);
+      size_t i = i0;
+      for (; i + kTransposeWidth <= row_end; i += kTransposeWidth) {
+        size_t j = j0;
+        for (; j + kTransposeWidth <= col_end; j += kTransposeWidth) {
+          transpose8x8Avx2(source + i * cols + j, cols, rows,
+                           dest + j * rows + i);
+        }
+        transposeScalar(source + i * cols + j, kTransposeWidth, col_end - j,
+                        cols, rows, dest + j * rows + i);
+      }
+      transposeScalar(source + i * cols + j0, row_end - i, col_end - j0, cols,
+                      rows, dest + j0 * rows + i);
+    }
+  }
+}
+
+#endif
+
+}  // namespace detail
+
+/**
+ * @brief Transpose a row-major matrix. It's done in tiles that fit in the
+ * cache so neither the reads nor the writes stride through all of memory and
+ * tiles of 32-bit elements are transposed 8x8 at a time with AVX2 if the CPU
+ * supports it.
+ *
+ * @tparam T type of the elements
+ * @param source matrix to transpose
+ * @param rows rows in the source
+ * @param cols columns in the source
+ * @param dest where to write the cols x rows transposed matrix
+ */
+template <typename T>
+void transpose(const T* source, size_t rows, size_t cols, T* dest) {
+#ifdef AMDINFER_X86_SIMD
+  if constexpr (sizeof(T) == sizeof(float)) {
+    static const bool has_avx2 = pre_post::detail::hasAvx2();
+    if (has_avx2 && rows >= detail::kTransposeWidth &&
+        cols >= detail::kTransposeWidth) {
+      // the intrinsics' loads and stores may alias any 32-bit type
+      detail::transposeAvx2(reinterpret_cast<const float*>(source), rows, cols,
+                            reinterpret_cast<float*>(dest));
+      return;
+    }
+  }
+#endif
+  detail::transposeBlocked(source, rows, cols, dest);
+}
+
+}  // namespace amdinfer::util
+
+#endif  // GUARD_AMDINFER_UTIL_TRANSPOSE
@@ -0,0 +1,124 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines how consumers wait for work on the queues between the stages
+ * of an endpoint
+ */
+
+#ifndef GUARD_AMDINFER_UTIL_WAIT
+#define GUARD_AMDINFER_UTIL_WAIT
+
+#include <algorithm>  // for min
+#include <chrono>     // for microseconds, steady_clock, duration_cast
+#include <string>     // for string
+
+#include "amdinfer/core/exceptions.hpp"  // for invalid_argument
+
+namespace amdinfer::util {
+
+/// How a consumer waits for an empty queue to get work
+enum class WaitMode {
+  /// sleep until a producer wakes it up
+  Block,
+  /// spin for a while and then sleep
+  Spin,
+  /// spin until there's work without ever sleeping
+  Poll
+};
+
+/// How long consumers spin before they sleep by default
+constexpr std::chrono::microseconds kDefaultSpinTime{50};
+/// The timeout of a wait without one
+constexpr auto kWaitForever = std::chrono::microseconds::max();
+
+/**
+ * @brief The strategy of a consumer waiting on a queue. Sleeping costs a
+ * futex wake-up on each hand-off, which is comparable to the compute of small
+ * models. Spinning skips it at the cost of a busy core while the queue is
+ * empty so polling should be used with consumers pinned to their own cores.
+ */
+struct WaitStrategy {
+  WaitMode mode = WaitMode::Block;
+  /// how long to spin before sleeping with WaitMode::Spin
+  std::chrono::microseconds spin = kDefaultSpinTime;
+};
+
+/**
+ * @brief Parse the name of a wait mode: "block", "spin" or "poll"
+ *
+ * @param mode the name to parse
+ * @return WaitMode
+ */
+inline WaitMode parseWaitMode(const std::string& mode) {
+  if (mode == "block") {
+    return WaitMode::Block;
+  }
+  if (mode == "spin") {
+    return WaitMode::Spin;
+  }
+  if (mode == "poll") {
+    return WaitMode::Poll;
+  }
+  throw invalid_argument("The wait mode must be block, spin or poll, not " +
+                         mode);
+}
+
+/// Tell the CPU that the thread is spinning so it can save power and not
+/// starve its sibling hyperthread
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield");
+#endif
+}
+
+/**
+ * @brief Spin on a queue until taking from it succeeds or the strategy says
+ * to stop and sleep instead. With WaitMode::Block, it doesn't spin at all.
+ *
+ * @param strategy how to wait
+ * @param timeout the most time to spin for
+ * @param ready checks if the queue may have work without taking any locks
+ * @param take tries to take the work
+ * @return bool true if the work was taken
+ */
+template <typename Ready, typename Take>
+bool spin(const WaitStrategy& strategy, std::chrono::microseconds timeout,
+          const Ready& ready, const Take& take) {
+  if (strategy.mode == WaitMode::Block) {
+    return false;
+  }
+  const auto limit = strategy.mode == WaitMode::Poll
+                       ? timeout
+                       : std::min(timeout, strategy.spin);
+  const auto start = std::chrono::steady_clock::now();
+  while (true) {
+    if (ready() && take()) {
+      return true;
+    }
+    const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+    if (elapsed >= limit) {
+      return false;
+    }
+    cpuRelax();
+  }
+}
+
+}  // namespace amdinfer::util
+
+#endif  // GUARD_AMDINFER_UTIL_WAIT
@@ -0,0 +1,187 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the thread pool whose threads steal work from one another
+ */
+
+#include "amdinfer/util/work_stealing_pool.hpp"
+
+#include <utility>  // for move
+
+#include "amdinfer/util/thread.hpp"  // for setThreadName, setThreadAffinity
+
+namespace amdinfer::util {
+
+namespace {
+
+/// the pool that the calling thread belongs to, if any
+thread_local const WorkStealingPool* current_pool = nullptr;
+/// the index of the calling thread's queue in its pool
+thread_local size_t current_index = 0;
+
+}  // namespace
+
+WorkStealingPool::WorkStealingPool(size_t threads) { this->start(threads); }
+
+WorkStealingPool::~WorkStealingPool() { this->stop(); }
+
+size_t WorkStealingPool::getSize() const { return threads_.size(); }
+
+void WorkStealingPool::resize(size_t threads) {
+  this->stop();
+  this->start(threads);
+}
+
+void WorkStealingPool::setAffinity(const std::vector<int>& cpus, bool spread) {
+  cpus_ = cpus;
+  spread_ = spread;
+  for (auto i = 0U; i < threads_.size(); ++i) {
+    this->pin(i);
+  }
+}
+
+void WorkStealingPool::pin(size_t index) {
+  if (cpus_.empty()) {
+    return;
+  }
+  if (spread_) {
+    util::setThreadAffinity(threads_[index], {cpus_[index % cpus_.size()]});
+  } else {
+    util::setThreadAffinity(threads_[index], cpus_);
+  }
+}
+
+void WorkStealingPool::submit(Task task) {
+  if (queues_.empty()) {
+    std::lock_guard lock{mutex_};
+    held_.push_back(std::move(task));
+    return;
+  }
+
+  // a task that submits more keeps them on its own thread while it's busy and
+  // the others steal them if they're idle
+  const auto index = current_pool == this
+                       ? current_index
+                       : next_.fetch_add(1) % queues_.size();
+  auto& queue = *queues_[index];
+  {
+    std::lock_guard lock{queue.mutex};
+    queue.tasks.push_back(std::move(task));
+  }
+
+  // either this sees the sleeping thread or the thread sees the task before it
+  // sleeps so the lock is only needed if a thread may be sleeping
+  pending_.fetch_add(1);
+  if (sleeping_.load() > 0) {
+    { std::lock_guard lock{mutex_}; }
+    cv_.notify_one();
+  }
+}
+
+bool WorkStealingPool::take(size_t index, Task& task) {
+  {
+    auto& queue = *queues_[index];
+    std::lock_guard lock{queue.mutex};
+    if (!queue.tasks.empty()) {
+      task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+      pending_.fetch_sub(1);
+      return true;
+    }
+  }
+
+  // steal the newest task of another thread since its owner takes the oldest
+  for (auto i = 1U; i < queues_.size(); ++i) {
+    auto& queue = *queues_[(index + i) % queues_.size()];
+    std::unique_lock lock{queue.mutex, std::try_to_lock};
+    if (lock.owns_lock() && !queue.tasks.empty()) {
+      task = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+      pending_.fetch_sub(1);
+      return true;
+    }
+  }
+  return false;
+}
+
+void WorkStealingPool::run(size_t index) {
+  util::setThreadName("StealPool");
+  current_pool = this;
+  current_index = index;
+
+  while (true) {
+    Task task;
+    if (this->take(index, task)) {
+      task();
+      continue;
+    }
+
+    std::unique_lock lock{mutex_};
+    if (pending_.load() > 0) {
+      // a queue that was busy when stealing may still have tasks
+      continue;
+    }
+    if (stop_) {
+      break;
+    }
+    sleeping_.fetch_add(1);
+    cv_.wait(lock, [this]() { return stop_ || pending_.load() > 0; });
+    sleeping_.fetch_sub(1);
+  }
+}
+
+void WorkStealingPool::start(size_t threads) {
+  if (threads == 0) {
+    return;
+  }
+  stop_ = false;
+  queues_.reserve(threads);
+  for (auto i = 0U; i < threads; ++i) {
+    queues_.push_back(std::make_unique<Queue>());
+  }
+  threads_.reserve(threads);
+  for (auto i = 0U; i < threads; ++i) {
+    threads_.emplace_back(&WorkStealingPool::run, this, i);
+    this->pin(i);
+  }
+
+  std::vector<Task> held;
+  {
+    std::lock_guard lock{mutex_};
+    held.swap(held_);
+  }
+  for (auto& task : held) {
+    this->submit(std::move(task));
+  }
+}
+
+void WorkStealingPool::stop() {
+  if (threads_.empty()) {
+    return;
+  }
+  {
+    std::lock_guard lock{mutex_};
+    stop_ = true;
+  }
+  cv_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+  threads_.clear();
+  queues_.clear();
+}
+
+}  // namespace amdinfer::util
@@ -0,0 +1,131 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines a thread pool whose threads steal work from one another
+ */
+
+#ifndef GUARD_AMDINFER_UTIL_WORK_STEALING_POOL
+#define GUARD_AMDINFER_UTIL_WORK_STEALING_POOL
+
+#include <atomic>              // for atomic
+#include <condition_variable>  // for condition_variable
+#include <cstddef>             // for size_t
+#include <deque>               // for deque
+#include <functional>          // for function
+#include <memory>              // for unique_ptr
+#include <mutex>               // for mutex
+#include <thread>              // for thread
+#include <vector>              // for vector
+
+namespace amdinfer::util {
+
+/**
+ * @brief The WorkStealingPool runs tasks on a set of threads. Unlike the
+ * ThreadPool, which has one queue that every push and pop contends on, each
+ * thread has its own queue. Tasks submitted from outside the pool are spread
+ * across the queues and tasks submitted by a task go to its thread's queue. A
+ * thread with an empty queue takes tasks from the others before it sleeps.
+ *
+ * Submitting doesn't make a future so tasks must report their own results and
+ * errors. An exception that escapes a task terminates the program, like one
+ * that escapes a thread.
+ */
+class WorkStealingPool {
+ public:
+  using Task = std::function<void()>;
+
+  /**
+   * @brief Construct a new WorkStealingPool object
+   *
+   * @param threads the number of threads to start
+   */
+  explicit WorkStealingPool(size_t threads = 0);
+  WorkStealingPool(const WorkStealingPool&) = delete;
+  WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+  WorkStealingPool(WorkStealingPool&&) = delete;
+  WorkStealingPool& operator=(WorkStealingPool&&) = delete;
+  /// Destructor. The tasks that were submitted are run first
+  ~WorkStealingPool();
+
+  /// Get the number of threads in the pool
+  [[nodiscard]] size_t getSize() const;
+
+  /**
+   * @brief Change the number of threads in the pool. The tasks that were
+   * submitted are run and the pool is restarted with the new threads so this
+   * shouldn't be called while other threads submit tasks
+   *
+   * @param threads the number of threads
+   */
+  void resize(size_t threads);
+
+  /**
+   * @brief Pin the pool's current and future threads to CPUs. If empty, new
+   * threads are left unpinned
+   *
+   * @param cpus the CPUs to pin to
+   * @param spread if true, each thread is pinned to one of the CPUs in turn
+   * instead of to all of them so the threads don't migrate between cores
+   */
+  void setAffinity(const std::vector<int>& cpus, bool spread = false);
+
+  /**
+   * @brief Run a task on one of the threads. With no threads, it's run by the
+   * next resize() that adds some or it's dropped when the pool is destroyed
+   *
+   * @param task the task to run
+   */
+  void submit(Task task);
+
+  /// Run the tasks that were submitted and stop the threads
+  void stop();
+
+ private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  /// Start the threads with their own queues
+  void start(size_t threads);
+  /// Take the next task from a thread's own queue or steal one from the others
+  bool take(size_t index, Task& task);
+  /// Run the tasks of one thread until the pool is stopped
+  void run(size_t index);
+  /// Pin a thread according to the affinity
+  void pin(size_t index);
+
+  std::vector<std::unique_ptr<Queue>> queues_;
+  std::vector<std::thread> threads_;
+  /// tasks submitted while there were no threads
+  std::vector<Task> held_;
+  std::vector<int> cpus_;
+  bool spread_ = false;
+  /// spreads the tasks submitted from outside the pool across the queues
+  std::atomic<size_t> next_ = 0;
+  /// tasks in the queues that haven't been taken yet
+  std::atomic<size_t> pending_ = 0;
+  /// threads that are sleeping on cv_
+  std::atomic<size_t> sleeping_ = 0;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stop_ = false;
+};
+
+}  // namespace amdinfer::util
+
+#endif  // GUARD_AMDINFER_UTIL_WORK_STEALING_POOL
@@ -25,6 +25,7 @@
 #include <cstddef>                 // for size_t, byte
 #include <cstdint>                 // for int32_t
 #include <cstring>                 // for memcpy
+#include <exception>               // for exception
 #include <future>                  // for future
 #include <memory>                  // for unique_ptr, allocator
 #include <ratio>                   // for micro
@@ -39,7 +40,7 @@
 #include "amdinfer/batching/batcher.hpp"  // for BatchPtr, Batch, BatchP...
 #include "amdinfer/build_options.hpp"     // for AMDINFER_ENABLE_TRACING
 #include "amdinfer/core/data_types.hpp"   // for DataType, DataType::Fp32
-#include "amdinfer/core/exceptions.hpp"   // for external_error
+#include "amdinfer/core/exceptions.hpp"   // for external_error, invali...
 #include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
 #include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
 #include "amdinfer/core/parameters.hpp"          // for ParameterMap
@@ -47,6 +48,8 @@
 #include "amdinfer/observation/logging.hpp"  // for Logger
 #include "amdinfer/observation/metrics.hpp"  // for Metrics, MetricSummaryIDs
 #include "amdinfer/observation/tracing.hpp"  // for Trace
+#include "amdinfer/util/ctpl.hpp"            // for ThreadPool
+#include "amdinfer/util/job_window.hpp"      // for JobWindow
 #include "amdinfer/util/parse_env.hpp"       // for autoExpandEnvironmentVa...
 #include "amdinfer/util/thread.hpp"          // for setThreadName
 #include "amdinfer/util/timer.hpp"           // for Timer
@@ -58,6 +61,18 @@ class AIGraph;
 
 namespace amdinfer::workers {
 
+/// By default, this many batches of AKS jobs are in flight at once
+constexpr size_t kDefaultAksJobs = 4;
+
+using AksFuture = std::future<std::vector<std::unique_ptr<vart::TensorBuffer>>>;
+
+/// A batch whose inputs have been enqueued in AKS
+struct AksJob {
+  BatchPtr batch;
+  /// the AKS job of each input of each request, in order
+  std::vector<std::vector<AksFuture>> futures;
+};
+
 /**
  * @brief The Aks worker is a simple worker that accepts a single uint32_t
  * argument and adds 1 to it and returns. It accepts multiple input tensors and
@@ -77,10 +92,17 @@ class Aks : public Worker {
   void doRelease() override;
   void doDestroy() override;
 
+  /// Wait for a batch's jobs to finish and respond to its requests
+  void respond(AksJob* job);
+
   /// the AKS system manager
   AKS::SysManagerExt* sys_manager_ = nullptr;
   /// the corresponding graph to the name
   AKS::AIGraph* graph_ = nullptr;
+  /// Most batches that may have jobs in AKS at once
+  size_t max_in_flight_ = kDefaultAksJobs;
+  /// threads that wait for the batches in flight and respond to them
+  util::ThreadPool thread_pool_;
 };
 
 std::thread Aks::spawn(BatchPtrQueue* input_queue) {
@@ -119,6 +141,18 @@ void Aks::doAcquire(ParameterMap* parameters) {
     throw external_error("AKS graph " + graph_name + " not found");
   }
 
+  if (parameters->has("jobs")) {
+    const auto jobs = parameters->get<int32_t>("jobs");
+    if (jobs <= 0) {
+      throw invalid_argument("The number of AKS jobs must be positive");
+    }
+    this->max_in_flight_ = jobs;
+  }
+  // each batch in flight has a thread to wait for it so they finish in any
+  // order
+  this->thread_pool_.resize(static_cast<int>(this->max_in_flight_));
+  this->thread_pool_.setAffinity(this->cpus_);
+
   this->metadata_.addInputTensor("input", {this->batch_size_, 1},
                                  DataType::Fp32);
   this->metadata_.addOutputTensor("output", {this->batch_size_, 1},
@@ -132,6 +166,10 @@ void Aks::doRun(BatchPtrQueue* input_queue) {
   const auto& logger = this->getLogger();
 #endif
 
+  // batches are enqueued in AKS as they arrive, up to the window, so the
+  // graph's kernels work on different batches at once. Each batch is finished
+  // by the thread pool once its jobs are done, in any order
+  util::JobWindow window{this->max_in_flight_};
   while (true) {
     BatchPtr batch;
     input_queue->wait_dequeue(batch);
@@ -139,17 +177,15 @@ void Aks::doRun(BatchPtrQueue* input_queue) {
       break;
     }
     AMDINFER_LOG_INFO(logger, "Got request in aks");
-    for (unsigned int j = 0; j < batch->size(); j++) {
-      const auto& req = batch->getRequest(static_cast<int>(j));
+    window.acquire();
+    auto job = std::make_shared<AksJob>();
+    job->futures.resize(batch->size());
 #ifdef AMDINFER_ENABLE_TRACING
-      const auto& trace = batch->getTrace(static_cast<int>(j));
-      trace->startSpan("aks");
+    batch->startSpan("aks");
 #endif
-      InferenceResponse resp;
-      resp.setID(req->getID());
-      resp.setModel("aks");
+    for (unsigned int j = 0; j < batch->size(); j++) {
+      const auto& req = batch->getRequest(static_cast<int>(j));
       auto inputs = req->getInputs();
-      auto outputs = req->getOutputs();
 
       for (auto& input : inputs) {
         auto* input_buffer = input.getData();
@@ -166,13 +202,35 @@ void Aks::doRun(BatchPtrQueue* input_queue) {
         auto* data_in_ptr = reinterpret_cast<float*>(v[0]->data().first);
         data_in_ptr[0] = value;
 
-        std::future<std::vector<std::unique_ptr<vart::TensorBuffer>>> future =
-          this->sys_manager_->enqueueJob(this->graph_, "", std::move(v),
-                                         nullptr);
+        job->futures[j].push_back(this->sys_manager_->enqueueJob(
+          this->graph_, "", std::move(v), nullptr));
+      }
+    }
+    job->batch = std::move(batch);
+    this->thread_pool_.push([this, job, &window](int id) {
+      (void)id;  // suppress unused variable warning
+      this->respond(job.get());
+      window.release();
+    });
+  }
+  // finish the batches in flight before ending
+  window.drain();
+  AMDINFER_LOG_INFO(logger, "Aks ending");
+}
+
+void Aks::respond(AksJob* job) {
+  const auto& batch = job->batch;
+  for (unsigned int j = 0; j < batch->size(); j++) {
+    const auto& req = batch->getRequest(static_cast<int>(j));
+    InferenceResponse resp;
+    resp.setID(req->getID());
+    resp.setModel("aks");
 
+    try {
+      for (auto& future : job->futures[j]) {
         auto out_data_descriptor = future.get();
 
-        value =
+        auto value =
           (reinterpret_cast<float*>(out_data_descriptor[0]->data().first))[0];
 
         InferenceResponseOutput output;
@@ -185,22 +243,25 @@ void Aks::doRun(BatchPtrQueue* input_queue) {
         output.setData(std::move(buffer));
         resp.addOutput(output);
       }
+    } catch (const std::exception& e) {
+      req->runCallbackError(e.what());
+      continue;
+    }
 
 #ifdef AMDINFER_ENABLE_METRICS
-      util::Timer timer{batch->getTime(j)};
-      timer.stop();
-      auto duration = timer.count<std::micro>();
-      Metrics::getInstance().observeSummary(MetricSummaryIDs::RequestLatency,
-                                            duration);
+    util::Timer timer{batch->getTime(j)};
+    timer.stop();
+    auto duration = timer.count<std::micro>();
+    Metrics::getInstance().observeSummary(MetricSummaryIDs::RequestLatency,
+                                          duration);
 #endif
 #ifdef AMDINFER_ENABLE_TRACING
-      auto context = trace->propagate();
-      resp.setContext(std::move(context));
+    const auto& trace = batch->getTrace(static_cast<int>(j));
+    auto context = trace->propagate();
+    resp.setContext(std::move(context));
 #endif
-      req->runCallbackOnce(resp);
-    }
+    req->runCallbackOnce(resp);
   }
-  AMDINFER_LOG_INFO(logger, "Aks ending");
 }
 
 void Aks::doRelease() {}
@@ -211,7 +272,7 @@ void Aks::doDestroy() {}
 extern "C" {
 // using smart pointer here may cause problems inside shared object so managing
 // manually
-amdinfer::workers::Worker* getWorker() {
+amdinfer::workers::Worker* AMDINFER_WORKER_FACTORY() {
   return new amdinfer::workers::Aks("AKS", "AKS");
 }
 }  // extern C
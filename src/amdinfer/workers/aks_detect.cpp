@@ -44,6 +44,7 @@
 #include "amdinfer/batching/batcher.hpp"  // for BatchPtr, Batch, BatchP...
 #include "amdinfer/build_options.hpp"     // for AMDINFER_ENABLE_TRACING
 #include "amdinfer/core/data_types.hpp"   // for DataType, DataType::Uint32
+#include "amdinfer/core/exceptions.hpp"   // for invalid_argument
 #include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
 #include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
 #include "amdinfer/core/parameters.hpp"          // for ParameterMap
@@ -51,8 +52,11 @@
 #include "amdinfer/observation/logging.hpp"  // for Logger
 #include "amdinfer/observation/metrics.hpp"  // for Metrics, MetricSummaryIDs
 #include "amdinfer/observation/tracing.hpp"  // for Trace
+#include "amdinfer/pre_post/detection.hpp"   // for packDetections
 #include "amdinfer/util/base64.hpp"          // for base64_decode
 #include "amdinfer/util/containers.hpp"      // for containerProduct
+#include "amdinfer/util/ctpl.hpp"            // for ThreadPool
+#include "amdinfer/util/job_window.hpp"      // for JobWindow
 #include "amdinfer/util/parse_env.hpp"       // for autoExpandEnvironmentVa...
 #include "amdinfer/util/thread.hpp"          // for setThreadName
 #include "amdinfer/util/timer.hpp"           // for Timer
@@ -64,6 +68,16 @@ class AIGraph;
 
 namespace amdinfer::workers {
 
+/// By default, this many AKS jobs are in flight at once
+constexpr size_t kDefaultAksJobs = 4;
+
+/// A batch that's been enqueued in AKS
+struct AksDetectJob {
+  BatchPtr batch;
+  std::vector<InferenceResponse> responses;
+  std::future<std::vector<std::unique_ptr<vart::TensorBuffer>>> future;
+};
+
 /**
  * @brief The Resnet50 worker accepts a 224x224 image and returns an array of
  * classification IDs
@@ -82,9 +96,16 @@ class AksDetect : public Worker {
   void doRelease() override;
   void doDestroy() override;
 
+  /// Wait for a job to finish and respond to its requests
+  void respond(AksDetectJob* job);
+
   AKS::SysManagerExt* sys_manager_ = nullptr;
   std::string graph_name_;
   AKS::AIGraph* graph_ = nullptr;
+  /// Most jobs that may be enqueued in AKS at once
+  size_t max_in_flight_ = kDefaultAksJobs;
+  /// threads that wait for the jobs in flight and respond to them
+  util::ThreadPool thread_pool_;
 };
 
 std::thread AksDetect::spawn(BatchPtrQueue* input_queue) {
@@ -137,6 +158,17 @@ void AksDetect::doAcquire(ParameterMap* parameters) {
 
   this->graph_ = this->sys_manager_->getGraph(this->graph_name_);
 
+  if (parameters->has("jobs")) {
+    const auto jobs = parameters->get<int32_t>("jobs");
+    if (jobs <= 0) {
+      throw invalid_argument("The number of AKS jobs must be positive");
+    }
+    this->max_in_flight_ = jobs;
+  }
+  // each job in flight has a thread to wait for it so they finish in any order
+  this->thread_pool_.resize(static_cast<int>(this->max_in_flight_));
+  this->thread_pool_.setAffinity(this->cpus_);
+
   this->metadata_.addInputTensor(
     "input", {this->batch_size_, kImageHeight, kImageWidth, kImageChannels},
     DataType::Int8);
@@ -151,6 +183,11 @@ void AksDetect::doRun(BatchPtrQueue* input_queue) {
   const auto& logger = this->getLogger();
 #endif
 
+  // batches are enqueued in AKS as they arrive, up to the window, so its
+  // pre-processing, DPU and post-processing kernels work on different batches
+  // at once. Each job is finished by the thread pool once it's done, in any
+  // order
+  util::JobWindow window{this->max_in_flight_};
   while (true) {
     BatchPtr batch;
     input_queue->wait_dequeue(batch);
@@ -158,19 +195,19 @@ void AksDetect::doRun(BatchPtrQueue* input_queue) {
       break;
     }
     AMDINFER_LOG_INFO(logger, "Got request in AksDetect");
-    std::vector<InferenceResponse> responses;
+    auto job = std::make_shared<AksDetectJob>();
+    auto& responses = job->responses;
     responses.reserve(batch->getInputSize());
 
     std::vector<std::unique_ptr<vart::TensorBuffer>> v;
     v.reserve(batch->size());
 
     size_t tensor_count = 0;
-    for (unsigned int j = 0; j < batch->size(); j++) {
-      const auto& req = batch->getRequest(static_cast<int>(j));
 #ifdef AMDINFER_ENABLE_TRACING
-      const auto& trace = batch->getTrace(static_cast<int>(j));
-      trace->startSpan("AksDetect");
+    batch->startSpan("AksDetect");
 #endif
+    for (unsigned int j = 0; j < batch->size(); j++) {
+      const auto& req = batch->getRequest(static_cast<int>(j));
       auto& resp = responses.emplace_back();
       resp.setID(req->getID());
       resp.setModel(this->graph_name_);
@@ -233,78 +270,101 @@ void AksDetect::doRun(BatchPtrQueue* input_queue) {
       }
     }
 
-    std::future<std::vector<std::unique_ptr<vart::TensorBuffer>>> future =
+    window.acquire();
+    job->future =
       this->sys_manager_->enqueueJob(this->graph_, "", std::move(v), nullptr);
+    job->batch = std::move(batch);
+    this->thread_pool_.push([this, job, &window](int id) {
+      (void)id;  // suppress unused variable warning
+      this->respond(job.get());
+      window.release();
+    });
+  }
+  // finish the jobs in flight before ending
+  window.drain();
+  AMDINFER_LOG_INFO(logger, "AksDetect ending");
+}
 
-    auto out_data_descriptor = future.get();
-
-    auto shape = out_data_descriptor[0]->get_tensor()->get_shape();
-    // shape[0] is number of boxes, shape[1] is the number of values per box
-    int size = shape.size() > 1 ? shape[0] * shape[1] : 0;
+void AksDetect::respond(AksDetectJob* job) {
+  auto& batch = job->batch;
+  auto& responses = job->responses;
+  std::vector<std::unique_ptr<vart::TensorBuffer>> out_data_descriptor;
+  try {
+    out_data_descriptor = job->future.get();
+  } catch (const std::exception& e) {
+#ifdef AMDINFER_ENABLE_LOGGING
+    const auto& logger = this->getLogger();
+#endif
+    AMDINFER_LOG_ERROR(logger, e.what());
+    for (unsigned int k = 0; k < batch->size(); k++) {
+      batch->getRequest(static_cast<int>(k))->runCallbackError(e.what());
+    }
+    this->returnInputBuffers(std::move(batch));
+    return;
+  }
 
-    auto* top_k_data =
-      reinterpret_cast<float*>(out_data_descriptor[0]->data().first);
-    auto my_data_2 = std::vector<std::vector<std::byte>>();
-    my_data_2.resize(this->batch_size_);
-    for (int i = 0; i < size; i += kAkdDetectResponseSize) {
-      auto batch_id = static_cast<int>(top_k_data[i]);
-      auto len = my_data_2[batch_id].size();
-      my_data_2[batch_id].resize(len + sizeof(DetectResponse));
+  auto shape = out_data_descriptor[0]->get_tensor()->get_shape();
+  // shape[0] is number of boxes, shape[1] is the number of values per box
+  auto count = shape.size() > 1 ? static_cast<size_t>(shape[0]) : 0;
 
-      memcpy(my_data_2[batch_id].data() + len, &(top_k_data[i + 1]),
-             sizeof(DetectResponse));
-    }
+  const auto* top_k_data =
+    reinterpret_cast<float*>(out_data_descriptor[0]->data().first);
+  const auto detections =
+    pre_post::packDetections(top_k_data, count, this->batch_size_);
 
-    tensor_count = 0;
-    for (unsigned int k = 0; k < batch->size(); k++) {
-      const auto& req = batch->getRequest(static_cast<int>(k));
-      auto inputs = req->getInputs();
-      auto outputs = req->getOutputs();
-      auto& resp = responses[k];
+  size_t tensor_count = 0;
+  for (unsigned int k = 0; k < batch->size(); k++) {
+    const auto& req = batch->getRequest(static_cast<int>(k));
+    auto inputs = req->getInputs();
+    auto outputs = req->getOutputs();
+    auto& resp = responses[k];
 
-      // int offset = 0;
-      for (unsigned int i = 0; i < inputs.size(); i++) {
-        InferenceResponseOutput output;
+    // int offset = 0;
+    for (unsigned int i = 0; i < inputs.size(); i++) {
+      InferenceResponseOutput output;
 
-        output.setDatatype(DataType::Fp32);
+      output.setDatatype(DataType::Fp32);
 
-        std::string output_name;
-        if (i < outputs.size()) {
-          output_name = outputs[i].getName();
-        }
+      std::string output_name;
+      if (i < outputs.size()) {
+        output_name = outputs[i].getName();
+      }
 
-        if (output_name.empty()) {
-          output.setName(inputs[0].getName());
-        } else {
-          output.setName(output_name);
-        }
+      if (output_name.empty()) {
+        output.setName(inputs[0].getName());
+      } else {
+        output.setName(output_name);
+      }
 
-        output.setShape(
-          {kAkdDetectResponseSize - 1,
-           my_data_2[tensor_count].size() / sizeof(DetectResponse)});
-        output.setData(std::move(my_data_2[tensor_count]));
-        resp.addOutput(output);
-        tensor_count++;
+      std::vector<std::byte> data;
+      if (tensor_count < this->batch_size_) {
+        const auto boxes = detections.count(tensor_count);
+        data.resize(boxes * sizeof(DetectResponse));
+        std::memcpy(data.data(), detections.data(tensor_count), data.size());
       }
+      output.setShape({kAkdDetectResponseSize - 1,
+                       data.size() / sizeof(DetectResponse)});
+      output.setData(std::move(data));
+      resp.addOutput(output);
+      tensor_count++;
+    }
 
 #ifdef AMDINFER_ENABLE_METRICS
-      util::Timer timer{batch->getTime(k)};
-      timer.stop();
-      auto duration = timer.count<std::micro>();
-      Metrics::getInstance().observeSummary(MetricSummaryIDs::RequestLatency,
-                                            duration);
+    util::Timer timer{batch->getTime(k)};
+    timer.stop();
+    auto duration = timer.count<std::micro>();
+    Metrics::getInstance().observeSummary(MetricSummaryIDs::RequestLatency,
+                                          duration);
 #endif
 
 #ifdef AMDINFER_ENABLE_TRACING
-      const auto& trace = batch->getTrace(k);
-      auto context = trace->propagate();
-      resp.setContext(std::move(context));
+    const auto& trace = batch->getTrace(k);
+    auto context = trace->propagate();
+    resp.setContext(std::move(context));
 #endif
-      req->runCallbackOnce(resp);
-    }
-    this->returnInputBuffers(std::move(batch));
+    req->runCallbackOnce(resp);
   }
-  AMDINFER_LOG_INFO(logger, "AksDetect ending");
+  this->returnInputBuffers(std::move(batch));
 }
 
 void AksDetect::doRelease() {}
@@ -315,7 +375,7 @@ void AksDetect::doDestroy() {}
 extern "C" {
 // using smart pointer here may cause problems inside shared object so managing
 // manually
-amdinfer::workers::Worker* getWorker() {
+amdinfer::workers::Worker* AMDINFER_WORKER_FACTORY() {
   return new amdinfer::workers::AksDetect("AksDetect", "AKS");
 }
 }  // extern C
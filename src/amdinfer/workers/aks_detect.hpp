@@ -20,19 +20,15 @@
 #ifndef GUARD_AMDINFER_WORKERS_AKS_DETECT
 #define GUARD_AMDINFER_WORKERS_AKS_DETECT
 
+#include "amdinfer/pre_post/detection.hpp"  // for Detection, kDetectionFl...
+
 namespace amdinfer::workers {
 
-struct DetectResponse {
-  float class_id;
-  float score;
-  float x;
-  float y;
-  float w;
-  float h;
-};
-
-// the number of float values per response
-const int kAkdDetectResponseSize = 7;
+/// The AKS detection graphs describe each box like the detection module does
+using DetectResponse = pre_post::Detection;
+
+// the number of float values per response: the image's index and the box
+const int kAkdDetectResponseSize = pre_post::kDetectionFloats + 1;
 
 }  // namespace amdinfer::workers
 
@@ -22,16 +22,13 @@
 #include <aks/AksTensorBuffer.h>   // for AksTensorBuffer
 
 #include <algorithm>               // for copy, max, copy_backward
-#include <chrono>                  // for seconds
 #include <cstdint>                 // for int32_t, uint8_t
 #include <cstring>                 // for size_t, memcpy
+#include <exception>               // for exception
 #include <ext/alloc_traits.h>      // for __alloc_traits<>::value...
-#include <future>                  // for future, future_status
 #include <memory>                  // for allocator, unique_ptr
 #include <opencv2/core.hpp>        // for Mat, MatSize, Size, Mat...
-#include <opencv2/imgcodecs.hpp>   // for imencode
 #include <opencv2/videoio.hpp>     // for VideoCapture, VideoCapt...
-#include <queue>                   // for queue
 #include <string>                  // for string, operator+, to_s...
 #include <thread>                  // for thread
 #include <utility>                 // for move, pair
@@ -46,14 +43,14 @@
 #include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
 #include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
 #include "amdinfer/core/parameters.hpp"          // for ParameterMap
-#include "amdinfer/declarations.hpp"         // for BufferPtrs, InferenceRe...
-#include "amdinfer/observation/logging.hpp"  // for Logger
-#include "amdinfer/observation/tracing.hpp"  // for Trace
-#include "amdinfer/util/base64.hpp"          // for base64_encode
-#include "amdinfer/util/parse_env.hpp"       // for autoExpandEnvironmentVa...
-#include "amdinfer/util/thread.hpp"          // for setThreadName
-#include "amdinfer/workers/aks_detect.hpp"   // for DetectResponse
-#include "amdinfer/workers/worker.hpp"       // for Worker, kNumBufferAuto
+#include "amdinfer/declarations.hpp"          // for BufferPtrs, InferenceRe...
+#include "amdinfer/observation/logging.hpp"   // for Logger
+#include "amdinfer/observation/tracing.hpp"   // for Trace
+#include "amdinfer/pre_post/detection.hpp"    // for packDetections
+#include "amdinfer/util/parse_env.hpp"        // for autoExpandEnvironmentVa...
+#include "amdinfer/util/thread.hpp"           // for setThreadName
+#include "amdinfer/workers/video_stream.hpp"  // for runVideoPipeline
+#include "amdinfer/workers/worker.hpp"        // for Worker, kNumBufferAuto
 
 namespace AKS {  // NOLINT(readability-identifier-naming)
 class AIGraph;
@@ -89,6 +86,7 @@ class AksDetectStream : public Worker {
 
   AKS::SysManagerExt* sys_manager_ = nullptr;
   AKS::AIGraph* graph_ = nullptr;
+  VideoPipelineOptions options_;
 };
 
 std::thread AksDetectStream::spawn(BatchPtrQueue* input_queue) {
@@ -100,13 +98,13 @@ std::vector<MemoryAllocators> AksDetectStream::getAllocators() const {
 }
 
 void AksDetectStream::doInit(ParameterMap* parameters) {
-  (void)parameters;  // suppress unused variable warning
   constexpr auto kBatchSize = 4;
 
   /// Get AKS System Manager instance
   this->sys_manager_ = AKS::SysManagerExt::getGlobal();
 
   this->batch_size_ = kBatchSize;
+  this->options_ = parseVideoPipelineOptions(parameters);
 }
 
 constexpr auto kImageWidth = 1920;
@@ -142,6 +140,55 @@ void AksDetectStream::doRun(BatchPtrQueue* input_queue) {
   const auto& logger = this->getLogger();
 #endif
 
+  auto preprocess = [this](VideoBatch* batch) {
+    const auto& size = batch->frames[0].size();
+    batch->inputs.emplace_back(
+      std::make_unique<AKS::AksTensorBuffer>(xir::Tensor::create(
+        "AksDetect-stream",
+        {static_cast<int>(this->batch_size_), size.height, size.width,
+         kImageChannels},
+        xir::create_data_type<unsigned char>())));
+    auto* data = reinterpret_cast<uint8_t*>(batch->inputs[0]->data().first);
+    for (size_t i = 0; i < batch->frames.size(); i++) {
+      const auto& frame = batch->frames[i];
+      auto input_size = frame.step[0] * frame.rows;
+      memcpy(data + (i * input_size), frame.data, input_size);
+    }
+  };
+  auto infer = [this](TensorBuffers inputs) {
+    return this->sys_manager_
+      ->enqueueJob(this->graph_, "", std::move(inputs), nullptr)
+      .get();
+  };
+  auto postprocess = [this](VideoBatch* batch) {
+    const auto* top_k_data =
+      reinterpret_cast<float*>(batch->outputs[0]->data().first);
+    auto shape = batch->outputs[0]->get_tensor()->get_shape();
+    const auto detections = pre_post::packDetections(
+      top_k_data, static_cast<size_t>(shape[0]), this->batch_size_);
+    auto& labels = batch->labels;
+    labels.assign(this->batch_size_, "[");
+    for (size_t i = 0; i < this->batch_size_; ++i) {
+      auto& label = labels[i];
+      for (size_t j = 0; j < detections.count(i); ++j) {
+        const auto& box = detections.data(i)[j];
+        label.append(R"({"fill": false, "box": [)");
+        label.append(std::to_string(box.x) + ",");
+        label.append(std::to_string(box.y) + ",");
+        label.append(std::to_string(box.w) + ",");
+        label.append(std::to_string(box.h));
+        label.append(R"(], "label": ")");
+        label.append(std::to_string(box.class_id) + "\"},");
+      }
+    }
+    for (auto& label : labels) {
+      if (label.size() > 1) {
+        label.pop_back();  // trim trailing comma
+      }
+      label += "]";
+    }
+  };
+
   while (true) {
     BatchPtr batch;
     input_queue->wait_dequeue(batch);
@@ -150,14 +197,15 @@ void AksDetectStream::doRun(BatchPtrQueue* input_queue) {
     }
 
     AMDINFER_LOG_INFO(logger, "Got request in AksDetectStream");
+#ifdef AMDINFER_ENABLE_TRACING
+    batch->startSpan("aks_detect_stream");
+#endif
     for (unsigned int k = 0; k < batch->size(); k++) {
       const auto& req = batch->getRequest(static_cast<int>(k));
 #ifdef AMDINFER_ENABLE_TRACING
       const auto& trace = batch->getTrace(static_cast<int>(k));
-      trace->startSpan("aks_detect_stream");
 #endif
       auto inputs = req->getInputs();
-      auto outputs = req->getOutputs();
       auto key = req->getParameters().get<std::string>("key");
       for (auto& input : inputs) {
         auto* input_buffer = input.getData();
@@ -204,156 +252,41 @@ void AksDetectStream::doRun(BatchPtrQueue* input_queue) {
         resp.addOutput(output);
         req->runCallback(resp);
 
-        // round to nearest multiple of batch size
-        auto count_adjusted = count - (count % this->batch_size_);
-        std::queue<
-          std::future<std::vector<std::unique_ptr<vart::TensorBuffer>>>>
-          futures;
-        std::queue<std::string> frames;
-        for (unsigned int frame_num = 0; frame_num < count_adjusted;
-             frame_num += this->batch_size_) {
-          std::vector<std::unique_ptr<vart::TensorBuffer>> v;
-          v.reserve(1);
-
+        auto respond = [&](const std::string& image,
+                           const std::string& labels) {
+          InferenceResponse resp;
+          resp.setID(req->getID());
+          resp.setModel("invert_video");
+
+          InferenceResponseOutput output;
+          output.setName("image");
+          output.setDatatype(DataType::String);
+          auto message = constructMessage(key, image, labels);
+          std::vector<std::byte> buffer;
+          buffer.resize(message.size());
+          memcpy(buffer.data(), message.data(), message.size());
+          output.setData(std::move(buffer));
+          output.setShape({message.size()});
+          resp.addOutput(output);
+          req->runCallback(resp);
+        };
+
+        AMDINFER_LOG_INFO(logger, "Streaming " + std::to_string(count) +
+                                    " frames in " + key);
 #ifdef AMDINFER_ENABLE_TRACING
-          trace->startSpan("enqueue_batch");
+        trace->startSpan("video_pipeline");
 #endif
-
-          for (size_t i = 0; i < this->batch_size_; i++) {
-            cv::Mat frame;
-            cap >> frame;  // get the next frame from video
-            if (frame.empty()) {
-              i--;
-              continue;
-            }
-            if (i == 0) {
-              v.emplace_back(
-                std::make_unique<AKS::AksTensorBuffer>(xir::Tensor::create(
-                  "AksDetect-stream",
-                  {static_cast<int>(this->batch_size_), frame.size().height,
-                   frame.size().width, kImageChannels},
-                  xir::create_data_type<unsigned char>())));
-            }
-            // cv::resize(frame, frame, cv::Size(kImageWidth, kImageHeight));
-            auto input_size = frame.step[0] * frame.rows;
-            memcpy(
-              reinterpret_cast<uint8_t*>(v[0]->data().first) + (i * input_size),
-              frame.data, input_size);
-
-            std::vector<unsigned char> buf;
-            cv::imencode(".jpg", frame, buf);
-            const auto* enc_msg = reinterpret_cast<const char*>(buf.data());
-            std::string encoded = util::base64Encode(enc_msg, buf.size());
-            frames.push("data:image/jpg;base64," + encoded);
-          }
-          AMDINFER_LOG_INFO(logger, "Enqueuing in " + key);
-          futures.push(this->sys_manager_->enqueueJob(this->graph_, "",
-                                                      std::move(v), nullptr));
+        try {
+          const auto sampling = parseVideoSampling(input.getParameters(), fps);
+          runVideoPipeline(&cap, count, this->batch_size_, this->options_,
+                           sampling, preprocess, infer, postprocess, respond);
+        } catch (const std::exception& e) {
+          AMDINFER_LOG_ERROR(logger, e.what());
+          req->runCallbackError(e.what());
+        }
 #ifdef AMDINFER_ENABLE_TRACING
-          trace->endSpan();
+        trace->endSpan();
 #endif
-          auto status = futures.front().wait_for(std::chrono::seconds(0));
-          if (status == std::future_status::ready) {
-            std::vector<std::unique_ptr<vart::TensorBuffer>>
-              out_data_descriptor = futures.front().get();
-            futures.pop();
-            auto* top_k_data =
-              reinterpret_cast<float*>(out_data_descriptor[0]->data().first);
-            auto shape = out_data_descriptor[0]->get_tensor()->get_shape();
-            std::vector<std::string> labels;
-            labels.reserve(this->batch_size_);
-            for (unsigned int j = 0; j < this->batch_size_; j++) {
-              labels.emplace_back("[");
-            }
-            for (int i = 0; i < shape[0] * shape[1];
-                 i += kAkdDetectResponseSize) {
-              auto batch_id = static_cast<int>(top_k_data[i]);
-              const auto* detect_response =
-                reinterpret_cast<DetectResponse*>(&(top_k_data[i + 1]));
-
-              labels[batch_id].append(R"({"fill": false, "box": [)");
-              labels[batch_id].append(std::to_string(detect_response->x) + ",");
-              labels[batch_id].append(std::to_string(detect_response->y) + ",");
-              labels[batch_id].append(std::to_string(detect_response->w) + ",");
-              labels[batch_id].append(std::to_string(detect_response->h));
-              labels[batch_id].append(R"(], "label": ")");
-              labels[batch_id].append(
-                std::to_string(detect_response->class_id) + "\"},");
-            }
-            for (unsigned int j = 0; j < this->batch_size_; j++) {
-              if (labels[j].size() > 1) {
-                labels[j].pop_back();  // trim trailing comma
-              }
-              labels[j] += "]";
-              InferenceResponse resp;
-              resp.setID(req->getID());
-              resp.setModel("invert_video");
-
-              InferenceResponseOutput output;
-              output.setName("image");
-              output.setDatatype(DataType::String);
-              auto message = constructMessage(key, frames.front(), labels[j]);
-              std::vector<std::byte> buffer;
-              buffer.resize(message.size());
-              memcpy(buffer.data(), message.data(), message.size());
-              output.setData(std::move(buffer));
-              output.setShape({message.size()});
-              resp.addOutput(output);
-              req->runCallback(resp);
-              frames.pop();
-            }
-          }
-        }
-        while (!futures.empty()) {
-          std::vector<std::unique_ptr<vart::TensorBuffer>> out_data_descriptor =
-            futures.front().get();
-          AMDINFER_LOG_INFO(logger, "Got future with key " + key);
-          futures.pop();
-          auto* top_k_data =
-            reinterpret_cast<float*>(out_data_descriptor[0]->data().first);
-          auto shape = out_data_descriptor[0]->get_tensor()->get_shape();
-          std::vector<std::string> labels;
-          labels.reserve(this->batch_size_);
-          for (unsigned int j = 0; j < this->batch_size_; j++) {
-            labels.emplace_back("[");
-          }
-          for (int i = 0; i < shape[0] * shape[1];
-               i += kAkdDetectResponseSize) {
-            auto batch_id = static_cast<int>(top_k_data[i]);
-            const auto* detect_response =
-              reinterpret_cast<DetectResponse*>(&(top_k_data[i + 1]));
-
-            labels[batch_id].append(R"({"fill": false, "box": [)");
-            labels[batch_id].append(std::to_string(detect_response->x) + ",");
-            labels[batch_id].append(std::to_string(detect_response->y) + ",");
-            labels[batch_id].append(std::to_string(detect_response->w) + ",");
-            labels[batch_id].append(std::to_string(detect_response->h));
-            labels[batch_id].append(R"(], "label": ")");
-            labels[batch_id].append(std::to_string(detect_response->class_id) +
-                                    "\"},");
-          }
-          for (unsigned int j = 0; j < this->batch_size_; j++) {
-            if (labels[j].size() > 1) {
-              labels[j].pop_back();  // trim trailing comma
-            }
-            labels[j] += "]";
-            InferenceResponse resp;
-            resp.setID(req->getID());
-            resp.setModel("invert_video");
-
-            InferenceResponseOutput output;
-            output.setName("image");
-            output.setDatatype(DataType::String);
-            auto message = constructMessage(key, frames.front(), labels[j]);
-            buffer.resize(message.size());
-            memcpy(buffer.data(), message.data(), message.size());
-            output.setData(std::move(buffer));
-            output.setShape({message.size()});
-            resp.addOutput(output);
-            req->runCallback(resp);
-            frames.pop();
-          }
-        }
       }
     }
   }
@@ -370,7 +303,7 @@ void AksDetectStream::doDestroy() {}
 extern "C" {
 // using smart pointer here may cause problems inside shared object so managing
 // manually
-amdinfer::workers::Worker* getWorker() {
+amdinfer::workers::Worker* AMDINFER_WORKER_FACTORY() {
   return new amdinfer::workers::AksDetectStream("AksDetectStream", "AKS");
 }
 }  // extern C
@@ -0,0 +1,357 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the BatchWorker class, which runs the usual loop of a worker
+ * around a hook that computes whole batches
+ */
+
+#ifndef GUARD_AMDINFER_WORKERS_BATCH_WORKER
+#define GUARD_AMDINFER_WORKERS_BATCH_WORKER
+
+#include <cstddef>     // for size_t, byte
+#include <exception>   // for exception
+#include <functional>  // for function
+#include <memory>      // for shared_ptr, unique_ptr
+#include <ratio>       // for micro
+#include <string>      // for string
+#include <thread>      // for thread
+#include <utility>     // for move
+#include <vector>      // for vector
+
+#include "amdinfer/batching/batch.hpp"           // for Batch, BatchPtr
+#include "amdinfer/build_options.hpp"            // for AMDINFER_ENABLE_METRICS
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/core/tensor.hpp"              // for Tensor
+#include "amdinfer/observation/metrics.hpp"      // for Metrics
+#include "amdinfer/util/job_window.hpp"          // for JobWindow
+#include "amdinfer/util/queue.hpp"               // for BlockingQueue
+#include "amdinfer/util/thread.hpp"              // for setThreadName
+#include "amdinfer/util/timer.hpp"               // for Timer
+#include "amdinfer/workers/worker.hpp"           // for Worker
+
+namespace amdinfer::workers {
+
+/// An input tensor of a batch with the requests' data back to back
+struct InputSpan {
+  const std::byte* data;
+  /// the size of one request's tensor in bytes
+  size_t stride;
+};
+
+/// The inputs of a batch to compute
+struct BatchView {
+  Batch* batch;
+  /// the number of requests in the batch
+  size_t size;
+  /// one span per input tensor, in the order of the requests' inputs
+  std::vector<InputSpan> inputs;
+};
+
+/// An output tensor of a batch to write with the requests' data back to back
+struct OutputSpan {
+  std::byte* data;
+  /// the size of one request's tensor in bytes
+  size_t stride;
+};
+using OutputSpans = std::vector<OutputSpan>;
+
+/**
+ * @brief Workers can extend the BatchWorker instead of the Worker to only
+ * implement how a batch is computed. It takes batches from the queue, gives
+ * the hook contiguous views of each input tensor and output buffers from the
+ * memory pool, and then responds to the requests, sharing the output buffers
+ * with the responses instead of copying them. Metrics, tracing, errors and
+ * returning the buffers to the pool are handled here.
+ *
+ * Workers with asynchronous devices can override submit() to start a batch
+ * and return a function that waits for it. Up to the in-flight window of
+ * batches are then started while a completion thread waits for the earlier
+ * ones and responds to them in order.
+ */
+class BatchWorker : public Worker {
+ public:
+  using Worker::Worker;
+
+  /// A function that waits for a submitted batch to finish
+  using Completion = std::function<void()>;
+
+ protected:
+  /**
+   * @brief Compute a batch. An exception fails all of its requests
+   *
+   * @param batch the batch's inputs
+   * @param outputs one span per output tensor, in the order of
+   * getOutputTensors(), to write the outputs to
+   */
+  virtual void compute(const BatchView& batch, const OutputSpans& outputs) = 0;
+
+  /**
+   * @brief Start computing a batch. By default, the batch is computed right
+   * away. Workers that can overlap batches can start the batch and return a
+   * function that waits for it, which is called on the completion thread. The
+   * views and the outputs stay valid until it returns.
+   *
+   * @param batch the batch's inputs
+   * @param outputs one span per output tensor to write the outputs to
+   * @return Completion the function to wait for the batch with or nullptr if
+   * it's already done
+   */
+  virtual Completion submit(const BatchView& batch,
+                            const OutputSpans& outputs) {
+    this->compute(batch, outputs);
+    return nullptr;
+  }
+
+  /**
+   * @brief Get the output tensors of one request. By default, these are the
+   * outputs in the worker's metadata without the leading batch dimension.
+   *
+   * @return std::vector<Tensor>
+   */
+  [[nodiscard]] virtual std::vector<Tensor> getOutputTensors() const {
+    auto outputs = this->metadata_.getOutputs();
+    for (auto& output : outputs) {
+      auto shape = output.getShape();
+      if (shape.size() > 1 && shape[0] == this->batch_size_) {
+        shape.erase(shape.begin());
+        output.setShape(std::move(shape));
+      }
+    }
+    return outputs;
+  }
+
+  /**
+   * @brief Get the buffers that the worker uses when it's busy. The batcher
+   * fills a batch while the window of batches is in flight and each of those
+   * holds its output buffers.
+   *
+   * @return std::vector<BufferDemand>
+   */
+  [[nodiscard]] std::vector<BufferDemand> getBufferDemands() const override {
+    auto demands = Worker::getBufferDemands();
+    for (auto& demand : demands) {
+      demand.count = in_flight_ + 1;
+    }
+    const auto outputs = this->getOutputTensors();
+    for (auto batch_size : this->getBatchSizes()) {
+      for (const auto& output : outputs) {
+        demands.push_back(
+          {output, batch_size, in_flight_, {MemoryAllocators::Cpu}});
+      }
+    }
+    return demands;
+  }
+
+  /**
+   * @brief Set how many batches may be submitted and not finished yet. Workers
+   * call this before they're run
+   *
+   * @param batches the size of the window, which must be positive
+   */
+  void setInFlight(size_t batches) {
+    if (batches == 0) {
+      throw invalid_argument("The in-flight batches must be positive");
+    }
+    in_flight_ = batches;
+  }
+
+ private:
+  /// A batch that's been submitted and is waiting to be finished
+  struct Job {
+    BatchPtr batch;
+    BufferPtrs outputs;
+    OutputSpans spans;
+    Completion wait;
+  };
+
+  void doRun(BatchPtrQueue* input_queue) final {
+    util::setThreadName(this->metadata_.getName());
+    const auto outputs = this->getOutputTensors();
+
+    util::JobWindow window{in_flight_};
+    BlockingQueue<std::unique_ptr<Job>> completions;
+    std::thread completion_thread;
+    if (in_flight_ > 1) {
+      completion_thread = std::thread([&]() {
+        util::setThreadName("Completion");
+        while (true) {
+          std::unique_ptr<Job> job;
+          completions.wait_dequeue(job);
+          if (job == nullptr) {
+            break;
+          }
+          this->finish(job.get(), outputs);
+          window.release();
+        }
+      });
+    }
+
+    while (true) {
+      BatchPtr batch;
+      input_queue->wait_dequeue(batch);
+      if (batch == nullptr) {
+        break;
+      }
+#ifdef AMDINFER_ENABLE_METRICS
+      Metrics::getInstance().incrementCounter(
+        MetricCounterIDs::PipelineIngressWorker);
+#endif
+#ifdef AMDINFER_ENABLE_TRACING
+      batch->startSpan(this->metadata_.getName().c_str());
+#endif
+      window.acquire();
+      auto job = std::make_unique<Job>();
+      job->batch = std::move(batch);
+      try {
+        this->start(job.get(), outputs);
+      } catch (const std::exception& e) {
+        this->fail(job.get(), e.what());
+        window.release();
+        continue;
+      }
+      if (in_flight_ > 1) {
+        completions.enqueue(std::move(job));
+      } else {
+        this->finish(job.get(), outputs);
+        window.release();
+      }
+    }
+
+    if (completion_thread.joinable()) {
+      completions.enqueue(nullptr);
+      completion_thread.join();
+    }
+  }
+
+  /// Get the batch's views and output buffers and submit it
+  void start(Job* job, const std::vector<Tensor>& outputs) {
+    auto* batch = job->batch.get();
+    BatchView view{batch, batch->size(), {}};
+    const auto raw_inputs = batch->getRawInputBuffers();
+    const auto& request = batch->getRequest(0);
+    view.inputs.reserve(raw_inputs.size());
+    for (auto i = 0U; i < raw_inputs.size(); ++i) {
+      const auto& input = request->getInputs().at(i);
+      view.inputs.push_back(
+        {static_cast<const std::byte*>(raw_inputs[i]->data(0)),
+         input.getSize() * input.getDatatype().size()});
+    }
+
+    job->outputs.reserve(outputs.size());
+    job->spans.reserve(outputs.size());
+    for (const auto& tensor : outputs) {
+      auto& buffer = job->outputs.emplace_back(
+        pool_->get({MemoryAllocators::Cpu}, tensor, view.size));
+      job->spans.push_back({static_cast<std::byte*>(buffer->data(0)),
+                            tensor.getSize() * tensor.getDatatype().size()});
+    }
+    job->wait = this->submit(view, job->spans);
+  }
+
+  /// Wait for a submitted batch and respond to its requests
+  void finish(Job* job, const std::vector<Tensor>& outputs) {
+    if (job->wait != nullptr) {
+      try {
+        job->wait();
+      } catch (const std::exception& e) {
+        this->fail(job, e.what());
+        return;
+      }
+    }
+
+    // each output buffer is shared by the requests' outputs and goes back to
+    // the pool once the last response that uses it is destroyed
+    std::vector<std::shared_ptr<std::byte>> owners;
+    owners.reserve(job->outputs.size());
+    for (auto& buffer : job->outputs) {
+      auto* data = static_cast<std::byte*>(buffer->data(0));
+      owners.emplace_back(data, [pool = pool_, raw = buffer.release()](
+                                  std::byte*) {
+        pool->put(std::unique_ptr<Buffer>(raw));
+      });
+    }
+    job->outputs.clear();
+
+    auto& batch = job->batch;
+#ifdef AMDINFER_ENABLE_TRACING
+    batch->endSpan();
+#endif
+    for (auto j = 0U; j < batch->size(); ++j) {
+      const auto& req = batch->getRequest(j);
+      InferenceResponse resp;
+      resp.setID(req->getID());
+      resp.setModel(this->metadata_.getName());
+      const auto& inputs = req->getInputs();
+      const auto& requested = req->getOutputs();
+      for (auto i = 0U; i < outputs.size(); ++i) {
+        const auto stride = job->spans[i].stride;
+        InferenceResponseOutput output;
+        // outputs take the names the request asks for or its first input's
+        std::string name;
+        if (i < requested.size()) {
+          name = requested[i].getName();
+        }
+        output.setName(name.empty() ? inputs.at(0).getName() : name);
+        output.setDatatype(outputs[i].getDatatype());
+        output.setShape(outputs[i].getShape());
+        output.setData(
+          std::shared_ptr<std::byte>(owners[i], owners[i].get() + j * stride),
+          stride);
+        resp.addOutput(output);
+      }
+
+#ifdef AMDINFER_ENABLE_TRACING
+      const auto& trace = batch->getTrace(j);
+      auto context = trace->propagate();
+      resp.setContext(std::move(context));
+#endif
+
+      req->runCallbackOnce(resp);
+#ifdef AMDINFER_ENABLE_METRICS
+      Metrics::getInstance().incrementCounter(
+        MetricCounterIDs::PipelineEgressWorker);
+      util::Timer timer{batch->getTime(j)};
+      timer.stop();
+      auto duration = timer.count<std::micro>();
+      Metrics::getInstance().observeSummary(MetricSummaryIDs::RequestLatency,
+                                            duration);
+#endif
+    }
+    this->returnInputBuffers(std::move(batch));
+  }
+
+  /// Fail all the requests of a batch and return its buffers to the pool
+  void fail(Job* job, const std::string& error) {
+#ifdef AMDINFER_ENABLE_LOGGING
+    const auto& logger = this->getLogger();
+#endif
+    AMDINFER_LOG_ERROR(logger, error);
+    for (const auto& req : *job->batch) {
+      req->runCallbackError(error);
+    }
+    for (auto& buffer : job->outputs) {
+      pool_->put(std::move(buffer));
+    }
+    job->outputs.clear();
+    this->returnInputBuffers(std::move(job->batch));
+  }
+
+  size_t in_flight_ = 1;
+};
+
+}  // namespace amdinfer::workers
+
+#endif  // GUARD_AMDINFER_WORKERS_BATCH_WORKER
@@ -34,9 +34,11 @@
 #include "amdinfer/batching/hard.hpp"    // for HardBatcher
 #include "amdinfer/build_options.hpp"    // for AMDINFER_ENABLE_TRACING
 #include "amdinfer/core/data_types.hpp"  // for DataType, DataType::Uint32
+#include "amdinfer/core/model_abi.h"     // for AmdinferBatch, AmdinferSpan
 #include "amdinfer/core/inference_request.hpp"  // for InferenceRequest, Infe...
 #include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
 #include "amdinfer/core/parameters.hpp"          // for ParameterMap
+#include "amdinfer/core/requested_outputs.hpp"   // for selectOutputs
 #include "amdinfer/declarations.hpp"         // for BufferPtr, InferenceRes...
 #include "amdinfer/observation/logging.hpp"  // for Logger
 #include "amdinfer/observation/metrics.hpp"  // for Metrics
@@ -87,6 +89,14 @@ void* openModel(const std::string& so_path) {
   return handle;
 }
 
+// the ABI's datatypes are passed to the server as they are
+static_assert(static_cast<int>(AMDINFER_BOOL) == DataType::Bool);
+static_assert(static_cast<int>(AMDINFER_UINT32) == DataType::Uint32);
+static_assert(static_cast<int>(AMDINFER_FP16) == DataType::Fp16);
+static_assert(static_cast<int>(AMDINFER_STRING) == DataType::String);
+static_assert(static_cast<int>(AMDINFER_BF16) == DataType::Bf16);
+static_assert(static_cast<int>(AMDINFER_BYTES) == DataType::Bytes);
+
 void* getFunction(void* handle, const std::string& function) {
   /* find the address of function  */
   void* fptr = dlsym(handle, function.c_str());
@@ -116,9 +126,15 @@ class CPlusPlus : public Worker {
   void doRelease() override;
   void doDestroy() override;
 
+  /// Run a batch with a model that uses the C ABI and respond to it
+  void runBatch(BatchPtr batch);
+
   void* handle_;
   std::vector<Tensor> input_tensors_;
   std::vector<Tensor> output_tensors_;
+  /// the model's run function if it uses the C ABI of model_abi.h
+  int32_t (*run_batch_)(AmdinferBatch*) = nullptr;
+  int32_t threads_ = 1;
 
   // workers define what batcher implementation should be used for them.
   // if not explicitly defined here, a default value is used from worker.hpp.
@@ -140,33 +156,31 @@ std::vector<MemoryAllocators> CPlusPlus::getAllocators() const {
 
 void respond(Batch* batch) {
   const auto batch_size = batch->size();
+#ifdef AMDINFER_ENABLE_TRACING
+  batch->startSpan("response");
+#endif
   for (unsigned int j = 0; j < batch_size; j++) {
     const auto& req = batch->getRequest(j);
 #ifdef AMDINFER_ENABLE_TRACING
     const auto& trace = batch->getTrace(j);
-    trace->startSpan("response");
 #endif
     InferenceResponse resp;
     resp.setID(req->getID());
     resp.setModel("CPlusPlus");
-    auto inputs = req->getInputs();
-    auto outputs = req->getOutputs();
-    for (unsigned int i = 0; i < inputs.size(); i++) {
+    const auto& inputs = req->getInputs();
+    std::vector<std::string> names;
+    names.reserve(inputs.size());
+    for (const auto& input : inputs) {
+      names.push_back(input.getName());
+    }
+    const auto selected = selectOutputs(*req, names, inputs.size(), "");
+    for (const auto& [i, name] : selected) {
       const auto& input = inputs[i];
       const auto* input_buffer = input.getData();
 
       InferenceResponseOutput output;
       output.setDatatype(DataType::Uint32);
-      std::string output_name;
-      if (i < outputs.size()) {
-        output_name = outputs[i].getName();
-      }
-
-      if (output_name.empty()) {
-        output.setName(input.getName());
-      } else {
-        output.setName(output_name);
-      }
+      output.setName(name);
       output.setShape(input.getShape());
       std::vector<std::byte> buffer;
       const auto size = input.getSize() * input.getDatatype().size();
@@ -214,7 +228,67 @@ void CPlusPlus::doInit(ParameterMap* parameters) {
   handle_ = openModel("lib" + model + "_model.so");
 }
 
-void CPlusPlus::doAcquire([[maybe_unused]] ParameterMap* parameters) {
+/// Convert the tensors that a model using the C ABI describes
+std::vector<Tensor> toTensors(const AmdinferTensorInfo* infos, size_t count) {
+  std::vector<Tensor> tensors;
+  tensors.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    const auto& info = infos[i];
+    if (info.datatype > AMDINFER_BYTES) {
+      throw invalid_argument("Tensor " + std::string{info.name} +
+                             " has an unknown datatype");
+    }
+    tensors.emplace_back(
+      info.name, std::vector<uint64_t>{info.shape, info.shape + info.rank},
+      DataType{static_cast<DataType::Value>(info.datatype)});
+  }
+  return tensors;
+}
+
+void CPlusPlus::doAcquire(ParameterMap* parameters) {
+  // models that export the C ABI get whole batches
+  if (auto* version_ptr = dlsym(handle_, "amdinferModelAbiVersion");
+      version_ptr != nullptr) {
+    auto* getVersion = reinterpret_cast<uint32_t (*)()>(version_ptr);
+    const auto version = getVersion();
+    if (version != AMDINFER_MODEL_ABI_VERSION) {
+      throw invalid_argument("The model uses version " +
+                             std::to_string(version) +
+                             " of the ABI but the server needs " +
+                             std::to_string(AMDINFER_MODEL_ABI_VERSION));
+    }
+    using GetTensors = size_t (*)(const AmdinferTensorInfo**);
+    const AmdinferTensorInfo* infos = nullptr;
+    auto* getInputs = reinterpret_cast<GetTensors>(
+      getFunction(handle_, "amdinferModelInputs"));
+    auto count = getInputs(&infos);
+    input_tensors_ = toTensors(infos, count);
+    auto* getOutputs = reinterpret_cast<GetTensors>(
+      getFunction(handle_, "amdinferModelOutputs"));
+    count = getOutputs(&infos);
+    output_tensors_ = toTensors(infos, count);
+    run_batch_ = reinterpret_cast<int32_t (*)(AmdinferBatch*)>(
+      getFunction(handle_, "amdinferModelRun"));
+
+    for (const auto& tensor : input_tensors_) {
+      metadata_.addInputTensor(tensor);
+    }
+    for (const auto& tensor : output_tensors_) {
+      metadata_.addOutputTensor(tensor);
+    }
+
+    // by default, the model may use all the CPUs the worker may run on
+    const auto cpus = cpus_.empty() ? util::getAllowedCpus() : cpus_;
+    threads_ = static_cast<int32_t>(cpus.size());
+    if (parameters->has("threads")) {
+      threads_ = parameters->get<int32_t>("threads");
+      if (threads_ <= 0) {
+        throw invalid_argument("The number of threads must be positive");
+      }
+    }
+    return;
+  }
+
   auto* input_ptr = getFunction(handle_, "getInputs");
   auto* getInputs =
     reinterpret_cast<std::vector<amdinfer::Tensor> (*)()>(input_ptr);
@@ -249,6 +323,10 @@ void CPlusPlus::doRun(BatchPtrQueue* input_queue) {
     Metrics::getInstance().incrementCounter(
       MetricCounterIDs::PipelineIngressWorker);
 #endif
+    if (run_batch_ != nullptr) {
+      this->runBatch(std::move(batch));
+      continue;
+    }
 
     auto new_batch = std::make_unique<Batch>();
     if (!(input_tensors_.empty() || output_tensors_.empty())) {
@@ -292,6 +370,122 @@ void CPlusPlus::doRun(BatchPtrQueue* input_queue) {
   AMDINFER_LOG_INFO(logger, "CPlusPlus ending");
 }
 
+void CPlusPlus::runBatch(BatchPtr batch) {
+  const auto batch_size = batch->size();
+  auto fail = [&batch](const std::string& error) {
+    for (const auto& req : *batch) {
+      req->runCallbackError(error);
+    }
+  };
+
+  auto raw_inputs = batch->getRawInputBuffers();
+  if (raw_inputs.size() != input_tensors_.size()) {
+    fail("The model takes " + std::to_string(input_tensors_.size()) +
+         " input tensors");
+    this->returnInputBuffers(std::move(batch));
+    return;
+  }
+  std::vector<AmdinferSpan> inputs;
+  inputs.reserve(raw_inputs.size());
+  for (auto i = 0U; i < raw_inputs.size(); ++i) {
+    const auto& tensor = input_tensors_[i];
+    inputs.push_back({raw_inputs[i]->data(0),
+                      tensor.getSize() * tensor.getDatatype().size()});
+  }
+
+  // the model writes its outputs straight into the buffers that back the
+  // responses
+  BufferPtrs output_buffers;
+  std::vector<AmdinferSpan> outputs;
+  output_buffers.reserve(output_tensors_.size());
+  outputs.reserve(output_tensors_.size());
+  for (const auto& tensor : output_tensors_) {
+    auto& buffer = output_buffers.emplace_back(
+      pool_->get({MemoryAllocators::Cpu}, tensor, batch_size));
+    outputs.push_back(
+      {buffer->data(0), tensor.getSize() * tensor.getDatatype().size()});
+  }
+
+#ifdef AMDINFER_ENABLE_TRACING
+  batch->startSpan("CPlusPlus");
+#endif
+  AmdinferBatch model_batch{batch_size,     inputs.data(),  inputs.size(),
+                            outputs.data(), outputs.size(), threads_,
+                            nullptr};
+  const auto status = run_batch_(&model_batch);
+#ifdef AMDINFER_ENABLE_TRACING
+  batch->endSpan();
+#endif
+  if (status != 0) {
+    fail(model_batch.error != nullptr
+           ? std::string{model_batch.error}
+           : "The model failed with status " + std::to_string(status));
+    for (auto& buffer : output_buffers) {
+      pool_->put(std::move(buffer));
+    }
+    this->returnInputBuffers(std::move(batch));
+    return;
+  }
+
+  // each output buffer is shared by the requests' outputs and goes back to the
+  // pool once the last response that uses it is destroyed
+  std::vector<std::shared_ptr<std::byte>> owners;
+  owners.reserve(output_buffers.size());
+  for (auto& buffer : output_buffers) {
+    auto* data = static_cast<std::byte*>(buffer->data(0));
+    owners.emplace_back(data, [pool = pool_, raw = buffer.release()](
+                                std::byte*) {
+      pool->put(std::unique_ptr<Buffer>(raw));
+    });
+  }
+
+  std::vector<std::string> names;
+  names.reserve(output_tensors_.size());
+  for (const auto& tensor : output_tensors_) {
+    names.push_back(tensor.getName());
+  }
+
+  for (auto j = 0U; j < batch_size; ++j) {
+    const auto& req = batch->getRequest(j);
+    InferenceResponse resp;
+    resp.setID(req->getID());
+    resp.setModel("CPlusPlus");
+    // the model computes all its outputs but only the requested ones are
+    // referenced by the response
+    const auto selected =
+      selectOutputs(*req, names, output_tensors_.size(), "");
+    for (const auto& [i, name] : selected) {
+      const auto& tensor = output_tensors_[i];
+      const auto stride = outputs[i].stride;
+      InferenceResponseOutput output;
+      output.setName(name);
+      output.setDatatype(tensor.getDatatype());
+      output.setShape(tensor.getShape());
+      output.setData(std::shared_ptr<std::byte>(owners[i],
+                                                owners[i].get() + j * stride),
+                     stride);
+      resp.addOutput(output);
+    }
+
+#ifdef AMDINFER_ENABLE_TRACING
+    auto context = batch->getTrace(j)->propagate();
+    resp.setContext(std::move(context));
+#endif
+
+    req->runCallbackOnce(resp);
+#ifdef AMDINFER_ENABLE_METRICS
+    Metrics::getInstance().incrementCounter(
+      MetricCounterIDs::PipelineEgressWorker);
+    util::Timer timer{batch->getTime(j)};
+    timer.stop();
+    auto duration = timer.count<std::micro>();
+    Metrics::getInstance().observeSummary(MetricSummaryIDs::RequestLatency,
+                                          duration);
+#endif
+  }
+  this->returnInputBuffers(std::move(batch));
+}
+
 void CPlusPlus::doRelease() {}
 void CPlusPlus::doDestroy() { dlclose(handle_); }
 
@@ -302,7 +496,7 @@ void CPlusPlus::doDestroy() { dlclose(handle_); }
 extern "C" {
 // using smart pointer here may cause problems inside shared object so managing
 // manually
-amdinfer::workers::Worker* getWorker() {
+amdinfer::workers::Worker* AMDINFER_WORKER_FACTORY() {
   return new amdinfer::workers::CPlusPlus("cPlusPlus", "cpu");
 }
 }  // extern C
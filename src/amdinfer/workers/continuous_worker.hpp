@@ -0,0 +1,303 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the ContinuousWorker class, which runs batches of requests
+ * one step at a time so requests can join and leave between steps
+ */
+
+#ifndef GUARD_AMDINFER_WORKERS_CONTINUOUS_WORKER
+#define GUARD_AMDINFER_WORKERS_CONTINUOUS_WORKER
+
+#include <algorithm>  // for max, remove_if
+#include <cstddef>    // for size_t, byte
+#include <deque>      // for deque
+#include <exception>  // for exception
+#include <memory>     // for shared_ptr, unique_ptr
+#include <ratio>      // for micro
+#include <string>     // for string
+#include <utility>    // for move
+#include <vector>     // for vector
+
+#include "amdinfer/batching/batch.hpp"           // for Batch, BatchPtr
+#include "amdinfer/build_options.hpp"            // for AMDINFER_ENABLE_METRICS
+#include "amdinfer/core/exceptions.hpp"          // for invalid_argument
+#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/core/parameters.hpp"          // for ParameterMap
+#include "amdinfer/observation/metrics.hpp"      // for Metrics
+#include "amdinfer/observation/tracing.hpp"      // for TracePtr
+#include "amdinfer/util/thread.hpp"              // for setThreadName
+#include "amdinfer/util/timer.hpp"               // for Timer
+#include "amdinfer/workers/worker.hpp"           // for Worker
+
+namespace amdinfer::workers {
+
+/// A request that a ContinuousWorker runs one step at a time
+struct Generation {
+  InferenceRequestPtr request;
+  /// the number of steps that have been run for the request before this one
+  size_t steps = 0;
+  /// the outputs of the current step, which the worker sets
+  std::vector<InferenceResponseOutput> outputs;
+  /// set by the worker once the current step is the request's last
+  bool done = false;
+  /// anything the worker keeps for the request between steps
+  std::shared_ptr<void> state;
+};
+
+/**
+ * @brief Workers for autoregressive models can extend the ContinuousWorker to
+ * schedule at the level of iterations instead of batches. The worker runs one
+ * step of all the running requests at a time. At each step boundary, finished
+ * requests leave and new requests from the batch queue join, up to the batch
+ * size, so the device stays busy when the requests need a different number of
+ * steps. The batcher passes requests on without waiting to fill a batch since
+ * they join at the next step anyway.
+ *
+ * Requests with the "stream" parameter set to true get a response for each
+ * step, with its outputs and the "final" parameter set on the last, which the
+ * gRPC stream and the websocket send as they come. Other requests get one
+ * response at the end with the outputs of all their steps joined along the
+ * first dimension.
+ */
+class ContinuousWorker : public Worker {
+ public:
+  using Worker::Worker;
+
+  using Worker::makeBatcher;
+  std::vector<std::unique_ptr<Batcher>> makeBatcher(
+    int num, ParameterMap* parameters, MemoryPool* pool) override {
+    if (parameters != nullptr && !parameters->has("timeout")) {
+      parameters->put("timeout", 0);
+    }
+    return Worker::makeBatcher(num, parameters, pool);
+  }
+
+ protected:
+  /**
+   * @brief Run one step of each running request. The worker sets the outputs
+   * of each request's step and marks the requests that are done. An exception
+   * fails all of them.
+   *
+   * @param generations the running requests
+   */
+  virtual void step(const std::vector<Generation*>& generations) = 0;
+
+ private:
+  /// A running request and what it needs to respond
+  struct Running {
+    Generation generation;
+    bool stream = false;
+    /// the batch that the request came in, shared by its requests so their
+    /// inputs stay valid until the last one is done
+    std::shared_ptr<Batch> batch;
+    /// the outputs of the previous steps if the request isn't streamed
+    std::vector<InferenceResponseOutput> outputs;
+    std::vector<std::vector<std::byte>> data;
+#ifdef AMDINFER_ENABLE_TRACING
+    TracePtr trace;
+#endif
+#ifdef AMDINFER_ENABLE_METRICS
+    util::TimePoint start_time;
+#endif
+  };
+  using RunningPtr = std::unique_ptr<Running>;
+
+  void doRun(BatchPtrQueue* input_queue) final {
+    util::setThreadName(this->metadata_.getName());
+    const auto capacity = std::max<size_t>(this->batch_size_, 1);
+
+    std::deque<RunningPtr> waiting;
+    std::vector<RunningPtr> running;
+    bool run = true;
+    while (true) {
+      // new requests join at the step boundary if there's room for them
+      while (run && waiting.size() + running.size() < capacity) {
+        BatchPtr batch;
+        if (running.empty() && waiting.empty()) {
+          input_queue->wait_dequeue(batch);
+        } else if (!input_queue->try_dequeue(batch)) {
+          break;
+        }
+        if (batch == nullptr) {
+          run = false;
+          break;
+        }
+        this->admit(std::move(batch), &waiting);
+      }
+      while (!waiting.empty() && running.size() < capacity) {
+        running.push_back(std::move(waiting.front()));
+        waiting.pop_front();
+      }
+      if (running.empty()) {
+        if (!run) {
+          break;
+        }
+        continue;
+      }
+
+      std::vector<Generation*> generations;
+      generations.reserve(running.size());
+      for (auto& request : running) {
+        request->generation.outputs.clear();
+        request->generation.done = false;
+        generations.push_back(&request->generation);
+      }
+      try {
+        this->step(generations);
+      } catch (const std::exception& e) {
+#ifdef AMDINFER_ENABLE_LOGGING
+        const auto& logger = this->getLogger();
+#endif
+        AMDINFER_LOG_ERROR(logger, e.what());
+        for (const auto& request : running) {
+          request->generation.request->runCallbackError(e.what());
+        }
+        running.clear();
+        continue;
+      }
+
+      // finished requests leave so others can take their place
+      running.erase(std::remove_if(running.begin(), running.end(),
+                                   [this](const RunningPtr& request) {
+                                     return this->respond(request.get());
+                                   }),
+                    running.end());
+    }
+  }
+
+  /// Split a batch into requests that can run on their own
+  void admit(BatchPtr batch, std::deque<RunningPtr>* waiting) {
+#ifdef AMDINFER_ENABLE_METRICS
+    Metrics::getInstance().incrementCounter(
+      MetricCounterIDs::PipelineIngressWorker);
+#endif
+    std::shared_ptr<Batch> owner{batch.release(), [this](Batch* released) {
+                                   this->returnInputBuffers(
+                                     std::unique_ptr<Batch>(released));
+                                 }};
+    for (auto j = 0U; j < owner->size(); ++j) {
+      auto request = std::make_unique<Running>();
+      request->generation.request = owner->getRequest(j);
+      const auto& parameters = request->generation.request->getParameters();
+      request->stream =
+        parameters.has("stream") && parameters.get<bool>("stream");
+      request->batch = owner;
+#ifdef AMDINFER_ENABLE_TRACING
+      request->trace = std::move(owner->getTrace(j));
+      request->trace->startSpan(this->metadata_.getName().c_str());
+#endif
+#ifdef AMDINFER_ENABLE_METRICS
+      request->start_time = owner->getTime(j);
+#endif
+      waiting->push_back(std::move(request));
+    }
+  }
+
+  /// Respond to a request's step and return true if it's done
+  bool respond(Running* request) {
+    auto& generation = request->generation;
+    generation.steps++;
+    const auto& req = generation.request;
+    if (!request->stream) {
+      try {
+        accumulate(request);
+      } catch (const invalid_argument& e) {
+        req->runCallbackError(e.what());
+        return true;
+      }
+      if (!generation.done) {
+        return false;
+      }
+    }
+
+    InferenceResponse resp;
+    resp.setID(req->getID());
+    resp.setModel(this->metadata_.getName());
+    auto& outputs = request->stream ? generation.outputs : request->outputs;
+    for (auto i = 0U; i < outputs.size(); ++i) {
+      if (!request->stream) {
+        outputs[i].setData(std::move(request->data[i]));
+      }
+      resp.addOutput(std::move(outputs[i]));
+    }
+    if (request->stream) {
+      ParameterMap parameters;
+      parameters.put("final", generation.done);
+      resp.setParameters(std::move(parameters));
+    }
+    if (!generation.done) {
+      req->runCallback(resp);
+      return false;
+    }
+
+#ifdef AMDINFER_ENABLE_TRACING
+    auto context = request->trace->propagate();
+    resp.setContext(std::move(context));
+#endif
+    req->runCallbackOnce(resp);
+#ifdef AMDINFER_ENABLE_METRICS
+    Metrics::getInstance().incrementCounter(
+      MetricCounterIDs::PipelineEgressWorker);
+    util::Timer timer{request->start_time};
+    timer.stop();
+    auto duration = timer.count<std::micro>();
+    Metrics::getInstance().observeSummary(MetricSummaryIDs::RequestLatency,
+                                          duration);
+#endif
+    return true;
+  }
+
+  /// Add a step's outputs to those of the request's previous steps
+  static void accumulate(Running* request) {
+    auto& outputs = request->generation.outputs;
+    if (request->generation.steps == 1) {
+      request->data.resize(outputs.size());
+      for (const auto& output : outputs) {
+        auto& joined = request->outputs.emplace_back();
+        joined.setName(output.getName());
+        joined.setDatatype(output.getDatatype());
+        joined.setShape({0});
+      }
+    }
+    if (outputs.size() != request->outputs.size()) {
+      throw invalid_argument("Each step must have the same outputs");
+    }
+    for (auto i = 0U; i < outputs.size(); ++i) {
+      const auto& output = outputs[i];
+      auto& joined = request->outputs[i];
+      auto shape = output.getShape();
+      if (shape.empty()) {
+        shape.push_back(1);
+      }
+      auto joined_shape = joined.getShape();
+      if (joined_shape.size() == 1 && shape.size() > 1) {
+        joined_shape.insert(joined_shape.end(), shape.begin() + 1,
+                            shape.end());
+      }
+      joined_shape[0] += shape[0];
+      joined.setShape(std::move(joined_shape));
+
+      const auto* data = static_cast<const std::byte*>(output.getData());
+      const auto size = output.getSize() * output.getDatatype().size();
+      request->data[i].insert(request->data[i].end(), data, data + size);
+    }
+  }
+};
+
+}  // namespace amdinfer::workers
+
+#endif  // GUARD_AMDINFER_WORKERS_CONTINUOUS_WORKER
@@ -115,12 +115,14 @@ void Echo::doRun(BatchPtrQueue* input_queue) {
 #ifdef AMDINFER_ENABLE_METRICS
     Metrics::getInstance().incrementCounter(
       MetricCounterIDs::PipelineIngressWorker);
+#endif
+#ifdef AMDINFER_ENABLE_TRACING
+    batch->startSpan("echo");
 #endif
     for (unsigned int j = 0; j < batch->size(); j++) {
       const auto& req = batch->getRequest(j);
 #ifdef AMDINFER_ENABLE_TRACING
       const auto& trace = batch->getTrace(j);
-      trace->startSpan("echo");
 #endif
       InferenceResponse resp;
       resp.setID(req->getID());
@@ -160,10 +162,8 @@ void Echo::doRun(BatchPtrQueue* input_queue) {
           output.setName(output_name);
         }
         output.setShape({1});
-        std::vector<std::byte> buffer;
-        buffer.resize(sizeof(uint32_t));
-        memcpy(buffer.data(), &value, sizeof(uint32_t));
-        output.setData(std::move(buffer));
+        auto* buffer = this->allocateOutput(&output);
+        memcpy(buffer, &value, sizeof(uint32_t));
         resp.addOutput(output);
       }
 
@@ -197,7 +197,7 @@ void Echo::doDestroy() {}
 extern "C" {
 // using smart pointer here may cause problems inside shared object so managing
 // manually
-amdinfer::workers::Worker* getWorker() {
+amdinfer::workers::Worker* AMDINFER_WORKER_FACTORY() {
   return new amdinfer::workers::Echo("echo", "cpu");
 }
 }  // extern C
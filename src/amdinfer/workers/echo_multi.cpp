@@ -17,33 +17,21 @@
  * @brief Implements the EchoMulti worker
  */
 
-#include <array>    // for array
-#include <cassert>  // for assert
-#include <cstddef>  // for size_t, byte
-#include <cstdint>  // for uint32_t, int32_t
-#include <cstring>  // for memcpy
-#include <memory>   // for unique_ptr, allocator
-#include <ratio>    // for micro
-#include <string>   // for string
-#include <thread>   // for thread
-#include <utility>  // for move
-#include <vector>   // for vector
-
-#include "amdinfer/batching/hard.hpp"    // for HardBatcher
-#include "amdinfer/build_options.hpp"    // for AMDINFER_ENABLE_TRACING
-#include "amdinfer/core/data_types.hpp"  // for DataType, DataType::Uint32
-#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
-#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
-#include "amdinfer/core/parameters.hpp"          // for ParameterMap
-#include "amdinfer/declarations.hpp"         // for BufferPtr, InferenceRes...
-#include "amdinfer/observation/logging.hpp"  // for Logger
-#include "amdinfer/observation/metrics.hpp"  // for Metrics
-#include "amdinfer/observation/tracing.hpp"  // for startFollowSpan, SpanPtr
-#include "amdinfer/util/containers.hpp"      // for containerSum
-#include "amdinfer/util/queue.hpp"           // for BufferPtrsQueue
-#include "amdinfer/util/thread.hpp"          // for setThreadName
-#include "amdinfer/util/timer.hpp"           // for Timer
-#include "amdinfer/workers/worker.hpp"       // for Worker
+#include <algorithm>  // for copy_n
+#include <array>      // for array
+#include <cstddef>    // for size_t
+#include <cstdint>    // for uint32_t, int32_t
+#include <memory>     // for unique_ptr, allocator
+#include <string>     // for string
+#include <thread>     // for thread
+#include <vector>     // for vector
+
+#include "amdinfer/batching/hard.hpp"         // for HardBatcher
+#include "amdinfer/core/data_types.hpp"       // for DataType, DataType::Uint32
+#include "amdinfer/core/parameters.hpp"       // for ParameterMap
+#include "amdinfer/util/containers.hpp"       // for containerSum
+#include "amdinfer/workers/batch_worker.hpp"  // for BatchWorker, BatchView
+#include "amdinfer/workers/worker.hpp"        // for Worker
 
 namespace amdinfer {
 
@@ -59,16 +47,16 @@ namespace workers {
  * and produces 3 output tensors as a test case for multi-input/output models.
  *
  */
-class EchoMulti : public Worker {
+class EchoMulti : public BatchWorker {
  public:
-  using Worker::Worker;
+  using BatchWorker::BatchWorker;
   std::thread spawn(BatchPtrQueue* input_queue) override;
   [[nodiscard]] std::vector<MemoryAllocators> getAllocators() const override;
 
  private:
   void doInit(ParameterMap* parameters) override;
   void doAcquire(ParameterMap* parameters) override;
-  void doRun(BatchPtrQueue* input_queue) override;
+  void compute(const BatchView& batch, const OutputSpans& outputs) override;
   void doRelease() override;
   void doDestroy() override;
 
@@ -113,99 +101,29 @@ void EchoMulti::doAcquire([[maybe_unused]] ParameterMap* parameters) {
   }
 }
 
-void EchoMulti::doRun(BatchPtrQueue* input_queue) {
-  util::setThreadName("EchoMulti");
-#ifdef AMDINFER_ENABLE_LOGGING
-  const auto& logger = this->getLogger();
-#endif
-
-  while (true) {
-    BatchPtr batch;
-    input_queue->wait_dequeue(batch);
-    if (batch == nullptr) {
-      break;
+void EchoMulti::compute(const BatchView& batch, const OutputSpans& outputs) {
+  // each request's outputs repeat its inputs, in order
+  const auto input_num = util::containerSum(kInputLengths);
+  std::vector<uint32_t> args(input_num);
+  for (size_t j = 0; j < batch.size; j++) {
+    auto arg = args.begin();
+    for (auto i = 0; i < kInputTensors; ++i) {
+      const auto& input = batch.inputs.at(i);
+      const auto* data =
+        reinterpret_cast<const uint32_t*>(input.data + j * input.stride);
+      arg = std::copy_n(data, kInputLengths.at(i), arg);
     }
-    AMDINFER_LOG_INFO(logger, "Got request in echoMulti");
-#ifdef AMDINFER_ENABLE_METRICS
-    Metrics::getInstance().incrementCounter(
-      MetricCounterIDs::PipelineIngressWorker);
-#endif
-    const auto batch_size = batch->size();
-    for (unsigned int j = 0; j < batch_size; j++) {
-      const auto& req = batch->getRequest(static_cast<int>(j));
-#ifdef AMDINFER_ENABLE_TRACING
-      const auto& trace = batch->getTrace(static_cast<int>(j));
-      trace->startSpan("echoMulti");
-#endif
-      InferenceResponse resp;
-      resp.setID(req->getID());
-      resp.setModel("echoMulti");
-      auto inputs = req->getInputs();
-      auto outputs = req->getOutputs();
-
-      std::vector<int> args;
-      const auto input_num = util::containerSum(kInputLengths);
-      assert(input_num != 0);
-      args.reserve(input_num);
-      for (auto i = 0; i < kInputTensors; ++i) {
-        const auto* input_buffer = static_cast<uint32_t*>(inputs[i].getData());
-        for (auto k = 0; k < kInputLengths.at(i); ++k) {
-          args.push_back(input_buffer[k]);
-        }
-      }
 
-      std::vector<int> output_args;
-      auto input_index = 0;
-      auto offset = 0;
-      output_args.reserve(util::containerSum(kOutputLengths));
-      for (auto i = 0; i < kOutputTensors; ++i) {
-        for (auto k = 0; k < kOutputLengths.at(i); ++k) {
-          output_args.push_back(args[input_index]);
-          input_index = (input_index + 1) % input_num;
-        }
-
-        InferenceResponseOutput output;
-        output.setDatatype(DataType::Uint32);
-        std::string output_name;
-        if (static_cast<size_t>(i) < outputs.size()) {
-          output_name = outputs[i].getName();
-        }
-
-        if (output_name.empty()) {
-          output.setName(inputs[0].getName());
-        } else {
-          output.setName(output_name);
-        }
-        output.setShape({static_cast<uint64_t>(kOutputLengths.at(i))});
-        std::vector<std::byte> buffer;
-        buffer.resize(kOutputLengths.at(i) * sizeof(uint32_t));
-        memcpy(buffer.data(), &(output_args[offset]),
-               kOutputLengths.at(i) * sizeof(uint32_t));
-        output.setData(std::move(buffer));
-        resp.addOutput(output);
-        offset += kOutputLengths.at(i);
+    auto input_index = 0;
+    for (auto i = 0; i < kOutputTensors; ++i) {
+      const auto& output = outputs.at(i);
+      auto* data = reinterpret_cast<uint32_t*>(output.data + j * output.stride);
+      for (auto k = 0; k < kOutputLengths.at(i); ++k) {
+        data[k] = args[input_index];
+        input_index = (input_index + 1) % input_num;
       }
-
-#ifdef AMDINFER_ENABLE_TRACING
-      auto context = trace->propagate();
-      resp.setContext(std::move(context));
-#endif
-
-      // respond back to the client
-      req->runCallbackOnce(resp);
-#ifdef AMDINFER_ENABLE_METRICS
-      Metrics::getInstance().incrementCounter(
-        MetricCounterIDs::PipelineEgressWorker);
-      util::Timer timer{batch->getTime(j)};
-      timer.stop();
-      auto duration = timer.count<std::micro>();
-      Metrics::getInstance().observeSummary(MetricSummaryIDs::RequestLatency,
-                                            duration);
-#endif
     }
-    this->returnInputBuffers(std::move(batch));
   }
-  AMDINFER_LOG_INFO(logger, "EchoMulti ending");
 }
 
 void EchoMulti::doRelease() {}
@@ -218,7 +136,7 @@ void EchoMulti::doDestroy() {}
 extern "C" {
 // using smart pointer here may cause problems inside shared object so managing
 // manually
-amdinfer::workers::Worker* getWorker() {
+amdinfer::workers::Worker* AMDINFER_WORKER_FACTORY() {
   return new amdinfer::workers::EchoMulti("echoMulti", "cpu");
 }
 }  // extern C
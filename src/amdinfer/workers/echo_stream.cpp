@@ -0,0 +1,106 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the EchoStream worker
+ */
+
+#include <cstdint>  // for uint32_t, int32_t
+#include <cstring>  // for memcpy
+#include <memory>   // for unique_ptr
+#include <thread>   // for thread
+#include <vector>   // for vector
+
+#include "amdinfer/core/data_types.hpp"            // for DataType
+#include "amdinfer/core/inference_request.hpp"     // for InferenceRequest
+#include "amdinfer/core/inference_response.hpp"    // for InferenceResponse...
+#include "amdinfer/core/parameters.hpp"            // for ParameterMap
+#include "amdinfer/workers/continuous_worker.hpp"  // for ContinuousWorker
+#include "amdinfer/workers/worker.hpp"             // for Worker
+
+namespace amdinfer::workers {
+
+/**
+ * @brief The EchoStream worker is a test case for continuous batching. Each
+ * request has a uint32_t input with the number of steps to run it for and
+ * each step outputs the step's number, counting from one, like an
+ * autoregressive model that generates one token per step.
+ *
+ */
+class EchoStream : public ContinuousWorker {
+ public:
+  using ContinuousWorker::ContinuousWorker;
+  std::thread spawn(BatchPtrQueue* input_queue) override;
+  [[nodiscard]] std::vector<MemoryAllocators> getAllocators() const override;
+
+ private:
+  void doInit(ParameterMap* parameters) override;
+  void doAcquire(ParameterMap* parameters) override;
+  void step(const std::vector<Generation*>& generations) override;
+  void doRelease() override;
+  void doDestroy() override;
+};
+
+std::thread EchoStream::spawn(BatchPtrQueue* input_queue) {
+  return std::thread(&EchoStream::run, this, input_queue);
+}
+
+std::vector<MemoryAllocators> EchoStream::getAllocators() const {
+  return {MemoryAllocators::Cpu};
+}
+
+void EchoStream::doInit(ParameterMap* parameters) {
+  constexpr auto kBatchSize = 4;
+
+  auto batch_size = kBatchSize;
+  if (parameters->has("batch_size")) {
+    batch_size = parameters->get<int32_t>("batch_size");
+  }
+  this->batch_size_ = batch_size;
+}
+
+void EchoStream::doAcquire([[maybe_unused]] ParameterMap* parameters) {
+  this->metadata_.addInputTensor("input", {1}, DataType::Uint32);
+  this->metadata_.addOutputTensor("output", {1}, DataType::Uint32);
+}
+
+void EchoStream::step(const std::vector<Generation*>& generations) {
+  for (auto* generation : generations) {
+    const auto& input = generation->request->getInputs().at(0);
+    const auto steps = *static_cast<const uint32_t*>(input.getData());
+    const auto value = static_cast<uint32_t>(generation->steps + 1);
+
+    auto& output = generation->outputs.emplace_back();
+    output.setName(input.getName());
+    output.setDatatype(DataType::Uint32);
+    output.setShape({1});
+    auto* data = this->allocateOutput(&output);
+    std::memcpy(data, &value, sizeof(uint32_t));
+    generation->done = value >= steps;
+  }
+}
+
+void EchoStream::doRelease() {}
+void EchoStream::doDestroy() {}
+
+}  // namespace amdinfer::workers
+
+extern "C" {
+// using smart pointer here may cause problems inside shared object so managing
+// manually
+amdinfer::workers::Worker* AMDINFER_WORKER_FACTORY() {
+  return new amdinfer::workers::EchoStream("echoStream", "cpu");
+}
+}  // extern C
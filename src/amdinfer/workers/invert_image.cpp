@@ -148,11 +148,13 @@ void InvertImage::doRun(BatchPtrQueue* input_queue) {
     }
 
     AMDINFER_LOG_INFO(logger, "Got request in InvertImage");
+#ifdef AMDINFER_ENABLE_TRACING
+    batch->startSpan("InvertImage");
+#endif
     for (unsigned int j = 0; j < batch->size(); j++) {
       const auto& req = batch->getRequest(j);
 #ifdef AMDINFER_ENABLE_TRACING
       const auto& trace = batch->getTrace(j);
-      trace->startSpan("InvertImage");
 #endif
       InferenceResponse resp;
       resp.setID(req->getID());
@@ -260,7 +262,7 @@ void InvertImage::doDestroy() {}
 extern "C" {
 // using smart pointer here may cause problems inside shared object so managing
 // manually
-amdinfer::workers::Worker* getWorker() {
+amdinfer::workers::Worker* AMDINFER_WORKER_FACTORY() {
   return new amdinfer::workers::InvertImage("InvertImage", "CPU");
 }
 }  // extern C
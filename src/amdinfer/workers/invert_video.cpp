@@ -18,19 +18,25 @@
  * @brief Implements the InvertVideo worker
  */
 
-#include <cstddef>                // for size_t
-#include <cstdint>                // for int32_t
+#include <algorithm>              // for max
+#include <cstddef>                // for size_t, byte
+#include <cstdint>                // for int32_t, uint32_t
+#include <cstring>                // for memcpy
+#include <exception>              // for exception
 #include <memory>                 // for allocator, unique_ptr
 #include <opencv2/core.hpp>       // for bitwise_not, Mat
 #include <opencv2/imgcodecs.hpp>  // for imencode
 #include <opencv2/videoio.hpp>    // for VideoCapture, CV_CAP_PRO...
+#include <optional>               // for optional, nullopt
 #include <string>                 // for string, operator+, char_...
 #include <thread>                 // for thread
+#include <utility>                // for move, make_pair
 #include <vector>                 // for vector
 
 #include "amdinfer/batching/batcher.hpp"  // for Batch, BatchPtrQueue
 #include "amdinfer/build_options.hpp"     // for AMDINFER_ENABLE_TRACING
 #include "amdinfer/core/data_types.hpp"   // for DataType, DataType::String
+#include "amdinfer/core/exceptions.hpp"   // for invalid_argument
 #include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
 #include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
 #include "amdinfer/core/parameters.hpp"          // for ParameterMap
@@ -38,6 +44,7 @@
 #include "amdinfer/observation/logging.hpp"  // for Logger
 #include "amdinfer/observation/tracing.hpp"  // for startFollowSpan, SpanPtr
 #include "amdinfer/util/base64.hpp"          // for base64_encode
+#include "amdinfer/util/pipeline.hpp"        // for BoundedQueue, Pipeline
 #include "amdinfer/util/thread.hpp"          // for setThreadName
 #include "amdinfer/workers/worker.hpp"       // for Worker
 
@@ -49,6 +56,34 @@ std::string constructMessage(const std::string& key, const std::string& data) {
          R"(", "labels": )" + labels + "}}";
 }
 
+/**
+ * @brief Construct a binary message for a frame. It starts with the length of
+ * a JSON header as a 4-byte little-endian integer, followed by the header and
+ * then the raw bytes of the JPEG image.
+ *
+ * @param key the key of the request
+ * @param image the encoded image
+ * @return std::vector<std::byte>
+ */
+std::vector<std::byte> constructBinaryMessage(
+  const std::string& key, const std::vector<unsigned char>& image) {
+  constexpr auto kBitsPerByte = 8U;
+  constexpr auto kByteMask = 0xFFU;
+
+  const std::string header = R"({"key": ")" + key + R"(", "labels": []})";
+  const auto length = static_cast<uint32_t>(header.size());
+  std::vector<std::byte> message(sizeof(length) + header.size() +
+                                 image.size());
+  for (size_t i = 0; i < sizeof(length); ++i) {
+    message[i] = static_cast<std::byte>((length >> (i * kBitsPerByte)) &
+                                        kByteMask);
+  }
+  auto* data = message.data() + sizeof(length);
+  memcpy(data, header.data(), header.size());
+  memcpy(data + header.size(), image.data(), image.size());
+  return message;
+}
+
 namespace workers {
 
 /**
@@ -68,6 +103,11 @@ class InvertVideo : public Worker {
   void doRun(BatchPtrQueue* input_queue) override;
   void doRelease() override;
   void doDestroy() override;
+
+  /// number of threads that invert and encode frames in parallel
+  size_t encode_threads_ = 2;
+  /// the maximum number of frames waiting for each stage
+  size_t queue_depth_ = 4;
 };
 
 std::thread InvertVideo::spawn(BatchPtrQueue* input_queue) {
@@ -78,10 +118,22 @@ std::vector<MemoryAllocators> InvertVideo::getAllocators() const {
   return {MemoryAllocators::Cpu};
 }
 
-void InvertVideo::doInit([[maybe_unused]] ParameterMap* parameters) {
+void InvertVideo::doInit(ParameterMap* parameters) {
   constexpr auto kBatchSize = 1;
 
   this->batch_size_ = kBatchSize;
+
+  for (auto [key, value] : {std::make_pair("encode_threads", &encode_threads_),
+                            std::make_pair("queue_depth", &queue_depth_)}) {
+    if (parameters->has(key)) {
+      auto requested = parameters->get<int32_t>(key);
+      if (requested <= 0) {
+        throw invalid_argument(std::string{"The parameter "} + key +
+                               " must be positive");
+      }
+      *value = static_cast<size_t>(requested);
+    }
+  }
 }
 
 // Support up to Full HD
@@ -116,12 +168,11 @@ void InvertVideo::doRun(BatchPtrQueue* input_queue) {
     }
 
     AMDINFER_LOG_INFO(logger, "Got request in InvertVideo");
-    for (unsigned int j = 0; j < batch->size(); j++) {
-      const auto& req = batch->getRequest(j);
 #ifdef AMDINFER_ENABLE_TRACING
-      const auto& trace = batch->getTrace(j);
-      trace->startSpan("InvertVideo");
+    batch->startSpan("InvertVideo");
 #endif
+    for (unsigned int j = 0; j < batch->size(); j++) {
+      const auto& req = batch->getRequest(j);
       auto inputs = req->getInputs();
       auto outputs = req->getOutputs();
       auto key = req->getParameters().get<std::string>("key");
@@ -161,34 +212,78 @@ void InvertVideo::doRun(BatchPtrQueue* input_queue) {
         output.setShape({message.size()});
         resp.addOutput(output);
         req->runCallback(resp);
-        for (int num_frames = 0; num_frames < count; num_frames++) {
-          cv::Mat frame;
-          cap >> frame;  // get the next frame from video
-          if (frame.empty()) {
-            num_frames--;
-            continue;
-          }
-          cv::bitwise_not(frame, frame);
-          std::vector<unsigned char> buf;
-          cv::imencode(".jpg", frame, buf);
-          const auto* enc_msg = reinterpret_cast<const char*>(buf.data());
-          std::string encoded =
-            "data:image/jpg;base64," + util::base64Encode(enc_msg, buf.size());
-
-          InferenceResponse resp;
-          resp.setID(req->getID());
-          resp.setModel("invert_video");
-
-          InferenceResponseOutput output;
-          output.setName("image");
-          output.setDatatype(DataType::String);
-          message = constructMessage(key, encoded);
-          buffer.resize(message.size());
-          memcpy(buffer.data(), message.data(), message.size());
-          output.setData(std::move(buffer));
-          output.setShape({message.size()});
-          resp.addOutput(output);
-          req->runCallback(resp);
+
+        // frames are sent as binary messages if the request asks for it.
+        // Otherwise, they're base64-encoded data URLs in JSON text messages
+        const auto& request_parameters = req->getParameters();
+        const bool binary = request_parameters.has("binary") &&
+                            request_parameters.get<bool>("binary");
+
+        // read the frames in order on one thread, invert and encode them in
+        // parallel and send them back in order
+        struct Frame {
+          size_t index;
+          cv::Mat image;
+          std::vector<std::byte> message;
+        };
+        util::BoundedQueue<Frame> decoded{this->queue_depth_};
+        util::BoundedQueue<Frame> encoded{this->queue_depth_};
+        util::Pipeline pipeline;
+        const auto frames = static_cast<size_t>(std::max(count, 0));
+        size_t next = 0;
+        pipeline.addSource(
+          "InvertDecode", &decoded, [&]() -> std::optional<Frame> {
+            if (next == frames) {
+              return std::nullopt;
+            }
+            cv::Mat frame;
+            cap >> frame;  // get the next frame from video
+            if (frame.empty()) {
+              return std::nullopt;
+            }
+            return Frame{next++, std::move(frame), {}};
+          });
+        pipeline.addStage(
+          "InvertEncode", this->encode_threads_, &decoded, &encoded,
+          [&](Frame frame) {
+            cv::bitwise_not(frame.image, frame.image);
+            std::vector<unsigned char> buf;
+            cv::imencode(".jpg", frame.image, buf);
+            frame.image.release();
+            if (binary) {
+              frame.message = constructBinaryMessage(key, buf);
+            } else {
+              const auto* enc_msg = reinterpret_cast<const char*>(buf.data());
+              auto text = constructMessage(
+                key, "data:image/jpg;base64," +
+                       util::base64Encode(enc_msg, buf.size()));
+              frame.message.resize(text.size());
+              memcpy(frame.message.data(), text.data(), text.size());
+            }
+            return frame;
+          });
+
+        try {
+          util::popInOrder(
+            &encoded, [](const Frame& frame) { return frame.index; },
+            [&](Frame frame) {
+              InferenceResponse resp;
+              resp.setID(req->getID());
+              resp.setModel("invert_video");
+
+              InferenceResponseOutput output;
+              output.setName("image");
+              // non-string outputs are sent as binary websocket messages
+              output.setDatatype(binary ? DataType::Uint8 : DataType::String);
+              output.setShape({frame.message.size()});
+              output.setData(std::move(frame.message));
+              resp.addOutput(output);
+              req->runCallback(resp);
+            });
+          pipeline.join();
+        } catch (const std::exception& e) {
+          AMDINFER_LOG_ERROR(logger, e.what());
+          req->runCallbackError(e.what());
         }
       }
     }
@@ -206,7 +301,7 @@ void InvertVideo::doDestroy() {}
 extern "C" {
 // using smart pointer here may cause problems inside shared object so managing
 // manually
-amdinfer::workers::Worker* getWorker() {
+amdinfer::workers::Worker* AMDINFER_WORKER_FACTORY() {
   return new amdinfer::workers::InvertVideo("InvertVideo", "CPU");
 }
 }  // extern C
@@ -17,35 +17,51 @@
  * @brief Implements the Migraphx worker.
  */
 
-#include <migraphx/migraphx.h>  // for migraphx_shape_datatype_t
+#include <hip/hip_runtime_api.h>  // for hipGetDeviceProperties, hipSe...
+#include <migraphx/migraphx.h>      // for migraphx_shape_datatype_t
+#include <migraphx/version.h>       // for MIGRAPHX_VERSION_MAJOR
+#include <omp.h>                    // for omp_set_num_threads
 
-#include <algorithm>              // for max
+#include <algorithm>              // for max, any_of, min, sort
 #include <cstddef>                // for byte, size_t
+#include <cstdint>                // for uint64_t
 #include <cstring>                // for memcpy
 #include <exception>              // for exception
 #include <filesystem>             // for path
 #include <fstream>                // for ifstream, operator<<
+#include <iterator>               // for prev
+#include <limits>                 // for numeric_limits
 #include <map>                    // for map
 #include <memory>                 // for allocator, unique_ptr
+#include <mutex>                  // for mutex, lock_guard
 #include <migraphx/migraphx.hpp>  // for shape, program, progra...
 #include <ratio>                  // for micro
+#include <sstream>                // for stringstream
 #include <stdexcept>              // for invalid_argument, runt...
 #include <string>                 // for string, operator+, to_...
 #include <thread>                 // for thread
-#include <utility>                // for move
+#include <utility>                // for move, pair
 #include <vector>                 // for vector
 
 #include "amdinfer/batching/hard.hpp"           // for BatchPtr, Batch, Batch...
+#include "amdinfer/batching/input_cast.hpp"     // for findCast, castInput
 #include "amdinfer/build_options.hpp"           // for AMDINFER_ENABLE_LOGGING
 #include "amdinfer/core/data_types.hpp"         // for DataType, operator<<
+#include "amdinfer/core/device_scheduler.hpp"   // for DeviceScheduler
 #include "amdinfer/core/exceptions.hpp"         // for invalid_argument, runt...
 #include "amdinfer/core/inference_request.hpp"  // for InferenceRequest
 #include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/core/model_artifacts.hpp"     // for getModelArtifact
 #include "amdinfer/core/parameters.hpp"          // for ParameterMap
+#include "amdinfer/core/requested_outputs.hpp"   // for selectOutputs
+#include "amdinfer/core/tensor.hpp"              // for Tensor
+#include "amdinfer/core/workspace_pool.hpp"      // for WorkspacePool
 #include "amdinfer/declarations.hpp"             // for InferenceResponseOutput
 #include "amdinfer/observation/logging.hpp"  // for AMDINFER_LOG_INFO, AMD...
 #include "amdinfer/observation/metrics.hpp"  // for Metrics, MetricCounterIDs
 #include "amdinfer/util/containers.hpp"      // for containerProduct
+#include "amdinfer/util/mapped_file.hpp"     // for MappedFile
+#include "amdinfer/util/model_cache.hpp"     // for getModelCachePath
 #include "amdinfer/util/queue.hpp"           // for BufferPtrsQueue
 #include "amdinfer/util/thread.hpp"          // for setThreadName
 #include "amdinfer/util/timer.hpp"           // for Timer
@@ -53,16 +69,82 @@
 
 namespace amdinfer::workers {
 
+/**
+ * @brief Holds what one batch needs while it's in flight on the GPU when the
+ * worker copies the data itself. Inputs are staged in pinned host memory and
+ * outputs are copied back to it so the copies can run asynchronously on the
+ * slot's stream.
+ */
+struct DeviceSlot {
+  DeviceSlot() = default;                              ///< Constructor
+  DeviceSlot(const DeviceSlot&) = delete;              ///< Copy constructor
+  DeviceSlot& operator=(const DeviceSlot&) = delete;   ///< Copy assignment
+  DeviceSlot(DeviceSlot&& other) = delete;             ///< Move constructor
+  DeviceSlot& operator=(DeviceSlot&& other) = delete;  ///< Move assignment
+  ~DeviceSlot() {
+    if (!shared) {
+      for (const auto& [name, buffer] : device) {
+        (void)hipFree(buffer);
+      }
+    }
+    for (const auto& [name, buffer] : host_inputs) {
+      (void)hipHostFree(buffer);
+    }
+    for (auto* buffer : host_outputs) {
+      (void)hipHostFree(buffer);
+    }
+    if (stream != nullptr) {
+      (void)hipStreamDestroy(stream);
+    }
+  }
+
+  hipStream_t stream = nullptr;
+  /// device buffers for each of the programs' parameters, including outputs
+  std::map<std::string, void*> device;
+  /// whether the device buffers are in a workspace leased from the GPU's pool
+  /// while a batch is in flight instead of being the slot's own
+  bool shared = false;
+  WorkspacePool::Lease workspace;
+  /// pinned host buffers for each input
+  std::map<std::string, void*> host_inputs;
+  /// pinned host buffers for each output, in order
+  std::vector<void*> host_outputs;
+  /**
+   * @brief GPU buffers from the memory pool for each request's outputs, by
+   * request and then output, if the batch's outputs stay on the device
+   */
+  BufferPtrs device_outputs;
+
+  BatchPtr batch;
+  migraphx::program* prog = nullptr;
+  /// the endpoint's turn on the GPU, held while the batch is in flight
+  DeviceScheduler::Turn turn;
+};
+
 /**
  * @brief The Migraphx worker accepts the name of an migraphx model file as an
  * argument and compiles and evaluates it.
  *
  */
+/**
+ * @brief The programs of a model, one per batch size and keyed by it. With
+ * offload copy, the endpoints that load the same model with the same options
+ * share them and take turns evaluating them.
+ */
+struct Programs {
+  std::map<size_t, migraphx::program> programs;
+  /// Held while a shared program is evaluated
+  std::mutex mutex;
+};
+
 class MIGraphXWorker : public Worker {
  public:
   using Worker::Worker;
   std::thread spawn(BatchPtrQueue* input_queue) override;
   [[nodiscard]] std::vector<MemoryAllocators> getAllocators() const override;
+  [[nodiscard]] bool acceptsScatterGather() const override;
+  [[nodiscard]] bool acceptsDeviceInputs() const override;
+  [[nodiscard]] std::vector<InputCast> getInputCasts() const override;
 
  private:
   void doInit(ParameterMap* parameters) override;
@@ -71,12 +153,63 @@ class MIGraphXWorker : public Worker {
   void doRelease() override;
   void doDestroy() override;
 
+  /// Load a compiled MessagePack (*.mxr) file
+  migraphx::program loadCompiled(const std::filesystem::path& path);
+  /// Load or compile the model for one batch size
+  migraphx::program loadProgram(size_t batch_size,
+                                const std::string& cache_dir);
+  /// Quantize a parsed model to the precision it's loaded with
+  void quantize(migraphx::program& prog) const;
+  /// Get the smallest program that fits a batch and the batch size it takes
+  std::pair<size_t, migraphx::program*> getProgram(size_t batch_size);
+  /**
+   * @brief Respond to each request in a batch with its part of the outputs
+   *
+   * @param batch the batch to respond to
+   * @param prog the program that ran the batch
+   * @param migraphx_output the outputs of the batch
+   * @param device_outputs if not empty, each request's outputs are already in
+   * these buffers, by request and then output, and are moved to the responses
+   */
+  void respond(Batch* batch, migraphx::program* prog,
+               const std::vector<migraphx::argument>& migraphx_output,
+               BufferPtrs* device_outputs = nullptr);
+  /**
+   * @brief Get GPU buffers from the memory pool for each request's outputs.
+   * If there isn't enough GPU memory, it returns none and the outputs are
+   * copied to the host instead
+   *
+   * @param results the outputs of the batch
+   * @param requests number of requests in the batch
+   * @return BufferPtrs
+   */
+  BufferPtrs getDeviceOutputs(const migraphx::arguments& results,
+                              size_t requests);
+  /// Return the unused buffers of a batch's outputs to the memory pool
+  void returnDeviceOutputs(BufferPtrs* buffers);
+  /**
+   * @brief Run batches with the model reading and writing device memory. The
+   * next batch is copied to the device while the previous one is evaluated.
+   *
+   * @param input_queue queue that receives incoming batches
+   */
+  void runOnDevice(BatchPtrQueue* input_queue);
+  /// Lease a workspace from the GPU's pool and lay the slot's buffers out in it
+  void leaseWorkspace(DeviceSlot* slot);
+  /// Copy a batch to the slot's device buffers and start evaluating it
+  void launch(DeviceSlot* slot, BatchPtr batch);
+  /// Wait for the slot's batch to finish and respond to its requests
+  void finish(DeviceSlot* slot);
+  [[nodiscard]] std::vector<size_t> getBatchSizes() const override;
+  [[nodiscard]] std::vector<Tensor> getWarmupInputs() const override;
+
   // the model file to be loaded.  Supported types are *.onnx and *.mxr
   std::filesystem::path input_file_;
-  // The prog_ is populated by reading the model file and contains most of
+  // The programs are populated by reading the model file and contain most of
   // the worker's important info such as number, data types and sizes of
-  // input and output buffers
-  migraphx::program prog_;
+  // input and output buffers. There's one program per batch size, keyed by
+  // the batch size it's compiled for. The largest is the worker's batch size
+  std::shared_ptr<Programs> programs_;
 
   // flag to pad out a batch with dummy data.  Sending a batch of requests
   // with uninitialized data may crash migraphx, for certain models.
@@ -85,14 +218,70 @@ class MIGraphXWorker : public Worker {
   bool pad_batch_ = true;
   // Calculated sizes in bytes for each input tensor, by input name
   std::map<std::string, size_t> input_sizes_;
+  // the MIGraphX target that models are compiled for: gpu or cpu
+  std::string target_ = "gpu";
+  // the number of threads that the CPU target runs each batch with. If it's
+  // zero, the OpenMP default is used
+  int threads_ = 0;
+  // the GPU that this instance of the worker runs on
+  int device_ = 0;
+  // the name of the GPU in the device metrics or cpu for the CPU target
+  std::string device_name_;
+  // With offload copy, MIGraphX copies the inputs and outputs to and from the
+  // device as part of each synchronous eval(). Otherwise, the worker does the
+  // copies itself asynchronously and keeps its device buffers allocated
+  bool offload_copy_ = true;
+  // Without offload copy, each request's outputs can be left on the GPU in
+  // buffers from the memory pool instead of being copied back to the host so
+  // they're only copied there if the response is serialized
+  bool device_outputs_ = false;
+  // Without offload copy, the device buffers of the batches in flight can be
+  // leased from a pool shared by the workers on the GPU instead of each slot
+  // keeping its own, at these offsets into a workspace of this size
+  bool share_workspace_ = false;
+  std::map<std::string, size_t> workspace_offsets_;
+  size_t workspace_bytes_ = 0;
+  std::shared_ptr<WorkspacePool> workspaces_;
+  // the precision that ONNX models are quantized to before they're compiled:
+  // fp32, fp16 or int8
+  std::string precision_ = "fp32";
+  // the directory with one <input>.bin file per input holding the samples
+  // that int8 quantization is calibrated with, one after another
+  std::filesystem::path calibration_;
+  // the hashes of the calibration files, which are part of the cache key
+  std::string calibration_hash_;
+  // the names of the programs' inputs. Without offload copy, the programs'
+  // parameters also include their outputs
+  std::vector<std::string> input_names_;
+  // the programs' inputs that requests of smaller types are converted to,
+  // scaled by the input_scale and input_offset parameters, and that requests
+  // in other layouts are transposed to if the input_layout parameter is set
+  std::vector<InputCast> input_casts_;
+  // the buffers of the batches in flight when not using offload copy
+  std::vector<std::unique_ptr<DeviceSlot>> slots_;
 };
 
 std::thread MIGraphXWorker::spawn(BatchPtrQueue* input_queue) {
   return std::thread(&MIGraphXWorker::run, this, input_queue);
 }
 
+// batches are built in pinned memory so they're copied to the GPU with DMA,
+// and in pageable memory if the pinned memory runs out
 std::vector<MemoryAllocators> MIGraphXWorker::getAllocators() const {
-  return {MemoryAllocators::Cpu};
+  if (target_ == "cpu") {
+    return {MemoryAllocators::Cpu};
+  }
+  return {MemoryAllocators::PinnedHost, MemoryAllocators::Cpu};
+}
+
+// without offload copy, the worker copies each request's inputs to the GPU
+// itself so it can gather them from wherever they are, including the GPU
+bool MIGraphXWorker::acceptsScatterGather() const { return !offload_copy_; }
+
+bool MIGraphXWorker::acceptsDeviceInputs() const { return !offload_copy_; }
+
+std::vector<InputCast> MIGraphXWorker::getInputCasts() const {
+  return input_casts_;
 }
 
 // Enum-to-enum conversion to let us read data type from migraphx model.
@@ -130,6 +319,226 @@ DataType toDataType(migraphx_shape_datatype_t in) {
   }
 }
 
+/**
+ * @brief Pick the GPU for one instance of the worker. The "device" parameter
+ * picks one explicitly. Otherwise, the instances are spread round-robin over
+ * the GPUs that are visible.
+ *
+ * @param parameters the worker's load-time parameters
+ * @return int the GPU's index
+ */
+int getInstanceDevice(const ParameterMap* parameters) {
+  int devices = 0;
+  if (hipGetDeviceCount(&devices) != hipSuccess || devices == 0) {
+    throw external_error("Server could not find a GPU");
+  }
+  if (parameters->has("device")) {
+    const auto device = parameters->get<int32_t>("device");
+    if (device < 0 || device >= devices) {
+      throw invalid_argument("GPU " + std::to_string(device) +
+                             " does not exist");
+    }
+    return device;
+  }
+  int32_t instance = 0;
+  if (parameters->has("instance")) {
+    instance = parameters->get<int32_t>("instance");
+  }
+  return instance % devices;
+}
+
+/// Throw an exception if a HIP call failed
+void checkHip(hipError_t status, const std::string& action) {
+  if (status != hipSuccess) {
+    throw external_error("Failed to " + action + ": " +
+                         hipGetErrorString(status));
+  }
+}
+
+/// Get the GPU that a pointer's memory is on or -1 if it's on the host
+int getPointerDevice(const void* data) {
+  hipPointerAttribute_t attributes;
+  if (hipPointerGetAttributes(&attributes, data) != hipSuccess) {
+    // pageable host memory that HIP doesn't know about is reported as an error
+    (void)hipGetLastError();
+    return -1;
+  }
+#if HIP_VERSION_MAJOR >= 6
+  const auto type = attributes.type;
+#else
+  const auto type = attributes.memoryType;
+#endif
+  return type == hipMemoryTypeDevice ? attributes.device : -1;
+}
+
+#ifdef AMDINFER_ENABLE_METRICS
+/// Keeps a job in flight on a GPU in the device metrics while it's in scope
+class DeviceJob {
+ public:
+  explicit DeviceJob(const std::string& device) : device_(device) {
+    Metrics::getInstance().startDeviceJob(device_);
+  }
+  DeviceJob(const DeviceJob&) = delete;              ///< Copy constructor
+  DeviceJob& operator=(const DeviceJob&) = delete;   ///< Copy assignment
+  DeviceJob(DeviceJob&& other) = delete;             ///< Move constructor
+  DeviceJob& operator=(DeviceJob&& other) = delete;  ///< Move assignment
+  ~DeviceJob() { Metrics::getInstance().finishDeviceJob(device_); }
+
+ private:
+  const std::string& device_;
+};
+#endif
+
+/// Without offload copy, the programs' outputs are also parameters
+bool isOutputParameter(const std::string& name) {
+  return name.find("#output_") != std::string::npos;
+}
+
+/// Get the device that models are compiled for, including its architecture
+std::string getDevice(const std::string& target) {
+  if (target != "gpu") {
+    return target;
+  }
+  int device = 0;
+  hipDeviceProp_t properties;
+  if (hipGetDevice(&device) != hipSuccess ||
+      hipGetDeviceProperties(&properties, device) != hipSuccess) {
+    return "gpu";
+  }
+  return std::string{"gpu-"} + properties.gcnArchName;
+}
+
+std::string getFramework() {
+  return "migraphx-" + std::to_string(MIGRAPHX_VERSION_MAJOR) + "." +
+         std::to_string(MIGRAPHX_VERSION_MINOR) + "." +
+         std::to_string(MIGRAPHX_VERSION_PATCH);
+}
+
+/// Check that the precision is one that models can be quantized to
+void checkPrecision(const std::string& precision) {
+  if (precision != "fp32" && precision != "fp16" && precision != "int8") {
+    throw invalid_argument("Unsupported precision " + precision +
+                           ". Use fp32, fp16 or int8");
+  }
+}
+
+/// Hash the calibration files in a directory in the order of their names
+std::string hashCalibration(const std::filesystem::path& directory) {
+  std::vector<std::filesystem::path> files;
+  for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+    if (entry.path().extension() == ".bin") {
+      files.push_back(entry.path());
+    }
+  }
+  std::sort(files.begin(), files.end());
+  std::string hash;
+  for (const auto& file : files) {
+    hash += util::hashFile(file);
+  }
+  return hash;
+}
+
+/**
+ * @brief Parse a comma-separated list of batch sizes like "1,4,16,64"
+ *
+ * @param text the list to parse
+ * @return std::vector<size_t> the batch sizes
+ */
+std::vector<size_t> parseBatchSizes(const std::string& text) {
+  std::vector<size_t> batch_sizes;
+  std::stringstream stream{text};
+  std::string token;
+  while (std::getline(stream, token, ',')) {
+    size_t parsed = 0;
+    int batch_size = 0;
+    try {
+      batch_size = std::stoi(token, &parsed);
+    } catch (const std::logic_error&) {
+      parsed = 0;
+    }
+    if (parsed != token.size() || batch_size <= 0) {
+      throw invalid_argument("Expected a list of positive batch sizes, got " +
+                             text);
+    }
+    batch_sizes.push_back(batch_size);
+  }
+  if (batch_sizes.empty()) {
+    throw invalid_argument("Expected a list of positive batch sizes, got " +
+                           text);
+  }
+  return batch_sizes;
+}
+
+void MIGraphXWorker::quantize(migraphx::program& prog) const {
+  if (this->precision_ == "fp16") {
+    migraphx::quantize_fp16(prog);
+    return;
+  }
+  if (this->precision_ != "int8") {
+    return;
+  }
+
+  // each input's calibration file holds its samples one after another. They're
+  // grouped into batches the size of the program, dropping any partial batch
+  auto shapes = prog.get_parameter_shapes();
+  std::vector<std::pair<std::string, util::MappedFile>> files;
+  size_t batches = std::numeric_limits<size_t>::max();
+  for (const auto* name : shapes.names()) {
+    const auto path = this->calibration_ / (std::string{name} + ".bin");
+    if (!std::filesystem::exists(path)) {
+      throw invalid_argument("No calibration data for input " +
+                             std::string{name} + " at " + path.string());
+    }
+    const auto& file = files.emplace_back(name, util::MappedFile{path}).second;
+    batches = std::min(batches, file.size() / shapes[name].bytes());
+  }
+  if (batches == 0) {
+    throw invalid_argument("The calibration data in " +
+                           this->calibration_.string() +
+                           " doesn't fill one batch");
+  }
+
+  migraphx::quantize_int8_options options;
+  for (size_t i = 0; i < batches; ++i) {
+    migraphx::program_parameters batch;
+    for (const auto& [name, file] : files) {
+      auto shape = shapes[name.c_str()];
+      // MIGraphX only reads the calibration data
+      auto* data = const_cast<char*>(file.data()) + i * shape.bytes();
+      batch.add(name.c_str(), migraphx::argument(shape, data));
+    }
+    options.add_calibration_data(batch);
+  }
+  migraphx::quantize_int8(prog, migraphx::target(this->target_.c_str()),
+                          options);
+}
+
+migraphx::program MIGraphXWorker::loadCompiled(
+  const std::filesystem::path& path) {
+#ifdef AMDINFER_ENABLE_LOGGING
+  const auto& logger = this->getLogger();
+#endif
+  AMDINFER_LOG_INFO(logger,
+                    "migraphx worker loading compiled model file " +
+                      path.string());
+  migraphx::file_options options;
+  options.set_file_format("msgpack");
+
+  // The hip library will throw a cryptic error if unable to connect with a
+  // GPU at this point.
+  try {
+    return migraphx::load(path.c_str(), options);
+  } catch (const std::exception& e) {
+    std::string emsg = e.what();
+    if (emsg.find("Failed to call function") != std::string::npos) {
+      emsg = emsg + ".  Server could not connect to a GPU.";
+    }
+    AMDINFER_LOG_ERROR(logger, emsg);
+    throw std::runtime_error(emsg);
+    // the program does not need to be compiled.
+  }
+}
+
 void MIGraphXWorker::doInit(ParameterMap* parameters) {
   // default batch size; client may request a change. Arbitrarily set to 64
   const int default_batch_size = 64;
@@ -145,6 +554,32 @@ void MIGraphXWorker::doInit(ParameterMap* parameters) {
 
   AMDINFER_LOG_INFO(logger, " MIGraphXWorker::doInit \n");
 
+  if (parameters->has("target")) {
+    this->target_ = parameters->get<std::string>("target");
+    if (this->target_ != "gpu" && this->target_ != "cpu") {
+      throw invalid_argument("Unsupported target " + this->target_ +
+                             ". Use gpu or cpu");
+    }
+  }
+  if (this->target_ == "cpu") {
+    this->device_name_ = "cpu";
+    if (parameters->has("threads")) {
+      this->threads_ = parameters->get<int>("threads");
+      if (this->threads_ < 0) {
+        throw invalid_argument("The number of threads can't be negative");
+      }
+    }
+  } else {
+    // the device is set per thread. This thread loads the models and warms
+    // them up and the run thread sets it again
+    this->device_ = getInstanceDevice(parameters);
+    this->device_name_ = "gpu" + std::to_string(this->device_);
+    if (hipSetDevice(this->device_) != hipSuccess) {
+      throw external_error("Server could not use GPU " +
+                           std::to_string(this->device_));
+    }
+  }
+
   if (parameters->has("batch")) {
     this->batch_size_ = parameters->get<int>("batch");
   }
@@ -161,6 +596,123 @@ void MIGraphXWorker::doInit(ParameterMap* parameters) {
   if (parameters->has("pad_batch")) {
     this->pad_batch_ = parameters->get<bool>("pad_batch");
   }
+  if (parameters->has("offload_copy")) {
+    this->offload_copy_ = parameters->get<bool>("offload_copy");
+  }
+  // the worker's own copies are to and from the GPU
+  if (!this->offload_copy_ && this->target_ == "cpu") {
+    throw invalid_argument("The cpu target needs offload_copy");
+  }
+  if (parameters->has("device_outputs")) {
+    this->device_outputs_ =
+      !this->offload_copy_ && parameters->get<bool>("device_outputs");
+  }
+  if (parameters->has("share_workspace")) {
+    this->share_workspace_ =
+      !this->offload_copy_ && parameters->get<bool>("share_workspace");
+  }
+  std::string cache_dir;
+  if (parameters->has("cache_dir")) {
+    cache_dir = parameters->get<std::string>("cache_dir");
+  }
+  if (parameters->has("precision")) {
+    this->precision_ = parameters->get<std::string>("precision");
+    checkPrecision(this->precision_);
+  }
+  if (this->precision_ == "int8") {
+    if (!parameters->has("calibration")) {
+      throw invalid_argument(
+        "The int8 precision needs a calibration directory");
+    }
+    this->calibration_ = parameters->get<std::string>("calibration");
+    if (!std::filesystem::is_directory(this->calibration_)) {
+      throw invalid_argument("Calibration directory " +
+                             this->calibration_.string() + " not found");
+    }
+    this->calibration_hash_ = hashCalibration(this->calibration_);
+  }
+  ParameterMap metadata_parameters;
+  metadata_parameters.put("precision", this->precision_);
+  this->metadata_.setParameters(metadata_parameters);
+
+  // The model is compiled once for each batch size in the ladder. Batches are
+  // run with the smallest program that fits them so small batches don't pay
+  // for the padding up to the largest batch size.
+  std::vector<size_t> batch_sizes{batch_size_};
+  if (parameters->has("batch_sizes")) {
+    batch_sizes = parseBatchSizes(parameters->get<std::string>("batch_sizes"));
+  }
+  auto load = [&]() {
+    auto programs = std::make_shared<Programs>();
+    for (auto batch_size : batch_sizes) {
+      auto prog = this->loadProgram(batch_size, cache_dir);
+      // a compiled model has its batch size baked in, which may differ from
+      // the one requested
+      auto input_shapes = prog.get_parameter_shapes();
+      // models compiled earlier may not match the requested offload copy
+      const auto names = input_shapes.names();
+      if (std::any_of(names.begin(), names.end(), isOutputParameter) ==
+          this->offload_copy_) {
+        throw invalid_argument(
+          "The compiled model for batch size " + std::to_string(batch_size) +
+          " does not match the offload_copy parameter");
+      }
+      const auto actual = input_shapes[input_shapes.names()[0]].lengths()[0];
+      programs->programs.insert_or_assign(actual, std::move(prog));
+    }
+    return programs;
+  };
+  // Endpoints that load the same model on the same device with other batching
+  // parameters share its programs. Without offload copy, the worker keeps
+  // batches in flight on the programs so they're its own
+  if (this->offload_copy_) {
+    std::string options = "migraphx-" + this->device_name_ + "-" +
+                          this->precision_ + this->calibration_hash_ + "-b";
+    for (auto batch_size : batch_sizes) {
+      options += std::to_string(batch_size) + ",";
+    }
+    programs_ = getModelArtifact<Programs>(
+      getModelArtifactKey(this->input_file_, options), load);
+  } else {
+    programs_ = load();
+  }
+
+  // Fetch the expected dimensions of the input from the largest program.
+  const auto& [max_batch_size, prog] = *programs_->programs.rbegin();
+  this->batch_size_ = max_batch_size;
+
+  const auto scale = parameters->has("input_scale")
+                       ? parameters->get<double>("input_scale")
+                       : 1.0;
+  const auto offset = parameters->has("input_offset")
+                        ? parameters->get<double>("input_offset")
+                        : 0.0;
+  const auto layout =
+    parameters->has("input_layout")
+      ? parseLayout(parameters->get<std::string>("input_layout"))
+      : InputLayout::Any;
+  migraphx::program_parameter_shapes input_shapes =
+    prog.get_parameter_shapes();
+  for (const auto* aname : input_shapes.names()) {
+    if (!isOutputParameter(aname)) {
+      input_names_.emplace_back(aname);
+      input_casts_.push_back({aname, toDataType(input_shapes[aname].type()),
+                              static_cast<float>(scale),
+                              static_cast<float>(offset), layout});
+    }
+    migraphx::shape ashape = input_shapes[aname];
+    // size of the buffer needed for this input
+    auto asize = ashape.bytes();
+    // size of a single request input (divide by batch size)
+    input_sizes_[aname] = asize / *(ashape.lengths().begin());
+  }
+}
+
+migraphx::program MIGraphXWorker::loadProgram(size_t batch_size,
+                                              const std::string& cache_dir) {
+#ifdef AMDINFER_ENABLE_LOGGING
+  const auto& logger = this->getLogger();
+#endif
 
   // Only load/compile the model once during the lifetime of the worker.
   // This worker does not deallocate or release resources until it's destroyed;
@@ -175,94 +727,107 @@ void MIGraphXWorker::doInit(ParameterMap* parameters) {
   // Filename processing.
   // Take the root of the given model file name and look for either an *.mxr
   // or *.onnx extension (after loading and compiling an *.onnx file, this
-  // worker saves it as an *.mxr file for future use)
-  // A *.mxr file should also have its baked-in batch size
+  // worker saves it as an *.mxr file in the model cache for future use)
+  // A *.mxr file next to the model should also have its baked-in batch size
   // tacked onto its name, eg. resnet50-v2-7_b64.mxr
   compiled_path.replace_extension();
-  compiled_path += (std::string("_b") + std::to_string(batch_size_));
+  compiled_path += (std::string("_b") + std::to_string(batch_size));
+  // a quantized model's name ends with its precision, eg. resnet50_b64_fp16,
+  // and a model compiled for the CPU with cpu, eg. resnet50_b64_cpu
+  if (this->precision_ != "fp32") {
+    compiled_path += "_" + this->precision_;
+  }
+  if (this->target_ == "cpu") {
+    compiled_path += "_cpu";
+  }
   compiled_path.replace_extension(".mxr");
 
   onnx_path.replace_extension(".onnx");
 
-  // Is there an mxr file?
+  // Is there an mxr file next to the model? These are used as is
   std::ifstream f(compiled_path.c_str());
   if (f.good()) {
-    // Load the compiled MessagePack (*.mxr) file
-    AMDINFER_LOG_INFO(
-      logger, std::string("migraphx worker loading compiled model file ") +
-                compiled_path.c_str());
-    migraphx::file_options options;
-    options.set_file_format("msgpack");
-
-    // The hip library will throw a cryptic error if unable to connect with a
-    // GPU at this point.
-    try {
-      this->prog_ = migraphx::load(compiled_path.c_str(), options);
-    } catch (const std::exception& e) {
-      std::string emsg = e.what();
-      if (emsg.find("Failed to call function") != std::string::npos) {
-        emsg = emsg + ".  Server could not connect to a GPU.";
-      }
-      AMDINFER_LOG_ERROR(logger, emsg);
-      throw std::runtime_error(emsg);
-      // prog_ does not need to be compiled.
-    }
+    return this->loadCompiled(compiled_path);
   } else {
     // Look for onnx file.  ifstream tests that the file can be opened
     f = std::ifstream(onnx_path.c_str());
-    if (f.good()) {
+
+    // Otherwise, the compiled model may be in the model cache from an earlier
+    // load. Its key covers everything the compiled model depends on
+    std::filesystem::path cache_path;
+    if (const auto cache = util::getModelCacheDirectory(cache_dir);
+        f.good() && !cache.empty()) {
+      // models compiled with and without offload copy take different inputs
+      auto framework =
+        this->offload_copy_ ? getFramework() : getFramework() + "-no-offload";
+      // and quantized models depend on their precision and calibration data
+      if (this->precision_ != "fp32") {
+        framework += "-" + this->precision_ + this->calibration_hash_;
+      }
+      util::ModelCacheKey key{onnx_path, getDevice(this->target_), framework,
+                              static_cast<int>(batch_size), ".mxr"};
+      cache_path = util::getModelCachePath(cache, key);
+    }
+
+    if (!cache_path.empty() && std::filesystem::exists(cache_path)) {
+      return this->loadCompiled(cache_path);
+    } else if (f.good()) {
       // Load the onnx file
-      // Using parse_onnx() instead of load() because there's a bug at the
-      // time of writing
+      // Using parse_onnx_buffer() instead of load() because there's a bug at
+      // the time of writing
       AMDINFER_LOG_INFO(
         logger, std::string("migraphx worker loading ONNX model file ") +
                   onnx_path.c_str());
 
       migraphx::onnx_options onnx_opts;
-      onnx_opts.set_default_dim_value(batch_size_);
-      this->prog_ = migraphx::parse_onnx(onnx_path.c_str(), onnx_opts);
-
-      auto param_shapes =
-        prog_.get_parameter_shapes();  // program_parameter_shapes struct
+      onnx_opts.set_default_dim_value(batch_size);
+      // the model is parsed from a mapping of its file instead of being read
+      // into a buffer first
+      const util::MappedFile onnx_file{onnx_path};
+      auto prog = migraphx::parse_onnx_buffer(onnx_file.data(),
+                                              onnx_file.size(), onnx_opts);
 
       AMDINFER_LOG_INFO(logger,
                         std::string("migraphx worker loaded ONNX model file ") +
                           onnx_path.c_str());
+      this->quantize(prog);
 
-      // Compile the model.  Hard-coded choices of offload_copy and gpu
-      // target.
+      // Compile the model for the target. Without offload copy, the
+      // program reads and writes device memory that the worker manages
       migraphx::compile_options comp_opts;
-      comp_opts.set_offload_copy();
+      comp_opts.set_offload_copy(this->offload_copy_);
 
-      // migraphx can support a reference (cpu) target as a fallback if GPU is
-      // not found; not implemented here
-      const bool use_gpu = true;
-      std::string target_str = use_gpu ? "gpu" : "ref";
-      migraphx::target targ{target_str.c_str()};
       // The hip library will throw a cryptic error if unable to connect with
       // a GPU at this point.
       try {
-        prog_.compile(migraphx::target("gpu"), comp_opts);
+        prog.compile(migraphx::target(this->target_.c_str()), comp_opts);
       } catch (const std::exception& e) {
         std::string emsg = e.what();
-        if (emsg.find("Failed to call function") != std::string::npos) {
+        if (this->target_ == "gpu" &&
+            emsg.find("Failed to call function") != std::string::npos) {
           emsg = emsg + ".  Server could not connect to a GPU.";
         }
         AMDINFER_LOG_ERROR(logger, emsg);
         throw std::runtime_error(emsg);
       }
 
-      // Save the compiled program as a MessagePack (*.mxr) file
-      f = std::ifstream(compiled_path.c_str());
-      if (!f.good()) {
-        migraphx::file_options options;
-        options.set_file_format("msgpack");
-
-        migraphx::save(this->prog_, compiled_path.c_str(), options);
-        AMDINFER_LOG_INFO(logger, std::string(" Saved compiled model file ") +
-                                    compiled_path.c_str());
+      // Save the compiled program as a MessagePack (*.mxr) file in the cache
+      if (!cache_path.empty()) {
+        const auto stored = util::storeInModelCache(
+          cache_path, [&prog](const std::filesystem::path& path) {
+            migraphx::file_options options;
+            options.set_file_format("msgpack");
+            migraphx::save(prog, path.c_str(), options);
+          });
+        if (stored) {
+          AMDINFER_LOG_INFO(logger, "Saved compiled model file " +
+                                      cache_path.string());
+        } else {
+          AMDINFER_LOG_WARN(logger, "Could not save compiled model file " +
+                                      cache_path.string());
+        }
       }
-
+      return prog;
     } else {
       // Not finding the model file makes it impossible to finish initializing
       // this worker
@@ -275,27 +840,199 @@ void MIGraphXWorker::doInit(ParameterMap* parameters) {
                                   " not found or can't be opened");
     }
   }
-  //
-  // Fetch the expected dimensions of the input from the parsed model.
-  migraphx::program_parameter_shapes input_shapes =
-    this->prog_.get_parameter_shapes();
-  const auto* input_name = input_shapes.names()[0];
-  auto sh = input_shapes[input_name];
-  auto length = sh.lengths();
-  migraphx::api::shapes output_shapes = prog_.get_output_shapes();
-  this->batch_size_ = length[0];
+}
 
-  for (const auto* aname : input_shapes.names()) {
-    migraphx::shape ashape = input_shapes[aname];
-    auto llen = ashape.lengths();
-    // size of the buffer needed for this input
-    auto asize = ashape.bytes();
-    // size of a single request input (divide by batch size)
-    input_sizes_[aname] = asize / *(ashape.lengths().begin());
+void MIGraphXWorker::doAcquire(ParameterMap* parameters) {
+  this->shareDevice(this->device_name_, parameters);
+  if (this->offload_copy_) {
+    return;
+  }
+
+  // two slots let the copies of one batch overlap the evaluation of the other.
+  // The buffers are sized for the largest program so they fit all of them
+  constexpr auto kSlots = 2;
+  auto& prog = programs_->programs.rbegin()->second;
+  auto param_shapes = prog.get_parameter_shapes();
+  auto output_shapes = prog.get_output_shapes();
+  if (this->share_workspace_) {
+    // the buffers are aligned as hipMalloc would align them
+    constexpr size_t kAlignment = 256;
+    for (const auto* name : param_shapes.names()) {
+      workspace_offsets_[name] = workspace_bytes_;
+      const auto bytes = param_shapes[name].bytes();
+      workspace_bytes_ += (bytes + kAlignment - 1) / kAlignment * kAlignment;
+    }
+    workspaces_ = WorkspacePool::get(
+      this->device_name_,
+      [device = this->device_](size_t bytes) -> void* {
+        void* data = nullptr;
+        if (hipSetDevice(device) != hipSuccess ||
+            hipMalloc(&data, bytes) != hipSuccess) {
+          return nullptr;
+        }
+        return data;
+      },
+      [](void* data) { (void)hipFree(data); });
+    workspaces_->reserve(workspace_bytes_);
+  }
+  for (auto i = 0; i < kSlots; ++i) {
+    auto slot = std::make_unique<DeviceSlot>();
+    slot->shared = this->share_workspace_;
+    checkHip(hipStreamCreate(&slot->stream), "create a HIP stream");
+    for (const auto* name : param_shapes.names()) {
+      const auto bytes = param_shapes[name].bytes();
+      if (!slot->shared) {
+        checkHip(hipMalloc(&slot->device[name], bytes), "allocate GPU memory");
+      }
+      if (!isOutputParameter(name)) {
+        checkHip(hipHostMalloc(&slot->host_inputs[name], bytes),
+                 "allocate pinned memory");
+      }
+    }
+    for (size_t j = 0; j < output_shapes.size(); ++j) {
+      checkHip(hipHostMalloc(&slot->host_outputs.emplace_back(nullptr),
+                             output_shapes[j].bytes()),
+               "allocate pinned memory");
+    }
+    slots_.push_back(std::move(slot));
+  }
+}
+
+std::vector<Tensor> MIGraphXWorker::getWarmupInputs() const {
+  // the worker's metadata has no inputs so they're read from the program
+  std::vector<Tensor> inputs;
+  auto input_shapes =
+    programs_->programs.rbegin()->second.get_parameter_shapes();
+  for (const auto& name : input_names_) {
+    auto shape = input_shapes[name.c_str()];
+    auto lengths = shape.lengths();
+    // remove the 0'th dimension (batch size) from lengths
+    std::vector<uint64_t> request_shape(lengths.begin() + 1, lengths.end());
+    inputs.emplace_back(name, std::move(request_shape),
+                        toDataType(shape.type()));
+  }
+  return inputs;
+}
+
+std::vector<size_t> MIGraphXWorker::getBatchSizes() const {
+  std::vector<size_t> batch_sizes;
+  batch_sizes.reserve(programs_->programs.size());
+  for (const auto& [batch_size, prog] : programs_->programs) {
+    batch_sizes.push_back(batch_size);
   }
+  return batch_sizes;
 }
 
-void MIGraphXWorker::doAcquire(ParameterMap* parameters) { (void)parameters; }
+std::pair<size_t, migraphx::program*> MIGraphXWorker::getProgram(
+  size_t batch_size) {
+  // batches are never larger than the largest batch size
+  auto& programs = programs_->programs;
+  auto iterator = programs.lower_bound(batch_size);
+  if (iterator == programs.end()) {
+    iterator = std::prev(programs.end());
+  }
+  return {iterator->first, &(iterator->second)};
+}
+
+void MIGraphXWorker::respond(
+  Batch* batch, migraphx::program* prog,
+  const std::vector<migraphx::argument>& migraphx_output,
+  BufferPtrs* device_outputs) {
+#ifdef AMDINFER_ENABLE_LOGGING
+  const auto& logger = this->getLogger();
+#endif
+#ifdef AMDINFER_ENABLE_METRICS
+  util::Timer timer;
+#endif
+  const auto inputs0 = batch->getRequest(0)->getInputs();
+
+  // for each request in the batch
+  for (unsigned int j = 0; j < batch->size(); j++) {
+    const auto& req = batch->getRequest(j);
+    try {
+      InferenceResponse resp;
+      resp.setID(req->getID());
+      resp.setModel("migraphx");
+
+      // Fetch the vector shape, data, etc. for output from the
+      // parsed/compiled model
+      migraphx::api::shapes output_shapes = prog->get_output_shapes();
+
+      //
+      // Transfer the migraphx results to output
+      //
+      size_t result_size =
+        migraphx_output.size();  //   Resnet models have 1 output; yolo and
+                                 //   bert models have 3
+
+      // The $request_output JSON is used to request which output tensors
+      // should be returned from the model. All of them are computed but only
+      // the requested ones are copied out.
+      // https://github.com/kserve/kserve/blob/master/docs/predict-api/v2/required_api.md
+      const auto selected =
+        selectOutputs(*req, {}, result_size, inputs0[0].getName());
+      for (const auto& [i, name] : selected) {
+        // the buffer to populate for return
+        InferenceResponseOutput output;
+
+        migraphx_shape_datatype_t output_type = output_shapes[i].type();
+        amdinfer::DataType output_dt = toDataType(output_type);
+        output.setDatatype(output_dt);
+
+        auto this_output = migraphx_output[i];
+        migraphx::api::shape shape = this_output.get_shape();
+        auto lengths = shape.lengths();
+
+        auto num_results =
+          util::containerProduct(lengths.begin() + 1, lengths.end());
+
+        // remove the 0'th dimension (batch size) from lengths
+        lengths.erase(lengths.begin());
+        // size of each result array, bytes
+        size_t size_of_result = num_results * output_dt.size();
+
+        // pointer to offset in data blob
+        char* results = this_output.data() + j * size_of_result;
+
+        output.setName(name);
+        output.setShape(lengths);
+
+        if (device_outputs != nullptr && !device_outputs->empty()) {
+          this->setOutputBuffer(
+            &output, std::move(device_outputs->at(j * result_size + i)));
+          resp.addOutput(output);
+          continue;
+        }
+
+        // Copy migraphx results to a buffer and add to output
+        std::vector<std::byte> buffer;
+        buffer.resize(size_of_result);
+        memcpy(buffer.data(), results, size_of_result);
+        output.setData(std::move(buffer));
+        resp.addOutput(output);
+      }
+      // respond back to the client
+      req->runCallbackOnce(resp);
+#ifdef AMDINFER_ENABLE_METRICS
+      Metrics::getInstance().incrementCounter(
+        MetricCounterIDs::PipelineEgressWorker);
+      timer.add(util::Mark::Arrival, batch->getTime(j));
+      timer.stop();
+      auto duration =
+        timer.count<std::micro>(util::Mark::Arrival, util::Mark::Stop);
+      Metrics::getInstance().observeSummary(
+        MetricSummaryIDs::RequestLatency, duration);
+#endif
+    } catch (const std::exception& e) {
+      AMDINFER_LOG_ERROR(logger, e.what());
+      // Pass error message back as reply to request; continue processing
+      // more inference requests
+
+      req->runCallbackError(
+        std::string("Error processing Migraphx request: ") + e.what());
+    }
+  }  // end j, request
+}
 
 void MIGraphXWorker::doRun(BatchPtrQueue* input_queue) {
 #ifdef AMDINFER_ENABLE_LOGGING
@@ -304,6 +1041,22 @@ void MIGraphXWorker::doRun(BatchPtrQueue* input_queue) {
   AMDINFER_LOG_INFO(logger, "beginning of MIGraphXWorker::doRun");
 
   util::setThreadName("Migraphx");
+  if (this->target_ == "cpu") {
+    // the thread count is kept by OpenMP per thread so it only applies to the
+    // batches that this thread evaluates
+    if (this->threads_ > 0) {
+      omp_set_num_threads(this->threads_);
+    }
+  } else if (hipSetDevice(this->device_) != hipSuccess) {
+    AMDINFER_LOG_ERROR(logger,
+                       "Could not use GPU " + std::to_string(this->device_));
+  }
+
+  if (!this->offload_copy_) {
+    this->runOnDevice(input_queue);
+    AMDINFER_LOG_INFO(logger, "Migraphx::doRun ending");
+    return;
+  }
 
   // stringstream used for formatting logger messages
   std::string msg;
@@ -324,7 +1077,7 @@ void MIGraphXWorker::doRun(BatchPtrQueue* input_queue) {
     }
     AMDINFER_LOG_INFO(logger, "New batch request in migraphx");
     util::Timer timer;
-    timer.add("batch_start");
+    timer.start();
 #ifdef AMDINFER_ENABLE_METRICS
     Metrics::getInstance().incrementCounter(
       MetricCounterIDs::PipelineIngressWorker);
@@ -341,12 +1094,15 @@ void MIGraphXWorker::doRun(BatchPtrQueue* input_queue) {
     auto inputs0 =
       req0->getInputs();  // const std::vector<InferenceRequestInput>
 
+    // run the batch with the smallest program that fits it
+    auto [program_batch_size, prog] = this->getProgram(batch->size());
+
     try {
       migraphx::program_parameters params;
 
       // populate the migraphx parameters with shape read from the onnx
       // model.
-      auto param_shapes = prog_.get_parameter_shapes();
+      auto param_shapes = prog->get_parameter_shapes();
 
       for (const auto& aninput : inputs0) {  // InferenceRequestInput
         auto aname = aninput.getName();
@@ -391,6 +1147,13 @@ void MIGraphXWorker::doRun(BatchPtrQueue* input_queue) {
         auto* a_data = aninput.getData();  //  void *
         params.add(aname.c_str(), migraphx::argument(modelshape, a_data));
       }
+#ifdef AMDINFER_ENABLE_METRICS
+      // MIGraphX copies all of the program's inputs and outputs in eval()
+      size_t to_device = 0;
+      for (const auto* name : param_shapes.names()) {
+        to_device += param_shapes[name].bytes();
+      }
+#endif
       // If there were fewer requests in the batch than the stated batch size,
       // pad the various input tensors with copies of the 0'th request's data.
 
@@ -407,7 +1170,7 @@ void MIGraphXWorker::doRun(BatchPtrQueue* input_queue) {
           // For each empty slot in buffer, i.e. from end of real requests up to
           // batch size
           for (size_t req_idx = batch->getRequests().size();
-               req_idx < batch_size_; req_idx++) {
+               req_idx < program_batch_size; req_idx++) {
             memcpy(a_data + req_idx * input_sizes_[aname], a_data,
                    input_sizes_[aname]);
           }
@@ -419,125 +1182,47 @@ void MIGraphXWorker::doRun(BatchPtrQueue* input_queue) {
       //
 
       AMDINFER_LOG_INFO(logger, "Beginning migraphx eval");
-      timer.add("eval_start");
-      migraphx::api::arguments migraphx_output = this->prog_.eval(params);
-      timer.add("eval_end");
-      auto eval_duration_us = timer.count<std::micro>("eval_start", "eval_end");
+      timer.add(util::Mark::InferStart);
+      auto migraphx_output = [&]() {
+        const auto turn = this->waitForDevice();
+#ifdef AMDINFER_ENABLE_METRICS
+        const DeviceJob job{this->device_name_};
+#endif
+        const std::lock_guard lock{programs_->mutex};
+        return prog->eval(params);
+      }();
+      timer.add(util::Mark::InferStop);
+#ifdef AMDINFER_ENABLE_METRICS
+      size_t to_host = 0;
+      for (size_t i = 0; i < migraphx_output.size(); i++) {
+        to_host += migraphx_output[i].get_shape().bytes();
+      }
+      auto& metrics = Metrics::getInstance();
+      metrics.addDeviceTransfer(this->device_name_,
+                                DeviceTransfer::HostToDevice, to_device);
+      metrics.addDeviceTransfer(this->device_name_,
+                                DeviceTransfer::DeviceToHost, to_host);
+#endif
+      auto eval_duration_us = timer.count<std::micro>(util::Mark::InferStart,
+                                                      util::Mark::InferStop);
       [[maybe_unused]] auto eval_duration_s = eval_duration_us / std::mega::num;
       AMDINFER_LOG_INFO(
         logger, std::string("Finished migraphx eval; batch size: ") +
-                  std::to_string(batch_size_) + "  elapsed time: " +
+                  std::to_string(program_batch_size) + "  elapsed time: " +
                   std::to_string(eval_duration_us) + " us.  Images/sec: " +
-                  std::to_string(batch_size_ / (eval_duration_s)));
+                  std::to_string(program_batch_size / (eval_duration_s)));
 
       //
       //           Fetch the results and populate response to each request in
       //           the batch
       //
 
-      // for each request in the batch
-      for (unsigned int j = 0; j < batch->size(); j++) {
-        const auto& req = batch->getRequest(j);
-        try {
-          InferenceResponse resp;
-          resp.setID(req->getID());
-          resp.setModel("migraphx");
-
-          // We don't use the outputs portion of the request currently.  It is
-          // part of the kserve format specification, which the Inference Server
-          // is intended to follow. "The $request_output JSON is used to request
-          // which output tensors should be returned from the model."
-          // https://github.com/kserve/kserve/blob/master/docs/predict-api/v2/required_api.md
-          //
-          // Selecting the request output is only relevant to models that have
-          // more than one output tensor.
-          //
-
-          // Fetch the vector shape, data, etc. for output from the
-          // parsed/compiled model
-          migraphx::api::shapes output_shapes = prog_.get_output_shapes();
-
-          //
-          // Transfer the migraphx results to output
-          //
-          size_t result_size =
-            migraphx_output.size();  //   Resnet models have 1 output; yolo and
-                                     //   bert models have 3
-
-          // For each output channel in result:
-          //
-          for (size_t i = 0; i < result_size; i++) {
-            // the buffer to populate for return
-            InferenceResponseOutput output;
-
-            migraphx_shape_datatype_t output_type = output_shapes[i].type();
-            amdinfer::DataType output_dt = toDataType(output_type);
-            output.setDatatype(output_dt);
-
-            auto this_output = migraphx_output[i];
-            migraphx::api::shape shape = this_output.get_shape();
-            auto lengths = shape.lengths();
-
-            auto num_results =
-              util::containerProduct(lengths.begin() + 1, lengths.end());
-
-            // remove the 0'th dimension (batch size) from lengths
-            lengths.erase(lengths.begin());
-            // size of each result array, bytes
-            size_t size_of_result = num_results * output_dt.size();
-
-            // pointer to offset in data blob
-            char* results = this_output.data() + j * size_of_result;
-
-            // the kserve specification for response output is at
-            // https://github.com/kserve/kserve/blob/master/docs/predict-api/v2/required_api.md#response-output
-            //
-            // The outputs buffer in the InferenceRequest is not used or
-            // enforced at the time of writing this, but here it is. Give the
-            // output a default name if necessary.
-            auto outputs =
-              req->getOutputs();  // one result vector for each request
-
-            std::string output_name;
-            if (i < outputs.size()) {
-              output_name = outputs[i].getName();
-            }
-
-            if (output_name.empty()) {
-              output.setName(inputs0[0].getName());
-            } else {
-              output.setName(output_name);
-            }
-            output.setShape(lengths);
-
-            // Copy migraphx results to a buffer and add to output
-            std::vector<std::byte> buffer;
-            buffer.resize(size_of_result);
-            memcpy(buffer.data(), results, size_of_result);
-            output.setData(std::move(buffer));
-            resp.addOutput(output);
-          }
-          // respond back to the client
-          req->runCallbackOnce(resp);
-#ifdef AMDINFER_ENABLE_METRICS
-          Metrics::getInstance().incrementCounter(
-            MetricCounterIDs::PipelineEgressWorker);
-          timer.add("batch_time", batch->getTime(j));
-          timer.add("request_latency");
-          auto duration =
-            timer.count<std::micro>("batch_time", "request_latency");
-          Metrics::getInstance().observeSummary(
-            MetricSummaryIDs::RequestLatency, duration);
-#endif
-        } catch (const std::exception& e) {
-          AMDINFER_LOG_ERROR(logger, e.what());
-          // Pass error message back as reply to request; continue processing
-          // more inference requests
-
-          req->runCallbackError(
-            std::string("Error processing Migraphx request: ") + e.what());
-        }
-      }  // end j, request
+      std::vector<migraphx::argument> outputs;
+      outputs.reserve(migraphx_output.size());
+      for (size_t i = 0; i < migraphx_output.size(); i++) {
+        outputs.push_back(migraphx_output[i]);
+      }
+      this->respond(batch.get(), prog, outputs);
     } catch (const std::exception& e) {
       // This outer catch block catches exceptions in evaluation of the batch.
       AMDINFER_LOG_ERROR(logger, e.what());
@@ -549,19 +1234,344 @@ void MIGraphXWorker::doRun(BatchPtrQueue* input_queue) {
       }
     }
 
-    timer.add("batch_stop");
+    timer.stop();
     this->returnInputBuffers(std::move(batch));
-    [[maybe_unused]] auto duration =
-      timer.count<std::micro>("batch_start", "batch_stop");
+    [[maybe_unused]] auto duration = timer.count<std::micro>();
     AMDINFER_LOG_INFO(
       logger, std::string("Finished migraphx batch processing; batch size: ") +
-                std::to_string(batch_size_) +
+                std::to_string(program_batch_size) +
                 "  elapsed time: " + std::to_string(duration) + " us");
   }  // end while (batch)
   AMDINFER_LOG_INFO(logger, "Migraphx::doRun ending");
 }
 
-void MIGraphXWorker::doRelease() {}
+void MIGraphXWorker::runOnDevice(BatchPtrQueue* input_queue) {
+  // the next batch is launched before waiting for the one in flight so its
+  // copies overlap the other's evaluation. If no batch is waiting, the one in
+  // flight is finished right away instead of waiting for the next batch
+  DeviceSlot* in_flight = nullptr;
+  size_t next = 0;
+  while (true) {
+    BatchPtr batch;
+    if (in_flight == nullptr) {
+      input_queue->wait_dequeue(batch);
+    } else if (!input_queue->try_dequeue(batch)) {
+      this->finish(in_flight);
+      in_flight = nullptr;
+      continue;
+    }
+    if (batch == nullptr) {
+      break;
+    }
+
+    // the batch in flight is finished before waiting for a turn on the GPU so
+    // the endpoints whose turn it is aren't held up by it
+    auto turn = this->tryDevice();
+    if (!turn.has_value() && in_flight != nullptr) {
+      this->finish(in_flight);
+      in_flight = nullptr;
+    }
+
+    auto* slot = slots_[next].get();
+    next = (next + 1) % slots_.size();
+    slot->turn =
+      turn.has_value() ? std::move(*turn) : this->waitForDevice();
+    this->launch(slot, std::move(batch));
+    if (in_flight != nullptr) {
+      this->finish(in_flight);
+    }
+    // the slot has no batch if it failed to launch
+    if (slot->batch == nullptr) {
+      slot->turn.release();
+    }
+    in_flight = slot->batch != nullptr ? slot : nullptr;
+  }
+  if (in_flight != nullptr) {
+    this->finish(in_flight);
+  }
+}
+
+void MIGraphXWorker::leaseWorkspace(DeviceSlot* slot) {
+  slot->workspace = workspaces_->acquire();
+  auto* base = static_cast<std::byte*>(slot->workspace.data());
+  for (const auto& [name, offset] : workspace_offsets_) {
+    slot->device[name] = base + offset;
+  }
+}
+
+void MIGraphXWorker::launch(DeviceSlot* slot, BatchPtr batch) {
+#ifdef AMDINFER_ENABLE_LOGGING
+  const auto& logger = this->getLogger();
+#endif
+#ifdef AMDINFER_ENABLE_METRICS
+  Metrics::getInstance().incrementCounter(
+    MetricCounterIDs::PipelineIngressWorker);
+#endif
+
+  // run the batch with the smallest program that fits it
+  auto [program_batch_size, prog] = this->getProgram(batch->size());
+  if (slot->shared) {
+    try {
+      this->leaseWorkspace(slot);
+    } catch (const std::exception& e) {
+      AMDINFER_LOG_ERROR(logger, e.what());
+      for (const auto& req : batch->getRequests()) {
+        req->runCallbackError(std::string("Migraphx inference error: ") +
+                              e.what());
+      }
+      this->returnInputBuffers(std::move(batch));
+      return;
+    }
+  }
+
+#ifdef AMDINFER_ENABLE_METRICS
+  // the job is finished once its stream is synchronized
+  Metrics::getInstance().startDeviceJob(this->device_name_);
+#endif
+  [[maybe_unused]] size_t to_device = 0;
+  [[maybe_unused]] size_t to_host = 0;
+  try {
+    auto param_shapes = prog->get_parameter_shapes();
+
+    // inputs that are read in place from the GPU instead of being copied to
+    // the slot's buffers
+    std::map<std::string, void*> bound;
+    const auto inputs0 = batch->getRequest(0)->getInputs();
+    for (auto index = 0U; index < inputs0.size(); ++index) {
+      const auto& aninput = inputs0[index];
+      // if there's only 1 input then the name in the request isn't required
+      // to match
+      const auto aname =
+        inputs0.size() == 1 ? input_names_.front() : aninput.getName();
+      auto host_input = slot->host_inputs.find(aname);
+      if (host_input == slot->host_inputs.end()) {
+        throw invalid_argument("Migraph worker model has no input " + aname);
+      }
+      migraphx::shape modelshape = param_shapes[aname.c_str()];
+      const auto model_type = toDataType(modelshape.type());
+
+      // each request's data is in its own segment in scatter-gather batches
+      // and otherwise, the 0'th request's data is the start of the batch's.
+      // Requests of other types that can be converted to the model's are
+      // converted as they're staged
+      const auto request_size = input_sizes_.at(aname);
+      std::vector<const std::byte*> requests;
+      std::vector<const InputCast*> casts;
+      requests.reserve(batch->size());
+      casts.reserve(batch->size());
+      for (size_t req_idx = 0; req_idx < batch->size(); req_idx++) {
+        const auto& request = *batch->getRequest(req_idx);
+        const auto* cast = findCast(input_casts_, request, index);
+        if (cast == nullptr &&
+            request.getInputs()[index].getDatatype() != model_type) {
+          throw invalid_argument("Migraph worker model and input data types "
+                                 "don't match for input " +
+                                 aname);
+        }
+        casts.push_back(cast);
+        requests.push_back(
+          batch->isScatterGather()
+            ? static_cast<const std::byte*>(
+                batch->getSegments(index)[req_idx].data)
+            : static_cast<const std::byte*>(aninput.getData()) +
+                req_idx * request_size);
+      }
+
+      // a request that fills the program and is already on this GPU, such as
+      // one in GPU shared memory, is bound without any copies
+      if (requests.size() == 1 && program_batch_size == 1 &&
+          casts[0] == nullptr &&
+          getPointerDevice(requests[0]) == this->device_) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+        bound.emplace(aname, const_cast<std::byte*>(requests[0]));
+        continue;
+      }
+
+      // requests on the host are staged in pinned memory and copied to the
+      // GPU together while those on a GPU are copied there directly. Unused
+      // request slots are padded with copies of the first request if needed
+      auto* host = static_cast<std::byte*>(host_input->second);
+      auto* device = static_cast<std::byte*>(slot->device.at(aname));
+      const auto slots = pad_batch_ ? program_batch_size : requests.size();
+      size_t staged = 0;
+      auto copy_staged = [&](size_t end) {
+        if (end > staged) {
+          checkHip(hipMemcpyAsync(device + staged * request_size,
+                                  host + staged * request_size,
+                                  (end - staged) * request_size,
+                                  hipMemcpyHostToDevice, slot->stream),
+                   "copy an input to the GPU");
+          to_device += (end - staged) * request_size;
+        }
+      };
+      for (size_t req_idx = 0; req_idx < slots; req_idx++) {
+        const auto source = req_idx < requests.size() ? req_idx : 0;
+        const auto* data = requests[source];
+        const auto* cast = casts[source];
+        if (getPointerDevice(data) < 0) {
+          if (cast == nullptr) {
+            memcpy(host + req_idx * request_size, data, request_size);
+          } else {
+            const auto& input = batch->getRequest(source)->getInputs()[index];
+            castInput(input, data, *cast, host + req_idx * request_size);
+          }
+          continue;
+        }
+        if (cast != nullptr) {
+          throw invalid_argument(
+            "Inputs on the GPU must match the type of the model's input " +
+            aname);
+        }
+        copy_staged(req_idx);
+        staged = req_idx + 1;
+        checkHip(hipMemcpyAsync(device + req_idx * request_size, data,
+                                request_size, hipMemcpyDefault, slot->stream),
+                 "copy an input on the GPU");
+      }
+      copy_staged(slots);
+    }
+
+    // the smaller programs use the start of the largest program's buffers
+    migraphx::program_parameters params;
+    for (const auto* name : param_shapes.names()) {
+      auto in_place = bound.find(name);
+      params.add(name, migraphx::argument(param_shapes[name],
+                                          in_place != bound.end()
+                                            ? in_place->second
+                                            : slot->device.at(name)));
+    }
+    auto results = prog->run_async(params, slot->stream);
+    if (device_outputs_) {
+      slot->device_outputs = this->getDeviceOutputs(results, batch->size());
+    }
+    for (size_t i = 0; i < results.size(); i++) {
+      auto result = results[i];
+      if (slot->device_outputs.empty()) {
+        checkHip(hipMemcpyAsync(slot->host_outputs.at(i), result.data(),
+                                result.get_shape().bytes(),
+                                hipMemcpyDeviceToHost, slot->stream),
+                 "copy an output from the GPU");
+        to_host += result.get_shape().bytes();
+        continue;
+      }
+      // the programs' output buffers are reused by the next batch so each
+      // request's part is copied out on the device
+      const auto request_bytes =
+        result.get_shape().bytes() / program_batch_size;
+      for (size_t j = 0; j < batch->size(); j++) {
+        checkHip(
+          hipMemcpyAsync(
+            slot->device_outputs.at(j * results.size() + i)->data(0),
+            result.data() + j * request_bytes, request_bytes,
+            hipMemcpyDeviceToDevice, slot->stream),
+          "copy an output on the GPU");
+      }
+    }
+  } catch (const std::exception& e) {
+    AMDINFER_LOG_ERROR(logger, e.what());
+    // the copies already queued may still read the staging buffers
+    (void)hipStreamSynchronize(slot->stream);
+    slot->workspace.release();
+    this->returnDeviceOutputs(&slot->device_outputs);
+#ifdef AMDINFER_ENABLE_METRICS
+    Metrics::getInstance().finishDeviceJob(this->device_name_);
+#endif
+    for (const auto& req : batch->getRequests()) {
+      req->runCallbackError(std::string("Migraphx inference error: ") +
+                            e.what());
+    }
+    this->returnInputBuffers(std::move(batch));
+    return;
+  }
+
+#ifdef AMDINFER_ENABLE_METRICS
+  auto& metrics = Metrics::getInstance();
+  metrics.addDeviceTransfer(this->device_name_, DeviceTransfer::HostToDevice,
+                            to_device);
+  metrics.addDeviceTransfer(this->device_name_, DeviceTransfer::DeviceToHost,
+                            to_host);
+#endif
+
+  // the inputs are staged so their buffers can be reused right away
+  for (auto& buffer : batch->getInputBuffers()) {
+    pool_->put(std::move(buffer));
+  }
+  slot->batch = std::move(batch);
+  slot->prog = prog;
+}
+
+void MIGraphXWorker::finish(DeviceSlot* slot) {
+#ifdef AMDINFER_ENABLE_LOGGING
+  const auto& logger = this->getLogger();
+#endif
+  auto batch = std::move(slot->batch);
+  try {
+    const auto status = hipStreamSynchronize(slot->stream);
+    slot->turn.release();
+    // the outputs are copied out of the workspace so it's free for the next
+    // job on the GPU
+    slot->workspace.release();
+#ifdef AMDINFER_ENABLE_METRICS
+    Metrics::getInstance().finishDeviceJob(this->device_name_);
+#endif
+    checkHip(status, "run the batch");
+
+    auto output_shapes = slot->prog->get_output_shapes();
+    std::vector<migraphx::argument> outputs;
+    outputs.reserve(output_shapes.size());
+    for (size_t i = 0; i < output_shapes.size(); i++) {
+      outputs.emplace_back(output_shapes[i], slot->host_outputs.at(i));
+    }
+    this->respond(batch.get(), slot->prog, outputs, &slot->device_outputs);
+  } catch (const std::exception& e) {
+    AMDINFER_LOG_ERROR(logger, e.what());
+    for (const auto& req : batch->getRequests()) {
+      req->runCallbackError(std::string("Migraphx inference error: ") +
+                            e.what());
+    }
+  }
+  // the requests that failed didn't take their buffers
+  this->returnDeviceOutputs(&slot->device_outputs);
+}
+
+BufferPtrs MIGraphXWorker::getDeviceOutputs(const migraphx::arguments& results,
+                                            size_t requests) {
+  BufferPtrs buffers;
+  buffers.reserve(requests * results.size());
+  try {
+    for (size_t j = 0; j < requests; j++) {
+      for (size_t i = 0; i < results.size(); i++) {
+        auto shape = results[i].get_shape();
+        auto lengths = shape.lengths();
+        const Tensor tensor{
+          "", std::vector<uint64_t>(lengths.begin() + 1, lengths.end()),
+          toDataType(shape.type())};
+        // the buffers are on this thread's GPU, which is the worker's
+        buffers.push_back(pool_->get({MemoryAllocators::HipDevice}, tensor, 1));
+      }
+    }
+  } catch (const runtime_error&) {
+    this->returnDeviceOutputs(&buffers);
+  }
+  return buffers;
+}
+
+void MIGraphXWorker::returnDeviceOutputs(BufferPtrs* buffers) {
+  for (auto& buffer : *buffers) {
+    if (buffer != nullptr) {
+      pool_->put(std::move(buffer));
+    }
+  }
+  buffers->clear();
+}
+
+void MIGraphXWorker::doRelease() {
+  slots_.clear();
+  if (workspaces_ != nullptr) {
+    workspaces_->unreserve(workspace_bytes_);
+    workspaces_ = nullptr;
+  }
+}
 void MIGraphXWorker::doDestroy() {}
 
 }  // namespace amdinfer::workers
@@ -569,7 +1579,7 @@ void MIGraphXWorker::doDestroy() {}
 extern "C" {
 // using smart pointer here may cause problems inside shared object so managing
 // manually
-amdinfer::workers::Worker* getWorker() {
+amdinfer::workers::Worker* AMDINFER_WORKER_FACTORY() {
   return new amdinfer::workers::MIGraphXWorker("MIGraphX", "gpu");
 }
 }  // extern C
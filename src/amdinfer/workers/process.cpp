@@ -0,0 +1,383 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the Process worker, which runs another worker in a child
+ * process of the server
+ */
+
+#include <spawn.h>     // for posix_spawnp
+#include <sys/wait.h>  // for waitpid, WNOHANG
+#include <unistd.h>    // for getpid, pid_t
+
+#include <atomic>         // for atomic, atomic_bool
+#include <chrono>         // for milliseconds
+#include <csignal>        // for kill, SIGKILL
+#include <cstdint>        // for uint64_t, int32_t
+#include <cstdlib>        // for getenv
+#include <cstring>        // for strerror
+#include <memory>         // for unique_ptr, make_unique
+#include <mutex>          // for mutex, lock_guard
+#include <optional>       // for optional
+#include <ratio>          // for micro
+#include <string>         // for string, to_string
+#include <thread>         // for thread, sleep_for
+#include <unordered_map>  // for unordered_map
+#include <utility>        // for move
+#include <vector>         // for vector
+
+#include "amdinfer/batching/soft.hpp"            // for SoftBatcher
+#include "amdinfer/build_options.hpp"            // for AMDINFER_ENABLE_ME...
+#include "amdinfer/core/exceptions.hpp"          // for runtime_error
+#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/core/parameters.hpp"          // for ParameterMap
+#include "amdinfer/core/process_channel.hpp"     // for ProcessChannel
+#include "amdinfer/core/wire_format.hpp"         // for encodeRequest
+#include "amdinfer/declarations.hpp"             // for InferenceRequestPtr
+#include "amdinfer/observation/logging.hpp"      // for Logger
+#include "amdinfer/observation/metrics.hpp"      // for Metrics
+#include "amdinfer/util/thread.hpp"              // for setThreadName
+#include "amdinfer/util/timer.hpp"               // for Timer, TimePoint
+#include "amdinfer/workers/worker.hpp"           // for Worker
+
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+extern char** environ;
+
+namespace amdinfer::workers {
+
+namespace {
+
+/// The environment variable with the path of the server to start hosts with
+constexpr auto kWorkerHostEnv = "AMDINFER_WORKER_HOST";
+/// How often the waiting threads check if the host is still running
+constexpr std::chrono::milliseconds kPoll{100};
+/// How long a host has to stop once its channel is closed before it's killed
+constexpr std::chrono::milliseconds kExitTimeout{5000};
+constexpr size_t kMegabyte = 1024 * 1024;
+
+/// The parameters that the endpoint applies in the server so they aren't also
+/// applied to the hosted worker
+const std::vector<std::string> kServerParameters{
+  "process",           "worker",           "process_memory_mb",
+  "instance",          "share",            "preprocess",
+  "response_cache_mb", "coalesce",         "max_queue_size",
+  "max_queue_mb",      "drain_timeout_ms", "trace_latency_ms",
+  "min_instances",     "max_instances"};
+
+/// Check if a process has exited, reaping it if it has
+bool hasExited(pid_t pid) {
+  int status = 0;
+  return waitpid(pid, &status, WNOHANG) == pid;
+}
+
+}  // namespace
+
+/**
+ * @brief The Process worker runs another worker in a child process, which is
+ * the server started as a host of that worker, so a worker that crashes or
+ * leaks takes down its own process and not the server's. The two processes
+ * are connected by a ProcessChannel in shared memory. Requests are written
+ * into it once, straight from their clients' buffers, and read in place by
+ * the host, which batches them for the worker as usual. The worker is loaded
+ * with the "process" parameter and otherwise takes the same parameters.
+ */
+class Process : public Worker {
+ public:
+  using Worker::Worker;
+  std::thread spawn(BatchPtrQueue* input_queue) override;
+  [[nodiscard]] std::vector<MemoryAllocators> getAllocators() const override;
+  [[nodiscard]] bool acceptsScatterGather() const override;
+
+ private:
+  struct Pending {
+    InferenceRequestPtr request;
+#ifdef AMDINFER_ENABLE_METRICS
+    util::TimePoint start;
+#endif
+  };
+
+  void doInit(ParameterMap* parameters) override;
+  void doAcquire(ParameterMap* parameters) override;
+  void doRun(BatchPtrQueue* input_queue) override;
+  void doRelease() override;
+  void doDestroy() override;
+
+  // the host batches the requests for its worker
+  using Worker::makeBatcher;
+  std::vector<std::unique_ptr<Batcher>> makeBatcher(int num,
+                                                    ParameterMap* parameters,
+                                                    MemoryPool* pool) override {
+    return this->makeBatcher<SoftBatcher>(num, parameters, pool);
+  }
+  // the host warms up and allocates for the worker
+  [[nodiscard]] std::vector<Tensor> getWarmupInputs() const override {
+    return {};
+  }
+  [[nodiscard]] std::vector<BufferDemand> getBufferDemands() const override {
+    return {};
+  }
+
+  /// Start the host and wait for it to load the worker
+  void start();
+  /// Pass the responses from the host to the requests' callbacks
+  void respond();
+  /// Fail the requests that are waiting on the host
+  void failPending(const std::string& error);
+  /// Stop the host once its channel is closed, killing it if it doesn't stop
+  void stop();
+
+  std::string worker_;
+  std::string host_;
+  size_t bytes_ = kDefaultChannelBytes;
+  /// the parameters to load the worker with in the host
+  ParameterMap parameters_;
+  std::unique_ptr<ProcessChannel> channel_;
+  pid_t child_ = -1;
+  std::atomic_bool exited_ = false;
+  std::thread responder_;
+  std::mutex mutex_;
+  std::unordered_map<uint64_t, Pending> pending_;
+  uint64_t next_tag_ = 1;
+};
+
+std::thread Process::spawn(BatchPtrQueue* input_queue) {
+  return std::thread(&Process::run, this, input_queue);
+}
+
+std::vector<MemoryAllocators> Process::getAllocators() const {
+  return {MemoryAllocators::Cpu};
+}
+
+// requests are written into the channel from wherever their inputs are
+bool Process::acceptsScatterGather() const { return true; }
+
+void Process::doInit(ParameterMap* parameters) {
+  if (!parameters->has("worker")) {
+    throw invalid_argument("The process worker needs a worker to host");
+  }
+  worker_ = parameters->get<std::string>("worker");
+  if (parameters->has("process_memory_mb")) {
+    const auto megabytes = parameters->get<int32_t>("process_memory_mb");
+    if (megabytes <= 0) {
+      throw invalid_argument("The process memory must be positive");
+    }
+    bytes_ = static_cast<size_t>(megabytes) * kMegabyte;
+  }
+  const auto* host = std::getenv(kWorkerHostEnv);
+  host_ = host == nullptr ? "amdinfer-server" : host;
+
+  parameters_ = *parameters;
+  for (const auto& key : kServerParameters) {
+    parameters_.erase(key);
+  }
+  // the server batches for the host only to hand over one request at a time
+  this->batch_size_ = 1;
+}
+
+void Process::doAcquire(ParameterMap* parameters) {
+  (void)parameters;  // suppress unused variable warning
+
+  static std::atomic<uint64_t> count = 0;
+  const auto name = "/amdinfer-" + std::to_string(getpid()) + "-" +
+                    std::to_string(count.fetch_add(1));
+  channel_ = std::make_unique<ProcessChannel>(name, bytes_);
+  try {
+    start();
+  } catch (...) {
+    channel_->close();
+    if (child_ > 0 && !exited_) {
+      stop();
+    }
+    throw;
+  }
+  // both processes have it mapped so the name isn't needed anymore
+  channel_->unlink();
+  responder_ = std::thread{&Process::respond, this};
+}
+
+void Process::start() {
+  std::string flag = "--worker-host";
+  auto name = channel_->getName();
+  std::vector<char*> argv{host_.data(), flag.data(), name.data(), nullptr};
+  if (const auto error = posix_spawnp(&child_, host_.c_str(), nullptr,
+                                      nullptr, argv.data(), environ);
+      error != 0) {
+    child_ = -1;
+    throw runtime_error("Could not start " + host_ + " to host " + worker_ +
+                        ": " + std::strerror(error));
+  }
+
+  InferenceRequest load;
+  load.setParameters(parameters_);
+  channel_->send(encodeRequest(0, worker_, load));
+
+  std::optional<ChannelMessage> reply;
+  while (!reply.has_value()) {
+    reply = channel_->receive(kPoll);
+    if (!reply.has_value() && hasExited(child_)) {
+      exited_ = true;
+      throw runtime_error("The process hosting " + worker_ +
+                          " exited while loading it");
+    }
+  }
+  const auto response = decodeResponse(reply->header, reply->body);
+  // the name and platform are the hosted worker's
+  this->metadata_ = readModel(response);
+}
+
+void Process::doRun(BatchPtrQueue* input_queue) {
+  util::setThreadName("Process");
+
+  while (true) {
+    BatchPtr batch;
+    input_queue->wait_dequeue(batch);
+    if (batch == nullptr) {
+      break;
+    }
+#ifdef AMDINFER_ENABLE_METRICS
+    Metrics::getInstance().incrementCounter(
+      MetricCounterIDs::PipelineIngressWorker);
+#endif
+    for (unsigned int j = 0; j < batch->size(); j++) {
+      const auto& req = batch->getRequest(j);
+      uint64_t tag = 0;
+      {
+        std::lock_guard lock{mutex_};
+        tag = next_tag_++;
+#ifdef AMDINFER_ENABLE_METRICS
+        pending_.try_emplace(tag, Pending{req, batch->getTime(j)});
+#else
+        pending_.try_emplace(tag, Pending{req});
+#endif
+      }
+      bool sent = false;
+      std::string error = "The process hosting " + worker_ + " has stopped";
+      try {
+        sent = channel_->send(encodeRequest(tag, worker_, *req));
+      } catch (const invalid_argument& e) {
+        error = e.what();
+      }
+      if (!sent) {
+        bool pending = false;
+        {
+          std::lock_guard lock{mutex_};
+          pending = pending_.erase(tag) != 0;
+        }
+        // the responder fails the pending requests if the host has exited
+        if (pending) {
+          req->runCallbackError(error);
+        }
+      }
+    }
+    // the inputs were copied into the channel so they can be released now
+    this->returnInputBuffers(std::move(batch));
+  }
+}
+
+void Process::respond() {
+  util::setThreadName("ProcessReply");
+#ifdef AMDINFER_ENABLE_LOGGING
+  const auto& logger = this->getLogger();
+#endif
+
+  while (!channel_->isClosed()) {
+    auto message = channel_->receive(kPoll);
+    if (!message.has_value()) {
+      if (!channel_->isClosed() && hasExited(child_)) {
+        exited_ = true;
+        AMDINFER_LOG_ERROR(logger,
+                           "The process hosting " + worker_ + " exited");
+        channel_->close();
+      }
+      continue;
+    }
+    Pending pending;
+    {
+      std::lock_guard lock{mutex_};
+      auto node = pending_.extract(message->header.tag);
+      if (node.empty()) {
+        continue;
+      }
+      pending = std::move(node.mapped());
+    }
+    // the response is copied out so responses that are kept, such as in the
+    // cache, don't hold the channel's memory
+    const auto response = decodeResponse(message->header, message->body);
+    message.reset();
+    pending.request->runCallbackOnce(response);
+#ifdef AMDINFER_ENABLE_METRICS
+    Metrics::getInstance().incrementCounter(
+      MetricCounterIDs::PipelineEgressWorker);
+    util::Timer timer{pending.start};
+    timer.stop();
+    Metrics::getInstance().observeSummary(MetricSummaryIDs::RequestLatency,
+                                          timer.count<std::micro>());
+#endif
+  }
+  failPending("The process hosting " + worker_ + " has stopped");
+}
+
+void Process::failPending(const std::string& error) {
+  std::unordered_map<uint64_t, Pending> pending;
+  {
+    std::lock_guard lock{mutex_};
+    pending.swap(pending_);
+  }
+  for (auto& [tag, request] : pending) {
+    request.request->runCallbackError(error);
+  }
+}
+
+void Process::stop() {
+  const auto deadline = util::getTime() + kExitTimeout;
+  while (!hasExited(child_)) {
+    if (util::getTime() >= deadline) {
+      kill(child_, SIGKILL);
+      int status = 0;
+      waitpid(child_, &status, 0);
+      break;
+    }
+    std::this_thread::sleep_for(kPoll);
+  }
+  exited_ = true;
+}
+
+void Process::doRelease() {
+  if (channel_ == nullptr) {
+    return;
+  }
+  // the host unloads its worker and exits once it sees the channel close
+  channel_->close();
+  if (responder_.joinable()) {
+    responder_.join();
+  }
+  if (!exited_) {
+    stop();
+  }
+  channel_.reset();
+}
+
+void Process::doDestroy() {}
+
+}  // namespace amdinfer::workers
+
+extern "C" {
+// using smart pointer here may cause problems inside shared object so managing
+// manually
+amdinfer::workers::Worker* AMDINFER_WORKER_FACTORY() {
+  return new amdinfer::workers::Process("process", "cpu");
+}
+}  // extern C
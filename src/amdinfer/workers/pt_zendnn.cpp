@@ -17,35 +17,42 @@
  * @brief Implements the PtZendnn worker
  */
 
-#include <algorithm>   // for copy
+#include <algorithm>   // for copy, min
 #include <cstddef>     // for size_t, byte
 #include <cstdint>     // for int32_t, uint64_t
 #include <cstring>     // for memcpy
 #include <exception>   // for exception
 #include <filesystem>  // for path, exists, filesystem
-#include <memory>      // for unique_ptr, allocator
+#include <memory>      // for unique_ptr, shared_ptr
 #include <ratio>       // for milli, micro
 #include <string>      // for string, operator+, to_s...
 #include <thread>      // for thread
 #include <utility>     // for move
 #include <vector>      // for vector
 
+#include "ATen/Parallel.h"               // for set_num_threads
+#include "caffe2/serialize/read_adapter_interface.h"  // for ReadAdapterInt...
 #include "amdinfer/batching/hard.hpp"    // for Batch, BatchPtrQueue
+#include "amdinfer/batching/input_cast.hpp"  // for InputCast, InputLayout
 #include "amdinfer/build_options.hpp"    // for AMDINFER_ENABLE_LOGGING
 #include "amdinfer/core/data_types.hpp"  // for DataType, DataType::FP32
 #include "amdinfer/core/exceptions.hpp"  // for external_error, file_no...
 #include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
 #include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/core/model_artifacts.hpp"     // for getModelArtifact
 #include "amdinfer/core/parameters.hpp"          // for ParameterMap
 #include "amdinfer/declarations.hpp"             // for InferenceResponseOutput
 #include "amdinfer/observation/logging.hpp"  // for Logger, AMDINFER_LOG_INFO
 #include "amdinfer/observation/metrics.hpp"  // for Metrics, MetricCounterIDs
 #include "amdinfer/observation/tracing.hpp"  // for Trace
 #include "amdinfer/util/containers.hpp"      // for containerProduct
+#include "amdinfer/util/mapped_file.hpp"     // for MappedFile
+#include "amdinfer/util/model_cache.hpp"     // for getModelCachePath
 #include "amdinfer/util/thread.hpp"          // for setThreadName
 #include "amdinfer/util/timer.hpp"           // for Timer
 #include "amdinfer/workers/worker.hpp"       // for Worker, kNumBufferAuto
 #include "torch/script.h"                    // for IValue, Tensor, Device
+#include "torch/version.h"                   // for TORCH_VERSION
 
 namespace fs = std::filesystem;
 
@@ -55,6 +62,65 @@ const int kResNetImageSize = 224;
 const int kResNetImageChannels = 3;
 const int kResNetOutputClasses = 1000;
 
+/// The precisions the model can run in
+enum class Precision { Fp32, Bf16, Int8 };
+
+Precision parsePrecision(const std::string& precision) {
+  if (precision == "fp32") {
+    return Precision::Fp32;
+  }
+  if (precision == "bf16") {
+    return Precision::Bf16;
+  }
+  if (precision == "int8") {
+    return Precision::Int8;
+  }
+  throw invalid_argument("Unsupported precision " + precision +
+                         ". Use fp32, bf16 or int8");
+}
+
+const char* toString(Precision precision) {
+  switch (precision) {
+    case Precision::Bf16:
+      return "bf16";
+    case Precision::Int8:
+      return "int8";
+    default:
+      return "fp32";
+  }
+}
+
+/**
+ * @brief Reads a model for torch from a file that's mapped into memory so
+ * torch copies its records straight out of the page cache
+ */
+class MappedReadAdapter : public caffe2::serialize::ReadAdapterInterface {
+ public:
+  explicit MappedReadAdapter(const fs::path& path) : file_(path) {}
+
+  [[nodiscard]] size_t size() const override { return file_.size(); }
+
+  size_t read(uint64_t pos, void* buf, size_t n,
+              const char* what) const override {
+    (void)what;  // suppress unused variable warning
+    if (pos >= file_.size()) {
+      return 0;
+    }
+    n = std::min(n, static_cast<size_t>(file_.size() - pos));
+    std::memcpy(buf, file_.data() + pos, n);
+    return n;
+  }
+
+ private:
+  util::MappedFile file_;
+};
+
+/// Load a TorchScript model onto the CPU from a mapping of its file
+torch::jit::Module loadModule(const fs::path& path) {
+  return torch::jit::load(std::make_shared<MappedReadAdapter>(path),
+                          torch::kCPU);
+}
+
 /**
  * @brief The PtZendnn worker is a simple worker that accepts a single uint32_t
  * argument and adds 1 to it and returns. It accepts multiple input tensors and
@@ -66,6 +132,8 @@ class PtZendnn : public Worker {
   using Worker::Worker;
   std::thread spawn(BatchPtrQueue* input_queue) override;
   [[nodiscard]] std::vector<MemoryAllocators> getAllocators() const override;
+  [[nodiscard]] bool acceptsScatterGather() const override;
+  [[nodiscard]] std::vector<InputCast> getInputCasts() const override;
 
  private:
   void doInit(ParameterMap* parameters) override;
@@ -74,6 +142,9 @@ class PtZendnn : public Worker {
   void doRelease() override;
   void doDestroy() override;
 
+  /// Run a batch with one of the sessions and respond to its requests
+  void process(size_t session, BatchPtr batch);
+
   // workers define what batcher implementation should be used for them.
   // if not explicitly defined here, a default value is used from worker.hpp.
   // using Worker::makeBatcher;
@@ -82,8 +153,12 @@ class PtZendnn : public Worker {
   //   return this->makeBatcher<HardBatcher>(num, parameters);
   // };
 
-  // Load the model here
-  torch::jit::script::Module model_;
+  // Load the model here. TorchScript modules can run forward() from several
+  // threads at once so the sessions and the endpoints that load the same
+  // model share it
+  std::shared_ptr<torch::jit::script::Module> model_;
+  /// Number of batches that may run at once, each on its own CPUs
+  size_t sessions_ = 1;
 
   // Image properties
   unsigned int image_width_ = kResNetImageSize;
@@ -93,6 +168,9 @@ class PtZendnn : public Worker {
   unsigned int output_classes_ = kResNetOutputClasses;
 
   DataType input_dt_ = DataType::FP32;
+  Precision precision_ = Precision::Fp32;
+  /// Whether the requests' data is NHWC and run in the channels-last format
+  bool channels_last_ = false;
 };
 
 std::thread PtZendnn::spawn(BatchPtrQueue* input_queue) {
@@ -103,6 +181,17 @@ std::vector<MemoryAllocators> PtZendnn::getAllocators() const {
   return {MemoryAllocators::Cpu};
 }
 
+// each request's inputs are copied into the PT tensor individually so there's
+// no need for the batcher to concatenate them first
+bool PtZendnn::acceptsScatterGather() const { return true; }
+
+// requests that declare their layout are transposed to the model's as they're
+// batched so clients don't have to match channels_last
+std::vector<InputCast> PtZendnn::getInputCasts() const {
+  return {{"input", input_dt_, 1.0F, 0.0F,
+           channels_last_ ? InputLayout::NHWC : InputLayout::NCHW}};
+}
+
 void PtZendnn::doInit(ParameterMap* parameters) {
   constexpr auto kBatchSize = 1;
 
@@ -126,6 +215,22 @@ void PtZendnn::doInit(ParameterMap* parameters) {
   if (parameters->has("output_classes")) {
     output_classes_ = parameters->get<int32_t>("output_classes");
   }
+
+  if (parameters->has("sessions")) {
+    const auto sessions = parameters->get<int32_t>("sessions");
+    if (sessions <= 0) {
+      throw invalid_argument("The number of sessions must be positive");
+    }
+    sessions_ = sessions;
+  }
+  this->splitSessionCpus(sessions_);
+
+  if (parameters->has("precision")) {
+    precision_ = parsePrecision(parameters->get<std::string>("precision"));
+  }
+  if (parameters->has("channels_last")) {
+    channels_last_ = parameters->get<bool>("channels_last");
+  }
 }
 
 void PtZendnn::doAcquire(ParameterMap* parameters) {
@@ -145,28 +250,81 @@ void PtZendnn::doAcquire(ParameterMap* parameters) {
     throw file_not_found_error("Model " + path.string() + " does not exist");
   }
 
-  // Load the model
-  torch::jit::Module torch_module;
-  try {
-    torch_module = torch::jit::load(path, torch::kCPU);
-  } catch (const c10::Error& e) {
-    AMDINFER_LOG_ERROR(logger, e.what());
-    throw file_read_error("Could not load model with torch");
+  // The optimized model may be in the model cache from an earlier load
+  std::string cache_dir;
+  if (parameters->has("cache_dir")) {
+    cache_dir = parameters->get<std::string>("cache_dir");
+  }
+  fs::path cache_path;
+  if (const auto cache = util::getModelCacheDirectory(cache_dir);
+      !cache.empty()) {
+    // the model is converted for bf16 before it's optimized
+    const auto* suffix = precision_ == Precision::Bf16 ? "-bf16" : "";
+    util::ModelCacheKey key{path, "cpu",
+                            std::string{"torch-"} + TORCH_VERSION + suffix,
+                            static_cast<int>(this->batch_size_), ".pt"};
+    cache_path = util::getModelCachePath(cache, key);
   }
 
-  AMDINFER_LOG_INFO(logger, "Model loaded");
+  // endpoints that load the same model with other batching parameters share
+  // the optimized module
+  const auto artifact_key = getModelArtifactKey(
+    path, std::string{"ptzendnn-"} + toString(precision_));
+  this->model_ = getModelArtifact<torch::jit::Module>(artifact_key, [&]() {
+    torch::jit::Module torch_module;
+    bool cached = false;
+    if (!cache_path.empty() && fs::exists(cache_path)) {
+      try {
+        torch_module = loadModule(cache_path);
+        cached = true;
+        AMDINFER_LOG_INFO(logger,
+                          "Optimized model loaded from the model cache");
+      } catch (const c10::Error& e) {
+        // fall back to optimizing the model again
+        AMDINFER_LOG_WARN(logger, e.what());
+      }
+    }
+
+    if (!cached) {
+      // Load the model
+      try {
+        torch_module = loadModule(path);
+      } catch (const c10::Error& e) {
+        AMDINFER_LOG_ERROR(logger, e.what());
+        throw file_read_error("Could not load model with torch");
+      }
 
-  // Some online optimizations for the model
-  torch_module.eval();
-  try {
-    torch_module = torch::jit::optimize_for_inference(torch_module);
-  } catch (const std::exception& e) {
-    AMDINFER_LOG_ERROR(logger, e.what());
-    throw external_error("Unable to perform optimizations");
-  }
-  AMDINFER_LOG_INFO(logger, "Model Optimized, Ready for prediction");
+      AMDINFER_LOG_INFO(logger, "Model loaded");
 
-  this->model_ = torch_module;
+      // Some online optimizations for the model. For bf16, the weights are
+      // converted first so they're folded into the optimized model as bf16.
+      // int8 models must already be quantized and are only frozen as the
+      // other optimizations don't support quantized ops
+      torch_module.eval();
+      try {
+        if (precision_ == Precision::Bf16) {
+          torch_module.to(torch::kBFloat16);
+        }
+        torch_module = precision_ == Precision::Int8
+                         ? torch::jit::freeze(torch_module)
+                         : torch::jit::optimize_for_inference(torch_module);
+      } catch (const std::exception& e) {
+        AMDINFER_LOG_ERROR(logger, e.what());
+        throw external_error("Unable to perform optimizations");
+      }
+
+      if (!cache_path.empty() &&
+          !util::storeInModelCache(
+            cache_path, [&torch_module](const fs::path& temp_path) {
+              torch_module.save(temp_path.string());
+            })) {
+        AMDINFER_LOG_WARN(logger, "Could not save the optimized model to " +
+                                    cache_path.string());
+      }
+    }
+    return std::make_shared<torch::jit::Module>(std::move(torch_module));
+  });
+  AMDINFER_LOG_INFO(logger, "Model Optimized, Ready for prediction");
 
   // Adding metadata for input and output
   this->metadata_.addInputTensor(
@@ -177,158 +335,199 @@ void PtZendnn::doAcquire(ParameterMap* parameters) {
 }
 
 void PtZendnn::doRun(BatchPtrQueue* input_queue) {
-  std::unique_ptr<Batch> batch;
   util::setThreadName("PtZendnn");
 #ifdef AMDINFER_ENABLE_LOGGING
   const auto& logger = this->getLogger();
 #endif
 
-  while (true) {
-    input_queue->wait_dequeue(batch);
-    if (batch == nullptr) {
-      break;
-    }
-    AMDINFER_LOG_DEBUG(logger, "Got request in PtZendnn. Size: " +
-                                 std::to_string(batch->size()));
-
-    std::vector<InferenceResponse> responses;
-    responses.reserve(batch->size());
+  this->runSessions(input_queue, [this](size_t session, BatchPtr batch) {
+    this->process(session, std::move(batch));
+  });
+  AMDINFER_LOG_INFO(logger, "PtZendnn ending");
+}
 
-    // This ensures no gradient is calculated and provide performance boost
-    torch::NoGradGuard no_grad;
-    c10::InferenceMode guard;
+void PtZendnn::process(size_t session, BatchPtr batch) {
+#ifdef AMDINFER_ENABLE_LOGGING
+  const auto& logger = this->getLogger();
+#endif
 
-    size_t input_size = 0;
-    std::vector<torch::jit::IValue> input_vec;
-    auto tensors = static_cast<int>(batch->size());
+  // each session's thread runs the ops of its batches on its own CPUs. With
+  // one session, torch's default is kept
+  thread_local bool threads_set = false;
+  if (sessions_ > 1 && !threads_set) {
+    at::set_num_threads(
+      static_cast<int>(this->getSessionCpus(session).size()));
+    threads_set = true;
+  }
 
-    // Initialize a PT tensor with required shape
-    torch::Tensor input_tensor = torch::empty(
-      {tensors, image_channels_, image_height_, image_width_}, torch::kF32);
+  AMDINFER_LOG_DEBUG(logger, "Got request in PtZendnn. Size: " +
+                               std::to_string(batch->size()));
+
+  std::vector<InferenceResponse> responses;
+  responses.reserve(batch->size());
+
+  // This ensures no gradient is calculated and provide performance boost
+  torch::NoGradGuard no_grad;
+  c10::InferenceMode guard;
+
+  size_t input_size = 0;
+  std::vector<torch::jit::IValue> input_vec;
+  auto tensors = static_cast<int>(batch->size());
+
+  // Use the batch's data in place if it's contiguous. Otherwise, initialize
+  // a PT tensor with the required shape and copy the requests into it. The
+  // data is NCHW unless it's channels-last, where it's NHWC
+  const auto batch_shape =
+    channels_last_
+      ? std::vector<int64_t>{tensors, image_height_, image_width_,
+                             image_channels_}
+      : std::vector<int64_t>{tensors, image_channels_, image_height_,
+                             image_width_};
+  auto* contiguous_input =
+    batch->getContiguousInput(batch->size() * image_size_ * sizeof(float));
+  torch::Tensor input_tensor =
+    contiguous_input != nullptr
+      ? torch::from_blob(contiguous_input, batch_shape, torch::kF32)
+      : torch::empty(batch_shape, torch::kF32);
 
 #ifdef AMDINFER_ENABLE_METRICS
-    Metrics::getInstance().incrementCounter(
-      MetricCounterIDs::PipelineIngressWorker);
+  Metrics::getInstance().incrementCounter(
+    MetricCounterIDs::PipelineIngressWorker);
 #endif
-    size_t vec_size = 0;
-    util::Timer timer{true};
-    for (unsigned int j = 0; j < batch->size(); j++) {
-      const auto& req = batch->getRequest(j);
-
+  size_t vec_size = 0;
+  util::Timer timer{true};
 #ifdef AMDINFER_ENABLE_TRACING
-      const auto& trace = batch->getTrace(j);
-      trace->startSpan("ptzendnn");
+  batch->startSpan("ptzendnn");
 #endif
-      auto& resp = responses.emplace_back();
-      resp.setID(req->getID());
-      resp.setModel("PTModel");
-
-      auto inputs = req->getInputs();
-      auto outputs = req->getOutputs();
-      AMDINFER_LOG_DEBUG(logger,
-                         "Size of input: " + std::to_string(inputs.size()));
-
-      // Get all the inputs from the requests and copy to the PT tensor
-      for (const auto& input : inputs) {
-        auto* input_buffer = input.getData();
-        const auto& input_shape = input.getShape();
-        input_size = util::containerProduct(input_shape);
-
-        auto* float_buffer = static_cast<float*>(input_buffer);
-        std::copy(float_buffer, float_buffer + input_size,
-                  input_tensor.data_ptr<float>() + vec_size);
-        vec_size = vec_size + input_size;
-      }
-    }
+  for (unsigned int j = 0; j < batch->size(); j++) {
+    const auto& req = batch->getRequest(j);
 
-    // Create the inputs and output tensor
-    input_vec.emplace_back(input_tensor);
-    c10::IValue prediction;
-
-    // Run through the model to get the predictions
-    timer.add("infer_start");
-    try {
-      prediction = this->model_.forward(input_vec);
-    } catch (const c10::Error& e) {
-      AMDINFER_LOG_ERROR(logger, "Model not suported/Issue with the model");
-      for (const auto& req : *batch) {
-        req->runCallbackError("Something went wrong");
-      }
-    }
-    timer.add("infer_stop");
-    {
-      [[maybe_unused]] auto duration =
-        timer.count<std::milli>("infer_start", "infer_stop");
-      AMDINFER_LOG_INFO(logger, "Time (ms) taken for " +
-                                  std::to_string(batch->size()) +
-                                  " images: " + std::to_string(duration));
+    auto& resp = responses.emplace_back();
+    resp.setID(req->getID());
+    resp.setModel("PTModel");
+
+    auto inputs = req->getInputs();
+    auto outputs = req->getOutputs();
+    AMDINFER_LOG_DEBUG(logger,
+                       "Size of input: " + std::to_string(inputs.size()));
+
+    if (contiguous_input != nullptr) {
+      continue;
     }
-    at::Tensor output_tensor;
-    if (!prediction.isTuple()) {
-      output_tensor = prediction.toTensor();
-    } else {
-      // For some models like InceptionV3 and GoogleNet which returns Tuple
-      output_tensor = prediction.toTuple()->elements()[0].toTensor();
+
+    // Get all the inputs from the requests and copy to the PT tensor
+    for (const auto& input : inputs) {
+      auto* input_buffer = input.getData();
+      const auto& input_shape = input.getShape();
+      input_size = util::containerProduct(input_shape);
+
+      auto* float_buffer = static_cast<float*>(input_buffer);
+      std::copy(float_buffer, float_buffer + input_size,
+                input_tensor.data_ptr<float>() + vec_size);
+      vec_size = vec_size + input_size;
     }
+  }
 
-    // Copy the output from the model to the response object
-    size_t response_size = output_classes_;
-    std::vector<size_t> new_shape = {response_size};
-    for (unsigned int k = 0; k < batch->size(); k++) {
-      const auto& req = batch->getRequest(k);
-      auto inputs = req->getInputs();
-      auto outputs = req->getOutputs();
-      auto& resp = responses[k];
-
-      for (unsigned int i = 0; i < inputs.size(); i++) {
-        InferenceResponseOutput output;
-        std::vector<std::byte> buffer;
-        buffer.resize(response_size * sizeof(float));
-
-        memcpy(buffer.data(), output_tensor[i].data_ptr<float>(),
-               response_size * sizeof(float));
-        output.setData(std::move(buffer));
-
-        std::string output_name;
-        if (i < outputs.size()) {
-          output_name = outputs[i].getName();
-        }
+  // Convert the batch to what the model runs with once it's assembled. NHWC
+  // data is permuted to NCHW without moving it, which is the channels-last
+  // memory format. Conversion to bf16 preserves the format
+  if (channels_last_) {
+    input_tensor = input_tensor.permute({0, 3, 1, 2});
+  }
+  if (precision_ == Precision::Bf16) {
+    input_tensor = input_tensor.to(torch::kBFloat16);
+  }
 
-        if (output_name.empty()) {
-          output.setName(inputs[0].getName());
-        } else {
-          output.setName(output_name);
-        }
+  // Create the inputs and output tensor
+  input_vec.emplace_back(input_tensor);
+  c10::IValue prediction;
 
-        output.setShape(new_shape);
-        output.setDatatype(DataType::FP32);
-        resp.addOutput(output);
+  // Run through the model to get the predictions
+  timer.add(util::Mark::InferStart);
+  try {
+    prediction = this->model_->forward(input_vec);
+  } catch (const c10::Error& e) {
+    AMDINFER_LOG_ERROR(logger, "Model not suported/Issue with the model");
+    for (const auto& req : *batch) {
+      req->runCallbackError("Something went wrong");
+    }
+    this->returnInputBuffers(std::move(batch));
+    return;
+  }
+  timer.add(util::Mark::InferStop);
+  {
+    [[maybe_unused]] auto duration =
+      timer.count<std::milli>(util::Mark::InferStart, util::Mark::InferStop);
+    AMDINFER_LOG_INFO(logger, "Time (ms) taken for " +
+                                std::to_string(batch->size()) +
+                                " images: " + std::to_string(duration));
+  }
+  at::Tensor output_tensor;
+  if (!prediction.isTuple()) {
+    output_tensor = prediction.toTensor();
+  } else {
+    // For some models like InceptionV3 and GoogleNet which returns Tuple
+    output_tensor = prediction.toTuple()->elements()[0].toTensor();
+  }
+  // the responses are always fp32
+  output_tensor = output_tensor.to(torch::kF32).contiguous();
+
+  // Copy the output from the model to the response object. Each input of
+  // each request is one row of the output, in the same order as the inputs
+  size_t response_size = output_classes_;
+  std::vector<size_t> new_shape = {response_size};
+  int64_t row = 0;
+  for (unsigned int k = 0; k < batch->size(); k++) {
+    const auto& req = batch->getRequest(k);
+    auto inputs = req->getInputs();
+    auto outputs = req->getOutputs();
+    auto& resp = responses[k];
+
+    for (unsigned int i = 0; i < inputs.size(); i++) {
+      InferenceResponseOutput output;
+      output.setShape(new_shape);
+      output.setDatatype(DataType::FP32);
+      auto* buffer = this->allocateOutput(&output);
+
+      memcpy(buffer, output_tensor[row].data_ptr<float>(),
+             response_size * sizeof(float));
+      row++;
+
+      std::string output_name;
+      if (i < outputs.size()) {
+        output_name = outputs[i].getName();
+      }
+
+      if (output_name.empty()) {
+        output.setName(inputs[0].getName());
+      } else {
+        output.setName(output_name);
       }
 
+      resp.addOutput(output);
+    }
+
 #ifdef AMDINFER_ENABLE_TRACING
-      auto context = batch->getTrace(k)->propagate();
-      resp.setContext(std::move(context));
+    auto context = batch->getTrace(k)->propagate();
+    resp.setContext(std::move(context));
 #endif
-      timer.stop();
-      [[maybe_unused]] auto duration = timer.count<std::milli>();
-      AMDINFER_LOG_DEBUG(logger,
-                         "Total time taken: " + std::to_string(duration));
+    timer.stop();
+    [[maybe_unused]] auto duration = timer.count<std::milli>();
+    AMDINFER_LOG_DEBUG(logger, "Total time taken: " + std::to_string(duration));
 
-      req->runCallbackOnce(resp);
+    req->runCallbackOnce(resp);
 
 #ifdef AMDINFER_ENABLE_METRICS
-      timer.add("metrics", batch->getTime(k));
-      duration = timer.count<std::micro>("metrics", "stop");
-      Metrics::getInstance().observeSummary(MetricSummaryIDs::RequestLatency,
-                                            duration);
+    timer.add(util::Mark::Arrival, batch->getTime(k));
+    duration = timer.count<std::micro>(util::Mark::Arrival, util::Mark::Stop);
+    Metrics::getInstance().observeSummary(MetricSummaryIDs::RequestLatency,
+                                          duration);
 #endif
-    }
-    this->returnInputBuffers(std::move(batch));
   }
-  AMDINFER_LOG_INFO(logger, "PtZendnn ending");
+  this->returnInputBuffers(std::move(batch));
 }
 
-void PtZendnn::doRelease() {}
+void PtZendnn::doRelease() { this->model_.reset(); }
 void PtZendnn::doDestroy() {}
 
 }  // namespace amdinfer::workers
@@ -336,7 +535,7 @@ void PtZendnn::doDestroy() {}
 extern "C" {
 // using smart pointer here may cause problems inside shared object so managing
 // manually
-amdinfer::workers::Worker* getWorker() {
+amdinfer::workers::Worker* AMDINFER_WORKER_FACTORY() {
   return new amdinfer::workers::PtZendnn("PtZendnn", "cpu");
 }
 }  // extern C
@@ -155,12 +155,11 @@ void ResNet50::doRun(BatchPtrQueue* input_queue) {
     v.reserve(batch->getInputSize());
 
     size_t tensor_count = 0;
-    for (unsigned int j = 0; j < batch->size(); j++) {
-      const auto& req = batch->getRequest(j);
 #ifdef AMDINFER_ENABLE_TRACING
-      auto& trace = batch->getTrace(j);
-      trace->startSpan("Resnet50");
+    batch->startSpan("Resnet50");
 #endif
+    for (unsigned int j = 0; j < batch->size(); j++) {
+      const auto& req = batch->getRequest(j);
       auto& resp = responses.emplace_back();
       resp.setID(req->getID());
       resp.setModel(this->graph_name_);
@@ -301,7 +300,7 @@ void ResNet50::doDestroy() {}
 extern "C" {
 // using smart pointer here may cause problems inside shared object so managing
 // manually
-amdinfer::workers::Worker* getWorker() {
+amdinfer::workers::Worker* AMDINFER_WORKER_FACTORY() {
   return new amdinfer::workers::ResNet50("ResNet50", "AKS");
 }
 }  // extern C
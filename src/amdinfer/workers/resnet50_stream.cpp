@@ -22,17 +22,14 @@
 #include <aks/AksTensorBuffer.h>   // for AksTensorBuffer
 
 #include <algorithm>               // for copy, max, copy_backward
-#include <chrono>                  // for seconds
 #include <cstdint>                 // for int32_t, uint8_t
 #include <cstring>                 // for size_t, memcpy
+#include <exception>               // for exception
 #include <ext/alloc_traits.h>      // for __alloc_traits<>::value...
-#include <future>                  // for future, future_status
 #include <memory>                  // for allocator, unique_ptr
 #include <opencv2/core.hpp>        // for Mat, Size
-#include <opencv2/imgcodecs.hpp>   // for imencode
 #include <opencv2/imgproc.hpp>     // for resize
 #include <opencv2/videoio.hpp>     // for VideoCapture, VideoCapt...
-#include <queue>                   // for queue
 #include <string>                  // for string, operator+, char...
 #include <thread>                  // for thread
 #include <utility>                 // for move, pair
@@ -47,12 +44,12 @@
 #include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
 #include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
 #include "amdinfer/core/parameters.hpp"          // for ParameterMap
-#include "amdinfer/declarations.hpp"         // for BufferPtrs, InferenceRe...
-#include "amdinfer/observation/logging.hpp"  // for Logger
-#include "amdinfer/util/base64.hpp"          // for base64_encode
-#include "amdinfer/util/parse_env.hpp"       // for autoExpandEnvironmentVa...
-#include "amdinfer/util/thread.hpp"          // for setThreadName
-#include "amdinfer/workers/worker.hpp"       // for Worker, kNumBufferAuto
+#include "amdinfer/declarations.hpp"          // for BufferPtrs, InferenceRe...
+#include "amdinfer/observation/logging.hpp"   // for Logger
+#include "amdinfer/util/parse_env.hpp"        // for autoExpandEnvironmentVa...
+#include "amdinfer/util/thread.hpp"           // for setThreadName
+#include "amdinfer/workers/video_stream.hpp"  // for runVideoPipeline
+#include "amdinfer/workers/worker.hpp"        // for Worker, kNumBufferAuto
 
 namespace AKS {  // NOLINT(readability-identifier-naming)
 class AIGraph;
@@ -91,6 +88,7 @@ class ResNet50Stream : public Worker {
   AKS::SysManagerExt* sys_manager_ = nullptr;
   std::string graph_name_;
   AKS::AIGraph* graph_ = nullptr;
+  VideoPipelineOptions options_;
 };
 
 std::thread ResNet50Stream::spawn(BatchPtrQueue* input_queue) {
@@ -103,13 +101,13 @@ std::vector<MemoryAllocators> ResNet50Stream::getAllocators() const {
 
 void ResNet50Stream::doInit(ParameterMap* parameters) {
   constexpr auto kBatchSize = 4;
-  (void)parameters;  // suppress unused variable warning
 
   /// Get AKS System Manager instance
   this->sys_manager_ = AKS::SysManagerExt::getGlobal();
   this->graph_name_ = "resnet50";
 
   this->batch_size_ = kBatchSize;
+  this->options_ = parseVideoPipelineOptions(parameters);
 }
 
 constexpr auto kImageWidth = 224;
@@ -147,12 +145,52 @@ void ResNet50Stream::doAcquire(ParameterMap* parameters) {
 }
 
 void ResNet50Stream::doRun(BatchPtrQueue* input_queue) {
-  std::shared_ptr<InferenceRequest> req;
   util::setThreadName("ResNet50Stream");
 #ifdef AMDINFER_ENABLE_LOGGING
   const auto& logger = this->getLogger();
 #endif
 
+  auto preprocess = [this](VideoBatch* batch) {
+    batch->inputs.emplace_back(
+      std::make_unique<AKS::AksTensorBuffer>(xir::Tensor::create(
+        "resnet-stream",
+        {static_cast<int>(this->batch_size_), kImageHeight, kImageWidth,
+         kImageChannels},
+        xir::create_data_type<unsigned char>())));
+    auto* data = reinterpret_cast<uint8_t*>(batch->inputs[0]->data().first);
+    for (size_t i = 0; i < batch->frames.size(); i++) {
+      // the resized frame is also the one sent back to the client
+      auto& frame = batch->frames[i];
+      cv::resize(frame, frame, cv::Size(kImageWidth, kImageHeight));
+      memcpy(data + (i * kImageSize), frame.data, kImageSize);
+    }
+  };
+  auto infer = [this](TensorBuffers inputs) {
+    return this->sys_manager_
+      ->enqueueJob(this->graph_, "", std::move(inputs), nullptr)
+      .get();
+  };
+  auto postprocess = [this](VideoBatch* batch) {
+    const auto* top_k_data =
+      reinterpret_cast<int*>(batch->outputs[0]->data().first);
+    for (unsigned int i = 0; i < this->batch_size_; i++) {
+      std::string labels = "[";
+      for (unsigned int j = 0; j < kResnetClassifications; j++) {
+        auto y = std::to_string(j * kBoxHeight);
+        auto label =
+          std::to_string(top_k_data[(i * kResnetClassifications) + j]);
+        labels.append(R"({"fill": true, "box": [0,)");
+        labels.append(y + ",");
+        labels.append(kImageWidthStr + ",");
+        labels.append(kBoxHeightStr + R"(], "label": ")");
+        labels.append(label + "\"},");
+      }
+      labels.pop_back();  // trim trailing comma
+      labels += "]";
+      batch->labels.push_back(std::move(labels));
+    }
+  };
+
   while (true) {
     BatchPtr batch;
     input_queue->wait_dequeue(batch);
@@ -163,7 +201,6 @@ void ResNet50Stream::doRun(BatchPtrQueue* input_queue) {
     AMDINFER_LOG_INFO(logger, "Got request in ResNet50Stream");
     for (const auto& req : *batch) {
       auto inputs = req->getInputs();
-      auto outputs = req->getOutputs();
       auto key = req->getParameters().get<std::string>("key");
       for (auto& input : inputs) {
         auto* input_buffer = input.getData();
@@ -207,119 +244,33 @@ void ResNet50Stream::doRun(BatchPtrQueue* input_queue) {
         output.setShape({message.size()});
         resp.addOutput(output);
         req->runCallback(resp);
-        // round to nearest multiple of batch size
-        auto count_adjusted = count - (count % this->batch_size_);
-        std::queue<
-          std::future<std::vector<std::unique_ptr<vart::TensorBuffer>>>>
-          futures;
-        std::queue<std::string> frames;
-        for (unsigned int num_frames = 0; num_frames < count_adjusted;
-             num_frames += this->batch_size_) {
-          std::vector<std::unique_ptr<vart::TensorBuffer>> v;
-          v.reserve(1);
-          v.emplace_back(std::make_unique<AKS::AksTensorBuffer>(
-            xir::Tensor::create("resnet-stream",
-                                {static_cast<int>(this->batch_size_),
-                                 kImageHeight, kImageWidth, kImageChannels},
-                                xir::create_data_type<unsigned char>())));
-
-          for (size_t i = 0; i < this->batch_size_; i++) {
-            cv::Mat frame;
-            cap >> frame;  // get the next frame from video
-            // if (frame.empty()) {
-            //   continue;
-            // }
-            cv::resize(frame, frame, cv::Size(kImageWidth, kImageHeight));
-
-            memcpy(
-              reinterpret_cast<uint8_t*>(v[0]->data().first) + (i * kImageSize),
-              frame.data, kImageSize);
-
-            std::vector<unsigned char> buf;
-            cv::imencode(".jpg", frame, buf);
-            const auto* enc_msg = reinterpret_cast<const char*>(buf.data());
-            std::string encoded = util::base64Encode(enc_msg, buf.size());
-            frames.push("data:image/jpg;base64," + encoded);
-          }
-          futures.push(this->sys_manager_->enqueueJob(this->graph_, "",
-                                                      std::move(v), nullptr));
-          auto status = futures.front().wait_for(std::chrono::seconds(0));
-          if (status == std::future_status::ready) {
-            std::vector<std::unique_ptr<vart::TensorBuffer>>
-              out_data_descriptor = futures.front().get();
-            futures.pop();
-            int* top_k_data =
-              reinterpret_cast<int*>(out_data_descriptor[0]->data().first);
-            for (unsigned int i = 0; i < this->batch_size_; i++) {
-              std::string labels = "[";
-              for (unsigned int j = 0; j < kResnetClassifications; j++) {
-                auto y = std::to_string(j * kBoxHeight);
-                auto label =
-                  std::to_string(top_k_data[(i * kResnetClassifications) + j]);
-                labels.append(R"({"fill": true, "box": [0,)");
-                labels.append(y + ",");
-                labels.append(kImageWidthStr + ",");
-                labels.append(kBoxHeightStr + R"(], "label": ")");
-                labels.append(label + "\"},");
-              }
-              labels.pop_back();  // trim trailing comma
-              labels += "]";
-              InferenceResponse resp;
-              resp.setID(req->getID());
-              resp.setModel("invert_video");
-
-              InferenceResponseOutput output;
-              output.setName("image");
-              output.setDatatype(DataType::String);
-              auto message = constructMessage(key, frames.front(), labels);
-              std::vector<std::byte> buffer;
-              buffer.resize(message.size());
-              memcpy(buffer.data(), message.data(), message.size());
-              output.setData(std::move(buffer));
-              output.setShape({message.size()});
-              resp.addOutput(output);
-              req->runCallback(resp);
-              frames.pop();
-            }
-          }
-        }
-        while (!futures.empty()) {
-          std::vector<std::unique_ptr<vart::TensorBuffer>> out_data_descriptor =
-            futures.front().get();
-          futures.pop();
-          int* top_k_data =
-            reinterpret_cast<int*>(out_data_descriptor[0]->data().first);
-          for (unsigned int i = 0; i < this->batch_size_; i++) {
-            std::string labels = "[";
-            for (unsigned int j = 0; j < kResnetClassifications; j++) {
-              auto y = std::to_string(j * kBoxHeight);
-              auto label =
-                std::to_string(top_k_data[(i * kResnetClassifications) + j]);
-              labels.append(R"({"fill": true, "box": [0,)");
-              labels.append(y + ",");
-              labels.append(kImageWidthStr + ",");
-              labels.append(kBoxHeightStr + R"(], "label": ")");
-              labels.append(label + "\"},");
-            }
-            labels.pop_back();  // trim trailing comma
-            labels += "]";
-            InferenceResponse resp;
-            resp.setID(req->getID());
-            resp.setModel("invert_video");
-
-            InferenceResponseOutput output;
-            output.setName("image");
-            output.setDatatype(DataType::String);
-            auto message = constructMessage(key, frames.front(), labels);
-            std::vector<std::byte> buffer;
-            buffer.resize(message.size());
-            memcpy(buffer.data(), message.data(), message.size());
-            output.setData(std::move(buffer));
-            output.setShape({message.size()});
-            resp.addOutput(output);
-            req->runCallback(resp);
-            frames.pop();
-          }
+
+        auto respond = [&](const std::string& image,
+                           const std::string& labels) {
+          InferenceResponse resp;
+          resp.setID(req->getID());
+          resp.setModel("invert_video");
+
+          InferenceResponseOutput output;
+          output.setName("image");
+          output.setDatatype(DataType::String);
+          auto message = constructMessage(key, image, labels);
+          std::vector<std::byte> buffer;
+          buffer.resize(message.size());
+          memcpy(buffer.data(), message.data(), message.size());
+          output.setData(std::move(buffer));
+          output.setShape({message.size()});
+          resp.addOutput(output);
+          req->runCallback(resp);
+        };
+
+        try {
+          const auto sampling = parseVideoSampling(input.getParameters(), fps);
+          runVideoPipeline(&cap, count, this->batch_size_, this->options_,
+                           sampling, preprocess, infer, postprocess, respond);
+        } catch (const std::exception& e) {
+          AMDINFER_LOG_ERROR(logger, e.what());
+          req->runCallbackError(e.what());
         }
       }
     }
@@ -337,7 +288,7 @@ void ResNet50Stream::doDestroy() {}
 extern "C" {
 // using smart pointer here may cause problems inside shared object so managing
 // manually
-amdinfer::workers::Worker* getWorker() {
+amdinfer::workers::Worker* AMDINFER_WORKER_FACTORY() {
   return new amdinfer::workers::ResNet50Stream("ResNet50Stream", "AKS");
 }
 }  // extern C
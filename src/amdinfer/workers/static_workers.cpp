@@ -0,0 +1,46 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Registers the workers that are compiled into the server. The build
+ * generates static_workers.inc with an AMDINFER_STATIC_WORKER entry for each
+ * worker in AMDINFER_STATIC_WORKERS, whose AMDINFER_WORKER_FACTORY is defined
+ * as the entry's factory so the workers don't clash
+ */
+
+#include "amdinfer/core/worker_info.hpp"  // for registerWorker
+
+// NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
+#define AMDINFER_STATIC_WORKER(name, factory) \
+  extern "C" amdinfer::workers::Worker* factory();
+#include "static_workers.inc"
+#undef AMDINFER_STATIC_WORKER
+
+namespace amdinfer::workers {
+
+namespace {
+
+/// Register the workers as the server starts, before any can be loaded
+[[maybe_unused]] const bool kRegistered = []() {
+// NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
+#define AMDINFER_STATIC_WORKER(name, factory) registerWorker(name, &(factory));
+#include "static_workers.inc"
+#undef AMDINFER_STATIC_WORKER
+  return true;
+}();
+
+}  // namespace
+
+}  // namespace amdinfer::workers
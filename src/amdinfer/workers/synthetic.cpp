@@ -0,0 +1,223 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Implements the Synthetic worker
+ */
+
+#include <algorithm>  // for max
+#include <chrono>     // for microseconds, steady_clock
+#include <cstddef>    // for size_t
+#include <cstdint>    // for int32_t, uint64_t
+#include <cstring>    // for memset
+#include <memory>     // for unique_ptr
+#include <random>     // for mt19937, random_device, ...
+#include <string>     // for string
+#include <thread>     // for thread, sleep_until
+#include <vector>     // for vector
+
+#include "amdinfer/core/data_types.hpp"       // for DataType
+#include "amdinfer/core/exceptions.hpp"       // for invalid_argument
+#include "amdinfer/core/parameters.hpp"       // for ParameterMap
+#include "amdinfer/workers/batch_worker.hpp"  // for BatchWorker, BatchView
+#include "amdinfer/workers/worker.hpp"        // for Worker
+
+namespace amdinfer::workers {
+
+/// How the latency of each batch varies around its mean
+enum class LatencyDistribution { Fixed, Uniform, Normal, Exponential };
+
+LatencyDistribution parseDistribution(const std::string& name) {
+  if (name == "fixed") {
+    return LatencyDistribution::Fixed;
+  }
+  if (name == "uniform") {
+    return LatencyDistribution::Uniform;
+  }
+  if (name == "normal") {
+    return LatencyDistribution::Normal;
+  }
+  if (name == "exponential") {
+    return LatencyDistribution::Exponential;
+  }
+  throw invalid_argument("Unknown latency distribution: " + name);
+}
+
+/**
+ * @brief The Synthetic worker stands in for a device so batching, scheduling
+ * and transport settings can be tested without one. Each batch takes a fixed
+ * latency plus a latency per request, drawn from a distribution, and the
+ * worker keeps a fixed number of batches in flight like a device's slots. The
+ * time passes by sleeping, which leaves the CPUs free as a device would, or by
+ * spinning to also load a CPU. Its output is a buffer of zeros of a given
+ * size and its inputs are ignored.
+ *
+ * Parameters:
+ *  - batch_size: requests in each batch (default 1)
+ *  - latency_us: latency of each batch in microseconds (default 1000)
+ *  - sample_latency_us: latency added by each request in the batch (default 0)
+ *  - distribution: fixed, uniform, normal or exponential (default fixed)
+ *  - jitter: spread of the uniform and normal distributions as a fraction of
+ *    the mean (default 0.1)
+ *  - spin: spin instead of sleeping (default false)
+ *  - slots: batches in flight at once (default 1)
+ *  - output_size: bytes of each request's output, at least 1 (default 4)
+ *  - seed: seed of the distribution for reproducible runs (default random)
+ */
+class Synthetic : public BatchWorker {
+ public:
+  using BatchWorker::BatchWorker;
+  std::thread spawn(BatchPtrQueue* input_queue) override;
+  [[nodiscard]] std::vector<MemoryAllocators> getAllocators() const override;
+
+ private:
+  void doInit(ParameterMap* parameters) override;
+  void doAcquire(ParameterMap* parameters) override;
+  void compute(const BatchView& batch, const OutputSpans& outputs) override;
+  Completion submit(const BatchView& batch,
+                    const OutputSpans& outputs) override;
+  void doRelease() override;
+  void doDestroy() override;
+
+  /// Draw the latency of a batch of this many requests
+  std::chrono::microseconds getLatency(size_t requests);
+  /// Wait until the time, spinning or sleeping
+  void waitUntil(std::chrono::steady_clock::time_point time) const;
+
+  double latency_us_ = 0;
+  double sample_latency_us_ = 0;
+  LatencyDistribution distribution_ = LatencyDistribution::Fixed;
+  double jitter_ = 0;
+  bool spin_ = false;
+  uint64_t output_size_ = 0;
+  // only the worker's own thread submits batches so it's not shared
+  std::mt19937 generator_;
+};
+
+std::thread Synthetic::spawn(BatchPtrQueue* input_queue) {
+  return std::thread(&Synthetic::run, this, input_queue);
+}
+
+std::vector<MemoryAllocators> Synthetic::getAllocators() const {
+  return {MemoryAllocators::Cpu};
+}
+
+void Synthetic::doInit(ParameterMap* parameters) {
+  constexpr auto kBatchSize = 1;
+  constexpr auto kLatencyUs = 1000;
+  constexpr auto kJitter = 0.1;
+  constexpr auto kOutputSize = 4;
+
+  auto get_int = [parameters](const std::string& key, int32_t value) {
+    if (parameters->has(key)) {
+      value = parameters->get<int32_t>(key);
+    }
+    if (value < 0) {
+      throw invalid_argument("The synthetic worker's " + key +
+                             " can't be negative");
+    }
+    return value;
+  };
+
+  this->batch_size_ = std::max(get_int("batch_size", kBatchSize), 1);
+  latency_us_ = get_int("latency_us", kLatencyUs);
+  sample_latency_us_ = get_int("sample_latency_us", 0);
+  output_size_ = std::max(get_int("output_size", kOutputSize), 1);
+  this->setInFlight(std::max(get_int("slots", 1), 1));
+
+  if (parameters->has("distribution")) {
+    distribution_ =
+      parseDistribution(parameters->get<std::string>("distribution"));
+  }
+  jitter_ = parameters->has("jitter") ? parameters->get<double>("jitter")
+                                      : kJitter;
+  if (jitter_ < 0) {
+    throw invalid_argument("The synthetic worker's jitter can't be negative");
+  }
+  spin_ = parameters->has("spin") && parameters->get<bool>("spin");
+  generator_.seed(parameters->has("seed")
+                    ? static_cast<unsigned>(parameters->get<int32_t>("seed"))
+                    : std::random_device{}());
+}
+
+void Synthetic::doAcquire([[maybe_unused]] ParameterMap* parameters) {
+  this->metadata_.addInputTensor("input", {1}, DataType::Uint8);
+  this->metadata_.addOutputTensor("output", {output_size_}, DataType::Uint8);
+}
+
+std::chrono::microseconds Synthetic::getLatency(size_t requests) {
+  const auto mean =
+    latency_us_ + sample_latency_us_ * static_cast<double>(requests);
+  double latency = mean;
+  switch (distribution_) {
+    case LatencyDistribution::Uniform:
+      latency = std::uniform_real_distribution<double>{
+        mean * (1 - jitter_), mean * (1 + jitter_)}(generator_);
+      break;
+    case LatencyDistribution::Normal:
+      if (mean * jitter_ > 0) {
+        latency =
+          std::normal_distribution<double>{mean, mean * jitter_}(generator_);
+      }
+      break;
+    case LatencyDistribution::Exponential:
+      if (mean > 0) {
+        latency = std::exponential_distribution<double>{1 / mean}(generator_);
+      }
+      break;
+    default:
+      break;
+  }
+  return std::chrono::microseconds{
+    static_cast<int64_t>(std::max(latency, 0.0))};
+}
+
+void Synthetic::waitUntil(std::chrono::steady_clock::time_point time) const {
+  if (!spin_) {
+    std::this_thread::sleep_until(time);
+    return;
+  }
+  while (std::chrono::steady_clock::now() < time) {
+  }
+}
+
+void Synthetic::compute(const BatchView& batch, const OutputSpans& outputs) {
+  for (const auto& output : outputs) {
+    std::memset(output.data, 0, output.stride * batch.size);
+  }
+}
+
+BatchWorker::Completion Synthetic::submit(const BatchView& batch,
+                                          const OutputSpans& outputs) {
+  // the batch starts now and each one in flight runs in its own slot so they
+  // overlap as they would on a device
+  const auto done =
+    std::chrono::steady_clock::now() + this->getLatency(batch.size);
+  this->compute(batch, outputs);
+  return [this, done]() { this->waitUntil(done); };
+}
+
+void Synthetic::doRelease() {}
+void Synthetic::doDestroy() {}
+
+}  // namespace amdinfer::workers
+
+extern "C" {
+// using smart pointer here may cause problems inside shared object so managing
+// manually
+amdinfer::workers::Worker* AMDINFER_WORKER_FACTORY() {
+  return new amdinfer::workers::Synthetic("synthetic", "cpu");
+}
+}  // extern C
@@ -19,29 +19,41 @@
 
 #include <dlfcn.h>               // for dlerror, dlopen, dlsym, RTLD...
 #include <tensorflow/c/c_api.h>  // for TF_Version
-#include <tensorflow/core/framework/graph.pb.h>         // for GraphDef
-#include <tensorflow/core/framework/tensor.h>           // for Tensor
-#include <tensorflow/core/framework/tensor_shape.h>     // for TensorShape
-#include <tensorflow/core/framework/tensor_shape.pb.h>  // for tensorflow
-#include <tensorflow/core/framework/tensor_types.h>     // for TTypes<>::Flat
-#include <tensorflow/core/framework/types.pb.h>         // for DT_FLOAT
-#include <tensorflow/core/platform/env.h>               // for ReadBinaryProto
-#include <tensorflow/core/platform/status.h>            // for Status
-#include <tensorflow/core/protobuf/config.pb.h>         // for ConfigProto
-#include <tensorflow/core/public/session.h>             // for NewSession
-#include <tensorflow/core/public/session_options.h>     // for SessionOptions
-
-#include <algorithm>  // for copy, max
-#include <cassert>    // for assert
-#include <cstddef>    // for size_t, byte
-#include <cstdint>    // for int32_t, uint...
-#include <cstring>    // for memcpy
-#include <memory>     // for allocator
-#include <ratio>      // for micro, milli
-#include <string>     // for string, opera...
-#include <thread>     // for thread
-#include <utility>    // for pair, move
-#include <vector>     // for vector
+#include <tensorflow/core/framework/allocation_description.pb.h>  // for All...
+#include <tensorflow/core/framework/allocator.h>          // for Allocator
+#include <tensorflow/core/framework/graph.pb.h>           // for GraphDef
+#include <tensorflow/core/framework/tensor.h>             // for Tensor
+#include <tensorflow/core/framework/tensor_shape.h>       // for TensorShape
+#include <tensorflow/core/framework/tensor_shape.pb.h>    // for tensorflow
+#include <tensorflow/core/framework/tensor_types.h>       // for TTypes<>::Flat
+#include <tensorflow/core/framework/types.pb.h>           // for DT_FLOAT
+#include <tensorflow/core/grappler/clusters/utils.h>      // for GetLocalCPUInfo
+#include <tensorflow/core/grappler/clusters/virtual_cluster.h>  // for Virt...
+#include <tensorflow/core/grappler/grappler_item.h>  // for GrapplerItem
+#include <tensorflow/core/grappler/optimizers/meta_optimizer.h>  // for Run...
+#include <tensorflow/core/platform/env.h>                 // for ReadBinaryProto
+#include <tensorflow/core/platform/status.h>              // for Status
+#include <tensorflow/core/protobuf/config.pb.h>           // for ConfigProto
+#include <tensorflow/core/protobuf/device_properties.pb.h>  // for DevicePr...
+#include <tensorflow/core/protobuf/rewriter_config.pb.h>  // for RewriterConfig
+#include <tensorflow/core/public/session.h>               // for NewSession
+#include <tensorflow/core/public/session_options.h>       // for SessionOptions
+
+#include <algorithm>   // for copy, max
+#include <cassert>     // for assert
+#include <cstddef>     // for size_t, byte
+#include <cstdint>     // for int32_t, uint...
+#include <cstring>     // for memcpy
+#include <filesystem>  // for path, exists
+#include <functional>  // for hash
+#include <limits>      // for numeric_limits
+#include <map>         // for map
+#include <memory>      // for allocator, shared_ptr, make_shared
+#include <ratio>       // for micro, milli
+#include <string>      // for string, opera...
+#include <thread>      // for thread
+#include <utility>     // for pair, move
+#include <vector>      // for vector
 
 #include "amdinfer/batching/hard.hpp"            // for Batch, BatchP...
 #include "amdinfer/build_options.hpp"            // for AMDINFER_ENABL...
@@ -54,6 +66,8 @@
 #include "amdinfer/observation/logging.hpp"      // for Logger, PROTE...
 #include "amdinfer/observation/metrics.hpp"      // for Metrics, Metr...
 #include "amdinfer/observation/tracing.hpp"      // for Trace
+#include "amdinfer/util/mapped_file.hpp"         // for MappedFile
+#include "amdinfer/util/model_cache.hpp"         // for getModelCachePath
 #include "amdinfer/util/thread.hpp"              // for setThreadName
 #include "amdinfer/util/timer.hpp"               // for Timer
 #include "amdinfer/workers/worker.hpp"           // for Worker, kNumB...
@@ -66,6 +80,82 @@ const int kResNetImageSize = 224;
 const int kResNetImageChannels = 3;
 const int kResNetOutputClasses = 1000;
 
+namespace {
+
+tf::RewriterConfig::Toggle toToggle(bool enabled) {
+  return enabled ? tf::RewriterConfig::ON : tf::RewriterConfig::OFF;
+}
+
+/**
+ * @brief Set how TF optimizes the graph from the load-time parameters. Options
+ * that aren't given keep TF's defaults
+ *
+ * @param parameters the worker's load-time parameters
+ * @param options the graph options to set
+ */
+void setGraphOptions(const ParameterMap& parameters,
+                     tf::GraphOptions* options) {
+  auto* rewrites = options->mutable_rewrite_options();
+  auto* optimizer = options->mutable_optimizer_options();
+  if (parameters.has("graph_optimizations")) {
+    const auto level = parameters.get<std::string>("graph_optimizations");
+    if (level == "off") {
+      rewrites->set_disable_meta_optimizer(true);
+      optimizer->set_opt_level(tf::OptimizerOptions::L0);
+    } else if (level == "aggressive") {
+      // run the optimizers twice and on graphs of any size
+      rewrites->set_meta_optimizer_iterations(tf::RewriterConfig::TWO);
+      rewrites->set_min_graph_nodes(-1);
+    } else if (level != "default") {
+      throw invalid_argument("Unsupported graph optimizations " + level +
+                             ". Use default, aggressive or off");
+    }
+  }
+  if (parameters.has("constant_folding")) {
+    const auto enabled = parameters.get<bool>("constant_folding");
+    rewrites->set_constant_folding(toToggle(enabled));
+    optimizer->set_do_constant_folding(enabled);
+  }
+  // the remapper fuses ops, such as convolutions with their bias and
+  // activation, into the ZenDNN kernels
+  if (parameters.has("remapping")) {
+    rewrites->set_remapping(toToggle(parameters.get<bool>("remapping")));
+  }
+  if (parameters.has("layout_optimizer")) {
+    rewrites->set_layout_optimizer(
+      toToggle(parameters.get<bool>("layout_optimizer")));
+  }
+  if (parameters.has("xla")) {
+    optimizer->set_global_jit_level(parameters.get<bool>("xla")
+                                      ? tf::OptimizerOptions::ON_1
+                                      : tf::OptimizerOptions::OFF);
+  }
+}
+
+}  // namespace
+
+/**
+ * @brief A TF tensor buffer over memory that the batch owns so TF reads the
+ * batch's input in place. The batch must outlive the tensors using it
+ */
+class BatchTensorBuffer : public tf::TensorBuffer {
+ public:
+  BatchTensorBuffer(void* data, size_t size)
+    : tf::TensorBuffer(data), size_(size) {}
+
+  [[nodiscard]] size_t size() const override { return size_; }
+  TensorBuffer* root_buffer() override { return this; }
+  void FillAllocationDescription(
+    tf::AllocationDescription* proto) const override {
+    proto->set_requested_bytes(static_cast<int64_t>(size_));
+    proto->set_allocator_name("amdinfer");
+  }
+  [[nodiscard]] bool OwnsMemory() const override { return false; }
+
+ private:
+  size_t size_;
+};
+
 /**
  * @brief The TfZendnn worker is a simple worker that accepts a single uint32_t
  * argument and adds 1 to it and returns. It accepts multiple input tensors and
@@ -85,10 +175,35 @@ class TfZendnn : public Worker {
   void doRelease() override;
   void doDestroy() override;
 
-  // TF session and graphs
-  tf::Session* session_ = nullptr;
+  /// Run a batch with one of the sessions and respond to its requests
+  void process(size_t session, BatchPtr batch);
+  /**
+   * @brief Get the input tensor of a batch. It uses the batch's data in place
+   * if it's contiguous and aligned for TF. Otherwise, the requests' data is
+   * copied into the session's tensor for the batch's size
+   *
+   * @param session index of the session that runs the batch
+   * @param batch the batch to get the input of
+   * @return tf::Tensor
+   */
+  tf::Tensor getInputTensor(size_t session, const Batch& batch);
+  /**
+   * @brief Optimize the graph once with the graph options so the sessions
+   * don't have to. The optimized graph is kept in the model cache, if there
+   * is one, and read from it on later loads
+   *
+   * @param path the model's file
+   * @param cache_dir the model cache directory or empty for the default
+   */
+  void optimizeGraph(const std::filesystem::path& path,
+                     const std::string& cache_dir);
+
+  // TF sessions and graphs. Each session has its own thread pools so the
+  // sessions can run batches in parallel
+  std::vector<tf::Session*> sessions_;
   tf::GraphDef graph_def_;
-  tf::Status status_;
+  /// per session, the input tensors that batches are copied into by size
+  std::vector<std::map<int64_t, tf::Tensor>> staging_;
 
   // Image properties
   unsigned int output_classes_ = kResNetOutputClasses;
@@ -101,6 +216,13 @@ class TfZendnn : public Worker {
   std::string input_node_{"input"};
   std::string output_node_{"predict"};
   DataType input_dt_ = DataType::Fp32;
+  /// Whether to run the graph with bf16 where the CPU supports it
+  bool bf16_ = false;
+  /// How TF optimizes the graph, from the load-time parameters
+  tf::GraphOptions graph_options_;
+  /// Whether to optimize the graph once when it's loaded instead of in each
+  /// session
+  bool optimize_graph_ = false;
 };
 
 std::thread TfZendnn::spawn(BatchPtrQueue* input_queue) {
@@ -142,6 +264,27 @@ void TfZendnn::doInit(ParameterMap* parameters) {
     output_node_ = parameters->get<std::string>("output_node");
   }
 
+  // int8 is a property of a quantized graph rather than a mode to turn on so
+  // it's not a precision here
+  if (parameters->has("precision")) {
+    const auto precision = parameters->get<std::string>("precision");
+    if (precision != "fp32" && precision != "bf16") {
+      throw invalid_argument("Unsupported precision " + precision +
+                             ". Use fp32 or bf16");
+    }
+    bf16_ = precision == "bf16";
+  }
+  setGraphOptions(*parameters, &graph_options_);
+  if (bf16_) {
+    // the graph keeps taking fp32 inputs and TF converts the ops that
+    // benefit from bf16 when it optimizes the graph
+    graph_options_.mutable_rewrite_options()
+      ->set_auto_mixed_precision_onednn_bfloat16(tf::RewriterConfig::ON);
+  }
+  if (parameters->has("optimize_graph")) {
+    optimize_graph_ = parameters->get<bool>("optimize_graph");
+  }
+
   std::string logmsg =
     "TensorFlow C/C++ library version: " + std::string(TF_Version());
 #ifdef AMDINFER_ENABLE_LOGGING
@@ -155,33 +298,6 @@ void TfZendnn::doAcquire(ParameterMap* parameters) {
   const auto& logger = this->getLogger();
 #endif
 
-  // TensorFlow session options
-  tf::SessionOptions options;
-  tf::ConfigProto& config = options.config;
-  config.set_use_per_session_threads(false);
-
-  // Parallelism parameters
-  const unsigned int default_inter_op = 1;
-  const unsigned int default_intra_op = 64;
-
-  auto inter_op = default_inter_op;
-  if (parameters->has("inter_op")) {
-    inter_op = parameters->get<int>("inter_op");
-  }
-  auto intra_op = default_intra_op;
-  if (parameters->has("intra_op")) {
-    inter_op = parameters->get<int>("intra_op");
-  }
-  config.set_intra_op_parallelism_threads(intra_op);
-  config.set_inter_op_parallelism_threads(inter_op);
-
-  // Start a new session
-  status_ = tf::NewSession(options, &(this->session_));
-  if (!status_.ok()) {
-    throw external_error("Could not initialize a tensorflow session");
-  }
-  AMDINFER_LOG_INFO(logger, "New TF Session Initiated");
-
   // Load the model
   std::string path;
   if (parameters->has("model")) {
@@ -190,18 +306,94 @@ void TfZendnn::doAcquire(ParameterMap* parameters) {
     throw invalid_argument("Model not provided in load-time parameters");
   }
 
-  status_ = tf::ReadBinaryProto(tf::Env::Default(), path, &graph_def_);
-  if (!status_.ok()) {
+  // the graph is parsed from a mapping of its file instead of being read
+  // into a buffer first but protobuf can only parse arrays under 2 GiB
+  bool parsed = false;
+  {
+    const util::MappedFile model{path};
+    if (model.size() <=
+        static_cast<size_t>(std::numeric_limits<int>::max())) {
+      parsed = graph_def_.ParseFromArray(model.data(),
+                                         static_cast<int>(model.size()));
+    } else {
+      parsed =
+        tf::ReadBinaryProto(tf::Env::Default(), path, &graph_def_).ok();
+    }
+  }
+  if (!parsed) {
     throw external_error("Could not load model with tensorflow");
   }
   AMDINFER_LOG_INFO(logger, "Reading Model");
 
-  // Add the graph to the session
-  status_ = this->session_->Create(graph_def_);
-  if (!status_.ok()) {
-    throw external_error("Could not load the model to session");
+  if (optimize_graph_) {
+    std::string cache_dir;
+    if (parameters->has("cache_dir")) {
+      cache_dir = parameters->get<std::string>("cache_dir");
+    }
+    this->optimizeGraph(path, cache_dir);
+  }
+
+  // Parallelism parameters. By default, each session uses all of its CPUs
+  // for the ops within it
+  const int default_inter_op = 1;
+  int32_t sessions = 1;
+  if (parameters->has("sessions")) {
+    sessions = parameters->get<int32_t>("sessions");
+  }
+  if (sessions <= 0) {
+    throw invalid_argument("The number of sessions must be positive");
+  }
+  auto inter_op = default_inter_op;
+  if (parameters->has("inter_op")) {
+    inter_op = parameters->get<int>("inter_op");
   }
-  AMDINFER_LOG_INFO(logger, "TF Session Created, Ready for prediction");
+
+  this->splitSessionCpus(sessions);
+  for (auto i = 0; i < sessions; ++i) {
+    const auto& cpus = this->getSessionCpus(i);
+    auto intra_op = static_cast<int>(cpus.size());
+    if (parameters->has("intra_op")) {
+      intra_op = parameters->get<int>("intra_op");
+    }
+
+    // TensorFlow session options
+    tf::SessionOptions options;
+    tf::ConfigProto& config = options.config;
+    config.set_use_per_session_threads(true);
+    config.set_intra_op_parallelism_threads(intra_op);
+    config.set_inter_op_parallelism_threads(inter_op);
+    *config.mutable_graph_options() = graph_options_;
+    if (optimize_graph_) {
+      // the graph is already optimized so it's not rewritten again
+      config.mutable_graph_options()
+        ->mutable_rewrite_options()
+        ->set_disable_meta_optimizer(true);
+    }
+
+    // Start a new session. Its thread pools are made here so create it from a
+    // thread that is pinned to the session's CPUs for the pools to inherit
+    tf::Session* session = nullptr;
+    tf::Status status;
+    std::thread creator{[&]() {
+      util::setThreadAffinity(cpus);
+      status = tf::NewSession(options, &session);
+      if (status.ok()) {
+        // Add the graph to the session
+        status = session->Create(graph_def_);
+      }
+    }};
+    creator.join();
+    if (session != nullptr) {
+      sessions_.push_back(session);
+    }
+    if (!status.ok()) {
+      throw external_error("Could not initialize a tensorflow session: " +
+                           status.ToString());
+    }
+  }
+  staging_.resize(sessions_.size());
+  AMDINFER_LOG_INFO(logger, std::to_string(sessions_.size()) +
+                              " TF Session(s) Created, Ready for prediction");
 
   // Adding metadata for input and output
   this->metadata_.addInputTensor(
@@ -211,155 +403,253 @@ void TfZendnn::doAcquire(ParameterMap* parameters) {
   this->metadata_.setName("TfZendnn");
 }
 
-void TfZendnn::doRun(BatchPtrQueue* input_queue) {
-  util::setThreadName("TfZendnn");
+void TfZendnn::optimizeGraph(const std::filesystem::path& path,
+                             const std::string& cache_dir) {
 #ifdef AMDINFER_ENABLE_LOGGING
   const auto& logger = this->getLogger();
 #endif
 
-  while (true) {
-    std::unique_ptr<Batch> batch;
-    input_queue->wait_dequeue(batch);
-    if (batch == nullptr) {
-      break;
+  std::filesystem::path cache_path;
+  if (const auto cache = util::getModelCacheDirectory(cache_dir);
+      !cache.empty()) {
+    // the optimized graph depends on the options and the node it's fetched
+    // from since the nodes that the output doesn't need are pruned
+    std::string options;
+    graph_options_.SerializeToString(&options);
+    const auto hash = std::hash<std::string>{}(options + output_node_);
+    util::ModelCacheKey key{
+      path, "cpu",
+      std::string{"tensorflow-"} + TF_Version() + "-" + std::to_string(hash),
+      static_cast<int>(this->batch_size_), ".pb"};
+    cache_path = util::getModelCachePath(cache, key);
+  }
+
+  if (!cache_path.empty() && std::filesystem::exists(cache_path)) {
+    tf::GraphDef cached;
+    if (tf::ReadBinaryProto(tf::Env::Default(), cache_path.string(), &cached)
+          .ok()) {
+      graph_def_ = std::move(cached);
+      AMDINFER_LOG_INFO(logger, "Optimized graph loaded from the model cache");
+      return;
     }
-    AMDINFER_LOG_DEBUG(logger, "Got request in TfZendnn. Size: " +
-                                 std::to_string(batch->size()));
+    // fall back to optimizing the graph again
+    AMDINFER_LOG_WARN(logger, "Could not read the optimized graph from " +
+                                cache_path.string());
+  }
 
-    std::vector<InferenceResponse> responses;
-    responses.reserve(batch->size());
+  tf::grappler::GrapplerItem item;
+  item.id = path.filename().string();
+  item.graph = graph_def_;
+  item.fetch.push_back(output_node_);
+  tf::ConfigProto config;
+  *config.mutable_graph_options() = graph_options_;
+
+  // the optimizers that need the device's properties get them from a cluster
+  // of the local CPU, as a session would give them
+  tf::grappler::VirtualCluster cluster(
+    {{"/job:localhost/replica:0/task:0/device:CPU:0",
+      tf::grappler::GetLocalCPUInfo()}});
+  tf::GraphDef optimized;
+  auto status = cluster.Provision();
+  if (status.ok()) {
+    status = tf::grappler::RunMetaOptimizer(std::move(item), config, nullptr,
+                                            &cluster, &optimized);
+  }
+  if (!status.ok()) {
+    throw external_error("Could not optimize the graph: " +
+                         status.ToString());
+  }
+  graph_def_ = std::move(optimized);
+  AMDINFER_LOG_INFO(logger, "Graph optimized");
+
+  if (!cache_path.empty() &&
+      !util::storeInModelCache(
+        cache_path, [this](const std::filesystem::path& temp_path) {
+          const auto written = tf::WriteBinaryProto(
+            tf::Env::Default(), temp_path.string(), graph_def_);
+          if (!written.ok()) {
+            throw external_error(written.ToString());
+          }
+        })) {
+    AMDINFER_LOG_WARN(logger, "Could not save the optimized graph to " +
+                                cache_path.string());
+  }
+}
 
-#ifdef AMDINFER_ENABLE_METRICS
-    Metrics::getInstance().incrementCounter(
-      MetricCounterIDs::PipelineIngressWorker);
+void TfZendnn::doRun(BatchPtrQueue* input_queue) {
+  util::setThreadName("TfZendnn");
+#ifdef AMDINFER_ENABLE_LOGGING
+  const auto& logger = this->getLogger();
 #endif
 
-    util::Timer timer{true};
+  this->runSessions(input_queue, [this](size_t session, BatchPtr batch) {
+    this->process(session, std::move(batch));
+  });
+  AMDINFER_LOG_INFO(logger, "TfZendnn ending");
+}
+
+void TfZendnn::process(size_t session, BatchPtr batch) {
+#ifdef AMDINFER_ENABLE_LOGGING
+  const auto& logger = this->getLogger();
+#endif
 
-    // Find total number of images to initialize for TF tensor
-    auto tensor_count = static_cast<int>(batch->size());
+  AMDINFER_LOG_DEBUG(logger, "Got request in TfZendnn. Size: " +
+                               std::to_string(batch->size()));
 
-    // Initialize a TensorFlow tensor with required shape
-    tf::Tensor input_tensor(
-      tf::DT_FLOAT, tf::TensorShape({tensor_count, image_height_, image_width_,
-                                     image_channels_}));
+  std::vector<InferenceResponse> responses;
+  responses.reserve(batch->size());
 
-    uint64_t input_size = image_height_ * image_width_ * image_channels_;
-    size_t vec_size = 0;
+#ifdef AMDINFER_ENABLE_METRICS
+  Metrics::getInstance().incrementCounter(
+    MetricCounterIDs::PipelineIngressWorker);
+#endif
 
-    for (unsigned int j = 0; j < batch->size(); j++) {
-      const auto& req = batch->getRequest(j);
+  util::Timer timer{true};
 
 #ifdef AMDINFER_ENABLE_TRACING
-      const auto& trace = batch->getTrace(j);
-      trace->startSpan("tfzendnn");
+  batch->startSpan("tfzendnn");
 #endif
-      auto& resp = responses.emplace_back();
-      resp.setID(req->getID());
-      resp.setModel("TFModel");
-
-      auto inputs = req->getInputs();
-      auto outputs = req->getOutputs();
-      AMDINFER_LOG_DEBUG(logger,
-                         "Size of input: " + std::to_string(inputs.size()));
-
-      // Get all the inputs from the requests and copy to the TensorFlow tensor
-      for (auto& input : inputs) {
-        auto* input_buffer = input.getData();
-        const auto* float_buffer = static_cast<float*>(input_buffer);
-        std::copy(float_buffer, float_buffer + input_size,
-                  input_tensor.flat<float>().data() + vec_size);
-        vec_size = vec_size + input_size;
-      }
+  for (const auto& req : *batch) {
+    auto& resp = responses.emplace_back();
+    resp.setID(req->getID());
+    resp.setModel("TFModel");
+  }
+  auto tensor_count = static_cast<int>(batch->size());
+  auto input_tensor = this->getInputTensor(session, *batch);
+
+  AMDINFER_LOG_DEBUG(logger, input_tensor.DebugString());
+
+  // Create the inputs and output tensor
+  std::vector<std::pair<std::string, tf::Tensor>> input_pair = {
+    {input_node_, input_tensor}};
+  std::vector<tensorflow::Tensor> output_tensor;
+
+  // Run the session to get the predictions
+  timer.add(util::Mark::InferStart);
+  auto status = this->sessions_.at(session)->Run(input_pair, {output_node_},
+                                                {}, &output_tensor);
+  timer.add(util::Mark::InferStop);
+  [[maybe_unused]] auto duration =
+    timer.count<std::milli>(util::Mark::InferStart, util::Mark::InferStop);
+  AMDINFER_LOG_INFO(logger, "Time taken for " + std::to_string(tensor_count) +
+                              " images: " + std::to_string(duration));
+
+  if (!status.ok()) {
+    AMDINFER_LOG_ERROR(logger, status.ToString());
+    for (const auto& req : *batch) {
+      req->runCallbackError("Issue with prediction");
     }
+    this->returnInputBuffers(std::move(batch));
+    return;
+  }
+  AMDINFER_LOG_DEBUG(logger, output_tensor[0].DebugString());
+
+  // Each input of each request is one row of the output, in the same order as
+  // the inputs. The outputs share the rows with the tensor, which lives until
+  // the last of them is destroyed, unless it shares the input's memory, which
+  // is reused once the batch is done
+  size_t response_size = output_classes_;
+  const auto row_bytes = response_size * sizeof(float);
+  std::vector<size_t> new_shape = {response_size};
+  const auto shared = output_tensor[0].SharesBufferWith(input_tensor);
+  auto rows = std::make_shared<tf::Tensor>(std::move(output_tensor[0]));
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  auto* rows_data = reinterpret_cast<std::byte*>(rows->flat<float>().data());
+  size_t row = 0;
+  for (unsigned int k = 0; k < batch->size(); k++) {
+    const auto& req = batch->getRequest(k);
+    auto inputs = req->getInputs();
+    auto outputs = req->getOutputs();
+    auto& resp = responses[k];
+
+    for (unsigned int i = 0; i < inputs.size(); i++) {
+      InferenceResponseOutput output;
+      output.setShape(new_shape);
+      output.setDatatype(DataType::Fp32);
+      auto* row_data = rows_data + (row * row_bytes);
+      if (shared) {
+        memcpy(this->allocateOutput(&output), row_data, row_bytes);
+      } else {
+        output.setData(std::shared_ptr<std::byte>(rows, row_data), row_bytes);
+      }
+      row++;
 
-    AMDINFER_LOG_DEBUG(logger, input_tensor.DebugString());
-
-    // Create the inputs and output tensor
-    std::vector<std::pair<std::string, tf::Tensor>> input_pair = {
-      {input_node_, input_tensor}};
-    std::vector<tensorflow::Tensor> output_tensor;
-
-    // Run the session to get the predictions
-    timer.add("infer_start");
-    status_ =
-      this->session_->Run(input_pair, {output_node_}, {}, &output_tensor);
-    timer.add("infer_stop");
-    [[maybe_unused]] auto duration =
-      timer.count<std::milli>("infer_start", "infer_stop");
-    AMDINFER_LOG_INFO(logger, "Time taken for " + std::to_string(tensor_count) +
-                                " images: " + std::to_string(duration));
-
-    if (!status_.ok()) {
-      AMDINFER_LOG_ERROR(logger, status_.ToString());
-      for (const auto& req : *batch) {
-        req->runCallbackError("Issue with prediction");
+      std::string output_name;
+      if (i < outputs.size()) {
+        output_name = outputs[i].getName();
       }
-    }
-    AMDINFER_LOG_DEBUG(logger, output_tensor[0].DebugString());
-
-    // Copy the output from the model to the response object
-    size_t response_size = output_classes_;
-    std::vector<size_t> new_shape = {response_size};
-    for (unsigned int k = 0; k < batch->size(); k++) {
-      const auto& req = batch->getRequest(k);
-      auto inputs = req->getInputs();
-      auto outputs = req->getOutputs();
-      auto& resp = responses[k];
-
-      for (unsigned int i = 0; i < inputs.size(); i++) {
-        InferenceResponseOutput output;
-        std::vector<std::byte> buffer;
-        buffer.resize(response_size * sizeof(float));
-
-        memcpy(buffer.data(),
-               output_tensor[0].flat<float>().data() + (i * response_size),
-               response_size * sizeof(float));
-        output.setData(std::move(buffer));
-
-        std::string output_name;
-        if (i < outputs.size()) {
-          output_name = outputs[i].getName();
-        }
-
-        if (output_name.empty()) {
-          output.setName(inputs[0].getName());
-        } else {
-          output.setName(output_name);
-        }
-
-        output.setShape(new_shape);
-        output.setDatatype(DataType::Fp32);
-        resp.addOutput(output);
+
+      if (output_name.empty()) {
+        output.setName(inputs[0].getName());
+      } else {
+        output.setName(output_name);
       }
 
+      resp.addOutput(output);
+    }
+
 #ifdef AMDINFER_ENABLE_TRACING
-      auto context = batch->getTrace(k)->propagate();
-      resp.setContext(std::move(context));
+    auto context = batch->getTrace(k)->propagate();
+    resp.setContext(std::move(context));
 #endif
 
-      timer.stop();
-      duration = timer.count<std::milli>();
-      AMDINFER_LOG_DEBUG(logger,
-                         "Total time taken: " + std::to_string(duration));
+    timer.stop();
+    duration = timer.count<std::milli>();
+    AMDINFER_LOG_DEBUG(logger, "Total time taken: " + std::to_string(duration));
 
-      req->runCallbackOnce(resp);
+    req->runCallbackOnce(resp);
 
 #ifdef AMDINFER_ENABLE_METRICS
-      timer.add("metrics", batch->getTime(k));
-      duration = timer.count<std::micro>("metrics", "stop");
-      Metrics::getInstance().observeSummary(MetricSummaryIDs::RequestLatency,
-                                            duration);
+    timer.add(util::Mark::Arrival, batch->getTime(k));
+    duration = timer.count<std::micro>(util::Mark::Arrival, util::Mark::Stop);
+    Metrics::getInstance().observeSummary(MetricSummaryIDs::RequestLatency,
+                                          duration);
 #endif
+  }
+  this->returnInputBuffers(std::move(batch));
+}
+
+tf::Tensor TfZendnn::getInputTensor(size_t session, const Batch& batch) {
+  int64_t rows = 0;
+  for (const auto& req : batch) {
+    rows += static_cast<int64_t>(req->getInputs().size());
+  }
+  const tf::TensorShape shape{rows, image_height_, image_width_,
+                              image_channels_};
+  const auto bytes = static_cast<size_t>(shape.num_elements()) * sizeof(float);
+
+  // TF's kernels may assume that the data is aligned as its allocator does
+  auto* data = batch.getContiguousInput(bytes);
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  const auto address = reinterpret_cast<uintptr_t>(data);
+  if (data != nullptr && address % tf::Allocator::kAllocatorAlignment == 0) {
+    auto* buffer = new BatchTensorBuffer(data, bytes);
+    tf::Tensor tensor{tf::DT_FLOAT, shape, buffer};
+    // the tensor holds its own reference to the buffer
+    buffer->Unref();
+    return tensor;
+  }
+
+  auto& staged = staging_.at(session);
+  auto& tensor = staged.try_emplace(rows, tf::DT_FLOAT, shape).first->second;
+  auto* destination = tensor.flat<float>().data();
+  for (const auto& req : batch) {
+    for (const auto& input : req->getInputs()) {
+      const auto* source = static_cast<const float*>(input.getData());
+      destination = std::copy(source, source + image_size_, destination);
     }
-    this->returnInputBuffers(std::move(batch));
   }
-  AMDINFER_LOG_INFO(logger, "TfZendnn ending");
+  return tensor;
 }
 
 void TfZendnn::doRelease() {
-  auto retval = this->session_->Close();
-  assert(retval.ok());
+  for (auto* session : sessions_) {
+    auto retval = session->Close();
+    assert(retval.ok());
+    delete session;  // NOLINT(cppcoreguidelines-owning-memory)
+  }
+  sessions_.clear();
+  staging_.clear();
 }
 void TfZendnn::doDestroy() {}
 
@@ -377,7 +667,7 @@ void* openLibrary(const char* library, int dlopen_flags) {
 extern "C" {
 // using smart pointer here may cause problems inside shared object so managing
 // manually
-amdinfer::workers::Worker* getWorker() {
+amdinfer::workers::Worker* AMDINFER_WORKER_FACTORY() {
   using amdinfer::workers::openLibrary;
   // Due to the DEEPBIND change for tensorflow_cc.so below, OMP now gives a
   // segfault unexpectedly if the server is run from Python. Preloading iomp
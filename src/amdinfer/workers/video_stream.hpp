@@ -0,0 +1,329 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Defines the staged pipeline shared by the workers that run inference
+ * on the frames of a video and stream the results back
+ */
+
+#ifndef GUARD_AMDINFER_WORKERS_VIDEO_STREAM
+#define GUARD_AMDINFER_WORKERS_VIDEO_STREAM
+
+#include <cmath>                   // for lround
+#include <cstddef>                 // for size_t
+#include <cstdint>                 // for int32_t
+#include <memory>                  // for unique_ptr
+#include <opencv2/core.hpp>        // for Mat, norm, Size
+#include <opencv2/imgcodecs.hpp>   // for imencode
+#include <opencv2/imgproc.hpp>     // for resize, cvtColor
+#include <opencv2/videoio.hpp>     // for VideoCapture
+#include <optional>                // for optional, nullopt
+#include <string>                  // for string
+#include <utility>                 // for move
+#include <variant>                 // for bad_variant_access
+#include <vart/tensor_buffer.hpp>  // for TensorBuffer
+#include <vector>                  // for vector
+
+#include "amdinfer/core/exceptions.hpp"  // for invalid_argument
+#include "amdinfer/core/parameters.hpp"  // for ParameterMap
+#include "amdinfer/util/base64.hpp"      // for base64Encode
+#include "amdinfer/util/pipeline.hpp"    // for BoundedQueue, Pipeline, pop...
+
+namespace amdinfer::workers {
+
+using TensorBuffers = std::vector<std::unique_ptr<vart::TensorBuffer>>;
+
+/// A batch of frames from a video as it moves through the pipeline
+struct VideoBatch {
+  /// position of the batch in the video
+  size_t index = 0;
+  std::vector<cv::Mat> frames;
+  /// number of unchanged frames before each frame that reuse the last result
+  std::vector<size_t> repeats;
+  TensorBuffers inputs;
+  TensorBuffers outputs;
+  /// the encoded frames and the labels for them
+  std::vector<std::string> images;
+  std::vector<std::string> labels;
+};
+
+/// The number of threads for each stage of the pipeline and the queue depth
+struct VideoPipelineOptions {
+  size_t preprocess_threads = 2;
+  size_t infer_threads = 1;
+  size_t postprocess_threads = 2;
+  size_t queue_depth = 4;
+};
+
+/// Which frames of a video are sent through the pipeline
+struct VideoSampling {
+  /// one frame in this many is read, to decimate the video to a lower rate
+  size_t stride = 1;
+  /// a read frame whose thumbnail differs from the last processed frame's by
+  /// less than this mean absolute difference per pixel, from 0 to 255, reuses
+  /// the last result. Zero disables the check
+  double threshold = 0;
+};
+
+namespace detail {
+
+inline void setPositive(const ParameterMap* parameters, const std::string& key,
+                        size_t* value) {
+  if (parameters->has(key)) {
+    auto requested = parameters->get<int32_t>(key);
+    if (requested <= 0) {
+      throw invalid_argument("The parameter " + key + " must be positive");
+    }
+    *value = static_cast<size_t>(requested);
+  }
+}
+
+inline double getNumber(const ParameterMap* parameters,
+                        const std::string& key) {
+  try {
+    return parameters->get<double>(key);
+  } catch (const std::bad_variant_access&) {
+    return parameters->get<int32_t>(key);
+  }
+}
+
+}  // namespace detail
+
+/**
+ * @brief Get which frames to process from the parameters of a video input:
+ * fps, the rate to decimate the video to, and skip_threshold, the difference
+ * under which frames are unchanged. Both may be integers or doubles.
+ *
+ * @param parameters the input's parameters
+ * @param video_fps the frame rate of the video
+ * @return VideoSampling
+ */
+inline VideoSampling parseVideoSampling(const ParameterMap& parameters,
+                                        double video_fps) {
+  VideoSampling sampling;
+  try {
+    if (parameters.has("fps")) {
+      const auto fps = detail::getNumber(&parameters, "fps");
+      if (fps <= 0) {
+        throw invalid_argument("The parameter fps must be positive");
+      }
+      if (video_fps > fps) {
+        sampling.stride = static_cast<size_t>(std::lround(video_fps / fps));
+      }
+    }
+    if (parameters.has("skip_threshold")) {
+      sampling.threshold = detail::getNumber(&parameters, "skip_threshold");
+    }
+  } catch (const std::bad_variant_access&) {
+    throw invalid_argument(
+      "The parameters fps and skip_threshold must be numbers");
+  }
+  return sampling;
+}
+
+/**
+ * @brief The FrameDifference class checks if frames are nearly the same as the
+ * last changed frame by comparing small grayscale thumbnails of them, which
+ * costs much less than running inference on the frame
+ */
+class FrameDifference {
+ public:
+  /**
+   * @brief Construct a new FrameDifference object
+   *
+   * @param threshold mean absolute difference per pixel of the thumbnails
+   * under which frames are unchanged. If it's not positive, every frame is
+   * changed
+   */
+  explicit FrameDifference(double threshold) : threshold_(threshold) {}
+
+  /**
+   * @brief Check if a frame is unchanged. Changed frames become the frame
+   * that later ones are compared to so slow changes still add up
+   *
+   * @param frame a BGR or grayscale frame
+   * @return bool
+   */
+  bool unchanged(const cv::Mat& frame) {
+    if (threshold_ <= 0) {
+      return false;
+    }
+    constexpr auto kThumbnailSize = 32;
+    cv::Mat thumbnail;
+    cv::resize(frame, thumbnail, cv::Size(kThumbnailSize, kThumbnailSize), 0,
+               0, cv::INTER_AREA);
+    if (thumbnail.channels() == 3) {
+      cv::cvtColor(thumbnail, thumbnail, cv::COLOR_BGR2GRAY);
+    }
+    if (!last_.empty()) {
+      const auto difference = cv::norm(thumbnail, last_, cv::NORM_L1) /
+                              static_cast<double>(thumbnail.total());
+      if (difference < threshold_) {
+        return true;
+      }
+    }
+    last_ = std::move(thumbnail);
+    return false;
+  }
+
+ private:
+  double threshold_;
+  cv::Mat last_;
+};
+
+/**
+ * @brief Get the pipeline options from the load-time parameters
+ * preprocess_threads, infer_threads, postprocess_threads and queue_depth
+ *
+ * @param parameters the worker's load-time parameters
+ * @return VideoPipelineOptions
+ */
+inline VideoPipelineOptions parseVideoPipelineOptions(
+  const ParameterMap* parameters) {
+  VideoPipelineOptions options;
+  if (parameters != nullptr) {
+    detail::setPositive(parameters, "preprocess_threads",
+                        &options.preprocess_threads);
+    detail::setPositive(parameters, "infer_threads", &options.infer_threads);
+    detail::setPositive(parameters, "postprocess_threads",
+                        &options.postprocess_threads);
+    detail::setPositive(parameters, "queue_depth", &options.queue_depth);
+  }
+  return options;
+}
+
+/**
+ * @brief Run the frames of a video through a pipeline of stages connected by
+ * bounded queues so decoding, preprocessing, inference and encoding of
+ * different batches overlap:
+ *
+ *   decode -> preprocess -> infer -> postprocess -> respond
+ *
+ * Decoding runs on one thread since frames are read from the video in order.
+ * It only decodes one frame in every sampling.stride frames and frames that
+ * are unchanged from the last processed frame are left out of the batches
+ * and respond with the last result again. The other stages run with the
+ * configured number of threads and the results are put back in order on the
+ * calling thread before responding. A final partial batch is dropped. If a
+ * stage throws, the pipeline stops and the error is rethrown here. The
+ * callbacks may be called from multiple threads at once, except for respond.
+ *
+ * @param cap the opened video
+ * @param frames the maximum number of frames to read from the video
+ * @param batch_size the number of frames in each batch
+ * @param options the number of threads per stage and the queue depth
+ * @param sampling which frames to process
+ * @param preprocess fills VideoBatch::inputs from VideoBatch::frames
+ * @param infer runs inference on the inputs and returns the outputs
+ * @param postprocess fills VideoBatch::labels from VideoBatch::outputs
+ * @param respond called with the encoded image and labels of each frame
+ */
+template <typename Preprocess, typename Infer, typename Postprocess,
+          typename Respond>
+void runVideoPipeline(cv::VideoCapture* cap, size_t frames, size_t batch_size,
+                      const VideoPipelineOptions& options,
+                      const VideoSampling& sampling, Preprocess preprocess,
+                      Infer infer,
+                      Postprocess postprocess, Respond respond) {
+  util::BoundedQueue<VideoBatch> decoded{options.queue_depth};
+  util::BoundedQueue<VideoBatch> preprocessed{options.queue_depth};
+  util::BoundedQueue<VideoBatch> inferred{options.queue_depth};
+  util::BoundedQueue<VideoBatch> postprocessed{options.queue_depth};
+
+  util::Pipeline pipeline;
+  size_t next = 0;
+  size_t read = 0;
+  size_t repeats = 0;
+  FrameDifference difference{sampling.threshold};
+  pipeline.addSource(
+    "VideoDecode", &decoded, [&]() -> std::optional<VideoBatch> {
+      VideoBatch batch;
+      batch.index = next++;
+      batch.frames.reserve(batch_size);
+      batch.repeats.reserve(batch_size);
+      while (batch.frames.size() < batch_size) {
+        if (read == frames) {
+          return std::nullopt;
+        }
+        // decimated frames are skipped without decoding them
+        if (read++ % sampling.stride != 0) {
+          if (!cap->grab()) {
+            return std::nullopt;
+          }
+          continue;
+        }
+        cv::Mat frame;
+        *cap >> frame;
+        if (frame.empty()) {
+          return std::nullopt;
+        }
+        if (difference.unchanged(frame)) {
+          ++repeats;
+          continue;
+        }
+        batch.frames.push_back(std::move(frame));
+        batch.repeats.push_back(repeats);
+        repeats = 0;
+      }
+      return batch;
+    });
+  pipeline.addStage("VideoPreprocess", options.preprocess_threads, &decoded,
+                    &preprocessed, [&](VideoBatch batch) {
+                      preprocess(&batch);
+                      return batch;
+                    });
+  pipeline.addStage("VideoInfer", options.infer_threads, &preprocessed,
+                    &inferred, [&](VideoBatch batch) {
+                      batch.outputs = infer(std::move(batch.inputs));
+                      return batch;
+                    });
+  pipeline.addStage(
+    "VideoPostprocess", options.postprocess_threads, &inferred, &postprocessed,
+    [&](VideoBatch batch) {
+      postprocess(&batch);
+      batch.images.reserve(batch.frames.size());
+      std::vector<unsigned char> buffer;
+      for (const auto& frame : batch.frames) {
+        cv::imencode(".jpg", frame, buffer);
+        const auto* data = reinterpret_cast<const char*>(buffer.data());
+        batch.images.push_back("data:image/jpg;base64," +
+                               util::base64Encode(data, buffer.size()));
+      }
+      // free the frames and tensors while the batch waits to be sent
+      batch.frames.clear();
+      batch.outputs.clear();
+      return batch;
+    });
+
+  std::string last_image;
+  std::string last_labels;
+  util::popInOrder(
+    &postprocessed, [](const VideoBatch& batch) { return batch.index; },
+    [&](VideoBatch batch) {
+      for (size_t i = 0; i < batch.images.size(); ++i) {
+        for (size_t j = 0; j < batch.repeats.at(i); ++j) {
+          respond(last_image, last_labels);
+        }
+        respond(batch.images[i], batch.labels.at(i));
+        last_image = std::move(batch.images[i]);
+        last_labels = std::move(batch.labels.at(i));
+      }
+    });
+  pipeline.join();
+}
+
+}  // namespace amdinfer::workers
+
+#endif  // GUARD_AMDINFER_WORKERS_VIDEO_STREAM
@@ -21,19 +21,48 @@
 #ifndef GUARD_AMDINFER_WORKERS_WORKER
 #define GUARD_AMDINFER_WORKERS_WORKER
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
 #include <limits>
 #include <memory>
+#include <ratio>
 #include <string>
 #include <thread>
 #include <utility>
 #include <vector>
 
+#include "amdinfer/batching/batch.hpp"
+#include "amdinfer/batching/batch_queue.hpp"
+#include "amdinfer/batching/bucket.hpp"
+#include "amdinfer/batching/deadline.hpp"
+#include "amdinfer/batching/input_cast.hpp"
+#include "amdinfer/batching/sequence.hpp"
 #include "amdinfer/batching/soft.hpp"
 #include "amdinfer/buffers/buffer.hpp"
 #include "amdinfer/build_options.hpp"
+#include "amdinfer/core/device_scheduler.hpp"
+#include "amdinfer/core/exceptions.hpp"
+#include "amdinfer/core/inference_request.hpp"
+#include "amdinfer/core/inference_response.hpp"
 #include "amdinfer/core/memory_pool/pool.hpp"
 #include "amdinfer/core/model_metadata.hpp"
+#include "amdinfer/core/tensor.hpp"
 #include "amdinfer/observation/logging.hpp"
+#include "amdinfer/observation/metrics.hpp"
+#include "amdinfer/observation/tracing.hpp"
+#include "amdinfer/util/thread.hpp"
+#include "amdinfer/util/timer.hpp"
+
+// The function that each worker defines to make itself, which the server looks
+// up in the worker's library. The build names it uniquely for each worker that
+// it compiles into the server so they don't clash
+#ifndef AMDINFER_WORKER_FACTORY
+// NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
+#define AMDINFER_WORKER_FACTORY getWorker
+#endif
 
 namespace amdinfer {
 
@@ -52,6 +81,41 @@ enum class WorkerStatus {
   Dead
 };
 
+/// Get the name of a worker's status as the debugging endpoints report it
+inline std::string toString(WorkerStatus status) {
+  switch (status) {
+    case WorkerStatus::New:
+      return "new";
+    case WorkerStatus::Init:
+      return "init";
+    case WorkerStatus::Acquire:
+      return "acquire";
+    case WorkerStatus::Run:
+      return "run";
+    case WorkerStatus::Inactive:
+      return "inactive";
+    case WorkerStatus::Release:
+      return "release";
+    case WorkerStatus::Destroy:
+      return "destroy";
+    case WorkerStatus::Dead:
+      return "dead";
+    default:
+      return "unknown";
+  }
+}
+
+/// Buffers of one tensor that a worker uses at the same time when it's busy
+struct BufferDemand {
+  Tensor tensor;
+  /// number of tensors in each buffer
+  size_t batch_size;
+  /// number of buffers
+  size_t count;
+  /// the allocators that the buffers come from, in order
+  std::vector<MemoryAllocators> allocators;
+};
+
 /**
  * @brief All workers should extend the Worker class which defines the methods
  * to create, start, and run workers over their lifecycle.
@@ -75,18 +139,143 @@ class Worker {
 
   /// Allocate some buffers that are used to hold input and output data
   [[nodiscard]] virtual std::vector<MemoryAllocators> getAllocators() const = 0;
+  /**
+   * @brief Workers that read each request's input data through its own
+   * pointers, rather than through the batch's contiguous input buffers, can
+   * return true here to receive scatter-gather batches. The batcher then skips
+   * copying the requests into a batch buffer.
+   */
+  [[nodiscard]] virtual bool acceptsScatterGather() const { return false; }
+  /**
+   * @brief Workers that accept scatter-gather batches and can read segments
+   * that are in GPU memory, such as inputs in GPU shared memory, can return
+   * true here to receive them in place. Otherwise, they're copied to the host.
+   */
+  [[nodiscard]] virtual bool acceptsDeviceInputs() const { return false; }
+  /**
+   * @brief Workers whose runtimes take inputs concatenated along the first
+   * dimension with the offsets of each request, such as for embeddings, can
+   * return true here. Their batches are then ragged if they're loaded with
+   * the "ragged" parameter so requests of different lengths aren't padded.
+   */
+  [[nodiscard]] virtual bool acceptsRaggedBatches() const { return false; }
+  /**
+   * @brief Workers whose models take inputs of fixed types can return them
+   * here so requests that send types that can be converted to them, such as
+   * 8-bit images to models that take floats, are converted as they're copied
+   * into contiguous batches.
+   */
+  [[nodiscard]] virtual std::vector<InputCast> getInputCasts() const {
+    return {};
+  }
 
-  /// Perform low-cost initialization of the worker
+  /**
+   * @brief Perform low-cost initialization of the worker. If the parameters
+   * have "cpus" (a CPU list like "0-3,8") or "numa_node", the worker's run
+   * thread is pinned to those CPUs.
+   *
+   * @param parameters the worker's load-time parameters
+   */
   void init(ParameterMap* parameters) {
     this->status_ = WorkerStatus::Init;
+    if (parameters != nullptr) {
+      this->cpus_ = util::getCpuAffinity(
+        parameters->has("cpus") ? parameters->get<std::string>("cpus") : "",
+        parameters->has("numa_node") ? parameters->get<int32_t>("numa_node")
+                                     : -1);
+    }
     this->doInit(parameters);
   }
   /// Acquire any hardware resources or perform high-cost initialization
   void acquire(ParameterMap* parameters) {
     this->status_ = WorkerStatus::Acquire;
     this->doAcquire(parameters);
+  }
+  /**
+   * @brief Run synthetic batches through the worker and then mark it as ready.
+   * Frameworks often initialize lazily on the first runs so warming up moves
+   * that cost out of the first real requests. If the parameters have "warmup"
+   * (a number of batches), that many batches of zeros are run at each of the
+   * worker's batch sizes and their timings are logged. They're left out of the
+   * request and latency metrics. The memory pool must be set before this is
+   * called.
+   *
+   * @param parameters the worker's load-time parameters
+   */
+  void warmUp(ParameterMap* parameters) {
+    int32_t batches = 0;
+    if (parameters != nullptr && parameters->has("warmup")) {
+      batches = parameters->get<int32_t>("warmup");
+    }
+
+    const auto inputs = this->getWarmupInputs();
+    if (batches > 0 && !inputs.empty()) {
+#ifdef AMDINFER_ENABLE_LOGGING
+      const auto& logger = this->getLogger();
+#endif
+#ifdef AMDINFER_ENABLE_METRICS
+      // doRun() runs the batches on this thread so it's excluded meanwhile
+      const MetricsExclusion exclusion;
+#endif
+      for (auto batch_size : this->getBatchSizes()) {
+        double first = 0;
+        double total = 0;
+        for (auto i = 0; i < batches; ++i) {
+          BatchPtrQueue queue;
+          queue.enqueue(this->makeWarmupBatch(inputs, batch_size));
+          queue.enqueue(nullptr);
+
+          util::Timer timer{true};
+          this->doRun(&queue);
+          timer.stop();
+          const auto duration = timer.count<std::micro>();
+          if (i == 0) {
+            first = duration;
+          }
+          total += duration;
+        }
+        [[maybe_unused]] const auto rest =
+          batches > 1 ? (total - first) / (batches - 1) : first;
+        AMDINFER_LOG_INFO(
+          logger, "Warmed up " + this->metadata_.getName() + " with " +
+                    std::to_string(batches) + " batches of size " +
+                    std::to_string(batch_size) + ": first took " +
+                    std::to_string(first) + " us and the rest took " +
+                    std::to_string(rest) + " us on average");
+      }
+    }
     this->metadata_.setReady(true);
   }
+  /**
+   * @brief Allocate the buffers that the worker uses when it's busy so the
+   * first requests after loading don't pay to grow the allocators. It's
+   * skipped if the parameters have "preallocate" set to false. The memory
+   * pool must be set before this is called.
+   *
+   * @param parameters the worker's load-time parameters
+   */
+  void preallocate(ParameterMap* parameters) {
+    if (parameters != nullptr && parameters->has("preallocate") &&
+        !parameters->get<bool>("preallocate")) {
+      return;
+    }
+#ifdef AMDINFER_ENABLE_LOGGING
+    const auto& logger = this->getLogger();
+#endif
+    for (const auto& demand : this->getBufferDemands()) {
+      // tensors with dynamic dimensions don't have a size to reserve
+      if (demand.tensor.getSize() == 0 || demand.count == 0) {
+        continue;
+      }
+      try {
+        pool_->reserve(demand.allocators, demand.tensor, demand.batch_size,
+                       demand.count);
+      } catch (const std::exception& e) {
+        AMDINFER_LOG_WARN(logger, "Could not preallocate the buffers for " +
+                                    demand.tensor.getName() + ": " + e.what());
+      }
+    }
+  }
   /**
    * @brief The main body of the worker executes the work
    *
@@ -94,14 +283,32 @@ class Worker {
    */
   void run(BatchPtrQueue* input_queue) {
     this->status_ = WorkerStatus::Run;
+    util::setThreadAffinity(this->cpus_);
     this->doRun(input_queue);
     this->status_ = WorkerStatus::Inactive;
+    if (stop_callback_) {
+      stop_callback_();
+    }
+  }
+  /**
+   * @brief Set a function that's called on the worker's thread when run()
+   * returns so the owner can wait for the worker to stop without polling its
+   * status. It should be set before the worker is spawned.
+   *
+   * @param callback function to call
+   */
+  void setStopCallback(std::function<void()> callback) {
+    stop_callback_ = std::move(callback);
   }
   /// Release any hardware resources
   void release() {
     this->status_ = WorkerStatus::Release;
     this->metadata_.setReady(false);
     this->doRelease();
+    if (scheduler_ != nullptr) {
+      scheduler_->removeEndpoint(endpoint_);
+      scheduler_.reset();
+    }
   }
   /// Perform any final operations before the worker thread is joined
   void destroy() {
@@ -111,12 +318,36 @@ class Worker {
   }
 
   void setPool(MemoryPool* pool) { pool_ = pool; }
+  /// Set the endpoint that the worker serves
+  void setEndpoint(const std::string& endpoint) { endpoint_ = endpoint; }
 
   [[nodiscard]] size_t getBatchSize() const { return this->batch_size_; }
+  /// Get the batch sizes the worker runs at, which are warmed up separately
+  [[nodiscard]] virtual std::vector<size_t> getBatchSizes() const {
+    return {this->batch_size_};
+  }
   [[nodiscard]] WorkerStatus getStatus() const { return this->status_; }
 
   virtual std::vector<std::unique_ptr<Batcher>> makeBatcher(
     int num, ParameterMap* parameters, MemoryPool* pool) {
+    // workers using the default can opt into deadline-aware, shape-bucketed
+    // or sequence batching at load
+    if (parameters != nullptr && parameters->has("batcher")) {
+      const auto batcher = parameters->get<std::string>("batcher");
+      if (batcher == "deadline") {
+        return this->makeBatcher<DeadlineBatcher>(num, parameters, pool);
+      }
+      if (batcher == "bucket") {
+        return this->makeBatcher<BucketBatcher>(num, parameters, pool);
+      }
+      if (batcher == "sequence") {
+        // one batcher owns all the slots so a sequence's steps stay in order
+        std::vector<std::unique_ptr<Batcher>> batchers;
+        batchers.emplace_back(
+          std::make_unique<SequenceBatcher>(pool, parameters));
+        return batchers;
+      }
+    }
     return this->makeBatcher<SoftBatcher>(num, parameters, pool);
   }
 
@@ -140,16 +371,263 @@ class Worker {
   [[nodiscard]] const Logger& getLogger() const { return logger_; };
 #endif
 
+  /**
+   * @brief Return a batch's input buffers to the pool once the worker is done
+   * with it, and the batch itself to the batcher that made it for reuse
+   *
+   * @param batch the finished batch
+   */
   void returnInputBuffers(std::unique_ptr<Batch> batch) {
-    auto buffers = batch->getInputBuffers();
-    for (auto& buffer : buffers) {
-      pool_->put(std::move(buffer));
+    batch->releaseInputBuffers(
+      [this](BufferPtr buffer) { pool_->put(std::move(buffer)); });
+    Batch::recycle(std::move(batch));
+  }
+
+  /**
+   * @brief Back an output's data with a buffer borrowed from the memory pool
+   * instead of a new heap allocation. The output's shape and datatype must be
+   * set first. The buffer goes back to its allocator when the last copy of
+   * the output is destroyed. Responses can outlive the server, such as those
+   * held by clients in the same process, so the output holds the allocator to
+   * keep its memory allocated after the pool is destroyed.
+   *
+   * @param output the output to allocate data for
+   * @return void* pointer to write the output's data to
+   */
+  void* allocateOutput(InferenceResponseOutput* output) {
+    auto buffer = pool_->get({MemoryAllocators::Cpu}, *output, 1);
+    auto* data = static_cast<std::byte*>(buffer->data(0));
+    const auto size = output->getSize() * output->getDatatype().size();
+    auto allocator = pool_->getOwner(buffer.get());
+    // the deleter must be copyable so it holds the buffer as a raw pointer
+    std::shared_ptr<std::byte> owner{
+      data, [allocator = std::move(allocator),
+             raw = buffer.release()](std::byte* address) {
+        const std::unique_ptr<Buffer> memory{raw};
+        allocator->put(address);
+      }};
+    output->setData(std::move(owner), size);
+    return data;
+  }
+
+  /**
+   * @brief Back an output's data with a buffer from the memory pool that may
+   * not be on the host, such as one in GPU memory. Its data is only copied to
+   * the host if the response is serialized. The buffer goes back to its
+   * allocator when the last copy of the output is destroyed, even if the pool
+   * has been destroyed by then.
+   *
+   * @param output the output to set the data of
+   * @param buffer the buffer holding the output's data
+   */
+  void setOutputBuffer(InferenceResponseOutput* output, BufferPtr buffer) {
+    const auto size = buffer->size();
+    auto allocator = pool_->getOwner(buffer.get());
+    std::shared_ptr<Buffer> owner{
+      buffer.release(), [allocator = std::move(allocator)](Buffer* raw) {
+        const std::unique_ptr<Buffer> memory{raw};
+        allocator->put(memory->data(0));
+      }};
+    output->setData(std::move(owner), size);
+  }
+
+  /**
+   * @brief Share a device with the other workers that run on it. If the
+   * parameters have "device_jobs", at most that many jobs run on the device at
+   * once and endpoints take turns by their "device_priority" and then fairly
+   * by their "device_weight". Otherwise, jobs never wait and only the device
+   * time of each endpoint is recorded. The limit is shared by all the workers
+   * on the device so a worker that asks for a different one fails to load.
+   * Workers call this once they know their device and then hold a turn from
+   * waitForDevice() while each job runs.
+   *
+   * @param device the device's name, such as gpu0
+   * @param parameters the worker's load-time parameters
+   */
+  void shareDevice(const std::string& device, ParameterMap* parameters) {
+    int32_t weight = 1;
+    int32_t priority = 0;
+    if (parameters != nullptr) {
+      if (parameters->has("device_weight")) {
+        weight = parameters->get<int32_t>("device_weight");
+      }
+      if (parameters->has("device_priority")) {
+        priority = parameters->get<int32_t>("device_priority");
+      }
+    }
+    auto scheduler = DeviceScheduler::get(device);
+    scheduler->addEndpoint(endpoint_, weight, priority);
+    if (parameters != nullptr && parameters->has("device_jobs")) {
+      const auto jobs = parameters->get<int32_t>("device_jobs");
+      if (jobs < 0) {
+        scheduler->removeEndpoint(endpoint_);
+        throw invalid_argument("The device jobs can't be negative");
+      }
+      try {
+        scheduler->setJobs(jobs);
+      } catch (const invalid_argument&) {
+        scheduler->removeEndpoint(endpoint_);
+        throw;
+      }
+    }
+    scheduler_ = std::move(scheduler);
+  }
+
+  /**
+   * @brief Wait for the endpoint's turn to run a job on the worker's device.
+   * If the worker doesn't share a device, this returns right away.
+   *
+   * @return DeviceScheduler::Turn the turn, which is held until it's released
+   */
+  DeviceScheduler::Turn waitForDevice() {
+    if (scheduler_ == nullptr) {
+      return {};
+    }
+    return scheduler_->acquire(endpoint_);
+  }
+
+  /**
+   * @brief Take the endpoint's turn to run a job on the worker's device if it
+   * doesn't have to wait for it. Workers that keep a job in flight while they
+   * start the next one should finish it before they wait for a turn so they
+   * don't hold up the workers whose turn it is.
+   *
+   * @return std::optional<DeviceScheduler::Turn> the turn or nullopt if it
+   * would have to wait
+   */
+  std::optional<DeviceScheduler::Turn> tryDevice() {
+    if (scheduler_ == nullptr) {
+      return DeviceScheduler::Turn{};
+    }
+    return scheduler_->tryAcquire(endpoint_);
+  }
+
+  /**
+   * @brief Split the worker's CPUs, or all the CPUs it may run on if it isn't
+   * pinned, evenly between its sessions. Workers with sessions call this while
+   * they're loaded so a split that can't be made fails the load rather than a
+   * session's thread.
+   *
+   * @param sessions number of sessions
+   */
+  void splitSessionCpus(size_t sessions) {
+    const auto cpus = cpus_.empty() ? util::getAllowedCpus() : cpus_;
+    session_cpus_ = util::splitCpus(cpus, sessions);
+  }
+
+  /**
+   * @brief Get the CPUs of one of the worker's sessions from the split made by
+   * splitSessionCpus()
+   *
+   * @param session index of the session
+   * @return const std::vector<int>&
+   */
+  [[nodiscard]] const std::vector<int>& getSessionCpus(size_t session) const {
+    return session_cpus_.at(session);
+  }
+
+  /**
+   * @brief Process batches from the queue with several sessions at once. Each
+   * session has its own thread, pinned to its share of the CPUs from
+   * splitSessionCpus(), and takes batches from the queue as it becomes free.
+   * This returns once the worker has been stopped and every session is done.
+   * With one session, batches are processed on the calling thread.
+   *
+   * @param input_queue queue that receives incoming batches
+   * @param process function that processes a batch with the given session
+   */
+  void runSessions(BatchPtrQueue* input_queue,
+                   const std::function<void(size_t, BatchPtr)>& process) {
+    const auto sessions = session_cpus_.size();
+    if (sessions <= 1) {
+      while (true) {
+        BatchPtr batch;
+        input_queue->wait_dequeue(batch);
+        if (batch == nullptr) {
+          break;
+        }
+        process(0, std::move(batch));
+      }
+      return;
+    }
+
+    // the nullptr that stops the worker only reaches one session and it can't
+    // be put back for the others as another worker may take it instead.
+    // Instead, the other sessions see the flag the next time they wake up
+    constexpr int64_t kStopPollUs = 100'000;
+    std::atomic_bool stop = false;
+    std::vector<std::thread> threads;
+    threads.reserve(sessions);
+    for (auto i = 0U; i < sessions; ++i) {
+      threads.emplace_back([&, i]() {
+        util::setThreadAffinity(session_cpus_[i]);
+        while (!stop) {
+          BatchPtr batch;
+          if (!input_queue->wait_dequeue_timed(batch, kStopPollUs)) {
+            continue;
+          }
+          if (batch == nullptr) {
+            stop = true;
+            break;
+          }
+          process(i, std::move(batch));
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+  /**
+   * @brief Get the input tensors of one synthetic request used to warm up the
+   * worker. By default, these are the inputs in the worker's metadata without
+   * the leading batch dimension that many workers include there. Workers whose
+   * metadata doesn't describe their inputs can override this.
+   *
+   * @return std::vector<Tensor> the inputs or empty to skip warming up
+   */
+  [[nodiscard]] virtual std::vector<Tensor> getWarmupInputs() const {
+    auto inputs = this->metadata_.getInputs();
+    for (auto& input : inputs) {
+      auto shape = input.getShape();
+      if (shape.size() > 1 && shape[0] == this->batch_size_) {
+        shape.erase(shape.begin());
+        input.setShape(std::move(shape));
+      }
+    }
+    return inputs;
+  }
+
+  /**
+   * @brief Get the buffers that the worker uses at the same time when it's
+   * busy, which are allocated when it's loaded. By default, these are the
+   * batchers' buffers for the warm-up inputs at each of the worker's batch
+   * sizes: one batch that's run while the next one is filled.
+   *
+   * @return std::vector<BufferDemand>
+   */
+  [[nodiscard]] virtual std::vector<BufferDemand> getBufferDemands() const {
+    const auto allocators = this->getAllocators();
+    const auto inputs = this->getWarmupInputs();
+    std::vector<BufferDemand> demands;
+    for (auto batch_size : this->getBatchSizes()) {
+      for (const auto& input : inputs) {
+        demands.push_back({input, batch_size, 2, allocators});
+      }
     }
+    return demands;
   }
 
   size_t batch_size_ = 1;
+  /// CPUs the worker's run thread is pinned to, if any
+  std::vector<int> cpus_;
+  /// CPUs of each of the worker's sessions, split from cpus_
+  std::vector<std::vector<int>> session_cpus_;
   ModelMetadata metadata_;
   MemoryPool* pool_;
+  /// the endpoint that the worker serves
+  std::string endpoint_;
 
  private:
   /// Perform low-cost initialization of the worker
@@ -167,11 +645,64 @@ class Worker {
   /// Perform any final operations before the worker's run thread is joined
   virtual void doDestroy() = 0;
 
+  /**
+   * @brief Make a batch of requests filled with zeros laid out like the
+   * batches that the batchers make: each input's data for the whole batch is
+   * contiguous in one buffer.
+   *
+   * @param inputs the input tensors of each request
+   * @param batch_size number of requests in the batch
+   * @return BatchPtr
+   */
+  BatchPtr makeWarmupBatch(const std::vector<Tensor>& inputs,
+                           size_t batch_size) {
+    auto batch = std::make_unique<Batch>();
+
+    std::vector<BufferPtr> buffers;
+    std::vector<size_t> sizes;
+    buffers.reserve(inputs.size());
+    sizes.reserve(inputs.size());
+    for (const auto& input : inputs) {
+      auto buffer = pool_->get(this->getAllocators(), input, batch_size);
+      const auto size = input.getSize() * input.getDatatype().size();
+      const std::vector<std::byte> zeros(size * batch_size);
+      buffer->write(zeros.data(), 0, zeros.size());
+      buffers.push_back(std::move(buffer));
+      sizes.push_back(size);
+    }
+
+    for (size_t i = 0; i < batch_size; ++i) {
+      auto request = std::make_shared<InferenceRequest>();
+      request->setID("warmup");
+      // the responses are discarded
+      request->setCallback([](const InferenceResponse&) {});
+      for (size_t j = 0; j < inputs.size(); ++j) {
+        const auto& input = inputs[j];
+        request->addInputTensor(buffers[j]->data(i * sizes[j]),
+                                input.getShape(), input.getDatatype(),
+                                input.getName());
+      }
+      batch->addRequest(std::move(request));
+#ifdef AMDINFER_ENABLE_TRACING
+      batch->addTrace(startTrace("warmup"));
+#endif
+#ifdef AMDINFER_ENABLE_METRICS
+      batch->addTime(util::getTime());
+#endif
+    }
+    batch->setBuffers(std::move(buffers), {});
+    return batch;
+  }
+
 #ifdef AMDINFER_ENABLE_LOGGING
   Logger logger_{Loggers::Server};
 #endif
 
-  WorkerStatus status_;
+  /// read by the server's threads, e.g. to report the state of the endpoint
+  std::atomic<WorkerStatus> status_;
+  /// shares the worker's device with other endpoints, if it's set
+  std::shared_ptr<DeviceScheduler> scheduler_;
+  std::function<void()> stop_callback_;
 };
 
 }  // namespace workers
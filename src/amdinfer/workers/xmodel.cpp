@@ -21,23 +21,27 @@
 #include <cxxabi.h>  // for __forced_unwind
 
 #include <algorithm>                    // for copy, copy_backward
-#include <atomic>                       // for atomic_int32_t
+#include <cmath>                        // for exp2
 #include <cstddef>                      // for size_t, byte
 #include <cstdint>                      // for uint64_t, uint32_t
 #include <cstdlib>                      // for getenv
 #include <cstring>                      // for memcpy
+#include <exception>                    // for exception
 #include <ext/alloc_traits.h>           // for __alloc_traits<>::...
-#include <memory>                       // for unique_ptr, allocator
-#include <queue>                        // for queue
+#include <limits>                       // for numeric_limits
+#include <map>                          // for map
+#include <memory>                       // for unique_ptr, shared_ptr
 #include <ratio>                        // for micro
 #include <string>                       // for string, operator!=
-#include <thread>                       // for thread, sleep_for
+#include <thread>                       // for thread
+#include <unordered_map>                // for unordered_map
 #include <utility>                      // for pair, move
 #include <vart/runner.hpp>              // for Runner
 #include <vart/runner_ext.hpp>          // for RunnerExt
 #include <vart/tensor_buffer.hpp>       // for TensorBuffer
 #include <vector>                       // for vector
 #include <vitis/ai/target_factory.hpp>  // for target_factory
+#include <xir/attrs/attrs.hpp>          // for Attrs
 #include <xir/graph/graph.hpp>          // for Graph
 #include <xir/graph/subgraph.hpp>       // for Subgraph
 #include <xir/tensor/tensor.hpp>        // for Tensor
@@ -45,29 +49,121 @@
 #include "amdinfer/batching/batcher.hpp"          // for BatchPtr, Batch
 #include "amdinfer/buffers/buffer.hpp"            // for Buffer
 #include "amdinfer/buffers/vart_tensor.hpp"       // for VartTensorBuffer
+#include "amdinfer/buffers/xrt_bo.hpp"            // for XrtBoBuffer
 #include "amdinfer/build_options.hpp"             // for AMDINFER_ENABLE_ME...
 #include "amdinfer/core/data_types.hpp"           // for DataType
 #include "amdinfer/core/data_types_internal.hpp"  // for mapXirToType
+#include "amdinfer/core/device_scheduler.hpp"     // for DeviceScheduler
 #include "amdinfer/core/exceptions.hpp"           // for invalid_argument
 #include "amdinfer/core/inference_request.hpp"    // for InferenceRequest
 #include "amdinfer/core/inference_response.hpp"   // for InferenceResponse
+#include "amdinfer/core/model_artifacts.hpp"      // for getModelArtifact
 #include "amdinfer/core/parameters.hpp"           // for ParameterMap
+#include "amdinfer/core/requested_outputs.hpp"    // for selectOutputs
 #include "amdinfer/declarations.hpp"              // for BufferPtrs, Infere...
 #include "amdinfer/observation/observer.hpp"      // for Loggers, Metrics...
 #include "amdinfer/util/containers.hpp"           // for containerProduct
-#include "amdinfer/util/ctpl.hpp"                 // for ThreadPool
+#include "amdinfer/util/job_window.hpp"           // for JobWindow
 #include "amdinfer/util/parse_env.hpp"            // for autoExpandEnvironm...
 #include "amdinfer/util/queue.hpp"                // for BufferPtrsQueue
 #include "amdinfer/util/thread.hpp"               // for setThreadName
 #include "amdinfer/util/timer.hpp"                // for Timer
+#include "amdinfer/util/work_stealing_pool.hpp"   // for WorkStealingPool
 #include "amdinfer/workers/worker.hpp"            // for Worker, kNumBuffer...
 
+#ifdef AMDINFER_ENABLE_XRT
+#include <experimental/xrt_system.h>  // for enumerate_devices
+#endif
+
 namespace amdinfer::workers {
 
+/// A batch that's been submitted to the runners
+struct XModelJob {
+  BatchPtr batch;
+  BufferPtrs input_buffers;
+  /// the pool buffers for the outputs of all the stages
+  BufferPtrs output_buffers;
+  /// the outputs of the stage that ran most recently
+  std::vector<vart::TensorBuffer*> outputs_ptr;
+  /// the outputs of the stages that have run, by tensor name
+  std::unordered_map<std::string, vart::TensorBuffer*> tensors;
+  uint32_t id = 0;
+  /// the endpoint's turn on the DPU, held until all the stages are done
+  DeviceScheduler::Turn turn;
+};
+using XModelJobQueue = BlockingQueue<std::unique_ptr<XModelJob>>;
+
+/// A DPU or CPU subgraph of the XModel and the runner that runs it
+struct XModelStage {
+  const xir::Subgraph* subgraph = nullptr;
+  std::unique_ptr<vart::Runner> runner;
+};
+
+/**
+ * @brief Get the FPGA card that an instance of the worker runs its DPU
+ * subgraphs on. The "device" parameter picks one and the instances are spread
+ * over the cards otherwise
+ *
+ * @param parameters the worker's load-time parameters
+ * @return size_t
+ */
+size_t getInstanceCard(const ParameterMap* parameters) {
+  size_t cards = 1;
+#ifdef AMDINFER_ENABLE_XRT
+  cards = std::max<size_t>(xrt::system::enumerate_devices(), 1);
+#endif
+  if (parameters->has("cards")) {
+    const auto count = parameters->get<int32_t>("cards");
+    if (count <= 0) {
+      throw invalid_argument("The number of cards must be positive");
+    }
+    cards = count;
+  }
+  if (parameters->has("device")) {
+    const auto device = parameters->get<int32_t>("device");
+    if (device < 0 || static_cast<size_t>(device) >= cards) {
+      throw invalid_argument("FPGA " + std::to_string(device) +
+                             " does not exist");
+    }
+    return device;
+  }
+  int32_t instance = 0;
+  if (parameters->has("instance")) {
+    instance = parameters->get<int32_t>("instance");
+  }
+  return instance % cards;
+}
+
+/**
+ * @brief Create the runner of a subgraph. DPU subgraphs run on the given card
+ * and, if it's not negative, on the given CU of the card
+ *
+ * @param subgraph the subgraph to run
+ * @param card the FPGA card for DPU subgraphs
+ * @param core the CU for DPU subgraphs or -1 to let the runtime pick
+ * @return std::unique_ptr<vart::Runner>
+ */
+std::unique_ptr<vart::Runner> createRunner(const xir::Subgraph* subgraph,
+                                           size_t card, int32_t core) {
+  if (subgraph->get_attr<std::string>("device") == "DPU") {
+    auto attrs = xir::Attrs::create();
+    attrs->set_attr<size_t>("__device_id__", card);
+    if (core >= 0) {
+      attrs->set_attr<size_t>("__device_core_id__", core);
+    }
+    return vart::Runner::create_runner_with_attrs(subgraph, attrs.get());
+  }
+  // CPU subgraphs are run by VART's CPU runner on the host
+  auto attrs = xir::Attrs::create();
+  attrs->set_attr<std::map<std::string, std::string>>(
+    "lib", {{"CPU", "libvart-cpu-runner.so"}});
+  return vart::Runner::create_runner_with_attrs(subgraph, attrs.get());
+}
+
 /**
  * @brief The XModel worker accepts a path to an XModel from the user and runs
- * the DPU subgraph associated with the XModel. The incoming requests are sent
- * to the FPGA using the Vitis AI runtime libraries.
+ * the DPU and CPU subgraphs of the XModel in order. The incoming requests are
+ * sent to the FPGA using the Vitis AI runtime libraries.
  *
  */
 class XModel : public Worker {
@@ -75,6 +171,10 @@ class XModel : public Worker {
   XModel() : Worker("XModel", "XModel") {}
   std::thread spawn(BatchPtrQueue* input_queue) override;
   [[nodiscard]] std::vector<MemoryAllocators> getAllocators() const override;
+  [[nodiscard]] std::vector<InputCast> getInputCasts() const override;
+
+ protected:
+  [[nodiscard]] std::vector<BufferDemand> getBufferDemands() const override;
 
  private:
   void doInit(ParameterMap* parameters) override;
@@ -83,27 +183,97 @@ class XModel : public Worker {
   void doRelease() override;
   void doDestroy() override;
 
-  vart::RunnerExt* getRunner();
-
-  std::unique_ptr<xir::Graph> graph_;
-  const xir::Subgraph* subgraph_ = nullptr;
+  vart::RunnerExt* getRunner(size_t stage);
+  /// Check if a stage runs on the DPU rather than the host
+  [[nodiscard]] bool onDpu(size_t stage) const;
+  /// Prepare the buffers for a batch and submit it to the first stage
+  std::unique_ptr<XModelJob> submit(BatchPtr batch);
+  /// Submit a job to a stage using the outputs of the earlier stages
+  void execute(size_t stage, XModelJob* job);
+  /// Respond to the requests in a job once the last stage has finished it
+  void respond(XModelJob* job);
+  /// Respond to the requests in a job that a stage couldn't run with an error
+  void fail(XModelJob* job, const std::string& error);
+
+  /// the XModel, which the endpoints that load the same file share. Their
+  /// runners are their own
+  std::shared_ptr<xir::Graph> graph_;
+  /// the DPU and CPU subgraphs in topological order
+  std::vector<const xir::Subgraph*> subgraphs_;
   std::string kernel_;
-  std::unique_ptr<vart::Runner> runner_;
+  /// the FPGA card that the DPU subgraphs run on
+  size_t card_ = 0;
+  /// the name of the DPU in the device metrics
+  std::string device_;
+  std::vector<XModelStage> stages_;
   std::vector<DataType> output_type_;
   std::vector<uint32_t> output_size_;
-  util::ThreadPool thread_pool_;
+  std::vector<std::string> output_names_;
+  /// Most jobs that may be submitted to the first runner at once
+  size_t max_in_flight_ = 2;
+  /// responds to the finished jobs
+  util::WorkStealingPool thread_pool_;
 };
 
 std::thread XModel::spawn(BatchPtrQueue* input_queue) {
   return std::thread(&XModel::run, this, input_queue);
 }
 
+// batches for the DPU are written into its memory if the server has XRT and
+// into host tensors that the runner copies otherwise
 std::vector<MemoryAllocators> XModel::getAllocators() const {
+  // the pool's XRT buffers are on the first card
+  if (!this->stages_.empty() && this->onDpu(0) && this->card_ == 0) {
+    return {MemoryAllocators::XrtBo, MemoryAllocators::VartTensor};
+  }
   return {MemoryAllocators::VartTensor};
 }
 
-vart::RunnerExt* XModel::getRunner() {
-  return dynamic_cast<vart::RunnerExt*>(this->runner_.get());
+// creating the VART tensors for the outputs of each stage is slow so they're
+// made for each job that may be in flight at load
+std::vector<BufferDemand> XModel::getBufferDemands() const {
+  auto demands = Worker::getBufferDemands();
+  for (auto& demand : demands) {
+    demand.count = this->max_in_flight_ + 1;
+  }
+  for (auto i = 0U; i < this->stages_.size(); ++i) {
+    std::vector<MemoryAllocators> allocators{MemoryAllocators::VartTensor};
+    if (i + 1 == this->stages_.size() && this->onDpu(i) && this->card_ == 0) {
+      allocators.insert(allocators.begin(), MemoryAllocators::XrtBo);
+    }
+    for (const auto* tensor : this->stages_[i].runner->get_output_tensors()) {
+      const auto& xir_shape = tensor->get_shape();
+      Tensor output{tensor->get_name(),
+                    {xir_shape.begin(), xir_shape.end()},
+                    mapXirToType(tensor->get_data_type())};
+      demands.push_back({output, 1, this->max_in_flight_, allocators});
+    }
+  }
+  return demands;
+}
+
+// float inputs are quantized to the DPU's fixed-point inputs as they're batched
+std::vector<InputCast> XModel::getInputCasts() const {
+  std::vector<InputCast> casts;
+  const auto& runner = this->stages_.front().runner;
+  for (const auto* tensor : runner->get_input_tensors()) {
+    const auto type = mapXirToType(tensor->get_data_type());
+    if (type == DataType::Int8 && tensor->has_attr("fix_point")) {
+      const auto fix_point = tensor->get_attr<int>("fix_point");
+      casts.push_back({tensor->get_name(), type,
+                       static_cast<float>(std::exp2(fix_point)), 0.0F});
+    }
+  }
+  return casts;
+}
+
+vart::RunnerExt* XModel::getRunner(size_t stage) {
+  return dynamic_cast<vart::RunnerExt*>(this->stages_[stage].runner.get());
+}
+
+bool XModel::onDpu(size_t stage) const {
+  return this->stages_[stage].subgraph->get_attr<std::string>("device") ==
+         "DPU";
 }
 
 void XModel::doInit(ParameterMap* parameters) {
@@ -120,31 +290,36 @@ void XModel::doInit(ParameterMap* parameters) {
     path = parameters->get<std::string>("model");
   }
   util::autoExpandEnvironmentVariables(path);
-  graph_ = xir::Graph::deserialize(path);
+  graph_ = getModelArtifact<xir::Graph>(
+    getModelArtifactKey(path, "xmodel"),
+    [&path]() { return xir::Graph::deserialize(path); });
 
   auto subgraphs = graph_->get_root_subgraph()->children_topological_sort();
-  std::vector<const xir::Subgraph*> dpu_graphs;
+  const xir::Subgraph* dpu_graph = nullptr;
   for (const auto* c : subgraphs) {
     // CHECK(c->has_attr("device"));
     auto device = c->get_attr<std::string>("device");
-    if (device == "DPU") {
-      dpu_graphs.emplace_back(c);
+    // the USER subgraphs hold the graph's inputs, which come from the requests
+    if (device == "DPU" || device == "CPU") {
+      subgraphs_.emplace_back(c);
+    }
+    if (device == "DPU" && dpu_graph == nullptr) {
+      dpu_graph = c;
     }
   }
-  // TODO(varunsh): we want to eventually support arbitrary numbers of dpu
-  // graphs but may need model chaining for that
-  if (dpu_graphs.size() > 1) {
-    throw invalid_argument("Unsupported XModel with more than 1 DPU subgraph");
+  if (dpu_graph == nullptr) {
+    throw invalid_argument("Unsupported XModel with no DPU subgraph");
   }
 
-  this->subgraph_ = dpu_graphs[0];
-  if (this->subgraph_->has_attr("dpu_fingerprint")) {
+  if (dpu_graph->has_attr("dpu_fingerprint")) {
     const auto fingerprint =
-      this->subgraph_->get_attr<std::uint64_t>("dpu_fingerprint");
+      dpu_graph->get_attr<std::uint64_t>("dpu_fingerprint");
     this->kernel_ = vitis::ai::target_factory()->create(fingerprint).type();
   } else {
-    this->kernel_ = this->subgraph_->get_attr<std::string>("kernel");
+    this->kernel_ = dpu_graph->get_attr<std::string>("kernel");
   }
+  this->card_ = getInstanceCard(parameters);
+  this->device_ = "dpu" + std::to_string(this->card_) + ":" + this->kernel_;
 }
 
 void XModel::doAcquire(ParameterMap* parameters) {
@@ -154,20 +329,68 @@ void XModel::doAcquire(ParameterMap* parameters) {
   if (parameters->has("threads")) {
     threads = parameters->get<int32_t>("threads");
   }
-  this->thread_pool_.resize(threads);
+  if (threads <= 0) {
+    throw invalid_argument("The number of threads must be positive");
+  }
+  // each CU runs one job while the next one is queued behind it so the CU
+  // doesn't idle between jobs
+  int32_t cus = 1;
+  if (parameters->has("cus")) {
+    cus = parameters->get<int32_t>("cus");
+  }
+  if (cus <= 0) {
+    throw invalid_argument("The number of CUs must be positive");
+  }
+  this->max_in_flight_ = 2 * static_cast<size_t>(cus);
+  this->thread_pool_.resize(static_cast<size_t>(threads));
+  this->thread_pool_.setAffinity(this->cpus_);
+  int32_t core = -1;
+  if (parameters->has("device_core")) {
+    core = parameters->get<int32_t>("device_core");
+    if (core < 0) {
+      throw invalid_argument("The device core can't be negative");
+    }
+  }
 
-  runner_ = vart::Runner::create_runner(this->subgraph_, "run");
-  auto input_tensors = runner_->get_input_tensors();
+  // each stage after the first reads its inputs from the outputs of the
+  // earlier stages so check that they exist and match before running anything
+  std::unordered_map<std::string, std::vector<int>> produced;
+  for (const auto* subgraph : subgraphs_) {
+    auto runner = createRunner(subgraph, this->card_, core);
+    if (!stages_.empty()) {
+      for (const auto* tensor : runner->get_input_tensors()) {
+        const auto& name = tensor->get_name();
+        auto found = produced.find(name);
+        if (found == produced.end()) {
+          throw invalid_argument("Input " + name + " of subgraph " +
+                                 subgraph->get_name() +
+                                 " is not made by an earlier subgraph");
+        }
+        if (found->second != tensor->get_shape()) {
+          throw invalid_argument("Input " + name + " of subgraph " +
+                                 subgraph->get_name() +
+                                 " has a different shape than its producer");
+        }
+      }
+    }
+    for (const auto* tensor : runner->get_output_tensors()) {
+      produced[tensor->get_name()] = tensor->get_shape();
+    }
+    stages_.push_back({subgraph, std::move(runner)});
+  }
+
+  auto input_tensors = stages_.front().runner->get_input_tensors();
   // assuming only one tensor as in doInit()
   auto input_shape = input_tensors[0]->get_shape();
   auto input_type = mapXirToType(input_tensors[0]->get_data_type());
   this->batch_size_ = input_shape[0];
   this->metadata_.addInputTensor("input", input_shape, input_type);
 
-  auto output_tensors = runner_->get_output_tensors();
+  auto output_tensors = stages_.back().runner->get_output_tensors();
   for (const auto* tensor : output_tensors) {
     auto output_shape = tensor->get_shape();
     output_type_.emplace_back(mapXirToType(tensor->get_data_type()));
+    output_names_.emplace_back(tensor->get_name());
     // +1 to skip the batch size
     output_size_.emplace_back(
       util::containerProduct(output_shape.begin() + 1, output_shape.end()));
@@ -175,18 +398,106 @@ void XModel::doAcquire(ParameterMap* parameters) {
     this->metadata_.addOutputTensor("output", output_shape,
                                     output_type_.back());
   }
+
+  this->shareDevice(this->device_, parameters);
 }
 
 void XModel::doRun(BatchPtrQueue* input_queue) {
-  std::atomic_int32_t thread_pool_size = 0;
-  const int max_thread_pool_size =
-    this->thread_pool_.getSize() * 4;  // 4 is arbitrary
   util::setThreadName("XModel");
 #ifdef AMDINFER_ENABLE_LOGGING
   const auto& logger = this->getLogger();
 #endif
 
-  const auto thread_pool_delay = std::chrono::milliseconds(10);
+  // each stage has a thread that takes jobs from its queue, waits for the
+  // stage to finish them and passes them on to the next stage. Jobs on the
+  // first runner are bounded by the CUs. Later stages take at most two jobs
+  // at once so one can be handed over while the other runs. Once the last
+  // stage is done, the responses are made in the thread pool
+  constexpr size_t kStageBuffers = 2;
+  const auto num_stages = stages_.size();
+  std::vector<std::unique_ptr<XModelJobQueue>> queues;
+  std::vector<std::unique_ptr<util::JobWindow>> windows;
+  for (size_t k = 0; k < num_stages; k++) {
+    queues.push_back(std::make_unique<XModelJobQueue>());
+    windows.push_back(std::make_unique<util::JobWindow>(
+      k == 0 ? max_in_flight_ : kStageBuffers));
+  }
+  util::JobWindow pending{std::numeric_limits<size_t>::max()};
+
+  auto forward = [this, num_stages, &queues, &windows, &pending](
+                   size_t stage, std::unique_ptr<XModelJob> job) {
+    if (stage < num_stages) {
+      windows[stage]->acquire();
+      queues[stage]->enqueue(std::move(job));
+      return;
+    }
+    job->turn.release();
+    this->thread_pool_.submit(
+      [this, job = std::shared_ptr<XModelJob>{std::move(job)}, &pending]() {
+        this->respond(job.get());
+        pending.release();
+      });
+  };
+
+  std::vector<std::thread> stage_threads;
+  for (size_t k = 0; k < num_stages; k++) {
+    stage_threads.emplace_back([this, k, num_stages, &queues, &windows,
+                                &pending, &forward]() {
+      util::setThreadName(k == 0 ? "XModelWait" : "XModelStage");
+      while (true) {
+        std::unique_ptr<XModelJob> job;
+        queues[k]->wait_dequeue(job);
+        if (job == nullptr) {
+          if (k + 1 < num_stages) {
+            queues[k + 1]->enqueue(nullptr);
+          }
+          break;
+        }
+        // a job that a stage can't run ends there and frees its slot so the
+        // stages keep going
+        bool released = false;
+        try {
+          // jobs for the first stage are submitted as they arrive
+          if (k > 0) {
+            this->execute(k, job.get());
+          }
+          this->getRunner(k)->wait(static_cast<int>(job->id), -1);
+#ifdef AMDINFER_ENABLE_METRICS
+          if (this->onDpu(k)) {
+            Metrics::getInstance().finishDeviceJob(this->device_);
+          }
+#endif
+          windows[k]->release();
+          released = true;
+          if (k + 1 < num_stages) {
+            for (auto* output : job->outputs_ptr) {
+              const auto* tensor = output->get_tensor();
+              const auto bytes =
+                tensor->get_data_size() / (tensor->get_shape())[0];
+              const auto used =
+                static_cast<size_t>(bytes) * job->batch->size();
+              output->sync_for_read(0, used);
+#ifdef AMDINFER_ENABLE_METRICS
+              if (this->onDpu(k)) {
+                Metrics::getInstance().addDeviceTransfer(
+                  this->device_, DeviceTransfer::DeviceToHost, used);
+              }
+#endif
+            }
+          }
+        } catch (const std::exception& e) {
+          AMDINFER_LOG_ERROR(this->getLogger(), e.what());
+          if (!released) {
+            windows[k]->release();
+          }
+          this->fail(job.get(), e.what());
+          pending.release();
+          continue;
+        }
+        forward(k + 1, std::move(job));
+      }
+    });
+  }
 
   while (true) {
     BatchPtr batch;
@@ -200,167 +511,239 @@ void XModel::doRun(BatchPtrQueue* input_queue) {
     Metrics::getInstance().incrementCounter(
       MetricCounterIDs::PipelineIngressWorker);
 #endif
-    thread_pool_size++;
-    if (thread_pool_size > max_thread_pool_size) {
-      std::this_thread::sleep_for(thread_pool_delay);
+    windows[0]->acquire();
+    pending.acquire();
+    // the first stage starts as the job is submitted
+    auto turn = this->waitForDevice();
+    auto job = this->submit(std::move(batch));
+    if (job == nullptr) {
+      windows[0]->release();
+      pending.release();
+      continue;
     }
-    this->thread_pool_.push(
-      [this, batch = std::move(batch), &thread_pool_size](int id) {
-        (void)id;  // suppress unused variable warning
+    job->turn = std::move(turn);
+    queues[0]->enqueue(std::move(job));
+  }
+
+  // finish the jobs in progress before ending
+  queues[0]->enqueue(nullptr);
+  for (auto& thread : stage_threads) {
+    thread.join();
+  }
+  pending.drain();
+  AMDINFER_LOG_INFO(logger, "XModel ending");
+}
+
+std::unique_ptr<XModelJob> XModel::submit(BatchPtr batch) {
 #ifdef AMDINFER_ENABLE_TRACING
-        for (unsigned int j = 0; j < batch->size(); j++) {
-          auto& trace = batch->getTrace(j);
-          trace->startSpan("xmodel");
-        }
+  batch->startSpan("xmodel");
 #endif
 
-        auto input_buffers = batch->getInputBuffers();
-      // const auto& output_buffers = batch->getOutputBuffers();
+  auto job = std::make_unique<XModelJob>();
+  job->input_buffers = batch->getInputBuffers();
+  job->batch = std::move(batch);
 
 #ifdef AMDINFER_ENABLE_LOGGING
-        for (const auto& buffer : input_buffers) {
-          logTraceBuffer(getLogger(), buffer->data(0));
-        }
+  for (const auto& buffer : job->input_buffers) {
+    logTraceBuffer(getLogger(), buffer->data(0));
+  }
 #endif  // AMDINFER_ENABLE_LOGGING
 
-        std::vector<vart::TensorBuffer*> inputs_ptr;
-        for (const auto& buffer : input_buffers) {
-          auto* vart = dynamic_cast<VartTensorBuffer*>(buffer.get());
-          inputs_ptr.emplace_back(vart->getTensorBuffer());
-        }
-
-        BufferPtrs output_buffers;
-        auto output_tensors = this->getRunner()->get_output_tensors();
-        for (const auto* tensor : output_tensors) {
-          auto xir_shape = tensor->get_shape();
-          std::vector<size_t> shape{xir_shape.begin(), xir_shape.end()};
-          auto xir_type = tensor->get_data_type();
-          auto type = mapXirToType(xir_type);
-          InferenceRequestInput input(nullptr, shape, type, tensor->get_name());
-          // the shape includes the batch size so use external batch size 1
-          output_buffers.push_back(
-            pool_->get({MemoryAllocators::VartTensor}, input, 1));
-        }
-
-        std::vector<vart::TensorBuffer*> outputs_ptr;
-        for (const auto& buffer : output_buffers) {
-          auto* vart = dynamic_cast<VartTensorBuffer*>(buffer.get());
-          outputs_ptr.emplace_back(vart->getTensorBuffer());
-        }
-
-        // auto outputs_ptr = this->getRunner()->get_outputs();
-
-        for (auto* input : inputs_ptr) {
-          const auto* tensor = input->get_tensor();
-          auto num = tensor->get_element_num();
-          auto batches = (tensor->get_shape())[0];
-          input->sync_for_write(0, num / batches);
-        }
-
-        std::queue<std::pair<uint32_t, int>> futures;
-        futures.push(getRunner()->execute_async(inputs_ptr, outputs_ptr));
-
-        std::vector<InferenceResponse> responses;
-        responses.reserve(batch->size());
-
-        for (const auto& req : *batch) {
-          auto& resp = responses.emplace_back();
-          resp.setID(req->getID());
-          resp.setModel("xmodel");
-        }
-
-        while (!futures.empty()) {
-          auto job_id = futures.front();
-          futures.pop();
-          getRunner()->wait(job_id.first, -1);
-        }
+  try {
+    this->execute(0, job.get());
+  } catch (const std::exception& e) {
+    AMDINFER_LOG_ERROR(this->getLogger(), e.what());
+    this->fail(job.get(), e.what());
+    return nullptr;
+  }
+  return job;
+}
 
-        for (auto* output : outputs_ptr) {
-          const auto* tensor = output->get_tensor();
-          output->sync_for_read(
-            0, tensor->get_element_num() / (tensor->get_shape())[0]);
-        }
+void XModel::execute(size_t stage, XModelJob* job) {
+  auto* runner = this->getRunner(stage);
 
-        const auto num_batches = batch->size();
-        for (unsigned int k = 0; k < num_batches; k++) {
-          const auto& req = batch->getRequest(k);
-          auto inputs = req->getInputs();
-          auto outputs = req->getOutputs();
-          auto& resp = responses[k];
-
-          const auto num_outputs = outputs_ptr.size();
-          for (unsigned int i = 0; i < num_outputs; i++) {
-            // auto* output_index = output_buffers[i]->data(0);
-            auto* output_index =
-              reinterpret_cast<void*>(outputs_ptr.at(i)->data().first);
-            InferenceResponseOutput output;
-            auto output_tensors = getRunner()->get_output_tensors();
-            auto output_shape = output_tensors[i]->get_shape();
-            std::vector<uint64_t> new_shape;
-            new_shape.reserve(output_shape.size() - 1);
-            for (size_t j = 0; j < output_shape.size() - 1; j++) {
-              new_shape.push_back(output_shape[j + 1]);
-            }
-            output.setShape(new_shape);
+  std::vector<vart::TensorBuffer*> inputs_ptr;
+  if (stage == 0) {
+    for (const auto& buffer : job->input_buffers) {
+      auto* vart = dynamic_cast<VartTensorBuffer*>(buffer.get());
+      inputs_ptr.emplace_back(vart->getTensorBuffer());
+    }
+  } else {
+    // the inputs were checked to exist in doAcquire()
+    for (const auto* tensor : runner->get_input_tensors()) {
+      inputs_ptr.emplace_back(job->tensors.at(tensor->get_name()));
+    }
+  }
 
-            output.setDatatype(this->output_type_[i]);
+  job->outputs_ptr.clear();
+  auto output_tensors = runner->get_output_tensors();
+  for (const auto* tensor : output_tensors) {
+    auto xir_shape = tensor->get_shape();
+    std::vector<size_t> shape{xir_shape.begin(), xir_shape.end()};
+    auto xir_type = tensor->get_data_type();
+    auto type = mapXirToType(xir_type);
+    InferenceRequestInput input(nullptr, shape, type, tensor->get_name());
+    // the outputs of the last stage are left in the DPU's memory until the
+    // responses sync them. Intermediate outputs are on the host for the CPU
+    // subgraphs
+    std::vector<MemoryAllocators> allocators{MemoryAllocators::VartTensor};
+    if (stage + 1 == stages_.size() && this->onDpu(stage) &&
+        this->card_ == 0) {
+      allocators.insert(allocators.begin(), MemoryAllocators::XrtBo);
+    }
+    // the shape includes the batch size so use external batch size 1
+    auto buffer = pool_->get(allocators, input, 1);
+    auto* vart = dynamic_cast<VartTensorBuffer*>(buffer.get());
+    job->outputs_ptr.emplace_back(vart->getTensorBuffer());
+    job->tensors[tensor->get_name()] = job->outputs_ptr.back();
+    job->output_buffers.push_back(std::move(buffer));
+  }
 
-            std::vector<std::byte> buffer;
-            buffer.resize(this->output_size_[i] * sizeof(uint8_t));
-            memcpy(buffer.data(),
-                   reinterpret_cast<int8_t*>(output_index) +
-                     (i * this->output_size_[i]),
-                   this->output_size_[i] * sizeof(uint8_t));
-            output.setData(std::move(buffer));
+  // only the requests in the batch are synced, not the whole tensor
+  const auto requests = job->batch->size();
+  for (auto i = 0U; i < inputs_ptr.size(); ++i) {
+    auto* input = inputs_ptr[i];
+    const auto* tensor = input->get_tensor();
+    const auto bytes = tensor->get_data_size() / (tensor->get_shape())[0];
+    const auto used = static_cast<size_t>(bytes) * requests;
+    auto* bo = stage == 0
+                 ? dynamic_cast<XrtBoBuffer*>(job->input_buffers[i].get())
+                 : nullptr;
+    if (bo != nullptr) {
+      bo->syncToDevice(used);
+    } else {
+      input->sync_for_write(0, used);
+    }
+#ifdef AMDINFER_ENABLE_METRICS
+    if (this->onDpu(stage)) {
+      Metrics::getInstance().addDeviceTransfer(
+        this->device_, DeviceTransfer::HostToDevice, used);
+    }
+#endif
+  }
 
-            std::string output_name;
-            if (i < outputs.size()) {
-              output_name = outputs[i].getName();
-            }
+  job->id = runner->execute_async(inputs_ptr, job->outputs_ptr).first;
+#ifdef AMDINFER_ENABLE_METRICS
+  // the job is finished once the stage's thread has waited for it
+  if (this->onDpu(stage)) {
+    Metrics::getInstance().startDeviceJob(this->device_);
+  }
+#endif
+}
 
-            if (output_name.empty()) {
-              output.setName(inputs[0].getName());
-            } else {
-              output.setName(output_name);
-            }
+void XModel::respond(XModelJob* job) {
+  const auto& batch = job->batch;
+  const auto& outputs_ptr = job->outputs_ptr;
+
+  // the last stage's buffers are the last ones allocated, in order
+  const auto first_output = job->output_buffers.size() - outputs_ptr.size();
+  for (auto i = 0U; i < outputs_ptr.size(); ++i) {
+    auto* output = outputs_ptr[i];
+    const auto* tensor = output->get_tensor();
+    const auto bytes = tensor->get_data_size() / (tensor->get_shape())[0];
+    const auto used = static_cast<size_t>(bytes) * batch->size();
+    auto* bo = dynamic_cast<XrtBoBuffer*>(
+      job->output_buffers[first_output + i].get());
+    if (bo != nullptr) {
+      bo->syncFromDevice(used);
+    } else {
+      output->sync_for_read(0, used);
+    }
+#ifdef AMDINFER_ENABLE_METRICS
+    if (this->onDpu(stages_.size() - 1)) {
+      Metrics::getInstance().addDeviceTransfer(
+        this->device_, DeviceTransfer::DeviceToHost, used);
+    }
+#endif
+  }
 
-            resp.addOutput(output);
-          }
+  const auto num_batches = batch->size();
+  for (unsigned int k = 0; k < num_batches; k++) {
+    const auto& req = batch->getRequest(k);
+    const auto& inputs = req->getInputs();
+    InferenceResponse resp;
+    resp.setID(req->getID());
+    resp.setModel("xmodel");
+
+    // unrequested outputs aren't copied out of the batch
+    const auto selected = selectOutputs(
+      *req, output_names_, outputs_ptr.size(), inputs[0].getName());
+    for (const auto& [i, name] : selected) {
+      // the data is read from the pool's buffer since the tensor buffers of
+      // buffer objects point at the device
+      auto* output_index = job->output_buffers.at(first_output + i)->data(0);
+      InferenceResponseOutput output;
+      auto output_tensors =
+        getRunner(stages_.size() - 1)->get_output_tensors();
+      auto output_shape = output_tensors[i]->get_shape();
+      std::vector<uint64_t> new_shape;
+      new_shape.reserve(output_shape.size() - 1);
+      for (size_t j = 0; j < output_shape.size() - 1; j++) {
+        new_shape.push_back(output_shape[j + 1]);
+      }
+      output.setShape(new_shape);
+
+      output.setDatatype(this->output_type_[i]);
+
+      // each request's output is the kth slice of the batch's output. CPU
+      // subgraphs may make outputs that are wider than the DPU's int8
+      const auto bytes = this->output_size_[i] * this->output_type_[i].size();
+      std::vector<std::byte> buffer;
+      buffer.resize(bytes);
+      memcpy(buffer.data(),
+             reinterpret_cast<std::byte*>(output_index) + (k * bytes), bytes);
+      output.setData(std::move(buffer));
+      output.setName(name);
+
+      resp.addOutput(std::move(output));
+    }
 
 #ifdef AMDINFER_ENABLE_TRACING
-          auto context = batch->getTrace(k)->propagate();
-          resp.setContext(std::move(context));
+    auto context = batch->getTrace(k)->propagate();
+    resp.setContext(std::move(context));
 #endif
 
-          req->runCallbackOnce(resp);
+    req->runCallbackOnce(resp);
 #ifdef AMDINFER_ENABLE_METRICS
-          Metrics::getInstance().incrementCounter(
-            MetricCounterIDs::PipelineEgressWorker);
-          util::Timer timer{batch->getTime(k)};
-          timer.stop();
-          auto duration = timer.count<std::micro>();
-          Metrics::getInstance().observeSummary(
-            MetricSummaryIDs::RequestLatency, duration);
+    Metrics::getInstance().incrementCounter(
+      MetricCounterIDs::PipelineEgressWorker);
+    util::Timer timer{batch->getTime(k)};
+    timer.stop();
+    auto duration = timer.count<std::micro>();
+    Metrics::getInstance().observeSummary(MetricSummaryIDs::RequestLatency,
+                                          duration);
 #endif
-        }
-        for (auto& buffer : input_buffers) {
-          pool_->put(std::move(buffer));
-        }
-        thread_pool_size--;
-      });
   }
-  AMDINFER_LOG_INFO(logger, "XModel ending");
+  for (auto& buffer : job->input_buffers) {
+    pool_->put(std::move(buffer));
+  }
+  for (auto& buffer : job->output_buffers) {
+    pool_->put(std::move(buffer));
+  }
+}
+
+void XModel::fail(XModelJob* job, const std::string& error) {
+  job->turn.release();
+  for (const auto& req : job->batch->getRequests()) {
+    req->runCallbackError("XModel inference error: " + error);
+  }
+  for (auto& buffer : job->input_buffers) {
+    pool_->put(std::move(buffer));
+  }
+  for (auto& buffer : job->output_buffers) {
+    pool_->put(std::move(buffer));
+  }
 }
 
 void XModel::doRelease() {}
-void XModel::doDestroy() { this->thread_pool_.stop(true); }
+void XModel::doDestroy() { this->thread_pool_.stop(); }
 
 }  // namespace amdinfer::workers
 
 extern "C" {
 // using smart pointer here may cause problems inside shared object so managing
 // manually
-amdinfer::workers::Worker* getWorker() {
+amdinfer::workers::Worker* AMDINFER_WORKER_FACTORY() {
   return new amdinfer::workers::XModel();
 }
 }  // extern C
@@ -0,0 +1,188 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Tests the ModelStreamInfer gRPC stream. The clients don't use the
+ * stream so requests are sent with the generated stub. gRPC's server is global
+ * so each of its modes is tested in an executable of its own.
+ */
+
+#ifndef GUARD_TESTS_API_MODEL_STREAM_INFER
+#define GUARD_TESTS_API_MODEL_STREAM_INFER
+
+#include <grpcpp/grpcpp.h>  // for ClientContext, CreateChannel
+
+#include <cstdint>  // for uint16_t, uint32_t
+#include <map>      // for map
+#include <memory>   // for unique_ptr, make_unique
+#include <string>   // for string, to_string
+#include <thread>   // for yield
+#include <vector>   // for vector
+
+#include "amdinfer/amdinfer.hpp"                // for GrpcClient, GrpcServ...
+#include "amdinfer/testing/gtest_fixtures.hpp"  // for BaseFixture
+#include "inference.grpc.pb.h"                  // for GRPCInferenceService
+#include "inference.pb.h"                       // for ModelInferRequest
+
+using StreamResponse = inference::ModelStreamInferResponse;
+
+/**
+ * @brief Starts the gRPC server, if it's not already running, and loads the
+ * echo worker for each test
+ *
+ * @tparam CallbackApi whether the server uses gRPC's callback API
+ */
+template <bool CallbackApi>
+class GrpcStreamFixture : public BaseFixture {
+ protected:
+  // the modes use different ports so a test can't reach the other mode
+  static constexpr uint16_t kPort =
+    CallbackApi ? kDefaultGrpcPort + 1 : kDefaultGrpcPort;
+
+  void SetUp() override {
+    const auto address = "localhost:" + std::to_string(kPort);
+    client_ = std::make_unique<amdinfer::GrpcClient>(address);
+    if (!client_->serverLive()) {
+      BaseFixture::SetUp();
+      amdinfer::GrpcServerOptions options;
+      options.callback_api = CallbackApi;
+      server_.startGrpc(kPort, options);
+      while (!client_->serverLive()) {
+        std::this_thread::yield();
+      }
+    }
+    stub_ = inference::GRPCInferenceService::NewStub(
+      grpc::CreateChannel(address, grpc::InsecureChannelCredentials()));
+    endpoint_ = client_->workerLoad("echo", {});
+  }
+
+  void TearDown() override { client_->modelUnload(endpoint_); }
+
+  std::unique_ptr<amdinfer::GrpcClient> client_;
+  std::unique_ptr<inference::GRPCInferenceService::Stub> stub_;
+  std::string endpoint_;
+};
+
+/// Make a request for the echo worker, which adds one to the value
+inline inference::ModelInferRequest makeStreamRequest(const std::string& model,
+                                                      int id, uint32_t value) {
+  inference::ModelInferRequest request;
+  request.set_model_name(model);
+  request.set_id(std::to_string(id));
+  auto* input = request.add_inputs();
+  input->set_name("input");
+  input->set_datatype("UINT32");
+  input->add_shape(1);
+  input->mutable_contents()->add_uint_contents(value);
+  return request;
+}
+
+/**
+ * @brief Send the requests over one stream and read all the responses
+ *
+ * @param stub the stub to open the stream with
+ * @param requests the requests to send
+ * @param lockstep if true, a request's response is read before the next
+ * request is sent. Otherwise, all the requests are sent first
+ * @return std::vector<StreamResponse> the responses in the order they arrived
+ */
+inline std::vector<StreamResponse> exchange(
+  inference::GRPCInferenceService::Stub* stub,
+  const std::vector<inference::ModelInferRequest>& requests, bool lockstep) {
+  grpc::ClientContext context;
+  auto stream = stub->ModelStreamInfer(&context);
+  std::vector<StreamResponse> responses;
+  StreamResponse response;
+  for (const auto& request : requests) {
+    EXPECT_TRUE(stream->Write(request));
+    if (lockstep) {
+      EXPECT_TRUE(stream->Read(&response));
+      responses.push_back(response);
+    }
+  }
+  EXPECT_TRUE(stream->WritesDone());
+  while (stream->Read(&response)) {
+    responses.push_back(response);
+  }
+  // the stream ends normally even if some of its requests failed
+  const auto status = stream->Finish();
+  EXPECT_TRUE(status.ok()) << status.error_message();
+  return responses;
+}
+
+/// Check that the response is the echo worker's answer to the value
+inline void expectEcho(const StreamResponse& response, uint32_t value) {
+  ASSERT_EQ(response.error_message(), "");
+  const auto& proto = response.infer_response();
+  EXPECT_EQ(proto.model_name(), "echo");
+  ASSERT_EQ(proto.outputs_size(), 1);
+  const auto& contents = proto.outputs(0).contents();
+  ASSERT_EQ(contents.uint_contents_size(), 1);
+  EXPECT_EQ(contents.uint_contents(0), value + 1);
+}
+
+/// Pipeline many requests on one stream. Each is answered once by its ID
+inline void testStreamMany(inference::GRPCInferenceService::Stub* stub,
+                           const std::string& endpoint) {
+  const auto num_requests = 32;
+  std::vector<inference::ModelInferRequest> requests;
+  for (auto i = 0; i < num_requests; ++i) {
+    requests.push_back(makeStreamRequest(endpoint, i, i * 10));
+  }
+
+  const auto responses = exchange(stub, requests, false);
+  ASSERT_EQ(responses.size(), num_requests);
+  std::map<std::string, int> seen;
+  for (const auto& response : responses) {
+    const auto& id = response.infer_response().id();
+    seen[id]++;
+    expectEcho(response, std::stoi(id) * 10);
+  }
+  EXPECT_EQ(seen.size(), num_requests);
+}
+
+/// A request's response comes back before the next request is sent
+inline void testStreamOrder(inference::GRPCInferenceService::Stub* stub,
+                            const std::string& endpoint) {
+  const auto num_requests = 8;
+  std::vector<inference::ModelInferRequest> requests;
+  for (auto i = 0; i < num_requests; ++i) {
+    requests.push_back(makeStreamRequest(endpoint, i, i));
+  }
+
+  const auto responses = exchange(stub, requests, true);
+  ASSERT_EQ(responses.size(), num_requests);
+  for (auto i = 0; i < num_requests; ++i) {
+    EXPECT_EQ(responses[i].infer_response().id(), std::to_string(i));
+    expectEcho(responses[i], i);
+  }
+}
+
+/// A failed request gets an error and the requests after it still succeed
+inline void testStreamError(inference::GRPCInferenceService::Stub* stub,
+                            const std::string& endpoint) {
+  const std::vector<inference::ModelInferRequest> requests{
+    makeStreamRequest(endpoint, 0, 1), makeStreamRequest("missing", 1, 2),
+    makeStreamRequest(endpoint, 2, 3)};
+
+  const auto responses = exchange(stub, requests, true);
+  ASSERT_EQ(responses.size(), requests.size());
+  expectEcho(responses[0], 1);
+  EXPECT_NE(responses[1].error_message(), "");
+  EXPECT_EQ(responses[1].infer_response().id(), "1");
+  expectEcho(responses[2], 3);
+}
+
+#endif  // GUARD_TESTS_API_MODEL_STREAM_INFER
@@ -13,6 +13,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cstddef>  // for size_t
 #include <cstdint>  // for uint32_t, uint64_t
 #include <vector>   // for vector, allocator
 
@@ -55,4 +56,43 @@ TEST_F(HttpFixture, Ordered) {
 }
 #endif
 
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST_F(BaseFixture, OrderedWindowed) {
+  NativeClient client(&server_);
+  auto endpoint = client.workerLoad("echo", {});
+  EXPECT_EQ(endpoint, "echo");
+
+  const auto data_size = 10;
+  std::vector<uint32_t> img_data(data_size);
+  std::vector<InferenceRequest> reqs(data_size);
+  for (auto i = 0; i < data_size; ++i) {
+    img_data[i] = i;
+    reqs[i].addInputTensor(&img_data[i], {1UL}, DataType::Uint32);
+  }
+
+  // a window that doesn't divide the requests evenly
+  auto resps = inferAsyncOrderedWindowed(&client, endpoint, reqs, 3);
+  ASSERT_EQ(resps.size(), data_size);
+  for (auto i = 0; i < data_size; ++i) {
+    ASSERT_FALSE(resps[i].isError());
+    const auto outputs = resps[i].getOutputs();
+    ASSERT_EQ(outputs.size(), 1);
+    EXPECT_EQ(static_cast<uint32_t*>(outputs[0].getData())[0], i + 1);
+  }
+
+  std::vector<size_t> indices;
+  inferAsyncOrderedWindowed(
+    &client, endpoint, reqs, data_size + 1,
+    [&indices](size_t index, const InferenceResponse& response) {
+      EXPECT_FALSE(response.isError());
+      indices.push_back(index);
+    });
+  ASSERT_EQ(indices.size(), data_size);
+  for (auto i = 0U; i < indices.size(); ++i) {
+    EXPECT_EQ(indices[i], i);
+  }
+
+  client.modelUnload(endpoint);
+}
+
 }  // namespace amdinfer
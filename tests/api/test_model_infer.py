@@ -13,6 +13,7 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 
+import asyncio
 import time
 
 import numpy as np
@@ -38,7 +39,11 @@ class TestModelInfer:
         input_data = amdinfer.InferenceRequestInput()
         input_data.shape = [1]
         input_data.datatype = amdinfer.DataType.UINT32
-        input_data.setUint32Data(np.array([1], np.uint32))
+        data = np.array([1], np.uint32)
+        input_data.setUint32Data(data)
+        # the input shares the array's memory, both ways
+        assert np.shares_memory(input_data.getUint32Data(), data)
+        assert np.shares_memory(np.asarray(input_data), data)
         request = amdinfer.InferenceRequest()
         request.addInputTensor(input_data)
 
@@ -50,6 +55,45 @@ class TestModelInfer:
         output_data = outputs[0].getUint32Data()
         assert len(output_data) == 1
         assert output_data[0] == 2
+        assert np.shares_memory(np.asarray(outputs[0]), output_data)
+
+        self.rest_client.modelUnload(endpoint)
+
+        try:
+            while self.rest_client.modelReady(endpoint):
+                time.sleep(1)
+        except amdinfer.RuntimeError:
+            pass
+
+    def test_model_infer_asyncio(self):
+        """
+        Test awaiting many inferences from one event loop
+        """
+
+        endpoint = self.rest_client.workerLoad("echo")
+        assert endpoint == "echo"
+
+        input_data = amdinfer.InferenceRequestInput()
+        input_data.shape = [1]
+        input_data.datatype = amdinfer.DataType.UINT32
+        input_data.setUint32Data(np.array([1], np.uint32))
+        request = amdinfer.InferenceRequest()
+        request.addInputTensor(input_data)
+
+        async def infer(num_requests):
+            return await asyncio.gather(
+                *[
+                    self.rest_client.modelInferAsync(endpoint, request)
+                    for _ in range(num_requests)
+                ]
+            )
+
+        responses = asyncio.run(infer(16))
+        for response in responses:
+            assert not response.isError(), response.getError()
+            outputs = response.getOutputs()
+            assert len(outputs) == 1
+            assert outputs[0].getUint32Data()[0] == 2
 
         self.rest_client.modelUnload(endpoint)
 
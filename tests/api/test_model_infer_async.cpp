@@ -13,11 +13,14 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-#include <cstdint>  // for uint8_t, uint64_t, uin...
-#include <future>   // for future
-#include <memory>   // for allocator, unique_ptr
-#include <queue>    // for queue
-#include <vector>   // for vector
+#include <condition_variable>  // for condition_variable
+#include <cstdint>             // for uint8_t, uint64_t, uin...
+#include <future>              // for future, promise
+#include <memory>              // for allocator, unique_ptr
+#include <mutex>               // for mutex, lock_guard, unique_lock
+#include <queue>               // for queue
+#include <string>              // for string
+#include <vector>              // for vector
 
 #include "amdinfer/amdinfer.hpp"                // for InferenceResponse, Grp...
 #include "amdinfer/testing/gtest_fixtures.hpp"  // for GrpcFixture
@@ -65,6 +68,43 @@ void test(amdinfer::Client* client) {
 #ifdef AMDINFER_ENABLE_GRPC
 // NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
 TEST_F(GrpcFixture, ModelInfer) { test(client_.get()); }
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST_F(GrpcFixture, ModelInferCallback) {
+  auto endpoint = client_->workerLoad("echo", {});
+  EXPECT_EQ(endpoint, "echo");
+
+  std::vector<uint32_t> img_data{1};
+  amdinfer::InferenceRequest request;
+  request.addInputTensor(static_cast<void*>(img_data.data()), {1UL},
+                         amdinfer::DataType::Uint32);
+
+  const auto num_requests = 16;
+  std::mutex mutex;
+  std::condition_variable cv;
+  auto responses = 0;
+  auto errors = 0;
+  for (auto i = 0; i < num_requests; ++i) {
+    client_->modelInferAsync(
+      endpoint, request, [&](const amdinfer::InferenceResponse& response) {
+        const auto outputs = response.getOutputs();
+        const auto valid =
+          !response.isError() && outputs.size() == 1 &&
+          static_cast<uint32_t*>(outputs[0].getData())[0] == 2;
+        std::lock_guard lock{mutex};
+        responses++;
+        errors += valid ? 0 : 1;
+        cv.notify_one();
+      });
+  }
+
+  std::unique_lock lock{mutex};
+  cv.wait(lock, [&]() { return responses == num_requests; });
+  EXPECT_EQ(errors, 0);
+  lock.unlock();
+
+  client_->modelUnload(endpoint);
+}
 #endif
 
 // NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
@@ -73,7 +113,80 @@ TEST_F(BaseFixture, ModelInfer) {
   test(&client);
 }
 
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST_F(BaseFixture, ModelInferShared) {
+  amdinfer::NativeClient client(&server_);
+  auto endpoint = client.workerLoad("echo", {});
+  EXPECT_EQ(endpoint, "echo");
+
+  // the data is read in place so it must outlive the requests
+  std::vector<uint32_t> img_data{1};
+  auto make_request = [&img_data]() {
+    auto request = std::make_shared<amdinfer::InferenceRequest>();
+    request->addInputTensor(static_cast<void*>(img_data.data()), {1UL},
+                            amdinfer::DataType::Uint32);
+    return request;
+  };
+
+  auto future = client.modelInferAsync(endpoint, make_request());
+  auto response = future.get();
+  EXPECT_FALSE(response.isError());
+  ASSERT_EQ(response.getOutputs().size(), 1);
+  EXPECT_EQ(static_cast<uint32_t*>(response.getOutputs()[0].getData())[0], 2);
+
+  std::promise<uint32_t> promise;
+  client.modelInferAsync(
+    endpoint, make_request(),
+    [&promise](const amdinfer::InferenceResponse& response) {
+      const auto outputs = response.getOutputs();
+      promise.set_value(response.isError() || outputs.empty()
+                          ? 0
+                          : static_cast<uint32_t*>(outputs[0].getData())[0]);
+    });
+  EXPECT_EQ(promise.get_future().get(), 2);
+  // the caller's data isn't changed
+  EXPECT_EQ(img_data[0], 1);
+
+  client.modelUnload(endpoint);
+}
+
 #ifdef AMDINFER_ENABLE_HTTP
 // NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
 TEST_F(HttpFixture, ModelInfer) { test(client_.get()); }
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST_F(HttpFixture, ModelInferQueueFull) {
+  amdinfer::ParameterMap parameters;
+  parameters.put("max_queue_size", 1);
+  auto endpoint = client_->workerLoad("echo", parameters);
+
+  std::vector<uint32_t> img_data{1};
+  amdinfer::InferenceRequest request;
+  request.addInputTensor(static_cast<void*>(img_data.data()), {1UL},
+                         amdinfer::DataType::Uint32);
+
+  // the batcher empties the queue quickly so requests are sent in bursts
+  // until one finds it full. Every request must still get a response
+  const auto num_requests = 256;
+  const auto max_bursts = 20;
+  auto rejected = 0;
+  for (auto burst = 0; burst < max_bursts && rejected == 0; ++burst) {
+    std::queue<amdinfer::InferenceResponseFuture> q;
+    for (auto i = 0; i < num_requests; ++i) {
+      q.push(client_->modelInferAsync(endpoint, request));
+    }
+    while (!q.empty()) {
+      auto response = q.front().get();
+      q.pop();
+      if (response.isError()) {
+        EXPECT_NE(response.getError().find("is full"), std::string::npos)
+          << response.getError();
+        rejected++;
+      }
+    }
+  }
+  EXPECT_GT(rejected, 0);
+
+  client_->modelUnload(endpoint);
+}
 #endif
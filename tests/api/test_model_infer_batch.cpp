@@ -0,0 +1,69 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>  // for uint32_t
+#include <string>   // for to_string
+#include <vector>   // for vector
+
+#include "amdinfer/amdinfer.hpp"                // for InferenceResponse, Grp...
+#include "amdinfer/testing/gtest_fixtures.hpp"  // for GrpcFixture
+
+template <typename ClientType>
+void test(ClientType* client) {
+  auto endpoint = client->workerLoad("echo", {});
+  EXPECT_EQ(endpoint, "echo");
+
+  const auto batch = 4U;
+  std::vector<uint32_t> data(batch);
+  std::vector<amdinfer::InferenceRequest> requests(batch);
+  for (auto i = 0U; i < batch; ++i) {
+    data[i] = i;
+    requests[i].setID(std::to_string(i));
+    requests[i].addInputTensor(static_cast<void*>(&data[i]), {1UL},
+                               amdinfer::DataType::Uint32);
+  }
+
+  auto responses = client->modelInferBatch(endpoint, requests);
+
+  // the responses come back in the order of the requests
+  ASSERT_EQ(responses.size(), batch);
+  for (auto i = 0U; i < batch; ++i) {
+    const auto& response = responses[i];
+    EXPECT_FALSE(response.isError());
+    EXPECT_EQ(response.getID(), std::to_string(i));
+    auto outputs = response.getOutputs();
+    ASSERT_EQ(outputs.size(), 1);
+    const auto* output = static_cast<uint32_t*>(outputs[0].getData());
+    EXPECT_EQ(output[0], i + 1);
+  }
+
+  // a request to a missing model fails without failing the call
+  responses = client->modelInferBatch("missing", requests);
+  ASSERT_EQ(responses.size(), batch);
+  for (const auto& response : responses) {
+    EXPECT_TRUE(response.isError());
+  }
+
+  client->modelUnload(endpoint);
+}
+
+#ifdef AMDINFER_ENABLE_GRPC
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST_F(GrpcFixture, ModelInferBatch) { test(client_.get()); }
+#endif
+
+#ifdef AMDINFER_ENABLE_HTTP
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST_F(HttpFixture, ModelInferBatch) { test(client_.get()); }
+#endif
@@ -0,0 +1,143 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>   // for atomic
+#include <cstdint>  // for uint32_t
+#include <memory>   // for make_shared
+#include <utility>  // for move
+#include <vector>   // for vector
+
+#include "amdinfer/amdinfer.hpp"                // for InferenceResponse, Grp...
+#include "amdinfer/clients/coroutine.hpp"       // for modelInferCo, CoExecutor
+#include "amdinfer/testing/gtest_fixtures.hpp"  // for GrpcFixture
+
+namespace {
+
+uint32_t getOutput(const amdinfer::InferenceResponse& response) {
+  const auto outputs = response.getOutputs();
+  if (response.isError() || outputs.size() != 1) {
+    return 0;
+  }
+  return static_cast<uint32_t*>(outputs[0].getData())[0];
+}
+
+// the coroutine's requests are awaited one after another but the coroutines
+// are interleaved on the executor's thread
+template <typename ClientType>
+void test(const ClientType& client, amdinfer::CoExecutor* executor) {
+  const auto endpoint = client.workerLoad("echo", {});
+  EXPECT_EQ(endpoint, "echo");
+
+  std::vector<uint32_t> img_data{1};
+  amdinfer::InferenceRequest request;
+  request.addInputTensor(static_cast<void*>(img_data.data()), {1UL},
+                         amdinfer::DataType::Uint32);
+
+  const auto num_tasks = 16;
+  const auto requests_per_task = 4;
+  auto errors = 0;
+  auto finished = 0;
+  auto infer = [&]() -> amdinfer::CoTask {
+    for (auto i = 0; i < requests_per_task; ++i) {
+      auto response =
+        co_await amdinfer::modelInferCo(client, endpoint, request, executor);
+      errors += getOutput(response) == 2 ? 0 : 1;
+    }
+    finished++;
+  };
+  for (auto i = 0; i < num_tasks; ++i) {
+    executor->spawn(infer());
+  }
+  executor->run();
+
+  EXPECT_EQ(finished, num_tasks);
+  EXPECT_EQ(errors, 0);
+
+  client.modelUnload(endpoint);
+}
+
+}  // namespace
+
+#ifdef AMDINFER_ENABLE_GRPC
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST_F(GrpcFixture, ModelInferCo) {
+  amdinfer::CoExecutor executor;
+  test(*client_, &executor);
+}
+#endif
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST_F(BaseFixture, ModelInferCo) {
+  amdinfer::NativeClient client(&server_);
+  auto endpoint = client.workerLoad("echo", {});
+  EXPECT_EQ(endpoint, "echo");
+
+  // the data is read in place so it must outlive the requests
+  std::vector<uint32_t> img_data{1};
+  auto request = std::make_shared<amdinfer::InferenceRequest>();
+  request->addInputTensor(static_cast<void*>(img_data.data()), {1UL},
+                          amdinfer::DataType::Uint32);
+
+  amdinfer::CoExecutor executor;
+  uint32_t output = 0;
+  auto infer = [&]() -> amdinfer::CoTask {
+    auto response = co_await amdinfer::modelInferCo(client, endpoint,
+                                                    std::move(request),
+                                                    &executor);
+    output = getOutput(response);
+  };
+  executor.spawn(infer());
+  executor.run();
+  EXPECT_EQ(output, 2);
+
+  client.modelUnload(endpoint);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST_F(BaseFixture, ModelInferCoNoExecutor) {
+  amdinfer::NativeClient client(&server_);
+  auto endpoint = client.workerLoad("echo", {});
+  EXPECT_EQ(endpoint, "echo");
+
+  std::vector<uint32_t> img_data{1};
+  auto request = std::make_shared<amdinfer::InferenceRequest>();
+  request->addInputTensor(static_cast<void*>(img_data.data()), {1UL},
+                          amdinfer::DataType::Uint32);
+
+  // the tasks start on the executor but are resumed and finish in the
+  // client's threads so run() must still return once they're all done
+  amdinfer::CoExecutor executor;
+  const auto num_tasks = 16;
+  std::atomic<int> outputs = 0;
+  auto infer = [&]() -> amdinfer::CoTask {
+    auto response = co_await amdinfer::modelInferCo(client, endpoint,
+                                                    request, nullptr);
+    outputs += getOutput(response) == 2 ? 1 : 0;
+  };
+  for (auto i = 0; i < num_tasks; ++i) {
+    executor.spawn(infer());
+  }
+  executor.run();
+  EXPECT_EQ(outputs, num_tasks);
+
+  client.modelUnload(endpoint);
+}
+
+#ifdef AMDINFER_ENABLE_HTTP
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST_F(HttpFixture, ModelInferCo) {
+  amdinfer::CoExecutor executor;
+  test(*client_, &executor);
+}
+#endif
@@ -0,0 +1,46 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>  // for uint32_t
+#include <vector>   // for vector
+
+#include "model_stream_infer.hpp"  // for GrpcStreamFixture, testStreamMany
+
+// the server runs its calls on gRPC's callback API
+using GrpcCallbackStream = GrpcStreamFixture<true>;
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST_F(GrpcCallbackStream, Many) { testStreamMany(stub_.get(), endpoint_); }
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST_F(GrpcCallbackStream, Order) { testStreamOrder(stub_.get(), endpoint_); }
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST_F(GrpcCallbackStream, Error) { testStreamError(stub_.get(), endpoint_); }
+
+// unary calls complete on the callback API as well
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST_F(GrpcCallbackStream, ModelInfer) {
+  std::vector<uint32_t> data{1};
+  amdinfer::InferenceRequest request;
+  request.addInputTensor(static_cast<void*>(data.data()), {1UL},
+                         amdinfer::DataType::Uint32);
+  for (auto i = 0; i < 4; ++i) {
+    const auto response = client_->modelInfer(endpoint_, request);
+    ASSERT_FALSE(response.isError()) << response.getError();
+    const auto outputs = response.getOutputs();
+    ASSERT_EQ(outputs.size(), 1);
+    EXPECT_EQ(static_cast<uint32_t*>(outputs[0].getData())[0], 2);
+  }
+}
@@ -0,0 +1,43 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <dlfcn.h>  // for dlopen, RTLD_LAZY, RTLD_NOLOAD
+
+#include <cstdint>  // for uint32_t
+#include <vector>   // for vector
+
+#include "amdinfer/amdinfer.hpp"                // for NativeClient
+#include "amdinfer/testing/gtest_fixtures.hpp"  // for BaseFixture
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST_F(BaseFixture, staticWorker) {
+  amdinfer::NativeClient client(&server_);
+  const auto endpoint = client.workerLoad("echo", {});
+  EXPECT_EQ(endpoint, "echo");
+
+  // the echo worker is compiled into the server so its library isn't opened
+  EXPECT_EQ(dlopen("libworkerEcho.so", RTLD_LAZY | RTLD_NOLOAD), nullptr);
+
+  std::vector<uint32_t> data{1};
+  amdinfer::InferenceRequest request;
+  request.addInputTensor(static_cast<void*>(data.data()), {1UL},
+                         amdinfer::DataType::Uint32);
+  const auto response = client.modelInfer(endpoint, request);
+  ASSERT_FALSE(response.isError());
+  const auto outputs = response.getOutputs();
+  ASSERT_EQ(outputs.size(), 1);
+  EXPECT_EQ(static_cast<const uint32_t*>(outputs[0].getData())[0], 2);
+
+  client.modelUnload(endpoint);
+}
@@ -13,10 +13,12 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-#include <memory>  // for allocator, unique_ptr
-#include <string>  // for basic_string, string
-#include <thread>  // for yield
-#include <vector>  // for vector
+#include <algorithm>  // for find
+#include <chrono>     // for steady_clock, seconds
+#include <memory>     // for allocator, unique_ptr
+#include <string>     // for basic_string, string
+#include <thread>     // for yield
+#include <vector>     // for vector
 
 #include "amdinfer/amdinfer.hpp"                // for Client, RequestParame...
 #include "amdinfer/testing/gtest_fixtures.hpp"  // for AssertionResult, Message
@@ -69,6 +71,61 @@ TEST_F(BaseFixture, workerLoad) {
   test(&client);
 }
 
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST_F(BaseFixture, workerLoadUnload) {
+  amdinfer::NativeClient client(&server_);
+  amdinfer::ParameterMap parameters;
+  parameters.put("async", true);
+  const auto endpoint = client.workerLoad("echo", parameters);
+  client.modelUnload(endpoint);
+
+  // an endpoint unloaded while it's loading is torn down once its load
+  // finishes instead of being published
+  const auto timeout = std::chrono::seconds(10);
+  const auto start = std::chrono::steady_clock::now();
+  bool unloaded = false;
+  while (!unloaded && std::chrono::steady_clock::now() - start < timeout) {
+    try {
+      (void)client.modelMetadata(endpoint);
+      std::this_thread::yield();
+    } catch (const amdinfer::invalid_argument&) {
+      unloaded = true;
+    }
+  }
+  EXPECT_TRUE(unloaded);
+  EXPECT_TRUE(client.modelList().empty());
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST_F(BaseFixture, workerLoadWhileLoading) {
+  amdinfer::NativeClient client(&server_);
+  amdinfer::ParameterMap parameters;
+  parameters.put("async", true);
+  const auto endpoint = client.workerLoad("echo", parameters);
+
+  // a load that doesn't share the endpoint adds its instance even if the
+  // endpoint is still loading
+  amdinfer::ParameterMap separate;
+  separate.put("share", false);
+  EXPECT_EQ(client.workerLoad("echo", separate), endpoint);
+  EXPECT_TRUE(client.modelReady(endpoint));
+  client.modelUnload(endpoint);
+
+  // loads are handled in order so the unload is done once this has loaded
+  amdinfer::ParameterMap other;
+  const auto max_buffer_num = 100;
+  other.put("max_buffer_num", max_buffer_num);
+  const auto other_endpoint = client.workerLoad("echo", other);
+  const auto models = client.modelList();
+  EXPECT_NE(std::find(models.begin(), models.end(), endpoint), models.end());
+
+  client.modelUnload(endpoint);
+  client.modelUnload(other_endpoint);
+  while (!client.modelList().empty()) {
+    std::this_thread::yield();
+  }
+}
+
 #ifdef AMDINFER_ENABLE_HTTP
 // NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
 TEST_F(HttpFixture, workerLoad) { test(client_.get()); }
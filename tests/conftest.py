@@ -219,6 +219,7 @@ def load(request, server):
 
     request.cls.rest_client = rest_client(request)
     request.cls.ws_client = ws_client(request)
+    request.cls.address = get_http_addr(request.config)
 
     response = request.cls.rest_client.workerLoad(test_model, parameters)
     request.cls.endpoint = response
@@ -242,9 +243,11 @@ def rest_client(request):
     return amdinfer.HttpClient("http://" + address)
 
 
-def ws_client(request):
+def ws_client(request, protocol=amdinfer.WebSocketProtocol.Json):
     address = get_http_addr(request.config)
-    return amdinfer.WebSocketClient("ws://" + address, "http://" + address)
+    return amdinfer.WebSocketClient(
+        "ws://" + address, "http://" + address, protocol
+    )
 
 
 # we can eventually parameterize the clients with a fixture like this
@@ -0,0 +1,156 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Benchmarks the hard and soft batchers with requests from many threads
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>           // for size_t
+#include <cstdint>           // for uint8_t, int64_t, uint64_t
+#include <initializer_list>  // for initializer_list
+#include <memory>            // for make_unique, make_shared
+#include <optional>          // for optional
+#include <thread>            // for thread
+#include <utility>           // for move
+#include <vector>            // for vector
+
+#include "amdinfer/batching/batch.hpp"          // for BatchPtr, Batch
+#include "amdinfer/batching/hard.hpp"           // for HardBatcher
+#include "amdinfer/batching/soft.hpp"           // for SoftBatcher
+#include "amdinfer/buffers/buffer.hpp"          // for Buffer
+#include "amdinfer/core/data_types.hpp"         // for DataType
+#include "amdinfer/core/inference_request.hpp"  // for InferenceRequest
+#include "amdinfer/core/memory_pool/pool.hpp"   // for MemoryPool
+#include "amdinfer/core/parameters.hpp"         // for ParameterMap
+#include "amdinfer/core/request_container.hpp"  // for RequestContainerPtr
+
+namespace amdinfer {
+
+// the requests sent per iteration, spread evenly over the producers. It's a
+// multiple of every batch size so the hard batcher never waits for more
+constexpr auto kRequests = 1024;
+constexpr auto kTimeoutMs = 1;
+constexpr auto kDataSize = 100;
+
+template <typename BatcherType>
+class PerfBatcherFixture : public ::benchmark::Fixture {
+ public:
+  void SetUp(const ::benchmark::State& state) override {
+    const auto batch_size = static_cast<int>(state.range(0));
+
+    ParameterMap parameters;
+    parameters.put("timeout", kTimeoutMs);
+    parameters.put("batch_size", batch_size);
+
+    batcher_.emplace(&pool_, &parameters);
+    batcher_->setName("benchmark");
+    batcher_->setBatchSize(batch_size);
+    batcher_->start({MemoryAllocators::Cpu});
+  }
+
+  void TearDown([[maybe_unused]] const ::benchmark::State& state) override {
+    batcher_->enqueue(nullptr);
+    batcher_->end();
+    batcher_.reset();
+  }
+
+  /// Send requests from some number of threads and wait until they're batched
+  void run(int producers) {
+    std::vector<std::thread> threads;
+    threads.reserve(producers);
+    for (auto i = 0; i < producers; ++i) {
+      threads.emplace_back([this, count = kRequests / producers]() {
+        for (auto j = 0; j < count; ++j) {
+          batcher_->enqueue(makeRequest());
+        }
+      });
+    }
+
+    size_t batched = 0;
+    while (batched < kRequests) {
+      BatchPtr batch;
+      batcher_->getOutputQueue()->wait_dequeue(batch);
+      batched += batch->size();
+      // return the batch's buffers as a worker would
+      for (auto& buffer : batch->getInputBuffers()) {
+        pool_.put(std::move(buffer));
+      }
+    }
+
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+ private:
+  /**
+   * @brief Make a request whose input is in a buffer from the pool, as the
+   * servers do. The batcher returns it to the pool once it's copied
+   */
+  RequestContainerPtr makeRequest() {
+    const std::vector<uint64_t> shape{1, 2, kDataSize / 2};
+    const InferenceRequestInput input{nullptr, shape, DataType::Uint8};
+    auto buffer = pool_.get({MemoryAllocators::Cpu}, input, 1);
+    auto* data = static_cast<uint8_t*>(buffer->data(0));
+    for (auto i = 0; i < kDataSize; i++) {
+      data[i] = static_cast<uint8_t>(i);
+    }
+
+    auto container = std::make_unique<RequestContainer>();
+    container->request = std::make_shared<InferenceRequest>();
+    container->request->addInputTensor(static_cast<void*>(data), shape,
+                                       DataType::Uint8);
+    return container;
+  }
+
+  MemoryPool pool_;
+  std::optional<BatcherType> batcher_;
+};
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+BENCHMARK_TEMPLATE_DEFINE_F(PerfBatcherFixture, Hard, HardBatcher)
+(benchmark::State& st) {  // NOLINT
+  for ([[maybe_unused]] auto _ : st) {
+    run(static_cast<int>(st.range(1)));
+  }
+  st.SetItemsProcessed(st.iterations() * kRequests);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+BENCHMARK_TEMPLATE_DEFINE_F(PerfBatcherFixture, Soft, SoftBatcher)
+(benchmark::State& st) {  // NOLINT
+  for ([[maybe_unused]] auto _ : st) {
+    run(static_cast<int>(st.range(1)));
+  }
+  st.SetItemsProcessed(st.iterations() * kRequests);
+}
+
+const std::initializer_list<int64_t> kBatchSizes{1, 4, 16};
+const std::initializer_list<int64_t> kProducers{1, 4, 16};
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+BENCHMARK_REGISTER_F(PerfBatcherFixture, Hard)
+  ->ArgsProduct({kBatchSizes, kProducers})
+  ->UseRealTime()
+  ->Unit(benchmark::kMicrosecond);
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+BENCHMARK_REGISTER_F(PerfBatcherFixture, Soft)
+  ->ArgsProduct({kBatchSizes, kProducers})
+  ->UseRealTime()
+  ->Unit(benchmark::kMicrosecond);
+
+}  // namespace amdinfer
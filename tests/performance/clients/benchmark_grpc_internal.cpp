@@ -0,0 +1,112 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Benchmarks mapping requests and responses to and from their protobuf
+ * messages
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>           // for byte
+#include <cstdint>           // for int64_t, uint64_t
+#include <initializer_list>  // for initializer_list
+#include <utility>           // for move
+#include <vector>            // for vector
+
+#include "amdinfer/clients/grpc_internal.hpp"    // for mapRequestToProto
+#include "amdinfer/core/data_types.hpp"          // for DataType
+#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/observation/observer.hpp"     // for Observer
+#include "inference.pb.h"                        // for ModelInferRequest
+
+namespace amdinfer {
+
+namespace {
+
+/// Get a response with one output of the first argument's number of floats
+InferenceResponse makeResponse(int64_t elements) {
+  std::vector<std::byte> data(elements * sizeof(float));
+  InferenceResponseOutput output;
+  output.setName("output");
+  output.setDatatype(DataType::Fp32);
+  output.setShape({static_cast<uint64_t>(elements)});
+  output.setData(std::move(data));
+  InferenceResponse response;
+  response.addOutput(output);
+  return response;
+}
+
+/// Map a request with one input to a message, as the client does
+void requestToProto(benchmark::State& state) {
+  const Observer observer;
+  std::vector<float> data(state.range(0));
+  InferenceRequest request;
+  request.addInputTensor(data.data(), {data.size()}, DataType::Fp32, "input");
+
+  for ([[maybe_unused]] auto _ : state) {
+    inference::ModelInferRequest proto;
+    mapRequestToProto(request, proto, observer);
+    benchmark::DoNotOptimize(proto);
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(data.size() * sizeof(float)));
+}
+
+/// Map a response to a message with typed or, if the second argument is set,
+/// raw contents, as the server does
+void responseToProto(benchmark::State& state) {
+  const auto response = makeResponse(state.range(0));
+  const auto raw = state.range(1) != 0;
+
+  for ([[maybe_unused]] auto _ : state) {
+    inference::ModelInferResponse proto;
+    mapResponseToProto(response, proto, raw);
+    benchmark::DoNotOptimize(proto);
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) *
+                          static_cast<int64_t>(sizeof(float)));
+}
+
+/// Map a message with typed or, if the second argument is set, raw contents
+/// to a response, as the client does
+void protoToResponse(benchmark::State& state) {
+  const Observer observer;
+  inference::ModelInferResponse proto;
+  mapResponseToProto(makeResponse(state.range(0)), proto, state.range(1) != 0);
+
+  for ([[maybe_unused]] auto _ : state) {
+    InferenceResponse response;
+    mapProtoToResponse(proto, response, observer);
+    benchmark::DoNotOptimize(response);
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) *
+                          static_cast<int64_t>(sizeof(float)));
+}
+
+}  // namespace
+
+const std::initializer_list<int64_t> kElements{1, 1 << 10, 1 << 20};
+const std::initializer_list<int64_t> kRaw{0, 1};
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+BENCHMARK(requestToProto)->ArgsProduct({kElements});
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+BENCHMARK(responseToProto)->ArgsProduct({kElements, kRaw});
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+BENCHMARK(protoToResponse)->ArgsProduct({kElements, kRaw});
+
+}  // namespace amdinfer
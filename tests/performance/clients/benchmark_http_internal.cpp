@@ -0,0 +1,121 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Benchmarks mapping requests and responses to and from their JSON
+ * bodies
+ */
+
+#include <benchmark/benchmark.h>
+#include <json/value.h>   // for Value
+#include <json/writer.h>  // for StreamWriterBuilder, writeString
+
+#include <cstdint>           // for int64_t
+#include <initializer_list>  // for initializer_list
+#include <string>            // for string, to_string
+#include <string_view>       // for string_view
+#include <vector>            // for vector
+
+#include "amdinfer/clients/http_internal.hpp"    // for mapRequestToJson
+#include "amdinfer/core/data_types.hpp"          // for DataType
+#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+
+namespace amdinfer {
+
+namespace {
+
+/// Map a request with one input to JSON with its data in the JSON or, if the
+/// second argument is set, in a binary section, as the client does
+void requestToJson(benchmark::State& state) {
+  std::vector<float> data(state.range(0));
+  InferenceRequest request;
+  request.addInputTensor(data.data(), {data.size()}, DataType::Fp32, "input");
+  const auto binary = state.range(1) != 0;
+
+  for ([[maybe_unused]] auto _ : state) {
+    std::string body;
+    auto json = mapRequestToJson(request, binary ? &body : nullptr);
+    benchmark::DoNotOptimize(json);
+    benchmark::DoNotOptimize(body);
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(data.size() * sizeof(float)));
+}
+
+/// Write a request's body with one input straight from the tensor with its
+/// data in the JSON or, if the second argument is set, in a binary section, as
+/// the HttpClient does
+void writeRequestBody(benchmark::State& state) {
+  std::vector<float> data(state.range(0));
+  InferenceRequest request;
+  request.addInputTensor(data.data(), {data.size()}, DataType::Fp32, "input");
+  const auto binary = state.range(1) != 0;
+
+  std::string body;
+  for ([[maybe_unused]] auto _ : state) {
+    auto header_length = writeRequest(request, binary, &body);
+    benchmark::DoNotOptimize(header_length);
+    benchmark::DoNotOptimize(body);
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(data.size() * sizeof(float)));
+}
+
+/// Parse a response body and map it to a response, with its data in the JSON
+/// or, if the second argument is set, in a binary section, as the client does
+void jsonToResponse(benchmark::State& state) {
+  std::vector<float> data(state.range(0));
+  InferenceRequest request;
+  request.addInputTensor(data.data(), {data.size()}, DataType::Fp32, "output");
+
+  // a request's inputs have the same JSON as a response's outputs
+  std::string binary;
+  const auto use_binary = state.range(1) != 0;
+  auto json = mapRequestToJson(request, use_binary ? &binary : nullptr);
+  json["model_name"] = "model";
+  json["outputs"] = json["inputs"];
+  json.removeMember("inputs");
+
+  Json::StreamWriterBuilder builder;
+  builder["indentation"] = "";
+  auto body = Json::writeString(builder, json);
+  const auto header_length = std::to_string(body.size());
+  body.append(binary);
+
+  for ([[maybe_unused]] auto _ : state) {
+    Json::Value header;
+    const auto rest = splitBinaryBody(body, header_length, &header);
+    auto response = mapJsonToResponse(&header, rest);
+    benchmark::DoNotOptimize(response);
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(data.size() * sizeof(float)));
+}
+
+}  // namespace
+
+// the text encoding is slow enough that larger tensors take seconds each
+const std::initializer_list<int64_t> kElements{1, 1 << 10, 1 << 16};
+const std::initializer_list<int64_t> kBinary{0, 1};
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+BENCHMARK(requestToJson)->ArgsProduct({kElements, kBinary});
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+BENCHMARK(writeRequestBody)->ArgsProduct({kElements, kBinary});
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+BENCHMARK(jsonToResponse)->ArgsProduct({kElements, kBinary});
+
+}  // namespace amdinfer
@@ -0,0 +1,111 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Benchmarks writing JSON inference responses with and without a JSON
+ * DOM
+ */
+
+#include <benchmark/benchmark.h>
+#include <json/value.h>   // for Value
+#include <json/writer.h>  // for StreamWriterBuilder, writeString
+
+#include <cstdint>           // for int64_t
+#include <initializer_list>  // for initializer_list
+#include <string>            // for string
+#include <vector>            // for vector
+
+#include "amdinfer/clients/json_writer.hpp"  // for JsonWriter
+#include "amdinfer/core/data_types.hpp"      // for DataType
+
+namespace amdinfer {
+
+namespace {
+
+/// Get the first argument's number of scores, like a classifier's output
+std::vector<float> makeData(int64_t elements) {
+  std::vector<float> data(elements);
+  for (auto i = 0; i < elements; ++i) {
+    data[i] = static_cast<float>(i) / static_cast<float>(elements);
+  }
+  return data;
+}
+
+/// Build a JSON DOM with one output and serialize it, as the server did before
+/// the writer was added
+void writeDom(benchmark::State& state) {
+  const auto data = makeData(state.range(0));
+  Json::StreamWriterBuilder builder;
+  builder["indentation"] = "";
+
+  for ([[maybe_unused]] auto _ : state) {
+    Json::Value json;
+    json["model_name"] = "benchmark";
+    Json::Value output;
+    output["name"] = "output";
+    output["datatype"] = "FP32";
+    output["shape"].append(static_cast<Json::UInt64>(data.size()));
+    output["data"] = Json::arrayValue;
+    for (const auto& datum : data) {
+      output["data"].append(datum);
+    }
+    json["outputs"].append(output);
+    benchmark::DoNotOptimize(Json::writeString(builder, json));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/// Write the same response with the JsonWriter
+void writeDirect(benchmark::State& state) {
+  const auto data = makeData(state.range(0));
+
+  for ([[maybe_unused]] auto _ : state) {
+    std::string body;
+    body.reserve(getMaxJsonSize(DataType::Fp32, data.size()) + 256);
+    JsonWriter writer{&body};
+    writer.beginObject();
+    writer.key("model_name");
+    writer.string("benchmark");
+    writer.key("outputs");
+    writer.beginArray();
+    writer.beginObject();
+    writer.key("name");
+    writer.string("output");
+    writer.key("datatype");
+    writer.string("FP32");
+    writer.key("shape");
+    writer.beginArray();
+    writer.number(static_cast<uint64_t>(data.size()));
+    writer.endArray();
+    writer.key("data");
+    writer.array(DataType::Fp32, data.data(), data.size());
+    writer.endObject();
+    writer.endArray();
+    writer.endObject();
+    benchmark::DoNotOptimize(body);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+}  // namespace
+
+const std::initializer_list<int64_t> kElements{1, 1000, 1 << 16};
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+BENCHMARK(writeDom)->ArgsProduct({kElements});
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+BENCHMARK(writeDirect)->ArgsProduct({kElements});
+
+}  // namespace amdinfer
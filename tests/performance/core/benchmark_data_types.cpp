@@ -0,0 +1,103 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Benchmarks writing tensors into buffers by dispatching on their
+ * datatypes with switchOverTypes, once per element as the protocol mappings
+ * used to and once per tensor
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>           // for byte, size_t
+#include <cstdint>           // for int64_t
+#include <initializer_list>  // for initializer_list
+#include <vector>            // for vector
+
+#include "amdinfer/buffers/cpu.hpp"                        // for CpuBuffer
+#include "amdinfer/core/data_types.hpp"                    // for DataType
+#include "amdinfer/core/memory_pool/memory_allocator.hpp"  // for MemoryAl...
+
+namespace amdinfer {
+
+namespace {
+
+struct WriteValue {
+  template <typename T>
+  size_t operator()(Buffer* buffer, double value, size_t offset) const {
+    return buffer->write(static_cast<T>(value), offset);
+  }
+};
+
+struct WriteValues {
+  template <typename T>
+  size_t operator()(Buffer* buffer, const double* values, size_t count) const {
+    return buffer->writeAs<T>(values, 0, count);
+  }
+};
+
+/**
+ * @brief Set up a benchmark's buffer and values. The first argument is the
+ * datatype and the second is the number of elements
+ */
+struct TensorData {
+  explicit TensorData(const benchmark::State& state)
+    : datatype(static_cast<DataType::Value>(state.range(0))),
+      values(state.range(1), 1.0),
+      data(values.size() * datatype.size()),
+      buffer(data.data(), MemoryAllocators::Cpu, data.size()) {}
+
+  DataType datatype;
+  std::vector<double> values;
+  std::vector<std::byte> data;
+  CpuBuffer buffer;
+};
+
+void perElement(benchmark::State& state) {
+  TensorData tensor{state};
+  for ([[maybe_unused]] auto _ : state) {
+    size_t offset = 0;
+    for (const auto value : tensor.values) {
+      offset = switchOverTypes(WriteValue(), tensor.datatype, &tensor.buffer,
+                               value, offset);
+    }
+    benchmark::DoNotOptimize(offset);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+
+void perTensor(benchmark::State& state) {
+  TensorData tensor{state};
+  for ([[maybe_unused]] auto _ : state) {
+    const auto offset =
+      switchOverTypes(WriteValues(), tensor.datatype, &tensor.buffer,
+                      tensor.values.data(), tensor.values.size());
+    benchmark::DoNotOptimize(offset);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+
+}  // namespace
+
+const std::initializer_list<int64_t> kDatatypes{
+  DataType::Uint8, DataType::Int64, DataType::Fp16, DataType::Fp32};
+const std::initializer_list<int64_t> kElements{64, 1 << 16};
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+BENCHMARK(perElement)->ArgsProduct({kDatatypes, kElements});
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+BENCHMARK(perTensor)->ArgsProduct({kDatatypes, kElements});
+
+}  // namespace amdinfer
@@ -0,0 +1,125 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Benchmarks the ParameterMap operations that every request makes
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>           // for byte
+#include <cstdint>           // for int32_t, int64_t
+#include <initializer_list>  // for initializer_list
+#include <string>            // for string, to_string
+#include <vector>            // for vector
+
+#include "amdinfer/core/parameters.hpp"  // for ParameterMap
+
+namespace amdinfer {
+
+namespace {
+
+/// Get the keys of a map with some number of parameters
+std::vector<std::string> makeKeys(int64_t count) {
+  std::vector<std::string> keys;
+  keys.reserve(count);
+  for (auto i = 0; i < count; ++i) {
+    keys.push_back("parameter_" + std::to_string(i));
+  }
+  return keys;
+}
+
+ParameterMap makeParameters(const std::vector<std::string>& keys) {
+  ParameterMap parameters;
+  for (const auto& key : keys) {
+    parameters.put(key, static_cast<int32_t>(key.size()));
+  }
+  return parameters;
+}
+
+/// Build a map of the first argument's number of parameters
+void put(benchmark::State& state) {
+  const auto keys = makeKeys(state.range(0));
+  for ([[maybe_unused]] auto _ : state) {
+    ParameterMap parameters;
+    for (const auto& key : keys) {
+      parameters.put(key, 1);
+    }
+    benchmark::DoNotOptimize(parameters);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/// Look up every parameter of a map
+void get(benchmark::State& state) {
+  const auto keys = makeKeys(state.range(0));
+  const auto parameters = makeParameters(keys);
+  for ([[maybe_unused]] auto _ : state) {
+    for (const auto& key : keys) {
+      benchmark::DoNotOptimize(parameters.get<int32_t>(key));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/// Check for a parameter that isn't there, as workers do for their options
+void hasMissing(benchmark::State& state) {
+  const auto parameters = makeParameters(makeKeys(state.range(0)));
+  for ([[maybe_unused]] auto _ : state) {
+    benchmark::DoNotOptimize(parameters.has("missing"));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+/// Copy a map, as copying a request does
+void copy(benchmark::State& state) {
+  const auto parameters = makeParameters(makeKeys(state.range(0)));
+  for ([[maybe_unused]] auto _ : state) {
+    auto copied = parameters;
+    benchmark::DoNotOptimize(copied);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+/// Serialize a map and deserialize it again
+void serialize(benchmark::State& state) {
+  const auto parameters = makeParameters(makeKeys(state.range(0)));
+  std::vector<std::byte> data(parameters.serializeSize());
+  for ([[maybe_unused]] auto _ : state) {
+    parameters.serialize(data.data());
+    ParameterMap deserialized;
+    deserialized.deserialize(data.data());
+    benchmark::DoNotOptimize(deserialized);
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(data.size()));
+}
+
+}  // namespace
+
+const std::initializer_list<int64_t> kParameterCounts{1, 4, 16, 64};
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+BENCHMARK(put)->ArgsProduct({kParameterCounts});
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+BENCHMARK(get)->ArgsProduct({kParameterCounts});
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+BENCHMARK(hasMissing)->ArgsProduct({kParameterCounts});
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+BENCHMARK(copy)->ArgsProduct({kParameterCounts});
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+BENCHMARK(serialize)->ArgsProduct({kParameterCounts});
+
+}  // namespace amdinfer
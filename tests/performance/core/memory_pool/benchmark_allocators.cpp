@@ -0,0 +1,98 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Benchmarks getting and putting buffers from the allocators, from many
+ * threads at once to measure their contention
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>           // for size_t
+#include <cstdint>           // for int64_t, uint64_t
+#include <initializer_list>  // for initializer_list
+#include <type_traits>       // for is_same_v
+
+#include "amdinfer/build_options.hpp"                   // for AMDINFER_ENA...
+#include "amdinfer/buffers/buffer.hpp"                  // for Buffer
+#include "amdinfer/core/data_types.hpp"                 // for DataType
+#include "amdinfer/core/inference_request.hpp"          // for InferenceReq...
+#include "amdinfer/core/memory_pool/cpu_allocator.hpp"  // for CpuAllocator
+
+#ifdef AMDINFER_ENABLE_VITIS
+#include "amdinfer/core/memory_pool/vart_tensor_allocator.hpp"  // for Vart...
+#endif
+
+namespace amdinfer {
+
+namespace {
+
+/// Size of the CpuAllocator's blocks, which all the buffers fit in
+constexpr size_t kBlockSize = 1ULL << 24U;
+constexpr int kMaxThreads = 16;
+
+/// Get the allocator that all the threads of a benchmark share
+template <typename Allocator>
+Allocator& getAllocator() {
+  if constexpr (std::is_same_v<Allocator, CpuAllocator>) {
+    static CpuAllocator allocator{kBlockSize};
+    return allocator;
+  } else {
+    static Allocator allocator;
+    return allocator;
+  }
+}
+
+/**
+ * @brief Get and put a buffer repeatedly. The first argument is the size of
+ * the buffer in bytes
+ *
+ * @tparam Allocator the allocator to benchmark
+ * @param state the benchmark's state
+ */
+template <typename Allocator>
+void getPut(benchmark::State& state) {
+  auto& allocator = getAllocator<Allocator>();
+  const auto size = static_cast<uint64_t>(state.range(0));
+  const InferenceRequestInput input{nullptr, {size}, DataType::Uint8, "input"};
+
+  for ([[maybe_unused]] auto _ : state) {
+    const auto buffer = allocator.get(input, 1);
+    auto* data = buffer->data(0);
+    benchmark::DoNotOptimize(data);
+    allocator.put(data);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+}  // namespace
+
+const std::initializer_list<int64_t> kBufferSizes{64, 4096, 1 << 20};
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+BENCHMARK_TEMPLATE(getPut, CpuAllocator)
+  ->ArgsProduct({kBufferSizes})
+  ->ThreadRange(1, kMaxThreads)
+  ->UseRealTime();
+
+#ifdef AMDINFER_ENABLE_VITIS
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+BENCHMARK_TEMPLATE(getPut, VartTensorAllocator)
+  ->ArgsProduct({kBufferSizes})
+  ->ThreadRange(1, kMaxThreads)
+  ->UseRealTime();
+#endif
+
+}  // namespace amdinfer
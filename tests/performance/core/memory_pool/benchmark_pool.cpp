@@ -0,0 +1,74 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Benchmarks getting and putting buffers from the memory pool, whose
+ * per-thread caches should keep threads from contending for the allocators
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>           // for int64_t, uint64_t
+#include <initializer_list>  // for initializer_list
+#include <utility>           // for move
+
+#include "amdinfer/buffers/buffer.hpp"                     // for Buffer
+#include "amdinfer/core/data_types.hpp"                    // for DataType
+#include "amdinfer/core/inference_request.hpp"             // for Inferenc...
+#include "amdinfer/core/memory_pool/memory_allocator.hpp"  // for MemoryAl...
+#include "amdinfer/core/memory_pool/pool.hpp"              // for MemoryPool
+
+namespace amdinfer {
+
+namespace {
+
+constexpr int kMaxThreads = 16;
+
+/**
+ * @brief Get and put a buffer repeatedly from a pool that all the threads
+ * share. The first argument is the size of the buffer in bytes and the second
+ * is the allocator to get it from
+ *
+ * @param state the benchmark's state
+ */
+void getPut(benchmark::State& state) {
+  static MemoryPool pool;
+  const auto size = static_cast<uint64_t>(state.range(0));
+  const auto allocator = static_cast<MemoryAllocators>(state.range(1));
+  const InferenceRequestInput input{nullptr, {size}, DataType::Uint8, "input"};
+
+  for ([[maybe_unused]] auto _ : state) {
+    auto buffer = pool.get({allocator}, input, 1);
+    benchmark::DoNotOptimize(buffer->data(0));
+    pool.put(std::move(buffer));
+  }
+  pool.flushThreadCache();
+  state.SetItemsProcessed(state.iterations());
+}
+
+}  // namespace
+
+const std::initializer_list<int64_t> kBufferSizes{64, 4096, 1 << 20};
+const std::initializer_list<int64_t> kAllocators{
+  static_cast<int64_t>(MemoryAllocators::Cpu),
+  static_cast<int64_t>(MemoryAllocators::CpuBinned)};
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+BENCHMARK(getPut)
+  ->ArgsProduct({kBufferSizes, kAllocators})
+  ->ThreadRange(1, kMaxThreads)
+  ->UseRealTime();
+
+}  // namespace amdinfer
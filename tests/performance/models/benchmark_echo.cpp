@@ -0,0 +1,291 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Performance testing for the overhead of each protocol. The echo
+ * workers do almost no work so the time is spent moving the requests through
+ * the client, server and batcher.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>  // for max
+#include <array>      // for array
+#include <chrono>     // for seconds
+#include <cstddef>    // for byte, size_t
+#include <cstdint>    // for uint64_t, uint32_t
+#include <deque>      // for deque
+#include <memory>     // for unique_ptr, make_unique
+#include <string>     // for string
+#include <thread>     // for sleep_for
+#include <tuple>      // for ignore
+#include <vector>     // for vector
+
+#include "amdinfer/amdinfer.hpp"            // for InferenceRequest
+#include "amdinfer/clients/websocket.hpp"  // for WebSocketClient
+
+struct Batching {
+  int batch_size;
+  int timeout_us;
+};
+
+// the bytes in each request's tensor, from one element to 64 MB
+const std::array<size_t, 7> kSizes = {4,          64,         1024,
+                                      16 * 1024,  256 * 1024, 4 * 1024 * 1024,
+                                      64 * 1024 * 1024};
+const std::array<amdinfer::DataType, 4> kDataTypes = {
+  amdinfer::DataType::Uint8, amdinfer::DataType::Uint32,
+  amdinfer::DataType::Fp32, amdinfer::DataType::Fp64};
+// requests kept in flight at once
+const std::array<int, 3> kConcurrency = {1, 8, 32};
+const std::array<Batching, 3> kBatching = {Batching{1, 0}, Batching{8, 100},
+                                           Batching{32, 1000}};
+
+// requests sent by each iteration for each one in flight
+const int kRequestsPerSlot = 8;
+
+enum class Protocol { Native, Http, Grpc, WebSocket };
+
+/**
+ * @brief The Transport starts the server and connects a client with one
+ * protocol. The websocket client sends its requests as websocket messages and
+ * uses HTTP for everything else.
+ */
+struct Transport {
+  explicit Transport(Protocol protocol) {
+    [[maybe_unused]] const auto default_http_port = 8998;
+    [[maybe_unused]] const auto default_grpc_port = 50'051;
+
+    if (protocol == Protocol::Native) {
+      client = std::make_unique<amdinfer::NativeClient>(&server);
+#ifdef AMDINFER_ENABLE_HTTP
+    } else if (protocol == Protocol::Http) {
+      server.startHttp(default_http_port);
+      client = std::make_unique<amdinfer::HttpClient>("http://127.0.0.1:8998");
+    } else if (protocol == Protocol::WebSocket) {
+      server.startHttp(default_http_port);
+      auto ws_client = std::make_unique<amdinfer::WebSocketClient>(
+        "ws://127.0.0.1:8998", "http://127.0.0.1:8998",
+        amdinfer::WebSocketProtocol::Binary);
+      websocket = ws_client.get();
+      client = std::move(ws_client);
+#endif
+#ifdef AMDINFER_ENABLE_GRPC
+    } else if (protocol == Protocol::Grpc) {
+      server.startGrpc(default_grpc_port);
+      client = std::make_unique<amdinfer::GrpcClient>("127.0.0.1:50051");
+#endif
+    }
+    if (client != nullptr) {
+      amdinfer::waitUntilServerReady(client.get());
+    }
+  }
+
+  std::string load(const std::string& worker, const Batching& batching) const {
+    amdinfer::ParameterMap parameters;
+    parameters.put("batch_size", batching.batch_size);
+    parameters.put("timeout_us", batching.timeout_us);
+    parameters.put("share", false);
+    return client->workerLoad(worker, parameters);
+  }
+
+  void unload(const std::string& endpoint) const {
+    client->workerUnload(endpoint);
+    while (client->modelReady(endpoint)) {
+      std::this_thread::sleep_for(std::chrono::seconds(1));
+    }
+  }
+
+  /**
+   * @brief Send the request this many times, keeping up to concurrency
+   * requests in flight
+   *
+   * @return true if all the responses succeeded
+   */
+  [[nodiscard]] bool run(const std::string& endpoint,
+                         const amdinfer::InferenceRequest& request,
+                         int requests, int concurrency) const {
+    bool ok = true;
+    if (websocket != nullptr) {
+      // responses can only be received in order so count the ones in flight
+      int sent = 0;
+      int received = 0;
+      while (received < requests) {
+        while (sent < requests && sent - received < concurrency) {
+          websocket->modelInferWs(endpoint, request);
+          ++sent;
+        }
+        ok &= !websocket->modelRecvResponse().isError();
+        ++received;
+      }
+      return ok;
+    }
+
+    std::deque<amdinfer::InferenceResponseFuture> in_flight;
+    int sent = 0;
+    while (sent < requests || !in_flight.empty()) {
+      while (sent < requests &&
+             in_flight.size() < static_cast<size_t>(concurrency)) {
+        in_flight.push_back(client->modelInferAsync(endpoint, request));
+        ++sent;
+      }
+      ok &= !in_flight.front().get().isError();
+      in_flight.pop_front();
+    }
+    return ok;
+  }
+
+  amdinfer::Server server;
+  std::unique_ptr<amdinfer::Client> client;
+  amdinfer::WebSocketClient* websocket = nullptr;
+};
+
+void reportRates(benchmark::State& st, int requests, size_t bytes) {
+  const auto total = static_cast<int64_t>(st.iterations()) * requests;
+  st.SetItemsProcessed(total);
+  st.SetBytesProcessed(total * static_cast<int64_t>(bytes));
+  // the inverse of the request rate is the time spent on each request
+  st.counters["s_per_request"] = benchmark::Counter(
+    static_cast<double>(total),
+    benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+
+/**
+ * @brief Send one tensor of each size and datatype to the Echo worker. It only
+ * reads the first element so the time is spent on the transport and batching.
+ */
+void echo(benchmark::State& st, Protocol protocol) {
+  const auto bytes = kSizes.at(st.range(0));
+  const auto datatype = kDataTypes.at(st.range(1));
+  const auto concurrency = kConcurrency.at(st.range(2));
+  const auto& batching = kBatching.at(st.range(3));
+
+  Transport transport{protocol};
+  if (transport.client == nullptr) {
+    st.SkipWithError("Protocol not enabled in this build");
+    return;
+  }
+  const auto endpoint = transport.load("echo", batching);
+
+  const auto elements = std::max<size_t>(bytes / datatype.size(), 1);
+  std::vector<std::byte> data(elements * datatype.size());
+  amdinfer::InferenceRequest request;
+  request.addInputTensor(data.data(), {elements}, datatype);
+
+  const auto requests = concurrency * kRequestsPerSlot;
+  // warm up
+  std::ignore = transport.run(endpoint, request, concurrency, concurrency);
+
+  for (auto _ : st) {
+    if (!transport.run(endpoint, request, requests, concurrency)) {
+      st.SkipWithError("Error in response");
+      break;
+    }
+  }
+  reportRates(st, requests, data.size());
+  transport.unload(endpoint);
+}
+
+/**
+ * @brief Send requests with many tensors to the EchoMulti worker, whose
+ * tensors have a fixed shape, to measure the cost of each tensor and of the
+ * batched workers' scatter and gather
+ */
+void echoMulti(benchmark::State& st, Protocol protocol) {
+  const auto concurrency = kConcurrency.at(st.range(0));
+  const auto& batching = kBatching.at(st.range(1));
+
+  Transport transport{protocol};
+  if (transport.client == nullptr) {
+    st.SkipWithError("Protocol not enabled in this build");
+    return;
+  }
+  const auto endpoint = transport.load("echoMulti", batching);
+
+  const std::array<uint64_t, 2> lengths = {1, 2};
+  std::vector<std::vector<uint32_t>> data;
+  amdinfer::InferenceRequest request;
+  size_t bytes = 0;
+  for (const auto length : lengths) {
+    auto& tensor = data.emplace_back(length);
+    request.addInputTensor(tensor.data(), {length}, amdinfer::DataType::Uint32);
+    bytes += length * sizeof(uint32_t);
+  }
+
+  const auto requests = concurrency * kRequestsPerSlot;
+  // warm up
+  std::ignore = transport.run(endpoint, request, concurrency, concurrency);
+
+  for (auto _ : st) {
+    if (!transport.run(endpoint, request, requests, concurrency)) {
+      st.SkipWithError("Error in response");
+      break;
+    }
+  }
+  reportRates(st, requests, bytes);
+  transport.unload(endpoint);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp)
+const std::initializer_list<std::vector<int64_t>> kEchoRange{
+  benchmark::CreateDenseRange(0, kSizes.size() - 1, 1),
+  benchmark::CreateDenseRange(0, kDataTypes.size() - 1, 1),
+  benchmark::CreateDenseRange(0, kConcurrency.size() - 1, 1),
+  benchmark::CreateDenseRange(0, kBatching.size() - 1, 1)};
+
+// NOLINTNEXTLINE(cert-err58-cpp)
+const std::initializer_list<std::vector<int64_t>> kEchoMultiRange{
+  benchmark::CreateDenseRange(0, kConcurrency.size() - 1, 1),
+  benchmark::CreateDenseRange(0, kBatching.size() - 1, 1)};
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+BENCHMARK_CAPTURE(echo, Native, Protocol::Native)
+  ->ArgsProduct(kEchoRange)
+  ->Unit(benchmark::kMicrosecond);
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+BENCHMARK_CAPTURE(echoMulti, Native, Protocol::Native)
+  ->ArgsProduct(kEchoMultiRange)
+  ->Unit(benchmark::kMicrosecond);
+#ifdef AMDINFER_ENABLE_HTTP
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+BENCHMARK_CAPTURE(echo, HTTP, Protocol::Http)
+  ->ArgsProduct(kEchoRange)
+  ->Unit(benchmark::kMicrosecond);
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+BENCHMARK_CAPTURE(echoMulti, HTTP, Protocol::Http)
+  ->ArgsProduct(kEchoMultiRange)
+  ->Unit(benchmark::kMicrosecond);
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+BENCHMARK_CAPTURE(echo, WebSocket, Protocol::WebSocket)
+  ->ArgsProduct(kEchoRange)
+  ->Unit(benchmark::kMicrosecond);
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+BENCHMARK_CAPTURE(echoMulti, WebSocket, Protocol::WebSocket)
+  ->ArgsProduct(kEchoMultiRange)
+  ->Unit(benchmark::kMicrosecond);
+#endif
+#ifdef AMDINFER_ENABLE_GRPC
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+BENCHMARK_CAPTURE(echo, gRPC, Protocol::Grpc)
+  ->ArgsProduct(kEchoRange)
+  ->Unit(benchmark::kMicrosecond);
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+BENCHMARK_CAPTURE(echoMulti, gRPC, Protocol::Grpc)
+  ->ArgsProduct(kEchoMultiRange)
+  ->Unit(benchmark::kMicrosecond);
+#endif
+
+// NOLINTNEXTLINE
+BENCHMARK_MAIN();
@@ -0,0 +1,88 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Performance testing for the server's overhead over MIGraphX
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>                // for byte
+#include <cstdint>                // for uint64_t, int64_t
+#include <migraphx/migraphx.hpp>  // for program, parse_onnx, argument
+#include <tuple>                  // for ignore
+#include <vector>                 // for vector
+
+#include "amdinfer/amdinfer.hpp"                   // for InferenceRequest
+#include "amdinfer/testing/get_path_to_asset.hpp"  // for getPathToAsset
+#include "server_overhead.hpp"                     // for measureOverhead
+
+void migraphxWorker(benchmark::State& st, Protocol protocol) {
+  const auto batch_size = static_cast<int>(st.range(1));
+  const auto model = amdinfer::getPathToAsset("onnx_resnet50");
+
+  // the program is compiled the same way as in the worker, where MIGraphX
+  // copies the inputs and outputs to and from the GPU
+  migraphx::onnx_options onnx_options;
+  onnx_options.set_default_dim_value(batch_size);
+  auto program = migraphx::parse_onnx(model.c_str(), onnx_options);
+  migraphx::compile_options compile_options;
+  compile_options.set_offload_copy(true);
+  program.compile(migraphx::target("gpu"), compile_options);
+
+  // resnet50 has one fp32 input
+  auto shapes = program.get_parameter_shapes();
+  const auto* name = shapes.names().front();
+  const auto shape = shapes[name];
+  std::vector<std::byte> images(shape.bytes());
+  migraphx::program_parameters parameters;
+  parameters.add(name, migraphx::argument(shape, images.data()));
+  auto runtime = [&]() { std::ignore = program.eval(parameters); };
+
+  amdinfer::ParameterMap worker_parameters;
+  worker_parameters.put("model", model);
+  worker_parameters.put("batch", batch_size);
+  Served served{protocol, "migraphx", worker_parameters};
+
+  const auto lengths = shape.lengths();
+  std::vector<uint64_t> request_shape(lengths.begin() + 1, lengths.end());
+  amdinfer::InferenceRequest request;
+  request.addInputTensor(images.data(), request_shape,
+                         amdinfer::DataType::Fp32);
+  measureOverhead(st, runtime, batch_size, served, request);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp)
+const std::initializer_list<std::vector<int64_t>> kRange{{10}, {1, 4}};
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+BENCHMARK_CAPTURE(migraphxWorker, Native, Protocol::Native)
+  ->ArgsProduct(kRange)
+  ->Unit(benchmark::kMillisecond);
+#ifdef AMDINFER_ENABLE_HTTP
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+BENCHMARK_CAPTURE(migraphxWorker, HTTP, Protocol::Http)
+  ->ArgsProduct(kRange)
+  ->Unit(benchmark::kMillisecond);
+#endif
+#ifdef AMDINFER_ENABLE_GRPC
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+BENCHMARK_CAPTURE(migraphxWorker, gRPC, Protocol::Grpc)
+  ->ArgsProduct(kRange)
+  ->Unit(benchmark::kMillisecond);
+#endif
+
+// NOLINTNEXTLINE
+BENCHMARK_MAIN();
@@ -0,0 +1,87 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Performance testing for the server's overhead over TorchScript
+ */
+
+#include <benchmark/benchmark.h>
+#include <torch/script.h>  // for Module, IValue, load
+#include <torch/torch.h>   // for from_blob, NoGradGuard
+
+#include <cstdint>  // for int64_t
+#include <tuple>    // for ignore
+#include <vector>   // for vector
+
+#include "amdinfer/amdinfer.hpp"                   // for InferenceRequest
+#include "amdinfer/testing/get_path_to_asset.hpp"  // for getPathToAsset
+#include "server_overhead.hpp"                     // for measureOverhead
+
+void ptzendnn(benchmark::State& st, Protocol protocol) {
+  const auto batch_size = static_cast<int>(st.range(1));
+  const int64_t input_size = 224;
+  const int64_t channels = 3;
+  const auto model = amdinfer::getPathToAsset("pt_resnet50");
+
+  // the module is optimized the same way as in the worker
+  auto module = torch::jit::load(model, torch::kCPU);
+  module.eval();
+  module = torch::jit::optimize_for_inference(module);
+
+  const auto image_size = channels * input_size * input_size;
+  std::vector<float> images(batch_size * image_size);
+  auto runtime = [&]() {
+    torch::NoGradGuard no_grad;
+    c10::InferenceMode guard;
+    std::vector<torch::jit::IValue> inputs{torch::from_blob(
+      images.data(), {batch_size, channels, input_size, input_size},
+      torch::kF32)};
+    std::ignore = module.forward(inputs).toTensor().contiguous();
+  };
+
+  amdinfer::ParameterMap parameters;
+  parameters.put("model", model);
+  parameters.put("batch_size", batch_size);
+  parameters.put("input_size", static_cast<int>(input_size));
+  Served served{protocol, "ptzendnn", parameters};
+
+  amdinfer::InferenceRequest request;
+  request.addInputTensor(images.data(), {channels, input_size, input_size},
+                         amdinfer::DataType::Fp32);
+  measureOverhead(st, runtime, batch_size, served, request);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp)
+const std::initializer_list<std::vector<int64_t>> kRange{{10}, {1, 4}};
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+BENCHMARK_CAPTURE(ptzendnn, Native, Protocol::Native)
+  ->ArgsProduct(kRange)
+  ->Unit(benchmark::kMillisecond);
+#ifdef AMDINFER_ENABLE_HTTP
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+BENCHMARK_CAPTURE(ptzendnn, HTTP, Protocol::Http)
+  ->ArgsProduct(kRange)
+  ->Unit(benchmark::kMillisecond);
+#endif
+#ifdef AMDINFER_ENABLE_GRPC
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+BENCHMARK_CAPTURE(ptzendnn, gRPC, Protocol::Grpc)
+  ->ArgsProduct(kRange)
+  ->Unit(benchmark::kMillisecond);
+#endif
+
+// NOLINTNEXTLINE
+BENCHMARK_MAIN();
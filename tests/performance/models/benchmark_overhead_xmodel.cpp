@@ -0,0 +1,107 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Performance testing for the server's overhead over a VART runner
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>                 // for byte
+#include <cstdint>                 // for uint64_t, int64_t, uint32_t
+#include <memory>                  // for unique_ptr
+#include <string>                  // for string
+#include <vart/runner.hpp>         // for Runner
+#include <vart/runner_ext.hpp>     // for RunnerExt
+#include <vector>                  // for vector
+#include <xir/graph/graph.hpp>     // for Graph
+#include <xir/graph/subgraph.hpp>  // for Subgraph
+#include <xir/tensor/tensor.hpp>   // for Tensor
+
+#include "amdinfer/amdinfer.hpp"                   // for InferenceRequest
+#include "amdinfer/core/data_types_internal.hpp"   // for mapXirToType
+#include "amdinfer/testing/get_path_to_asset.hpp"  // for getPathToAsset
+#include "server_overhead.hpp"                     // for measureOverhead
+
+const xir::Subgraph* getDpuSubgraph(const xir::Graph* graph) {
+  for (const auto* subgraph :
+       graph->get_root_subgraph()->children_topological_sort()) {
+    if (subgraph->has_attr("device") &&
+        subgraph->get_attr<std::string>("device") == "DPU") {
+      return subgraph;
+    }
+  }
+  return nullptr;
+}
+
+void xmodel(benchmark::State& st, Protocol protocol) {
+  const auto model = amdinfer::getPathToAsset("u250_resnet50");
+
+  // the runner runs the model's first DPU subgraph, as the worker does for a
+  // model with one
+  const auto graph = xir::Graph::deserialize(model);
+  const auto* subgraph = getDpuSubgraph(graph.get());
+  if (subgraph == nullptr) {
+    st.SkipWithError("No DPU subgraph found in the model");
+    return;
+  }
+  auto runner = vart::Runner::create_runner(subgraph, "run");
+  auto* runner_ext = dynamic_cast<vart::RunnerExt*>(runner.get());
+  auto inputs = runner_ext->get_inputs();
+  auto outputs = runner_ext->get_outputs();
+  auto runtime = [&]() {
+    const auto job = runner_ext->execute_async(inputs, outputs);
+    runner_ext->wait(static_cast<int>(job.first), -1);
+  };
+
+  // each run is one batch of the DPU's batch size
+  const auto* tensor = runner->get_input_tensors().front();
+  const auto shape = tensor->get_shape();
+  const auto batch_size = shape.front();
+  const auto datatype = amdinfer::mapXirToType(tensor->get_data_type());
+  std::vector<uint64_t> request_shape(shape.begin() + 1, shape.end());
+  std::vector<std::byte> image(tensor->get_data_size() / batch_size);
+
+  amdinfer::ParameterMap parameters;
+  parameters.put("model", model);
+  Served served{protocol, "xmodel", parameters};
+
+  amdinfer::InferenceRequest request;
+  request.addInputTensor(image.data(), request_shape, datatype);
+  measureOverhead(st, runtime, batch_size, served, request);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp)
+const std::initializer_list<std::vector<int64_t>> kRange{{10}};
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+BENCHMARK_CAPTURE(xmodel, Native, Protocol::Native)
+  ->ArgsProduct(kRange)
+  ->Unit(benchmark::kMillisecond);
+#ifdef AMDINFER_ENABLE_HTTP
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+BENCHMARK_CAPTURE(xmodel, HTTP, Protocol::Http)
+  ->ArgsProduct(kRange)
+  ->Unit(benchmark::kMillisecond);
+#endif
+#ifdef AMDINFER_ENABLE_GRPC
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+BENCHMARK_CAPTURE(xmodel, gRPC, Protocol::Grpc)
+  ->ArgsProduct(kRange)
+  ->Unit(benchmark::kMillisecond);
+#endif
+
+// NOLINTNEXTLINE
+BENCHMARK_MAIN();
@@ -0,0 +1,174 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Measures how much time the server adds to a backend's own runtime
+ */
+
+#ifndef GUARD_TESTS_PERFORMANCE_MODELS_SERVER_OVERHEAD
+#define GUARD_TESTS_PERFORMANCE_MODELS_SERVER_OVERHEAD
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>      // for duration, steady_clock
+#include <functional>  // for function
+#include <memory>      // for unique_ptr, make_unique
+#include <ratio>       // for milli
+#include <string>      // for string
+#include <thread>      // for sleep_for
+#include <tuple>       // for ignore
+#include <vector>      // for vector
+
+#include "amdinfer/amdinfer.hpp"  // for InferenceRequest
+
+enum class Protocol { Native, Http, Grpc };
+
+/// Runs one batch of inference directly with the backend's runtime
+using Runtime = std::function<void()>;
+
+/**
+ * @brief The Served endpoint is a worker loaded in a server with a native
+ * client and, for the other protocols, a client that goes through the network
+ */
+struct Served {
+  Served(Protocol protocol, const std::string& worker,
+         const amdinfer::ParameterMap& parameters) {
+    [[maybe_unused]] const auto default_http_port = 8998;
+    [[maybe_unused]] const auto default_grpc_port = 50'051;
+
+    native = std::make_unique<amdinfer::NativeClient>(&server);
+    if (protocol == Protocol::Native) {
+      client = native.get();
+#ifdef AMDINFER_ENABLE_HTTP
+    } else if (protocol == Protocol::Http) {
+      server.startHttp(default_http_port);
+      remote = std::make_unique<amdinfer::HttpClient>("http://127.0.0.1:8998");
+      client = remote.get();
+#endif
+#ifdef AMDINFER_ENABLE_GRPC
+    } else if (protocol == Protocol::Grpc) {
+      server.startGrpc(default_grpc_port);
+      remote = std::make_unique<amdinfer::GrpcClient>("127.0.0.1:50051");
+      client = remote.get();
+#endif
+    }
+    if (client != nullptr) {
+      amdinfer::waitUntilServerReady(client);
+      endpoint = native->workerLoad(worker, parameters);
+    }
+  }
+  Served(const Served&) = delete;
+  Served& operator=(const Served&) = delete;
+  Served(Served&&) = delete;
+  Served& operator=(Served&&) = delete;
+
+  ~Served() {
+    if (endpoint.empty()) {
+      return;
+    }
+    native->workerUnload(endpoint);
+    while (native->modelReady(endpoint)) {
+      std::this_thread::sleep_for(std::chrono::seconds(1));
+    }
+  }
+
+  amdinfer::Server server;
+  std::unique_ptr<amdinfer::NativeClient> native;
+  std::unique_ptr<amdinfer::Client> remote;
+  amdinfer::Client* client = nullptr;
+  std::string endpoint;
+};
+
+/**
+ * @brief Run the same batches directly with the runtime, through the server
+ * with the native client and then with the chosen protocol's client, one batch
+ * at a time so the time of each stage is what it adds to the one before it.
+ * Each batch is sent to the server as that many requests at once. The
+ * counters report the milliseconds per request spent in the runtime, added by
+ * the server (queuing, batching and the worker's copies) and added by the
+ * protocol (serialization and the network).
+ *
+ * @param st the benchmark state
+ * @param runtime runs one batch directly
+ * @param batch_size the requests in each of the runtime's batches, which the
+ * worker should be loaded to batch as well
+ * @param served the worker to compare against
+ * @param request the request to send, with the same inputs as the runtime's
+ */
+inline void measureOverhead(benchmark::State& st, const Runtime& runtime,
+                            int batch_size, const Served& served,
+                            const amdinfer::InferenceRequest& request) {
+  if (served.client == nullptr) {
+    st.SkipWithError("Protocol not enabled in this build");
+    return;
+  }
+
+  const auto batches = st.range(0);
+  const auto warmup_requests = 4;
+  for (auto i = 0; i < warmup_requests; ++i) {
+    runtime();
+    std::ignore = served.native->modelInfer(served.endpoint, request);
+    std::ignore = served.client->modelInfer(served.endpoint, request);
+  }
+
+  using Clock = std::chrono::steady_clock;
+  using Milliseconds = std::chrono::duration<double, std::milli>;
+  // time the batches through one client, returning false on an error
+  std::vector<amdinfer::InferenceResponseFuture> futures(batch_size);
+  auto send = [&](const amdinfer::Client* client, Milliseconds* time) {
+    bool ok = true;
+    const auto start = Clock::now();
+    for (auto i = 0; i < batches; ++i) {
+      for (auto& future : futures) {
+        future = client->modelInferAsync(served.endpoint, request);
+      }
+      for (auto& future : futures) {
+        ok &= !future.get().isError();
+      }
+    }
+    *time += Clock::now() - start;
+    return ok;
+  };
+
+  Milliseconds runtime_time{0};
+  Milliseconds native_time{0};
+  Milliseconds client_time{0};
+  const auto remote = served.client != served.native.get();
+  for (auto _ : st) {
+    const auto start = Clock::now();
+    for (auto i = 0; i < batches; ++i) {
+      runtime();
+    }
+    runtime_time += Clock::now() - start;
+
+    if (!send(served.native.get(), &native_time) ||
+        (remote && !send(served.client, &client_time))) {
+      st.SkipWithError("Error in response");
+      break;
+    }
+  }
+  if (!remote) {
+    client_time = native_time;
+  }
+
+  const auto total =
+    static_cast<double>(st.iterations() * batches * batch_size);
+  st.counters["runtime_ms"] = runtime_time.count() / total;
+  st.counters["server_ms"] = (native_time - runtime_time).count() / total;
+  st.counters["protocol_ms"] = (client_time - native_time).count() / total;
+  st.counters["overhead_ms"] = (client_time - runtime_time).count() / total;
+}
+
+#endif  // GUARD_TESTS_PERFORMANCE_MODELS_SERVER_OVERHEAD
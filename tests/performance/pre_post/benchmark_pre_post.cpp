@@ -0,0 +1,147 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Benchmarks the pre- and post-processing kernels against their scalar
+ * versions
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <array>             // for array
+#include <cstddef>           // for size_t
+#include <cstdint>           // for uint8_t, int64_t
+#include <initializer_list>  // for initializer_list
+#include <vector>            // for vector
+
+#include "amdinfer/pre_post/get_top_k.hpp"  // for getTopK
+#include "amdinfer/pre_post/normalize.hpp"  // for normalize, ImageOrder
+#include "amdinfer/pre_post/softmax.hpp"    // for softmax, softmaxScalar
+
+namespace amdinfer::pre_post {
+
+namespace {
+
+constexpr auto kChannels = 3;
+constexpr std::array<float, kChannels> kMean{0.485F, 0.456F, 0.406F};
+constexpr std::array<float, kChannels> kStd{4.367F, 4.464F, 4.444F};
+constexpr auto kScale = 1.0F / 255;
+
+/// The image of the first argument's size in pixels
+std::vector<uint8_t> makeImage(int64_t pixels) {
+  std::vector<uint8_t> image(pixels * kChannels);
+  for (size_t i = 0; i < image.size(); ++i) {
+    image[i] = static_cast<uint8_t>(i);
+  }
+  return image;
+}
+
+/// The scores of the first argument's number of classes
+std::vector<float> makeScores(int64_t classes) {
+  std::vector<float> scores(classes);
+  for (size_t i = 0; i < scores.size(); ++i) {
+    // spread the scores out so the order isn't trivial
+    constexpr auto kPrime = 7919;
+    scores[i] = static_cast<float>((i * kPrime) % classes) / 100;
+  }
+  return scores;
+}
+
+/// Normalize an image with the fastest kernel the CPU supports
+void normalizeImage(benchmark::State& state) {
+  const auto pixels = static_cast<size_t>(state.range(0));
+  const auto order = static_cast<ImageOrder>(state.range(1));
+  const auto image = makeImage(state.range(0));
+  std::vector<float> output(image.size());
+  for ([[maybe_unused]] auto _ : state) {
+    normalize(image.data(), pixels, order, kScale, kMean.data(), kStd.data(),
+              output.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(image.size()));
+}
+
+/// Normalize an image one element at a time
+void normalizeImageScalar(benchmark::State& state) {
+  const auto pixels = static_cast<size_t>(state.range(0));
+  const auto order = static_cast<ImageOrder>(state.range(1));
+  const auto image = makeImage(state.range(0));
+  const detail::NormalizeFactors factors{kScale, kMean.data(), kStd.data()};
+  std::vector<float> output(image.size());
+  for ([[maybe_unused]] auto _ : state) {
+    detail::normalizeScalar(image.data(), pixels, order, factors,
+                            output.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(image.size()));
+}
+
+/// Compute the softmax of scores with the fastest kernel the CPU supports
+void softmaxScores(benchmark::State& state) {
+  const auto scores = makeScores(state.range(0));
+  std::vector<float> output(scores.size());
+  for ([[maybe_unused]] auto _ : state) {
+    softmax(scores.data(), scores.size(), output.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/// Compute the softmax of scores one element at a time
+void softmaxScoresScalar(benchmark::State& state) {
+  const auto scores = makeScores(state.range(0));
+  std::vector<float> output(scores.size());
+  for ([[maybe_unused]] auto _ : state) {
+    detail::softmaxScalar(scores.data(), scores.size(), output.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/// Get the indices of the top k scores
+void topK(benchmark::State& state) {
+  const auto scores = makeScores(state.range(0));
+  const auto k = static_cast<int>(state.range(1));
+  for ([[maybe_unused]] auto _ : state) {
+    benchmark::DoNotOptimize(getTopK(scores.data(), scores.size(), k));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+}  // namespace
+
+// 224x224 is the input of ResNet50 and 1920x1080 a full HD frame
+const std::initializer_list<int64_t> kPixels{224 * 224, 1920 * 1080};
+const std::initializer_list<int64_t> kOrders{
+  static_cast<int64_t>(ImageOrder::NHWC),
+  static_cast<int64_t>(ImageOrder::NCHW)};
+// 1000 is the number of classes of ImageNet
+const std::initializer_list<int64_t> kClasses{10, 1000, 1 << 16};
+const std::initializer_list<int64_t> kTopK{1, 5};
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+BENCHMARK(normalizeImage)->ArgsProduct({kPixels, kOrders});
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+BENCHMARK(normalizeImageScalar)->ArgsProduct({kPixels, kOrders});
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+BENCHMARK(softmaxScores)->ArgsProduct({kClasses});
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+BENCHMARK(softmaxScoresScalar)->ArgsProduct({kClasses});
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+BENCHMARK(topK)->ArgsProduct({kClasses, kTopK});
+
+}  // namespace amdinfer::pre_post
@@ -0,0 +1,99 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Benchmarks parsing JSON inference requests with and without the
+ * tensor data in the JSON DOM
+ */
+
+#include <benchmark/benchmark.h>
+#include <json/reader.h>  // for CharReaderBuilder, CharReader
+#include <json/value.h>   // for Value
+
+#include <cstdint>           // for int64_t
+#include <initializer_list>  // for initializer_list
+#include <memory>            // for unique_ptr
+#include <string>            // for string, to_string
+#include <string_view>       // for string_view
+#include <vector>            // for vector
+
+#include "amdinfer/buffers/cpu.hpp"          // for CpuBuffer
+#include "amdinfer/core/data_types.hpp"      // for DataType
+#include "amdinfer/servers/http_parser.hpp"  // for parseJsonRequest
+
+namespace amdinfer {
+
+namespace {
+
+/// Get the body of a request with one input of the first argument's number of
+/// floats
+std::string makeBody(int64_t elements) {
+  std::string body = R"({"id": "benchmark", "inputs": [{"name": "input", )";
+  body += R"("datatype": "FP32", "shape": [)" + std::to_string(elements);
+  body += R"(], "data": [)";
+  for (auto i = 0; i < elements; ++i) {
+    if (i > 0) {
+      body += ", ";
+    }
+    body += std::to_string(i) + ".5";
+  }
+  body += "]}]}";
+  return body;
+}
+
+/// Parse the whole request into a JSON DOM, as the server did before the
+/// parser was added. The data would still have to be copied out of the DOM
+void parseDom(benchmark::State& state) {
+  const auto body = makeBody(state.range(0));
+  Json::CharReaderBuilder builder;
+  const std::unique_ptr<Json::CharReader> reader{builder.newCharReader()};
+
+  for ([[maybe_unused]] auto _ : state) {
+    Json::Value json;
+    std::string errors;
+    reader->parse(body.data(), body.data() + body.size(), &json, &errors);
+    benchmark::DoNotOptimize(json);
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(body.size()));
+}
+
+/// Parse the request without its data and then parse the data into a buffer
+void parseRequest(benchmark::State& state) {
+  const auto body = makeBody(state.range(0));
+  std::vector<float> data(state.range(0));
+  CpuBuffer buffer{data.data(), MemoryAllocators::Cpu,
+                   data.size() * sizeof(float)};
+
+  for ([[maybe_unused]] auto _ : state) {
+    std::vector<std::string_view> text;
+    auto json = parseJsonRequest(body, &text);
+    benchmark::DoNotOptimize(json);
+    benchmark::DoNotOptimize(parseJsonArray(text[0], DataType::Fp32, &buffer));
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(body.size()));
+}
+
+}  // namespace
+
+const std::initializer_list<int64_t> kElements{1, 1 << 10, 1 << 16};
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+BENCHMARK(parseDom)->ArgsProduct({kElements});
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+BENCHMARK(parseRequest)->ArgsProduct({kElements});
+
+}  // namespace amdinfer
@@ -0,0 +1,93 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Benchmarks the base64 kernels against the scalar code
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>           // for int64_t
+#include <initializer_list>  // for initializer_list
+#include <string>            // for string
+
+#include "amdinfer/util/base64.hpp"  // for base64Decode, base64Encode
+
+namespace amdinfer::util {
+
+namespace {
+
+using detail::Base64Kernel;
+
+/// Get the second argument's kernel, skipping the run if the CPU lacks it
+bool getKernel(benchmark::State& state, Base64Kernel* kernel) {
+  *kernel = static_cast<Base64Kernel>(state.range(1));
+  if (*kernel > detail::getBase64Kernel()) {
+    state.SkipWithError("The CPU doesn't support this kernel");
+    return false;
+  }
+  return true;
+}
+
+/// The first argument's number of bytes, like an encoded frame
+std::string makeData(int64_t size) {
+  std::string data(size, '\0');
+  for (auto i = 0; i < size; ++i) {
+    data[i] = static_cast<char>(i * i);
+  }
+  return data;
+}
+
+void encode(benchmark::State& state) {
+  Base64Kernel kernel{};
+  if (!getKernel(state, &kernel)) {
+    return;
+  }
+  const auto data = makeData(state.range(0));
+  for ([[maybe_unused]] auto _ : state) {
+    auto encoded = detail::base64Encode(data.data(), data.size(), kernel);
+    benchmark::DoNotOptimize(encoded);
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void decode(benchmark::State& state) {
+  Base64Kernel kernel{};
+  if (!getKernel(state, &kernel)) {
+    return;
+  }
+  const auto encoded = base64Encode(makeData(state.range(0)));
+  for ([[maybe_unused]] auto _ : state) {
+    auto decoded = detail::base64Decode(encoded.data(), encoded.size(), kernel);
+    benchmark::DoNotOptimize(decoded);
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+}  // namespace
+
+// from a small image to a large JPEG frame
+const std::initializer_list<int64_t> kSizes{1 << 10, 1 << 16, 1 << 20};
+const std::initializer_list<int64_t> kKernels{
+  static_cast<int64_t>(Base64Kernel::Scalar),
+  static_cast<int64_t>(Base64Kernel::Avx2),
+  static_cast<int64_t>(Base64Kernel::Avx512Vbmi)};
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+BENCHMARK(encode)->ArgsProduct({kSizes, kKernels});
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+BENCHMARK(decode)->ArgsProduct({kSizes, kKernels});
+
+}  // namespace amdinfer::util
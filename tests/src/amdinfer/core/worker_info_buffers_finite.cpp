@@ -35,8 +35,11 @@
 
 namespace amdinfer {
 
-WorkerInfo::WorkerInfo(const std::string& name, ParameterMap* parameters,
-                       MemoryPool* pool) {
+WorkerInfo::WorkerInfo(const std::string& endpoint, const std::string& name,
+                       ParameterMap* parameters, MemoryPool* pool,
+                       size_t instances) {
+  (void)endpoint;
+  (void)instances;
   this->batch_size_ = 1;
 
   this->addAndStartWorker(name, parameters, pool);
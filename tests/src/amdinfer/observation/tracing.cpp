@@ -60,6 +60,28 @@ StringMap Trace::propagate() { return StringMap(); }
 
 void Trace::endTrace() {}
 
+// NOLINTNEXTLINE(readability-convert-member-functions-to-static)
+trace_api::SpanContext Trace::getContext() const {
+  return trace_api::SpanContext::GetInvalid();
+}
+
+void Trace::tailSample(
+  [[maybe_unused]] InferenceRequest* request,
+  [[maybe_unused]] std::optional<std::chrono::milliseconds> latency) {}
+
+BatchTrace::BatchTrace(const char* name, const std::vector<TracePtr>& traces) {
+  (void)name;
+  (void)traces;
+}
+
+BatchTrace::~BatchTrace() = default;
+
+void BatchTrace::setAttribute(
+  [[maybe_unused]] nostd::string_view key,
+  [[maybe_unused]] const opentelemetry::common::AttributeValue& value) {}
+
+void BatchTrace::end() {}
+
 TracePtr startTrace(const char* name) { return std::make_unique<Trace>(name); }
 
 TracePtr startTrace(const char* name,
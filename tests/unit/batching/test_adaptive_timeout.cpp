@@ -0,0 +1,84 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>  // for milliseconds
+
+#include "amdinfer/batching/adaptive_timeout.hpp"  // for AdaptiveTimeout
+#include "amdinfer/util/timer.hpp"                 // for getTime, TimePoint
+#include "gtest/gtest.h"                           // for Test, EXPECT_EQ
+
+namespace amdinfer {
+
+constexpr auto kLatencySlo = 50.0;
+constexpr auto kMaxTimeout = 100.0;
+
+void addArrivals(AdaptiveTimeout* timeout, int count,
+                 std::chrono::milliseconds gap) {
+  auto time = util::getTime();
+  for (auto i = 0; i < count; ++i) {
+    timeout->recordArrival(time);
+    time += gap;
+  }
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitAdaptiveTimeout, NoHistory) {
+  AdaptiveTimeout timeout{kLatencySlo, kMaxTimeout};
+
+  // with no history, wait as long as the SLO allows
+  EXPECT_DOUBLE_EQ(timeout.getTimeout(4), kLatencySlo);
+  // the batch is always full with a batch size of 1
+  EXPECT_DOUBLE_EQ(timeout.getTimeout(1), 0);
+
+  AdaptiveTimeout capped{kLatencySlo, kLatencySlo / 2};
+  EXPECT_DOUBLE_EQ(capped.getTimeout(4), kLatencySlo / 2);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitAdaptiveTimeout, HeavyTraffic) {
+  AdaptiveTimeout timeout{kLatencySlo, kMaxTimeout};
+  addArrivals(&timeout, 10, std::chrono::milliseconds{2});
+
+  // wait for the batch to fill with some margin
+  const auto wait = timeout.getTimeout(4);
+  EXPECT_GE(wait, 3 * 2);
+  EXPECT_LT(wait, kLatencySlo);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitAdaptiveTimeout, LightTraffic) {
+  AdaptiveTimeout timeout{kLatencySlo, kMaxTimeout};
+  addArrivals(&timeout, 10, std::chrono::milliseconds{200});
+
+  // no other request is expected within the SLO so don't wait
+  EXPECT_DOUBLE_EQ(timeout.getTimeout(4), 0);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitAdaptiveTimeout, ServiceTime) {
+  AdaptiveTimeout timeout{kLatencySlo, kMaxTimeout};
+  addArrivals(&timeout, 10, std::chrono::milliseconds{10});
+
+  // the service time eats into the time left to wait for the batch
+  timeout.recordService(kLatencySlo - 30);
+  EXPECT_DOUBLE_EQ(timeout.getTimeout(8), 30);
+
+  // not enough time left for another request to arrive
+  AdaptiveTimeout slow{kLatencySlo, kMaxTimeout};
+  addArrivals(&slow, 10, std::chrono::milliseconds{10});
+  slow.recordService(kLatencySlo - 5);
+  EXPECT_DOUBLE_EQ(slow.getTimeout(8), 0);
+}
+
+}  // namespace amdinfer
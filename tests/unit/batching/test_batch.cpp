@@ -0,0 +1,98 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <array>    // for array
+#include <cstddef>  // for byte
+#include <memory>   // for make_shared, make_unique
+#include <utility>  // for move
+#include <vector>   // for vector
+
+#include "amdinfer/batching/batch.hpp"       // for Batch, BatchFreeList
+#include "amdinfer/buffers/cpu.hpp"          // for CpuBuffer
+#include "amdinfer/core/request_timing.hpp"  // for RequestTiming
+#include "gtest/gtest.h"                     // for Test, EXPECT_EQ
+
+namespace amdinfer {
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitBatch, Recycle) {
+  auto free_list = std::make_shared<BatchFreeList>(1);
+  auto batch = free_list->get();
+  const auto* address = batch.get();
+
+  int completed = 0;
+  batch->addCompletionCallback([&completed]() { completed++; });
+  batch->addTiming(std::make_shared<RequestTiming>());
+  std::vector<std::byte> data(4);
+  batch->addInputBuffer(
+    std::make_unique<CpuBuffer>(data.data(), MemoryAllocators::Cpu, 4));
+
+  std::vector<const void*> released;
+  batch->releaseInputBuffers(
+    [&released](BufferPtr buffer) { released.push_back(buffer->data(0)); });
+  ASSERT_EQ(released.size(), 1);
+  EXPECT_EQ(released[0], data.data());
+  EXPECT_EQ(batch->getInputSize(), 0);
+
+  // recycling a batch finishes it like destroying it would
+  Batch::recycle(std::move(batch));
+  EXPECT_EQ(completed, 1);
+
+  auto reused = free_list->get();
+  EXPECT_EQ(reused.get(), address);
+  EXPECT_TRUE(reused->empty());
+  EXPECT_TRUE(reused->getTimings().empty());
+
+  // the list keeps at most its capacity and destroys the rest
+  auto extra = free_list->get();
+  EXPECT_NE(extra.get(), address);
+  Batch::recycle(std::move(reused));
+  Batch::recycle(std::move(extra));
+  EXPECT_EQ(free_list->get().get(), address);
+
+  // batches that aren't from a free list are destroyed
+  auto standalone = std::make_unique<Batch>();
+  standalone->addCompletionCallback([&completed]() { completed++; });
+  Batch::recycle(std::move(standalone));
+  EXPECT_EQ(completed, 2);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitBatch, ContiguousInput) {
+  std::array<float, 4> data{};
+  const auto bytes = data.size() * sizeof(float);
+
+  Batch batch;
+  batch.addInputBuffer(
+    std::make_unique<CpuBuffer>(data.data(), MemoryAllocators::Cpu, bytes));
+  EXPECT_EQ(batch.getContiguousInput(bytes), data.data());
+
+  // segments are contiguous if each one starts where the last one ended
+  Batch segmented;
+  segmented.addSegment(0, {data.data(), bytes / 2});
+  segmented.addSegment(0, {&data[2], bytes / 2});
+  EXPECT_EQ(segmented.getContiguousInput(bytes), data.data());
+  EXPECT_EQ(segmented.getContiguousInput(bytes / 2), nullptr);
+
+  Batch gapped;
+  gapped.addSegment(0, {data.data(), sizeof(float)});
+  gapped.addSegment(0, {&data[2], sizeof(float)});
+  EXPECT_EQ(gapped.getContiguousInput(bytes / 2), nullptr);
+
+  // the segments of two inputs don't make up one tensor
+  segmented.addSegment(1, {data.data(), bytes});
+  EXPECT_EQ(segmented.getContiguousInput(bytes), nullptr);
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,145 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>   // for make_unique
+#include <thread>   // for thread
+#include <utility>  // for move
+#include <vector>   // for vector
+
+#include "amdinfer/batching/batch.hpp"        // for Batch, BatchPtr
+#include "amdinfer/batching/batch_queue.hpp"  // for BatchQueue
+#include "amdinfer/buffers/buffer.hpp"        // for Buffer
+#include "amdinfer/core/request_timing.hpp"   // for RequestTiming
+#include "gtest/gtest.h"                      // for Test, EXPECT_EQ
+
+namespace amdinfer {
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitBatchQueue, Standalone) {
+  BatchQueue queue;
+  BatchPtr batch;
+  EXPECT_FALSE(queue.try_dequeue(batch));
+  EXPECT_FALSE(queue.wait_dequeue_timed(batch, 1));
+
+  auto expected = std::make_unique<Batch>();
+  const auto* address = expected.get();
+  queue.enqueue(std::move(expected));
+  EXPECT_EQ(queue.size_approx(), 1);
+  queue.wait_dequeue(batch);
+  EXPECT_EQ(batch.get(), address);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitBatchQueue, OwnQueueFirst) {
+  BatchQueue queue_0;
+  BatchQueue queue_1;
+  BatchQueue::share({&queue_0, &queue_1});
+
+  auto batch_0 = std::make_unique<Batch>();
+  auto batch_1 = std::make_unique<Batch>();
+  const auto* address_0 = batch_0.get();
+  const auto* address_1 = batch_1.get();
+  queue_0.enqueue(std::move(batch_0));
+  queue_1.enqueue(std::move(batch_1));
+
+  BatchPtr batch;
+  ASSERT_TRUE(queue_1.try_dequeue(batch));
+  EXPECT_EQ(batch.get(), address_1);
+  ASSERT_TRUE(queue_1.try_dequeue(batch));
+  EXPECT_EQ(batch.get(), address_0);
+  EXPECT_FALSE(queue_0.try_dequeue(batch));
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitBatchQueue, Steal) {
+  BatchQueue queue_0;
+  BatchQueue queue_1;
+  BatchQueue::share({&queue_0, &queue_1});
+
+  // a consumer blocked on an empty queue is woken up by its neighbour's batch
+  BatchPtr batch;
+  std::thread consumer{[&] { queue_1.wait_dequeue(batch); }};
+  auto expected = std::make_unique<Batch>();
+  const auto* address = expected.get();
+  queue_0.enqueue(std::move(expected));
+  consumer.join();
+
+  EXPECT_EQ(batch.get(), address);
+  EXPECT_EQ(queue_0.size_approx(), 0);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitBatchQueue, Activity) {
+  BatchQueue queue;
+  std::vector<double> periods;
+  queue.trackActivity(
+    [&periods](double seconds) { periods.push_back(seconds); });
+
+  // overlapping batches make one busy period that ends with the last one
+  queue.enqueue(std::make_unique<Batch>());
+  queue.enqueue(std::make_unique<Batch>());
+  BatchPtr batch_0;
+  BatchPtr batch_1;
+  queue.wait_dequeue(batch_0);
+  queue.wait_dequeue(batch_1);
+  batch_0.reset();
+  EXPECT_TRUE(periods.empty());
+  batch_1.reset();
+  ASSERT_EQ(periods.size(), 1);
+  EXPECT_GE(periods[0], 0);
+
+  // the nullptr used to stop consumers doesn't count
+  queue.enqueue(nullptr);
+  queue.wait_dequeue(batch_0);
+  EXPECT_EQ(periods.size(), 1);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitBatchQueue, InFlight) {
+  // batches in flight are counted even if the activity isn't tracked
+  BatchQueue queue;
+  queue.enqueue(std::make_unique<Batch>());
+  queue.enqueue(std::make_unique<Batch>());
+  EXPECT_EQ(queue.inFlight(), 0);
+
+  BatchPtr batch_0;
+  BatchPtr batch_1;
+  queue.wait_dequeue(batch_0);
+  queue.wait_dequeue(batch_1);
+  EXPECT_EQ(queue.inFlight(), 2);
+  batch_0.reset();
+  EXPECT_EQ(queue.inFlight(), 1);
+  batch_1.reset();
+  EXPECT_EQ(queue.inFlight(), 0);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitBatchQueue, Timing) {
+  BatchQueue queue;
+  auto timing = std::make_shared<RequestTiming>();
+  auto expected = std::make_unique<Batch>();
+  expected->addRequest(nullptr);
+  expected->addRequest(nullptr);
+  expected->addTiming(timing);
+  queue.enqueue(std::move(expected));
+  EXPECT_EQ(timing->taken, util::TimePoint{});
+
+  // the timing is filled in as the batch is taken
+  BatchPtr batch;
+  queue.wait_dequeue(batch);
+  EXPECT_NE(timing->taken, util::TimePoint{});
+  EXPECT_EQ(timing->batch_size, 2);
+}
+
+}  // namespace amdinfer
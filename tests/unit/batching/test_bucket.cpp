@@ -0,0 +1,186 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>  // for uint8_t
+#include <memory>   // for make_shared, make_unique
+#include <string>   // for string
+#include <utility>  // for move
+#include <vector>   // for vector
+
+#include "amdinfer/batching/bucket.hpp"          // for BucketBatcher
+#include "amdinfer/buffers/buffer.hpp"           // for Buffer
+#include "amdinfer/core/data_types.hpp"          // for DataType
+#include "amdinfer/core/exceptions.hpp"          // for invalid_argument
+#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/core/memory_pool/pool.hpp"    // for MemoryPool
+#include "amdinfer/core/parameters.hpp"          // for ParameterMap
+#include "amdinfer/core/request_container.hpp"   // for RequestContainer
+#include "gtest/gtest.h"                         // for Test, EXPECT_EQ
+
+namespace amdinfer {
+
+// timeout in us to read from the batcher
+constexpr auto kTimeoutUs = 1'000'000;
+
+class UnitBucketBatcher : public testing::Test {
+ protected:
+  void SetUp() override {
+    ParameterMap parameters;
+    parameters.put("buckets", "4,8");
+    // the short bucket waits so the test can fill it without a race
+    parameters.put("bucket_timeouts", "60000,1");
+    batcher_ = std::make_unique<BucketBatcher>(&pool_, &parameters);
+    batcher_->setName("test");
+    batcher_->setBatchSize(2);
+  }
+
+  // the requests are enqueued before starting so they're seen together
+  void start() { batcher_->start({MemoryAllocators::Cpu}); }
+
+  void TearDown() override {
+    batcher_->enqueue(nullptr);
+    batcher_->end();
+  }
+
+  // each request's data counts up from its first value
+  void enqueue(const std::string& id, const std::vector<uint64_t>& shape,
+               uint8_t first) {
+    InferenceRequestInput input{nullptr, shape, DataType::Uint8};
+    auto& buffer =
+      ingress_.emplace_back(pool_.get({MemoryAllocators::Cpu}, input, 1));
+    for (auto i = 0U; i < input.getSize(); ++i) {
+      buffer->write(static_cast<uint8_t>(first + i), i);
+    }
+
+    auto request = std::make_shared<InferenceRequest>();
+    request->setID(id);
+    request->addInputTensor(buffer->data(0), shape, DataType::Uint8);
+    request->setCallback([this, id](const InferenceResponse& response) {
+      if (response.isError()) {
+        errors_.push_back(id);
+      }
+    });
+    auto container = std::make_unique<RequestContainer>();
+    container->request = std::move(request);
+    batcher_->enqueue(std::move(container));
+  }
+
+  BatchPtr next() {
+    BatchPtr batch;
+    EXPECT_TRUE(
+      batcher_->getOutputQueue()->wait_dequeue_timed(batch, kTimeoutUs));
+    return batch;
+  }
+
+  std::vector<uint8_t> read(const BatchPtr& batch, size_t bytes) {
+    const auto* data =
+      static_cast<uint8_t*>(batch->getRawInputBuffers()[0]->data(0));
+    return {data, data + bytes};
+  }
+
+  void put(BatchPtr batch) {
+    for (auto& buffer : batch->getInputBuffers()) {
+      pool_.put(std::move(buffer));
+    }
+  }
+
+  MemoryPool pool_;
+  std::unique_ptr<BucketBatcher> batcher_;
+  // the batch returns the memory to the pool so these only hold the objects
+  BufferPtrs ingress_;
+  std::vector<std::string> errors_;
+};
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST_F(UnitBucketBatcher, Pad) {
+  enqueue("0", {3}, 1);
+  enqueue("1", {6}, 11);
+  enqueue("2", {2}, 21);
+  start();
+
+  // the short requests fill their bucket so it's sent right away
+  auto batch = next();
+  ASSERT_NE(batch, nullptr);
+  ASSERT_EQ(batch->size(), 2);
+  EXPECT_EQ(batch->getRequest(0)->getID(), "0");
+  EXPECT_EQ(batch->getRequest(1)->getID(), "2");
+  EXPECT_EQ(batch->getRequest(1)->getInputs()[0].getShape(),
+            std::vector<uint64_t>{4});
+  EXPECT_EQ(read(batch, 8), std::vector<uint8_t>({1, 2, 3, 0, 21, 22, 0, 0}));
+  put(std::move(batch));
+
+  // the long request is sent after its bucket's timeout
+  batch = next();
+  ASSERT_NE(batch, nullptr);
+  ASSERT_EQ(batch->size(), 1);
+  EXPECT_EQ(batch->getRequest(0)->getID(), "1");
+  EXPECT_EQ(batch->getRequest(0)->getInputs()[0].getShape(),
+            std::vector<uint64_t>{8});
+  EXPECT_EQ(read(batch, 8),
+            std::vector<uint8_t>({11, 12, 13, 14, 15, 16, 0, 0}));
+  put(std::move(batch));
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST_F(UnitBucketBatcher, PadRows) {
+  // the last dimension is padded in each row
+  enqueue("0", {2, 3}, 1);
+  enqueue("1", {2, 4}, 11);
+  start();
+
+  auto batch = next();
+  ASSERT_NE(batch, nullptr);
+  ASSERT_EQ(batch->size(), 2);
+  EXPECT_EQ(batch->getRequest(0)->getInputs()[0].getShape(),
+            std::vector<uint64_t>({2, 4}));
+  EXPECT_EQ(read(batch, 16),
+            std::vector<uint8_t>(
+              {1, 2, 3, 0, 4, 5, 6, 0, 11, 12, 13, 14, 15, 16, 17, 18}));
+  put(std::move(batch));
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST_F(UnitBucketBatcher, Reject) {
+  enqueue("0", {9}, 1);
+  enqueue("1", {3}, 1);
+  enqueue("2", {2, 2}, 1);
+  start();
+
+  // the mismatched request is rejected when the bucket is sent
+  auto batch = next();
+  ASSERT_NE(batch, nullptr);
+  ASSERT_EQ(batch->size(), 1);
+  EXPECT_EQ(batch->getRequest(0)->getID(), "1");
+  put(std::move(batch));
+  EXPECT_EQ(errors_, std::vector<std::string>({"0", "2"}));
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitBucketBatcherParameters, Invalid) {
+  MemoryPool pool;
+  ParameterMap parameters;
+  EXPECT_THROW(BucketBatcher(&pool, &parameters), invalid_argument);
+  parameters.put("buckets", "8,4");
+  EXPECT_THROW(BucketBatcher(&pool, &parameters), invalid_argument);
+  parameters.erase("buckets");
+  parameters.put("buckets", "4,x");
+  EXPECT_THROW(BucketBatcher(&pool, &parameters), invalid_argument);
+  parameters.erase("buckets");
+  parameters.put("buckets", "4,8");
+  parameters.put("bucket_timeouts", "10");
+  EXPECT_THROW(BucketBatcher(&pool, &parameters), invalid_argument);
+}
+
+}  // namespace amdinfer
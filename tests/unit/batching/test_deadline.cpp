@@ -0,0 +1,155 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>    // for atomic
+#include <chrono>    // for milliseconds
+#include <cstdint>   // for int32_t
+#include <memory>    // for make_shared, make_unique
+#include <optional>  // for optional
+#include <string>    // for string
+#include <utility>   // for move
+#include <vector>    // for vector
+
+#include "amdinfer/batching/deadline.hpp"        // for DeadlineBatcher
+#include "amdinfer/buffers/buffer.hpp"           // for Buffer
+#include "amdinfer/core/data_types.hpp"          // for DataType
+#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/core/memory_pool/pool.hpp"    // for MemoryPool
+#include "amdinfer/core/parameters.hpp"          // for ParameterMap
+#include "amdinfer/core/request_container.hpp"   // for RequestContainer
+#include "amdinfer/util/timer.hpp"               // for getTime
+#include "gtest/gtest.h"                         // for Test, EXPECT_EQ
+
+namespace amdinfer {
+
+// timeout in us to read from the batcher
+constexpr auto kTimeoutUs = 1'000'000;
+
+class UnitDeadlineBatcher : public testing::Test {
+ protected:
+  void SetUp() override {
+    ParameterMap parameters;
+    parameters.put("timeout", 1);
+    batcher_.emplace(&pool_, &parameters);
+    batcher_->setName("test");
+  }
+
+  void TearDown() override {
+    batcher_->enqueue(nullptr);
+    batcher_->end();
+  }
+
+  // the ID of each request is used to check the order they are served in
+  void enqueue(const std::string& id, std::optional<int32_t> deadline,
+               std::optional<int32_t> priority = std::nullopt) {
+    batcher_->enqueue(makeRequest(id, deadline, priority));
+  }
+
+  std::unique_ptr<RequestContainer> makeRequest(
+    const std::string& id, std::optional<int32_t> deadline,
+    std::optional<int32_t> priority = std::nullopt) {
+    InferenceRequestInput input{nullptr, {1}, DataType::Uint8};
+    auto buffer = pool_.get({MemoryAllocators::Cpu}, input, 1);
+
+    auto request = std::make_shared<InferenceRequest>();
+    request->setID(id);
+    request->addInputTensor(buffer->data(0), {1}, DataType::Uint8);
+    ParameterMap parameters;
+    if (deadline.has_value()) {
+      parameters.put("deadline_ms", deadline.value());
+    }
+    if (priority.has_value()) {
+      parameters.put("priority", priority.value());
+    }
+    request->setParameters(parameters);
+    request->setCallback([this, id](const InferenceResponse& response) {
+      if (response.isError()) {
+        errors_.push_back(id);
+      }
+    });
+
+    auto req = std::make_unique<RequestContainer>();
+    req->request = std::move(request);
+    return req;
+  }
+
+  std::vector<std::string> dequeue(size_t count) {
+    std::vector<std::string> ids;
+    for (auto i = 0U; i < count; ++i) {
+      BatchPtr batch;
+      if (!batcher_->getOutputQueue()->wait_dequeue_timed(batch, kTimeoutUs)) {
+        break;
+      }
+      for (const auto& request : *batch) {
+        ids.push_back(request->getID());
+      }
+      for (auto& buffer : batch->getInputBuffers()) {
+        pool_.put(std::move(buffer));
+      }
+    }
+    return ids;
+  }
+
+  MemoryPool pool_;
+  std::optional<DeadlineBatcher> batcher_;
+  std::vector<std::string> errors_;
+};
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST_F(UnitDeadlineBatcher, Order) {
+  // queue up all the requests before starting so they're ordered together
+  enqueue("none", std::nullopt);
+  enqueue("late", 10'000);
+  enqueue("early", 5'000);
+  enqueue("later", 5'000);
+  enqueue("high", 20'000, 1);
+  batcher_->start({MemoryAllocators::Cpu});
+
+  const std::vector<std::string> golden{"high", "early", "later", "late",
+                                        "none"};
+  EXPECT_EQ(dequeue(golden.size()), golden);
+  EXPECT_TRUE(errors_.empty());
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST_F(UnitDeadlineBatcher, RejectExpired) {
+  batcher_->start({MemoryAllocators::Cpu});
+
+  enqueue("expired", -1);
+  enqueue("valid", 10'000);
+
+  const auto ids = dequeue(1);
+  EXPECT_EQ(ids, std::vector<std::string>{"valid"});
+  EXPECT_EQ(errors_, std::vector<std::string>{"expired"});
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST_F(UnitDeadlineBatcher, DropAbandoned) {
+  std::atomic<bool> cancelled = true;
+  auto req = makeRequest("cancelled", std::nullopt);
+  req->cancelled = &cancelled;
+  batcher_->enqueue(std::move(req));
+  req = makeRequest("timed_out", std::nullopt);
+  req->deadline = util::getTime() - std::chrono::milliseconds(1);
+  batcher_->enqueue(std::move(req));
+  enqueue("valid", std::nullopt);
+  batcher_->start({MemoryAllocators::Cpu});
+
+  const auto ids = dequeue(1);
+  EXPECT_EQ(ids, std::vector<std::string>{"valid"});
+  EXPECT_EQ(errors_, (std::vector<std::string>{"timed_out", "cancelled"}));
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,88 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <chrono>  // for milliseconds, seconds
+
+#include "amdinfer/batching/endpoint_signals.hpp"  // for EndpointSignals
+#include "amdinfer/util/timer.hpp"                 // for getTime, TimePoint
+#include "gtest/gtest.h"                           // for Test, EXPECT_EQ
+
+namespace amdinfer {
+
+constexpr auto kRequests = 4;
+// in microseconds
+constexpr auto kWait = 1000.0;
+constexpr auto kDuration = 5000.0;
+constexpr std::chrono::milliseconds kGap{10};
+
+/// Record batches of kRequests every kGap for a while and return the end time
+util::TimePoint addLoad(EndpointSignals* signals, util::TimePoint time,
+                        std::chrono::seconds length) {
+  const auto end = time + length;
+  for (; time < end; time += kGap) {
+    for (auto i = 0; i < kRequests; ++i) {
+      signals->recordQueued(kWait, time);
+    }
+    signals->recordBatch(kRequests, kDuration, time);
+  }
+  return time;
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitEndpointSignals, NoHistory) {
+  const EndpointSignals signals;
+
+  const auto values = signals.get(2, util::getTime());
+  EXPECT_DOUBLE_EQ(values.concurrency, 0);
+  EXPECT_DOUBLE_EQ(values.queue_time, 0);
+  EXPECT_DOUBLE_EQ(values.throughput, 0);
+  EXPECT_DOUBLE_EQ(values.capacity, 0);
+  EXPECT_DOUBLE_EQ(values.headroom, 0);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitEndpointSignals, SteadyLoad) {
+  EndpointSignals signals{std::chrono::seconds{10}};
+  const auto end =
+    addLoad(&signals, util::getTime(), std::chrono::seconds{100});
+
+  const auto values = signals.get(2, end);
+  // 4 requests every 10 ms
+  EXPECT_NEAR(values.throughput, 400, 1);
+  EXPECT_DOUBLE_EQ(values.queue_time, kWait);
+  // each instance finishes 4 requests in 5 ms while it's busy
+  EXPECT_NEAR(values.service_rate, 800, 1e-6);
+  EXPECT_NEAR(values.capacity, 1600, 1e-6);
+  EXPECT_NEAR(values.headroom, 1200, 1);
+  // each request spends 6 ms queued and in its batch
+  EXPECT_NEAR(values.concurrency, 2.4, 0.01);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitEndpointSignals, Decay) {
+  EndpointSignals signals{std::chrono::seconds{10}};
+  const auto end =
+    addLoad(&signals, util::getTime(), std::chrono::seconds{100});
+
+  // the load is forgotten once it stops but the capacity is still known
+  const auto idle = signals.get(2, end + std::chrono::seconds{100});
+  EXPECT_LT(idle.throughput, 0.1);
+  EXPECT_LT(idle.concurrency, 0.001);
+  EXPECT_NEAR(idle.capacity, 1600, 1e-6);
+  EXPECT_NEAR(idle.headroom, 1600, 0.1);
+
+  // more instances add to the capacity
+  EXPECT_NEAR(signals.get(4, end).capacity, 3200, 1e-6);
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,134 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>                // for uint8_t
+#include <cstring>                // for memcpy
+#include <future>                 // for promise
+#include <memory>                 // for make_unique, make_shared
+#include <opencv2/core.hpp>       // for Mat, Scalar
+#include <opencv2/imgcodecs.hpp>  // for imencode
+#include <string>                 // for string
+#include <vector>                 // for vector
+
+#include "amdinfer/batching/preprocessor.hpp"    // for Preprocessor
+#include "amdinfer/batching/soft.hpp"            // for SoftBatcher
+#include "amdinfer/buffers/cpu.hpp"              // for CpuBuffer
+#include "amdinfer/build_options.hpp"            // for AMDINFER_ENABLE_TRACING
+#include "amdinfer/core/data_types.hpp"          // for DataType
+#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/core/memory_pool/pool.hpp"    // for MemoryPool
+#include "amdinfer/core/parameters.hpp"          // for ParameterMap
+#include "amdinfer/core/request_container.hpp"   // for RequestContainer
+#include "amdinfer/observation/tracing.hpp"      // for startTrace
+#include "gtest/gtest.h"                         // for Test, EXPECT_EQ
+
+namespace amdinfer {
+
+namespace {
+
+ParameterMap makeParameters() {
+  ParameterMap parameters;
+  parameters.put("preprocess", "image");
+  parameters.put("preprocess_height", 4);
+  parameters.put("preprocess_width", 4);
+  parameters.put("preprocess_threads", 1);
+  return parameters;
+}
+
+/**
+ * @brief Make a request with the bytes as its one input, in a buffer from the
+ * pool like the servers use
+ *
+ * @param bytes the input's data
+ * @param pool the pool to get the buffer from
+ * @param buffers holds the buffer objects. The preprocessor or the test returns
+ * their memory to the pool
+ * @return RequestContainerPtr
+ */
+RequestContainerPtr makeRequest(const std::vector<uint8_t>& bytes,
+                                MemoryPool* pool, BufferPtrs* buffers) {
+  InferenceRequestInput input{nullptr, {bytes.size()}, DataType::String};
+  auto& buffer =
+    buffers->emplace_back(pool->get({MemoryAllocators::Cpu}, input, 1));
+  std::memcpy(buffer->data(0), bytes.data(), bytes.size());
+
+  auto container = std::make_unique<RequestContainer>();
+  container->request = std::make_shared<InferenceRequest>();
+  container->request->addInputTensor(buffer->data(0), {bytes.size()},
+                                     DataType::String, "image");
+#ifdef AMDINFER_ENABLE_TRACING
+  container->trace = startTrace("test");
+#endif
+  return container;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitPreprocessor, Image) {
+  MemoryPool pool;
+  SoftBatcher batcher(&pool);
+  Preprocessor preprocessor{"test", makeParameters(), &batcher, &pool};
+
+  // a blue image in OpenCV's BGR order that's scaled down to 4x4
+  const cv::Mat image{8, 8, CV_8UC3, cv::Scalar{255, 0, 0}};
+  std::vector<uint8_t> encoded;
+  ASSERT_TRUE(cv::imencode(".png", image, encoded));
+  BufferPtrs buffers;
+  preprocessor.enqueue(makeRequest(encoded, &pool, &buffers));
+
+  // the preprocessed request is passed on to the batcher
+  RequestContainerPtr container;
+  batcher.getInputQueue()->wait_dequeue(container);
+  ASSERT_NE(container, nullptr);
+  const auto& input = container->request->getInputs().at(0);
+  EXPECT_EQ(input.getName(), "image");
+  EXPECT_EQ(input.getDatatype(), DataType::Fp32);
+  EXPECT_EQ(input.getShape(), (std::vector<uint64_t>{4, 4, 3}));
+  // the pixels are in RGB order by default
+  const auto* pixels = static_cast<const float*>(input.getData());
+  for (auto i = 0; i < 4 * 4; ++i) {
+    EXPECT_FLOAT_EQ(pixels[3 * i], 0);
+    EXPECT_FLOAT_EQ(pixels[3 * i + 1], 0);
+    EXPECT_FLOAT_EQ(pixels[3 * i + 2], 255);
+  }
+  pool.put(std::make_unique<CpuBuffer>(input.getData(), MemoryAllocators::Cpu,
+                                       input.getSize() * sizeof(float)));
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitPreprocessor, MalformedImage) {
+  MemoryPool pool;
+  SoftBatcher batcher(&pool);
+  Preprocessor preprocessor{"test", makeParameters(), &batcher, &pool};
+
+  const std::string text = "not an image";
+  BufferPtrs buffers;
+  auto container = makeRequest({text.begin(), text.end()}, &pool, &buffers);
+  std::promise<InferenceResponse> promise;
+  auto future = promise.get_future();
+  container->request->setCallback(
+    [&promise](const InferenceResponse& response) {
+      promise.set_value(response);
+    });
+  preprocessor.enqueue(std::move(container));
+
+  // the request gets an error instead of reaching the batcher
+  const auto response = future.get();
+  EXPECT_TRUE(response.isError());
+  EXPECT_EQ(batcher.getInputQueue()->size_approx(), 0U);
+}
+
+}  // namespace amdinfer
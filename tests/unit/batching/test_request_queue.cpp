@@ -0,0 +1,162 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>  // for rotate
+#include <chrono>     // for microseconds
+#include <memory>     // for make_unique
+#include <thread>     // for thread
+#include <utility>    // for move
+#include <vector>     // for vector
+
+#include "amdinfer/batching/request_queue.hpp"  // for RequestQueue
+#include "amdinfer/core/exceptions.hpp"         // for invalid_argument
+#include "amdinfer/core/request_container.hpp"  // for RequestContainer
+#include "amdinfer/util/wait.hpp"               // for WaitStrategy
+#include "gtest/gtest.h"                        // for Test, EXPECT_EQ
+
+namespace amdinfer {
+
+namespace {
+
+/// Enqueue a request of a class and return its address to check for it later
+const RequestContainer* add(RequestQueue* queue, RequestPriority priority) {
+  auto request = std::make_unique<RequestContainer>();
+  const auto* address = request.get();
+  queue->enqueue(std::move(request), priority);
+  return address;
+}
+
+/// Take all the requests from a queue in order
+std::vector<const RequestContainer*> drain(RequestQueue* queue) {
+  std::vector<const RequestContainer*> addresses;
+  RequestContainerPtr request;
+  while (queue->try_dequeue(request)) {
+    addresses.push_back(request.get());
+  }
+  return addresses;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitRequestQueue, Empty) {
+  RequestQueue queue;
+  RequestContainerPtr request;
+  EXPECT_FALSE(queue.try_dequeue(request));
+  EXPECT_FALSE(queue.wait_dequeue_timed(request, 1));
+
+  const auto* address = add(&queue, RequestPriority::Normal);
+  EXPECT_EQ(queue.size_approx(), 1);
+  EXPECT_EQ(queue.sizeApprox(RequestPriority::Normal), 1);
+  EXPECT_EQ(queue.sizeApprox(RequestPriority::High), 0);
+  queue.wait_dequeue(request);
+  EXPECT_EQ(request.get(), address);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitRequestQueue, Priorities) {
+  RequestQueue queue;
+  const auto* low = add(&queue, RequestPriority::Low);
+  const auto* normal_0 = add(&queue, RequestPriority::Normal);
+  const auto* high = add(&queue, RequestPriority::High);
+  const auto* normal_1 = add(&queue, RequestPriority::Normal);
+
+  const std::vector<const RequestContainer*> expected{high, normal_0,
+                                                      normal_1, low};
+  EXPECT_EQ(drain(&queue), expected);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitRequestQueue, Starvation) {
+  RequestQueue queue{2};
+  const auto* low = add(&queue, RequestPriority::Low);
+  std::vector<const RequestContainer*> high;
+  for (auto i = 0; i < 4; ++i) {
+    high.push_back(add(&queue, RequestPriority::High));
+  }
+
+  // the low request is served once two high ones have gone ahead of it
+  const std::vector<const RequestContainer*> expected{high[0], high[1], low,
+                                                      high[2], high[3]};
+  EXPECT_EQ(drain(&queue), expected);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitRequestQueue, Strict) {
+  RequestQueue queue{0};
+  const auto* low = add(&queue, RequestPriority::Low);
+  std::vector<const RequestContainer*> expected;
+  for (auto i = 0; i < 4; ++i) {
+    expected.push_back(add(&queue, RequestPriority::High));
+  }
+  expected.push_back(low);
+  EXPECT_EQ(drain(&queue), expected);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitRequestQueue, Stop) {
+  RequestQueue queue{2};
+  std::vector<const RequestContainer*> expected;
+  for (auto i = 0; i < 4; ++i) {
+    expected.push_back(add(&queue, RequestPriority::Normal));
+  }
+  queue.enqueue(nullptr, RequestPriority::Low);
+  // requests that arrive after the stop still go ahead of it
+  expected.push_back(add(&queue, RequestPriority::High));
+  EXPECT_EQ(queue.size_approx(), 5);
+
+  RequestContainerPtr request;
+  std::vector<const RequestContainer*> addresses;
+  for (auto i = 0; i < 5; ++i) {
+    ASSERT_TRUE(queue.try_dequeue(request));
+    ASSERT_NE(request, nullptr);
+    addresses.push_back(request.get());
+  }
+  std::rotate(expected.begin(), expected.end() - 1, expected.end());
+  EXPECT_EQ(addresses, expected);
+
+  // the stop is taken once every class is empty and only once
+  ASSERT_TRUE(queue.wait_dequeue_timed(request, 100));
+  EXPECT_EQ(request, nullptr);
+  EXPECT_FALSE(queue.try_dequeue(request));
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitRequestQueue, WaitStrategies) {
+  EXPECT_EQ(util::parseWaitMode("spin"), util::WaitMode::Spin);
+  EXPECT_THROW(util::parseWaitMode("sleep"), invalid_argument);
+
+  for (const auto mode : {util::WaitMode::Spin, util::WaitMode::Poll}) {
+    RequestQueue queue;
+    queue.setWaitStrategy({mode, std::chrono::microseconds{10}});
+    RequestContainerPtr request;
+    EXPECT_FALSE(queue.wait_dequeue_timed(request, 100));
+
+    // a request that arrives while spinning or after parking is taken
+    const RequestContainer* address = nullptr;
+    std::thread producer{[&queue, &address]() {
+      std::this_thread::sleep_for(std::chrono::milliseconds{1});
+      address = add(&queue, RequestPriority::Normal);
+    }};
+    queue.wait_dequeue(request);
+    producer.join();
+    EXPECT_EQ(request.get(), address);
+
+    address = add(&queue, RequestPriority::High);
+    EXPECT_TRUE(queue.wait_dequeue_timed(request, 100));
+    EXPECT_EQ(request.get(), address);
+  }
+}
+
+}  // namespace amdinfer
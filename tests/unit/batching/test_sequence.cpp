@@ -0,0 +1,188 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>    // for milliseconds
+#include <cstdint>   // for int32_t
+#include <memory>    // for make_shared, make_unique
+#include <optional>  // for optional
+#include <string>    // for string
+#include <thread>    // for sleep_for
+#include <utility>   // for move
+#include <vector>    // for vector
+
+#include "amdinfer/batching/sequence.hpp"        // for SequenceBatcher
+#include "amdinfer/buffers/buffer.hpp"           // for Buffer
+#include "amdinfer/core/data_types.hpp"          // for DataType
+#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/core/memory_pool/pool.hpp"    // for MemoryPool
+#include "amdinfer/core/parameters.hpp"          // for ParameterMap
+#include "amdinfer/core/request_container.hpp"   // for RequestContainer
+#include "amdinfer/core/tensor.hpp"              // for Tensor
+#include "gtest/gtest.h"                         // for Test, EXPECT_EQ
+
+namespace amdinfer {
+
+// timeout in us to read from the batcher
+constexpr auto kTimeoutUs = 1'000'000;
+// timeout in us to check that the batcher holds a batch back
+constexpr auto kHoldUs = 50'000;
+
+class UnitSequenceBatcher : public testing::Test {
+ protected:
+  void SetUp() override { make(60'000); }
+
+  void TearDown() override {
+    batcher_->enqueue(nullptr);
+    batcher_->end();
+  }
+
+  void make(int32_t idle_ms) {
+    ParameterMap parameters;
+    parameters.put("timeout", 1);
+    parameters.put("sequence_idle_ms", idle_ms);
+    batcher_.emplace(&pool_, &parameters);
+    batcher_->setName("test");
+    batcher_->setBatchSize(2);
+  }
+
+  // the ID of each request is used to check which batch it's in
+  void enqueue(const std::string& id, std::optional<int32_t> sequence,
+               bool start = false, bool end = false) {
+    InferenceRequestInput input{nullptr, {1}, DataType::Uint8};
+    auto buffer = pool_.get({MemoryAllocators::Cpu}, input, 1);
+
+    auto request = std::make_shared<InferenceRequest>();
+    request->setID(id);
+    request->addInputTensor(buffer->data(0), {1}, DataType::Uint8);
+    ParameterMap parameters;
+    if (sequence.has_value()) {
+      parameters.put("sequence_id", sequence.value());
+    }
+    parameters.put("sequence_start", start);
+    parameters.put("sequence_end", end);
+    request->setParameters(parameters);
+    request->setCallback([this, id](const InferenceResponse& response) {
+      if (response.isError()) {
+        errors_.push_back(id);
+      }
+    });
+
+    auto req = std::make_unique<RequestContainer>();
+    req->request = std::move(request);
+    batcher_->enqueue(std::move(req));
+  }
+
+  // get the next batch's requests as ID:slot
+  std::vector<std::string> dequeue(BatchPtr* batch,
+                                   int64_t timeout = kTimeoutUs) {
+    std::vector<std::string> ids;
+    if (!batcher_->getOutputQueue()->wait_dequeue_timed(*batch, timeout)) {
+      return ids;
+    }
+    for (const auto& request : **batch) {
+      const auto slot = request->getParameters().get<int32_t>("sequence_slot");
+      ids.push_back(request->getID() + ":" + std::to_string(slot));
+    }
+    for (auto& buffer : (*batch)->getInputBuffers()) {
+      pool_.put(std::move(buffer));
+    }
+    return ids;
+  }
+
+  MemoryPool pool_;
+  std::optional<SequenceBatcher> batcher_;
+  std::vector<std::string> errors_;
+};
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST_F(UnitSequenceBatcher, Slots) {
+  enqueue("a0", 1, true);
+  enqueue("a1", 1);
+  enqueue("b0", 2, true);
+  batcher_->start({MemoryAllocators::Cpu});
+
+  BatchPtr batch;
+  std::vector<std::string> golden{"a0:0", "b0:1"};
+  EXPECT_EQ(dequeue(&batch), golden);
+  ASSERT_NE(batch->getSequenceStates(), nullptr);
+
+  // the next step waits until the worker is done with the previous one
+  BatchPtr next;
+  EXPECT_TRUE(dequeue(&next, kHoldUs).empty());
+  batch.reset();
+  golden = {"a1:0"};
+  EXPECT_EQ(dequeue(&next), golden);
+  next.reset();
+
+  // an ended sequence's slot goes to the next sequence
+  enqueue("a2", 1, false, true);
+  EXPECT_EQ(dequeue(&next), std::vector<std::string>{"a2:0"});
+  next.reset();
+  enqueue("c0", 3, true);
+  EXPECT_EQ(dequeue(&next), std::vector<std::string>{"c0:0"});
+  EXPECT_TRUE(errors_.empty());
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST_F(UnitSequenceBatcher, Reject) {
+  enqueue("none", std::nullopt);
+  enqueue("unstarted", 1);
+  enqueue("a", 1, true);
+  enqueue("b", 2, true);
+  enqueue("full", 3, true);
+  // all the requests are taken before the batch is sent
+  batcher_->start({MemoryAllocators::Cpu});
+
+  BatchPtr batch;
+  const std::vector<std::string> golden{"a:0", "b:1"};
+  EXPECT_EQ(dequeue(&batch), golden);
+  const std::vector<std::string> errors{"none", "unstarted", "full"};
+  EXPECT_EQ(errors_, errors);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST_F(UnitSequenceBatcher, Reclaim) {
+  make(1);
+  batcher_->start({MemoryAllocators::Cpu});
+  enqueue("a0", 1, true);
+  BatchPtr batch;
+  EXPECT_EQ(dequeue(&batch), std::vector<std::string>{"a0:0"});
+  batch.reset();
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  enqueue("a1", 1);
+  EXPECT_TRUE(dequeue(&batch, kHoldUs).empty());
+  EXPECT_EQ(errors_, std::vector<std::string>{"a1"});
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitSequenceStates, Reset) {
+  MemoryPool pool;
+  SequenceStates states{&pool, {MemoryAllocators::Cpu}};
+  const Tensor tensor{"state", {4}, DataType::Uint8};
+
+  auto state = states.get(0, tensor);
+  EXPECT_TRUE(state.fresh);
+  EXPECT_EQ(state.buffer->size(), 4);
+  EXPECT_FALSE(states.get(0, tensor).fresh);
+  EXPECT_EQ(states.get(0, tensor).buffer, state.buffer);
+  EXPECT_TRUE(states.get(1, tensor).fresh);
+
+  states.reset(0);
+  EXPECT_TRUE(states.get(0, tensor).fresh);
+  EXPECT_FALSE(states.get(1, tensor).fresh);
+}
+
+}  // namespace amdinfer
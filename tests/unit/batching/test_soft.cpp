@@ -13,18 +13,52 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-#include <memory>  // for allocator
+#include <atomic>   // for atomic
+#include <cstdint>  // for uint8_t, int64_t
+#include <cstring>  // for memcpy, memset
+#include <memory>   // for allocator, make_unique
+#include <string>   // for string
+#include <vector>   // for vector
 
-#include "amdinfer/batching/soft.hpp"           // for SoftBatcher
-#include "amdinfer/build_options.hpp"           // for AMDINFER_ENABLE_LOGGING
-#include "amdinfer/core/memory_pool/pool.hpp"   // for MemoryPool
-#include "amdinfer/core/request_container.hpp"  // for InferenceRequestInput
-#include "amdinfer/core/worker_info.hpp"        // for WorkerInfo
-#include "amdinfer/observation/logging.hpp"  // for initLogger, LogLevel, Log...
-#include "gtest/gtest.h"                     // for Test, SuiteApiResolver, TEST
+#include "amdinfer/batching/request_queue.hpp"   // for kDefaultStarvat...
+#include "amdinfer/batching/soft.hpp"            // for SoftBatcher
+#include "amdinfer/buffers/buffer.hpp"           // for Buffer
+#include "amdinfer/build_options.hpp"            // for AMDINFER_ENABLE_LOGGING
+#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/core/memory_pool/pool.hpp"    // for MemoryPool
+#include "amdinfer/core/parameters.hpp"          // for ParameterMap
+#include "amdinfer/core/request_coalescer.hpp"   // for RequestCoalescer
+#include "amdinfer/core/request_container.hpp"   // for InferenceRequestInput
+#include "amdinfer/core/worker_info.hpp"         // for WorkerInfo
+#include "amdinfer/observation/logging.hpp"      // for initLogger, LogLevel,...
+#include "gtest/gtest.h"                         // for Test, SuiteApiResolve...
 
 namespace amdinfer {
 
+namespace {
+
+/// Respond to each request in a batch with its input and return the buffers
+void respond(Batch* batch, MemoryPool* pool) {
+  for (const auto& request : *batch) {
+    const auto& input = request->getInputs()[0];
+    InferenceResponseOutput output;
+    output.setDatatype(DataType::Uint8);
+    output.setShape(input.getShape());
+    std::vector<std::byte> data(input.getSize());
+    std::memcpy(data.data(), input.getData(), data.size());
+    output.setData(std::move(data));
+    InferenceResponse response;
+    response.addOutput(output);
+    request->runCallbackOnce(response);
+  }
+  for (auto& buffer : batch->getInputBuffers()) {
+    pool->put(std::move(buffer));
+  }
+}
+
+}  // namespace
+
 // NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
 TEST(UnitSoftBatcher, ConstructAndStart) {
 #ifdef AMDINFER_ENABLE_LOGGING
@@ -44,11 +78,564 @@ TEST(UnitSoftBatcher, ConstructAndStart) {
   SoftBatcher batcher(&pool);
   batcher.setName("test");
 
-  WorkerInfo fake("", nullptr, &pool);
+  WorkerInfo fake("", "", nullptr, &pool);
+  batcher.start({MemoryAllocators::Cpu});
+
+  batcher.enqueue(nullptr);
+  batcher.end();
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitSoftBatcher, ScatterGather) {
+  MemoryPool pool;
+
+  SoftBatcher batcher(&pool);
+  batcher.setName("test");
+  batcher.setBatchSize(2);
+  batcher.setScatterGather(true);
+
+  WorkerInfo fake("", "", nullptr, &pool);
+  batcher.start({MemoryAllocators::Cpu});
+
+  const auto shape = {4UL};
+  InferenceRequestInput input{nullptr, shape, DataType::Uint8};
+  // the batch returns the memory to the pool so these are only kept to hold
+  // the buffer objects
+  BufferPtrs ingress;
+  std::vector<void*> addresses;
+  for (auto i = 0; i < 2; ++i) {
+    auto& buffer =
+      ingress.emplace_back(pool.get({MemoryAllocators::Cpu}, input, 1));
+    addresses.push_back(buffer->data(0));
+
+    auto req = std::make_unique<RequestContainer>();
+    req->request = std::make_shared<InferenceRequest>();
+    req->request->addInputTensor(addresses.back(), shape, DataType::Uint8);
+    batcher.enqueue(std::move(req));
+  }
+
+  BatchPtr batch;
+  batcher.getOutputQueue()->wait_dequeue(batch);
+  ASSERT_TRUE(batch->isScatterGather());
+  EXPECT_EQ(batch->size(), 2);
+  EXPECT_EQ(batch->getInputSize(), 1);
+
+  // the segments point at the requests' data instead of a copy
+  const auto& segments = batch->getSegments(0);
+  ASSERT_EQ(segments.size(), 2);
+  for (auto i = 0U; i < segments.size(); ++i) {
+    EXPECT_EQ(segments[i].data, addresses[i]);
+    EXPECT_EQ(segments[i].size, 4);
+    EXPECT_EQ(batch->getRequest(i)->getInputs()[0].getData(), addresses[i]);
+  }
+
+  for (auto& buffer : batch->getInputBuffers()) {
+    pool.put(std::move(buffer));
+  }
+
+  batcher.enqueue(nullptr);
+  batcher.end();
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitSoftBatcher, Ragged) {
+  MemoryPool pool;
+
+  SoftBatcher batcher(&pool);
+  batcher.setName("test");
+  batcher.setBatchSize(2);
+  batcher.setRagged(true);
+
+  WorkerInfo fake("", "", nullptr, &pool);
+  batcher.start({MemoryAllocators::Cpu});
+
+  // the requests differ in their first dimension
+  BufferPtrs ingress;
+  const std::vector<uint64_t> lengths{3, 1};
+  for (auto i = 0U; i < lengths.size(); ++i) {
+    const std::vector<uint64_t> shape{lengths[i], 2};
+    InferenceRequestInput input{nullptr, shape, DataType::Uint8};
+    auto& buffer =
+      ingress.emplace_back(pool.get({MemoryAllocators::Cpu}, input, 1));
+    for (auto j = 0U; j < input.getSize(); ++j) {
+      buffer->write(static_cast<uint8_t>(i * 10 + j), j);
+    }
+
+    auto req = std::make_unique<RequestContainer>();
+    req->request = std::make_shared<InferenceRequest>();
+    req->request->addInputTensor(buffer->data(0), shape, DataType::Uint8);
+    batcher.enqueue(std::move(req));
+  }
+
+  BatchPtr batch;
+  batcher.getOutputQueue()->wait_dequeue(batch);
+  ASSERT_TRUE(batch->isRagged());
+  EXPECT_FALSE(batch->isScatterGather());
+  ASSERT_EQ(batch->size(), 2);
+  EXPECT_EQ(batch->getOffsets(0), std::vector<uint64_t>({0, 3, 4}));
+
+  // the inputs are concatenated without padding
+  auto* data = static_cast<uint8_t*>(batch->getRawInputBuffers()[0]->data(0));
+  EXPECT_EQ(std::vector<uint8_t>(data, data + 8),
+            std::vector<uint8_t>({0, 1, 2, 3, 4, 5, 10, 11}));
+  EXPECT_EQ(batch->getRequest(0)->getInputs()[0].getData(), data);
+  EXPECT_EQ(batch->getRequest(1)->getInputs()[0].getData(), data + 6);
+
+  for (auto& buffer : batch->getInputBuffers()) {
+    pool.put(std::move(buffer));
+  }
+
+  batcher.enqueue(nullptr);
+  batcher.end();
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitSoftBatcher, LendInputs) {
+  MemoryPool pool;
+
+  ParameterMap parameters;
+  parameters.put("timeout", 1);
+  SoftBatcher batcher(&pool, &parameters);
+  batcher.setName("test");
+  batcher.setBatchSize(1);
+
+  WorkerInfo fake("", "", nullptr, &pool);
+  batcher.start({MemoryAllocators::Cpu});
+
+  const auto shape = {4UL};
+  InferenceRequestInput input{nullptr, shape, DataType::Uint8};
+  // the batch returns the memory to the pool so this is only kept to hold the
+  // buffer object
+  auto ingress = pool.get({MemoryAllocators::Cpu}, input, 1);
+  auto* data = ingress->data(0);
+  auto req = std::make_unique<RequestContainer>();
+  req->request = std::make_shared<InferenceRequest>();
+  req->request->addInputTensor(data, shape, DataType::Uint8);
+  batcher.enqueue(std::move(req));
+
+  // a request that fills the batch by itself isn't copied
+  BatchPtr batch;
+  batcher.getOutputQueue()->wait_dequeue(batch);
+  ASSERT_EQ(batch->size(), 1);
+  ASSERT_EQ(batch->getInputSize(), 1);
+  EXPECT_EQ(batch->getRawInputBuffers()[0]->data(0), data);
+  EXPECT_EQ(batch->getRawInputBuffers()[0]->size(), 4);
+  EXPECT_EQ(batch->getRequest(0)->getInputs()[0].getData(), data);
+  for (auto& buffer : batch->getInputBuffers()) {
+    pool.put(std::move(buffer));
+  }
+
+  batcher.enqueue(nullptr);
+  batcher.end();
+
+  // a batch that's sent with room left is still copied so workers may use
+  // all of it
+  SoftBatcher partial(&pool, &parameters);
+  partial.setName("test");
+  partial.setBatchSize(2);
+  partial.start({MemoryAllocators::Cpu});
+  auto other = pool.get({MemoryAllocators::Cpu}, input, 1);
+  req = std::make_unique<RequestContainer>();
+  req->request = std::make_shared<InferenceRequest>();
+  req->request->addInputTensor(other->data(0), shape, DataType::Uint8);
+  partial.enqueue(std::move(req));
+
+  partial.getOutputQueue()->wait_dequeue(batch);
+  ASSERT_EQ(batch->size(), 1);
+  EXPECT_NE(batch->getRawInputBuffers()[0]->data(0), other->data(0));
+  EXPECT_EQ(batch->getRawInputBuffers()[0]->size(), 8);
+  for (auto& buffer : batch->getInputBuffers()) {
+    pool.put(std::move(buffer));
+  }
+
+  partial.enqueue(nullptr);
+  partial.end();
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitSoftBatcher, Samples) {
+  MemoryPool pool;
+
+  ParameterMap parameters;
+  parameters.put("batch_samples", true);
+  parameters.put("timeout", 1);
+  SoftBatcher batcher(&pool, &parameters);
+  batcher.setName("test");
+  batcher.setBatchSize(4);
+
+  WorkerInfo fake("", "", nullptr, &pool);
+  batcher.start({MemoryAllocators::Cpu});
+
+  // two requests of three samples each so the second one is split
+  std::vector<InferenceResponse> responses(2);
+  BufferPtrs ingress;
+  for (auto i = 0; i < 2; ++i) {
+    const auto shape = {3UL};
+    InferenceRequestInput input{nullptr, shape, DataType::Uint8};
+    auto& buffer =
+      ingress.emplace_back(pool.get({MemoryAllocators::Cpu}, input, 1));
+    for (uint8_t j = 0; j < 3; ++j) {
+      buffer->write(static_cast<uint8_t>(i * 3 + j + 1), j);
+    }
+
+    auto req = std::make_unique<RequestContainer>();
+    req->request = std::make_shared<InferenceRequest>();
+    req->request->addInputTensor(buffer->data(0), shape, DataType::Uint8);
+    req->request->setCallback(
+      [&responses, i](const InferenceResponse& response) {
+        responses[i] = response;
+      });
+    batcher.enqueue(std::move(req));
+  }
+
+  BatchPtr batch;
+  batcher.getOutputQueue()->wait_dequeue(batch);
+  ASSERT_EQ(batch->size(), 2);
+  EXPECT_EQ(batch->getRequest(0)->getInputs()[0].getShape()[0], 3);
+  EXPECT_EQ(batch->getRequest(1)->getInputs()[0].getShape()[0], 1);
+  const auto* data =
+    static_cast<uint8_t*>(batch->getRawInputBuffers()[0]->data(0));
+  EXPECT_EQ(std::vector<uint8_t>(data, data + 4),
+            std::vector<uint8_t>({1, 2, 3, 4}));
+  respond(batch.get(), &pool);
+  EXPECT_FALSE(responses[0].getOutputs().empty());
+  EXPECT_TRUE(responses[1].getOutputs().empty());
+
+  // the rest of the split request starts the next batch
+  batcher.getOutputQueue()->wait_dequeue(batch);
+  ASSERT_EQ(batch->size(), 1);
+  EXPECT_EQ(batch->getRequest(0)->getInputs()[0].getShape()[0], 2);
+  respond(batch.get(), &pool);
+
+  // the parts' outputs are joined for the original request
+  const auto outputs = responses[1].getOutputs();
+  ASSERT_EQ(outputs.size(), 1);
+  EXPECT_EQ(outputs[0].getShape(), std::vector<uint64_t>{3});
+  const auto* joined = static_cast<uint8_t*>(outputs[0].getData());
+  EXPECT_EQ(std::vector<uint8_t>(joined, joined + 3),
+            std::vector<uint8_t>({4, 5, 6}));
+
+  batcher.enqueue(nullptr);
+  batcher.end();
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitSoftBatcher, SamplesOutOfOrder) {
+  MemoryPool pool;
+
+  ParameterMap parameters;
+  parameters.put("batch_samples", true);
+  SoftBatcher batcher(&pool, &parameters);
+  batcher.setName("test");
+  batcher.setBatchSize(2);
+
+  WorkerInfo fake("", "", nullptr, &pool);
+  batcher.start({MemoryAllocators::Cpu});
+
+  const auto shape = {6UL};
+  InferenceRequestInput input{nullptr, shape, DataType::Uint8};
+  auto ingress = pool.get({MemoryAllocators::Cpu}, input, 1);
+  for (uint8_t j = 0; j < 6; ++j) {
+    ingress->write(j, j);
+  }
+  InferenceResponse joined;
+  auto req = std::make_unique<RequestContainer>();
+  req->request = std::make_shared<InferenceRequest>();
+  req->request->addInputTensor(ingress->data(0), shape, DataType::Uint8);
+  req->request->setCallback(
+    [&joined](const InferenceResponse& response) { joined = response; });
+  batcher.enqueue(std::move(req));
+
+  // the parts may be run by different instances and finish in any order
+  std::vector<BatchPtr> batches(3);
+  for (auto& batch : batches) {
+    batcher.getOutputQueue()->wait_dequeue(batch);
+    ASSERT_EQ(batch->size(), 1);
+  }
+  respond(batches[2].get(), &pool);
+  respond(batches[0].get(), &pool);
+  EXPECT_TRUE(joined.getOutputs().empty());
+  respond(batches[1].get(), &pool);
+
+  const auto outputs = joined.getOutputs();
+  ASSERT_EQ(outputs.size(), 1);
+  EXPECT_EQ(outputs[0].getShape(), std::vector<uint64_t>{6});
+  const auto* data = static_cast<uint8_t*>(outputs[0].getData());
+  EXPECT_EQ(std::vector<uint8_t>(data, data + 6),
+            std::vector<uint8_t>({0, 1, 2, 3, 4, 5}));
+
+  batcher.enqueue(nullptr);
+  batcher.end();
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitSoftBatcher, PreferredSize) {
+  MemoryPool pool;
+
+  ParameterMap parameters;
+  parameters.put("preferred_batch_sizes", "2,8");
+  // long enough that only the preferred size sends the batch
+  parameters.put("timeout", 60000);
+  SoftBatcher batcher(&pool, &parameters);
+  batcher.setName("test");
+  batcher.setBatchSize(4);
+
+  WorkerInfo fake("", "", nullptr, &pool);
+
+  BufferPtrs ingress;
+  for (auto i = 0; i < 2; ++i) {
+    const auto shape = {1UL};
+    InferenceRequestInput input{nullptr, shape, DataType::Uint8};
+    auto& buffer =
+      ingress.emplace_back(pool.get({MemoryAllocators::Cpu}, input, 1));
+    auto req = std::make_unique<RequestContainer>();
+    req->request = std::make_shared<InferenceRequest>();
+    req->request->addInputTensor(buffer->data(0), shape, DataType::Uint8);
+    batcher.enqueue(std::move(req));
+  }
+  batcher.start({MemoryAllocators::Cpu});
+
+  BatchPtr batch;
+  // in microseconds
+  constexpr int64_t kTimeout = 10'000'000;
+  ASSERT_TRUE(batcher.getOutputQueue()->wait_dequeue_timed(batch, kTimeout));
+  EXPECT_EQ(batch->size(), 2);
+  for (auto& buffer : batch->getInputBuffers()) {
+    pool.put(std::move(buffer));
+  }
+
+  batcher.enqueue(nullptr);
+  batcher.end();
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitSoftBatcher, CastInputs) {
+  MemoryPool pool;
+
+  SoftBatcher batcher(&pool);
+  batcher.setName("test");
+  batcher.setBatchSize(2);
+  batcher.setInputCasts({{"input", DataType::Fp32, 0.5F, -1.0F}});
+
+  WorkerInfo fake("", "", nullptr, &pool);
+  batcher.start({MemoryAllocators::Cpu});
+
+  const auto shape = {4UL};
+  InferenceRequestInput input{nullptr, shape, DataType::Uint8};
+  // the batcher returns the memory to the pool once it's copied so these are
+  // only kept to hold the buffer objects
+  BufferPtrs ingress;
+  for (auto i = 0; i < 2; ++i) {
+    auto& buffer =
+      ingress.emplace_back(pool.get({MemoryAllocators::Cpu}, input, 1));
+    auto* data = static_cast<uint8_t*>(buffer->data(0));
+    for (auto j = 0; j < 4; ++j) {
+      data[j] = static_cast<uint8_t>(i * 4 + j);
+    }
+
+    auto req = std::make_unique<RequestContainer>();
+    req->request = std::make_shared<InferenceRequest>();
+    req->request->addInputTensor(data, shape, DataType::Uint8);
+    batcher.enqueue(std::move(req));
+  }
+
+  BatchPtr batch;
+  batcher.getOutputQueue()->wait_dequeue(batch);
+  ASSERT_EQ(batch->size(), 2);
+  for (auto i = 0U; i < batch->size(); ++i) {
+    const auto& converted = batch->getRequest(i)->getInputs()[0];
+    EXPECT_EQ(converted.getDatatype(), DataType::Fp32);
+    const auto* values = static_cast<const float*>(converted.getData());
+    for (auto j = 0U; j < 4; ++j) {
+      EXPECT_EQ(values[j], static_cast<float>(i * 4 + j) * 0.5F - 1.0F);
+    }
+  }
+  EXPECT_EQ(batch->getRawInputBuffers()[0]->data(0),
+            batch->getRequest(0)->getInputs()[0].getData());
+
+  for (auto& buffer : batch->getInputBuffers()) {
+    pool.put(std::move(buffer));
+  }
+
+  batcher.enqueue(nullptr);
+  batcher.end();
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitSoftBatcher, TransposeInputs) {
+  MemoryPool pool;
+
+  SoftBatcher batcher(&pool);
+  batcher.setName("test");
+  batcher.setBatchSize(1);
+  batcher.setInputCasts(
+    {{"input", DataType::Fp32, 1.0F, 0.0F, InputLayout::NCHW}});
+
+  WorkerInfo fake("", "", nullptr, &pool);
+  batcher.start({MemoryAllocators::Cpu});
+
+  // a 2x2 image with 3 channels where each element is its HWC index
+  const std::vector<uint64_t> shape{2, 2, 3};
+  InferenceRequestInput input{nullptr, shape, DataType::Uint8};
+  auto ingress = pool.get({MemoryAllocators::Cpu}, input, 1);
+  auto* data = static_cast<uint8_t*>(ingress->data(0));
+  for (auto i = 0; i < 12; ++i) {
+    data[i] = static_cast<uint8_t>(i);
+  }
+  input.setData(data);
+  ParameterMap parameters;
+  parameters.put("layout", "NHWC");
+  input.setParameters(parameters);
+
+  auto req = std::make_unique<RequestContainer>();
+  req->request = std::make_shared<InferenceRequest>();
+  req->request->addInputTensor(input);
+  batcher.enqueue(std::move(req));
+
+  BatchPtr batch;
+  batcher.getOutputQueue()->wait_dequeue(batch);
+  ASSERT_EQ(batch->size(), 1);
+  const auto& converted = batch->getRequest(0)->getInputs()[0];
+  EXPECT_EQ(converted.getDatatype(), DataType::Fp32);
+  EXPECT_EQ(converted.getShape(), (std::vector<uint64_t>{3, 2, 2}));
+  EXPECT_EQ(converted.getParameters().get<std::string>("layout"), "NCHW");
+  const auto* values = static_cast<const float*>(converted.getData());
+  for (auto c = 0; c < 3; ++c) {
+    for (auto pixel = 0; pixel < 4; ++pixel) {
+      EXPECT_EQ(values[c * 4 + pixel], static_cast<float>(pixel * 3 + c));
+    }
+  }
+
+  for (auto& buffer : batch->getInputBuffers()) {
+    pool.put(std::move(buffer));
+  }
+
+  batcher.enqueue(nullptr);
+  batcher.end();
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitSoftBatcher, StopAfterQueued) {
+  MemoryPool pool;
+
+  SoftBatcher batcher(&pool);
+  batcher.setName("test");
+  batcher.setBatchSize(2);
+
+  WorkerInfo fake("", "", nullptr, &pool);
+
+  // more high priority requests than the starvation limit are queued ahead of
+  // the null request, as when an endpoint is unloaded while it's busy
+  const auto shape = {4UL};
+  InferenceRequestInput input{nullptr, shape, DataType::Uint8};
+  const auto requests = 4 * kDefaultStarvationLimit;
+  BufferPtrs ingress;
+  for (auto i = 0U; i < requests; ++i) {
+    auto& buffer =
+      ingress.emplace_back(pool.get({MemoryAllocators::Cpu}, input, 1));
+    auto req = std::make_unique<RequestContainer>();
+    req->request = std::make_shared<InferenceRequest>();
+    req->request->addInputTensor(buffer->data(0), shape, DataType::Uint8);
+    ParameterMap parameters;
+    parameters.put("priority", 1);
+    req->request->setParameters(parameters);
+    batcher.enqueue(std::move(req));
+  }
+  batcher.enqueue(nullptr);
+
+  // the batcher batches all of them before it stops
+  batcher.start({MemoryAllocators::Cpu});
+  batcher.end();
+
+  size_t batched = 0;
+  BatchPtr batch;
+  while (batcher.getOutputQueue()->try_dequeue(batch)) {
+    ASSERT_NE(batch, nullptr);
+    batched += batch->size();
+    respond(batch.get(), &pool);
+  }
+  EXPECT_EQ(batched, requests);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitSoftBatcher, CancelCoalesced) {
+  MemoryPool pool;
+
+  SoftBatcher batcher(&pool);
+  batcher.setName("test");
+  batcher.setBatchSize(1);
+
+  WorkerInfo fake("", "", nullptr, &pool);
   batcher.start({MemoryAllocators::Cpu});
 
+  const auto shape = {4UL};
+  InferenceRequestInput input{nullptr, shape, DataType::Uint8};
+  RequestCoalescer coalescer;
+  const std::atomic<bool> cancelled = true;
+  std::vector<InferenceResponse> responses;
+  const auto make_request = [&](const std::string& id, Buffer* buffer) {
+    auto req = std::make_unique<RequestContainer>();
+    req->request = std::make_shared<InferenceRequest>();
+    req->request->setID(id);
+    req->request->addInputTensor(buffer->data(0), shape, DataType::Uint8);
+    req->request->setCallback(
+      [&responses](const InferenceResponse& response) {
+        responses.push_back(response);
+      });
+    return req;
+  };
+  // set up the client's request to lead the identical ones as endpoints do
+  const auto lead = [&](RequestContainer* req) {
+    const auto key = *RequestCoalescer::key(*req);
+    EXPECT_FALSE(coalescer.join(key, req->request.get()));
+    req->request->setCallback(
+      [&coalescer, key](const InferenceResponse& response) {
+        coalescer.finish(key, response);
+      });
+    req->coalescer = &coalescer;
+    req->coalesce_key = key;
+    req->cancelled = &cancelled;
+  };
+
+  // the follower wasn't cancelled so the leader still runs for it. The batch
+  // and the batcher return the leaders' memory to the pool so their buffers
+  // are only kept to hold the buffer objects
+  auto leader_buffer = pool.get({MemoryAllocators::Cpu}, input, 1);
+  auto follower_buffer = pool.get({MemoryAllocators::Cpu}, input, 1);
+  std::memset(leader_buffer->data(0), 1, 4);
+  std::memset(follower_buffer->data(0), 1, 4);
+  auto leader = make_request("leader", leader_buffer.get());
+  lead(leader.get());
+  auto follower = make_request("follower", follower_buffer.get());
+  const auto key = *RequestCoalescer::key(*follower);
+  EXPECT_TRUE(coalescer.join(key, follower->request.get()));
+  pool.put(std::move(follower_buffer));
+  batcher.enqueue(std::move(leader));
+
+  BatchPtr batch;
+  batcher.getOutputQueue()->wait_dequeue(batch);
+  ASSERT_EQ(batch->size(), 1);
+  ASSERT_EQ(responses.size(), 1);
+  EXPECT_TRUE(responses[0].isError());
+  respond(batch.get(), &pool);
+  ASSERT_EQ(responses.size(), 2);
+  EXPECT_EQ(responses[1].getID(), "follower");
+  EXPECT_FALSE(responses[1].isError());
+  EXPECT_EQ(coalescer.size(), 0);
+
+  // without followers, the cancelled leader is dropped
+  responses.clear();
+  auto alone_buffer = pool.get({MemoryAllocators::Cpu}, input, 1);
+  std::memset(alone_buffer->data(0), 2, 4);
+  auto alone = make_request("alone", alone_buffer.get());
+  lead(alone.get());
+  batcher.enqueue(std::move(alone));
   batcher.enqueue(nullptr);
   batcher.end();
+  EXPECT_FALSE(batcher.getOutputQueue()->try_dequeue(batch));
+  ASSERT_EQ(responses.size(), 1);
+  EXPECT_TRUE(responses[0].isError());
+  EXPECT_EQ(coalescer.size(), 0);
 }
 
 }  // namespace amdinfer
@@ -96,7 +96,7 @@ class UnitSoftBatcherFixture : public testing::TestWithParam<BatchConfig> {
     this->batcher_->setName("test");
     this->batcher_->setBatchSize(batch_size);
 
-    this->worker_.emplace("", &parameters, &pool_);
+    this->worker_.emplace("", "", &parameters, &pool_);
     // for (size_t i = 0; i < buffer_num; i++) {
     //   BufferPtrs vec;
     //   vec.emplace_back(std::make_unique<VectorBuffer>(batch_size * data_size,
@@ -175,6 +175,17 @@ class UnitSoftBatcherFixture : public testing::TestWithParam<BatchConfig> {
     return request;
   }
 
+  // the request's data is written by the batcher directly into the batch
+  std::unique_ptr<RequestContainer> createDeferredRequest() {
+    auto req = std::make_unique<RequestContainer>();
+    req->request = std::make_shared<InferenceRequest>();
+    req->request->addInputTensor(nullptr, data_shape_, DataType::Uint8);
+    req->input_writers.emplace_back([this](Buffer* buffer, size_t offset) {
+      buffer->write(buffer_->data(0), offset, data_size_);
+    });
+    return req;
+  }
+
  private:
   int data_size_ = 0;
   BufferPtr buffer_;
@@ -200,6 +211,19 @@ TEST_P(UnitSoftBatcherFixture, BasicBatching) {  // NOLINT
   this->checkBatch();
 }
 
+TEST_P(UnitSoftBatcherFixture, DeferredBatching) {  // NOLINT
+  const auto& batch_config = GetParam();
+  auto requests = batch_config.requests;
+
+  for (const auto& i : requests) {
+    for (auto j = 0; j < i; ++j) {
+      this->enqueue(createDeferredRequest());
+    }
+  }
+
+  this->checkBatch();
+}
+
 // batch size, requests, golden # tensors per response,
 /**
  * The BatchConfig defines the configuration for the batcher. It has the
@@ -14,11 +14,14 @@
 
 #include <array>    // for array
 #include <cstddef>  // for size_t
+#include <cstdint>  // for uint8_t, uint32_t
 #include <memory>   // for allocator
+#include <vector>   // for vector
 
 #include "amdinfer/buffers/cpu.hpp"      // for CpuBuffer
 #include "amdinfer/core/data_types.hpp"  // for DataType, getSize, oper...
 #include "amdinfer/declarations.hpp"     // for BufferPtrs
+#include "amdinfer/util/convert.hpp"     // for kConvertChunkSize
 #include "amdinfer/util/queue.hpp"       // for BufferPtrsQueue
 #include "gtest/gtest.h"                 // for EXPECT_EQ, FAIL, UnitTest
 
@@ -78,16 +81,46 @@ TEST_P(UnitVectorBufferFixture, TestFixtureState) {  // NOLINT
 
 // Excluding STRING as it doesn't have a defined size to pre-allocate
 // NOLINTNEXTLINE(cert-err58-cpp)
-const std::array<DataType, 12> kDataTypes{
+const std::array<DataType, 13> kDataTypes{
   amdinfer::DataType::Bool,   amdinfer::DataType::Uint8,
   amdinfer::DataType::Uint16, amdinfer::DataType::Uint32,
   amdinfer::DataType::Uint64, amdinfer::DataType::Int8,
   amdinfer::DataType::Int16,  amdinfer::DataType::Int32,
   amdinfer::DataType::Int64,  amdinfer::DataType::Fp16,
-  amdinfer::DataType::Fp32,   amdinfer::DataType::Fp64};
+  amdinfer::DataType::Fp32,   amdinfer::DataType::Fp64,
+  amdinfer::DataType::Bf16};
 
 // NOLINTNEXTLINE(cert-err58-cpp)
 INSTANTIATE_TEST_SUITE_P(DataTypes, UnitVectorBufferFixture,
                          testing::ValuesIn(kDataTypes));
 
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitCpuBuffer, WriteAs) {
+  // more elements than are converted at a time
+  constexpr auto kCount = util::kConvertChunkSize + 3;
+  std::vector<uint32_t> wide(kCount);
+  for (auto i = 0U; i < kCount; ++i) {
+    wide[i] = i;
+  }
+
+  std::vector<std::byte> memory(kCount * sizeof(uint32_t));
+  CpuBuffer buffer{memory.data(), MemoryAllocators::Cpu};
+  auto offset = buffer.writeAs<uint8_t>(wide.data(), 0, kCount);
+  EXPECT_EQ(offset, kCount);
+  const auto* narrow = static_cast<uint8_t*>(buffer.data(0));
+  for (auto i = 0U; i < kCount; ++i) {
+    EXPECT_EQ(narrow[i], static_cast<uint8_t>(i));
+  }
+
+  // elements of the same type are copied as they are
+  offset = buffer.writeAs<uint32_t>(wide.data(), 0, kCount);
+  EXPECT_EQ(offset, kCount * sizeof(uint32_t));
+  EXPECT_EQ(*static_cast<uint32_t*>(buffer.data(sizeof(uint32_t) * 2)), 2);
+
+  const std::vector<float> floats{1.5F, -2.0F};
+  buffer.writeAs<fp16>(floats.data(), 0, floats.size());
+  EXPECT_EQ(static_cast<float>(*static_cast<fp16*>(buffer.data(sizeof(fp16)))),
+            -2.0F);
+}
+
 }  // namespace amdinfer
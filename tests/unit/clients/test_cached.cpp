@@ -0,0 +1,170 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>   // for atomic
+#include <chrono>   // for milliseconds
+#include <future>   // for promise
+#include <memory>   // for unique_ptr, make_unique
+#include <string>   // for string
+#include <thread>   // for sleep_for
+#include <tuple>    // for ignore
+#include <utility>  // for move
+#include <vector>   // for vector
+
+#include "amdinfer/clients/cached.hpp"           // for CachedClient
+#include "amdinfer/core/exceptions.hpp"          // for invalid_argument
+#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/core/model_metadata.hpp"      // for ModelMetadata
+#include "amdinfer/core/parameters.hpp"          // for ParameterMap
+#include "amdinfer/core/server_metadata.hpp"     // for ServerMetadata
+#include "gtest/gtest.h"                         // for Test, EXPECT_EQ
+
+namespace amdinfer {
+
+namespace {
+
+/// A server that counts the calls made to it
+class FakeClient : public Client {
+ public:
+  void setReady(bool ready) { ready_ = ready; }
+  void setError(bool error) { error_ = error; }
+  [[nodiscard]] int calls() const { return calls_; }
+
+  [[nodiscard]] ServerMetadata serverMetadata() const override {
+    calls_++;
+    return {};
+  }
+  [[nodiscard]] bool serverLive() const override { return true; }
+  [[nodiscard]] bool serverReady() const override { return true; }
+  [[nodiscard]] bool modelReady(const std::string&) const override {
+    calls_++;
+    return ready_;
+  }
+  [[nodiscard]] ModelMetadata modelMetadata(
+    const std::string& model) const override {
+    calls_++;
+    ModelMetadata metadata{model, ""};
+    metadata.setReady(ready_);
+    return metadata;
+  }
+  void modelLoad(const std::string&, const ParameterMap&) const override {}
+  void modelUnload(const std::string&) const override {}
+  [[nodiscard]] InferenceResponse modelInfer(
+    const std::string& model, const InferenceRequest& request) const override {
+    return modelInferAsync(model, request).get();
+  }
+  [[nodiscard]] InferenceResponseFuture modelInferAsync(
+    const std::string&, const InferenceRequest&) const override {
+    std::promise<InferenceResponse> promise;
+    promise.set_value(error_ ? InferenceResponse{"error"}
+                             : InferenceResponse{});
+    return promise.get_future();
+  }
+  [[nodiscard]] std::vector<std::string> modelList() const override {
+    return {};
+  }
+  std::string workerLoad(const std::string& worker,
+                         const ParameterMap&) const override {
+    return worker;
+  }
+  void workerUnload(const std::string&) const override {}
+  [[nodiscard]] bool hasHardware(const std::string&, int) const override {
+    return true;
+  }
+
+ private:
+  std::atomic<bool> ready_ = true;
+  std::atomic<bool> error_ = false;
+  mutable std::atomic<int> calls_ = 0;
+};
+
+}  // namespace
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitClientsCached, Construct) {
+  EXPECT_THROW(CachedClient(nullptr), invalid_argument);
+  EXPECT_THROW(CachedClient(std::make_unique<FakeClient>(),
+                            std::chrono::milliseconds(-1)),
+               invalid_argument);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitClientsCached, CacheReady) {
+  auto fake_client = std::make_unique<FakeClient>();
+  auto* fake = fake_client.get();
+  CachedClient client{std::move(fake_client), std::chrono::minutes(1)};
+
+  EXPECT_TRUE(client.modelReady("test"));
+  EXPECT_TRUE(client.modelReady("test"));
+  EXPECT_TRUE(client.modelMetadata("test").isReady());
+  EXPECT_TRUE(client.modelMetadata("test").isReady());
+  std::ignore = client.serverMetadata();
+  std::ignore = client.serverMetadata();
+  EXPECT_EQ(fake->calls(), 3);
+
+  // models are asked again after they're loaded or unloaded
+  client.modelLoad("test", {});
+  EXPECT_TRUE(client.modelReady("test"));
+  client.modelUnload("test");
+  fake->setReady(false);
+  EXPECT_FALSE(client.modelReady("test"));
+  EXPECT_EQ(fake->calls(), 5);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitClientsCached, SkipNotReady) {
+  auto fake_client = std::make_unique<FakeClient>();
+  auto* fake = fake_client.get();
+  CachedClient client{std::move(fake_client), std::chrono::minutes(1)};
+  fake->setReady(false);
+
+  EXPECT_FALSE(client.modelReady("test"));
+  EXPECT_FALSE(client.modelMetadata("test").isReady());
+  fake->setReady(true);
+  EXPECT_TRUE(client.modelReady("test"));
+  EXPECT_TRUE(client.modelMetadata("test").isReady());
+  EXPECT_EQ(fake->calls(), 4);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitClientsCached, Invalidate) {
+  auto fake_client = std::make_unique<FakeClient>();
+  auto* fake = fake_client.get();
+  CachedClient client{std::move(fake_client), std::chrono::minutes(1)};
+
+  EXPECT_TRUE(client.modelReady("test"));
+  fake->setError(true);
+  EXPECT_TRUE(client.modelInfer("test", InferenceRequest{}).isError());
+  EXPECT_TRUE(client.modelReady("test"));
+  client.invalidate("test");
+  EXPECT_TRUE(client.modelReady("test"));
+  client.invalidate();
+  EXPECT_TRUE(client.modelReady("test"));
+  EXPECT_EQ(fake->calls(), 4);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitClientsCached, Expire) {
+  auto fake_client = std::make_unique<FakeClient>();
+  auto* fake = fake_client.get();
+  CachedClient client{std::move(fake_client), std::chrono::milliseconds(10)};
+
+  EXPECT_TRUE(client.modelReady("test"));
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_TRUE(client.modelReady("test"));
+  EXPECT_EQ(fake->calls(), 2);
+}
+
+}  // namespace amdinfer
@@ -12,16 +12,23 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-#include <array>    // for array
-#include <cstddef>  // for byte
-#include <cstdint>  // for int16_t, int32_t
-#include <iomanip>  // for operator<<
-#include <memory>   // for allocator
+#include <algorithm>  // for equal
+#include <array>      // for array
+#include <cstddef>    // for byte
+#include <cstdint>    // for int16_t, int32_t
+#include <cstring>    // for memcpy
+#include <iomanip>    // for operator<<
+#include <memory>     // for allocator
+#include <string>     // for string
+#include <utility>    // for move
+#include <vector>     // for vector
 
 #include "amdinfer/clients/grpc_internal.hpp"    // for mapRequestToProto
+#include "amdinfer/core/compression.hpp"         // for CompressionOptions
 #include "amdinfer/core/data_types.hpp"          // for DataType, switchOver...
 #include "amdinfer/core/exceptions.hpp"          // for invalid_argument
 #include "amdinfer/core/inference_request.hpp"   // for InferenceRequestInput
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
 #include "amdinfer/observation/observer.hpp"     // for Logger, Observer
 #include "amdinfer/testing/observation.hpp"      // for initializeTestLogging
 #include "google/protobuf/repeated_ptr_field.h"  // for RepeatedPtrField
@@ -40,6 +47,7 @@ const int16_t kInt16Value = -2;
 const int32_t kInt32Value = -3;
 const int64_t kInt64Value = -4;
 const fp16 kFp16Value{1.4F};  // NOLINT(cert-err58-cpp)
+const bf16 kBf16Value{1.5F};  // NOLINT(cert-err58-cpp)
 const float kFloatValue = 2.7F;
 const double kDoubleValue = 3.6;
 const char kCharValue = 'x';
@@ -68,6 +76,8 @@ struct AssignData {
       data_cast[0] = kInt64Value;
     } else if constexpr (std::is_same_v<T, fp16>) {
       data_cast[0] = kFp16Value;
+    } else if constexpr (std::is_same_v<T, bf16>) {
+      data_cast[0] = kBf16Value;
     } else if constexpr (std::is_same_v<T, float>) {
       data_cast[0] = kFloatValue;
     } else if constexpr (std::is_same_v<T, double>) {
@@ -82,35 +92,38 @@ struct AssignData {
 
 struct CheckData {
   template <typename T>
-  void operator()(
-    const inference::ModelInferRequest_InferInputTensor* tensor) const {
-    auto* contents = getTensorContents<T>(tensor);
+  void operator()(const std::string& raw) const {
+    ASSERT_EQ(raw.size(), sizeof(T));
+    T value;
+    std::memcpy(&value, raw.data(), sizeof(T));
     if constexpr (std::is_same_v<T, bool>) {
-      EXPECT_EQ(*contents, kBoolValue);
+      EXPECT_EQ(value, kBoolValue);
     } else if constexpr (std::is_same_v<T, uint8_t>) {
-      EXPECT_EQ(*contents, kUint8Value);
+      EXPECT_EQ(value, kUint8Value);
     } else if constexpr (std::is_same_v<T, uint16_t>) {
-      EXPECT_EQ(*contents, kUint16Value);
+      EXPECT_EQ(value, kUint16Value);
     } else if constexpr (std::is_same_v<T, uint32_t>) {
-      EXPECT_EQ(*contents, kUint32Value);
+      EXPECT_EQ(value, kUint32Value);
     } else if constexpr (std::is_same_v<T, uint64_t>) {
-      EXPECT_EQ(*contents, kUint64Value);
+      EXPECT_EQ(value, kUint64Value);
     } else if constexpr (std::is_same_v<T, int8_t>) {
-      EXPECT_EQ(*contents, kInt8Value);
+      EXPECT_EQ(value, kInt8Value);
     } else if constexpr (std::is_same_v<T, int16_t>) {
-      EXPECT_EQ(*contents, kInt16Value);
+      EXPECT_EQ(value, kInt16Value);
     } else if constexpr (std::is_same_v<T, int32_t>) {
-      EXPECT_EQ(*contents, kInt32Value);
+      EXPECT_EQ(value, kInt32Value);
     } else if constexpr (std::is_same_v<T, int64_t>) {
-      EXPECT_EQ(*contents, kInt64Value);
+      EXPECT_EQ(value, kInt64Value);
     } else if constexpr (std::is_same_v<T, fp16>) {
-      EXPECT_FLOAT_EQ(*contents, kFp16Value);
+      EXPECT_FLOAT_EQ(value, kFp16Value);
+    } else if constexpr (std::is_same_v<T, bf16>) {
+      EXPECT_FLOAT_EQ(value, kBf16Value);
     } else if constexpr (std::is_same_v<T, float>) {
-      EXPECT_FLOAT_EQ(*contents, kFloatValue);
+      EXPECT_FLOAT_EQ(value, kFloatValue);
     } else if constexpr (std::is_same_v<T, double>) {
-      EXPECT_EQ(*contents, kDoubleValue);
+      EXPECT_EQ(value, kDoubleValue);
     } else if constexpr (std::is_same_v<T, char>) {
-      EXPECT_EQ(contents[0][0][0], kCharValue);
+      EXPECT_EQ(value, kCharValue);
     } else {
       throw invalid_argument("Unsupported datatype to CheckData");
     }
@@ -139,16 +152,63 @@ TEST_P(Fixture, TestRequestToProto) {  // NOLINT
   inference::ModelInferRequest proto_request;
   mapRequestToProto(request, proto_request, observer);
 
-  const auto& tensor = proto_request.inputs().at(0);
-  switchOverTypes(CheckData(), datatype, &tensor);
+  // the client sends the input data as raw contents
+  ASSERT_EQ(proto_request.raw_input_contents_size(), 1);
+  EXPECT_FALSE(proto_request.inputs().at(0).has_contents());
+  switchOverTypes(CheckData(), datatype, proto_request.raw_input_contents(0));
+}
+
+TEST_P(Fixture, TestRawResponseRoundTrip) {  // NOLINT
+  initializeTestLogging();
+  Observer observer;
+  AMDINFER_IF_LOGGING(observer.logger = Logger{Loggers::Test});
+
+  auto datatype = GetParam();
+
+  std::vector<std::byte> data(datatype.size());
+  switchOverTypes(AssignData(), datatype, data.data());
+
+  InferenceResponseOutput output;
+  output.setName("output");
+  output.setDatatype(datatype);
+  output.setShape({1});
+  auto output_data = data;
+  output.setData(std::move(output_data));
+  InferenceResponse response;
+  response.addOutput(output);
+
+  inference::ModelInferResponse proto_response;
+  mapResponseToProto(response, proto_response, true);
+  ASSERT_EQ(proto_response.raw_output_contents_size(), 1);
+  EXPECT_FALSE(proto_response.outputs(0).has_contents());
+  switchOverTypes(CheckData(), datatype, proto_response.raw_output_contents(0));
+
+  InferenceResponse mapped;
+  mapProtoToResponse(proto_response, mapped, observer);
+  const auto outputs = mapped.getOutputs();
+  ASSERT_EQ(outputs.size(), 1);
+  const auto* mapped_data =
+    static_cast<const std::byte*>(outputs[0].getData());
+  EXPECT_TRUE(std::equal(data.begin(), data.end(), mapped_data));
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitClientsGrpcInternal, CompressionAlgorithm) {
+  const CompressionOptions gzip{Compression::Gzip, 1024};
+  EXPECT_EQ(getCompressionAlgorithm(gzip, 1023), GRPC_COMPRESS_NONE);
+  EXPECT_EQ(getCompressionAlgorithm(gzip, 1024), GRPC_COMPRESS_GZIP);
+  const CompressionOptions deflate{Compression::Deflate, 0};
+  EXPECT_EQ(getCompressionAlgorithm(deflate, 0), GRPC_COMPRESS_DEFLATE);
+  EXPECT_EQ(getCompressionAlgorithm({}, 1U << 20U), GRPC_COMPRESS_NONE);
 }
 
 // we exclude STRING as it doesn't have a defined size we can pre-allocate
 // NOLINTNEXTLINE(cert-err58-cpp)
-const std::array<DataType, 12> kDataTypes{
+const std::array<DataType, 13> kDataTypes{
   DataType::Bool,   DataType::Uint8, DataType::Uint16, DataType::Uint32,
   DataType::Uint64, DataType::Int8,  DataType::Int16,  DataType::Int32,
-  DataType::Int64,  DataType::Fp16,  DataType::Fp32,   DataType::Fp64};
+  DataType::Int64,  DataType::Fp16,  DataType::Fp32,   DataType::Fp64,
+  DataType::Bf16};
 
 // NOLINTNEXTLINE(cert-err58-cpp)
 INSTANTIATE_TEST_SUITE_P(UnitClientsGrpcInternal, Fixture,
@@ -0,0 +1,166 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <json/value.h>   // for Value
+#include <json/writer.h>  // for StreamWriterBuilder
+
+#include <array>    // for array
+#include <cstddef>  // for byte
+#include <cstdint>  // for int32_t
+#include <cstring>  // for memcmp
+#include <string>   // for string
+#include <vector>   // for vector
+
+#include "amdinfer/clients/http_internal.hpp"    // for mapRequestToJson
+#include "amdinfer/core/bytes_tensor.hpp"        // for encodeBytes
+#include "amdinfer/core/data_types.hpp"          // for DataType
+#include "amdinfer/core/exceptions.hpp"          // for invalid_argument
+#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/core/model_metadata.hpp"      // for ModelMetadata
+#include "amdinfer/core/parameters.hpp"          // for ParameterMap
+#include "gtest/gtest.h"                         // for Test, EXPECT_EQ
+
+namespace amdinfer {
+
+/// Write and parse JSON so its numbers have the types that parsing gives them
+Json::Value reparse(const Json::Value& json) {
+  Json::StreamWriterBuilder builder;
+  const auto body = Json::writeString(builder, json);
+  Json::Value parsed;
+  splitBinaryBody(body, std::to_string(body.size()), &parsed);
+  return parsed;
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitClientsHttpInternal, BinaryRequest) {
+  std::array<float, 3> data{1.0F, 2.0F, 3.0F};
+  std::string str = "hello";
+
+  InferenceRequest request;
+  request.addInputTensor(data.data(), {data.size()}, DataType::Fp32, "floats");
+  request.addInputTensor(str.data(), {str.size()}, DataType::String, "str");
+
+  std::string binary;
+  auto json = mapRequestToJson(request, &binary);
+
+  // numeric data is moved out of the JSON and strings are left in it
+  const auto& inputs = json["inputs"];
+  ASSERT_EQ(inputs.size(), 2);
+  EXPECT_FALSE(inputs[0].isMember("data"));
+  EXPECT_EQ(inputs[0]["parameters"][kBinaryDataSize].asUInt64(),
+            sizeof(data));
+  EXPECT_EQ(inputs[1]["data"][0].asString(), str);
+  ASSERT_EQ(binary.size(), sizeof(data));
+  EXPECT_EQ(memcmp(binary.data(), data.data(), sizeof(data)), 0);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitClientsHttpInternal, WriteRequest) {
+  std::array<float, 3> data{1.5F, -2.0F, 3.0F};
+  std::string str = "say \"hi\"";
+  const auto bytes = encodeBytes(std::vector<std::string>{"a", "bc"});
+
+  InferenceRequest request;
+  request.setID("id");
+  ParameterMap parameters;
+  parameters.put("flag", true);
+  parameters.put("scale", 0.25);
+  parameters.put("count", 3);
+  parameters.put("mode", "fast");
+  request.setParameters(parameters);
+  request.addInputTensor(data.data(), {data.size()}, DataType::Fp32, "floats");
+  request.addInputTensor(str.data(), {str.size()}, DataType::String, "str");
+  request.addInputTensor(const_cast<std::byte*>(bytes.data()), {bytes.size()},
+                         DataType::Bytes, "bytes");
+
+  // the written JSON is the same as the mapped JSON
+  std::string body;
+  auto header_length = writeRequest(request, false, &body);
+  EXPECT_EQ(header_length, body.size());
+  Json::Value written;
+  EXPECT_TRUE(splitBinaryBody(body, std::to_string(header_length), &written)
+                .empty());
+  EXPECT_EQ(written, reparse(mapRequestToJson(request)));
+
+  // with the binary extension, the data follows the JSON in order
+  header_length = writeRequest(request, true, &body);
+  std::string binary;
+  auto expected = mapRequestToJson(request, &binary);
+  expected["parameters"]["binary_data_output"] = true;
+  const auto rest =
+    splitBinaryBody(body, std::to_string(header_length), &written);
+  EXPECT_EQ(written, reparse(expected));
+  EXPECT_EQ(rest, binary);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitClientsHttpInternal, BinaryResponse) {
+  std::array<int32_t, 2> data{-1, 7};
+
+  Json::Value json;
+  json["model_name"] = "model";
+  Json::Value output;
+  output["name"] = "output";
+  output["datatype"] = "INT32";
+  output["shape"].append(2);
+  output["parameters"][kBinaryDataSize] = static_cast<Json::UInt64>(8);
+  json["outputs"].append(output);
+
+  Json::StreamWriterBuilder builder;
+  builder["indentation"] = "";
+  auto body = Json::writeString(builder, json);
+  const auto header_length = std::to_string(body.size());
+  body.append(reinterpret_cast<const char*>(data.data()), sizeof(data));
+
+  Json::Value header;
+  auto binary = splitBinaryBody(body, header_length, &header);
+  EXPECT_EQ(binary.size(), sizeof(data));
+
+  auto response = mapJsonToResponse(&header, binary);
+  const auto outputs = response.getOutputs();
+  ASSERT_EQ(outputs.size(), 1);
+  ASSERT_EQ(outputs[0].getSize(), data.size());
+  const auto* mapped = static_cast<const int32_t*>(outputs[0].getData());
+  EXPECT_EQ(mapped[0], data[0]);
+  EXPECT_EQ(mapped[1], data[1]);
+
+  // the binary section must hold all the data that the header describes
+  EXPECT_THROW(mapJsonToResponse(&header, binary.substr(1)), invalid_argument);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitClientsHttpInternal, BinaryHeaderLength) {
+  const std::string body = "{}";
+  Json::Value json;
+  EXPECT_THROW(splitBinaryBody(body, "abc", &json), invalid_argument);
+  EXPECT_THROW(splitBinaryBody(body, "2x", &json), invalid_argument);
+  EXPECT_THROW(splitBinaryBody(body, "3", &json), invalid_argument);
+  EXPECT_TRUE(splitBinaryBody(body, "2", &json).empty());
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitClientsHttpInternal, ModelMetadataParameters) {
+  ModelMetadata metadata{"model", "onnx_onnxv1"};
+  EXPECT_FALSE(modelMetadataToJson(metadata).isMember("parameters"));
+
+  ParameterMap parameters;
+  parameters.put("precision", "fp16");
+  metadata.setParameters(parameters);
+  const auto json = reparse(modelMetadataToJson(metadata));
+  const auto mapped = mapJsonToModelMetadata(&json);
+  EXPECT_EQ(mapped.getParameters().get<std::string>("precision"), "fp16");
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,136 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <json/reader.h>  // for CharReaderBuilder, CharReader
+#include <json/value.h>   // for Value
+
+#include <cstdint>  // for int8_t, uint64_t
+#include <limits>   // for numeric_limits
+#include <memory>   // for unique_ptr
+#include <string>   // for string
+#include <vector>   // for vector
+
+#include "amdinfer/clients/json_writer.hpp"  // for JsonWriter
+#include "amdinfer/core/bytes_tensor.hpp"    // for encodeBytes
+#include "amdinfer/core/data_types.hpp"      // for DataType
+#include "gtest/gtest.h"                     // for Test, EXPECT_EQ
+
+namespace amdinfer {
+
+namespace {
+
+Json::Value parse(const std::string& text) {
+  Json::CharReaderBuilder builder;
+  const std::unique_ptr<Json::CharReader> reader{builder.newCharReader()};
+  Json::Value json;
+  std::string errors;
+  EXPECT_TRUE(
+    reader->parse(text.data(), text.data() + text.size(), &json, &errors))
+    << errors;
+  return json;
+}
+
+std::string writeArray(DataType datatype, const void* data, size_t count) {
+  std::string out;
+  JsonWriter writer{&out};
+  writer.array(datatype, data, count);
+  EXPECT_LE(out.size(), getMaxJsonSize(datatype, count));
+  return out;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitServersJsonWriter, Object) {
+  std::string out;
+  JsonWriter writer{&out};
+  writer.beginObject();
+  writer.key("id");
+  writer.string("a \"quoted\"\n\x01 id");
+  writer.key("outputs");
+  writer.beginArray();
+  for (auto i = 0; i < 2; ++i) {
+    writer.beginObject();
+    writer.key("shape");
+    writer.beginArray();
+    writer.number(uint64_t{2});
+    writer.endArray();
+    writer.key("data");
+    const std::vector<float> data{1.0F, -0.5F + static_cast<float>(i)};
+    writer.array(DataType::Fp32, data.data(), data.size());
+    writer.endObject();
+  }
+  writer.endArray();
+  writer.key("parameters");
+  Json::Value parameters;
+  parameters["key"] = "value";
+  writer.json(parameters);
+  writer.key("done");
+  writer.boolean(true);
+  writer.endObject();
+
+  const auto json = parse(out);
+  EXPECT_EQ(json["id"].asString(), "a \"quoted\"\n\x01 id");
+  ASSERT_EQ(json["outputs"].size(), 2);
+  EXPECT_EQ(json["outputs"][1]["shape"][0].asUInt64(), 2);
+  EXPECT_EQ(json["outputs"][1]["data"][1].asFloat(), 0.5F);
+  EXPECT_EQ(json["parameters"]["key"].asString(), "value");
+  EXPECT_TRUE(json["done"].asBool());
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitServersJsonWriter, Numbers) {
+  // floats get their shortest text that reads back as the same value
+  const std::vector<float> floats{0.1F, 5.0F, -1e-20F,
+                                  std::numeric_limits<float>::lowest(),
+                                  std::numeric_limits<float>::quiet_NaN()};
+  const auto text = writeArray(DataType::Fp32, floats.data(), floats.size());
+  EXPECT_EQ(text.substr(0, 14), "[0.1,5.0,-1e-2");
+  const auto json = parse(text);
+  for (auto i = 0U; i + 1 < floats.size(); ++i) {
+    EXPECT_EQ(json[i].asFloat(), floats[i]);
+  }
+  EXPECT_TRUE(json[4].isNull());
+
+  const std::vector<double> doubles{0.1, std::numeric_limits<double>::min()};
+  const auto double_json =
+    parse(writeArray(DataType::Fp64, doubles.data(), doubles.size()));
+  EXPECT_EQ(double_json[0].asDouble(), 0.1);
+  EXPECT_EQ(double_json[1].asDouble(), doubles[1]);
+
+  const std::vector<int8_t> ints{-128, 0, 127};
+  EXPECT_EQ(writeArray(DataType::Int8, ints.data(), ints.size()),
+            "[-128,0,127]");
+  const std::vector<uint64_t> longs{std::numeric_limits<uint64_t>::max()};
+  EXPECT_EQ(writeArray(DataType::Uint64, longs.data(), longs.size()),
+            "[18446744073709551615]");
+  const std::vector<fp16> halfs{fp16{0.5F}};
+  EXPECT_EQ(writeArray(DataType::Fp16, halfs.data(), halfs.size()), "[0.5]");
+  const bool flags[] = {true, false};  // NOLINT(*-avoid-c-arrays)
+  EXPECT_EQ(writeArray(DataType::Bool, flags, 2), "[true,false]");
+  EXPECT_EQ(writeArray(DataType::Fp32, nullptr, 0), "[]");
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitServersJsonWriter, Strings) {
+  const std::string text = "a\tb";
+  EXPECT_EQ(writeArray(DataType::String, text.data(), text.size()),
+            R"(["a\tb"])");
+
+  const auto bytes = encodeBytes(std::vector<std::string>{"x", "", "y\"z"});
+  EXPECT_EQ(writeArray(DataType::Bytes, bytes.data(), bytes.size()),
+            R"(["x","","y\"z"])");
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,161 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>   // for atomic
+#include <chrono>   // for milliseconds
+#include <future>   // for promise
+#include <memory>   // for unique_ptr, make_unique
+#include <mutex>    // for mutex, lock_guard
+#include <string>   // for string
+#include <thread>   // for thread, sleep_for
+#include <utility>  // for move
+#include <vector>   // for vector
+
+#include "amdinfer/clients/replicated.hpp"       // for ReplicatedClient
+#include "amdinfer/core/exceptions.hpp"          // for invalid_argument
+#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/core/model_metadata.hpp"      // for ModelMetadata
+#include "amdinfer/core/server_metadata.hpp"     // for ServerMetadata
+#include "gtest/gtest.h"                         // for Test, EXPECT_EQ
+
+namespace amdinfer {
+
+namespace {
+
+/// A replica that responds to each request after its delay
+class FakeClient : public Client {
+ public:
+  explicit FakeClient(std::chrono::milliseconds delay) : delay_(delay) {}
+  FakeClient(const FakeClient&) = delete;
+  FakeClient& operator=(const FakeClient&) = delete;
+  FakeClient(FakeClient&&) = delete;
+  FakeClient& operator=(FakeClient&&) = delete;
+  ~FakeClient() override {
+    for (auto& thread : threads_) {
+      thread.join();
+    }
+  }
+
+  void setDelay(std::chrono::milliseconds delay) { delay_ = delay; }
+  [[nodiscard]] int requests() const { return requests_; }
+
+  [[nodiscard]] ServerMetadata serverMetadata() const override { return {}; }
+  [[nodiscard]] bool serverLive() const override { return true; }
+  [[nodiscard]] bool serverReady() const override { return true; }
+  [[nodiscard]] bool modelReady(const std::string&) const override {
+    return true;
+  }
+  [[nodiscard]] ModelMetadata modelMetadata(
+    const std::string& model) const override {
+    return ModelMetadata{model, ""};
+  }
+  void modelLoad(const std::string&, const ParameterMap&) const override {}
+  void modelUnload(const std::string&) const override {}
+  [[nodiscard]] InferenceResponse modelInfer(
+    const std::string& model, const InferenceRequest& request) const override {
+    return modelInferAsync(model, request).get();
+  }
+  [[nodiscard]] InferenceResponseFuture modelInferAsync(
+    const std::string&, const InferenceRequest&) const override {
+    requests_++;
+    std::promise<InferenceResponse> promise;
+    auto future = promise.get_future();
+    std::lock_guard lock{mutex_};
+    threads_.emplace_back(
+      [delay = delay_.load(), promise = std::move(promise)]() mutable {
+        std::this_thread::sleep_for(delay);
+        promise.set_value(InferenceResponse{});
+      });
+    return future;
+  }
+  [[nodiscard]] std::vector<std::string> modelList() const override {
+    return {};
+  }
+  std::string workerLoad(const std::string& worker,
+                         const ParameterMap&) const override {
+    return worker;
+  }
+  void workerUnload(const std::string&) const override {}
+  [[nodiscard]] bool hasHardware(const std::string&, int) const override {
+    return true;
+  }
+
+ private:
+  std::atomic<std::chrono::milliseconds> delay_;
+  mutable std::atomic<int> requests_ = 0;
+  mutable std::mutex mutex_;
+  mutable std::vector<std::thread> threads_;
+};
+
+}  // namespace
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitClientsReplicated, Construct) {
+  EXPECT_THROW(ReplicatedClient({}), invalid_argument);
+
+  std::vector<std::unique_ptr<Client>> replicas;
+  replicas.push_back(std::make_unique<FakeClient>(std::chrono::milliseconds(0)));
+  EXPECT_THROW(ReplicatedClient(std::move(replicas), 1), invalid_argument);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitClientsReplicated, PreferFastest) {
+  auto fast = std::make_unique<FakeClient>(std::chrono::milliseconds(1));
+  auto slow = std::make_unique<FakeClient>(std::chrono::milliseconds(50));
+  auto* fast_ptr = fast.get();
+  auto* slow_ptr = slow.get();
+  std::vector<std::unique_ptr<Client>> replicas;
+  replicas.push_back(std::move(slow));
+  replicas.push_back(std::move(fast));
+  ReplicatedClient client{std::move(replicas)};
+
+  const auto requests = 10;
+  for (auto i = 0; i < requests; ++i) {
+    EXPECT_FALSE(client.modelInfer("test", InferenceRequest{}).isError());
+  }
+  // the slow replica is only tried until it's been measured
+  EXPECT_EQ(slow_ptr->requests(), 1);
+  EXPECT_EQ(fast_ptr->requests(), requests - 1);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitClientsReplicated, Hedge) {
+  auto first = std::make_unique<FakeClient>(std::chrono::milliseconds(1));
+  auto second = std::make_unique<FakeClient>(std::chrono::milliseconds(5));
+  auto* first_ptr = first.get();
+  auto* second_ptr = second.get();
+  std::vector<std::unique_ptr<Client>> replicas;
+  replicas.push_back(std::move(first));
+  replicas.push_back(std::move(second));
+  ReplicatedClient client{std::move(replicas), 0.5};
+
+  // record enough latencies for hedging with the first replica the fastest
+  const auto warmup = 20;
+  for (auto i = 0; i < warmup; ++i) {
+    EXPECT_FALSE(client.modelInfer("test", InferenceRequest{}).isError());
+  }
+  const auto second_requests = second_ptr->requests();
+
+  first_ptr->setDelay(std::chrono::milliseconds(500));
+  const auto start = std::chrono::steady_clock::now();
+  EXPECT_FALSE(client.modelInfer("test", InferenceRequest{}).isError());
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+
+  // the request is answered by the duplicate sent to the second replica
+  EXPECT_LT(elapsed, std::chrono::milliseconds(250));
+  EXPECT_EQ(second_ptr->requests(), second_requests + 1);
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,131 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <array>    // for array
+#include <cstdint>  // for int32_t
+#include <cstring>  // for memcmp
+#include <string>   // for string
+#include <vector>   // for vector
+
+#include "amdinfer/clients/websocket_internal.hpp"  // for encodeRequestFrame
+#include "amdinfer/core/data_types.hpp"             // for DataType
+#include "amdinfer/core/exceptions.hpp"             // for invalid_argument
+#include "amdinfer/core/inference_request.hpp"      // for InferenceRequest
+#include "amdinfer/core/inference_response.hpp"     // for InferenceResponse
+#include "gtest/gtest.h"                            // for Test, EXPECT_EQ
+
+namespace amdinfer {
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitClientsWebsocketInternal, RequestFrame) {
+  std::array<float, 3> data{1.0F, 2.0F, 3.0F};
+  std::string str = "video.mp4";
+
+  InferenceRequest request;
+  request.setID("7");
+  ParameterMap parameters;
+  parameters.put("key", "0");
+  parameters.put("binary", true);
+  parameters.put("scale", 0.5);
+  request.setParameters(parameters);
+  request.addInputTensor(data.data(), {1, data.size()}, DataType::Fp32,
+                         "floats");
+  InferenceRequestInput input{str.data(), {str.size()}, DataType::String,
+                              "str"};
+  ParameterMap input_parameters;
+  input_parameters.put("count", 100);
+  input.setParameters(input_parameters);
+  request.addInputTensor(input);
+
+  const auto message = encodeRequestFrame("model", request);
+  const auto frame = decodeFrame(message);
+
+  EXPECT_EQ(frame.model, "model");
+  EXPECT_EQ(frame.id, "7");
+  EXPECT_FALSE(frame.error);
+  EXPECT_EQ(frame.parameters.size(), 3);
+  EXPECT_EQ(frame.parameters.get<std::string>("key"), "0");
+  EXPECT_TRUE(frame.parameters.get<bool>("binary"));
+  EXPECT_DOUBLE_EQ(frame.parameters.get<double>("scale"), 0.5);
+  ASSERT_EQ(frame.tensors.size(), 2);
+
+  const auto& floats = frame.tensors[0];
+  EXPECT_EQ(floats.name, "floats");
+  EXPECT_EQ(floats.datatype, DataType::Fp32);
+  EXPECT_EQ(floats.shape, (std::vector<uint64_t>{1, data.size()}));
+  ASSERT_EQ(floats.data.size(), sizeof(data));
+  EXPECT_EQ(memcmp(floats.data.data(), data.data(), sizeof(data)), 0);
+
+  const auto& strings = frame.tensors[1];
+  EXPECT_EQ(strings.datatype, DataType::String);
+  EXPECT_EQ(strings.parameters.get<int32_t>("count"), 100);
+  EXPECT_EQ(strings.data, str);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitClientsWebsocketInternal, ResponseFrame) {
+  std::array<int32_t, 2> data{-1, 7};
+
+  InferenceResponse response;
+  response.setID("id");
+  response.setModel("model");
+  InferenceResponseOutput output;
+  output.setName("output");
+  output.setDatatype(DataType::Int32);
+  output.setShape({data.size()});
+  std::vector<std::byte> buffer(sizeof(data));
+  memcpy(buffer.data(), data.data(), sizeof(data));
+  output.setData(std::move(buffer));
+  response.addOutput(output);
+
+  const auto decoded = decodeResponseFrame(encodeResponseFrame(response));
+  EXPECT_FALSE(decoded.isError());
+  EXPECT_EQ(decoded.getID(), "id");
+  EXPECT_EQ(decoded.getModel(), "model");
+  const auto& outputs = decoded.getOutputs();
+  ASSERT_EQ(outputs.size(), 1);
+  EXPECT_EQ(outputs[0].getName(), "output");
+  ASSERT_EQ(outputs[0].getSize(), data.size());
+  const auto* mapped = static_cast<const int32_t*>(outputs[0].getData());
+  EXPECT_EQ(mapped[0], data[0]);
+  EXPECT_EQ(mapped[1], data[1]);
+
+  InferenceResponse error{"failed"};
+  error.setID("id");
+  const auto decoded_error = decodeResponseFrame(encodeResponseFrame(error));
+  EXPECT_TRUE(decoded_error.isError());
+  EXPECT_EQ(decoded_error.getError(), "failed");
+  EXPECT_EQ(decoded_error.getID(), "id");
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitClientsWebsocketInternal, InvalidFrame) {
+  std::array<float, 2> data{1.0F, 2.0F};
+  InferenceRequest request;
+  request.addInputTensor(data.data(), {data.size()}, DataType::Fp32, "input");
+  const auto message = encodeRequestFrame("model", request);
+
+  EXPECT_NO_THROW(decodeFrame(message));
+  // every truncated frame is rejected rather than read out of bounds
+  for (auto i = 0U; i < message.size(); ++i) {
+    EXPECT_THROW(decodeFrame(message.substr(0, i)), invalid_argument);
+  }
+  EXPECT_THROW(decodeFrame(message + "x"), invalid_argument);
+
+  auto version = message;
+  version[0] = 2;
+  EXPECT_THROW(decodeFrame(version), invalid_argument);
+}
+
+}  // namespace amdinfer
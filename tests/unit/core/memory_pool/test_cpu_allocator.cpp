@@ -22,6 +22,9 @@
 // #include <string>   // for string, basic_string, alloc...
 // #include <vector>   // for vector
 
+#include <cstdint>  // for uintptr_t, uint8_t
+#include <vector>   // for vector
+
 #include "amdinfer/buffers/buffer.hpp"  // for BufferPtr
 #include "amdinfer/core/exceptions.hpp"
 #include "amdinfer/core/inference_request.hpp"  // for InferenceRequestInput
@@ -100,4 +103,104 @@ TEST(UnitCpuAllocator, BadFree) {
                      , runtime_error);
 }
 
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitCpuAllocator, Stats) {
+  constexpr auto kBlockSize = sizeof(int) * 4;
+  CpuAllocator allocator{kBlockSize, kBlockSize};
+  InferenceRequestInput input{nullptr, {1}, DataType::Int32};
+
+  const auto buffer_0 = allocator.get(input, 1);
+  auto stats = allocator.getStats();
+  EXPECT_EQ(stats.allocated, kBlockSize);
+  EXPECT_EQ(stats.in_use, sizeof(int));
+  EXPECT_EQ(stats.largest_free, kBlockSize - sizeof(int));
+  EXPECT_EQ(stats.failures, 0);
+
+  EXPECT_THROW(std::ignore = allocator.get(input, 4), runtime_error);
+  allocator.put(buffer_0->data(0));
+  stats = allocator.getStats();
+  EXPECT_EQ(stats.in_use, 0);
+  EXPECT_EQ(stats.largest_free, kBlockSize);
+  EXPECT_EQ(stats.failures, 1);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitCpuAllocator, Alignment) {
+  constexpr auto kAlignment = 64;
+  CpuAllocator allocator{kAlignment * 4, kAlignment * 4, kAlignment};
+  InferenceRequestInput input{nullptr, {1}, DataType::Int32};
+
+  const auto buffer_0 = allocator.get(input, 1);
+  const auto buffer_1 = allocator.get(input, 1);
+  EXPECT_EQ(buffer_0->size(), sizeof(int));
+  const auto address_0 = reinterpret_cast<uintptr_t>(buffer_0->data(0));
+  const auto address_1 = reinterpret_cast<uintptr_t>(buffer_1->data(0));
+  EXPECT_EQ(address_0 % kAlignment, 0);
+  EXPECT_EQ(address_1, address_0 + kAlignment);
+  EXPECT_EQ(allocator.getStats().in_use, kAlignment * 2);
+
+  allocator.put(buffer_0->data(0));
+  allocator.put(buffer_1->data(0));
+
+  EXPECT_THROW(CpuAllocator(1, -1, 3), invalid_argument);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitCpuAllocator, HugeBlock) {
+  // blocks of at least a huge page are aligned to one
+  constexpr size_t kHugePageSize = 2'097'152;
+  CpuAllocator allocator{kHugePageSize};
+  InferenceRequestInput input{nullptr, {kHugePageSize + 1}, DataType::Uint8};
+
+  const auto buffer = allocator.get(input, 1);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(buffer->data(0)) % kHugePageSize, 0);
+  // the memory starts zeroed
+  auto* data = static_cast<uint8_t*>(buffer->data(0));
+  EXPECT_EQ(data[kHugePageSize], 0);
+  buffer->write(uint8_t{1}, kHugePageSize);
+  EXPECT_EQ(data[kHugePageSize], 1);
+
+  allocator.put(buffer->data(0));
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitCpuAllocator, Trim) {
+  constexpr auto kBlockSize = sizeof(int) * 2;
+  CpuAllocator allocator{kBlockSize};
+  InferenceRequestInput input{nullptr, {1}, DataType::Int32};
+
+  // three blocks where the middle one has a buffer left in it
+  std::vector<BufferPtr> buffers;
+  for (auto i = 0; i < 6; ++i) {
+    buffers.push_back(allocator.get(input, 1));
+  }
+  auto* kept = buffers[2]->data(0);
+  for (auto i = 0U; i < buffers.size(); ++i) {
+    if (i != 2) {
+      allocator.put(buffers[i]->data(0));
+    }
+  }
+  auto stats = allocator.getStats();
+  EXPECT_EQ(stats.allocated, kBlockSize * 3);
+  // the free memory is split between the blocks
+  EXPECT_DOUBLE_EQ(stats.fragmentation, 0.6);
+
+  // the newest idle block goes first and blocks in use are kept
+  EXPECT_EQ(allocator.trim(kBlockSize * 2), kBlockSize);
+  EXPECT_EQ(allocator.getStats().allocated, kBlockSize * 2);
+  EXPECT_EQ(allocator.trim(0), kBlockSize);
+  stats = allocator.getStats();
+  EXPECT_EQ(stats.allocated, kBlockSize);
+  EXPECT_EQ(stats.in_use, sizeof(int));
+
+  allocator.put(kept);
+  EXPECT_EQ(allocator.trim(0), kBlockSize);
+  EXPECT_EQ(allocator.getStats().allocated, 0);
+
+  // memory is allocated again after trimming
+  const auto buffer = allocator.get(input, 1);
+  EXPECT_EQ(allocator.getStats().allocated, kBlockSize);
+  allocator.put(buffer->data(0));
+}
+
 }  // namespace amdinfer
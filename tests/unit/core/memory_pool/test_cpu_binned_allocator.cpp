@@ -0,0 +1,143 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief
+ */
+
+#include "amdinfer/buffers/buffer.hpp"  // for BufferPtr
+#include "amdinfer/core/exceptions.hpp"
+#include "amdinfer/core/inference_request.hpp"  // for InferenceRequestInput
+#include "amdinfer/core/memory_pool/cpu_binned_allocator.hpp"
+#include "amdinfer/testing/gtest.hpp"  // for AssertionResult,...
+
+namespace amdinfer {
+
+// the smallest size class used by the allocator
+constexpr auto kMinBinSize = 64;
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitCpuBinnedAllocator, Basic) {
+  CpuBinnedAllocator allocator{kMinBinSize * 4};
+  InferenceRequestInput input{nullptr, {1}, DataType::Int32};
+
+  const auto buffer_0 = allocator.get(input, 1);
+  const auto buffer_1 = allocator.get(input, 1);
+  EXPECT_EQ(buffer_0->getAllocator(), MemoryAllocators::CpuBinned);
+
+  auto* address_0 = static_cast<std::byte*>(buffer_0->data(0));
+  auto* address_1 = static_cast<std::byte*>(buffer_1->data(0));
+  ASSERT_EQ(address_0 + kMinBinSize, address_1);
+
+  allocator.put(address_0);
+  allocator.put(address_1);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitCpuBinnedAllocator, Reuse) {
+  CpuBinnedAllocator allocator{kMinBinSize * 2, kMinBinSize * 2};
+  InferenceRequestInput input{nullptr, {1}, DataType::Int32};
+
+  const auto buffer_0 = allocator.get(input, 1);
+  const auto buffer_1 = allocator.get(input, 1);
+  const auto* address_0 = buffer_0->data(0);
+
+  allocator.put(address_0);
+  const auto buffer_2 = allocator.get(input, 1);
+  ASSERT_EQ(address_0, buffer_2->data(0));
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitCpuBinnedAllocator, SizeClasses) {
+  const auto block_size = kMinBinSize * 4;
+  CpuBinnedAllocator allocator{block_size};
+  // 33 ints don't fit in 128 bytes so this goes into the 256 byte class
+  InferenceRequestInput input{nullptr, {33}, DataType::Int32};
+
+  const auto buffer_0 = allocator.get(input, 1);
+  const auto buffer_1 = allocator.get(input, 1);
+  ASSERT_NE(buffer_0->data(0), buffer_1->data(0));
+
+  // chunks larger than the block size are allocated individually
+  const auto buffer_2 = allocator.get(input, 2);
+  allocator.put(buffer_2->data(0));
+  const auto buffer_3 = allocator.get(input, 2);
+  ASSERT_EQ(buffer_2->data(0), buffer_3->data(0));
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitCpuBinnedAllocator, ExceedingMax) {
+  CpuBinnedAllocator allocator{kMinBinSize, kMinBinSize};
+  InferenceRequestInput input{nullptr, {1}, DataType::Int32};
+
+  std::ignore = allocator.get(input, 1);
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-goto, hicpp-avoid-goto)
+  EXPECT_THROW_CHECK(std::ignore = allocator.get(input, 1);
+                     , EXPECT_STREQ(e.what(), "Too much requested");
+                     , runtime_error);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitCpuBinnedAllocator, LargerThanBins) {
+  CpuBinnedAllocator allocator{kMinBinSize};
+  InferenceRequestInput input{nullptr, {1}, DataType::Uint8};
+
+  // one byte more than the largest class
+  const auto batch_size = (size_t{1} << 63) + 1;
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-goto, hicpp-avoid-goto)
+  EXPECT_THROW_CHECK(std::ignore = allocator.get(input, batch_size);
+                     , EXPECT_STREQ(e.what(), "Too much requested");
+                     , runtime_error);
+  EXPECT_EQ(allocator.getStats().failures, 1);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitCpuBinnedAllocator, BadFree) {
+  CpuBinnedAllocator allocator{kMinBinSize};
+  InferenceRequestInput input{nullptr, {1}, DataType::Int32};
+
+  const auto buffer_0 = allocator.get(input, 1);
+  const auto* address_0 = static_cast<int*>(buffer_0->data(0));
+  const auto* bad_address = address_0 + 1;
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-goto, hicpp-avoid-goto)
+  EXPECT_THROW_CHECK(allocator.put(bad_address);
+                     , EXPECT_STREQ(e.what(), "Address not found");
+                     , runtime_error);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitCpuBinnedAllocator, Stats) {
+  constexpr auto kBlockSize = kMinBinSize * 4;
+  CpuBinnedAllocator allocator{kBlockSize, kBlockSize};
+  InferenceRequestInput input{nullptr, {1}, DataType::Int32};
+
+  // the buffer uses a whole chunk of the smallest class
+  const auto buffer_0 = allocator.get(input, 1);
+  auto stats = allocator.getStats();
+  EXPECT_EQ(stats.allocated, kBlockSize);
+  EXPECT_EQ(stats.in_use, kMinBinSize);
+  EXPECT_EQ(stats.largest_free, kMinBinSize);
+  EXPECT_EQ(stats.failures, 0);
+
+  // a larger class needs a new block, which exceeds the maximum
+  InferenceRequestInput large{nullptr, {kMinBinSize * 2}, DataType::Uint8};
+  EXPECT_THROW(std::ignore = allocator.get(large, 1), runtime_error);
+  allocator.put(buffer_0->data(0));
+  stats = allocator.getStats();
+  EXPECT_EQ(stats.in_use, 0);
+  EXPECT_EQ(stats.failures, 1);
+}
+
+}  // namespace amdinfer
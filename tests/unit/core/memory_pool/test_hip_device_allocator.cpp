@@ -0,0 +1,77 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Tests the HipDeviceAllocator
+ */
+
+#include <hip/hip_runtime_api.h>  // for hipSetDevice
+
+#include "amdinfer/buffers/buffer.hpp"  // for BufferPtr
+#include "amdinfer/core/exceptions.hpp"
+#include "amdinfer/core/inference_request.hpp"  // for InferenceRequestInput
+#include "amdinfer/core/memory_pool/hip_device_allocator.hpp"
+#include "amdinfer/testing/gtest.hpp"  // for AssertionResult,...
+
+namespace amdinfer {
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitHipDeviceAllocator, Reuse) {
+  HipDeviceAllocator allocator{sizeof(int) * 4, sizeof(int) * 4};
+  InferenceRequestInput input{nullptr, {1}, DataType::Int32};
+
+  auto buffer_0 = allocator.get(input, 1);
+  EXPECT_EQ(buffer_0->getAllocator(), MemoryAllocators::HipDevice);
+  auto* address_0 = buffer_0->data(0);
+
+  // the memory is on the device so it's written and read with copies
+  const int value = 42;
+  buffer_0->write(value, 0);
+  int read = 0;
+  buffer_0->read(&read, 0, sizeof(read));
+  EXPECT_EQ(read, value);
+
+  allocator.put(address_0);
+  const auto buffer_1 = allocator.get(input, 1);
+  EXPECT_EQ(buffer_1->data(0), address_0);
+
+  // it's bounded on each device like the CpuAllocator
+  EXPECT_THROW((void)allocator.get(input, 4), runtime_error);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitHipDeviceAllocator, Devices) {
+  int devices = 0;
+  if (hipGetDeviceCount(&devices) != hipSuccess || devices < 2) {
+    GTEST_SKIP() << "This test needs two GPUs";
+  }
+  HipDeviceAllocator allocator{sizeof(int) * 4, sizeof(int) * 4};
+  InferenceRequestInput input{nullptr, {4}, DataType::Int32};
+
+  // each device has its own memory so a full device doesn't affect another
+  ASSERT_EQ(hipSetDevice(0), hipSuccess);
+  auto* address_0 = allocator.get(input, 1)->data(0);
+  ASSERT_EQ(hipSetDevice(1), hipSuccess);
+  auto* address_1 = allocator.get(input, 1)->data(0);
+  EXPECT_NE(address_0, address_1);
+  EXPECT_EQ(allocator.getStats().in_use, sizeof(int) * 8);
+
+  // addresses are returned to the device they're on from any device
+  allocator.put(address_0);
+  allocator.put(address_1);
+  EXPECT_EQ(allocator.getStats().in_use, 0U);
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,54 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file
+ * @brief Tests the PinnedHostAllocator
+ */
+
+#include <cstring>  // for memcpy
+
+#include "amdinfer/buffers/buffer.hpp"  // for BufferPtr
+#include "amdinfer/core/exceptions.hpp"
+#include "amdinfer/core/inference_request.hpp"  // for InferenceRequestInput
+#include "amdinfer/core/memory_pool/pinned_host_allocator.hpp"
+#include "amdinfer/testing/gtest.hpp"  // for AssertionResult,...
+
+namespace amdinfer {
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitPinnedHostAllocator, Reuse) {
+  PinnedHostAllocator allocator{sizeof(int) * 4, sizeof(int) * 4};
+  InferenceRequestInput input{nullptr, {1}, DataType::Int32};
+
+  const auto buffer_0 = allocator.get(input, 1);
+  EXPECT_EQ(buffer_0->getAllocator(), MemoryAllocators::PinnedHost);
+  const auto* address_0 = static_cast<int*>(buffer_0->data(0));
+
+  // the memory is host memory so it's written and read like any other
+  const int value = 42;
+  buffer_0->write(value, 0);
+  int read = 0;
+  std::memcpy(&read, address_0, sizeof(read));
+  EXPECT_EQ(read, value);
+
+  allocator.put(address_0);
+  const auto buffer_1 = allocator.get(input, 1);
+  EXPECT_EQ(buffer_1->data(0), address_0);
+
+  // it's bounded like the CpuAllocator
+  EXPECT_THROW((void)allocator.get(input, 4), runtime_error);
+}
+
+}  // namespace amdinfer
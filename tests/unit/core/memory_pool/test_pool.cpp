@@ -17,7 +17,12 @@
  * @brief
  */
 
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <thread>
 #include <tuple>
+#include <vector>
 
 #include "amdinfer/buffers/buffer.hpp"  // for BufferPtr
 #include "amdinfer/core/exceptions.hpp"
@@ -37,4 +42,165 @@ TEST(UnitPool, Basic) {
   pool.put(std::move(buffer));
 }
 
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitPool, ThreadCache) {
+  MemoryPool pool;
+  InferenceRequestInput input{nullptr, {1}, DataType::Int32};
+
+  auto buffer_0 = pool.get({MemoryAllocators::Cpu}, input, 1);
+  EXPECT_EQ(buffer_0->size(), sizeof(int));
+  auto* address_0 = buffer_0->data(0);
+  pool.put(std::move(buffer_0));
+
+  // the freed buffer is reused from the cache
+  auto buffer_1 = pool.get({MemoryAllocators::Cpu}, input, 1);
+  EXPECT_EQ(buffer_1->data(0), address_0);
+
+  // buffers freed on another thread go into that thread's cache
+  std::thread thread{[&pool, &buffer_1]() {
+    pool.put(std::move(buffer_1));
+    pool.flushThreadCache();
+  }};
+  thread.join();
+
+  auto buffer_2 = pool.get({MemoryAllocators::CpuBinned}, input, 2);
+  EXPECT_EQ(buffer_2->getAllocator(), MemoryAllocators::CpuBinned);
+  pool.put(std::move(buffer_2));
+  pool.flushThreadCache();
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitPool, Reserve) {
+  MemoryPool pool;
+  // large enough to skip the thread caches
+  InferenceRequestInput input{nullptr, {65'536}, DataType::Int32};
+
+  const auto allocated = [&pool]() {
+    for (const auto& [allocator, stats] : pool.getStats()) {
+      if (allocator == MemoryAllocators::Cpu) {
+        return stats.allocated;
+      }
+    }
+    return size_t{0};
+  };
+
+  pool.reserve({MemoryAllocators::Cpu}, input, 2, 3);
+  const auto reserved = allocated();
+  EXPECT_GE(reserved, 65'536 * sizeof(int) * 2 * 3);
+
+  // getting the reserved buffers doesn't allocate more
+  std::vector<BufferPtr> buffers;
+  for (auto i = 0; i < 3; ++i) {
+    buffers.push_back(pool.get({MemoryAllocators::Cpu}, input, 2));
+  }
+  EXPECT_EQ(allocated(), reserved);
+  for (auto& buffer : buffers) {
+    pool.put(std::move(buffer));
+  }
+
+  EXPECT_THROW(pool.reserve({}, input, 1, 1), runtime_error);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitPool, Trim) {
+  MemoryPool pool;
+  InferenceRequestInput input{nullptr, {65'536}, DataType::Int32};
+
+  const auto allocated = [&pool]() {
+    for (const auto& [allocator, stats] : pool.getStats()) {
+      if (allocator == MemoryAllocators::Cpu) {
+        return stats.allocated;
+      }
+    }
+    return size_t{0};
+  };
+
+  pool.reserve({MemoryAllocators::Cpu}, input, 8, 2);
+  ASSERT_GT(allocated(), 0);
+  pool.startTrimming(std::chrono::milliseconds{1}, 0);
+  for (auto i = 0; i < 1000 && allocated() > 0; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+  EXPECT_EQ(allocated(), 0);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitPool, Partition) {
+  const size_t mib = 1'048'576;
+  MemoryPool pool;
+  // large enough to skip the thread caches
+  InferenceRequestInput input{nullptr, {mib / sizeof(int)}, DataType::Int32};
+
+  const auto in_use = [](const MemoryPool& memory) {
+    for (const auto& [allocator, stats] : memory.getStats()) {
+      if (allocator == MemoryAllocators::Cpu) {
+        return stats.in_use;
+      }
+    }
+    return size_t{0};
+  };
+
+  MemoryPool partition{&pool, "partition", 2 * mib, false};
+  std::vector<BufferPtr> buffers;
+  buffers.push_back(partition.get({MemoryAllocators::Cpu}, input, 1));
+  buffers.push_back(partition.get({MemoryAllocators::Cpu}, input, 1));
+  EXPECT_THROW(std::ignore = partition.get({MemoryAllocators::Cpu}, input, 1),
+               runtime_error);
+  EXPECT_EQ(in_use(partition), 2 * mib);
+  EXPECT_EQ(in_use(pool), 0);
+
+  // buffers from the parent, like the requests' inputs, go back to it
+  auto buffer = pool.get({MemoryAllocators::Cpu}, input, 1);
+  EXPECT_EQ(in_use(pool), mib);
+  partition.put(std::move(buffer));
+  EXPECT_EQ(in_use(pool), 0);
+
+  MemoryPool overflow{&pool, "overflow", mib, true};
+  buffers.push_back(overflow.get({MemoryAllocators::Cpu}, input, 1));
+  buffers.push_back(overflow.get({MemoryAllocators::Cpu}, input, 1));
+  EXPECT_EQ(in_use(overflow), mib);
+  EXPECT_EQ(in_use(pool), mib);
+
+  overflow.put(std::move(buffers.back()));
+  buffers.pop_back();
+  EXPECT_EQ(in_use(pool), 0);
+  overflow.put(std::move(buffers.back()));
+  buffers.pop_back();
+  EXPECT_EQ(in_use(overflow), 0);
+  for (auto& item : buffers) {
+    partition.put(std::move(item));
+  }
+  EXPECT_EQ(in_use(partition), 0);
+
+  // trimming the pool trims its partitions
+  EXPECT_GE(pool.trim(0), 3 * mib);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitPool, Owner) {
+  const size_t mib = 1'048'576;
+  InferenceRequestInput input{nullptr, {mib / sizeof(int)}, DataType::Int32};
+
+  auto pool = std::make_unique<MemoryPool>();
+  auto partition =
+    std::make_unique<MemoryPool>(pool.get(), "partition", mib, false);
+  auto buffer = partition->get({MemoryAllocators::Cpu}, input, 1);
+  auto owner = partition->getOwner(buffer.get());
+  // buffers from the parent are owned by the parent's allocator
+  auto parent_buffer = pool->get({MemoryAllocators::Cpu}, input, 1);
+  auto parent_owner = partition->getOwner(parent_buffer.get());
+  EXPECT_NE(owner, parent_owner);
+
+  // the memory stays allocated after the pools are destroyed
+  partition.reset();
+  pool.reset();
+  EXPECT_EQ(owner->getStats().in_use, mib);
+  std::memset(buffer->data(0), 1, mib);
+
+  owner->put(buffer->data(0));
+  EXPECT_EQ(owner->getStats().in_use, 0);
+  parent_owner->put(parent_buffer->data(0));
+  EXPECT_EQ(parent_owner->getStats().in_use, 0);
+}
+
 }  // namespace amdinfer
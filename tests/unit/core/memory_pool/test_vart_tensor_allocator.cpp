@@ -0,0 +1,63 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+/**
+ * @file
+ * @brief
+ */
+
+#include "amdinfer/buffers/buffer.hpp"  // for BufferPtr
+#include "amdinfer/core/exceptions.hpp"
+#include "amdinfer/core/inference_request.hpp"  // for InferenceRequestInput
+#include "amdinfer/core/memory_pool/vart_tensor_allocator.hpp"
+#include "amdinfer/testing/gtest.hpp"  // for AssertionResult,...
+
+namespace amdinfer {
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitVartTensorAllocator, Reuse) {
+  VartTensorAllocator allocator;
+  InferenceRequestInput input{nullptr, {1, 4}, DataType::Int8, "input"};
+
+  const auto buffer_0 = allocator.get(input, 1);
+  EXPECT_EQ(buffer_0->getAllocator(), MemoryAllocators::VartTensor);
+  const auto* address_0 = buffer_0->data(0);
+
+  // freed buffers are reused for the same signature
+  allocator.put(address_0);
+  const auto buffer_1 = allocator.get(input, 1);
+  EXPECT_EQ(buffer_1->data(0), address_0);
+
+  // but not for a different one
+  allocator.put(address_0);
+  InferenceRequestInput other{nullptr, {1, 4}, DataType::Int8, "other"};
+  const auto buffer_2 = allocator.get(other, 1);
+  EXPECT_NE(buffer_2->data(0), address_0);
+
+  // freeing twice doesn't hand out the buffer twice
+  allocator.put(address_0);
+  const auto buffer_3 = allocator.get(input, 1);
+  const auto buffer_4 = allocator.get(input, 1);
+  EXPECT_NE(buffer_3->data(0), buffer_4->data(0));
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitVartTensorAllocator, UnknownAddress) {
+  VartTensorAllocator allocator;
+  int value = 0;
+  EXPECT_THROW(allocator.put(&value), runtime_error);
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,127 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <chrono>  // for seconds
+
+#include "amdinfer/batching/endpoint_signals.hpp"  // for SignalValues
+#include "amdinfer/core/autoscaler.hpp"            // for Autoscaler
+#include "amdinfer/core/exceptions.hpp"            // for invalid_argument
+#include "amdinfer/core/parameters.hpp"            // for ParameterMap
+#include "amdinfer/util/timer.hpp"                 // for getTime
+#include "gtest/gtest.h"                           // for Test, EXPECT_EQ
+
+namespace amdinfer {
+
+namespace {
+
+/// Get signals of a group running at some fraction of its capacity
+SignalValues makeSignals(double utilization, double queue_time = 0) {
+  SignalValues signals;
+  signals.capacity = 100;
+  signals.throughput = utilization * signals.capacity;
+  signals.queue_time = queue_time;
+  return signals;
+}
+
+AutoscaleLimits makeLimits(size_t min_instances, size_t max_instances) {
+  AutoscaleLimits limits;
+  limits.min_instances = min_instances;
+  limits.max_instances = max_instances;
+  limits.idle = std::chrono::seconds{30};
+  return limits;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitAutoscaler, ParseLimits) {
+  ParameterMap parameters;
+  EXPECT_FALSE(parseAutoscaleLimits(parameters, 1).has_value());
+
+  parameters.put("max_instances", 4);
+  auto limits = parseAutoscaleLimits(parameters, 2);
+  ASSERT_TRUE(limits.has_value());
+  // the group doesn't go below what was loaded by default
+  EXPECT_EQ(limits->min_instances, 2);
+  EXPECT_EQ(limits->max_instances, 4);
+  EXPECT_EQ(limits->idle, kDefaultScaleIdle);
+
+  parameters.put("min_instances", 1);
+  parameters.put("scale_idle_s", 5);
+  limits = parseAutoscaleLimits(parameters, 2);
+  ASSERT_TRUE(limits.has_value());
+  EXPECT_EQ(limits->min_instances, 1);
+  EXPECT_EQ(limits->idle, std::chrono::seconds{5});
+
+  ParameterMap inverted;
+  inverted.put("min_instances", 3);
+  inverted.put("max_instances", 2);
+  EXPECT_THROW(parseAutoscaleLimits(inverted, 1), invalid_argument);
+  ParameterMap zero;
+  zero.put("max_instances", 0);
+  EXPECT_THROW(parseAutoscaleLimits(zero, 1), invalid_argument);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitAutoscaler, ScaleUp) {
+  Autoscaler autoscaler{makeLimits(1, 3)};
+  auto time = util::getTime();
+
+  EXPECT_EQ(autoscaler.decide(makeSignals(0.5), 1, time), 0);
+  EXPECT_EQ(autoscaler.decide(makeSignals(0.9), 1, time), 1);
+  // one step at a time
+  EXPECT_EQ(autoscaler.decide(makeSignals(0.9), 1, time), 0);
+  autoscaler.finish(time);
+
+  // the signals need time to show the new instance
+  time += std::chrono::seconds{1};
+  EXPECT_EQ(autoscaler.decide(makeSignals(0.9), 2, time), 0);
+  time += kDefaultSignalWindow;
+  // requests waiting too long also scale a loaded group up
+  EXPECT_EQ(autoscaler.decide(makeSignals(0.5, 2 * kDefaultScaleQueueTime), 2,
+                              time),
+            1);
+  autoscaler.finish(time);
+
+  time += kDefaultSignalWindow;
+  EXPECT_EQ(autoscaler.decide(makeSignals(0.9), 3, time), 0);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitAutoscaler, ScaleDown) {
+  Autoscaler autoscaler{makeLimits(1, 3)};
+  auto time = util::getTime();
+
+  // the queue time of the last requests doesn't count once the load is gone
+  EXPECT_EQ(autoscaler.decide(makeSignals(0.1, 2 * kDefaultScaleQueueTime), 2,
+                              time),
+            0);
+  time += std::chrono::seconds{20};
+  EXPECT_EQ(autoscaler.decide(makeSignals(0.1), 2, time), 0);
+  // any load restarts the idle time
+  EXPECT_EQ(autoscaler.decide(makeSignals(0.5), 2, time), 0);
+  time += std::chrono::seconds{20};
+  EXPECT_EQ(autoscaler.decide(makeSignals(0.1), 2, time), 0);
+  time += std::chrono::seconds{30};
+  EXPECT_EQ(autoscaler.decide(makeSignals(0.1), 2, time), -1);
+  autoscaler.finish(time);
+
+  // the group doesn't go below its minimum
+  time += std::chrono::seconds{60};
+  EXPECT_EQ(autoscaler.decide(makeSignals(0), 1, time), 0);
+  time += std::chrono::seconds{60};
+  EXPECT_EQ(autoscaler.decide(makeSignals(0), 1, time), 0);
+  EXPECT_EQ(autoscaler.decide(makeSignals(0), 0, time), 1);
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,281 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <unistd.h>  // for getpid
+
+#include <cstddef>     // for byte, size_t
+#include <cstdint>     // for uint64_t, uint16_t
+#include <cstring>     // for memcpy
+#include <filesystem>  // for path, temp_directory_path, remove_all
+#include <fstream>     // for ofstream
+#include <memory>      // for make_shared, unique_ptr
+#include <mutex>       // for mutex, lock_guard
+#include <string>      // for string, to_string
+#include <utility>     // for move
+#include <vector>      // for vector
+
+#include "amdinfer/core/bulk_job.hpp"            // for BulkResults
+#include "amdinfer/core/bulk_jobs.hpp"           // for BulkJob, Dataset
+#include "amdinfer/core/data_types.hpp"          // for DataType
+#include "amdinfer/core/exceptions.hpp"          // for invalid_argument
+#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/core/request_container.hpp"   // for RequestContainer
+#include "amdinfer/core/wire_format.hpp"         // for encodeRequest
+#include "gtest/gtest.h"                         // for Test, EXPECT_EQ
+
+namespace fs = std::filesystem;
+
+namespace amdinfer {
+
+namespace {
+
+class UnitBulkJobs : public testing::Test {
+ protected:
+  void SetUp() override {
+    directory_ = fs::temp_directory_path() /
+                 ("amdinfer_test_bulk_jobs_" + std::to_string(getpid()));
+    fs::remove_all(directory_);
+    fs::create_directories(directory_);
+  }
+
+  void TearDown() override { fs::remove_all(directory_); }
+
+  fs::path writeFile(const std::string& name, const std::string& contents) {
+    const auto path = directory_ / name;
+    std::ofstream file{path, std::ios::binary};
+    file << contents;
+    return path;
+  }
+
+  /// Write a .npy file of floats numbered from zero
+  fs::path writeNpy(const std::string& name, const std::string& descr,
+                    const std::string& shape, size_t values) {
+    std::string header = "{'descr': '" + descr +
+                         "', 'fortran_order': False, 'shape': " + shape + ", }";
+    // the data starts at a multiple of 64 bytes, as numpy writes it
+    const auto kPrefix = 10U;
+    const auto kAlignment = 64U;
+    header.resize(((header.size() + kPrefix) / kAlignment + 1) * kAlignment -
+                    kPrefix - 1,
+                  ' ');
+    header += '\n';
+    std::string contents{"\x93NUMPY\x01\x00", 8};
+    const auto size = static_cast<uint16_t>(header.size());
+    contents.append(reinterpret_cast<const char*>(&size), sizeof(size));
+    contents += header;
+    for (size_t i = 0; i < values; ++i) {
+      const auto value = static_cast<float>(i);
+      contents.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+    return writeFile(name, contents);
+  }
+
+  fs::path directory_;
+};
+
+/// Respond to each request with its first input as the output
+void echo(std::unique_ptr<RequestContainer> container) {
+  const auto& input = container->request->getInputs().at(0);
+  InferenceResponse response;
+  InferenceResponseOutput output;
+  output.setName("output");
+  output.setDatatype(input.getDatatype());
+  output.setShape(input.getShape());
+  std::vector<std::byte> bytes(input.getSize() * input.getDatatype().size());
+  std::memcpy(bytes.data(), input.getData(), bytes.size());
+  output.setData(std::move(bytes));
+  response.addOutput(std::move(output));
+  container->request->runCallbackOnce(response);
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST_F(UnitBulkJobs, Npy) {
+  const auto path = writeNpy("data.npy", "<f4", "(5, 2, 3)", 30);
+  const Dataset dataset{path, "images"};
+  ASSERT_EQ(dataset.size(), 5U);
+
+  const auto request = dataset.request(3);
+  const auto& inputs = request->getInputs();
+  ASSERT_EQ(inputs.size(), 1U);
+  EXPECT_EQ(inputs[0].getName(), "images");
+  EXPECT_EQ(inputs[0].getDatatype(), DataType::Fp32);
+  EXPECT_EQ(inputs[0].getShape(), (std::vector<uint64_t>{2, 3}));
+  const auto* data = static_cast<const float*>(inputs[0].getData());
+  EXPECT_EQ(data[0], 18.0F);
+  EXPECT_EQ(data[5], 23.0F);
+
+  // a tensor of scalars has samples of one scalar
+  const Dataset scalars{writeNpy("scalars.npy", "<f4", "(4,)", 4), "input"};
+  ASSERT_EQ(scalars.size(), 4U);
+  EXPECT_EQ(scalars.request(2)->getInputs()[0].getShape(),
+            (std::vector<uint64_t>{1}));
+
+  EXPECT_THROW(Dataset(writeNpy("big.npy", ">f4", "(5, 6)", 30), "input"),
+               invalid_argument);
+  EXPECT_THROW(Dataset(writeNpy("short.npy", "<f4", "(6, 6)", 30), "input"),
+               invalid_argument);
+  EXPECT_THROW(Dataset(writeFile("other.npy", "not a numpy file"), "input"),
+               invalid_argument);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST_F(UnitBulkJobs, Safetensors) {
+  const std::string header =
+    R"({"__metadata__":{"format":"pt"},)"
+    R"("a":{"dtype":"I32","shape":[3,2],"data_offsets":[0,24]},)"
+    R"("b":{"dtype":"U8","shape":[3],"data_offsets":[24,27]}})";
+  std::string contents;
+  const uint64_t size = header.size();
+  contents.append(reinterpret_cast<const char*>(&size), sizeof(size));
+  contents += header;
+  for (int32_t i = 0; i < 6; ++i) {
+    contents.append(reinterpret_cast<const char*>(&i), sizeof(i));
+  }
+  contents += std::string{"\x07\x08\x09", 3};
+  const Dataset dataset{writeFile("data.safetensors", contents), "input"};
+  ASSERT_EQ(dataset.size(), 3U);
+
+  const auto request = dataset.request(1);
+  const auto& inputs = request->getInputs();
+  ASSERT_EQ(inputs.size(), 2U);
+  EXPECT_EQ(inputs[0].getName(), "a");
+  EXPECT_EQ(inputs[0].getShape(), (std::vector<uint64_t>{2}));
+  EXPECT_EQ(static_cast<const int32_t*>(inputs[0].getData())[1], 3);
+  EXPECT_EQ(inputs[1].getName(), "b");
+  EXPECT_EQ(inputs[1].getDatatype(), DataType::Uint8);
+  EXPECT_EQ(*static_cast<const uint8_t*>(inputs[1].getData()), 8);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST_F(UnitBulkJobs, Records) {
+  std::string contents;
+  for (int32_t i = 0; i < 3; ++i) {
+    std::vector<int32_t> data{i, i * 2};
+    InferenceRequest request;
+    request.addInputTensor(data.data(), {2}, DataType::Int32, "input");
+    const auto message = encodeRequest(0, "model", request).flatten();
+    contents.append(reinterpret_cast<const char*>(message.data()),
+                    message.size());
+  }
+  // a record that's cut off ends the dataset
+  const Dataset dataset{
+    writeFile("data.bin", contents.substr(0, contents.size() - 1)), "input"};
+  ASSERT_EQ(dataset.size(), 2U);
+  const auto request = dataset.request(1);
+  const auto* data =
+    static_cast<const int32_t*>(request->getInputs().at(0).getData());
+  EXPECT_EQ(data[1], 2);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST_F(UnitBulkJobs, Run) {
+  BulkJobOptions options;
+  options.input = writeNpy("data.npy", "<f4", "(100, 4)", 400);
+  options.output = directory_ / "results";
+  options.in_flight = 8;
+  BulkJob job{options, echo};
+  const auto progress = job.wait();
+  EXPECT_EQ(progress.state, BulkJobState::Done);
+  EXPECT_EQ(progress.total, 100U);
+  EXPECT_EQ(progress.submitted, 100U);
+  EXPECT_EQ(progress.completed, 100U);
+  EXPECT_EQ(progress.failed, 0U);
+  EXPECT_FALSE(fs::exists(options.output.string() + ".partial"));
+
+  BulkResults results{options.output};
+  std::vector<bool> seen(progress.total);
+  while (auto result = results.next()) {
+    ASSERT_LT(result->sample, seen.size());
+    seen[result->sample] = true;
+    const auto& outputs = result->response.getOutputs();
+    ASSERT_EQ(outputs.size(), 1U);
+    const auto* data = static_cast<const float*>(outputs[0].getData());
+    EXPECT_EQ(data[0], static_cast<float>(result->sample * 4));
+  }
+  for (const auto sample : seen) {
+    EXPECT_TRUE(sample);
+  }
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST_F(UnitBulkJobs, Failure) {
+  BulkJobOptions options;
+  options.input = writeNpy("data.npy", "<f4", "(10, 4)", 40);
+  options.output = directory_ / "results";
+  auto calls = 0;
+  BulkJob job{options, [&calls](std::unique_ptr<RequestContainer> container) {
+                if (++calls > 3) {
+                  throw invalid_argument("Worker model not found");
+                }
+                container->request->runCallbackOnce(
+                  InferenceResponse{"bad input"});
+              }};
+  const auto progress = job.wait();
+  EXPECT_EQ(progress.state, BulkJobState::Failed);
+  EXPECT_EQ(progress.error, "Worker model not found");
+  EXPECT_EQ(progress.submitted, 3U);
+  EXPECT_EQ(progress.failed, 3U);
+  // the results written so far are kept
+  EXPECT_FALSE(fs::exists(options.output));
+  BulkResults results{options.output.string() + ".partial"};
+  auto count = 0;
+  while (auto result = results.next()) {
+    EXPECT_TRUE(result->response.isError());
+    count++;
+  }
+  EXPECT_EQ(count, 3);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST_F(UnitBulkJobs, Cancel) {
+  BulkJobOptions options;
+  options.input = writeNpy("data.npy", "<f4", "(10, 4)", 40);
+  options.output = directory_ / "results";
+  options.in_flight = 2;
+  std::mutex mutex;
+  std::vector<std::unique_ptr<RequestContainer>> held;
+  BulkJobs jobs;
+  const auto id = jobs.start(
+    options, [&mutex, &held](std::unique_ptr<RequestContainer> container) {
+      const std::lock_guard lock{mutex};
+      held.push_back(std::move(container));
+    });
+  EXPECT_THROW((void)jobs.progress("0"), invalid_argument);
+
+  // the job waits with the window full until the requests respond
+  while (jobs.progress(id).submitted < 2) {
+    std::this_thread::yield();
+  }
+  jobs.cancel(id);
+  {
+    const std::lock_guard lock{mutex};
+    EXPECT_EQ(held.size(), 2U);
+    for (auto& container : held) {
+      echo(std::move(container));
+    }
+  }
+  while (jobs.progress(id).state == BulkJobState::Running) {
+    std::this_thread::yield();
+  }
+  const auto progress = jobs.progress(id);
+  EXPECT_EQ(progress.state, BulkJobState::Cancelled);
+  EXPECT_EQ(progress.completed, 2U);
+  ASSERT_EQ(jobs.list().size(), 1U);
+  EXPECT_EQ(jobs.list()[0].first, id);
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,84 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>  // for equal
+#include <cstddef>    // for byte
+#include <string>     // for string
+#include <vector>     // for vector
+
+#include "amdinfer/buffers/cpu.hpp"                        // for CpuBuffer
+#include "amdinfer/core/bytes_tensor.hpp"                  // for BytesView
+#include "amdinfer/core/exceptions.hpp"                    // for invalid_arg...
+#include "amdinfer/core/memory_pool/memory_allocator.hpp"  // for MemoryAll...
+#include "gtest/gtest.h"                                   // for Test
+
+namespace amdinfer {
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitBytesTensor, RoundTrip) {
+  const std::vector<std::string> elements{"hello", "", "world!"};
+  const auto data = encodeBytes(elements);
+  EXPECT_EQ(data.size(), getBytesSize(elements));
+  EXPECT_EQ(data.size(), 3 * kBytesLengthSize + 11);
+  EXPECT_EQ(data[0], std::byte{5});
+
+  const BytesView view{data.data(), data.size()};
+  ASSERT_EQ(view.size(), elements.size());
+  for (size_t i = 0; i < elements.size(); ++i) {
+    EXPECT_EQ(view[i], elements[i]);
+  }
+  // the elements are read in place
+  EXPECT_EQ(static_cast<const void*>(view[0].data()),
+            static_cast<const void*>(data.data() + kBytesLengthSize));
+
+  EXPECT_TRUE(BytesView{}.empty());
+  EXPECT_TRUE((BytesView{data.data(), 0}).empty());
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitBytesTensor, Malformed) {
+  const auto data = encodeBytes(std::vector<std::string>{"hello"});
+  // a truncated length
+  EXPECT_THROW(BytesView(data.data(), 2), invalid_argument);
+  // a truncated element
+  EXPECT_THROW(BytesView(data.data(), data.size() - 1), invalid_argument);
+
+  EXPECT_NO_THROW(checkBytesShape(6, {2, 3}, "input"));
+  EXPECT_NO_THROW(checkBytesShape(0, {0}, "input"));
+  EXPECT_THROW(checkBytesShape(5, {2, 3}, "input"), invalid_argument);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitBytesTensor, WriteBuffer) {
+  // long elements are written past the staging chunk
+  const std::vector<std::string> elements{"a", std::string(100000, 'b'), "",
+                                          "cd"};
+  const auto expected = encodeBytes(elements);
+  std::vector<std::byte> data(expected.size());
+  CpuBuffer buffer{data.data(), MemoryAllocators::Cpu, data.size()};
+
+  EXPECT_EQ(buffer.writeBytes(elements, 0), expected.size());
+  EXPECT_EQ(data, expected);
+
+  // many short elements are staged in chunks
+  const std::vector<std::string> short_elements(5000, "xyz");
+  const auto short_expected = encodeBytes(short_elements);
+  data.assign(short_expected.size() + 1, std::byte{0});
+  CpuBuffer short_buffer{data.data(), MemoryAllocators::Cpu, data.size()};
+  EXPECT_EQ(short_buffer.writeBytes(short_elements, 1), data.size());
+  EXPECT_TRUE(std::equal(short_expected.begin(), short_expected.end(),
+                         data.begin() + 1));
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,100 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstddef>  // for byte
+#include <cstdint>  // for uint64_t
+#include <cstring>  // for memcpy
+#include <string>   // for string
+#include <utility>  // for move
+#include <vector>   // for vector
+
+#include "amdinfer/core/classification.hpp"      // for classify
+#include "amdinfer/core/data_types.hpp"          // for DataType
+#include "amdinfer/core/exceptions.hpp"          // for invalid_argument
+#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/core/parameters.hpp"          // for ParameterMap
+#include "gtest/gtest.h"                         // for Test, EXPECT_EQ
+
+namespace amdinfer {
+
+namespace {
+
+InferenceRequestOutput makeOutput(const std::string& name, int k) {
+  InferenceRequestOutput output;
+  output.setName(name);
+  ParameterMap parameters;
+  parameters.put("classification", k);
+  output.setParameters(parameters);
+  return output;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitClassification, GetClassifications) {
+  InferenceRequest request;
+  EXPECT_TRUE(getClassifications(request).empty());
+
+  InferenceRequestOutput plain;
+  plain.setName("plain");
+  request.addOutputTensor(plain);
+  request.addOutputTensor(makeOutput("probabilities", 3));
+  const Classifications golden{{"probabilities", 3}};
+  EXPECT_EQ(getClassifications(request), golden);
+
+  request.addOutputTensor(makeOutput("bad", 0));
+  EXPECT_THROW((void)getClassifications(request), invalid_argument);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitClassification, Classify) {
+  // two rows of four classes
+  const std::vector<float> scores{0.1F, 0.4F, 0.2F, 0.3F,
+                                  0.9F, 0.0F, 0.05F, 0.05F};
+  std::vector<std::byte> data(scores.size() * sizeof(float));
+  std::memcpy(data.data(), scores.data(), data.size());
+
+  InferenceResponseOutput output;
+  output.setName("probabilities");
+  output.setDatatype(DataType::Fp32);
+  output.setShape({2, 4});
+  output.setData(std::move(data));
+  InferenceResponseOutput other;
+  other.setName("other");
+  other.setDatatype(DataType::Uint8);
+  other.setShape({1});
+  other.setData(std::vector<std::byte>{std::byte{7}});
+
+  InferenceResponse response;
+  response.addOutput(std::move(output));
+  response.addOutput(std::move(other));
+  classify(&response, {{"probabilities", 2}});
+
+  const auto& outputs = response.getOutputs();
+  ASSERT_EQ(outputs.size(), 2);
+  const auto& classified = outputs[0];
+  EXPECT_EQ(classified.getName(), "probabilities");
+  EXPECT_EQ(classified.getDatatype(), DataType::Fp32);
+  EXPECT_EQ(classified.getShape(), (std::vector<uint64_t>{2, 2, 2}));
+  const auto* pairs = static_cast<const float*>(classified.getData());
+  const std::vector<float> golden{1, 0.4F, 3, 0.3F, 0, 0.9F, 3, 0.05F};
+  EXPECT_EQ(std::vector<float>(pairs, pairs + golden.size()), golden);
+
+  // other outputs are left as they are
+  EXPECT_EQ(outputs[1].getName(), "other");
+  EXPECT_EQ(outputs[1].getShape(), std::vector<uint64_t>{1});
+}
+
+}  // namespace amdinfer
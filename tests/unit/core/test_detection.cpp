@@ -0,0 +1,113 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <cstddef>  // for byte
+#include <cstdint>  // for uint64_t
+#include <cstring>  // for memcpy
+#include <string>   // for string
+#include <utility>  // for move
+#include <vector>   // for vector
+
+#include "amdinfer/core/data_types.hpp"          // for DataType
+#include "amdinfer/core/detection.hpp"           // for detect
+#include "amdinfer/core/exceptions.hpp"          // for invalid_argument
+#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/core/parameters.hpp"          // for ParameterMap
+#include "gtest/gtest.h"                         // for Test, EXPECT_EQ
+
+namespace amdinfer {
+
+namespace {
+
+InferenceRequestOutput makeOutput(const std::string& name,
+                                  const ParameterMap& parameters) {
+  InferenceRequestOutput output;
+  output.setName(name);
+  output.setParameters(parameters);
+  return output;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitDetection, GetDetectionOutputs) {
+  InferenceRequest request;
+  EXPECT_TRUE(getDetectionOutputs(request).empty());
+
+  InferenceRequestOutput plain;
+  plain.setName("plain");
+  request.addOutputTensor(plain);
+  ParameterMap parameters;
+  parameters.put("detection", 0.5);
+  parameters.put("max_detections", 10);
+  request.addOutputTensor(makeOutput("boxes", parameters));
+  const auto outputs = getDetectionOutputs(request);
+  ASSERT_EQ(outputs.size(), 1U);
+  EXPECT_EQ(outputs[0].first, "boxes");
+  EXPECT_EQ(outputs[0].second.score_threshold, 0.5F);
+  EXPECT_EQ(outputs[0].second.iou_threshold,
+            pre_post::DetectionOptions{}.iou_threshold);
+  EXPECT_EQ(outputs[0].second.max_detections, 10U);
+
+  parameters.put("iou_threshold", 2.0);
+  request.addOutputTensor(makeOutput("bad", parameters));
+  EXPECT_THROW((void)getDetectionOutputs(request), invalid_argument);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitDetection, Detect) {
+  // two images of two boxes with two classes: [cx, cy, w, h, obj, c0, c1]
+  const std::vector<float> predictions{
+    10, 10, 4, 4, 0.9F, 1, 0,  //
+    11, 10, 4, 4, 0.8F, 1, 0,  // suppressed by the first box
+    50, 50, 2, 2, 0.1F, 0, 1,  //
+    20, 20, 2, 6, 0.6F, 0, 1};
+  std::vector<std::byte> data(predictions.size() * sizeof(float));
+  std::memcpy(data.data(), predictions.data(), data.size());
+
+  InferenceResponseOutput output;
+  output.setName("boxes");
+  output.setDatatype(DataType::Fp32);
+  output.setShape({2, 2, 7});
+  output.setData(std::move(data));
+  InferenceResponseOutput other;
+  other.setName("other");
+  other.setDatatype(DataType::Uint8);
+  other.setShape({1});
+  other.setData(std::vector<std::byte>{std::byte{7}});
+
+  InferenceResponse response;
+  response.addOutput(std::move(output));
+  response.addOutput(std::move(other));
+  detect(&response, {{"boxes", pre_post::DetectionOptions{}}});
+
+  const auto& outputs = response.getOutputs();
+  ASSERT_EQ(outputs.size(), 2U);
+  const auto& detected = outputs[0];
+  EXPECT_EQ(detected.getName(), "boxes");
+  EXPECT_EQ(detected.getDatatype(), DataType::Fp32);
+  EXPECT_EQ(detected.getShape(), (std::vector<uint64_t>{2, 7}));
+  const auto* rows = static_cast<const float*>(detected.getData());
+  const std::vector<float> golden{0, 0, 0.9F, 8,  8,  4, 4,
+                                  1, 1, 0.6F, 19, 17, 2, 6};
+  EXPECT_EQ(std::vector<float>(rows, rows + golden.size()), golden);
+
+  // other outputs are left as they are
+  EXPECT_EQ(outputs[1].getName(), "other");
+  EXPECT_EQ(outputs[1].getShape(), std::vector<uint64_t>{1});
+}
+
+}  // namespace amdinfer
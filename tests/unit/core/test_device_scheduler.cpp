@@ -0,0 +1,143 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>   // for milliseconds
+#include <future>   // for async, future
+#include <string>   // for string
+#include <thread>   // for sleep_for
+#include <utility>  // for move
+#include <vector>   // for vector
+
+#include "amdinfer/core/device_scheduler.hpp"  // for DeviceScheduler
+#include "amdinfer/core/exceptions.hpp"        // for invalid_argument
+#include "gtest/gtest.h"                       // for Test, EXPECT_EQ
+
+namespace amdinfer {
+
+namespace {
+
+constexpr std::chrono::milliseconds kWait{50};
+
+/// Check if a future is ready after giving it a short time to become ready
+template <typename T>
+bool isReady(const std::future<T>& future) {
+  return future.wait_for(kWait) == std::future_status::ready;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitDeviceScheduler, Shared) {
+  auto scheduler = DeviceScheduler::get("test0");
+  EXPECT_EQ(DeviceScheduler::get("test0"), scheduler);
+  EXPECT_NE(DeviceScheduler::get("test1"), scheduler);
+
+  EXPECT_THROW(scheduler->addEndpoint("a", 0, 0), invalid_argument);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitDeviceScheduler, Unlimited) {
+  auto scheduler = std::make_shared<DeviceScheduler>("test");
+  scheduler->addEndpoint("a", 1, 0);
+
+  // without a limit, turns never wait
+  std::vector<DeviceScheduler::Turn> turns;
+  for (auto i = 0; i < 4; ++i) {
+    auto turn = scheduler->tryAcquire("a");
+    ASSERT_TRUE(turn.has_value());
+    turns.push_back(std::move(*turn));
+  }
+  std::this_thread::sleep_for(kWait);
+  turns.clear();
+  EXPECT_GT(scheduler->getDeviceTime("a"), 0);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitDeviceScheduler, Jobs) {
+  auto scheduler = std::make_shared<DeviceScheduler>("test");
+  scheduler->addEndpoint("a", 1, 0);
+  scheduler->setJobs(1);
+
+  // another endpoint can't change the device's limit but may ask for the same
+  scheduler->addEndpoint("b", 1, 0);
+  EXPECT_THROW(scheduler->setJobs(2), invalid_argument);
+  EXPECT_THROW(scheduler->setJobs(0), invalid_argument);
+  EXPECT_NO_THROW(scheduler->setJobs(1));
+  auto turn = scheduler->acquire("a");
+  EXPECT_FALSE(scheduler->tryAcquire("b").has_value());
+  turn.release();
+
+  // once the device has no endpoints, the next one sets a new limit
+  scheduler->removeEndpoint("a");
+  scheduler->removeEndpoint("b");
+  scheduler->addEndpoint("c", 1, 0);
+  EXPECT_NO_THROW(scheduler->setJobs(2));
+  auto first = scheduler->tryAcquire("c");
+  EXPECT_TRUE(first.has_value());
+  EXPECT_TRUE(scheduler->tryAcquire("c").has_value());
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitDeviceScheduler, Fairness) {
+  auto scheduler = std::make_shared<DeviceScheduler>("test");
+  scheduler->addEndpoint("a", 1, 0);
+  scheduler->addEndpoint("b", 1, 0);
+  scheduler->setJobs(1);
+
+  // a uses the device first and is charged for it
+  auto turn = scheduler->acquire("a");
+  EXPECT_FALSE(scheduler->tryAcquire("b").has_value());
+  std::this_thread::sleep_for(kWait);
+
+  // b is waiting so a's next turn goes to b even though a asked first
+  auto second_a = std::async(std::launch::async,
+                             [&]() { return scheduler->acquire("a"); });
+  std::this_thread::sleep_for(kWait);
+  auto first_b = std::async(std::launch::async,
+                            [&]() { return scheduler->acquire("b"); });
+  std::this_thread::sleep_for(kWait);
+  turn.release();
+
+  EXPECT_TRUE(isReady(first_b));
+  EXPECT_FALSE(isReady(second_a));
+  first_b.get().release();
+  EXPECT_TRUE(isReady(second_a));
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitDeviceScheduler, Priority) {
+  auto scheduler = std::make_shared<DeviceScheduler>("test");
+  scheduler->addEndpoint("low", 1, 0);
+  scheduler->addEndpoint("high", 1, 1);
+  scheduler->setJobs(1);
+
+  auto turn = scheduler->acquire("high");
+  std::this_thread::sleep_for(kWait);
+
+  // high has used the device more but it still goes before low
+  auto low = std::async(std::launch::async,
+                        [&]() { return scheduler->acquire("low"); });
+  std::this_thread::sleep_for(kWait);
+  auto high = std::async(std::launch::async,
+                         [&]() { return scheduler->acquire("high"); });
+  std::this_thread::sleep_for(kWait);
+  turn.release();
+
+  EXPECT_TRUE(isReady(high));
+  EXPECT_FALSE(isReady(low));
+  high.get().release();
+  EXPECT_TRUE(isReady(low));
+}
+
+}  // namespace amdinfer
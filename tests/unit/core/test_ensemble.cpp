@@ -0,0 +1,177 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstddef>  // for byte
+#include <cstdint>  // for uint32_t
+#include <future>   // for promise
+#include <memory>   // for make_shared, make_unique
+#include <string>   // for string
+#include <utility>  // for move
+#include <vector>   // for vector
+
+#include "amdinfer/build_options.hpp"            // for AMDINFER_ENABLE_TRACING
+#include "amdinfer/core/data_types.hpp"          // for DataType
+#include "amdinfer/core/ensemble.hpp"            // for Ensemble
+#include "amdinfer/core/exceptions.hpp"          // for invalid_argument
+#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/core/request_container.hpp"   // for RequestContainer
+#include "amdinfer/observation/tracing.hpp"      // for startTrace
+#include "gtest/gtest.h"                         // for Test, EXPECT_EQ
+
+namespace amdinfer {
+
+namespace {
+
+/**
+ * @brief Make endpoints that answer the ensemble's requests in place. The
+ * "fail" model responds with an error, the "missing" model can't be enqueued
+ * and the others add one to their input.
+ *
+ * @param models the models that requests were sent to, in order
+ * @return EnsembleDispatch
+ */
+EnsembleDispatch makeDispatch(std::vector<std::string>* models) {
+  return [models](const std::string& model,
+                  std::unique_ptr<RequestContainer> request) {
+    models->push_back(model);
+    if (model == "missing") {
+      throw invalid_argument("Worker missing not found");
+    }
+    if (model == "fail") {
+      request->request->runCallbackError("broken");
+      return;
+    }
+    const auto& input = request->request->getInputs().at(0);
+    const auto* data = static_cast<const uint32_t*>(request->input_views.at(0));
+    std::vector<std::byte> buffer(input.getSize() * sizeof(uint32_t));
+    auto* result = reinterpret_cast<uint32_t*>(buffer.data());
+    for (auto i = 0U; i < input.getSize(); ++i) {
+      result[i] = data[i] + 1;
+    }
+    InferenceResponseOutput output;
+    output.setName("output");
+    output.setShape(input.getShape());
+    output.setDatatype(DataType::Uint32);
+    output.setData(std::move(buffer));
+    InferenceResponse response;
+    response.addOutput(std::move(output));
+    request->request->runCallbackOnce(response);
+  };
+}
+
+EnsembleConfig makeConfig(std::vector<EnsembleStep> steps,
+                          const std::string& output = "out") {
+  EnsembleConfig config{ModelMetadata{"ensemble", "ensemble"},
+                        std::move(steps)};
+  config.metadata.addInputTensor("in", {1}, DataType::Uint32);
+  config.metadata.addOutputTensor(output, {1}, DataType::Uint32);
+  return config;
+}
+
+std::shared_ptr<const Ensemble> makeEnsemble(
+  EnsembleConfig config, std::vector<std::string>* models) {
+  return std::make_shared<const Ensemble>(std::move(config),
+                                          makeDispatch(models), nullptr);
+}
+
+/// Run the ensemble for a request whose input is read in place
+InferenceResponse run(const Ensemble& ensemble, std::vector<uint32_t>* data) {
+  std::promise<InferenceResponse> promise;
+  auto future = promise.get_future();
+  auto container = std::make_unique<RequestContainer>();
+  container->request = std::make_shared<InferenceRequest>();
+  container->request->addInputTensor(nullptr, {data->size()},
+                                     DataType::Uint32, "in");
+  container->request->setCallback(
+    [&promise](const InferenceResponse& response) {
+      promise.set_value(response);
+    });
+  container->input_views.push_back(data->data());
+#ifdef AMDINFER_ENABLE_TRACING
+  container->trace = startTrace("test");
+#endif
+  ensemble.infer(std::move(container));
+  return future.get();
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitEnsemble, Validation) {
+  std::vector<std::string> models;
+  const auto make = [&](std::vector<EnsembleStep> steps,
+                        const std::string& output = "out") {
+    return makeEnsemble(makeConfig(std::move(steps), output), &models);
+  };
+
+  EXPECT_THROW(make({}), invalid_argument);
+  // a step needs inputs to start
+  EXPECT_THROW(make({{"a", {}, {"out"}}}), invalid_argument);
+  // a tensor that's never produced, by a step or the ensemble's inputs
+  EXPECT_THROW(make({{"a", {"unknown"}, {"out"}}}), invalid_argument);
+  // the ensemble's output must be named by a step
+  EXPECT_THROW(make({{"a", {"in"}, {"result"}}}), invalid_argument);
+  EXPECT_THROW(make({{"a", {"in"}, {"out"}}, {"b", {"in"}, {"out"}}}),
+               invalid_argument);
+  EXPECT_THROW(make({{"a", {"in"}, {"in"}}}), invalid_argument);
+  // two steps that wait for each other never start
+  EXPECT_THROW(make({{"a", {"in"}, {"x"}},
+                     {"b", {"x", "z"}, {"y"}},
+                     {"c", {"y"}, {"z", "out"}}}),
+               invalid_argument);
+
+  const auto ensemble = make({{"a", {"in"}, {"x"}}, {"b", {"x"}, {"out"}}});
+  EXPECT_EQ(ensemble->getModels(), (std::vector<std::string>{"a", "b"}));
+  EXPECT_TRUE(models.empty());
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitEnsemble, Run) {
+  std::vector<std::string> models;
+  const auto ensemble = makeEnsemble(
+    makeConfig({{"a", {"in"}, {"x"}}, {"b", {"x"}, {"out"}}}), &models);
+  std::vector<uint32_t> data{1, 2};
+  const auto response = run(*ensemble, &data);
+  ASSERT_FALSE(response.isError()) << response.getError();
+  EXPECT_EQ(models, (std::vector<std::string>{"a", "b"}));
+  const auto& outputs = response.getOutputs();
+  ASSERT_EQ(outputs.size(), 1U);
+  EXPECT_EQ(outputs[0].getName(), "out");
+  const auto* result = static_cast<const uint32_t*>(outputs[0].getData());
+  EXPECT_EQ(result[0], 3U);
+  EXPECT_EQ(result[1], 4U);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitEnsemble, MiddleStepFails) {
+  std::vector<uint32_t> data{1};
+  // the error of the failing step is returned and the steps after it don't run
+  for (const auto* failing : {"fail", "missing"}) {
+    std::vector<std::string> models;
+    const auto ensemble = makeEnsemble(makeConfig({{"a", {"in"}, {"x"}},
+                                                   {failing, {"x"}, {"y"}},
+                                                   {"c", {"y"}, {"out"}}}),
+                                       &models);
+    const auto response = run(*ensemble, &data);
+    ASSERT_TRUE(response.isError());
+    EXPECT_EQ(response.getError().find("Model " + std::string{failing} +
+                                       " failed"),
+              0U)
+      << response.getError();
+    EXPECT_EQ(models, (std::vector<std::string>{"a", failing}));
+  }
+}
+
+}  // namespace amdinfer
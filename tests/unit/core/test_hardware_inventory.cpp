@@ -0,0 +1,92 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>  // for atomic
+#include <chrono>  // for milliseconds, hours
+#include <thread>  // for sleep_for
+
+#include "amdinfer/core/exceptions.hpp"          // for external_error
+#include "amdinfer/core/hardware_inventory.hpp"  // for HardwareInventory
+#include "gtest/gtest.h"                         // for Test, EXPECT_EQ
+
+namespace amdinfer {
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitHardwareInventory, Cached) {
+  std::atomic<int> probes = 0;
+  HardwareInventory inventory{[&probes]() {
+                                Hardware hardware;
+                                hardware.kernels["kernel"] = 2;
+                                hardware.gpus = ++probes;
+                                return hardware;
+                              },
+                              std::chrono::hours{1}};
+
+  // reads after the first come from memory
+  for (auto i = 0; i < 10; ++i) {
+    const auto hardware = inventory.read();
+    EXPECT_EQ(hardware->gpus, 1);
+    EXPECT_EQ(hardware->kernels.at("kernel"), 2);
+  }
+  EXPECT_EQ(probes, 1);
+
+  inventory.refresh();
+  EXPECT_EQ(inventory.read()->gpus, 2);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitHardwareInventory, Refresh) {
+  std::atomic<int> probes = 0;
+  HardwareInventory inventory{[&probes]() {
+                                Hardware hardware;
+                                hardware.gpus = ++probes;
+                                return hardware;
+                              },
+                              std::chrono::milliseconds{1}};
+
+  EXPECT_EQ(inventory.read()->gpus, 1);
+  // the background thread keeps looking it up without being asked
+  const auto deadline =
+    std::chrono::steady_clock::now() + std::chrono::seconds{10};
+  while (probes < 3 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+  EXPECT_GE(probes, 3);
+  EXPECT_GE(inventory.read()->gpus, 3);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitHardwareInventory, Failure) {
+  std::atomic<int> probes = 0;
+  HardwareInventory inventory{[&probes]() {
+                                if (++probes != 2) {
+                                  throw external_error("XRM went away");
+                                }
+                                Hardware hardware;
+                                hardware.gpus = 1;
+                                return hardware;
+                              },
+                              std::chrono::hours{1}};
+
+  // the first lookup has nothing to fall back on so it throws and is retried
+  EXPECT_THROW((void)inventory.read(), external_error);
+  EXPECT_EQ(inventory.read()->gpus, 1);
+
+  // later lookups that fail keep the last one
+  inventory.refresh();
+  EXPECT_EQ(probes, 3);
+  EXPECT_EQ(inventory.read()->gpus, 1);
+}
+
+}  // namespace amdinfer
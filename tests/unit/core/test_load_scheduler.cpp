@@ -0,0 +1,149 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>  // for max
+#include <atomic>     // for atomic
+#include <chrono>     // for milliseconds
+#include <cstddef>    // for size_t
+#include <map>        // for map
+#include <mutex>      // for mutex, lock_guard
+#include <stdexcept>  // for runtime_error
+#include <string>     // for string
+#include <thread>     // for sleep_for
+#include <utility>    // for move
+#include <vector>     // for vector
+
+#include "amdinfer/core/load_scheduler.hpp"  // for LoadScheduler, Load
+#include "gtest/gtest.h"                     // for Test, EXPECT_EQ
+
+namespace amdinfer {
+
+namespace {
+
+constexpr std::chrono::milliseconds kLoadTime{20};
+
+/// Records how many loads run at once, overall and on each device
+class Concurrency {
+ public:
+  Load load(const std::string& device) {
+    return {device, [this, device]() {
+              enter(device);
+              std::this_thread::sleep_for(kLoadTime);
+              exit(device);
+            }};
+  }
+
+  size_t maxRunning() {
+    std::lock_guard lock{mutex_};
+    return max_running_;
+  }
+
+  size_t maxRunning(const std::string& device) {
+    std::lock_guard lock{mutex_};
+    return max_devices_[device];
+  }
+
+  size_t finished() {
+    std::lock_guard lock{mutex_};
+    return finished_;
+  }
+
+ private:
+  void enter(const std::string& device) {
+    std::lock_guard lock{mutex_};
+    max_running_ = std::max(max_running_, ++running_);
+    max_devices_[device] = std::max(max_devices_[device], ++devices_[device]);
+  }
+
+  void exit(const std::string& device) {
+    std::lock_guard lock{mutex_};
+    running_--;
+    devices_[device]--;
+    finished_++;
+  }
+
+  std::mutex mutex_;
+  size_t running_ = 0;
+  size_t max_running_ = 0;
+  size_t finished_ = 0;
+  std::map<std::string, size_t> devices_;
+  std::map<std::string, size_t> max_devices_;
+};
+
+}  // namespace
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitLoadScheduler, Threads) {
+  const size_t threads = 3;
+  Concurrency concurrency;
+  std::vector<Load> loads;
+  for (auto i = 0; i < 9; ++i) {
+    loads.push_back(concurrency.load("cpu"));
+  }
+
+  LoadScheduler scheduler{{threads, {}}};
+  scheduler.run(std::move(loads));
+  EXPECT_EQ(concurrency.finished(), 9);
+  EXPECT_GT(concurrency.maxRunning(), 1);
+  EXPECT_LE(concurrency.maxRunning(), threads);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitLoadScheduler, Devices) {
+  Concurrency concurrency;
+  std::vector<Load> loads;
+  // the gpu loads come first but the others don't wait behind them
+  for (auto i = 0; i < 4; ++i) {
+    loads.push_back(concurrency.load("gpu"));
+  }
+  for (auto i = 0; i < 4; ++i) {
+    loads.push_back(concurrency.load("cpu"));
+  }
+
+  LoadScheduler scheduler{{4, {{"gpu", 1}, {"cpu", 0}}}};
+  scheduler.run(std::move(loads));
+  EXPECT_EQ(concurrency.finished(), 8);
+  EXPECT_EQ(concurrency.maxRunning("gpu"), 1);
+  EXPECT_LE(concurrency.maxRunning("cpu"), 3);
+  EXPECT_LE(concurrency.maxRunning(), 4);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitLoadScheduler, Errors) {
+  std::atomic<int> finished = 0;
+  std::vector<Load> loads;
+  loads.push_back({"", []() { throw std::runtime_error("failed"); }});
+  loads.push_back({"", [&]() { finished++; }});
+
+  LoadScheduler scheduler{{1, {}}};
+  scheduler.run(std::move(loads));
+  EXPECT_EQ(finished, 1);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitLoadScheduler, Stop) {
+  std::atomic<int> finished = 0;
+  LoadScheduler scheduler{{1, {}}};
+  std::vector<Load> loads;
+  loads.push_back({"", [&]() {
+                     scheduler.stop();
+                     finished++;
+                   }});
+  loads.push_back({"", [&]() { finished++; }});
+
+  scheduler.run(std::move(loads));
+  EXPECT_EQ(finished, 1);
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,94 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>  // for atomic
+#include <memory>  // for make_shared, shared_ptr
+#include <string>  // for string
+#include <thread>  // for thread
+#include <vector>  // for vector
+
+#include "amdinfer/core/exceptions.hpp"       // for runtime_error
+#include "amdinfer/core/model_artifacts.hpp"  // for getModelArtifact
+#include "gtest/gtest.h"                      // for Test, EXPECT_EQ
+
+namespace amdinfer {
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitModelArtifacts, Share) {
+  int loads = 0;
+  auto load = [&loads]() {
+    loads++;
+    return std::make_shared<int>(loads);
+  };
+
+  auto first = getModelArtifact<int>("share", load);
+  auto second = getModelArtifact<int>("share", load);
+  EXPECT_EQ(first, second);
+  EXPECT_NE(getModelArtifact<int>("other", load), first);
+  EXPECT_EQ(loads, 2);
+
+  // it's loaded again once no one holds it
+  first.reset();
+  second.reset();
+  EXPECT_EQ(*getModelArtifact<int>("share", load), 3);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitModelArtifacts, Failure) {
+  auto fail = []() -> std::shared_ptr<int> {
+    throw runtime_error("failed");
+  };
+  EXPECT_THROW(getModelArtifact<int>("failure", fail), runtime_error);
+  auto loaded = getModelArtifact<int>(
+    "failure", []() { return std::make_shared<int>(1); });
+  EXPECT_EQ(*loaded, 1);
+
+  // a key only holds one type at a time
+  EXPECT_THROW(getModelArtifact<std::string>(
+                 "failure", []() { return std::make_shared<std::string>(); }),
+               runtime_error);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitModelArtifacts, LoadOnce) {
+  std::atomic<int> loads = 0;
+  std::vector<std::shared_ptr<int>> artifacts(4);
+  std::vector<std::thread> threads;
+  for (auto& artifact : artifacts) {
+    threads.emplace_back([&artifact, &loads]() {
+      artifact = getModelArtifact<int>("once", [&loads]() {
+        loads++;
+        std::this_thread::yield();
+        return std::make_shared<int>(0);
+      });
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(loads, 1);
+  for (const auto& artifact : artifacts) {
+    EXPECT_EQ(artifact, artifacts.front());
+  }
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitModelArtifacts, Key) {
+  EXPECT_EQ(getModelArtifactKey("/tmp/../tmp/model.pt", "ptzendnn-fp32"),
+            getModelArtifactKey("/tmp/model.pt", "ptzendnn-fp32"));
+  EXPECT_NE(getModelArtifactKey("/tmp/model.pt", "ptzendnn-fp32"),
+            getModelArtifactKey("/tmp/model.pt", "ptzendnn-bf16"));
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,88 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>  // for string
+#include <vector>  // for vector
+
+#include "amdinfer/core/model_budget.hpp"  // for ModelBudget
+#include "gtest/gtest.h"                   // for Test, EXPECT_EQ
+
+namespace amdinfer {
+
+using Models = std::vector<std::string>;
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitModelBudget, Unlimited) {
+  ModelBudget budget{{{"gpu", 0}}};
+  EXPECT_TRUE(budget.add("a", "gpu", 100).empty());
+  EXPECT_TRUE(budget.add("b", "gpu", 100).empty());
+  EXPECT_TRUE(budget.add("c", "cpu", 100).empty());
+  EXPECT_EQ(budget.used("gpu"), 200);
+  EXPECT_EQ(budget.used("cpu"), 100);
+  EXPECT_EQ(budget.used("dpu"), 0);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitModelBudget, LeastRecentlyUsed) {
+  ModelBudget budget{{{"gpu", 300}}};
+  for (const auto* model : {"a", "b", "c"}) {
+    EXPECT_TRUE(budget.add(model, "gpu", 100).empty());
+    budget.release(model);
+  }
+  // a was added first but it's used most recently
+  budget.acquire("a");
+  budget.release("a");
+
+  EXPECT_EQ(budget.add("d", "gpu", 150), (Models{"b", "c"}));
+  EXPECT_TRUE(budget.contains("a"));
+  EXPECT_FALSE(budget.contains("b"));
+  EXPECT_EQ(budget.used("gpu"), 250);
+
+  // models on other devices aren't affected
+  EXPECT_TRUE(budget.add("e", "cpu", 1000).empty());
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitModelBudget, Busy) {
+  ModelBudget budget{{{"gpu", 200}}};
+  EXPECT_TRUE(budget.add("a", "gpu", 100).empty());
+  budget.release("a");
+  EXPECT_TRUE(budget.add("b", "gpu", 100).empty());
+  budget.release("b");
+
+  // models with requests in flight, or that are loading, aren't unloaded
+  budget.acquire("a");
+  EXPECT_EQ(budget.add("c", "gpu", 100), (Models{"b"}));
+  EXPECT_TRUE(budget.add("d", "gpu", 100).empty());
+  EXPECT_EQ(budget.used("gpu"), 300);
+
+  budget.release("a");
+  budget.release("c");
+  budget.release("d");
+  EXPECT_EQ(budget.add("e", "gpu", 100), (Models{"a", "c"}));
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitModelBudget, Remove) {
+  ModelBudget budget{{{"gpu", 100}}};
+  EXPECT_TRUE(budget.add("a", "gpu", 100).empty());
+  budget.remove("a");
+  EXPECT_FALSE(budget.contains("a"));
+  EXPECT_EQ(budget.used("gpu"), 0);
+  // releasing a model that's gone does nothing
+  budget.release("a");
+  EXPECT_TRUE(budget.add("b", "gpu", 100).empty());
+}
+
+}  // namespace amdinfer
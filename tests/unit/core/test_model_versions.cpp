@@ -0,0 +1,110 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>  // for atomic
+#include <string>  // for string
+#include <thread>  // for thread
+#include <vector>  // for vector
+
+#include "amdinfer/core/model_versions.hpp"  // for Aliases, sortVersions
+#include "gtest/gtest.h"                     // for Test, EXPECT_EQ
+
+namespace amdinfer {
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitModelVersions, Order) {
+  // numbers are compared by value rather than as strings
+  EXPECT_TRUE(isOlderVersion("9", "10"));
+  EXPECT_FALSE(isOlderVersion("10", "9"));
+  EXPECT_TRUE(isOlderVersion("2", "11"));
+  // leading zeros don't change the value
+  EXPECT_FALSE(isOlderVersion("010", "10"));
+  EXPECT_FALSE(isOlderVersion("10", "010"));
+  EXPECT_TRUE(isOlderVersion("009", "10"));
+  EXPECT_FALSE(isOlderVersion("0", "00"));
+  // other versions are compared as strings
+  EXPECT_TRUE(isOlderVersion("10", "9a"));
+  EXPECT_TRUE(isOlderVersion("alpha", "beta"));
+
+  EXPECT_TRUE(isNumericVersion("10"));
+  EXPECT_FALSE(isNumericVersion(""));
+  EXPECT_FALSE(isNumericVersion("v1"));
+
+  std::vector<std::string> versions{"10", "9", "1", "100", "9", "20"};
+  sortVersions(&versions);
+  EXPECT_EQ(versions,
+            (std::vector<std::string>{"1", "9", "10", "20", "100"}));
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitModelVersions, Aliases) {
+  Aliases aliases;
+  EXPECT_EQ(aliases.resolve("model"), "model");
+  EXPECT_FALSE(aliases.erase("model"));
+
+  aliases.set("model", "model/1");
+  EXPECT_EQ(aliases.resolve("model"), "model/1");
+  aliases.set("model", "model/2");
+  EXPECT_EQ(aliases.resolve("model"), "model/2");
+  aliases.set("other", "other/1");
+  EXPECT_EQ(aliases.snapshot()->size(), 2);
+
+  // a snapshot isn't changed by later swaps
+  const auto snapshot = aliases.snapshot();
+  EXPECT_TRUE(aliases.erase("model"));
+  EXPECT_EQ(aliases.resolve("model"), "model");
+  EXPECT_EQ(snapshot->at("model"), "model/2");
+  EXPECT_EQ(aliases.resolve("other"), "other/1");
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitModelVersions, AliasSwap) {
+  Aliases aliases;
+  aliases.set("model", "model/1");
+
+  // readers always see one version or the other while it's swapped
+  std::atomic<bool> stop = false;
+  std::atomic<int> invalid = 0;
+  std::vector<std::thread> readers;
+  for (auto i = 0; i < 4; ++i) {
+    readers.emplace_back([&]() {
+      while (!stop) {
+        const auto endpoint = aliases.resolve("model");
+        if (endpoint != "model/1" && endpoint != "model/2") {
+          invalid++;
+        }
+      }
+    });
+  }
+  // swapping other aliases at the same time doesn't lose either change
+  std::thread other{[&]() {
+    for (auto i = 0; i < 1000; ++i) {
+      aliases.set("other", "other/" + std::to_string(i));
+    }
+  }};
+  for (auto i = 0; i < 1000; ++i) {
+    aliases.set("model", i % 2 == 0 ? "model/2" : "model/1");
+  }
+  other.join();
+  stop = true;
+  for (auto& reader : readers) {
+    reader.join();
+  }
+
+  EXPECT_EQ(invalid, 0);
+  EXPECT_EQ(aliases.resolve("model"), "model/1");
+  EXPECT_EQ(aliases.resolve("other"), "other/999");
+}
+
+}  // namespace amdinfer
@@ -13,10 +13,12 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-#include <array>    // for array
-#include <cstddef>  // for byte, size_t
-#include <string>   // for string, basic_string, alloc...
-#include <vector>   // for vector
+#include <array>        // for array
+#include <cstddef>      // for byte, size_t
+#include <stdexcept>    // for out_of_range
+#include <string>       // for string, basic_string, alloc...
+#include <type_traits>  // for is_const_v, remove_reference_t
+#include <vector>       // for vector
 
 #include "amdinfer/core/parameters.hpp"  // for ParameterMap
 #include "gtest/gtest.h"                 // for AssertionResult, Message
@@ -74,4 +76,60 @@ TEST(UnitParameterMap, SerDes) {
             new_params.get<double>(keys[index_double]));
 }
 
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitParameterMap, Access) {
+  ParameterMap params;
+  EXPECT_FALSE(params.has("key"));
+  EXPECT_THROW(params.get<int>("key"), std::out_of_range);
+
+  params.put("b", 1);
+  params.put("c", "value");
+  params.put("a", true);
+  // existing keys keep their values
+  params.put("b", 2);
+  EXPECT_EQ(params.size(), 3);
+  EXPECT_EQ(params.get<int>("b"), 1);
+
+  // the parameters are iterated in the order of their keys
+  std::vector<std::string> keys;
+  for (const auto& [key, value] : params) {
+    keys.push_back(key);
+  }
+  EXPECT_EQ(keys, (std::vector<std::string>{"a", "b", "c"}));
+
+  // values can be changed in place but the keys are read-only
+  for (auto&& [key, value] : params) {
+    static_assert(std::is_const_v<std::remove_reference_t<decltype(key)>>);
+    if (key == "b") {
+      value = 3;
+    }
+  }
+  EXPECT_EQ(params.get<int>("b"), 3);
+  auto it = params.begin();
+  it++;
+  EXPECT_EQ(it->first, "b");
+  it->second = 1;
+  EXPECT_EQ(params.get<int>("b"), 1);
+
+  params.rename("a", "d");
+  EXPECT_FALSE(params.has("a"));
+  EXPECT_TRUE(params.get<bool>("d"));
+  params.rename("d", "b");
+  EXPECT_FALSE(params.has("d"));
+  EXPECT_EQ(params.get<int>("b"), 1);
+
+  params.erase("b");
+  params.erase("missing");
+  EXPECT_EQ(params.size(), 1);
+  EXPECT_EQ(params.get<std::string>("c"), "value");
+
+  ParameterMap other;
+  other.put("c", "value");
+  std::less<ParameterMap> less;
+  EXPECT_FALSE(less(params, other));
+  EXPECT_FALSE(less(other, params));
+  other.put("e", 1);
+  EXPECT_TRUE(less(params, other));
+}
+
 }  // namespace amdinfer
@@ -0,0 +1,233 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>   // for hours
+#include <cstdint>  // for uint8_t
+#include <cstring>  // for memcpy
+#include <future>   // for promise
+#include <memory>   // for make_unique, make_shared
+#include <mutex>    // for mutex, lock_guard
+#include <string>   // for string
+#include <utility>  // for move
+#include <vector>   // for vector
+
+#include "amdinfer/buffers/buffer.hpp"           // for Buffer
+#include "amdinfer/core/data_types.hpp"          // for DataType
+#include "amdinfer/core/exceptions.hpp"          // for invalid_argument
+#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/core/parameters.hpp"          // for ParameterMap
+#include "amdinfer/core/peers.hpp"               // for PeerRouter
+#include "amdinfer/core/request_container.hpp"   // for RequestContainer
+#include "amdinfer/declarations.hpp"             // for RequestContainerPtr
+#include "gtest/gtest.h"                         // for Test, EXPECT_EQ
+
+namespace amdinfer {
+
+namespace {
+
+/// What a fake peer was sent
+struct Sent {
+  std::mutex mutex;
+  std::vector<std::string> models;
+  std::vector<std::vector<uint8_t>> data;
+  std::vector<bool> forward;
+};
+
+/// A peer that reports a fixed load and answers requests with their ID
+class FakePeer : public Peer {
+ public:
+  FakePeer(PeerLoad load, Sent* sent, bool reachable = true)
+    : load_(std::move(load)), sent_(sent), reachable_(reachable) {}
+
+  [[nodiscard]] std::string name() const override { return "fake"; }
+
+  PeerLoad load() override {
+    if (!reachable_) {
+      throw runtime_error("unreachable");
+    }
+    return load_;
+  }
+
+  InferenceResponseFuture infer(const std::string& model,
+                                const InferenceRequest& request) override {
+    const auto& input = request.getInputs().at(0);
+    const auto* data = static_cast<const uint8_t*>(input.getData());
+    {
+      std::lock_guard lock{sent_->mutex};
+      sent_->models.push_back(model);
+      sent_->data.emplace_back(data, data + input.getSize());
+      sent_->forward.push_back(request.getParameters().get<bool>("forward"));
+    }
+    std::promise<InferenceResponse> promise;
+    InferenceResponse response;
+    response.setID(request.getID());
+    response.setModel(model);
+    promise.set_value(std::move(response));
+    return promise.get_future();
+  }
+
+ private:
+  PeerLoad load_;
+  Sent* sent_;
+  bool reachable_;
+};
+
+/**
+ * @brief Make a request whose input is decoded by the batcher. If it has a
+ * view, it's read in place. Otherwise, the writer writes the data
+ */
+RequestContainerPtr makeRequest(std::vector<uint8_t>* data, bool view,
+                                std::promise<InferenceResponse>* promise) {
+  auto container = std::make_unique<RequestContainer>();
+  container->request = std::make_shared<InferenceRequest>();
+  container->request->setID("id");
+  container->request->addInputTensor(nullptr, {data->size()}, DataType::Uint8,
+                                     "input");
+  container->request->setCallback(
+    [promise](const InferenceResponse& response) {
+      promise->set_value(response);
+    });
+  if (view) {
+    container->input_views.push_back(data->data());
+  }
+  container->input_writers.emplace_back(
+    [data](Buffer* buffer, size_t offset) {
+      std::memcpy(buffer->data(offset), data->data(), data->size());
+    });
+  return container;
+}
+
+PeerLimits makeLimits(size_t threshold) {
+  PeerLimits limits;
+  // the loads are only fetched with refresh() in the tests
+  limits.interval = std::chrono::hours{1};
+  limits.threshold = threshold;
+  return limits;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitPeers, ParseAddress) {
+  const auto address = parsePeerAddress("node1:8997:8998");
+  EXPECT_EQ(address.socket, "node1:8997");
+  EXPECT_EQ(address.http, "http://node1:8998");
+
+  EXPECT_THROW(parsePeerAddress("node1:8997"), invalid_argument);
+  EXPECT_THROW(parsePeerAddress(":8997:8998"), invalid_argument);
+  EXPECT_THROW(parsePeerAddress("node1::8998"), invalid_argument);
+  EXPECT_THROW(parsePeerAddress("node1:8997:"), invalid_argument);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitPeers, NotLoadedHere) {
+  Sent sent;
+  std::vector<std::unique_ptr<Peer>> peers;
+  peers.push_back(std::make_unique<FakePeer>(PeerLoad{{"other", 0}}, &sent));
+  peers.push_back(std::make_unique<FakePeer>(PeerLoad{{"model", 5}}, &sent));
+  PeerRouter router{std::move(peers), makeLimits(8), nullptr};
+
+  std::vector<uint8_t> data{1, 2, 3};
+  std::promise<InferenceResponse> promise;
+  auto future = promise.get_future();
+  auto request = makeRequest(&data, false, &promise);
+  // a model that no peer has stays here
+  EXPECT_FALSE(router.forward("missing", std::nullopt, &request));
+  ASSERT_NE(request, nullptr);
+
+  EXPECT_TRUE(router.forward("model", std::nullopt, &request));
+  EXPECT_EQ(request, nullptr);
+  EXPECT_EQ(future.get().getID(), "id");
+  ASSERT_EQ(sent.models.size(), 1);
+  EXPECT_EQ(sent.models[0], "model");
+  EXPECT_EQ(sent.data[0], data);
+  EXPECT_FALSE(sent.forward[0]);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitPeers, Threshold) {
+  Sent sent;
+  std::vector<std::unique_ptr<Peer>> peers;
+  peers.push_back(std::make_unique<FakePeer>(PeerLoad{{"model", 4}}, &sent));
+  PeerRouter router{std::move(peers), makeLimits(8), nullptr};
+
+  std::vector<uint8_t> data{1, 2, 3};
+  std::promise<InferenceResponse> promise;
+  auto future = promise.get_future();
+  auto request = makeRequest(&data, true, &promise);
+  EXPECT_FALSE(router.forward("model", 7, &request));
+  // the peer must have less queued than here
+  EXPECT_FALSE(router.forward("model", 4, &request));
+
+  ParameterMap parameters;
+  parameters.put("forward", false);
+  request->request->setParameters(parameters);
+  EXPECT_FALSE(router.forward("model", 8, &request));
+
+  // a forward parameter of the wrong type is the caller's error
+  parameters.erase("forward");
+  parameters.put("forward", 0);
+  request->request->setParameters(parameters);
+  EXPECT_THROW(router.forward("model", 8, &request), invalid_argument);
+
+  parameters.erase("forward");
+  parameters.put("forward", true);
+  request->request->setParameters(parameters);
+  EXPECT_TRUE(router.forward("model", 8, &request));
+  EXPECT_EQ(future.get().getID(), "id");
+  ASSERT_EQ(sent.data.size(), 1);
+  EXPECT_EQ(sent.data[0], data);
+  // the peer serves a forwarded request itself
+  EXPECT_FALSE(sent.forward[0]);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitPeers, LeastLoaded) {
+  Sent first;
+  Sent second;
+  std::vector<std::unique_ptr<Peer>> peers;
+  peers.push_back(std::make_unique<FakePeer>(PeerLoad{{"model", 3}}, &first));
+  peers.push_back(std::make_unique<FakePeer>(PeerLoad{{"model", 1}}, &second));
+  Sent unreachable;
+  peers.push_back(std::make_unique<FakePeer>(PeerLoad{{"model", 0}},
+                                             &unreachable, false));
+  PeerRouter router{std::move(peers), makeLimits(0), nullptr};
+
+  std::vector<uint8_t> data{1};
+  // each forwarded request counts against its peer until the next fetch
+  const auto forward = [&]() {
+    std::promise<InferenceResponse> promise;
+    auto future = promise.get_future();
+    auto request = makeRequest(&data, true, &promise);
+    EXPECT_TRUE(router.forward("model", 10, &request));
+    future.wait();
+  };
+  forward();
+  forward();
+  EXPECT_EQ(second.models.size(), 2);
+  EXPECT_EQ(first.models.size(), 0);
+  forward();
+  forward();
+  EXPECT_EQ(first.models.size() + second.models.size(), 4);
+  EXPECT_EQ(first.models.size(), 1);
+  EXPECT_EQ(unreachable.models.size(), 0);
+
+  // fetching the loads again drops the counts
+  router.refresh();
+  forward();
+  EXPECT_EQ(second.models.size(), 4);
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,201 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <sys/wait.h>  // for waitpid, WEXITSTATUS
+#include <unistd.h>    // for fork, getpid, _exit
+
+#include <chrono>   // for milliseconds
+#include <cstdint>  // for int32_t, uint64_t
+#include <string>   // for string, to_string
+#include <thread>   // for thread
+#include <vector>   // for vector
+
+#include "amdinfer/core/data_types.hpp"          // for DataType
+#include "amdinfer/core/exceptions.hpp"          // for invalid_argument
+#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/core/model_metadata.hpp"      // for ModelMetadata
+#include "amdinfer/core/process_channel.hpp"     // for ProcessChannel
+#include "amdinfer/core/wire_format.hpp"         // for encodeRequest
+#include "gtest/gtest.h"                         // for Test, EXPECT_EQ
+
+namespace amdinfer {
+
+namespace {
+
+const std::chrono::milliseconds kTimeout{5000};
+
+std::string makeName(const std::string& test) {
+  return "/amdinfer-test-" + test + "-" + std::to_string(getpid());
+}
+
+/// Make a request whose input holds the value repeated some number of times
+WireMessage makeRequest(uint64_t tag, std::vector<int32_t>* data) {
+  InferenceRequest request;
+  request.addInputTensor(data->data(), {data->size()}, DataType::Int32,
+                         "input");
+  return encodeRequest(tag, "model", request);
+}
+
+/// Receive a request and check that it holds the expected values
+void expectRequest(ProcessChannel* channel, uint64_t tag, int32_t value,
+                   size_t size) {
+  const auto message = channel->receive(kTimeout);
+  ASSERT_TRUE(message.has_value());
+  const auto decoded = decodeRequest(message->header, message->body);
+  EXPECT_EQ(decoded.tag, tag);
+  const auto& input = decoded.request->getInputs().at(0);
+  ASSERT_EQ(input.getSize(), size);
+  const auto* values = static_cast<const int32_t*>(input.getData());
+  for (size_t i = 0; i < size; ++i) {
+    ASSERT_EQ(values[i], value);
+  }
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitProcessChannel, SendReceive) {
+  ProcessChannel parent{makeName("send"), kDefaultChannelBytes};
+  ProcessChannel child{parent.getName()};
+
+  std::vector<int32_t> data(10, 3);
+  ASSERT_TRUE(parent.send(makeRequest(1, &data)));
+  expectRequest(&child, 1, 3, data.size());
+
+  InferenceResponse response;
+  response.setID("id");
+  ASSERT_TRUE(child.send(encodeResponse(1, response)));
+  const auto message = parent.receive(kTimeout);
+  ASSERT_TRUE(message.has_value());
+  EXPECT_EQ(decodeResponse(message->header, message->body).getID(), "id");
+
+  // nothing else was sent
+  EXPECT_FALSE(parent.receive(std::chrono::milliseconds(1)).has_value());
+  EXPECT_THROW(ProcessChannel(parent.getName(), kDefaultChannelBytes),
+               invalid_argument);
+  EXPECT_THROW(ProcessChannel("/amdinfer-test-missing"), invalid_argument);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitProcessChannel, Wrap) {
+  // the memory only holds a few messages at a time so it wraps around often
+  const size_t bytes = 4096;
+  ProcessChannel parent{makeName("wrap"), bytes};
+  ProcessChannel child{parent.getName()};
+
+  std::vector<int32_t> large(bytes / 2);
+  EXPECT_THROW((void)parent.send(makeRequest(0, &large)), invalid_argument);
+
+  const int messages = 200;
+  std::thread receiver{[&child]() {
+    for (auto i = 0; i < messages; ++i) {
+      expectRequest(&child, i, i, (i * 7) % 100);
+    }
+  }};
+  for (auto i = 0; i < messages; ++i) {
+    std::vector<int32_t> data((i * 7) % 100, i);
+    ASSERT_TRUE(parent.send(makeRequest(i, &data)));
+  }
+  receiver.join();
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitProcessChannel, Close) {
+  const size_t bytes = 4096;
+  ProcessChannel parent{makeName("close"), bytes};
+  ProcessChannel child{parent.getName()};
+
+  // a held message keeps its memory so the sender waits until it's closed
+  std::vector<int32_t> data(bytes / 8);
+  ASSERT_TRUE(parent.send(makeRequest(0, &data)));
+  const auto held = child.receive(kTimeout);
+  ASSERT_TRUE(held.has_value());
+  std::thread closer{[&child]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    child.close();
+  }};
+  bool sent = true;
+  for (auto i = 0; i < 3 && sent; ++i) {
+    sent = parent.send(makeRequest(0, &data));
+  }
+  closer.join();
+  EXPECT_FALSE(sent);
+  EXPECT_TRUE(parent.isClosed());
+  EXPECT_FALSE(child.receive(kTimeout).has_value());
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitProcessChannel, Processes) {
+  ProcessChannel parent{makeName("processes"), kDefaultChannelBytes};
+  const int messages = 1000;
+
+  const auto pid = fork();
+  ASSERT_NE(pid, -1);
+  if (pid == 0) {
+    // the child echoes the tag of each request back until it's closed
+    ProcessChannel child{parent.getName()};
+    while (true) {
+      const auto message = child.receive(kTimeout);
+      if (!message.has_value()) {
+        _exit(child.isClosed() ? 0 : 1);
+      }
+      InferenceResponse response;
+      if (!child.send(encodeResponse(message->header.tag, response))) {
+        _exit(0);
+      }
+    }
+  }
+
+  for (auto i = 0; i < messages; ++i) {
+    std::vector<int32_t> data(i % 50, i);
+    ASSERT_TRUE(parent.send(makeRequest(i, &data)));
+    const auto message = parent.receive(kTimeout);
+    ASSERT_TRUE(message.has_value());
+    EXPECT_EQ(message->header.tag, static_cast<uint64_t>(i));
+  }
+  parent.close();
+  int status = 0;
+  ASSERT_EQ(waitpid(pid, &status, 0), pid);
+  EXPECT_EQ(WEXITSTATUS(status), 0);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitProcessChannel, Metadata) {
+  ModelMetadata metadata{"model", "cpu"};
+  metadata.addInputTensor("image", {224, 224, 3}, DataType::Fp32);
+  metadata.addOutputTensor("classes", {1000}, DataType::Int32);
+  metadata.addOutputTensor("scores", {1000}, DataType::Fp32);
+
+  const auto response = describeModel(metadata);
+  const auto bytes = encodeResponse(0, response).flatten();
+  const auto header = decodeHeader(bytes.data(), bytes.size());
+  const auto read =
+    readModel(decodeResponse(header, bytes.data() + sizeof(WireHeader)));
+
+  EXPECT_EQ(read.getName(), "model");
+  EXPECT_EQ(read.getPlatform(), "cpu");
+  ASSERT_EQ(read.getInputs().size(), 1U);
+  EXPECT_EQ(read.getInputs()[0].getName(), "image");
+  EXPECT_EQ(read.getInputs()[0].getShape(),
+            metadata.getInputs()[0].getShape());
+  ASSERT_EQ(read.getOutputs().size(), 2U);
+  EXPECT_EQ(read.getOutputs()[1].getName(), "scores");
+  EXPECT_EQ(read.getOutputs()[1].getDatatype(), DataType::Fp32);
+
+  EXPECT_THROW(readModel(InferenceResponse{"failed"}), runtime_error);
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,105 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>   // for atomic
+#include <memory>   // for make_shared
+#include <thread>   // for thread
+#include <utility>  // for move
+#include <vector>   // for vector
+
+#include "amdinfer/core/queue_limit.hpp"  // for QueueLimit
+#include "gtest/gtest.h"                  // for Test, EXPECT_EQ
+
+namespace amdinfer {
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitQueueLimit, Requests) {
+  auto limit = std::make_shared<QueueLimit>(2, 0);
+  auto first = limit->tryAcquire(1);
+  auto second = limit->tryAcquire(1);
+  ASSERT_TRUE(first.has_value());
+  ASSERT_TRUE(second.has_value());
+  EXPECT_FALSE(limit->tryAcquire(1).has_value());
+  EXPECT_EQ(limit->requests(), 2);
+
+  // giving a ticket back makes room for another request
+  first.reset();
+  EXPECT_EQ(limit->requests(), 1);
+  auto third = limit->tryAcquire(1);
+  EXPECT_TRUE(third.has_value());
+
+  // moving a ticket keeps its room and releasing it twice is harmless
+  QueueLimit::Ticket moved{std::move(*second)};
+  second.reset();
+  EXPECT_EQ(limit->requests(), 2);
+  moved.release();
+  moved.release();
+  EXPECT_EQ(limit->requests(), 1);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitQueueLimit, Bytes) {
+  constexpr auto kMaxBytes = 100;
+  auto limit = std::make_shared<QueueLimit>(0, kMaxBytes);
+
+  // a request larger than the limit is taken if nothing else is waiting
+  auto large = limit->tryAcquire(kMaxBytes * 2);
+  ASSERT_TRUE(large.has_value());
+  EXPECT_FALSE(limit->tryAcquire(1).has_value());
+  large.reset();
+  EXPECT_EQ(limit->bytes(), 0);
+
+  auto first = limit->tryAcquire(kMaxBytes / 2);
+  auto second = limit->tryAcquire(kMaxBytes / 2);
+  ASSERT_TRUE(first.has_value());
+  ASSERT_TRUE(second.has_value());
+  EXPECT_FALSE(limit->tryAcquire(1).has_value());
+  EXPECT_EQ(limit->bytes(), kMaxBytes);
+  EXPECT_EQ(limit->requests(), 2);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitQueueLimit, Threads) {
+  constexpr auto kMaxRequests = 2;
+  constexpr auto kThreads = 4;
+  constexpr auto kIterations = 10000;
+  auto limit = std::make_shared<QueueLimit>(kMaxRequests, 0);
+
+  // the count is only exact when no one is acquiring so the tickets that are
+  // held are counted separately
+  std::atomic<int> held = 0;
+  std::atomic<bool> exceeded = false;
+  std::vector<std::thread> threads;
+  threads.reserve(kThreads);
+  for (auto i = 0; i < kThreads; ++i) {
+    threads.emplace_back([&]() {
+      for (auto j = 0; j < kIterations; ++j) {
+        auto ticket = limit->tryAcquire(1);
+        if (ticket.has_value()) {
+          if (held.fetch_add(1) >= kMaxRequests) {
+            exceeded = true;
+          }
+          held.fetch_sub(1);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_FALSE(exceeded);
+  EXPECT_EQ(limit->requests(), 0);
+}
+
+}  // namespace amdinfer
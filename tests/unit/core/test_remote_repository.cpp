@@ -0,0 +1,196 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>      // for atomic
+#include <cstring>     // for memcpy
+#include <filesystem>  // for path, temp_directory_path
+#include <fstream>     // for ifstream, ofstream
+#include <map>         // for map
+#include <memory>      // for make_unique
+#include <sstream>     // for stringstream
+#include <stdexcept>   // for runtime_error
+#include <string>      // for string
+#include <utility>     // for move
+#include <vector>      // for vector
+
+#include "amdinfer/core/exceptions.hpp"         // for invalid_argument
+#include "amdinfer/core/remote_repository.hpp"  // for RemoteRepository
+#include "gtest/gtest.h"                        // for Test, EXPECT_EQ
+
+namespace fs = std::filesystem;
+
+namespace amdinfer {
+
+/// A store that holds its files in memory and counts how much is read
+class FakeStore : public ObjectStore {
+ public:
+  FakeStore(std::map<std::string, std::string> files,
+            std::atomic<size_t>* reads, std::string hash = "")
+    : files_(std::move(files)), reads_(reads), hash_(std::move(hash)) {}
+
+  [[nodiscard]] std::string name() const override { return "fake://models"; }
+
+  std::vector<RemoteObject> list() override {
+    std::vector<RemoteObject> objects;
+    for (const auto& [path, contents] : files_) {
+      objects.push_back({path, contents.size(), "v1", hash_});
+    }
+    return objects;
+  }
+
+  void read(const RemoteObject& object, size_t offset, size_t size,
+            char* data) override {
+    const auto& contents = files_.at(object.path);
+    if (contents == "broken") {
+      throw runtime_error("Could not read " + object.path);
+    }
+    std::memcpy(data, contents.data() + offset, size);
+    (*reads_)++;
+  }
+
+ private:
+  std::map<std::string, std::string> files_;
+  std::atomic<size_t>* reads_;
+  std::string hash_;
+};
+
+class UnitRemoteRepository : public testing::Test {
+ protected:
+  void SetUp() override {
+    options_.cache = fs::temp_directory_path() / "amdinfer_test_remote";
+    options_.threads = 3;
+    options_.chunk_size = 4;
+    fs::remove_all(options_.cache);
+  }
+
+  void TearDown() override { fs::remove_all(options_.cache); }
+
+  static std::string readFile(const fs::path& path) {
+    std::ifstream file{path};
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+  }
+
+  std::unique_ptr<RemoteRepository> makeRepository(
+    std::map<std::string, std::string> files, std::string hash = "") {
+    return std::make_unique<RemoteRepository>(
+      std::make_unique<FakeStore>(std::move(files), &reads_, std::move(hash)),
+      options_);
+  }
+
+  RemoteOptions options_;
+  std::atomic<size_t> reads_ = 0;
+};
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitRemoteRepositoryManifest, Parse) {
+  const auto objects = parseManifest(
+    "# size hash path\n12 0123456789abcdef mnist/config.pbtxt\n\n"
+    "0 - mnist/1/a b.onnx\r\n");
+  ASSERT_EQ(objects.size(), 2);
+  EXPECT_EQ(objects[0].path, "mnist/config.pbtxt");
+  EXPECT_EQ(objects[0].size, 12);
+  EXPECT_EQ(objects[0].hash, "0123456789abcdef");
+  EXPECT_EQ(objects[1].path, "mnist/1/a b.onnx");
+  EXPECT_EQ(objects[1].size, 0);
+  EXPECT_TRUE(objects[1].hash.empty());
+
+  EXPECT_THROW(parseManifest("12 mnist/config.pbtxt"), invalid_argument);
+  EXPECT_THROW(parseManifest("12a - mnist/config.pbtxt"), invalid_argument);
+  // hashes name files in the cache so they can't be paths
+  EXPECT_THROW(parseManifest("12 ../../etc mnist/config.pbtxt"),
+               invalid_argument);
+  EXPECT_THROW(parseManifest("12 abc mnist/config.pbtxt"), invalid_argument);
+  EXPECT_THROW(parseManifest("12 0123456789ABCDEF mnist/config.pbtxt"),
+               invalid_argument);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST_F(UnitRemoteRepository, Download) {
+  const std::map<std::string, std::string> files{
+    {"a/config.pbtxt", "config a"},
+    {"a/1/model", "the first model"},
+    {"b/config.pbtxt", "config b"},
+    {"b/1/empty", ""},
+    {"README", "not a model"},
+    {"../escape/config.pbtxt", "outside"}};
+  auto repository = makeRepository(files);
+  const auto mirror = repository->start();
+
+  // the configs are there as soon as it starts
+  EXPECT_EQ(readFile(mirror / "a/config.pbtxt"), "config a");
+  EXPECT_EQ(readFile(mirror / "b/config.pbtxt"), "config b");
+  EXPECT_EQ(repository->models(), (std::vector<std::string>{"a", "b"}));
+
+  EXPECT_TRUE(repository->waitForModel("a"));
+  EXPECT_TRUE(repository->waitForModel("b"));
+  EXPECT_FALSE(repository->waitForModel("c"));
+  EXPECT_EQ(readFile(mirror / "a/1/model"), "the first model");
+  EXPECT_TRUE(fs::exists(mirror / "b/1/empty"));
+  EXPECT_FALSE(fs::exists(mirror / "README"));
+  EXPECT_FALSE(fs::exists(mirror.parent_path() / "escape"));
+  // each file is read in four byte parts
+  EXPECT_EQ(reads_, 2 + 4 + 2);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST_F(UnitRemoteRepository, Cached) {
+  const std::map<std::string, std::string> files{
+    {"a/config.pbtxt", "config a"}, {"a/1/model", "the first model"}};
+  {
+    auto repository = makeRepository(files);
+    repository->start();
+    EXPECT_TRUE(repository->waitForModel("a"));
+  }
+  const size_t reads = reads_;
+
+  // files of the same version are linked from the cache again
+  auto repository = makeRepository(files);
+  const auto mirror = repository->start();
+  EXPECT_TRUE(repository->waitForModel("a"));
+  EXPECT_EQ(reads_, reads);
+  EXPECT_EQ(readFile(mirror / "a/1/model"), "the first model");
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST_F(UnitRemoteRepository, InvalidHash) {
+  // a store that lists a hash that's a path is skipped rather than trusted
+  const auto outside = options_.cache / "outside";
+  fs::create_directories(outside);
+  {
+    std::ofstream{outside / "secret"} << "config a";
+  }
+  auto repository = makeRepository({{"a/config.pbtxt", "config a"}},
+                                   "../outside/secret");
+  const auto mirror = repository->start();
+  EXPECT_TRUE(repository->models().empty());
+  EXPECT_FALSE(fs::exists(mirror / "a/config.pbtxt"));
+  EXPECT_EQ(reads_, 0);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST_F(UnitRemoteRepository, Failure) {
+  auto repository = makeRepository({{"a/config.pbtxt", "config a"},
+                                    {"a/1/model", "broken"},
+                                    {"b/config.pbtxt", "config b"}});
+  const auto mirror = repository->start();
+
+  // a file that fails only fails its own model
+  EXPECT_FALSE(repository->waitForModel("a"));
+  EXPECT_TRUE(repository->waitForModel("b"));
+  EXPECT_FALSE(fs::exists(mirror / "a/1/model"));
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,154 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>  // for uint8_t
+#include <memory>   // for make_shared, make_unique
+#include <string>   // for string
+#include <vector>   // for vector
+
+#include "amdinfer/core/data_types.hpp"          // for DataType
+#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/core/parameters.hpp"          // for ParameterMap
+#include "amdinfer/core/request_coalescer.hpp"   // for RequestCoalescer
+#include "amdinfer/core/request_container.hpp"   // for RequestContainer
+#include "amdinfer/core/response_callback.hpp"   // for ResponseCallback
+#include "amdinfer/declarations.hpp"             // for RequestContainerPtr
+#include "gtest/gtest.h"                         // for Test, EXPECT_EQ
+
+namespace amdinfer {
+
+namespace {
+
+RequestContainerPtr makeRequest(std::vector<uint8_t>* data,
+                                const std::string& id,
+                                std::vector<std::string>* answered) {
+  auto container = std::make_unique<RequestContainer>();
+  container->request = std::make_shared<InferenceRequest>();
+  container->request->setID(id);
+  container->request->addInputTensor(data->data(), {data->size()},
+                                     DataType::Uint8, "input");
+  container->request->setCallback(
+    [answered](const InferenceResponse& response) {
+      answered->push_back(response.getID());
+    });
+  return container;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitRequestCoalescer, Key) {
+  std::vector<uint8_t> data{1, 2, 3, 4};
+  std::vector<std::string> answered;
+  auto request = makeRequest(&data, "", &answered);
+  auto copy = data;
+  EXPECT_TRUE(RequestCoalescer::key(*request).has_value());
+  EXPECT_EQ(RequestCoalescer::key(*request),
+            RequestCoalescer::key(*makeRequest(&copy, "", &answered)));
+
+  // the cache's opt-out is separate from coalescing
+  ParameterMap parameters;
+  parameters.put("cache", false);
+  request->request->setParameters(parameters);
+  EXPECT_TRUE(RequestCoalescer::key(*request).has_value());
+  parameters.put("coalesce", false);
+  request->request->setParameters(parameters);
+  EXPECT_FALSE(RequestCoalescer::key(*request).has_value());
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitRequestCoalescer, JoinFinish) {
+  std::vector<uint8_t> data{1, 2, 3, 4};
+  std::vector<std::string> answered;
+  auto first = makeRequest(&data, "first", &answered);
+  auto second = makeRequest(&data, "second", &answered);
+  auto third = makeRequest(&data, "third", &answered);
+  const auto key = *RequestCoalescer::key(*first);
+
+  RequestCoalescer coalescer;
+  EXPECT_FALSE(coalescer.join(key, first->request.get()));
+  EXPECT_TRUE(coalescer.join(key, second->request.get()));
+  EXPECT_TRUE(coalescer.join(key, third->request.get()));
+  EXPECT_EQ(coalescer.size(), 1);
+
+  // each attached request gets the response with its own ID and the one that
+  // ran is answered last
+  InferenceResponse response;
+  response.setID("first");
+  response.setModel("model");
+  coalescer.finish(key, response);
+  EXPECT_EQ(answered, (std::vector<std::string>{"second", "third", "first"}));
+  EXPECT_EQ(coalescer.size(), 0);
+
+  // once the response is in, the next identical request runs again
+  auto fourth = makeRequest(&data, "fourth", &answered);
+  EXPECT_FALSE(coalescer.join(key, fourth->request.get()));
+  response.setID("fourth");
+  coalescer.finish(key, response);
+  EXPECT_EQ(answered.size(), 4);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitRequestCoalescer, Detach) {
+  std::vector<uint8_t> data{1, 2, 3, 4};
+  std::vector<std::string> answered;
+  auto first = makeRequest(&data, "first", &answered);
+  auto second = makeRequest(&data, "second", &answered);
+  const auto key = *RequestCoalescer::key(*first);
+
+  RequestCoalescer coalescer;
+  EXPECT_FALSE(coalescer.join(key, first->request.get()));
+  EXPECT_TRUE(coalescer.join(key, second->request.get()));
+
+  // the detached request gets its callback back and the attached one still
+  // waits for the response
+  ResponseCallback callback;
+  EXPECT_TRUE(coalescer.detach(key, &callback));
+  ASSERT_NE(callback, nullptr);
+  InferenceResponse response;
+  response.setID("first");
+  callback(response);
+  EXPECT_EQ(coalescer.size(), 1);
+  coalescer.finish(key, response);
+  EXPECT_EQ(answered, (std::vector<std::string>{"first", "second"}));
+
+  // without attached requests, the key is free for the next request
+  auto third = makeRequest(&data, "third", &answered);
+  EXPECT_FALSE(coalescer.join(key, third->request.get()));
+  EXPECT_FALSE(coalescer.detach(key, &callback));
+  EXPECT_EQ(coalescer.size(), 0);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitRequestCoalescer, Collision) {
+  std::vector<uint8_t> data{1, 2, 3, 4};
+  std::vector<std::string> answered;
+  auto first = makeRequest(&data, "first", &answered);
+  auto second = makeRequest(&data, "second", &answered);
+
+  // requests whose hashes collide are run separately
+  RequestCoalescer coalescer;
+  EXPECT_FALSE(coalescer.join({1, 1}, first->request.get()));
+  EXPECT_FALSE(coalescer.join({1, 2}, second->request.get()));
+  EXPECT_EQ(coalescer.size(), 2);
+  InferenceResponse response;
+  response.setID("second");
+  coalescer.finish({1, 2}, response);
+  EXPECT_EQ(answered, (std::vector<std::string>{"second"}));
+  coalescer.finish({1, 1}, response);
+  EXPECT_EQ(coalescer.size(), 0);
+}
+
+}  // namespace amdinfer
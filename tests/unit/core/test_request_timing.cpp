@@ -0,0 +1,65 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>   // for microseconds
+#include <cstdint>  // for int32_t
+
+#include "amdinfer/core/exceptions.hpp"      // for invalid_argument
+#include "amdinfer/core/parameters.hpp"      // for ParameterMap
+#include "amdinfer/core/request_timing.hpp"  // for RequestTiming
+#include "amdinfer/util/timer.hpp"           // for getTime
+#include "gtest/gtest.h"                     // for Test, EXPECT_EQ
+
+namespace amdinfer {
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitRequestTiming, Requested) {
+  ParameterMap parameters;
+  EXPECT_FALSE(RequestTiming::requested(parameters));
+  parameters.put(kRequestTiming, true);
+  EXPECT_TRUE(RequestTiming::requested(parameters));
+  parameters.erase(kRequestTiming);
+  parameters.put(kRequestTiming, false);
+  EXPECT_FALSE(RequestTiming::requested(parameters));
+
+  parameters.erase(kRequestTiming);
+  parameters.put(kRequestTiming, 1);
+  EXPECT_THROW((void)RequestTiming::requested(parameters), invalid_argument);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitRequestTiming, Parameters) {
+  constexpr auto kQueueTime = 100;
+  constexpr auto kBatchWait = 250;
+
+  RequestTiming timing;
+  // a request served without batching has no time in any stage
+  auto parameters = timing.parameters();
+  EXPECT_DOUBLE_EQ(parameters.get<double>(kTimingQueue), 0);
+  EXPECT_DOUBLE_EQ(parameters.get<double>(kTimingBatchWait), 0);
+  EXPECT_DOUBLE_EQ(parameters.get<double>(kTimingCompute), 0);
+  EXPECT_EQ(parameters.get<int32_t>(kTimingBatchSize), 0);
+
+  timing.taken = util::getTime();
+  timing.batched = timing.taken - std::chrono::microseconds(kBatchWait);
+  timing.enqueued = timing.batched - std::chrono::microseconds(kQueueTime);
+  timing.batch_size = 4;
+  parameters = timing.parameters();
+  EXPECT_DOUBLE_EQ(parameters.get<double>(kTimingQueue), kQueueTime);
+  EXPECT_DOUBLE_EQ(parameters.get<double>(kTimingBatchWait), kBatchWait);
+  EXPECT_GE(parameters.get<double>(kTimingCompute), 0);
+  EXPECT_EQ(parameters.get<int32_t>(kTimingBatchSize), 4);
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,114 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>  // for string
+#include <vector>  // for vector
+
+#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/core/requested_outputs.hpp"   // for selectOutputs
+#include "gtest/gtest.h"                         // for Test, EXPECT_EQ
+
+namespace amdinfer {
+
+namespace {
+
+void addOutput(InferenceRequest* request, const std::string& name) {
+  InferenceRequestOutput output;
+  output.setName(name);
+  request->addOutputTensor(output);
+}
+
+std::vector<size_t> indices(const std::vector<SelectedOutput>& selected) {
+  std::vector<size_t> result;
+  for (const auto& output : selected) {
+    result.push_back(output.index);
+  }
+  return result;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitRequestedOutputs, SelectAll) {
+  const std::vector<std::string> names{"boxes", "scores", "labels"};
+  InferenceRequest request;
+
+  auto selected = selectOutputs(request, names, names.size(), "");
+  ASSERT_EQ(selected.size(), names.size());
+  for (size_t i = 0; i < names.size(); ++i) {
+    EXPECT_EQ(selected[i].index, i);
+    EXPECT_EQ(selected[i].name, names[i]);
+  }
+
+  selected = selectOutputs(request, {}, 2, "input");
+  EXPECT_EQ(indices(selected), (std::vector<size_t>{0, 1}));
+  EXPECT_EQ(selected[1].name, "input");
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitRequestedOutputs, SelectByName) {
+  const std::vector<std::string> names{"boxes", "scores", "labels"};
+  InferenceRequest request;
+  addOutput(&request, "labels");
+  addOutput(&request, "boxes");
+
+  const auto selected = selectOutputs(request, names, names.size(), "input");
+  EXPECT_EQ(indices(selected), (std::vector<size_t>{2, 0}));
+  EXPECT_EQ(selected[0].name, "labels");
+  EXPECT_EQ(selected[1].name, "boxes");
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitRequestedOutputs, SelectByPosition) {
+  // names that aren't the model's rename its outputs in order
+  InferenceRequest request;
+  addOutput(&request, "first");
+  addOutput(&request, "");
+
+  auto selected = selectOutputs(request, {}, 3, "input");
+  EXPECT_EQ(indices(selected), (std::vector<size_t>{0, 1}));
+  EXPECT_EQ(selected[0].name, "first");
+  EXPECT_EQ(selected[1].name, "input");
+
+  selected = selectOutputs(request, {}, 1, "input");
+  EXPECT_EQ(indices(selected), (std::vector<size_t>{0}));
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitRequestedOutputs, Filter) {
+  InferenceResponse response;
+  for (const auto* name : {"boxes", "scores", "labels"}) {
+    InferenceResponseOutput output;
+    output.setName(name);
+    response.addOutput(output);
+  }
+
+  // responses that don't name any requested output are left as they are
+  filterOutputs(&response, {"other"});
+  EXPECT_EQ(response.getOutputs().size(), 3);
+
+  filterOutputs(&response, {"labels", "boxes"});
+  const auto& outputs = response.getOutputs();
+  ASSERT_EQ(outputs.size(), 2);
+  EXPECT_EQ(outputs[0].getName(), "boxes");
+  EXPECT_EQ(outputs[1].getName(), "labels");
+
+  InferenceRequest request;
+  EXPECT_TRUE(getRequestedOutputs(request).empty());
+  addOutput(&request, "scores");
+  EXPECT_EQ(getRequestedOutputs(request), std::vector<std::string>{"scores"});
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,159 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstddef>  // for byte, size_t
+#include <cstdint>  // for uint8_t
+#include <memory>   // for make_shared, make_unique
+#include <utility>  // for move
+#include <vector>   // for vector
+
+#include "amdinfer/core/data_types.hpp"          // for DataType
+#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/core/parameters.hpp"          // for ParameterMap
+#include "amdinfer/core/request_container.hpp"   // for RequestContainer
+#include "amdinfer/core/response_cache.hpp"      // for ResponseCache
+#include "amdinfer/declarations.hpp"             // for RequestContainerPtr
+#include "gtest/gtest.h"                         // for Test, EXPECT_EQ
+
+namespace amdinfer {
+
+namespace {
+
+RequestContainerPtr makeRequest(std::vector<uint8_t>* data) {
+  auto container = std::make_unique<RequestContainer>();
+  container->request = std::make_shared<InferenceRequest>();
+  container->request->addInputTensor(data->data(), {data->size()},
+                                     DataType::Uint8, "input");
+  return container;
+}
+
+InferenceResponse makeResponse(size_t size, uint8_t value) {
+  InferenceResponseOutput output;
+  output.setName("output");
+  output.setShape({size});
+  output.setDatatype(DataType::Uint8);
+  output.setData(std::vector<std::byte>(size, std::byte{value}));
+  InferenceResponse response;
+  response.setModel("model");
+  response.addOutput(std::move(output));
+  return response;
+}
+
+uint8_t firstByte(const InferenceResponse& response) {
+  return static_cast<uint8_t*>(response.getOutputs()[0].getData())[0];
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitResponseCache, Key) {
+  std::vector<uint8_t> data{1, 2, 3, 4};
+  auto request = makeRequest(&data);
+  const auto key = ResponseCache::key(*request);
+  ASSERT_TRUE(key.has_value());
+
+  // the same inputs in another buffer have the same key
+  auto copy = data;
+  EXPECT_EQ(ResponseCache::key(*makeRequest(&copy)), key);
+
+  copy[0] = 0;
+  EXPECT_NE(ResponseCache::key(*makeRequest(&copy)), key);
+
+  ParameterMap parameters;
+  parameters.put("top_k", 5);
+  request->request->setParameters(parameters);
+  EXPECT_NE(ResponseCache::key(*request), key);
+
+  // requests can bypass the cache
+  parameters.put("cache", false);
+  request->request->setParameters(parameters);
+  EXPECT_FALSE(ResponseCache::key(*request).has_value());
+
+  // deferred inputs can only be hashed if they can be read in place
+  auto deferred = makeRequest(&data);
+  deferred->input_writers.emplace_back([](Buffer*, size_t) {});
+  EXPECT_FALSE(ResponseCache::key(*deferred).has_value());
+  deferred->input_views.push_back(data.data());
+  EXPECT_EQ(ResponseCache::key(*deferred), key);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitResponseCache, GetPut) {
+  ResponseCache cache{100};
+  EXPECT_FALSE(cache.get({1, 1}).has_value());
+
+  cache.put({1, 1}, makeResponse(10, 7));
+  EXPECT_EQ(cache.size(), 10);
+  auto response = cache.get({1, 1});
+  ASSERT_TRUE(response.has_value());
+  EXPECT_EQ(response->getModel(), "model");
+  const auto& outputs = response->getOutputs();
+  ASSERT_EQ(outputs.size(), 1);
+  EXPECT_EQ(outputs[0].getName(), "output");
+  EXPECT_EQ(outputs[0].getSize(), 10);
+  EXPECT_EQ(static_cast<uint8_t*>(outputs[0].getData())[9], 7);
+
+  // the response shares the cached data
+  auto again = cache.get({1, 1});
+  ASSERT_TRUE(again.has_value());
+  EXPECT_EQ(again->getOutputs()[0].getData(), outputs[0].getData());
+
+  // errors and responses larger than the cache aren't saved
+  cache.put({2, 2}, InferenceResponse{"error"});
+  EXPECT_FALSE(cache.get({2, 2}).has_value());
+  cache.put({3, 3}, makeResponse(101, 0));
+  EXPECT_FALSE(cache.get({3, 3}).has_value());
+
+  // replacing a response updates its size
+  cache.put({1, 1}, makeResponse(20, 8));
+  EXPECT_EQ(cache.size(), 20);
+  EXPECT_EQ(firstByte(*cache.get({1, 1})), 8);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitResponseCache, Evict) {
+  ResponseCache cache{100};
+  cache.put({1, 1}, makeResponse(40, 1));
+  cache.put({2, 2}, makeResponse(40, 2));
+  // using the first response makes the second the least recently used
+  EXPECT_TRUE(cache.get({1, 1}).has_value());
+  cache.put({3, 3}, makeResponse(40, 3));
+
+  EXPECT_TRUE(cache.get({1, 1}).has_value());
+  EXPECT_FALSE(cache.get({2, 2}).has_value());
+  EXPECT_TRUE(cache.get({3, 3}).has_value());
+  EXPECT_EQ(cache.size(), 80);
+
+  // responses taken from the cache outlive their eviction
+  auto response = cache.get({1, 1});
+  cache.put({4, 4}, makeResponse(100, 4));
+  EXPECT_FALSE(cache.get({1, 1}).has_value());
+  EXPECT_EQ(static_cast<uint8_t*>(response->getOutputs()[0].getData())[0], 1);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitResponseCache, Collision) {
+  ResponseCache cache{100};
+  cache.put({1, 1}, makeResponse(10, 1));
+
+  // a request whose hash collides with another's isn't given its response
+  EXPECT_FALSE(cache.get({1, 2}).has_value());
+  cache.put({1, 2}, makeResponse(10, 2));
+  EXPECT_EQ(cache.size(), 20);
+  EXPECT_EQ(firstByte(*cache.get({1, 1})), 1);
+  EXPECT_EQ(firstByte(*cache.get({1, 2})), 2);
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,98 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <array>    // for array
+#include <future>   // for promise
+#include <memory>   // for make_shared, make_unique
+#include <string>   // for string
+#include <utility>  // for move
+
+#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/core/response_callback.hpp"   // for ResponseCallback
+#include "amdinfer/declarations.hpp"             // for Callback
+#include "gtest/gtest.h"                         // for Test, EXPECT_EQ
+
+namespace amdinfer {
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitResponseCallback, Empty) {
+  ResponseCallback callback;
+  EXPECT_TRUE(callback == nullptr);
+  EXPECT_FALSE(callback);
+
+  // empty std::functions stay empty
+  callback = Callback{};
+  EXPECT_TRUE(callback == nullptr);
+
+  callback = [](const InferenceResponse&) {};
+  EXPECT_TRUE(callback != nullptr);
+  callback = nullptr;
+  EXPECT_TRUE(callback == nullptr);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitResponseCallback, MoveOnly) {
+  std::promise<std::string> promise;
+  auto future = promise.get_future();
+  ResponseCallback callback = [promise = std::move(promise)](
+                                const InferenceResponse& response) mutable {
+    promise.set_value(response.getError());
+  };
+
+  auto moved = std::move(callback);
+  EXPECT_TRUE(callback == nullptr);  // NOLINT(bugprone-use-after-move)
+  moved(InferenceResponse{"error"});
+  EXPECT_EQ(future.get(), "error");
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitResponseCallback, Large) {
+  // callables larger than the capacity are stored on the heap
+  auto counter = std::make_shared<int>(0);
+  std::array<char, ResponseCallback::kCapacity> padding{};
+  ResponseCallback callback = [counter, padding](const InferenceResponse&) {
+    *counter += static_cast<int>(padding.size());
+  };
+  ResponseCallback other;
+  other = std::move(callback);
+  other(InferenceResponse{});
+  EXPECT_EQ(*counter, ResponseCallback::kCapacity);
+
+  other = nullptr;
+  EXPECT_EQ(counter.use_count(), 1);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitResponseCallback, Request) {
+  auto count = 0;
+  InferenceRequest request;
+  request.setID("id");
+  request.setCallback([&count](const InferenceResponse&) { count++; });
+
+  // copies of a request don't share its callback
+  const InferenceRequest copy{request};
+  EXPECT_EQ(copy.getID(), "id");
+
+  request.runCallbackOnce(InferenceResponse{});
+  request.runCallbackOnce(InferenceResponse{});
+  EXPECT_EQ(count, 1);
+
+  request.setCallback([&count](const InferenceResponse&) { count++; });
+  auto callback = request.getCallback();
+  callback(InferenceResponse{});
+  EXPECT_EQ(count, 2);
+}
+
+}  // namespace amdinfer
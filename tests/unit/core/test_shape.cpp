@@ -0,0 +1,84 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>        // for uint64_t
+#include <functional>     // for hash
+#include <unordered_set>  // for unordered_set
+#include <utility>        // for move
+#include <vector>         // for vector
+
+#include "amdinfer/core/shape.hpp"  // for Shape
+#include "gtest/gtest.h"            // for Test, EXPECT_EQ
+
+namespace amdinfer {
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitShape, Vector) {
+  const std::vector<uint64_t> dims{1, 3, 224, 224};
+  Shape shape = dims;
+  EXPECT_EQ(shape.size(), dims.size());
+  EXPECT_EQ(shape, dims);
+  EXPECT_EQ(shape, (Shape{1, 3, 224, 224}));
+  EXPECT_NE(shape, (Shape{1, 3, 224}));
+  EXPECT_EQ(static_cast<std::vector<uint64_t>>(shape), dims);
+
+  shape[0] = 4;
+  shape.insert(shape.begin(), 2);
+  EXPECT_EQ(shape, (Shape{2, 4, 3, 224, 224}));
+  shape.erase(shape.begin() + 1);
+  EXPECT_EQ(shape, (Shape{2, 3, 224, 224}));
+  shape.insert(shape.end(), dims.begin(), dims.begin() + 2);
+  EXPECT_EQ(shape, (Shape{2, 3, 224, 224, 1, 3}));
+  shape.resize(2);
+  EXPECT_EQ(shape, (Shape{2, 3}));
+  shape.clear();
+  EXPECT_TRUE(shape.empty());
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitShape, Heap) {
+  // shapes longer than the inline dimensions move to the heap
+  Shape shape;
+  std::vector<uint64_t> dims;
+  for (uint64_t i = 0; i < 3 * kShapeInlineDims; ++i) {
+    shape.push_back(i);
+    dims.push_back(i);
+  }
+  EXPECT_EQ(shape, dims);
+
+  auto copy = shape;
+  EXPECT_EQ(copy, shape);
+  EXPECT_NE(copy.data(), shape.data());
+
+  const auto* data = shape.data();
+  auto moved = std::move(shape);
+  EXPECT_EQ(moved.data(), data);
+  EXPECT_EQ(moved, dims);
+
+  Shape small{1, 2};
+  auto moved_small = std::move(small);
+  EXPECT_EQ(moved_small, (Shape{1, 2}));
+  moved_small = moved;
+  EXPECT_EQ(moved_small, dims);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitShape, Hash) {
+  EXPECT_EQ(std::hash<Shape>{}(Shape{2, 3}), std::hash<Shape>{}(Shape{2, 3}));
+  std::unordered_set<Shape> shapes{Shape{2, 3}, Shape{3, 2}, Shape{2, 3}};
+  EXPECT_EQ(shapes.size(), 2);
+  EXPECT_EQ(shapes.count(Shape{3, 2}), 1);
+}
+
+}  // namespace amdinfer
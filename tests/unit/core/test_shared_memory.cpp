@@ -0,0 +1,206 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fcntl.h>     // for O_CREAT, O_RDWR
+#include <sys/mman.h>  // for mmap, munmap, shm_open, shm_unlink
+#include <unistd.h>    // for ftruncate, getpid, close
+
+#include <cstddef>  // for byte, size_t
+#include <cstdint>  // for uint8_t
+#include <limits>   // for numeric_limits
+#include <string>   // for string, to_string
+#include <vector>   // for vector
+
+#include "amdinfer/buffers/cpu.hpp"              // for CpuBuffer
+#include "amdinfer/core/data_types.hpp"          // for DataType
+#include "amdinfer/core/exceptions.hpp"          // for invalid_argument
+#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/core/parameters.hpp"          // for ParameterMap
+#include "amdinfer/core/request_container.hpp"   // for RequestContainer
+#include "amdinfer/core/shared_memory.hpp"       // for SharedMemoryRegistry
+#include "gtest/gtest.h"                         // for Test, EXPECT_EQ
+
+namespace amdinfer {
+
+namespace {
+
+constexpr size_t kObjectSize = 8192;
+// an offset that isn't page aligned to check that the mapping is adjusted
+constexpr size_t kRegionOffset = 100;
+constexpr size_t kRegionSize = 1000;
+
+/// Creates a shared memory object as a client would and maps it to check on
+class UnitSharedMemory : public testing::Test {
+ protected:
+  void SetUp() override {
+    const int fd = shm_open(key_.c_str(), O_CREAT | O_RDWR, S_IRUSR | S_IWUSR);
+    ASSERT_NE(fd, -1);
+    ASSERT_EQ(ftruncate(fd, kObjectSize), 0);
+    void* memory = mmap(nullptr, kObjectSize, PROT_READ | PROT_WRITE,
+                        MAP_SHARED, fd, 0);
+    close(fd);
+    ASSERT_NE(memory, MAP_FAILED);
+    memory_ = static_cast<uint8_t*>(memory);
+    for (auto i = 0U; i < kObjectSize; ++i) {
+      memory_[i] = static_cast<uint8_t>(i);
+    }
+    registry_.add({"region", key_, kRegionOffset, kRegionSize});
+  }
+
+  void TearDown() override {
+    munmap(memory_, kObjectSize);
+    shm_unlink(key_.c_str());
+  }
+
+  static ParameterMap tensorParameters(int offset, int byte_size) {
+    ParameterMap parameters;
+    parameters.put(kSharedMemoryRegion, "region");
+    parameters.put(kSharedMemoryOffset, offset);
+    parameters.put(kSharedMemoryByteSize, byte_size);
+    return parameters;
+  }
+
+  std::string key_ = "/amdinfer_test_" + std::to_string(getpid());
+  uint8_t* memory_ = nullptr;
+  SharedMemoryRegistry registry_;
+};
+
+}  // namespace
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST_F(UnitSharedMemory, Registry) {
+  // the server maps the same memory the client writes to
+  auto block = registry_.get("region", 10, 4);
+  EXPECT_FALSE(block.onDevice());
+  auto* data = static_cast<uint8_t*>(block.data());
+  EXPECT_EQ(data[0], static_cast<uint8_t>(kRegionOffset + 10));
+  data[1] = 0;
+  EXPECT_EQ(memory_[kRegionOffset + 11], 0);
+
+  const auto regions = registry_.status("");
+  ASSERT_EQ(regions.size(), 1);
+  EXPECT_EQ(regions[0].name, "region");
+  EXPECT_EQ(regions[0].key, key_);
+  EXPECT_EQ(regions[0].offset, kRegionOffset);
+  EXPECT_EQ(regions[0].byte_size, kRegionSize);
+
+  EXPECT_THROW(registry_.add({"region", key_, 0, 1}), invalid_argument);
+  EXPECT_THROW(registry_.add({"large", key_, 0, kObjectSize + 1}),
+               invalid_argument);
+  EXPECT_THROW(registry_.add({"past", key_, kObjectSize + 1, 1}),
+               invalid_argument);
+  // an offset and size that wrap around when they're added are too large
+  EXPECT_THROW(registry_.add({"wrap", key_, kRegionOffset,
+                              std::numeric_limits<size_t>::max()}),
+               invalid_argument);
+  EXPECT_THROW(registry_.add({"missing", key_ + "_missing", 0, 1}),
+               invalid_argument);
+  EXPECT_THROW((void)registry_.get("region", kRegionSize - 3, 4),
+               invalid_argument);
+  EXPECT_THROW((void)registry_.get("missing", 0, 1), invalid_argument);
+  EXPECT_THROW((void)registry_.status("missing"), invalid_argument);
+
+  // GPU regions are separate from system ones and need a valid IPC handle
+  EXPECT_TRUE(
+    registry_.status("", MemoryAllocators::HipSharedMemory).empty());
+  EXPECT_THROW(
+    (void)registry_.status("region", MemoryAllocators::HipSharedMemory),
+    invalid_argument);
+  EXPECT_THROW(registry_.add({"gpu", "handle", 0, 1,
+                              MemoryAllocators::HipSharedMemory, 0}),
+               invalid_argument);
+  registry_.remove("region", MemoryAllocators::HipSharedMemory);
+  EXPECT_EQ(registry_.status("").size(), 1);
+
+  // memory that's in use stays mapped after the region is unregistered
+  registry_.remove("region");
+  EXPECT_TRUE(registry_.status("").empty());
+  EXPECT_EQ(data[0], static_cast<uint8_t>(kRegionOffset + 10));
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST_F(UnitSharedMemory, Inputs) {
+  SharedMemoryTensors tensors{&registry_};
+  RequestContainer container;
+
+  InferenceRequestInput input;
+  input.setName("input");
+  input.setShape({4});
+  input.setDatatype(DataType::Uint8);
+  EXPECT_FALSE(tensors.addInput(input, &container));
+  EXPECT_TRUE(container.input_views.empty());
+
+  input.setParameters(tensorParameters(8, 4));
+  ASSERT_TRUE(tensors.addInput(input, &container));
+  ASSERT_EQ(container.input_views.size(), 1);
+  ASSERT_EQ(container.input_writers.size(), 1);
+  EXPECT_FALSE(container.device_views);
+  const auto* data = static_cast<const uint8_t*>(container.input_views[0]);
+  EXPECT_EQ(data[0], static_cast<uint8_t>(kRegionOffset + 8));
+  memory_[kRegionOffset + 9] = 0;
+  EXPECT_EQ(data[1], 0);
+
+  // the writer copies the same data
+  std::vector<uint8_t> copy(4);
+  CpuBuffer buffer{copy.data(), MemoryAllocators::Cpu, copy.size()};
+  container.input_writers[0](&buffer, 0);
+  EXPECT_EQ(copy[0], static_cast<uint8_t>(kRegionOffset + 8));
+  EXPECT_EQ(copy[1], 0);
+
+  // the data must match the shape of the input
+  input.setParameters(tensorParameters(8, 5));
+  EXPECT_THROW((void)tensors.addInput(input, &container), invalid_argument);
+
+  input.setParameters(tensorParameters(8, 4));
+  SharedMemoryTensors unsupported;
+  EXPECT_THROW((void)unsupported.addInput(input, &container),
+               invalid_argument);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST_F(UnitSharedMemory, Outputs) {
+  InferenceRequest request;
+  InferenceRequestOutput requested;
+  requested.setName("output");
+  requested.setParameters(tensorParameters(0, 8));
+  request.addOutputTensor(requested);
+  InferenceRequestOutput other;
+  other.setName("other");
+  request.addOutputTensor(other);
+
+  SharedMemoryTensors tensors{&registry_};
+  tensors.addOutputs(request);
+  EXPECT_TRUE(tensors.containsOutput("output"));
+  EXPECT_FALSE(tensors.containsOutput("other"));
+
+  InferenceResponseOutput output;
+  output.setName("output");
+  output.setShape({4});
+  output.setDatatype(DataType::Uint8);
+  output.setData(std::vector<std::byte>(4, std::byte{7}));
+  const auto parameters = tensors.writeOutput(output);
+  EXPECT_EQ(parameters.get<int32_t>(kSharedMemoryByteSize), 4);
+  EXPECT_EQ(parameters.get<std::string>(kSharedMemoryRegion), "region");
+  EXPECT_EQ(memory_[kRegionOffset + 3], 7);
+  EXPECT_EQ(memory_[kRegionOffset + 4],
+            static_cast<uint8_t>(kRegionOffset + 4));
+
+  // outputs can't be larger than the space requested for them
+  output.setShape({9});
+  output.setData(std::vector<std::byte>(9));
+  EXPECT_THROW((void)tensors.writeOutput(output), invalid_argument);
+}
+
+}  // namespace amdinfer
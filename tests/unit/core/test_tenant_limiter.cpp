@@ -0,0 +1,149 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>  // for int64_t
+#include <map>      // for map
+#include <string>   // for string
+#include <utility>  // for move
+#include <vector>   // for vector
+
+#include "amdinfer/core/tenant_limiter.hpp"  // for TenantLimiter, RateBucket
+#include "gtest/gtest.h"                     // for Test, EXPECT_EQ
+
+namespace amdinfer {
+
+namespace {
+
+constexpr int64_t kSecond = 1'000'000'000;
+
+}  // namespace
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitTenantLimiter, RateBucket) {
+  // two per second with a burst of two seconds holds four
+  RateBucket bucket{2, 2};
+  const auto start = kSecond;
+  for (auto i = 0; i < 4; ++i) {
+    EXPECT_TRUE(bucket.take(1, start));
+  }
+  EXPECT_FALSE(bucket.take(1, start));
+  // half a second refills one
+  EXPECT_TRUE(bucket.take(1, start + kSecond / 2));
+  EXPECT_FALSE(bucket.take(1, start + kSecond / 2));
+  bucket.giveBack(1);
+  EXPECT_TRUE(bucket.take(1, start + kSecond / 2));
+
+  // a full bucket gives more than it holds and then stays empty until the
+  // debt is paid off
+  RateBucket bytes{100, 1};
+  EXPECT_TRUE(bytes.take(300, start));
+  EXPECT_FALSE(bytes.take(1, start + 2 * kSecond));
+  EXPECT_TRUE(bytes.take(1, start + 3 * kSecond));
+
+  RateBucket unlimited{0, 1};
+  for (auto i = 0; i < 100; ++i) {
+    EXPECT_TRUE(unlimited.take(1, start));
+  }
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitTenantLimiter, Rate) {
+  TenantLimits limits;
+  limits.requests_per_second = 1;
+  limits.burst = 3;
+  TenantLimiter limiter{"X-Tenant-ID", limits};
+  EXPECT_EQ(limiter.header(), "x-tenant-id");
+
+  for (auto i = 0; i < 3; ++i) {
+    EXPECT_FALSE(limiter.admit("a", 0).rejected());
+  }
+  const auto ticket = limiter.admit("a", 0);
+  EXPECT_TRUE(ticket.rejected());
+  EXPECT_EQ(ticket.rejection(), TenantRejection::Rate);
+  // each tenant has buckets of its own
+  EXPECT_FALSE(limiter.admit("b", 0).rejected());
+  EXPECT_FALSE(limiter.admit("", 0).rejected());
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitTenantLimiter, Bytes) {
+  TenantLimits limits;
+  limits.requests_per_second = 1;
+  limits.bytes_per_second = 100;
+  limits.burst = 2;
+  TenantLimiter limiter{"x-tenant-id", limits};
+
+  EXPECT_FALSE(limiter.admit("a", 150).rejected());
+  EXPECT_EQ(limiter.admit("a", 100).rejection(), TenantRejection::Bytes);
+  // the call turned away for its bytes gave back its request
+  EXPECT_FALSE(limiter.admit("a", 10).rejected());
+  EXPECT_EQ(limiter.admit("a", 0).rejection(), TenantRejection::Rate);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitTenantLimiter, InFlight) {
+  TenantLimits limits;
+  limits.max_in_flight = 2;
+  TenantLimiter limiter{"x-tenant-id", limits};
+
+  auto first = limiter.admit("a", 0);
+  auto second = limiter.admit("a", 0);
+  EXPECT_FALSE(second.rejected());
+  EXPECT_EQ(limiter.admit("a", 0).rejection(), TenantRejection::InFlight);
+  // a call that was turned away doesn't keep a place
+  EXPECT_EQ(limiter.admit("a", 0).rejection(), TenantRejection::InFlight);
+
+  first.release();
+  first.release();
+  auto third = std::move(second);
+  EXPECT_FALSE(limiter.admit("a", 0).rejected());
+  {
+    const auto fourth = limiter.admit("a", 0);
+    EXPECT_FALSE(fourth.rejected());
+    EXPECT_TRUE(limiter.admit("a", 0).rejected());
+  }
+  EXPECT_FALSE(limiter.admit("a", 0).rejected());
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitTenantLimiter, Tenants) {
+  TenantLimits limits;
+  limits.max_in_flight = 1;
+  TenantLimits large;
+  large.max_in_flight = 3;
+  TenantLimiter limiter{
+    "x-tenant-id", limits, {{"large", large}, {"other", large}}, 2};
+
+  std::vector<TenantTicket> tickets;
+  for (auto i = 0; i < 3; ++i) {
+    tickets.push_back(limiter.admit("large", 0));
+    EXPECT_FALSE(tickets.back().rejected());
+  }
+  EXPECT_TRUE(limiter.admit("large", 0).rejected());
+
+  // listed tenants don't count towards the most that are added
+  tickets.push_back(limiter.admit("a", 0));
+  tickets.push_back(limiter.admit("b", 0));
+  EXPECT_TRUE(limiter.admit("a", 0).rejected());
+  EXPECT_TRUE(limiter.admit("b", 0).rejected());
+  // later tenants share the limits of "other"
+  for (const auto* tenant : {"c", "d", "e"}) {
+    tickets.push_back(limiter.admit(tenant, 0));
+    EXPECT_FALSE(tickets.back().rejected());
+  }
+  EXPECT_TRUE(limiter.admit("f", 0).rejected());
+  EXPECT_TRUE(limiter.admit("other", 0).rejected());
+}
+
+}  // namespace amdinfer
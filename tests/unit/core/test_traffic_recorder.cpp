@@ -0,0 +1,143 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <unistd.h>  // for getpid
+
+#include <cstdint>     // for int32_t, uint64_t
+#include <filesystem>  // for path, temp_directory_path, remove
+#include <fstream>     // for ofstream
+#include <memory>      // for make_shared
+#include <string>      // for string, to_string
+#include <utility>     // for move
+#include <vector>      // for vector
+
+#include "amdinfer/core/data_types.hpp"         // for DataType
+#include "amdinfer/core/exceptions.hpp"         // for invalid_argument
+#include "amdinfer/core/inference_request.hpp"  // for InferenceRequest
+#include "amdinfer/core/request_container.hpp"  // for RequestContainer
+#include "amdinfer/core/traffic_log.hpp"        // for TrafficLog
+#include "amdinfer/core/traffic_recorder.hpp"   // for TrafficRecorder
+#include "gtest/gtest.h"                        // for Test, EXPECT_EQ
+
+namespace fs = std::filesystem;
+
+namespace amdinfer {
+
+namespace {
+
+fs::path getLogPath(const std::string& name) {
+  return fs::temp_directory_path() /
+         ("amdinfer_traffic_" + name + "_" + std::to_string(getpid()));
+}
+
+/// Record some requests with numbered data and return the log's records
+std::vector<TrafficRecord> recordAndRead(const fs::path& path,
+                                         const RecorderLimits& limits,
+                                         int requests) {
+  {
+    TrafficRecorder recorder{path, limits};
+    for (auto i = 0; i < requests; ++i) {
+      std::vector<int32_t> data{i, i + 1, i + 2};
+      RequestContainer container;
+      container.request = std::make_shared<InferenceRequest>();
+      container.request->addInputTensor(data.data(), {3}, DataType::Int32,
+                                        "input");
+      recorder.record("model", container);
+    }
+  }
+  TrafficLog log{path};
+  std::vector<TrafficRecord> records;
+  while (auto record = log.next()) {
+    records.push_back(std::move(*record));
+  }
+  return records;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitTrafficRecorder, Payloads) {
+  RecorderLimits limits;
+  limits.payloads = true;
+  const auto path = getLogPath("payloads");
+  const auto records = recordAndRead(path, limits, 4);
+  fs::remove(path);
+
+  ASSERT_EQ(records.size(), 4);
+  for (auto i = 0U; i < records.size(); ++i) {
+    const auto& record = records[i];
+    EXPECT_EQ(record.endpoint, "model");
+    EXPECT_TRUE(record.payload);
+    if (i > 0) {
+      EXPECT_GE(record.arrival, records[i - 1].arrival);
+    }
+    const auto& inputs = record.request->getInputs();
+    ASSERT_EQ(inputs.size(), 1);
+    EXPECT_EQ(inputs[0].getName(), "input");
+    EXPECT_EQ(inputs[0].getShape(), (std::vector<uint64_t>{3}));
+    EXPECT_EQ(inputs[0].getDatatype(), DataType::Int32);
+    const auto* data = static_cast<const int32_t*>(inputs[0].getData());
+    EXPECT_EQ(data[0], static_cast<int32_t>(i));
+    EXPECT_EQ(data[2], static_cast<int32_t>(i + 2));
+  }
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitTrafficRecorder, ShapesOnly) {
+  const auto path = getLogPath("shapes");
+  const auto records = recordAndRead(path, {}, 2);
+  fs::remove(path);
+
+  ASSERT_EQ(records.size(), 2);
+  // the data that wasn't recorded is replayed as zeros
+  EXPECT_FALSE(records[1].payload);
+  const auto& inputs = records[1].request->getInputs();
+  ASSERT_EQ(inputs.size(), 1);
+  EXPECT_EQ(inputs[0].getShape(), (std::vector<uint64_t>{3}));
+  const auto* data = static_cast<const int32_t*>(inputs[0].getData());
+  EXPECT_EQ(data[0], 0);
+  EXPECT_EQ(data[2], 0);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitTrafficRecorder, Sampling) {
+  RecorderLimits limits;
+  limits.sample_rate = 0.25;
+  const auto path = getLogPath("sampling");
+  EXPECT_EQ(recordAndRead(path, limits, 16).size(), 4);
+  fs::remove(path);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitTrafficRecorder, MaxBytes) {
+  const auto path = getLogPath("max_bytes");
+  ASSERT_EQ(recordAndRead(path, {}, 1).size(), 1);
+  const auto record_size = fs::file_size(path) - sizeof(TrafficLogHeader);
+
+  // room for the header and two and a half records
+  RecorderLimits limits;
+  limits.max_bytes = sizeof(TrafficLogHeader) + record_size * 5 / 2;
+  EXPECT_EQ(recordAndRead(path, limits, 8).size(), 2);
+  fs::remove(path);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitTrafficRecorder, NotALog) {
+  const auto path = getLogPath("not_a_log");
+  std::ofstream{path} << "not a traffic log";
+  EXPECT_THROW(TrafficLog{path}, invalid_argument);
+  fs::remove(path);
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,138 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>           // for sort
+#include <chrono>              // for milliseconds
+#include <condition_variable>  // for condition_variable
+#include <cstddef>             // for size_t
+#include <filesystem>          // for path, create_directories, remove_all
+#include <fstream>             // for ofstream
+#include <mutex>               // for mutex, lock_guard, unique_lock
+#include <string>              // for string
+#include <thread>              // for sleep_for
+#include <vector>              // for vector
+
+#include "amdinfer/build_options.hpp"         // for AMDINFER_ENABLE_LOGGING
+#include "amdinfer/core/update_listener.hpp"  // for UpdateListener
+#include "amdinfer/observation/logging.hpp"   // for initLogger, LogOptions
+#include "gtest/gtest.h"                      // for Test, EXPECT_EQ
+
+namespace fs = std::filesystem;
+
+namespace amdinfer {
+
+namespace {
+
+constexpr std::chrono::milliseconds kSettle{20};
+
+/// Records the changes that a listener applies
+class Applied {
+ public:
+  UpdateListener::ApplyChange callback() {
+    return [this](const std::string& model) {
+      std::lock_guard lock{mutex_};
+      models_.push_back(model);
+      cv_.notify_all();
+    };
+  }
+
+  /**
+   * @brief Wait for a number of changes to be applied and then for a while
+   * longer to catch any extra ones
+   *
+   * @param count the changes to wait for
+   * @return std::vector<std::string> the models whose changes were applied
+   */
+  std::vector<std::string> wait(size_t count) {
+    std::unique_lock lock{mutex_};
+    cv_.wait_for(lock, std::chrono::seconds{5},
+                 [&]() { return models_.size() >= count; });
+    lock.unlock();
+    std::this_thread::sleep_for(10 * kSettle);
+    lock.lock();
+    return models_;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::vector<std::string> models_;
+};
+
+void initLogging() {
+#ifdef AMDINFER_ENABLE_LOGGING
+  LogOptions options{
+    "server",        // logger_name
+    "",              // log directory
+    false,           // enable file logging
+    LogLevel::Warn,  // file log level
+    true,            // enable console logging
+    LogLevel::Warn   // console log level
+  };
+  initLogger(options);
+#endif
+}
+
+/// Write a model's config and tell the listener about it like the watcher
+void writeConfig(UpdateListener* listener, const fs::path& repository,
+                 const std::string& model, int revision) {
+  const auto directory = repository / model;
+  fs::create_directories(directory);
+  std::ofstream{directory / "config.pbtxt"} << "revision " << revision;
+  listener->handleFileAction(0, directory.string(), "config.pbtxt",
+                             efsw::Actions::Modified, "");
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitUpdateListener, Debounce) {
+  initLogging();
+  const auto repository =
+    fs::temp_directory_path() / "amdinfer_test_update_listener";
+  fs::remove_all(repository);
+  fs::create_directories(repository);
+
+  Applied applied;
+  {
+    UpdateListener listener{repository, applied.callback(), 2, kSettle};
+
+    // a burst of events for one model is applied once, after it settles
+    for (auto i = 0; i < 20; ++i) {
+      writeConfig(&listener, repository, "a", i);
+      std::this_thread::sleep_for(kSettle / 4);
+    }
+    // files that aren't a model's config aren't applied by themselves and
+    // files outside the repository are ignored
+    fs::create_directories(repository / "b" / "1");
+    listener.handleFileAction(0, (repository / "b" / "1").string(),
+                              "model.onnx", efsw::Actions::Add, "");
+    listener.handleFileAction(0, repository.parent_path().string(),
+                              "config.pbtxt", efsw::Actions::Modified, "");
+    EXPECT_EQ(applied.wait(1), (std::vector<std::string>{"a"}));
+
+    // a later change is applied again and changes to two models are both
+    // applied
+    writeConfig(&listener, repository, "a", 20);
+    writeConfig(&listener, repository, "b", 0);
+    auto models = applied.wait(3);
+    ASSERT_EQ(models.size(), 3);
+    std::sort(models.begin() + 1, models.end());
+    EXPECT_EQ(models, (std::vector<std::string>{"a", "a", "b"}));
+  }
+
+  fs::remove_all(repository);
+}
+
+}  // namespace amdinfer
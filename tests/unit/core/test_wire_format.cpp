@@ -0,0 +1,190 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <sys/socket.h>  // for socketpair
+#include <unistd.h>      // for close
+
+#include <array>    // for array
+#include <cstddef>  // for byte
+#include <cstdint>  // for int32_t, uint64_t
+#include <cstring>  // for memcpy
+#include <string>   // for string
+#include <thread>   // for thread
+#include <vector>   // for vector
+
+#include "amdinfer/core/data_types.hpp"          // for DataType
+#include "amdinfer/core/exceptions.hpp"          // for invalid_argument
+#include "amdinfer/core/inference_request.hpp"   // for InferenceRequest
+#include "amdinfer/core/inference_response.hpp"  // for InferenceResponse
+#include "amdinfer/core/wire_format.hpp"         // for encodeRequest
+#include "gtest/gtest.h"                         // for Test, EXPECT_EQ
+
+namespace amdinfer {
+
+namespace {
+
+/// Decode the header of a flattened message and return it
+WireHeader getHeader(const std::vector<std::byte>& message) {
+  return decodeHeader(message.data(), message.size() - sizeof(WireHeader));
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitWireFormat, Request) {
+  std::vector<int32_t> data{1, 2, 3, 4, 5, 6};
+  std::string text{"hello"};
+
+  InferenceRequest request;
+  request.setID("id");
+  ParameterMap parameters;
+  parameters.put("key", 1);
+  parameters.put("text", std::string(300, 'x'));
+  request.setParameters(parameters);
+  request.addInputTensor(data.data(), {2, 3}, DataType::Int32, "numbers");
+  request.addInputTensor(text.data(), {text.size()}, DataType::String, "text");
+
+  const auto encoded = encodeRequest(7, "model", request);
+  // the tensors' data is sent in place
+  ASSERT_EQ(encoded.data.size(), 2);
+  EXPECT_EQ(static_cast<const void*>(encoded.data[0].data), data.data());
+
+  const auto message = encoded.flatten();
+  EXPECT_EQ(message.size(), encoded.size());
+  const auto header = getHeader(message);
+  EXPECT_EQ(header.kind, WireKind::Request);
+  EXPECT_EQ(header.data_size, data.size() * sizeof(int32_t) + text.size());
+
+  const auto decoded = decodeRequest(header, message.data() + sizeof(header));
+  EXPECT_EQ(decoded.tag, 7);
+  EXPECT_EQ(decoded.model, "model");
+  EXPECT_EQ(decoded.request->getID(), "id");
+  EXPECT_EQ(decoded.request->getParameters().get<int32_t>("key"), 1);
+  EXPECT_EQ(decoded.request->getParameters().get<std::string>("text"),
+            std::string(300, 'x'));
+
+  const auto& inputs = decoded.request->getInputs();
+  ASSERT_EQ(inputs.size(), 2);
+  EXPECT_EQ(inputs[0].getName(), "numbers");
+  EXPECT_EQ(inputs[0].getShape(), (std::vector<uint64_t>{2, 3}));
+  EXPECT_EQ(inputs[0].getDatatype(), DataType::Int32);
+  const auto* numbers = static_cast<const int32_t*>(inputs[0].getData());
+  EXPECT_EQ(std::vector<int32_t>(numbers, numbers + data.size()), data);
+  EXPECT_EQ(std::string(static_cast<const char*>(inputs[1].getData()),
+                        inputs[1].getSize()),
+            text);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitWireFormat, Response) {
+  std::vector<float> data{1.5F, 2.5F};
+  InferenceResponse response;
+  response.setID("id");
+  response.setModel("model");
+  InferenceResponseOutput output;
+  output.setName("output");
+  output.setDatatype(DataType::Fp32);
+  output.setShape({data.size()});
+  std::vector<std::byte> bytes(data.size() * sizeof(float));
+  std::memcpy(bytes.data(), data.data(), bytes.size());
+  output.setData(std::move(bytes));
+  response.addOutput(std::move(output));
+
+  const auto message = encodeResponse(3, response).flatten();
+  const auto header = getHeader(message);
+  EXPECT_EQ(header.tag, 3);
+  const auto decoded = decodeResponse(header, message.data() + sizeof(header));
+  EXPECT_FALSE(decoded.isError());
+  EXPECT_EQ(decoded.getID(), "id");
+  EXPECT_EQ(decoded.getModel(), "model");
+  const auto& outputs = decoded.getOutputs();
+  ASSERT_EQ(outputs.size(), 1);
+  EXPECT_EQ(outputs[0].getName(), "output");
+  const auto* values = static_cast<const float*>(outputs[0].getData());
+  EXPECT_EQ(std::vector<float>(values, values + data.size()), data);
+
+  InferenceResponse error{"failed"};
+  error.setID("id");
+  const auto error_message = encodeResponse(4, error).flatten();
+  const auto error_header = getHeader(error_message);
+  EXPECT_EQ(error_header.flags, kWireError);
+  const auto decoded_error =
+    decodeResponse(error_header, error_message.data() + sizeof(WireHeader));
+  EXPECT_TRUE(decoded_error.isError());
+  EXPECT_EQ(decoded_error.getError(), "failed");
+  EXPECT_EQ(decoded_error.getID(), "id");
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitWireFormat, Invalid) {
+  std::vector<int32_t> data{1, 2};
+  InferenceRequest request;
+  request.addInputTensor(data.data(), {2}, DataType::Int32, "input");
+  auto message = encodeRequest(0, "model", request).flatten();
+
+  EXPECT_THROW(decodeHeader(message.data(), 1), invalid_argument);
+  const auto header = getHeader(message);
+  EXPECT_THROW(decodeResponse(header, message.data() + sizeof(WireHeader)),
+               invalid_argument);
+
+  // claiming less data than the tensors have is caught before reading past it
+  auto truncated = header;
+  truncated.data_size -= 1;
+  EXPECT_THROW(decodeRequest(truncated, message.data() + sizeof(WireHeader)),
+               invalid_argument);
+
+  // so is a string whose length runs past the end of the metadata
+  const uint64_t length = 1ULL << 40U;
+  std::memcpy(message.data() + sizeof(WireHeader), &length, sizeof(length));
+  EXPECT_THROW(decodeRequest(header, message.data() + sizeof(WireHeader)),
+               invalid_argument);
+
+  message[0] = std::byte{0};
+  EXPECT_THROW(getHeader(message), invalid_argument);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitWireFormat, Socket) {
+  std::array<int, 2> sockets{};
+  ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, sockets.data()), 0);
+
+  // larger than the socket's buffer so it's sent in more than one write
+  constexpr auto kSize = 1U << 22U;
+  std::vector<uint8_t> data(kSize);
+  for (auto i = 0U; i < kSize; ++i) {
+    data[i] = static_cast<uint8_t>(i);
+  }
+  InferenceRequest request;
+  request.addInputTensor(data.data(), {kSize}, DataType::Uint8, "input");
+  const auto message = encodeRequest(1, "model", request);
+  std::thread sender{[&] { EXPECT_TRUE(sendMessage(sockets[0], message)); }};
+
+  std::array<std::byte, sizeof(WireHeader)> raw_header;
+  ASSERT_TRUE(receive(sockets[1], raw_header.data(), raw_header.size()));
+  const auto header = decodeHeader(raw_header.data(), kSize * 2);
+  std::vector<std::byte> body(header.bodySize());
+  ASSERT_TRUE(receive(sockets[1], body.data(), body.size()));
+  sender.join();
+
+  const auto decoded = decodeRequest(header, body.data());
+  const auto* received =
+    static_cast<const uint8_t*>(decoded.request->getInputs()[0].getData());
+  EXPECT_EQ(std::vector<uint8_t>(received, received + kSize), data);
+
+  close(sockets[0]);
+  EXPECT_FALSE(receive(sockets[1], body.data(), 1));
+  close(sockets[1]);
+}
+
+}  // namespace amdinfer
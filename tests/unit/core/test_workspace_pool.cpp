@@ -0,0 +1,127 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstddef>  // for size_t
+#include <cstdlib>  // for malloc, free
+#include <memory>   // for make_shared, shared_ptr
+#include <utility>  // for move
+
+#include "amdinfer/core/exceptions.hpp"      // for runtime_error
+#include "amdinfer/core/workspace_pool.hpp"  // for WorkspacePool
+#include "gtest/gtest.h"                     // for Test, EXPECT_EQ
+
+namespace amdinfer {
+
+namespace {
+
+/// Make a pool of host memory that counts its allocations
+std::shared_ptr<WorkspacePool> makePool(int* allocations) {
+  return std::make_shared<WorkspacePool>(
+    [allocations](size_t bytes) {
+      ++*allocations;
+      // NOLINTNEXTLINE(cppcoreguidelines-no-malloc)
+      return std::malloc(bytes);
+    },
+    [allocations](void* data) {
+      --*allocations;
+      // NOLINTNEXTLINE(cppcoreguidelines-no-malloc)
+      std::free(data);
+    });
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitWorkspacePool, Shared) {
+  // NOLINTNEXTLINE(cppcoreguidelines-no-malloc)
+  auto allocate = [](size_t bytes) { return std::malloc(bytes); };
+  // NOLINTNEXTLINE(cppcoreguidelines-no-malloc)
+  auto free = [](void* data) { std::free(data); };
+  auto pool = WorkspacePool::get("test0", allocate, free);
+  EXPECT_EQ(WorkspacePool::get("test0", allocate, free), pool);
+  EXPECT_NE(WorkspacePool::get("test1", allocate, free), pool);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitWorkspacePool, Reuse) {
+  auto allocations = 0;
+  {
+    auto pool = makePool(&allocations);
+    pool->reserve(64);
+    pool->reserve(256);
+    EXPECT_EQ(pool->getWorkspaceSize(), 256U);
+
+    // two jobs in flight at once need two workspaces
+    auto first = pool->acquire();
+    auto second = pool->acquire();
+    EXPECT_NE(first.data(), second.data());
+    EXPECT_EQ(first.size(), 256U);
+    EXPECT_EQ(allocations, 2);
+    EXPECT_EQ(pool->getAllocatedSize(), 512U);
+
+    // returned workspaces are reused
+    auto* data = first.data();
+    first.release();
+    auto third = pool->acquire();
+    EXPECT_EQ(third.data(), data);
+    EXPECT_EQ(allocations, 2);
+
+    // moving a lease doesn't return it
+    auto moved = std::move(third);
+    EXPECT_EQ(moved.data(), data);
+    EXPECT_EQ(third.data(), nullptr);
+    EXPECT_EQ(allocations, 2);
+  }
+  EXPECT_EQ(allocations, 0);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitWorkspacePool, Resize) {
+  auto allocations = 0;
+  auto pool = makePool(&allocations);
+  pool->reserve(64);
+  auto lease = pool->acquire();
+  pool->acquire().release();
+  EXPECT_EQ(allocations, 2);
+
+  // a larger reservation frees the idle workspace and the leased one once
+  // it's returned
+  pool->reserve(128);
+  EXPECT_EQ(allocations, 1);
+  EXPECT_EQ(lease.size(), 64U);
+  lease.release();
+  EXPECT_EQ(allocations, 0);
+  EXPECT_EQ(pool->acquire().size(), 128U);
+  EXPECT_EQ(pool->getAllocatedSize(), 128U);
+
+  // the workspaces shrink once the larger reservation is given back
+  pool->unreserve(128);
+  EXPECT_EQ(pool->getWorkspaceSize(), 64U);
+  EXPECT_EQ(allocations, 0);
+  pool->unreserve(64);
+  EXPECT_EQ(pool->getWorkspaceSize(), 0U);
+  EXPECT_EQ(pool->acquire().data(), nullptr);
+  EXPECT_EQ(pool->getAllocatedSize(), 0U);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitWorkspacePool, OutOfMemory) {
+  auto pool = std::make_shared<WorkspacePool>([](size_t) { return nullptr; },
+                                              [](void*) {});
+  pool->reserve(64);
+  EXPECT_THROW((void)pool->acquire(), runtime_error);
+  EXPECT_EQ(pool->getAllocatedSize(), 0U);
+}
+
+}  // namespace amdinfer
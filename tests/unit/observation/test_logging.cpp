@@ -0,0 +1,93 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <spdlog/spdlog.h>  // for get
+
+#include <filesystem>  // for path, temp_directory_path, create_directories
+#include <fstream>     // for ifstream
+#include <string>      // for string, getline, to_string
+
+#include "amdinfer/observation/logging.hpp"  // for initLogger, Logger
+#include "gtest/gtest.h"                     // for Test, EXPECT_EQ
+
+namespace fs = std::filesystem;
+
+namespace amdinfer {
+
+namespace {
+
+LogOptions makeOptions(const fs::path& directory) {
+  return {
+    "test",  // logger_name
+    directory.string(),
+    true,            // enable file logging
+    LogLevel::Warn,  // file log level
+    false,           // enable console logging
+    LogLevel::Off    // console log level
+  };
+}
+
+/// Count the lines in the file that contain the text
+int countLines(const fs::path& path, const std::string& text) {
+  std::ifstream file{path};
+  std::string line;
+  auto count = 0;
+  while (std::getline(file, line)) {
+    if (line.find(text) != std::string::npos) {
+      count++;
+    }
+  }
+  return count;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitLogging, ReachesSink) {
+  const auto directory = fs::temp_directory_path() / "amdinfer_test_logging";
+  fs::create_directories(directory);
+  const auto path = directory / "test.log";
+
+  initLogger(makeOptions(directory));
+  {
+    Logger logger{Loggers::Test};
+    // more messages than the queue holds are all written since logging waits
+    // for room instead of dropping the oldest
+    constexpr auto kMessages = 20000;
+    for (auto i = 0; i < kMessages; ++i) {
+      AMDINFER_LOG_WARN(logger, "message " + std::to_string(i));
+    }
+    AMDINFER_LOG_ERROR(logger, "last");
+
+    // shutting down writes out everything that's queued
+    shutdownLogging();
+    EXPECT_EQ(countLines(path, "message "), kMessages);
+    EXPECT_EQ(countLines(path, "last"), 1);
+  }
+  EXPECT_EQ(spdlog::get("test"), nullptr);
+
+  // logging can be started again after it's shut down
+  initLogger(makeOptions(directory));
+  {
+    Logger logger{Loggers::Test};
+    AMDINFER_LOG_WARN(logger, "again");
+  }
+  shutdownLogging();
+  EXPECT_EQ(countLines(path, "again"), 1);
+  EXPECT_EQ(countLines(path, "message "), 0);
+
+  fs::remove_all(directory);
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,209 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <prometheus/metric_family.h>  // for MetricFamily
+
+#include <chrono>   // for milliseconds
+#include <cmath>    // for isnan
+#include <cstdint>  // for uint64_t
+#include <sstream>  // for istringstream
+#include <string>   // for string, getline
+#include <thread>   // for thread, sleep_for
+#include <tuple>    // for ignore
+#include <vector>   // for vector
+
+#include "amdinfer/observation/metrics.hpp"  // for Metrics, ShardedCounter
+#include "gtest/gtest.h"                     // for Test, EXPECT_EQ
+
+namespace amdinfer {
+
+namespace {
+
+/// Get the line of a metric in the serialized metrics, which has its value
+std::string findMetric(const std::string& metrics, const std::string& name) {
+  std::istringstream stream{metrics};
+  std::string line;
+  while (std::getline(stream, line)) {
+    if (line.rfind(name + " ", 0) == 0) {
+      return line;
+    }
+  }
+  return "";
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitMetrics, ShardedCounter) {
+  constexpr auto kThreads = 8;
+  constexpr auto kIncrements = 10000;
+
+  ShardedCounter counter;
+  std::vector<std::thread> threads;
+  threads.reserve(kThreads);
+  for (auto i = 0; i < kThreads; ++i) {
+    threads.emplace_back([&counter]() {
+      for (auto j = 0; j < kIncrements; ++j) {
+        counter.increment(1);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  // no increments are lost even if threads share a shard
+  EXPECT_EQ(counter.value(), kThreads * kIncrements);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitMetrics, ShardedHistogram) {
+  ShardedHistogram histogram{{1, 2, 4}};
+  for (const auto value : {0.5, 1.0, 1.5, 3.0, 4.0, 10.0}) {
+    histogram.observe(value);
+  }
+
+  // values equal to a bound go in its bucket and large ones overflow
+  const std::vector<uint64_t> expected{2, 1, 2, 1};
+  const auto counts = histogram.counts();
+  EXPECT_EQ(counts, expected);
+  EXPECT_DOUBLE_EQ(histogram.sum(), 20.0);
+
+  // the quantiles are interpolated within their bucket
+  EXPECT_DOUBLE_EQ(histogram.quantile(counts, 0.5), 2.0);
+  EXPECT_DOUBLE_EQ(histogram.quantile(counts, 0.75), 3.5);
+  // there's no upper bound for the overflow bucket
+  EXPECT_DOUBLE_EQ(histogram.quantile(counts, 1.0), 4.0);
+
+  const ShardedHistogram empty{{1}};
+  EXPECT_TRUE(std::isnan(empty.quantile(empty.counts(), 0.5)));
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitMetrics, ScrapeCallback) {
+  auto& metrics = Metrics::getInstance();
+  auto calls = 0;
+  const auto id = metrics.addScrapeCallback([&calls, &metrics]() {
+    calls++;
+    metrics.setGauge(MetricGaugeIDs::QueuesBatcherInput, "echo", 2);
+  });
+
+  std::ignore = metrics.getMetrics();
+  EXPECT_EQ(calls, 1);
+
+  metrics.removeScrapeCallback(id);
+  std::ignore = metrics.getMetrics();
+  EXPECT_EQ(calls, 1);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitMetrics, ScrapeInterval) {
+  auto& metrics = Metrics::getInstance();
+  auto calls = 0;
+  const auto id = metrics.addScrapeCallback([&calls]() { calls++; });
+
+  // scrapes within the interval get the last serialization
+  metrics.setScrapeInterval(std::chrono::milliseconds(10));
+  const auto first = metrics.getMetrics();
+  EXPECT_EQ(metrics.getMetrics(), first);
+  EXPECT_EQ(calls, 1);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  std::ignore = metrics.getMetrics();
+  EXPECT_EQ(calls, 2);
+
+  metrics.setScrapeInterval(std::chrono::milliseconds(0));
+  std::ignore = metrics.getMetrics();
+  std::ignore = metrics.getMetrics();
+  EXPECT_EQ(calls, 4);
+  metrics.removeScrapeCallback(id);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitMetrics, Exclusion) {
+  auto& metrics = Metrics::getInstance();
+  const std::string name = R"(amdinfer_pipeline_ingress_total{stage="worker"})";
+  metrics.incrementCounter(MetricCounterIDs::PipelineIngressWorker);
+  const auto counted = findMetric(metrics.getMetrics(), name);
+  ASSERT_FALSE(counted.empty());
+
+  // what's recorded while an exclusion is alive is left out
+  {
+    const MetricsExclusion exclusion;
+    EXPECT_TRUE(MetricsExclusion::active());
+    metrics.incrementCounter(MetricCounterIDs::PipelineIngressWorker);
+  }
+  EXPECT_FALSE(MetricsExclusion::active());
+  EXPECT_EQ(findMetric(metrics.getMetrics(), name), counted);
+
+  // it only applies to its own thread
+  const MetricsExclusion exclusion;
+  std::thread other{[&metrics]() {
+    EXPECT_FALSE(MetricsExclusion::active());
+    metrics.incrementCounter(MetricCounterIDs::PipelineIngressWorker);
+  }};
+  other.join();
+  EXPECT_NE(findMetric(metrics.getMetrics(), name), counted);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitMetrics, MemoryPoolCache) {
+  auto& metrics = Metrics::getInstance();
+  // the pool's threads count their hits and publish them in bulk
+  metrics.incrementCounter(MetricCounterIDs::MemoryPoolCacheHit, 3);
+  metrics.incrementCounter(MetricCounterIDs::MemoryPoolCacheMiss);
+  const auto serialized = metrics.getMetrics();
+  const std::string hits = R"(amdinfer_memory_pool_cache_total{result="hit"})";
+  const std::string misses =
+    R"(amdinfer_memory_pool_cache_total{result="miss"})";
+  EXPECT_EQ(findMetric(serialized, hits), hits + " 3");
+  EXPECT_EQ(findMetric(serialized, misses), misses + " 1");
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitMetrics, DeviceFamily) {
+  DeviceFamily devices;
+  // overlapping jobs keep the device busy once, not twice
+  devices.start("gpu0");
+  devices.start("gpu0");
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  devices.finish("gpu0");
+  devices.transfer("gpu0", DeviceTransfer::HostToDevice, 4);
+  devices.transfer("gpu0", DeviceTransfer::DeviceToHost, 2);
+  // unmatched ends are ignored
+  devices.finish("gpu1");
+
+  std::vector<prometheus::MetricFamily> families;
+  devices.collect(&families);
+  ASSERT_EQ(families.size(), 3);
+  const auto& busy = families[0].metric;
+  const auto& in_flight = families[1].metric;
+  const auto& transferred = families[2].metric;
+  ASSERT_EQ(busy.size(), 1);
+  EXPECT_EQ(busy[0].label[0].value, "gpu0");
+  const auto busy_seconds = busy[0].counter.value;
+  EXPECT_GE(busy_seconds, 0.01);
+  ASSERT_EQ(in_flight.size(), 1);
+  EXPECT_EQ(in_flight[0].gauge.value, 1);
+  ASSERT_EQ(transferred.size(), 2);
+  EXPECT_EQ(transferred[0].counter.value, 4);
+  EXPECT_EQ(transferred[1].counter.value, 2);
+
+  // the job still in flight counts as busy time as it's collected
+  devices.finish("gpu0");
+  families.clear();
+  devices.collect(&families);
+  EXPECT_GE(families[0].metric[0].counter.value, busy_seconds);
+  EXPECT_EQ(families[1].metric[0].gauge.value, 0);
+}
+
+}  // namespace amdinfer
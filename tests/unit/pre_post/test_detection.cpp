@@ -0,0 +1,185 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstddef>  // for size_t
+#include <vector>   // for vector
+
+#include "amdinfer/pre_post/detection.hpp"  // for detect, packDetections
+#include "gtest/gtest.h"                    // for Test, EXPECT_EQ
+
+namespace amdinfer {
+
+namespace {
+
+const size_t kClasses = 3;
+const size_t kStride = pre_post::detail::kBoxValues + kClasses;
+
+/// Add a prediction of a box centered at (x, y) to the data
+void addBox(std::vector<float>* data, float x, float y, float size,
+            float objectness, size_t class_id) {
+  data->insert(data->end(), {x, y, size, size, objectness});
+  for (size_t i = 0; i < kClasses; ++i) {
+    data->push_back(i == class_id ? 1.0F : 0.1F);
+  }
+}
+
+/// Make an image of boxes that don't overlap and score below the threshold,
+/// with a few that pass in between. Its size isn't a multiple of the vector
+/// widths to also cover the scalar tails
+std::vector<float> makeImage(size_t boxes) {
+  std::vector<float> data;
+  for (size_t i = 0; i < boxes; ++i) {
+    const auto score = i % 7 == 3 ? 0.3F + static_cast<float>(i) / 1000 : 0.1F;
+    addBox(&data, static_cast<float>(i * 10), 0, 4, score, i % kClasses);
+  }
+  return data;
+}
+
+void expectEqual(const pre_post::Detections& actual,
+                 const pre_post::Detections& expected) {
+  ASSERT_EQ(actual.offsets, expected.offsets);
+  ASSERT_EQ(actual.boxes.size(), expected.boxes.size());
+  for (size_t i = 0; i < actual.boxes.size(); ++i) {
+    EXPECT_EQ(actual.boxes[i].class_id, expected.boxes[i].class_id);
+    EXPECT_FLOAT_EQ(actual.boxes[i].score, expected.boxes[i].score);
+    EXPECT_EQ(actual.boxes[i].x, expected.boxes[i].x);
+  }
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitPrePostDetection, Decode) {
+  std::vector<float> data;
+  addBox(&data, 10, 20, 4, 0.9F, 2);
+  addBox(&data, 50, 50, 4, 0.2F, 1);
+
+  const auto detections = pre_post::detect(data.data(), 1, 2, kClasses);
+  ASSERT_EQ(detections.count(0), 1U);
+  const auto& box = detections.boxes[0];
+  EXPECT_EQ(box.class_id, 2);
+  EXPECT_FLOAT_EQ(box.score, 0.9F);
+  EXPECT_EQ(box.x, 8);
+  EXPECT_EQ(box.y, 18);
+  EXPECT_EQ(box.w, 4);
+  EXPECT_EQ(box.h, 4);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitPrePostDetection, Suppress) {
+  std::vector<float> data;
+  addBox(&data, 10, 10, 10, 0.8F, 0);
+  // overlaps the first box by 81/119 so it's suppressed
+  addBox(&data, 11, 11, 10, 0.9F, 0);
+  // overlaps it just as much but is of another class so it's kept
+  addBox(&data, 11, 11, 10, 0.7F, 1);
+  // of the same class but far away so it's kept
+  addBox(&data, 100, 100, 10, 0.6F, 0);
+
+  const auto detections = pre_post::detect(data.data(), 1, 4, kClasses);
+  ASSERT_EQ(detections.count(0), 3U);
+  EXPECT_FLOAT_EQ(detections.boxes[0].score, 0.9F);
+  EXPECT_FLOAT_EQ(detections.boxes[1].score, 0.7F);
+  EXPECT_FLOAT_EQ(detections.boxes[2].score, 0.6F);
+
+  // with a looser threshold, the overlapping boxes are kept
+  pre_post::DetectionOptions options;
+  options.iou_threshold = 0.7F;
+  EXPECT_EQ(pre_post::detect(data.data(), 1, 4, kClasses, options).count(0),
+            4U);
+  options.max_detections = 2;
+  EXPECT_EQ(pre_post::detect(data.data(), 1, 4, kClasses, options).count(0),
+            2U);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitPrePostDetection, Batch) {
+  const size_t boxes = 61;
+  const auto image = makeImage(boxes);
+  std::vector<float> data;
+  for (size_t i = 0; i < 3; ++i) {
+    if (i != 1) {
+      data.insert(data.end(), image.begin(), image.end());
+    } else {
+      // an image with nothing in it
+      data.resize(data.size() + image.size(), 0);
+    }
+  }
+
+  const auto single = pre_post::detect(image.data(), 1, boxes, kClasses);
+  const auto detections = pre_post::detect(data.data(), 3, boxes, kClasses);
+  ASSERT_EQ(single.count(0), 9U);
+  EXPECT_EQ(detections.count(0), single.count(0));
+  EXPECT_EQ(detections.count(1), 0U);
+  EXPECT_EQ(detections.count(2), single.count(0));
+  for (size_t i = 0; i < single.count(0); ++i) {
+    EXPECT_EQ(detections.data(2)[i].x, single.boxes[i].x);
+    if (i > 0) {
+      EXPECT_GE(single.boxes[i - 1].score, single.boxes[i].score);
+    }
+  }
+}
+
+#ifdef AMDINFER_X86_SIMD
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitPrePostDetection, Kernels) {
+  if (!pre_post::detail::hasAvx2()) {
+    GTEST_SKIP() << "AVX2 is not supported";
+  }
+  const size_t boxes = 61;
+  auto data = makeImage(boxes);
+  // overlap some of the boxes so the NMS has something to do
+  for (size_t i = 0; i < 20; ++i) {
+    addBox(&data, static_cast<float>(i * 10) + 1, 1, 4, 0.5F, i % kClasses);
+  }
+  const auto count = data.size() / kStride;
+
+  std::vector<pre_post::detail::Candidate> scalar;
+  std::vector<pre_post::detail::Candidate> avx2;
+  pre_post::detail::decodeScalar(data.data(), count, kClasses, 0.25F, 0,
+                                 &scalar);
+  pre_post::detail::decodeAvx2(data.data(), count, kClasses, 0.25F, 0, &avx2);
+  ASSERT_EQ(scalar.size(), avx2.size());
+  for (size_t i = 0; i < scalar.size(); ++i) {
+    EXPECT_EQ(scalar[i].detection.x, avx2[i].detection.x);
+  }
+
+  pre_post::detail::KeptBoxes kept;
+  for (size_t i = 0; i < scalar.size(); ++i) {
+    kept.add(scalar[i].detection);
+  }
+  for (size_t i = 0; i < boxes; ++i) {
+    const pre_post::Detection box{0, 1, static_cast<float>(i * 5), 0.5F, 4, 4};
+    EXPECT_EQ(pre_post::detail::suppressedScalar(kept, box, 0.3F),
+              pre_post::detail::suppressedAvx2(kept, box, 0.3F));
+  }
+}
+#endif
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitPrePostDetection, Pack) {
+  // rows of [image, class, score, x, y, w, h] out of order by image
+  const std::vector<float> rows{1, 0, 0.9F, 1, 2, 3, 4,  //
+                                0, 1, 0.8F, 5, 6, 7, 8,  //
+                                1, 2, 0.7F, 9, 9, 9, 9,  //
+                                5, 2, 0.7F, 9, 9, 9, 9};
+  const auto detections = pre_post::packDetections(rows.data(), 4, 3);
+  pre_post::Detections expected;
+  expected.boxes = {
+    {1, 0.8F, 5, 6, 7, 8}, {0, 0.9F, 1, 2, 3, 4}, {2, 0.7F, 9, 9, 9, 9}};
+  expected.offsets = {0, 1, 3, 3};
+  expectEqual(detections, expected);
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,79 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <algorithm>  // for sort
+#include <cstddef>    // for size_t
+#include <cstdint>    // for int8_t
+#include <numeric>    // for iota
+#include <vector>     // for vector
+
+#include "amdinfer/pre_post/get_top_k.hpp"  // for getTopK
+#include "gtest/gtest.h"                    // for Test, EXPECT_EQ
+
+namespace amdinfer {
+
+namespace {
+
+template <typename T>
+std::vector<int> expected(const std::vector<T>& data, int k) {
+  std::vector<int> indices(data.size());
+  std::iota(indices.begin(), indices.end(), 0);
+  std::sort(indices.begin(), indices.end(), [&](int a, int b) {
+    return data[a] != data[b] ? data[a] > data[b] : a > b;
+  });
+  indices.resize(std::min(static_cast<size_t>(k), data.size()));
+  return indices;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitPrePostGetTopK, Basic) {
+  const size_t size = 1000;
+  std::vector<double> data(size);
+  for (size_t i = 0; i < size; ++i) {
+    data[i] = static_cast<double>((i * 7919) % size) / 3;
+  }
+  for (auto k : {1, 5, 999, 1000}) {
+    EXPECT_EQ(pre_post::getTopK(data.data(), size, k), expected(data, k));
+  }
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitPrePostGetTopK, Ties) {
+  // equal values are ordered by descending index
+  const std::vector<int8_t> data{3, 7, 7, -1, 3, 7};
+  const std::vector<int> golden{5, 2, 1, 4};
+  EXPECT_EQ(pre_post::getTopK(data.data(), data.size(), 4), golden);
+  EXPECT_EQ(pre_post::getTopK(data.data(), data.size(), 4),
+            expected(data, 4));
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitPrePostGetTopK, Limits) {
+  const std::vector<float> data{1, 2, 3};
+  EXPECT_TRUE(pre_post::getTopK(data.data(), data.size(), 0).empty());
+  EXPECT_EQ(pre_post::getTopK(data.data(), data.size(), 5),
+            (std::vector<int>{2, 1, 0}));
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitPrePostGetTopK, Batch) {
+  const std::vector<float> data{1, 4, 2, 9, 3, 5};
+  const std::vector<std::vector<int>> golden{{1, 2}, {0, 2}};
+  EXPECT_EQ(pre_post::getTopK(data.data(), 2, 3, 2), golden);
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,89 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>  // for uint8_t
+#include <vector>   // for vector
+
+#include "amdinfer/pre_post/jpeg_header.hpp"  // for jpegDimensions
+#include "gtest/gtest.h"                      // for Test, EXPECT_EQ
+
+namespace amdinfer {
+
+namespace {
+
+/// Make the start of a JPEG file with an APP0 segment and a baseline frame
+std::vector<uint8_t> makeHeader(int height, int width) {
+  std::vector<uint8_t> data{0xFF, 0xD8};
+  // APP0 with a length of 16
+  data.insert(data.end(), {0xFF, 0xE0, 0x00, 0x10});
+  data.insert(data.end(), 14, 0);
+  // padded SOF0 with 3 components
+  data.insert(data.end(), {0xFF, 0xFF, 0xC0, 0x00, 0x11, 0x08});
+  data.push_back(static_cast<uint8_t>(height >> 8));
+  data.push_back(static_cast<uint8_t>(height & 0xFF));
+  data.push_back(static_cast<uint8_t>(width >> 8));
+  data.push_back(static_cast<uint8_t>(width & 0xFF));
+  data.insert(data.end(), 10, 0);
+  return data;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitPrePostJpegHeader, Dimensions) {
+  const auto data = makeHeader(1080, 1920);
+  EXPECT_TRUE(pre_post::isJpeg(data.data(), data.size()));
+  const auto dimensions = pre_post::jpegDimensions(data.data(), data.size());
+  ASSERT_TRUE(dimensions.has_value());
+  EXPECT_EQ(dimensions->height, 1080);
+  EXPECT_EQ(dimensions->width, 1920);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitPrePostJpegHeader, Invalid) {
+  const std::vector<uint8_t> png{0x89, 'P', 'N', 'G', 0x0D, 0x0A};
+  EXPECT_FALSE(pre_post::isJpeg(png.data(), png.size()));
+  EXPECT_FALSE(pre_post::jpegDimensions(png.data(), png.size()).has_value());
+
+  // every truncation of the header before the size is complete fails
+  const auto data = makeHeader(480, 640);
+  const auto complete = 2 + 18 + 10;
+  for (auto size = 0; size < complete; ++size) {
+    EXPECT_FALSE(pre_post::jpegDimensions(data.data(), size).has_value());
+  }
+  EXPECT_TRUE(pre_post::jpegDimensions(data.data(), complete).has_value());
+
+  // the image data starts before any frame
+  const std::vector<uint8_t> scan{0xFF, 0xD8, 0xFF, 0xDA, 0x00, 0x08};
+  EXPECT_FALSE(pre_post::jpegDimensions(scan.data(), scan.size()).has_value());
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitPrePostJpegHeader, ScaleDenominator) {
+  const pre_post::ImageDimensions image{1080, 1920};
+  EXPECT_EQ(pre_post::jpegScaleDenominator(image, 224, 224), 4);
+  EXPECT_EQ(pre_post::jpegScaleDenominator(image, 135, 240), 8);
+  EXPECT_EQ(pre_post::jpegScaleDenominator(image, 136, 240), 4);
+  EXPECT_EQ(pre_post::jpegScaleDenominator(image, 540, 960), 2);
+  EXPECT_EQ(pre_post::jpegScaleDenominator(image, 541, 960), 1);
+  EXPECT_EQ(pre_post::jpegScaleDenominator(image, 2000, 2000), 1);
+  EXPECT_EQ(pre_post::jpegScaleDenominator(image, 0, 0), 1);
+
+  // scaled sizes are rounded up
+  const pre_post::ImageDimensions odd{225, 225};
+  EXPECT_EQ(pre_post::jpegScaleDenominator(odd, 29, 29), 8);
+  EXPECT_EQ(pre_post::jpegScaleDenominator(odd, 30, 29), 4);
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,142 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <array>    // for array
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint8_t
+#include <vector>   // for vector
+
+#include "amdinfer/pre_post/normalize.hpp"  // for normalize, ImageOrder
+#include "gtest/gtest.h"                    // for Test, EXPECT_FLOAT_EQ
+
+namespace amdinfer {
+
+namespace {
+
+constexpr auto kChannels = 3;
+const float kScale = 1 / 255.0F;
+const std::array<float, kChannels> kMean{0.485F, 0.456F, 0.406F};
+const std::array<float, kChannels> kStd{4.367F, 4.464F, 4.444F};
+
+// an odd number of pixels to also cover the scalar tail after the SIMD loops
+const size_t kPixels = 227;
+
+std::vector<uint8_t> makeImage() {
+  std::vector<uint8_t> image(kPixels * kChannels);
+  for (size_t i = 0; i < image.size(); ++i) {
+    image[i] = static_cast<uint8_t>(i * 7);
+  }
+  return image;
+}
+
+float expected(const std::vector<uint8_t>& image, size_t pixel, int channel) {
+  return (static_cast<float>(image[(pixel * kChannels) + channel]) * kScale -
+          kMean[channel]) *
+         kStd[channel];
+}
+
+template <typename F>
+void check(F normalize) {
+  const auto image = makeImage();
+  std::vector<float> output(image.size());
+
+  normalize(image.data(), pre_post::ImageOrder::NHWC, output.data());
+  for (size_t p = 0; p < kPixels; ++p) {
+    for (auto c = 0; c < kChannels; ++c) {
+      EXPECT_NEAR(output[(p * kChannels) + c], expected(image, p, c), 1e-5);
+    }
+  }
+
+  normalize(image.data(), pre_post::ImageOrder::NCHW, output.data());
+  for (size_t p = 0; p < kPixels; ++p) {
+    for (auto c = 0; c < kChannels; ++c) {
+      EXPECT_NEAR(output[(c * kPixels) + p], expected(image, p, c), 1e-5);
+    }
+  }
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitPrePostNormalize, Dispatch) {
+  check([](const uint8_t* input, pre_post::ImageOrder order, float* output) {
+    pre_post::normalize(input, kPixels, order, kScale, kMean.data(),
+                        kStd.data(), output);
+  });
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitPrePostNormalize, Strided) {
+  // normalize a crop of the middle columns of a wider image
+  const size_t rows = 5;
+  const size_t cols = 37;
+  const size_t offset = 3;
+  const size_t stride = (cols + 11) * kChannels;
+  std::vector<uint8_t> image(rows * stride);
+  for (size_t i = 0; i < image.size(); ++i) {
+    image[i] = static_cast<uint8_t>(i * 13);
+  }
+  const auto* input = image.data() + (offset * kChannels);
+  const auto value = [&](size_t r, size_t col, int c) {
+    const auto x = input[(r * stride) + (col * kChannels) + c];
+    return (static_cast<float>(x) * kScale - kMean[c]) * kStd[c];
+  };
+
+  std::vector<float> output(rows * cols * kChannels);
+  pre_post::normalize(input, rows, cols, stride, pre_post::ImageOrder::NHWC,
+                      kScale, kMean.data(), kStd.data(), output.data());
+  for (size_t r = 0; r < rows; ++r) {
+    for (size_t col = 0; col < cols; ++col) {
+      for (auto c = 0; c < kChannels; ++c) {
+        EXPECT_NEAR(output[(((r * cols) + col) * kChannels) + c],
+                    value(r, col, c), 1e-5);
+      }
+    }
+  }
+
+  pre_post::normalize(input, rows, cols, stride, pre_post::ImageOrder::NCHW,
+                      kScale, kMean.data(), kStd.data(), output.data());
+  for (size_t r = 0; r < rows; ++r) {
+    for (size_t col = 0; col < cols; ++col) {
+      for (auto c = 0; c < kChannels; ++c) {
+        EXPECT_NEAR(output[(c * rows * cols) + (r * cols) + col],
+                    value(r, col, c), 1e-5);
+      }
+    }
+  }
+}
+
+#ifdef AMDINFER_X86_SIMD
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitPrePostNormalize, Kernels) {
+  const pre_post::detail::NormalizeFactors factors{kScale, kMean.data(),
+                                                   kStd.data()};
+  check([&](const uint8_t* input, pre_post::ImageOrder order, float* output) {
+    pre_post::detail::normalizeScalar(input, kPixels, order, factors, output);
+  });
+  if (pre_post::detail::hasAvx2()) {
+    check([&](const uint8_t* input, pre_post::ImageOrder order, float* output) {
+      pre_post::detail::normalizeAvx2(input, kPixels, order, factors, output);
+    });
+  }
+  if (pre_post::detail::hasAvx512()) {
+    check([&](const uint8_t* input, pre_post::ImageOrder order, float* output) {
+      pre_post::detail::normalizeAvx512(input, kPixels, order, factors,
+                                        output);
+    });
+  }
+}
+#endif
+
+}  // namespace amdinfer
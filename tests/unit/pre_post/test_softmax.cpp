@@ -0,0 +1,152 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <cmath>    // for exp
+#include <cstddef>  // for size_t
+#include <vector>   // for vector
+
+#include "amdinfer/pre_post/softmax.hpp"  // for softmax, calcSoftmax
+#include "gtest/gtest.h"                  // for Test, EXPECT_NEAR
+
+namespace amdinfer {
+
+namespace {
+
+// not a multiple of the vector widths to also cover the scalar tails
+const size_t kClasses = 1001;
+
+template <typename T>
+std::vector<T> makeData(size_t size) {
+  std::vector<T> data(size);
+  for (size_t i = 0; i < size; ++i) {
+    // a wide range of values so some of the exponentials underflow
+    data[i] = static_cast<T>((static_cast<int>((i * 37) % 211) - 105) * 0.9);
+  }
+  return data;
+}
+
+template <typename T>
+std::vector<double> expected(const T* data, size_t size) {
+  double max = data[0];
+  for (size_t i = 1; i < size; ++i) {
+    max = std::max(max, static_cast<double>(data[i]));
+  }
+  std::vector<double> result(size);
+  double sum = 0;
+  for (size_t i = 0; i < size; ++i) {
+    result[i] = std::exp(data[i] - max);
+    sum += result[i];
+  }
+  for (auto& value : result) {
+    value /= sum;
+  }
+  return result;
+}
+
+template <typename T, typename F>
+void check(F softmax, double tolerance) {
+  const auto data = makeData<T>(kClasses);
+  std::vector<T> result(kClasses);
+  softmax(data.data(), kClasses, result.data());
+
+  const auto golden = expected(data.data(), kClasses);
+  double sum = 0;
+  for (size_t i = 0; i < kClasses; ++i) {
+    EXPECT_NEAR(result[i], golden[i], golden[i] * tolerance + 1e-30);
+    sum += result[i];
+  }
+  EXPECT_NEAR(sum, 1, tolerance * 10);
+}
+
+const double kFloatTolerance = 1e-5;
+const double kDoubleTolerance = 1e-12;
+
+}  // namespace
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitPrePostSoftmax, Dispatch) {
+  check<float>(
+    [](const float* data, size_t size, float* result) {
+      pre_post::softmax(data, size, result);
+    },
+    kFloatTolerance);
+  check<double>(
+    [](const double* data, size_t size, double* result) {
+      pre_post::softmax(data, size, result);
+    },
+    kDoubleTolerance);
+}
+
+#ifdef AMDINFER_X86_SIMD
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitPrePostSoftmax, Kernels) {
+  if (pre_post::detail::hasAvx2()) {
+    check<float>(
+      [](const float* data, size_t size, float* result) {
+        pre_post::detail::softmaxAvx2(data, size, result);
+      },
+      kFloatTolerance);
+    check<double>(
+      [](const double* data, size_t size, double* result) {
+        pre_post::detail::softmaxAvx2(data, size, result);
+      },
+      kDoubleTolerance);
+  }
+  if (pre_post::detail::hasAvx512()) {
+    check<float>(
+      [](const float* data, size_t size, float* result) {
+        pre_post::detail::softmaxAvx512(data, size, result);
+      },
+      kFloatTolerance);
+    check<double>(
+      [](const double* data, size_t size, double* result) {
+        pre_post::detail::softmaxAvx512(data, size, result);
+      },
+      kDoubleTolerance);
+  }
+}
+#endif
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitPrePostSoftmax, Batch) {
+  const size_t batch = 3;
+  auto data = makeData<float>(batch * kClasses);
+  std::vector<float> result(data.size());
+  pre_post::softmax(data.data(), batch, kClasses, result.data());
+  for (size_t i = 0; i < batch; ++i) {
+    const auto golden = expected(data.data() + (i * kClasses), kClasses);
+    for (size_t j = 0; j < kClasses; ++j) {
+      EXPECT_NEAR(result[(i * kClasses) + j], golden[j],
+                  golden[j] * kFloatTolerance + 1e-30);
+    }
+  }
+
+  // softmax can also run in place
+  pre_post::softmax(data.data(), batch, kClasses, data.data());
+  EXPECT_EQ(data, result);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitPrePostSoftmax, CalcSoftmax) {
+  const std::vector<int> data{1, 5, -3, 5, 2};
+  std::vector<double> result(data.size());
+  pre_post::calcSoftmax(data.data(), data.size(), result.data());
+  const auto golden = expected(data.data(), data.size());
+  for (size_t i = 0; i < data.size(); ++i) {
+    EXPECT_NEAR(result[i], golden[i], golden[i] * kDoubleTolerance);
+  }
+}
+
+}  // namespace amdinfer
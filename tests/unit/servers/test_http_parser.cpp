@@ -0,0 +1,97 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <json/value.h>  // for Value
+
+#include <array>        // for array
+#include <cstdint>      // for int32_t, uint8_t
+#include <string>       // for string
+#include <string_view>  // for string_view
+#include <vector>       // for vector
+
+#include "amdinfer/buffers/cpu.hpp"          // for CpuBuffer
+#include "amdinfer/core/data_types.hpp"      // for DataType
+#include "amdinfer/core/exceptions.hpp"      // for invalid_argument
+#include "amdinfer/servers/http_parser.hpp"  // for parseJsonRequest
+#include "gtest/gtest.h"                     // for Test, EXPECT_EQ
+
+namespace amdinfer {
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitServersHttpParser, Request) {
+  const std::string body = R"({
+    "id": "abc",
+    "inputs": [
+      {"data": [[1, 2], [3, 4]], "name": "a", "shape": [2, 2],
+       "datatype": "INT32"},
+      {"name": "b", "shape": [1], "datatype": "STRING", "data": ["x,]"]},
+      {"name": "c", "shape": [1], "datatype": "INT32"}
+    ],
+    "parameters": {"key": "value"}
+  })";
+
+  std::vector<std::string_view> data;
+  auto json = parseJsonRequest(body, &data);
+
+  EXPECT_EQ((*json)["id"].asString(), "abc");
+  EXPECT_EQ((*json)["parameters"]["key"].asString(), "value");
+  const auto& inputs = (*json)["inputs"];
+  ASSERT_EQ(inputs.size(), 3);
+  EXPECT_EQ(inputs[0]["name"].asString(), "a");
+  EXPECT_FALSE(inputs[0].isMember("data"));
+  EXPECT_EQ(inputs[1]["datatype"].asString(), "STRING");
+
+  ASSERT_EQ(data.size(), 3);
+  EXPECT_EQ(data[0], "[[1, 2], [3, 4]]");
+  EXPECT_EQ(data[1], R"(["x,]"])");
+  EXPECT_TRUE(data[2].empty());
+
+  EXPECT_THROW(parseJsonRequest(R"({"inputs": [)", &data), invalid_argument);
+  EXPECT_THROW(parseJsonRequest(R"({"id": "a"} x)", &data), invalid_argument);
+  EXPECT_THROW(parseJsonRequest(R"({"id": [}])", &data), invalid_argument);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitServersHttpParser, Array) {
+  std::array<int32_t, 4> ints{};
+  CpuBuffer int_buffer{ints.data(), MemoryAllocators::Cpu, sizeof(ints)};
+  auto size = parseJsonArray("[[1, -2], [3.0, 4]]", DataType::Int32,
+                             &int_buffer);
+  EXPECT_EQ(size, sizeof(ints));
+  EXPECT_EQ(ints, (std::array<int32_t, 4>{1, -2, 3, 4}));
+
+  std::array<float, 2> floats{};
+  CpuBuffer float_buffer{floats.data(), MemoryAllocators::Cpu};
+  parseJsonArray("[1.5,-2e1]", DataType::Fp32, &float_buffer);
+  EXPECT_FLOAT_EQ(floats[0], 1.5F);
+  EXPECT_FLOAT_EQ(floats[1], -20.0F);
+
+  std::array<char, 4> chars{};
+  CpuBuffer char_buffer{chars.data(), MemoryAllocators::Cpu};
+  parseJsonArray(R"(["abc"])", DataType::String, &char_buffer);
+  EXPECT_EQ(std::string(chars.data()), "abc");
+
+  std::array<uint8_t, 1> small{};
+  CpuBuffer small_buffer{small.data(), MemoryAllocators::Cpu, sizeof(small)};
+  EXPECT_THROW(parseJsonArray("[1, 2]", DataType::Uint8, &small_buffer),
+               invalid_argument);
+  EXPECT_THROW(parseJsonArray("[300]", DataType::Uint8, &small_buffer),
+               invalid_argument);
+  EXPECT_THROW(parseJsonArray(R"(["1"])", DataType::Uint8, &small_buffer),
+               invalid_argument);
+  EXPECT_THROW(parseJsonArray("[1 2]", DataType::Uint8, &small_buffer),
+               invalid_argument);
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,127 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>  // for atomic
+#include <chrono>  // for milliseconds
+#include <mutex>   // for mutex, lock_guard
+#include <string>  // for string
+#include <thread>  // for thread, sleep_for
+#include <vector>  // for vector
+
+#include "amdinfer/servers/send_window.hpp"  // for SendWindow
+#include "gtest/gtest.h"                     // for Test
+
+namespace amdinfer {
+
+namespace {
+
+// the window is used from other threads so the sent messages are guarded
+struct Sent {
+  void add(const std::string& message) {
+    std::lock_guard lock{mutex};
+    messages.push_back(message);
+  }
+  std::vector<std::string> get() {
+    std::lock_guard lock{mutex};
+    return messages;
+  }
+
+  std::vector<std::string> messages;
+  std::mutex mutex;
+};
+
+SendWindow::Sender getSender(Sent* sent) {
+  return [sent](const std::string& message, bool) { sent->add(message); };
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitSendWindow, Unbounded) {
+  Sent sent;
+  SendWindow window{0, WebSocketWindowPolicy::Skip, getSender(&sent)};
+  for (auto i = 0; i < 4; ++i) {
+    EXPECT_EQ(window.push("abcd", true), 0);
+  }
+  EXPECT_EQ(sent.get().size(), 4);
+  EXPECT_FALSE(window.bounded());
+  EXPECT_EQ(window.buffered(), 0);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitSendWindow, Skip) {
+  Sent sent;
+  SendWindow window{8, WebSocketWindowPolicy::Skip, getSender(&sent)};
+  EXPECT_EQ(window.push("aaaa", true), 0);
+  EXPECT_EQ(window.push("bbbb", true), 0);
+  EXPECT_EQ(window.push("cccc", true), 1);
+  // errors are sent even if the window is full
+  EXPECT_EQ(window.push("error", false, false), 0);
+  EXPECT_EQ(window.buffered(), 13);
+
+  window.ack(13);
+  EXPECT_EQ(window.buffered(), 0);
+  // a message larger than the window is sent if nothing is in flight
+  EXPECT_EQ(window.push("dddddddddddd", true), 0);
+  EXPECT_EQ(sent.get(), (std::vector<std::string>{"aaaa", "bbbb", "error",
+                                                  "dddddddddddd"}));
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitSendWindow, DropOldest) {
+  Sent sent;
+  SendWindow window{8, WebSocketWindowPolicy::DropOldest, getSender(&sent)};
+  EXPECT_EQ(window.push("aaaa", true), 0);
+  EXPECT_EQ(window.push("bbbb", true), 0);
+  EXPECT_EQ(window.push("cccc", true), 0);
+  EXPECT_EQ(window.push("dddd", true), 0);
+  EXPECT_EQ(window.push("eeee", true), 1);
+  EXPECT_EQ(window.buffered(), 16);
+  EXPECT_EQ(sent.get().size(), 2);
+
+  // the newest queued messages are sent as the client catches up
+  window.ack(4);
+  EXPECT_EQ(sent.get().back(), "dddd");
+  window.ack(8);
+  EXPECT_EQ(sent.get(),
+            (std::vector<std::string>{"aaaa", "bbbb", "dddd", "eeee"}));
+  EXPECT_EQ(window.buffered(), 4);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitSendWindow, Block) {
+  Sent sent;
+  SendWindow window{4, WebSocketWindowPolicy::Block, getSender(&sent)};
+  EXPECT_EQ(window.push("aaaa", true), 0);
+
+  std::atomic_bool done = false;
+  std::thread producer{[&] {
+    window.push("bbbb", true);
+    window.push("cccc", true);
+    done = true;
+  }};
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_FALSE(done);
+  EXPECT_EQ(sent.get().size(), 1);
+
+  window.ack(4);
+  // closing the window wakes the producer without sending
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  window.close();
+  producer.join();
+  EXPECT_TRUE(done);
+  EXPECT_EQ(sent.get(), (std::vector<std::string>{"aaaa", "bbbb"}));
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,101 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstddef>  // for size_t
+#include <random>   // for mt19937
+#include <string>   // for string
+#include <utility>  // for pair
+#include <vector>   // for vector
+
+#include "amdinfer/util/base64.hpp"  // for base64Decode, base64Encode
+#include "gtest/gtest.h"             // for Test, EXPECT_EQ
+
+namespace amdinfer {
+
+namespace {
+
+using util::detail::Base64Kernel;
+
+/// Get the kernels that the CPU supports
+std::vector<Base64Kernel> getKernels() {
+  std::vector<Base64Kernel> kernels{Base64Kernel::Scalar};
+  const auto best = util::detail::getBase64Kernel();
+  for (auto kernel : {Base64Kernel::Avx2, Base64Kernel::Avx512Vbmi}) {
+    if (kernel <= best) {
+      kernels.push_back(kernel);
+    }
+  }
+  return kernels;
+}
+
+std::string makeData(size_t size) {
+  std::mt19937 gen{static_cast<std::mt19937::result_type>(size)};
+  std::string data(size, '\0');
+  for (auto& c : data) {
+    c = static_cast<char>(gen());
+  }
+  return data;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitUtilBase64, Rfc4648) {
+  const std::vector<std::pair<std::string, std::string>> vectors{
+    {"", ""},         {"f", "Zg=="},        {"fo", "Zm8="},
+    {"foo", "Zm9v"},  {"foob", "Zm9vYg=="}, {"fooba", "Zm9vYmE="},
+    {"foobar", "Zm9vYmFy"}};
+  for (const auto& [decoded, encoded] : vectors) {
+    EXPECT_EQ(util::base64Encode(decoded), encoded);
+    EXPECT_EQ(util::base64Decode(encoded), decoded);
+  }
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitUtilBase64, Kernels) {
+  // sizes around the kernels' blocks and their scalar tails
+  for (size_t size = 0; size < 300; ++size) {
+    const auto data = makeData(size);
+    const auto expected =
+      util::detail::base64Encode(data.data(), size, Base64Kernel::Scalar);
+    for (auto kernel : getKernels()) {
+      const auto encoded =
+        util::detail::base64Encode(data.data(), size, kernel);
+      ASSERT_EQ(encoded, expected) << size;
+      ASSERT_EQ(
+        util::detail::base64Decode(encoded.data(), encoded.size(), kernel),
+        data)
+        << size;
+    }
+  }
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitUtilBase64, SkipsInvalid) {
+  const auto data = makeData(1000);
+  const auto encoded = util::base64Encode(data);
+  // line breaks in the middle of the blocks and a stray character
+  std::string wrapped;
+  for (size_t i = 0; i < encoded.size(); i += 76) {
+    wrapped += encoded.substr(i, 76) + "\r\n";
+  }
+  wrapped.insert(wrapped.size() / 2, "\x80");
+  for (auto kernel : getKernels()) {
+    EXPECT_EQ(
+      util::detail::base64Decode(wrapped.data(), wrapped.size(), kernel),
+      data);
+  }
+}
+
+}  // namespace amdinfer
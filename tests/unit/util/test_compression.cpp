@@ -14,7 +14,9 @@
 
 #include <array>   // for array
 #include <memory>  // for allocator
+#include <string>  // for string
 
+#include "amdinfer/core/exceptions.hpp"   // for invalid_argument
 #include "amdinfer/util/compression.hpp"  // for zDecompress
 #include "gtest/gtest.h"                  // for Test, SuiteApiResolver, EXP...
 
@@ -32,6 +34,49 @@ TEST(UnitUtilCompression, Decompression) {
   auto decompressed_str = util::zDecompress(data, compressed_data.size());
 
   EXPECT_EQ(decompressed_str, "amdinfer");
+  EXPECT_EQ(util::decompress({data, compressed_data.size()}), "amdinfer");
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitUtilCompression, RoundTrip) {
+  std::string data;
+  for (auto i = 0; i < 1000; ++i) {
+    data += R"({"name": "input", "data": [)" + std::to_string(i) + "]}";
+  }
+
+  for (const auto algorithm : {Compression::Deflate, Compression::Gzip}) {
+    const auto compressed = util::compress(data, algorithm);
+    EXPECT_LT(compressed.size(), data.size());
+    EXPECT_EQ(util::decompress(compressed), data);
+    EXPECT_THROW(util::decompress(compressed, data.size() - 1),
+                 invalid_argument);
+    EXPECT_THROW(util::decompress(compressed.substr(0, compressed.size() / 2)),
+                 invalid_argument);
+  }
+  // gzip streams start with its magic number
+  const auto gzip = util::compress(data, Compression::Gzip);
+  EXPECT_EQ(static_cast<unsigned char>(gzip[0]), 0x1f);
+  EXPECT_EQ(static_cast<unsigned char>(gzip[1]), 0x8b);
+  EXPECT_EQ(util::compress(data, Compression::None), data);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitUtilCompression, Encodings) {
+  EXPECT_EQ(util::parseContentEncoding("gzip"), Compression::Gzip);
+  EXPECT_EQ(util::parseContentEncoding(" Deflate "), Compression::Deflate);
+  EXPECT_EQ(util::parseContentEncoding("identity"), Compression::None);
+  EXPECT_THROW(util::parseContentEncoding("br"), invalid_argument);
+
+  const auto gzip = Compression::Gzip;
+  const auto deflate = Compression::Deflate;
+  EXPECT_EQ(util::negotiateEncoding("gzip, deflate", deflate), deflate);
+  EXPECT_EQ(util::negotiateEncoding("gzip;q=0.5", deflate), gzip);
+  EXPECT_EQ(util::negotiateEncoding("gzip;q=0, deflate", gzip), deflate);
+  EXPECT_EQ(util::negotiateEncoding("*", gzip), gzip);
+  EXPECT_EQ(util::negotiateEncoding("br", gzip), Compression::None);
+  EXPECT_EQ(util::negotiateEncoding("", gzip), Compression::None);
+  EXPECT_EQ(util::negotiateEncoding("gzip", Compression::None),
+            Compression::None);
 }
 
 }  //  namespace amdinfer
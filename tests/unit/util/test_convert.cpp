@@ -0,0 +1,113 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cmath>    // for isnan
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint16_t, uint8_t, int8_t
+#include <limits>   // for numeric_limits
+#include <vector>   // for vector
+
+#include "amdinfer/core/data_types.hpp"  // for bf16, fp16
+#include "amdinfer/util/convert.hpp"     // for convert
+#include "gtest/gtest.h"                 // for Test, EXPECT_EQ
+
+namespace amdinfer {
+
+namespace {
+
+/// Values that are exact in both fp16 and bf16, more than the vector widths
+std::vector<float> getValues() {
+  constexpr auto kCount = 37;
+  std::vector<float> values(kCount);
+  for (auto i = 0; i < kCount; ++i) {
+    values[i] = static_cast<float>(i - kCount / 2) * 0.5F;
+  }
+  return values;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitUtilConvert, Bf16) {
+  EXPECT_EQ(bf16{}.bits(), 0);
+  EXPECT_EQ(bf16{1.0F}.bits(), 0x3F80);
+  EXPECT_EQ(static_cast<float>(bf16::fromBits(0xC040)), -3.0F);
+
+  // ties round to the even mantissa
+  EXPECT_EQ(bf16{1.00390625F}.bits(), 0x3F80);
+  EXPECT_EQ(bf16{1.01171875F}.bits(), 0x3F82);
+  // values past the largest bf16 round to infinity
+  EXPECT_EQ(bf16{std::numeric_limits<float>::max()}.bits(), 0x7F80);
+  EXPECT_TRUE(std::isnan(
+    static_cast<float>(bf16{std::numeric_limits<float>::quiet_NaN()})));
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitUtilConvert, Halves) {
+  const auto values = getValues();
+  const auto count = values.size();
+
+  std::vector<fp16> halves(count);
+  util::convert(values.data(), count, halves.data());
+  std::vector<float> floats(count);
+  util::convert(halves.data(), count, floats.data());
+  EXPECT_EQ(floats, values);
+
+  std::vector<bf16> brains(count);
+  util::convert(values.data(), count, brains.data());
+  for (size_t i = 0; i < count; ++i) {
+    EXPECT_EQ(brains[i].bits(), bf16{values[i]}.bits());
+  }
+  util::convert(brains.data(), count, floats.data());
+  EXPECT_EQ(floats, values);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitUtilConvert, Scaled) {
+  constexpr auto kCount = 37;
+  std::vector<uint8_t> bytes(kCount);
+  for (auto i = 0; i < kCount; ++i) {
+    bytes[i] = static_cast<uint8_t>(i * 7);
+  }
+  std::vector<float> floats(kCount);
+  util::convertScaled(bytes.data(), kCount, 0.5F, -1.0F, floats.data());
+  std::vector<fp16> halves(kCount);
+  util::convertScaled(bytes.data(), kCount, 0.5F, -1.0F, halves.data());
+  for (auto i = 0; i < kCount; ++i) {
+    const auto golden = static_cast<float>(bytes[i]) * 0.5F - 1.0F;
+    EXPECT_EQ(floats[i], golden);
+    EXPECT_EQ(static_cast<float>(halves[i]), golden);
+  }
+
+  // fixed-point values round to the nearest even and saturate, in both the
+  // vectors and the remainder
+  const std::vector<float> special{100.0F, -100.0F, 0.375F, 0.625F,
+                                   std::numeric_limits<float>::quiet_NaN()};
+  const std::vector<int8_t> golden{127, -128, 2, 2, -128};
+  std::vector<float> values = special;
+  const auto middle = getValues();
+  values.insert(values.end(), middle.begin(), middle.end());
+  values.insert(values.end(), special.begin(), special.end());
+  std::vector<int8_t> chars(values.size());
+  util::convertScaled(values.data(), values.size(), 4.0F, 0.0F, chars.data());
+  const auto tail = chars.end() - static_cast<int>(special.size());
+  EXPECT_EQ(std::vector<int8_t>(chars.begin(), chars.begin() + special.size()),
+            golden);
+  EXPECT_EQ(std::vector<int8_t>(tail, chars.end()), golden);
+  for (size_t i = 0; i < middle.size(); ++i) {
+    EXPECT_EQ(chars[special.size() + i], static_cast<int8_t>(middle[i] * 4.0F));
+  }
+}
+
+}  // namespace amdinfer
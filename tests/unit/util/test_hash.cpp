@@ -0,0 +1,59 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>  // for uint64_t
+#include <string>   // for string
+#include <vector>   // for vector
+
+#include "amdinfer/util/hash.hpp"  // for xxh64
+#include "gtest/gtest.h"           // for Test, EXPECT_EQ
+
+namespace amdinfer {
+
+namespace {
+
+uint64_t hash(const std::string& data, uint64_t seed = 0) {
+  return util::xxh64(data.data(), data.size(), seed);
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitUtilHash, Reference) {
+  EXPECT_EQ(hash(""), 0xEF46DB3751D8E999ULL);
+  EXPECT_EQ(hash("a"), 0xD24EC4F1A98C6E5BULL);
+  EXPECT_EQ(hash("abc"), 0x44BC2CF5AD770999ULL);
+  EXPECT_EQ(hash("Nobody inspects the spammish repetition"),
+            0xFBCEA83C8A378BF1ULL);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitUtilHash, Sizes) {
+  // every size hits a different mix of the stripe loop and the tail
+  std::vector<uint64_t> hashes;
+  std::string data;
+  for (auto i = 0; i < 100; ++i) {
+    hashes.push_back(hash(data));
+    for (auto j = 0; j < i; ++j) {
+      EXPECT_NE(hashes[i], hashes[j]);
+    }
+    data.push_back(static_cast<char>(i));
+  }
+
+  EXPECT_NE(hash(data, 1), hash(data));
+  data.back() ^= 1;
+  EXPECT_NE(hash(data), hashes.back());
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,78 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <filesystem>  // for path, temp_directory_path
+#include <fstream>     // for ofstream
+#include <string>      // for string
+#include <utility>     // for move
+
+#include "amdinfer/core/exceptions.hpp"   // for file_read_error
+#include "amdinfer/util/mapped_file.hpp"  // for MappedFile
+#include "gtest/gtest.h"                  // for Test, EXPECT_EQ
+
+namespace fs = std::filesystem;
+
+namespace amdinfer {
+
+class UnitUtilMappedFile : public testing::Test {
+ protected:
+  void SetUp() override {
+    directory_ = fs::temp_directory_path() / "amdinfer_test_mapped_file";
+    fs::remove_all(directory_);
+    fs::create_directories(directory_);
+  }
+
+  void TearDown() override { fs::remove_all(directory_); }
+
+  fs::path writeFile(const std::string& name,
+                     const std::string& contents) const {
+    const auto path = directory_ / name;
+    std::ofstream file{path, std::ios::binary};
+    file << contents;
+    return path;
+  }
+
+  fs::path directory_;
+};
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST_F(UnitUtilMappedFile, Map) {
+  const std::string contents{"model\0weights", 13};
+  const util::MappedFile file{writeFile("model.onnx", contents)};
+  ASSERT_EQ(file.size(), contents.size());
+  EXPECT_EQ(std::string(file.data(), file.size()), contents);
+
+  const util::MappedFile empty{writeFile("empty.onnx", "")};
+  EXPECT_EQ(empty.size(), 0);
+  EXPECT_EQ(empty.data(), nullptr);
+
+  EXPECT_THROW(util::MappedFile{directory_ / "missing.onnx"}, file_read_error);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST_F(UnitUtilMappedFile, Move) {
+  util::MappedFile file{writeFile("a.onnx", "first")};
+  util::MappedFile other{std::move(file)};
+  EXPECT_EQ(file.data(), nullptr);  // NOLINT(bugprone-use-after-move)
+  EXPECT_EQ(std::string(other.data(), other.size()), "first");
+
+  other = util::MappedFile{writeFile("b.onnx", "second")};
+  EXPECT_EQ(std::string(other.data(), other.size()), "second");
+
+  // the mapping outlives the file's name
+  fs::remove(directory_ / "b.onnx");
+  EXPECT_EQ(std::string(other.data(), other.size()), "second");
+}
+
+}  // namespace amdinfer
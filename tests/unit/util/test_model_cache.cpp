@@ -0,0 +1,95 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <filesystem>  // for path, temp_directory_path
+#include <fstream>     // for ofstream
+#include <iterator>    // for distance
+#include <stdexcept>   // for runtime_error
+#include <string>      // for string
+
+#include "amdinfer/util/model_cache.hpp"  // for getModelCachePath
+#include "gtest/gtest.h"                  // for Test, EXPECT_EQ, EXPECT_NE
+
+namespace fs = std::filesystem;
+
+namespace amdinfer {
+
+class UnitUtilModelCache : public testing::Test {
+ protected:
+  void SetUp() override {
+    directory_ = fs::temp_directory_path() / "amdinfer_test_model_cache";
+    fs::remove_all(directory_);
+    fs::create_directories(directory_);
+    model_ = directory_ / "model.onnx";
+    writeModel("model");
+  }
+
+  void TearDown() override { fs::remove_all(directory_); }
+
+  void writeModel(const std::string& contents) const {
+    std::ofstream file{model_};
+    file << contents;
+  }
+
+  fs::path directory_;
+  fs::path model_;
+};
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST_F(UnitUtilModelCache, PathTracksKey) {
+  util::ModelCacheKey key{model_, "gpu-gfx90a", "migraphx-2.5.0", 4, ".mxr"};
+  const auto path = util::getModelCachePath(directory_, key);
+  EXPECT_EQ(path.parent_path(), directory_);
+  EXPECT_EQ(path.extension(), ".mxr");
+  EXPECT_EQ(path, util::getModelCachePath(directory_, key));
+
+  auto other = key;
+  other.batch_size = 1;
+  EXPECT_NE(path, util::getModelCachePath(directory_, other));
+  other = key;
+  other.device = "gpu-gfx908";
+  EXPECT_NE(path, util::getModelCachePath(directory_, other));
+  other = key;
+  other.framework = "migraphx-2.6.0";
+  EXPECT_NE(path, util::getModelCachePath(directory_, other));
+
+  writeModel("a different model");
+  EXPECT_NE(path, util::getModelCachePath(directory_, key));
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST_F(UnitUtilModelCache, Store) {
+  const auto cache = directory_ / "cache";
+  const auto path = cache / "compiled.mxr";
+
+  EXPECT_TRUE(util::storeInModelCache(path, [](const fs::path& temp_path) {
+    std::ofstream file{temp_path};
+    file << "compiled";
+  }));
+  EXPECT_TRUE(fs::exists(path));
+
+  // a failed write leaves nothing behind in the cache
+  const auto failed_path = cache / "failed.mxr";
+  EXPECT_FALSE(
+    util::storeInModelCache(failed_path, [](const fs::path& temp_path) {
+      std::ofstream file{temp_path};
+      file << "partial";
+      throw std::runtime_error("compile failed");
+    }));
+  EXPECT_FALSE(fs::exists(failed_path));
+  const fs::directory_iterator files{cache};
+  EXPECT_EQ(std::distance(fs::begin(files), fs::end(files)), 1);
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,71 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>  // for equal
+#include <cstddef>    // for size_t
+#include <cstdint>    // for uint8_t
+#include <vector>     // for vector
+
+#include "amdinfer/util/parallel_copy.hpp"  // for ParallelCopier
+#include "gtest/gtest.h"                    // for Test, EXPECT_EQ
+
+namespace amdinfer {
+
+namespace {
+
+std::vector<uint8_t> makeData(size_t size) {
+  std::vector<uint8_t> data(size);
+  for (auto i = 0U; i < size; ++i) {
+    data[i] = static_cast<uint8_t>(i * 7 + 3);
+  }
+  return data;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitUtilParallelCopy, Streaming) {
+  const auto data = makeData(1000);
+  // misaligned ends and a tail shorter than a vector are copied too
+  for (const auto offset : {0, 1, 5, 15}) {
+    std::vector<uint8_t> copy(data.size() + offset);
+    util::copyStreaming(copy.data() + offset, data.data(),
+                        data.size() - offset);
+    EXPECT_TRUE(std::equal(data.begin(), data.end() - offset,
+                           copy.begin() + offset));
+  }
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitUtilParallelCopy, Chunks) {
+  // every copy is split and the larger ones are streamed
+  util::ParallelCopier copier{3, 1, 4096};
+  for (const size_t size : {1, 63, 64, 65, 200, 4096, 100003}) {
+    const auto data = makeData(size);
+    std::vector<uint8_t> copy(size);
+    copier.copy(copy.data(), data.data(), size);
+    EXPECT_EQ(copy, data) << "size " << size;
+  }
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitUtilParallelCopy, NoThreads) {
+  util::ParallelCopier copier{0, 1, 1};
+  const auto data = makeData(5000);
+  std::vector<uint8_t> copy(data.size());
+  copier.copy(copy.data(), data.data(), data.size());
+  EXPECT_EQ(copy, data);
+}
+
+}  // namespace amdinfer
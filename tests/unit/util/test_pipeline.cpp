@@ -0,0 +1,120 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>  // for sort
+#include <atomic>     // for atomic_int
+#include <cstddef>    // for size_t
+#include <optional>   // for optional, nullopt
+#include <stdexcept>  // for runtime_error
+#include <vector>     // for vector
+
+#include "amdinfer/util/pipeline.hpp"  // for BoundedQueue, Pipeline, pop...
+#include "gtest/gtest.h"               // for Test, EXPECT_EQ, EXPECT_THROW
+
+namespace amdinfer {
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitUtilPipeline, BoundedQueue) {
+  util::BoundedQueue<int> queue{2};
+  EXPECT_TRUE(queue.push(1));
+  EXPECT_TRUE(queue.push(2));
+  EXPECT_EQ(queue.pop(), 1);
+
+  // closing the queue rejects new items but the queued ones can be drained
+  queue.close();
+  EXPECT_FALSE(queue.push(3));
+  EXPECT_EQ(queue.pop(), 2);
+  EXPECT_EQ(queue.pop(), std::nullopt);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitUtilPipeline, Stages) {
+  const int count = 100;
+  const int depth = 2;
+  const int threads = 3;
+  util::BoundedQueue<int> numbers{depth};
+  util::BoundedQueue<int> squares{depth};
+  std::atomic_int in_flight = 0;
+  std::atomic_int max_in_flight = 0;
+
+  util::Pipeline pipeline;
+  int next = 0;
+  pipeline.addSource("source", &numbers, [&]() -> std::optional<int> {
+    if (next == count) {
+      return std::nullopt;
+    }
+    auto current = ++in_flight;
+    max_in_flight = std::max(max_in_flight.load(), current);
+    return next++;
+  });
+  pipeline.addStage("square", threads, &numbers, &squares,
+                    [](int value) { return value * value; });
+
+  std::vector<int> results;
+  while (auto value = squares.pop()) {
+    results.push_back(*value);
+    --in_flight;
+  }
+  pipeline.join();
+
+  // the stage's threads may reorder the items
+  std::sort(results.begin(), results.end());
+  ASSERT_EQ(results.size(), count);
+  for (auto i = 0; i < count; ++i) {
+    EXPECT_EQ(results[i], i * i);
+  }
+  // the source can't get further ahead than the queues and stages allow: one
+  // item each in the source, the consumer and the threads plus the queued ones
+  EXPECT_LE(max_in_flight, 2 * depth + threads + 2);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitUtilPipeline, PopInOrder) {
+  util::BoundedQueue<int> queue{4};
+  for (auto value : {2, 0, 3, 1}) {
+    queue.push(value);
+  }
+  queue.close();
+
+  std::vector<int> results;
+  util::popInOrder(
+    &queue, [](int value) { return static_cast<size_t>(value); },
+    [&](int value) { results.push_back(value); });
+  const std::vector<int> expected{0, 1, 2, 3};
+  EXPECT_EQ(results, expected);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitUtilPipeline, Error) {
+  util::BoundedQueue<int> numbers{1};
+  util::BoundedQueue<int> results{1};
+
+  util::Pipeline pipeline;
+  int next = 0;
+  // the source never ends on its own so the error has to stop it
+  pipeline.addSource("source", &numbers,
+                     [&]() -> std::optional<int> { return next++; });
+  pipeline.addStage("fail", 2, &numbers, &results, [](int value) {
+    if (value == 5) {
+      throw std::runtime_error("failed");
+    }
+    return value;
+  });
+
+  while (results.pop().has_value()) {
+  }
+  EXPECT_THROW(pipeline.join(), std::runtime_error);
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,81 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>   // for milliseconds, steady_clock
+#include <cmath>    // for sqrt
+#include <sstream>  // for istringstream
+#include <string>   // for string, getline, stoul
+#include <thread>   // for thread
+
+#include "amdinfer/core/exceptions.hpp"  // for runtime_error
+#include "amdinfer/util/profiler.hpp"    // for CpuProfiler
+#include "amdinfer/util/thread.hpp"      // for setThreadName
+#include "gtest/gtest.h"                 // for Test, EXPECT_EQ, EXPECT_THROW
+
+namespace amdinfer {
+
+namespace {
+
+/// Use the CPU for some time so the thread gets sampled
+double spin(std::chrono::milliseconds duration) {
+  const auto end = std::chrono::steady_clock::now() + duration;
+  volatile double sum = 0;
+  while (std::chrono::steady_clock::now() < end) {
+    for (auto i = 0; i < 1000; ++i) {
+      sum = sum + std::sqrt(static_cast<double>(i));
+    }
+  }
+  return sum;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitUtilProfiler, Sample) {
+  const auto frequency = 1000;
+  util::CpuProfiler::start(frequency);
+  EXPECT_TRUE(util::CpuProfiler::running());
+  EXPECT_THROW(util::CpuProfiler::start(frequency), runtime_error);
+
+  std::thread thread{[]() {
+    util::setThreadName("profiled");
+    spin(std::chrono::milliseconds(200));  // NOLINT(*-magic-numbers)
+  }};
+  thread.join();
+
+  const auto profile = util::CpuProfiler::stop();
+  EXPECT_FALSE(util::CpuProfiler::running());
+  EXPECT_THROW(std::ignore = util::CpuProfiler::stop(), runtime_error);
+
+  // each line is a stack followed by its number of samples
+  size_t samples = 0;
+  std::istringstream lines{profile};
+  std::string line;
+  while (std::getline(lines, line)) {
+    const auto space = line.rfind(' ');
+    ASSERT_NE(space, std::string::npos);
+    if (line.rfind("profiled;", 0) == 0) {
+      samples += std::stoul(line.substr(space + 1));
+    }
+  }
+  EXPECT_GT(samples, 0);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitUtilProfiler, InvalidFrequency) {
+  EXPECT_THROW(util::CpuProfiler::start(0), invalid_argument);
+  EXPECT_FALSE(util::CpuProfiler::running());
+}
+
+}  // namespace amdinfer
@@ -0,0 +1,57 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <vector>  // for vector
+
+#include "amdinfer/core/exceptions.hpp"  // for invalid_argument
+#include "amdinfer/util/thread.hpp"      // for parseCpuList, splitCpus
+#include "gtest/gtest.h"                 // for Test, EXPECT_EQ, EXPECT_THROW
+
+namespace amdinfer {
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitUtilThread, ParseCpuList) {
+  const std::vector<int> expected{0, 1, 2, 3, 8, 10, 11};
+  EXPECT_EQ(util::parseCpuList("0-3,8,10-11"), expected);
+  EXPECT_TRUE(util::parseCpuList("").empty());
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitUtilThread, ParseInvalidCpuList) {
+  EXPECT_THROW(util::parseCpuList("3-1"), invalid_argument);
+  EXPECT_THROW(util::parseCpuList("a,b"), invalid_argument);
+  EXPECT_THROW(util::parseCpuList("-1"), invalid_argument);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitUtilThread, CpuAffinity) {
+  const std::vector<int> expected{2, 3};
+  // the CPU list takes precedence over the NUMA node
+  EXPECT_EQ(util::getCpuAffinity("2-3", 0), expected);
+  EXPECT_TRUE(util::getCpuAffinity("", -1).empty());
+  EXPECT_FALSE(util::setThreadAffinity(std::vector<int>{}));
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitUtilThread, SplitCpus) {
+  const std::vector<int> cpus{0, 1, 2, 3, 8};
+  const std::vector<std::vector<int>> expected{{0, 1, 2}, {3, 8}};
+  EXPECT_EQ(util::splitCpus(cpus, 2), expected);
+  EXPECT_EQ(util::splitCpus(cpus, cpus.size()).back(), std::vector<int>{8});
+  EXPECT_THROW(util::splitCpus(cpus, 0), invalid_argument);
+  EXPECT_THROW(util::splitCpus(cpus, cpus.size() + 1), invalid_argument);
+  EXPECT_FALSE(util::getAllowedCpus().empty());
+}
+
+}  // namespace amdinfer
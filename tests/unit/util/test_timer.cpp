@@ -0,0 +1,71 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>  // for milliseconds, steady_clock
+#include <ratio>   // for milli
+#include <thread>  // for sleep_for
+
+#include "amdinfer/util/timer.hpp"  // for Timer, Clock, Mark
+#include "gtest/gtest.h"            // for Test, EXPECT_LE, EXPECT_NEAR
+
+namespace amdinfer {
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitUtilTimer, ClockIsSteady) {
+  auto previous = util::Clock::now();
+  for (auto i = 0; i < 1000; ++i) {
+    const auto now = util::Clock::now();
+    EXPECT_LE(previous, now);
+    previous = now;
+  }
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitUtilTimer, ClockMatchesSteadyClock) {
+  const std::chrono::milliseconds wait{50};
+  const auto steady_start = std::chrono::steady_clock::now();
+  const auto start = util::Clock::now();
+  std::this_thread::sleep_for(wait);
+  const auto stop = util::Clock::now();
+  const auto steady_stop = std::chrono::steady_clock::now();
+
+  const std::chrono::duration<double, std::milli> elapsed = stop - start;
+  const std::chrono::duration<double, std::milli> expected =
+    steady_stop - steady_start;
+  // the calibration is within a fraction of a percent so a few milliseconds
+  // covers the time between reading the two clocks
+  EXPECT_NEAR(elapsed.count(), expected.count(), 5);
+  EXPECT_GE(elapsed, wait);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitUtilTimer, Marks) {
+  const auto start = util::getTime();
+  util::Timer timer{start};
+  timer.add(util::Mark::InferStart, start + std::chrono::milliseconds(2));
+  timer.add(util::Mark::InferStop, start + std::chrono::milliseconds(5));
+  timer.add(util::Mark::Stop, start + std::chrono::milliseconds(6));
+
+  EXPECT_DOUBLE_EQ(timer.count<std::milli>(), 6);
+  EXPECT_DOUBLE_EQ(
+    timer.count<std::milli>(util::Mark::InferStart, util::Mark::InferStop), 3);
+  EXPECT_EQ((timer.count<std::micro, int>(util::Mark::Start,
+                                          util::Mark::InferStart)),
+            2000);
+
+  timer.clear();
+  EXPECT_DOUBLE_EQ(timer.count(), 0);
+}
+
+}  // namespace amdinfer
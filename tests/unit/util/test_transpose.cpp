@@ -0,0 +1,61 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint8_t
+#include <utility>  // for pair
+#include <vector>   // for vector
+
+#include "amdinfer/util/transpose.hpp"  // for transpose
+#include "gtest/gtest.h"                // for Test, EXPECT_EQ
+
+namespace amdinfer {
+
+namespace {
+
+template <typename T>
+void checkTranspose(size_t rows, size_t cols) {
+  std::vector<T> source(rows * cols);
+  for (size_t i = 0; i < source.size(); ++i) {
+    source[i] = static_cast<T>(i);
+  }
+  std::vector<T> dest(source.size());
+  util::transpose(source.data(), rows, cols, dest.data());
+  for (size_t i = 0; i < rows; ++i) {
+    for (size_t j = 0; j < cols; ++j) {
+      ASSERT_EQ(dest[j * rows + i], source[i * cols + j])
+        << rows << "x" << cols << " at " << i << ", " << j;
+    }
+  }
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitUtilTranspose, Floats) {
+  // sizes that cover the vector tiles, partial blocks and the scalar edges
+  for (const auto& [rows, cols] : std::vector<std::pair<size_t, size_t>>{
+         {1, 1}, {3, 7}, {8, 8}, {16, 3}, {37, 45}, {224 * 224, 3}}) {
+    checkTranspose<float>(rows, cols);
+    checkTranspose<float>(cols, rows);
+  }
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitUtilTranspose, Bytes) {
+  checkTranspose<uint8_t>(5, 3);
+  checkTranspose<uint8_t>(40, 33);
+}
+
+}  // namespace amdinfer
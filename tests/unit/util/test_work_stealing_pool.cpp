@@ -0,0 +1,73 @@
+// Copyright 2023 Advanced Micro Devices, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>  // for atomic
+#include <chrono>  // for milliseconds
+#include <thread>  // for sleep_for
+
+#include "amdinfer/util/thread.hpp"              // for getAllowedCpus
+#include "amdinfer/util/work_stealing_pool.hpp"  // for WorkStealingPool
+#include "gtest/gtest.h"                         // for Test, EXPECT_EQ
+
+namespace amdinfer {
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitWorkStealingPool, Submit) {
+  const auto kTasks = 1000;
+  std::atomic<int> count = 0;
+  {
+    util::WorkStealingPool pool{4};
+    EXPECT_EQ(pool.getSize(), 4);
+    for (auto i = 0; i < kTasks; ++i) {
+      pool.submit([&count]() { count++; });
+    }
+  }
+  // the pool runs the submitted tasks before it's destroyed
+  EXPECT_EQ(count, kTasks);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitWorkStealingPool, Steal) {
+  std::atomic<int> count = 0;
+  util::WorkStealingPool pool{2};
+  // the nested tasks go to the busy thread's queue and the idle one takes them
+  pool.submit([&]() {
+    for (auto i = 0; i < 4; ++i) {
+      pool.submit([&count]() { count++; });
+    }
+    while (count < 4) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  });
+  pool.stop();
+  EXPECT_EQ(count, 4);
+  EXPECT_EQ(pool.getSize(), 0);
+}
+
+// NOLINTNEXTLINE(cert-err58-cpp, cppcoreguidelines-owning-memory)
+TEST(UnitWorkStealingPool, Resize) {
+  std::atomic<int> count = 0;
+  util::WorkStealingPool pool;
+  // without threads, tasks wait for them
+  pool.submit([&count]() { count++; });
+  EXPECT_EQ(count, 0);
+  pool.resize(1);
+  pool.setAffinity(util::getAllowedCpus(), true);
+  pool.submit([&count]() { count++; });
+  pool.resize(3);
+  EXPECT_EQ(count, 2);
+  EXPECT_EQ(pool.getSize(), 3);
+}
+
+}  // namespace amdinfer
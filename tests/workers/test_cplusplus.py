@@ -182,3 +182,16 @@ class TestCPlusPlus2:
         """
         request = self.construct_request()
         self.send_request(request)
+
+
+@pytest.mark.usefixtures("load")
+class TestCPlusPlusBatched(TestCPlusPlus2):
+    """
+    Test the CPlusPlus worker with a model that uses the batched C ABI
+    """
+
+    @staticmethod
+    def get_config():
+        model = "CPlusPlus"
+        parameters = {"model": "echo_batched", "batch_size": 2, "timeout": 1000}
+        return (model, parameters)
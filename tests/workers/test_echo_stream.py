@@ -0,0 +1,80 @@
+# Copyright 2022 Advanced Micro Devices, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+import numpy as np
+import pytest
+
+import amdinfer
+
+
+@pytest.mark.usefixtures("load")
+class TestEchoStream:
+    """
+    Test the EchoStream worker
+    """
+
+    @staticmethod
+    def get_config():
+        model = "echoStream"
+        parameters = {"batch_size": 2}
+        return (model, parameters)
+
+    @staticmethod
+    def construct_request(steps):
+        """
+        Construct a request that runs for the given number of steps
+
+        Args:
+            steps (int): Number of steps to run the request for
+
+        Returns:
+            InferenceRequest: The constructed request
+        """
+
+        input_0 = amdinfer.InferenceRequestInput()
+        input_0.name = "echoStream"
+        input_0.datatype = amdinfer.DataType.UINT32
+        input_0.shape = [1]
+        input_0.setUint32Data(np.array([steps], np.uint32))
+
+        request = amdinfer.InferenceRequest()
+        request.addInputTensor(input_0)
+        return request
+
+    def test_echo_stream_0(self):
+        """
+        Send requests of different lengths so they join and leave the running
+        batch at different steps. Each response has the outputs of all steps
+        """
+        steps = [3, 1, 5, 2]
+        requests = [self.construct_request(count) for count in steps]
+        try:
+            responses = amdinfer.inferAsyncOrdered(
+                self.rest_client, self.endpoint, requests
+            )
+        except ConnectionError:
+            pytest.fail(
+                "Connection to the amdinfer server ended without response!", False
+            )
+
+        for count, response in zip(steps, responses):
+            assert not response.isError(), response.getError()
+            assert response.model == "echoStream"
+
+            outputs = response.getOutputs()
+            assert len(outputs) == 1
+            data = outputs[0].getUint32Data()
+            assert (data == list(range(1, count + 1))).all(), data
+            assert outputs[0].shape == [count]
@@ -13,7 +13,9 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 
+import base64
 import json
+import struct
 
 import cv2
 import pytest
@@ -37,7 +39,7 @@ class TestInvertVideo:
         parameters = None
         return (model, parameters)
 
-    def construct_request(self, video_path, requested_frames_count):
+    def construct_request(self, video_path, requested_frames_count, binary=False):
         input_0 = amdinfer.InferenceRequestInput()
         input_0.name = "input0"
         input_0.datatype = amdinfer.DataType.STRING
@@ -51,6 +53,8 @@ class TestInvertVideo:
         request.addInputTensor(input_0)
         parameters_2 = amdinfer.ParameterMap()
         parameters_2.put("key", "0")
+        if binary:
+            parameters_2.put("binary", True)
         request.parameters = parameters_2
 
         self.ws_client.modelInferWs(self.endpoint, request)
@@ -71,6 +75,68 @@ class TestInvertVideo:
             frame = cv2.bitwise_not(frame)
             compare_jpgs(resp_data.encode(), frame)
 
+    def recv_binary_frames(self, video_path, count):
+
+        cap = cv2.VideoCapture(video_path)
+        for _ in range(count):
+            resp = self.ws_client.modelRecvBytes()
+            # a little-endian header length, the JSON header and then the JPG
+            header_length = struct.unpack("<I", resp[:4])[0]
+            header = json.loads(resp[4 : 4 + header_length])
+            assert header["key"] == "0"
+            resp_data = base64.b64encode(resp[4 + header_length :])
+            _, frame = cap.read()
+            frame = cv2.bitwise_not(frame)
+            compare_jpgs(resp_data, frame)
+
+    def test_invert_video_binary_frames(self):
+        requested_frames_count = 10
+        video_path = amdinfer.testing.getPathToAsset("asset_Physicsworks.ogv")
+        client = amdinfer.WebSocketClient(
+            "ws://" + self.address,
+            "http://" + self.address,
+            amdinfer.WebSocketProtocol.Binary,
+        )
+
+        input_0 = amdinfer.InferenceRequestInput()
+        input_0.name = "input0"
+        input_0.datatype = amdinfer.DataType.STRING
+        input_0.setStringData(amdinfer.stringToArray(video_path))
+        input_0.shape = [len(video_path)]
+        parameters = amdinfer.ParameterMap()
+        parameters.put("count", requested_frames_count)
+        input_0.parameters = parameters
+
+        request = amdinfer.InferenceRequest()
+        request.id = "video"
+        request.addInputTensor(input_0)
+        parameters_2 = amdinfer.ParameterMap()
+        parameters_2.put("key", "0")
+        request.parameters = parameters_2
+
+        client.modelInferWs(self.endpoint, request)
+        # the first response holds the video's FPS as JSON text
+        response = client.modelRecvResponse()
+        assert not response.isError()
+        assert response.id == "video"
+        header = json.loads(response.getOutputs()[0].getStringData().tobytes())
+        assert header["key"] == "0"
+
+        # binary connections get binary frames from the worker by default
+        cap = cv2.VideoCapture(video_path)
+        for _ in range(requested_frames_count):
+            response = client.modelRecvResponse()
+            assert not response.isError()
+            output = response.getOutputs()[0]
+            assert output.datatype == amdinfer.DataType.UINT8
+            resp = output.getUint8Data().tobytes()
+            header_length = struct.unpack("<I", resp[:4])[0]
+            assert json.loads(resp[4 : 4 + header_length])["key"] == "0"
+            _, frame = cap.read()
+            frame = cv2.bitwise_not(frame)
+            compare_jpgs(base64.b64encode(resp[4 + header_length :]), frame)
+        client.close()
+
     def test_invert_video_0(self):
         requested_frames_count = 100
         video_path = amdinfer.testing.getPathToAsset("asset_Physicsworks.ogv")
@@ -79,6 +145,14 @@ class TestInvertVideo:
         self.recv_frames(video_path, requested_frames_count)
         self.ws_client.close()
 
+    def test_invert_video_binary(self):
+        requested_frames_count = 100
+        video_path = amdinfer.testing.getPathToAsset("asset_Physicsworks.ogv")
+
+        self.construct_request(video_path, requested_frames_count, binary=True)
+        self.recv_binary_frames(video_path, requested_frames_count)
+        self.ws_client.close()
+
     # ? This is commented out because we need a function like run_benchmark()
     # ? to work with the pedantic mode to add the necessary metadata for the
     # ? benchmark to work with the benchmarking framework.
@@ -0,0 +1,89 @@
+# Copyright 2023 Advanced Micro Devices, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import time
+
+import numpy as np
+import pytest
+
+import amdinfer
+
+
+@pytest.mark.usefixtures("load")
+class TestSynthetic:
+    """
+    Test the Synthetic worker
+    """
+
+    latency_us = 20000
+    slots = 2
+    output_size = 16
+
+    @classmethod
+    def get_config(cls):
+        model = "synthetic"
+        parameters = {
+            "batch_size": 1,
+            "latency_us": cls.latency_us,
+            "slots": cls.slots,
+            "output_size": cls.output_size,
+            "seed": 0,
+        }
+        return (model, parameters)
+
+    @staticmethod
+    def construct_request():
+        """
+        Construct a request with an arbitrary input, which the worker ignores
+
+        Returns:
+            InferenceRequest: The constructed request
+        """
+
+        request = amdinfer.InferenceRequest()
+        input_0 = amdinfer.InferenceRequestInput()
+        input_0.name = "synthetic"
+        input_0.datatype = amdinfer.DataType.UINT8
+        input_0.shape = [4]
+        input_0.setUint8Data(np.zeros(4, np.uint8))
+        request.addInputTensor(input_0)
+        return request
+
+    def test_synthetic_0(self):
+        """
+        Send requests to the synthetic worker and check that its slots overlap
+        their latencies
+        """
+        requests = [self.construct_request()] * (self.slots * 2)
+
+        start = time.monotonic()
+        responses = amdinfer.inferAsyncOrdered(
+            self.rest_client, self.endpoint, requests
+        )
+        elapsed_us = (time.monotonic() - start) * 1e6
+
+        for response in responses:
+            assert not response.isError(), response.getError()
+            assert response.model == "synthetic"
+            outputs = response.getOutputs()
+            assert len(outputs) == 1
+            output = outputs[0]
+            assert output.datatype == amdinfer.DataType.UINT8
+            assert output.shape == [self.output_size]
+            assert (output.getUint8Data() == 0).all()
+
+        # the batches run two at a time so they take at least two latencies
+        # but less than running them one at a time
+        assert elapsed_us >= 2 * self.latency_us
+        assert elapsed_us < len(requests) * self.latency_us
@@ -88,6 +88,11 @@ docker-compose stop
 docker-compose rm -f
 ./amdinfer up --profile autotest-dev
 
+print_header "Testing the static workers in the stable dev docker image"
+
+./amdinfer --dry-run run --autotest-dev --command ./tools/static_workers.sh
+./amdinfer run --autotest-dev --command ./tools/static_workers.sh
+
 # This test must be run after the previous one. It requires that certain files
 # e.g. the AKS files exist in the repository. These files are created when
 # the project is built in the autotest-dev test.
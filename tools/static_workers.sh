@@ -0,0 +1,58 @@
+#!/usr/bin/env bash
+# Copyright 2023 Advanced Micro Devices, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+set -e
+
+usage_static_workers() {
+cat << EOF
+Build amdinfer with the echo worker compiled into the server and test that it
+loads without the worker's library.
+
+usage: ./static_workers.sh [flags]
+
+flags: provide options for this command
+  -h | --help                  - prints this message and exits
+EOF
+}
+
+static_workers(){
+  if [ "$1" == "-h" ] || [ "$1" == "--help" ]; then
+    usage_static_workers;
+    exit 0;
+  fi
+
+  if [[ -z $LD_LIBRARY_PATH && -f ~/.env ]]; then
+    source ~/.env
+  fi
+
+  cd $AMDINFER_ROOT
+  # use a separate build directory so the usual build isn't reconfigured
+  build_dir=${AMDINFER_ROOT}/build/StaticWorkers
+
+  cmake -S . -B $build_dir -DCMAKE_BUILD_TYPE=Debug \
+    -DAMDINFER_STATIC_WORKERS=Echo
+  cmake --build $build_dir -- -j $(nproc)
+
+  if [[ -e $build_dir/src/amdinfer/workers/libworkerEcho.so ]]; then
+    echo "The echo worker was built as a library"
+    return 1
+  fi
+
+  cd $build_dir
+  ctest --output-on-failure -R staticWorker
+  cd -
+}
+
+static_workers "$@"